@@ -0,0 +1,305 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "benchmark/benchmark_runner.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "common/config.h"
+#include "util/cpu_info.h"
+
+namespace doris {
+
+struct BenchmarkResult {
+    std::string name;
+    int64_t iterations = 0;
+    // in nanoseconds per iteration
+    double real_time = 0;
+    double cpu_time = 0;
+    double bytes_per_second = 0;
+    double items_per_second = 0;
+    std::map<std::string, double> counters;
+    std::string label;
+    std::string error;
+};
+
+static std::vector<std::pair<std::string, BenchmarkFunc>>& registered_benchmarks() {
+    static std::vector<std::pair<std::string, BenchmarkFunc>> s_benchmarks;
+    return s_benchmarks;
+}
+
+int register_benchmark(const std::string& name, BenchmarkFunc func) {
+    registered_benchmarks().emplace_back(name, std::move(func));
+    return registered_benchmarks().size();
+}
+
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(double min_time_s) : _min_time_ns(min_time_s * 1e9) { }
+
+    BenchmarkResult run(const std::string& name, const BenchmarkFunc& func) {
+        static const int64_t kMaxIterations = 1000000000;
+        int64_t iterations = 1;
+        while (true) {
+            BenchmarkState state(iterations);
+            func(&state);
+
+            double real_ns = state._real_watch.elapsed_time();
+            if (!state._error.empty() || real_ns >= _min_time_ns
+                    || iterations >= kMaxIterations) {
+                return _make_result(name, state);
+            }
+            // predict the iterations needed, but grow at most 10 times each run
+            double multiplier = real_ns > 0 ? _min_time_ns * 1.4 / real_ns : 10;
+            multiplier = std::min(std::max(multiplier, 2.0), 10.0);
+            iterations = std::min<int64_t>(iterations * multiplier, kMaxIterations);
+        }
+    }
+
+private:
+    BenchmarkResult _make_result(const std::string& name, const BenchmarkState& state) {
+        BenchmarkResult result;
+        result.name = name;
+        result.error = state._error;
+        result.iterations = state._iterations;
+        double real_ns = state._real_watch.elapsed_time();
+        double cpu_ns = state._cpu_watch.elapsed_time();
+        result.real_time = real_ns / state._iterations;
+        result.cpu_time = cpu_ns / state._iterations;
+        // Google Benchmark computes rates by cpu time
+        if (cpu_ns > 0) {
+            result.bytes_per_second = state._bytes_processed * 1e9 / cpu_ns;
+            result.items_per_second = state._items_processed * 1e9 / cpu_ns;
+        }
+        result.counters = state._counters;
+        result.label = state._label;
+        return result;
+    }
+
+    double _min_time_ns;
+};
+
+static void print_console(const BenchmarkResult& result) {
+    if (!result.error.empty()) {
+        printf("%-60s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+        return;
+    }
+    printf("%-60s %12.0f ns %12.0f ns %10ld", result.name.c_str(),
+           result.real_time, result.cpu_time, result.iterations);
+    if (result.bytes_per_second > 0) {
+        printf(" %10.2fMB/s", result.bytes_per_second / 1024 / 1024);
+    }
+    if (result.items_per_second > 0) {
+        printf(" %10.2fM items/s", result.items_per_second / 1e6);
+    }
+    for (auto& it : result.counters) {
+        printf(" %s=%.3f", it.first.c_str(), it.second);
+    }
+    if (!result.label.empty()) {
+        printf(" %s", result.label.c_str());
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+static std::string to_json(const std::vector<BenchmarkResult>& results) {
+    rapidjson::StringBuffer s;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
+
+    writer.StartObject();
+    writer.Key("context");
+    writer.StartObject();
+    char date[64];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    writer.Key("date");
+    writer.String(date);
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+    writer.Key("host_name");
+    writer.String(host);
+    writer.Key("num_cpus");
+    writer.Int(CpuInfo::num_cores());
+    writer.Key("mhz_per_cpu");
+    writer.Int64(CpuInfo::cycles_per_ms() / 1000);
+#ifdef NDEBUG
+    writer.Key("library_build_type");
+    writer.String("release");
+#else
+    writer.Key("library_build_type");
+    writer.String("debug");
+#endif
+    writer.EndObject();
+
+    writer.Key("benchmarks");
+    writer.StartArray();
+    for (auto& result : results) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(result.name.c_str());
+        if (!result.error.empty()) {
+            writer.Key("error_occurred");
+            writer.Bool(true);
+            writer.Key("error_message");
+            writer.String(result.error.c_str());
+            writer.EndObject();
+            continue;
+        }
+        writer.Key("iterations");
+        writer.Int64(result.iterations);
+        writer.Key("real_time");
+        writer.Double(result.real_time);
+        writer.Key("cpu_time");
+        writer.Double(result.cpu_time);
+        writer.Key("time_unit");
+        writer.String("ns");
+        if (result.bytes_per_second > 0) {
+            writer.Key("bytes_per_second");
+            writer.Double(result.bytes_per_second);
+        }
+        if (result.items_per_second > 0) {
+            writer.Key("items_per_second");
+            writer.Double(result.items_per_second);
+        }
+        for (auto& it : result.counters) {
+            writer.Key(it.first.c_str());
+            writer.Double(it.second);
+        }
+        if (!result.label.empty()) {
+            writer.Key("label");
+            writer.String(result.label.c_str());
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return s.GetString();
+}
+
+static bool parse_flag(const char* arg, const char* name, std::string* value) {
+    size_t len = strlen(name);
+    if (strncmp(arg, name, len) != 0) {
+        return false;
+    }
+    if (arg[len] == '\0') {
+        value->clear();
+        return true;
+    }
+    if (arg[len] != '=') {
+        return false;
+    }
+    *value = arg + len + 1;
+    return true;
+}
+
+int run_benchmarks(int argc, char** argv) {
+    std::string filter;
+    double min_time_s = 0.5;
+    std::string format = "console";
+    std::string out_file;
+    bool list_only = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string value;
+        if (parse_flag(argv[i], "--benchmark_filter", &value)) {
+            filter = value;
+        } else if (parse_flag(argv[i], "--benchmark_min_time", &value)) {
+            min_time_s = atof(value.c_str());
+        } else if (parse_flag(argv[i], "--benchmark_format", &value)) {
+            format = value;
+        } else if (parse_flag(argv[i], "--benchmark_out", &value)) {
+            out_file = value;
+        } else if (parse_flag(argv[i], "--benchmark_list_tests", &value)) {
+            list_only = true;
+        } else {
+            fprintf(stderr, "unknown flag: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (format != "console" && format != "json") {
+        fprintf(stderr, "unknown benchmark format: %s\n", format.c_str());
+        return 1;
+    }
+
+    // the code being measured reads configs, use their default values, some
+    // of which are under DORIS_HOME, which is the working directory if not set
+    if (getenv("DORIS_HOME") == nullptr) {
+        char cwd[PATH_MAX];
+        if (getcwd(cwd, sizeof(cwd)) == nullptr) {
+            perror("failed to get working directory");
+            return 1;
+        }
+        setenv("DORIS_HOME", cwd, 0);
+    }
+    if (!config::init(nullptr, false)) {
+        fprintf(stderr, "failed to init config\n");
+        return 1;
+    }
+    CpuInfo::init();
+
+    BenchmarkRunner runner(min_time_s);
+    std::vector<BenchmarkResult> results;
+    if (format == "console" && !list_only) {
+        printf("%-60s %15s %15s %10s\n", "Benchmark", "Time", "CPU", "Iterations");
+    }
+    for (auto& it : registered_benchmarks()) {
+        if (!filter.empty() && it.first.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (list_only) {
+            printf("%s\n", it.first.c_str());
+            continue;
+        }
+        results.push_back(runner.run(it.first, it.second));
+        if (format == "console") {
+            print_console(results.back());
+        }
+    }
+    if (list_only) {
+        return 0;
+    }
+
+    std::string json = to_json(results);
+    if (format == "json") {
+        printf("%s\n", json.c_str());
+    }
+    if (!out_file.empty()) {
+        std::ofstream out(out_file);
+        out << json << std::endl;
+        if (!out.good()) {
+            fprintf(stderr, "failed to write %s\n", out_file.c_str());
+            return 1;
+        }
+    }
+    auto has_error = [](const BenchmarkResult& r) { return !r.error.empty(); };
+    return std::any_of(results.begin(), results.end(), has_error) ? 1 : 0;
+}
+
+}
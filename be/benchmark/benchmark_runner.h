@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include "util/stopwatch.hpp"
+
+namespace doris {
+
+// A small benchmark runner for the benchmarks under be/benchmark.
+//
+// Each benchmark is a function which runs its measured code as long as
+// BenchmarkState::keep_running() returns true. The runner increases the
+// number of iterations until one run takes at least --benchmark_min_time
+// seconds, and reports the time per iteration, bytes and items processed per
+// second and user counters. The JSON output has the same layout as the one of
+// Google Benchmark, so the same tools can be used to compare results.
+//
+//   static void BM_foo(BenchmarkState* state) {
+//       // setup, not measured
+//       while (state->keep_running()) {
+//           foo();
+//       }
+//       state->set_items_processed(state->iterations() * N);
+//   }
+//   BENCHMARK(BM_foo);
+class BenchmarkState {
+public:
+    explicit BenchmarkState(int64_t iterations) : _iterations(iterations) { }
+
+    bool keep_running() {
+        if (_started_iterations == 0) {
+            _real_watch.start();
+            _cpu_watch.start();
+        }
+        if (_started_iterations < _iterations && _error.empty()) {
+            ++_started_iterations;
+            return true;
+        }
+        _real_watch.stop();
+        _cpu_watch.stop();
+        return false;
+    }
+
+    // exclude the time between pause_timing() and resume_timing()
+    void pause_timing() {
+        _real_watch.stop();
+        _cpu_watch.stop();
+    }
+    void resume_timing() {
+        _real_watch.start();
+        _cpu_watch.start();
+    }
+
+    // the number of iterations which keep_running() returns true
+    int64_t iterations() const { return _iterations; }
+
+    void set_bytes_processed(int64_t bytes) { _bytes_processed = bytes; }
+    void set_items_processed(int64_t items) { _items_processed = items; }
+    // reported as is, eg. compression ratio
+    void set_counter(const std::string& name, double value) { _counters[name] = value; }
+    void set_label(const std::string& label) { _label = label; }
+    // stop running and report 'msg' instead of the result
+    void skip_with_error(const std::string& msg) { _error = msg; }
+
+private:
+    friend class BenchmarkRunner;
+
+    int64_t _iterations;
+    int64_t _started_iterations = 0;
+    MonotonicStopWatch _real_watch;
+    ThreadCpuStopWatch _cpu_watch;
+
+    int64_t _bytes_processed = 0;
+    int64_t _items_processed = 0;
+    std::map<std::string, double> _counters;
+    std::string _label;
+    std::string _error;
+};
+
+typedef std::function<void(BenchmarkState*)> BenchmarkFunc;
+
+// Register a benchmark, usually called by BENCHMARK or during static
+// initialization
+int register_benchmark(const std::string& name, BenchmarkFunc func);
+
+// Run the benchmarks selected by command line flags:
+//   --benchmark_filter=<substr>  only run benchmarks whose names contain substr
+//   --benchmark_min_time=<secs>  minimal time of each benchmark, default 0.5
+//   --benchmark_format=<console|json>  format of stdout, default console
+//   --benchmark_out=<file>       also write the results into file as JSON
+//   --benchmark_list_tests       only print the names of the benchmarks
+int run_benchmarks(int argc, char** argv);
+
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+
+#define BENCHMARK(func) \
+    static int BENCHMARK_CONCAT(_benchmark_, __LINE__) = ::doris::register_benchmark(#func, func)
+
+#define BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { return ::doris::run_benchmarks(argc, argv); }
@@ -0,0 +1,615 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Benchmarks of single exec nodes on synthetic rows. Each benchmark drives one
+// node of a plan: HashJoinNode, NewPartitionedAggregationNode, SpillSortNode
+// or TopNNode, whose children return prebuilt tuples. Only open() and
+// get_next() of the node are measured. Nodes run in the same ExecEnv as in a
+// backend, whose directories are created under DORIS_HOME.
+//
+// Keys of the input are unique, skewed (zipf) or of low cardinality, and rows
+// are 16, 64 or 256 bytes wide. Hardware counters from util/perf_counters.h
+// are reported per input row if perf events are available, they only count
+// the benchmark thread, which excludes the build side of hash joins.
+//
+//   exec_benchmark --benchmark_filter=BM_HashJoin/skewed --benchmark_out=result.json
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_runner.h"
+#include "common/config.h"
+#include "common/daemon.h"
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "exec/hash_join_node.h"
+#include "exec/new_partitioned_aggregation_node.h"
+#include "exec/spill_sort_node.h"
+#include "exec/topn_node.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "olap/options.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/descriptor_helper.h"
+#include "util/file_utils.h"
+#include "util/perf_counters.h"
+
+namespace doris {
+
+static const int64_t kNumRows = 1024 * 1024;
+// rows of the build side of hash joins, which is joined by kNumRows rows
+static const int64_t kNumBuildRows = 256 * 1024;
+static const int64_t kLowCardinality = 1024;
+static const double kZipfExponent = 1.0;
+static const int64_t kTopNLimit = 100;
+static const int kBatchSize = 1024;
+static const uint32_t kSeed = 20191101;
+
+// symbols of the builtin sum(BIGINT) and count(), the same as FunctionSet in fe
+static const std::string kAggFnPrefix = "_ZN5doris18AggregateFunctions";
+static const std::string kInitNullSymbol =
+    kAggFnPrefix + "9init_nullEPN9doris_udf15FunctionContextEPNS1_6AnyValE";
+static const std::string kSumBigintSymbol =
+    kAggFnPrefix + "3sumIN9doris_udf9BigIntValES3_EEvPNS2_15FunctionContextERKT_PT0_";
+static const std::string kInitZeroBigintSymbol =
+    kAggFnPrefix + "9init_zeroIN9doris_udf9BigIntValEEEvPNS2_15FunctionContextEPT_";
+static const std::string kCountUpdateSymbol =
+    kAggFnPrefix + "12count_updateEPN9doris_udf15FunctionContextERKNS1_6AnyValEPNS1_9BigIntValE";
+static const std::string kCountMergeSymbol =
+    kAggFnPrefix + "11count_mergeEPN9doris_udf15FunctionContextERKNS1_9BigIntValEPS4_";
+
+enum class KeyDistribution {
+    // every key appears the same number of times, in random order
+    UNIQUE,
+    // zipf distribution
+    SKEWED,
+    LOW_CARDINALITY,
+};
+
+static const char* distribution_name(KeyDistribution dist) {
+    switch (dist) {
+    case KeyDistribution::UNIQUE:
+        return "unique";
+    case KeyDistribution::SKEWED:
+        return "skewed";
+    case KeyDistribution::LOW_CARDINALITY:
+        return "low_cardinality";
+    }
+    return "unknown";
+}
+
+// generate 'num' keys in [0, cardinality)
+static std::vector<int64_t> generate_keys(KeyDistribution dist, int64_t num, int64_t cardinality) {
+    std::mt19937_64 rng(kSeed);
+    std::vector<int64_t> keys(num);
+    switch (dist) {
+    case KeyDistribution::UNIQUE:
+        for (int64_t i = 0; i < num; ++i) {
+            keys[i] = i % cardinality;
+        }
+        std::shuffle(keys.begin(), keys.end(), rng);
+        break;
+    case KeyDistribution::SKEWED: {
+        std::vector<double> cdf(cardinality);
+        double sum = 0;
+        for (int64_t i = 0; i < cardinality; ++i) {
+            sum += 1.0 / pow(i + 1, kZipfExponent);
+            cdf[i] = sum;
+        }
+        std::uniform_real_distribution<double> uniform(0, sum);
+        for (int64_t i = 0; i < num; ++i) {
+            int64_t key = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+            keys[i] = std::min(key, cardinality - 1);
+        }
+        break;
+    }
+    case KeyDistribution::LOW_CARDINALITY: {
+        std::uniform_int_distribution<int64_t> uniform(0, std::min(kLowCardinality, cardinality) - 1);
+        for (int64_t i = 0; i < num; ++i) {
+            keys[i] = uniform(rng);
+        }
+        break;
+    }
+    }
+    return keys;
+}
+
+static TTypeDesc bigint_type() {
+    TTypeNode node;
+    node.type = TTypeNodeType::SCALAR;
+    node.__isset.scalar_type = true;
+    node.scalar_type.type = TPrimitiveType::BIGINT;
+    TTypeDesc type_desc;
+    type_desc.types.push_back(node);
+    return type_desc;
+}
+
+static TExpr slot_ref(const SlotDescriptor* slot) {
+    TExprNode node;
+    node.node_type = TExprNodeType::SLOT_REF;
+    node.type = bigint_type();
+    node.num_children = 0;
+    node.output_scale = -1;
+    TSlotRef ref;
+    ref.slot_id = slot->id();
+    ref.tuple_id = slot->parent();
+    node.__set_slot_ref(ref);
+    TExpr expr;
+    expr.nodes.push_back(node);
+    return expr;
+}
+
+// an aggregate function of BIGINT 'input' which returns BIGINT
+static TExpr agg_expr(const std::string& name, const std::string& init_symbol,
+                      const std::string& update_symbol, const std::string& merge_symbol,
+                      const TExpr& input) {
+    TFunction fn;
+    fn.name.function_name = name;
+    fn.binary_type = TFunctionBinaryType::BUILTIN;
+    fn.arg_types.push_back(bigint_type());
+    fn.ret_type = bigint_type();
+    fn.has_var_args = false;
+    TAggregateFunction agg_fn;
+    agg_fn.intermediate_type = bigint_type();
+    agg_fn.__set_init_fn_symbol(init_symbol);
+    agg_fn.__set_update_fn_symbol(update_symbol);
+    agg_fn.__set_merge_fn_symbol(merge_symbol);
+    fn.__set_aggregate_fn(agg_fn);
+
+    TExprNode node;
+    node.node_type = TExprNodeType::AGG_EXPR;
+    node.type = bigint_type();
+    node.num_children = 1;
+    node.output_scale = -1;
+    TAggregateExpr agg;
+    agg.is_merge_agg = false;
+    node.__set_agg_expr(agg);
+    node.__set_fn(fn);
+
+    TExpr expr;
+    expr.nodes.push_back(node);
+    expr.nodes.insert(expr.nodes.end(), input.nodes.begin(), input.nodes.end());
+    return expr;
+}
+
+static TPlanNode plan_node(int id, TPlanNodeType::type type,
+                           const std::vector<TTupleId>& row_tuples, int num_children) {
+    TPlanNode tnode;
+    tnode.node_id = id;
+    tnode.node_type = type;
+    tnode.num_children = num_children;
+    tnode.limit = -1;
+    tnode.row_tuples = row_tuples;
+    tnode.nullable_tuples.assign(row_tuples.size(), false);
+    tnode.compact_data = false;
+    return tnode;
+}
+
+// Add a tuple of 'width' bytes of BIGINT slots and return its id. The first
+// slot is the key and the second one is the value to aggregate.
+static TTupleId add_input_tuple(TDescriptorTableBuilder* dtb, int width) {
+    // tuple ids are assigned in order by TTupleDescriptorBuilder
+    TTupleId id = dtb->desc_tbl().tupleDescriptors.size();
+    TTupleDescriptorBuilder tuple_builder;
+    int num_slots = width / sizeof(int64_t);
+    for (int i = 0; i < num_slots; ++i) {
+        tuple_builder.add_slot(
+            TSlotDescriptorBuilder().type(TYPE_BIGINT).nullable(false).column_pos(i).build());
+    }
+    tuple_builder.build(dtb);
+    return id;
+}
+
+// Add a tuple of the grouping key, sum() and count(), and return its id
+static TTupleId add_agg_tuple(TDescriptorTableBuilder* dtb) {
+    TTupleId id = dtb->desc_tbl().tupleDescriptors.size();
+    TTupleDescriptorBuilder tuple_builder;
+    tuple_builder.add_slot(TSlotDescriptorBuilder().type(TYPE_BIGINT).nullable(true).build());
+    // sum() is null if there is no input
+    tuple_builder.add_slot(TSlotDescriptorBuilder().type(TYPE_BIGINT).nullable(true).build());
+    tuple_builder.add_slot(TSlotDescriptorBuilder().type(TYPE_BIGINT).nullable(false).build());
+    tuple_builder.build(dtb);
+    return id;
+}
+
+// Tuples of an input, which are shared by all iterations
+class InputTuples {
+public:
+    InputTuples(const TupleDescriptor* tuple_desc, const std::vector<int64_t>& keys)
+            : _pool(&_tracker) {
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+        _tuples.reserve(keys.size());
+        for (int64_t i = 0; i < keys.size(); ++i) {
+            Tuple* tuple = Tuple::create(tuple_desc->byte_size(), &_pool);
+            *(int64_t*)tuple->get_slot(slots[0]->tuple_offset()) = keys[i];
+            for (int j = 1; j < slots.size(); ++j) {
+                *(int64_t*)tuple->get_slot(slots[j]->tuple_offset()) = i + j;
+            }
+            _tuples.push_back(tuple);
+        }
+        _bytes = keys.size() * tuple_desc->byte_size();
+    }
+
+    const std::vector<Tuple*>& tuples() const { return _tuples; }
+    int64_t bytes() const { return _bytes; }
+
+private:
+    MemTracker _tracker;
+    MemPool _pool;
+    std::vector<Tuple*> _tuples;
+    int64_t _bytes = 0;
+};
+
+// Returns rows of the given tuples without copying them, like a scan node or
+// an exchange node which feeds the node being measured.
+class TupleSourceNode : public ExecNode {
+public:
+    TupleSourceNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                    const InputTuples* input)
+            : ExecNode(pool, tnode, descs), _input(input) {
+    }
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        const std::vector<Tuple*>& tuples = _input->tuples();
+        while (_next < tuples.size() && !row_batch->at_capacity()) {
+            int idx = row_batch->add_row();
+            row_batch->get_row(idx)->set_tuple(0, tuples[_next++]);
+            row_batch->commit_last_row();
+            ++_num_rows_returned;
+        }
+        *eos = _next == tuples.size();
+        return Status::OK();
+    }
+
+private:
+    const InputTuples* _input;
+    size_t _next = 0;
+};
+
+static ExecEnv* init_exec_env() {
+    std::vector<StorePath> paths;
+    paths.emplace_back(std::string(getenv("DORIS_HOME")) + "/exec_benchmark_data", -1);
+    for (auto& dir : { paths[0].path, config::sys_log_dir }) {
+        Status st = FileUtils::create_dir(dir);
+        if (!st.ok()) {
+            fprintf(stderr, "failed to create %s: %s\n", dir.c_str(), st.get_error_msg().c_str());
+            return nullptr;
+        }
+    }
+
+    char arg0[] = "exec_benchmark";
+    char* argv[] = { arg0, nullptr };
+    init_daemon(1, argv, paths);
+    ExecEnv* exec_env = ExecEnv::GetInstance();
+    Status st = ExecEnv::init(exec_env, paths);
+    if (!st.ok()) {
+        fprintf(stderr, "failed to init exec env: %s\n", st.get_error_msg().c_str());
+        return nullptr;
+    }
+    return exec_env;
+}
+
+// the ExecEnv shared by all benchmarks, nullptr if it fails to init
+static ExecEnv* benchmark_exec_env() {
+    static ExecEnv* exec_env = init_exec_env();
+    return exec_env;
+}
+
+// Create a RuntimeState in the same way as PlanFragmentExecutor::prepare()
+static Status create_runtime_state(ExecEnv* exec_env, DescriptorTbl* desc_tbl,
+                                   std::unique_ptr<RuntimeState>* state) {
+    static int64_t next_query_id = 0;
+    TExecPlanFragmentParams params;
+    params.params.query_id.hi = 0;
+    params.params.query_id.lo = ++next_query_id;
+    params.params.fragment_instance_id = params.params.query_id;
+    TQueryOptions query_options;
+    query_options.__set_batch_size(kBatchSize);
+    state->reset(new RuntimeState(params, query_options, TQueryGlobals(), exec_env));
+    (*state)->set_desc_tbl(desc_tbl);
+    RETURN_IF_ERROR((*state)->init_mem_trackers(params.params.query_id));
+    RETURN_IF_ERROR((*state)->create_block_mgr());
+    return Status::OK();
+}
+
+// Create the sources for 'inputs' as children of 'node' and init them all
+static Status init_node(RuntimeState* state, ExecNode* node, const TPlanNode& tnode,
+                        const std::vector<std::pair<TTupleId, const InputTuples*>>& inputs) {
+    ObjectPool* pool = state->obj_pool();
+    for (int i = 0; i < inputs.size(); ++i) {
+        TPlanNode source_tnode = plan_node(tnode.node_id + 1 + i, TPlanNodeType::EXCHANGE_NODE,
+                                           { inputs[i].first }, 0);
+        ExecNode* source = pool->add(
+            new TupleSourceNode(pool, source_tnode, state->desc_tbl(), inputs[i].second));
+        RETURN_IF_ERROR(source->init(source_tnode, state));
+        node->add_child(source);
+    }
+    return node->init(tnode, state);
+}
+
+typedef std::function<Status(RuntimeState*, ExecNode**)> CreateNodeFunc;
+
+// Hardware counters which are reported per input row
+class HardwareCounters {
+public:
+    HardwareCounters() {
+        add(PerfCounters::PERF_COUNTER_HW_CPU_CYCLES, "cycles_per_row");
+        add(PerfCounters::PERF_COUNTER_HW_INSTRUCTIONS, "instructions_per_row");
+        add(PerfCounters::PERF_COUNTER_HW_CACHE_MISSES, "cache_misses_per_row");
+        add(PerfCounters::PERF_COUNTER_HW_BRANCH_MISSES, "branch_misses_per_row");
+        _totals.resize(_names.size());
+    }
+
+    void start() { _counters.snapshot(""); }
+
+    void stop() {
+        _counters.snapshot("");
+        int num = _snapshots++ * 2;
+        const std::vector<int64_t>* begin = _counters.counters(num);
+        const std::vector<int64_t>* end = _counters.counters(num + 1);
+        if (begin == nullptr || end == nullptr) {
+            return;
+        }
+        for (int i = 0; i < _totals.size(); ++i) {
+            _totals[i] += (*end)[i] - (*begin)[i];
+        }
+    }
+
+    void report(BenchmarkState* state, int64_t rows) const {
+        for (int i = 0; i < _names.size(); ++i) {
+            state->set_counter(_names[i], rows > 0 ? (double)_totals[i] / rows : 0);
+        }
+    }
+
+private:
+    void add(PerfCounters::Counter counter, const std::string& name) {
+        // not available without permission of perf events
+        if (_counters.add_counter(counter)) {
+            _names.push_back(name);
+        }
+    }
+
+    PerfCounters _counters;
+    std::vector<std::string> _names;
+    std::vector<int64_t> _totals;
+    int _snapshots = 0;
+};
+
+// Run the node created by 'create_node' once in each iteration. Creating,
+// preparing and closing the node are not measured.
+static void run_node(BenchmarkState* state, DescriptorTbl* desc_tbl,
+                     const CreateNodeFunc& create_node, int64_t input_rows, int64_t input_bytes) {
+    ExecEnv* exec_env = benchmark_exec_env();
+    if (exec_env == nullptr) {
+        state->skip_with_error("failed to init exec env");
+        return;
+    }
+    HardwareCounters counters;
+    int64_t rows_returned = 0;
+    while (state->keep_running()) {
+        state->pause_timing();
+        std::unique_ptr<RuntimeState> runtime_state;
+        ExecNode* node = nullptr;
+        Status st = create_runtime_state(exec_env, desc_tbl, &runtime_state);
+        if (st.ok()) {
+            st = create_node(runtime_state.get(), &node);
+        }
+        if (st.ok()) {
+            st = node->prepare(runtime_state.get());
+        }
+        counters.start();
+        state->resume_timing();
+
+        if (st.ok()) {
+            st = node->open(runtime_state.get());
+        }
+        if (st.ok()) {
+            RowBatch batch(node->row_desc(), runtime_state->batch_size(),
+                           runtime_state->instance_mem_tracker());
+            bool eos = false;
+            while (st.ok() && !eos) {
+                st = node->get_next(runtime_state.get(), &batch, &eos);
+                rows_returned += batch.num_rows();
+                batch.reset();
+            }
+        }
+
+        state->pause_timing();
+        counters.stop();
+        if (node != nullptr) {
+            node->close(runtime_state.get());
+        }
+        if (runtime_state != nullptr) {
+            exec_env->thread_mgr()->unregister_pool(runtime_state->resource_pool());
+        }
+        runtime_state.reset();
+        if (!st.ok()) {
+            state->skip_with_error(st.get_error_msg());
+        }
+        state->resume_timing();
+    }
+    state->set_items_processed(state->iterations() * input_rows);
+    state->set_bytes_processed(state->iterations() * input_bytes);
+    state->set_counter("rows_returned", (double)rows_returned / state->iterations());
+    counters.report(state, state->iterations() * input_rows);
+}
+
+// Inner join of kNumRows probe rows whose keys are of 'dist' with
+// kNumBuildRows build rows of unique keys
+static void BM_HashJoin(BenchmarkState* state, KeyDistribution dist, int width) {
+    TDescriptorTableBuilder dtb;
+    TTupleId probe_tuple_id = add_input_tuple(&dtb, width);
+    TTupleId build_tuple_id = add_input_tuple(&dtb, width);
+    ObjectPool pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    Status st = DescriptorTbl::create(&pool, dtb.desc_tbl(), &desc_tbl);
+    if (!st.ok()) {
+        state->skip_with_error(st.get_error_msg());
+        return;
+    }
+    const TupleDescriptor* probe_desc = desc_tbl->get_tuple_descriptor(probe_tuple_id);
+    const TupleDescriptor* build_desc = desc_tbl->get_tuple_descriptor(build_tuple_id);
+    InputTuples probe(probe_desc, generate_keys(dist, kNumRows, kNumBuildRows));
+    InputTuples build(build_desc,
+                      generate_keys(KeyDistribution::UNIQUE, kNumBuildRows, kNumBuildRows));
+
+    TPlanNode tnode = plan_node(0, TPlanNodeType::HASH_JOIN_NODE,
+                                { probe_tuple_id, build_tuple_id }, 2);
+    THashJoinNode join_node;
+    join_node.join_op = TJoinOp::INNER_JOIN;
+    TEqJoinCondition condition;
+    condition.left = slot_ref(probe_desc->slots()[0]);
+    condition.right = slot_ref(build_desc->slots()[0]);
+    join_node.eq_join_conjuncts.push_back(condition);
+    tnode.__set_hash_join_node(join_node);
+
+    auto create_node = [&](RuntimeState* runtime_state, ExecNode** node) {
+        ObjectPool* obj_pool = runtime_state->obj_pool();
+        *node = obj_pool->add(new HashJoinNode(obj_pool, tnode, *desc_tbl));
+        return init_node(runtime_state, *node, tnode,
+                         { { probe_tuple_id, &probe }, { build_tuple_id, &build } });
+    };
+    run_node(state, desc_tbl, create_node, kNumRows + kNumBuildRows,
+             probe.bytes() + build.bytes());
+}
+
+// select k, sum(v), count(v) group by k
+static void BM_Aggregation(BenchmarkState* state, KeyDistribution dist, int width) {
+    TDescriptorTableBuilder dtb;
+    TTupleId input_tuple_id = add_input_tuple(&dtb, width);
+    TTupleId intermediate_tuple_id = add_agg_tuple(&dtb);
+    TTupleId output_tuple_id = add_agg_tuple(&dtb);
+    ObjectPool pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    Status st = DescriptorTbl::create(&pool, dtb.desc_tbl(), &desc_tbl);
+    if (!st.ok()) {
+        state->skip_with_error(st.get_error_msg());
+        return;
+    }
+    const TupleDescriptor* input_desc = desc_tbl->get_tuple_descriptor(input_tuple_id);
+    InputTuples input(input_desc, generate_keys(dist, kNumRows, kNumRows));
+
+    TPlanNode tnode = plan_node(0, TPlanNodeType::AGGREGATION_NODE, { output_tuple_id }, 1);
+    TAggregationNode agg_node;
+    agg_node.grouping_exprs.push_back(slot_ref(input_desc->slots()[0]));
+    TExpr value = slot_ref(input_desc->slots()[1]);
+    agg_node.aggregate_functions.push_back(
+        agg_expr("sum", kInitNullSymbol, kSumBigintSymbol, kSumBigintSymbol, value));
+    agg_node.aggregate_functions.push_back(
+        agg_expr("count", kInitZeroBigintSymbol, kCountUpdateSymbol, kCountMergeSymbol, value));
+    agg_node.__isset.grouping_exprs = true;
+    agg_node.intermediate_tuple_id = intermediate_tuple_id;
+    agg_node.output_tuple_id = output_tuple_id;
+    agg_node.need_finalize = true;
+    tnode.__set_agg_node(agg_node);
+
+    auto create_node = [&](RuntimeState* runtime_state, ExecNode** node) {
+        ObjectPool* obj_pool = runtime_state->obj_pool();
+        *node = obj_pool->add(new NewPartitionedAggregationNode(obj_pool, tnode, *desc_tbl));
+        return init_node(runtime_state, *node, tnode, { { input_tuple_id, &input } });
+    };
+    run_node(state, desc_tbl, create_node, kNumRows, input.bytes());
+}
+
+// select * order by k, by SpillSortNode or by TopNNode with limit kTopNLimit
+static void BM_Sort(BenchmarkState* state, KeyDistribution dist, int width, bool top_n) {
+    TDescriptorTableBuilder dtb;
+    TTupleId input_tuple_id = add_input_tuple(&dtb, width);
+    TTupleId sort_tuple_id = add_input_tuple(&dtb, width);
+    ObjectPool pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    Status st = DescriptorTbl::create(&pool, dtb.desc_tbl(), &desc_tbl);
+    if (!st.ok()) {
+        state->skip_with_error(st.get_error_msg());
+        return;
+    }
+    const TupleDescriptor* input_desc = desc_tbl->get_tuple_descriptor(input_tuple_id);
+    const TupleDescriptor* sort_desc = desc_tbl->get_tuple_descriptor(sort_tuple_id);
+    InputTuples input(input_desc, generate_keys(dist, kNumRows, kNumRows));
+
+    TPlanNode tnode = plan_node(0, TPlanNodeType::SORT_NODE, { sort_tuple_id }, 1);
+    if (top_n) {
+        tnode.limit = kTopNLimit;
+    }
+    TSortNode sort_node;
+    sort_node.use_top_n = top_n;
+    // rows are materialized into sort tuples as planned by fe
+    sort_node.sort_info.ordering_exprs.push_back(slot_ref(sort_desc->slots()[0]));
+    sort_node.sort_info.is_asc_order.push_back(true);
+    sort_node.sort_info.nulls_first.push_back(false);
+    std::vector<TExpr> slot_exprs;
+    for (auto slot : input_desc->slots()) {
+        slot_exprs.push_back(slot_ref(slot));
+    }
+    sort_node.sort_info.__set_sort_tuple_slot_exprs(slot_exprs);
+    tnode.__set_sort_node(sort_node);
+
+    auto create_node = [&](RuntimeState* runtime_state, ExecNode** node) {
+        ObjectPool* obj_pool = runtime_state->obj_pool();
+        if (top_n) {
+            *node = obj_pool->add(new TopNNode(obj_pool, tnode, *desc_tbl));
+        } else {
+            *node = obj_pool->add(new SpillSortNode(obj_pool, tnode, *desc_tbl));
+        }
+        return init_node(runtime_state, *node, tnode, { { input_tuple_id, &input } });
+    };
+    run_node(state, desc_tbl, create_node, kNumRows, input.bytes());
+}
+
+static void register_benchmarks() {
+    for (KeyDistribution dist : { KeyDistribution::UNIQUE, KeyDistribution::SKEWED,
+                                  KeyDistribution::LOW_CARDINALITY }) {
+        for (int width : { 16, 64, 256 }) {
+            std::string suffix = std::string("/") + distribution_name(dist)
+                + "/width_" + std::to_string(width);
+            register_benchmark("BM_HashJoin" + suffix, [dist, width](BenchmarkState* state) {
+                BM_HashJoin(state, dist, width);
+            });
+            register_benchmark("BM_Aggregation" + suffix, [dist, width](BenchmarkState* state) {
+                BM_Aggregation(state, dist, width);
+            });
+            register_benchmark("BM_Sort" + suffix, [dist, width](BenchmarkState* state) {
+                BM_Sort(state, dist, width, false);
+            });
+            register_benchmark("BM_TopN" + suffix, [dist, width](BenchmarkState* state) {
+                BM_Sort(state, dist, width, true);
+            });
+        }
+    }
+}
+
+static int s_registered = (register_benchmarks(), 0);
+
+}
+
+BENCHMARK_MAIN();
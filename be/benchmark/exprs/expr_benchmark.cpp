@@ -0,0 +1,789 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Benchmarks of exprs and builtin functions on a fixed dataset. Every expr is
+// evaluated over the same kNumRows rows, which are generated once with a fixed
+// seed, in three modes:
+//   interpreted  ExprContext::get_value() for each row
+//   codegen      the jitted compute function of the expr for each row, which
+//                is skipped with the error if the expr can not be codegened
+//   batch        Expr::get_*_vals() or filter_batch() for each RowBatch,
+//                only for exprs of numeric and boolean results
+// Exprs are built from thrift in the same way as fe sends them, with the
+// symbols of doris_builtins_functions.py. ns_per_row is reported along with
+// the ratio of null results, or of true results for predicates, which should
+// be the same in all modes.
+//
+//   expr_benchmark --benchmark_filter=like --benchmark_out=result.json
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_runner.h"
+#include "codegen/codegen_anyval.h"
+#include "codegen/llvm_codegen.h"
+#include "common/config.h"
+#include "common/daemon.h"
+#include "common/object_pool.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "olap/options.h"
+#include "runtime/datetime_value.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "udf/udf.h"
+#include "util/descriptor_helper.h"
+#include "util/file_utils.h"
+#include "util/stopwatch.hpp"
+
+namespace doris {
+
+static const int64_t kNumRows = 256 * 1024;
+static const int kBatchSize = 1024;
+static const uint32_t kSeed = 20191101;
+
+// symbols of the builtins, the same as gensrc/script/doris_builtins_functions.py
+static const std::string kUdfContext = "EPN9doris_udf15FunctionContext";
+static const std::string kStateScope = kUdfContext + "ENS2_18FunctionStateScopeE";
+static const std::string kCastToIntSymbol =
+    "_ZN5doris13CastFunctions15cast_to_int_val" + kUdfContext + "ERKNS1_9StringValE";
+static const std::string kLikeSymbol =
+    "_ZN5doris13LikePredicate4like" + kUdfContext + "ERKNS1_9StringValES6_";
+static const std::string kLikePrepareSymbol =
+    "_ZN5doris13LikePredicate12like_prepare" + kStateScope;
+static const std::string kLikeCloseSymbol =
+    "_ZN5doris13LikePredicate10like_close" + kStateScope;
+static const std::string kGetJsonIntSymbol =
+    "_ZN5doris13JsonFunctions12get_json_int" + kUdfContext + "ERKNS1_9StringValES6_";
+static const std::string kGetJsonStringSymbol =
+    "_ZN5doris13JsonFunctions15get_json_string" + kUdfContext + "ERKNS1_9StringValES6_";
+static const std::string kJsonPathPrepareSymbol =
+    "_ZN5doris13JsonFunctions17json_path_prepare" + kStateScope;
+static const std::string kJsonPathCloseSymbol =
+    "_ZN5doris13JsonFunctions15json_path_close" + kStateScope;
+static const std::string kConvertTzSymbol =
+    "_ZN5doris18TimestampFunctions10convert_tz" + kUdfContext
+    + "ERKNS1_11DateTimeValERKNS1_9StringValES9_";
+static const std::string kConvertTzPrepareSymbol =
+    "_ZN5doris18TimestampFunctions18convert_tz_prepare" + kStateScope;
+static const std::string kTimezoneCloseSymbol =
+    "_ZN5doris18TimestampFunctions14timezone_close" + kStateScope;
+static const std::string kDateFormatSymbol =
+    "_ZN5doris18TimestampFunctions11date_format" + kUdfContext
+    + "ERKNS1_11DateTimeValERKNS1_9StringValE";
+static const std::string kSubstringSymbol =
+    "_ZN5doris15StringFunctions9substring" + kUdfContext
+    + "ERKNS1_9StringValERKNS1_6IntValES9_";
+static const std::string kUpperSymbol =
+    "_ZN5doris15StringFunctions5upper" + kUdfContext + "ERKNS1_9StringValE";
+static const std::string kLengthSymbol =
+    "_ZN5doris15StringFunctions6length" + kUdfContext + "ERKNS1_9StringValE";
+static const std::string kConcatSymbol =
+    "_ZN5doris15StringFunctions6concat" + kUdfContext + "EiPKNS1_9StringValE";
+static const std::string kSplitPartSymbol =
+    "_ZN5doris15StringFunctions10split_part" + kUdfContext
+    + "ERKNS1_9StringValES6_RKNS1_6IntValE";
+
+// words of the text column, some of which are searched by LIKE
+static const char* kWords[] = {
+    "apache", "doris", "olap", "query", "vector", "storage",
+    "engine", "tablet", "rowset", "segment", "column", "bitmap",
+};
+
+// columns of the input tuple
+enum Column {
+    // BIGINT in [0, 2^20)
+    COL_A,
+    // BIGINT in [0, 2^32)
+    COL_B,
+    // VARCHAR of INT, eg. "-12345"
+    COL_INT_STR,
+    // VARCHAR of 2 to 8 words separated by spaces
+    COL_TEXT,
+    // VARCHAR of {"id": <int>, "name": <word>, "attrs": {"k1": <word>, "k2": <int>}}
+    COL_JSON,
+    // DATETIME between 2000-01-01 and 2019-12-28
+    COL_DT,
+    NUM_COLUMNS,
+};
+
+enum class EvalMode {
+    INTERPRETED,
+    CODEGEN,
+    BATCH,
+};
+
+static const char* mode_name(EvalMode mode) {
+    switch (mode) {
+    case EvalMode::INTERPRETED:
+        return "interpreted";
+    case EvalMode::CODEGEN:
+        return "codegen";
+    case EvalMode::BATCH:
+        return "batch";
+    }
+    return "unknown";
+}
+
+static TTypeDesc scalar_type(TPrimitiveType::type type) {
+    TTypeNode node;
+    node.type = TTypeNodeType::SCALAR;
+    node.__isset.scalar_type = true;
+    node.scalar_type.type = type;
+    if (type == TPrimitiveType::VARCHAR) {
+        node.scalar_type.__set_len(65535);
+    }
+    TTypeDesc type_desc;
+    type_desc.types.push_back(node);
+    return type_desc;
+}
+
+static TExprNode expr_node(TExprNodeType::type node_type, TPrimitiveType::type type) {
+    TExprNode node;
+    node.node_type = node_type;
+    node.type = scalar_type(type);
+    node.num_children = 0;
+    node.output_scale = -1;
+    return node;
+}
+
+// flatten 'node' and its children in the depth first order
+static TExpr make_expr(TExprNode node, const std::vector<TExpr>& children) {
+    node.num_children = children.size();
+    TExpr expr;
+    expr.nodes.push_back(node);
+    for (auto& child : children) {
+        expr.nodes.insert(expr.nodes.end(), child.nodes.begin(), child.nodes.end());
+    }
+    return expr;
+}
+
+static TExpr slot_ref(const SlotDescriptor* slot) {
+    TExprNode node = expr_node(TExprNodeType::SLOT_REF, TPrimitiveType::BIGINT);
+    node.type = slot->type().to_thrift();
+    TSlotRef ref;
+    ref.slot_id = slot->id();
+    ref.tuple_id = slot->parent();
+    node.__set_slot_ref(ref);
+    return make_expr(node, {});
+}
+
+static TExpr int_literal(TPrimitiveType::type type, int64_t value) {
+    TExprNode node = expr_node(TExprNodeType::INT_LITERAL, type);
+    TIntLiteral literal;
+    literal.value = value;
+    node.__set_int_literal(literal);
+    return make_expr(node, {});
+}
+
+static TExpr string_literal(const std::string& value) {
+    TExprNode node = expr_node(TExprNodeType::STRING_LITERAL, TPrimitiveType::VARCHAR);
+    TStringLiteral literal;
+    literal.value = value;
+    node.__set_string_literal(literal);
+    return make_expr(node, {});
+}
+
+static TExpr arithmetic_expr(TExprOpcode::type op, const TExpr& left, const TExpr& right) {
+    TExprNode node = expr_node(TExprNodeType::ARITHMETIC_EXPR, TPrimitiveType::BIGINT);
+    node.__set_opcode(op);
+    return make_expr(node, { left, right });
+}
+
+static TExpr binary_pred(TExprOpcode::type op, const TExpr& left, const TExpr& right) {
+    TExprNode node = expr_node(TExprNodeType::BINARY_PRED, TPrimitiveType::BOOLEAN);
+    node.__set_opcode(op);
+    node.__set_child_type(left.nodes[0].type.types[0].scalar_type.type);
+    return make_expr(node, { left, right });
+}
+
+// A call of the builtin 'symbol'. Children from 'vararg_start_idx' are var args
+// if it is not negative.
+static TExpr fn_call(TExprNodeType::type node_type, const std::string& name,
+                     TPrimitiveType::type ret_type, const std::vector<TExpr>& args,
+                     const std::string& symbol, const std::string& prepare_symbol = "",
+                     const std::string& close_symbol = "", int vararg_start_idx = -1) {
+    TExprNode node = expr_node(node_type, ret_type);
+    TFunction fn;
+    fn.name.function_name = name;
+    fn.binary_type = TFunctionBinaryType::BUILTIN;
+    int num_arg_types = vararg_start_idx < 0 ? args.size() : vararg_start_idx + 1;
+    for (int i = 0; i < num_arg_types; ++i) {
+        fn.arg_types.push_back(args[i].nodes[0].type);
+    }
+    fn.ret_type = node.type;
+    fn.has_var_args = vararg_start_idx >= 0;
+    TScalarFunction scalar_fn;
+    scalar_fn.symbol = symbol;
+    if (!prepare_symbol.empty()) {
+        scalar_fn.__set_prepare_fn_symbol(prepare_symbol);
+        scalar_fn.__set_close_fn_symbol(close_symbol);
+    }
+    fn.__set_scalar_fn(scalar_fn);
+    node.__set_fn(fn);
+    if (vararg_start_idx >= 0) {
+        node.__set_vararg_start_idx(vararg_start_idx);
+    }
+    return make_expr(node, args);
+}
+
+static TExpr fn_call(const std::string& name, TPrimitiveType::type ret_type,
+                     const std::vector<TExpr>& args, const std::string& symbol,
+                     const std::string& prepare_symbol = "",
+                     const std::string& close_symbol = "", int vararg_start_idx = -1) {
+    return fn_call(TExprNodeType::FUNCTION_CALL, name, ret_type, args, symbol,
+                   prepare_symbol, close_symbol, vararg_start_idx);
+}
+
+// The input rows, which are shared by all benchmarks
+class ExprDataset {
+public:
+    ExprDataset() : _pool(&_tracker) { }
+
+    Status init() {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        for (int i = 0; i < NUM_COLUMNS; ++i) {
+            TSlotDescriptorBuilder slot_builder;
+            switch (i) {
+            case COL_A:
+            case COL_B:
+                slot_builder.type(TYPE_BIGINT);
+                break;
+            case COL_DT:
+                slot_builder.type(TYPE_DATETIME);
+                break;
+            default:
+                slot_builder.string_type(65535);
+                break;
+            }
+            tuple_builder.add_slot(slot_builder.nullable(false).column_pos(i).build());
+        }
+        tuple_builder.build(&dtb);
+        RETURN_IF_ERROR(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl));
+        _row_desc.reset(new RowDescriptor(*_desc_tbl, { 0 }, { false }));
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+
+        std::mt19937_64 rng(kSeed);
+        int num_words = sizeof(kWords) / sizeof(kWords[0]);
+        std::uniform_int_distribution<int> word_dist(0, num_words - 1);
+        std::uniform_int_distribution<int> num_words_dist(2, 8);
+        std::uniform_int_distribution<int32_t> int_dist(-1000000000, 1000000000);
+        for (int64_t i = 0; i < kNumRows; i += kBatchSize) {
+            RowBatch* batch = new RowBatch(*_row_desc, kBatchSize, &_tracker);
+            _batches.emplace_back(batch);
+            for (int j = 0; j < kBatchSize && i + j < kNumRows; ++j) {
+                Tuple* tuple = Tuple::create(tuple_desc->byte_size(), &_pool);
+                for (int k = 0; k < NUM_COLUMNS; ++k) {
+                    void* slot = tuple->get_slot(tuple_desc->slots()[k]->tuple_offset());
+                    std::string str;
+                    switch (k) {
+                    case COL_A:
+                        *(int64_t*)slot = rng() % (1 << 20);
+                        continue;
+                    case COL_B:
+                        *(int64_t*)slot = rng() % (1LL << 32);
+                        continue;
+                    case COL_DT: {
+                        int64_t date = (2000 + rng() % 20) * 10000 + (1 + rng() % 12) * 100
+                            + (1 + rng() % 28);
+                        int64_t time = (rng() % 24) * 10000 + (rng() % 60) * 100 + rng() % 60;
+                        DateTimeValue value;
+                        value.from_date_int64(date * 1000000 + time);
+                        value.to_datetime();
+                        *(DateTimeValue*)slot = value;
+                        continue;
+                    }
+                    case COL_INT_STR:
+                        str = std::to_string(int_dist(rng));
+                        break;
+                    case COL_TEXT: {
+                        int n = num_words_dist(rng);
+                        for (int w = 0; w < n; ++w) {
+                            if (w > 0) {
+                                str.push_back(' ');
+                            }
+                            str.append(kWords[word_dist(rng)]);
+                        }
+                        break;
+                    }
+                    case COL_JSON:
+                        str = "{\"id\": " + std::to_string(int_dist(rng))
+                            + ", \"name\": \"" + kWords[word_dist(rng)]
+                            + "\", \"attrs\": {\"k1\": \"" + kWords[word_dist(rng)]
+                            + "\", \"k2\": " + std::to_string(int_dist(rng)) + "}}";
+                        break;
+                    }
+                    char* ptr = (char*)_pool.allocate(str.size());
+                    memcpy(ptr, str.data(), str.size());
+                    *(StringValue*)slot = StringValue(ptr, str.size());
+                }
+                int idx = batch->add_row();
+                batch->get_row(idx)->set_tuple(0, tuple);
+                batch->commit_last_row();
+            }
+        }
+        return Status::OK();
+    }
+
+    DescriptorTbl* desc_tbl() const { return _desc_tbl; }
+    const RowDescriptor& row_desc() const { return *_row_desc; }
+    const SlotDescriptor* slot(Column column) const {
+        return _desc_tbl->get_tuple_descriptor(0)->slots()[column];
+    }
+    const std::vector<std::unique_ptr<RowBatch>>& batches() const { return _batches; }
+
+private:
+    ObjectPool _obj_pool;
+    MemTracker _tracker;
+    MemPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    std::vector<std::unique_ptr<RowBatch>> _batches;
+};
+
+typedef std::function<TExpr(const ExprDataset&)> BuildExprFunc;
+
+struct ExprCase {
+    std::string name;
+    // type of the result
+    PrimitiveType type;
+    BuildExprFunc build;
+};
+
+static std::vector<ExprCase> expr_cases() {
+    auto like = [](const std::string& pattern) {
+        return [pattern](const ExprDataset& data) {
+            return fn_call("like", TPrimitiveType::BOOLEAN,
+                           { slot_ref(data.slot(COL_TEXT)), string_literal(pattern) },
+                           kLikeSymbol, kLikePrepareSymbol, kLikeCloseSymbol);
+        };
+    };
+    return {
+        // a * 3 + b
+        { "arithmetic", TYPE_BIGINT, [](const ExprDataset& data) {
+            return arithmetic_expr(
+                TExprOpcode::ADD,
+                arithmetic_expr(TExprOpcode::MULTIPLY, slot_ref(data.slot(COL_A)),
+                                int_literal(TPrimitiveType::BIGINT, 3)),
+                slot_ref(data.slot(COL_B)));
+        } },
+        // b % 7
+        { "arithmetic_mod", TYPE_BIGINT, [](const ExprDataset& data) {
+            return arithmetic_expr(TExprOpcode::MOD, slot_ref(data.slot(COL_B)),
+                                   int_literal(TPrimitiveType::BIGINT, 7));
+        } },
+        // a < 2^19, which is true for half of the rows
+        { "compare", TYPE_BOOLEAN, [](const ExprDataset& data) {
+            return binary_pred(TExprOpcode::LT, slot_ref(data.slot(COL_A)),
+                               int_literal(TPrimitiveType::BIGINT, 1 << 19));
+        } },
+        // case when a < 2^18 then b when a < 2^19 then b * 2 else 0 end
+        { "case", TYPE_BIGINT, [](const ExprDataset& data) {
+            TExprNode node = expr_node(TExprNodeType::CASE_EXPR, TPrimitiveType::BIGINT);
+            TCaseExpr case_expr;
+            case_expr.has_case_expr = false;
+            case_expr.has_else_expr = true;
+            node.__set_case_expr(case_expr);
+            TExpr a = slot_ref(data.slot(COL_A));
+            TExpr b = slot_ref(data.slot(COL_B));
+            return make_expr(node, {
+                binary_pred(TExprOpcode::LT, a, int_literal(TPrimitiveType::BIGINT, 1 << 18)),
+                b,
+                binary_pred(TExprOpcode::LT, a, int_literal(TPrimitiveType::BIGINT, 1 << 19)),
+                arithmetic_expr(TExprOpcode::MULTIPLY, b, int_literal(TPrimitiveType::BIGINT, 2)),
+                int_literal(TPrimitiveType::BIGINT, 0) });
+        } },
+        // cast(int_str as int)
+        { "cast_string_to_int", TYPE_INT, [](const ExprDataset& data) {
+            TExpr expr = fn_call(TExprNodeType::CAST_EXPR, "casttoint", TPrimitiveType::INT,
+                                 { slot_ref(data.slot(COL_INT_STR)) }, kCastToIntSymbol);
+            expr.nodes[0].__set_opcode(TExprOpcode::CAST);
+            return expr;
+        } },
+        // the patterns of the fast paths of LikePredicate and of a regex
+        { "like_starts_with", TYPE_BOOLEAN, like("doris%") },
+        { "like_ends_with", TYPE_BOOLEAN, like("%doris") },
+        { "like_substring", TYPE_BOOLEAN, like("%doris%") },
+        { "like_regex", TYPE_BOOLEAN, like("%st_rage%en_ine%") },
+        { "get_json_int", TYPE_INT, [](const ExprDataset& data) {
+            return fn_call("get_json_int", TPrimitiveType::INT,
+                           { slot_ref(data.slot(COL_JSON)), string_literal("$.id") },
+                           kGetJsonIntSymbol, kJsonPathPrepareSymbol, kJsonPathCloseSymbol);
+        } },
+        { "get_json_string", TYPE_VARCHAR, [](const ExprDataset& data) {
+            return fn_call("get_json_string", TPrimitiveType::VARCHAR,
+                           { slot_ref(data.slot(COL_JSON)), string_literal("$.attrs.k1") },
+                           kGetJsonStringSymbol, kJsonPathPrepareSymbol, kJsonPathCloseSymbol);
+        } },
+        { "convert_tz", TYPE_DATETIME, [](const ExprDataset& data) {
+            return fn_call("convert_tz", TPrimitiveType::DATETIME,
+                           { slot_ref(data.slot(COL_DT)), string_literal("Asia/Shanghai"),
+                             string_literal("America/Los_Angeles") },
+                           kConvertTzSymbol, kConvertTzPrepareSymbol, kTimezoneCloseSymbol);
+        } },
+        { "date_format", TYPE_VARCHAR, [](const ExprDataset& data) {
+            return fn_call("date_format", TPrimitiveType::VARCHAR,
+                           { slot_ref(data.slot(COL_DT)), string_literal("%Y-%m-%d %H:%i:%s") },
+                           kDateFormatSymbol);
+        } },
+        { "substring", TYPE_VARCHAR, [](const ExprDataset& data) {
+            return fn_call("substring", TPrimitiveType::VARCHAR,
+                           { slot_ref(data.slot(COL_TEXT)), int_literal(TPrimitiveType::INT, 2),
+                             int_literal(TPrimitiveType::INT, 5) },
+                           kSubstringSymbol);
+        } },
+        { "upper", TYPE_VARCHAR, [](const ExprDataset& data) {
+            return fn_call("upper", TPrimitiveType::VARCHAR, { slot_ref(data.slot(COL_TEXT)) },
+                           kUpperSymbol);
+        } },
+        { "length", TYPE_INT, [](const ExprDataset& data) {
+            return fn_call("length", TPrimitiveType::INT, { slot_ref(data.slot(COL_TEXT)) },
+                           kLengthSymbol);
+        } },
+        { "concat", TYPE_VARCHAR, [](const ExprDataset& data) {
+            return fn_call("concat", TPrimitiveType::VARCHAR,
+                           { slot_ref(data.slot(COL_TEXT)), string_literal("-"),
+                             slot_ref(data.slot(COL_INT_STR)) },
+                           kConcatSymbol, "", "", 0);
+        } },
+        { "split_part", TYPE_VARCHAR, [](const ExprDataset& data) {
+            return fn_call("split_part", TPrimitiveType::VARCHAR,
+                           { slot_ref(data.slot(COL_TEXT)), string_literal(" "),
+                             int_literal(TPrimitiveType::INT, 2) },
+                           kSplitPartSymbol);
+        } },
+    };
+}
+
+static bool has_batch_eval(PrimitiveType type) {
+    switch (type) {
+    case TYPE_BOOLEAN:
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static ExecEnv* init_exec_env() {
+    std::vector<StorePath> paths;
+    paths.emplace_back(std::string(getenv("DORIS_HOME")) + "/expr_benchmark_data", -1);
+    for (auto& dir : { paths[0].path, config::sys_log_dir }) {
+        Status st = FileUtils::create_dir(dir);
+        if (!st.ok()) {
+            fprintf(stderr, "failed to create %s: %s\n", dir.c_str(), st.get_error_msg().c_str());
+            return nullptr;
+        }
+    }
+
+    char arg0[] = "expr_benchmark";
+    char* argv[] = { arg0, nullptr };
+    init_daemon(1, argv, paths);
+    LlvmCodeGen::initialize_llvm();
+    ExecEnv* exec_env = ExecEnv::GetInstance();
+    Status st = ExecEnv::init(exec_env, paths);
+    if (!st.ok()) {
+        fprintf(stderr, "failed to init exec env: %s\n", st.get_error_msg().c_str());
+        return nullptr;
+    }
+    return exec_env;
+}
+
+// the ExecEnv shared by all benchmarks, nullptr if it fails to init
+static ExecEnv* benchmark_exec_env() {
+    static ExecEnv* exec_env = init_exec_env();
+    return exec_env;
+}
+
+// the rows shared by all benchmarks, nullptr if they fail to be generated
+static const ExprDataset* benchmark_dataset() {
+    static ExprDataset* dataset = []() {
+        ExprDataset* data = new ExprDataset();
+        Status st = data->init();
+        if (!st.ok()) {
+            fprintf(stderr, "failed to generate rows: %s\n", st.get_error_msg().c_str());
+            delete data;
+            return (ExprDataset*)nullptr;
+        }
+        return data;
+    }();
+    return dataset;
+}
+
+static Status create_runtime_state(ExecEnv* exec_env, DescriptorTbl* desc_tbl, bool codegen,
+                                   std::unique_ptr<RuntimeState>* state) {
+    static int64_t next_query_id = 0;
+    TExecPlanFragmentParams params;
+    params.params.query_id.hi = 0;
+    params.params.query_id.lo = ++next_query_id;
+    params.params.fragment_instance_id = params.params.query_id;
+    TQueryOptions query_options;
+    query_options.__set_batch_size(kBatchSize);
+    query_options.__set_disable_codegen(!codegen);
+    // codegen the children of exprs too instead of calling their interpreted versions
+    query_options.__set_codegen_level(codegen ? 1 : 0);
+    state->reset(new RuntimeState(params, query_options, TQueryGlobals(), exec_env));
+    (*state)->set_desc_tbl(desc_tbl);
+    RETURN_IF_ERROR((*state)->init_mem_trackers(params.params.query_id));
+    return Status::OK();
+}
+
+// void EvalExpr(ExprContext* ctx, TupleRow* row, <lowered *Val>* result)
+typedef void (*EvalExprFn)(ExprContext*, TupleRow*, void*);
+
+// Codegen and jit EvalExpr(), which stores the result of the expr of 'ctx' in
+// 'result'. The lowered *Val has the same layout as the *Val in memory.
+static Status codegen_eval_expr(RuntimeState* state, ExprContext* ctx, EvalExprFn* eval_fn) {
+    llvm::Function* expr_fn = nullptr;
+    RETURN_IF_ERROR(ctx->root()->get_codegend_compute_fn(state, &expr_fn));
+    LlvmCodeGen* codegen = nullptr;
+    RETURN_IF_ERROR(state->get_codegen(&codegen));
+
+    llvm::PointerType* expr_ctx_ptr_type =
+        llvm::PointerType::get(codegen->get_type(ExprContext::_s_llvm_class_name), 0);
+    llvm::PointerType* tuple_row_ptr_type =
+        llvm::PointerType::get(codegen->get_type(TupleRow::_s_llvm_class_name), 0);
+    LlvmCodeGen::FnPrototype prototype(codegen, "EvalExpr", codegen->void_type());
+    prototype.add_argument(LlvmCodeGen::NamedVariable("ctx", expr_ctx_ptr_type));
+    prototype.add_argument(LlvmCodeGen::NamedVariable("row", tuple_row_ptr_type));
+    prototype.add_argument(LlvmCodeGen::NamedVariable(
+        "result", CodegenAnyVal::get_lowered_ptr_type(codegen, ctx->root()->type())));
+
+    LlvmCodeGen::LlvmBuilder builder(codegen->context());
+    llvm::Value* args[3];
+    llvm::Function* fn = prototype.generate_prototype(&builder, args);
+    llvm::Value* expr_args[] = { args[0], args[1] };
+    CodegenAnyVal::create_call(codegen, &builder, expr_fn, expr_args, "result", args[2]);
+    builder.CreateRetVoid();
+    fn = codegen->finalize_function(fn);
+    if (fn == nullptr) {
+        return Status::InternalError("failed to finalize EvalExpr");
+    }
+
+    void* fn_ptr = nullptr;
+    codegen->add_function_to_jit(fn, &fn_ptr);
+    RETURN_IF_ERROR(codegen->finalize_module());
+    if (fn_ptr == nullptr) {
+        return Status::InternalError("failed to jit EvalExpr");
+    }
+    *eval_fn = reinterpret_cast<EvalExprFn>(fn_ptr);
+    return Status::OK();
+}
+
+// Counts the rows whose results are null, or for predicates the rows whose
+// results are true
+class ResultCounter {
+public:
+    explicit ResultCounter(PrimitiveType type) : _is_pred(type == TYPE_BOOLEAN) { }
+
+    void add(const AnyVal* val) {
+        if (_is_pred) {
+            _num += !val->is_null && static_cast<const BooleanVal*>(val)->val;
+        } else {
+            _num += val->is_null;
+        }
+    }
+
+    // the result of ExprContext::get_value(), which is nullptr for null
+    void add(const void* value) {
+        if (_is_pred) {
+            _num += value != nullptr && *static_cast<const bool*>(value);
+        } else {
+            _num += value == nullptr;
+        }
+    }
+
+    void add_num(int64_t num) { _num += num; }
+
+    void report(BenchmarkState* state, int64_t rows) const {
+        state->set_counter(_is_pred ? "true_ratio" : "null_ratio",
+                           rows > 0 ? (double)_num / rows : 0);
+    }
+
+private:
+    bool _is_pred;
+    int64_t _num = 0;
+};
+
+// Evaluate the expr of 'ctx' for all rows of 'batch' by Expr::get_*_vals()
+// or filter_batch()
+static void eval_batch(ExprContext* ctx, RowBatch* batch, int* sel, AnyVal* vals,
+                       ResultCounter* counter) {
+    int num_rows = batch->num_rows();
+    for (int i = 0; i < num_rows; ++i) {
+        sel[i] = i;
+    }
+    Expr* root = ctx->root();
+    int val_size = 0;
+    switch (root->type().type) {
+    case TYPE_BOOLEAN:
+        counter->add_num(ctx->filter_batch(batch, sel, num_rows));
+        return;
+    case TYPE_TINYINT:
+        root->get_tiny_int_vals(ctx, batch, sel, num_rows, (TinyIntVal*)vals);
+        val_size = sizeof(TinyIntVal);
+        break;
+    case TYPE_SMALLINT:
+        root->get_small_int_vals(ctx, batch, sel, num_rows, (SmallIntVal*)vals);
+        val_size = sizeof(SmallIntVal);
+        break;
+    case TYPE_INT:
+        root->get_int_vals(ctx, batch, sel, num_rows, (IntVal*)vals);
+        val_size = sizeof(IntVal);
+        break;
+    case TYPE_BIGINT:
+        root->get_big_int_vals(ctx, batch, sel, num_rows, (BigIntVal*)vals);
+        val_size = sizeof(BigIntVal);
+        break;
+    case TYPE_FLOAT:
+        root->get_float_vals(ctx, batch, sel, num_rows, (FloatVal*)vals);
+        val_size = sizeof(FloatVal);
+        break;
+    case TYPE_DOUBLE:
+        root->get_double_vals(ctx, batch, sel, num_rows, (DoubleVal*)vals);
+        val_size = sizeof(DoubleVal);
+        break;
+    default:
+        DCHECK(false) << "no batch evaluation of " << root->type();
+        return;
+    }
+    for (int i = 0; i < num_rows; ++i) {
+        counter->add((const AnyVal*)((const uint8_t*)vals + i * val_size));
+    }
+}
+
+// Evaluate the expr of 'expr_case' for all rows of the dataset once in each
+// iteration. Building, preparing and jitting the expr are not measured.
+static void BM_Expr(BenchmarkState* state, const ExprCase& expr_case, EvalMode mode) {
+    ExecEnv* exec_env = benchmark_exec_env();
+    if (exec_env == nullptr) {
+        state->skip_with_error("failed to init exec env");
+        return;
+    }
+    const ExprDataset* dataset = benchmark_dataset();
+    if (dataset == nullptr) {
+        state->skip_with_error("failed to generate rows");
+        return;
+    }
+
+    std::unique_ptr<RuntimeState> runtime_state;
+    Status st = create_runtime_state(exec_env, dataset->desc_tbl(), mode == EvalMode::CODEGEN,
+                                     &runtime_state);
+    ExprContext* ctx = nullptr;
+    if (st.ok()) {
+        st = Expr::create_expr_tree(runtime_state->obj_pool(), expr_case.build(*dataset), &ctx);
+    }
+    if (st.ok()) {
+        st = ctx->prepare(runtime_state.get(), dataset->row_desc(),
+                          runtime_state->instance_mem_tracker());
+    }
+    if (st.ok()) {
+        st = ctx->open(runtime_state.get());
+    }
+    EvalExprFn eval_fn = nullptr;
+    if (st.ok() && mode == EvalMode::CODEGEN) {
+        st = codegen_eval_expr(runtime_state.get(), ctx, &eval_fn);
+    }
+
+    if (st.ok()) {
+        ResultCounter counter(expr_case.type);
+        // large enough for any lowered *Val except DecimalVal
+        alignas(16) uint8_t result[64];
+        std::vector<int> sel(kBatchSize);
+        // large enough for kBatchSize of any numeric *Val
+        std::vector<DoubleVal> vals(kBatchSize);
+        MonotonicStopWatch watch;
+        watch.start();
+        while (state->keep_running()) {
+            for (auto& batch : dataset->batches()) {
+                switch (mode) {
+                case EvalMode::INTERPRETED:
+                    for (int i = 0; i < batch->num_rows(); ++i) {
+                        counter.add(ctx->get_value(batch->get_row(i)));
+                    }
+                    break;
+                case EvalMode::CODEGEN:
+                    for (int i = 0; i < batch->num_rows(); ++i) {
+                        eval_fn(ctx, batch->get_row(i), result);
+                        counter.add((const AnyVal*)result);
+                    }
+                    break;
+                case EvalMode::BATCH:
+                    eval_batch(ctx, batch.get(), sel.data(), vals.data(), &counter);
+                    break;
+                }
+                ctx->free_local_allocations();
+            }
+        }
+        watch.stop();
+        int64_t rows = state->iterations() * kNumRows;
+        state->set_items_processed(rows);
+        state->set_counter("ns_per_row", (double)watch.elapsed_time() / rows);
+        counter.report(state, rows);
+    } else {
+        state->skip_with_error(st.get_error_msg());
+    }
+
+    if (ctx != nullptr) {
+        ctx->close(runtime_state.get());
+    }
+    if (runtime_state != nullptr) {
+        exec_env->thread_mgr()->unregister_pool(runtime_state->resource_pool());
+    }
+}
+
+static void register_benchmarks() {
+    for (const ExprCase& expr_case : expr_cases()) {
+        for (EvalMode mode : { EvalMode::INTERPRETED, EvalMode::CODEGEN, EvalMode::BATCH }) {
+            if (mode == EvalMode::BATCH && !has_batch_eval(expr_case.type)) {
+                continue;
+            }
+            register_benchmark("BM_Expr/" + expr_case.name + "/" + mode_name(mode),
+                               [expr_case, mode](BenchmarkState* state) {
+                BM_Expr(state, expr_case, mode);
+            });
+        }
+    }
+}
+
+static int s_registered = (register_benchmarks(), 0);
+
+}
+
+BENCHMARK_MAIN();
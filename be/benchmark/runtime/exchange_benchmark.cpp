@@ -0,0 +1,903 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Throughput and latency of the rpcs which move row batches between backends,
+// through brpc servers started in this process:
+//   transmit_data            DataStreamSenders send batches to DataStreamRecvrs
+//                            through the PInternalServiceImpl of a backend.
+//   tablet_writer_add_batch  senders send batches like NodeChannel of
+//                            OlapTableSink, to a service which deserializes
+//                            them like TabletsChannel but doesn't write them,
+//                            so that storage is left out, see load_benchmark.
+// Every combination of the serialization formats, batch sizes, numbers of
+// senders and receivers, and buffer sizes of receivers is run. Formats are:
+//   pb              tuple data in PRowBatch, uncompressed
+//   pb_snappy       tuple data in PRowBatch, compressed by snappy
+//                   (compress_rowbatches)
+//   attachment_lz4  tuple data in the rpc attachment, compressed by LZ4
+//                   (data_stream_sender_use_attachment and
+//                   tablet_writer_add_batch_use_attachment)
+// Rows are an INT, a BIGINT and a VARCHAR of a dictionary of strings.
+//
+//   exchange_benchmark --modes=transmit_data --num_senders=1,8 --batch_sizes=1024,4096
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "common/config.h"
+#include "common/daemon.h"
+#include "common/object_pool.h"
+#include "gen_cpp/DataSinks_types.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "gen_cpp/palo_internal_service.pb.h"
+#include "olap/options.h"
+#include "olap/utils.h"
+#include "runtime/data_stream_mgr.h"
+#include "runtime/data_stream_recvr.h"
+#include "runtime/data_stream_sender.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/query_statistics.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "service/brpc.h"
+#include "service/brpc_service.h"
+#include "util/block_compression.h"
+#include "util/brpc_stub_cache.h"
+#include "util/cpu_info.h"
+#include "util/descriptor_helper.h"
+#include "util/file_utils.h"
+#include "util/ref_count_closure.h"
+#include "util/stopwatch.hpp"
+
+DEFINE_string(modes, "transmit_data,tablet_writer_add_batch",
+              "rpcs to run: transmit_data and tablet_writer_add_batch");
+DEFINE_string(formats, "pb,pb_snappy,attachment_lz4",
+              "serialization formats: pb, pb_snappy and attachment_lz4");
+DEFINE_string(batch_sizes, "1024,4096", "rows of a batch");
+DEFINE_string(num_senders, "1,4,16", "numbers of senders, each sends in its own thread");
+DEFINE_string(num_receivers, "1,4",
+              "numbers of DataStreamRecvrs of transmit_data, or of load channels of "
+              "tablet_writer_add_batch");
+DEFINE_string(recvr_buffer_sizes, "10485760",
+              "buffer sizes of a DataStreamRecvr, like exchg_node_buffer_size_bytes");
+DEFINE_string(partition, "random",
+              "partition of DataStreamSender: random, broadcast or hash");
+DEFINE_int32(num_servers, 1, "number of brpc servers, receivers are evenly spread on them");
+DEFINE_int32(port, 18060,
+             "port of the first brpc server, it must not be brpc_port, otherwise senders "
+             "pass batches to receivers of this process directly");
+DEFINE_int64(rows_per_sender, 1000000, "rows sent by every sender");
+DEFINE_int32(string_length, 32, "length of the VARCHAR column");
+DEFINE_int32(max_in_flight_packets, 1,
+             "tablet_writer_add_batch packets in flight of a sender to a load channel, "
+             "like tablet_writer_max_in_flight_packets");
+DEFINE_string(output_json, "", "write results into this file as JSON");
+
+namespace doris {
+
+static const PlanNodeId kDestNodeId = 1;
+static const int64_t kIndexId = 100;
+static const int kNumDictStrings = 1024;
+static const uint32_t kSeed = 20191101;
+
+static const std::vector<std::string> kFormats = { "pb", "pb_snappy", "attachment_lz4" };
+
+// Schema of the rows, shared by senders and receivers
+struct Schema {
+    ObjectPool pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    std::unique_ptr<RowDescriptor> row_desc;
+    const TupleDescriptor* tuple_desc = nullptr;
+
+    Status init() {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+            TSlotDescriptorBuilder().type(TYPE_INT).nullable(false).column_pos(0).build());
+        tuple_builder.add_slot(
+            TSlotDescriptorBuilder().type(TYPE_BIGINT).nullable(false).column_pos(1).build());
+        tuple_builder.add_slot(
+            TSlotDescriptorBuilder().string_type(FLAGS_string_length)
+                .nullable(false).column_pos(2).build());
+        tuple_builder.build(&dtb);
+        RETURN_IF_ERROR(DescriptorTbl::create(&pool, dtb.desc_tbl(), &desc_tbl));
+        row_desc.reset(new RowDescriptor(*desc_tbl, { 0 }, { false }));
+        tuple_desc = desc_tbl->get_tuple_descriptor(0);
+        return Status::OK();
+    }
+};
+
+static Schema* s_schema = nullptr;
+
+// A batch of rows which is sent repeatedly by a sender. Batches are not shared
+// by senders, because serialization of a batch uses its buffers.
+class InputBatch {
+public:
+    InputBatch(int batch_size, int seed) {
+        _batch.reset(new RowBatch(*s_schema->row_desc, batch_size, &_tracker));
+        const std::vector<SlotDescriptor*>& slots = s_schema->tuple_desc->slots();
+        MemPool* pool = _batch->tuple_data_pool();
+        std::mt19937_64 rng(kSeed + seed);
+        for (int i = 0; i < batch_size; ++i) {
+            Tuple* tuple = Tuple::create(s_schema->tuple_desc->byte_size(), pool);
+            *(int32_t*)tuple->get_slot(slots[0]->tuple_offset()) = rng();
+            *(int64_t*)tuple->get_slot(slots[1]->tuple_offset()) = seed * batch_size + i;
+            // strings of a dictionary, which are compressible like real ones
+            uint64_t word = rng() % kNumDictStrings;
+            char* str = (char*)pool->allocate(FLAGS_string_length);
+            for (int j = 0; j < FLAGS_string_length; ++j) {
+                str[j] = 'a' + (word >> (j % 10)) % 26;
+            }
+            *(StringValue*)tuple->get_slot(slots[2]->tuple_offset()) =
+                StringValue(str, FLAGS_string_length);
+
+            int idx = _batch->add_row();
+            _batch->get_row(idx)->set_tuple(0, tuple);
+            _batch->commit_last_row();
+        }
+        _bytes = batch_size * (s_schema->tuple_desc->byte_size() + FLAGS_string_length);
+    }
+
+    RowBatch* batch() { return _batch.get(); }
+    int64_t bytes() const { return _bytes; }
+
+private:
+    MemTracker _tracker;
+    std::unique_ptr<RowBatch> _batch;
+    int64_t _bytes = 0;
+};
+
+struct RunConfig {
+    std::string mode;
+    std::string format;
+    int batch_size = 0;
+    int num_senders = 0;
+    int num_receivers = 0;
+    int recvr_buffer_size = 0;
+};
+
+struct RunResult {
+    RunConfig config;
+    int64_t real_ns = 0;
+    int64_t rows_sent = 0;
+    int64_t rows_received = 0;
+    // size of rows in memory, the same for all formats
+    int64_t row_bytes = 0;
+    // latencies of every send() of DataStreamSender, or of every add batch rpc
+    std::vector<int64_t> latencies_us;
+    std::string error;
+};
+
+static void set_format(const std::string& format) {
+    config::compress_rowbatches = format == "pb_snappy";
+    config::data_stream_sender_use_attachment = format == "attachment_lz4";
+    config::tablet_writer_add_batch_use_attachment = format == "attachment_lz4";
+}
+
+static TNetworkAddress server_address(int receiver) {
+    TNetworkAddress address;
+    address.hostname = "127.0.0.1";
+    address.port = FLAGS_port + receiver % FLAGS_num_servers;
+    return address;
+}
+
+static Status create_runtime_state(ExecEnv* exec_env, std::unique_ptr<RuntimeState>* state) {
+    static std::atomic<int64_t> next_query_id(0);
+    TExecPlanFragmentParams params;
+    params.params.query_id.hi = 0;
+    params.params.query_id.lo = ++next_query_id;
+    params.params.fragment_instance_id = params.params.query_id;
+    TQueryOptions query_options;
+    state->reset(new RuntimeState(params, query_options, TQueryGlobals(), exec_env));
+    (*state)->set_desc_tbl(s_schema->desc_tbl);
+    RETURN_IF_ERROR((*state)->init_mem_trackers(params.params.query_id));
+    return Status::OK();
+}
+
+static TDataStreamSink data_stream_sink() {
+    TDataStreamSink sink;
+    sink.dest_node_id = kDestNodeId;
+    if (FLAGS_partition == "broadcast") {
+        sink.output_partition.type = TPartitionType::UNPARTITIONED;
+    } else if (FLAGS_partition == "hash") {
+        // hash of the INT column
+        sink.output_partition.type = TPartitionType::HASH_PARTITIONED;
+        const SlotDescriptor* slot = s_schema->tuple_desc->slots()[0];
+        TExprNode node;
+        node.node_type = TExprNodeType::SLOT_REF;
+        node.type = slot->type().to_thrift();
+        node.num_children = 0;
+        node.__isset.slot_ref = true;
+        node.slot_ref.slot_id = slot->id();
+        node.slot_ref.tuple_id = 0;
+        TExpr expr;
+        expr.nodes.push_back(node);
+        sink.output_partition.__set_partition_exprs({ expr });
+    } else {
+        sink.output_partition.type = TPartitionType::RANDOM;
+    }
+    return sink;
+}
+
+// DataStreamSenders send to DataStreamRecvrs of the same process through brpc
+static void run_transmit_data(ExecEnv* exec_env, RunResult* result) {
+    const RunConfig& config = result->config;
+    std::unique_ptr<RuntimeState> recvr_state;
+    Status st = create_runtime_state(exec_env, &recvr_state);
+    if (!st.ok()) {
+        result->error = st.get_error_msg();
+        return;
+    }
+    TUniqueId query_id = recvr_state->query_id();
+    std::vector<boost::shared_ptr<DataStreamRecvr>> recvrs;
+    std::vector<TPlanFragmentDestination> destinations;
+    for (int i = 0; i < config.num_receivers; ++i) {
+        TUniqueId finst_id;
+        finst_id.hi = query_id.lo;
+        finst_id.lo = i + 1;
+        RuntimeProfile* profile = recvr_state->obj_pool()->add(
+            new RuntimeProfile(recvr_state->obj_pool(), "DataStreamRecvr"));
+        recvrs.push_back(exec_env->stream_mgr()->create_recvr(
+                recvr_state.get(), *s_schema->row_desc, finst_id, kDestNodeId,
+                config.num_senders, config.recvr_buffer_size, profile, false,
+                std::make_shared<QueryStatisticsRecvr>()));
+
+        TPlanFragmentDestination destination;
+        destination.fragment_instance_id = finst_id;
+        destination.server = server_address(i);
+        destination.__set_brpc_server(server_address(i));
+        destinations.push_back(destination);
+    }
+
+    std::atomic<int64_t> rows_received(0);
+    std::vector<std::thread> recvr_threads;
+    for (auto& recvr : recvrs) {
+        recvr_threads.emplace_back([&recvr, &rows_received] {
+            RowBatch* batch = nullptr;
+            while (recvr->get_batch(&batch).ok() && batch != nullptr) {
+                rows_received += batch->num_rows();
+            }
+        });
+    }
+
+    std::vector<std::vector<int64_t>> latencies(config.num_senders);
+    std::vector<std::string> errors(config.num_senders);
+    std::vector<std::unique_ptr<InputBatch>> inputs;
+    for (int i = 0; i < config.num_senders; ++i) {
+        inputs.emplace_back(new InputBatch(config.batch_size, i));
+    }
+    int64_t num_batches = (FLAGS_rows_per_sender + config.batch_size - 1) / config.batch_size;
+
+    MonotonicStopWatch watch;
+    watch.start();
+    std::vector<std::thread> sender_threads;
+    for (int i = 0; i < config.num_senders; ++i) {
+        sender_threads.emplace_back([&, i] {
+            std::unique_ptr<RuntimeState> state;
+            Status st = create_runtime_state(exec_env, &state);
+            if (!st.ok()) {
+                errors[i] = st.get_error_msg();
+                return;
+            }
+            TDataSink tsink;
+            tsink.type = TDataSinkType::DATA_STREAM_SINK;
+            tsink.__set_stream_sink(data_stream_sink());
+            DataStreamSender sender(state->obj_pool(), i, *s_schema->row_desc,
+                                    tsink.stream_sink, destinations, 16 * 1024, false);
+            sender.set_query_statistics(std::make_shared<QueryStatistics>());
+            st = sender.init(tsink);
+            if (st.ok()) {
+                st = sender.prepare(state.get());
+            }
+            if (st.ok()) {
+                st = sender.open(state.get());
+            }
+            RowBatch* batch = inputs[i]->batch();
+            latencies[i].reserve(num_batches);
+            for (int64_t j = 0; st.ok() && j < num_batches; ++j) {
+                MonotonicStopWatch send_watch;
+                send_watch.start();
+                st = sender.send(state.get(), batch);
+                latencies[i].push_back(send_watch.elapsed_time() / 1000);
+            }
+            // receivers wait for every sender to close
+            Status close_st = sender.close(state.get(), st);
+            if (st.ok()) {
+                st = close_st;
+            }
+            if (!st.ok()) {
+                errors[i] = st.get_error_msg();
+            }
+        });
+    }
+    for (auto& thread : sender_threads) {
+        thread.join();
+    }
+    for (int i = 0; i < errors.size(); ++i) {
+        if (!errors[i].empty()) {
+            result->error = errors[i];
+            // unblock receivers which are waiting for the failed senders
+            for (auto& destination : destinations) {
+                exec_env->stream_mgr()->cancel(destination.fragment_instance_id);
+            }
+            break;
+        }
+    }
+    for (auto& thread : recvr_threads) {
+        thread.join();
+    }
+    result->real_ns = watch.elapsed_time();
+    for (auto& recvr : recvrs) {
+        recvr->close();
+    }
+
+    int64_t copies = FLAGS_partition == "broadcast" ? config.num_receivers : 1;
+    result->rows_sent = num_batches * config.batch_size * config.num_senders * copies;
+    result->rows_received = rows_received;
+    result->row_bytes = num_batches * inputs[0]->bytes() * config.num_senders * copies;
+    for (auto& sender_latencies : latencies) {
+        result->latencies_us.insert(result->latencies_us.end(),
+                                    sender_latencies.begin(), sender_latencies.end());
+    }
+}
+
+// The receiving end of tablet_writer_add_batch, which deserializes batches like
+// TabletsChannel and drops them
+class AddBatchSinkService : public palo::PInternalService {
+public:
+    void tablet_writer_add_batch(google::protobuf::RpcController* controller,
+                                 const PTabletWriterAddBatchRequest* request,
+                                 PTabletWriterAddBatchResult* response,
+                                 google::protobuf::Closure* done) override {
+        brpc::ClosureGuard closure_guard(done);
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+        Status st = deserialize(*request, cntl->request_attachment());
+        st.to_protobuf(response->mutable_status());
+    }
+
+    int64_t rows_received() const { return _rows_received; }
+
+private:
+    Status deserialize(const PTabletWriterAddBatchRequest& request,
+                       const butil::IOBuf& attachment) {
+        if (!request.has_row_batch()) {
+            return Status::OK();
+        }
+        std::unique_ptr<RowBatch> batch;
+        if (request.has_attachment_compression_type()) {
+            BlockCompressionCodec* codec = nullptr;
+            RETURN_IF_ERROR(get_block_compression_codec(
+                    (segment_v2::CompressionTypePB)request.attachment_compression_type(),
+                    &codec));
+            std::string buf;
+            Slice tuple_data;
+            if (attachment.backing_block_num() == 1) {
+                auto block = attachment.backing_block(0);
+                tuple_data = Slice(block.data(), block.size());
+            } else {
+                attachment.copy_to(&buf);
+                tuple_data = Slice(buf);
+            }
+            batch.reset(new RowBatch(*s_schema->row_desc, request.row_batch(), tuple_data,
+                                     codec, request.attachment_uncompressed_size(),
+                                     &_tracker));
+            if (!batch->valid()) {
+                return Status::InternalError("corrupted tuple data in attachment");
+            }
+        } else {
+            batch.reset(new RowBatch(*s_schema->row_desc, request.row_batch(), &_tracker));
+        }
+        if (batch->num_rows() != request.tablet_ids_size()) {
+            return Status::InternalError("number of rows and tablet ids does not match");
+        }
+        _rows_received += batch->num_rows();
+        return Status::OK();
+    }
+
+    MemTracker _tracker;
+    std::atomic<int64_t> _rows_received { 0 };
+};
+
+// A sender of tablet_writer_add_batch to one load channel, which serializes
+// batches and keeps packets in flight like NodeChannel
+class AddBatchSender {
+public:
+    AddBatchSender(palo::PInternalService_Stub* stub, int64_t load_id, int sender_id,
+                   BlockCompressionCodec* codec)
+            : _stub(stub), _codec(codec) {
+        _request.mutable_id()->set_hi(0);
+        _request.mutable_id()->set_lo(load_id);
+        _request.set_index_id(kIndexId);
+        _request.set_sender_id(sender_id);
+    }
+
+    ~AddBatchSender() {
+        for (auto closure : _closures) {
+            closure->join();
+            if (closure->unref()) {
+                delete closure;
+            }
+        }
+    }
+
+    Status send(RowBatch* batch, std::vector<int64_t>* latencies_us) {
+        RETURN_IF_ERROR(wait_in_flight(FLAGS_max_in_flight_packets - 1, latencies_us));
+        auto closure = new RefCountClosure<PTabletWriterAddBatchResult>();
+        closure->ref();
+        _closures.push_back(closure);
+
+        _request.set_packet_seq(_next_packet_seq++);
+        _request.clear_tablet_ids();
+        for (int i = 0; i < batch->num_rows(); ++i) {
+            _request.add_tablet_ids(i);
+        }
+        if (_codec != nullptr) {
+            batch->serialize(_request.mutable_row_batch(), &_tuple_data_buf);
+            Slice input(_tuple_data_buf);
+            size_t max_len = _codec->max_compressed_len(input.size);
+            char* buf = reinterpret_cast<char*>(malloc(max_len));
+            Slice output(buf, max_len);
+            Status st = _codec->compress(input, &output);
+            if (!st.ok()) {
+                free(buf);
+                return st;
+            }
+            closure->cntl.request_attachment().append_user_data(buf, output.size, free);
+            _request.set_attachment_compression_type(segment_v2::LZ4);
+            _request.set_attachment_uncompressed_size(input.size);
+        } else {
+            batch->serialize(_request.mutable_row_batch());
+        }
+
+        closure->ref();
+        closure->cntl.set_timeout_ms(60000);
+        _stub->tablet_writer_add_batch(&closure->cntl, &_request, &closure->result, closure);
+        return Status::OK();
+    }
+
+    Status close(std::vector<int64_t>* latencies_us) {
+        return wait_in_flight(0, latencies_us);
+    }
+
+private:
+    Status wait_in_flight(int max_in_flight, std::vector<int64_t>* latencies_us) {
+        while (_closures.size() > max_in_flight) {
+            auto closure = _closures.front();
+            _closures.pop_front();
+            closure->join();
+            Status st;
+            if (closure->cntl.Failed()) {
+                st = Status::InternalError(closure->cntl.ErrorText());
+            } else {
+                st = Status(closure->result.status());
+                latencies_us->push_back(closure->cntl.latency_us());
+            }
+            if (closure->unref()) {
+                delete closure;
+            }
+            RETURN_IF_ERROR(st);
+        }
+        return Status::OK();
+    }
+
+    palo::PInternalService_Stub* _stub;
+    BlockCompressionCodec* _codec;
+    PTabletWriterAddBatchRequest _request;
+    std::string _tuple_data_buf;
+    int64_t _next_packet_seq = 0;
+    std::deque<RefCountClosure<PTabletWriterAddBatchResult>*> _closures;
+};
+
+static std::vector<AddBatchSinkService*> s_sink_services;
+
+// Every sender sends to all load channels in turn, like OlapTableSink sends the
+// rows of the tablets of every channel
+static void run_tablet_writer_add_batch(ExecEnv* exec_env, RunResult* result) {
+    const RunConfig& config = result->config;
+    BlockCompressionCodec* codec = nullptr;
+    if (config::tablet_writer_add_batch_use_attachment) {
+        Status st = get_block_compression_codec(segment_v2::LZ4, &codec);
+        if (!st.ok()) {
+            result->error = st.get_error_msg();
+            return;
+        }
+    }
+    int64_t rows_received_before = 0;
+    for (auto service : s_sink_services) {
+        rows_received_before += service->rows_received();
+    }
+
+    std::vector<std::vector<int64_t>> latencies(config.num_senders);
+    std::vector<std::string> errors(config.num_senders);
+    std::vector<std::unique_ptr<InputBatch>> inputs;
+    for (int i = 0; i < config.num_senders; ++i) {
+        inputs.emplace_back(new InputBatch(config.batch_size, i));
+    }
+    int64_t num_batches = (FLAGS_rows_per_sender + config.batch_size - 1) / config.batch_size;
+
+    MonotonicStopWatch watch;
+    watch.start();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < config.num_senders; ++i) {
+        threads.emplace_back([&, i] {
+            std::vector<std::unique_ptr<AddBatchSender>> channels;
+            for (int j = 0; j < config.num_receivers; ++j) {
+                auto stub = exec_env->brpc_stub_cache()->get_stub(server_address(j));
+                channels.emplace_back(new AddBatchSender(stub, j + 1, i, codec));
+            }
+            RowBatch* batch = inputs[i]->batch();
+            latencies[i].reserve(num_batches);
+            Status st;
+            for (int64_t j = 0; st.ok() && j < num_batches; ++j) {
+                st = channels[j % channels.size()]->send(batch, &latencies[i]);
+            }
+            for (auto& channel : channels) {
+                Status close_st = channel->close(&latencies[i]);
+                if (st.ok()) {
+                    st = close_st;
+                }
+            }
+            if (!st.ok()) {
+                errors[i] = st.get_error_msg();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    result->real_ns = watch.elapsed_time();
+    for (auto& error : errors) {
+        if (!error.empty()) {
+            result->error = error;
+            break;
+        }
+    }
+
+    int64_t rows_received = -rows_received_before;
+    for (auto service : s_sink_services) {
+        rows_received += service->rows_received();
+    }
+    result->rows_sent = num_batches * config.batch_size * config.num_senders;
+    result->rows_received = rows_received;
+    result->row_bytes = num_batches * inputs[0]->bytes() * config.num_senders;
+    for (auto& sender_latencies : latencies) {
+        result->latencies_us.insert(result->latencies_us.end(),
+                                    sender_latencies.begin(), sender_latencies.end());
+    }
+}
+
+static int64_t percentile(std::vector<int64_t>* values, double p) {
+    if (values->empty()) {
+        return 0;
+    }
+    size_t idx = std::min(values->size() - 1, (size_t)(p / 100 * values->size()));
+    std::nth_element(values->begin(), values->begin() + idx, values->end());
+    return (*values)[idx];
+}
+
+struct Summary {
+    double rows_per_second = 0;
+    double mb_per_second = 0;
+    int64_t p50_us = 0;
+    int64_t p99_us = 0;
+    int64_t max_us = 0;
+};
+
+static Summary summarize(RunResult* r) {
+    Summary s;
+    if (r->real_ns > 0) {
+        s.rows_per_second = r->rows_received * 1e9 / r->real_ns;
+        s.mb_per_second = r->row_bytes * 1e9 / r->real_ns / (1024 * 1024);
+    }
+    s.p50_us = percentile(&r->latencies_us, 50);
+    s.p99_us = percentile(&r->latencies_us, 99);
+    s.max_us = percentile(&r->latencies_us, 100);
+    return s;
+}
+
+static void print_results(std::vector<RunResult>* results) {
+    printf("%-24s %-15s %7s %8s %10s %10s %12s %10s %9s %9s %9s\n", "Mode", "Format", "Batch",
+           "Senders", "Receivers", "Buffer KB", "Krows/s", "MB/s", "P50 us", "P99 us",
+           "Max us");
+    for (auto& r : *results) {
+        const RunConfig& c = r.config;
+        if (!r.error.empty()) {
+            printf("%-24s %-15s %7d %8d %10d %10d  failed: %s\n", c.mode.c_str(),
+                   c.format.c_str(), c.batch_size, c.num_senders, c.num_receivers,
+                   c.recvr_buffer_size / 1024, r.error.c_str());
+            continue;
+        }
+        Summary s = summarize(&r);
+        printf("%-24s %-15s %7d %8d %10d %10d %12.1f %10.1f %9ld %9ld %9ld\n", c.mode.c_str(),
+               c.format.c_str(), c.batch_size, c.num_senders, c.num_receivers,
+               c.recvr_buffer_size / 1024, s.rows_per_second / 1e3, s.mb_per_second,
+               s.p50_us, s.p99_us, s.max_us);
+    }
+}
+
+static std::string to_json(std::vector<RunResult>* results) {
+    rapidjson::StringBuffer buf;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buf);
+    writer.StartObject();
+    writer.Key("context");
+    writer.StartObject();
+    writer.Key("num_cpus");
+    writer.Int(CpuInfo::num_cores());
+    writer.Key("partition");
+    writer.String(FLAGS_partition.c_str());
+    writer.Key("num_servers");
+    writer.Int(FLAGS_num_servers);
+    writer.Key("rows_per_sender");
+    writer.Int64(FLAGS_rows_per_sender);
+    writer.Key("string_length");
+    writer.Int(FLAGS_string_length);
+    writer.Key("max_in_flight_packets");
+    writer.Int(FLAGS_max_in_flight_packets);
+    writer.EndObject();
+    writer.Key("runs");
+    writer.StartArray();
+    for (auto& r : *results) {
+        const RunConfig& c = r.config;
+        writer.StartObject();
+        writer.Key("mode");
+        writer.String(c.mode.c_str());
+        writer.Key("format");
+        writer.String(c.format.c_str());
+        writer.Key("batch_size");
+        writer.Int(c.batch_size);
+        writer.Key("num_senders");
+        writer.Int(c.num_senders);
+        writer.Key("num_receivers");
+        writer.Int(c.num_receivers);
+        writer.Key("recvr_buffer_size");
+        writer.Int(c.recvr_buffer_size);
+        if (!r.error.empty()) {
+            writer.Key("error");
+            writer.String(r.error.c_str());
+            writer.EndObject();
+            continue;
+        }
+        Summary s = summarize(&r);
+        writer.Key("real_time_ns");
+        writer.Int64(r.real_ns);
+        writer.Key("rows_sent");
+        writer.Int64(r.rows_sent);
+        writer.Key("rows_received");
+        writer.Int64(r.rows_received);
+        writer.Key("rows_per_second");
+        writer.Double(s.rows_per_second);
+        writer.Key("mb_per_second");
+        writer.Double(s.mb_per_second);
+        writer.Key("latency_p50_us");
+        writer.Int64(s.p50_us);
+        writer.Key("latency_p99_us");
+        writer.Int64(s.p99_us);
+        writer.Key("latency_max_us");
+        writer.Int64(s.max_us);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return buf.GetString();
+}
+
+static bool parse_ints(const std::string& flag, const std::string& value,
+                       std::vector<int>* ints) {
+    std::vector<std::string> strs;
+    split_string<char>(value, ',', &strs);
+    for (auto& str : strs) {
+        int num = atoi(str.c_str());
+        if (num <= 0) {
+            std::cerr << "invalid " << flag << ": " << str << std::endl;
+            return false;
+        }
+        ints->push_back(num);
+    }
+    return !ints->empty();
+}
+
+static ExecEnv* init_exec_env() {
+    std::vector<StorePath> paths;
+    paths.emplace_back(std::string(getenv("DORIS_HOME")) + "/exchange_benchmark_data", -1);
+    for (auto& dir : { paths[0].path, config::sys_log_dir }) {
+        Status st = FileUtils::create_dir(dir);
+        if (!st.ok()) {
+            std::cerr << "failed to create " << dir << ": " << st.get_error_msg() << std::endl;
+            return nullptr;
+        }
+    }
+    char arg0[] = "exchange_benchmark";
+    char* argv[] = { arg0, nullptr };
+    init_daemon(1, argv, paths);
+    ExecEnv* exec_env = ExecEnv::GetInstance();
+    Status st = ExecEnv::init(exec_env, paths);
+    if (!st.ok()) {
+        std::cerr << "failed to init exec env: " << st.get_error_msg() << std::endl;
+        return nullptr;
+    }
+    return exec_env;
+}
+
+static int run() {
+    std::vector<std::string> modes;
+    split_string<char>(FLAGS_modes, ',', &modes);
+    std::vector<std::string> formats;
+    split_string<char>(FLAGS_formats, ',', &formats);
+    std::vector<int> batch_sizes;
+    std::vector<int> num_senders;
+    std::vector<int> num_receivers;
+    std::vector<int> buffer_sizes;
+    if (!parse_ints("batch_sizes", FLAGS_batch_sizes, &batch_sizes)
+            || !parse_ints("num_senders", FLAGS_num_senders, &num_senders)
+            || !parse_ints("num_receivers", FLAGS_num_receivers, &num_receivers)
+            || !parse_ints("recvr_buffer_sizes", FLAGS_recvr_buffer_sizes, &buffer_sizes)) {
+        return 1;
+    }
+    for (auto& mode : modes) {
+        if (mode != "transmit_data" && mode != "tablet_writer_add_batch") {
+            std::cerr << "unknown mode: " << mode << std::endl;
+            return 1;
+        }
+    }
+    for (auto& format : formats) {
+        if (std::find(kFormats.begin(), kFormats.end(), format) == kFormats.end()) {
+            std::cerr << "unknown format: " << format << std::endl;
+            return 1;
+        }
+    }
+    if (FLAGS_partition != "random" && FLAGS_partition != "broadcast"
+            && FLAGS_partition != "hash") {
+        std::cerr << "unknown partition: " << FLAGS_partition << std::endl;
+        return 1;
+    }
+    if (FLAGS_num_servers <= 0 || FLAGS_max_in_flight_packets <= 0) {
+        std::cerr << "num_servers and max_in_flight_packets must be positive" << std::endl;
+        return 1;
+    }
+    if (FLAGS_port <= config::brpc_port && config::brpc_port < FLAGS_port + FLAGS_num_servers) {
+        std::cerr << "ports of servers must not include brpc_port " << config::brpc_port
+                  << std::endl;
+        return 1;
+    }
+
+    ExecEnv* exec_env = init_exec_env();
+    if (exec_env == nullptr) {
+        return 1;
+    }
+    Schema schema;
+    Status st = schema.init();
+    if (!st.ok()) {
+        std::cerr << "failed to create schema: " << st.get_error_msg() << std::endl;
+        return 1;
+    }
+    s_schema = &schema;
+
+    // servers of a backend for transmit_data, and sink servers for
+    // tablet_writer_add_batch on the same ports
+    std::vector<RunResult> results;
+    std::vector<std::unique_ptr<BRpcService>> rpc_services;
+    std::vector<std::unique_ptr<brpc::Server>> sink_servers;
+    for (auto& mode : modes) {
+        for (int i = 0; i < FLAGS_num_servers; ++i) {
+            if (mode == "transmit_data") {
+                rpc_services.emplace_back(new BRpcService(exec_env));
+                st = rpc_services.back()->start(FLAGS_port + i);
+            } else {
+                sink_servers.emplace_back(new brpc::Server());
+                s_sink_services.push_back(new AddBatchSinkService());
+                sink_servers.back()->AddService(s_sink_services.back(),
+                                                brpc::SERVER_OWNS_SERVICE);
+                brpc::ServerOptions options;
+                if (sink_servers.back()->Start(FLAGS_port + i, &options) != 0) {
+                    st = Status::InternalError("failed to start brpc server");
+                }
+            }
+            if (!st.ok()) {
+                std::cerr << "failed to start brpc server on port " << FLAGS_port + i << ": "
+                          << st.get_error_msg() << std::endl;
+                return 1;
+            }
+        }
+
+        for (auto& format : formats) {
+            set_format(format);
+            for (int batch_size : batch_sizes) {
+                for (int senders : num_senders) {
+                    for (int receivers : num_receivers) {
+                        for (int buffer_size : buffer_sizes) {
+                            RunResult result;
+                            result.config.mode = mode;
+                            result.config.format = format;
+                            result.config.batch_size = batch_size;
+                            result.config.num_senders = senders;
+                            result.config.num_receivers = receivers;
+                            result.config.recvr_buffer_size = buffer_size;
+                            if (mode == "transmit_data") {
+                                run_transmit_data(exec_env, &result);
+                            } else {
+                                run_tablet_writer_add_batch(exec_env, &result);
+                                // buffers of receivers are not used
+                                results.push_back(std::move(result));
+                                break;
+                            }
+                            results.push_back(std::move(result));
+                        }
+                    }
+                }
+            }
+        }
+        // ports are reused by the servers of the next mode
+        for (auto& server : sink_servers) {
+            server->Stop(0);
+            server->Join();
+        }
+        sink_servers.clear();
+        s_sink_services.clear();
+        rpc_services.clear();
+    }
+
+    print_results(&results);
+    if (!FLAGS_output_json.empty()) {
+        std::ofstream out(FLAGS_output_json);
+        out << to_json(&results) << std::endl;
+        if (!out.good()) {
+            std::cerr << "failed to write " << FLAGS_output_json << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    gflags::SetUsageMessage("Throughput of transmit_data and tablet_writer_add_batch rpcs");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    if (getenv("DORIS_HOME") == nullptr) {
+        setenv("DORIS_HOME", ".", 0);
+    }
+    if (!doris::config::init(nullptr, false)) {
+        std::cerr << "failed to init config" << std::endl;
+        return 1;
+    }
+    doris::CpuInfo::init();
+
+    int ret = doris::run();
+    google::protobuf::ShutdownProtobufLibrary();
+    return ret;
+}
@@ -0,0 +1,529 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Contention benchmark of the shared structures on the hot paths of storage.
+// Each workload is run by 1 to 128 threads for a fixed time, every thread
+// operates on keys of the same zipf distribution:
+//   lru_cache       ShardedLRUCache lookup, insert on miss, and erase
+//   page_cache      StoragePageCache lookup, insert on miss, and insert of
+//                   prefetched pages
+//   tablet_manager  TabletManager::get_tablet of num_tablets tablets
+//   txn_manager     TxnManager::has_txn, and prepare_txn with rollback_txn
+// Throughput and the time threads wait for olap Mutex and RWMutex, which are
+// counted by LockWaitStats, are reported for each number of threads.
+//
+//   concurrency_benchmark --workloads=lru_cache --threads=1,16,64 --write_percent=20
+
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "common/config.h"
+#include "gen_cpp/AgentService_types.h"
+#include "olap/lru_cache.h"
+#include "olap/options.h"
+#include "olap/page_cache.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet_manager.h"
+#include "olap/txn_manager.h"
+#include "olap/utils.h"
+#include "util/cpu_info.h"
+#include "util/stopwatch.hpp"
+#include "util/uid_util.h"
+
+DEFINE_string(workloads, "lru_cache,page_cache,tablet_manager,txn_manager",
+              "workloads to run: lru_cache, page_cache, tablet_manager and txn_manager");
+DEFINE_string(threads, "1,2,4,8,16,32,64,128", "numbers of threads to run each workload by");
+DEFINE_int32(duration_ms, 2000, "time to run each workload by each number of threads");
+DEFINE_int64(num_keys, 1000000, "number of distinct keys");
+DEFINE_double(zipf_exponent, 0.99, "exponent of the zipf distribution of keys");
+DEFINE_int32(write_percent, 10,
+             "percent of operations which write: erase from lru_cache, insert prefetched "
+             "pages into page_cache, prepare and rollback a txn, tablet_manager only reads");
+DEFINE_int64(cache_capacity_mb, 256, "capacity of lru_cache and page_cache");
+DEFINE_int32(value_size, 4096, "charge of an entry of lru_cache and size of a page");
+DEFINE_int32(num_tablets, 100, "number of tablets created for tablet_manager");
+DEFINE_string(storage_root_path, "./concurrency_benchmark_data",
+              "storage root path of tablet_manager, which is removed before and after running");
+DEFINE_string(output_json, "", "write results into this file as JSON");
+
+namespace doris {
+
+// keys are taken from a shared sequence of zipf samples, at different
+// positions by different threads
+static const int64_t kNumSamples = 1 << 20;
+static const uint32_t kSeed = 20191101;
+static const int64_t kPartitionId = 10;
+static const int32_t kSchemaHash = 1111;
+static const int64_t kFirstTabletId = 10000;
+// check whether to stop every kCheckInterval operations
+static const int kCheckInterval = 64;
+
+class Workload {
+public:
+    virtual ~Workload() { }
+
+    virtual Status init() { return Status::OK(); }
+    virtual void close() { }
+
+    // Run one operation on 'key' by thread 'thread_id'. Return true if it
+    // finds an existing entry.
+    virtual bool run(int thread_id, int64_t key, bool write) = 0;
+
+    // Whether the results of run() are hits of a cache
+    virtual bool is_cache() const { return false; }
+};
+
+class LruCacheWorkload : public Workload {
+public:
+    Status init() override {
+        _cache.reset(new_lru_cache(FLAGS_cache_capacity_mb * 1024 * 1024));
+        return Status::OK();
+    }
+
+    void close() override { _cache.reset(); }
+
+    bool run(int thread_id, int64_t key, bool write) override {
+        CacheKey cache_key((const char*)&key, sizeof(key));
+        if (write) {
+            _cache->erase(cache_key);
+            return false;
+        }
+        Cache::Handle* handle = _cache->lookup(cache_key);
+        if (handle != nullptr) {
+            _cache->release(handle);
+            return true;
+        }
+        // values are not used, so all entries share one
+        handle = _cache->insert(cache_key, &_value, FLAGS_value_size,
+                                [](const CacheKey& key, void* value) { });
+        _cache->release(handle);
+        return false;
+    }
+
+    bool is_cache() const override { return true; }
+
+private:
+    std::unique_ptr<Cache> _cache;
+    int64_t _value = 0;
+};
+
+class PageCacheWorkload : public Workload {
+public:
+    Status init() override {
+        _cache.reset(new StoragePageCache(FLAGS_cache_capacity_mb * 1024 * 1024));
+        return Status::OK();
+    }
+
+    void close() override { _cache.reset(); }
+
+    bool run(int thread_id, int64_t key, bool write) override {
+        // pages of the same segment file are at different offsets, like the
+        // keys built by ColumnReader
+        StoragePageCache::CacheKey cache_key(
+            "segment_" + std::to_string(key / kPagesPerFile) + ".dat",
+            (key % kPagesPerFile) * FLAGS_value_size);
+        PageCacheHandle handle;
+        if (!write && _cache->lookup(cache_key, &handle)) {
+            return true;
+        }
+        // the cache owns the page after inserted
+        Slice page(new uint8_t[FLAGS_value_size], FLAGS_value_size);
+        _cache->insert(cache_key, page, &handle, PageCacheType::DATA_PAGE,
+                       write ? CachePriority::PREFETCH : CachePriority::NORMAL);
+        return false;
+    }
+
+    bool is_cache() const override { return true; }
+
+private:
+    static const int64_t kPagesPerFile = 1024;
+
+    std::unique_ptr<StoragePageCache> _cache;
+};
+
+class TabletManagerWorkload : public Workload {
+public:
+    Status init() override {
+        remove_all_dir(FLAGS_storage_root_path);
+        if (create_dir(FLAGS_storage_root_path) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to create " + FLAGS_storage_root_path);
+        }
+        EngineOptions options;
+        options.store_paths.emplace_back(FLAGS_storage_root_path, -1);
+        RETURN_IF_ERROR(StorageEngine::open(options, &_engine));
+        for (int i = 0; i < FLAGS_num_tablets; ++i) {
+            TCreateTabletReq request;
+            create_tablet_request(kFirstTabletId + i, &request);
+            if (_engine->create_tablet(request) != OLAP_SUCCESS) {
+                return Status::InternalError("failed to create tablet");
+            }
+        }
+        return Status::OK();
+    }
+
+    void close() override {
+        delete _engine;
+        _engine = nullptr;
+        remove_all_dir(FLAGS_storage_root_path);
+    }
+
+    bool run(int thread_id, int64_t key, bool write) override {
+        TabletSharedPtr tablet = _engine->tablet_manager()->get_tablet(
+            kFirstTabletId + key % FLAGS_num_tablets, kSchemaHash);
+        return tablet != nullptr;
+    }
+
+private:
+    static void create_tablet_request(int64_t tablet_id, TCreateTabletReq* request) {
+        request->tablet_id = tablet_id;
+        request->__set_version(1);
+        request->__set_version_hash(0);
+        request->tablet_schema.schema_hash = kSchemaHash;
+        request->tablet_schema.short_key_column_count = 1;
+        request->tablet_schema.keys_type = TKeysType::DUP_KEYS;
+        request->tablet_schema.storage_type = TStorageType::COLUMN;
+
+        TColumn key_column;
+        key_column.column_name = "k";
+        key_column.__set_is_key(true);
+        key_column.column_type.type = TPrimitiveType::INT;
+        request->tablet_schema.columns.push_back(key_column);
+
+        TColumn value_column;
+        value_column.column_name = "v";
+        value_column.__set_is_key(false);
+        value_column.column_type.type = TPrimitiveType::BIGINT;
+        value_column.__set_aggregation_type(TAggregationType::NONE);
+        request->tablet_schema.columns.push_back(value_column);
+    }
+
+    StorageEngine* _engine = nullptr;
+};
+
+class TxnManagerWorkload : public Workload {
+public:
+    Status init() override {
+        _txn_manager.reset(new TxnManager());
+        return Status::OK();
+    }
+
+    void close() override { _txn_manager.reset(); }
+
+    // Txns are the keys and every thread loads its own tablet, so that
+    // threads contend on the shards of txns, as loads of many tablets do.
+    bool run(int thread_id, int64_t key, bool write) override {
+        TTransactionId txn_id = key + 1;
+        TTabletId tablet_id = kFirstTabletId + thread_id;
+        TabletUid tablet_uid(0, tablet_id);
+        if (!write) {
+            return _txn_manager->has_txn(kPartitionId, txn_id, tablet_id, kSchemaHash,
+                                         tablet_uid);
+        }
+        PUniqueId load_id;
+        load_id.set_hi(thread_id);
+        load_id.set_lo(txn_id);
+        _txn_manager->prepare_txn(kPartitionId, txn_id, tablet_id, kSchemaHash, tablet_uid,
+                                  load_id);
+        _txn_manager->rollback_txn(kPartitionId, txn_id, tablet_id, kSchemaHash, tablet_uid);
+        return false;
+    }
+
+private:
+    std::unique_ptr<TxnManager> _txn_manager;
+};
+
+static std::unique_ptr<Workload> create_workload(const std::string& name) {
+    std::unique_ptr<Workload> workload;
+    if (name == "lru_cache") {
+        workload.reset(new LruCacheWorkload());
+    } else if (name == "page_cache") {
+        workload.reset(new PageCacheWorkload());
+    } else if (name == "tablet_manager") {
+        workload.reset(new TabletManagerWorkload());
+    } else if (name == "txn_manager") {
+        workload.reset(new TxnManagerWorkload());
+    }
+    return workload;
+}
+
+// keys in [0, num_keys) of the zipf distribution, in which key i is the
+// (i + 1)th most frequent one
+static std::vector<int64_t> zipf_samples() {
+    std::vector<double> cdf(FLAGS_num_keys);
+    double sum = 0;
+    for (int64_t i = 0; i < FLAGS_num_keys; ++i) {
+        sum += 1.0 / pow(i + 1, FLAGS_zipf_exponent);
+        cdf[i] = sum;
+    }
+    std::mt19937_64 rng(kSeed);
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<int64_t> samples(kNumSamples);
+    for (int64_t i = 0; i < kNumSamples; ++i) {
+        int64_t key = std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin();
+        samples[i] = std::min(key, FLAGS_num_keys - 1);
+    }
+    return samples;
+}
+
+struct ThreadResult {
+    int64_t ops = 0;
+    int64_t hits = 0;
+    int64_t lock_waits = 0;
+    int64_t lock_wait_ns = 0;
+};
+
+struct RunResult {
+    std::string workload;
+    int num_threads = 0;
+    bool is_cache = false;
+    int64_t real_ns = 0;
+    ThreadResult total;
+};
+
+// Run 'workload' by 'num_threads' threads for duration_ms
+static RunResult run_workload(const std::string& name, Workload* workload, int num_threads,
+                              const std::vector<int64_t>& samples) {
+    std::vector<ThreadResult> results(num_threads);
+    std::atomic<int> num_ready(0);
+    std::atomic<bool> started(false);
+    std::atomic<bool> stopped(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            // a different sequence of write decisions for each thread
+            std::mt19937 rng(kSeed + t);
+            std::uniform_int_distribution<int> percent(0, 99);
+            size_t pos = (size_t)t * kNumSamples / num_threads;
+            ThreadResult* result = &results[t];
+
+            num_ready++;
+            while (!started.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            LockWaitStats start_stats = *LockWaitStats::current();
+            while (!stopped.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < kCheckInterval; ++i) {
+                    bool write = percent(rng) < FLAGS_write_percent;
+                    result->hits += workload->run(t, samples[pos], write);
+                    pos = pos + 1 == samples.size() ? 0 : pos + 1;
+                }
+                result->ops += kCheckInterval;
+            }
+            const LockWaitStats* stats = LockWaitStats::current();
+            result->lock_waits = stats->wait_count - start_stats.wait_count;
+            result->lock_wait_ns = stats->wait_ns - start_stats.wait_ns;
+        });
+    }
+    while (num_ready.load() < num_threads) {
+        std::this_thread::yield();
+    }
+
+    MonotonicStopWatch watch;
+    watch.start();
+    started.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_duration_ms));
+    stopped.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    RunResult run_result;
+    run_result.workload = name;
+    run_result.num_threads = num_threads;
+    run_result.is_cache = workload->is_cache();
+    run_result.real_ns = watch.elapsed_time();
+    for (auto& result : results) {
+        run_result.total.ops += result.ops;
+        run_result.total.hits += result.hits;
+        run_result.total.lock_waits += result.lock_waits;
+        run_result.total.lock_wait_ns += result.lock_wait_ns;
+    }
+    return run_result;
+}
+
+static double ops_per_second(const RunResult& r) {
+    return r.real_ns > 0 ? r.total.ops * 1e9 / r.real_ns : 0;
+}
+
+static double hit_ratio(const RunResult& r) {
+    return r.total.ops > 0 ? (double)r.total.hits / r.total.ops : 0;
+}
+
+static double lock_wait_ns_per_op(const RunResult& r) {
+    return r.total.ops > 0 ? (double)r.total.lock_wait_ns / r.total.ops : 0;
+}
+
+// percent of the time of all threads which is spent waiting for locks
+static double lock_wait_percent(const RunResult& r) {
+    double thread_ns = (double)r.real_ns * r.num_threads;
+    return thread_ns > 0 ? r.total.lock_wait_ns * 100.0 / thread_ns : 0;
+}
+
+static void print_results(const std::vector<RunResult>& results) {
+    printf("%-16s %8s %12s %14s %8s %12s %14s %10s\n", "Workload", "Threads", "Mops/s",
+           "Kops/s/thread", "Hit %", "Waits/Kops", "Wait ns/op", "Wait %");
+    for (auto& r : results) {
+        double ops = ops_per_second(r);
+        char hit[16] = "-";
+        if (r.is_cache) {
+            snprintf(hit, sizeof(hit), "%.1f", hit_ratio(r) * 100);
+        }
+        printf("%-16s %8d %12.3f %14.1f %8s %12.2f %14.1f %10.2f\n", r.workload.c_str(),
+               r.num_threads, ops / 1e6, ops / r.num_threads / 1e3, hit,
+               r.total.ops > 0 ? r.total.lock_waits * 1000.0 / r.total.ops : 0,
+               lock_wait_ns_per_op(r), lock_wait_percent(r));
+    }
+}
+
+static std::string to_json(const std::vector<RunResult>& results) {
+    rapidjson::StringBuffer s;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
+    writer.StartObject();
+    writer.Key("context");
+    writer.StartObject();
+    writer.Key("num_cpus");
+    writer.Int(CpuInfo::num_cores());
+    writer.Key("duration_ms");
+    writer.Int(FLAGS_duration_ms);
+    writer.Key("num_keys");
+    writer.Int64(FLAGS_num_keys);
+    writer.Key("zipf_exponent");
+    writer.Double(FLAGS_zipf_exponent);
+    writer.Key("write_percent");
+    writer.Int(FLAGS_write_percent);
+    writer.Key("cache_capacity_mb");
+    writer.Int64(FLAGS_cache_capacity_mb);
+    writer.Key("value_size");
+    writer.Int(FLAGS_value_size);
+    writer.Key("num_tablets");
+    writer.Int(FLAGS_num_tablets);
+    writer.EndObject();
+    writer.Key("runs");
+    writer.StartArray();
+    for (auto& r : results) {
+        writer.StartObject();
+        writer.Key("workload");
+        writer.String(r.workload.c_str());
+        writer.Key("threads");
+        writer.Int(r.num_threads);
+        writer.Key("real_time_ns");
+        writer.Int64(r.real_ns);
+        writer.Key("ops");
+        writer.Int64(r.total.ops);
+        writer.Key("ops_per_second");
+        writer.Double(ops_per_second(r));
+        if (r.is_cache) {
+            writer.Key("hit_ratio");
+            writer.Double(hit_ratio(r));
+        }
+        writer.Key("lock_waits");
+        writer.Int64(r.total.lock_waits);
+        writer.Key("lock_wait_ns");
+        writer.Int64(r.total.lock_wait_ns);
+        writer.Key("lock_wait_ns_per_op");
+        writer.Double(lock_wait_ns_per_op(r));
+        writer.Key("lock_wait_percent");
+        writer.Double(lock_wait_percent(r));
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return s.GetString();
+}
+
+static int run() {
+    std::vector<std::string> workloads;
+    split_string<char>(FLAGS_workloads, ',', &workloads);
+    std::vector<std::string> thread_strs;
+    split_string<char>(FLAGS_threads, ',', &thread_strs);
+    std::vector<int> thread_nums;
+    for (auto& str : thread_strs) {
+        int num = atoi(str.c_str());
+        if (num <= 0) {
+            std::cerr << "invalid number of threads: " << str << std::endl;
+            return 1;
+        }
+        thread_nums.push_back(num);
+    }
+
+    std::vector<int64_t> samples = zipf_samples();
+    LockWaitStats::set_enabled(true);
+    std::vector<RunResult> results;
+    for (auto& name : workloads) {
+        std::unique_ptr<Workload> workload = create_workload(name);
+        if (workload == nullptr) {
+            std::cerr << "unknown workload: " << name << std::endl;
+            return 1;
+        }
+        Status st = workload->init();
+        if (!st.ok()) {
+            std::cerr << "failed to init " << name << ": " << st.to_string() << std::endl;
+            workload->close();
+            return 1;
+        }
+        for (int num_threads : thread_nums) {
+            results.push_back(run_workload(name, workload.get(), num_threads, samples));
+        }
+        workload->close();
+    }
+
+    print_results(results);
+    if (!FLAGS_output_json.empty()) {
+        std::ofstream out(FLAGS_output_json);
+        out << to_json(results) << std::endl;
+        if (!out.good()) {
+            std::cerr << "failed to write " << FLAGS_output_json << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    gflags::SetUsageMessage("Contention benchmark of caches, TabletManager and TxnManager");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    if (!doris::config::init(nullptr, false)) {
+        std::cerr << "failed to init config" << std::endl;
+        return 1;
+    }
+    if (FLAGS_num_keys <= 0 || FLAGS_num_tablets <= 0 || FLAGS_value_size <= 0) {
+        std::cerr << "num_keys, num_tablets and value_size must be positive" << std::endl;
+        return 1;
+    }
+    doris::CpuInfo::init();
+
+    int ret = doris::run();
+    google::protobuf::ShutdownProtobufLibrary();
+    return ret;
+}
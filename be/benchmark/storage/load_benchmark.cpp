@@ -0,0 +1,584 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Benchmark of the load path of one tablet without a cluster: tuples are
+// inserted into memtables, which are flushed into a rowset writer when they
+// reach write_buffer_size, as DeltaWriter does. Insert, flush and build are
+// measured separately for alpha and beta rowset writers, and the whole
+// DeltaWriter, which only writes alpha rowsets, is measured end to end.
+//
+//   load_benchmark --keys_type=agg --key_cardinality=10000 --output_json=result.json
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "common/config.h"
+#include "common/object_pool.h"
+#include "gen_cpp/AgentService_types.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "olap/delta_writer.h"
+#include "olap/memtable.h"
+#include "olap/options.h"
+#include "olap/rowset/alpha_rowset_writer.h"
+#include "olap/rowset/beta_rowset_writer.h"
+#include "olap/schema.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/utils.h"
+#include "runtime/descriptors.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+#include "util/cpu_info.h"
+#include "util/descriptor_helper.h"
+#include "util/stopwatch.hpp"
+
+DEFINE_string(storage_root_path, "./load_benchmark_data",
+              "storage root path, which is removed before and after running");
+DEFINE_string(keys_type, "dup", "keys type of the tablet: dup, agg or unique");
+DEFINE_int32(num_key_columns, 3, "number of INT key columns");
+DEFINE_int32(num_value_columns, 4, "number of BIGINT value columns");
+DEFINE_int32(num_varchar_columns, 1, "number of VARCHAR value columns");
+DEFINE_int32(varchar_len, 32, "length of the values of VARCHAR columns");
+DEFINE_int64(key_cardinality, 1000000, "number of distinct keys");
+DEFINE_int64(num_rows, 2000000, "number of rows to load");
+DEFINE_string(rowset_types, "alpha,beta", "rowset writers to measure stages with");
+DEFINE_bool(delta_writer, true, "also measure the whole DeltaWriter");
+DEFINE_int64(write_buffer_size, 0, "memtable size, 0 to use the config default");
+DEFINE_bool(memtable_use_sorted_vector, false, "see config memtable_use_sorted_vector");
+DEFINE_string(output_json, "", "write results into this file as JSON");
+
+namespace doris {
+
+static const int64_t kPartitionId = 10;
+static const int32_t kSchemaHash = 1111;
+// tuples are generated by batches, which is not measured
+static const int kTupleBatchSize = 1024;
+
+struct StageResult {
+    std::string name;
+    int64_t rows = 0;
+    int64_t bytes = 0;
+    int64_t real_ns = 0;
+    int64_t cpu_ns = 0;
+    int64_t peak_memory_bytes = 0;
+};
+
+static int64_t process_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+static int64_t peak_rss_bytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss * 1024L;
+}
+
+static TKeysType::type keys_type_from_flag() {
+    if (FLAGS_keys_type == "agg") {
+        return TKeysType::AGG_KEYS;
+    } else if (FLAGS_keys_type == "unique") {
+        return TKeysType::UNIQUE_KEYS;
+    }
+    return TKeysType::DUP_KEYS;
+}
+
+static TAggregationType::type value_aggregation(TKeysType::type keys_type, bool is_varchar) {
+    switch (keys_type) {
+    case TKeysType::AGG_KEYS:
+        return is_varchar ? TAggregationType::REPLACE : TAggregationType::SUM;
+    case TKeysType::UNIQUE_KEYS:
+        return TAggregationType::REPLACE;
+    default:
+        return TAggregationType::NONE;
+    }
+}
+
+// Columns are named k<i>, v<i> and s<i> for INT keys, BIGINT values and
+// VARCHAR values, in this order.
+static void create_tablet_request(int64_t tablet_id, TCreateTabletReq* request) {
+    TKeysType::type keys_type = keys_type_from_flag();
+    request->tablet_id = tablet_id;
+    request->__set_version(1);
+    request->__set_version_hash(0);
+    request->tablet_schema.schema_hash = kSchemaHash;
+    request->tablet_schema.short_key_column_count = std::min(FLAGS_num_key_columns, 3);
+    request->tablet_schema.keys_type = keys_type;
+    request->tablet_schema.storage_type = TStorageType::COLUMN;
+
+    for (int i = 0; i < FLAGS_num_key_columns; ++i) {
+        TColumn column;
+        column.column_name = "k" + std::to_string(i);
+        column.__set_is_key(true);
+        column.column_type.type = TPrimitiveType::INT;
+        request->tablet_schema.columns.push_back(column);
+    }
+    for (int i = 0; i < FLAGS_num_value_columns; ++i) {
+        TColumn column;
+        column.column_name = "v" + std::to_string(i);
+        column.__set_is_key(false);
+        column.column_type.type = TPrimitiveType::BIGINT;
+        column.__set_aggregation_type(value_aggregation(keys_type, false));
+        request->tablet_schema.columns.push_back(column);
+    }
+    for (int i = 0; i < FLAGS_num_varchar_columns; ++i) {
+        TColumn column;
+        column.column_name = "s" + std::to_string(i);
+        column.__set_is_key(false);
+        column.column_type.type = TPrimitiveType::VARCHAR;
+        column.column_type.__set_len(FLAGS_varchar_len);
+        column.__set_aggregation_type(value_aggregation(keys_type, true));
+        request->tablet_schema.columns.push_back(column);
+    }
+}
+
+static TDescriptorTable create_descriptor_table() {
+    TDescriptorTableBuilder dtb;
+    TTupleDescriptorBuilder tuple_builder;
+    int pos = 0;
+    for (int i = 0; i < FLAGS_num_key_columns; ++i) {
+        tuple_builder.add_slot(TSlotDescriptorBuilder().type(TYPE_INT).nullable(false)
+            .column_name("k" + std::to_string(i)).column_pos(pos++).build());
+    }
+    for (int i = 0; i < FLAGS_num_value_columns; ++i) {
+        tuple_builder.add_slot(TSlotDescriptorBuilder().type(TYPE_BIGINT).nullable(false)
+            .column_name("v" + std::to_string(i)).column_pos(pos++).build());
+    }
+    for (int i = 0; i < FLAGS_num_varchar_columns; ++i) {
+        tuple_builder.add_slot(TSlotDescriptorBuilder().string_type(FLAGS_varchar_len)
+            .nullable(false).column_name("s" + std::to_string(i)).column_pos(pos++).build());
+    }
+    tuple_builder.build(&dtb);
+    return dtb.desc_tbl();
+}
+
+// Generates batches of tuples, a batch is valid until the next one is generated
+class TupleGenerator {
+public:
+    explicit TupleGenerator(const TupleDescriptor* tuple_desc)
+            : _tuple_desc(tuple_desc), _rng(20191101) {
+        _tuple_buf.resize(kTupleBatchSize * tuple_desc->byte_size());
+        _string_buf.resize(kTupleBatchSize * FLAGS_num_varchar_columns * FLAGS_varchar_len);
+    }
+
+    // return the number of tuples generated, and also the bytes of their values
+    int next_batch(int64_t max_rows, std::vector<Tuple*>* tuples, int64_t* bytes) {
+        static const char* kAlphabet = "abcdefghijklmnopqrstuvwxyz";
+        const std::vector<SlotDescriptor*>& slots = _tuple_desc->slots();
+        int num = std::min<int64_t>(max_rows, kTupleBatchSize);
+        tuples->clear();
+        *bytes = 0;
+        char* str = _string_buf.data();
+        for (int i = 0; i < num; ++i) {
+            Tuple* tuple = (Tuple*)(_tuple_buf.data() + i * _tuple_desc->byte_size());
+            memset(tuple, 0, _tuple_desc->byte_size());
+            int64_t key = _rng() % FLAGS_key_cardinality;
+            int slot_id = 0;
+            for (int j = 0; j < FLAGS_num_key_columns; ++j) {
+                // the other key columns are functions of the first one, so the
+                // number of distinct keys is key_cardinality
+                int32_t value = j == 0 ? key : (int32_t)((key * 2654435761L + j) & 0x7fffffff);
+                *(int32_t*)tuple->get_slot(slots[slot_id++]->tuple_offset()) = value;
+                *bytes += sizeof(int32_t);
+            }
+            for (int j = 0; j < FLAGS_num_value_columns; ++j) {
+                *(int64_t*)tuple->get_slot(slots[slot_id++]->tuple_offset()) = _rng();
+                *bytes += sizeof(int64_t);
+            }
+            for (int j = 0; j < FLAGS_num_varchar_columns; ++j) {
+                for (int k = 0; k < FLAGS_varchar_len; ++k) {
+                    str[k] = kAlphabet[_rng() % 26];
+                }
+                StringValue* value = (StringValue*)tuple->get_slot(slots[slot_id++]->tuple_offset());
+                value->ptr = str;
+                value->len = FLAGS_varchar_len;
+                str += FLAGS_varchar_len;
+                *bytes += FLAGS_varchar_len;
+            }
+            tuples->push_back(tuple);
+        }
+        return num;
+    }
+
+private:
+    const TupleDescriptor* _tuple_desc;
+    std::mt19937_64 _rng;
+    std::vector<char> _tuple_buf;
+    std::vector<char> _string_buf;
+};
+
+class LoadBenchmark {
+public:
+    Status init() {
+        remove_all_dir(FLAGS_storage_root_path);
+        if (create_dir(FLAGS_storage_root_path) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to create " + FLAGS_storage_root_path);
+        }
+        EngineOptions options;
+        options.store_paths.emplace_back(FLAGS_storage_root_path, -1);
+        RETURN_IF_ERROR(StorageEngine::open(options, &_engine));
+
+        DescriptorTbl* desc_tbl = nullptr;
+        RETURN_IF_ERROR(DescriptorTbl::create(&_obj_pool, create_descriptor_table(), &desc_tbl));
+        _tuple_desc = desc_tbl->get_tuple_descriptor(0);
+        return Status::OK();
+    }
+
+    void close() {
+        delete _engine;
+        _engine = nullptr;
+        remove_all_dir(FLAGS_storage_root_path);
+    }
+
+    // Insert into memtables and flush them into a rowset writer of 'rowset_type'
+    Status run_stages(RowsetTypePB rowset_type, std::vector<StageResult>* results) {
+        TabletSharedPtr tablet;
+        RETURN_IF_ERROR(_create_tablet(&tablet));
+        std::string prefix = rowset_type == ALPHA_ROWSET ? "alpha/" : "beta/";
+
+        RowsetWriterContext context;
+        RETURN_IF_ERROR(_init_writer_context(tablet, rowset_type, &context));
+        RowsetWriterSharedPtr rowset_writer;
+        if (rowset_type == ALPHA_ROWSET) {
+            rowset_writer.reset(new AlphaRowsetWriter());
+        } else {
+            rowset_writer.reset(new BetaRowsetWriter());
+        }
+        if (rowset_writer->init(context) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to init rowset writer");
+        }
+
+        const TabletSchema& tablet_schema = tablet->tablet_schema();
+        Schema schema(tablet_schema);
+        std::vector<uint32_t> col_ids;
+        for (uint32_t i = 0; i < tablet_schema.num_columns(); ++i) {
+            col_ids.push_back(i);
+        }
+        KeysType keys_type = tablet->keys_type();
+
+        StageResult insert;
+        insert.name = prefix + "memtable_insert";
+        StageResult flush;
+        flush.name = prefix + "memtable_flush";
+        StageResult build;
+        build.name = prefix + "rowset_build";
+
+        TupleGenerator generator(_tuple_desc);
+        std::unique_ptr<MemTable> mem_table(
+            new MemTable(&schema, &tablet_schema, &col_ids, _tuple_desc, keys_type));
+        std::vector<Tuple*> tuples;
+        int64_t rows_left = FLAGS_num_rows;
+        while (rows_left > 0) {
+            int64_t bytes = 0;
+            int num = generator.next_batch(rows_left, &tuples, &bytes);
+            rows_left -= num;
+            insert.rows += num;
+            insert.bytes += bytes;
+
+            MonotonicStopWatch watch;
+            watch.start();
+            int64_t cpu_start = process_cpu_ns();
+            for (Tuple* tuple : tuples) {
+                mem_table->insert(tuple);
+            }
+            insert.cpu_ns += process_cpu_ns() - cpu_start;
+            insert.real_ns += watch.elapsed_time();
+            insert.peak_memory_bytes = std::max<int64_t>(
+                insert.peak_memory_bytes, mem_table->memory_usage());
+
+            if (mem_table->memory_usage() >= config::write_buffer_size || rows_left == 0) {
+                // the rows are counted by the rowset at last
+                RETURN_IF_ERROR(_measure(&flush, [&] {
+                    return mem_table->flush(rowset_writer) == OLAP_SUCCESS;
+                }));
+                mem_table.reset(
+                    new MemTable(&schema, &tablet_schema, &col_ids, _tuple_desc, keys_type));
+            }
+        }
+        flush.peak_memory_bytes = peak_rss_bytes();
+
+        RowsetSharedPtr rowset;
+        RETURN_IF_ERROR(_measure(&build, [&] {
+            rowset = rowset_writer->build();
+            return rowset != nullptr;
+        }));
+        build.peak_memory_bytes = peak_rss_bytes();
+        flush.rows = rowset->num_rows();
+        flush.bytes = rowset->data_disk_size();
+        build.rows = rowset->num_rows();
+        build.bytes = rowset->data_disk_size();
+
+        results->push_back(insert);
+        results->push_back(flush);
+        results->push_back(build);
+        return Status::OK();
+    }
+
+    // Write all rows by DeltaWriter, including its background flush
+    Status run_delta_writer(std::vector<StageResult>* results) {
+        TabletSharedPtr tablet;
+        RETURN_IF_ERROR(_create_tablet(&tablet));
+
+        PUniqueId load_id;
+        load_id.set_hi(0);
+        load_id.set_lo(++_next_txn_id);
+        WriteRequest write_req = { tablet->tablet_id(), kSchemaHash, WriteType::LOAD,
+                                   _next_txn_id, kPartitionId, load_id, false, _tuple_desc };
+        DeltaWriter* writer = nullptr;
+        if (DeltaWriter::open(&write_req, &writer) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to open delta writer");
+        }
+        std::unique_ptr<DeltaWriter> writer_ptr(writer);
+
+        StageResult result;
+        result.name = "delta_writer";
+        TupleGenerator generator(_tuple_desc);
+        std::vector<Tuple*> tuples;
+        int64_t rows_left = FLAGS_num_rows;
+        while (rows_left > 0) {
+            int64_t bytes = 0;
+            int num = generator.next_batch(rows_left, &tuples, &bytes);
+            rows_left -= num;
+            result.rows += num;
+            result.bytes += bytes;
+            RETURN_IF_ERROR(_measure(&result, [&] {
+                for (Tuple* tuple : tuples) {
+                    if (writer->write(tuple) != OLAP_SUCCESS) {
+                        return false;
+                    }
+                }
+                return true;
+            }));
+        }
+        RETURN_IF_ERROR(_measure(&result, [&] {
+            return writer->close(nullptr) == OLAP_SUCCESS;
+        }));
+        result.peak_memory_bytes = peak_rss_bytes();
+        results->push_back(result);
+        return Status::OK();
+    }
+
+private:
+    template<typename Func>
+    Status _measure(StageResult* result, Func func) {
+        MonotonicStopWatch watch;
+        watch.start();
+        int64_t cpu_start = process_cpu_ns();
+        bool ok = func();
+        result->cpu_ns += process_cpu_ns() - cpu_start;
+        result->real_ns += watch.elapsed_time();
+        if (!ok) {
+            return Status::InternalError("failed to run " + result->name);
+        }
+        return Status::OK();
+    }
+
+    Status _create_tablet(TabletSharedPtr* tablet) {
+        int64_t tablet_id = ++_next_tablet_id;
+        TCreateTabletReq request;
+        create_tablet_request(tablet_id, &request);
+        if (_engine->create_tablet(request) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to create tablet");
+        }
+        *tablet = _engine->tablet_manager()->get_tablet(tablet_id, kSchemaHash);
+        if (*tablet == nullptr) {
+            return Status::InternalError("failed to get tablet");
+        }
+        return Status::OK();
+    }
+
+    Status _init_writer_context(TabletSharedPtr tablet, RowsetTypePB rowset_type,
+                                RowsetWriterContext* context) {
+        RowsetId rowset_id = 0;
+        if (tablet->next_rowset_id(&rowset_id) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to generate rowset id");
+        }
+        context->rowset_id = rowset_id;
+        context->tablet_uid = tablet->tablet_uid();
+        context->tablet_id = tablet->tablet_id();
+        context->partition_id = kPartitionId;
+        context->tablet_schema_hash = kSchemaHash;
+        context->rowset_type = rowset_type;
+        context->rowset_path_prefix = tablet->tablet_path();
+        context->tablet_schema = &(tablet->tablet_schema());
+        context->rowset_state = PREPARED;
+        context->data_dir = tablet->data_dir();
+        context->txn_id = ++_next_txn_id;
+        context->load_id.set_hi(0);
+        context->load_id.set_lo(_next_txn_id);
+        return Status::OK();
+    }
+
+    StorageEngine* _engine = nullptr;
+    ObjectPool _obj_pool;
+    TupleDescriptor* _tuple_desc = nullptr;
+    int64_t _next_tablet_id = 10000;
+    int64_t _next_txn_id = 20000;
+};
+
+static void print_results(const std::vector<StageResult>& results) {
+    printf("%-24s %12s %12s %12s %12s %14s\n",
+           "Stage", "Rows", "Krows/s", "MB/s", "CPU ns/row", "Peak memory MB");
+    for (auto& r : results) {
+        double secs = r.real_ns / 1e9;
+        printf("%-24s %12ld %12.1f %12.1f %12.1f %14.1f\n", r.name.c_str(), r.rows,
+               secs > 0 ? r.rows / secs / 1000 : 0,
+               secs > 0 ? r.bytes / secs / 1024 / 1024 : 0,
+               r.rows > 0 ? (double)r.cpu_ns / r.rows : 0,
+               r.peak_memory_bytes / 1024.0 / 1024);
+    }
+}
+
+static std::string to_json(const std::vector<StageResult>& results) {
+    rapidjson::StringBuffer s;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
+
+    writer.StartObject();
+    writer.Key("context");
+    writer.StartObject();
+    writer.Key("keys_type");
+    writer.String(FLAGS_keys_type.c_str());
+    writer.Key("num_key_columns");
+    writer.Int(FLAGS_num_key_columns);
+    writer.Key("num_value_columns");
+    writer.Int(FLAGS_num_value_columns);
+    writer.Key("num_varchar_columns");
+    writer.Int(FLAGS_num_varchar_columns);
+    writer.Key("varchar_len");
+    writer.Int(FLAGS_varchar_len);
+    writer.Key("key_cardinality");
+    writer.Int64(FLAGS_key_cardinality);
+    writer.Key("num_rows");
+    writer.Int64(FLAGS_num_rows);
+    writer.Key("write_buffer_size");
+    writer.Int64(config::write_buffer_size);
+    writer.Key("memtable_use_sorted_vector");
+    writer.Bool(config::memtable_use_sorted_vector);
+    writer.EndObject();
+
+    writer.Key("stages");
+    writer.StartArray();
+    for (auto& r : results) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(r.name.c_str());
+        writer.Key("rows");
+        writer.Int64(r.rows);
+        writer.Key("bytes");
+        writer.Int64(r.bytes);
+        writer.Key("real_time_ns");
+        writer.Int64(r.real_ns);
+        writer.Key("cpu_time_ns");
+        writer.Int64(r.cpu_ns);
+        double secs = r.real_ns / 1e9;
+        writer.Key("rows_per_second");
+        writer.Double(secs > 0 ? r.rows / secs : 0);
+        writer.Key("bytes_per_second");
+        writer.Double(secs > 0 ? r.bytes / secs : 0);
+        writer.Key("cpu_ns_per_row");
+        writer.Double(r.rows > 0 ? (double)r.cpu_ns / r.rows : 0);
+        writer.Key("peak_memory_bytes");
+        writer.Int64(r.peak_memory_bytes);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    return s.GetString();
+}
+
+static int run() {
+    LoadBenchmark benchmark;
+    Status st = benchmark.init();
+    if (!st.ok()) {
+        std::cerr << "failed to init: " << st.to_string() << std::endl;
+        return 1;
+    }
+
+    std::vector<StageResult> results;
+    std::vector<std::string> rowset_types;
+    split_string<char>(FLAGS_rowset_types, ',', &rowset_types);
+    for (auto& type : rowset_types) {
+        if (type == "alpha") {
+            st = benchmark.run_stages(ALPHA_ROWSET, &results);
+        } else if (type == "beta") {
+            st = benchmark.run_stages(BETA_ROWSET, &results);
+        } else {
+            st = Status::InvalidArgument("unknown rowset type: " + type);
+        }
+        if (!st.ok()) {
+            break;
+        }
+    }
+    if (st.ok() && FLAGS_delta_writer) {
+        st = benchmark.run_delta_writer(&results);
+    }
+    benchmark.close();
+    if (!st.ok()) {
+        std::cerr << "failed to run: " << st.to_string() << std::endl;
+        return 1;
+    }
+
+    print_results(results);
+    if (!FLAGS_output_json.empty()) {
+        std::ofstream out(FLAGS_output_json);
+        out << to_json(results) << std::endl;
+        if (!out.good()) {
+            std::cerr << "failed to write " << FLAGS_output_json << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    gflags::SetUsageMessage("Benchmark of memtable insert, flush and rowset write");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    if (!doris::config::init(nullptr, false)) {
+        std::cerr << "failed to init config" << std::endl;
+        return 1;
+    }
+    if (FLAGS_write_buffer_size > 0) {
+        doris::config::write_buffer_size = FLAGS_write_buffer_size;
+    }
+    doris::config::memtable_use_sorted_vector = FLAGS_memtable_use_sorted_vector;
+    if (FLAGS_num_key_columns <= 0 || FLAGS_key_cardinality <= 0) {
+        std::cerr << "num_key_columns and key_cardinality must be positive" << std::endl;
+        return 1;
+    }
+    doris::CpuInfo::init();
+
+    int ret = doris::run();
+    google::protobuf::ShutdownProtobufLibrary();
+    return ret;
+}
@@ -0,0 +1,458 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Benchmarks of segment_v2 page encodings and segment scans on synthetic data.
+//
+//   storage_benchmark --benchmark_filter=Encode/INT --benchmark_out=result.json
+
+#include <stdlib.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_runner.h"
+#include "gen_cpp/olap_file.pb.h"
+#include "olap/column_block.h"
+#include "olap/olap_cond.h"
+#include "olap/row_block2.h"
+#include "olap/row_cursor.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "olap/types.h"
+#include "olap/rowset/segment_v2/binary_dict_page.h"
+#include "olap/rowset/segment_v2/binary_plain_page.h"
+#include "olap/rowset/segment_v2/binary_prefix_page.h"
+#include "olap/rowset/segment_v2/bitshuffle_page.h"
+#include "olap/rowset/segment_v2/frame_of_reference_page.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/plain_page.h"
+#include "olap/rowset/segment_v2/rle_page.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/rowset/segment_v2/segment_iterator.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "util/arena.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static const size_t kNumValues = 1024 * 1024;
+static const uint32_t kSeed = 20191101;
+static const int kLowCardinality = 16;
+
+enum class Distribution {
+    SORTED,
+    RANDOM,
+    LOW_CARDINALITY,
+};
+
+static const char* distribution_name(Distribution dist) {
+    switch (dist) {
+    case Distribution::SORTED:
+        return "sorted";
+    case Distribution::RANDOM:
+        return "random";
+    case Distribution::LOW_CARDINALITY:
+        return "low_cardinality";
+    }
+    return "unknown";
+}
+
+static std::vector<int32_t> generate_ints(Distribution dist, size_t num) {
+    std::mt19937 rng(kSeed);
+    std::vector<int32_t> values(num);
+    for (size_t i = 0; i < num; ++i) {
+        switch (dist) {
+        case Distribution::SORTED:
+            values[i] = i;
+            break;
+        case Distribution::RANDOM:
+            values[i] = rng();
+            break;
+        case Distribution::LOW_CARDINALITY:
+            values[i] = rng() % kLowCardinality;
+            break;
+        }
+    }
+    return values;
+}
+
+static std::vector<std::string> generate_strings(Distribution dist, size_t num) {
+    static const char* kAlphabet = "abcdefghijklmnopqrstuvwxyz0123456789";
+    std::mt19937 rng(kSeed);
+    std::vector<std::string> values(num);
+    for (size_t i = 0; i < num; ++i) {
+        char buf[64];
+        switch (dist) {
+        case Distribution::SORTED:
+            snprintf(buf, sizeof(buf), "key_%012zu", i);
+            values[i] = buf;
+            break;
+        case Distribution::RANDOM: {
+            size_t len = 8 + rng() % 25;
+            for (size_t j = 0; j < len; ++j) {
+                values[i].push_back(kAlphabet[rng() % 36]);
+            }
+            break;
+        }
+        case Distribution::LOW_CARDINALITY:
+            snprintf(buf, sizeof(buf), "category_%02u", (unsigned)(rng() % kLowCardinality));
+            values[i] = buf;
+            break;
+        }
+    }
+    return values;
+}
+
+// The pages and the dictionary page, if any, of an encoded column
+struct EncodedColumn {
+    std::vector<std::string> pages;
+    std::string dict;
+
+    size_t encoded_bytes() const {
+        size_t bytes = dict.size();
+        for (auto& page : pages) {
+            bytes += page.size();
+        }
+        return bytes;
+    }
+};
+
+template<class PageBuilderType>
+static void encode_column(const uint8_t* values, size_t num_values, size_t value_size,
+                          EncodedColumn* column) {
+    PageBuilderOptions opts;
+    // the dictionary is kept in builder, so it is created for every column
+    PageBuilderType builder(opts);
+    column->pages.clear();
+    size_t offset = 0;
+    while (offset < num_values) {
+        size_t n = num_values - offset;
+        builder.add(values + offset * value_size, &n);
+        offset += n;
+        if (n == 0 || builder.is_page_full() || offset == num_values) {
+            Slice page = builder.finish();
+            column->pages.emplace_back(page.data, page.size);
+            builder.reset();
+        }
+    }
+    Slice dict;
+    if (builder.get_dictionary_page(&dict).ok()) {
+        column->dict.assign(dict.data, dict.size);
+    } else {
+        column->dict.clear();
+    }
+}
+
+template<class PageDecoderType>
+static Status decode_column(const EncodedColumn& column, const TypeInfo* type_info,
+                            uint8_t* values, Arena* arena) {
+    PageDecoderOptions opts;
+    if (!column.dict.empty()) {
+        opts.dict_decoder.reset(
+            new BinaryPlainPageDecoder(Slice(column.dict), PageDecoderOptions()));
+        RETURN_IF_ERROR(opts.dict_decoder->init());
+    }
+    ColumnBlock block(type_info, values, nullptr, arena);
+    size_t offset = 0;
+    for (auto& page : column.pages) {
+        PageDecoderType decoder(Slice(page), opts);
+        RETURN_IF_ERROR(decoder.init());
+        ColumnBlockView view(&block, offset);
+        size_t n = decoder.count();
+        RETURN_IF_ERROR(decoder.next_batch(&n, &view));
+        offset += n;
+    }
+    return Status::OK();
+}
+
+// Values of the column to encode, 'raw' points to CppType of the field type
+struct ColumnValues {
+    std::vector<int32_t> ints;
+    std::vector<std::string> strings;
+    std::vector<Slice> slices;
+    const uint8_t* raw = nullptr;
+    size_t value_size = 0;
+    size_t raw_bytes = 0;
+};
+
+static void generate_column(FieldType type, Distribution dist, ColumnValues* values) {
+    if (type == OLAP_FIELD_TYPE_INT) {
+        values->ints = generate_ints(dist, kNumValues);
+        values->raw = (const uint8_t*)values->ints.data();
+        values->value_size = sizeof(int32_t);
+        values->raw_bytes = kNumValues * sizeof(int32_t);
+    } else {
+        values->strings = generate_strings(dist, kNumValues);
+        values->raw_bytes = 0;
+        for (auto& str : values->strings) {
+            values->slices.emplace_back(str);
+            values->raw_bytes += str.size();
+        }
+        values->raw = (const uint8_t*)values->slices.data();
+        values->value_size = sizeof(Slice);
+    }
+}
+
+template<FieldType Type, class PageBuilderType>
+static void BM_Encode(BenchmarkState* state, Distribution dist) {
+    ColumnValues values;
+    generate_column(Type, dist, &values);
+    EncodedColumn column;
+    while (state->keep_running()) {
+        encode_column<PageBuilderType>(values.raw, kNumValues, values.value_size, &column);
+    }
+    state->set_bytes_processed(state->iterations() * values.raw_bytes);
+    state->set_items_processed(state->iterations() * kNumValues);
+    state->set_counter("compression_ratio", (double)values.raw_bytes / column.encoded_bytes());
+}
+
+template<FieldType Type, class PageBuilderType, class PageDecoderType>
+static void BM_Decode(BenchmarkState* state, Distribution dist) {
+    typedef typename TypeTraits<Type>::CppType CppType;
+    ColumnValues values;
+    generate_column(Type, dist, &values);
+    EncodedColumn column;
+    encode_column<PageBuilderType>(values.raw, kNumValues, values.value_size, &column);
+
+    const TypeInfo* type_info = get_type_info(Type);
+    std::unique_ptr<CppType[]> decoded(new CppType[kNumValues]);
+    while (state->keep_running()) {
+        // decoded strings are copied into the arena
+        Arena arena;
+        Status st = decode_column<PageDecoderType>(
+            column, type_info, (uint8_t*)decoded.get(), &arena);
+        if (!st.ok()) {
+            state->skip_with_error(st.to_string());
+            return;
+        }
+    }
+    state->set_bytes_processed(state->iterations() * values.raw_bytes);
+    state->set_items_processed(state->iterations() * kNumValues);
+    state->set_counter("compression_ratio", (double)values.raw_bytes / column.encoded_bytes());
+}
+
+template<FieldType Type, class PageBuilderType, class PageDecoderType>
+static void register_encoding(const std::string& type_name, const std::string& encoding_name) {
+    for (auto dist : { Distribution::SORTED, Distribution::RANDOM, Distribution::LOW_CARDINALITY }) {
+        std::string suffix = "/" + type_name + "/" + encoding_name + "/" + distribution_name(dist);
+        register_benchmark("BM_Encode" + suffix, [dist](BenchmarkState* state) {
+            BM_Encode<Type, PageBuilderType>(state, dist);
+        });
+        register_benchmark("BM_Decode" + suffix, [dist](BenchmarkState* state) {
+            BM_Decode<Type, PageBuilderType, PageDecoderType>(state, dist);
+        });
+    }
+}
+
+// Segment scans, the segment has columns:
+//   k1     INT, sorted key
+//   v_int  INT, random in [0, kNumValues), 10% null
+//   v_low  INT, kLowCardinality distinct values
+//   v_str  VARCHAR, kLowCardinality distinct values
+// All pages are in the page cache after the first iteration, so the scans
+// measure decoding and predicate evaluation instead of IO.
+class ScanFixture {
+public:
+    static ScanFixture* instance() {
+        static ScanFixture s_fixture;
+        return &s_fixture;
+    }
+
+    Status init() {
+        if (_segment != nullptr) {
+            return Status::OK();
+        }
+        TabletSchemaPB schema_pb;
+        schema_pb.set_keys_type(DUP_KEYS);
+        schema_pb.set_num_short_key_columns(1);
+        schema_pb.set_num_rows_per_row_block(1024);
+        _add_column(&schema_pb, 1, "k1", "INT", true, false, 4);
+        _add_column(&schema_pb, 2, "v_int", "INT", false, true, 4);
+        _add_column(&schema_pb, 3, "v_low", "INT", false, false, 4);
+        _add_column(&schema_pb, 4, "v_str", "VARCHAR", false, false, 64);
+        _tablet_schema.reset(new TabletSchema());
+        _tablet_schema->init_from_pb(schema_pb);
+
+        std::string dir = "./storage_benchmark_data";
+        FileUtils::remove_all(dir);
+        RETURN_IF_ERROR(FileUtils::create_dir(dir));
+        std::string fname = dir + "/scan.dat";
+        RETURN_IF_ERROR(_write_segment(fname));
+
+        _segment.reset(new Segment(fname, 0, _tablet_schema, 1024));
+        return _segment->open();
+    }
+
+    const TabletSchema* tablet_schema() const { return _tablet_schema.get(); }
+    Segment* segment() const { return _segment.get(); }
+
+private:
+    static void _add_column(TabletSchemaPB* schema_pb, int32_t id, const std::string& name,
+                            const std::string& type, bool is_key, bool is_nullable,
+                            int32_t length) {
+        ColumnPB* column = schema_pb->add_column();
+        column->set_unique_id(id);
+        column->set_name(name);
+        column->set_type(type);
+        column->set_is_key(is_key);
+        column->set_is_nullable(is_nullable);
+        column->set_length(length);
+        column->set_index_length(std::min(length, 36));
+        if (!is_key) {
+            column->set_aggregation("NONE");
+        }
+    }
+
+    Status _write_segment(const std::string& fname) {
+        SegmentWriterOptions opts;
+        SegmentWriter writer(fname, 0, _tablet_schema.get(), opts);
+        RETURN_IF_ERROR(writer.init(0));
+
+        RowCursor row;
+        if (row.init(*_tablet_schema) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to init row cursor");
+        }
+        std::vector<int32_t> random_ints = generate_ints(Distribution::RANDOM, kNumValues);
+        std::vector<int32_t> low_ints = generate_ints(Distribution::LOW_CARDINALITY, kNumValues);
+        std::vector<std::string> low_strings =
+            generate_strings(Distribution::LOW_CARDINALITY, kNumValues);
+        for (size_t i = 0; i < kNumValues; ++i) {
+            row.cell(0).set_not_null();
+            *(int32_t*)row.cell(0).mutable_cell_ptr() = i;
+
+            if (i % 10 == 0) {
+                row.cell(1).set_null();
+            } else {
+                row.cell(1).set_not_null();
+                *(int32_t*)row.cell(1).mutable_cell_ptr() = (uint32_t)random_ints[i] % kNumValues;
+            }
+
+            row.cell(2).set_not_null();
+            *(int32_t*)row.cell(2).mutable_cell_ptr() = low_ints[i];
+
+            row.cell(3).set_not_null();
+            *(Slice*)row.cell(3).mutable_cell_ptr() = Slice(low_strings[i]);
+
+            RETURN_IF_ERROR(writer.append_row(row));
+        }
+        uint32_t file_size = 0;
+        return writer.finalize(&file_size);
+    }
+
+    std::shared_ptr<TabletSchema> _tablet_schema;
+    std::shared_ptr<Segment> _segment;
+};
+
+static void BM_SegmentScan(BenchmarkState* state, const std::vector<TCondition>& tconditions) {
+    ScanFixture* fixture = ScanFixture::instance();
+    Status st = fixture->init();
+    if (!st.ok()) {
+        state->skip_with_error(st.to_string());
+        return;
+    }
+    Conditions conditions;
+    conditions.set_tablet_schema(fixture->tablet_schema());
+    for (auto& tcondition : tconditions) {
+        if (conditions.append_condition(tcondition) != OLAP_SUCCESS) {
+            state->skip_with_error("invalid condition on " + tcondition.column_name);
+            conditions.finalize();
+            return;
+        }
+    }
+
+    Schema schema(*fixture->tablet_schema());
+    int64_t rows_returned = 0;
+    while (state->keep_running()) {
+        std::unique_ptr<SegmentIterator> iter;
+        st = fixture->segment()->new_iterator(schema, &iter);
+        if (st.ok()) {
+            StorageReadOptions read_opts;
+            read_opts.conditions = tconditions.empty() ? nullptr : &conditions;
+            st = iter->init(read_opts);
+        }
+        Arena arena;
+        RowBlockV2 block(schema, 1024, &arena);
+        rows_returned = 0;
+        // an empty block is returned at the end
+        while (st.ok()) {
+            st = iter->next_batch(&block);
+            if (block.num_rows() == 0) {
+                break;
+            }
+            rows_returned += block.num_rows();
+        }
+        if (!st.ok()) {
+            state->skip_with_error(st.to_string());
+            break;
+        }
+    }
+    conditions.finalize();
+    state->set_items_processed(state->iterations() * kNumValues);
+    state->set_counter("rows_returned", rows_returned);
+}
+
+static TCondition make_condition(const std::string& column, const std::string& op,
+                                 const std::string& value) {
+    TCondition condition;
+    condition.column_name = column;
+    condition.condition_op = op;
+    condition.condition_values.push_back(value);
+    return condition;
+}
+
+static void register_benchmarks() {
+    register_encoding<OLAP_FIELD_TYPE_INT, PlainPageBuilder<OLAP_FIELD_TYPE_INT>,
+        PlainPageDecoder<OLAP_FIELD_TYPE_INT>>("INT", "plain");
+    register_encoding<OLAP_FIELD_TYPE_INT, BitshufflePageBuilder<OLAP_FIELD_TYPE_INT>,
+        BitShufflePageDecoder<OLAP_FIELD_TYPE_INT>>("INT", "bit_shuffle");
+    register_encoding<OLAP_FIELD_TYPE_INT, FrameOfReferencePageBuilder<OLAP_FIELD_TYPE_INT>,
+        FrameOfReferencePageDecoder<OLAP_FIELD_TYPE_INT>>("INT", "frame_of_reference");
+    register_encoding<OLAP_FIELD_TYPE_INT, RlePageBuilder<OLAP_FIELD_TYPE_INT>,
+        RlePageDecoder<OLAP_FIELD_TYPE_INT>>("INT", "rle");
+    register_encoding<OLAP_FIELD_TYPE_VARCHAR, BinaryPlainPageBuilder,
+        BinaryPlainPageDecoder>("VARCHAR", "plain");
+    register_encoding<OLAP_FIELD_TYPE_VARCHAR, BinaryDictPageBuilder,
+        BinaryDictPageDecoder>("VARCHAR", "dict");
+    register_encoding<OLAP_FIELD_TYPE_VARCHAR, BinaryPrefixPageBuilder,
+        BinaryPrefixPageDecoder>("VARCHAR", "prefix");
+
+    std::vector<std::pair<std::string, std::vector<TCondition>>> scans = {
+        { "no_predicate", {} },
+        // about 10% rows, evaluated row by row
+        { "random_int_lt", { make_condition("v_int", "<", std::to_string(kNumValues / 10)) } },
+        { "low_card_int_eq", { make_condition("v_low", "=", "3") } },
+        { "low_card_str_eq", { make_condition("v_str", "=", "category_03") } },
+        // about 10% rows, most pages are pruned by zone map
+        { "sorted_key_lt", { make_condition("k1", "<", std::to_string(kNumValues / 10)) } },
+    };
+    for (auto& scan : scans) {
+        auto tconditions = scan.second;
+        register_benchmark("BM_SegmentScan/" + scan.first, [tconditions](BenchmarkState* state) {
+            BM_SegmentScan(state, tconditions);
+        });
+    }
+}
+
+static int s_registered = (register_benchmarks(), 0);
+
+} // namespace segment_v2
+} // namespace doris
+
+BENCHMARK_MAIN();
@@ -113,6 +113,7 @@ Status HeartbeatServer::_heartbeat(
             _master_info->network_address.hostname = master_info.network_address.hostname;
             _master_info->network_address.port = master_info.network_address.port;
             _epoch = master_info.epoch;
+            _master_info->epoch = _epoch;
             need_report = true;
             LOG(INFO) << "master change. new master host: " << _master_info->network_address.hostname
                       << ". port: " << _master_info->network_address.port << ". epoch: " << _epoch;
@@ -127,6 +128,7 @@ Status HeartbeatServer::_heartbeat(
         // when Master FE restarted, host and port remains the same, but epoch will be increased.
         if (master_info.epoch > _epoch) {
             _epoch = master_info.epoch;
+            _master_info->epoch = _epoch;
             need_report = true;
             LOG(INFO) << "master restarted. epoch: " << _epoch;
         }
@@ -18,6 +18,7 @@
 #include "agent/task_worker_pool.h"
 #include <pthread.h>
 #include <sys/stat.h>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <csignal>
@@ -93,6 +94,9 @@ TaskWorkerPool::TaskWorkerPool(
         const TMasterInfo& master_info) :
         _master_info(master_info),
         _worker_thread_condition_lock(_worker_thread_lock),
+        _worker_count(0),
+        _max_worker_count(0),
+        _idle_worker_count(0),
         _task_worker_type(task_worker_type) {
     _agent_utils = new AgentUtils();
     _master_client = new MasterServerClient(_master_info, &_master_service_client_cache);
@@ -132,6 +136,7 @@ void TaskWorkerPool::start() {
         break;
     case TaskWorkerType::PUBLISH_VERSION:
         _worker_count = config::publish_version_worker_count;
+        _max_worker_count = config::publish_version_max_worker_count;
         _callback_function = _publish_version_worker_thread_callback;
         break;
     case TaskWorkerType::CLEAR_ALTER_TASK:
@@ -206,6 +211,7 @@ void TaskWorkerPool::start() {
         // pass
         break;
     }
+    _max_worker_count = std::max(_max_worker_count, _worker_count);
 
 #ifndef BE_TEST
     for (uint32_t i = 0; i < _worker_count; i++) {
@@ -229,6 +235,16 @@ void TaskWorkerPool::submit_task(const TAgentTaskRequest& task) {
         (const_cast<TAgentTaskRequest&>(task)).__set_recv_time(time(nullptr));
         _tasks.push_back(task);
         _worker_thread_condition_lock.notify();
+#ifndef BE_TEST
+        // spawn more workers when tasks are piling up, e.g. thousands of
+        // publish version tasks after a big load. Workers are never stopped.
+        if (_tasks.size() > _idle_worker_count && _worker_count < _max_worker_count) {
+            ++_worker_count;
+            LOG(INFO) << "spawn task worker, worker count:" << _worker_count
+                      << ", queued task count:" << _tasks.size();
+            _spawn_callback_worker_thread(_callback_function);
+        }
+#endif
     }
 }
 
@@ -803,19 +819,34 @@ void* TaskWorkerPool::_publish_version_worker_thread_callback(void* arg_this) {
 #endif
         TAgentTaskRequest agent_task_req;
         TPublishVersionRequest publish_version_req;
+        // signatures of the same transaction resent by fe, which are
+        // finished together with agent_task_req
+        vector<int64_t> merged_signatures;
         {
             lock_guard<Mutex> worker_thread_lock(worker_pool_this->_worker_thread_lock);
             while (worker_pool_this->_tasks.empty()) {
+                ++worker_pool_this->_idle_worker_count;
                 worker_pool_this->_worker_thread_condition_lock.wait();
+                --worker_pool_this->_idle_worker_count;
             }
 
             agent_task_req = worker_pool_this->_tasks.front();
             publish_version_req = agent_task_req.publish_version_req;
             worker_pool_this->_tasks.pop_front();
+            for (auto it = worker_pool_this->_tasks.begin();
+                    it != worker_pool_this->_tasks.end();) {
+                if (it->publish_version_req.transaction_id == publish_version_req.transaction_id) {
+                    merged_signatures.push_back(it->signature);
+                    it = worker_pool_this->_tasks.erase(it);
+                } else {
+                    ++it;
+                }
+            }
         }
 
         DorisMetrics::publish_task_request_total.increment(1);
-        LOG(INFO)<< "get publish version task, signature:" << agent_task_req.signature;
+        LOG(INFO)<< "get publish version task, signature:" << agent_task_req.signature
+                 << ", merged task count:" << merged_signatures.size();
 
         TStatusCode::type status_code = TStatusCode::OK;
         vector<string> error_msgs;
@@ -864,6 +895,11 @@ void* TaskWorkerPool::_publish_version_worker_thread_callback(void* arg_this) {
 
         worker_pool_this->_finish_task(finish_task_request);
         worker_pool_this->_remove_task_info(agent_task_req.task_type, agent_task_req.signature, "");
+        for (int64_t signature : merged_signatures) {
+            finish_task_request.__set_signature(signature);
+            worker_pool_this->_finish_task(finish_task_request);
+            worker_pool_this->_remove_task_info(agent_task_req.task_type, signature, "");
+        }
 #ifndef BE_TEST
     }
 #endif
@@ -1303,6 +1339,13 @@ void* TaskWorkerPool::_report_tablet_worker_thread_callback(void* arg_this) {
     request.__isset.tablets = true;
     AgentStatus status = DORIS_SUCCESS;
 
+    // tablets info accepted by master in last report, the following incremental
+    // reports only contain tablets changed since it
+    std::map<TTabletId, TTablet> last_tablets;
+    bool can_report_incremental = false;
+    TEpoch last_full_report_epoch = -1;
+    time_t last_full_report_time = 0;
+
 #ifndef BE_TEST
     while (true) {
         if (worker_pool_this->_master_info.network_address.port == 0) {
@@ -1316,8 +1359,9 @@ void* TaskWorkerPool::_report_tablet_worker_thread_callback(void* arg_this) {
         request.tablets.clear();
 
         request.__set_report_version(_s_report_version);
+        std::map<TTabletId, TTablet> all_tablets;
         OLAPStatus report_all_tablets_info_status =
-                StorageEngine::instance()->tablet_manager()->report_all_tablets_info(&request.tablets);
+                StorageEngine::instance()->tablet_manager()->report_all_tablets_info(&all_tablets);
         if (report_all_tablets_info_status != OLAP_SUCCESS) {
             OLAP_LOG_WARNING("report get all tablets info failed. status: %d",
                              report_all_tablets_info_status);
@@ -1331,9 +1375,40 @@ void* TaskWorkerPool::_report_tablet_worker_thread_callback(void* arg_this) {
 #endif
         }
 
+        // master loses the reported info when it is changed or restarted,
+        // so all tablets should be reported to it again
+        time_t now = time(NULL);
+        bool is_incremental = can_report_incremental
+                && last_full_report_epoch == worker_pool_this->_master_info.epoch
+                && now - last_full_report_time < config::report_all_tablets_interval_seconds
+                && _get_changed_tablets(last_tablets, all_tablets, &request.tablets);
+        if (!is_incremental) {
+            request.tablets = all_tablets;
+        }
+        // an incremental report is sent even if nothing changed, since master
+        // asks for a full report by it once it dropped or failed a former one
+        request.__set_is_incremental(is_incremental);
+        TEpoch master_epoch = worker_pool_this->_master_info.epoch;
+
         TMasterResult result;
         status = worker_pool_this->_master_client->report(request, &result);
 
+        if (status == DORIS_SUCCESS && result.status.status_code == TStatusCode::OK) {
+            last_tablets.swap(all_tablets);
+            // master in old version doesn't know incremental report, and master
+            // doesn't support it until a full report is applied after it dropped
+            // or failed a report, since report is applied asynchronously
+            can_report_incremental = result.__isset.support_incremental_tablet_report
+                    && result.support_incremental_tablet_report;
+            if (!is_incremental) {
+                last_full_report_epoch = master_epoch;
+                last_full_report_time = now;
+            }
+        } else {
+            // report all tablets next time, since master may not get this one
+            can_report_incremental = false;
+        }
+
         if (status != DORIS_SUCCESS) {
             DorisMetrics::report_all_tablets_requests_failed.increment(1);
             LOG(WARNING) << "finish report olap table state failed. status:" << status
@@ -1351,6 +1426,30 @@ void* TaskWorkerPool::_report_tablet_worker_thread_callback(void* arg_this) {
     return (void*)0;
 }
 
+bool TaskWorkerPool::_get_changed_tablets(
+        const std::map<TTabletId, TTablet>& last_tablets,
+        const std::map<TTabletId, TTablet>& all_tablets,
+        std::map<TTabletId, TTablet>* changed_tablets) {
+    // tablets of both maps are ordered by tablet id
+    auto last_it = last_tablets.begin();
+    for (auto& it : all_tablets) {
+        if (last_it != last_tablets.end() && last_it->first < it.first) {
+            // tablet is dropped since last report
+            return false;
+        }
+        if (last_it != last_tablets.end() && last_it->first == it.first) {
+            if (!(last_it->second == it.second)) {
+                (*changed_tablets)[it.first] = it.second;
+            }
+            ++last_it;
+        } else {
+            // new tablet
+            (*changed_tablets)[it.first] = it.second;
+        }
+    }
+    return last_it == last_tablets.end();
+}
+
 void* TaskWorkerPool::_upload_worker_thread_callback(void* arg_this) {
     TaskWorkerPool* worker_pool_this = (TaskWorkerPool*) arg_this;
 
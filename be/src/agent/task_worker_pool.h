@@ -127,6 +127,14 @@ private:
             int64_t signature,
             TTabletInfo* tablet_info);
 
+    // Put tablets of all_tablets which are not the same as in last_tablets into
+    // changed_tablets. Return false if any tablet of last_tablets is missing in
+    // all_tablets, which can't be described by an incremental report.
+    static bool _get_changed_tablets(
+            const std::map<TTabletId, TTablet>& last_tablets,
+            const std::map<TTabletId, TTablet>& all_tablets,
+            std::map<TTabletId, TTablet>* changed_tablets);
+
     AgentStatus _move_dir(
             const TTabletId tablet_id,
             const TSchemaHash schema_hash,
@@ -148,6 +156,12 @@ private:
     Mutex _worker_thread_lock;
     Condition _worker_thread_condition_lock;
     uint32_t _worker_count;
+    // workers are spawned up to this count when there are more queued tasks
+    // than idle workers
+    uint32_t _max_worker_count;
+    // workers waiting for tasks, only counted by callbacks of pools whose
+    // _max_worker_count is larger than _worker_count
+    uint32_t _idle_worker_count;
     TaskWorkerType _task_worker_type;
     CALLBACK_FUNCTION _callback_function;
     static std::atomic_ulong _s_report_version;
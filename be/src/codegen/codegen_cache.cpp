@@ -0,0 +1,70 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "codegen/codegen_cache.h"
+
+#include <llvm/ExecutionEngine/ExecutionEngine.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include "common/config.h"
+#include "olap/lru_cache.h"
+
+namespace doris {
+
+LlvmCompiledModule::LlvmCompiledModule() : context(new llvm::LLVMContext()) {
+}
+
+LlvmCompiledModule::~LlvmCompiledModule() {
+}
+
+CodegenCache* CodegenCache::instance() {
+    if (config::codegen_cache_capacity <= 0) {
+        return NULL;
+    }
+    static CodegenCache s_cache(config::codegen_cache_capacity);
+    return &s_cache;
+}
+
+CodegenCache::CodegenCache(int capacity) : _cache(new_lru_cache(capacity)) {
+}
+
+CodegenCache::~CodegenCache() {
+}
+
+void CodegenCache::delete_entry(const CacheKey& key, void* value) {
+    delete reinterpret_cast<std::shared_ptr<Entry>*>(value);
+}
+
+std::shared_ptr<CodegenCache::Entry> CodegenCache::lookup(const std::string& key) {
+    Cache::Handle* handle = _cache->lookup(key);
+    if (handle == NULL) {
+        return std::shared_ptr<Entry>();
+    }
+    std::shared_ptr<Entry> entry = *reinterpret_cast<std::shared_ptr<Entry>*>(
+            _cache->value(handle));
+    _cache->release(handle);
+    return entry;
+}
+
+void CodegenCache::insert(const std::string& key, const std::shared_ptr<Entry>& entry) {
+    // every entry is charged 1, the capacity is a number of modules
+    Cache::Handle* handle = _cache->insert(
+            key, new std::shared_ptr<Entry>(entry), 1, delete_entry);
+    _cache->release(handle);
+}
+
+}
@@ -0,0 +1,88 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_CODEGEN_CODEGEN_CACHE_H
+#define DORIS_BE_SRC_CODEGEN_CODEGEN_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/scoped_ptr.hpp>
+
+namespace llvm {
+class ExecutionEngine;
+class LLVMContext;
+}
+
+namespace doris {
+
+class Cache;
+class CacheKey;
+
+// The llvm objects jitted code lives in. Shared by the LlvmCodeGen that created them
+// and the CodegenCache, so the code stays valid as long as any of them uses it.
+struct LlvmCompiledModule {
+    LlvmCompiledModule();
+    ~LlvmCompiledModule();
+
+    // Top level llvm object. Objects from different contexts do not share anything.
+    boost::scoped_ptr<llvm::LLVMContext> context;
+
+    // Execution/Jitting engine, owns the module. Declared after 'context' so that it
+    // is destroyed first.
+    boost::scoped_ptr<llvm::ExecutionEngine> execution_engine;
+};
+
+// BE wide cache of jitted functions, so that fragments which generate the same IR,
+// like the instances of one query or a dashboard query that is run again, skip
+// optimizing and compiling it (see LlvmCodeGen::finalize_module()).
+//
+// The key is the IR text of everything the functions to jit refer to, see
+// LlvmCodeGen::fingerprint(). It includes the tuple offsets, types and pointers
+// baked into the IR, so modules with the same key compute the same thing. Entries
+// are evicted least recently used first; an LlvmCodeGen using an evicted entry keeps
+// its code alive through its reference.
+class CodegenCache {
+public:
+    struct Entry {
+        std::shared_ptr<LlvmCompiledModule> module;
+        // in the order the functions were added with LlvmCodeGen::add_function_to_jit()
+        std::vector<void*> fn_ptrs;
+    };
+
+    // Returns NULL if the cache is disabled by config::codegen_cache_capacity.
+    static CodegenCache* instance();
+
+    ~CodegenCache();
+
+    // Returns an empty pointer if there is no entry for 'key'.
+    std::shared_ptr<Entry> lookup(const std::string& key);
+
+    void insert(const std::string& key, const std::shared_ptr<Entry>& entry);
+
+private:
+    CodegenCache(int capacity);
+
+    static void delete_entry(const CacheKey& key, void* value);
+
+    boost::scoped_ptr<Cache> _cache;
+};
+
+}
+
+#endif
@@ -43,6 +43,7 @@
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "codegen/subexpr_elimination.h"
 #include "codegen/doris_ir_data.h"
@@ -93,9 +94,8 @@ LlvmCodeGen::LlvmCodeGen(ObjectPool* pool, const std::string& name) :
         _optimizations_enabled(false),
         _is_corrupt(false),
         _is_compiled(false),
-        _context(new llvm::LLVMContext()),
+        _compiled_module(new LlvmCompiledModule()),
         _module(NULL),
-        _execution_engine(NULL),
         _scratch_buffer_offset(0),
         _debug_trace_fn(NULL) {
     DCHECK(s_llvm_initialized) << "Must call LlvmCodeGen::initialize_llvm first.";
@@ -106,6 +106,7 @@ LlvmCodeGen::LlvmCodeGen(ObjectPool* pool, const std::string& name) :
     _codegen_timer = ADD_TIMER(&_profile, "CodegenTime");
     _optimization_timer = ADD_TIMER(&_profile, "OptimizationTime");
     _compile_timer = ADD_TIMER(&_profile, "CompileTime");
+    _cache_hits_counter = ADD_COUNTER(&_profile, "CacheHits", TUnit::UNIT);
 
     _loaded_functions.resize(IRFunction::FN_END);
 }
@@ -280,9 +281,9 @@ Status LlvmCodeGen::init() {
     // for some reason SSE4 intrinsics selection will not work.
     // builder.setMCPU(llvm::sys::getHostCPUName());
     builder.setErrorStr(&_error_string);
-    _execution_engine.reset(builder.create());
-    if (_execution_engine == NULL) {
-        // _execution_engine will take ownership of the module if it is created
+    _compiled_module->execution_engine.reset(builder.create());
+    if (execution_engine() == NULL) {
+        // the execution engine will take ownership of the module if it is created
         delete _module;
         std::stringstream ss;
         ss << "Could not create ExecutionEngine: " << _error_string;
@@ -299,8 +300,12 @@ Status LlvmCodeGen::init() {
 }
 
 LlvmCodeGen::~LlvmCodeGen() {
+    // Code of a module in the CodegenCache is freed with its execution engine.
+    if (!_compiled_module.unique()) {
+        return;
+    }
     for (auto& it : _jitted_functions) {
-        _execution_engine->freeMachineCodeForFunction(it.first);
+        execution_engine()->freeMachineCodeForFunction(it.first);
     }
 }
 
@@ -551,7 +556,7 @@ llvm::Function* LlvmCodeGen::replace_call_sites(
         caller = new_caller;
     } else if (_jitted_functions.find(caller) != _jitted_functions.end()) {
         // This function is already dynamically linked, unlink it.
-        _execution_engine->freeMachineCodeForFunction(caller);
+        execution_engine()->freeMachineCodeForFunction(caller);
         _jitted_functions.erase(caller);
     }
 
@@ -685,6 +690,21 @@ Status LlvmCodeGen::finalize_module() {
     }
     SCOPED_TIMER(_profile.total_time_counter());
 
+    CodegenCache* cache = _fns_to_jit_compile.empty() ? NULL : CodegenCache::instance();
+    std::string cache_key;
+    if (cache != NULL) {
+        cache_key = fingerprint();
+        _cache_entry = cache->lookup(cache_key);
+        if (_cache_entry != NULL) {
+            DCHECK_EQ(_cache_entry->fn_ptrs.size(), _fns_to_jit_compile.size());
+            for (int i = 0; i < _fns_to_jit_compile.size(); ++i) {
+                publish_jitted_fn(_fns_to_jit_compile[i].second, _cache_entry->fn_ptrs[i]);
+            }
+            COUNTER_UPDATE(_cache_hits_counter, 1);
+            return Status::OK();
+        }
+    }
+
     // Don't waste time optimizing module if there are no functions to JIT. This can happen
     // if the codegen object is created but no functions are successfully codegen'd.
     if (_optimizations_enabled // TODO(zc): && !FLAGS_disable_optimization_passes 
@@ -694,8 +714,24 @@ Status LlvmCodeGen::finalize_module() {
 
     SCOPED_TIMER(_compile_timer);
     // JIT compile all codegen'd functions
+    std::vector<void*> fn_ptrs;
     for (int i = 0; i < _fns_to_jit_compile.size(); ++i) {
-        *_fns_to_jit_compile[i].second = jit_function(_fns_to_jit_compile[i].first);
+        fn_ptrs.push_back(jit_function(_fns_to_jit_compile[i].first));
+        publish_jitted_fn(_fns_to_jit_compile[i].second, fn_ptrs.back());
+    }
+    if (cache != NULL) {
+        std::shared_ptr<CodegenCache::Entry> entry(new CodegenCache::Entry());
+        entry->module = _compiled_module;
+        entry->fn_ptrs.swap(fn_ptrs);
+        for (int i = 0; i < entry->fn_ptrs.size(); ++i) {
+            if (entry->fn_ptrs[i] == NULL) {
+                entry.reset();
+                break;
+            }
+        }
+        if (entry != NULL) {
+            cache->insert(cache_key, entry);
+        }
     }
 #if 0
     if (FLAGS_opt_module_dir.size() != 0) {
@@ -713,6 +749,55 @@ Status LlvmCodeGen::finalize_module() {
     return Status::OK();
 }
 
+std::string LlvmCodeGen::fingerprint() {
+    std::string key;
+    llvm::raw_string_ostream out(key);
+    out << _optimizations_enabled << "\n";
+
+    // Everything the functions to jit can reach ends up in the jitted code, so print
+    // all of it. Values that are not globals and have no operands, like constant
+    // ints, are already part of the text of their user.
+    std::set<const llvm::Value*> visited;
+    std::vector<const llvm::User*> worklist;
+    auto add_value = [&visited, &worklist](const llvm::Value* value) {
+        const llvm::User* user = llvm::dyn_cast<llvm::User>(value);
+        if (user == NULL || !llvm::isa<llvm::Constant>(user)) {
+            return;
+        }
+        if (!llvm::isa<llvm::GlobalValue>(user) && user->getNumOperands() == 0) {
+            return;
+        }
+        if (visited.insert(user).second) {
+            worklist.push_back(user);
+        }
+    };
+    for (int i = 0; i < _fns_to_jit_compile.size(); ++i) {
+        out << _fns_to_jit_compile[i].first->getName() << "\n";
+        add_value(_fns_to_jit_compile[i].first);
+    }
+    while (!worklist.empty()) {
+        const llvm::User* user = worklist.back();
+        worklist.pop_back();
+        if (llvm::isa<llvm::GlobalValue>(user)) {
+            out << *user << "\n";
+        }
+        const llvm::Function* fn = llvm::dyn_cast<llvm::Function>(user);
+        if (fn == NULL) {
+            for (unsigned i = 0; i < user->getNumOperands(); ++i) {
+                add_value(user->getOperand(i));
+            }
+            continue;
+        }
+        for (llvm::const_inst_iterator it = llvm::inst_begin(fn);
+                it != llvm::inst_end(fn); ++it) {
+            for (unsigned i = 0; i < it->getNumOperands(); ++i) {
+                add_value(it->getOperand(i));
+            }
+        }
+    }
+    return out.str();
+}
+
 void LlvmCodeGen::optimize_module() {
     SCOPED_TIMER(_optimization_timer);
 
@@ -825,7 +910,7 @@ void* LlvmCodeGen::jit_function(llvm::Function* function, int* scratch_size) {
     }
 
     // TODO: log a warning if the jitted function is too big (larger than I cache)
-    void* jitted_function = _execution_engine->getPointerToFunction(function);
+    void* jitted_function = execution_engine()->getPointerToFunction(function);
     boost::lock_guard<boost::mutex> l(_jitted_functions_lock);
 
     if (jitted_function != NULL) {
@@ -868,7 +953,7 @@ void LlvmCodeGen::codegen_debug_trace(LlvmBuilder* builder, const char* str) {
         _debug_trace_fn->setCallingConv(llvm::CallingConv::C);
 
         // Add a mapping to the execution engine so it can link the debug_trace function
-        _execution_engine->addGlobalMapping(_debug_trace_fn,
+        execution_engine()->addGlobalMapping(_debug_trace_fn,
                                             reinterpret_cast<void*>(&debug_trace));
     }
 
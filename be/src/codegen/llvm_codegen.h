@@ -19,6 +19,8 @@
 #define DORIS_BE_SRC_QUERY_CODEGEN_LLVM_CODEGEN_H
 
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <boost/scoped_ptr.hpp>
@@ -33,6 +35,7 @@
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/Support/MemoryBuffer.h>
 
+#include "codegen/codegen_cache.h"
 #include "common/status.h"
 #include "runtime/primitive_type.h"
 #include "exprs/expr.h"
@@ -234,12 +237,12 @@ public:
     // Returns reference to llvm context object.  Each LlvmCodeGen has its own
     // context to allow multiple threads to be calling into llvm at the same time.
     llvm::LLVMContext& context() {
-        return *_context.get();
+        return *_compiled_module->context.get();
     }
 
     // Returns execution engine interface
     llvm::ExecutionEngine* execution_engine() {
-        return _execution_engine.get();
+        return _compiled_module->execution_engine.get();
     }
 
     // Returns the underlying llvm module
@@ -276,6 +279,18 @@ public:
     // functions.
     void optimize_module();
 
+    // Returns the IR of the functions to jit and of every function and global they
+    // refer to. Used as the CodegenCache key, so modules with equal fingerprints
+    // compile to the same code.
+    std::string fingerprint();
+
+    // Stores the jitted 'fn' into 'fn_ptr'. The fragment may already be running when
+    // the module is finalized in the background (see config::enable_async_codegen),
+    // so this pairs with the acquire load in the readers of the function pointers.
+    static void publish_jitted_fn(void** fn_ptr, void* fn) {
+        __atomic_store_n(fn_ptr, fn, __ATOMIC_RELEASE);
+    }
+
     // Replaces all instructions that call 'target_name' with a call instruction
     // to the new_fn.  Returns the modified function.
     // - target_name is the unmangled function name that should be replaced.
@@ -334,6 +349,10 @@ public:
     /// objects. This provides the same behavior as walking each of those objects and calling
     /// JitFunction().
     //
+    /// *fn_ptr may be set while the fragment is already running, so callers must only
+    /// read it with __atomic_load_n(fn_ptr, __ATOMIC_ACQUIRE) and fall back to the
+    /// interpreted path while it is NULL.
+    //
     /// In addition, any functions not registered with AddFunctionToJit() are marked as
     /// internal in FinalizeModule() and may be removed as part of optimization.
     //
@@ -542,6 +561,7 @@ private:
     RuntimeProfile::Counter* _codegen_timer;
     RuntimeProfile::Counter* _optimization_timer;
     RuntimeProfile::Counter* _compile_timer;
+    RuntimeProfile::Counter* _cache_hits_counter;
 
     // whether or not optimizations are enabled
     bool _optimizations_enabled;
@@ -559,16 +579,18 @@ private:
     // Error string that llvm will write to
     std::string _error_string;
 
-    // Top level llvm object.  Objects from different contexts do not share anything.
-    // We can have multiple instances of the LlvmCodeGen object in different threads
-    boost::scoped_ptr<llvm::LLVMContext> _context;
+    // The llvm context and execution engine of this object. We can have multiple
+    // instances of the LlvmCodeGen object in different threads. Shared with the
+    // CodegenCache once the module was compiled and added to it.
+    std::shared_ptr<LlvmCompiledModule> _compiled_module;
 
     // Top level codegen object.  Contains everything to jit one 'unit' of code.
-    // Owned by the _execution_engine.
+    // Owned by the execution engine of _compiled_module.
     llvm::Module* _module;
 
-    // Execution/Jitting engine.
-    boost::scoped_ptr<llvm::ExecutionEngine> _execution_engine;
+    // Set if finalize_module() found the module in the CodegenCache. The jitted
+    // functions live in the compiled module of the entry in that case.
+    std::shared_ptr<CodegenCache::Entry> _cache_entry;
 
     // current offset into scratch buffer
     int _scratch_buffer_offset;
@@ -50,6 +50,11 @@ namespace config {
     // defaults to bytes if no unit is given"
     CONF_String(mem_limit, "80%");
 
+    // consume()/release() deltas smaller than this are buffered per core in each
+    // MemTracker before they are added to its shared consumption counter. The peak
+    // consumption may lag by up to this many bytes per core. 0 disables the buffering.
+    CONF_Int64(mem_tracker_consume_batch_bytes, "65536");
+
     // the port heartbeat service used
     CONF_Int32(heartbeat_service_port, "9050");
     // the count of heart beat service
@@ -64,6 +69,9 @@ namespace config {
     CONF_Int32(push_worker_count_high_priority, "3");
     // the count of thread to publish version
     CONF_Int32(publish_version_worker_count, "2");
+    // the max count of thread to publish version. more threads are spawned
+    // up to this count when publish version tasks are piling up.
+    CONF_Int32(publish_version_max_worker_count, "8");
     // the count of thread to clear alter task
     CONF_Int32(clear_alter_task_worker_count, "1");
     // the count of thread to clear transaction task
@@ -76,6 +84,11 @@ namespace config {
     CONF_Int32(clone_worker_count, "3");
     // the count of thread to clone
     CONF_Int32(storage_medium_migrate_count, "1");
+    // max write rate of storage medium migration on destination data dir,
+    // unit: MB/s. 0 means no limit. It is also lowered to
+    // data_dir_compaction_io_mbytes_per_sec_on_query while queries are
+    // reading the data dir.
+    CONF_Int32(storage_migration_io_mbytes_per_sec, "100");
     // the count of thread to check consistency
     CONF_Int32(check_consistency_worker_count, "1");
     // the count of thread to upload
@@ -92,6 +105,10 @@ namespace config {
     CONF_Int32(report_disk_state_interval_seconds, "60");
     // the interval time(seconds) for agent report olap table to FE
     CONF_Int32(report_tablet_interval_seconds, "60");
+    // the interval time(seconds) for agent report all olap tables to FE. reports between
+    // two full reports only contain tablets changed since last report. if it is not larger
+    // than report_tablet_interval_seconds, every report contains all tablets.
+    CONF_Int32(report_all_tablets_interval_seconds, "1800");
     // the timeout(seconds) for alter table
     CONF_Int32(alter_tablet_timeout_seconds, "86400");
     // the timeout(seconds) for make snapshot
@@ -104,6 +121,12 @@ namespace config {
     CONF_Int32(download_low_speed_limit_kbps, "50");
     // download low speed time(seconds)
     CONF_Int32(download_low_speed_time, "300");
+    // number of files of a tablet downloaded at the same time when clone
+    CONF_Int32(clone_download_file_thread_num, "4");
+    // max total download speed(KB/s) of all clone tasks of a backend, which is
+    // divided among the files being downloaded. 0 means only max_download_speed_kbps
+    // limits the speed of each file.
+    CONF_Int64(clone_max_download_speed_kbps, "0");
     // curl verbose mode
     CONF_Int64(curl_verbose_mode, "1");
     // seconds to sleep for each time check table status
@@ -161,6 +184,15 @@ namespace config {
     CONF_Int32(doris_scanner_thread_pool_thread_num, "48");
     // number of olap scanner thread pool size
     CONF_Int32(doris_scanner_thread_pool_queue_size, "102400");
+    // whether to split the olap scanner threads across NUMA nodes and pin them there.
+    // Scanners are then scheduled on the node of the data dir they read.
+    CONF_Bool(doris_scanner_thread_pool_numa_aware, "false");
+    // number of olap scanner thread pool size for small scans, which only read point key ranges,
+    // so that they are not queued behind big scans. 0 means small scans use the common pool.
+    CONF_Int32(doris_small_scanner_thread_pool_thread_num, "8");
+    // max scheduling rounds of scanners of a small scan in small scanner thread pool,
+    // the scan is moved to the common pool after that
+    CONF_Int32(doris_small_scan_max_rounds, "16");
     // number of etl thread pool size
     CONF_Int32(etl_thread_pool_size, "8");
     // number of etl thread pool size
@@ -171,14 +203,25 @@ namespace config {
     CONF_Int32(thrift_connect_timeout_seconds, "3");
     // max row count number for single scan range
     CONF_Int32(doris_scan_range_row_count, "524288");
+    // min row count number for single scan range. rows of scan range are decided by rows of
+    // all tablets to scan and number of scanner threads, between this and doris_scan_range_row_count
+    CONF_Int32(doris_scan_range_min_row_count, "65536");
     // size of scanner queue between scanner thread and compute thread
     CONF_Int32(doris_scanner_queue_size, "1024");
     // single read execute fragment row size
     CONF_Int32(doris_scanner_row_num, "16384");
+    // max bytes of row batches read by a scanner in one scheduling round
+    CONF_Int64(doris_scanner_max_bytes_per_round, "67108864");
+    // number of sliced scrolls to scan one elasticsearch shard in parallel
+    CONF_Int32(es_scroll_slices_per_shard, "1");
     // number of max scan keys
     CONF_Int32(doris_max_scan_key_num, "1024");
     // return_row / total_row
     CONF_Int32(doris_max_pushdown_conjuncts_return_rate, "90");
+    // if true, concurrent scanners reading the same rows of a tablet share rows read by one reader
+    CONF_Bool(enable_olap_shared_scan, "false");
+    // max chunks of 1024 rows kept by a shared scan for scanners reading behind
+    CONF_Int32(olap_shared_scan_max_chunks, "64");
     // (Advanced) Maximum size of per-query receive-side buffer
     CONF_Int32(exchg_node_buffer_size_bytes, "10485760");
     // insert sort threadhold for sorter
@@ -196,6 +239,9 @@ namespace config {
     CONF_String(module_output, "");
     // memory_limitation_per_thread_for_schema_change unit GB
     CONF_Int32(memory_limitation_per_thread_for_schema_change, "2");
+    // number of threads to convert historical rowsets of a tablet in schema change,
+    // each of which may use memory_limitation_per_thread_for_schema_change when sorting
+    CONF_Int32(schema_change_convert_thread_num, "1");
 
     CONF_Int64(max_unpacked_row_block_size, "104857600");
 
@@ -207,6 +253,8 @@ namespace config {
     CONF_Int32(default_num_rows_per_data_block, "1024");
     CONF_Int32(default_num_rows_per_column_file_block, "1024");
     CONF_Int32(max_tablet_num_per_shard, "1024");
+    // number of threads of each data dir to load tablets from meta when BE starts
+    CONF_Int32(load_tablet_thread_num_per_store, "4");
     // pending data policy
     CONF_Int32(pending_data_expire_time_sec, "1800");
     // inc_rowset expired interval
@@ -227,6 +275,67 @@ namespace config {
 
     // Cache for stoage page size
     CONF_String(storage_page_cache_limit, "20G");
+    // Percentage of storage_page_cache_limit reserved for index pages, such as ordinal
+    // index, zone map and bloom filter pages, so that they are not evicted by data pages.
+    // 0 means index pages and data pages share the whole cache
+    CONF_Int32(index_page_cache_percentage, "10");
+    // Percentage of data page cache kept for pages which are accessed only once. Pages are
+    // inserted into the cold part of the cache and promoted only when accessed again, so that
+    // one-off full scans can't flush hot pages. 0 means no cold part
+    CONF_Int32(storage_page_cache_cold_percentage, "37");
+    // max number of data pages of a column read by one IO when scanning segment_v2.
+    // following pages adjacent in file are read ahead into page cache together
+    // with the page being read. 1 means no read ahead
+    CONF_Int32(segment_page_read_ahead_num, "4");
+    // If true, hot data pages of segment_v2, which are read again from page cache,
+    // are cached in decompressed form to save the cost of decompression. Pages read
+    // only once stay compressed in page cache
+    CONF_Bool(segment_cache_decompressed_page, "true");
+    // Memory limit of the cache of opened segment_v2 segments, which keeps parsed
+    // footers, column readers and short key indexes, so that they are not loaded
+    // again for every query
+    CONF_String(segment_cache_limit, "2G");
+    // Streams of the columns read from an alpha segment which are closer than this
+    // number of bytes in file are merged into one read ahead IO. 0 means no merging
+    CONF_Int64(segment_read_coalesce_gap_bytes, "65536");
+    // If true, delete conditions are compiled into column predicates and rows of
+    // blocks are deleted batch by batch, otherwise row by row
+    CONF_Bool(enable_vectorized_delete_predicates, "true");
+    // If true, UNIQUE_KEYS tablets keep a primary key index in memory, which marks
+    // rows superseded by later loads in delete bitmaps, so that queries read rowsets
+    // without merging them. The index of a tablet is built in background when the
+    // tablet is first queried, queries merge rowsets until it's built
+    CONF_Bool(enable_merge_on_write, "false");
+    // Number of threads building primary key indexes of merge-on-write tablets
+    CONF_Int32(primary_key_index_build_thread_num, "1");
+    // Max number of tablets waiting for their primary key indexes to be built,
+    // queries of more tablets merge rowsets and submit builds again later
+    CONF_Int32(primary_key_index_build_queue_size, "10240");
+
+    // Capacity of the cache for outputs of aggregation fragments over olap tablets,
+    // used by queries with session variable enable_fragment_result_cache. 0 disables it
+    CONF_String(fragment_result_cache_limit, "1G");
+    // Outputs of fragment instances larger than this are not cached
+    CONF_Int64(fragment_result_cache_max_entry_bytes, "16777216");
+    // max number of bytes of one merged read ahead IO of alpha segment streams.
+    // 0 means not to read ahead streams
+    CONF_Int64(segment_read_coalesce_max_bytes, "8388608");
+    // segment_v2 files being written are flushed to disk and dropped from page
+    // cache every time this number of bytes are written. 0 means never
+    CONF_Int64(segment_write_drop_cache_bytes, "1048576");
+    // compression of pages of segment_v2 files, one of NO_COMPRESSION, SNAPPY,
+    // LZ4, LZ4F, ZLIB and ZSTD. Compressed pages can not be read by older BEs,
+    // so only set this after all BEs in the cluster are upgraded
+    CONF_String(segment_v2_compression_type, "NO_COMPRESSION");
+    // compression of pages of segment_v2 files written to HDD data dirs, which
+    // hold cold data when there are SSD data dirs too, for example ZSTD.
+    // segment_v2_compression_type is used if empty. Like it, only set this after
+    // all BEs are upgraded
+    CONF_String(segment_v2_hdd_compression_type, "");
+    // a page of segment_v2 is stored uncompressed if compression saves less
+    // than this percent of its size, and the following pages of the column are
+    // stored uncompressed without trying for a while
+    CONF_Int32(segment_v2_compression_min_saving_percent, "10");
 
     // be policy
     CONF_Int64(base_compaction_start_hour, "20");
@@ -251,10 +360,50 @@ namespace config {
     // compaction until this interval passes.
     CONF_Int64(min_compaction_failure_interval_sec, "600") // 10 min
 
+    // whether to schedule compaction of all tablets by a global scheduler,
+    // which picks tablets by score and runs them in a shared thread pool,
+    // instead of fixed base/cumulative compaction threads of every disk.
+    CONF_Bool(enable_compaction_scheduler, "true");
+    // number of threads to run compaction tasks handed out by the scheduler,
+    // 0 means the same number as fixed threads, which is
+    // (base_compaction_num_threads_per_disk + cumulative_compaction_num_threads_per_disk) * num of disks
+    CONF_Int32(compaction_task_num_threads, "0");
+    // max number of compaction tasks running on one disk at the same time
+    CONF_Int32(compaction_task_num_per_disk, "2");
+    // interval of the scheduler to rescore tablets when no task finishes
+    CONF_Int32(compaction_schedule_interval_ms, "5000");
+    // max total write rate of compaction and schema change on one data dir,
+    // shared by all tasks running on it, unit: MB/s. 0 means no limit.
+    CONF_Int32(data_dir_compaction_io_mbytes_per_sec, "0");
+    // max total write rate of compaction on one data dir while queries are
+    // reading it, so that background IO yields the disk to queries, unit: MB/s.
+    // 0 means no limit.
+    CONF_Int32(data_dir_compaction_io_mbytes_per_sec_on_query, "0");
+    // max total write rate of loads on one data dir, unit: MB/s. 0 means no limit.
+    CONF_Int32(data_dir_load_io_mbytes_per_sec, "0");
+    // a data dir is regarded as busy with queries within this interval after
+    // the last bytes read by queries
+    CONF_Int32(data_dir_query_io_active_ms, "1000");
+
+    // whether to do compaction by hard linking segment files of input rowsets
+    // when their key ranges don't overlap with each other, for example data
+    // loaded in time order, instead of merging and rewriting all rows.
+    CONF_Bool(enable_ordered_data_compaction, "false");
+
+    // whether to merge rows of compaction by column groups when the output
+    // rowset is written by BetaRowsetWriter. Key columns are merged and written
+    // first, then each group of value columns is merged with the key columns.
+    CONF_Bool(enable_vertical_compaction, "false");
+    // max number of value columns merged together in vertical compaction
+    CONF_Int32(vertical_compaction_num_columns_per_group, "5");
+
     // Port to start debug webserver on
     CONF_Int32(webserver_port, "8040");
     // Number of webserver workers
     CONF_Int32(webserver_num_workers, "5");
+    // Number of threads to handle load and download requests of webserver,
+    // 0 means handling them in webserver workers
+    CONF_Int32(webserver_num_data_plane_workers, "32");
     // Period to update rate counters and sampling counters in ms.
     CONF_Int32(periodic_counter_update_period_ms, "500");
 
@@ -264,9 +413,27 @@ namespace config {
     CONF_Int64(load_error_log_reserve_hours, "48");
     // Deprecated, use streaming_load_max_mb instead
     CONF_Int64(mini_load_max_mb, "2048");
+    // max number of scanner threads of one broker scan node
+    CONF_Int32(broker_scan_node_max_scanner_threads, "4");
+    // splittable plain text ranges of broker load larger than this are scanned in
+    // pieces of this size by several scanner threads. 0 means not to split
+    CONF_Int64(broker_scanner_split_bytes, "268435456");
+    // max number of 4MB chunks a compressed broker load file is decompressed ahead
+    // of parsing in a background thread. 0 means to decompress in the scanner thread
+    CONF_Int32(broker_scanner_decompress_chunks, "2");
+    // kafka msgs are copied into batches of this size by routine load consumers,
+    // then every batch is appended to the pipe as one chunk
+    CONF_Int64(routine_load_consumer_batch_bytes, "262144");
     CONF_Int32(number_tablet_writer_threads, "16");
 
     CONF_Int64(streaming_load_max_mb, "10240");
+    // Stream loads with header "group_commit: true" and a body not larger than this
+    // are appended into a load shared by small loads of the same table, which is
+    // committed every group_commit_interval_ms or when it has received
+    // group_commit_data_bytes. Larger ones are loaded in their own transactions
+    CONF_Int64(group_commit_max_body_bytes, "4194304");
+    CONF_Int32(group_commit_interval_ms, "1000");
+    CONF_Int64(group_commit_data_bytes, "67108864");
     // the alive time of a TabletsChannel.
     // If the channel does not receive any data till this time,
     // the channel will be removed.
@@ -275,10 +442,44 @@ namespace config {
     // you may need to increase this timeout if using larger 'streaming_load_max_mb',
     // or encounter 'tablet writer write failed' error when loading.
     CONF_Int32(tablet_writer_rpc_timeout_sec, "600");
+    // max number of add batch packets in flight of one tablet writer channel,
+    // sender waits for the oldest one when it is reached. Backends before
+    // supporting out of order packets only accept 1.
+    CONF_Int32(tablet_writer_max_in_flight_packets, "1");
+    // number of threads of an olap table sink to send batches to tablet writers,
+    // so that rows are routed while batches are sent. 0 means batches are sent
+    // in the thread executing the sink.
+    CONF_Int32(olap_table_sink_send_thread_num, "0");
+    // max number of batches of one node channel waiting to be sent, the sink
+    // blocks when it is reached.
+    CONF_Int32(olap_table_sink_max_pending_batches, "4");
+    // if positive, rows of aggregate and unique key tables are buffered by each node
+    // channel of olap table sink in batches of this many rows, which are sorted by
+    // tablet and keys, and rows of the same keys are aggregated before they are sent.
+    // 0 means rows are sent in the order they come.
+    CONF_Int32(olap_table_sink_pre_aggregate_rows, "0");
+    // if true, olap table sink only sends rows of a tablet to one replica, which
+    // builds the rowset and sends it to other replicas before commit, so that
+    // rows are not sorted and encoded in every replica.
+    CONF_Bool(enable_single_replica_load, "false");
+    // number of threads to download rowsets from other replicas in single replica load
+    CONF_Int32(tablet_writer_pull_rowset_thread_num, "8");
+
+    // export sink writes to file writer once this many bytes are buffered
+    CONF_Int64(export_sink_write_buffer_bytes, "1048576");
+    // export sink begins a new file when this many bytes are written to the
+    // current one. 0 means one file per fragment instance.
+    CONF_Int64(export_max_file_size_bytes, "1073741824");
 
     // Fragment thread pool
     CONF_Int32(fragment_pool_thread_num, "64");
     CONF_Int32(fragment_pool_queue_size, "1024");
+    // max number of fragment instances of one resource user running at the same time,
+    // the others wait in a FIFO queue of that user. 0 means no limit.
+    CONF_Int32(max_running_fragments_per_user, "0");
+    // max number of fragment instances of one resource user waiting for admission,
+    // more are rejected
+    CONF_Int32(max_queued_fragments_per_user, "1024");
 
     //for cast
     CONF_Bool(cast, "true");
@@ -310,10 +511,48 @@ namespace config {
 
     // for pprof
     CONF_String(pprof_profile_dir, "${DORIS_HOME}/log")
+    // Samples per second of cpu time taken by the always-on cpu profiler,
+    // which are served by /pprof/query_profile. 0 to disable it.
+    CONF_Int32(cpu_profile_sample_hz, "10")
+    // Number of the latest samples kept by the cpu profiler, each takes about 300 bytes
+    CONF_Int64(cpu_profile_buffer_samples, "32768")
+
+    // Number of the latest queries whose traces are kept, which are recorded
+    // when query option enable_query_trace is set, and served by /api/query_trace
+    CONF_Int32(query_trace_max_queries, "20")
+    // Spans of a query after this number are dropped, each takes about 64 bytes
+    CONF_Int64(query_trace_max_spans_per_query, "1000000")
+
+    // Number of distinct keys after which the hash table of AggregationNode and
+    // HashJoinNode is split into 256 sub tables that grow independently.
+    // 0 or less means never.
+    CONF_Int64(hash_table_two_level_threshold, "100000");
+
+    // Max number of threads HashJoinNode uses to put its build rows into the hash
+    // table once all of them are read. Threads beyond the first are only used if the
+    // query's resource pool has thread tokens to spare. 1 or less disables it.
+    CONF_Int32(hash_join_build_thread_num, "4");
+
+    // Max number of threads SpillSorter uses to sort a run in memory. Threads beyond the
+    // first are only used for runs of at least sort_parallel_min_tuples tuples and if
+    // the query's resource pool has thread tokens to spare. 1 or less disables it.
+    CONF_Int32(sort_thread_num, "4");
+    CONF_Int64(sort_parallel_min_tuples, "262144");
+
+    // if true, the fragment instances of a query on this backend build the hash table
+    // of a broadcast join once and share it instead of building one each
+    CONF_Bool(enable_shared_broadcast_hash_table, "true");
+
+    // max number of compiled codegen modules kept for fragments which generate the
+    // same IR, so they skip optimizing and compiling it. 0 disables the cache.
+    CONF_Int32(codegen_cache_capacity, "256");
+
+    // if true, fragments compile the codegened functions in a background thread and
+    // run interpreted until the jitted functions are ready
+    CONF_Bool(enable_async_codegen, "true");
 
     // for partition
     CONF_Bool(enable_partitioned_hash_join, "false")
-    CONF_Bool(enable_partitioned_aggregation, "false")
     CONF_Bool(enable_new_partitioned_aggregation, "true")
     
     // for kudu
@@ -361,12 +600,22 @@ namespace config {
     // then only the first writable directory is used
     CONF_Bool(allow_multiple_scratch_dirs_per_device, "false");
 
+    // if true, blocks spilled by BufferedBlockMgr2 are compressed by LZ4 before they
+    // are written to the scratch directories, blocks that do not shrink are written raw
+    CONF_Bool(spill_compression, "false");
+    // max number of spilled block writes in flight per scratch directory
+    CONF_Int32(spill_writes_per_scratch_dir, "2");
+
     // linux transparent huge page
     CONF_Bool(madvise_huge_pages, "false");
 
     // whether use mmap to allocate memory
     CONF_Bool(mmap_buffers, "false");
 
+    // Bytes of the free chunks the chunk allocator of MemPool and Arena keeps for
+    // reuse, chunks freed past this are returned to the system.
+    CONF_Int64(chunk_reserved_bytes_limit, "2147483648");
+
     // max memory can be allocated by buffer pool
     CONF_String(buffer_pool_limit, "80G");
 
@@ -381,10 +630,46 @@ namespace config {
 
     // write buffer size before flush
     CONF_Int32(write_buffer_size, "104857600");
+    // number of threads of each store to flush memtables in background
+    CONF_Int32(flush_thread_num_per_store, "2");
+    // max number of memtables waiting to be flushed in each store, loads are
+    // blocked when the queue is full
+    CONF_Int32(flush_queue_size_per_store, "10");
+    // max memory of all memtables of loads in this backend, when it is exceeded,
+    // the largest memtables are flushed first
+    CONF_Int64(load_process_max_memory_limit_bytes, "107374182400");
+    // if true, memtable appends rows to a vector and sorts them when flushing,
+    // instead of inserting every row into a skiplist. AGG_KEYS tables always use skiplist
+    CONF_Bool(memtable_use_sorted_vector, "false");
+    // for memtable using sorted vector, unsorted rows are sorted and aggregated
+    // into sorted rows when there are at least this many unsorted rows and no
+    // less than sorted rows, only for AGG_KEYS and UNIQUE_KEYS tables
+    CONF_Int32(memtable_pre_aggregate_rows, "65536");
+    // number of threads to write rows of one add batch request to different
+    // tablets in parallel, 0 means writing in the rpc thread
+    CONF_Int32(tablet_writer_add_batch_thread_num, "8");
+    // if true, tuple data of tablet writer add batch rpc is compressed by LZ4 and
+    // sent in rpc attachment instead of protobuf message, only enable it after
+    // all backends are upgraded to support it
+    CONF_Bool(tablet_writer_add_batch_use_attachment, "false");
+    // if true, tuple data of exchange row batches is compressed by LZ4 and sent in
+    // rpc attachment instead of protobuf message, compress_rowbatches is ignored then.
+    // only enable it after all backends are upgraded to support it
+    CONF_Bool(data_stream_sender_use_attachment, "false");
+    // if true, row batches sent to an exchange node of a fragment instance running on
+    // this backend are handed to its receiver directly instead of via a brpc loopback
+    CONF_Bool(enable_local_exchange, "true");
+    // if true, intermediates of ndv, hll_union_agg and hll_raw_agg start as sparse
+    // hll sets instead of full 16KB register arrays. Backends accept both formats,
+    // only enable it after all backends are upgraded to accept sparse ones
+    CONF_Bool(enable_sparse_hll_intermediate, "false");
 
     // update interval of tablet stat cache
     CONF_Int32(tablet_stat_cache_update_interval_second, "300");
 
+    // number of shards of tablet map in tablet manager, should be power of 2
+    CONF_Int32(tablet_map_shard_size, "64");
+
     // result buffer cancelled time (unit: second)
     CONF_Int32(result_buffer_cancelled_interval_time, "300");
 
@@ -392,6 +677,7 @@ namespace config {
     CONF_Bool(force_recovery, "false");
 
     // the increased frequency of priority for remaining tasks in BlockingPriorityQueue
+    // and PriorityThreadPool
     CONF_Int32(priority_queue_remaining_tasks_increased_frequency, "512");
 
     // sync tablet_meta when modifing meta
@@ -403,6 +689,9 @@ namespace config {
     // txn commit rpc timeout
     CONF_Int32(txn_commit_rpc_timeout_ms, "10000");
 
+    // number of shards of txn map in txn manager, should be power of 2
+    CONF_Int32(txn_map_shard_size, "128");
+
     // If set to true, metric calculator will run
     CONF_Bool(enable_metric_calculator, "true");
 
@@ -435,10 +724,19 @@ namespace config {
     CONF_String(small_file_dir, "${DORIS_HOME}/lib/small_file/");
     // path gc
     CONF_Bool(path_gc_check, "true");
-    CONF_Int32(path_gc_check_interval_second, "86400");
+    // interval to gc files of rowsets recorded as gc candidates when they
+    // become unused. All files of a data dir are only checked after a full
+    // path scan, which runs every path_scan_interval_second.
+    CONF_Int32(path_gc_check_interval_second, "600");
     CONF_Int32(path_gc_check_step, "1000");
     CONF_Int32(path_gc_check_step_interval_ms, "10");
-    CONF_Int32(path_scan_interval_second, "86400");
+    CONF_Int32(path_scan_interval_second, "604800");
+    // max number of files checked or removed per second by path gc and trash
+    // sweep on one data dir. 0 means no limit.
+    CONF_Int32(path_gc_files_per_sec, "1000");
+    // max number of files checked or removed per second by path gc and trash
+    // sweep on one data dir while queries are reading it. 0 means no limit.
+    CONF_Int32(path_gc_files_per_sec_on_query, "100");
 } // namespace config
 
 } // namespace doris
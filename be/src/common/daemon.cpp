@@ -50,6 +50,7 @@
 #include "exprs/utility_functions.h"
 #include "exprs/json_functions.h"
 #include "exprs/hll_hash_function.h"
+#include "exprs/bitmap_function.h"
 #include "exprs/timezone_db.h"
 #include "geo/geo_functions.h"
 #include "olap/options.h"
@@ -267,6 +268,7 @@ void init_daemon(int argc, char** argv, const std::vector<StorePath>& paths) {
     CompoundPredicate::init();
     JsonFunctions::init();
     HllHashFunctions::init();
+    BitmapFunctions::init();
     ESFunctions::init();
     GeoFunctions::init();
     TimezoneDatabase::init();
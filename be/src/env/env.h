@@ -155,6 +155,11 @@ struct RandomAccessFileOptions {
 struct WritableFileOptions {
     // Call Sync() during Close().
     bool sync_on_close = false;
+    // If not 0, written data are flushed to disk every time this number of
+    // bytes are appended, and then dropped from OS page cache, so that large
+    // background writes neither evict pages of hot data nor pile up dirty
+    // pages to be flushed by a long fsync.
+    uint64_t drop_cache_bytes = 0;
     // See CreateMode for details.
     Env::CreateMode mode = Env::CREATE_IF_NON_EXISTING_TRUNCATE;
 };
@@ -225,6 +230,14 @@ public:
     // Safe for concurrent use by multiple threads.
     virtual Status readv_at(uint64_t offset, const Slice* res, size_t res_cnt) const = 0;
 
+    // Hint that "size" bytes from "offset" are going to be read soon. The read
+    // may be submitted without waiting for it, so one thread can have several
+    // reads in flight by prefetching all of them before reading them one by one.
+    // Default implementation does nothing.
+    //
+    // Safe for concurrent use by multiple threads.
+    virtual Status prefetch(uint64_t offset, size_t size) const { return Status::OK(); }
+
     // Return the size of this file
     virtual Status size(uint64_t* size) const = 0;
 
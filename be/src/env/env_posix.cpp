@@ -252,6 +252,15 @@ public:
     Status readv_at(uint64_t offset, const Slice* res, size_t res_cnt) const override {
         return do_readv_at(_fd, _filename, offset, res, res_cnt);
     }
+
+    Status prefetch(uint64_t offset, size_t size) const override {
+        int res = posix_fadvise(_fd, offset, size, POSIX_FADV_WILLNEED);
+        if (res != 0) {
+            return io_error(_filename, res);
+        }
+        return Status::OK();
+    }
+
     Status size(uint64_t* size) const override {
         struct stat st;
         auto res = fstat(_fd, &st);
@@ -270,8 +279,10 @@ private:
 
 class PosixWritableFile : public WritableFile {
 public:
-    PosixWritableFile(std::string filename, int fd, uint64_t filesize, bool sync_on_close)
-        : _filename(std::move(filename)), _fd(fd), _sync_on_close(sync_on_close), _filesize(filesize) { }
+    PosixWritableFile(std::string filename, int fd, uint64_t filesize, bool sync_on_close,
+                      uint64_t drop_cache_bytes)
+        : _filename(std::move(filename)), _fd(fd), _sync_on_close(sync_on_close),
+        _drop_cache_bytes(drop_cache_bytes), _filesize(filesize), _dropped_size(filesize) { }
 
     ~PosixWritableFile() override {
         WARN_IF_ERROR(close(), "Failed to close file, file=" + _filename);
@@ -285,6 +296,9 @@ public:
         size_t bytes_written = 0;
         RETURN_IF_ERROR(do_writev_at(_fd, _filename, _filesize, data, cnt, &bytes_written));
         _filesize += bytes_written;
+        if (_drop_cache_bytes > 0 && _filesize - _dropped_size >= _drop_cache_bytes) {
+            RETURN_IF_ERROR(_drop_cache());
+        }
         return Status::OK();
     }
 
@@ -322,6 +336,10 @@ public:
             }
         }
 
+        if (_drop_cache_bytes > 0 && _filesize > _dropped_size) {
+            WARN_IF_ERROR(_drop_cache(), "Failed to drop cache of file, file=" + _filename);
+        }
+
         if (_sync_on_close) {
             Status sync_status = sync();
             if (!sync_status.ok()) {
@@ -373,12 +391,30 @@ public:
     uint64_t size() const override { return _filesize; }
     const string& filename() const override { return _filename; }
 private:
+    // Write back data appended since last call and wait for it, then drop
+    // them from page cache. Dirty pages can't be dropped, so they must be
+    // written back first.
+    Status _drop_cache() {
+#if defined(__linux__)
+        int flags = SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER;
+        if (sync_file_range(_fd, _dropped_size, _filesize - _dropped_size, flags) < 0) {
+            return io_error(_filename, errno);
+        }
+        posix_fadvise(_fd, _dropped_size, _filesize - _dropped_size, POSIX_FADV_DONTNEED);
+#endif
+        _dropped_size = _filesize;
+        return Status::OK();
+    }
+
     std::string _filename;
     int _fd;
     const bool _sync_on_close = false;
+    const uint64_t _drop_cache_bytes = 0;
     bool _pending_sync = false;
     bool _closed = false;
     uint64_t _filesize = 0;
+    // data before this offset have been dropped from page cache
+    uint64_t _dropped_size = 0;
     uint64_t _pre_allocated_size = 0;
 };
 
@@ -524,7 +560,8 @@ public:
         if (opts.mode == OPEN_EXISTING) {
             RETURN_IF_ERROR(get_file_size(fname, &file_size));
         }
-        result->reset(new PosixWritableFile(fname, fd, file_size, opts.sync_on_close));
+        result->reset(new PosixWritableFile(fname, fd, file_size, opts.sync_on_close,
+                                            opts.drop_cache_bytes));
         return Status::OK();
     }
 
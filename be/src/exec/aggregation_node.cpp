@@ -18,6 +18,7 @@
 #include "exec/aggregation_node.h"
 
 #include <math.h>
+#include <limits>
 #include <sstream>
 #include <boost/functional/hash.hpp>
 #include <thrift/protocol/TDebugProtocol.h>
@@ -53,6 +54,24 @@ namespace doris {
 
 const char* AggregationNode::_s_llvm_class_name = "class.doris::AggregationNode";
 
+// Minimum reduction factor (input rows / groups) a streaming pre-aggregation needs to
+// keep growing its hash table once the table is larger than 'min_ht_mem' bytes. The
+// table is allowed to grow freely while it fits in L2, needs some reduction to grow
+// into L3 and significant reduction to grow beyond it.
+struct StreamingHtMinReduction {
+    int64_t min_ht_mem;
+    double min_reduction;
+};
+
+static const StreamingHtMinReduction STREAMING_HT_MIN_REDUCTION[] = {
+    {0, 0.0},
+    {256 * 1024, 1.1},
+    {2 * 1024 * 1024, 2.0},
+};
+
+static const int STREAMING_HT_MIN_REDUCTION_SIZE =
+    sizeof(STREAMING_HT_MIN_REDUCTION) / sizeof(STREAMING_HT_MIN_REDUCTION[0]);
+
 // TODO: pass in maximum size; enforce by setting limit in mempool
 // TODO: have a Status ExecNode::init(const TPlanNode&) member function
 // that does initialization outside of c'tor, so we can indicate errors
@@ -63,6 +82,9 @@ AggregationNode::AggregationNode(
             _intermediate_tuple_desc(NULL),
             _output_tuple_id(tnode.agg_node.output_tuple_id),
             _output_tuple_desc(NULL),
+            _is_streaming_preagg(false),
+            _child_eos(false),
+            _num_passthrough_rows(0),
             _singleton_output_tuple(NULL),
             //_tuple_pool(new MemPool()),
             //
@@ -71,7 +93,18 @@ AggregationNode::AggregationNode(
             _needs_finalize(tnode.agg_node.need_finalize),
             _build_timer(NULL),
             _get_results_timer(NULL),
-            _hash_table_buckets_counter(NULL) {
+            _hash_table_buckets_counter(NULL),
+            _streaming_timer(NULL),
+            _num_passthrough_rows_counter(NULL),
+            _preagg_streaming_ht_min_reduction(NULL) {
+    if (tnode.agg_node.__isset.use_streaming_preaggregation) {
+        _is_streaming_preagg = tnode.agg_node.use_streaming_preaggregation;
+        if (_is_streaming_preagg) {
+            DCHECK(!_needs_finalize) << "Preaggs are not finalized";
+            DCHECK(!tnode.agg_node.grouping_exprs.empty()) << "Streaming preaggs do grouping";
+            DCHECK(_limit == -1) << "Preaggs have no limits";
+        }
+    }
 }
 
 AggregationNode::~AggregationNode() {
@@ -100,6 +133,14 @@ Status AggregationNode::prepare(RuntimeState* state) {
         ADD_COUNTER(runtime_profile(), "BuildBuckets", TUnit::UNIT);
     _hash_table_load_factor_counter =
         ADD_COUNTER(runtime_profile(), "LoadFactor", TUnit::DOUBLE_VALUE);
+    if (_is_streaming_preagg) {
+        add_runtime_exec_option("Streaming Preaggregation");
+        _streaming_timer = ADD_TIMER(runtime_profile(), "StreamingTime");
+        _num_passthrough_rows_counter =
+            ADD_COUNTER(runtime_profile(), "RowsPassedThrough", TUnit::UNIT);
+        _preagg_streaming_ht_min_reduction = ADD_COUNTER(
+            runtime_profile(), "ReductionFactorThresholdToExpand", TUnit::DOUBLE_VALUE);
+    }
 
     SCOPED_TIMER(_runtime_profile->total_time_counter());
 
@@ -153,7 +194,7 @@ Status AggregationNode::prepare(RuntimeState* state) {
     if (_probe_expr_ctxs.empty()) {
         // create single output tuple now; we need to output something
         // even if our input is empty
-        _singleton_output_tuple = construct_intermediate_tuple();
+        _singleton_output_tuple = construct_intermediate_tuple(_tuple_pool.get());
     }
 
     if (state->codegen_level() > 0) {
@@ -188,6 +229,11 @@ Status AggregationNode::open(RuntimeState* state) {
 
     RETURN_IF_ERROR(_children[0]->open(state));
 
+    if (_is_streaming_preagg) {
+        // Input rows are aggregated as they are read in get_next().
+        return Status::OK();
+    }
+
     RowBatch batch(_children[0]->row_desc(), state->batch_size(), mem_tracker());
     int64_t num_input_rows = 0;
     int64_t num_agg_rows = 0;
@@ -212,11 +258,17 @@ Status AggregationNode::open(RuntimeState* state) {
 
         int64_t agg_rows_before = _hash_tbl->size();
 
-        if (_process_row_batch_fn != NULL) {
-            _process_row_batch_fn(this, &batch);
+        // set by the codegen thread once the module is compiled
+        ProcessRowBatchFn process_row_batch_fn =
+            __atomic_load_n(&_process_row_batch_fn, __ATOMIC_ACQUIRE);
+        if (process_row_batch_fn != NULL) {
+            process_row_batch_fn(this, &batch);
         } else if (_singleton_output_tuple != NULL) {
             SCOPED_TIMER(_build_timer);
-            process_row_batch_no_grouping(&batch, _tuple_pool.get());
+            // every row goes to the singleton tuple, so UDAs with a batch
+            // update/merge symbol can consume the whole batch at once
+            AggFnEvaluator::add_batch(_aggregate_evaluators, _agg_fn_ctxs,
+                                      &batch, _singleton_output_tuple);
         } else {
             process_row_batch_with_grouping(&batch, _tuple_pool.get());
             if (limit_with_no_agg) {
@@ -260,6 +312,7 @@ Status AggregationNode::open(RuntimeState* state) {
 
 Status AggregationNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(state->check_query_state());
@@ -270,6 +323,15 @@ Status AggregationNode::get_next(RuntimeState* state, RowBatch* row_batch, bool*
         return Status::OK();
     }
 
+    if (_is_streaming_preagg && !_child_eos) {
+        RETURN_IF_ERROR(get_rows_streaming(state, row_batch));
+        if (row_batch->num_rows() > 0) {
+            *eos = false;
+            return Status::OK();
+        }
+        DCHECK(_child_eos);
+    }
+
     ExprContext** ctxs = &_conjunct_ctxs[0];
     int num_ctxs = _conjunct_ctxs.size();
 
@@ -328,6 +390,11 @@ Status AggregationNode::close(RuntimeState* state) {
     if (_needs_finalize && _output_tuple_desc != NULL) {
         dummy_dst = Tuple::create(_output_tuple_desc->byte_size(), _tuple_pool.get());
     }
+    if (_is_streaming_preagg && !_child_eos && _hash_tbl.get() != NULL) {
+        // Closed before the hash table was returned.
+        _output_iterator = _hash_tbl->begin();
+    }
+    _child_batch.reset();
     while (!_output_iterator.at_end()) {
         Tuple* tuple = _output_iterator.get_row()->get_tuple(0);
         if (_needs_finalize) {
@@ -358,8 +425,8 @@ Status AggregationNode::close(RuntimeState* state) {
     return ExecNode::close(state);
 }
 
-Tuple* AggregationNode::construct_intermediate_tuple() {
-    Tuple* agg_tuple = Tuple::create(_intermediate_tuple_desc->byte_size(), _tuple_pool.get());
+Tuple* AggregationNode::construct_intermediate_tuple(MemPool* pool) {
+    Tuple* agg_tuple = Tuple::create(_intermediate_tuple_desc->byte_size(), pool);
     vector<SlotDescriptor*>::const_iterator slot_desc = _intermediate_tuple_desc->slots().begin();
 
     // copy grouping values
@@ -369,7 +436,7 @@ Tuple* AggregationNode::construct_intermediate_tuple() {
         } else {
             void* src = _hash_tbl->last_expr_value(i);
             void* dst = agg_tuple->get_slot((*slot_desc)->tuple_offset());
-            RawValue::write(src, dst, (*slot_desc)->type(), _tuple_pool.get());
+            RawValue::write(src, dst, (*slot_desc)->type(), pool);
         }
     }
 
@@ -435,6 +502,79 @@ void AggregationNode::update_tuple(Tuple* tuple, TupleRow* row) {
 #endif
 }
 
+Status AggregationNode::get_rows_streaming(RuntimeState* state, RowBatch* row_batch) {
+    DCHECK(!_child_eos);
+    DCHECK_EQ(row_batch->num_rows(), 0);
+
+    if (_child_batch.get() == NULL) {
+        _child_batch.reset(
+            new RowBatch(child(0)->row_desc(), state->batch_size(), mem_tracker()));
+    }
+
+    do {
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(state->check_query_state());
+        RETURN_IF_ERROR(child(0)->get_next(state, _child_batch.get(), &_child_eos));
+        SCOPED_TIMER(_streaming_timer);
+
+        // Only check the reduction when the batch could make the hash table grow; the
+        // space left in the table is always used.
+        int64_t remaining_capacity = _hash_tbl->num_inserts_before_resize();
+        if (remaining_capacity < _child_batch->num_rows()
+                && should_expand_preagg_hash_table()) {
+            remaining_capacity = std::numeric_limits<int64_t>::max();
+        }
+
+        int num_passthrough_rows = row_batch->num_rows();
+        process_row_batch_streaming(_child_batch.get(), row_batch, remaining_capacity);
+        num_passthrough_rows = row_batch->num_rows() - num_passthrough_rows;
+        _num_passthrough_rows += num_passthrough_rows;
+
+        _child_batch->transfer_resource_ownership(row_batch);
+        RETURN_IF_ERROR(state->check_query_state());
+    } while (row_batch->num_rows() == 0 && !_child_eos);
+
+    COUNTER_SET(_hash_table_buckets_counter, _hash_tbl->num_buckets());
+    COUNTER_SET(_hash_table_load_factor_counter, _hash_tbl->load_factor());
+    COUNTER_SET(memory_used_counter(),
+                _tuple_pool->peak_allocated_bytes() + _hash_tbl->byte_size());
+    COUNTER_SET(_num_passthrough_rows_counter, _num_passthrough_rows);
+
+    if (_child_eos) {
+        _child_batch.reset();
+        _output_iterator = _hash_tbl->begin();
+    }
+
+    _num_rows_returned += row_batch->num_rows();
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    return Status::OK();
+}
+
+bool AggregationNode::should_expand_preagg_hash_table() const {
+    int64_t ht_rows = _hash_tbl->size();
+    // Need some rows in the table to have valid statistics.
+    if (ht_rows == 0) {
+        return true;
+    }
+
+    int64_t ht_mem = _hash_tbl->byte_size();
+    int cache_level = 0;
+    while (cache_level + 1 < STREAMING_HT_MIN_REDUCTION_SIZE
+            && ht_mem >= STREAMING_HT_MIN_REDUCTION[cache_level + 1].min_ht_mem) {
+        ++cache_level;
+    }
+
+    // Passed through rows were not aggregated into the table.
+    int64_t aggregated_input_rows = _children[0]->rows_returned() - _num_passthrough_rows;
+    if (aggregated_input_rows <= 0) {
+        return true;
+    }
+    double current_reduction = static_cast<double>(aggregated_input_rows) / ht_rows;
+    double min_reduction = STREAMING_HT_MIN_REDUCTION[cache_level].min_reduction;
+    COUNTER_SET(_preagg_streaming_ht_min_reduction, min_reduction);
+    return current_reduction > min_reduction;
+}
+
 Tuple* AggregationNode::finalize_tuple(Tuple* tuple, MemPool* pool) {
     DCHECK(tuple != NULL);
 
@@ -1004,9 +1144,10 @@ Function* AggregationNode::codegen_process_row_batch(
             process_batch_fn, false, hash_fn, "hash_current_row", &replaced);
         DCHECK_EQ(replaced, 2);
 
+        // Called by find() and by insert() to check for an existing key.
         process_batch_fn = codegen->replace_call_sites(
             process_batch_fn, false, equals_fn, "equals", &replaced);
-        DCHECK_EQ(replaced, 1);
+        DCHECK_EQ(replaced, 2);
     }
 
     process_batch_fn = codegen->replace_call_sites(
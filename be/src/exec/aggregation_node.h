@@ -54,6 +54,13 @@ class SlotDescriptor;
 // will be appended to the end of the normal tuple data that stores the size of buffer
 // for that string slot.  This also results in the correct alignment because StringValue
 // slots are 8-byte aligned and form the tail end of the tuple.
+//
+// If the plan enables streaming pre-aggregation (first phase of a distributed
+// aggregation), input rows are aggregated while they are read in get_next(). Each time
+// the hash table would have to grow, the reduction achieved so far is compared with a
+// threshold that depends on how large the hash table already is. If the table is not
+// worth growing, rows whose group is not in the table are passed through to the parent
+// as single row groups instead. The hash table is returned once the input is exhausted.
 class AggregationNode : public ExecNode {
 public:
     AggregationNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -94,6 +101,17 @@ private:
     /// the intermediate tuple.
     TupleId _output_tuple_id;
     TupleDescriptor* _output_tuple_desc;
+
+    // True if this is a streaming pre-aggregation, see the class comment.
+    bool _is_streaming_preagg;
+
+    // Streaming pre-aggregation only: the batch read from the child and if the child
+    // has returned all rows.
+    boost::scoped_ptr<RowBatch> _child_batch;
+    bool _child_eos;
+
+    // Number of input rows returned without being aggregated into the hash table.
+    int64_t _num_passthrough_rows;
     
     Tuple* _singleton_output_tuple;  // result of aggregation w/o GROUP BY
     boost::scoped_ptr<MemPool> _tuple_pool;
@@ -119,11 +137,15 @@ private:
     RuntimeProfile::Counter* _hash_table_buckets_counter;
     // Load factor in hash table
     RuntimeProfile::Counter* _hash_table_load_factor_counter;
+    // Streaming pre-aggregation only
+    RuntimeProfile::Counter* _streaming_timer;
+    RuntimeProfile::Counter* _num_passthrough_rows_counter;
+    RuntimeProfile::Counter* _preagg_streaming_ht_min_reduction;
 
-    // Constructs a new aggregation output tuple (allocated from _tuple_pool),
+    // Constructs a new aggregation output tuple (allocated from 'pool'),
     // initialized to grouping values computed over '_current_row'.
     // Aggregation expr slots are set to their initial values.
-    Tuple* construct_intermediate_tuple();
+    Tuple* construct_intermediate_tuple(MemPool* pool);
 
     // Updates the aggregation output tuple 'tuple' with aggregation values
     // computed over 'row'.
@@ -137,6 +159,20 @@ private:
     void process_row_batch_no_grouping(RowBatch* batch, MemPool* pool);
     void process_row_batch_with_grouping(RowBatch* batch, MemPool* pool);
 
+    // Aggregates the rows of 'in_batch' into the hash table, adding at most
+    // 'remaining_capacity' new groups. Rows of other new groups are passed through to
+    // 'out_batch'.
+    void process_row_batch_streaming(
+        RowBatch* in_batch, RowBatch* out_batch, int64_t remaining_capacity);
+
+    // Streaming pre-aggregation: reads child batches until some rows are passed
+    // through to 'row_batch' or the child is exhausted.
+    Status get_rows_streaming(RuntimeState* state, RowBatch* row_batch);
+
+    // Returns true if the hash table reduces the input enough to be worth growing it,
+    // given the cache level its current size falls into.
+    bool should_expand_preagg_hash_table() const;
+
     /// Codegen the process row batch loop.  The loop has already been compiled to
     /// IR and loaded into the codegen object.  UpdateAggTuple has also been
     /// codegen'd to IR.  This function will modify the loop subsituting the
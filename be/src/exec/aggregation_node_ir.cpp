@@ -38,7 +38,7 @@ void AggregationNode::process_row_batch_with_grouping(RowBatch* batch, MemPool*
         HashTable::Iterator it = _hash_tbl->find(row);
 
         if (it.at_end()) {
-            agg_tuple = construct_intermediate_tuple();
+            agg_tuple = construct_intermediate_tuple(_tuple_pool.get());
             _hash_tbl->insert(reinterpret_cast<TupleRow*>(&agg_tuple));
         } else {
             agg_tuple = it.get_row()->get_tuple(0);
@@ -48,5 +48,32 @@ void AggregationNode::process_row_batch_with_grouping(RowBatch* batch, MemPool*
     }
 }
 
+void AggregationNode::process_row_batch_streaming(
+        RowBatch* in_batch, RowBatch* out_batch, int64_t remaining_capacity) {
+    for (int i = 0; i < in_batch->num_rows(); ++i) {
+        TupleRow* in_row = in_batch->get_row(i);
+        HashTable::Iterator it = _hash_tbl->find(in_row);
+
+        if (!it.at_end()) {
+            update_tuple(it.get_row()->get_tuple(0), in_row);
+        } else if (remaining_capacity > 0) {
+            Tuple* agg_tuple = construct_intermediate_tuple(_tuple_pool.get());
+            _hash_tbl->insert(reinterpret_cast<TupleRow*>(&agg_tuple));
+            update_tuple(agg_tuple, in_row);
+            --remaining_capacity;
+        } else {
+            // Pass the row through as a group of its own; the merge aggregation
+            // combines it with the other rows of the group.
+            int row_idx = out_batch->add_row();
+            DCHECK(row_idx != RowBatch::INVALID_ROW_INDEX);
+            TupleRow* out_row = out_batch->get_row(row_idx);
+            Tuple* agg_tuple = construct_intermediate_tuple(out_batch->tuple_data_pool());
+            update_tuple(agg_tuple, in_row);
+            out_row->set_tuple(0, finalize_tuple(agg_tuple, out_batch->tuple_data_pool()));
+            out_batch->commit_last_row();
+        }
+    }
+}
+
 }
 
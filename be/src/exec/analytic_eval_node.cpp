@@ -50,6 +50,7 @@ AnalyticEvalNode::AnalyticEvalNode(ObjectPool* pool, const TPlanNode& tnode,
         _last_result_idx(-1),
         _prev_pool_last_result_idx(-1),
         _prev_pool_last_window_idx(-1),
+        _window_back_agg(NULL),
         _curr_tuple(NULL),
         _dummy_result_tuple(NULL),
         _curr_partition_idx(-1),
@@ -162,6 +163,11 @@ Status AnalyticEvalNode::prepare(RuntimeState* state) {
                 mem_tracker(), &ctx));
         _fn_ctxs.push_back(ctx);
         state->obj_pool()->add(ctx);
+        if (_fn_scope == ROWS && _window.__isset.window_start &&
+                (_evaluators[i]->agg_op() == AggFnEvaluator::MIN ||
+                 _evaluators[i]->agg_op() == AggFnEvaluator::MAX)) {
+            _sliding_fn_idxs.push_back(i);
+        }
     }
 
     if (_partition_by_eq_expr_ctx != NULL || _order_by_eq_expr_ctx != NULL) {
@@ -224,6 +230,9 @@ Status AnalyticEvalNode::open(RuntimeState* state) {
     _curr_tuple = Tuple::create(_intermediate_tuple_desc->byte_size(), _mem_pool.get());
     AggFnEvaluator::init(_evaluators, _fn_ctxs, _curr_tuple);
     _dummy_result_tuple = Tuple::create(_result_tuple_desc->byte_size(), _mem_pool.get());
+    if (!_sliding_fn_idxs.empty()) {
+        _window_back_agg = new_sliding_agg();
+    }
 
     // Initialize state for the first partition.
     init_next_partition(0);
@@ -371,6 +380,9 @@ std::string AnalyticEvalNode::debug_state_string(bool detailed) const {
 void AnalyticEvalNode::add_result_tuple(int64_t stream_idx) {
     VLOG_ROW << id() << " add_result_tuple idx=" << stream_idx;
     DCHECK(_curr_tuple != NULL);
+    if (!_sliding_fn_idxs.empty()) {
+        update_sliding_fn_values();
+    }
     Tuple* result_tuple = Tuple::create(_result_tuple_desc->byte_size(),
                                         _curr_tuple_pool.get());
 
@@ -432,11 +444,101 @@ inline void AnalyticEvalNode::try_remove_rows_before_window(int64_t stream_idx)
     DCHECK(!_window_tuples.empty()) << debug_state_string(true);
     DCHECK_EQ(remove_idx + std::max(_rows_start_offset, 0L), _window_tuples.front().first)
             << debug_state_string(true);
+    remove_first_window_tuple();
+}
+
+inline void AnalyticEvalNode::remove_first_window_tuple() {
     TupleRow* remove_row = reinterpret_cast<TupleRow*>(&_window_tuples.front().second);
     AggFnEvaluator::remove(_evaluators, _fn_ctxs, remove_row, _curr_tuple);
+    if (!_sliding_fn_idxs.empty()) {
+        remove_sliding_window_row();
+    }
     _window_tuples.pop_front();
 }
 
+Tuple* AnalyticEvalNode::new_sliding_agg() {
+    Tuple* agg = NULL;
+    if (_free_sliding_aggs.empty()) {
+        agg = Tuple::create(_intermediate_tuple_desc->byte_size(), _mem_pool.get());
+    } else {
+        agg = _free_sliding_aggs.back();
+        _free_sliding_aggs.pop_back();
+    }
+    for (int i : _sliding_fn_idxs) {
+        _evaluators[i]->init(_fn_ctxs[i], agg);
+    }
+    return agg;
+}
+
+void AnalyticEvalNode::reset_sliding_agg(Tuple* agg) {
+    for (int i : _sliding_fn_idxs) {
+        // string values of min() and max() are allocated from the fn context, results
+        // got by get_value() are copies
+        const SlotDescriptor* slot_desc = _intermediate_tuple_desc->slots()[i];
+        if (slot_desc->type().is_string_type() &&
+                !agg->is_null(slot_desc->null_indicator_offset())) {
+            StringValue* value = agg->get_string_slot(slot_desc->tuple_offset());
+            if (value->ptr != NULL) {
+                _fn_ctxs[i]->free(reinterpret_cast<uint8_t*>(value->ptr));
+            }
+        }
+        _evaluators[i]->init(_fn_ctxs[i], agg);
+    }
+}
+
+inline void AnalyticEvalNode::add_sliding_window_row(TupleRow* row) {
+    for (int i : _sliding_fn_idxs) {
+        _evaluators[i]->add(_fn_ctxs[i], row, _window_back_agg);
+    }
+}
+
+void AnalyticEvalNode::remove_sliding_window_row() {
+    if (_window_front_aggs.empty()) {
+        // Move all rows of the window to the front stack, the last pushed aggregate is
+        // the one of the whole window and belongs to the oldest row.
+        Tuple* prev_agg = NULL;
+        for (auto it = _window_tuples.rbegin(); it != _window_tuples.rend(); ++it) {
+            Tuple* agg = new_sliding_agg();
+            TupleRow* row = reinterpret_cast<TupleRow*>(&it->second);
+            for (int i : _sliding_fn_idxs) {
+                if (prev_agg != NULL) {
+                    _evaluators[i]->merge(_fn_ctxs[i], prev_agg, agg);
+                }
+                _evaluators[i]->add(_fn_ctxs[i], row, agg);
+            }
+            _window_front_aggs.push_back(agg);
+            prev_agg = agg;
+        }
+        reset_sliding_agg(_window_back_agg);
+    }
+    DCHECK(!_window_front_aggs.empty());
+    Tuple* agg = _window_front_aggs.back();
+    _window_front_aggs.pop_back();
+    reset_sliding_agg(agg);
+    _free_sliding_aggs.push_back(agg);
+}
+
+void AnalyticEvalNode::clear_sliding_window() {
+    for (Tuple* agg : _window_front_aggs) {
+        reset_sliding_agg(agg);
+        _free_sliding_aggs.push_back(agg);
+    }
+    _window_front_aggs.clear();
+    reset_sliding_agg(_window_back_agg);
+}
+
+void AnalyticEvalNode::update_sliding_fn_values() {
+    // _curr_tuple is updated with every row of the partition like for all other fns,
+    // so the slots are recomputed from the window state.
+    reset_sliding_agg(_curr_tuple);
+    for (int i : _sliding_fn_idxs) {
+        if (!_window_front_aggs.empty()) {
+            _evaluators[i]->merge(_fn_ctxs[i], _window_front_aggs.back(), _curr_tuple);
+        }
+        _evaluators[i]->merge(_fn_ctxs[i], _window_back_agg, _curr_tuple);
+    }
+}
+
 inline void AnalyticEvalNode::try_add_remaining_results(int64_t partition_idx,
         int64_t prev_partition_idx) {
     DCHECK_LT(prev_partition_idx, partition_idx);
@@ -478,9 +580,7 @@ inline void AnalyticEvalNode::try_add_remaining_results(int64_t partition_idx,
             // and add the result tuple at the next index.
             VLOG_ROW << id() << " Remove window_row_idx=" << _window_tuples.front().first
                      << " for result row at idx=" << next_result_idx;
-            TupleRow* remove_row = reinterpret_cast<TupleRow*>(&_window_tuples.front().second);
-            AggFnEvaluator::remove(_evaluators, _fn_ctxs, remove_row, _curr_tuple);
-            _window_tuples.pop_front();
+            remove_first_window_tuple();
         }
 
         add_result_tuple(_last_result_idx + 1);
@@ -542,6 +642,9 @@ inline void AnalyticEvalNode::init_next_partition(int64_t stream_idx) {
     }
 
     _window_tuples.clear();
+    if (!_sliding_fn_idxs.empty()) {
+        clear_sliding_window();
+    }
 
     // Re-initialize _curr_tuple.
     VLOG_ROW << id() << " Reset curr_tuple";
@@ -668,6 +771,9 @@ Status AnalyticEvalNode::process_child_batch(RuntimeState* state) {
                                _curr_tuple_pool.get());
                 _window_tuples.push_back(std::pair<int64_t, Tuple*>(stream_idx, tuple));
                 last_window_tuple_idx = stream_idx;
+                if (!_sliding_fn_idxs.empty()) {
+                    add_sliding_window_row(row);
+                }
             }
         }
 
@@ -798,6 +904,7 @@ inline int64_t AnalyticEvalNode::num_output_rows_ready() const {
 
 Status AnalyticEvalNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     //RETURN_IF_ERROR(QueryMaintenance(state));
@@ -151,6 +151,28 @@ private:
     // process_child_batch().
     void try_remove_rows_before_window(int64_t stream_idx);
 
+    // Removes the first tuple of _window_tuples from the window, i.e. from _curr_tuple
+    // and from the sliding window state of _sliding_fn_idxs.
+    void remove_first_window_tuple();
+
+    // MIN() and MAX() have no remove fn, so for ROWS windows with a start bound their
+    // value over the window is kept by two stacks of intermediate tuples instead of in
+    // _curr_tuple: _window_back_agg aggregates the newest rows of the window, and
+    // _window_front_aggs[i] aggregates the i-th newest of the remaining (oldest) rows up
+    // to the newest of them. Once the oldest rows are all removed, the whole window is
+    // moved to _window_front_aggs. Every row is aggregated a constant number of times.
+    void add_sliding_window_row(TupleRow* row);
+    void remove_sliding_window_row();
+    void clear_sliding_window();
+
+    // Sets the slots of _sliding_fn_idxs in _curr_tuple to their value over the window.
+    void update_sliding_fn_values();
+
+    // Returns an intermediate tuple with the slots of _sliding_fn_idxs initialized.
+    Tuple* new_sliding_agg();
+    // Frees the values in the slots of _sliding_fn_idxs of 'agg' and initializes them.
+    void reset_sliding_agg(Tuple* agg);
+
     // Initializes state at the start of a new partition. stream_idx is the index of the
     // current input row from _input_stream.
     void init_next_partition(int64_t stream_idx);
@@ -258,6 +280,14 @@ private:
     std::list<std::pair<int64_t, Tuple*> > _window_tuples;
     TupleDescriptor* _child_tuple_desc;
 
+    // Indexes of the MIN() and MAX() evaluators if the window is ROWS with a start bound,
+    // see add_sliding_window_row().
+    std::vector<int> _sliding_fn_idxs;
+    std::vector<Tuple*> _window_front_aggs;
+    Tuple* _window_back_agg;
+    // Intermediate tuples popped from _window_front_aggs, reused by new_sliding_agg().
+    std::vector<Tuple*> _free_sliding_aggs;
+
     // Pools used to allocate result tuples (added to _result_tuples and later returned)
     // and window tuples (added to _window_tuples to buffer the current window). Resources
     // are transferred from _curr_tuple_pool to _prev_tuple_pool once it is at least
@@ -20,11 +20,13 @@
 #include <chrono>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "runtime/runtime_state.h"
 #include "runtime/row_batch.h"
 #include "runtime/dpp_sink_internal.h"
 #include "exec/broker_scanner.h"
+#include "exec/json_scanner.h"
 #include "exec/parquet_scanner.h"
 #include "exprs/expr.h"
 #include "util/runtime_profile.h"
@@ -128,17 +130,57 @@ Status BrokerScanNode::open(RuntimeState* state) {
     return Status::OK();
 }
 
+void BrokerScanNode::split_scan_ranges() {
+    int64_t split_bytes = config::broker_scanner_split_bytes;
+    for (auto& scan_range_params : _scan_ranges) {
+        const TBrokerScanRange& scan_range = scan_range_params.scan_range.broker_scan_range;
+        TBrokerScanRange unsplit_range = scan_range;
+        unsplit_range.ranges.clear();
+        for (auto& range : scan_range.ranges) {
+            // BrokerScanner starts a piece not at the beginning of the file from the next
+            // line, and reads a piece to the end of its last line
+            bool splittable = range.format_type == TFileFormatType::FORMAT_CSV_PLAIN
+                && range.splittable
+                && (range.file_type == TFileType::FILE_BROKER
+                    || range.file_type == TFileType::FILE_LOCAL);
+            if (split_bytes <= 0 || !splittable || range.size <= split_bytes) {
+                unsplit_range.ranges.push_back(range);
+                continue;
+            }
+            for (int64_t offset = 0; offset < range.size; offset += split_bytes) {
+                TBrokerScanRange piece_range = unsplit_range;
+                piece_range.ranges.clear();
+                TBrokerRangeDesc piece = range;
+                piece.start_offset = range.start_offset + offset;
+                piece.size = std::min(split_bytes, range.size - offset);
+                piece_range.ranges.push_back(piece);
+                _scanner_ranges.push_back(std::move(piece_range));
+            }
+        }
+        if (!unsplit_range.ranges.empty()) {
+            _scanner_ranges.push_back(std::move(unsplit_range));
+        }
+    }
+}
+
 Status BrokerScanNode::start_scanners() {
+    split_scan_ranges();
+    int num_scanners = std::min<int>(
+        config::broker_scan_node_max_scanner_threads, _scanner_ranges.size());
+    num_scanners = std::max(1, num_scanners);
     {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
-        _num_running_scanners = 1;
+        _num_running_scanners = num_scanners;
+    }
+    for (int i = 0; i < num_scanners; ++i) {
+        _scanner_threads.emplace_back(&BrokerScanNode::scanner_worker, this);
     }
-    _scanner_threads.emplace_back(&BrokerScanNode::scanner_worker, this, 0, _scan_ranges.size());
     return Status::OK();
 }
 
 Status BrokerScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     // check if CANCELLED.
     if (state->is_cancelled()) {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
@@ -273,6 +315,7 @@ std::unique_ptr<BaseScanner> BrokerScanNode::create_scanner(const TBrokerScanRan
     BaseScanner *scan = nullptr;
     switch (scan_range.ranges[0].format_type) {
     case TFileFormatType::FORMAT_PARQUET:
+    case TFileFormatType::FORMAT_ORC:
         scan = new ParquetScanner(_runtime_state,
                 runtime_profile(),
                 scan_range.params,
@@ -280,6 +323,14 @@ std::unique_ptr<BaseScanner> BrokerScanNode::create_scanner(const TBrokerScanRan
                 scan_range.broker_addresses,
                 counter);
         break;
+    case TFileFormatType::FORMAT_JSON:
+        scan = new JsonScanner(_runtime_state,
+                runtime_profile(),
+                scan_range.params,
+                scan_range.ranges,
+                scan_range.broker_addresses,
+                counter);
+        break;
     default:
         scan = new BrokerScanner(
                 _runtime_state,
@@ -406,7 +457,7 @@ Status BrokerScanNode::scanner_scan(
     return Status::OK();
 }
 
-void BrokerScanNode::scanner_worker(int start_idx, int length) {
+void BrokerScanNode::scanner_worker() {
     // Clone expr context
     std::vector<ExprContext*> scanner_expr_ctxs;
     auto status = Expr::clone_if_not_exists(_conjunct_ctxs, _runtime_state, &scanner_expr_ctxs);
@@ -422,12 +473,22 @@ void BrokerScanNode::scanner_worker(int start_idx, int length) {
         }
     }
     ScannerCounter counter;
-    for (int i = 0; i < length && status.ok(); ++i) {
-        const TBrokerScanRange& scan_range = 
-            _scan_ranges[start_idx + i].scan_range.broker_scan_range;
-        status = scanner_scan(scan_range, scanner_expr_ctxs, partition_expr_ctxs, &counter);
+    while (status.ok() && !_scan_finished.load()) {
+        {
+            // another scanner failed
+            std::lock_guard<std::mutex> l(_batch_queue_lock);
+            if (!_process_status.ok()) {
+                break;
+            }
+        }
+        int idx = _next_scanner_range.fetch_add(1);
+        if (idx >= _scanner_ranges.size()) {
+            break;
+        }
+        status = scanner_scan(_scanner_ranges[idx], scanner_expr_ctxs, partition_expr_ctxs,
+                              &counter);
         if (!status.ok()) {
-            LOG(WARNING) << "Scanner[" << start_idx + i << "] prcess failed. status="
+            LOG(WARNING) << "Scanner[" << idx << "] prcess failed. status="
                 << status.get_error_msg();
         }
     }
@@ -86,8 +86,13 @@ private:
     // Create scanners to do scan job
     Status start_scanners();
 
-    // One scanner worker, This scanner will handle 'length' ranges start from start_idx
-    void scanner_worker(int start_idx, int length);
+    // Fills _scanner_ranges with the ranges of _scan_ranges, splitting large plain text
+    // ranges into pieces that can be scanned in parallel
+    void split_scan_ranges();
+
+    // One scanner worker, This scanner will handle ranges of _scanner_ranges until none
+    // is left
+    void scanner_worker();
 
     // Scan one range
     Status scanner_scan(const TBrokerScanRange& scan_range,
@@ -107,6 +112,10 @@ private:
     TupleDescriptor* _tuple_desc;
     std::map<std::string, SlotDescriptor*> _slots_map;
     std::vector<TScanRangeParams> _scan_ranges;
+    // ranges scanned by the scanner threads, the next one to scan is
+    // _next_scanner_range
+    std::vector<TBrokerScanRange> _scanner_ranges;
+    std::atomic<int> _next_scanner_range{0};
 
     std::mutex _batch_queue_lock;
     std::condition_variable _queue_reader_cond;
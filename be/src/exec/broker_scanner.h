@@ -40,6 +40,7 @@ class TextConverter;
 class FileReader;
 class LineReader;
 class Decompressor;
+class DecompressFileReader;
 class RuntimeState;
 class ExprContext;
 class TupleDescriptor;
@@ -74,6 +75,8 @@ private:
     Status open_file_reader();
     Status create_decompressor(TFileFormatType::type type);
     Status open_line_reader();
+    // stop the background decompress thread of the current file
+    void close_decompress_reader();
     // Read next buffer from reader
     Status open_next_reader();
 
@@ -113,11 +116,16 @@ private:;
 
     char _value_separator;
     char _line_delimiter;
+    // fields of the line being converted, kept to not allocate for every line
+    std::vector<Slice> _split_values;
 
     // Reader
     FileReader* _cur_file_reader;
     LineReader* _cur_line_reader;
     Decompressor* _cur_decompressor;
+    // reads and decompresses _cur_file_reader ahead of _cur_line_reader,
+    // nullptr if the file is not compressed
+    DecompressFileReader* _cur_decompress_reader;
     int _next_range;
     bool _cur_line_reader_eof;
 
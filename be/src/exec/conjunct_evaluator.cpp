@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/conjunct_evaluator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "exprs/expr_context.h"
+#include "util/stopwatch.hpp"
+
+namespace doris {
+
+void ConjunctEvaluator::init(ExprContext* const* ctxs, int num_ctxs) {
+    _conjuncts.clear();
+    for (int i = 0; i < num_ctxs; ++i) {
+        _conjuncts.push_back({ctxs[i], 0, 0, 0});
+    }
+    _num_batches = 0;
+}
+
+int ConjunctEvaluator::filter(RowBatch* batch, int* sel, int num_rows) {
+    for (Conjunct& conjunct : _conjuncts) {
+        if (num_rows == 0) {
+            break;
+        }
+        uint64_t start = StopWatch::rdtsc();
+        int num_kept = conjunct.ctx->filter_batch(batch, sel, num_rows);
+        conjunct.ticks += StopWatch::rdtsc() - start;
+        conjunct.rows_in += num_rows;
+        conjunct.rows_out += num_kept;
+        num_rows = num_kept;
+    }
+    if (_conjuncts.size() > 1 && ++_num_batches == REORDER_INTERVAL) {
+        reorder();
+        _num_batches = 0;
+    }
+    return num_rows;
+}
+
+void ConjunctEvaluator::reorder() {
+    auto rank = [](const Conjunct& c) -> double {
+        if (c.rows_in == 0) {
+            return std::numeric_limits<double>::max();
+        }
+        return static_cast<double>(c.rows_in - c.rows_out) / std::max<uint64_t>(c.ticks, 1);
+    };
+    std::stable_sort(_conjuncts.begin(), _conjuncts.end(),
+                     [&rank](const Conjunct& a, const Conjunct& b) {
+                         return rank(a) > rank(b);
+                     });
+    for (Conjunct& conjunct : _conjuncts) {
+        conjunct.rows_in /= 2;
+        conjunct.rows_out /= 2;
+        conjunct.ticks /= 2;
+    }
+}
+
+}
@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_EXEC_CONJUNCT_EVALUATOR_H
+#define DORIS_BE_SRC_EXEC_CONJUNCT_EVALUATOR_H
+
+#include <cstdint>
+#include <vector>
+
+namespace doris {
+
+class ExprContext;
+class RowBatch;
+
+// Filters row batches with a list of conjuncts, one conjunct at a time over the rows
+// the previous ones kept (see Expr::filter_batch()).
+//
+// The conjuncts are ANDed, so their order does not matter for the result but does for
+// the cost: the sooner rows are dropped the fewer are left for the others. The
+// evaluator counts the rows each conjunct sees and drops and the cpu ticks it takes,
+// and every REORDER_INTERVAL batches sorts the conjuncts by dropped rows per tick.
+// Conjuncts that did not see any rows since the last reorder go first, so that a
+// conjunct behind a very selective one is measured again from time to time.
+class ConjunctEvaluator {
+public:
+    ConjunctEvaluator() : _num_batches(0) { }
+
+    // 'ctxs' must stay valid as long as this evaluator is used.
+    void init(ExprContext* const* ctxs, int num_ctxs);
+
+    bool empty() const { return _conjuncts.empty(); }
+
+    // Keeps at the front of 'sel' the rows sel[0, num_rows) of 'batch' for which all
+    // conjuncts are true, in their original order, and returns their number. 'sel'
+    // must be increasing.
+    int filter(RowBatch* batch, int* sel, int num_rows);
+
+private:
+    static const int REORDER_INTERVAL = 32;
+
+    struct Conjunct {
+        ExprContext* ctx;
+        int64_t rows_in;
+        int64_t rows_out;
+        uint64_t ticks;
+    };
+
+    // Sorts '_conjuncts' by observed cost and halves their stats, so recent batches
+    // weigh more.
+    void reorder();
+
+    std::vector<Conjunct> _conjuncts;
+    int _num_batches;
+};
+
+}
+
+#endif
@@ -17,10 +17,14 @@
 
 #include "exec/cross_join_node.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/debug_util.h"
@@ -37,14 +41,137 @@ Status CrossJoinNode::prepare(RuntimeState* state) {
     DCHECK(_join_op == TJoinOp::CROSS_JOIN);
     RETURN_IF_ERROR(BlockingJoinNode::prepare(state));
     _build_batch_pool.reset(new ObjectPool());
+    _key_row.resize(_probe_tuple_row_size + _build_tuple_row_size);
+    init_range_conjuncts();
     return Status::OK();
 }
 
+void CrossJoinNode::init_range_conjuncts() {
+    std::vector<TupleId> probe_tuple_ids;
+    for (auto tuple_desc : child(0)->row_desc().tuple_descriptors()) {
+        probe_tuple_ids.push_back(tuple_desc->id());
+    }
+    std::vector<TupleId> build_tuple_ids;
+    for (auto tuple_desc : child(1)->row_desc().tuple_descriptors()) {
+        build_tuple_ids.push_back(tuple_desc->id());
+    }
+    for (auto ctx : _conjunct_ctxs) {
+        Expr* pred = ctx->root();
+        if (pred->node_type() != TExprNodeType::BINARY_PRED || pred->get_num_children() != 2) {
+            continue;
+        }
+        TExprOpcode::type op = pred->op();
+        if (op != TExprOpcode::EQ && op != TExprOpcode::LT && op != TExprOpcode::LE
+                && op != TExprOpcode::GT && op != TExprOpcode::GE) {
+            continue;
+        }
+        for (int child_idx = 0; child_idx < 2; ++child_idx) {
+            Expr* key = pred->get_child(child_idx);
+            Expr* probe_expr = pred->get_child(1 - child_idx);
+            if (!key->is_slotref() || !key->is_bound(&build_tuple_ids)
+                    || !probe_expr->is_bound(&probe_tuple_ids)
+                    || key->type() != probe_expr->type()) {
+                continue;
+            }
+            // only types whose RawValue::compare() agrees with the predicate, floating
+            // point types are left out because of NaN
+            switch (key->type().type) {
+            case TYPE_TINYINT:
+            case TYPE_SMALLINT:
+            case TYPE_INT:
+            case TYPE_BIGINT:
+            case TYPE_LARGEINT:
+            case TYPE_DATE:
+            case TYPE_DATETIME:
+            case TYPE_DECIMAL:
+            case TYPE_DECIMALV2:
+                break;
+            default:
+                continue;
+            }
+            SlotRef* slot_ref = static_cast<SlotRef*>(key);
+            if (_build_key == nullptr) {
+                _build_key = slot_ref;
+            } else if (_build_key->slot_id() != slot_ref->slot_id()) {
+                continue;
+            }
+            if (child_idx == 1) {
+                // "probe_expr op key" to "key op' probe_expr"
+                switch (op) {
+                case TExprOpcode::LT: op = TExprOpcode::GT; break;
+                case TExprOpcode::LE: op = TExprOpcode::GE; break;
+                case TExprOpcode::GT: op = TExprOpcode::LT; break;
+                case TExprOpcode::GE: op = TExprOpcode::LE; break;
+                default: break;
+                }
+            }
+            _range_conjuncts.push_back({ctx, probe_expr, op});
+            break;
+        }
+    }
+}
+
+const void* CrossJoinNode::get_build_key(TupleRow* build_row) {
+    TupleRow* key_row = reinterpret_cast<TupleRow*>(&_key_row[0]);
+    create_output_row(key_row, nullptr, build_row);
+    return SlotRef::get_value(_build_key, key_row);
+}
+
+void CrossJoinNode::init_build_row_range(TupleRow* left_row) {
+    TupleRow* key_row = reinterpret_cast<TupleRow*>(&_key_row[0]);
+    create_output_row(key_row, left_row, nullptr);
+    const TypeDescriptor& type = _build_key->type();
+    auto key_less = [&type](const std::pair<const void*, TupleRow*>& build_row,
+                            const void* value) {
+        return RawValue::compare(build_row.first, value, type) < 0;
+    };
+    auto less_key = [&type](const void* value,
+                            const std::pair<const void*, TupleRow*>& build_row) {
+        return RawValue::compare(value, build_row.first, type) < 0;
+    };
+    auto begin = _sorted_build_rows.begin();
+    auto end = _sorted_build_rows.end();
+    for (auto& conjunct : _range_conjuncts) {
+        if (begin >= end) {
+            break;
+        }
+        const void* value = conjunct.ctx->get_value(conjunct.probe_expr, key_row);
+        if (value == nullptr) {
+            // comparing with null is never true
+            end = begin;
+            break;
+        }
+        switch (conjunct.op) {
+        case TExprOpcode::EQ:
+            begin = std::lower_bound(begin, end, value, key_less);
+            end = std::upper_bound(begin, end, value, less_key);
+            break;
+        case TExprOpcode::LT:
+            end = std::lower_bound(begin, end, value, key_less);
+            break;
+        case TExprOpcode::LE:
+            end = std::upper_bound(begin, end, value, less_key);
+            break;
+        case TExprOpcode::GT:
+            begin = std::upper_bound(begin, end, value, less_key);
+            break;
+        case TExprOpcode::GE:
+            begin = std::lower_bound(begin, end, value, key_less);
+            break;
+        default:
+            DCHECK(false) << "bad op of range conjunct: " << conjunct.op;
+        }
+    }
+    _build_row_idx = begin - _sorted_build_rows.begin();
+    _build_row_end = std::max(begin, end) - _sorted_build_rows.begin();
+}
+
 Status CrossJoinNode::close(RuntimeState* state) {
     // avoid double close
     if (is_closed()) {
         return Status::OK();
     }
+    _sorted_build_rows.clear();
     _build_batches.reset();
     _build_batch_pool.reset();
     BlockingJoinNode::close(state);
@@ -79,11 +206,34 @@ Status CrossJoinNode::construct_build_side(RuntimeState* state) {
         }
     }
 
+    if (_build_key != nullptr) {
+        SCOPED_TIMER(_build_timer);
+        for (auto it = _build_batches.iterator(); !it.at_end(); it.next()) {
+            const void* key = get_build_key(it.get_row());
+            // rows with null build key can't match any left row
+            if (key != nullptr) {
+                _sorted_build_rows.emplace_back(key, it.get_row());
+            }
+        }
+        const TypeDescriptor& type = _build_key->type();
+        std::sort(_sorted_build_rows.begin(), _sorted_build_rows.end(),
+                  [&type](const std::pair<const void*, TupleRow*>& lhs,
+                          const std::pair<const void*, TupleRow*>& rhs) {
+                      return RawValue::compare(lhs.first, rhs.first, type) < 0;
+                  });
+    }
+
     return Status::OK();
 }
 
 void CrossJoinNode::init_get_next(TupleRow* first_left_row) {
-    _current_build_row = _build_batches.iterator();
+    if (_build_key == nullptr) {
+        _current_build_row = _build_batches.iterator();
+    } else if (first_left_row == nullptr) {
+        _build_row_idx = _build_row_end = 0;
+    } else {
+        init_build_row_range(first_left_row);
+    }
 }
 
 Status CrossJoinNode::get_next(RuntimeState* state, RowBatch* output_batch, bool* eos) {
@@ -93,6 +243,7 @@ Status CrossJoinNode::get_next(RuntimeState* state, RowBatch* output_batch, bool
     // TOOD(zhaochun)
     // RETURN_IF_ERROR(state->check_query_state());
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
 
     if (reached_limit() || _eos) {
         *eos = true;
@@ -120,7 +271,7 @@ Status CrossJoinNode::get_next(RuntimeState* state, RowBatch* output_batch, bool
         }
 
         // Check to see if we're done processing the current left child batch
-        if (_current_build_row.at_end() && _left_batch_pos == _left_batch->num_rows()) {
+        if (build_rows_at_end() && _left_batch_pos == _left_batch->num_rows()) {
             _left_batch->transfer_resource_ownership(output_batch);
             _left_batch_pos = 0;
 
@@ -164,9 +315,15 @@ int CrossJoinNode::process_left_child_batch(RowBatch* output_batch, RowBatch* ba
     int ctx_size = _conjunct_ctxs.size();
 
     while (true) {
-        while (!_current_build_row.at_end()) {
-            create_output_row(output_row, _current_left_child_row, _current_build_row.get_row());
-            _current_build_row.next();
+        while (!build_rows_at_end()) {
+            if (_build_key != nullptr) {
+                create_output_row(output_row, _current_left_child_row,
+                                  _sorted_build_rows[_build_row_idx++].second);
+            } else {
+                create_output_row(output_row, _current_left_child_row,
+                                  _current_build_row.get_row());
+                _current_build_row.next();
+            }
 
             if (!eval_conjuncts(ctxs, ctx_size, output_row)) {
                 continue;
@@ -185,7 +342,7 @@ int CrossJoinNode::process_left_child_batch(RowBatch* output_batch, RowBatch* ba
             output_row = reinterpret_cast<TupleRow*>(output_row_mem);
         }
 
-        DCHECK(_current_build_row.at_end());
+        DCHECK(build_rows_at_end());
 
         // Advance to the next row in the left child batch
         if (UNLIKELY(_left_batch_pos == batch->num_rows())) {
@@ -194,7 +351,7 @@ int CrossJoinNode::process_left_child_batch(RowBatch* output_batch, RowBatch* ba
         }
 
         _current_left_child_row = batch->get_row(_left_batch_pos++);
-        _current_build_row = _build_batches.iterator();
+        init_get_next(_current_left_child_row);
     }
 
     output_batch->commit_rows(rows_returned);
@@ -22,17 +22,22 @@
 #include <boost/unordered_set.hpp>
 #include <boost/thread.hpp>
 #include <string>
+#include <vector>
 
 #include "exec/exec_node.h"
 #include "exec/blocking_join_node.h"
 #include "exec/row_batch_list.h"
 #include "runtime/descriptors.h"
 #include "runtime/mem_pool.h"
+#include "gen_cpp/Opcodes_types.h"
 #include "gen_cpp/PlanNodes_types.h"
 
 namespace doris {
 
+class Expr;
+class ExprContext;
 class RowBatch;
+class SlotRef;
 class TupleRow;
 
 // Node for cross joins.
@@ -41,6 +46,10 @@ class TupleRow;
 // build batches are kept in a list that is fully constructed from the right child in
 // construct_build_side() (called by BlockingJoinNode::open()) while rows are fetched from
 // the left child as necessary in get_next().
+// If some conjuncts compare a slot of the right child with an expr of the left child,
+// e.g. "a.ts >= b.start_ts AND a.ts < b.end_ts", the build rows are sorted by that slot
+// and each left row is only paired with the range of build rows found by binary search
+// (an interval join), instead of with all build rows.
 class CrossJoinNode : public BlockingJoinNode {
 public:
     CrossJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -60,6 +69,44 @@ private:
     RowBatchList _build_batches;
     RowBatchList::TupleRowIterator _current_build_row;
 
+    // A conjunct "build key op probe_expr", which bounds the range of sorted build rows
+    // that can match a left row.
+    struct RangeConjunct {
+        ExprContext* ctx;
+        // bound to the left child
+        Expr* probe_expr;
+        // one of EQ, LT, LE, GT and GE, with the build key as the left operand
+        TExprOpcode::type op;
+    };
+
+    // Slot of the right child which build rows are sorted by, null if no conjunct can
+    // be used to limit the build rows of a left row.
+    SlotRef* _build_key = nullptr;
+    std::vector<RangeConjunct> _range_conjuncts;
+    // Build rows whose build key is not null, and the pointers to their build keys,
+    // sorted by build key. Only used if '_build_key' is set.
+    std::vector<std::pair<const void*, TupleRow*>> _sorted_build_rows;
+    // Range of '_sorted_build_rows' left to join with the current left row.
+    int _build_row_idx = 0;
+    int _build_row_end = 0;
+    // Output row to evaluate build keys and probe exprs on.
+    std::vector<uint8_t> _key_row;
+
+    // Finds a conjunct to sort build rows by, and all conjuncts on the same build key.
+    void init_range_conjuncts();
+
+    // Returns the value of the build key in 'build_row', null if it is null.
+    const void* get_build_key(TupleRow* build_row);
+
+    // Sets the range of sorted build rows that can match 'left_row'.
+    void init_build_row_range(TupleRow* left_row);
+
+    // Returns true if all build rows are joined with the current left row.
+    bool build_rows_at_end() {
+        return _build_key != nullptr ? _build_row_idx == _build_row_end
+                                     : _current_build_row.at_end();
+    }
+
     // Processes a batch from the left child.
     //  output_batch: the batch for resulting tuple rows
     //  batch: the batch from the left child to process.  This function can be called to
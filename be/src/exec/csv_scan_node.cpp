@@ -263,6 +263,7 @@ Status CsvScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     SCOPED_TIMER(materialize_tuple_timer());
 
     if (reached_limit()) {
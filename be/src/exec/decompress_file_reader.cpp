@@ -0,0 +1,267 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/decompress_file_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "common/logging.h"
+#include "exec/decompressor.h"
+
+// same as the input chunk of PlainTextLineReader, which must be
+// large enough for lz4 and lzo headers
+#define INPUT_CHUNK  (2 * 1024 * 1024)
+#define OUTPUT_CHUNK (4 * 1024 * 1024)
+
+namespace doris {
+
+DecompressFileReader::DecompressFileReader(
+        RuntimeProfile* profile, FileReader* file_reader,
+        Decompressor* decompressor, int max_chunks) :
+            _profile(profile),
+            _file_reader(file_reader),
+            _decompressor(decompressor),
+            _max_chunks(std::max(max_chunks, 1)),
+            _decompress_done(false),
+            _closed(false),
+            _cur_chunk_pos(0),
+            _bytes_read(0),
+            _bytes_decompressed(0) {
+}
+
+DecompressFileReader::~DecompressFileReader() {
+    close();
+}
+
+Status DecompressFileReader::open() {
+    _decompress_thread = std::thread(&DecompressFileReader::_decompress_worker, this);
+    return Status::OK();
+}
+
+void DecompressFileReader::close() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_closed) {
+            return;
+        }
+        _closed = true;
+    }
+    _chunk_free_cv.notify_all();
+    if (_decompress_thread.joinable()) {
+        _decompress_thread.join();
+    }
+
+    if (_profile != nullptr) {
+        COUNTER_UPDATE(ADD_COUNTER(_profile, "CompressedBytesRead", TUnit::BYTES),
+                       _bytes_read);
+        COUNTER_UPDATE(ADD_TIMER(_profile, "CompressedFileReadTime"),
+                       _read_watch.elapsed_time());
+        COUNTER_UPDATE(ADD_COUNTER(_profile, "BytesDecompressed", TUnit::BYTES),
+                       _bytes_decompressed);
+        COUNTER_UPDATE(ADD_TIMER(_profile, "DecompressTime"),
+                       _decompress_watch.elapsed_time());
+    }
+
+    _ready_chunks.clear();
+    _free_chunks.clear();
+    _cur_chunk.reset();
+}
+
+Status DecompressFileReader::read(uint8_t* buf, size_t* buf_len, bool* eof) {
+    size_t read_len = 0;
+    while (read_len < *buf_len) {
+        if (_cur_chunk == nullptr || _cur_chunk_pos == _cur_chunk->len) {
+            std::unique_lock<std::mutex> l(_lock);
+            if (_cur_chunk != nullptr) {
+                _free_chunks.push_back(std::move(_cur_chunk));
+            }
+            // return what we already have instead of waiting for more
+            if (read_len > 0 && _ready_chunks.empty()) {
+                break;
+            }
+            while (_ready_chunks.empty() && !_decompress_done) {
+                _chunk_ready_cv.wait(l);
+            }
+            if (_ready_chunks.empty()) {
+                RETURN_IF_ERROR(_decompress_status);
+                break;
+            }
+            _cur_chunk = std::move(_ready_chunks.front());
+            _ready_chunks.pop_front();
+            _cur_chunk_pos = 0;
+            _chunk_free_cv.notify_one();
+        }
+
+        size_t copy_len = std::min(*buf_len - read_len, _cur_chunk->len - _cur_chunk_pos);
+        memcpy(buf + read_len, _cur_chunk->data.data() + _cur_chunk_pos, copy_len);
+        read_len += copy_len;
+        _cur_chunk_pos += copy_len;
+    }
+
+    *buf_len = read_len;
+    *eof = (read_len == 0);
+    return Status::OK();
+}
+
+void DecompressFileReader::_decompress_worker() {
+    Status status = _decompress_all();
+    if (!status.ok()) {
+        LOG(WARNING) << "decompress failed: " << status.get_error_msg();
+    }
+
+    std::lock_guard<std::mutex> l(_lock);
+    _decompress_status = status;
+    _decompress_done = true;
+    _chunk_ready_cv.notify_all();
+}
+
+std::unique_ptr<DecompressFileReader::Chunk> DecompressFileReader::_get_free_chunk() {
+    std::unique_lock<std::mutex> l(_lock);
+    while (!_closed && _ready_chunks.size() >= static_cast<size_t>(_max_chunks)) {
+        _chunk_free_cv.wait(l);
+    }
+    if (_closed) {
+        return nullptr;
+    }
+    std::unique_ptr<Chunk> chunk;
+    if (!_free_chunks.empty()) {
+        chunk = std::move(_free_chunks.back());
+        _free_chunks.pop_back();
+    } else {
+        chunk.reset(new Chunk());
+        chunk->data.resize(OUTPUT_CHUNK);
+    }
+    chunk->len = 0;
+    return chunk;
+}
+
+bool DecompressFileReader::_push_chunk(std::unique_ptr<Chunk> chunk) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_closed) {
+        return false;
+    }
+    _ready_chunks.push_back(std::move(chunk));
+    _chunk_ready_cv.notify_one();
+    return true;
+}
+
+// The same decompress loop as PlainTextLineReader::read_line(), except that
+// the decompressed data is handed out by chunks instead of searched for lines.
+Status DecompressFileReader::_decompress_all() {
+    std::vector<uint8_t> input(INPUT_CHUNK);
+    size_t input_pos = 0;
+    size_t input_limit = 0;
+    bool stream_end = true;
+    size_t more_input_bytes = 0;
+    size_t more_output_bytes = 0;
+
+    std::unique_ptr<Chunk> chunk;
+    while (true) {
+        if (chunk == nullptr) {
+            chunk = _get_free_chunk();
+            if (chunk == nullptr) {
+                // closed by reader
+                return Status::OK();
+            }
+        }
+
+        // 1. make sure there is room in the output chunk
+        size_t target = std::max<size_t>(1024, more_output_bytes);
+        if (chunk->data.size() - chunk->len < target) {
+            if (chunk->len > 0) {
+                if (!_push_chunk(std::move(chunk))) {
+                    return Status::OK();
+                }
+                continue;
+            }
+            chunk->data.resize(target);
+        }
+
+        // 2. read from file reader if all input is consumed or more is required
+        if (input_limit == input_pos || more_input_bytes > 0) {
+            if (more_input_bytes == 0) {
+                input_pos = 0;
+                input_limit = 0;
+            } else if (input.size() - input_limit < more_input_bytes) {
+                memmove(input.data(), input.data() + input_pos, input_limit - input_pos);
+                input_limit -= input_pos;
+                input_pos = 0;
+                if (input.size() - input_limit < more_input_bytes) {
+                    input.resize(input_limit + more_input_bytes);
+                }
+            }
+
+            size_t read_len = input.size() - input_limit;
+            bool file_eof = false;
+            _read_watch.start();
+            Status st = _file_reader->read(input.data() + input_limit, &read_len, &file_eof);
+            _read_watch.stop();
+            RETURN_IF_ERROR(st);
+            _bytes_read += read_len;
+
+            if (file_eof || read_len == 0) {
+                if (!stream_end) {
+                    return Status::InternalError(
+                        "Compressed file has been truncated, which is not allowed");
+                }
+                break;
+            }
+            input_limit += read_len;
+
+            if (read_len < more_input_bytes) {
+                // we failed to read enough data, continue to read from file
+                more_input_bytes -= read_len;
+                continue;
+            }
+        }
+
+        // 3. decompress
+        size_t input_read_bytes = 0;
+        size_t decompressed_len = 0;
+        more_input_bytes = 0;
+        more_output_bytes = 0;
+        _decompress_watch.start();
+        Status st = _decompressor->decompress(
+                input.data() + input_pos, input_limit - input_pos, &input_read_bytes,
+                chunk->data.data() + chunk->len, chunk->data.size() - chunk->len,
+                &decompressed_len, &stream_end, &more_input_bytes, &more_output_bytes);
+        _decompress_watch.stop();
+        RETURN_IF_ERROR(st);
+
+        input_pos += input_read_bytes;
+        chunk->len += decompressed_len;
+        _bytes_decompressed += decompressed_len;
+
+        if (input_read_bytes == 0 && more_input_bytes == 0 && more_output_bytes == 0) {
+            std::stringstream ss;
+            ss << "decompress made no progress."
+               << " input_read_bytes: " << input_read_bytes
+               << " decompressed_len: " << decompressed_len;
+            return Status::InternalError(ss.str());
+        }
+    }
+
+    if (chunk != nullptr && chunk->len > 0) {
+        _push_chunk(std::move(chunk));
+    }
+    return Status::OK();
+}
+
+}
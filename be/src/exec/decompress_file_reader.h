@@ -0,0 +1,122 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/status.h"
+#include "exec/file_reader.h"
+#include "util/runtime_profile.h"
+#include "util/stopwatch.hpp"
+
+namespace doris {
+
+class Decompressor;
+
+// A FileReader which returns the decompressed content of another FileReader.
+// Reading and decompressing are done by a background thread, which runs ahead
+// of the caller by at most 'max_chunks' chunks of decompressed data, so that
+// file IO and decompression overlap with the parsing done by the caller.
+//
+// This reader does not own 'file_reader' and 'decompressor', and they must
+// not be used by others until this reader is closed.
+class DecompressFileReader : public FileReader {
+public:
+    DecompressFileReader(RuntimeProfile* profile, FileReader* file_reader,
+                         Decompressor* decompressor, int max_chunks);
+    virtual ~DecompressFileReader();
+
+    // start the background decompress thread
+    virtual Status open() override;
+
+    // Copy decompressed data into 'buf'. Block only when no decompressed data
+    // is ready. 'eof' is set only when all data has been returned.
+    virtual Status read(uint8_t* buf, size_t* buf_len, bool* eof) override;
+
+    virtual Status readat(int64_t position, int64_t nbytes,
+                          int64_t* bytes_read, void* out) override {
+        return Status::NotSupported("Not supported readat");
+    }
+    virtual int64_t size() override {
+        return -1;
+    }
+    virtual Status seek(int64_t position) override {
+        return Status::NotSupported("Not supported seek");
+    }
+    virtual Status tell(int64_t* position) override {
+        return Status::NotSupported("Not supported tell");
+    }
+
+    // stop and join the background thread
+    virtual void close() override;
+    virtual bool closed() override {
+        return _closed;
+    }
+
+private:
+    struct Chunk {
+        std::vector<uint8_t> data;
+        size_t len = 0;
+    };
+
+    void _decompress_worker();
+    Status _decompress_all();
+    // get an empty chunk to decompress into, waiting while 'max_chunks'
+    // chunks are waiting to be read. Return nullptr if this reader is closed.
+    std::unique_ptr<Chunk> _get_free_chunk();
+    // return false if this reader is closed
+    bool _push_chunk(std::unique_ptr<Chunk> chunk);
+
+private:
+    RuntimeProfile* _profile;
+    FileReader* _file_reader;
+    Decompressor* _decompressor;
+    int _max_chunks;
+
+    std::mutex _lock;
+    std::condition_variable _chunk_ready_cv;
+    std::condition_variable _chunk_free_cv;
+    // decompressed chunks waiting to be read
+    std::deque<std::unique_ptr<Chunk>> _ready_chunks;
+    // chunks already read, which are reused by the decompress thread
+    std::vector<std::unique_ptr<Chunk>> _free_chunks;
+    // set by the decompress thread when it finishes
+    bool _decompress_done;
+    Status _decompress_status;
+    bool _closed;
+
+    // the chunk being read by the caller
+    std::unique_ptr<Chunk> _cur_chunk;
+    size_t _cur_chunk_pos;
+
+    std::thread _decompress_thread;
+
+    // updated by the decompress thread and reported when closed,
+    // because counters are not thread safe
+    int64_t _bytes_read;
+    int64_t _bytes_decompressed;
+    MonotonicStopWatch _read_watch;
+    MonotonicStopWatch _decompress_watch;
+};
+
+}
@@ -216,6 +216,68 @@ static bool is_literal_node(const Expr* expr) {
     }
 }
 
+// Negate 'predicate' in place. NOT of a compound predicate is pushed down to its
+// children by De Morgan's laws. Return false if it can not be negated.
+static bool negate_predicate(ExtPredicate* predicate) {
+    switch (predicate->node_type) {
+        case TExprNodeType::BINARY_PRED: {
+            ExtBinaryPredicate* binary_predicate = (ExtBinaryPredicate*)predicate;
+            switch (binary_predicate->op) {
+                case TExprOpcode::EQ: binary_predicate->op = TExprOpcode::NE; return true;
+                case TExprOpcode::NE: binary_predicate->op = TExprOpcode::EQ; return true;
+                case TExprOpcode::LT: binary_predicate->op = TExprOpcode::GE; return true;
+                case TExprOpcode::LE: binary_predicate->op = TExprOpcode::GT; return true;
+                case TExprOpcode::GT: binary_predicate->op = TExprOpcode::LE; return true;
+                case TExprOpcode::GE: binary_predicate->op = TExprOpcode::LT; return true;
+                default: return false;
+            }
+        }
+        case TExprNodeType::IN_PRED: {
+            ExtInPredicate* in_predicate = (ExtInPredicate*)predicate;
+            in_predicate->is_not_in = !in_predicate->is_not_in;
+            return true;
+        }
+        case TExprNodeType::IS_NULL_PRED: {
+            ExtIsNullPredicate* is_null_predicate = (ExtIsNullPredicate*)predicate;
+            is_null_predicate->is_not_null = !is_null_predicate->is_not_null;
+            return true;
+        }
+        case TExprNodeType::COMPOUND_PRED: {
+            ExtCompoundPredicate* compound_predicate = (ExtCompoundPredicate*)predicate;
+            for (auto child : compound_predicate->children) {
+                if (!negate_predicate(child)) {
+                    return false;
+                }
+            }
+            compound_predicate->op = (compound_predicate->op == TExprOpcode::COMPOUND_AND
+                                      ? TExprOpcode::COMPOUND_OR : TExprOpcode::COMPOUND_AND);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+Status EsPredicate::build_one_predicate(const Expr* expr, ExtPredicate** predicate) {
+    std::vector<ExtPredicate*> disjuncts;
+    disjuncts.swap(_disjuncts);
+    Status status = build_disjuncts_list(expr);
+    disjuncts.swap(_disjuncts);
+    if (!status.ok()) {
+        for (auto disjunct : disjuncts) {
+            delete disjunct;
+        }
+        return status;
+    }
+    if (disjuncts.size() == 1) {
+        *predicate = disjuncts[0];
+    } else {
+        *predicate = new ExtCompoundPredicate(
+            TExprNodeType::COMPOUND_PRED, TExprOpcode::COMPOUND_OR, disjuncts);
+    }
+    return Status::OK();
+}
+
 Status EsPredicate::build_disjuncts_list(const Expr* conjunct) {
     if (TExprNodeType::BINARY_PRED == conjunct->node_type()) {
         if (conjunct->children().size() != 2) {
@@ -282,6 +344,26 @@ Status EsPredicate::build_disjuncts_list(const Expr* conjunct) {
         return Status::OK();
     } 
 
+    if (TExprNodeType::FUNCTION_CALL == conjunct->node_type()
+            && (conjunct->fn().name.function_name == "is_null_pred"
+                || conjunct->fn().name.function_name == "is_not_null_pred")) {
+        if (TExprNodeType::SLOT_REF != conjunct->get_child(0)->node_type()) {
+            return Status::InternalError("build disjuncts failed: no SLOT_REF child");
+        }
+        const SlotDescriptor* slot_desc = get_slot_desc((const SlotRef*)conjunct->get_child(0));
+        if (slot_desc == nullptr) {
+            return Status::InternalError("build disjuncts failed: slot_desc is null");
+        }
+
+        ExtPredicate* predicate = new ExtIsNullPredicate(
+                    TExprNodeType::IS_NULL_PRED,
+                    slot_desc->col_name(),
+                    slot_desc->type(),
+                    conjunct->fn().name.function_name == "is_not_null_pred");
+        _disjuncts.push_back(predicate);
+        return Status::OK();
+    }
+
     if (TExprNodeType::FUNCTION_CALL == conjunct->node_type()) {
         std::string fname = conjunct->fn().name.function_name;
         if (fname != "like") {
@@ -370,6 +452,38 @@ Status EsPredicate::build_disjuncts_list(const Expr* conjunct) {
         return Status::OK();
     } 
     
+    if (TExprNodeType::COMPOUND_PRED == conjunct->node_type()
+            && TExprOpcode::COMPOUND_NOT == conjunct->op()) {
+        ExtPredicate* predicate = nullptr;
+        RETURN_IF_ERROR(build_one_predicate(conjunct->get_child(0), &predicate));
+        if (!negate_predicate(predicate)) {
+            delete predicate;
+            return Status::InternalError("build disjuncts failed: predicate can not be negated");
+        }
+        _disjuncts.push_back(predicate);
+        return Status::OK();
+    }
+
+    if (TExprNodeType::COMPOUND_PRED == conjunct->node_type()
+            && TExprOpcode::COMPOUND_AND == conjunct->op()) {
+        // top level AND are split into conjuncts by FE, so this is nested in OR or NOT
+        std::vector<ExtPredicate*> children;
+        for (int i = 0; i < 2; ++i) {
+            ExtPredicate* child = nullptr;
+            Status status = build_one_predicate(conjunct->get_child(i), &child);
+            if (!status.ok()) {
+                for (auto built_child : children) {
+                    delete built_child;
+                }
+                return status;
+            }
+            children.push_back(child);
+        }
+        _disjuncts.push_back(new ExtCompoundPredicate(
+                TExprNodeType::COMPOUND_PRED, TExprOpcode::COMPOUND_AND, children));
+        return Status::OK();
+    }
+
     if (TExprNodeType::COMPOUND_PRED == conjunct->node_type()) {
         if (TExprOpcode::COMPOUND_OR != conjunct->op()) {
             return Status::InternalError("build disjuncts failed: op is not COMPOUND_OR");
@@ -81,6 +81,8 @@ struct ExtColumnDesc {
 struct ExtPredicate {
     ExtPredicate(TExprNodeType::type node_type) : node_type(node_type) {
     }
+    virtual ~ExtPredicate() {
+    }
 
     TExprNodeType::type node_type;
 };
@@ -141,8 +143,7 @@ struct ExtIsNullPredicate : public ExtPredicate {
                 TExprNodeType::type node_type,
                 const std::string& name, 
                 const TypeDescriptor& type,
-                bool is_not_null,
-                ExtLiteral value) :
+                bool is_not_null) :
         ExtPredicate(node_type),
         col(name, type),
         is_not_null(is_not_null) {
@@ -168,6 +169,27 @@ struct ExtFunction : public ExtPredicate {
     const std::vector<ExtLiteral> values;
 };
 
+// AND or OR of predicates which are nested in other predicates,
+// e.g. (k1 = 1 and k2 = 2) or k3 = 3, which owns its children
+struct ExtCompoundPredicate : public ExtPredicate {
+    ExtCompoundPredicate(
+                TExprNodeType::type node_type,
+                TExprOpcode::type op,
+                const std::vector<ExtPredicate*>& children) :
+        ExtPredicate(node_type),
+        op(op),
+        children(children) {
+    }
+    ~ExtCompoundPredicate() override {
+        for (auto child : children) {
+            delete child;
+        }
+    }
+
+    TExprOpcode::type op;
+    std::vector<ExtPredicate*> children;
+};
+
 class EsPredicate {
 public:
     EsPredicate(ExprContext* context, const TupleDescriptor* tuple_desc);
@@ -185,6 +207,9 @@ public:
 
 private:
     Status build_disjuncts_list(const Expr* conjunct);
+    // build 'expr' into one predicate, disjuncts of an OR are wrapped
+    // into a compound predicate
+    Status build_one_predicate(const Expr* expr, ExtPredicate** predicate);
     bool is_match_func(const Expr* conjunct);
     const SlotDescriptor* get_slot_desc(const SlotRef* slotRef);
 
@@ -17,6 +17,9 @@
 
 #include "exec/es/es_query_builder.h"
 
+#include <map>
+#include <utility>
+
 #include <boost/algorithm/string/replace.hpp>
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/stringbuffer.h"
@@ -71,31 +74,47 @@ void TermQueryBuilder::to_json(rapidjson::Document* document, rapidjson::Value*
 
 RangeQueryBuilder::RangeQueryBuilder(const ExtBinaryPredicate& range_predicate) {
     _field = range_predicate.col.name;
-    _value = range_predicate.value.to_string();
-    _op = range_predicate.op;
+    _bounds.emplace_back(range_predicate.op, range_predicate.value.to_string());
+}
+
+static bool is_lower_bound(TExprOpcode::type op) {
+    return op == TExprOpcode::GT || op == TExprOpcode::GE;
+}
+
+bool RangeQueryBuilder::merge(const ExtBinaryPredicate& range_predicate) {
+    DCHECK(range_predicate.col.name == _field);
+    for (auto& bound : _bounds) {
+        if (is_lower_bound(bound.first) == is_lower_bound(range_predicate.op)) {
+            return false;
+        }
+    }
+    _bounds.emplace_back(range_predicate.op, range_predicate.value.to_string());
+    return true;
 }
 
 void RangeQueryBuilder::to_json(rapidjson::Document* document, rapidjson::Value* query) {
     rapidjson::Document::AllocatorType& allocator = document->GetAllocator();
     rapidjson::Value field_value(_field.c_str(), allocator);
-    rapidjson::Value value(_value.c_str(), allocator);
     rapidjson::Value op_node(rapidjson::kObjectType);
     op_node.SetObject();
-    switch (_op) {
-        case TExprOpcode::LT:
-            op_node.AddMember("lt", value, allocator);
-            break;
-        case TExprOpcode::LE:
-            op_node.AddMember("le", value, allocator);
-            break;
-        case TExprOpcode::GT:
-            op_node.AddMember("gt", value, allocator);
-            break;
-        case TExprOpcode::GE:
-            op_node.AddMember("ge", value, allocator);
-            break;
-        default:
-            break;
+    for (auto& bound : _bounds) {
+        rapidjson::Value value(bound.second.c_str(), allocator);
+        switch (bound.first) {
+            case TExprOpcode::LT:
+                op_node.AddMember("lt", value, allocator);
+                break;
+            case TExprOpcode::LE:
+                op_node.AddMember("lte", value, allocator);
+                break;
+            case TExprOpcode::GT:
+                op_node.AddMember("gt", value, allocator);
+                break;
+            case TExprOpcode::GE:
+                op_node.AddMember("gte", value, allocator);
+                break;
+            default:
+                break;
+        }
     }
     rapidjson::Value field_node(rapidjson::kObjectType);
     field_node.SetObject();
@@ -103,6 +122,19 @@ void RangeQueryBuilder::to_json(rapidjson::Document* document, rapidjson::Value*
     query->AddMember("range", field_node, allocator);
 }
 
+ExistsQueryBuilder::ExistsQueryBuilder(const ExtIsNullPredicate& is_null_predicate) {
+    _field = is_null_predicate.col.name;
+}
+
+void ExistsQueryBuilder::to_json(rapidjson::Document* document, rapidjson::Value* query) {
+    rapidjson::Document::AllocatorType& allocator = document->GetAllocator();
+    rapidjson::Value exists_node(rapidjson::kObjectType);
+    exists_node.SetObject();
+    rapidjson::Value field_value(_field.c_str(), allocator);
+    exists_node.AddMember("field", field_value, allocator);
+    query->AddMember("exists", exists_node, allocator);
+}
+
 void WildCardQueryBuilder::to_json(rapidjson::Document* document, rapidjson::Value* query) {
     rapidjson::Document::AllocatorType& allocator = document->GetAllocator();
     rapidjson::Value term_node(rapidjson::kObjectType);
@@ -170,66 +202,84 @@ BooleanQueryBuilder::~BooleanQueryBuilder() {
 
 BooleanQueryBuilder::BooleanQueryBuilder(const std::vector<ExtPredicate*>& predicates) {
     for (auto predicate : predicates) {
-        switch (predicate->node_type) {
-            case TExprNodeType::BINARY_PRED: {
-                ExtBinaryPredicate* binary_predicate = (ExtBinaryPredicate*)predicate;
-                switch (binary_predicate->op) {
-                    case TExprOpcode::EQ: {
-                        TermQueryBuilder* term_query = new TermQueryBuilder(*binary_predicate);
-                        _should_clauses.push_back(term_query);
-                        break;
-                        }
-                    case TExprOpcode::NE:{ // process NE
-                        TermQueryBuilder* term_query = new TermQueryBuilder(*binary_predicate);
-                        BooleanQueryBuilder* bool_query = new BooleanQueryBuilder();
-                        bool_query->must_not(term_query);
-                        _should_clauses.push_back(bool_query);
-                        break;
-                        }
-                    case TExprOpcode::LT:
-                    case TExprOpcode::LE:
-                    case TExprOpcode::GT:
-                    case TExprOpcode::GE: {
-                        RangeQueryBuilder* range_query = new RangeQueryBuilder(*binary_predicate);
-                        _should_clauses.push_back(range_query);
-                        break;
-                        }
-                    default:
-                        break;
+        QueryBuilder* query = to_query_builder(predicate);
+        if (query != nullptr) {
+            _should_clauses.push_back(query);
+        }
+    }
+}
+
+QueryBuilder* BooleanQueryBuilder::to_query_builder(const ExtPredicate* predicate) {
+    switch (predicate->node_type) {
+        case TExprNodeType::BINARY_PRED: {
+            ExtBinaryPredicate* binary_predicate = (ExtBinaryPredicate*)predicate;
+            switch (binary_predicate->op) {
+                case TExprOpcode::EQ: {
+                    return new TermQueryBuilder(*binary_predicate);
                 }
-                break;
+                case TExprOpcode::NE: { // process NE
+                    TermQueryBuilder* term_query = new TermQueryBuilder(*binary_predicate);
+                    BooleanQueryBuilder* bool_query = new BooleanQueryBuilder();
+                    bool_query->must_not(term_query);
+                    return bool_query;
+                }
+                case TExprOpcode::LT:
+                case TExprOpcode::LE:
+                case TExprOpcode::GT:
+                case TExprOpcode::GE: {
+                    return new RangeQueryBuilder(*binary_predicate);
+                }
+                default:
+                    return nullptr;
             }
-            case TExprNodeType::IN_PRED: {
-                ExtInPredicate* in_predicate = (ExtInPredicate *)predicate;
-                    bool is_not_in = in_predicate->is_not_in;
-                    if (is_not_in) { // process not in predicate
-                        TermsInSetQueryBuilder* terms_predicate = new TermsInSetQueryBuilder(*in_predicate);
-                        BooleanQueryBuilder* bool_query = new BooleanQueryBuilder();
-                        bool_query->must_not(terms_predicate);
-                        _should_clauses.push_back(bool_query);
-                    } else { // process in predicate 
-                        TermsInSetQueryBuilder* terms_query= new TermsInSetQueryBuilder(*in_predicate);
-                        _should_clauses.push_back(terms_query);
-                    }
-                    break;
+        }
+        case TExprNodeType::IN_PRED: {
+            ExtInPredicate* in_predicate = (ExtInPredicate *)predicate;
+            TermsInSetQueryBuilder* terms_query = new TermsInSetQueryBuilder(*in_predicate);
+            if (in_predicate->is_not_in) { // process not in predicate
+                BooleanQueryBuilder* bool_query = new BooleanQueryBuilder();
+                bool_query->must_not(terms_query);
+                return bool_query;
             }
-            case TExprNodeType::LIKE_PRED: {
-                ExtLikePredicate* like_predicate = (ExtLikePredicate *)predicate;
-                WildCardQueryBuilder* wild_card_query = new WildCardQueryBuilder(*like_predicate);
-                _should_clauses.push_back(wild_card_query);
-                break;
+            return terms_query;
+        }
+        case TExprNodeType::LIKE_PRED: {
+            ExtLikePredicate* like_predicate = (ExtLikePredicate *)predicate;
+            return new WildCardQueryBuilder(*like_predicate);
+        }
+        case TExprNodeType::IS_NULL_PRED: {
+            ExtIsNullPredicate* is_null_predicate = (ExtIsNullPredicate *)predicate;
+            ExistsQueryBuilder* exists_query = new ExistsQueryBuilder(*is_null_predicate);
+            if (!is_null_predicate->is_not_null) { // process is null predicate
+                BooleanQueryBuilder* bool_query = new BooleanQueryBuilder();
+                bool_query->must_not(exists_query);
+                return bool_query;
             }
-            case TExprNodeType::FUNCTION_CALL: {
-                ExtFunction* function_predicate = (ExtFunction *)predicate;
-                if ("esquery" == function_predicate->func_name ) {
-                    ESQueryBuilder* es_query = new ESQueryBuilder(*function_predicate);
-                    _should_clauses.push_back(es_query);
-                };
-                break;
+            return exists_query;
+        }
+        case TExprNodeType::COMPOUND_PRED: {
+            ExtCompoundPredicate* compound_predicate = (ExtCompoundPredicate *)predicate;
+            if (compound_predicate->op == TExprOpcode::COMPOUND_OR) {
+                return new BooleanQueryBuilder(compound_predicate->children);
             }
-            default:
-                break;
+            BooleanQueryBuilder* bool_query = new BooleanQueryBuilder();
+            for (auto child : compound_predicate->children) {
+                QueryBuilder* child_query = to_query_builder(child);
+                if (child_query != nullptr) {
+                    bool_query->must(child_query);
+                }
+            }
+            return bool_query;
+        }
+        case TExprNodeType::FUNCTION_CALL: {
+            ExtFunction* function_predicate = (ExtFunction *)predicate;
+            if ("esquery" == function_predicate->func_name ) {
+                return new ESQueryBuilder(*function_predicate);
+            }
+            return nullptr;
         }
+        default:
+            return nullptr;
     }
 }
 
@@ -312,45 +362,50 @@ Status BooleanQueryBuilder::check_es_query(const ExtFunction& extFunction) {
     return Status::OK();
 }
 
+bool BooleanQueryBuilder::is_valid(const ExtPredicate* predicate) {
+    switch (predicate->node_type) {
+        case TExprNodeType::BINARY_PRED: {
+            ExtBinaryPredicate* binary_predicate = (ExtBinaryPredicate*)predicate;
+            TExprOpcode::type op = binary_predicate->op;
+            return op == TExprOpcode::EQ || op == TExprOpcode::NE
+                || op == TExprOpcode::LT || op == TExprOpcode::LE
+                || op == TExprOpcode::GT || op == TExprOpcode::GE;
+        }
+        case TExprNodeType::LIKE_PRED:
+        case TExprNodeType::IN_PRED:
+        case TExprNodeType::IS_NULL_PRED: {
+            return true;
+        }
+        case TExprNodeType::COMPOUND_PRED: {
+            ExtCompoundPredicate* compound_predicate = (ExtCompoundPredicate *)predicate;
+            for (auto child : compound_predicate->children) {
+                if (!is_valid(child)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case TExprNodeType::FUNCTION_CALL: {
+            ExtFunction* function_predicate = (ExtFunction *)predicate;
+            if ("esquery" == function_predicate->func_name ) {
+                return check_es_query(*function_predicate).ok();
+            }
+            return false;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
 void BooleanQueryBuilder::validate(const std::vector<EsPredicate*>& espredicates, std::vector<bool>* result) {
     int conjunct_size = espredicates.size();
     result->reserve(conjunct_size);
     for (auto espredicate : espredicates) {
         bool flag = true;
         for (auto predicate : espredicate->get_predicate_list()) {
-            switch (predicate->node_type) {
-                case TExprNodeType::BINARY_PRED: {
-                    ExtBinaryPredicate* binary_predicate = (ExtBinaryPredicate*)predicate;
-                    TExprOpcode::type op = binary_predicate->op;
-                    if (op != TExprOpcode::EQ && op != TExprOpcode::NE 
-                        && op != TExprOpcode::LT && op != TExprOpcode::LE
-                        && op != TExprOpcode::GT && op != TExprOpcode::GE) {
-                        flag = false;
-                    }
-                    break;
-                }
-                case TExprNodeType::LIKE_PRED:
-                case TExprNodeType::IN_PRED: {
-                    break;
-                }
-                case TExprNodeType::FUNCTION_CALL: {
-                    ExtFunction* function_predicate = (ExtFunction *)predicate;
-                    if ("esquery" == function_predicate->func_name ) {
-                        Status st = check_es_query(*function_predicate);
-                        if (!st.ok()) {
-                            flag = false;
-                        }
-                    } else {
-                       flag = false;
-		            }
-                    break;
-                }
-                default: {
-                    flag = false;
-                    break;
-                }
-            }
-            if (!flag) {
+            if (!is_valid(predicate)) {
+                flag = false;
                 break;
             }
         }
@@ -358,6 +413,15 @@ void BooleanQueryBuilder::validate(const std::vector<EsPredicate*>& espredicates
     }
 }
 
+static bool is_range_predicate(const ExtPredicate* predicate) {
+    if (predicate->node_type != TExprNodeType::BINARY_PRED) {
+        return false;
+    }
+    TExprOpcode::type op = ((const ExtBinaryPredicate*)predicate)->op;
+    return op == TExprOpcode::LT || op == TExprOpcode::LE
+        || op == TExprOpcode::GT || op == TExprOpcode::GE;
+}
+
 void BooleanQueryBuilder::to_query(const std::vector<EsPredicate*>& predicates, rapidjson::Document* root, rapidjson::Value* query) {
     if (predicates.size() == 0) {
         MatchAllQueryBuilder match_all_query;
@@ -366,10 +430,27 @@ void BooleanQueryBuilder::to_query(const std::vector<EsPredicate*>& predicates,
     }
     root->SetObject();
     BooleanQueryBuilder bool_query;
+    // conjuncts of one range bound on the same field, e.g. k > 1 and k < 10,
+    // are merged into one range query
+    std::map<std::string, RangeQueryBuilder*> field_ranges;
     for (auto es_predicate : predicates) {
-        vector<ExtPredicate*> or_predicates = es_predicate->get_predicate_list();
+        const vector<ExtPredicate*>& or_predicates = es_predicate->get_predicate_list();
+        if (or_predicates.size() == 1 && is_range_predicate(or_predicates[0])) {
+            const ExtBinaryPredicate* range_predicate = (const ExtBinaryPredicate*)or_predicates[0];
+            auto iter = field_ranges.find(range_predicate->col.name);
+            if (iter != field_ranges.end() && iter->second->merge(*range_predicate)) {
+                continue;
+            }
+            RangeQueryBuilder* range_query = new RangeQueryBuilder(*range_predicate);
+            BooleanQueryBuilder* inner_bool_query = new BooleanQueryBuilder();
+            inner_bool_query->should(range_query);
+            bool_query.must(inner_bool_query);
+            field_ranges[range_predicate->col.name] = range_query;
+            continue;
+        }
         BooleanQueryBuilder* inner_bool_query = new BooleanQueryBuilder(or_predicates);
         bool_query.must(inner_bool_query);
     }
-    bool_query.to_json(root, query);}
+    bool_query.to_json(root, query);
+}
 }
@@ -63,10 +63,22 @@ class RangeQueryBuilder : public QueryBuilder {
 public:
     RangeQueryBuilder(const ExtBinaryPredicate& range_predicate);
     void to_json(rapidjson::Document* document, rapidjson::Value* query) override;
+    // merge the bound of another range predicate of the same field, e.g. field < value2.
+    // return false if this query already has a bound of the same side
+    bool merge(const ExtBinaryPredicate& range_predicate);
+private:
+    std::string _field;
+    std::vector<std::pair<TExprOpcode::type, std::string>> _bounds;
+};
+
+// process is null predicate: field is [not] null
+class ExistsQueryBuilder : public QueryBuilder {
+
+public:
+    ExistsQueryBuilder(const ExtIsNullPredicate& is_null_predicate);
+    void to_json(rapidjson::Document* document, rapidjson::Value* query) override;
 private:
     std::string _field;
-    std::string _value;
-    TExprOpcode::type _op;
 };
 
 // process in predicate :  field in [value1, value2]
@@ -114,6 +126,10 @@ public:
     static void validate(const std::vector<EsPredicate*>& espredicates, std::vector<bool>* result);
 
 private:
+    // create query of one predicate, return nullptr if it is not supported
+    static QueryBuilder* to_query_builder(const ExtPredicate* predicate);
+    static bool is_valid(const ExtPredicate* predicate);
+
     // add child query
     void should(QueryBuilder* filter);
     void filter(QueryBuilder* filter);
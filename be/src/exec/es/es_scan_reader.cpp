@@ -26,7 +26,7 @@
 #include "exec/es/es_scroll_query.h"
 
 namespace doris {
-const std::string REUQEST_SCROLL_FILTER_PATH = "filter_path=_scroll_id,hits.hits._source,hits.total,_id,hits.hits._source.fields";
+const std::string REUQEST_SCROLL_FILTER_PATH = "filter_path=_scroll_id,hits.hits._source,hits.total,_id,hits.hits._source.fields,hits.hits.fields";
 const std::string REQUEST_SCROLL_PATH = "_scroll";
 const std::string REQUEST_PREFERENCE_PREFIX = "&preference=_shards:";
 const std::string REQUEST_SEARCH_SCROLL_PATH = "/_search/scroll";
@@ -51,6 +51,8 @@ ESScanReader::ESScanReader(const std::string& target, const std::map<std::string
     }
     std::string batch_size_str = props.at(KEY_BATCH_SIZE);
     _batch_size = atoi(batch_size_str.c_str());
+    auto iter = props.find(KEY_DOC_VALUE_MODE);
+    _doc_value_mode = (iter != props.end() && iter->second == "true");
     _init_scroll_url = _target + REQUEST_SEPARATOR + _index + REQUEST_SEPARATOR + _type + "/_search?scroll=" + REQUEST_SCROLL_TIME + REQUEST_PREFERENCE_PREFIX + _shards + "&" + REUQEST_SCROLL_FILTER_PATH;
     _next_scroll_url = _target + REQUEST_SEARCH_SCROLL_PATH + "?" + REUQEST_SCROLL_FILTER_PATH;
     _eos = false;
@@ -85,7 +87,7 @@ Status ESScanReader::get_next(bool* scan_eos, std::unique_ptr<ScrollParser>& scr
     }
 
     if (_is_first) {
-        response = _cached_response;
+        response = std::move(_cached_response);
         _is_first = false;
     } else {
         RETURN_IF_ERROR(_network_client.init(_next_scroll_url));
@@ -111,8 +113,8 @@ Status ESScanReader::get_next(bool* scan_eos, std::unique_ptr<ScrollParser>& scr
         }
     }
 
-    scroll_parser.reset(new ScrollParser());
-    Status status = scroll_parser->parse(response);
+    scroll_parser.reset(new ScrollParser(_doc_value_mode));
+    Status status = scroll_parser->parse(std::move(response));
     if (!status.ok()){
         _eos = true;
         LOG(WARNING) << status.get_error_msg();
@@ -39,6 +39,12 @@ public:
     static constexpr const char* KEY_SHARD = "shard_id";
     static constexpr const char* KEY_QUERY = "query";
     static constexpr const char* KEY_BATCH_SIZE = "batch_size";
+    // scan the documents of a shard by several slices,
+    // 'slice_id' of 'slice_max' is scanned by this reader
+    static constexpr const char* KEY_SLICE_ID = "slice_id";
+    static constexpr const char* KEY_SLICE_MAX = "slice_max";
+    // "true" to fetch docvalue_fields instead of _source
+    static constexpr const char* KEY_DOC_VALUE_MODE = "doc_value_mode";
     ESScanReader(const std::string& target, const std::map<std::string, std::string>& props);
     ~ESScanReader();
 
@@ -67,6 +73,7 @@ private:
     std::string _next_scroll_url;
     bool _eos;
     int _batch_size;
+    bool _doc_value_mode;
 
     std::string _cached_response;
 };
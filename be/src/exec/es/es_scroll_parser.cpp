@@ -33,6 +33,7 @@ static const char* FIELD_SCROLL_ID = "_scroll_id";
 static const char* FIELD_HITS = "hits";
 static const char* FIELD_INNER_HITS = "hits";
 static const char* FIELD_SOURCE = "_source";
+static const char* FIELD_DOC_VALUES = "fields";
 static const char* FIELD_TOTAL = "total";
 
 static const string ERROR_INVALID_COL_DATA = "Data source returned inconsistent column data. "
@@ -77,9 +78,9 @@ static Status get_int_value(const rapidjson::Value &col, PrimitiveType type, voi
     RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
     StringParser::ParseResult result;
-    const std::string& val = col.GetString();
+    const char* val = col.GetString();
     size_t len = col.GetStringLength();
-    T v = StringParser::string_to_int<T>(val.c_str(), len, &result);
+    T v = StringParser::string_to_int<T>(val, len, &result);
     RETURN_ERROR_IF_PARSING_FAILED(result, type);
 
     if (sizeof(T) < 16) {
@@ -104,30 +105,36 @@ static Status get_float_value(const rapidjson::Value &col, PrimitiveType type, v
     RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
     StringParser::ParseResult result;
-    const std::string& val = col.GetString();
+    const char* val = col.GetString();
     size_t len = col.GetStringLength();
-    T v = StringParser::string_to_float<T>(val.c_str(), len, &result);
+    T v = StringParser::string_to_float<T>(val, len, &result);
     RETURN_ERROR_IF_PARSING_FAILED(result, type);
     *reinterpret_cast<T*>(slot) = v;
 
     return Status::OK();
 }
 
-ScrollParser::ScrollParser() :
+ScrollParser::ScrollParser(bool doc_value_mode) :
+    _doc_value_mode(doc_value_mode),
     _scroll_id(""),
     _total(0),
     _size(0),
-    _line_index(0) {
+    _line_index(0),
+    _inner_hits_node(nullptr) {
 }
 
 ScrollParser::~ScrollParser() {
 }
 
-Status ScrollParser::parse(const std::string& scroll_result) {
-    _document_node.Parse(scroll_result.c_str());
+Status ScrollParser::parse(std::string&& scroll_result) {
+    _response = std::move(scroll_result);
+    // parsing in place modifies the response, so log it before
+    VLOG(3) << "es scroll response: " << _response;
+    _document_node.ParseInsitu(&_response[0]);
     if (_document_node.HasParseError()) {
         std::stringstream ss;
-        ss << "Parsing json error, json is: " << scroll_result;
+        ss << "Parsing json error, error code: " << _document_node.GetParseError()
+           << ", offset: " << _document_node.GetErrorOffset();
         return Status::InternalError(ss.str());
     }
 
@@ -151,9 +158,8 @@ Status ScrollParser::parse(const std::string& scroll_result) {
         return Status::InternalError("inner hits node is not an array");
     }
 
-    rapidjson::Document::AllocatorType& a = _document_node.GetAllocator();
-    _inner_hits_node.CopyFrom(inner_hits_node, a);
-    _size = _inner_hits_node.Size();
+    _inner_hits_node = &inner_hits_node;
+    _size = _inner_hits_node->Size();
 
     return Status::OK();
 }
@@ -177,8 +183,18 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc,
         return Status::OK();
     }
 
-    const rapidjson::Value& obj = _inner_hits_node[_line_index++];
-    const rapidjson::Value& line = obj[FIELD_SOURCE];
+    const rapidjson::Value& obj = (*_inner_hits_node)[_line_index++];
+    // in doc value mode, a document without any of the fields has no 'fields'
+    static const rapidjson::Value empty_line(rapidjson::kObjectType);
+    const rapidjson::Value* line_node = &empty_line;
+    rapidjson::Value::ConstMemberIterator line_itr =
+        obj.FindMember(_doc_value_mode ? FIELD_DOC_VALUES : FIELD_SOURCE);
+    if (line_itr != obj.MemberEnd()) {
+        line_node = &line_itr->value;
+    } else if (!_doc_value_mode) {
+        return Status::InternalError("Parse inner hits failed");
+    }
+    const rapidjson::Value& line = *line_node;
     if (!line.IsObject()) {
         return Status::InternalError("Parse inner hits failed");
     }
@@ -197,9 +213,18 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc,
             tuple->set_null(slot_desc->null_indicator_offset());
             continue;
         }
+        const rapidjson::Value* col_node = &itr->value;
+        if (_doc_value_mode) {
+            // doc values of a field are always an array
+            if (!col_node->IsArray() || col_node->Empty()) {
+                tuple->set_null(slot_desc->null_indicator_offset());
+                continue;
+            }
+            col_node = &(*col_node)[0];
+        }
 
         tuple->set_not_null(slot_desc->null_indicator_offset());
-        const rapidjson::Value &col = line[col_name];
+        const rapidjson::Value &col = *col_node;
 
         void* slot = tuple->get_slot(slot_desc->tuple_offset());
         PrimitiveType type = slot_desc->type().type;
@@ -209,7 +234,7 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc,
                 RETURN_ERROR_IF_COL_IS_ARRAY(col, type);
                 RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
-                const std::string& val = col.GetString();
+                const char* val = col.GetString();
                 size_t val_size = col.GetStringLength();
                 char* buffer = reinterpret_cast<char*>(tuple_pool->try_allocate_unaligned(val_size));
                 if (UNLIKELY(buffer == NULL)) {
@@ -217,7 +242,7 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc,
                                 val_size, "string slot");
                     return tuple_pool->mem_tracker()->MemLimitExceeded(NULL, details, val_size);
                 }
-                memcpy(buffer, val.data(), val_size);
+                memcpy(buffer, val, val_size);
                 reinterpret_cast<StringValue*>(slot)->ptr = buffer;
                 reinterpret_cast<StringValue*>(slot)->len = val_size;
                 break;
@@ -293,11 +318,11 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc,
                 RETURN_ERROR_IF_COL_IS_ARRAY(col, type);
                 RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
-                const std::string& val = col.GetString();
+                const char* val = col.GetString();
                 size_t val_size = col.GetStringLength();
                 StringParser::ParseResult result;
                 bool b = 
-                    StringParser::string_to_bool(val.c_str(), val_size, &result);
+                    StringParser::string_to_bool(val, val_size, &result);
                 RETURN_ERROR_IF_PARSING_FAILED(result, type);
                 *reinterpret_cast<int8_t*>(slot) = b;
                 break;
@@ -306,7 +331,9 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc,
             case TYPE_DATE:
             case TYPE_DATETIME: {
                 if (col.IsNumber()) {
-                    if (!reinterpret_cast<DateTimeValue*>(slot)->from_unixtime(col.GetInt64(), "+08:00")) {
+                    // doc values of date are milliseconds since epoch
+                    int64_t seconds = _doc_value_mode ? col.GetInt64() / 1000 : col.GetInt64();
+                    if (!reinterpret_cast<DateTimeValue*>(slot)->from_unixtime(seconds, "+08:00")) {
                         return Status::InternalError(strings::Substitute(ERROR_INVALID_COL_DATA, type_to_string(type)));
                     }
 
@@ -322,9 +349,9 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc,
                 RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
                 DateTimeValue* ts_slot = reinterpret_cast<DateTimeValue*>(slot);
-                const std::string& val = col.GetString();
+                const char* val = col.GetString();
                 size_t val_size = col.GetStringLength();
-                if (!ts_slot->from_date_str(val.c_str(), val_size)) {
+                if (!ts_slot->from_date_str(val, val_size)) {
                     return Status::InternalError(strings::Substitute(ERROR_INVALID_COL_DATA, type_to_string(type)));
                 }
 
@@ -30,10 +30,13 @@ class Status;
 class ScrollParser {
 
 public:
-    ScrollParser();
+    // 'doc_value_mode' is true if documents are fetched by docvalue_fields
+    ScrollParser(bool doc_value_mode = false);
     ~ScrollParser();
 
-    Status parse(const std::string& scroll_result);
+    // the response is kept by this parser and parsed in place,
+    // so that string values in it are not copied by rapidjson
+    Status parse(std::string&& scroll_result);
     Status fill_tuple(const TupleDescriptor* _tuple_desc, Tuple* tuple, 
                 MemPool* mem_pool, bool* line_eof);
 
@@ -43,12 +46,15 @@ public:
 
 private:
 
+    bool _doc_value_mode;
     std::string _scroll_id;
     int _total;
     int _size;
     rapidjson::SizeType _line_index;
 
+    std::string _response;
     rapidjson::Document _document_node;
-    rapidjson::Value _inner_hits_node;
+    // points into _document_node
+    const rapidjson::Value* _inner_hits_node;
 };
 }
@@ -75,8 +75,18 @@ std::string ESScrollQueryBuilder::build(const std::map<std::string, std::string>
     BooleanQueryBuilder::to_query(predicates, &scratch_document, &query_node);
     // note: add `query` for this value....
     es_query_dsl.AddMember("query", query_node, allocator);
-    // just filter the selected fields for reducing the network cost
-    if (fields.size() > 0) {
+    auto doc_value_iter = properties.find(ESScanReader::KEY_DOC_VALUE_MODE);
+    if (doc_value_iter != properties.end() && doc_value_iter->second == "true") {
+        // fetch the columnar doc values of selected fields instead of parsing _source
+        rapidjson::Value doc_value_node(rapidjson::kArrayType);
+        for (auto iter = fields.begin(); iter != fields.end(); iter++) {
+            rapidjson::Value field(iter->c_str(), allocator);
+            doc_value_node.PushBack(field, allocator);
+        }
+        es_query_dsl.AddMember("docvalue_fields", doc_value_node, allocator);
+        es_query_dsl.AddMember("_source", false, allocator);
+    } else if (fields.size() > 0) {
+        // just filter the selected fields for reducing the network cost
         rapidjson::Value source_node(rapidjson::kArrayType);
         for (auto iter = fields.begin(); iter != fields.end(); iter++) {
             rapidjson::Value field(iter->c_str(), allocator);
@@ -92,6 +102,14 @@ std::string ESScrollQueryBuilder::build(const std::map<std::string, std::string>
     es_query_dsl.AddMember("sort", sort_node, allocator);
     // number of docuements returned
     es_query_dsl.AddMember("size", size, allocator);
+    // sliced scroll, scroll of each slice can be consumed in parallel
+    auto slice_iter = properties.find(ESScanReader::KEY_SLICE_MAX);
+    if (slice_iter != properties.end() && atoi(slice_iter->second.c_str()) > 1) {
+        rapidjson::Value slice_node(rapidjson::kObjectType);
+        slice_node.AddMember("id", atoi(properties.at(ESScanReader::KEY_SLICE_ID).c_str()), allocator);
+        slice_node.AddMember("max", atoi(slice_iter->second.c_str()), allocator);
+        es_query_dsl.AddMember("slice", slice_node, allocator);
+    }
     rapidjson::StringBuffer buffer;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     es_query_dsl.Accept(writer);
@@ -17,9 +17,11 @@
 
 #include "exec/es_http_scan_node.h"
 
+#include <algorithm>
 #include <chrono>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exec/es/es_predicate.h"
 #include "exec/es/es_query_builder.h"
@@ -148,18 +150,20 @@ Status EsHttpScanNode::open(RuntimeState* state) {
 }
 
 Status EsHttpScanNode::start_scanners() {
+    // every shard is scanned by several sliced scrolls in parallel
+    int num_slices = std::max(config::es_scroll_slices_per_shard, 1);
     {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
-        _num_running_scanners = _scan_ranges.size();
+        _num_running_scanners = _scan_ranges.size() * num_slices;
     }
 
+    // scanners report failure by _process_status, so all of them are
+    // started without waiting for each other
     for (int i = 0; i < _scan_ranges.size(); i++) {
-        std::promise<Status> p;
-        std::future<Status> f = p.get_future();
-        _scanner_threads.emplace_back(&EsHttpScanNode::scanner_worker, this, i,
-                    _scan_ranges.size(), std::ref(p));
-        Status status = f.get();
-        if (!status.ok()) return status;
+        for (int slice_id = 0; slice_id < num_slices; ++slice_id) {
+            _scanner_threads.emplace_back(&EsHttpScanNode::scanner_worker, this,
+                                          i, slice_id, num_slices);
+        }
     }
     return Status::OK();
 }
@@ -167,6 +171,7 @@ Status EsHttpScanNode::start_scanners() {
 Status EsHttpScanNode::get_next(RuntimeState* state, RowBatch* row_batch, 
             bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     if (state->is_cancelled()) {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
         if (update_status(Status::Cancelled("Cancelled"))) {
@@ -388,10 +393,10 @@ static std::string get_host_port(const std::vector<TNetworkAddress>& es_hosts) {
     return host_port;
 }
 
-void EsHttpScanNode::scanner_worker(int start_idx, int length, std::promise<Status>& p_status) {
+void EsHttpScanNode::scanner_worker(int range_idx, int slice_id, int num_slices) {
     // Clone expr context
     std::vector<ExprContext*> scanner_expr_ctxs;
-    DCHECK(start_idx < length);
+    DCHECK(range_idx < _scan_ranges.size());
     auto status = Expr::clone_if_not_exists(_conjunct_ctxs, _runtime_state, 
                 &scanner_expr_ctxs);
     if (!status.ok()) {
@@ -400,7 +405,7 @@ void EsHttpScanNode::scanner_worker(int start_idx, int length, std::promise<Stat
 
     EsScanCounter counter;
     const TEsScanRange& es_scan_range = 
-        _scan_ranges[start_idx].scan_range.es_scan_range;
+        _scan_ranges[range_idx].scan_range.es_scan_range;
 
     // Collect the informations from scan range to perperties
     std::map<std::string, std::string> properties(_properties);
@@ -411,6 +416,8 @@ void EsHttpScanNode::scanner_worker(int start_idx, int length, std::promise<Stat
     properties[ESScanReader::KEY_SHARD] = std::to_string(es_scan_range.shard_id);
     properties[ESScanReader::KEY_BATCH_SIZE] = std::to_string(_runtime_state->batch_size());
     properties[ESScanReader::KEY_HOST_PORT] = get_host_port(es_scan_range.es_hosts);
+    properties[ESScanReader::KEY_SLICE_ID] = std::to_string(slice_id);
+    properties[ESScanReader::KEY_SLICE_MAX] = std::to_string(num_slices);
     properties[ESScanReader::KEY_QUERY] 
         = ESScrollQueryBuilder::build(properties, _column_names, _predicates);
 
@@ -420,7 +427,8 @@ void EsHttpScanNode::scanner_worker(int start_idx, int length, std::promise<Stat
                     properties, scanner_expr_ctxs, &counter));
     status = scanner_scan(std::move(scanner), scanner_expr_ctxs, &counter);
     if (!status.ok()) {
-        LOG(WARNING) << "Scanner[" << start_idx << "] process failed. status="
+        LOG(WARNING) << "Scanner[" << range_idx << ", slice " << slice_id
+            << "] process failed. status="
             << status.get_error_msg();
     }
 
@@ -439,7 +447,5 @@ void EsHttpScanNode::scanner_worker(int start_idx, int length, std::promise<Stat
     if (!status.ok()) {
         _queue_writer_cond.notify_all();
     }
-
-    p_status.set_value(status);
 }
 }
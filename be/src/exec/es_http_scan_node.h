@@ -70,8 +70,9 @@ private:
     // Create scanners to do scan job
     Status start_scanners();
 
-    // One scanner worker, This scanner will hanle 'length' ranges start from start_idx
-    void scanner_worker(int start_idx, int length, std::promise<Status>& p_status);
+    // One scanner worker, which scans the slice 'slice_id' of 'num_slices'
+    // slices of the range 'range_idx'
+    void scanner_worker(int range_idx, int slice_id, int num_slices);
 
     // Scan one range
     Status scanner_scan(std::unique_ptr<EsHttpScanner> scanner,
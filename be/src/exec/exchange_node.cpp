@@ -22,6 +22,7 @@
 #include "runtime/data_stream_mgr.h"
 #include "runtime/data_stream_recvr.h"
 #include "runtime/exec_env.h"
+#include "runtime/query_trace.h"
 #include "runtime/runtime_state.h"
 #include "runtime/row_batch.h"
 #include "util/runtime_profile.h"
@@ -119,6 +120,7 @@ Status ExchangeNode::fill_input_row_batch(RuntimeState* state) {
     Status ret_status;
     {
         // SCOPED_TIMER(state->total_network_receive_timer());
+        SCOPED_TRACE_SPAN(state, "ExchangeReceive", "exchange");
         ret_status = _stream_recvr->get_batch(&_input_batch);
     }
     VLOG_FILE << "exch: has batch=" << (_input_batch == NULL ? "false" : "true")
@@ -131,6 +133,7 @@ Status ExchangeNode::fill_input_row_batch(RuntimeState* state) {
 Status ExchangeNode::get_next(RuntimeState* state, RowBatch* output_batch, bool* eos) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
 
     if (reached_limit()) {
         _stream_recvr->transfer_all_resources(output_batch);
@@ -214,6 +217,7 @@ Status ExchangeNode::get_next_merging(RuntimeState* state, RowBatch* output_batc
     // RETURN_IF_ERROR(QueryMaintenance(state));
     RETURN_IF_ERROR(state->check_query_state());
 
+    SCOPED_TRACE_SPAN(state, "ExchangeReceive", "exchange");
     RETURN_IF_ERROR(_stream_recvr->get_next(output_batch, eos));
     while ((_num_rows_skipped < _offset)) {
         _num_rows_skipped += output_batch->num_rows();
@@ -17,6 +17,7 @@
 
 #include "exec/exec_node.h"
 
+#include <string.h>
 #include <sstream>
 #include <thrift/protocol/TDebugProtocol.h>
 #include <unistd.h>
@@ -27,13 +28,13 @@
 #include "common/status.h"
 #include "exprs/expr_context.h"
 #include "exec/aggregation_node.h"
-#include "exec/partitioned_aggregation_node.h"
 #include "exec/new_partitioned_aggregation_node.h"
 #include "exec/csv_scan_node.h"
 #include "exec/es_scan_node.h"
 #include "exec/es_http_scan_node.h"
 #include "exec/pre_aggregation_node.h"
 #include "exec/hash_join_node.h"
+#include "exec/partitioned_hash_join_node.h"
 #include "exec/broker_scan_node.h"
 #include "exec/cross_join_node.h"
 #include "exec/empty_set_node.h"
@@ -187,6 +188,9 @@ Status ExecNode::prepare(RuntimeState* state) {
                                                    _rows_returned_counter,
                                                    runtime_profile()->total_time_counter()),
                               "");
+    if (state->enable_perf_counters() && ThreadPerfCounters::current() != nullptr) {
+        add_perf_counters();
+    }
     _mem_tracker.reset(new MemTracker(-1, _runtime_profile->name(), state->instance_mem_tracker()));
     _expr_mem_tracker.reset(new MemTracker(-1, "Exprs", _mem_tracker.get()));
     _expr_mem_pool.reset(new MemPool(_expr_mem_tracker.get()));
@@ -202,6 +206,36 @@ Status ExecNode::prepare(RuntimeState* state) {
     return Status::OK();
 }
 
+// Derived counter function: return instructions per cycle
+static int64_t instructions_per_cycle(const RuntimeProfile::Counter* instructions,
+                                      const RuntimeProfile::Counter* cycles) {
+    double ipc = 0;
+    if (cycles->value() != 0) {
+        ipc = static_cast<double>(instructions->value()) / cycles->value();
+    }
+    int64_t value = 0;
+    memcpy(&value, &ipc, sizeof(ipc));
+    return value;
+}
+
+void ExecNode::add_perf_counters() {
+    _perf_counters.resize(ThreadPerfCounters::NUM_EVENTS);
+    _perf_counters[ThreadPerfCounters::CPU_CYCLES] =
+        ADD_COUNTER(_runtime_profile, "HWCycles", TUnit::UNIT);
+    _perf_counters[ThreadPerfCounters::INSTRUCTIONS] =
+        ADD_COUNTER(_runtime_profile, "HWInstructions", TUnit::UNIT);
+    _perf_counters[ThreadPerfCounters::LLC_MISSES] =
+        ADD_COUNTER(_runtime_profile, "HWLLCMisses", TUnit::UNIT);
+    _perf_counters[ThreadPerfCounters::BRANCH_MISSES] =
+        ADD_COUNTER(_runtime_profile, "HWBranchMisses", TUnit::UNIT);
+    runtime_profile()->add_derived_counter(
+        "HWInstructionsPerCycle", TUnit::DOUBLE_VALUE,
+        boost::bind<int64_t>(&instructions_per_cycle,
+                             _perf_counters[ThreadPerfCounters::INSTRUCTIONS],
+                             _perf_counters[ThreadPerfCounters::CPU_CYCLES]),
+        "");
+}
+
 Status ExecNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     return Expr::open(_conjunct_ctxs, state);
@@ -387,9 +421,7 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
         return Status::OK();
 
     case TPlanNodeType::AGGREGATION_NODE:
-        if (config::enable_partitioned_aggregation) {
-            *node = pool->add(new PartitionedAggregationNode(pool, tnode, descs));
-        } else if (config::enable_new_partitioned_aggregation) {
+        if (config::enable_new_partitioned_aggregation) {
             *node = pool->add(new NewPartitionedAggregationNode(pool, tnode, descs));
         } else {
             *node = pool->add(new AggregationNode(pool, tnode, descs));
@@ -400,7 +432,12 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
           *node = pool->add(new PreAggregationNode(pool, tnode, descs));
           return Status::OK();*/
     case TPlanNodeType::HASH_JOIN_NODE:
-        *node = pool->add(new HashJoinNode(pool, tnode, descs));
+        if (config::enable_partitioned_hash_join
+                && tnode.hash_join_node.join_op != TJoinOp::NULL_AWARE_LEFT_ANTI_JOIN) {
+            *node = pool->add(new PartitionedHashJoinNode(pool, tnode, descs));
+        } else {
+            *node = pool->add(new HashJoinNode(pool, tnode, descs));
+        }
         return Status::OK();
 
     case TPlanNodeType::CROSS_JOIN_NODE:
@@ -27,6 +27,7 @@
 #include "runtime/descriptors.h"
 #include "runtime/mem_pool.h"
 #include "util/runtime_profile.h"
+#include "util/perf_counters.h"
 #include "util/blocking_queue.hpp"
 #include "runtime/bufferpool/buffer_pool.h"
 #include "runtime/query_statistics.h"
@@ -146,6 +147,13 @@ public:
     static Status create_tree(RuntimeState* state, ObjectPool* pool, const TPlan& plan,
                              const DescriptorTbl& descs, ExecNode** root);
 
+    // Add 'child' as the last child, which is done by create_tree() for nodes of
+    // a plan. Used to drive a single node with other inputs, eg. in benchmarks.
+    // Must be called before init() because some nodes need their children then.
+    void add_child(ExecNode* child) {
+        _children.push_back(child);
+    }
+
     // Set debug action for node with given id in 'tree'
     static void set_debug_options(int node_id, TExecNodePhase::type phase,
                                 TDebugAction::type action, ExecNode* tree);
@@ -330,6 +338,10 @@ protected:
     RuntimeProfile::Counter* _rows_returned_rate;
     // Account for peak memory used by this node
     RuntimeProfile::Counter* _memory_used_counter;
+    // Hardware counters of get_next() indexed by ThreadPerfCounters::Event, including
+    // the ones of children as TotalTime does. Empty unless enable_perf_counters is set
+    // in query options, see SCOPED_PERF_COUNTERS.
+    std::vector<RuntimeProfile::Counter*> _perf_counters;
 
     // Execution options that are determined at runtime.  This is added to the
     // runtime profile at close().  Examples for options logged here would be
@@ -390,6 +402,9 @@ protected:
     virtual Status QueryMaintenance(RuntimeState* state) WARN_UNUSED_RESULT;
 
 private:
+    // Add the hardware counters of get_next() into the runtime profile
+    void add_perf_counters();
+
     bool _is_closed;
 };
 
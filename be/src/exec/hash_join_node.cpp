@@ -20,12 +20,18 @@
 #include <sstream>
 
 #include "codegen/llvm_codegen.h"
+#include "common/config.h"
 #include "exec/hash_table.hpp"
+#include "runtime/exec_env.h"
+#include "runtime/fragment_mgr.h"
+#include "runtime/query_trace.h"
 #include "exprs/expr.h"
 #include "exprs/in_predicate.h"
 #include "exprs/slot_ref.h"
+#include "runtime/datetime_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
+#include "util/cpu_profiler.h"
 #include "util/runtime_profile.h"
 #include "gen_cpp/PlanNodes_types.h"
 
@@ -42,7 +48,11 @@ HashJoinNode::HashJoinNode(
         ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs) :
             ExecNode(pool, tnode, descs),
             _join_op(tnode.hash_join_node.join_op),
+            _parallel_build(false),
+            _share_hash_tbl(false),
+            _is_shared_builder(false),
             _probe_eos(false),
+            _probe_hash_end(0),
             _codegen_process_build_batch_fn(NULL),
             _process_build_batch_fn(NULL),
             _process_probe_batch_fn(NULL),
@@ -53,6 +63,8 @@ HashJoinNode::HashJoinNode(
     _match_all_build =
         (_join_op == TJoinOp::RIGHT_OUTER_JOIN || _join_op == TJoinOp::FULL_OUTER_JOIN);
     _is_push_down = tnode.hash_join_node.is_push_down;
+    _is_broadcast_join = tnode.hash_join_node.__isset.is_broadcast_join
+        && tnode.hash_join_node.is_broadcast_join;
 }
 
 HashJoinNode::~HashJoinNode() {
@@ -138,8 +150,18 @@ Status HashJoinNode::prepare(RuntimeState* state) {
     _hash_tbl.reset(new HashTable(
             _build_expr_ctxs, _probe_expr_ctxs, _build_tuple_size,
             stores_nulls, id(), mem_tracker(), 1024));
+    _parallel_build = config::hash_join_build_thread_num > 1
+        && _hash_tbl->can_build_in_parallel();
+    // Only joins which never write to the build rows while probing can share them.
+    // The other instances drop their copy of the build side by closing the exchange.
+    _share_hash_tbl = config::enable_shared_broadcast_hash_table
+        && _is_broadcast_join && !stores_nulls
+        && child(1)->type() == TPlanNodeType::EXCHANGE_NODE
+        && state->exec_env() != NULL && state->exec_env()->fragment_mgr() != NULL;
 
     _probe_batch.reset(new RowBatch(child(0)->row_desc(), state->batch_size(), mem_tracker()));
+    _probe_hashes.resize(state->batch_size());
+    _probe_hash_valid.resize(state->batch_size());
 
     if (state->codegen_level() > 0) {
         if (_join_op == TJoinOp::LEFT_ANTI_JOIN) {
@@ -196,6 +218,13 @@ Status HashJoinNode::close(RuntimeState* state) {
     if (_build_pool.get() != NULL) {
         _build_pool->free_all();
     }
+    if (_shared_hash_tbl != nullptr) {
+        if (_is_shared_builder) {
+            // the other instances must not wait for a build that never finishes
+            _shared_hash_tbl->set_build_status(Status::Cancelled("Cancelled"));
+        }
+        _shared_hash_tbl.reset();
+    }
 
     Expr::close(_build_expr_ctxs, state);
     Expr::close(_probe_expr_ctxs, state);
@@ -209,7 +238,111 @@ Status HashJoinNode::close(RuntimeState* state) {
     return ExecNode::close(state);
 }
 
+static int64_t get_int_value(PrimitiveType type, void* val) {
+    switch (type) {
+    case TYPE_TINYINT:
+        return *reinterpret_cast<int8_t*>(val);
+    case TYPE_SMALLINT:
+        return *reinterpret_cast<int16_t*>(val);
+    case TYPE_INT:
+        return *reinterpret_cast<int32_t*>(val);
+    default:
+        return *reinterpret_cast<int64_t*>(val);
+    }
+}
+
+Status HashJoinNode::push_down_min_max_predicates(RuntimeState* state) {
+    std::list<ExprContext*> expr_ctxs;
+    for (int i = 0; i < _probe_expr_ctxs.size(); ++i) {
+        const TypeDescriptor& type = _probe_expr_ctxs[i]->root()->type();
+        bool is_date = type.type == TYPE_DATE || type.type == TYPE_DATETIME;
+        if (!is_date && type.type != TYPE_TINYINT && type.type != TYPE_SMALLINT
+                && type.type != TYPE_INT && type.type != TYPE_BIGINT) {
+            continue;
+        }
+        bool has_value = false;
+        int64_t min_int = 0;
+        int64_t max_int = 0;
+        DateTimeValue min_date;
+        DateTimeValue max_date;
+        {
+            SCOPED_TIMER(_push_compute_timer);
+            HashTable::Iterator iter = _hash_tbl->begin();
+            while (iter.has_next()) {
+                void* val = _build_expr_ctxs[i]->get_value(iter.get_row());
+                iter.next<false>();
+                if (val == NULL) {
+                    continue;
+                }
+                if (is_date) {
+                    const DateTimeValue& date = *reinterpret_cast<DateTimeValue*>(val);
+                    if (!has_value || date < min_date) {
+                        min_date = date;
+                    }
+                    if (!has_value || max_date < date) {
+                        max_date = date;
+                    }
+                } else {
+                    int64_t int_val = get_int_value(type.type, val);
+                    if (!has_value || int_val < min_int) {
+                        min_int = int_val;
+                    }
+                    if (!has_value || int_val > max_int) {
+                        max_int = int_val;
+                    }
+                }
+                has_value = true;
+            }
+        }
+        if (!has_value) {
+            continue;
+        }
+
+        for (auto op : {TExprOpcode::GE, TExprOpcode::LE}) {
+            TExprNode literal_node;
+            literal_node.__set_type(type.to_thrift());
+            literal_node.__set_num_children(0);
+            if (is_date) {
+                char buf[64];
+                (op == TExprOpcode::GE ? min_date : max_date).to_string(buf);
+                literal_node.__set_node_type(TExprNodeType::DATE_LITERAL);
+                TDateLiteral date_literal;
+                date_literal.__set_value(buf);
+                literal_node.__set_date_literal(date_literal);
+            } else {
+                literal_node.__set_node_type(TExprNodeType::INT_LITERAL);
+                TIntLiteral int_literal;
+                int_literal.__set_value(op == TExprOpcode::GE ? min_int : max_int);
+                literal_node.__set_int_literal(int_literal);
+            }
+            TExpr literal_expr;
+            literal_expr.nodes.push_back(literal_node);
+            ExprContext* literal_ctx = NULL;
+            RETURN_IF_ERROR(Expr::create_expr_tree(_pool, literal_expr, &literal_ctx));
+
+            TExprNode pred_node;
+            pred_node.__set_node_type(TExprNodeType::BINARY_PRED);
+            pred_node.__set_type(TypeDescriptor(TYPE_BOOLEAN).to_thrift());
+            pred_node.__set_opcode(op);
+            pred_node.__set_child_type(to_thrift(type.type));
+            pred_node.__set_num_children(0);
+            TExpr pred_expr;
+            pred_expr.nodes.push_back(pred_node);
+            ExprContext* ctx = NULL;
+            RETURN_IF_ERROR(Expr::create_expr_tree(_pool, pred_expr, &ctx));
+            ctx->root()->add_child(Expr::copy(_pool, _probe_expr_ctxs[i]->root()));
+            ctx->root()->add_child(literal_ctx->root());
+            expr_ctxs.push_back(ctx);
+        }
+    }
+    if (!expr_ctxs.empty()) {
+        push_down_predicate(state, &expr_ctxs);
+    }
+    return Status::OK();
+}
+
 void HashJoinNode::build_side_thread(RuntimeState* state, boost::promise<Status>* status) {
+    CpuProfileTag profile_tag(state->query_id(), state->fragment_instance_id());
     status->set_value(construct_hash_table(state));
     // Release the thread token as soon as possible (before the main thread joins
     // on it).  This way, if we had a chain of 10 joins using 1 additional thread,
@@ -218,6 +351,11 @@ void HashJoinNode::build_side_thread(RuntimeState* state, boost::promise<Status>
 }
 
 Status HashJoinNode::construct_hash_table(RuntimeState* state) {
+    SCOPED_TRACE_SPAN(state, "HashJoinBuild", "join");
+    if (_share_hash_tbl) {
+        return construct_shared_hash_table(state);
+    }
+
     // Do a full scan of child(1) and store everything in _hash_tbl
     // The hash join node needs to keep in memory all build tuples, including the tuple
     // row ptrs.  The row ptrs are copied into the hash table's internal structure so they
@@ -234,11 +372,16 @@ Status HashJoinNode::construct_hash_table(RuntimeState* state) {
         _build_pool->acquire_data(build_batch.tuple_data_pool(), false);
         RETURN_IF_LIMIT_EXCEEDED(state);
 
-        // Call codegen version if possible
-        if (_process_build_batch_fn == NULL) {
+        // Call codegen version if possible, it is set by the codegen thread once the
+        // module is compiled
+        ProcessBuildBatchFn process_build_batch_fn =
+            __atomic_load_n(&_process_build_batch_fn, __ATOMIC_ACQUIRE);
+        if (_parallel_build) {
+            append_build_batch(&build_batch);
+        } else if (process_build_batch_fn == NULL) {
             process_build_batch(&build_batch);
         } else {
-            _process_build_batch_fn(this, &build_batch);
+            process_build_batch_fn(this, &build_batch);
         }
 
         VLOG_ROW << _hash_tbl->debug_string(true, &child(1)->row_desc());
@@ -253,6 +396,111 @@ Status HashJoinNode::construct_hash_table(RuntimeState* state) {
         }
     }
 
+    if (_parallel_build) {
+        SCOPED_TIMER(_build_timer);
+        build_hash_table_in_parallel(state, _hash_tbl.get());
+        RETURN_IF_LIMIT_EXCEEDED(state);
+        COUNTER_SET(_build_buckets_counter, _hash_tbl->num_buckets());
+        COUNTER_SET(_hash_tbl_load_factor_counter, _hash_tbl->load_factor());
+    }
+
+    return Status::OK();
+}
+
+void HashJoinNode::build_hash_table_in_parallel(RuntimeState* state, HashTable* hash_tbl) {
+    // Small tables stay single level and are placed by this thread alone.
+    int num_threads = 1;
+    if (config::hash_table_two_level_threshold > 0
+            && hash_tbl->size() >= config::hash_table_two_level_threshold) {
+        while (num_threads < config::hash_join_build_thread_num
+                && state->resource_pool()->try_acquire_thread_token()) {
+            ++num_threads;
+        }
+    }
+
+    hash_tbl->build_in_parallel(num_threads);
+
+    for (int i = 1; i < num_threads; ++i) {
+        state->resource_pool()->release_thread_token(false);
+    }
+    if (num_threads > 1) {
+        add_runtime_exec_option("Hash Table Built In Parallel");
+    }
+}
+
+Status HashJoinNode::construct_shared_hash_table(RuntimeState* state) {
+    _shared_hash_tbl = state->exec_env()->fragment_mgr()->get_shared_hash_table(
+        state->query_id(), id(), state->query_options().mem_limit,
+        state->exec_env()->process_mem_tracker(), &_is_shared_builder);
+
+    if (_is_shared_builder) {
+        add_runtime_exec_option("Shared Hash Table Built");
+        Status status = build_shared_hash_table(state);
+        _shared_hash_tbl->set_build_status(status);
+        RETURN_IF_ERROR(status);
+    } else {
+        // Nothing is read from the build side. Closing it right away makes the senders
+        // drop the rows broadcast to this instance instead of blocking on its buffer
+        // while the builder still needs their rows.
+        child(1)->close(state);
+        RETURN_IF_ERROR(_shared_hash_tbl->wait_for_build(state));
+        add_runtime_exec_option("Shared Hash Table Probed");
+    }
+
+    // The shared table was built with the exprs of the builder, this instance probes
+    // it with its own ones.
+    HashTable* shared_tbl = _shared_hash_tbl->hash_tbl();
+    _hash_tbl->share_from(*shared_tbl);
+    COUNTER_SET(_build_rows_counter, _hash_tbl->size());
+    COUNTER_SET(_build_buckets_counter, _hash_tbl->num_buckets());
+    COUNTER_SET(_hash_tbl_load_factor_counter, _hash_tbl->load_factor());
+    return Status::OK();
+}
+
+Status HashJoinNode::build_shared_hash_table(RuntimeState* state) {
+    // Unlike _hash_tbl, this table is not codegen'd for: the jitted build function
+    // inserts into _hash_tbl.
+    HashTable* hash_tbl = new HashTable(
+            _build_expr_ctxs, _probe_expr_ctxs, _build_tuple_size,
+            false, id(), _shared_hash_tbl->mem_tracker(), 1024);
+    _shared_hash_tbl->set_hash_tbl(hash_tbl);
+    MemPool* build_pool = _shared_hash_tbl->build_pool();
+
+    RowBatch build_batch(child(1)->row_desc(), state->batch_size(), mem_tracker());
+    RETURN_IF_ERROR(child(1)->open(state));
+
+    while (true) {
+        RETURN_IF_CANCELLED(state);
+        bool eos = true;
+        RETURN_IF_ERROR(child(1)->get_next(state, &build_batch, &eos));
+        SCOPED_TIMER(_build_timer);
+        build_pool->acquire_data(build_batch.tuple_data_pool(), false);
+        if (_shared_hash_tbl->mem_tracker()->limit_exceeded()) {
+            return Status::MemoryLimitExceeded("Memory limit exceeded");
+        }
+
+        for (int i = 0; i < build_batch.num_rows(); ++i) {
+            if (_parallel_build) {
+                hash_tbl->append(build_batch.get_row(i));
+            } else {
+                hash_tbl->insert(build_batch.get_row(i));
+            }
+        }
+        COUNTER_SET(_build_rows_counter, hash_tbl->size());
+        build_batch.reset();
+
+        if (eos) {
+            break;
+        }
+    }
+
+    if (_parallel_build) {
+        SCOPED_TIMER(_build_timer);
+        build_hash_table_in_parallel(state, hash_tbl);
+    }
+    if (_shared_hash_tbl->mem_tracker()->limit_exceeded()) {
+        return Status::MemoryLimitExceeded("Memory limit exceeded");
+    }
     return Status::OK();
 }
 
@@ -304,6 +552,8 @@ Status HashJoinNode::open(RuntimeState* state) {
 
         if (_hash_tbl->size() > 1024) {
             _is_push_down = false;
+            SCOPED_TIMER(_push_down_timer);
+            RETURN_IF_ERROR(push_down_min_max_predicates(state));
         }
 
         // TODO: this is used for Code Check, Remove this later
@@ -345,7 +595,8 @@ Status HashJoinNode::open(RuntimeState* state) {
                         in_pre->insert(val);
                     }
 
-                    SCOPED_TIMER(_build_timer);
+                    // timed per row, so only sample it
+                    SCOPED_SAMPLED_TIMER(_build_timer, 64);
                     iter.next<false>();
                 }
             }
@@ -382,6 +633,7 @@ Status HashJoinNode::open(RuntimeState* state) {
         RETURN_IF_ERROR(child(0)->get_next(state, _probe_batch.get(), &_probe_eos));
         COUNTER_UPDATE(_probe_rows_counter, _probe_batch->num_rows());
         _probe_batch_pos = 0;
+        _probe_hash_end = 0;
 
         if (_probe_batch->num_rows() == 0) {
             if (_probe_eos) {
@@ -408,6 +660,7 @@ Status HashJoinNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* eo
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
 
     if (reached_limit()) {
         *eos = true;
@@ -663,14 +916,16 @@ Status HashJoinNode::left_join_get_next(RuntimeState* state,
         }
 
         // Continue processing this row batch
-        if (_process_probe_batch_fn == NULL) {
+        ProcessProbeBatchFn process_probe_batch_fn =
+            __atomic_load_n(&_process_probe_batch_fn, __ATOMIC_ACQUIRE);
+        if (process_probe_batch_fn == NULL) {
             _num_rows_returned +=
                 process_probe_batch(out_batch, _probe_batch.get(), max_added_rows);
             COUNTER_SET(_rows_returned_counter, _num_rows_returned);
         } else {
             // Use codegen'd function
             _num_rows_returned +=
-                _process_probe_batch_fn(this, out_batch, _probe_batch.get(), max_added_rows);
+                process_probe_batch_fn(this, out_batch, _probe_batch.get(), max_added_rows);
             COUNTER_SET(_rows_returned_counter, _num_rows_returned);
         }
 
@@ -683,6 +938,7 @@ Status HashJoinNode::left_join_get_next(RuntimeState* state,
         if (!_hash_tbl_iterator.has_next() && _probe_batch_pos == _probe_batch->num_rows()) {
             _probe_batch->transfer_resource_ownership(out_batch);
             _probe_batch_pos = 0;
+            _probe_hash_end = 0;
 
             if (out_batch->is_full() || out_batch->at_resource_limit()) {
                 break;
@@ -934,9 +1190,11 @@ Function* HashJoinNode::codegen_process_probe_batch(RuntimeState* state, Functio
         process_probe_batch_fn, false, hash_fn, "hash_current_row", &replaced);
     DCHECK_EQ(replaced, 1);
 
+    // Called when hashing probe rows ahead and again by find() for rows that have
+    // a candidate bucket.
     process_probe_batch_fn = codegen->replace_call_sites(
         process_probe_batch_fn, false, eval_row_fn, "eval_probe_row", &replaced);
-    DCHECK_EQ(replaced, 1);
+    DCHECK_EQ(replaced, 2);
 
     process_probe_batch_fn = codegen->replace_call_sites(
         process_probe_batch_fn, false, create_output_row_fn, "create_output_row", &replaced);
@@ -955,7 +1213,7 @@ Function* HashJoinNode::codegen_process_probe_batch(RuntimeState* state, Functio
 
     process_probe_batch_fn = codegen->replace_call_sites(
         process_probe_batch_fn, false, equals_fn, "equals", &replaced);
-    DCHECK_EQ(replaced, 2);
+    DCHECK_EQ(replaced, 1);
 
     return codegen->optimize_function_with_exprs(process_probe_batch_fn);
 }
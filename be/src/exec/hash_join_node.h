@@ -25,6 +25,7 @@
 
 #include "exec/exec_node.h"
 #include "exec/hash_table.h"
+#include "exec/shared_hash_table_ctx.h"
 #include "gen_cpp/PlanNodes_types.h"
 
 namespace doris {
@@ -67,6 +68,7 @@ private:
     boost::scoped_ptr<HashTable> _hash_tbl;
     HashTable::Iterator _hash_tbl_iterator;
     bool _is_push_down;
+    bool _is_broadcast_join;
 
     // for right outer joins, keep track of what's been joined
     typedef boost::unordered_set<TupleRow*> BuildTupleRowSet;
@@ -88,6 +90,18 @@ private:
     bool _match_one_build;  // match at most one build row to each probe row
     bool _match_all_build;  // output all rows coming from the build input
 
+    // if true, build rows are appended to _hash_tbl and put into its buckets by
+    // several threads after the build side is read, see build_hash_table_in_parallel()
+    bool _parallel_build;
+
+    // if true, the hash table is built once for all instances of this broadcast join
+    // on this backend, see construct_shared_hash_table()
+    bool _share_hash_tbl;
+    // the shared build side, set by construct_shared_hash_table()
+    std::shared_ptr<SharedHashTableCtx> _shared_hash_tbl;
+    // true if this instance builds the shared hash table
+    bool _is_shared_builder;
+
     bool _matched_probe;  // if true, we have matched the current probe row
     bool _eos;  // if true, nothing left to return in get_next()
     boost::scoped_ptr<MemPool> _build_pool;  // holds everything referenced in _hash_tbl
@@ -106,6 +120,18 @@ private:
     bool _probe_eos;  // if true, probe child has no more rows to process
     TupleRow* _current_probe_row;
 
+    // Number of probe rows process_probe_batch() hashes ahead, prefetching their
+    // buckets before any of them is looked up. Small enough for the prefetched
+    // cache lines to stay in L1.
+    static const int PROBE_PREFETCH_ROWS = 64;
+
+    // Hashes of the probe rows in _probe_batch up to _probe_hash_end, computed by
+    // process_probe_batch(). _probe_hash_valid[i] is 0 if row i has NULL keys that
+    // cannot match. _probe_hash_end must be reset when _probe_batch gets new rows.
+    std::vector<uint32_t> _probe_hashes;
+    std::vector<uint8_t> _probe_hash_valid;
+    int _probe_hash_end;
+
     // _build_tuple_idx[i] is the tuple index of child(1)'s tuple[i] in the output row
     std::vector<int> _build_tuple_idx;
     int _build_tuple_size;
@@ -149,6 +175,22 @@ private:
     // same time.
     Status construct_hash_table(RuntimeState* state);
 
+    // Puts the rows appended to _hash_tbl into its buckets with up to
+    // config::hash_join_build_thread_num threads, as many as the resource pool allows.
+    void build_hash_table_in_parallel(RuntimeState* state, HashTable* hash_tbl);
+
+    // Either builds the hash table shared with the other instances or waits for it,
+    // and makes _hash_tbl probe it.
+    Status construct_shared_hash_table(RuntimeState* state);
+
+    // Inserts all rows of child(1) into the shared hash table.
+    Status build_shared_hash_table(RuntimeState* state);
+
+    // Push down predicates of range between min and max values of build exprs to
+    // probe side when there are too many values for in predicates. Only integer
+    // and date types are pushed down.
+    Status push_down_min_max_predicates(RuntimeState* state);
+
     // GetNext helper function for the common join cases: Inner join, left semi and left
     // outer
     Status left_join_get_next(RuntimeState* state, RowBatch* row_batch, bool* eos);
@@ -164,6 +206,9 @@ private:
     // Construct the build hash table, adding all the rows in 'build_batch'
     void process_build_batch(RowBatch* build_batch);
 
+    // Appends all the rows in 'build_batch' to the hash table for the parallel build
+    void append_build_batch(RowBatch* build_batch);
+
     // Write combined row, consisting of probe_row and build_row, to out_row.
     // This is replaced by codegen.
     void create_output_row(TupleRow* out_row, TupleRow* probe_row, TupleRow* build_row);
@@ -15,6 +15,8 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <algorithm>
+
 #include "exec/hash_join_node.h"
 #include "exec/hash_table.hpp"
 #include "runtime/row_batch.h"
@@ -121,8 +123,28 @@ int HashJoinNode::process_probe_batch(RowBatch* out_batch, RowBatch* probe_batch
                 goto end;
             }
 
-            _current_probe_row = probe_batch->get_row(_probe_batch_pos++);
-            _hash_tbl_iterator = _hash_tbl->find(_current_probe_row);
+            // Hash the next rows and prefetch their buckets, so the lookups below
+            // don't wait on each cache miss one after the other.
+            if (_probe_batch_pos >= _probe_hash_end) {
+                int hash_end = std::min(_probe_batch_pos + PROBE_PREFETCH_ROWS, probe_rows);
+                for (int i = _probe_batch_pos; i < hash_end; ++i) {
+                    _probe_hash_valid[i] =
+                        _hash_tbl->hash_probe_row(probe_batch->get_row(i), &_probe_hashes[i]);
+                    if (_probe_hash_valid[i]) {
+                        _hash_tbl->prefetch_bucket(_probe_hashes[i]);
+                    }
+                }
+                _probe_hash_end = hash_end;
+            }
+
+            _current_probe_row = probe_batch->get_row(_probe_batch_pos);
+            if (_probe_hash_valid[_probe_batch_pos]) {
+                _hash_tbl_iterator = _hash_tbl->find(
+                    _current_probe_row, _probe_hashes[_probe_batch_pos]);
+            } else {
+                _hash_tbl_iterator = _hash_tbl->end();
+            }
+            ++_probe_batch_pos;
             _matched_probe = false;
         }
     }
@@ -143,5 +165,11 @@ void HashJoinNode::process_build_batch(RowBatch* build_batch) {
         _hash_tbl->insert(build_batch->get_row(i));
     }
 }
+
+void HashJoinNode::append_build_batch(RowBatch* build_batch) {
+    for (int i = 0; i < build_batch->num_rows(); ++i) {
+        _hash_tbl->append(build_batch->get_row(i));
+    }
+}
 }
 
@@ -17,14 +17,22 @@
 
 #include "exec/hash_table.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include "codegen/codegen_anyval.h"
 #include "codegen/llvm_codegen.h"
+#include "common/config.h"
+
+#include <boost/thread/thread.hpp>
 
 #include "exprs/expr.h"
+#include "exprs/slot_ref.h"
 #include "runtime/raw_value.h"
 #include "runtime/string_value.hpp"
 #include "runtime/mem_tracker.h"
 #include "runtime/runtime_state.h"
+#include "util/bit_util.h"
 #include "util/doris_metrics.h"
 
 using llvm::BasicBlock;
@@ -55,15 +63,20 @@ HashTable::HashTable(const vector<ExprContext*>& build_expr_ctxs,
         _num_nodes(0),
         _exceeded_limit(false),
         _mem_tracker(mem_tracker),
-        _mem_limit_exceeded(false) {
+        _mem_limit_exceeded(false),
+        _is_shared(false) {
     DCHECK(mem_tracker != NULL);
     DCHECK_EQ(_build_expr_ctxs.size(), _probe_expr_ctxs.size());
 
     DCHECK_EQ((num_buckets & (num_buckets - 1)), 0) << "num_buckets must be a power of 2";
-    _buckets.resize(num_buckets);
+    num_buckets = std::max<int64_t>(num_buckets, GROUP_SIZE);
+    _sub_tables.resize(1);
+    init_sub_table(&_sub_tables[0], num_buckets);
+    _sub_table_mask = 0;
     _num_buckets = num_buckets;
-    _num_buckets_till_resize = MAX_BUCKET_OCCUPANCY_FRACTION * _num_buckets;
-    _mem_tracker->consume(_buckets.capacity() * sizeof(Bucket));
+    _mem_tracker->consume(bucket_byte_size(_num_buckets));
+    _two_level_threshold = config::hash_table_two_level_threshold > 0 ?
+        config::hash_table_two_level_threshold : -1;
 
     // Compute the layout and buffer size to store the evaluated expr results
     _results_buffer_size = Expr::compute_results_layout(_build_expr_ctxs,
@@ -95,14 +108,20 @@ void HashTable::close() {
     // TODO: use tr1::array?
     delete[] _expr_values_buffer;
     delete[] _expr_value_null_bits;
+    if (_is_shared) {
+        return;
+    }
     free(_nodes);
+    for (int i = 0; i < _sub_tables.size(); ++i) {
+        free_sub_table(&_sub_tables[i]);
+    }
 #if 0
     if (DorisMetrics::hash_table_total_bytes() != NULL) {
         DorisMetrics::hash_table_total_bytes()->increment(-_nodes_capacity * _node_byte_size);
     }
 #endif
     _mem_tracker->release(_nodes_capacity * _node_byte_size);
-    _mem_tracker->release(_buckets.size() * sizeof(Bucket));
+    _mem_tracker->release(bucket_byte_size(_num_buckets));
 }
 
 bool HashTable::eval_row(TupleRow* row, const vector<ExprContext*>& ctxs) {
@@ -202,59 +221,315 @@ bool HashTable::equals(TupleRow* build_row) {
     return true;
 }
 
-void HashTable::resize_buckets(int64_t num_buckets) {
+void HashTable::init_sub_table(SubTable* sub_table, int64_t num_buckets) {
     DCHECK_EQ((num_buckets & (num_buckets - 1)), 0) << "num_buckets must be a power of 2";
+    DCHECK_GE(num_buckets, GROUP_SIZE);
+    sub_table->buckets = new Bucket[num_buckets];
+    sub_table->ctrl = reinterpret_cast<uint8_t*>(malloc(num_buckets));
+    memset(sub_table->ctrl, EMPTY_CTRL, num_buckets);
+    sub_table->num_buckets = num_buckets;
+    sub_table->group_mask = num_buckets / GROUP_SIZE - 1;
+    sub_table->num_filled_buckets = 0;
+    sub_table->num_buckets_till_resize = MAX_BUCKET_OCCUPANCY_FRACTION * num_buckets;
+}
 
-    int64_t old_num_buckets = _num_buckets;
-    int64_t delta_bytes = (num_buckets - old_num_buckets) * sizeof(Bucket);
-    if (!_mem_tracker->try_consume(delta_bytes)) {
-        mem_limit_exceeded(delta_bytes);
-        return;
+void HashTable::free_sub_table(SubTable* sub_table) {
+    delete[] sub_table->buckets;
+    free(sub_table->ctrl);
+    sub_table->buckets = NULL;
+    sub_table->ctrl = NULL;
+}
+
+void HashTable::share_from(const HashTable& build_table) {
+    DCHECK(!_is_shared);
+    DCHECK_EQ(_num_nodes, 0);
+    DCHECK_EQ(_node_byte_size, build_table._node_byte_size);
+    DCHECK_EQ(_results_buffer_size, build_table._results_buffer_size);
+    DCHECK_EQ(_stores_nulls, build_table._stores_nulls);
+    DCHECK_EQ(_initial_seed, build_table._initial_seed);
+
+    free(_nodes);
+    for (int i = 0; i < _sub_tables.size(); ++i) {
+        free_sub_table(&_sub_tables[i]);
     }
+    _mem_tracker->release(_nodes_capacity * _node_byte_size);
+    _mem_tracker->release(bucket_byte_size(_num_buckets));
+
+    _nodes = build_table._nodes;
+    _num_nodes = build_table._num_nodes;
+    _nodes_capacity = build_table._nodes_capacity;
+    _sub_tables = build_table._sub_tables;
+    _sub_table_mask = build_table._sub_table_mask;
+    _num_buckets = build_table._num_buckets;
+    _num_filled_buckets = build_table._num_filled_buckets;
+    _is_shared = true;
+}
 
-    _buckets.resize(num_buckets);
+void HashTable::place_node(int64_t node_idx, uint32_t hash) {
+    SubTable* sub_table = &_sub_tables[sub_table_idx(hash)];
+    int64_t bucket_idx = find_empty_bucket(*sub_table, hash);
+    sub_table->ctrl[bucket_idx] = hash_tag(hash);
+    sub_table->buckets[bucket_idx]._node_idx = node_idx;
+    ++sub_table->num_filled_buckets;
+}
 
-    // If we're doubling the number of buckets, all nodes in a particular bucket
-    // either remain there, or move down to an analogous bucket in the other half.
-    // In order to efficiently check which of the two buckets a node belongs in, the number
-    // of buckets must be a power of 2.
-    bool doubled_buckets = (num_buckets == old_num_buckets * 2);
+bool HashTable::can_build_in_parallel() const {
+    for (int i = 0; i < _build_expr_ctxs.size(); ++i) {
+        if (_build_expr_ctxs[i]->root()->node_type() != TExprNodeType::SLOT_REF) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    for (int i = 0; i < _num_buckets; ++i) {
-        Bucket* bucket = &_buckets[i];
-        Bucket* sister_bucket = &_buckets[i + old_num_buckets];
-        Node* last_node = NULL;
-        int node_idx = bucket->_node_idx;
+bool HashTable::build_rows_equal(TupleRow* lhs, TupleRow* rhs) const {
+    for (int i = 0; i < _build_expr_ctxs.size(); ++i) {
+        // SlotRef::get_value() doesn't use the ExprContext, so unlike equals() this can
+        // be called from several threads
+        Expr* expr = _build_expr_ctxs[i]->root();
+        void* lhs_val = SlotRef::get_value(expr, lhs);
+        void* rhs_val = SlotRef::get_value(expr, rhs);
+
+        if (lhs_val == NULL || rhs_val == NULL) {
+            // rows with NULL keys are only appended if the table stores NULLs
+            if (lhs_val != rhs_val) {
+                return false;
+            }
+            continue;
+        }
+
+        if (!RawValue::eq(lhs_val, rhs_val, expr->type())) {
+            return false;
+        }
+    }
 
-        while (node_idx != -1) {
+    return true;
+}
+
+int64_t HashTable::place_appended_nodes(const std::vector<int64_t>& node_idxs,
+                                        const std::vector<int64_t>& sub_table_offsets,
+                                        int begin, int end) {
+    int64_t num_filled_buckets = 0;
+    for (int t = begin; t < end; ++t) {
+        SubTable* sub_table = &_sub_tables[t];
+        for (int64_t i = sub_table_offsets[t]; i < sub_table_offsets[t + 1]; ++i) {
+            int64_t node_idx = node_idxs[i];
             Node* node = get_node(node_idx);
-            int64_t next_idx = node->_next_idx;
             uint32_t hash = node->_hash;
+            uint8_t tag = hash_tag(hash);
+            int64_t group = hash_group(hash, *sub_table);
+
+            for (int64_t step = 1; ; ++step) {
+                uint8_t* ctrl = sub_table->ctrl + group * GROUP_SIZE;
+                uint32_t matches = match_tag(ctrl, tag);
+                int64_t bucket_idx = -1;
+
+                while (matches != 0) {
+                    int64_t idx = group * GROUP_SIZE + __builtin_ctz(matches);
+                    Node* head = get_node(sub_table->buckets[idx]._node_idx);
+                    if (head->_hash == hash && build_rows_equal(head->data(), node->data())) {
+                        bucket_idx = idx;
+                        break;
+                    }
+                    matches &= matches - 1;
+                }
+
+                if (bucket_idx != -1) {
+                    // like insert(), the new node becomes the head of the chain
+                    node->_next_idx = sub_table->buckets[bucket_idx]._node_idx;
+                    sub_table->buckets[bucket_idx]._node_idx = node_idx;
+                    break;
+                }
+
+                uint32_t empty = match_empty(ctrl);
+                if (empty != 0) {
+                    bucket_idx = group * GROUP_SIZE + __builtin_ctz(empty);
+                    ctrl[bucket_idx - group * GROUP_SIZE] = tag;
+                    sub_table->buckets[bucket_idx]._node_idx = node_idx;
+                    ++sub_table->num_filled_buckets;
+                    ++num_filled_buckets;
+                    break;
+                }
+                group = (group + step) & sub_table->group_mask;
+            }
+        }
+    }
+    return num_filled_buckets;
+}
 
-            bool node_must_move = true;
-            Bucket* move_to = NULL;
+void HashTable::build_in_parallel(int num_threads) {
+    DCHECK(can_build_in_parallel());
+    DCHECK_EQ(_num_filled_buckets, 0);
+    DCHECK(!is_two_level());
+    bool two_level = _two_level_threshold != -1 && _num_nodes >= _two_level_threshold;
+    int num_sub_tables = two_level ? NUM_SUB_TABLES : 1;
+    int shift = 32 - SUB_TABLE_BITS;
+
+    // Group the nodes by sub table, keeping their order so that chains of equal keys
+    // are the same as if the rows had been inserted.
+    std::vector<int64_t> sub_table_offsets(num_sub_tables + 1, 0);
+    if (two_level) {
+        for (int64_t i = 0; i < _num_nodes; ++i) {
+            ++sub_table_offsets[(get_node(i)->_hash >> shift) + 1];
+        }
+    } else {
+        sub_table_offsets[1] = _num_nodes;
+    }
+    for (int i = 0; i < num_sub_tables; ++i) {
+        sub_table_offsets[i + 1] += sub_table_offsets[i];
+    }
+    std::vector<int64_t> node_idxs(_num_nodes);
+    {
+        std::vector<int64_t> next(sub_table_offsets.begin(), sub_table_offsets.end() - 1);
+        for (int64_t i = 0; i < _num_nodes; ++i) {
+            int t = two_level ? get_node(i)->_hash >> shift : 0;
+            node_idxs[next[t]++] = i;
+        }
+    }
 
-            if (doubled_buckets) {
-                node_must_move = ((hash & old_num_buckets) != 0);
-                move_to = sister_bucket;
-            } else {
-                int64_t bucket_idx = hash & (num_buckets - 1);
-                node_must_move = (bucket_idx != i);
-                move_to = &_buckets[bucket_idx];
-            }
+    // The number of distinct keys is not known, so every sub table is sized for all of
+    // its rows like convert_to_two_level() does and none of them grows while placing.
+    int64_t num_buckets = 0;
+    std::vector<int64_t> sub_table_buckets(num_sub_tables);
+    for (int i = 0; i < num_sub_tables; ++i) {
+        int64_t num_rows = sub_table_offsets[i + 1] - sub_table_offsets[i];
+        sub_table_buckets[i] = std::max<int64_t>(
+            GROUP_SIZE, BitUtil::next_power_of_two(num_rows * 2));
+        num_buckets += sub_table_buckets[i];
+    }
+    int64_t delta_bytes = bucket_byte_size(num_buckets) - bucket_byte_size(_num_buckets);
+    if (delta_bytes > 0) {
+        _mem_tracker->consume(delta_bytes);
+        if (_mem_tracker->limit_exceeded()) {
+            mem_limit_exceeded(delta_bytes);
+        }
+    } else {
+        _mem_tracker->release(-delta_bytes);
+    }
 
-            if (node_must_move) {
-                move_node(bucket, move_to, node_idx, node, last_node);
-            } else {
-                last_node = node;
-            }
+    free_sub_table(&_sub_tables[0]);
+    std::vector<SubTable> sub_tables(num_sub_tables);
+    _sub_tables.swap(sub_tables);
+    _sub_table_mask = num_sub_tables - 1;
+    for (int i = 0; i < num_sub_tables; ++i) {
+        init_sub_table(&_sub_tables[i], sub_table_buckets[i]);
+    }
+    _num_buckets = num_buckets;
+
+    num_threads = std::max(1, std::min(num_threads, num_sub_tables));
+    std::vector<int64_t> num_filled_buckets(num_threads, 0);
+    boost::thread_group threads;
+    for (int i = 1; i < num_threads; ++i) {
+        int begin = num_sub_tables * i / num_threads;
+        int end = num_sub_tables * (i + 1) / num_threads;
+        threads.create_thread([this, &node_idxs, &sub_table_offsets, &num_filled_buckets,
+                               i, begin, end]() {
+            num_filled_buckets[i] = place_appended_nodes(
+                node_idxs, sub_table_offsets, begin, end);
+        });
+    }
+    num_filled_buckets[0] = place_appended_nodes(
+        node_idxs, sub_table_offsets, 0, num_sub_tables / num_threads);
+    threads.join_all();
+
+    for (int i = 0; i < num_threads; ++i) {
+        _num_filled_buckets += num_filled_buckets[i];
+    }
+}
+
+int64_t HashTable::num_inserts_before_resize() const {
+    int64_t num_inserts = std::numeric_limits<int64_t>::max();
+    for (int i = 0; i < _sub_tables.size(); ++i) {
+        const SubTable& sub_table = _sub_tables[i];
+        num_inserts = std::min(num_inserts,
+            sub_table.num_buckets_till_resize + 1 - sub_table.num_filled_buckets);
+    }
+    return num_inserts;
+}
+
+bool HashTable::resize_buckets(SubTable* sub_table, int64_t num_buckets, bool force) {
+    int64_t old_num_buckets = sub_table->num_buckets;
+    int64_t delta_bytes = bucket_byte_size(num_buckets) - bucket_byte_size(old_num_buckets);
+    if (force) {
+        _mem_tracker->consume(delta_bytes);
+        if (_mem_tracker->limit_exceeded()) {
+            mem_limit_exceeded(delta_bytes);
+        }
+    } else if (!_mem_tracker->try_consume(delta_bytes)) {
+        mem_limit_exceeded(delta_bytes);
+        return false;
+    }
 
-            node_idx = next_idx;
+    int64_t num_filled_buckets = sub_table->num_filled_buckets;
+    SubTable old_sub_table = *sub_table;
+    init_sub_table(sub_table, num_buckets);
+    sub_table->num_filled_buckets = num_filled_buckets;
+
+    // Every filled bucket holds a distinct key, so the head nodes only need to be
+    // put into the first empty bucket of their probe sequence; no keys are compared
+    // and the chains of equal keys stay as they are.
+    for (int64_t i = 0; i < old_num_buckets; ++i) {
+        if (old_sub_table.ctrl[i] == EMPTY_CTRL) {
+            continue;
         }
+        int64_t node_idx = old_sub_table.buckets[i]._node_idx;
+        uint32_t hash = get_node(node_idx)->_hash;
+        int64_t bucket_idx = find_empty_bucket(*sub_table, hash);
+        sub_table->ctrl[bucket_idx] = old_sub_table.ctrl[i];
+        sub_table->buckets[bucket_idx]._node_idx = node_idx;
     }
 
+    free_sub_table(&old_sub_table);
+    _num_buckets += num_buckets - old_num_buckets;
+    return true;
+}
+
+void HashTable::convert_to_two_level() {
+    DCHECK(!is_two_level());
+    SubTable& old_sub_table = _sub_tables[0];
+
+    // Count the keys of every sub table and size it for twice as many, so that none
+    // of them has to grow while the keys are placed.
+    std::vector<int64_t> sub_table_buckets(NUM_SUB_TABLES, 0);
+    for (int64_t i = 0; i < old_sub_table.num_buckets; ++i) {
+        if (old_sub_table.ctrl[i] != EMPTY_CTRL) {
+            uint32_t hash = get_node(old_sub_table.buckets[i]._node_idx)->_hash;
+            ++sub_table_buckets[hash >> (32 - SUB_TABLE_BITS)];
+        }
+    }
+    int64_t num_buckets = 0;
+    for (int i = 0; i < NUM_SUB_TABLES; ++i) {
+        sub_table_buckets[i] = std::max<int64_t>(
+            GROUP_SIZE, BitUtil::next_power_of_two(sub_table_buckets[i] * 2));
+        num_buckets += sub_table_buckets[i];
+    }
+
+    int64_t delta_bytes = bucket_byte_size(num_buckets) - bucket_byte_size(_num_buckets);
+    if (delta_bytes > 0 && !_mem_tracker->try_consume(delta_bytes)) {
+        mem_limit_exceeded(delta_bytes);
+        return;
+    }
+
+    std::vector<SubTable> sub_tables(NUM_SUB_TABLES);
+    sub_tables.swap(_sub_tables);
+    _sub_table_mask = NUM_SUB_TABLES - 1;
+    for (int i = 0; i < NUM_SUB_TABLES; ++i) {
+        init_sub_table(&_sub_tables[i], sub_table_buckets[i]);
+    }
+
+    const SubTable& single_table = sub_tables[0];
+    for (int64_t i = 0; i < single_table.num_buckets; ++i) {
+        if (single_table.ctrl[i] != EMPTY_CTRL) {
+            int64_t node_idx = single_table.buckets[i]._node_idx;
+            place_node(node_idx, get_node(node_idx)->_hash);
+        }
+    }
+
+    free_sub_table(&sub_tables[0]);
+    if (delta_bytes < 0) {
+        _mem_tracker->release(-delta_bytes);
+    }
     _num_buckets = num_buckets;
-    _num_buckets_till_resize = MAX_BUCKET_OCCUPANCY_FRACTION * _num_buckets;
 }
 
 void HashTable::grow_node_array() {
@@ -292,34 +567,40 @@ std::string HashTable::debug_string(bool skip_empty, const RowDescriptor* desc)
     std::stringstream ss;
     ss << std::endl;
 
-    for (int i = 0; i < _buckets.size(); ++i) {
-        int64_t node_idx = _buckets[i]._node_idx;
-        bool first = true;
+    for (int t = 0; t < _sub_tables.size(); ++t) {
+        const SubTable& sub_table = _sub_tables[t];
+        for (int i = 0; i < sub_table.num_buckets; ++i) {
+            int64_t node_idx = sub_table.buckets[i]._node_idx;
+            bool first = true;
 
-        if (skip_empty && node_idx == -1) {
-            continue;
-        }
+            if (skip_empty && node_idx == -1) {
+                continue;
+            }
 
-        ss << i << ": ";
+            if (is_two_level()) {
+                ss << t << ".";
+            }
+            ss << i << ": ";
 
-        while (node_idx != -1) {
-            Node* node = get_node(node_idx);
+            while (node_idx != -1) {
+                Node* node = get_node(node_idx);
 
-            if (!first) {
-                ss << ",";
-            }
+                if (!first) {
+                    ss << ",";
+                }
 
-            if (desc == NULL) {
-                ss << node_idx << "(" << (void*)node->data() << ")";
-            } else {
-                ss << (void*)node->data() << " " << node->data()->to_string(*desc);
+                if (desc == NULL) {
+                    ss << node_idx << "(" << (void*)node->data() << ")";
+                } else {
+                    ss << (void*)node->data() << " " << node->data()->to_string(*desc);
+                }
+
+                node_idx = node->_next_idx;
+                first = false;
             }
 
-            node_idx = node->_next_idx;
-            first = false;
+            ss << std::endl;
         }
-
-        ss << std::endl;
     }
 
     return ss.str();
@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_QUERY_EXEC_HASH_TABLE_H
 #define DORIS_BE_SRC_QUERY_EXEC_HASH_TABLE_H
 
+#include <emmintrin.h>
 #include <vector>
 #include <boost/cstdint.hpp>
 
@@ -60,26 +61,36 @@ using std::vector;
 //
 // The hash table does not support removes. The hash table is not thread safe.
 //
-// The implementation is based on the boost multiset.  The hashtable is implemented by
-// two data structures: a vector of buckets and a vector of nodes.  Inserted values
-// are stored as nodes (in the order they are inserted).  The buckets (indexed by the
-// mod of the hash) contain pointers to the node vector.  Nodes that fall in the same
-// bucket are linked together (the bucket pointer gets you the head of that linked list).
-// When growing the hash table, the number of buckets is doubled, and nodes from a
-// particular bucket either stay in place or move to an analogous bucket in the second
-// half of buckets. This behavior allows us to avoid moving about half the nodes each
-// time, and maintains good cache properties by only accessing 2 buckets at a time.
-// The node vector is modified in place.
-// Due to the doubling nature of the buckets, we require that the number of buckets is a
-// power of 2. This allows us to determine if a node needs to move by simply checking a
-// single bit, and further allows us to initially hash nodes using a bitmask.
+// The hashtable is implemented by three data structures: a vector of nodes, a flat
+// array of buckets and an array of control bytes with one byte per bucket.  Inserted
+// values are stored as nodes (in the order they are inserted).  The buckets use open
+// addressing: every filled bucket holds the index of the first node of one distinct
+// key, and nodes with equal keys are linked together from there.  The control byte of
+// a filled bucket is a 7 bit tag taken from the hash of its key, empty buckets have
+// EMPTY_CTRL.  Buckets are split into aligned groups of GROUP_SIZE; the low bits of the
+// hash pick the first group and groups are probed in triangular order.  A probe loads
+// the control bytes of a group with one SSE2 instruction and compares all of them with
+// the tag at once, so nodes are only touched for buckets whose tag matches and the
+// probe stops at the first group that has an empty bucket.  Unlike node chains per
+// bucket, hash collisions never make a probe walk other keys' nodes.
+// Since the number of groups is a power of 2, the triangular probe sequence visits
+// every group, and the occupancy limit makes sure there is always an empty bucket.
+// When growing the hash table, the number of buckets is doubled and the head node of
+// every key is placed again; the node vector is not touched.
 //
-// TODO: this is not a fancy hash table in terms of memory access patterns (cuckoo-hashing
-// or something that spills to disk). We will likely want to invest more time into this.
-// TODO: hash-join and aggregation have very different access patterns.  Joins insert
-// all the rows and then calls scan to find them.  Aggregation interleaves find() and
-// inserts().  We can want to optimize joins more heavily for inserts() (in particular
-// growing).
+// The buckets and control bytes form a SubTable.  Once the table holds more keys than
+// config::hash_table_two_level_threshold it is converted into NUM_SUB_TABLES sub
+// tables picked by the top SUB_TABLE_BITS bits of the hash.  Sub tables resize on
+// their own, so growing a large table only re-places the keys of one small sub table
+// at a time instead of stalling on all of them, and the buckets that are repeatedly
+// touched while a sub table grows stay in cache.  All sub tables share the node
+// vector and the expr values buffer, so codegen and the Iterator are not affected.
+// The tag uses the low 7 bits of the hash and the group the bits above it, which are
+// independent of the sub table as long as a sub table has fewer than 2^17 groups.
+//
+// For joins, hash_probe_row() and prefetch_bucket() allow computing the hashes of many
+// probe rows up front and prefetching their groups before they are looked up with
+// find(probe_row, hash).
 class HashTable {
 private:
     struct Node;
@@ -110,14 +121,31 @@ public:
     // Insert row into the hash table.  Row will be evaluated over _build_expr_ctxs
     // This will grow the hash table if necessary
     void IR_ALWAYS_INLINE insert(TupleRow* row) {
-        if (_num_filled_buckets > _num_buckets_till_resize) {
-            // TODO: next prime instead of double?
-            resize_buckets(_num_buckets * 2);
-        }
-
         insert_impl(row);
     }
 
+    // Returns true if build rows can be compared without evaluating exprs, which
+    // build_in_parallel() relies on: every build expr is a SlotRef.
+    bool can_build_in_parallel() const;
+
+    // Like insert(), but the row is only appended to the node array. The appended rows
+    // are put into the buckets by build_in_parallel(), which must be called before
+    // anything else is done with the table. Must not be mixed with insert().
+    void IR_ALWAYS_INLINE append(TupleRow* row);
+
+    // Makes this empty table probe the rows and buckets of 'build_table' instead of its
+    // own, e.g. for other fragment instances of a broadcast join. Nothing is copied:
+    // 'build_table' must have been built with exprs of the same layout, must not be
+    // changed anymore and must stay alive and open until this table is closed. This
+    // table cannot be inserted into afterwards. Finds on different tables sharing
+    // the same build table can run concurrently, matched() and set_matched() cannot.
+    void share_from(const HashTable& build_table);
+
+    // Puts all rows added by append() into the buckets. The table is made two level
+    // (if it has enough rows) with every sub table sized for all of its rows, and
+    // 'num_threads' threads place the rows of disjoint ranges of sub tables.
+    void build_in_parallel(int num_threads);
+
     // Returns the start iterator for all rows that match 'probe_row'.  'probe_row' is
     // evaluated with _probe_expr_ctxs.  The iterator can be iterated until HashTable::end()
     // to find all the matching rows.
@@ -129,6 +157,31 @@ public:
     // Returns HashTable::end() if there is no match.
     Iterator IR_ALWAYS_INLINE find(TupleRow* probe_row);
 
+    // Same as find(), but 'hash' must have been computed by hash_probe_row() for
+    // 'probe_row'. 'probe_row' is only evaluated again if a bucket with a matching
+    // tag and hash is found, so probe rows without a match cost no expr evaluation.
+    Iterator IR_ALWAYS_INLINE find(TupleRow* probe_row, uint32_t hash);
+
+    // Evaluates 'probe_row' with _probe_expr_ctxs and stores its hash in 'hash'.
+    // Returns false if the row cannot match any build row because it has NULL keys
+    // and the table does not store NULLs.
+    bool IR_ALWAYS_INLINE hash_probe_row(TupleRow* probe_row, uint32_t* hash) {
+        bool has_nulls = eval_probe_row(probe_row);
+        if (!_stores_nulls && has_nulls) {
+            return false;
+        }
+        *hash = hash_current_row();
+        return true;
+    }
+
+    // Prefetches the control bytes and buckets of the first group probed for 'hash'.
+    void prefetch_bucket(uint32_t hash) const {
+        const SubTable& sub_table = _sub_tables[sub_table_idx(hash)];
+        int64_t bucket_idx = hash_group(hash, sub_table) * GROUP_SIZE;
+        __builtin_prefetch(sub_table.ctrl + bucket_idx);
+        __builtin_prefetch(&sub_table.buckets[bucket_idx]);
+    }
+
     // Returns number of elements in the hash table
     int64_t size() {
         return _num_nodes;
@@ -136,7 +189,16 @@ public:
 
     // Returns the number of buckets
     int64_t num_buckets() {
-        return _buckets.size();
+        return _num_buckets;
+    }
+
+    // Returns the number of new keys that can be inserted before any buckets are
+    // resized.
+    int64_t num_inserts_before_resize() const;
+
+    // Returns true if the table has been split into sub tables.
+    bool is_two_level() const {
+        return _sub_table_mask != 0;
     }
 
     // true if any of the MemTrackers was exceeded
@@ -146,12 +208,12 @@ public:
 
     // Returns the load factor (the number of non-empty buckets)
     float load_factor() {
-        return _num_filled_buckets / static_cast<float>(_buckets.size());
+        return _num_filled_buckets / static_cast<float>(_num_buckets);
     }
 
     // Returns the number of bytes allocated to the hash table
     int64_t byte_size() const {
-        return _node_byte_size * _nodes_capacity + sizeof(Bucket) * _buckets.size();
+        return _node_byte_size * _nodes_capacity + bucket_byte_size(_num_buckets);
     }
 
     // Returns the results of the exprs at 'expr_idx' evaluated over the last row
@@ -200,12 +262,12 @@ public:
     // stl-like iterator interface.
     class Iterator {
     public:
-        Iterator() : _table(NULL), _bucket_idx(-1), _node_idx(-1) {
+        Iterator() : _table(NULL), _sub_table_idx(-1), _bucket_idx(-1), _node_idx(-1) {
         }
 
         // Iterates to the next element.  In the case where the iterator was
-        // from a Find, this will lazily evaluate that bucket, only returning
-        // TupleRows that match the current scan row.
+        // from a Find, this only walks the rows with the same key as the
+        // current scan row.
         template<bool check_match>
         void IR_ALWAYS_INLINE next();
 
@@ -242,25 +304,30 @@ public:
         }
 
         bool operator==(const Iterator& rhs) {
-            return _bucket_idx == rhs._bucket_idx && _node_idx == rhs._node_idx;
+            return _sub_table_idx == rhs._sub_table_idx
+                && _bucket_idx == rhs._bucket_idx && _node_idx == rhs._node_idx;
         }
 
         bool operator!=(const Iterator& rhs) {
-            return _bucket_idx != rhs._bucket_idx || _node_idx != rhs._node_idx;
+            return !(*this == rhs);
         }
 
     private:
         friend class HashTable;
 
-        Iterator(HashTable* table, int bucket_idx, int64_t node, uint32_t hash) :
+        Iterator(HashTable* table, int sub_table_idx, int64_t bucket_idx,
+                 int64_t node, uint32_t hash) :
             _table(table),
+            _sub_table_idx(sub_table_idx),
             _bucket_idx(bucket_idx),
             _node_idx(node),
             _scan_hash(hash) {
         }
 
         HashTable* _table;
-        // Current bucket idx
+        // Current sub table idx
+        int _sub_table_idx;
+        // Current bucket idx (within current sub table)
         int64_t _bucket_idx;
         // Current node idx (within current bucket)
         int64_t _node_idx;
@@ -275,7 +342,7 @@ private:
     // Header portion of a Node.  The node data (TupleRow) is right after the
     // node memory to maximize cache hits.
     struct Node {
-        int64_t _next_idx;  // chain to next node for collisions
+        int64_t _next_idx;  // chain to next node with an equal key
         uint32_t _hash;     // Cache of the hash for _data
         bool matched;
 
@@ -299,9 +366,99 @@ private:
         }
     };
 
-    // Returns the next non-empty bucket and updates idx to be the index of that bucket.
-    // If there are no more buckets, returns NULL and sets idx to -1
-    Bucket* next_bucket(int64_t* bucket_idx);
+    // Plain arrays rather than vectors so that share_from() can copy sub tables
+    // without copying their buckets.
+    struct SubTable {
+        Bucket* buckets;
+        // One control byte per bucket, see EMPTY_CTRL and hash_tag().
+        uint8_t* ctrl;
+        // number of entries of 'buckets' and 'ctrl'
+        int64_t num_buckets;
+        // num_buckets / GROUP_SIZE - 1
+        int64_t group_mask;
+        // Number of non-empty buckets.  Used to determine when to grow and rehash
+        int64_t num_filled_buckets;
+        // The number of filled buckets to trigger a resize.  This is cached for
+        // efficiency
+        int64_t num_buckets_till_resize;
+    };
+
+    // Number of buckets whose control bytes are compared by one SSE2 instruction.
+    static const int GROUP_SIZE = 16;
+
+    // Number of top hash bits that pick the sub table of a two level table.
+    static const int SUB_TABLE_BITS = 8;
+    static const int NUM_SUB_TABLES = 1 << SUB_TABLE_BITS;
+
+    // Control byte of an empty bucket. Tags only use the low 7 bits, so this is the
+    // only control byte that has the high bit set.
+    static const uint8_t EMPTY_CTRL = 0x80;
+
+    static uint8_t hash_tag(uint32_t hash) {
+        return hash & 0x7f;
+    }
+
+    static int64_t hash_group(uint32_t hash, const SubTable& sub_table) {
+        return (hash >> 7) & sub_table.group_mask;
+    }
+
+    int sub_table_idx(uint32_t hash) const {
+        return (hash >> (32 - SUB_TABLE_BITS)) & _sub_table_mask;
+    }
+
+    // Returns a bit mask of the buckets in the group starting at 'ctrl' whose
+    // control byte is 'tag'.
+    static uint32_t match_tag(const uint8_t* ctrl, uint8_t tag) {
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag)));
+    }
+
+    // Returns a bit mask of the empty buckets in the group starting at 'ctrl'.
+    static uint32_t match_empty(const uint8_t* ctrl) {
+        return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)));
+    }
+
+    static int64_t bucket_byte_size(int64_t num_buckets) {
+        return num_buckets * (sizeof(Bucket) + sizeof(uint8_t));
+    }
+
+    // Probes the buckets of 'sub_table' for 'hash' comparing with the values in
+    // '_expr_values_buffer'. Returns the bucket of the matching key and sets 'found',
+    // or returns the empty bucket where the key would be inserted.  If 'lazy_eval' is
+    // true, 'probe_row' is evaluated right before the first comparison.  This is a
+    // template so that calls without it have no call site of eval_probe_row() for
+    // codegen to replace.
+    template<bool lazy_eval>
+    int64_t IR_ALWAYS_INLINE probe_bucket(const SubTable& sub_table, uint32_t hash,
+                                          TupleRow* probe_row, bool* found);
+
+    // Returns the first empty bucket in the probe sequence of 'hash'.
+    static int64_t find_empty_bucket(const SubTable& sub_table, uint32_t hash);
+
+    // Returns the next non-empty bucket and updates the indexes to be the position of
+    // that bucket.  If there are no more buckets, returns NULL and sets both to -1
+    Bucket* next_bucket(int* sub_table_idx, int64_t* bucket_idx);
+
+    // Allocates the buckets of an empty sub table.
+    static void init_sub_table(SubTable* sub_table, int64_t num_buckets);
+
+    // Frees the buckets and control bytes of 'sub_table'.
+    static void free_sub_table(SubTable* sub_table);
+
+    // Places the node at 'node_idx' with 'hash', whose key is not in the table yet,
+    // into its sub table without checking for resizes.
+    void place_node(int64_t node_idx, uint32_t hash);
+
+    // Places the appended nodes 'node_idxs' of sub tables [begin, end), chaining nodes
+    // with equal keys. Only reads the build rows, so it can run concurrently for
+    // disjoint ranges. Returns the number of buckets filled.
+    int64_t place_appended_nodes(const std::vector<int64_t>& node_idxs,
+                                 const std::vector<int64_t>& sub_table_offsets,
+                                 int begin, int end);
+
+    // Returns true if the build rows 'lhs' and 'rhs' have equal keys. Requires
+    // can_build_in_parallel().
+    bool build_rows_equal(TupleRow* lhs, TupleRow* rhs) const;
 
     // Returns node at idx.  Tracking structures do not use pointers since they will
     // change as the HashTable grows.
@@ -310,21 +467,18 @@ private:
         return reinterpret_cast<Node*>(_nodes + _node_byte_size * idx);
     }
 
-    // Resize the hash table to 'num_buckets'
-    void resize_buckets(int64_t num_buckets);
+    // Resize 'sub_table' to 'num_buckets'. Returns false if the mem limit was
+    // exceeded, unless 'force' is true, in which case the sub table is resized
+    // anyway and only _exceeded_limit is set, like grow_node_array() does.
+    bool resize_buckets(SubTable* sub_table, int64_t num_buckets, bool force = false);
+
+    // Splits the single bucket array into NUM_SUB_TABLES sub tables. Leaves the table
+    // as it is if the mem limit would be exceeded.
+    void convert_to_two_level();
 
     // Insert row into the hash table
     void IR_ALWAYS_INLINE insert_impl(TupleRow* row);
 
-    // Chains the node at 'node_idx' to 'bucket'.  Nodes in a bucket are chained
-    // as a linked list; this places the new node at the beginning of the list.
-    void add_to_bucket(Bucket* bucket, int64_t node_idx, Node* node);
-
-    // Moves a node from one bucket to another. 'previous_node' refers to the
-    // node (if any) that's chained before this node in from_bucket's linked list.
-    void move_node(Bucket* from_bucket, Bucket* to_bucket, int64_t node_idx, Node* node,
-                  Node* previous_node);
-
     // Evaluate the exprs over row and cache the results in '_expr_values_buffer'.
     // Returns whether any expr evaluated to NULL
     // This will be replaced by codegen
@@ -379,6 +533,10 @@ private:
     // defined as the number of non-empty buckets / total_buckets
     static const float MAX_BUCKET_OCCUPANCY_FRACTION;
 
+    // Number of keys after which the table is converted into sub tables, -1 if it
+    // never is.
+    int64_t _two_level_threshold;
+
     const std::vector<ExprContext*>& _build_expr_ctxs;
     const std::vector<ExprContext*>& _probe_expr_ctxs;
 
@@ -391,7 +549,7 @@ private:
     // Size of hash table nodes.  This includes a fixed size header and the Tuple*'s that
     // follow.
     const int _node_byte_size;
-    // Number of non-empty buckets.  Used to determine when to grow and rehash
+    // Number of non-empty buckets of all sub tables.
     int64_t _num_filled_buckets;
     // Memory to store node data.  This is not allocated from a pool to take advantage
     // of realloc.
@@ -405,18 +563,21 @@ private:
     bool _exceeded_limit;   // true if any of _mem_trackers[].limit_exceeded()
 
     MemTracker* _mem_tracker;
-    // Set to true if the hash table exceeds the memory limit. If this is set,
-    // subsequent calls to Insert() will be ignored.
+    // Set to true if the hash table exceeds the memory limit. Inserts still succeed,
+    // growing past the limit if they have to.
     bool _mem_limit_exceeded;
 
-    std::vector<Bucket> _buckets;
+    // true if '_nodes' and '_sub_tables' belong to another table, see share_from()
+    bool _is_shared;
 
-    // equal to _buckets.size() but more efficient than the size function
-    int64_t _num_buckets;
+    // A single sub table, or NUM_SUB_TABLES of them once the table is two level.
+    std::vector<SubTable> _sub_tables;
 
-    // The number of filled buckets to trigger a resize.  This is cached for efficiency
-    int64_t _num_buckets_till_resize;
+    // NUM_SUB_TABLES - 1 if the table is two level, 0 otherwise.
+    int _sub_table_mask;
 
+    // Number of buckets of all sub tables.
+    int64_t _num_buckets;
     // Cache of exprs values for the current row being evaluated.  This can either
     // be a build row (during insert()) or probe row (during find()).
     std::vector<int> _expr_values_buffer_offsets;
@@ -30,49 +30,116 @@ inline HashTable::Iterator HashTable::find(TupleRow* probe_row) {
     }
 
     uint32_t hash = hash_current_row();
-    int64_t bucket_idx = hash & (_num_buckets - 1);
+    int sub_idx = sub_table_idx(hash);
+    const SubTable& sub_table = _sub_tables[sub_idx];
+    bool found = false;
+    int64_t bucket_idx = probe_bucket<false>(sub_table, hash, NULL, &found);
+
+    if (found) {
+        return Iterator(this, sub_idx, bucket_idx, sub_table.buckets[bucket_idx]._node_idx,
+                        hash);
+    }
+
+    return end();
+}
+
+inline HashTable::Iterator HashTable::find(TupleRow* probe_row, uint32_t hash) {
+    int sub_idx = sub_table_idx(hash);
+    const SubTable& sub_table = _sub_tables[sub_idx];
+    bool found = false;
+    int64_t bucket_idx = probe_bucket<true>(sub_table, hash, probe_row, &found);
 
-    Bucket* bucket = &_buckets[bucket_idx];
-    int64_t node_idx = bucket->_node_idx;
+    if (found) {
+        return Iterator(this, sub_idx, bucket_idx, sub_table.buckets[bucket_idx]._node_idx,
+                        hash);
+    }
+
+    return end();
+}
+
+template<bool lazy_eval>
+inline int64_t HashTable::probe_bucket(const SubTable& sub_table, uint32_t hash,
+                                       TupleRow* probe_row, bool* found) {
+    uint8_t tag = hash_tag(hash);
+    int64_t group = hash_group(hash, sub_table);
+    bool evaluated = !lazy_eval;
+
+    for (int64_t step = 1; ; ++step) {
+        const uint8_t* ctrl = sub_table.ctrl + group * GROUP_SIZE;
+        uint32_t matches = match_tag(ctrl, tag);
+
+        while (matches != 0) {
+            int64_t bucket_idx = group * GROUP_SIZE + __builtin_ctz(matches);
+            Node* node = get_node(sub_table.buckets[bucket_idx]._node_idx);
+
+            if (node->_hash == hash) {
+                if (lazy_eval && !evaluated) {
+                    eval_probe_row(probe_row);
+                    evaluated = true;
+                }
+
+                if (equals(node->data())) {
+                    *found = true;
+                    return bucket_idx;
+                }
+            }
 
-    while (node_idx != -1) {
-        Node* node = get_node(node_idx);
+            matches &= matches - 1;
+        }
 
-        if (node->_hash == hash && equals(node->data())) {
-            return Iterator(this, bucket_idx, node_idx, hash);
+        uint32_t empty = match_empty(ctrl);
+        if (empty != 0) {
+            *found = false;
+            return group * GROUP_SIZE + __builtin_ctz(empty);
         }
 
-        node_idx = node->_next_idx;
+        group = (group + step) & sub_table.group_mask;
     }
+}
 
-    return end();
+inline int64_t HashTable::find_empty_bucket(const SubTable& sub_table, uint32_t hash) {
+    int64_t group = hash_group(hash, sub_table);
+
+    for (int64_t step = 1; ; ++step) {
+        uint32_t empty = match_empty(sub_table.ctrl + group * GROUP_SIZE);
+        if (empty != 0) {
+            return group * GROUP_SIZE + __builtin_ctz(empty);
+        }
+        group = (group + step) & sub_table.group_mask;
+    }
 }
 
 inline HashTable::Iterator HashTable::begin() {
+    int sub_idx = 0;
     int64_t bucket_idx = -1;
-    Bucket* bucket = next_bucket(&bucket_idx);
+    Bucket* bucket = next_bucket(&sub_idx, &bucket_idx);
 
     if (bucket != NULL) {
-        return Iterator(this, bucket_idx, bucket->_node_idx, 0);
+        return Iterator(this, sub_idx, bucket_idx, bucket->_node_idx, 0);
     }
 
     return end();
 }
 
-inline HashTable::Bucket* HashTable::next_bucket(int64_t* bucket_idx) {
+inline HashTable::Bucket* HashTable::next_bucket(int* sub_table_idx, int64_t* bucket_idx) {
     ++*bucket_idx;
 
-    for (; *bucket_idx < _num_buckets; ++*bucket_idx) {
-        if (_buckets[*bucket_idx]._node_idx != -1) {
-            return &_buckets[*bucket_idx];
+    for (; *sub_table_idx < _sub_tables.size(); ++*sub_table_idx, *bucket_idx = 0) {
+        SubTable& sub_table = _sub_tables[*sub_table_idx];
+        for (; *bucket_idx < sub_table.num_buckets; ++*bucket_idx) {
+            if (sub_table.ctrl[*bucket_idx] != EMPTY_CTRL) {
+                return &sub_table.buckets[*bucket_idx];
+            }
         }
     }
 
+    *sub_table_idx = -1;
     *bucket_idx = -1;
     return NULL;
 }
 
 inline void HashTable::insert_impl(TupleRow* row) {
+    DCHECK(!_is_shared);
     bool has_null = eval_build_row(row);
 
     if (!_stores_nulls && has_null) {
@@ -80,7 +147,26 @@ inline void HashTable::insert_impl(TupleRow* row) {
     }
 
     uint32_t hash = hash_current_row();
-    int64_t bucket_idx = hash & (_num_buckets - 1);
+    SubTable* sub_table = &_sub_tables[sub_table_idx(hash)];
+    bool found = false;
+    int64_t bucket_idx = probe_bucket<false>(*sub_table, hash, NULL, &found);
+
+    if (!found && sub_table->num_filled_buckets > sub_table->num_buckets_till_resize) {
+        if (!is_two_level() && _two_level_threshold != -1
+                && _num_filled_buckets >= _two_level_threshold) {
+            convert_to_two_level();
+        } else {
+            resize_buckets(sub_table, sub_table->num_buckets * 2);
+        }
+        sub_table = &_sub_tables[sub_table_idx(hash)];
+        // Probing relies on an empty bucket, so a sub table which could not grow
+        // within the mem limit has to grow anyway before it is full. The row must not
+        // be dropped, the caller sees the exceeded limit instead.
+        if (UNLIKELY(sub_table->num_filled_buckets >= sub_table->num_buckets - 1)) {
+            resize_buckets(sub_table, sub_table->num_buckets * 2, true);
+        }
+        bucket_idx = find_empty_bucket(*sub_table, hash);
+    }
 
     if (_num_nodes == _nodes_capacity) {
         grow_node_array();
@@ -90,35 +176,39 @@ inline void HashTable::insert_impl(TupleRow* row) {
     TupleRow* data = node->data();
     node->_hash = hash;
     memcpy(data, row, sizeof(Tuple*) * _num_build_tuples);
-    add_to_bucket(&_buckets[bucket_idx], _num_nodes, node);
-    ++_num_nodes;
-}
 
-inline void HashTable::add_to_bucket(Bucket* bucket, int64_t node_idx, Node* node) {
-    if (bucket->_node_idx == -1) {
+    Bucket* bucket = &sub_table->buckets[bucket_idx];
+    if (found) {
+        // Rows with an equal key are chained, the new node becomes the head.
+        node->_next_idx = bucket->_node_idx;
+    } else {
+        node->_next_idx = -1;
+        sub_table->ctrl[bucket_idx] = hash_tag(hash);
+        ++sub_table->num_filled_buckets;
         ++_num_filled_buckets;
     }
-
-    node->_next_idx = bucket->_node_idx;
-    bucket->_node_idx = node_idx;
+    bucket->_node_idx = _num_nodes;
+    ++_num_nodes;
 }
 
-inline void HashTable::move_node(Bucket* from_bucket, Bucket* to_bucket,
-                                int64_t node_idx, Node* node, Node* previous_node) {
-    int64_t next_idx = node->_next_idx;
+inline void HashTable::append(TupleRow* row) {
+    DCHECK(!_is_shared);
+    DCHECK_EQ(_num_filled_buckets, 0);
+    bool has_null = eval_build_row(row);
 
-    if (previous_node != NULL) {
-        previous_node->_next_idx = next_idx;
-    } else {
-        // Update bucket directly
-        from_bucket->_node_idx = next_idx;
+    if (!_stores_nulls && has_null) {
+        return;
+    }
 
-        if (next_idx == -1) {
-            --_num_filled_buckets;
-        }
+    if (_num_nodes == _nodes_capacity) {
+        grow_node_array();
     }
 
-    add_to_bucket(to_bucket, node_idx, node);
+    Node* node = get_node(_num_nodes);
+    node->_hash = hash_current_row();
+    node->_next_idx = -1;
+    memcpy(node->data(), row, sizeof(Tuple*) * _num_build_tuples);
+    ++_num_nodes;
 }
 
 template<bool check_match>
@@ -127,25 +217,14 @@ inline void HashTable::Iterator::next() {
         return;
     }
 
-    // TODO: this should prefetch the next tuplerow
     Node* node = _table->get_node(_node_idx);
 
-    // Iterator is not from a full table scan, evaluate equality now.  Only the current
-    // bucket needs to be scanned. '_expr_values_buffer' contains the results
-    // for the current probe row.
+    // Iterator is not from a full table scan.  All nodes chained to the bucket have
+    // the key that find() matched, so no equality checks are needed.
     if (check_match) {
-        // TODO: this should prefetch the next node
-        int64_t next_idx = node->_next_idx;
-
-        while (next_idx != -1) {
-            node = _table->get_node(next_idx);
-
-            if (node->_hash == _scan_hash && _table->equals(node->data())) {
-                _node_idx = next_idx;
-                return;
-            }
-
-            next_idx = node->_next_idx;
+        if (node->_next_idx != -1) {
+            _node_idx = node->_next_idx;
+            return;
         }
 
         *this = _table->end();
@@ -157,10 +236,9 @@ inline void HashTable::Iterator::next() {
         }
 
         // Move onto the next bucket
-        Bucket* bucket = _table->next_bucket(&_bucket_idx);
+        Bucket* bucket = _table->next_bucket(&_sub_table_idx, &_bucket_idx);
 
         if (bucket == NULL) {
-            _bucket_idx = -1;
             _node_idx = -1;
         } else {
             _node_idx = bucket->_node_idx;
@@ -0,0 +1,303 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/json_scanner.h"
+
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+#include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_pipe.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+#include "exec/plain_text_line_reader.h"
+#include "exec/local_file_reader.h"
+#include "exec/broker_reader.h"
+
+namespace doris {
+
+// size of the buffer where values of a json line are allocated,
+// values of a larger line are allocated in extra chunks
+static const size_t JSON_VALUE_BUFFER_SIZE = 64 * 1024;
+
+JsonScanner::JsonScanner(RuntimeState* state,
+                         RuntimeProfile* profile,
+                         const TBrokerScanRangeParams& params,
+                         const std::vector<TBrokerRangeDesc>& ranges,
+                         const std::vector<TNetworkAddress>& broker_addresses,
+                         ScannerCounter* counter) : BaseScanner(state, profile, params, counter),
+        _ranges(ranges),
+        _broker_addresses(broker_addresses),
+        _cur_file_reader(nullptr),
+        _cur_line_reader(nullptr),
+        _next_range(0),
+        _cur_line_reader_eof(false),
+        _scanner_eof(false) {
+}
+
+JsonScanner::~JsonScanner() {
+    close();
+}
+
+Status JsonScanner::open() {
+    RETURN_IF_ERROR(BaseScanner::open());
+    RETURN_IF_ERROR(parse_json_paths());
+    _nested_values.resize(_src_slot_descs.size());
+    _value_buf.reset(new char[JSON_VALUE_BUFFER_SIZE]);
+    _value_allocator.reset(new rapidjson::MemoryPoolAllocator<>(
+            _value_buf.get(), JSON_VALUE_BUFFER_SIZE));
+    _doc.reset(new rapidjson::Document(_value_allocator.get()));
+    return Status::OK();
+}
+
+Status JsonScanner::parse_json_paths() {
+    if (!_params.__isset.json_paths) {
+        for (auto slot_desc : _src_slot_descs) {
+            _json_paths.push_back({slot_desc->col_name()});
+        }
+        return Status::OK();
+    }
+    if (_params.json_paths.size() != _src_slot_descs.size()) {
+        std::stringstream ss;
+        ss << "number of json paths is not the number of source columns. "
+            << "json paths number: " << _params.json_paths.size() << ", "
+            << "source columns number: " << _src_slot_descs.size();
+        return Status::InternalError(ss.str());
+    }
+    for (auto& json_path : _params.json_paths) {
+        std::string path = json_path;
+        if (boost::starts_with(path, "$.")) {
+            path = path.substr(2);
+        }
+        std::vector<std::string> keys;
+        boost::split(keys, path, boost::is_any_of("."));
+        for (auto& key : keys) {
+            if (key.empty()) {
+                std::stringstream ss;
+                ss << "invalid json path: " << json_path;
+                return Status::InternalError(ss.str());
+            }
+        }
+        _json_paths.push_back(std::move(keys));
+    }
+    return Status::OK();
+}
+
+Status JsonScanner::get_next(Tuple* tuple, MemPool* tuple_pool, bool* eof) {
+    SCOPED_TIMER(_read_timer);
+    // Get one line
+    while (!_scanner_eof) {
+        if (_cur_line_reader == nullptr || _cur_line_reader_eof) {
+            RETURN_IF_ERROR(open_next_reader());
+            // If there isn't any more reader, break this
+            if (_scanner_eof) {
+                continue;
+            }
+        }
+        const uint8_t* ptr = nullptr;
+        size_t size = 0;
+        RETURN_IF_ERROR(_cur_line_reader->read_line(
+                &ptr, &size, &_cur_line_reader_eof));
+        if (size == 0) {
+            // Read empty row, just continue
+            continue;
+        }
+        {
+            COUNTER_UPDATE(_rows_read_counter, 1);
+            SCOPED_TIMER(_materialize_timer);
+            _counter->num_rows_total++;
+            Slice line(ptr, size);
+            if (line_to_src_tuple(line) && fill_dest_tuple(line, tuple, tuple_pool)) {
+                break;
+            }
+        }
+    }
+    if (_scanner_eof) {
+        *eof = true;
+    } else {
+        *eof = false;
+    }
+    return Status::OK();
+}
+
+Status JsonScanner::open_next_reader() {
+    if (_next_range >= _ranges.size()) {
+        _scanner_eof = true;
+        return Status::OK();
+    }
+
+    RETURN_IF_ERROR(open_file_reader());
+    if (_cur_line_reader != nullptr) {
+        delete _cur_line_reader;
+        _cur_line_reader = nullptr;
+    }
+    const TBrokerRangeDesc& range = _ranges[_next_range];
+    _cur_line_reader = new PlainTextLineReader(
+            _profile, _cur_file_reader, nullptr, range.size, '\n');
+    _cur_line_reader_eof = false;
+    _next_range++;
+    return Status::OK();
+}
+
+Status JsonScanner::open_file_reader() {
+    if (_cur_file_reader != nullptr) {
+        if (_stream_load_pipe != nullptr) {
+            _stream_load_pipe.reset();
+            _cur_file_reader = nullptr;
+        } else {
+            delete _cur_file_reader;
+            _cur_file_reader = nullptr;
+        }
+    }
+
+    const TBrokerRangeDesc& range = _ranges[_next_range];
+    if (range.start_offset != 0) {
+        return Status::InternalError("For now we do not support split json file");
+    }
+    switch (range.file_type) {
+    case TFileType::FILE_LOCAL: {
+        LocalFileReader* file_reader = new LocalFileReader(range.path, 0);
+        RETURN_IF_ERROR(file_reader->open());
+        _cur_file_reader = file_reader;
+        break;
+    }
+    case TFileType::FILE_BROKER: {
+        BrokerReader* broker_reader = new BrokerReader(
+            _state->exec_env(), _broker_addresses, _params.properties, range.path, 0);
+        RETURN_IF_ERROR(broker_reader->open());
+        _cur_file_reader = broker_reader;
+        break;
+    }
+    case TFileType::FILE_STREAM: {
+        _stream_load_pipe = _state->exec_env()->load_stream_mgr()->get(range.load_id);
+        if (_stream_load_pipe == nullptr) {
+            VLOG(3) << "unknown stream load id: " << UniqueId(range.load_id);
+            return Status::InternalError("unknown stream load id");
+        }
+        _cur_file_reader = _stream_load_pipe.get();
+        break;
+    }
+    default: {
+        std::stringstream ss;
+        ss << "Unknown file type, type=" << range.file_type;
+        return Status::InternalError(ss.str());
+    }
+    }
+    return Status::OK();
+}
+
+void JsonScanner::close() {
+    if (_cur_line_reader != nullptr) {
+        delete _cur_line_reader;
+        _cur_line_reader = nullptr;
+    }
+
+    if (_cur_file_reader != nullptr) {
+        if (_stream_load_pipe != nullptr) {
+            _stream_load_pipe.reset();
+            _cur_file_reader = nullptr;
+        } else {
+            delete _cur_file_reader;
+            _cur_file_reader = nullptr;
+        }
+    }
+}
+
+const rapidjson::Value* JsonScanner::find_value(
+        const rapidjson::Value& object, const std::vector<std::string>& path) const {
+    const rapidjson::Value* value = &object;
+    for (auto& key : path) {
+        if (!value->IsObject()) {
+            return nullptr;
+        }
+        auto it = value->FindMember(key.c_str());
+        if (it == value->MemberEnd()) {
+            return nullptr;
+        }
+        value = &it->value;
+    }
+    return value;
+}
+
+bool JsonScanner::line_to_src_tuple(const Slice& line) {
+    // numbers are kept as their text, which is converted by the exprs of dest slots
+    // as the fields of csv lines
+    _line_buf.assign(line.data, line.data + line.size);
+    _line_buf.push_back('\0');
+    _value_allocator->Clear();
+    _doc->ParseInsitu<rapidjson::kParseNumbersAsStringsFlag
+        | rapidjson::kParseValidateEncodingFlag>(_line_buf.data());
+    if (_doc->HasParseError() || !_doc->IsObject()) {
+        std::stringstream error_msg;
+        if (_doc->HasParseError()) {
+            error_msg << "parse json failed: " << rapidjson::GetParseError_En(_doc->GetParseError())
+                << " offset: " << _doc->GetErrorOffset();
+        } else {
+            error_msg << "json line is not an object";
+        }
+        _state->append_error_msg_to_file(std::string(line.data, line.size), error_msg.str());
+        _counter->num_rows_filtered++;
+        return false;
+    }
+
+    for (int i = 0; i < _src_slot_descs.size(); ++i) {
+        auto slot_desc = _src_slot_descs[i];
+        const rapidjson::Value* value = find_value(*_doc, _json_paths[i]);
+        if (value == nullptr || value->IsNull()) {
+            if (!slot_desc->is_nullable()) {
+                std::stringstream error_msg;
+                error_msg << "value is null while source column is not nullable. "
+                    << "json path: " << boost::join(_json_paths[i], ".") << "; ";
+                _state->append_error_msg_to_file(std::string(line.data, line.size),
+                                                 error_msg.str());
+                _counter->num_rows_filtered++;
+                return false;
+            }
+            _src_tuple->set_null(slot_desc->null_indicator_offset());
+            continue;
+        }
+        _src_tuple->set_not_null(slot_desc->null_indicator_offset());
+        void* slot = _src_tuple->get_slot(slot_desc->tuple_offset());
+        StringValue* str_slot = reinterpret_cast<StringValue*>(slot);
+        if (value->IsString()) {
+            str_slot->ptr = const_cast<char*>(value->GetString());
+            str_slot->len = value->GetStringLength();
+        } else if (value->IsBool()) {
+            str_slot->ptr = const_cast<char*>(value->GetBool() ? "true" : "false");
+            str_slot->len = value->GetBool() ? 4 : 5;
+        } else {
+            // objects and arrays are loaded as their json text
+            rapidjson::StringBuffer buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            value->Accept(writer);
+            std::string& text = _nested_values[i];
+            text.assign(buffer.GetString(), buffer.GetSize());
+            str_slot->ptr = const_cast<char*>(text.data());
+            str_slot->len = text.size();
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+#include "exec/base_scanner.h"
+#include "common/status.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "gen_cpp/Types_types.h"
+#include "util/slice.h"
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+class Tuple;
+class SlotDescriptor;
+class FileReader;
+class LineReader;
+class RuntimeState;
+class RuntimeProfile;
+class StreamLoadPipe;
+
+// Json scanner converts lines of json objects to doris's tuple.
+// Every line of the file is one json object, and the values of source slots are
+// found by the json paths of the load, or by the names of the slots if there aren't.
+class JsonScanner : public BaseScanner {
+public:
+    JsonScanner(
+        RuntimeState* state,
+        RuntimeProfile* profile,
+        const TBrokerScanRangeParams& params,
+        const std::vector<TBrokerRangeDesc>& ranges,
+        const std::vector<TNetworkAddress>& broker_addresses,
+        ScannerCounter* counter);
+    ~JsonScanner();
+
+    // Open this scanner, will initialize information need to
+    Status open() override;
+
+    // Get next tuple
+    Status get_next(Tuple* tuple, MemPool* tuple_pool, bool* eof) override;
+
+    // Close this scanner
+    void close() override;
+
+private:
+    // Parse json paths of source slots, like "$.k1" or "$.k2.a"
+    Status parse_json_paths();
+    Status open_file_reader();
+    Status open_next_reader();
+
+    // Find the value of path in the object, nullptr if it doesn't exist
+    const rapidjson::Value* find_value(
+        const rapidjson::Value& object, const std::vector<std::string>& path) const;
+
+    // Parse one line and point the source slots to the values of their paths
+    bool line_to_src_tuple(const Slice& line);
+
+private:
+    const std::vector<TBrokerRangeDesc>& _ranges;
+    const std::vector<TNetworkAddress>& _broker_addresses;
+
+    // keys to the value of each source slot
+    std::vector<std::vector<std::string>> _json_paths;
+
+    // Lines are parsed in place, so the strings of the document point to this buffer
+    std::vector<char> _line_buf;
+    // Values of the document are allocated in this buffer, which is reused by every line
+    std::unique_ptr<char[]> _value_buf;
+    std::unique_ptr<rapidjson::MemoryPoolAllocator<>> _value_allocator;
+    std::unique_ptr<rapidjson::Document> _doc;
+    // text of objects and arrays of the line being converted
+    std::vector<std::string> _nested_values;
+
+    // Reader
+    FileReader* _cur_file_reader;
+    LineReader* _cur_line_reader;
+    int _next_range;
+    bool _cur_line_reader_eof;
+    bool _scanner_eof;
+
+    // used to hold current StreamLoadPipe
+    std::shared_ptr<StreamLoadPipe> _stream_load_pipe;
+};
+
+}
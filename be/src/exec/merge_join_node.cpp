@@ -22,6 +22,7 @@
 #include "exprs/expr.h"
 #include "exprs/in_predicate.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/debug_util.h"
@@ -29,25 +30,14 @@
 
 namespace doris {
 
-template<class T>
-int compare_value(const void* left_value,  const void* right_value) {
-    if (*(T*)left_value < * (T*)right_value) {
-        return -1;
-    } else if (*(T*)left_value == *(T*)right_value) {
-        return 0;
-    } else {
-        return 1;
-    }
-}
-
-template<class T>
-int compare_value(const StringValue* left_value,  const StringValue* right_value) {
-    return left_value->compare(*right_value);
-}
-
 MergeJoinNode::MergeJoinNode(
         ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs) :
             ExecNode(pool, tnode, descs),
+            _eos(false),
+            _right_group_idx(0),
+            _in_right_group(false),
+            _right_tuple_size(0),
+            _left_tuple_row_size(0),
             _out_batch(NULL) {
 }
 
@@ -77,43 +67,22 @@ Status MergeJoinNode::init(const TPlanNode& tnode, RuntimeState* state) {
 Status MergeJoinNode::prepare(RuntimeState* state) {
     RETURN_IF_ERROR(ExecNode::prepare(state));
 
-    // build and probe exprs are evaluated in the context of the rows produced by our
-    // right and left children, respectively
+    // join exprs are evaluated in the context of the rows produced by our
+    // left and right children, respectively
     RETURN_IF_ERROR(Expr::prepare(
             _left_expr_ctxs, state, child(0)->row_desc(), expr_mem_tracker()));
     RETURN_IF_ERROR(Expr::prepare(
             _right_expr_ctxs, state, child(1)->row_desc(), expr_mem_tracker()));
 
+    // both children are ordered by values of the join exprs, which are compared as such
     for (int i = 0; i < _left_expr_ctxs.size(); ++i) {
-        switch (_left_expr_ctxs[i]->root()->type().type) {
-        case TYPE_TINYINT:
-            _cmp_func.push_back(compare_value<int8_t>);
-            break;
-
-        case TYPE_SMALLINT:
-            _cmp_func.push_back(compare_value<int16_t>);
-            break;
-
-        case TYPE_INT:
-            _cmp_func.push_back(compare_value<int32_t>);
-            break;
-
-        case TYPE_BIGINT:
-            _cmp_func.push_back(compare_value<int64_t>);
-            break;
-
-        case TYPE_LARGEINT:
-            _cmp_func.push_back(compare_value<__int128>);
-            break;
-
-        case TYPE_CHAR:
-        case TYPE_VARCHAR:
-            _cmp_func.push_back(compare_value<StringValue>);
-            break;
-
-        default:
-            return Status::InternalError("unspport compare type.");
-            break;
+        const TypeDescriptor& left_type = _left_expr_ctxs[i]->root()->type();
+        const TypeDescriptor& right_type = _right_expr_ctxs[i]->root()->type();
+        if (!(left_type == right_type) || left_type.is_complex_type()) {
+            std::stringstream ss;
+            ss << "unsupported merge join exprs of type " << left_type.debug_string()
+               << " and " << right_type.debug_string();
+            return Status::InternalError(ss.str());
         }
     }
 
@@ -121,10 +90,8 @@ Status MergeJoinNode::prepare(RuntimeState* state) {
     RETURN_IF_ERROR(Expr::prepare(
             _other_join_conjunct_ctxs, state, _row_descriptor, expr_mem_tracker()));
 
-    _result_tuple_row_size = _row_descriptor.tuple_descriptors().size() * sizeof(Tuple*);
-    // pre-compute the tuple index of build tuples in the output row
-
-    _left_tuple_size = child(0)->row_desc().tuple_descriptors().size();
+    // pre-compute the tuple index of right tuples in the output row
+    _left_tuple_row_size = child(0)->row_desc().tuple_descriptors().size() * sizeof(Tuple*);
     _right_tuple_size = child(1)->row_desc().tuple_descriptors().size();
     _right_tuple_idx.reserve(_right_tuple_size);
 
@@ -133,10 +100,10 @@ Status MergeJoinNode::prepare(RuntimeState* state) {
         _right_tuple_idx.push_back(_row_descriptor.get_tuple_idx(right_tuple_desc->id()));
     }
 
-    _left_child_ctx.reset(
-            new ChildReaderContext(row_desc(), state->batch_size(), state->instance_mem_tracker()));
-    _right_child_ctx.reset(
-            new ChildReaderContext(row_desc(), state->batch_size(), state->instance_mem_tracker()));
+    _left_child_ctx.reset(new ChildReaderContext(
+            child(0)->row_desc(), state->batch_size(), state->instance_mem_tracker()));
+    _right_child_ctx.reset(new ChildReaderContext(
+            child(1)->row_desc(), state->batch_size(), state->instance_mem_tracker()));
 
     return Status::OK();
 }
@@ -146,6 +113,10 @@ Status MergeJoinNode::close(RuntimeState* state) {
         return Status::OK();
     }
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::CLOSE));
+    _right_group.clear();
+    _right_group_batches.clear();
+    _left_child_ctx.reset();
+    _right_child_ctx.reset();
     Expr::close(_left_expr_ctxs, state);
     Expr::close(_right_expr_ctxs, state);
     Expr::close(_other_join_conjunct_ctxs, state);
@@ -161,9 +132,6 @@ Status MergeJoinNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(Expr::open(_other_join_conjunct_ctxs, state));
 
     _eos = false;
-    // Open the probe-side child so that it may perform any initialisation in parallel.
-    // Don't exit even if we see an error, we still need to wait for the build thread
-    // to finish.
     RETURN_IF_ERROR(child(0)->open(state));
     RETURN_IF_ERROR(child(1)->open(state));
 
@@ -177,152 +145,179 @@ Status MergeJoinNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* e
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
 
     if (reached_limit() || _eos) {
         *eos = true;
         return Status::OK();
     }
 
-    while (true) {
-        int row_idx = out_batch->add_row();
-        DCHECK(row_idx != RowBatch::INVALID_ROW_INDEX);
-        TupleRow* row = out_batch->get_row(row_idx);
-
-        _out_batch = out_batch;
-        RETURN_IF_ERROR(get_next_row(state, row, eos));
+    _out_batch = out_batch;
+    ExprContext* const* other_conjunct_ctxs = _other_join_conjunct_ctxs.data();
+    int num_other_conjunct_ctxs = _other_join_conjunct_ctxs.size();
+    ExprContext* const* conjunct_ctxs = _conjunct_ctxs.data();
+    int num_conjunct_ctxs = _conjunct_ctxs.size();
+
+    while (!_eos && !out_batch->is_full() && !out_batch->at_resource_limit()) {
+        if (_in_right_group) {
+            // join the current left row with the right rows of its key
+            TupleRow* left_row = _left_child_ctx->current_row;
+            while (_right_group_idx < _right_group.size() && !out_batch->is_full()) {
+                int row_idx = out_batch->add_row();
+                TupleRow* out_row = out_batch->get_row(row_idx);
+                create_output_row(out_row, left_row, _right_group[_right_group_idx++]);
+                if (eval_conjuncts(other_conjunct_ctxs, num_other_conjunct_ctxs, out_row)
+                        && eval_conjuncts(conjunct_ctxs, num_conjunct_ctxs, out_row)) {
+                    out_batch->commit_last_row();
+                    ++_num_rows_returned;
+                    if (reached_limit()) {
+                        _eos = true;
+                        break;
+                    }
+                }
+            }
+            if (_eos || _right_group_idx < _right_group.size()) {
+                break;
+            }
+
+            RETURN_IF_ERROR(get_input_row(state, 0));
+            left_row = _left_child_ctx->current_row;
+            if (left_row != NULL && !has_null_key(_left_expr_ctxs, left_row)
+                    && compare_row(_left_expr_ctxs, left_row,
+                                   _right_expr_ctxs, _right_group[0]) == 0) {
+                _right_group_idx = 0;
+            } else {
+                release_right_group();
+            }
+            continue;
+        }
 
-        if (*eos) {
+        TupleRow* left_row = _left_child_ctx->current_row;
+        TupleRow* right_row = _right_child_ctx->current_row;
+        if (left_row == NULL || right_row == NULL) {
             _eos = true;
-            return Status::OK();
+            break;
         }
-
-        if (eval_conjuncts(&_other_join_conjunct_ctxs[0], _other_join_conjunct_ctxs.size(), row)) {
-            out_batch->commit_last_row();
-            ++_num_rows_returned;
-            COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+        if (has_null_key(_left_expr_ctxs, left_row)) {
+            RETURN_IF_ERROR(get_input_row(state, 0));
+            continue;
+        }
+        if (has_null_key(_right_expr_ctxs, right_row)) {
+            RETURN_IF_ERROR(get_input_row(state, 1));
+            continue;
         }
 
-        if (out_batch->is_full() || out_batch->at_resource_limit() || reached_limit()) {
-            break;
+        int cmp = compare_row(_left_expr_ctxs, left_row, _right_expr_ctxs, right_row);
+        if (cmp < 0) {
+            RETURN_IF_ERROR(get_input_row(state, 0));
+        } else if (cmp > 0) {
+            RETURN_IF_ERROR(get_input_row(state, 1));
+        } else {
+            RETURN_IF_ERROR(build_right_group(state));
+            _right_group_idx = 0;
+            _in_right_group = true;
         }
     }
 
+    if (_eos) {
+        transfer_all_resources(out_batch);
+    }
+    _out_batch = NULL;
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    *eos = _eos;
     return Status::OK();
 }
 
 void MergeJoinNode::create_output_row(TupleRow* out, TupleRow* left, TupleRow* right) {
-    if (left == NULL) {
-        memset(out, 0, _left_tuple_size);
-    } else {
-        memcpy(out, left, _left_tuple_size);
+    memcpy(out, left, _left_tuple_row_size);
+    for (int i = 0; i < _right_tuple_size; ++i) {
+        out->set_tuple(_right_tuple_idx[i], right->get_tuple(i));
     }
+}
 
-    if (right != NULL) {
-        for (int i = 0; i < _right_tuple_size; ++i) {
-            out->set_tuple(_right_tuple_idx[i], right->get_tuple(i));
-        }
-    } else {
-        for (int i = 0; i < _right_tuple_size; ++i) {
-            out->set_tuple(_right_tuple_idx[i], NULL);
+int MergeJoinNode::compare_row(const std::vector<ExprContext*>& lhs_ctxs, TupleRow* lhs,
+                               const std::vector<ExprContext*>& rhs_ctxs, TupleRow* rhs) {
+    for (int i = 0; i < lhs_ctxs.size(); ++i) {
+        void* lhs_value = lhs_ctxs[i]->get_value(lhs);
+        void* rhs_value = rhs_ctxs[i]->get_value(rhs);
+        int cmp = RawValue::compare(lhs_value, rhs_value, lhs_ctxs[i]->root()->type());
+        if (cmp != 0) {
+            return cmp;
         }
     }
+    return 0;
 }
 
-Status MergeJoinNode::compare_row(TupleRow* left_row, TupleRow* right_row, bool* is_lt) {
-    if (left_row == NULL) {
-        *is_lt = false;
-        return Status::OK();
-    } else if (right_row == NULL) {
-        *is_lt = true;
-        return Status::OK();
+bool MergeJoinNode::has_null_key(const std::vector<ExprContext*>& ctxs, TupleRow* row) {
+    for (auto ctx : ctxs) {
+        if (ctx->get_value(row) == NULL) {
+            return true;
+        }
     }
+    return false;
+}
 
-    for (int i = 0; i < _left_expr_ctxs.size(); ++i) {
-        void* left_value = _left_expr_ctxs[i]->get_value(left_row);
-        void* right_value = _right_expr_ctxs[i]->get_value(right_row);
-        int cmp_val = _cmp_func[i](left_value, right_value);
-
-        if (cmp_val < 0) {
-            *is_lt = true;
-            return Status::OK();
-        } else if (cmp_val == 0) {
-            // do nothing
-        } else {
-            *is_lt = false;
-            return Status::OK();
+Status MergeJoinNode::build_right_group(RuntimeState* state) {
+    DCHECK(_right_group.empty());
+    TupleRow* first_row = _right_child_ctx->current_row;
+    _right_group.push_back(first_row);
+    while (true) {
+        RETURN_IF_ERROR(get_input_row(state, 1));
+        TupleRow* row = _right_child_ctx->current_row;
+        if (row == NULL || has_null_key(_right_expr_ctxs, row)
+                || compare_row(_right_expr_ctxs, first_row, _right_expr_ctxs, row) != 0) {
+            break;
         }
+        _right_group.push_back(row);
     }
-
-    // equal
-    *is_lt = false;
-
     return Status::OK();
 }
 
-Status MergeJoinNode::get_next_row(RuntimeState* state, TupleRow* out_row, bool* eos) {
-    TupleRow* left_row = _left_child_ctx->current_row;
-    TupleRow* right_row = _right_child_ctx->current_row;
-
-    if (left_row == NULL && right_row == NULL) {
-        *eos = true;
-        return Status::OK();
+void MergeJoinNode::release_right_group() {
+    for (auto& batch : _right_group_batches) {
+        batch->transfer_resource_ownership(_out_batch);
     }
+    _right_group_batches.clear();
+    _right_group.clear();
+    _in_right_group = false;
+}
 
-    bool is_lt = true;
-    RETURN_IF_ERROR(compare_row(left_row, right_row, &is_lt));
-
-    if (is_lt) {
-        create_output_row(out_row, left_row, NULL);
-        RETURN_IF_ERROR(get_input_row(state, 0));
-    } else {
-        create_output_row(out_row, NULL, right_row);
-        RETURN_IF_ERROR(get_input_row(state, 1));
+void MergeJoinNode::transfer_all_resources(RowBatch* batch) {
+    for (auto& group_batch : _right_group_batches) {
+        group_batch->transfer_resource_ownership(batch);
     }
-
-    return Status::OK();
+    _right_group_batches.clear();
+    _left_child_ctx->batch->transfer_resource_ownership(batch);
+    _right_child_ctx->batch->transfer_resource_ownership(batch);
 }
 
 Status MergeJoinNode::get_input_row(RuntimeState* state, int child_idx) {
-    ChildReaderContext* ctx = NULL;
-
-    if (child_idx == 0) {
-        ctx = _left_child_ctx.get();
-    } else {
-        ctx = _right_child_ctx.get();
-    }
+    ChildReaderContext* ctx = child_idx == 0 ? _left_child_ctx.get() : _right_child_ctx.get();
 
     // loop util read a valid data
-    while (!ctx->is_eos && ctx->row_idx >= ctx->batch.num_rows()) {
-        // transfer ownership before get new batch
-        if (NULL != _out_batch) {
-            ctx->batch.transfer_resource_ownership(_out_batch);
-        }
-
-        if (child_idx == 0) {
-            _left_child_ctx.reset(
-                    new ChildReaderContext(
-                            child(child_idx)->row_desc(),
-                            state->batch_size(),
-                            state->instance_mem_tracker()));
-            ctx = _left_child_ctx.get();
+    while (!ctx->is_eos && ctx->row_idx >= ctx->batch->num_rows()) {
+        if (child_idx == 1 && !_right_group.empty()) {
+            // rows of the batch are still to be joined
+            _right_group_batches.push_back(std::move(ctx->batch));
+            ctx->batch.reset(new RowBatch(
+                    child(1)->row_desc(), state->batch_size(), state->instance_mem_tracker()));
         } else {
-            _right_child_ctx.reset(
-                    new ChildReaderContext(
-                            child(child_idx)->row_desc(),
-                            state->batch_size(),
-                            state->instance_mem_tracker()));
-            ctx = _right_child_ctx.get();
+            // transfer ownership before get new batch
+            if (NULL != _out_batch) {
+                ctx->batch->transfer_resource_ownership(_out_batch);
+            }
+            ctx->batch->reset();
         }
-
-        RETURN_IF_ERROR(child(child_idx)->get_next(state, &ctx->batch, &ctx->is_eos));
+        ctx->row_idx = 0;
+        RETURN_IF_ERROR(child(child_idx)->get_next(state, ctx->batch.get(), &ctx->is_eos));
     }
 
-    if (ctx->row_idx >= ctx->batch.num_rows()) {
+    if (ctx->row_idx >= ctx->batch->num_rows()) {
         ctx->current_row = NULL;
         return Status::OK();
     }
 
-    ctx->current_row = ctx->batch.get_row(ctx->row_idx++);
+    ctx->current_row = ctx->batch->get_row(ctx->row_idx++);
     return Status::OK();
 }
 
@@ -331,6 +326,7 @@ void MergeJoinNode::debug_string(int indentation_level, stringstream* out) const
     *out << "MergeJoin(eos=" << (_eos ? "true" : "false")
          << " _left_child_pos=" << (_left_child_ctx.get() ? _left_child_ctx->row_idx : -1)
          << " _right_child_pos=" << (_right_child_ctx.get() ? _right_child_ctx->row_idx : -1)
+         << " _right_group_size=" << _right_group.size()
          << " join_conjuncts=";
     *out << "Conjunct(";
          // << " left_exprs=" << Expr::debug_string(_left_exprs)
@@ -341,4 +337,3 @@ void MergeJoinNode::debug_string(int indentation_level, stringstream* out) const
 }
 
 }
-
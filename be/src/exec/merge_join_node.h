@@ -21,7 +21,9 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/unordered_set.hpp>
 #include <boost/thread.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "exec/exec_node.h"
 #include "runtime/row_batch.h"
@@ -32,8 +34,12 @@ namespace doris {
 class MemPool;
 class TupleRow;
 
-// Node for in-memory merge joins:
-// find the minimal tuple and output
+// Node for inner equi-joins of two children whose rows are ordered by the join exprs,
+// e.g. scans of colocated tables bucketed and ordered by the join keys
+// (TOlapScanNode.ordered_by_keys). Both children are streamed: the right rows of the
+// current join key are kept while the left rows of that key are joined with them, so
+// only the largest group of right rows with equal keys is held in memory.
+// Rows with NULL join keys never match and are skipped.
 class MergeJoinNode : public ExecNode {
 public:
     MergeJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -54,7 +60,6 @@ protected:
 private:
     // our equi-join predicates "<lhs> = <rhs>" are separated into
     // _left_exprs (over child(0)) and _right_exprs (over child(1))
-    // check which expr is min
     std::vector<ExprContext*> _left_expr_ctxs;
     std::vector<ExprContext*> _right_expr_ctxs;
 
@@ -64,36 +69,52 @@ private:
     bool _eos;            // if true, nothing left to return in get_next()
 
     struct ChildReaderContext {
-        RowBatch batch;
+        std::unique_ptr<RowBatch> batch;
         int row_idx;
         bool is_eos;
         TupleRow* current_row;
         ChildReaderContext(const RowDescriptor& desc, int batch_size, MemTracker* mem_tracker) :
-            batch(desc, batch_size, mem_tracker), row_idx(0), is_eos(false), current_row(NULL) {
+            batch(new RowBatch(desc, batch_size, mem_tracker)), row_idx(0), is_eos(false),
+            current_row(NULL) {
         }
     };
-    // _left_batch must be cleared before calling get_next().  used cache child(0)'s data
-    // _rigth_batch must be cleared before calling get_next().  used cache child(1)'s data
-    // does not initialize all tuple ptrs in the row, only the ones that it
-    // is responsible for.
+    // current_row of a child is NULL once all its rows are read
     boost::scoped_ptr<ChildReaderContext> _left_child_ctx;
     boost::scoped_ptr<ChildReaderContext> _right_child_ctx;
-    // _build_tuple_idx[i] is the tuple index of child(1)'s tuple[i] in the output row
+
+    // Right rows with the same join key, which are joined with every left row of that
+    // key. _right_group_idx is the next one to join with the current left row.
+    std::vector<TupleRow*> _right_group;
+    int _right_group_idx;
+    // True if the current left row has the join key of _right_group.
+    bool _in_right_group;
+    // Batches of the right child read past while collecting _right_group. They are
+    // kept until the group is done, then their resources go to the output batch.
+    std::vector<std::unique_ptr<RowBatch>> _right_group_batches;
+
+    // _right_tuple_idx[i] is the tuple index of child(1)'s tuple[i] in the output row
     std::vector<int> _right_tuple_idx;
     int _right_tuple_size;
-    int _left_tuple_size;
+    // byte size of the tuple pointers of child(0)'s row, which lead the output row
+    int _left_tuple_row_size;
+    // Batch being filled by get_next(), which takes the resources of the input
+    // batches read past.
     RowBatch* _out_batch;
 
-    typedef int (*CompareFn)(const void*, const void*);
-    std::vector<CompareFn> _cmp_func;
-
-    // byte size of result tuple row (sum of the tuple ptrs, not the tuple data).
-    // This should be the same size as the probe tuple row.
-    int _result_tuple_row_size;
-
     void create_output_row(TupleRow* out, TupleRow* left, TupleRow* right);
-    Status compare_row(TupleRow* left_row, TupleRow* right_row, bool* is_lt);
-    Status get_next_row(RuntimeState* state, TupleRow* out_row, bool* eos);
+    // Returns a negative value, 0 or a positive value if the join key of 'lhs'
+    // (evaluated by 'lhs_ctxs') is less than, equal to or greater than that of 'rhs'.
+    // Neither key may contain NULL.
+    int compare_row(const std::vector<ExprContext*>& lhs_ctxs, TupleRow* lhs,
+                    const std::vector<ExprContext*>& rhs_ctxs, TupleRow* rhs);
+    static bool has_null_key(const std::vector<ExprContext*>& ctxs, TupleRow* row);
+    // Collects the current right row and the following ones with the same join key
+    // into _right_group.
+    Status build_right_group(RuntimeState* state);
+    // Ends the current group of right rows.
+    void release_right_group();
+    // Transfers the resources of all input batches to 'batch' at eos.
+    void transfer_all_resources(RowBatch* batch);
     Status get_input_row(RuntimeState* state, int child_idx);
 };
 
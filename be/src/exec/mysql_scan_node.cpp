@@ -116,7 +116,8 @@ Status MysqlScanNode::open(RuntimeState* state) {
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
     RETURN_IF_ERROR(_mysql_scanner->open());
-    RETURN_IF_ERROR(_mysql_scanner->query(_table_name, _columns, _filters));
+    // all conjuncts are pushed to mysql as filters, so limit can be pushed too
+    RETURN_IF_ERROR(_mysql_scanner->query(_table_name, _columns, _filters, _limit));
     // check materialize slot num
     int materialize_num = 0;
 
@@ -159,6 +160,7 @@ Status MysqlScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* e
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     SCOPED_TIMER(materialize_tuple_timer());
 
     if (reached_limit()) {
@@ -255,6 +257,8 @@ Status MysqlScanNode::close(RuntimeState* state) {
         COUNTER_UPDATE(memory_used_counter(), _tuple_pool->peak_allocated_bytes());
     }
     _tuple_pool.reset();
+    // release the mysql connection and the rest of the result set
+    _mysql_scanner.reset();
 
     return ExecNode::close(state);
 }
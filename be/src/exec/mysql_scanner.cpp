@@ -96,13 +96,15 @@ Status MysqlScanner::query(const std::string& query) {
     // clean the last query result
     if (_my_result) {
         mysql_free_result(_my_result);
+        _my_result = NULL;
     }
 
-    // use store result because mysql table is small, can load in memory avoid of many RPC
-    _my_result = mysql_store_result(_my_conn);
+    // use result to fetch rows one by one from server instead of loading the whole
+    // result set in memory, which may be too large to hold when mysql table is large
+    _my_result = mysql_use_result(_my_conn);
 
     if (NULL == _my_result) {
-        return _error_status("mysql store result failed.");
+        return _error_status("mysql use result failed.");
     }
 
     _field_num = mysql_num_fields(_my_result);
@@ -111,7 +113,7 @@ Status MysqlScanner::query(const std::string& query) {
 }
 
 Status MysqlScanner::query(const std::string& table, const std::vector<std::string>& fields,
-                           const std::vector<std::string>& filters) {
+                           const std::vector<std::string>& filters, int64_t limit) {
     if (!_is_open) {
         return Status::InternalError("Query before open.");
     }
@@ -140,6 +142,10 @@ Status MysqlScanner::query(const std::string& table, const std::vector<std::stri
         }
     }
 
+    if (limit != -1) {
+        _sql_str += " LIMIT " + std::to_string(limit);
+    }
+
     return query(_sql_str);
 }
 
@@ -159,6 +165,10 @@ Status MysqlScanner::get_next_row(char** *buf, unsigned long** lengths, bool* eo
     *buf = mysql_fetch_row(_my_result);
 
     if (NULL == *buf) {
+        // rows are fetched from server when streaming, NULL may be a network error
+        if (0 != mysql_errno(_my_conn)) {
+            return _error_status("mysql fetch row failed.");
+        }
         *eos = true;
         return Status::OK();
     }
@@ -18,6 +18,7 @@
 #ifndef  DORIS_BE_SRC_QUERY_EXEC_MYSQL_SCANNER_H
 #define  DORIS_BE_SRC_QUERY_EXEC_MYSQL_SCANNER_H
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string>
 #include <vector>
@@ -54,9 +55,12 @@ public:
     Status open();
     Status query(const std::string& query);
 
-    // query for DORIS
+    // query for DORIS, 'limit' is pushed into the sql if it is not -1,
+    // so all conjuncts of the query must be in 'filters'
     Status query(const std::string& table, const std::vector<std::string>& fields,
-                 const std::vector<std::string>& filters);
+                 const std::vector<std::string>& filters, int64_t limit = -1);
+    // rows are streamed from mysql server, so the connection can not be used
+    // for another query until all rows are fetched
     Status get_next_row(char** *buf, unsigned long** lengths, bool* eos);
 
     int field_num() const {
@@ -37,6 +37,7 @@
 #include "runtime/exec_env.h"
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/query_trace.h"
 #include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
@@ -350,6 +351,7 @@ Status NewPartitionedAggregationNode::open(RuntimeState* state) {
 
 Status NewPartitionedAggregationNode::get_next(RuntimeState* state, RowBatch* row_batch,
     bool* eos) {
+  SCOPED_PERF_COUNTERS(_perf_counters);
   int first_row_idx = row_batch->num_rows();
   RETURN_IF_ERROR(GetNextInternal(state, row_batch, eos));
   RETURN_IF_ERROR(HandleOutputStrings(row_batch, first_row_idx));
@@ -1354,6 +1356,7 @@ Status NewPartitionedAggregationNode::ProcessStream(BufferedTupleStream3* input_
 }
 
 Status NewPartitionedAggregationNode::SpillPartition(bool more_aggregate_rows) {
+  SCOPED_TRACE_SPAN(state_, "AggSpill", "spill");
   int64_t max_freed_mem = 0;
   int partition_idx = -1;
 
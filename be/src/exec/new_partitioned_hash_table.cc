@@ -94,7 +94,8 @@ NewPartitionedHashTableCtx::NewPartitionedHashTableCtx(const std::vector<Expr*>&
       level_(0),
       scratch_row_(NULL),
       mem_pool_(mem_pool),
-      expr_results_pool_(expr_results_pool) {
+      expr_results_pool_(expr_results_pool),
+      packed_key_bytes_(0) {
   DCHECK(!finds_some_nulls_ || stores_nulls_);
   // Compute the layout and buffer size to store the evaluated expr results
   DCHECK_EQ(build_exprs_.size(), probe_exprs_.size());
@@ -142,7 +143,39 @@ Status NewPartitionedHashTableCtx::Init(ObjectPool* pool, RuntimeState* state, i
       probe_expr_evals_.push_back(context);
   }
   DCHECK_EQ(probe_exprs_.size(), probe_expr_evals_.size());
-  return expr_values_cache_.Init(state, mem_pool_->mem_tracker(), build_exprs_);
+  RETURN_IF_ERROR(expr_values_cache_.Init(state, mem_pool_->mem_tracker(), build_exprs_));
+  InitPackedKey();
+  return Status::OK();
+}
+
+void NewPartitionedHashTableCtx::InitPackedKey() {
+  packed_key_bytes_ = 0;
+  key_slot_sizes_.clear();
+  if (expr_values_cache_.var_result_offset() != -1) return;
+  int bytes_per_row = expr_values_cache_.expr_values_bytes_per_row();
+  if (bytes_per_row > sizeof(__uint128_t)) return;
+  for (int i = 0; i < build_exprs_.size(); ++i) {
+    // Only types whose equality is the equality of their bytes. Floating point
+    // values (0.0 == -0.0, NaN != NaN) and DateTimeValue (which ignores some of
+    // its fields when compared) keep using the generic path.
+    switch (build_exprs_[i]->type().type) {
+      case TYPE_BOOLEAN:
+      case TYPE_TINYINT:
+      case TYPE_SMALLINT:
+      case TYPE_INT:
+      case TYPE_BIGINT:
+      case TYPE_LARGEINT:
+      case TYPE_DECIMALV2:
+        break;
+      default:
+        key_slot_sizes_.clear();
+        return;
+    }
+    key_slot_sizes_.push_back(build_exprs_[i]->type().get_slot_size());
+  }
+  // The padding between the values in the results buffer is never written, so it
+  // stays zero and doesn't affect the packed key.
+  packed_key_bytes_ = bytes_per_row <= sizeof(uint64_t) ? sizeof(uint64_t) : sizeof(__uint128_t);
 }
 
 Status NewPartitionedHashTableCtx::Create(ObjectPool* pool, RuntimeState* state,
@@ -210,7 +243,11 @@ uint32_t NewPartitionedHashTableCtx::Hash(const void* input, int len, uint32_t h
 uint32_t NewPartitionedHashTableCtx::HashRow(
     const uint8_t* expr_values, const uint8_t* expr_values_null) const noexcept {
   DCHECK_LT(level_, seeds_.size());
-  if (expr_values_cache_.var_result_offset() == -1) {
+  if (packed_key_bytes_ == sizeof(uint64_t)) {
+    return HashPackedKey<uint64_t>(expr_values);
+  } else if (packed_key_bytes_ == sizeof(__uint128_t)) {
+    return HashPackedKey<__uint128_t>(expr_values);
+  } else if (expr_values_cache_.var_result_offset() == -1) {
     /// This handles NULLs implicitly since a constant seed value was put
     /// into results buffer for nulls.
     return Hash(
@@ -276,9 +313,59 @@ uint32_t NewPartitionedHashTableCtx::HashVariableLenRow(const uint8_t* expr_valu
   return hash;
 }
 
+template <typename KeyType>
+uint32_t NewPartitionedHashTableCtx::HashPackedKey(const uint8_t* expr_values) const {
+  KeyType key = 0;
+  memcpy(&key, expr_values, expr_values_cache_.expr_values_bytes_per_row());
+  return Hash(&key, sizeof(KeyType), seeds_[level_]);
+}
+
+// Copies a fixed width value of 'size' bytes, so the common sizes don't go
+// through a memcpy() call.
+static inline void CopyKeySlot(uint8_t* dst, const void* src, int size) {
+  switch (size) {
+    case 1: *dst = *reinterpret_cast<const uint8_t*>(src); break;
+    case 2: memcpy(dst, src, 2); break;
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    default: memcpy(dst, src, size); break;
+  }
+}
+
+template <typename KeyType, bool FORCE_NULL_EQUALITY>
+bool NewPartitionedHashTableCtx::EqualsPackedKey(TupleRow* build_row,
+    const uint8_t* expr_values, const uint8_t* expr_values_null) const {
+  KeyType build_key = 0;
+  uint8_t* build_values = reinterpret_cast<uint8_t*>(&build_key);
+  for (int i = 0; i < build_expr_evals_.size(); ++i) {
+    const void* val = build_expr_evals_[i]->get_value(build_row);
+    if (val == NULL) {
+      if (!(FORCE_NULL_EQUALITY || finds_nulls_[i])) return false;
+      if (!expr_values_null[i]) return false;
+      // EvalRow() put the same constant into 'expr_values' for the NULL.
+      val = NULL_VALUE;
+    } else {
+      if (expr_values_null[i]) return false;
+    }
+    CopyKeySlot(build_values + expr_values_cache_.expr_values_offsets(i), val,
+        key_slot_sizes_[i]);
+  }
+  KeyType probe_key = 0;
+  memcpy(&probe_key, expr_values, expr_values_cache_.expr_values_bytes_per_row());
+  return build_key == probe_key;
+}
+
 template <bool FORCE_NULL_EQUALITY>
 bool NewPartitionedHashTableCtx::Equals(TupleRow* build_row, const uint8_t* expr_values,
     const uint8_t* expr_values_null) const noexcept {
+  if (packed_key_bytes_ == sizeof(uint64_t)) {
+    return EqualsPackedKey<uint64_t, FORCE_NULL_EQUALITY>(
+        build_row, expr_values, expr_values_null);
+  } else if (packed_key_bytes_ == sizeof(__uint128_t)) {
+    return EqualsPackedKey<__uint128_t, FORCE_NULL_EQUALITY>(
+        build_row, expr_values, expr_values_null);
+  }
   for (int i = 0; i < build_expr_evals_.size(); ++i) {
     void* val = build_expr_evals_[i]->get_value(build_row);
     if (val == NULL) {
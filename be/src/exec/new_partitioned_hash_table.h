@@ -476,6 +476,22 @@ class NewPartitionedHashTableCtx {
         expr_values_cache_.cur_expr_values_null());
   }
 
+  /// Specialized HashRow() and Equals() used when all build exprs are fixed width
+  /// integer-like types whose evaluated values fit into a single KeyType, i.e. when
+  /// 'packed_key_bytes_' is non-zero. The values in 'expr_values' are loaded as one
+  /// zero padded KeyType, so hashing and comparing a row doesn't need to look at the
+  /// exprs' types.
+  template <typename KeyType>
+  uint32_t HashPackedKey(const uint8_t* expr_values) const;
+
+  template <typename KeyType, bool FORCE_NULL_EQUALITY>
+  bool EqualsPackedKey(TupleRow* build_row, const uint8_t* expr_values,
+      const uint8_t* expr_values_null) const;
+
+  /// Sets 'packed_key_bytes_' and 'key_slot_sizes_' from the build exprs and the
+  /// layout of 'expr_values_cache_'.
+  void InitPackedKey();
+
   /// Cross-compiled function to access member variables used in CodegenHashRow().
   uint32_t IR_ALWAYS_INLINE GetHashSeed() const;
 
@@ -522,6 +538,14 @@ class NewPartitionedHashTableCtx {
 
   // MemPool for allocations by made EvalRow to copy expr's StringVal result. Not owned
   MemPool* expr_results_pool_;
+
+  /// sizeof(uint64_t) or sizeof(__uint128_t) if a row of evaluated build exprs fits
+  /// into that many bytes and can be compared bytewise, 0 if the generic HashRow() and
+  /// Equals() have to be used.
+  int packed_key_bytes_;
+
+  /// The slot size of each build expr. Only set if 'packed_key_bytes_' is non-zero.
+  std::vector<int> key_slot_sizes_;
 };
 
 /// The hash table consists of a contiguous array of buckets that contain a pointer to the
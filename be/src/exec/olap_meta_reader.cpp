@@ -113,4 +113,23 @@ Status EngineMetaReader::get_hints(
     return Status::OK();
 }
 
+Status EngineMetaReader::get_num_rows(
+        boost::shared_ptr<DorisScanRange> scan_range,
+        int64_t* num_rows) {
+    auto tablet_id = scan_range->scan_range().tablet_id;
+    int32_t schema_hash = strtoul(scan_range->scan_range().schema_hash.c_str(), NULL, 10);
+    std::string err;
+    TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+        tablet_id, schema_hash, true, &err);
+    if (tablet == nullptr) {
+        std::stringstream ss;
+        ss << "failed to get tablet: " << tablet_id << "with schema hash: "
+            << schema_hash << ", reason: " << err;
+        LOG(WARNING) << ss.str();
+        return Status::InternalError(ss.str());
+    }
+    *num_rows = tablet->num_rows();
+    return Status::OK();
+}
+
 } // namespace doris
@@ -48,6 +48,11 @@ public:
         std::vector<OlapScanRange>& scan_key_range,
         std::vector<OlapScanRange>* sub_scan_range, 
         RuntimeProfile* profile);
+
+    // Get number of rows of the tablet to scan
+    static Status get_num_rows(
+        boost::shared_ptr<DorisScanRange> scan_range,
+        int64_t* num_rows);
 };
 
 } // namespace doris
@@ -81,6 +81,7 @@ Status OlapRewriteNode::open(RuntimeState* state) {
 Status OlapRewriteNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
 
     if (reached_limit() || (_child_row_idx == _child_row_batch->num_rows() && _child_eos)) {
         // we're already done or we exhausted the last child batch and there won't be any
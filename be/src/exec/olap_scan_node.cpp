@@ -18,6 +18,8 @@
 #include "exec/olap_scan_node.h"
 
 #include <algorithm>
+#include <atomic>
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 #include <sstream>
 #include <iostream>
@@ -29,15 +31,22 @@
 #include "exprs/expr.h"
 #include "exprs/binary_predicate.h"
 #include "exprs/in_predicate.h"
+#include "exprs/slot_ref.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/exec_env.h"
+#include "runtime/query_trace.h"
 #include "runtime/runtime_state.h"
 #include "runtime/row_batch.h"
+#include "runtime/sorted_run_merger.h"
 #include "runtime/string_value.h"
 #include "runtime/tuple_row.h"
+#include "gutil/strings/substitute.h"
 #include "util/runtime_profile.h"
+#include "util/cpu_info.h"
+#include "util/cpu_profiler.h"
 #include "util/thread_pool.hpp"
 #include "util/debug_util.h"
+#include "util/doris_metrics.h"
 #include "util/priority_thread_pool.hpp"
 #include "agent/cgroups_mgr.h"
 #include "common/resource_tls.h"
@@ -47,6 +56,10 @@ using llvm::Function;
 
 namespace doris {
 
+// number of scan nodes scheduling scanners in the common scanner thread pool,
+// threads of the pool are shared fairly by them
+static std::atomic<int32_t> s_common_pool_scan_node_num(0);
+
 #define DS_SUCCESS(x) ((x) >= 0)
 
 OlapScanNode::OlapScanNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs):
@@ -85,6 +98,8 @@ Status OlapScanNode::init(const TPlanNode& tnode, RuntimeState* state) {
     // Before, we support scan data ordered, but is not used in production
     // Now, we drop this functional
     DCHECK(!_is_result_order) << "ordered result don't support any more";
+    _ordered_by_keys = tnode.olap_scan_node.__isset.ordered_by_keys
+        && tnode.olap_scan_node.ordered_by_keys;
 
     return Status::OK();
 }
@@ -139,6 +154,19 @@ void OlapScanNode::_init_counter(RuntimeState* state) {
     _index_load_timer = ADD_TIMER(_runtime_profile, "IndexLoadTime");
 
     _scan_timer = ADD_TIMER(_runtime_profile, "ScanTime");
+
+    _page_cache_read_counter = ADD_COUNTER(_runtime_profile, "PageCacheBytesRead", TUnit::BYTES);
+    _scanner_cpu_timer = ADD_TIMER(_runtime_profile, "ScannerCpuTime");
+
+    if (CpuInfo::get_max_num_numa_nodes() > 1) {
+        for (int node = 0; node < CpuInfo::get_max_num_numa_nodes(); ++node) {
+            _scanner_numa_node_counters.push_back(ADD_COUNTER(
+                    _runtime_profile, strings::Substitute("ScannerRoundsOnNumaNode$0", node),
+                    TUnit::UNIT));
+        }
+        _scanner_numa_remote_counter =
+            ADD_COUNTER(_runtime_profile, "ScannerRoundsNumaRemote", TUnit::UNIT);
+    }
 }
 
 Status OlapScanNode::prepare(RuntimeState* state) {
@@ -150,6 +178,8 @@ Status OlapScanNode::prepare(RuntimeState* state) {
     _rows_pushed_cond_filtered_counter =
         ADD_COUNTER(_runtime_profile, "RowsPushedCondFiltered", TUnit::UNIT);
     _init_counter(state);
+    _free_row_batches.resize(state->exec_env()->thread_pool()->is_numa_aware()
+                             ? CpuInfo::get_max_num_numa_nodes() : 1);
 
     _tuple_desc = state->desc_tbl().get_tuple_descriptor(_tuple_id);
     if (_tuple_desc == NULL) {
@@ -171,6 +201,10 @@ Status OlapScanNode::prepare(RuntimeState* state) {
         _string_slots.push_back(slots[i]);
     }
 
+    if (_ordered_by_keys) {
+        RETURN_IF_ERROR(init_key_exprs(state));
+    }
+
     if (state->codegen_level() > 0) {
         LlvmCodeGen* codegen = NULL;
         RETURN_IF_ERROR(state->get_codegen(&codegen));
@@ -191,6 +225,7 @@ Status OlapScanNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(ExecNode::open(state));
+    RETURN_IF_ERROR(Expr::open(_key_expr_ctxs, state));
 
     for (int conj_idx = 0; conj_idx < _conjunct_ctxs.size(); ++conj_idx) {
         // if conjunct is constant, compute direct and set eos = true
@@ -210,10 +245,11 @@ Status OlapScanNode::open(RuntimeState* state) {
 Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
 
     // check if Canceled.
     if (state->is_cancelled()) {
-        boost::unique_lock<boost::mutex> l(_row_batches_lock);
+        boost::unique_lock<boost::mutex> l(_scan_batches_lock);
         _transfer_done = true;
         boost::lock_guard<boost::mutex> guard(_status_mutex);
         if (LIKELY(_status.ok())) {
@@ -240,29 +276,43 @@ Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
         _start = true;
     }
 
-    // wait for batch from queue
+    if (_ordered_by_keys) {
+        return get_next_ordered(state, row_batch, eos);
+    }
+
+    // schedule scanners and wait for batch from queue
     RowBatch* materialized_batch = NULL;
-    {
-        boost::unique_lock<boost::mutex> l(_row_batches_lock);
-        while (_materialized_row_batches.empty() && !_transfer_done) {
+    while (true) {
+        int64_t running_thread = schedule_scanners(state);
+        boost::unique_lock<boost::mutex> l(_scan_batches_lock);
+        // wait when all scanners assigned are running & no result in queue
+        ScopedTraceSpan wait_span(_scan_row_batches.empty() ? state->query_trace() : nullptr,
+                                  state->fragment_instance_id(), "WaitScannerBatch", "scan");
+        while (_running_thread == running_thread && _scan_row_batches.empty()
+                && !_scanner_done && !_transfer_done) {
             if (state->is_cancelled()) {
                 _transfer_done = true;
+                break;
             }
-
-            _row_batch_added_cv.timed_wait(l, _wait_duration);
+            _scan_batch_added_cv.timed_wait(l, _wait_duration);
         }
-
-        if (!_materialized_row_batches.empty()) {
-            materialized_batch = dynamic_cast<RowBatch*>(_materialized_row_batches.front());
+        if (_transfer_done) {
+            break;
+        }
+        if (!_scan_row_batches.empty()) {
+            materialized_batch = dynamic_cast<RowBatch*>(_scan_row_batches.front());
             DCHECK(materialized_batch != NULL);
-            _materialized_row_batches.pop_front();
+            _scan_row_batches.pop_front();
+            break;
         }
+        if (_scanner_done) {
+            break;
+        }
+        // some scanner finished its round without output, schedule it again
     }
 
     // return batch
     if (NULL != materialized_batch) {
-        // notify scanner
-        _row_batch_consumed_cv.notify_one();
         // get scanner's batch memory
         row_batch->acquire_state(materialized_batch);
         _num_rows_returned += row_batch->num_rows();
@@ -276,11 +326,10 @@ Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
             COUNTER_SET(_rows_returned_counter, _num_rows_returned);
 
             {
-                boost::unique_lock<boost::mutex> l(_row_batches_lock);
+                boost::unique_lock<boost::mutex> l(_scan_batches_lock);
                 _transfer_done = true;
             }
-
-            _row_batch_consumed_cv.notify_all();
+            finish_schedule_scanners();
             *eos = true;
             LOG(INFO) << "OlapScanNode ReachedLimit.";
         } else {
@@ -297,11 +346,12 @@ Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
         __sync_fetch_and_sub(&_buffered_bytes,
                              row_batch->tuple_data_pool()->total_reserved_bytes());
 
-        delete materialized_batch;
+        return_free_row_batch(materialized_batch);
         return Status::OK();
     }
 
     // all scanner done, change *eos to true
+    finish_schedule_scanners();
     *eos = true;
     boost::lock_guard<boost::mutex> guard(_status_mutex);
     return _status;
@@ -311,6 +361,8 @@ Status OlapScanNode::collect_query_statistics(QueryStatistics* statistics) {
     RETURN_IF_ERROR(ExecNode::collect_query_statistics(statistics));
     statistics->add_scan_bytes(_read_compressed_counter->value());
     statistics->add_scan_rows(_raw_rows_counter->value());
+    statistics->add_scan_bytes_from_page_cache(_page_cache_read_counter->value());
+    statistics->add_cpu_ns(_scanner_cpu_timer->value());
     return Status::OK();
 }
 
@@ -320,38 +372,43 @@ Status OlapScanNode::close(RuntimeState* state) {
     }
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::CLOSE));
 
-    // change done status
+    // change done status and wait for the running scanner tasks, which stop as soon as
+    // they see it
     {
-        boost::unique_lock<boost::mutex> l(_row_batches_lock);
+        boost::unique_lock<boost::mutex> l(_scan_batches_lock);
         _transfer_done = true;
+        while (_running_thread > 0) {
+            _scan_batch_added_cv.wait(l);
+        }
     }
-    // notify all scanner thread
-    _row_batch_consumed_cv.notify_all();
-    _row_batch_added_cv.notify_all();
-    _scan_batch_added_cv.notify_all();
-
-    // join transfer thread
-    _transfer_thread.join_all();
+    finish_schedule_scanners();
 
     // clear some row batch in queue
-    for (auto row_batch : _materialized_row_batches) {
+    for (auto row_batch : _scan_row_batches) {
         delete row_batch;
     }
 
-    _materialized_row_batches.clear();
+    _scan_row_batches.clear();
 
-    for (auto row_batch : _scan_row_batches) {
-        delete row_batch;
+    for (auto& free_row_batches : _free_row_batches) {
+        for (auto row_batch : free_row_batches) {
+            delete row_batch;
+        }
     }
+    _free_row_batches.clear();
 
-    _scan_row_batches.clear();
+    _ordered_merger.reset();
+    _ordered_runs.clear();
 
     // OlapScanNode terminate by exception
     // so that initiative close the Scanner
     for (auto scanner : _all_olap_scanners) {
         scanner->close(state);
     }
+    Expr::close(_key_expr_ctxs, state);
 
+    DorisMetrics::query_scan_latency_ms.add(
+            _runtime_profile->total_time_counter()->value() / 1000000);
     VLOG(1) << "OlapScanNode::close()";
     return ScanNode::close(state);
 }
@@ -604,9 +661,10 @@ Status OlapScanNode::split_scan_range() {
 
     // doris scan range is related with one tablet
     // split scan range for every tablet
+    int block_row_count = get_scan_range_row_count();
     for (auto scan_range : _doris_scan_ranges) {
         sub_ranges.clear();
-        RETURN_IF_ERROR(get_sub_scan_range(scan_range, &sub_ranges));
+        RETURN_IF_ERROR(get_sub_scan_range(scan_range, block_row_count, &sub_ranges));
 
         for (auto sub_range : sub_ranges) {
             VLOG(1) << "SubScanKey=" << (sub_range.begin_include ? "[" : "(")
@@ -671,10 +729,46 @@ Status OlapScanNode::start_scan_thread(RuntimeState* state) {
     _progress = ProgressUpdater(ss.str(), _olap_scanners.size(), 1);
     _progress.set_logging_level(1);
 
-    _transfer_thread.add_thread(
-        new boost::thread(
-            &OlapScanNode::transfer_thread, this, state));
+    // scanner open pushdown to scanThread
+    for (auto scanner : _olap_scanners) {
+        RETURN_IF_ERROR(Expr::clone_if_not_exists(
+                _conjunct_ctxs, state, scanner->conjunct_ctxs()));
+    }
+    if (_ordered_by_keys) {
+        // the scanners are run by get_next_ordered()
+        return Status::OK();
+    }
+
+    /*********************************
+     * 优先级调度基本策略:
+     * 1. 通过查询拆分的Range个数来确定初始nice值
+     *    Range个数越多，越倾向于认定为大查询，nice值越小
+     * 2. 通过查询累计读取的数据量来调整nice值
+     *    读取的数据越多，越倾向于认定为大查询，nice值越小
+     * 3. 通过nice值来判断查询的优先级
+     *    nice值越大的，越优先获得的查询资源
+     * 4. 定期提高队列内残留任务的优先级，避免大查询完全饿死
+     * 5. 公共线程池中每个ScanNode同时提交的任务数不超过它公平分得的线程数
+     * 6. 只读取单点key的小查询先在独立的线程池中调度，运行轮数过多后移入公共线程池
+     *********************************/
+    _in_small_scan_pool = state->exec_env()->small_scan_thread_pool() != nullptr
+        && is_point_scan();
+    if (!_in_small_scan_pool) {
+        ++s_common_pool_scan_node_num;
+        _in_common_pool = true;
+    }
+    _total_assign_num = 0;
+    _nice = 18 + std::max(0, 2 - (int)_olap_scanners.size() / 5);
 
+    _scanner_mem_limit = 512 * 1024 * 1024;
+    // TODO(zc): use memory limit
+    if (state->fragment_mem_tracker() != nullptr) {
+        _scanner_mem_limit = state->fragment_mem_tracker()->limit();
+    }
+    _max_scanner_thread = _max_materialized_row_batches;
+    if (config::doris_scanner_row_num > state->batch_size()) {
+        _max_scanner_thread /= config::doris_scanner_row_num / state->batch_size();
+    }
     return Status::OK();
 }
 
@@ -997,13 +1091,37 @@ bool OlapScanNode::select_scan_range(boost::shared_ptr<DorisScanRange> scan_rang
     return true;
 }
 
+int OlapScanNode::get_scan_range_row_count() {
+    int max_row_count = config::doris_scan_range_row_count;
+    int min_row_count = std::min(config::doris_scan_range_min_row_count, max_row_count);
+    int64_t total_rows = 0;
+    for (auto& scan_range : _doris_scan_ranges) {
+        int64_t num_rows = 0;
+        if (!EngineMetaReader::get_num_rows(scan_range, &num_rows).ok()) {
+            // fail later when read it, use default row count here
+            return max_row_count;
+        }
+        total_rows += num_rows;
+    }
+    int64_t row_count = total_rows / std::max(1, config::doris_scanner_thread_pool_thread_num);
+    row_count = std::max<int64_t>(min_row_count, std::min<int64_t>(max_row_count, row_count));
+    VLOG(1) << "scan range row count=" << row_count << ", total rows=" << total_rows;
+    return row_count;
+}
+
 Status OlapScanNode::get_sub_scan_range(
         boost::shared_ptr<DorisScanRange> scan_range,
+        int block_row_count,
         std::vector<OlapScanRange>* sub_range) {
     std::vector<OlapScanRange> scan_key_range;
     RETURN_IF_ERROR(_scan_keys.get_key_range(&scan_key_range));
 
-    if (limit() != -1 ||
+    // rows of a tablet are got from meta once if aggregation is pushed down,
+    // and top n rows of a tablet are read by one scanner if top n is pushed down
+    bool push_down_agg = _olap_scan_node.__isset.push_down_agg_type
+        && _olap_scan_node.push_down_agg_type != TPushAggOp::NONE;
+    bool push_down_topn = _olap_scan_node.__isset.push_down_topn_limit;
+    if (limit() != -1 || push_down_agg || push_down_topn || _ordered_by_keys ||
         scan_key_range.size() > 64) {
         if (scan_key_range.size() != 0) {
             *sub_range = scan_key_range;
@@ -1013,7 +1131,7 @@ Status OlapScanNode::get_sub_scan_range(
     } else {
         if (!EngineMetaReader::get_hints(
                     scan_range,
-                    config::doris_scan_range_row_count,
+                    block_row_count,
                     _scan_keys.begin_include(),
                     _scan_keys.end_include(),
                     scan_key_range,
@@ -1030,153 +1148,121 @@ Status OlapScanNode::get_sub_scan_range(
     return Status::OK();
 }
 
-void OlapScanNode::transfer_thread(RuntimeState* state) {
-    // scanner open pushdown to scanThread
-    Status status = Status::OK();
-    for (auto scanner : _olap_scanners) {
-        status = Expr::clone_if_not_exists(_conjunct_ctxs, state, scanner->conjunct_ctxs());
-        if (!status.ok()) {
-            boost::lock_guard<boost::mutex> guard(_status_mutex);
-            _status = status;
-            break;
+bool OlapScanNode::is_point_scan() const {
+    for (auto& key_range : _query_key_ranges) {
+        if (!key_range.begin_include || !key_range.end_include
+                || !(key_range.begin_scan_range == key_range.end_scan_range)) {
+            return false;
         }
     }
+    return !_query_key_ranges.empty();
+}
 
-    /*********************************
-     * 优先级调度基本策略:
-     * 1. 通过查询拆分的Range个数来确定初始nice值
-     *    Range个数越多，越倾向于认定为大查询，nice值越小
-     * 2. 通过查询累计读取的数据量来调整nice值
-     *    读取的数据越多，越倾向于认定为大查询，nice值越小
-     * 3. 通过nice值来判断查询的优先级
-     *    nice值越大的，越优先获得的查询资源
-     * 4. 定期提高队列内残留任务的优先级，避免大查询完全饿死
-     *********************************/
-    PriorityThreadPool* thread_pool = state->exec_env()->thread_pool();
-    _total_assign_num = 0;
-    _nice = 18 + std::max(0, 2 - (int)_olap_scanners.size() / 5);
+int64_t OlapScanNode::schedule_scanners(RuntimeState* state) {
     std::list<OlapScanner*> olap_scanners;
-
-    int64_t mem_limit = 512 * 1024 * 1024;
-    // TODO(zc): use memory limit
-    int64_t mem_consume = __sync_fetch_and_add(&_buffered_bytes, 0);
-    if (state->fragment_mem_tracker() != nullptr) {
-        mem_limit = state->fragment_mem_tracker()->limit();
-        mem_consume = state->fragment_mem_tracker()->consumption();
-    }
-    int max_thread = _max_materialized_row_batches;
-    if (config::doris_scanner_row_num > state->batch_size()) {
-        max_thread /= config::doris_scanner_row_num / state->batch_size();
-    }
-    // read from scanner
-    while (LIKELY(status.ok())) {
-        int assigned_thread_num = 0;
-        // copy to local
-        {
-            boost::unique_lock<boost::mutex> l(_scan_batches_lock);
-            assigned_thread_num = _running_thread;
-            // int64_t buf_bytes = __sync_fetch_and_add(&_buffered_bytes, 0);
-            // How many thread can apply to this query
-            size_t thread_slot_num = 0;
-            mem_consume = __sync_fetch_and_add(&_buffered_bytes, 0);
-            if (state->fragment_mem_tracker() != nullptr) {
-                mem_consume = state->fragment_mem_tracker()->consumption();
-            }
-            if (mem_consume < (mem_limit * 6) / 10) {
-                thread_slot_num = max_thread - assigned_thread_num;
-            } else {
-                // Memory already exceed
-                if (_scan_row_batches.empty()) {
-                    // NOTE(zc): here need to lock row_batches_lock_
-                    //  be worried about dead lock, so don't check here
-                    // if (materialized_row_batches_.empty()) {
-                    //     LOG(FATAL) << "Scan_row_batches_ and materialized_row_batches_"
-                    //         " are empty when memory exceed";
-                    // }
-                    // Just for notify if scan_row_batches_ is empty and no running thread
-                    if (assigned_thread_num == 0) {
-                        thread_slot_num = 1;
-                        // NOTE: if olap_scanners_ is empty, scanner_done_ should be true
-                    }
-                }
-            }
-            thread_slot_num = std::min(thread_slot_num, _olap_scanners.size());
-            for (int i = 0; i < thread_slot_num; ++i) {
-                olap_scanners.push_back(_olap_scanners.front());
-                _olap_scanners.pop_front();
-                _running_thread++;
-                assigned_thread_num++;
-            }
+    int64_t running_thread = 0;
+    {
+        boost::unique_lock<boost::mutex> l(_scan_batches_lock);
+        if (_transfer_done) {
+            return _running_thread;
         }
-
-        auto iter = olap_scanners.begin();
-        while (iter != olap_scanners.end()) {
-            PriorityThreadPool::Task task;
-            task.work_function = boost::bind(&OlapScanNode::scanner_thread, this, *iter);
-            task.priority = _nice;
-            if (thread_pool->offer(task)) {
-                olap_scanners.erase(iter++);
-            } else {
-                LOG(FATAL) << "Failed to assign scanner task to thread pool!";
-            }
-            ++_total_assign_num;
+        int64_t assigned_thread_num = _running_thread;
+        // How many thread can apply to this query
+        size_t thread_slot_num = 0;
+        int64_t mem_consume = __sync_fetch_and_add(&_buffered_bytes, 0);
+        if (state->fragment_mem_tracker() != nullptr) {
+            mem_consume = state->fragment_mem_tracker()->consumption();
         }
-
-        RowBatchInterface* scan_batch = NULL;
-        {
-            // 1 scanner idle task not empty, assign new sanner task
-            boost::unique_lock<boost::mutex> l(_scan_batches_lock);
-
-            // scanner_row_num = 16k
-            // 16k * 10 * 12 * 8 = 15M(>2s)  --> nice=10
-            // 16k * 20 * 22 * 8 = 55M(>6s)  --> nice=0
-            while (_nice > 0
-                       && _total_assign_num > (22 - _nice) * (20 - _nice) * 6) {
-                --_nice;
+        if (mem_consume < (_scanner_mem_limit * 6) / 10) {
+            int fair_thread = _max_scanner_thread;
+            if (!_in_small_scan_pool) {
+                // don't let one scan node occupy all threads of common pool
+                int scan_node_num = std::max(1, s_common_pool_scan_node_num.load());
+                fair_thread = std::min(_max_scanner_thread, std::max(1,
+                    (config::doris_scanner_thread_pool_thread_num + scan_node_num - 1)
+                    / scan_node_num));
             }
-
-            // 2 wait when all scanner are running & no result in queue
-            while (UNLIKELY(_running_thread == assigned_thread_num
-                            && _scan_row_batches.empty()
-                            && !_scanner_done)) {
-                _scan_batch_added_cv.wait(l);
+            // don't scan further ahead than the consumer while enough batches are queued
+            if (fair_thread > assigned_thread_num
+                    && _scan_row_batches.size()
+                        < static_cast<size_t>(_max_materialized_row_batches)) {
+                thread_slot_num = fair_thread - assigned_thread_num;
             }
-
-            // 3 transfer result row batch when queue is not empty
-            if (LIKELY(!_scan_row_batches.empty())) {
-                scan_batch = _scan_row_batches.front();
-                _scan_row_batches.pop_front();
-
-                // delete scan_batch if transfer thread should be stoped
-                // because scan_batch wouldn't be useful anymore
-                if (UNLIKELY(_transfer_done)) {
-                    delete scan_batch;
-                    scan_batch = NULL;
-                }
-            } else {
-                if (_scanner_done) {
-                    break;
-                }
+        } else {
+            // Memory already exceed
+            // Just for notify if scan_row_batches_ is empty and no running thread
+            if (_scan_row_batches.empty() && assigned_thread_num == 0) {
+                thread_slot_num = 1;
+                // NOTE: if olap_scanners_ is empty, scanner_done_ should be true
             }
         }
+        thread_slot_num = std::min(thread_slot_num, _olap_scanners.size());
+        for (int i = 0; i < thread_slot_num; ++i) {
+            olap_scanners.push_back(_olap_scanners.front());
+            _olap_scanners.pop_front();
+            _running_thread++;
+        }
+        running_thread = _running_thread;
+    }
 
-        if (NULL != scan_batch) {
-            add_one_batch(scan_batch);
+    // offer tasks without holding _scan_batches_lock, which the pool threads need
+    PriorityThreadPool* thread_pool = state->exec_env()->thread_pool();
+    PriorityThreadPool* small_scan_thread_pool = state->exec_env()->small_scan_thread_pool();
+    for (auto scanner : olap_scanners) {
+        PriorityThreadPool::Task task;
+        task.work_function = boost::bind(&OlapScanNode::scanner_thread, this, scanner);
+        task.priority = _nice;
+        task.numa_node = scanner->numa_node();
+        PriorityThreadPool* pool = _in_small_scan_pool ? small_scan_thread_pool : thread_pool;
+        if (!pool->offer(task)) {
+            LOG(FATAL) << "Failed to assign scanner task to thread pool!";
+        }
+        ++_total_assign_num;
+        if (_in_small_scan_pool && _total_assign_num > config::doris_small_scan_max_rounds) {
+            // it's not small as expected
+            _in_small_scan_pool = false;
+            _in_common_pool = true;
+            ++s_common_pool_scan_node_num;
         }
     }
 
-    VLOG(1) << "TransferThread finish.";
-    boost::unique_lock<boost::mutex> l(_row_batches_lock);
-    _transfer_done = true;
-    _row_batch_added_cv.notify_all();
+    // scanner_row_num = 16k
+    // 16k * 10 * 12 * 8 = 15M(>2s)  --> nice=10
+    // 16k * 20 * 22 * 8 = 55M(>6s)  --> nice=0
+    while (_nice > 0
+               && _total_assign_num > (22 - _nice) * (20 - _nice) * 6) {
+        --_nice;
+    }
+    return running_thread;
+}
+
+void OlapScanNode::finish_schedule_scanners() {
+    if (_in_common_pool) {
+        --s_common_pool_scan_node_num;
+        _in_common_pool = false;
+    }
 }
 
 void OlapScanNode::scanner_thread(OlapScanner* scanner) {
+    ThreadCpuStopWatch cpu_watch;
+    cpu_watch.start();
     Status status = Status::OK();
-    bool eos = false;
+    // don't open scanner if other scanners have returned enough rows
+    bool eos = reached_scan_limit(0);
     RuntimeState* state = scanner->runtime_state();
+    int numa_node = -1;
+    if (!_scanner_numa_node_counters.empty()) {
+        numa_node = PriorityThreadPool::current_numa_node();
+        COUNTER_UPDATE(_scanner_numa_node_counters[numa_node], 1);
+        if (scanner->numa_node() >= 0 && scanner->numa_node() != numa_node) {
+            COUNTER_UPDATE(_scanner_numa_remote_counter, 1);
+        }
+    }
     DCHECK(NULL != state);
-    if (!scanner->is_open()) {
+    CpuProfileTag profile_tag(state->query_id(), state->fragment_instance_id());
+    SCOPED_TRACE_SPAN(state, "OlapScanner", "scan");
+    if (!eos && !scanner->is_open()) {
+        SCOPED_TRACE_SPAN(state, "OlapScannerOpen", "scan");
         status = scanner->open();
         if (!status.ok()) {
             boost::lock_guard<boost::mutex> guard(_status_mutex);
@@ -1198,18 +1284,20 @@ void OlapScanNode::scanner_thread(OlapScanner* scanner) {
     // need yield this thread when we do enough work. However, OlapStorage read
     // data in pre-aggregate mode, then we can't use storage returned data to
     // judge if we need to yield. So we record all raw data read in this round
-    // scan, if this exceed threshold, we yield this thread.
+    // scan, if this exceed threshold, we yield this thread. Wide rows may take
+    // long before rows exceed threshold, so bytes of returned batches are limited too.
     int64_t raw_rows_read = scanner->raw_rows_read();
     int64_t raw_rows_threshold = raw_rows_read + config::doris_scanner_row_num;
-    while (!eos && raw_rows_read < raw_rows_threshold) {
+    int64_t bytes_read = 0;
+    while (!eos && raw_rows_read < raw_rows_threshold
+            && bytes_read < config::doris_scanner_max_bytes_per_round) {
         if (UNLIKELY(_transfer_done)) {
             eos = true;
             status = Status::Cancelled("Cancelled");
             LOG(INFO) << "Scan thread cancelled, cause query done, maybe reach limit.";
             break;
         }
-        RowBatch *row_batch = new RowBatch(
-                this->row_desc(), state->batch_size(), _runtime_state->fragment_mem_tracker());
+        RowBatch* row_batch = get_free_row_batch(numa_node);
         row_batch->set_scanner_id(scanner->id());
         status = scanner->get_batch(_runtime_state, row_batch, &eos);
         if (!status.ok()) {
@@ -1220,12 +1308,18 @@ void OlapScanNode::scanner_thread(OlapScanner* scanner) {
         // 4. if status not ok, change status_.
         if (UNLIKELY(row_batch->num_rows() == 0)) {
             // may be failed, push already, scan node delete this batch.
-            delete row_batch;
+            return_free_row_batch(row_batch);
             row_batch = NULL;
         } else {
+            _num_rows_scanned += row_batch->num_rows();
             row_batchs.push_back(row_batch);
-            __sync_fetch_and_add(&_buffered_bytes,
-                                 row_batch->tuple_data_pool()->total_reserved_bytes());
+            int64_t batch_bytes = row_batch->tuple_data_pool()->total_reserved_bytes();
+            __sync_fetch_and_add(&_buffered_bytes, batch_bytes);
+            bytes_read += batch_bytes;
+        }
+        if (reached_scan_limit(0)) {
+            eos = true;
+            break;
         }
         raw_rows_read = scanner->raw_rows_read();
     }
@@ -1266,25 +1360,130 @@ void OlapScanNode::scanner_thread(OlapScanner* scanner) {
     } else {
         _olap_scanners.push_front(scanner);
     }
+    if (UNLIKELY(reached_scan_limit(0) && !_olap_scanners.empty())) {
+        // rows are enough for limit, finish the scanners not scheduled yet
+        for (auto pending_scanner : _olap_scanners) {
+            _progress.update(1);
+            pending_scanner->close(_runtime_state);
+        }
+        _olap_scanners.clear();
+        if (_progress.done()) {
+            _scanner_done = true;
+        }
+    }
+    // update before the scan node sees this thread finished
+    _scanner_cpu_timer->update(cpu_watch.elapsed_time());
     _running_thread--;
     _scan_batch_added_cv.notify_one();
 }
 
-Status OlapScanNode::add_one_batch(RowBatchInterface* row_batch) {
+RowBatch* OlapScanNode::get_free_row_batch(int numa_node) {
+    RowBatch* row_batch = nullptr;
     {
-        boost::unique_lock<boost::mutex> l(_row_batches_lock);
+        std::lock_guard<SpinLock> l(_free_row_batches_lock);
+        auto& free_row_batches =
+            _free_row_batches[_free_row_batches.size() > 1 ? std::max(numa_node, 0) : 0];
+        if (!free_row_batches.empty()) {
+            row_batch = free_row_batches.back();
+            free_row_batches.pop_back();
+        }
+    }
+    if (row_batch == nullptr) {
+        row_batch = new RowBatch(this->row_desc(), _runtime_state->batch_size(),
+                                 _runtime_state->fragment_mem_tracker());
+        row_batch->set_numa_node(numa_node);
+        return row_batch;
+    }
+    row_batch->reset();
+    return row_batch;
+}
 
-        while (UNLIKELY(_materialized_row_batches.size()
-                        >= _max_materialized_row_batches
-                        && !_transfer_done)) {
-            _row_batch_consumed_cv.wait(l);
+void OlapScanNode::return_free_row_batch(RowBatch* row_batch) {
+    {
+        std::lock_guard<SpinLock> l(_free_row_batches_lock);
+        auto& free_row_batches = _free_row_batches[
+            _free_row_batches.size() > 1 ? std::max(row_batch->numa_node(), 0) : 0];
+        if (free_row_batches.size() * _free_row_batches.size()
+                < static_cast<size_t>(_max_materialized_row_batches)) {
+            free_row_batches.push_back(row_batch);
+            return;
         }
+    }
+    delete row_batch;
+}
 
-        VLOG(2) << "Push row_batch to materialized_row_batches";
-        _materialized_row_batches.push_back(row_batch);
+Status OlapScanNode::init_key_exprs(RuntimeState* state) {
+    // rows of a tablet are ordered by all its keys, so by the leading keys in the tuple
+    for (auto& key_name : _olap_scan_node.key_column_name) {
+        SlotDescriptor* key_slot = nullptr;
+        for (auto slot : _tuple_desc->slots()) {
+            if (slot->is_materialized() && slot->col_name() == key_name) {
+                key_slot = slot;
+                break;
+            }
+        }
+        if (key_slot == nullptr) {
+            break;
+        }
+        Expr* expr = state->obj_pool()->add(new SlotRef(key_slot));
+        _key_expr_ctxs.push_back(state->obj_pool()->add(new ExprContext(expr)));
+    }
+    return Expr::prepare(_key_expr_ctxs, state, row_desc(), expr_mem_tracker());
+}
+
+Status OlapScanNode::get_next_ordered(RuntimeState* state, RowBatch* row_batch, bool* eos) {
+    if (_all_olap_scanners.empty()) {
+        _eos = true;
+        *eos = true;
+        return Status::OK();
+    }
+    if (_ordered_merger == nullptr) {
+        std::vector<SortedRunMerger::RunBatchSupplier> runs;
+        for (auto scanner : _all_olap_scanners) {
+            _ordered_runs.emplace_back(new OrderedScannerRun(scanner,
+                    new RowBatch(row_desc(), state->batch_size(),
+                                 state->fragment_mem_tracker())));
+            runs.push_back(boost::bind(&OlapScanNode::get_ordered_run_batch,
+                                       this, _ordered_runs.back().get(), _1));
+        }
+        // nulls sort before all other values in storage
+        TupleRowComparator less_than(_key_expr_ctxs, _key_expr_ctxs, true, true);
+        _ordered_merger.reset(new SortedRunMerger(
+                less_than, &_row_descriptor, runtime_profile(), false));
+        RETURN_IF_ERROR(_ordered_merger->prepare(runs));
+    }
+
+    RETURN_IF_ERROR(_ordered_merger->get_next(row_batch, eos));
+    _num_rows_returned += row_batch->num_rows();
+    if (reached_limit()) {
+        int num_rows_over = _num_rows_returned - _limit;
+        row_batch->set_num_rows(row_batch->num_rows() - num_rows_over);
+        _num_rows_returned -= num_rows_over;
+        *eos = true;
+    }
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    _eos = *eos;
+    return Status::OK();
+}
+
+Status OlapScanNode::get_ordered_run_batch(OrderedScannerRun* run, RowBatch** batch) {
+    *batch = nullptr;
+    OlapScanner* scanner = run->scanner;
+    if (!run->eos && !scanner->is_open()) {
+        RETURN_IF_ERROR(scanner->open());
+        scanner->set_opened();
+    }
+    // resources of the last batch have been transferred by the merger
+    run->batch->reset();
+    while (!run->eos && run->batch->num_rows() == 0) {
+        RETURN_IF_CANCELLED(_runtime_state);
+        RETURN_IF_ERROR(scanner->get_batch(_runtime_state, run->batch.get(), &run->eos));
+    }
+    if (run->batch->num_rows() == 0) {
+        scanner->close(_runtime_state);
+        return Status::OK();
     }
-    // remove one batch, notify main thread
-    _row_batch_added_cv.notify_one();
+    *batch = run->batch.get();
     return Status::OK();
 }
 
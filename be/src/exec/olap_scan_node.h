@@ -25,6 +25,8 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <atomic>
+#include <memory>
 #include <queue>
 
 #include "exec/olap_common.h"
@@ -35,9 +37,12 @@
 #include "runtime/row_batch_interface.hpp"
 #include "runtime/vectorized_row_batch.h"
 #include "util/progress_updater.h"
+#include "util/spinlock.h"
 
 namespace doris {
 
+class SortedRunMerger;
+
 enum TransferStatus {
     READ_ROWBATCH = 1,
     INIT_HEAP = 2,
@@ -152,16 +157,54 @@ protected:
     bool select_scan_range(boost::shared_ptr<DorisScanRange> scan_range);
     Status get_sub_scan_range(
         boost::shared_ptr<DorisScanRange> scan_range,
+        int block_row_count,
         std::vector<OlapScanRange>* sub_range);
-    void transfer_thread(RuntimeState* state);
+    // Return row count of sub scan range, so that rows of all tablets to scan
+    // are split into about as many ranges as scanner threads
+    int get_scan_range_row_count();
+    // Return true if all key ranges to scan are single keys
+    bool is_point_scan() const;
+    // Return true if rows returned by scanners plus pending_rows reach limit of
+    // this node, then there is no need to read more rows.
+    bool reached_scan_limit(int64_t pending_rows) const {
+        return _limit != -1 && _num_rows_scanned.load(std::memory_order_relaxed)
+            + pending_rows >= _limit;
+    }
+    // Offers idle scanners to the scanner thread pools, as many as memory, the queue of
+    // scanned batches and the fair share of this node in the common pool allow.
+    // Returns the number of scanner tasks running after the offer.
+    int64_t schedule_scanners(RuntimeState* state);
+    // Leaves the common pool once no more scanners will be scheduled.
+    void finish_schedule_scanners();
     //void vectorized_scanner_thread(OlapScanner* scanner);
     void scanner_thread(OlapScanner* scanner);
 
-    Status add_one_batch(RowBatchInterface* row_batch);
+    // Returns a batch for a scanner running on numa_node, reusing one of
+    // _free_row_batches of that node if possible.
+    RowBatch* get_free_row_batch(int numa_node);
+    // Keeps 'row_batch', whose data has been consumed, to be reused by the scanners.
+    void return_free_row_batch(RowBatch* row_batch);
 
     // Write debug string of this into out.
     virtual void debug_string(int indentation_level, std::stringstream* out) const;
 
+    // A scanner whose rows, ordered by keys, are merged by get_next_ordered().
+    struct OrderedScannerRun {
+        OrderedScannerRun(OlapScanner* scanner_, RowBatch* batch_) :
+                scanner(scanner_), batch(batch_), eos(false) { }
+        OlapScanner* scanner;
+        std::unique_ptr<RowBatch> batch;
+        bool eos;
+    };
+
+    // Builds _key_expr_ctxs over the key columns present in the tuple, in key order.
+    Status init_key_exprs(RuntimeState* state);
+    // Returns rows of all scanners merged in order of keys. The scanners are run by
+    // the calling thread, one batch ahead each.
+    Status get_next_ordered(RuntimeState* state, RowBatch* row_batch, bool* eos);
+    // Supplies the next non-empty batch of 'run' to _ordered_merger, or NULL at eos.
+    Status get_ordered_run_batch(OrderedScannerRun* run, RowBatch** batch);
+
 private:
     void _init_counter(RuntimeState* state);
 
@@ -198,34 +241,43 @@ private:
     // Order Result Flag
     bool _is_result_order;
 
+    // Set if rows are returned in order of keys (TOlapScanNode.ordered_by_keys). Each
+    // scanner reads one tablet without splitting it, merging its rowsets in order of
+    // keys, and the rows of the scanners are merged by _ordered_merger.
+    bool _ordered_by_keys = false;
+    // SlotRefs of the leading key columns present in the tuple, which rows are ordered by
+    std::vector<ExprContext*> _key_expr_ctxs;
+    std::vector<std::unique_ptr<OrderedScannerRun>> _ordered_runs;
+    std::unique_ptr<SortedRunMerger> _ordered_merger;
+
     // Pool for storing allocated scanner objects.  We don't want to use the
     // runtime pool to ensure that the scanner objects are deleted before this
     // object is.
     boost::scoped_ptr<ObjectPool> _scanner_pool;
 
-    // Thread group for transfer thread
-    boost::thread_group _transfer_thread;
     // Keeps track of total splits and the number finished.
     ProgressUpdater _progress;
 
-    // Lock and condition variables protecting _materialized_row_batches.  Row batches are
-    // produced asynchronously by the scanner threads and consumed by the main thread in
-    // GetNext.  Row batches must be processed by the main thread in the order they are
-    // queued to avoid freeing attached resources prematurely (row batches will never depend
-    // on resources attached to earlier batches in the queue).
-    // This lock cannot be taken together with any other locks except _lock.
-    boost::mutex _row_batches_lock;
-    boost::condition_variable _row_batch_added_cv;
-    boost::condition_variable _row_batch_consumed_cv;
-
-    std::list<RowBatchInterface*> _materialized_row_batches;
-
+    // Lock and condition variable protecting _scan_row_batches, _olap_scanners and
+    // _running_thread. Row batches are produced asynchronously by the scanner threads and
+    // consumed in get_next(), which also schedules the scanners, so a scan node takes no
+    // thread of its own. Row batches must be processed in the order they are queued to
+    // avoid freeing attached resources prematurely (row batches will never depend on
+    // resources attached to earlier batches in the queue).
     boost::mutex _scan_batches_lock;
     boost::condition_variable _scan_batch_added_cv;
     int32_t _scanner_task_finish_count;
 
     std::list<RowBatchInterface*> _scan_row_batches;
 
+    // Batches already consumed by get_next(), so that scanners don't have to build a
+    // RowBatch (row descriptor, MemPool and tuple pointers) for every batch. They are
+    // reset by the scanner thread that takes them, not on the get_next() path.
+    // Kept per NUMA node if the scanner pool is NUMA aware, so that scanners reuse
+    // batches whose memory is local to them.
+    SpinLock _free_row_batches_lock;
+    std::vector<std::vector<RowBatch*>> _free_row_batches;
+
     std::list<OlapScanner*> _all_olap_scanners;
     std::list<OlapScanner*> _olap_scanners;
 
@@ -238,6 +290,12 @@ private:
     boost::posix_time::time_duration _wait_duration;
     int _total_assign_num;
     int _nice;
+    // Scheduling state set up in start_scan_thread(), only used by the thread calling
+    // get_next().
+    bool _in_small_scan_pool = false;
+    bool _in_common_pool = false;
+    int64_t _scanner_mem_limit = 0;
+    int _max_scanner_thread = 0;
 
     // protect _status, for many thread may change _status
     boost::mutex _status_mutex;
@@ -252,6 +310,8 @@ private:
 
     int64_t _buffered_bytes;
     int64_t _running_thread;
+    // rows returned by all scanners
+    std::atomic<int64_t> _num_rows_scanned{0};
     EvalConjunctsFn _eval_conjuncts_fn;
 
     // Counters
@@ -274,6 +334,15 @@ private:
     RuntimeProfile::Counter* _block_fetch_timer = nullptr;
 
     RuntimeProfile::Counter* _index_load_timer = nullptr;
+
+    // bytes of segment_v2 data pages found in page cache
+    RuntimeProfile::Counter* _page_cache_read_counter = nullptr;
+    // cpu time of the scanner threads
+    RuntimeProfile::Counter* _scanner_cpu_timer = nullptr;
+    // scanner rounds run on each NUMA node, and those not on the node of their data dir.
+    // Only set up on multi-node machines.
+    std::vector<RuntimeProfile::Counter*> _scanner_numa_node_counters;
+    RuntimeProfile::Counter* _scanner_numa_remote_counter = nullptr;
 };
 
 } // namespace doris
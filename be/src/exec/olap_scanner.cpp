@@ -15,6 +15,7 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 
@@ -22,7 +23,9 @@
 #include "olap_scanner.h"
 #include "olap_scan_node.h"
 #include "olap_utils.h"
+#include "olap/data_dir.h"
 #include "olap/field.h"
+#include "olap/rowset/alpha_rowset.h"
 #include "service/backend_options.h"
 #include "runtime/descriptors.h"
 #include "runtime/runtime_state.h"
@@ -89,6 +92,10 @@ Status OlapScanner::_prepare(
             LOG(WARNING) << ss.str();
             return Status::InternalError(ss.str());
         }
+        // rowsets to read, they are captured under the meta lock, and their readers are
+        // created after the lock is released. Captured rowsets are kept alive by
+        // these references even if they are compacted meanwhile.
+        std::vector<RowsetSharedPtr> rowsets;
         {
             ReadLock rdlock(_tablet->get_header_lock_ptr());
             const RowsetSharedPtr rowset = _tablet->rowset_with_max_version();
@@ -115,7 +122,7 @@ Status OlapScanner::_prepare(
             // to prevent this case: when there are lots of olap scanners to run for example 10000
             // the rowsets maybe compacted when the last olap scanner starts
             Version rd_version(0, _version);
-            OLAPStatus acquire_reader_st = _tablet->capture_rs_readers(rd_version, &_params.rs_readers);
+            OLAPStatus acquire_reader_st = _tablet->capture_consistent_rowsets(rd_version, &rowsets);
             if (acquire_reader_st != OLAP_SUCCESS) {
                 LOG(WARNING) << "fail to init reader.res=" << acquire_reader_st;
                 std::stringstream ss;
@@ -123,6 +130,19 @@ Status OlapScanner::_prepare(
                 << ", res=" << acquire_reader_st << ", backend=" << BackendOptions::get_localhost();
                 return Status::InternalError(ss.str().c_str());
             }
+            _tablet->increase_query_count();
+        }
+        for (auto& rowset : rowsets) {
+            std::shared_ptr<RowsetReader> rs_reader(rowset->create_reader());
+            if (rs_reader == nullptr) {
+                std::stringstream ss;
+                ss << "failed to create reader for rowset " << rowset->rowset_id()
+                   << ". tablet=" << _tablet->full_name()
+                   << ", backend=" << BackendOptions::get_localhost();
+                LOG(WARNING) << ss.str();
+                return Status::InternalError(ss.str());
+            }
+            _params.rs_readers.push_back(std::move(rs_reader));
         }
     }
     
@@ -134,6 +154,13 @@ Status OlapScanner::_prepare(
     return Status::OK();
 }
 
+int OlapScanner::numa_node() const {
+    if (_tablet == nullptr || _tablet->data_dir() == nullptr) {
+        return -1;
+    }
+    return _tablet->data_dir()->numa_node();
+}
+
 Status OlapScanner::open() {
     RETURN_IF_ERROR(_ctor_status);
     SCOPED_TIMER(_parent->_reader_init_timer);
@@ -141,7 +168,31 @@ Status OlapScanner::open() {
     if (_conjunct_ctxs.size() > _direct_conjunct_size) {
         _use_pushdown_conjuncts = true;
     }
+    _direct_conjunct_evaluator.init(_conjunct_ctxs.data(), _direct_conjunct_size);
+    _pushdown_conjunct_evaluator.init(_conjunct_ctxs.data() + _direct_conjunct_size,
+                                      _conjunct_ctxs.size() - _direct_conjunct_size);
+
+    const TOlapScanNode& olap_scan_node = _parent->_olap_scan_node;
+    if (olap_scan_node.__isset.push_down_agg_type
+            && olap_scan_node.push_down_agg_type != TPushAggOp::NONE
+            && _init_meta_rows(olap_scan_node.push_down_agg_type)) {
+        _read_from_meta = true;
+        return Status::OK();
+    }
+
+    // rows are read in order of keys for top n and merge join, which is not kept
+    // by shared scans
+    if (config::enable_olap_shared_scan && !_params.need_ordered_result) {
+        RETURN_IF_ERROR(_attach_shared_scan());
+        if (_shared_scan != nullptr) {
+            // reader of this scanner is initialized when rows of shared scan run out
+            return Status::OK();
+        }
+    }
+    return _init_reader();
+}
 
+Status OlapScanner::_init_reader() {
     auto res = _reader->init(_params);
     if (res != OLAP_SUCCESS) {
         OLAP_LOG_WARNING("fail to init reader.[res=%d]", res);
@@ -150,9 +201,102 @@ Status OlapScanner::open() {
            << ", res=" << res << ", backend=" << BackendOptions::get_localhost();
         return Status::InternalError(ss.str().c_str());
     }
+    _is_reader_inited = true;
     return Status::OK();
 }
 
+Status OlapScanner::_attach_shared_scan() {
+    for (auto cid : _params.return_columns) {
+        if (_tablet->tablet_schema().column(cid).type() == OLAP_FIELD_TYPE_HLL) {
+            return Status::OK();
+        }
+    }
+    // rows are in the same order only if they are read from the same rowsets
+    std::stringstream key;
+    key << _params.to_string() << " return_columns=";
+    for (auto cid : _params.return_columns) {
+        key << cid << ",";
+    }
+    key << " rowsets=";
+    ReaderParams params = _params;
+    params.rs_readers.clear();
+    for (auto& rs_reader : _params.rs_readers) {
+        RowsetSharedPtr rowset = rs_reader->rowset();
+        key << rowset->rowset_id() << ",";
+        // readers of this scanner are kept to read rows not got from shared scan
+        RowsetReaderSharedPtr new_rs_reader = rowset->create_reader();
+        if (new_rs_reader == nullptr) {
+            return Status::OK();
+        }
+        params.rs_readers.push_back(new_rs_reader);
+    }
+
+    int64_t chunk_idx = 0;
+    OLAPStatus res = OlapSharedScanMgr::instance()->attach(
+        key.str(), params, &_shared_scan, &chunk_idx, &_shared_begin_row);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to attach shared scan, read rows alone. tablet="
+                     << _tablet->full_name() << ", res=" << res;
+        _shared_scan.reset();
+        return Status::OK();
+    }
+    _shared_chunk_idx = chunk_idx;
+    _shared_end_row = _shared_begin_row;
+    res = _shared_row_cursor.init(_tablet->tablet_schema(), _params.return_columns);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to init shared row cursor. res=" << res;
+        return Status::InternalError("failed to initialize shared row cursor");
+    }
+    return Status::OK();
+}
+
+Status OlapScanner::_next_row(const RowCursor** row, bool* eof) {
+    while (_shared_scan != nullptr) {
+        if (_shared_chunk != nullptr && _shared_chunk_pos < _shared_chunk->rows.size()) {
+            _shared_row_cursor.attach(_shared_chunk->rows[_shared_chunk_pos++]);
+            ++_shared_end_row;
+            ++_raw_rows_read;
+            *row = &_shared_row_cursor;
+            *eof = false;
+            return Status::OK();
+        }
+        OLAPStatus res = _shared_scan->get_chunk(
+            _shared_chunk_idx++, &_shared_chunk, &_shared_chunk_dropped);
+        if (res != OLAP_SUCCESS) {
+            return Status::InternalError("Internal Error: read storage fail.");
+        }
+        _shared_chunk_pos = 0;
+        if (_shared_chunk == nullptr) {
+            _shared_scan.reset();
+        }
+    }
+
+    // Rows before ones got from shared scan are read by this scanner, so are
+    // rows after them if this scanner fell behind the shared scan.
+    *row = &_read_row_cursor;
+    while (true) {
+        if (_shared_begin_row != -1 && !_shared_chunk_dropped
+                && _private_row_idx == _shared_begin_row) {
+            *eof = true;
+            return Status::OK();
+        }
+        if (!_is_reader_inited) {
+            RETURN_IF_ERROR(_init_reader());
+        }
+        auto res = _reader->next_row_with_aggregation(&_read_row_cursor, eof);
+        if (res != OLAP_SUCCESS) {
+            return Status::InternalError("Internal Error: read storage fail.");
+        }
+        if (*eof) {
+            return Status::OK();
+        }
+        int64_t row_idx = _private_row_idx++;
+        if (row_idx < _shared_begin_row || row_idx >= _shared_end_row) {
+            return Status::OK();
+        }
+    }
+}
+
 // it will be called under tablet read lock because capture rs readers need 
 Status OlapScanner::_init_params(
         const std::vector<OlapScanRange>& key_ranges,
@@ -164,6 +308,16 @@ Status OlapScanner::_init_params(
     _params.reader_type = READER_QUERY;
     _params.aggregation = _aggregation;
     _params.version = Version(0, _version);
+    const TOlapScanNode& olap_scan_node = _parent->_olap_scan_node;
+    if (olap_scan_node.__isset.push_down_topn_limit) {
+        // rows of this scanner are read in order of keys and merged by top n node
+        _topn_limit = olap_scan_node.push_down_topn_limit;
+        _params.need_ordered_result = true;
+    }
+    if (olap_scan_node.__isset.ordered_by_keys && olap_scan_node.ordered_by_keys) {
+        // rows of this scanner are read in order of keys and merged by the scan node
+        _params.need_ordered_result = true;
+    }
 
     // Condition
     for (auto& filter : filters) {
@@ -213,6 +367,15 @@ Status OlapScanner::_init_params(
     }
     _read_row_cursor.allocate_memory_for_string_type(_tablet->tablet_schema());
 
+    for (int i = 0; i < _query_slots.size(); ++i) {
+        SlotDescriptor* slot_desc = _query_slots[i];
+        auto cid = _return_columns[i];
+        _slot_converters.push_back({slot_desc->type().type, slot_desc->tuple_offset(),
+                                    slot_desc->null_indicator_offset(), cid,
+                                    _read_row_cursor.column_size(cid),
+                                    _tablet->tablet_schema().column(cid).is_nullable()});
+    }
+
     return Status::OK();
 }
 
@@ -245,28 +408,157 @@ Status OlapScanner::_init_return_columns() {
     return Status::OK();
 }
 
+bool OlapScanner::_init_meta_rows(TPushAggOp::type agg_type) {
+    // rows in meta are exact only when there are no predicates and no rows to merge
+    if (_tablet->keys_type() != DUP_KEYS || !_conjunct_ctxs.empty()
+            || !_params.conditions.empty() || !_params.start_key.empty()) {
+        return false;
+    }
+    for (auto& rs_reader : _params.rs_readers) {
+        if (rs_reader->rowset()->delete_flag()) {
+            return false;
+        }
+    }
+    // rows removed by DELETE are only filtered out when data is read
+    _tablet->obtain_header_rdlock();
+    bool has_delete_predicate = _tablet->has_delete_predicate_until(_params.version.second);
+    _tablet->release_header_lock();
+    if (has_delete_predicate) {
+        return false;
+    }
+    if (agg_type == TPushAggOp::COUNT) {
+        for (auto& rs_reader : _params.rs_readers) {
+            RowsetSharedPtr rowset = rs_reader->rowset();
+            if (!rowset->zero_num_rows()) {
+                _meta_rows.emplace_back(rowset->num_rows(), nullptr);
+            }
+        }
+        return true;
+    }
+
+    // only key columns which are not string have zone maps to be used
+    for (auto cid : _return_columns) {
+        const TabletColumn& column = _tablet->tablet_schema().column(cid);
+        if (!column.is_key() || column.type() == OLAP_FIELD_TYPE_CHAR
+                || column.type() == OLAP_FIELD_TYPE_VARCHAR
+                || column.type() == OLAP_FIELD_TYPE_HLL) {
+            return false;
+        }
+    }
+    for (auto& rs_reader : _params.rs_readers) {
+        RowsetSharedPtr rowset = rs_reader->rowset();
+        if (rowset->zero_num_rows()) {
+            continue;
+        }
+        if (rowset->rowset_meta()->rowset_type() != ALPHA_ROWSET
+                || rowset->load() != OLAP_SUCCESS) {
+            _meta_rows.clear();
+            return false;
+        }
+        AlphaRowsetSharedPtr alpha_rowset = std::static_pointer_cast<AlphaRowset>(rowset);
+        for (auto& segment_group : alpha_rowset->segment_groups()) {
+            if (segment_group->zero_num_rows()) {
+                continue;
+            }
+            const std::vector<KeyRange>& zone_maps = segment_group->get_zone_maps();
+            for (auto cid : _return_columns) {
+                if (cid >= zone_maps.size() || zone_maps[cid].first == nullptr
+                        || zone_maps[cid].second == nullptr
+                        || zone_maps[cid].first->is_null() || zone_maps[cid].second->is_null()) {
+                    _meta_rows.clear();
+                    return false;
+                }
+            }
+            _meta_rows.emplace_back(segment_group->num_rows(), segment_group);
+        }
+    }
+    return true;
+}
+
+void OlapScanner::_build_tuple_from_zone_maps(
+        const std::vector<KeyRange>& zone_maps, bool is_max, Tuple* tuple) {
+    for (auto cid : _return_columns) {
+        WrapperField* field = is_max ? zone_maps[cid].second : zone_maps[cid].first;
+        _read_row_cursor.set_not_null(cid);
+        _read_row_cursor.set_field_content_shallow(cid, (const char*)field->cell_ptr());
+    }
+    _convert_row_to_tuple(_read_row_cursor, tuple);
+}
+
+Status OlapScanner::_get_batch_from_meta(RowBatch* batch, bool* eof) {
+    SCOPED_TIMER(_parent->_scan_timer);
+    Tuple* tuple = nullptr;
+    while (!batch->is_full() && !_parent->reached_scan_limit(batch->num_rows())) {
+        if (_meta_rows_left == 0) {
+            if (_meta_rows_idx == _meta_rows.size()) {
+                *eof = true;
+                break;
+            }
+            _meta_rows_left = _meta_rows[_meta_rows_idx++].first;
+            tuple = nullptr;
+            continue;
+        }
+        const std::shared_ptr<SegmentGroup>& segment_group = _meta_rows[_meta_rows_idx - 1].second;
+        if (tuple == nullptr) {
+            // rows of one segment group share the same tuples in batch
+            tuple = reinterpret_cast<Tuple*>(
+                batch->tuple_data_pool()->allocate(_tuple_desc->byte_size()));
+            tuple->init(_tuple_desc->byte_size());
+            if (segment_group != nullptr) {
+                _build_tuple_from_zone_maps(segment_group->get_zone_maps(), false, tuple);
+            }
+        }
+        Tuple* row_tuple = tuple;
+        if (segment_group != nullptr && _meta_rows_left == segment_group->num_rows()) {
+            Tuple* max_tuple = reinterpret_cast<Tuple*>(
+                batch->tuple_data_pool()->allocate(_tuple_desc->byte_size()));
+            max_tuple->init(_tuple_desc->byte_size());
+            _build_tuple_from_zone_maps(segment_group->get_zone_maps(), true, max_tuple);
+            row_tuple = max_tuple;
+        }
+        int row_idx = batch->add_row();
+        TupleRow* row = batch->get_row(row_idx);
+        row->set_tuple(_tuple_idx, row_tuple);
+        batch->commit_last_row();
+        --_meta_rows_left;
+        ++_num_rows_read;
+        ++_raw_rows_read;
+    }
+    return Status::OK();
+}
+
 Status OlapScanner::get_batch(
         RuntimeState* state, RowBatch* batch, bool* eof) {
+    if (_read_from_meta) {
+        return _get_batch_from_meta(batch, eof);
+    }
     // 2. Allocate Row's Tuple buf
     uint8_t *tuple_buf = batch->tuple_data_pool()->allocate(
         state->batch_size() * _tuple_desc->byte_size());
     bzero(tuple_buf, state->batch_size() * _tuple_desc->byte_size());
     Tuple *tuple = reinterpret_cast<Tuple*>(tuple_buf);
+    if (_string_slots.empty()) {
+        return _get_batch_by_batch_filter(batch, tuple, eof);
+    }
 
     int64_t raw_rows_threshold = raw_rows_read() + config::doris_scanner_row_num;
     {
         SCOPED_TIMER(_parent->_scan_timer);
         while (true) {
-            // Batch is full, break
-            if (batch->is_full()) {
+            // Batch is full or enough rows are returned for limit, break
+            if (batch->is_full() || _parent->reached_scan_limit(batch->num_rows())) {
                 _update_realtime_counter();
                 break;
             }
-            // Read one row from reader
-            auto res = _reader->next_row_with_aggregation(&_read_row_cursor, eof);
-            if (res != OLAP_SUCCESS) {
-                return Status::InternalError("Internal Error: read storage fail.");
+            // Rows after first top n rows by keys will never be output
+            if (_topn_limit != -1 && _num_rows_returned >= _topn_limit) {
+                *eof = true;
+                _update_realtime_counter();
+                break;
             }
+            // Read one row from reader
+            const RowCursor* row_cursor = nullptr;
+            RETURN_IF_ERROR(_next_row(&row_cursor, eof));
             // If we reach end of this scanner, break
             if (UNLIKELY(*eof)) {
                 _update_realtime_counter();
@@ -275,7 +567,7 @@ Status OlapScanner::get_batch(
 
             _num_rows_read++;
 
-            _convert_row_to_tuple(tuple);
+            _convert_row_to_tuple(*row_cursor, tuple);
             if (VLOG_ROW_IS_ON) {
                 VLOG_ROW << "OlapScanner input row: " << Tuple::to_string(tuple, *_tuple_desc);
             }
@@ -334,25 +626,13 @@ Status OlapScanner::get_batch(
 
                 // check direct && pushdown conjuncts success then commit tuple
                 batch->commit_last_row();
+                ++_num_rows_returned;
                 char* new_tuple = reinterpret_cast<char*>(tuple);
                 new_tuple += _tuple_desc->byte_size();
                 tuple = reinterpret_cast<Tuple*>(new_tuple);
 
                 // compute pushdown conjuncts filter rate
-                if (_use_pushdown_conjuncts) {
-                    // check this rate after
-                    if (_num_rows_read > 32768) {
-                        int32_t pushdown_return_rate
-                            = _num_rows_read * 100 / (_num_rows_read + _num_rows_pushed_cond_filtered);
-                        if (pushdown_return_rate > config::doris_max_pushdown_conjuncts_return_rate) {
-                            _use_pushdown_conjuncts = false;
-                            VLOG(2) << "Stop Using PushDown Conjuncts. "
-                                << "PushDownReturnRate: " << pushdown_return_rate << "%"
-                                << " MaxPushDownReturnRate: "
-                                << config::doris_max_pushdown_conjuncts_return_rate << "%";
-                        }
-                    }
-                }
+                _check_pushdown_return_rate();
             } while (false);
 
             if (raw_rows_read() >= raw_rows_threshold) {
@@ -364,21 +644,143 @@ Status OlapScanner::get_batch(
     return Status::OK();
 }
 
-void OlapScanner::_convert_row_to_tuple(Tuple* tuple) {
-    size_t slots_size = _query_slots.size();
-    for (int i = 0; i < slots_size; ++i) {
-        SlotDescriptor* slot_desc = _query_slots[i];
-        auto cid = _return_columns[i];
-        if (_read_row_cursor.is_null(cid)) {
-            tuple->set_null(slot_desc->null_indicator_offset());
+Status OlapScanner::_get_batch_by_batch_filter(RowBatch* batch, Tuple* tuple, bool* eof) {
+    const int tuple_size = _tuple_desc->byte_size();
+    // the remaining tuples allocated by get_batch()
+    int num_free_tuples = std::min(_runtime_state->batch_size(),
+                                   batch->capacity() - batch->num_rows());
+    _selection.resize(num_free_tuples);
+
+    int64_t raw_rows_threshold = raw_rows_read() + config::doris_scanner_row_num;
+    SCOPED_TIMER(_parent->_scan_timer);
+    while (true) {
+        // Batch is full or enough rows are returned for limit, break
+        if (batch->is_full() || _parent->reached_scan_limit(batch->num_rows())) {
+            _update_realtime_counter();
+            break;
+        }
+        // Rows after first top n rows by keys will never be output
+        if (_topn_limit != -1 && _num_rows_returned >= _topn_limit) {
+            *eof = true;
+            _update_realtime_counter();
+            break;
+        }
+
+        // 1. Read rows into the free tuples and add them to the batch
+        const int begin = batch->num_rows();
+        const int max_rows = std::min(num_free_tuples, batch->capacity() - begin);
+        if (max_rows == 0) {
+            break;
+        }
+        int num_rows = 0;
+        while (num_rows < max_rows) {
+            const RowCursor* row_cursor = nullptr;
+            RETURN_IF_ERROR(_next_row(&row_cursor, eof));
+            if (UNLIKELY(*eof)) {
+                break;
+            }
+            _num_rows_read++;
+            Tuple* row_tuple = reinterpret_cast<Tuple*>(
+                reinterpret_cast<char*>(tuple) + num_rows * tuple_size);
+            _convert_row_to_tuple(*row_cursor, row_tuple);
+            int row_idx = batch->add_row();
+            batch->get_row(row_idx)->set_tuple(_tuple_idx, row_tuple);
+            batch->commit_last_row();
+            _selection[num_rows] = row_idx;
+            ++num_rows;
+        }
+
+        // 2. Filter the rows, direct conjuncts first
+        int num_selected = num_rows;
+        if (_eval_conjuncts_fn != nullptr) {
+            num_selected = 0;
+            for (int i = 0; i < num_rows; ++i) {
+                _selection[num_selected] = _selection[i];
+                num_selected += _eval_conjuncts_fn(
+                    &_conjunct_ctxs[0], _direct_conjunct_size, batch->get_row(_selection[i]));
+            }
+        } else {
+            num_selected = _direct_conjunct_evaluator.filter(batch, &_selection[0], num_rows);
+        }
+        if (_use_pushdown_conjuncts && num_selected > 0) {
+            int num_direct_selected = num_selected;
+            num_selected = _pushdown_conjunct_evaluator.filter(
+                batch, &_selection[0], num_selected);
+            _num_rows_pushed_cond_filtered += num_direct_selected - num_selected;
+        }
+        // Keep the rows within the scan limit and the top n limit, as get_batch() does.
+        while (num_selected > 0 && _parent->reached_scan_limit(begin + num_selected - 1)) {
+            --num_selected;
+        }
+        if (_topn_limit != -1) {
+            num_selected = std::min<int64_t>(num_selected, _topn_limit - _num_rows_returned);
+        }
+
+        // 3. Move the tuples of the selected rows to the front and drop the others,
+        // resetting their tuples for reuse
+        for (int i = 0; i < num_selected; ++i) {
+            int src = _selection[i] - begin;
+            if (src != i) {
+                memcpy(reinterpret_cast<char*>(tuple) + i * tuple_size,
+                       reinterpret_cast<char*>(tuple) + src * tuple_size, tuple_size);
+            }
+        }
+        for (int i = num_selected; i < num_rows; ++i) {
+            reinterpret_cast<Tuple*>(reinterpret_cast<char*>(tuple) + i * tuple_size)
+                ->init(tuple_size);
+        }
+        batch->set_num_rows(begin + num_selected);
+        if (VLOG_ROW_IS_ON) {
+            for (int i = begin; i < batch->num_rows(); ++i) {
+                VLOG_ROW << "OlapScanner output row: "
+                    << Tuple::to_string(batch->get_row(i)->get_tuple(_tuple_idx), *_tuple_desc);
+            }
+        }
+        _num_rows_returned += num_selected;
+        tuple = reinterpret_cast<Tuple*>(reinterpret_cast<char*>(tuple) + num_selected * tuple_size);
+        num_free_tuples -= num_selected;
+
+        _check_pushdown_return_rate();
+
+        if (*eof) {
+            _update_realtime_counter();
+            break;
+        }
+        if (raw_rows_read() >= raw_rows_threshold) {
+            break;
+        }
+    }
+    return Status::OK();
+}
+
+void OlapScanner::_check_pushdown_return_rate() {
+    // check this rate after
+    if (_use_pushdown_conjuncts && _num_rows_read > 32768) {
+        int32_t pushdown_return_rate
+            = _num_rows_read * 100 / (_num_rows_read + _num_rows_pushed_cond_filtered);
+        if (pushdown_return_rate > config::doris_max_pushdown_conjuncts_return_rate) {
+            _use_pushdown_conjuncts = false;
+            VLOG(2) << "Stop Using PushDown Conjuncts. "
+                << "PushDownReturnRate: " << pushdown_return_rate << "%"
+                << " MaxPushDownReturnRate: "
+                << config::doris_max_pushdown_conjuncts_return_rate << "%";
+        }
+    }
+}
+
+void OlapScanner::_convert_row_to_tuple(const RowCursor& row_cursor, Tuple* tuple) {
+    for (auto& converter : _slot_converters) {
+        // the null byte is followed by content of cell
+        char* ptr = row_cursor.nullable_cell_ptr(converter.cid);
+        if (converter.is_nullable && *reinterpret_cast<bool*>(ptr)) {
+            tuple->set_null(converter.null_indicator_offset);
             continue;
         }
-        char* ptr = (char*)_read_row_cursor.cell_ptr(cid);
-        size_t len = _read_row_cursor.column_size(cid);
-        switch (slot_desc->type().type) {
+        ++ptr;
+        switch (converter.type) {
         case TYPE_CHAR: {
             Slice* slice = reinterpret_cast<Slice*>(ptr);
-            StringValue *slot = tuple->get_string_slot(slot_desc->tuple_offset());
+            StringValue *slot = tuple->get_string_slot(converter.tuple_offset);
             slot->ptr = slice->data;
             slot->len = strnlen(slot->ptr, slice->size);
             break;
@@ -386,13 +788,13 @@ void OlapScanner::_convert_row_to_tuple(Tuple* tuple) {
         case TYPE_VARCHAR:
         case TYPE_HLL: {
             Slice* slice = reinterpret_cast<Slice*>(ptr);
-            StringValue *slot = tuple->get_string_slot(slot_desc->tuple_offset());
+            StringValue *slot = tuple->get_string_slot(converter.tuple_offset);
             slot->ptr = slice->data;
             slot->len = slice->size;
             break;
         }
         case TYPE_DECIMAL: {
-            DecimalValue *slot = tuple->get_decimal_slot(slot_desc->tuple_offset());
+            DecimalValue *slot = tuple->get_decimal_slot(converter.tuple_offset);
 
             // TODO(lingbin): should remove this assign, use set member function
             int64_t int_value = *(int64_t*)(ptr);
@@ -401,25 +803,25 @@ void OlapScanner::_convert_row_to_tuple(Tuple* tuple) {
             break;
         }
         case TYPE_DECIMALV2: {
-            DecimalV2Value *slot = tuple->get_decimalv2_slot(slot_desc->tuple_offset());
+            DecimalV2Value *slot = tuple->get_decimalv2_slot(converter.tuple_offset);
 
             int64_t int_value = *(int64_t*)(ptr);
             int32_t frac_value = *(int32_t*)(ptr + sizeof(int64_t));
             if (!slot->from_olap_decimal(int_value, frac_value)) {
-                tuple->set_null(slot_desc->null_indicator_offset());
+                tuple->set_null(converter.null_indicator_offset);
             }
             break;
         }
         case TYPE_DATETIME: {
-            DateTimeValue *slot = tuple->get_datetime_slot(slot_desc->tuple_offset());
+            DateTimeValue *slot = tuple->get_datetime_slot(converter.tuple_offset);
             uint64_t value = *reinterpret_cast<uint64_t*>(ptr);
             if (!slot->from_olap_datetime(value)) {
-                tuple->set_null(slot_desc->null_indicator_offset());
+                tuple->set_null(converter.null_indicator_offset);
             }
             break;
         }
         case TYPE_DATE: {
-            DateTimeValue *slot = tuple->get_datetime_slot(slot_desc->tuple_offset());
+            DateTimeValue *slot = tuple->get_datetime_slot(converter.tuple_offset);
             uint64_t value = 0;
             value = *(unsigned char*)(ptr + 2);
             value <<= 8;
@@ -427,13 +829,13 @@ void OlapScanner::_convert_row_to_tuple(Tuple* tuple) {
             value <<= 8;
             value |= *(unsigned char*)(ptr);
             if (!slot->from_olap_date(value)) {
-                tuple->set_null(slot_desc->null_indicator_offset());
+                tuple->set_null(converter.null_indicator_offset);
             }
             break;
         }
         default: {
-            void *slot = tuple->get_slot(slot_desc->tuple_offset());
-            memory_copy(slot, ptr, len);
+            void *slot = tuple->get_slot(converter.tuple_offset);
+            memory_copy(slot, ptr, converter.len);
             break;
         }
         }
@@ -472,7 +874,26 @@ void OlapScanner::update_counter() {
 
     COUNTER_UPDATE(_parent->_index_load_timer, _reader->stats().index_load_ns);
 
-    DorisMetrics::query_scan_bytes.increment(_reader->stats().compressed_bytes_read);
+    // page cache counters of each column read from segment_v2
+    RuntimeProfile* profile = _parent->runtime_profile();
+    int64_t page_cache_miss_bytes = 0;
+    for (auto& it : _reader->stats().column_page_cache_stats) {
+        page_cache_miss_bytes += it.second.page_cache_miss_bytes;
+        COUNTER_UPDATE(_parent->_page_cache_read_counter, it.second.page_cache_hit_bytes);
+        const std::string& prefix = _tablet->tablet_schema().column(it.first).name();
+        COUNTER_UPDATE(ADD_COUNTER(profile, prefix + "PageCacheHit", TUnit::UNIT),
+                       it.second.page_cache_hit);
+        COUNTER_UPDATE(ADD_COUNTER(profile, prefix + "PageCacheMiss", TUnit::UNIT),
+                       it.second.page_cache_miss);
+        COUNTER_UPDATE(ADD_COUNTER(profile, prefix + "DecompressedPageCacheHit", TUnit::UNIT),
+                       it.second.decompressed_page_cache_hit);
+    }
+
+    // pages of segment_v2 read from file are not counted in compressed_bytes_read
+    COUNTER_UPDATE(_parent->_read_compressed_counter, page_cache_miss_bytes);
+    int64_t file_bytes_read = _reader->stats().compressed_bytes_read + page_cache_miss_bytes;
+    DorisMetrics::query_scan_bytes.increment(file_bytes_read);
+    _tablet->data_dir()->io_scheduler()->record_query_io(file_bytes_read);
     DorisMetrics::query_scan_rows.increment(_reader->stats().raw_rows_read);
 
     _has_update_counter = true;
@@ -481,6 +902,8 @@ void OlapScanner::update_counter() {
 void OlapScanner::_update_realtime_counter() {
     COUNTER_UPDATE(_parent->_read_compressed_counter, _reader->stats().compressed_bytes_read);
     COUNTER_UPDATE(_parent->_raw_rows_counter, _reader->stats().raw_rows_read);
+    // let background IO on the data dir yield to this query
+    _tablet->data_dir()->io_scheduler()->record_query_io(_reader->stats().compressed_bytes_read);
     _reader->mutable_stats()->compressed_bytes_read = 0;
     _raw_rows_read += _reader->mutable_stats()->raw_rows_read;
     _reader->mutable_stats()->raw_rows_read = 0;
@@ -497,6 +920,8 @@ Status OlapScanner::close(RuntimeState* state) {
     // deconstructor in reader references runtime state 
     // so that it will core
     _params.rs_readers.clear();
+    _shared_scan.reset();
+    _shared_chunk.reset();
     update_counter();
     _reader.reset();
     Expr::close(_conjunct_ctxs, state);
@@ -25,8 +25,10 @@
 #include <utility>
 
 #include "common/status.h"
+#include "exec/conjunct_evaluator.h"
 #include "exec/olap_common.h"
 #include "exec/exec_node.h"
+#include "exec/olap_shared_scan.h"
 #include "exprs/expr.h"
 #include "gen_cpp/PaloInternalService_types.h"
 #include "gen_cpp/PlanNodes_types.h"
@@ -39,6 +41,7 @@
 #include "olap/olap_cond.h"
 #include "olap/storage_engine.h"
 #include "olap/reader.h"
+#include "olap/rowset/segment_group.h"
 
 namespace doris {
 
@@ -79,6 +82,9 @@ public:
 
     int64_t raw_rows_read() const { return _raw_rows_read; }
 
+    // NUMA node of the data dir of the tablet, -1 if unknown
+    int numa_node() const;
+
     void update_counter();
 private:
     Status _prepare(
@@ -91,7 +97,26 @@ private:
         const std::vector<TCondition>& filters,
         const std::vector<TCondition>& is_nulls);
     Status _init_return_columns();
-    void _convert_row_to_tuple(Tuple* tuple);
+    Status _init_reader();
+    // Share rows read by other scanners reading the same rows concurrently.
+    Status _attach_shared_scan();
+    // Get next row from shared scan or reader of this scanner.
+    Status _next_row(const RowCursor** row, bool* eof);
+    // Collect number of rows and zone maps of rowsets to answer the aggregation
+    // pushed down to this scanner, return true if all rows can be got from meta.
+    bool _init_meta_rows(TPushAggOp::type agg_type);
+    // Fill tuples in batch from meta of rowsets instead of reading data.
+    Status _get_batch_from_meta(RowBatch* batch, bool* eof);
+    // Build tuple by min values, or max values if is_max is true, of zone maps.
+    void _build_tuple_from_zone_maps(const std::vector<KeyRange>& zone_maps,
+                                     bool is_max, Tuple* tuple);
+    void _convert_row_to_tuple(const RowCursor& row_cursor, Tuple* tuple);
+    // Read rows into the consecutive tuples from 'tuple' a batch at a time and filter
+    // each batch of rows with one pass per conjunct. The tuples must not point into
+    // the row cursor, so this is only used if there are no string slots.
+    Status _get_batch_by_batch_filter(RowBatch* batch, Tuple* tuple, bool* eof);
+    // Stop evaluating pushdown conjuncts if they filter too few rows.
+    void _check_pushdown_return_rate();
 
     // Update profile that need to be reported in realtime.
     void _update_realtime_counter();
@@ -117,6 +142,7 @@ private:
 
     ReaderParams _params;
     std::unique_ptr<Reader> _reader;
+    bool _is_reader_inited = false;
 
     TabletSharedPtr _tablet;
     int64_t _version;
@@ -129,6 +155,18 @@ private:
 
     std::vector<SlotDescriptor*> _query_slots;
 
+    // What is needed to convert a cell of _read_row_cursor into a slot of tuple,
+    // which is got once instead of being looked up again for each row.
+    struct SlotConverter {
+        PrimitiveType type;
+        int tuple_offset;
+        NullIndicatorOffset null_indicator_offset;
+        uint32_t cid;
+        size_t len;
+        bool is_nullable;
+    };
+    std::vector<SlotConverter> _slot_converters;
+
     // time costed and row returned statistics
     ExecNode::EvalConjunctsFn _eval_conjuncts_fn = nullptr;
 
@@ -136,10 +174,40 @@ private:
     int64_t _num_rows_read = 0;
     int64_t _raw_rows_read = 0;
 
+    // Rows are got from meta of rowsets if aggregation is pushed down. Each item is
+    // number of rows of a rowset for count, or of a segment group for min/max, whose
+    // rows are filled by min values of zone maps except one row by max values.
+    bool _read_from_meta = false;
+    std::vector<std::pair<int64_t, std::shared_ptr<SegmentGroup>>> _meta_rows;
+    size_t _meta_rows_idx = 0;
+    int64_t _meta_rows_left = 0;
+
+    // Rows from _shared_begin_row to _shared_end_row among all rows are got from
+    // shared scan, -1 means rows are not shared. Other rows are read by _reader.
+    std::shared_ptr<OlapSharedScan> _shared_scan;
+    std::shared_ptr<OlapSharedScan::Chunk> _shared_chunk;
+    size_t _shared_chunk_pos = 0;
+    int64_t _shared_chunk_idx = 0;
+    bool _shared_chunk_dropped = false;
+    int64_t _shared_begin_row = -1;
+    int64_t _shared_end_row = -1;
+    int64_t _private_row_idx = 0;
+    RowCursor _shared_row_cursor;
+
+    // Only first rows by keys are needed if top n is pushed down, -1 means
+    // all rows are needed
+    int64_t _topn_limit = -1;
+    int64_t _num_rows_returned = 0;
+
     RuntimeProfile::Counter* _rows_pushed_cond_filtered_counter = nullptr;
     // number rows filtered by pushed condition
     int64_t _num_rows_pushed_cond_filtered = 0;
 
+    // indexes of the rows passing the conjuncts, used by _get_batch_by_batch_filter()
+    std::vector<int> _selection;
+    ConjunctEvaluator _direct_conjunct_evaluator;
+    ConjunctEvaluator _pushdown_conjunct_evaluator;
+
     bool _is_closed = false;
 };
 
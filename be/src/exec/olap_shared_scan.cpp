@@ -0,0 +1,145 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/olap_shared_scan.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "olap/row.h"
+
+namespace doris {
+
+// rows of each chunk shared by scanners
+static const int SHARED_SCAN_CHUNK_ROWS = 1024;
+
+OlapSharedScan::~OlapSharedScan() {
+    _params.rs_readers.clear();
+    _reader.reset();
+}
+
+OLAPStatus OlapSharedScan::init(const ReaderParams& params) {
+    _params = params;
+    _params.runtime_state = nullptr;
+    _params.profile = nullptr;
+    _reader.reset(new Reader());
+    RETURN_NOT_OK(_reader->init(_params));
+    const TabletSchema& schema = _params.tablet->tablet_schema();
+    RETURN_NOT_OK(_read_row_cursor.init(schema, _params.return_columns));
+    _read_row_cursor.allocate_memory_for_string_type(schema);
+    RETURN_NOT_OK(_chunk_row_cursor.init(schema, _params.return_columns));
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus OlapSharedScan::get_chunk(int64_t idx, std::shared_ptr<Chunk>* chunk, bool* dropped) {
+    std::lock_guard<std::mutex> l(_lock);
+    chunk->reset();
+    *dropped = idx < _first_chunk_idx;
+    if (*dropped) {
+        return OLAP_SUCCESS;
+    }
+    while (idx >= _first_chunk_idx + (int64_t)_chunks.size()) {
+        if (_eof) {
+            return OLAP_SUCCESS;
+        }
+        RETURN_NOT_OK(_read_chunk());
+    }
+    *chunk = _chunks[idx - _first_chunk_idx];
+    return OLAP_SUCCESS;
+}
+
+bool OlapSharedScan::get_start(int64_t* chunk_idx, int64_t* row_idx) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_eof && _chunks.empty()) {
+        return false;
+    }
+    *chunk_idx = _first_chunk_idx;
+    *row_idx = _first_row_idx;
+    return true;
+}
+
+OLAPStatus OlapSharedScan::_read_chunk() {
+    std::shared_ptr<Chunk> chunk(new Chunk());
+    chunk->tracker.reset(new MemTracker(-1));
+    chunk->mem_pool.reset(new MemPool(chunk->tracker.get()));
+    size_t fixed_len = _chunk_row_cursor.get_fixed_len();
+    while (chunk->rows.size() < SHARED_SCAN_CHUNK_ROWS) {
+        RETURN_NOT_OK(_reader->next_row_with_aggregation(&_read_row_cursor, &_eof));
+        if (_eof) {
+            break;
+        }
+        char* buf = reinterpret_cast<char*>(chunk->mem_pool->allocate(fixed_len));
+        _chunk_row_cursor.attach(buf);
+        copy_row(&_chunk_row_cursor, _read_row_cursor, chunk->mem_pool.get());
+        chunk->rows.push_back(buf);
+    }
+    if (_eof) {
+        // release files and memory of reader as early as possible
+        _reader.reset();
+        _params.rs_readers.clear();
+    }
+    if (chunk->rows.empty()) {
+        return OLAP_SUCCESS;
+    }
+    _chunks.push_back(chunk);
+    while (_chunks.size() > (size_t)std::max(config::olap_shared_scan_max_chunks, 1)) {
+        _first_row_idx += _chunks.front()->rows.size();
+        _chunks.pop_front();
+        ++_first_chunk_idx;
+    }
+    return OLAP_SUCCESS;
+}
+
+OlapSharedScanMgr* OlapSharedScanMgr::instance() {
+    static OlapSharedScanMgr mgr;
+    return &mgr;
+}
+
+OLAPStatus OlapSharedScanMgr::attach(const std::string& key, const ReaderParams& params,
+                                     std::shared_ptr<OlapSharedScan>* scan,
+                                     int64_t* chunk_idx, int64_t* row_idx) {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _scans.find(key);
+        if (it != _scans.end()) {
+            *scan = it->second.lock();
+            if (*scan != nullptr && (*scan)->get_start(chunk_idx, row_idx)) {
+                return OLAP_SUCCESS;
+            }
+        }
+    }
+
+    // reader is initialized out of lock since it may read files
+    std::shared_ptr<OlapSharedScan> new_scan(new OlapSharedScan());
+    RETURN_NOT_OK(new_scan->init(params));
+    *scan = new_scan;
+    *chunk_idx = 0;
+    *row_idx = 0;
+
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto it = _scans.begin(); it != _scans.end();) {
+        if (it->second.expired()) {
+            it = _scans.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _scans[key] = new_scan;
+    return OLAP_SUCCESS;
+}
+
+} // namespace doris
@@ -0,0 +1,100 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_QUERY_EXEC_OLAP_SHARED_SCAN_H
+#define DORIS_BE_SRC_QUERY_EXEC_OLAP_SHARED_SCAN_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "olap/reader.h"
+#include "olap/row_cursor.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+
+namespace doris {
+
+// Rows read from storage by one Reader, which are shared by scanners reading
+// the same rows concurrently, that is the same tablet, version, rowsets,
+// columns, key ranges and conditions, for example panels of a dashboard
+// refreshed at the same time. Whichever scanner wants rows not read yet reads
+// the next chunk for all of them. Only the latest chunks are kept, a scanner
+// falling behind them has to read the remaining rows itself.
+class OlapSharedScan {
+public:
+    struct Chunk {
+        std::unique_ptr<MemTracker> tracker;
+        std::unique_ptr<MemPool> mem_pool;
+        // fixed buffers of rows which can be attached to row cursors
+        std::vector<char*> rows;
+    };
+
+    OlapSharedScan() { }
+    ~OlapSharedScan();
+
+    // Params are copied without runtime state and profile, which belong to
+    // the scanner creating the scan.
+    OLAPStatus init(const ReaderParams& params);
+
+    // Get chunk of index 'idx', read it if it is not read yet. Chunk is set to
+    // nullptr if all rows have been read before it, or if it has been dropped,
+    // when 'dropped' is set to true.
+    OLAPStatus get_chunk(int64_t idx, std::shared_ptr<Chunk>* chunk, bool* dropped);
+
+    // Get the first chunk kept and the index of its first row among all rows,
+    // from which a new scanner starts to share rows. Return false if there are
+    // no rows to share any more.
+    bool get_start(int64_t* chunk_idx, int64_t* row_idx);
+
+private:
+    OLAPStatus _read_chunk();
+
+    std::mutex _lock;
+    ReaderParams _params;
+    std::unique_ptr<Reader> _reader;
+    RowCursor _read_row_cursor;
+    RowCursor _chunk_row_cursor;
+    std::deque<std::shared_ptr<Chunk>> _chunks;
+    // index of the first chunk in _chunks and of its first row
+    int64_t _first_chunk_idx = 0;
+    int64_t _first_row_idx = 0;
+    bool _eof = false;
+};
+
+class OlapSharedScanMgr {
+public:
+    static OlapSharedScanMgr* instance();
+
+    // Get the shared scan of key being read, or create one by params. Rows of
+    // a new scan are shared from its start, and rows of an existing one from
+    // 'chunk_idx' whose first row is of index 'row_idx'.
+    OLAPStatus attach(const std::string& key, const ReaderParams& params,
+                      std::shared_ptr<OlapSharedScan>* scan,
+                      int64_t* chunk_idx, int64_t* row_idx);
+
+private:
+    std::mutex _lock;
+    std::map<std::string, std::weak_ptr<OlapSharedScan>> _scans;
+};
+
+} // namespace doris
+
+#endif
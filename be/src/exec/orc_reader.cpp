@@ -0,0 +1,104 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "exec/parquet_reader.h"
+#include "exec/orc_reader.h"
+
+#include <algorithm>
+
+#include "common/logging.h"
+
+namespace doris {
+
+OrcReaderWrap::OrcReaderWrap(FileReader *file_reader) : ParquetReaderWrap(file_reader) {
+}
+
+OrcReaderWrap::~OrcReaderWrap() {
+}
+
+Status OrcReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs) {
+    arrow::Status status = arrow::adapters::orc::ORCFileReader::Open(
+            _parquet, arrow::default_memory_pool(), &_orc_reader);
+    if (!status.ok()) {
+        LOG(WARNING) << "Open orc file failed. " << status.ToString();
+        return Status::InternalError(status.ToString());
+    }
+    _total_groups = _orc_reader->NumberOfStripes();
+    if (_total_groups == 0) {
+        return Status::EndOfFile("Empty Orc File");
+    }
+
+    // map
+    std::shared_ptr<arrow::Schema> schema;
+    status = _orc_reader->ReadSchema(&schema);
+    if (!status.ok()) {
+        LOG(WARNING) << "Read orc schema failed. " << status.ToString();
+        return Status::InternalError(status.ToString());
+    }
+    for (int i = 0; i < schema->num_fields(); ++i) {
+        _map_column.emplace(schema->field(i)->name(), i);
+    }
+    RETURN_IF_ERROR(column_indices(tuple_slot_descs));
+    std::vector<int> sorted_ids(_parquet_column_ids);
+    std::sort(sorted_ids.begin(), sorted_ids.end());
+    for (int id : _parquet_column_ids) {
+        _stripe_column_index.push_back(
+            std::lower_bound(sorted_ids.begin(), sorted_ids.end(), id) - sorted_ids.begin());
+    }
+
+    bool eof = false;
+    RETURN_IF_ERROR(read_stripe(&eof));
+    if (eof) {
+        return Status::EndOfFile("Empty Orc File");
+    }
+    return init_column_types();
+}
+
+Status OrcReaderWrap::read_record_batch(const std::vector<SlotDescriptor*>& tuple_slot_descs, bool* eof) {
+    if (_current_line_of_batch < _batch->num_rows()) {
+        return Status::OK();
+    }
+    _current_group++;
+    return read_stripe(eof);
+}
+
+void OrcReaderWrap::set_batch_columns() {
+    _current_line_of_batch = 0;
+    _batch_columns.resize(_stripe_column_index.size());
+    for (int i = 0; i < _stripe_column_index.size(); ++i) {
+        _batch_columns[i] = _batch->column(_stripe_column_index[i]);
+    }
+}
+
+Status OrcReaderWrap::read_stripe(bool* eof) {
+    for (; _current_group < _total_groups; ++_current_group) {
+        arrow::Status status = _orc_reader->ReadStripe(_current_group, _parquet_column_ids, &_batch);
+        if (!status.ok()) {
+            LOG(WARNING) << "Read orc stripe failed. stripe=" << _current_group
+                << ", " << status.ToString();
+            return Status::InternalError(status.ToString());
+        }
+        if (_batch->num_rows() > 0) {
+            set_batch_columns();
+            return Status::OK();
+        }
+    }
+    _parquet_column_ids.clear();
+    *eof = true;
+    return Status::OK();
+}
+
+}
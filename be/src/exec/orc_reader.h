@@ -0,0 +1,53 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <arrow/adapters/orc/adapter.h>
+
+#include "exec/parquet_reader.h"
+
+namespace doris {
+
+// Reader of broker orc file.
+// Stripes are read one at a time with only the columns of the tuple, through the arrow
+// orc adapter, and converted to tuples by ParquetReaderWrap.
+class OrcReaderWrap : public ParquetReaderWrap {
+public:
+    OrcReaderWrap(FileReader *file_reader);
+    virtual ~OrcReaderWrap();
+
+    Status init_parquet_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs) override;
+
+protected:
+    Status read_record_batch(const std::vector<SlotDescriptor*>& tuple_slot_descs, bool* eof) override;
+    void set_batch_columns() override;
+
+private:
+    // Reads stripes from _current_group on until one has rows, sets *eof when there is none
+    Status read_stripe(bool* eof);
+
+    std::unique_ptr<arrow::adapters::orc::ORCFileReader> _orc_reader;
+    // A stripe has the columns read in file order, this is the position of the
+    // column of every tuple slot in it.
+    std::vector<int> _stripe_column_index;
+};
+
+}
@@ -26,6 +26,7 @@
 #include "runtime/client_cache.h"
 #include "runtime/exec_env.h"
 #include "util/thrift_util.h"
+#include "gutil/strings/numbers.h"
 #include "runtime/tuple.h"
 #include "runtime/descriptors.h"
 #include "runtime/mem_pool.h"
@@ -35,7 +36,7 @@ namespace doris {
 // Broker
 
 ParquetReaderWrap::ParquetReaderWrap(FileReader *file_reader) :
-           _total_groups(0), _current_group(0), _rows_of_group(0), _current_line_of_group(0) {
+           _total_groups(0), _current_group(0), _current_line_of_batch(0) {
     _parquet = std::shared_ptr<ParquetFile>(new ParquetFile(file_reader));
     _properties = parquet::ReaderProperties();
     _properties.enable_buffered_stream();
@@ -58,7 +59,6 @@ Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>
         if (_total_groups == 0) {
             return Status::EndOfFile("Empty Parquet File");
         }
-        _rows_of_group = _file_metadata->RowGroup(0)->num_rows();
 
         // map
         auto *schemaDescriptor = _file_metadata->schema();
@@ -67,7 +67,7 @@ Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>
             _map_column.emplace(schemaDescriptor->Column(i)->name(), i);
         }
 
-        if (_current_line_of_group == 0) {// the first read
+        if (_batch == nullptr) {// the first read
             RETURN_IF_ERROR(column_indices(tuple_slot_descs));
             // read batch
             arrow::Status status = _reader->GetRecordBatchReader({_current_group}, _parquet_column_ids, &_rb_batch);
@@ -80,16 +80,11 @@ Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>
                 LOG(WARNING) << "The first read record. " << status.ToString();
                 return Status::InternalError(status.ToString());
             }
-            //save column type
-            std::shared_ptr<arrow::Schema> field_schema = _batch->schema();
-            for (int i = 0; i < _parquet_column_ids.size(); i++) {
-                std::shared_ptr<arrow::Field>  field = field_schema->field(i);
-                if (!field) {
-                    LOG(WARNING) << "Get filed schema failed. Column order:" << i;
-                    return Status::InternalError(status.ToString());
-                }
-                _parquet_column_type.emplace_back(field->type()->id());
+            if (_batch == nullptr) {
+                return Status::EndOfFile("Empty Parquet File");
             }
+            set_batch_columns();
+            RETURN_IF_ERROR(init_column_types());
         }
         return Status::OK();
     } catch (parquet::ParquetException& e) {
@@ -147,18 +142,45 @@ inline Status ParquetReaderWrap::set_field_null(Tuple* tuple, const SlotDescript
     return Status::OK();
 }
 
+Status ParquetReaderWrap::init_column_types() {
+    //save column type
+    for (int i = 0; i < _parquet_column_ids.size(); i++) {
+        if (i >= _batch_columns.size()) {
+            LOG(WARNING) << "Get filed schema failed. Column order:" << i;
+            return Status::InternalError("Get field schema failed.");
+        }
+        _parquet_column_type.emplace_back(_batch_columns[i]->type_id());
+    }
+    return Status::OK();
+}
+
+void ParquetReaderWrap::set_batch_columns() {
+    // keep the columns of the batch, so that reading a value doesn't copy a shared_ptr
+    _current_line_of_batch = 0;
+    _batch_columns.resize(_batch->num_columns());
+    for (int i = 0; i < _batch->num_columns(); ++i) {
+        _batch_columns[i] = _batch->column(i);
+    }
+}
+
 Status ParquetReaderWrap::read_record_batch(const std::vector<SlotDescriptor*>& tuple_slot_descs, bool* eof) {
-    if (_current_line_of_group >= _rows_of_group) {// read next row group
+    if (_current_line_of_batch < _batch->num_rows()) {
+        return Status::OK();
+    }
+    // a row group with more rows than the batch size of the reader comes in several batches
+    arrow::Status status = _rb_batch->ReadNext(&_batch);
+    if (!status.ok()) {
+        return Status::InternalError("Read Batch Error With Libarrow.");
+    }
+    while (_batch == nullptr) {// read next row group
         _current_group++;
         if (_current_group >= _total_groups) {// read completed.
             _parquet_column_ids.clear();
             *eof = true;
             return Status::OK();
         }
-        _current_line_of_group = 0;
-        _rows_of_group = _file_metadata->RowGroup(_current_group)->num_rows(); //get rows of the current row group
         // read batch
-        arrow::Status status = _reader->GetRecordBatchReader({_current_group}, _parquet_column_ids, &_rb_batch);
+        status = _reader->GetRecordBatchReader({_current_group}, _parquet_column_ids, &_rb_batch);
         if (!status.ok()) {
             return Status::InternalError("Get RecordBatchReader Failed.");
         }
@@ -167,28 +189,29 @@ Status ParquetReaderWrap::read_record_batch(const std::vector<SlotDescriptor*>&
             return Status::InternalError("Read Batch Error With Libarrow.");
         }
     }
+    set_batch_columns();
     return Status::OK();
 }
 
-Status ParquetReaderWrap::handle_timestamp(const std::shared_ptr<arrow::TimestampArray>& ts_array, uint8_t *buf, int32_t *wbytes) {
+Status ParquetReaderWrap::handle_timestamp(const arrow::TimestampArray* ts_array, uint8_t *buf, int32_t *wbytes) {
     const auto type = std::dynamic_pointer_cast<arrow::TimestampType>(ts_array->type());
     // Doris only supports seconds
     time_t timestamp = 0;
     switch (type->unit()) {
         case arrow::TimeUnit::type::NANO: {// INT96
-            timestamp = (time_t)((int64_t)ts_array->Value(_current_line_of_group) / 1000000000); // convert to Second
+            timestamp = (time_t)((int64_t)ts_array->Value(_current_line_of_batch) / 1000000000); // convert to Second
             break;
         }
         case arrow::TimeUnit::type::SECOND: {
-            timestamp = (time_t)ts_array->Value(_current_line_of_group);
+            timestamp = (time_t)ts_array->Value(_current_line_of_batch);
             break;
         }
         case arrow::TimeUnit::type::MILLI: {
-            timestamp = (time_t)((int64_t)ts_array->Value(_current_line_of_group) / 1000); // convert to Second
+            timestamp = (time_t)((int64_t)ts_array->Value(_current_line_of_batch) / 1000); // convert to Second
             break;
         }
         case arrow::TimeUnit::type::MICRO: {
-            timestamp = (time_t)((int64_t)ts_array->Value(_current_line_of_group) / 1000000); // convert to Second
+            timestamp = (time_t)((int64_t)ts_array->Value(_current_line_of_batch) / 1000000); // convert to Second
             break;
         }
         default:
@@ -200,6 +223,15 @@ Status ParquetReaderWrap::handle_timestamp(const std::shared_ptr<arrow::Timestam
     return Status::OK();
 }
 
+Status ParquetReaderWrap::handle_date(const arrow::Date32Array* date_array, uint8_t *buf, int32_t *wbytes) {
+    // days since the unix epoch
+    time_t timestamp = (time_t)date_array->Value(_current_line_of_batch) * 86400;
+    struct tm date;
+    gmtime_r(&timestamp, &date);
+    *wbytes = (uint32_t)strftime((char*)buf, 64, "%Y-%m-%d", &date);
+    return Status::OK();
+}
+
 Status ParquetReaderWrap::read(Tuple* tuple, const std::vector<SlotDescriptor*>& tuple_slot_descs, MemPool* mem_pool, bool* eof) {
     uint8_t tmp_buf[128] = {0};
     int32_t wbytes = 0;
@@ -212,85 +244,85 @@ Status ParquetReaderWrap::read(Tuple* tuple, const std::vector<SlotDescriptor*>&
             column_index = i;// column index in batch record
             switch (_parquet_column_type[i]) {
                 case arrow::Type::type::STRING: {
-                    auto str_array = std::dynamic_pointer_cast<arrow::StringArray>(_batch->column(column_index));
-                    if (str_array->IsNull(_current_line_of_group)) {
+                    auto str_array = static_cast<const arrow::StringArray*>(_batch_columns[column_index].get());
+                    if (str_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        value = str_array->GetValue(_current_line_of_group, &wbytes);
+                        value = str_array->GetValue(_current_line_of_batch, &wbytes);
                         fill_slot(tuple, slot_desc, mem_pool, value, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::INT32: {
-                    auto int32_array = std::dynamic_pointer_cast<arrow::Int32Array>(_batch->column(column_index));
-                    if (int32_array->IsNull(_current_line_of_group)) {
+                    auto int32_array = static_cast<const arrow::Int32Array*>(_batch_columns[column_index].get());
+                    if (int32_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        int32_t value = int32_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%d", value);
+                        int32_t value = int32_array->Value(_current_line_of_batch);
+                        wbytes = FastInt32ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::INT64: {
-                    auto int64_array = std::dynamic_pointer_cast<arrow::Int64Array>(_batch->column(column_index));
-                    if (int64_array->IsNull(_current_line_of_group)) {
+                    auto int64_array = static_cast<const arrow::Int64Array*>(_batch_columns[column_index].get());
+                    if (int64_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        int64_t value = int64_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%ld", value);
+                        int64_t value = int64_array->Value(_current_line_of_batch);
+                        wbytes = FastInt64ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::UINT32: {
-                    auto uint32_array = std::dynamic_pointer_cast<arrow::UInt32Array>(_batch->column(column_index));
-                    if (uint32_array->IsNull(_current_line_of_group)) {
+                    auto uint32_array = static_cast<const arrow::UInt32Array*>(_batch_columns[column_index].get());
+                    if (uint32_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        uint32_t value = uint32_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%u", value);
+                        uint32_t value = uint32_array->Value(_current_line_of_batch);
+                        wbytes = FastUInt32ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::UINT64: {
-                    auto uint64_array = std::dynamic_pointer_cast<arrow::UInt64Array>(_batch->column(column_index));
-                    if (uint64_array->IsNull(_current_line_of_group)) {
+                    auto uint64_array = static_cast<const arrow::UInt64Array*>(_batch_columns[column_index].get());
+                    if (uint64_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        uint64_t value = uint64_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%lu", value);
+                        uint64_t value = uint64_array->Value(_current_line_of_batch);
+                        wbytes = FastUInt64ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::BINARY: {
-                    auto str_array = std::dynamic_pointer_cast<arrow::BinaryArray>(_batch->column(column_index));
-                    if (str_array->IsNull(_current_line_of_group)) {
+                    auto str_array = static_cast<const arrow::BinaryArray*>(_batch_columns[column_index].get());
+                    if (str_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                      value = str_array->GetValue(_current_line_of_group, &wbytes);
+                      value = str_array->GetValue(_current_line_of_batch, &wbytes);
                       fill_slot(tuple, slot_desc, mem_pool, value, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::FIXED_SIZE_BINARY: {
-                    auto fixed_array = std::dynamic_pointer_cast<arrow::FixedSizeBinaryArray>(_batch->column(column_index));
-                    if (fixed_array->IsNull(_current_line_of_group)) {
+                    auto fixed_array = static_cast<const arrow::FixedSizeBinaryArray*>(_batch_columns[column_index].get());
+                    if (fixed_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        string value = fixed_array->GetString(_current_line_of_group);
+                        string value = fixed_array->GetString(_current_line_of_batch);
                         fill_slot(tuple, slot_desc, mem_pool, (uint8_t*)value.c_str(), value.length());
                     }
                     break;
                 }
                 case arrow::Type::type::BOOL: {
-                    auto boolean_array = std::dynamic_pointer_cast<arrow::BooleanArray>(_batch->column(column_index));
-                    if (boolean_array->IsNull(_current_line_of_group)) {
+                    auto boolean_array = static_cast<const arrow::BooleanArray*>(_batch_columns[column_index].get());
+                    if (boolean_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        bool value = boolean_array->Value(_current_line_of_group);
+                        bool value = boolean_array->Value(_current_line_of_batch);
                         if (value) {
                             fill_slot(tuple, slot_desc, mem_pool, (uint8_t*)"true", 4);
                         } else {
@@ -300,85 +332,85 @@ Status ParquetReaderWrap::read(Tuple* tuple, const std::vector<SlotDescriptor*>&
                     break;
                 }
                 case arrow::Type::type::UINT8: {
-                    auto uint8_array = std::dynamic_pointer_cast<arrow::UInt8Array>(_batch->column(column_index));
-                    if (uint8_array->IsNull(_current_line_of_group)) {
+                    auto uint8_array = static_cast<const arrow::UInt8Array*>(_batch_columns[column_index].get());
+                    if (uint8_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        uint8_t value = uint8_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%d", value);
+                        uint8_t value = uint8_array->Value(_current_line_of_batch);
+                        wbytes = FastUInt32ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::INT8: {
-                    auto int8_array = std::dynamic_pointer_cast<arrow::Int8Array>(_batch->column(column_index));
-                    if (int8_array->IsNull(_current_line_of_group)) {
+                    auto int8_array = static_cast<const arrow::Int8Array*>(_batch_columns[column_index].get());
+                    if (int8_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        int8_t value = int8_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%d", value);
+                        int8_t value = int8_array->Value(_current_line_of_batch);
+                        wbytes = FastInt32ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::UINT16: {
-                    auto uint16_array = std::dynamic_pointer_cast<arrow::UInt16Array>(_batch->column(column_index));
-                    if (uint16_array->IsNull(_current_line_of_group)) {
+                    auto uint16_array = static_cast<const arrow::UInt16Array*>(_batch_columns[column_index].get());
+                    if (uint16_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        uint16_t value = uint16_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%d", value);
+                        uint16_t value = uint16_array->Value(_current_line_of_batch);
+                        wbytes = FastUInt32ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::INT16: {
-                    auto int16_array = std::dynamic_pointer_cast<arrow::Int16Array>(_batch->column(column_index));
-                    if (int16_array->IsNull(_current_line_of_group)) {
+                    auto int16_array = static_cast<const arrow::Int16Array*>(_batch_columns[column_index].get());
+                    if (int16_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        int16_t value = int16_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%d", value);
+                        int16_t value = int16_array->Value(_current_line_of_batch);
+                        wbytes = FastInt32ToBufferLeft(value, (char*)tmp_buf) - (char*)tmp_buf;
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::HALF_FLOAT: {
-                    auto half_float_array = std::dynamic_pointer_cast<arrow::HalfFloatArray>(_batch->column(column_index));
-                    if (half_float_array->IsNull(_current_line_of_group)) {
+                    auto half_float_array = static_cast<const arrow::HalfFloatArray*>(_batch_columns[column_index].get());
+                    if (half_float_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        float value = half_float_array->Value(_current_line_of_group);
+                        float value = half_float_array->Value(_current_line_of_batch);
                         wbytes = sprintf((char*)tmp_buf, "%f", value);
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::FLOAT: {
-                    auto float_array = std::dynamic_pointer_cast<arrow::FloatArray>(_batch->column(column_index));
-                    if (float_array->IsNull(_current_line_of_group)) {
+                    auto float_array = static_cast<const arrow::FloatArray*>(_batch_columns[column_index].get());
+                    if (float_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        float value = float_array->Value(_current_line_of_group);
+                        float value = float_array->Value(_current_line_of_batch);
                         wbytes = sprintf((char*)tmp_buf, "%f", value);
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::DOUBLE: {
-                    auto double_array = std::dynamic_pointer_cast<arrow::DoubleArray>(_batch->column(column_index));
-                    if (double_array->IsNull(_current_line_of_group)) {
+                    auto double_array = static_cast<const arrow::DoubleArray*>(_batch_columns[column_index].get());
+                    if (double_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        float value = double_array->Value(_current_line_of_group);
-                        wbytes = sprintf((char*)tmp_buf, "%f", value);
+                        double value = double_array->Value(_current_line_of_batch);
+                        wbytes = DoubleToBuffer(value, sizeof(tmp_buf), (char*)tmp_buf);
                         fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                     }
                     break;
                 }
                 case arrow::Type::type::TIMESTAMP: {
-                    auto ts_array = std::dynamic_pointer_cast<arrow::TimestampArray>(_batch->column(column_index));
-                    if (ts_array->IsNull(_current_line_of_group)) {
+                    auto ts_array = static_cast<const arrow::TimestampArray*>(_batch_columns[column_index].get());
+                    if (ts_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
                         RETURN_IF_ERROR(handle_timestamp(ts_array, tmp_buf, &wbytes));// convert timestamp to string time
@@ -386,12 +418,22 @@ Status ParquetReaderWrap::read(Tuple* tuple, const std::vector<SlotDescriptor*>&
                     }
                     break;
                 }
+                case arrow::Type::type::DATE32: {
+                    auto date_array = static_cast<const arrow::Date32Array*>(_batch_columns[column_index].get());
+                    if (date_array->IsNull(_current_line_of_batch)) {
+                        RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
+                    } else {
+                        RETURN_IF_ERROR(handle_date(date_array, tmp_buf, &wbytes));
+                        fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
+                    }
+                    break;
+                }
                 case arrow::Type::type::DECIMAL: {
-                    auto decimal_array = std::dynamic_pointer_cast<arrow::DecimalArray>(_batch->column(column_index));
-                    if (decimal_array->IsNull(_current_line_of_group)) {
+                    auto decimal_array = static_cast<const arrow::DecimalArray*>(_batch_columns[column_index].get());
+                    if (decimal_array->IsNull(_current_line_of_batch)) {
                         RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                     } else {
-                        std::string value = decimal_array->FormatValue(_current_line_of_group);
+                        std::string value = decimal_array->FormatValue(_current_line_of_batch);
                         fill_slot(tuple, slot_desc, mem_pool, (const uint8_t*)value.c_str(), value.length());
                     }
                     break;
@@ -401,7 +443,7 @@ Status ParquetReaderWrap::read(Tuple* tuple, const std::vector<SlotDescriptor*>&
                     std::stringstream str_error;
                     str_error << "The field name("<< slot_desc->col_name() <<"), type("<< _parquet_column_type[i] <<
                             ") not support. RowGroup: " << _current_group
-                            << ", Row: " << _current_line_of_group << ", ColumnIndex:" << column_index;
+                            << ", Row: " << _current_line_of_batch << ", ColumnIndex:" << column_index;
                     LOG(WARNING) << str_error.str();
                     return Status::InternalError(str_error.str());
                 }
@@ -409,14 +451,14 @@ Status ParquetReaderWrap::read(Tuple* tuple, const std::vector<SlotDescriptor*>&
         }
     } catch (parquet::ParquetException& e) {
         std::stringstream str_error;
-        str_error << e.what() << " RowGroup:" << _current_group << ", Row:" << _current_line_of_group
+        str_error << e.what() << " RowGroup:" << _current_group << ", Row:" << _current_line_of_batch
                             << ", ColumnIndex " << column_index;
         LOG(WARNING) << str_error.str();
         return Status::InternalError(str_error.str());
     }
 
     // update data value
-    ++_current_line_of_group;
+    ++_current_line_of_batch;
     return read_record_batch(tuple_slot_descs, eof);
 }
 
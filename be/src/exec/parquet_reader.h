@@ -65,7 +65,9 @@ private:
     FileReader *_file;
 };
 
-// Reader of broker parquet file
+// Reader of broker parquet file.
+// Converts the arrow record batches read from the file into tuples, readers of other
+// columnar formats with an arrow adapter only provide the batches (see OrcReaderWrap).
 class ParquetReaderWrap {
 public:
     ParquetReaderWrap(FileReader *file_reader);
@@ -75,16 +77,22 @@ public:
     Status read(Tuple* tuple, const std::vector<SlotDescriptor*>& tuple_slot_descs, MemPool* mem_pool, bool* eof);
     void close();
     Status size(int64_t* size);
-    Status init_parquet_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs);
+    virtual Status init_parquet_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs);
 
-private:
+protected:
     void fill_slot(Tuple* tuple, SlotDescriptor* slot_desc, MemPool* mem_pool, const uint8_t* value, int32_t len);
     Status column_indices(const std::vector<SlotDescriptor*>& tuple_slot_descs);
     Status set_field_null(Tuple* tuple, const SlotDescriptor* slot_desc);
-    Status read_record_batch(const std::vector<SlotDescriptor*>& tuple_slot_descs, bool* eof);
-    Status handle_timestamp(const std::shared_ptr<arrow::TimestampArray>& ts_array, uint8_t *buf, int32_t *wbtyes);
+    // Saves the type of every column read from _batch_columns
+    Status init_column_types();
+    // Sets _batch_columns to the columns of _batch in the order of the tuple slots
+    virtual void set_batch_columns();
+    // Makes _batch hold the next row to read, sets *eof when there is none
+    virtual Status read_record_batch(const std::vector<SlotDescriptor*>& tuple_slot_descs, bool* eof);
+    Status handle_timestamp(const arrow::TimestampArray* ts_array, uint8_t *buf, int32_t *wbtyes);
+    Status handle_date(const arrow::Date32Array* date_array, uint8_t *buf, int32_t *wbtyes);
 
-private:
+protected:
     parquet::ReaderProperties _properties;
     std::shared_ptr<ParquetFile> _parquet;
 
@@ -99,8 +107,9 @@ private:
     int _total_groups; // groups in a parquet file
     int _current_group;
 
-    int _rows_of_group; // rows in a group.
-    int _current_line_of_group;
+    // columns of _batch
+    std::vector<std::shared_ptr<arrow::Array>> _batch_columns;
+    int _current_line_of_batch;
 };
 
 }
@@ -30,7 +30,7 @@
 #include "exec/local_file_reader.h"
 #include "exec/broker_reader.h"
 #include "exec/decompressor.h"
-#include "exec/parquet_reader.h"
+#include "exec/orc_reader.h"
 
 namespace doris {
 
@@ -141,7 +141,11 @@ Status ParquetScanner::open_next_reader() {
             file_reader->close();
             continue;
         }
-        _cur_file_reader = new ParquetReaderWrap(file_reader.release());
+        if (range.format_type == TFileFormatType::FORMAT_ORC) {
+            _cur_file_reader = new OrcReaderWrap(file_reader.release());
+        } else {
+            _cur_file_reader = new ParquetReaderWrap(file_reader.release());
+        }
         Status status = _cur_file_reader->init_parquet_reader(_src_slot_descs);
         if (status.is_end_of_file()) {
             continue;
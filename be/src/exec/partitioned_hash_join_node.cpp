@@ -0,0 +1,587 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/partitioned_hash_join_node.h"
+
+#include <sstream>
+
+#include "common/object_pool.h"
+#include "exec/new_partitioned_hash_table.inline.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "runtime/buffered_tuple_stream3.inline.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/query_trace.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/tuple_row.h"
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+PartitionedHashJoinNode::PartitionedHashJoinNode(
+        ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs) :
+            ExecNode(pool, tnode, descs),
+            _state(nullptr),
+            _join_op(tnode.hash_join_node.join_op),
+            _probe_tuple_row_size(0),
+            _build_tuple_row_size(0),
+            _build_tuple_size(0),
+            _probe_state(PROBING),
+            _probe_batch_pos(0),
+            _probe_eos(false),
+            _current_probe_row(nullptr),
+            _matched_probe(false),
+            _unmatched_partition_idx(-1),
+            _build_timer(nullptr),
+            _probe_timer(nullptr),
+            _build_rows_counter(nullptr),
+            _probe_rows_counter(nullptr),
+            _num_hash_buckets(nullptr) {
+    _match_all_probe =
+        (_join_op == TJoinOp::LEFT_OUTER_JOIN || _join_op == TJoinOp::FULL_OUTER_JOIN);
+    _match_one_build = (_join_op == TJoinOp::LEFT_SEMI_JOIN);
+    _match_all_build =
+        (_join_op == TJoinOp::RIGHT_OUTER_JOIN || _join_op == TJoinOp::FULL_OUTER_JOIN);
+}
+
+PartitionedHashJoinNode::~PartitionedHashJoinNode() {
+    // _probe_batch must be cleaned up in close() to ensure proper resource freeing.
+    DCHECK(_probe_batch == nullptr);
+}
+
+Status PartitionedHashJoinNode::init(const TPlanNode& tnode, RuntimeState* state) {
+    RETURN_IF_ERROR(ExecNode::init(tnode, state));
+    DCHECK(tnode.__isset.hash_join_node);
+    DCHECK_NE(_join_op, TJoinOp::NULL_AWARE_LEFT_ANTI_JOIN);
+    const std::vector<TEqJoinCondition>& eq_join_conjuncts =
+        tnode.hash_join_node.eq_join_conjuncts;
+
+    for (int i = 0; i < eq_join_conjuncts.size(); ++i) {
+        Expr* expr = nullptr;
+        RETURN_IF_ERROR(Expr::create(eq_join_conjuncts[i].left, child(0)->row_desc(),
+                state, &expr, mem_tracker()));
+        _probe_exprs.push_back(expr);
+        RETURN_IF_ERROR(Expr::create(eq_join_conjuncts[i].right, child(1)->row_desc(),
+                state, &expr, mem_tracker()));
+        _build_exprs.push_back(expr);
+    }
+
+    RETURN_IF_ERROR(
+        Expr::create_expr_trees(_pool, tnode.hash_join_node.other_join_conjuncts,
+                                &_other_join_conjunct_ctxs));
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::prepare(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_ERROR(ExecNode::prepare(state));
+    _state = state;
+
+    _build_timer = ADD_TIMER(runtime_profile(), "BuildTime");
+    _probe_timer = ADD_TIMER(runtime_profile(), "ProbeTime");
+    _build_rows_counter = ADD_COUNTER(runtime_profile(), "BuildRows", TUnit::UNIT);
+    _probe_rows_counter = ADD_COUNTER(runtime_profile(), "ProbeRows", TUnit::UNIT);
+    _num_hash_buckets = ADD_COUNTER(runtime_profile(), "HashBuckets", TUnit::UNIT);
+
+    // _other_join_conjuncts are evaluated in the context of the rows produced by this node
+    RETURN_IF_ERROR(Expr::prepare(
+            _other_join_conjunct_ctxs, state, _row_descriptor, expr_mem_tracker()));
+
+    int num_probe_tuples = child(0)->row_desc().tuple_descriptors().size();
+    _build_tuple_size = child(1)->row_desc().tuple_descriptors().size();
+    _probe_tuple_row_size = num_probe_tuples * sizeof(Tuple*);
+    _build_tuple_row_size = _build_tuple_size * sizeof(Tuple*);
+
+    // Same NULL semantics as HashJoinNode: joins which return unmatched build rows
+    // keep build rows with NULL keys, and NULL keys match each other in that case.
+    const bool stores_nulls = _join_op == TJoinOp::RIGHT_OUTER_JOIN
+        || _join_op == TJoinOp::FULL_OUTER_JOIN
+        || _join_op == TJoinOp::RIGHT_ANTI_JOIN
+        || _join_op == TJoinOp::RIGHT_SEMI_JOIN;
+    _expr_results_pool.reset(new MemPool(expr_mem_tracker()));
+    RETURN_IF_ERROR(NewPartitionedHashTableCtx::Create(_pool, state, _build_exprs,
+            _probe_exprs, stores_nulls, std::vector<bool>(_build_exprs.size(), stores_nulls),
+            state->fragment_hash_seed(), 1, _build_tuple_size,
+            expr_mem_pool(), _expr_results_pool.get(), expr_mem_tracker(),
+            child(1)->row_desc(), child(0)->row_desc(), &_ht_ctx));
+    _partition_pool.reset(new ObjectPool());
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::open(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_ERROR(ExecNode::open(state));
+    RETURN_IF_CANCELLED(state);
+    RETURN_IF_ERROR(Expr::open(_other_join_conjunct_ctxs, state));
+    RETURN_IF_ERROR(_ht_ctx->Open(state));
+
+    // Consume the whole build side before opening the probe side, so the probe
+    // child doesn't hold memory while the partitions are filled.
+    RETURN_IF_ERROR(child(1)->open(state));
+
+    // Claim reservation after the child has been opened to reduce the peak reservation
+    // requirement.
+    if (!_buffer_pool_client.is_registered()) {
+        RETURN_IF_ERROR(claim_buffer_reservation(state));
+    }
+    if (_ht_allocator == nullptr) {
+        _ht_allocator.reset(new Suballocator(state->exec_env()->buffer_pool(),
+                &_buffer_pool_client, _resource_profile.spillable_buffer_size));
+    }
+    RETURN_IF_ERROR(create_hash_partitions());
+    {
+        RowBatch build_batch(child(1)->row_desc(), state->batch_size(), mem_tracker());
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_CANCELLED(state);
+            RETURN_IF_ERROR(child(1)->get_next(state, &build_batch, &eos));
+            SCOPED_TIMER(_build_timer);
+            // The build streams deep copy the rows, so 'build_batch' can be reused.
+            RETURN_IF_ERROR(partition_build_batch(&build_batch));
+            build_batch.reset();
+        }
+    }
+    {
+        SCOPED_TIMER(_build_timer);
+        RETURN_IF_ERROR(build_hash_tables());
+    }
+
+    RETURN_IF_ERROR(child(0)->open(state));
+    _probe_batch.reset(new RowBatch(child(0)->row_desc(), state->batch_size(), mem_tracker()));
+    _probe_batch_pos = 0;
+    _probe_eos = false;
+    _current_probe_row = nullptr;
+    _probe_state = PROBING;
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* eos) {
+    RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
+    RETURN_IF_CANCELLED(state);
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
+
+    if (reached_limit()) {
+        *eos = true;
+        return Status::OK();
+    }
+
+    *eos = false;
+    while (true) {
+        if (_probe_state == PROBING) {
+            {
+                SCOPED_TIMER(_probe_timer);
+                RETURN_IF_ERROR(process_probe_batch(out_batch));
+            }
+            if (out_batch->is_full() || reached_limit()) {
+                break;
+            }
+            // '_probe_batch' is used up.
+            if (_probe_eos) {
+                _probe_state =
+                    need_output_unmatched_build() ? OUTPUTTING_UNMATCHED : PROBE_DONE;
+                _unmatched_partition_idx = -1;
+                _hash_tbl_iterator.SetAtEnd();
+                continue;
+            }
+            RETURN_IF_ERROR(next_probe_batch(state, out_batch));
+            if (out_batch->at_resource_limit()) {
+                break;
+            }
+        } else if (_probe_state == OUTPUTTING_UNMATCHED) {
+            output_unmatched_build(out_batch);
+            if (out_batch->is_full() || reached_limit()) {
+                break;
+            }
+        } else {
+            DCHECK_EQ(_probe_state, PROBE_DONE);
+            close_hash_partitions(out_batch);
+            *eos = true;
+            break;
+        }
+    }
+
+    if (reached_limit()) {
+        *eos = true;
+    }
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::close(RuntimeState* state) {
+    if (is_closed()) {
+        return Status::OK();
+    }
+
+    // Must reset _probe_batch in close() to release resources
+    _probe_batch.reset(nullptr);
+
+    for (Partition* partition : _hash_partitions) {
+        partition->close(nullptr);
+    }
+    _hash_partitions.clear();
+    if (_partition_pool != nullptr) {
+        _partition_pool->clear();
+    }
+
+    if (_ht_ctx != nullptr) {
+        _ht_ctx->Close(state);
+        _ht_ctx.reset();
+    }
+    if (_expr_results_pool != nullptr) {
+        _expr_results_pool->free_all();
+    }
+    Expr::close(_build_exprs);
+    Expr::close(_probe_exprs);
+    Expr::close(_other_join_conjunct_ctxs, state);
+    return ExecNode::close(state);
+}
+
+Status PartitionedHashJoinNode::create_hash_partitions() {
+    DCHECK(_hash_partitions.empty());
+    for (int i = 0; i < PARTITION_FANOUT; ++i) {
+        Partition* partition = _partition_pool->add(new Partition(this, i));
+        // Add before init() so the partition is closed on error.
+        _hash_partitions.push_back(partition);
+        RETURN_IF_ERROR(partition->init());
+    }
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::partition_build_batch(RowBatch* build_batch) {
+    NewPartitionedHashTableCtx* ht_ctx = _ht_ctx.get();
+    for (int i = 0; i < build_batch->num_rows(); ++i) {
+        TupleRow* row = build_batch->get_row(i);
+        // Build rows with NULL keys can never be matched and are dropped unless the
+        // join returns unmatched build rows.
+        if (!ht_ctx->EvalAndHashBuild(row)) {
+            continue;
+        }
+        uint32_t hash = ht_ctx->expr_values_cache()->CurExprValuesHash();
+        Partition* partition = _hash_partitions[hash >> (32 - NUM_PARTITIONING_BITS)];
+        Status status;
+        if (UNLIKELY(!partition->build_rows()->AddRow(row, &status))) {
+            RETURN_IF_ERROR(status);
+            std::stringstream error_msg;
+            error_msg << "Not enough reservation to add build rows in hash join node with id "
+                      << _id << ". " << _buffer_pool_client.DebugString();
+            return _state->set_mem_limit_exceeded(error_msg.str());
+        }
+    }
+    COUNTER_UPDATE(_build_rows_counter, build_batch->num_rows());
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::build_hash_tables() {
+    SCOPED_TRACE_SPAN(_state, "HashJoinBuild", "join");
+    for (Partition* partition : _hash_partitions) {
+        if (partition->build_rows()->num_rows() == 0) {
+            continue;
+        }
+        RETURN_IF_ERROR(partition->build_hash_table());
+        COUNTER_UPDATE(_num_hash_buckets, partition->hash_tbl()->num_buckets());
+    }
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::next_probe_batch(RuntimeState* state, RowBatch* out_batch) {
+    // pass on resources, out_batch might still need them
+    _probe_batch->transfer_resource_ownership(out_batch);
+    _probe_batch_pos = 0;
+    while (!_probe_eos) {
+        RETURN_IF_ERROR(child(0)->get_next(state, _probe_batch.get(), &_probe_eos));
+        if (_probe_batch->num_rows() > 0) {
+            COUNTER_UPDATE(_probe_rows_counter, _probe_batch->num_rows());
+            break;
+        }
+        // Empty batches can still contain IO buffers, which need to be passed up to
+        // the caller.
+        _probe_batch->transfer_resource_ownership(out_batch);
+    }
+    return Status::OK();
+}
+
+void PartitionedHashJoinNode::find_probe_row() {
+    if (!_ht_ctx->EvalAndHashProbe(_current_probe_row)) {
+        // NULL key which can't match anything.
+        _hash_tbl_iterator.SetAtEnd();
+        return;
+    }
+    uint32_t hash = _ht_ctx->expr_values_cache()->CurExprValuesHash();
+    Partition* partition = _hash_partitions[hash >> (32 - NUM_PARTITIONING_BITS)];
+    if (partition->hash_tbl() == nullptr) {
+        _hash_tbl_iterator.SetAtEnd();
+    } else {
+        _hash_tbl_iterator = partition->hash_tbl()->FindProbeRow(_ht_ctx.get());
+    }
+}
+
+Status PartitionedHashJoinNode::process_probe_batch(RowBatch* out_batch) {
+    ExprContext* const* other_conjunct_ctxs = _other_join_conjunct_ctxs.data();
+    int num_other_conjunct_ctxs = _other_join_conjunct_ctxs.size();
+    const bool right_semi_or_anti = _join_op == TJoinOp::RIGHT_SEMI_JOIN
+        || _join_op == TJoinOp::RIGHT_ANTI_JOIN;
+
+    while (true) {
+        if (_current_probe_row == nullptr) {
+            if (_probe_batch_pos == _probe_batch->num_rows()) {
+                return Status::OK();
+            }
+            _current_probe_row = _probe_batch->get_row(_probe_batch_pos++);
+            _matched_probe = false;
+            find_probe_row();
+        }
+
+        // create output rows for the matching build rows
+        while (!_hash_tbl_iterator.AtEnd()) {
+            if (right_semi_or_anti && _hash_tbl_iterator.IsMatched()) {
+                // We have already matched this build row, continue to next match.
+                _hash_tbl_iterator.NextDuplicate();
+                continue;
+            }
+            int row_idx = out_batch->add_row();
+            TupleRow* out_row = out_batch->get_row(row_idx);
+            create_output_row(out_row, _current_probe_row, _hash_tbl_iterator.GetRow());
+            if (!eval_conjuncts(other_conjunct_ctxs, num_other_conjunct_ctxs, out_row)) {
+                _hash_tbl_iterator.NextDuplicate();
+                continue;
+            }
+
+            // we have a match for the purpose of the (outer?) join as soon as we
+            // satisfy the JOIN clause conjuncts
+            _matched_probe = true;
+            if (_match_all_build || right_semi_or_anti) {
+                _hash_tbl_iterator.SetMatched();
+            }
+            if (_join_op == TJoinOp::LEFT_ANTI_JOIN) {
+                // equal match won't return
+                _hash_tbl_iterator.SetAtEnd();
+                break;
+            }
+            if (_join_op == TJoinOp::RIGHT_ANTI_JOIN) {
+                _hash_tbl_iterator.NextDuplicate();
+                continue;
+            }
+            if (_match_one_build) {
+                _hash_tbl_iterator.SetAtEnd();
+            } else {
+                _hash_tbl_iterator.NextDuplicate();
+            }
+            if (commit_output_row(out_batch, row_idx, out_row)) {
+                return Status::OK();
+            }
+        }
+
+        // check whether we need to output the current probe row before
+        // moving on to the next one
+        TupleRow* probe_row = _current_probe_row;
+        _current_probe_row = nullptr;
+        if (!_matched_probe && (_match_all_probe || _join_op == TJoinOp::LEFT_ANTI_JOIN)) {
+            int row_idx = out_batch->add_row();
+            TupleRow* out_row = out_batch->get_row(row_idx);
+            create_output_row(out_row, probe_row, nullptr);
+            if (commit_output_row(out_batch, row_idx, out_row)) {
+                return Status::OK();
+            }
+        }
+    }
+}
+
+void PartitionedHashJoinNode::output_unmatched_build(RowBatch* out_batch) {
+    while (true) {
+        if (_hash_tbl_iterator.AtEnd()) {
+            // move on to the next partition with a non-empty hash table
+            for (++_unmatched_partition_idx;
+                    _unmatched_partition_idx < _hash_partitions.size();
+                    ++_unmatched_partition_idx) {
+                NewPartitionedHashTable* hash_tbl =
+                    _hash_partitions[_unmatched_partition_idx]->hash_tbl();
+                if (hash_tbl != nullptr && hash_tbl->size() > 0) {
+                    break;
+                }
+            }
+            if (_unmatched_partition_idx == _hash_partitions.size()) {
+                _probe_state = PROBE_DONE;
+                return;
+            }
+            _hash_tbl_iterator = _hash_partitions[_unmatched_partition_idx]->hash_tbl()
+                ->FirstUnmatched(_ht_ctx.get());
+            continue;
+        }
+        int row_idx = out_batch->add_row();
+        TupleRow* out_row = out_batch->get_row(row_idx);
+        create_output_row(out_row, nullptr, _hash_tbl_iterator.GetRow());
+        _hash_tbl_iterator.NextUnmatched();
+        if (commit_output_row(out_batch, row_idx, out_row)) {
+            return;
+        }
+    }
+}
+
+void PartitionedHashJoinNode::close_hash_partitions(RowBatch* out_batch) {
+    for (Partition* partition : _hash_partitions) {
+        partition->close(out_batch);
+    }
+    _hash_partitions.clear();
+}
+
+bool PartitionedHashJoinNode::commit_output_row(
+        RowBatch* out_batch, int row_idx, TupleRow* out_row) {
+    DCHECK_EQ(out_batch->get_row(row_idx), out_row);
+    if (!eval_conjuncts(_conjunct_ctxs.data(), _conjunct_ctxs.size(), out_row)) {
+        return false;
+    }
+    out_batch->commit_last_row();
+    VLOG_ROW << "match row: " << out_row->to_string(row_desc());
+    ++_num_rows_returned;
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    return out_batch->is_full() || reached_limit();
+}
+
+void PartitionedHashJoinNode::create_output_row(
+        TupleRow* out, TupleRow* probe, TupleRow* build) {
+    uint8_t* out_ptr = reinterpret_cast<uint8_t*>(out);
+    if (probe == nullptr) {
+        memset(out_ptr, 0, _probe_tuple_row_size);
+    } else {
+        memcpy(out_ptr, probe, _probe_tuple_row_size);
+    }
+
+    if (build == nullptr) {
+        memset(out_ptr + _probe_tuple_row_size, 0, _build_tuple_row_size);
+    } else {
+        memcpy(out_ptr + _probe_tuple_row_size, build, _build_tuple_row_size);
+    }
+}
+
+void PartitionedHashJoinNode::debug_string(
+        int indentation_level, std::stringstream* out) const {
+    *out << std::string(indentation_level * 2, ' ');
+    *out << "PartitionedHashJoinNode(join_op=" << _join_op
+         << " probe_state=" << _probe_state
+         << " hash_partitions=" << _hash_partitions.size();
+    ExecNode::debug_string(indentation_level, out);
+    *out << ")";
+}
+
+PartitionedHashJoinNode::Partition::Partition(PartitionedHashJoinNode* parent, int idx) :
+            _parent(parent),
+            _idx(idx),
+            _is_closed(false) {
+}
+
+PartitionedHashJoinNode::Partition::~Partition() {
+    DCHECK(_is_closed);
+}
+
+Status PartitionedHashJoinNode::Partition::init() {
+    _build_rows.reset(new BufferedTupleStream3(_parent->_state,
+            &_parent->child(1)->row_desc(), &_parent->_buffer_pool_client,
+            _parent->_resource_profile.spillable_buffer_size,
+            _parent->_resource_profile.max_row_buffer_size));
+    RETURN_IF_ERROR(_build_rows->Init(_parent->id(), true));
+    bool got_buffer = false;
+    RETURN_IF_ERROR(_build_rows->PrepareForWrite(&got_buffer));
+    if (!got_buffer) {
+        std::stringstream error_msg;
+        error_msg << "Not enough reservation to create partition " << _idx
+                  << " in hash join node with id "
+                  << _parent->id() << ". " << _parent->_buffer_pool_client.DebugString();
+        return _parent->_state->set_mem_limit_exceeded(error_msg.str());
+    }
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::Partition::build_hash_table() {
+    DCHECK(_hash_tbl == nullptr);
+    int64_t num_buckets = NewPartitionedHashTable::EstimateNumBuckets(_build_rows->num_rows());
+    if (num_buckets > MAX_HASH_TABLE_BUCKETS) {
+        std::stringstream error_msg;
+        error_msg << "Partition " << _idx << " of hash join node with id " << _parent->id()
+                  << " has too many rows (" << _build_rows->num_rows() << ") for a hash table";
+        return _parent->_state->set_mem_limit_exceeded(error_msg.str());
+    }
+    // Sized for all rows up front, so inserts never have to resize the buckets.
+    _hash_tbl.reset(NewPartitionedHashTable::Create(_parent->_ht_allocator.get(), true,
+            _parent->_build_tuple_size, _build_rows.get(), MAX_HASH_TABLE_BUCKETS, num_buckets));
+    bool got_memory = false;
+    RETURN_IF_ERROR(_hash_tbl->Init(&got_memory));
+    if (!got_memory) {
+        close_hash_table();
+        return not_enough_reservation_for_hash_table();
+    }
+
+    bool got_read_buffer = false;
+    RETURN_IF_ERROR(_build_rows->PrepareForRead(false, &got_read_buffer));
+    DCHECK(got_read_buffer) << "Stream is pinned";
+
+    NewPartitionedHashTableCtx* ht_ctx = _parent->_ht_ctx.get();
+    RowBatch batch(_parent->child(1)->row_desc(), _parent->_state->batch_size(),
+            _parent->mem_tracker());
+    std::vector<BufferedTupleStream3::FlatRowPtr> flat_rows;
+    bool eos = false;
+    while (!eos) {
+        RETURN_IF_ERROR(_build_rows->GetNext(&batch, &eos, &flat_rows));
+        DCHECK_EQ(batch.num_rows(), flat_rows.size());
+        for (int i = 0; i < batch.num_rows(); ++i) {
+            TupleRow* row = batch.get_row(i);
+            // Rows with NULL keys were dropped while partitioning if not needed.
+            bool hashed = ht_ctx->EvalAndHashBuild(row);
+            DCHECK(hashed);
+            Status status;
+            if (UNLIKELY(!_hash_tbl->Insert(ht_ctx, flat_rows[i], row, &status))) {
+                // Out of memory for the duplicate nodes.
+                RETURN_IF_ERROR(status);
+                close_hash_table();
+                return not_enough_reservation_for_hash_table();
+            }
+        }
+        batch.reset();
+    }
+    return Status::OK();
+}
+
+Status PartitionedHashJoinNode::Partition::not_enough_reservation_for_hash_table() {
+    std::stringstream error_msg;
+    error_msg << "Not enough reservation to build hash table of partition " << _idx
+              << " in hash join node with id " << _parent->id() << ". "
+              << _parent->_buffer_pool_client.DebugString();
+    return _parent->_state->set_mem_limit_exceeded(error_msg.str());
+}
+
+void PartitionedHashJoinNode::Partition::close_hash_table() {
+    if (_hash_tbl != nullptr) {
+        _hash_tbl->Close();
+        _hash_tbl.reset();
+    }
+}
+
+void PartitionedHashJoinNode::Partition::close(RowBatch* batch) {
+    if (_is_closed) {
+        return;
+    }
+    _is_closed = true;
+    close_hash_table();
+    RowBatch::FlushMode flush = batch != nullptr
+        ? RowBatch::FlushMode::FLUSH_RESOURCES : RowBatch::FlushMode::NO_FLUSH_RESOURCES;
+    if (_build_rows != nullptr) {
+        _build_rows->Close(batch, flush);
+    }
+}
+
+}
@@ -0,0 +1,215 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_EXEC_PARTITIONED_HASH_JOIN_NODE_H
+#define DORIS_BE_SRC_EXEC_PARTITIONED_HASH_JOIN_NODE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/scoped_ptr.hpp>
+
+#include "exec/exec_node.h"
+#include "exec/new_partitioned_hash_table.h"
+#include "runtime/buffered_tuple_stream3.h"
+#include "runtime/bufferpool/suballocator.h"
+#include "gen_cpp/PlanNodes_types.h"
+
+namespace doris {
+
+class Expr;
+class ExprContext;
+class MemPool;
+class RowBatch;
+class TupleRow;
+
+// Hash join node which keeps the build side in BufferedTupleStream3 instead of a
+// MemPool, so all of its memory is accounted against the node's buffer pool
+// reservation.
+//
+// Build rows from child(1) are hash partitioned into PARTITION_FANOUT partitions on
+// the top NUM_PARTITIONING_BITS bits of the join key hash, and every partition gets
+// a NewPartitionedHashTable over its stream, so no single hash table has to be
+// sized for the whole build side. All partitions stay in memory: the buffer pool of
+// this tree can't write pages to scratch files, so when the reservation is exhausted
+// the query fails with mem limit exceeded, just like HashJoinNode does.
+//
+// Supports all join ops of HashJoinNode except NULL_AWARE_LEFT_ANTI_JOIN, which
+// exec_node still routes to HashJoinNode. Runtime predicate push down into the probe
+// side scan is not done by this node.
+class PartitionedHashJoinNode : public ExecNode {
+public:
+    PartitionedHashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
+    ~PartitionedHashJoinNode();
+
+    virtual Status init(const TPlanNode& tnode, RuntimeState* state = nullptr);
+    virtual Status prepare(RuntimeState* state);
+    virtual Status open(RuntimeState* state);
+    virtual Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos);
+    virtual Status close(RuntimeState* state);
+
+protected:
+    virtual void debug_string(int indentation_level, std::stringstream* out) const;
+
+private:
+    // Number of partitions the build input is split into.
+    static const int PARTITION_FANOUT = 16;
+
+    // Needs to be the log(PARTITION_FANOUT).
+    static const int NUM_PARTITIONING_BITS = 4;
+
+    // The top NUM_PARTITIONING_BITS bits pick the partition, so a hash table of one
+    // partition can only make use of the remaining bits.
+    static const int64_t MAX_HASH_TABLE_BUCKETS = 1L << (32 - NUM_PARTITIONING_BITS);
+
+    enum ProbeState {
+        // Joining probe rows from child(0).
+        PROBING,
+        // Returning unmatched build rows of the partitions.
+        OUTPUTTING_UNMATCHED,
+        // All rows are returned.
+        PROBE_DONE,
+    };
+
+    class Partition {
+    public:
+        Partition(PartitionedHashJoinNode* parent, int idx);
+        ~Partition();
+
+        // Allocates the build stream and its first write page.
+        Status init();
+
+        // Builds the hash table over all rows of the build stream. Returns a mem
+        // limit exceeded error if the reservation could not hold the hash table.
+        Status build_hash_table();
+
+        // Releases the stream and the hash table. Pages backing rows that were
+        // returned to the caller are attached to 'batch' if it is not NULL.
+        void close(RowBatch* batch);
+
+        bool is_closed() const { return _is_closed; }
+        NewPartitionedHashTable* hash_tbl() const { return _hash_tbl.get(); }
+        BufferedTupleStream3* build_rows() const { return _build_rows.get(); }
+
+    private:
+        void close_hash_table();
+
+        Status not_enough_reservation_for_hash_table();
+
+        PartitionedHashJoinNode* _parent;
+        const int _idx;
+        bool _is_closed;
+
+        // All build rows of the partition, pinned until the partition is closed.
+        std::unique_ptr<BufferedTupleStream3> _build_rows;
+
+        boost::scoped_ptr<NewPartitionedHashTable> _hash_tbl;
+    };
+
+    // Creates PARTITION_FANOUT empty partitions in '_hash_partitions'.
+    Status create_hash_partitions();
+
+    // Appends the rows of 'build_batch' to the build streams of '_hash_partitions'.
+    // Returns a mem limit exceeded error if the reservation runs out.
+    Status partition_build_batch(RowBatch* build_batch);
+
+    // Builds the hash tables of every non-empty partition in '_hash_partitions'.
+    Status build_hash_tables();
+
+    // Fetches the next non-empty probe batch into '_probe_batch'. Sets '_probe_eos'
+    // once the probe input is exhausted.
+    Status next_probe_batch(RuntimeState* state, RowBatch* out_batch);
+
+    // Joins rows of '_probe_batch' starting at '_probe_batch_pos' into 'out_batch'
+    // until either runs out.
+    Status process_probe_batch(RowBatch* out_batch);
+
+    // Looks up '_current_probe_row' in the hash table of its partition.
+    void find_probe_row();
+
+    // Returns unmatched build rows of the partitions for right/full joins.
+    void output_unmatched_build(RowBatch* out_batch);
+
+    // Closes every partition, attaching the memory referenced by returned rows to
+    // 'out_batch'.
+    void close_hash_partitions(RowBatch* out_batch);
+
+    // Adds 'out_row' to 'out_batch' if it passes the conjuncts. Returns true if
+    // 'out_batch' is full or the limit is reached.
+    bool commit_output_row(RowBatch* out_batch, int row_idx, TupleRow* out_row);
+
+    void create_output_row(TupleRow* out_row, TupleRow* probe_row, TupleRow* build_row);
+
+    bool need_output_unmatched_build() const {
+        return _match_all_build || _join_op == TJoinOp::RIGHT_ANTI_JOIN;
+    }
+
+    RuntimeState* _state;
+
+    TJoinOp::type _join_op;
+
+    // our equi-join predicates "<lhs> = <rhs>" are separated into
+    // _build_exprs (over child(1)) and _probe_exprs (over child(0))
+    std::vector<Expr*> _build_exprs;
+    std::vector<Expr*> _probe_exprs;
+
+    // non-equi-join conjuncts from the JOIN clause
+    std::vector<ExprContext*> _other_join_conjunct_ctxs;
+
+    // derived from _join_op
+    bool _match_all_probe;  // output all rows coming from the probe input
+    bool _match_one_build;  // match at most one build row to each probe row
+    bool _match_all_build;  // output all rows coming from the build input
+
+    int _probe_tuple_row_size;
+    int _build_tuple_row_size;
+    int _build_tuple_size;
+
+    // Pool for the values of the join exprs cached in '_ht_ctx'.
+    boost::scoped_ptr<MemPool> _expr_results_pool;
+    boost::scoped_ptr<NewPartitionedHashTableCtx> _ht_ctx;
+
+    // Allocates hash table buckets and duplicate nodes from the node's reservation.
+    boost::scoped_ptr<Suballocator> _ht_allocator;
+
+    boost::scoped_ptr<ObjectPool> _partition_pool;
+
+    std::vector<Partition*> _hash_partitions;
+
+    ProbeState _probe_state;
+
+    boost::scoped_ptr<RowBatch> _probe_batch;
+    int _probe_batch_pos;
+    bool _probe_eos;
+    TupleRow* _current_probe_row;
+    bool _matched_probe;
+    NewPartitionedHashTable::Iterator _hash_tbl_iterator;
+
+    // Partition whose unmatched build rows are being returned.
+    int _unmatched_partition_idx;
+
+    RuntimeProfile::Counter* _build_timer;
+    RuntimeProfile::Counter* _probe_timer;
+    RuntimeProfile::Counter* _build_rows_counter;
+    RuntimeProfile::Counter* _probe_rows_counter;
+    RuntimeProfile::Counter* _num_hash_buckets;
+};
+
+}
+
+#endif
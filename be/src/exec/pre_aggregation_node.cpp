@@ -221,6 +221,7 @@ Status PreAggregationNode::get_next(RuntimeState* state, RowBatch* row_batch, bo
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     SCOPED_TIMER(_get_results_timer);
     int read_time = 0;
 
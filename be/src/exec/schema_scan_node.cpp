@@ -240,6 +240,7 @@ Status SchemaScanNode::get_next(RuntimeState* state, RowBatch* row_batch,
 
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     SCOPED_TIMER(materialize_tuple_timer());
 
     if (reached_limit()) {
@@ -18,8 +18,11 @@
 #ifndef DORIS_BE_SRC_QUERY_EXEC_SELECT_NODE_H
 #define DORIS_BE_SRC_QUERY_EXEC_SELECT_NODE_H
 
+#include <vector>
+
 #include <boost/scoped_ptr.hpp>
 
+#include "exec/conjunct_evaluator.h"
 #include "exec/exec_node.h"
 #include "runtime/mem_pool.h"
 
@@ -43,14 +46,23 @@ private:
     // current row batch of child
     boost::scoped_ptr<RowBatch> _child_row_batch;
 
-    // index of current row in _child_row_batch
+    // indexes of the rows of _child_row_batch that passed the conjuncts, the first
+    // _num_selected entries are valid
+    std::vector<int> _selection;
+    int _num_selected;
+
+    // index of current row in _selection
     int _child_row_idx;
 
     // true if last get_next() call on child signalled eos
     bool _child_eos;
 
-    // Copy rows from _child_row_batch for which _conjuncts evaluate to true to
-    // output_batch, up to _limit.
+    ConjunctEvaluator _conjunct_evaluator;
+
+    // Evaluates the conjuncts over the whole of _child_row_batch and fills _selection.
+    void select_rows();
+
+    // Copy the selected rows of _child_row_batch to output_batch, up to _limit.
     // Return true if limit was hit or output_batch should be returned, otherwise false.
     bool copy_rows(RowBatch* output_batch);
 };
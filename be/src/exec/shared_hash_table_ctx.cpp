@@ -0,0 +1,66 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "exec/shared_hash_table_ctx.h"
+
+#include "exec/hash_table.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+
+namespace doris {
+
+SharedHashTableCtx::SharedHashTableCtx(int64_t mem_limit, MemTracker* parent) :
+        _mem_tracker(new MemTracker(mem_limit, "SharedHashTable", parent)),
+        _build_pool(new MemPool(_mem_tracker.get())),
+        _built(false) {
+}
+
+SharedHashTableCtx::~SharedHashTableCtx() {
+    if (_hash_tbl.get() != NULL) {
+        _hash_tbl->close();
+    }
+    _build_pool->free_all();
+    _mem_tracker->unregister_from_parent();
+}
+
+void SharedHashTableCtx::set_hash_tbl(HashTable* hash_tbl) {
+    DCHECK(_hash_tbl.get() == NULL);
+    _hash_tbl.reset(hash_tbl);
+}
+
+void SharedHashTableCtx::set_build_status(const Status& status) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_built) {
+        return;
+    }
+    _built = true;
+    _build_status = status;
+    _built_cv.notify_all();
+}
+
+Status SharedHashTableCtx::wait_for_build(RuntimeState* state) {
+    std::unique_lock<std::mutex> l(_lock);
+    while (!_built) {
+        if (state->is_cancelled()) {
+            return Status::Cancelled("Cancelled");
+        }
+        _built_cv.wait_for(l, std::chrono::milliseconds(100));
+    }
+    return _build_status;
+}
+
+}
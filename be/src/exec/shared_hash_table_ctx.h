@@ -0,0 +1,80 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#ifndef DORIS_BE_SRC_EXEC_SHARED_HASH_TABLE_CTX_H
+#define DORIS_BE_SRC_EXEC_SHARED_HASH_TABLE_CTX_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <boost/scoped_ptr.hpp>
+
+#include "common/status.h"
+
+namespace doris {
+
+class HashTable;
+class MemPool;
+class MemTracker;
+class RuntimeState;
+
+// Build side of a broadcast hash join shared by the fragment instances of one query
+// on this backend, handed out by FragmentMgr::get_shared_hash_table(). The first
+// instance builds the hash table into it; the others wait for set_build_status()
+// and probe the table through HashTable::share_from().
+//
+// The build rows and the table outlive the instance that built them, so they are
+// tracked by this class's own MemTracker instead of that instance's.
+class SharedHashTableCtx {
+public:
+    SharedHashTableCtx(int64_t mem_limit, MemTracker* parent);
+    ~SharedHashTableCtx();
+
+    MemTracker* mem_tracker() { return _mem_tracker.get(); }
+
+    // Holds the tuple data of the build rows.
+    MemPool* build_pool() { return _build_pool.get(); }
+
+    // Only valid for the builder, or for the others once wait_for_build() returned OK.
+    HashTable* hash_tbl() { return _hash_tbl.get(); }
+
+    // Takes ownership of the table the builder inserts into. Its exprs are only used
+    // while building.
+    void set_hash_tbl(HashTable* hash_tbl);
+
+    // Called by the builder when the table is complete or the build failed. Only the
+    // first call has any effect.
+    void set_build_status(const Status& status);
+
+    // Blocks until the builder called set_build_status() and returns its status, or
+    // returns early if 'state' is cancelled.
+    Status wait_for_build(RuntimeState* state);
+
+private:
+    std::unique_ptr<MemTracker> _mem_tracker;
+    boost::scoped_ptr<MemPool> _build_pool;
+    boost::scoped_ptr<HashTable> _hash_tbl;
+
+    std::mutex _lock;
+    std::condition_variable _built_cv;
+    bool _built;
+    Status _build_status;
+};
+
+}
+
+#endif
@@ -71,6 +71,9 @@ Status OlapTableSchemaParam::init(const TOlapTableSchemaParam& tschema) {
     _db_id = tschema.db_id;
     _table_id = tschema.table_id;
     _version = tschema.version;
+    if (tschema.__isset.keys_type) {
+        _keys_type = tschema.keys_type;
+    }
     std::map<std::string, SlotDescriptor*> slots_map;
     _tuple_desc = _obj_pool.add(new TupleDescriptor(tschema.tuple_desc));
     for (auto& t_slot_desc : tschema.slot_descs) {
@@ -91,6 +94,10 @@ Status OlapTableSchemaParam::init(const TOlapTableSchemaParam& tschema) {
             }
             index->slots.emplace_back(it->second);
         }
+        if (t_index.__isset.aggregation_types
+                && t_index.aggregation_types.size() == index->slots.size()) {
+            index->aggregation_types = t_index.aggregation_types;
+        }
         _indexes.emplace_back(index);
     }
 
@@ -41,6 +41,8 @@ struct OlapTableIndexSchema {
     int64_t index_id;
     std::vector<SlotDescriptor*> slots;
     int32_t schema_hash;
+    // aggregation type of each of slots, NONE for keys. Empty if not known.
+    std::vector<TAggregationType::type> aggregation_types;
 
     void to_protobuf(POlapTableIndexSchema* pindex) const;
 };
@@ -56,6 +58,8 @@ public:
     int64_t db_id() const { return _db_id; }
     int64_t table_id() const { return _table_id; }
     int64_t version() const { return _version; }
+    // DUP_KEYS if not known
+    TKeysType::type keys_type() const { return _keys_type; }
 
     TupleDescriptor* tuple_desc() const { return _tuple_desc; }
     const std::vector<OlapTableIndexSchema*>& indexes() const {
@@ -79,6 +83,7 @@ private:
     int64_t _db_id;
     int64_t _table_id;
     int64_t _version;
+    TKeysType::type _keys_type = TKeysType::DUP_KEYS;
 
     TupleDescriptor* _tuple_desc = nullptr;
     mutable POlapTableSchemaParam* _proto_schema = nullptr;
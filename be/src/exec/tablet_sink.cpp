@@ -17,15 +17,23 @@
 
 #include "exec/tablet_sink.h"
 
+#include <algorithm>
 #include <sstream>
 
+#include <boost/bind.hpp>
+
 #include "exprs/expr.h"
+#include "runtime/decimal_value.h"
+#include "runtime/decimalv2_value.h"
 #include "runtime/exec_env.h"
+#include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/tuple_row.h"
 
+#include "util/block_compression.h"
 #include "util/brpc_stub_cache.h"
+#include "util/thread_pool.hpp"
 #include "util/uid_util.h"
 #include "service/brpc.h"
 
@@ -45,12 +53,12 @@ NodeChannel::~NodeChannel() {
         }
         _open_closure = nullptr;
     }
-    if (_add_batch_closure != nullptr) {
-        if (_add_batch_closure->unref()) {
-            delete _add_batch_closure;
+    for (auto closure : _add_batch_closures) {
+        if (closure->unref()) {
+            delete closure;
         }
-        _add_batch_closure = nullptr;
     }
+    _add_batch_closures.clear();
     _add_batch_request.release_id();
 }
 
@@ -62,8 +70,13 @@ Status NodeChannel::init(RuntimeState* state) {
         ss << "unknown node id, id=" << _node_id;
         return Status::InternalError(ss.str());
     }
+    _init_pre_aggregate();
+    int batch_size = state->batch_size();
+    if (!_key_slots.empty()) {
+        batch_size = std::max(batch_size, config::olap_table_sink_pre_aggregate_rows);
+    }
     RowDescriptor row_desc(_tuple_desc, false);
-    _batch.reset(new RowBatch(row_desc, state->batch_size(), _parent->_mem_tracker));
+    _batch.reset(new RowBatch(row_desc, batch_size, _parent->_mem_tracker));
 
     _stub = state->exec_env()->brpc_stub_cache()->get_stub(
         _node_info->host, _node_info->brpc_port);
@@ -79,6 +92,12 @@ Status NodeChannel::init(RuntimeState* state) {
     _add_batch_request.set_sender_id(_parent->_sender_id);
 
     _rpc_timeout_ms = config::tablet_writer_rpc_timeout_sec * 1000;
+    _max_in_flight_packets = std::max(config::tablet_writer_max_in_flight_packets, 1);
+    if (config::tablet_writer_add_batch_use_attachment) {
+        RETURN_IF_ERROR(get_block_compression_codec(segment_v2::LZ4, &_attachment_codec));
+    }
+    _send_pool = _parent->_send_batch_pool.get();
+    _max_pending_batches = std::max(config::olap_table_sink_max_pending_batches, 1);
     return Status::OK();
 }
 
@@ -92,6 +111,15 @@ void NodeChannel::open() {
         auto ptablet = request.add_tablets();
         ptablet->set_partition_id(tablet.partition_id);
         ptablet->set_tablet_id(tablet.tablet_id);
+        auto it = _tablet_followers.find(tablet.tablet_id);
+        if (it != std::end(_tablet_followers)) {
+            for (auto node_info : it->second) {
+                auto follower = ptablet->add_followers();
+                follower->set_node_id(node_info->id);
+                follower->set_host(node_info->host);
+                follower->set_brpc_port(node_info->brpc_port);
+            }
+        }
     }
     request.set_num_senders(_parent->_num_senders);
     request.set_need_gen_rollup(_parent->_need_gen_rollup);
@@ -124,10 +152,6 @@ Status NodeChannel::open_wait() {
     }
     _open_closure = nullptr;
 
-    // add batch closure
-    _add_batch_closure = new RefCountClosure<PTabletWriterAddBatchResult>();
-    _add_batch_closure->ref();
-
     return status;
 }
 
@@ -141,10 +165,209 @@ Status NodeChannel::add_row(Tuple* input_tuple, int64_t tablet_id) {
     auto tuple = input_tuple->deep_copy(*_tuple_desc, _batch->tuple_data_pool());
     _batch->get_row(row_no)->set_tuple(0, tuple);
     _batch->commit_last_row();
-    _add_batch_request.add_tablet_ids(tablet_id);
+    _tablet_ids.Add(tablet_id);
     return Status::OK();
 }
 
+void NodeChannel::_init_pre_aggregate() {
+    if (config::olap_table_sink_pre_aggregate_rows <= 0) {
+        return;
+    }
+    auto keys_type = _parent->_schema->keys_type();
+    if (keys_type != TKeysType::AGG_KEYS && keys_type != TKeysType::UNIQUE_KEYS) {
+        return;
+    }
+    const OlapTableIndexSchema* index = nullptr;
+    for (auto it : _parent->_schema->indexes()) {
+        if (it->index_id == _index_id) {
+            index = it;
+            break;
+        }
+    }
+    if (index == nullptr || index->aggregation_types.empty()) {
+        return;
+    }
+    std::vector<SlotDescriptor*> key_slots;
+    for (int i = 0; i < index->slots.size(); ++i) {
+        SlotDescriptor* slot = index->slots[i];
+        auto agg_type = index->aggregation_types[i];
+        switch (agg_type) {
+        case TAggregationType::NONE:
+            key_slots.push_back(slot);
+            continue;
+        case TAggregationType::SUM:
+            switch (slot->type().type) {
+            case TYPE_TINYINT:
+            case TYPE_SMALLINT:
+            case TYPE_INT:
+            case TYPE_BIGINT:
+            case TYPE_LARGEINT:
+            case TYPE_FLOAT:
+            case TYPE_DOUBLE:
+            case TYPE_DECIMAL:
+            case TYPE_DECIMALV2:
+                break;
+            default:
+                return;
+            }
+            break;
+        case TAggregationType::MIN:
+        case TAggregationType::MAX:
+        case TAggregationType::REPLACE:
+        case TAggregationType::REPLACE_IF_NOT_NULL:
+            break;
+        default:
+            // hll and bitmap values are only merged by the receivers
+            _value_slots.clear();
+            _value_agg_types.clear();
+            return;
+        }
+        _value_slots.push_back(slot);
+        _value_agg_types.push_back(agg_type);
+    }
+    _key_slots.swap(key_slots);
+}
+
+int NodeChannel::_compare_keys(const Tuple* lhs, const Tuple* rhs) const {
+    for (auto slot : _key_slots) {
+        bool lhs_null = lhs->is_null(slot->null_indicator_offset());
+        bool rhs_null = rhs->is_null(slot->null_indicator_offset());
+        if (lhs_null || rhs_null) {
+            if (lhs_null != rhs_null) {
+                return lhs_null ? -1 : 1;
+            }
+            continue;
+        }
+        int res = RawValue::compare(lhs->get_slot(slot->tuple_offset()),
+                                    rhs->get_slot(slot->tuple_offset()), slot->type());
+        if (res != 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+// same as aggregation of storage: SUM, MIN and MAX ignore nulls, and
+// REPLACE keeps the last value
+void NodeChannel::_aggregate_tuple(Tuple* dst, const Tuple* src) const {
+    for (int i = 0; i < _value_slots.size(); ++i) {
+        const SlotDescriptor* slot = _value_slots[i];
+        const NullIndicatorOffset& null_offset = slot->null_indicator_offset();
+        void* dst_value = dst->get_slot(slot->tuple_offset());
+        const void* src_value = src->get_slot(slot->tuple_offset());
+        if (src->is_null(null_offset)) {
+            if (_value_agg_types[i] == TAggregationType::REPLACE) {
+                dst->set_null(null_offset);
+            }
+            continue;
+        }
+        if (!dst->is_null(null_offset)) {
+            switch (_value_agg_types[i]) {
+            case TAggregationType::MIN:
+                if (RawValue::compare(src_value, dst_value, slot->type()) >= 0) {
+                    continue;
+                }
+                break;
+            case TAggregationType::MAX:
+                if (RawValue::compare(src_value, dst_value, slot->type()) <= 0) {
+                    continue;
+                }
+                break;
+            case TAggregationType::SUM:
+                switch (slot->type().type) {
+                case TYPE_TINYINT:
+                    *reinterpret_cast<int8_t*>(dst_value) += *reinterpret_cast<const int8_t*>(src_value);
+                    break;
+                case TYPE_SMALLINT:
+                    *reinterpret_cast<int16_t*>(dst_value) += *reinterpret_cast<const int16_t*>(src_value);
+                    break;
+                case TYPE_INT:
+                    *reinterpret_cast<int32_t*>(dst_value) += *reinterpret_cast<const int32_t*>(src_value);
+                    break;
+                case TYPE_BIGINT:
+                    *reinterpret_cast<int64_t*>(dst_value) += *reinterpret_cast<const int64_t*>(src_value);
+                    break;
+                case TYPE_LARGEINT: {
+                    __int128 dst_int, src_int;
+                    memcpy(&dst_int, dst_value, sizeof(dst_int));
+                    memcpy(&src_int, src_value, sizeof(src_int));
+                    dst_int += src_int;
+                    memcpy(dst_value, &dst_int, sizeof(dst_int));
+                    break;
+                }
+                case TYPE_FLOAT:
+                    *reinterpret_cast<float*>(dst_value) += *reinterpret_cast<const float*>(src_value);
+                    break;
+                case TYPE_DOUBLE:
+                    *reinterpret_cast<double*>(dst_value) += *reinterpret_cast<const double*>(src_value);
+                    break;
+                case TYPE_DECIMAL:
+                    *reinterpret_cast<DecimalValue*>(dst_value) +=
+                        *reinterpret_cast<const DecimalValue*>(src_value);
+                    break;
+                case TYPE_DECIMALV2: {
+                    DecimalV2Value dst_decimal, src_decimal;
+                    memcpy(&dst_decimal, dst_value, sizeof(dst_decimal));
+                    memcpy(&src_decimal, src_value, sizeof(src_decimal));
+                    dst_decimal += src_decimal;
+                    memcpy(dst_value, &dst_decimal, sizeof(dst_decimal));
+                    break;
+                }
+                default:
+                    DCHECK(false) << "unsupported sum type " << slot->type().debug_string();
+                    break;
+                }
+                continue;
+            default:
+                break;
+            }
+        }
+        // values are in the tuple pool of the same batch, so strings are not copied
+        dst->set_not_null(null_offset);
+        RawValue::write(src_value, dst_value, slot->type(), nullptr);
+    }
+}
+
+void NodeChannel::_pre_aggregate_batch(RowBatch* batch,
+                                       google::protobuf::RepeatedField<int64_t>* tablet_ids) {
+    int num_rows = batch->num_rows();
+    if (num_rows <= 1) {
+        return;
+    }
+    DCHECK_EQ(num_rows, tablet_ids->size());
+    std::vector<Tuple*> tuples(num_rows);
+    std::vector<int> order(num_rows);
+    for (int i = 0; i < num_rows; ++i) {
+        tuples[i] = batch->get_row(i)->get_tuple(0);
+        order[i] = i;
+    }
+    // rows of the same keys keep the order they come, so that REPLACE keeps the last value
+    const int64_t* ids = tablet_ids->data();
+    std::stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+        if (ids[lhs] != ids[rhs]) {
+            return ids[lhs] < ids[rhs];
+        }
+        return _compare_keys(tuples[lhs], tuples[rhs]) < 0;
+    });
+
+    google::protobuf::RepeatedField<int64_t> sorted_ids;
+    sorted_ids.Reserve(num_rows);
+    int num_sorted_rows = 0;
+    for (int idx : order) {
+        if (num_sorted_rows > 0 && sorted_ids.Get(num_sorted_rows - 1) == ids[idx]) {
+            Tuple* last = batch->get_row(num_sorted_rows - 1)->get_tuple(0);
+            if (_compare_keys(last, tuples[idx]) == 0) {
+                _aggregate_tuple(last, tuples[idx]);
+                continue;
+            }
+        }
+        batch->get_row(num_sorted_rows++)->set_tuple(0, tuples[idx]);
+        sorted_ids.Add(ids[idx]);
+    }
+    batch->set_num_rows(num_sorted_rows);
+    tablet_ids->Swap(&sorted_ids);
+}
+
 Status NodeChannel::close(RuntimeState* state) {
     auto st = _close(state);
     _batch.reset();
@@ -152,20 +375,22 @@ Status NodeChannel::close(RuntimeState* state) {
 }
 
 Status NodeChannel::_close(RuntimeState* state) {
-    RETURN_IF_ERROR(_wait_in_flight_packet());
     return _send_cur_batch(true);
 }
 
 Status NodeChannel::close_wait(RuntimeState* state) {
-    RETURN_IF_ERROR(_wait_in_flight_packet());
-    Status status(_add_batch_closure->result.status());
+    Status status;
+    if (_send_pool != nullptr) {
+        status = _wait_pending_batches();
+    }
     if (status.ok()) {
-        for (auto& tablet : _add_batch_closure->result.tablet_vec()) {
-            TTabletCommitInfo commit_info;
-            commit_info.tabletId = tablet.tablet_id();
-            commit_info.backendId = _node_id;
+        status = _wait_in_flight_packets(0);
+    }
+    if (status.ok()) {
+        for (auto& commit_info : _tablet_commit_infos) {
             state->tablet_commit_infos().emplace_back(std::move(commit_info));
         }
+        _tablet_commit_infos.clear();
     }
     // clear batch after sendt
     _batch.reset();
@@ -173,6 +398,15 @@ Status NodeChannel::close_wait(RuntimeState* state) {
 }
 
 void NodeChannel::cancel() {
+    if (_send_pool != nullptr) {
+        // stop sending pending batches, and wait the running send task
+        std::unique_lock<std::mutex> l(_pending_lock);
+        _cancelled = true;
+        while (_send_task_running) {
+            _pending_cond.wait(l);
+        }
+        _pending_batches.clear();
+    }
     // Do we need to wait last rpc finished???
     PTabletWriterCancelRequest request;
     request.set_allocated_id(&_parent->_load_id);
@@ -193,43 +427,182 @@ void NodeChannel::cancel() {
     _batch.reset();
 }
 
-Status NodeChannel::_wait_in_flight_packet() {
-    if (!_has_in_flight_packet) {
+Status NodeChannel::_wait_in_flight_packets(int max_in_flight) {
+    if (static_cast<int>(_add_batch_closures.size()) <= max_in_flight) {
         return Status::OK();
     }
 
-    SCOPED_RAW_TIMER(_parent->mutable_wait_in_flight_packet_ns()); 
-    _add_batch_closure->join();
-    _has_in_flight_packet = false;
-    if (_add_batch_closure->cntl.Failed()) {
+    Status status;
+    int64_t wait_ns = 0;
+    {
+        SCOPED_RAW_TIMER(&wait_ns);
+        while (status.ok() && static_cast<int>(_add_batch_closures.size()) > max_in_flight) {
+            // receiver adds packets in order, so wait the oldest one first
+            auto closure = _add_batch_closures.front();
+            _add_batch_closures.pop_front();
+            closure->join();
+            status = _handle_add_batch_result(closure);
+            if (closure->unref()) {
+                delete closure;
+            }
+        }
+    }
+    _parent->update_send_batch_counter(wait_ns, 0);
+    return status;
+}
+
+Status NodeChannel::_handle_add_batch_result(RefCountClosure<PTabletWriterAddBatchResult>* closure) {
+    if (closure->cntl.Failed()) {
         LOG(WARNING) << "failed to send batch, error="
-            << berror(_add_batch_closure->cntl.ErrorCode())
-            << ", error_text=" << _add_batch_closure->cntl.ErrorText();
+            << berror(closure->cntl.ErrorCode())
+            << ", error_text=" << closure->cntl.ErrorText();
         return Status::InternalError("failed to send batch");
     }
 
-    if (_add_batch_closure->result.has_execution_time_us()) {
+    if (closure->result.has_execution_time_us()) {
         _parent->update_node_add_batch_counter(_node_id,
-                _add_batch_closure->result.execution_time_us(),
-                _add_batch_closure->result.wait_lock_time_us());
+                closure->result.execution_time_us(),
+                closure->result.wait_lock_time_us());
     }
-    return {_add_batch_closure->result.status()};
+    Status status(closure->result.status());
+    if (status.ok()) {
+        for (auto& tablet : closure->result.tablet_vec()) {
+            TTabletCommitInfo commit_info;
+            commit_info.tabletId = tablet.tablet_id();
+            commit_info.backendId = _node_id;
+            _tablet_commit_infos.emplace_back(std::move(commit_info));
+            // followers have committed the same rowset in single replica load
+            for (auto node_id : tablet.follower_node_ids()) {
+                TTabletCommitInfo follower_commit_info;
+                follower_commit_info.tabletId = tablet.tablet_id();
+                follower_commit_info.backendId = node_id;
+                _tablet_commit_infos.emplace_back(std::move(follower_commit_info));
+            }
+        }
+    }
+    return status;
 }
 
 Status NodeChannel::_send_cur_batch(bool eos) {
-    RETURN_IF_ERROR(_wait_in_flight_packet());
+    if (_send_pool == nullptr) {
+        auto st = _send_batch(_batch.get(), &_tablet_ids, eos);
+        _batch->reset();
+        _tablet_ids.Clear();
+        return st;
+    }
 
-    // tablet_ids has already set when add row
+    bool need_schedule = false;
+    {
+        std::unique_lock<std::mutex> l(_pending_lock);
+        while (_send_status.ok()
+               && static_cast<int>(_pending_batches.size()) >= _max_pending_batches) {
+            _pending_cond.wait(l);
+        }
+        RETURN_IF_ERROR(_send_status);
+        _pending_batches.emplace_back();
+        auto& pending = _pending_batches.back();
+        if (!eos) {
+            pending.batch.reset(new RowBatch(_batch->row_desc(), _batch->capacity(),
+                                             _parent->_mem_tracker));
+        }
+        pending.batch.swap(_batch);
+        pending.tablet_ids.Swap(&_tablet_ids);
+        pending.eos = eos;
+        if (!_send_task_running) {
+            _send_task_running = true;
+            need_schedule = true;
+        }
+    }
+    if (need_schedule
+            && !_send_pool->offer(boost::bind<void>(&NodeChannel::_send_pending_batches, this))) {
+        std::lock_guard<std::mutex> l(_pending_lock);
+        _pending_batches.clear();
+        _send_task_running = false;
+        _send_status = Status::InternalError("failed to submit send batch task");
+        _pending_cond.notify_all();
+        return _send_status;
+    }
+    return Status::OK();
+}
+
+void NodeChannel::_send_pending_batches() {
+    while (true) {
+        PendingBatch pending;
+        {
+            std::lock_guard<std::mutex> l(_pending_lock);
+            if (_cancelled || !_send_status.ok()) {
+                _pending_batches.clear();
+            }
+            if (_pending_batches.empty()) {
+                _send_task_running = false;
+                _pending_cond.notify_all();
+                return;
+            }
+            auto& front = _pending_batches.front();
+            pending.batch = std::move(front.batch);
+            pending.tablet_ids.Swap(&front.tablet_ids);
+            pending.eos = front.eos;
+            _pending_batches.pop_front();
+            _pending_cond.notify_all();
+        }
+        auto st = _send_batch(pending.batch.get(), &pending.tablet_ids, pending.eos);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to send pending batch, load_id=" << print_id(_parent->_load_id)
+                << ", node=" << _node_info->host << ":" << _node_info->brpc_port
+                << ", errmsg=" << st.get_error_msg();
+            std::lock_guard<std::mutex> l(_pending_lock);
+            _send_status = st;
+        }
+    }
+}
+
+Status NodeChannel::_wait_pending_batches() {
+    std::unique_lock<std::mutex> l(_pending_lock);
+    while (_send_task_running) {
+        _pending_cond.wait(l);
+    }
+    return _send_status;
+}
+
+Status NodeChannel::_send_batch(RowBatch* batch,
+                                google::protobuf::RepeatedField<int64_t>* tablet_ids,
+                                bool eos) {
+    if (!_key_slots.empty()) {
+        _pre_aggregate_batch(batch, tablet_ids);
+    }
+    // eos packet is sent after all packets finish
+    RETURN_IF_ERROR(_wait_in_flight_packets(eos ? 0 : _max_in_flight_packets - 1));
+
+    _add_batch_request.mutable_tablet_ids()->Swap(tablet_ids);
     _add_batch_request.set_eos(eos);
     _add_batch_request.set_packet_seq(_next_packet_seq);
-    if (_batch->num_rows() > 0) {
-        SCOPED_RAW_TIMER(_parent->mutable_serialize_batch_ns()); 
-        _batch->serialize(_add_batch_request.mutable_row_batch());
-    }
 
-    _add_batch_closure->ref();
-    _add_batch_closure->cntl.Reset();
-    _add_batch_closure->cntl.set_timeout_ms(_rpc_timeout_ms);
+    auto closure = new RefCountClosure<PTabletWriterAddBatchResult>();
+    closure->cntl.set_timeout_ms(_rpc_timeout_ms);
+
+    if (batch->num_rows() > 0) {
+        int64_t serialize_ns = 0;
+        Status st;
+        {
+            SCOPED_RAW_TIMER(&serialize_ns);
+            if (_attachment_codec != nullptr) {
+                st = _serialize_batch_to_attachment(batch, &closure->cntl);
+            } else {
+                batch->serialize(_add_batch_request.mutable_row_batch());
+            }
+        }
+        _parent->update_send_batch_counter(0, serialize_ns);
+        if (!st.ok()) {
+            _add_batch_request.clear_tablet_ids();
+            _add_batch_request.clear_row_batch();
+            delete closure;
+            return st;
+        }
+    }
+    // one ref is released by rpc, the other by this channel
+    closure->ref();
+    closure->ref();
+    _add_batch_closures.push_back(closure);
 
     if (eos) {
         for (auto pid : _parent->_partition_ids) {
@@ -237,18 +610,17 @@ Status NodeChannel::_send_cur_batch(bool eos) {
         }
     }
 
-    _stub->tablet_writer_add_batch(&_add_batch_closure->cntl,
+    _stub->tablet_writer_add_batch(&closure->cntl,
                                    &_add_batch_request,
-                                   &_add_batch_closure->result,
-                                   _add_batch_closure);
+                                   &closure->result,
+                                   closure);
     _add_batch_request.clear_tablet_ids();
     _add_batch_request.clear_row_batch();
     _add_batch_request.clear_partition_ids();
+    _add_batch_request.clear_attachment_compression_type();
+    _add_batch_request.clear_attachment_uncompressed_size();
 
-    _has_in_flight_packet = true;
     _next_packet_seq++;
-
-    _batch->reset();
     return Status::OK();
 }
 
@@ -266,16 +638,30 @@ Status IndexChannel::init(RuntimeState* state,
             return Status::InternalError("unknown tablet");
         }
         std::vector<NodeChannel*> channels;
-        for (auto& node_id : location->node_ids) {
-            NodeChannel* channel = nullptr;
-            auto it = _node_channels.find(node_id);
-            if (it == std::end(_node_channels)) {
-                channel = _parent->_pool->add(
-                    new NodeChannel(_parent, _index_id, node_id, _schema_hash));
-                _node_channels.emplace(node_id, channel);
-            } else {
-                channel = it->second;
+        if (_parent->_single_replica_load && location->node_ids.size() > 1) {
+            // rows are only sent to one replica, others are followers. replica
+            // is chosen by tablet id to spread the work among nodes
+            int leader = tablet.tablet_id % location->node_ids.size();
+            std::vector<const NodeInfo*> followers;
+            for (int i = 0; i < location->node_ids.size(); ++i) {
+                if (i == leader) {
+                    continue;
+                }
+                auto node_info = _parent->_nodes_info->find_node(location->node_ids[i]);
+                if (node_info == nullptr) {
+                    LOG(WARNING) << "unknown node id, id=" << location->node_ids[i];
+                    return Status::InternalError("unknown node id");
+                }
+                followers.push_back(node_info);
             }
+            auto channel = _get_or_create_channel(location->node_ids[leader]);
+            channel->add_tablet(tablet, followers);
+            channels.push_back(channel);
+            _channels_by_tablet.emplace(tablet.tablet_id, std::move(channels));
+            continue;
+        }
+        for (auto& node_id : location->node_ids) {
+            auto channel = _get_or_create_channel(node_id);
             channel->add_tablet(tablet);
             channels.push_back(channel);
         }
@@ -308,6 +694,25 @@ Status IndexChannel::open() {
     return Status::OK();
 }
 
+Status NodeChannel::_serialize_batch_to_attachment(RowBatch* batch, brpc::Controller* cntl) {
+    batch->serialize(_add_batch_request.mutable_row_batch(), &_tuple_data_buf);
+    Slice input(_tuple_data_buf);
+    size_t max_len = _attachment_codec->max_compressed_len(input.size);
+    // buffer is owned by attachment after appended, so that it is not copied
+    char* buf = reinterpret_cast<char*>(malloc(max_len));
+    Slice output(buf, max_len);
+    auto st = _attachment_codec->compress(input, &output);
+    if (!st.ok()) {
+        free(buf);
+        LOG(WARNING) << "fail to compress tuple data, msg=" << st.get_error_msg();
+        return st;
+    }
+    cntl->request_attachment().append_user_data(buf, output.size, free);
+    _add_batch_request.set_attachment_compression_type(segment_v2::LZ4);
+    _add_batch_request.set_attachment_uncompressed_size(input.size);
+    return Status::OK();
+}
+
 Status IndexChannel::add_row(Tuple* tuple, int64_t tablet_id) {
     auto it = _channels_by_tablet.find(tablet_id);
     DCHECK(it != std::end(_channels_by_tablet)) << "unknown tablet, tablet_id=" << tablet_id;
@@ -381,10 +786,25 @@ void IndexChannel::cancel() {
     }
 }
 
+NodeChannel* IndexChannel::_get_or_create_channel(int64_t node_id) {
+    auto it = _node_channels.find(node_id);
+    if (it != std::end(_node_channels)) {
+        return it->second;
+    }
+    auto channel = _parent->_pool->add(
+        new NodeChannel(_parent, _index_id, node_id, _schema_hash));
+    _node_channels.emplace(node_id, channel);
+    return channel;
+}
+
 bool IndexChannel::_handle_failed_node(NodeChannel* channel) {
     DCHECK(!channel->already_failed());
     channel->set_failed();
     _num_failed_channels++;
+    if (_parent->_single_replica_load) {
+        // tablets of failed node have no other replica to receive rows
+        return true;
+    }
     return _num_failed_channels >= ((_parent->_num_repicas + 1) / 2);
 }
 
@@ -411,6 +831,7 @@ Status OlapTableSink::init(const TDataSink& t_sink) {
     _table_id = table_sink.table_id;
     _num_repicas = table_sink.num_replicas;
     _need_gen_rollup = table_sink.need_gen_rollup;
+    _single_replica_load = config::enable_single_replica_load;
     _db_name = table_sink.db_name;
     _table_name = table_sink.table_name;
     _tuple_desc_id = table_sink.tuple_id;
@@ -511,6 +932,11 @@ Status OlapTableSink::prepare(RuntimeState* state) {
     _wait_in_flight_packet_timer = ADD_TIMER(_profile, "WaitInFlightPacketTime");
     _serialize_batch_timer = ADD_TIMER(_profile, "SerializeBatchTime");
 
+    if (config::olap_table_sink_send_thread_num > 0) {
+        _send_batch_pool.reset(new ThreadPool(config::olap_table_sink_send_thread_num,
+                                              config::olap_table_sink_send_thread_num * 4));
+    }
+
     // open all channels
     auto& partitions = _partition->get_partitions();
     for (int i = 0; i < _schema->indexes().size(); ++i) {
@@ -636,6 +1062,8 @@ Status OlapTableSink::close(RuntimeState* state, Status close_status) {
             channel->cancel();
         }
     }
+    // all send tasks have finished after channels are closed or cancelled
+    _send_batch_pool.reset();
     Expr::close(_output_expr_ctxs, state);
     _output_batch.reset();
     return status;
@@ -17,7 +17,10 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -38,9 +41,11 @@
 namespace doris {
 
 class Bitmap;
+class BlockCompressionCodec;
 class MemTracker;
 class RuntimeProfile;
 class RowDescriptor;
+class ThreadPool;
 class Tuple;
 class TupleDescriptor;
 class ExprContext;
@@ -59,6 +64,13 @@ public:
     void add_tablet(const TTabletWithPartition& tablet) {
         _all_tablets.emplace_back(tablet);
     }
+    // in single replica load, rows of tablet are only sent to this node, which
+    // sends the built rowset to followers
+    void add_tablet(const TTabletWithPartition& tablet,
+                    const std::vector<const NodeInfo*>& followers) {
+        _all_tablets.emplace_back(tablet);
+        _tablet_followers.emplace(tablet.tablet_id, followers);
+    }
 
     Status init(RuntimeState* state);
 
@@ -80,9 +92,37 @@ public:
     const NodeInfo* node_info() const { return _node_info; }
 
 private:
+    // batch which is full or the last one, waiting to be sent by send pool
+    struct PendingBatch {
+        std::unique_ptr<RowBatch> batch;
+        google::protobuf::RepeatedField<int64_t> tablet_ids;
+        bool eos;
+    };
+
+    // send _batch directly, or hand it over to send pool if there is one
     Status _send_cur_batch(bool eos = false);
-    // wait inflight packet finish, return error if inflight packet return failed
-    Status _wait_in_flight_packet();
+    Status _send_batch(RowBatch* batch, google::protobuf::RepeatedField<int64_t>* tablet_ids,
+                       bool eos);
+    // run in send pool, send pending batches until there is no more one
+    void _send_pending_batches();
+    // wait until all pending batches are sent, return the first error of sending
+    Status _wait_pending_batches();
+    // serialize batch and put its tuple data in attachment of cntl
+    Status _serialize_batch_to_attachment(RowBatch* batch, brpc::Controller* cntl);
+    // wait inflight packets finish until there are no more than max_in_flight
+    // packets in flight, return error if inflight packet return failed
+    Status _wait_in_flight_packets(int max_in_flight);
+    // check result of a finished packet, and record tablets committed by it
+    Status _handle_add_batch_result(RefCountClosure<PTabletWriterAddBatchResult>* closure);
+    // set up _key_slots, _value_slots and _value_agg_types if rows of the index of this
+    // channel can be pre-aggregated, see olap_table_sink_pre_aggregate_rows
+    void _init_pre_aggregate();
+    // sort rows of batch by tablet and keys, and aggregate rows of the same tablet and
+    // keys into the first of them
+    void _pre_aggregate_batch(RowBatch* batch,
+                              google::protobuf::RepeatedField<int64_t>* tablet_ids);
+    int _compare_keys(const Tuple* lhs, const Tuple* rhs) const;
+    void _aggregate_tuple(Tuple* dst, const Tuple* src) const;
 
     Status _close(RuntimeState* state);
 
@@ -96,18 +136,48 @@ private:
     const NodeInfo* _node_info = nullptr;
 
     bool _already_failed = false;
-    bool _has_in_flight_packet = false;
     // this should be set in init() using config
     int _rpc_timeout_ms = 60000;
+    int _max_in_flight_packets = 1;
     int64_t _next_packet_seq = 0;
 
     std::unique_ptr<RowBatch> _batch;
+    // tablet ids of rows in _batch
+    google::protobuf::RepeatedField<int64_t> _tablet_ids;
     palo::PInternalService_Stub* _stub = nullptr;
     RefCountClosure<PTabletWriterOpenResult>* _open_closure = nullptr;
-    RefCountClosure<PTabletWriterAddBatchResult>* _add_batch_closure = nullptr;
+    // closures of add batch packets in flight, in order of packet seq
+    std::deque<RefCountClosure<PTabletWriterAddBatchResult>*> _add_batch_closures;
+    // tablets committed by finished packets
+    std::vector<TTabletCommitInfo> _tablet_commit_infos;
 
     std::vector<TTabletWithPartition> _all_tablets;
+    // tablet_id -> followers of tablet in single replica load
+    std::unordered_map<int64_t, std::vector<const NodeInfo*>> _tablet_followers;
     PTabletWriterAddBatchRequest _add_batch_request;
+
+    // codec to compress tuple data in attachment, null if attachment is not used
+    BlockCompressionCodec* _attachment_codec = nullptr;
+    // buffer of uncompressed tuple data, reused by batches
+    std::string _tuple_data_buf;
+
+    // slots of the index of this channel, only set if rows are pre-aggregated
+    std::vector<SlotDescriptor*> _key_slots;
+    std::vector<SlotDescriptor*> _value_slots;
+    std::vector<TAggregationType::type> _value_agg_types;
+
+    // batches are sent in this pool if it is not null, owned by parent.
+    // at most one task of this channel is running in it, so that batches
+    // are sent in order and the states above are accessed by one thread.
+    ThreadPool* _send_pool = nullptr;
+    int _max_pending_batches = 1;
+    // protect members below
+    std::mutex _pending_lock;
+    std::condition_variable _pending_cond;
+    std::deque<PendingBatch> _pending_batches;
+    bool _send_task_running = false;
+    bool _cancelled = false;
+    Status _send_status;
 };
 
 class IndexChannel {
@@ -128,6 +198,7 @@ public:
     void cancel();
 
 private:
+    NodeChannel* _get_or_create_channel(int64_t node_id);
     // return true if this load can't success.
     bool _handle_failed_node(NodeChannel* channel);
 
@@ -179,11 +250,14 @@ public:
         return _profile;
     }
 
-    // these 2 counters does not thread-safe. make sure only one thread
-    // at a time can modify them.
-    int64_t* mutable_wait_in_flight_packet_ns() { return &_wait_in_flight_packet_ns; }
-    int64_t* mutable_serialize_batch_ns() { return &_serialize_batch_ns; }
+    // counters are updated by node channels, which may run in different send threads
+    void update_send_batch_counter(int64_t wait_in_flight_packet_ns, int64_t serialize_batch_ns) {
+        std::lock_guard<std::mutex> l(_counter_lock);
+        _wait_in_flight_packet_ns += wait_in_flight_packet_ns;
+        _serialize_batch_ns += serialize_batch_ns;
+    }
     void update_node_add_batch_counter(int64_t be_id, int64_t add_batch_time_ns, int64_t wait_lock_time_ns) {
+        std::lock_guard<std::mutex> l(_counter_lock);
         auto search = _node_add_batch_counter_map.find(be_id);
         if (search == _node_add_batch_counter_map.end()) {
             AddBatchCounter new_counter;
@@ -220,6 +294,7 @@ private:
     int64_t _table_id = -1;
     int _num_repicas = -1;
     bool _need_gen_rollup = true;
+    bool _single_replica_load = false;
     std::string _db_name;
     std::string _table_name;
     int _tuple_desc_id = -1;
@@ -254,6 +329,10 @@ private:
     // index_channel
     std::vector<IndexChannel*> _channels;
 
+    // threads to send batches of node channels, null if batches are sent
+    // in the thread executing this sink
+    std::unique_ptr<ThreadPool> _send_batch_pool;
+
     std::vector<DecimalValue> _max_decimal_val;
     std::vector<DecimalValue> _min_decimal_val;
 
@@ -281,6 +360,8 @@ private:
     RuntimeProfile::Counter* _wait_in_flight_packet_timer = nullptr;
     RuntimeProfile::Counter* _serialize_batch_timer = nullptr;
 
+    // protect counters updated by node channels
+    std::mutex _counter_lock;
     // BE id -> add_batch method counter
     std::unordered_map<int64_t, AddBatchCounter> _node_add_batch_counter_map;
 };
@@ -20,6 +20,7 @@
 #include <sstream>
 
 #include "exprs/expr.h"
+#include "exprs/slot_ref.h"
 #include "gen_cpp/Exprs_types.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/descriptors.h"
@@ -41,6 +42,9 @@ TopNNode::TopNNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl
         _materialized_tuple_desc(NULL),
         _tuple_row_less_than(NULL),
         _tuple_pool(NULL),
+        _threshold_expr_ctx(NULL),
+        _threshold_slot_desc(NULL),
+        _rows_skipped_by_threshold_counter(NULL),
         _num_rows_skipped(0),
         _priority_queue(NULL) {
 }
@@ -80,9 +84,38 @@ Status TopNNode::prepare(RuntimeState* state) {
     _abort_on_default_limit_exceeded = _abort_on_default_limit_exceeded &&
                                        state->abort_on_default_limit_exceeded();
     _materialized_tuple_desc = _row_descriptor.tuple_descriptors()[0];
+    init_threshold_filter();
+    _rows_skipped_by_threshold_counter =
+        ADD_COUNTER(runtime_profile(), "RowsSkippedByThreshold", TUnit::UNIT);
     return Status::OK();
 }
 
+void TopNNode::init_threshold_filter() {
+    const std::vector<ExprContext*>& slot_expr_ctxs =
+        _sort_exec_exprs.sort_tuple_slot_expr_ctxs();
+    if (slot_expr_ctxs.empty()) {
+        return;
+    }
+    Expr* first_ordering_expr = _sort_exec_exprs.lhs_ordering_expr_ctxs()[0]->root();
+    if (!first_ordering_expr->is_slotref()) {
+        return;
+    }
+    SlotId slot_id = static_cast<SlotRef*>(first_ordering_expr)->slot_id();
+    int mat_expr_index = 0;
+    for (SlotDescriptor* slot_desc : _materialized_tuple_desc->slots()) {
+        if (!slot_desc->is_materialized()) {
+            continue;
+        }
+        if (slot_desc->id() == slot_id) {
+            DCHECK_LT(mat_expr_index, slot_expr_ctxs.size());
+            _threshold_expr_ctx = slot_expr_ctxs[mat_expr_index];
+            _threshold_slot_desc = slot_desc;
+            return;
+        }
+        ++mat_expr_index;
+    }
+}
+
 Status TopNNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
     RETURN_IF_ERROR(ExecNode::open(state));
@@ -140,6 +173,7 @@ Status TopNNode::open(RuntimeState* state) {
 
 Status TopNNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     // RETURN_IF_ERROR(QueryMaintenance(state));
@@ -204,6 +238,11 @@ void TopNNode::insert_tuple_row(TupleRow* input_row) {
     } else {
         DCHECK(!_priority_queue->empty());
         Tuple* top_tuple = _priority_queue->top();
+        if (_threshold_expr_ctx != NULL && compare_with_threshold(
+                _threshold_expr_ctx->get_value(input_row), top_tuple) > 0) {
+            COUNTER_UPDATE(_rows_skipped_by_threshold_counter, 1);
+            return;
+        }
         _tmp_tuple->materialize_exprs<false>(input_row, *_materialized_tuple_desc,
                 _sort_exec_exprs.sort_tuple_slot_expr_ctxs(), NULL, NULL, NULL);
 
@@ -221,6 +260,23 @@ void TopNNode::insert_tuple_row(TupleRow* input_row) {
     }
 }
 
+int TopNNode::compare_with_threshold(void* value, Tuple* threshold) const {
+    void* threshold_value = threshold->is_null(_threshold_slot_desc->null_indicator_offset())
+        ? NULL : threshold->get_slot(_threshold_slot_desc->tuple_offset());
+    // The sort order of NULLs is independent of asc/desc.
+    if (value == NULL && threshold_value == NULL) {
+        return 0;
+    }
+    if (value == NULL) {
+        return _nulls_first[0] ? -1 : 1;
+    }
+    if (threshold_value == NULL) {
+        return _nulls_first[0] ? 1 : -1;
+    }
+    int result = RawValue::compare(value, threshold_value, _threshold_slot_desc->type());
+    return _is_asc_order[0] ? result : -result;
+}
+
 // Reverse the order of the tuples in the priority queue
 void TopNNode::prepare_for_output() {
     _sorted_top_n.resize(_priority_queue->size());
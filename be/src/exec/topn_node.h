@@ -62,6 +62,14 @@ private:
     // Flatten and reverse the priority queue.
     void prepare_for_output();
 
+    // Finds the input expr and the sort tuple slot of the first ordering expr, which
+    // are used to skip input rows that can't beat the current N-th row.
+    void init_threshold_filter();
+
+    // Compares the first ordering value of an input row, 'value', with the one of
+    // 'threshold' like _tuple_row_less_than would.
+    int compare_with_threshold(void* value, Tuple* threshold) const;
+
     // number rows to skipped
     int64_t _offset;
 
@@ -92,6 +100,15 @@ private:
     std::vector<Tuple*>::iterator _get_next_iter;
     // std::vector<TupleRow*>::iterator _get_next_iter;
 
+    // Evaluates the first ordering expr over input rows and the slot it is
+    // materialized into. Once the priority queue is full its top is the current N-th
+    // row, and input rows which sort after it on this key alone are dropped without
+    // being materialized. NULL if the first ordering expr is not a materialized slot.
+    ExprContext* _threshold_expr_ctx;
+    SlotDescriptor* _threshold_slot_desc;
+
+    RuntimeProfile::Counter* _rows_skipped_by_threshold_counter;
+
     // True if the _limit comes from DEFAULT_ORDER_BY_LIMIT and the query option
     // ABORT_ON_DEFAULT_LIMIT_EXCEEDED is set.
     bool _abort_on_default_limit_exceeded;
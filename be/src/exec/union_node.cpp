@@ -20,6 +20,7 @@
 #include "codegen/llvm_codegen.h"
 #include "exprs/expr.h"
 #include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/tuple.h"
@@ -93,9 +94,41 @@ Status UnionNode::prepare(RuntimeState* state) {
         // AddExprCtxsToFree(_child_expr_lists[i]);
         DCHECK_EQ(_child_expr_lists[i].size(), _tuple_desc->slots().size());
     }
+    _child_slot_copies.resize(_child_expr_lists.size());
+    for (int i = 0; i < _child_expr_lists.size(); ++i) {
+        if (!is_child_passthrough(i)) init_slot_copies(i);
+    }
     return Status::OK();
 }
 
+void UnionNode::init_slot_copies(int child_idx) {
+    std::vector<SlotCopy> copies;
+    const std::vector<ExprContext*>& exprs = _child_expr_lists[child_idx];
+    int expr_idx = 0;
+    for (const SlotDescriptor* slot_desc : _tuple_desc->slots()) {
+        if (!slot_desc->is_materialized()) continue;
+        const Expr* expr = exprs[expr_idx++]->root();
+        // types must match exactly, e.g. a DATE slot of a DATETIME expr is left to
+        // materialize_exprs()
+        if (!expr->is_slotref() || expr->type() != slot_desc->type()
+                || slot_desc->type().type == TYPE_NULL || slot_desc->type().is_complex_type()) {
+            return;
+        }
+        const SlotRef* slot_ref = static_cast<const SlotRef*>(expr);
+        if (slot_ref->slot_id() == -1) return;
+        SlotCopy copy;
+        copy.src_tuple_idx = slot_ref->tuple_idx();
+        copy.src_offset = slot_ref->slot_offset();
+        copy.src_null_indicator = slot_ref->null_indicator_offset();
+        copy.dst_offset = slot_desc->tuple_offset();
+        copy.dst_null_indicator = slot_desc->null_indicator_offset();
+        copy.size = slot_desc->slot_size();
+        copy.string_type = slot_desc->type().is_string_type() ? &slot_desc->type() : nullptr;
+        copies.push_back(copy);
+    }
+    _child_slot_copies[child_idx].swap(copies);
+}
+
 void UnionNode::codegen(RuntimeState* state) {
 #if 0
     DCHECK(state->ShouldCodegen());
@@ -228,7 +261,9 @@ Status UnionNode::get_next_materialized(RuntimeState* state, RowBatch* row_batch
                 if (_child_batch->num_rows() == 0) continue;
             }
             DCHECK_EQ(_codegend_union_materialize_batch_fns.size(), _children.size());
-            if (_codegend_union_materialize_batch_fns[_child_idx] == nullptr) {
+            if (!_child_slot_copies[_child_idx].empty()) {
+                copy_slots_batch(row_batch, &tuple_buf);
+            } else if (_codegend_union_materialize_batch_fns[_child_idx] == nullptr) {
                 materialize_batch(row_batch, &tuple_buf);
             } else {
                 _codegend_union_materialize_batch_fns[_child_idx](this, row_batch, &tuple_buf);
@@ -277,6 +312,7 @@ Status UnionNode::get_next_const(RuntimeState* state, RowBatch* row_batch) {
 
 Status UnionNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_PERF_COUNTERS(_perf_counters);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     // TODO(zc)
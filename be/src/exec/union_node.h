@@ -70,6 +70,24 @@ private:
     /// Exprs materialized by this node. The i-th result expr list refers to the i-th child.
     std::vector<std::vector<ExprContext*>> _child_expr_lists;
 
+    /// Copy of a slot of a child row into a slot of the output tuple.
+    struct SlotCopy {
+        int src_tuple_idx;
+        int src_offset;
+        NullIndicatorOffset src_null_indicator;
+        int dst_offset;
+        NullIndicatorOffset dst_null_indicator;
+        int size;
+        /// var-len data is copied into the output batch's pool
+        const TypeDescriptor* string_type;
+    };
+
+    /// The i-th list copies the slots of the i-th child if every expr of its result expr
+    /// list is a SlotRef of the same type as the output slot, so that the child's rows
+    /// are materialized by copying slots column by column instead of evaluating exprs
+    /// row by row. Empty if the child needs expr evaluation or is passthrough.
+    std::vector<std::vector<SlotCopy>> _child_slot_copies;
+
     /////////////////////////////////////////
     /// BEGIN: Members that must be Reset()
 
@@ -122,6 +140,14 @@ private:
     /// have been consumed from the current child batch. Updates '_child_row_idx'.
     void materialize_batch(RowBatch* dst_batch, uint8_t** tuple_buf);
 
+    /// Like materialize_batch(), but copies slots by '_child_slot_copies' of the current
+    /// child instead of evaluating exprs. 'tuple_buf' must be zeroed.
+    void copy_slots_batch(RowBatch* dst_batch, uint8_t** tuple_buf);
+
+    /// Fills '_child_slot_copies' for the child at 'child_idx' if all its result exprs
+    /// are SlotRefs which can be copied directly.
+    void init_slot_copies(int child_idx);
+
     /// Evaluates 'exprs' over 'row', materializes the results in 'tuple_buf'.
     /// and appends the new tuple to 'dst_batch'. Increments '_num_rows_returned'.
     void materialize_exprs(const std::vector<ExprContext*>& exprs,
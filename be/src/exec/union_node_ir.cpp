@@ -16,6 +16,7 @@
 // under the License.
 
 #include "exec/union_node.h"
+#include "runtime/raw_value.h"
 #include "runtime/tuple_row.h"
 
 namespace doris {
@@ -52,4 +53,41 @@ void UnionNode::materialize_batch(RowBatch* dst_batch, uint8_t** tuple_buf) {
     *tuple_buf = cur_tuple;
 }
 
+void UnionNode::copy_slots_batch(RowBatch* dst_batch, uint8_t** tuple_buf) {
+    RowBatch* child_batch = _child_batch.get();
+    int tuple_byte_size = _tuple_desc->byte_size();
+    uint8_t* first_tuple = *tuple_buf;
+    MemPool* pool = dst_batch->tuple_data_pool();
+
+    int num_rows_to_process = std::min(child_batch->num_rows() - _child_row_idx,
+                                       dst_batch->capacity() - dst_batch->num_rows());
+    // Copy one slot of all rows at a time, so that the inner loop only does a single
+    // kind of copy.
+    for (const SlotCopy& copy : _child_slot_copies[_child_idx]) {
+        uint8_t* cur_tuple = first_tuple;
+        for (int i = 0; i < num_rows_to_process; ++i, cur_tuple += tuple_byte_size) {
+            Tuple* src = child_batch->get_row(_child_row_idx + i)->get_tuple(copy.src_tuple_idx);
+            Tuple* dst = reinterpret_cast<Tuple*>(cur_tuple);
+            if (src == nullptr || src->is_null(copy.src_null_indicator)) {
+                dst->set_null(copy.dst_null_indicator);
+            } else if (copy.string_type != nullptr) {
+                RawValue::write(src->get_slot(copy.src_offset), dst->get_slot(copy.dst_offset),
+                                *copy.string_type, pool);
+            } else {
+                memcpy(dst->get_slot(copy.dst_offset), src->get_slot(copy.src_offset), copy.size);
+            }
+        }
+    }
+
+    int dst_row_idx = dst_batch->add_rows(num_rows_to_process);
+    uint8_t* cur_tuple = first_tuple;
+    for (int i = 0; i < num_rows_to_process; ++i, cur_tuple += tuple_byte_size) {
+        dst_batch->get_row(dst_row_idx + i)->set_tuple(0, reinterpret_cast<Tuple*>(cur_tuple));
+    }
+    dst_batch->commit_rows(num_rows_to_process);
+
+    _child_row_idx += num_rows_to_process;
+    *tuple_buf = cur_tuple;
+}
+
 }
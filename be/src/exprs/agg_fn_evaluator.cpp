@@ -24,9 +24,11 @@
 #include "exec/aggregation_node.h"
 #include "exprs/aggregate_functions.h"
 #include "exprs/anyval_util.h"
+#include "runtime/row_batch.h"
 #include "runtime/user_function_cache.h"
 #include "udf/udf_internal.h"
 #include "util/debug_util.h"
+#include "util/symbols_util.h"
 #include "runtime/datetime_value.h"
 #include "runtime/mem_tracker.h"
 #include "thrift/protocol/TDebugProtocol.h"
@@ -116,7 +118,9 @@ AggFnEvaluator::AggFnEvaluator(const TExprNode& desc, bool is_analytic_fn) :
         _merge_fn(NULL),
         _serialize_fn(NULL),
         _get_value_fn(NULL),
-        _finalize_fn(NULL) {
+        _finalize_fn(NULL),
+        _update_batch_fn(NULL),
+        _merge_batch_fn(NULL) {
         if (_fn.name.function_name == "count") {
             _agg_op = COUNT;
         } else if (_fn.name.function_name == "min") {
@@ -248,6 +252,14 @@ Status AggFnEvaluator::prepare(
                 NULL));
     }
 
+    // Batch versions are optional and only looked up for UDAs
+    if (_fn.binary_type != TFunctionBinaryType::BUILTIN && !_is_multi_distinct) {
+        _update_batch_fn = get_batch_fn(_fn.aggregate_fn.update_fn_symbol);
+        if (_merge_fn != NULL) {
+            _merge_batch_fn = get_batch_fn(_fn.aggregate_fn.merge_fn_symbol);
+        }
+    }
+
     vector<FunctionContext::TypeDesc> arg_types;
     for (int j = 0; j < _input_exprs_ctxs.size(); ++j) {
         arg_types.push_back(
@@ -816,6 +828,60 @@ void AggFnEvaluator::update_or_merge(FunctionContext* agg_fn_ctx, TupleRow* row,
     set_output_slot(_staging_intermediate_val, _intermediate_slot_desc, dst);
 }
 
+void* AggFnEvaluator::get_batch_fn(const std::string& symbol) {
+    std::string batch_symbol = SymbolsUtil::mangle_batch_function(
+        SymbolsUtil::demangle_no_args(symbol) + "_batch");
+    void* fn = NULL;
+    Status status = UserFunctionCache::instance()->get_function_ptr(
+        _fn.id, batch_symbol, _hdfs_location, _fn.checksum, &fn, NULL, true);
+    return status.ok() ? fn : NULL;
+}
+
+void AggFnEvaluator::add_batch(FunctionContext* agg_fn_ctx, RowBatch* batch, Tuple* dst) {
+    void* batch_fn = _is_merge ? _merge_batch_fn : _update_batch_fn;
+    if (batch_fn == NULL) {
+        for (int i = 0; i < batch->num_rows(); ++i) {
+            add(agg_fn_ctx, batch->get_row(i), dst);
+        }
+        return;
+    }
+    agg_fn_ctx->impl()->increment_num_updates(batch->num_rows());
+    update_or_merge_batch(agg_fn_ctx, batch, dst, batch_fn);
+}
+
+void AggFnEvaluator::update_or_merge_batch(FunctionContext* agg_fn_ctx,
+        RowBatch* batch, Tuple* dst, void* fn) {
+    int num_rows = batch->num_rows();
+    if (num_rows == 0) {
+        return;
+    }
+    bool dst_null = dst->is_null(_intermediate_slot_desc->null_indicator_offset());
+    void* dst_slot = NULL;
+    if (!dst_null) {
+        dst_slot = dst->get_slot(_intermediate_slot_desc->tuple_offset());
+    }
+    set_any_val(dst_slot, _intermediate_slot_desc->type(), _staging_intermediate_val);
+
+    // Convert the inputs to columns of *Vals
+    std::vector<std::vector<uint8_t>> bufs(input_expr_ctxs().size());
+    std::vector<const AnyVal*> args(input_expr_ctxs().size());
+    for (int i = 0; i < input_expr_ctxs().size(); ++i) {
+        const TypeDescriptor& type = input_expr_ctxs()[i]->root()->type();
+        int val_size = AnyValUtil::any_val_size(type);
+        bufs[i].resize(num_rows * val_size);
+        for (int j = 0; j < num_rows; ++j) {
+            void* src_slot = input_expr_ctxs()[i]->get_value(batch->get_row(j));
+            set_any_val(src_slot, type, reinterpret_cast<AnyVal*>(&bufs[i][j * val_size]));
+        }
+        args[i] = reinterpret_cast<const AnyVal*>(bufs[i].data());
+    }
+
+    reinterpret_cast<UdaUpdateBatch>(fn)(agg_fn_ctx, num_rows, args.data(),
+                                         _staging_intermediate_val);
+
+    set_output_slot(_staging_intermediate_val, _intermediate_slot_desc, dst);
+}
+
 void AggFnEvaluator::update(
         FunctionContext* agg_fn_ctx, TupleRow* row, Tuple* dst, void* fn, MemPool* pool) {
     return update_or_merge(agg_fn_ctx, row, dst, fn);
@@ -35,6 +35,7 @@
 namespace doris {
 
 class AggregationNode;
+class RowBatch;
 class TExprNode;
 
 // This class evaluates aggregate functions. Aggregate funtions can either be
@@ -124,6 +125,10 @@ public:
     // is_merge_. That is, from the caller, it doesn't mater.
     void add(doris_udf::FunctionContext* agg_fn_ctx, TupleRow* src, Tuple* dst);
 
+    // Same as calling add() for every row of batch, but calls the batch version of the
+    // UDA's update() or merge() function once if it has one, see UdaUpdateBatch.
+    void add_batch(doris_udf::FunctionContext* agg_fn_ctx, RowBatch* batch, Tuple* dst);
+
     // Updates the intermediate state dst to remove the input src row, i.e. undoes
     // add(src, dst). Only used internally for analytic fn builtins.
     void remove(doris_udf::FunctionContext* agg_fn_ctx, TupleRow* src, Tuple* dst);
@@ -181,6 +186,9 @@ public:
     void choose_update_or_merge(FunctionContext* agg_fn_ctx, TupleRow* row, Tuple* dst);
     static void add(const std::vector<AggFnEvaluator*>& evaluators,
                 const std::vector<doris_udf::FunctionContext*>& fn_ctxs, TupleRow* src, Tuple* dst);
+    static void add_batch(const std::vector<AggFnEvaluator*>& evaluators,
+                const std::vector<doris_udf::FunctionContext*>& fn_ctxs, RowBatch* batch,
+                Tuple* dst);
     static void remove(const std::vector<AggFnEvaluator*>& evaluators,
                 const std::vector<doris_udf::FunctionContext*>& fn_ctxs, TupleRow* src, Tuple* dst);
     static void get_value(const std::vector<AggFnEvaluator*>& evaluators,
@@ -265,6 +273,9 @@ private:
     void* _serialize_fn;
     void* _get_value_fn;
     void* _finalize_fn;
+    // Optional batch versions of _update_fn and _merge_fn of UDAs.
+    void* _update_batch_fn;
+    void* _merge_batch_fn;
 
     // Use create() instead.
     AggFnEvaluator(const TExprNode& desc);
@@ -290,6 +301,13 @@ private:
     void update_or_merge(FunctionContext* agg_fn_ctx,
             TupleRow* row, Tuple* dst, void* fn);
 
+    // Batch version of update_or_merge(), fn is a UdaUpdateBatch.
+    void update_or_merge_batch(FunctionContext* agg_fn_ctx,
+            RowBatch* batch, Tuple* dst, void* fn);
+
+    // Looks up the optional batch version of the UDA function 'symbol'.
+    void* get_batch_fn(const std::string& symbol);
+
     // Sets up the arguments to call fn. This converts from the agg-expr signature,
     // taking TupleRow to the UDA signature taking AnvVals.
     // void serialize_or_finalize(FunctionContext* agg_fn_ctx, const SlotDescriptor* dst_slot_desc, Tuple* dst, void* fn);
@@ -339,6 +357,14 @@ inline void AggFnEvaluator::add(const std::vector<AggFnEvaluator*>& evaluators,
         evaluators[i]->add(fn_ctxs[i], src, dst);
     }
 }
+inline void AggFnEvaluator::add_batch(const std::vector<AggFnEvaluator*>& evaluators,
+        const std::vector<doris_udf::FunctionContext*>& fn_ctxs, RowBatch* batch, Tuple* dst) {
+    DCHECK_EQ(evaluators.size(), fn_ctxs.size());
+
+    for (int i = 0; i < evaluators.size(); ++i) {
+        evaluators[i]->add_batch(fn_ctxs[i], batch, dst);
+    }
+}
 inline void AggFnEvaluator::remove(const std::vector<AggFnEvaluator*>& evaluators,
         const std::vector<doris_udf::FunctionContext*>& fn_ctxs, TupleRow* src, Tuple* dst) {
     DCHECK_EQ(evaluators.size(), fn_ctxs.size());
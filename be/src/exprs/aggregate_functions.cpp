@@ -22,6 +22,7 @@
 #include <sstream>
 #include <unordered_set>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "runtime/string_value.h"
 #include "runtime/datetime_value.h"
@@ -233,14 +234,7 @@ void AggregateFunctions::avg_update(FunctionContext* ctx, const T& src, StringVa
 }
 
 struct PercentileApproxState {
-public:
-    PercentileApproxState() : digest(new TDigest()){
-    }
-    ~PercentileApproxState() {
-        delete digest;
-    }
-    
-    TDigest *digest = nullptr;
+    TDigest digest;
     double targetQuantile = -1.0;
 };
 
@@ -259,7 +253,7 @@ void AggregateFunctions::percentile_approx_update(FunctionContext* ctx, const T&
     DCHECK_EQ(sizeof(PercentileApproxState), dst->len);
 
     PercentileApproxState* percentile = reinterpret_cast<PercentileApproxState*>(dst->ptr);
-    percentile->digest->add(src.val);
+    percentile->digest.add(src.val);
     percentile->targetQuantile = quantile.val;
 }
 
@@ -267,10 +261,12 @@ StringVal AggregateFunctions::percentile_approx_serialize(FunctionContext* ctx,
     DCHECK(!src.is_null);
 
     PercentileApproxState* percentile = reinterpret_cast<PercentileApproxState*>(src.ptr);
-    uint32_t serialized_size = percentile->digest->serialized_size();
+    // only send the compressed centroids to the merging side
+    percentile->digest.compress();
+    uint32_t serialized_size = percentile->digest.serialized_size();
     StringVal result(ctx, sizeof(double) + serialized_size);
     memcpy(result.ptr, &percentile->targetQuantile, sizeof(double));
-    percentile->digest->serialize(result.ptr + sizeof(double));
+    percentile->digest.serialize(result.ptr + sizeof(double));
 
     delete percentile;
     return result;
@@ -283,15 +279,12 @@ void AggregateFunctions::percentile_approx_merge(FunctionContext* ctx, const Str
     double quantile;
     memcpy(&quantile, src.ptr, sizeof(double));
 
-    PercentileApproxState *src_percentile = new PercentileApproxState();
-    src_percentile->targetQuantile = quantile;
-    src_percentile->digest->unserialize(src.ptr + sizeof(double));
+    TDigest src_digest;
+    src_digest.unserialize(src.ptr + sizeof(double));
 
     PercentileApproxState* dst_percentile = reinterpret_cast<PercentileApproxState*>(dst->ptr);
-    dst_percentile->digest->merge(src_percentile->digest);
+    dst_percentile->digest.merge(&src_digest);
     dst_percentile->targetQuantile = quantile;
-
-    delete src_percentile;
 }
 
 DoubleVal AggregateFunctions::percentile_approx_finalize(FunctionContext* ctx, const StringVal& src) {
@@ -299,7 +292,7 @@ DoubleVal AggregateFunctions::percentile_approx_finalize(FunctionContext* ctx, c
 
     PercentileApproxState* percentile = reinterpret_cast<PercentileApproxState *>(src.ptr);
     double quantile = percentile->targetQuantile;
-    double result = percentile->digest->quantile(quantile);
+    double result = percentile->digest.quantile(quantile);
 
     delete percentile;
     return DoubleVal(result);
@@ -1133,11 +1126,15 @@ StringVal AggregateFunctions::pcsa_finalize(FunctionContext* c, const StringVal&
 }
 
 void AggregateFunctions::hll_init(FunctionContext* ctx, StringVal* dst) {
-    int str_len = std::pow(2, HLL_COLUMN_PRECISION);
+    if (config::enable_sparse_hll_intermediate) {
+        static_cast<HllVal*>(dst)->init(ctx);
+        return;
+    }
+    // untagged registers, the intermediate older backends exchange
     dst->is_null = false;
-    dst->ptr = ctx->allocate(str_len);
-    dst->len = str_len;
-    memset(dst->ptr, 0, str_len);
+    dst->ptr = ctx->allocate(HLL_REGISTERS_COUNT);
+    dst->len = HLL_REGISTERS_COUNT;
+    memset(dst->ptr, 0, HLL_REGISTERS_COUNT);
 }
 
 template <typename T>
@@ -1147,33 +1144,46 @@ void AggregateFunctions::hll_update(FunctionContext* ctx, const T& src, StringVa
     }
 
     DCHECK(!dst->is_null);
-    DCHECK_EQ(dst->len, std::pow(2, HLL_COLUMN_PRECISION));
     uint64_t hash_value = AnyValUtil::hash64_murmur(src, HashUtil::MURMUR_SEED);
 
-    if (hash_value != 0) {
+    if (hash_value == 0) {
+        return;
+    }
+    if (dst->len == HLL_REGISTERS_COUNT) {
         // Use the lower bits to index into the number of streams and then
         // find the first 1 bit after the index bits.
-        int idx = hash_value % dst->len;
-        // uint8_t first_one_bit = __buiHLL_LENltin_ctzl(hash_value >> HLL_PRECISION) + 1;
+        int idx = hash_value % HLL_REGISTERS_COUNT;
         uint8_t first_one_bit = __builtin_ctzl(hash_value >> HLL_COLUMN_PRECISION) + 1;
         dst->ptr[idx] = std::max(dst->ptr[idx], first_one_bit);
+        return;
     }
+    static_cast<HllVal*>(dst)->agg_update_hash(ctx, hash_value);
 }
 
 void AggregateFunctions::hll_merge(FunctionContext* ctx, const StringVal& src,
                                    StringVal* dst) {
     DCHECK(!dst->is_null);
     DCHECK(!src.is_null);
-    DCHECK_EQ(dst->len, std::pow(2, HLL_COLUMN_PRECISION));
-    DCHECK_EQ(src.len, std::pow(2, HLL_COLUMN_PRECISION));
-
-    for (int i = 0; i < src.len; ++i) {
-        dst->ptr[i] = std::max(dst->ptr[i], src.ptr[i]);
+    if (dst->len == HLL_REGISTERS_COUNT) {
+        if (src.len == HLL_REGISTERS_COUNT) {
+            HllSetHelper::merge_registers(dst->ptr, src.ptr, HLL_REGISTERS_COUNT);
+            return;
+        }
+        // a sparse intermediate from a backend enabling them, tag our registers as
+        // a full set to union it
+        uint8_t* full = ctx->allocate(HLL_COLUMN_DEFAULT_LEN);
+        full[0] = HLL_DATA_FULL;
+        memcpy(full + 1, dst->ptr, HLL_REGISTERS_COUNT);
+        ctx->free(dst->ptr);
+        dst->ptr = full;
+        dst->len = HLL_COLUMN_DEFAULT_LEN;
     }
+    static_cast<HllVal*>(dst)->agg_parse_and_cal(ctx, static_cast<const HllVal&>(src));
 }
 
 StringVal AggregateFunctions::hll_finalize(FunctionContext* ctx, const StringVal& src) {
-    double estimate = hll_algorithm(src);
+    double estimate = src.len == HLL_REGISTERS_COUNT
+        ? hll_algorithm(src.ptr, src.len) : hll_algorithm(static_cast<const HllVal&>(src));
     // Output the estimate as ascii string
     std::stringstream out;
     out << (int64_t)estimate;
@@ -1194,17 +1204,15 @@ void AggregateFunctions::hll_union_agg_update(FunctionContext* ctx,
     }
     DCHECK(!dst->is_null);
     
-    dst->agg_parse_and_cal(src);
+    dst->agg_parse_and_cal(ctx, src);
     return ;
 }
 
 void AggregateFunctions::hll_union_agg_merge(FunctionContext* ctx, const HllVal& src, HllVal* dst) {
     DCHECK(!dst->is_null);
     DCHECK(!src.is_null);
-    DCHECK_EQ(dst->len, HLL_COLUMN_DEFAULT_LEN);
-    DCHECK_EQ(src.len, HLL_COLUMN_DEFAULT_LEN);
      
-    dst->agg_merge(src);
+    dst->agg_parse_and_cal(ctx, src);
 }
 
 doris_udf::BigIntVal AggregateFunctions::hll_union_agg_finalize(doris_udf::FunctionContext* ctx,
@@ -1233,9 +1241,50 @@ doris_udf::StringVal AggregateFunctions::hll_union_agg_finalize(doris_udf::Funct
     return AnyValUtil::from_string_temp(ctx, std::to_string(intVal.val));;
 }
 
+// 2^-i for every register value i
+struct HllInversePow2Table {
+    float values[256];
+
+    HllInversePow2Table() {
+        for (int i = 0; i < 256; ++i) {
+            values[i] = powf(2.0f, -i);
+        }
+    }
+};
+static const HllInversePow2Table s_hll_inverse_pow2;
+
 int64_t AggregateFunctions::hll_algorithm(uint8_t *pdata, int data_len) {
     DCHECK_EQ(data_len, HLL_REGISTERS_COUNT);
-    
+
+    float harmonic_mean = 0;
+    int num_zero_registers = 0;
+    for (int i = 0; i < data_len; ++i) {
+        harmonic_mean += s_hll_inverse_pow2.values[pdata[i]];
+        num_zero_registers += (pdata[i] == 0);
+    }
+    return hll_estimate(harmonic_mean, num_zero_registers);
+}
+
+int64_t AggregateFunctions::hll_algorithm(const HllVal &dst) {
+    if (dst.ptr[0] == HLL_DATA_FULL) {
+        return hll_algorithm(dst.ptr + 1, dst.len - 1);
+    }
+    // sparse, registers which are not stored are zero
+    int32_t count = 0;
+    if (dst.ptr[0] == HLL_DATA_SPRASE) {
+        memcpy(&count, dst.ptr + 1, sizeof(count));
+    }
+    int num_zero_registers = HLL_REGISTERS_COUNT - count;
+    float harmonic_mean = num_zero_registers;
+    const uint8_t* entry = dst.ptr + HLL_SPARSE_HEADER_LEN;
+    for (int32_t i = 0; i < count; ++i, entry += HLL_SPARSE_ENTRY_LEN) {
+        harmonic_mean += s_hll_inverse_pow2.values[entry[2]];
+        num_zero_registers += (entry[2] == 0);
+    }
+    return hll_estimate(harmonic_mean, num_zero_registers);
+}
+
+int64_t AggregateFunctions::hll_estimate(float harmonic_mean, int num_zero_registers) {
     const int num_streams = HLL_REGISTERS_COUNT;
     // Empirical constants for the algorithm.
     float alpha = 0;
@@ -1250,17 +1299,6 @@ int64_t AggregateFunctions::hll_algorithm(uint8_t *pdata, int data_len) {
         alpha = 0.7213f / (1 + 1.079f / num_streams);
     }
     
-    float harmonic_mean = 0;
-    int num_zero_registers = 0;
-    
-    for (int i = 0; i < data_len; ++i) {
-        harmonic_mean += powf(2.0f, -pdata[i]);
-        
-        if (pdata[i] == 0) {
-            ++num_zero_registers;
-        }
-    }
-    
     harmonic_mean = 1.0f / harmonic_mean;
     double estimate = alpha * num_streams * num_streams * harmonic_mean;
     // according to HerperLogLog current correction, if E is cardinal
@@ -1308,15 +1346,94 @@ doris_udf::HllVal AggregateFunctions::hll_raw_agg_finalize(
         doris_udf::FunctionContext* ctx,
         const HllVal& src) {
     DCHECK(!src.is_null);
-    DCHECK_EQ(src.len, HLL_COLUMN_DEFAULT_LEN);
 
     HllVal result;
-    result.init(ctx);
+    result.is_null = false;
+    result.len = src.len;
+    result.ptr = ctx->allocate(src.len);
     memcpy(result.ptr, src.ptr, src.len);
     return result;
 }
 
-// TODO chenhao , reduce memory copy
+// Set of the distinct values of one group, used by the multi distinct states. Unlike a
+// node based std::unordered_set it allocates nothing per value. The values are kept
+// once in '_values', in insertion order. Up to MAX_SCAN_SIZE of them are looked up by
+// comparing with each, which is all most groups ever hold; larger sets also get an
+// open addressing table of indexes (+ 1) into '_values' with linear probing, kept at
+// most half full. Values are compared by their bytes.
+template <typename V>
+class DistinctValueSet {
+public:
+    static const size_t MAX_SCAN_SIZE = 8;
+
+    DistinctValueSet() : _mask(0) {
+    }
+
+    void insert(const V& value) {
+        if (_slots.empty()) {
+            for (const V& v : _values) {
+                if (equal(v, value)) {
+                    return;
+                }
+            }
+            _values.push_back(value);
+            if (_values.size() > MAX_SCAN_SIZE) {
+                rebuild();
+            }
+            return;
+        }
+        size_t i = hash(value) & _mask;
+        for (; _slots[i] != 0; i = (i + 1) & _mask) {
+            if (equal(_values[_slots[i] - 1], value)) {
+                return;
+            }
+        }
+        _values.push_back(value);
+        if (_values.size() * 2 > _slots.size()) {
+            rebuild();
+        } else {
+            _slots[i] = _values.size();
+        }
+    }
+
+    size_t size() const {
+        return _values.size();
+    }
+
+    const std::vector<V>& values() const {
+        return _values;
+    }
+
+private:
+    static size_t hash(const V& value) {
+        return HashUtil::hash(&value, sizeof(V), 0);
+    }
+
+    static bool equal(const V& lhs, const V& rhs) {
+        return memcmp(&lhs, &rhs, sizeof(V)) == 0;
+    }
+
+    void rebuild() {
+        size_t num_slots = 16;
+        while (num_slots < _values.size() * 4) {
+            num_slots <<= 1;
+        }
+        _slots.assign(num_slots, 0);
+        _mask = num_slots - 1;
+        for (size_t idx = 0; idx < _values.size(); ++idx) {
+            size_t i = hash(_values[idx]) & _mask;
+            while (_slots[i] != 0) {
+                i = (i + 1) & _mask;
+            }
+            _slots[i] = idx + 1;
+        }
+    }
+
+    std::vector<V> _values;
+    std::vector<uint32_t> _slots;
+    size_t _mask;
+};
+
 // multi distinct state for numertic
 // serialize order type:value:value:value ...
 template <typename T>
@@ -1353,12 +1470,12 @@ public:
     }
 
     void update(T& t) {
-        _set.insert(t);
+        _set.insert(t.val);
     }
 
     // type:one byte  value:sizeof(T)
     StringVal serialize(FunctionContext* ctx) {
-        size_t type_size = sizeof(((T*)0)->val);
+        size_t type_size = sizeof(ValueType);
         const size_t serialized_set_length = sizeof(uint8_t) + type_size * _set.size();
         StringVal result(ctx, serialized_set_length);
         uint8_t* type_writer = result.ptr;
@@ -1366,15 +1483,16 @@ public:
         *type_writer = (uint8_t)_type;
         type_writer++;
         // value
-        for (auto& value : _set) {
-            memcpy(type_writer, &value.val, type_size);
+        for (auto& value : _set.values()) {
+            memcpy(type_writer, &value, type_size);
             type_writer += type_size;
         }
         return result;
     }
 
+    // adds the values of the serialized set 'src' to this set
     void unserialize(StringVal& src) {
-        size_t type_size = sizeof(((T*)0)->val);
+        size_t type_size = sizeof(ValueType);
         const uint8_t* type_reader = src.ptr;
         const uint8_t* end = src.ptr + src.len;
         // type
@@ -1382,19 +1500,13 @@ public:
         type_reader++;
         // value
         while (type_reader < end) {
-            T value;
-            value.is_null = false;
-            memcpy(&value.val, type_reader, type_size);
+            ValueType value;
+            memcpy(&value, type_reader, type_size);
             _set.insert(value);
             type_reader += type_size;
         }
     }
 
-    // merge set
-    void merge(MultiDistinctNumericState& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }
-
     // count
     BigIntVal count_finalize() {
         return BigIntVal(_set.size());
@@ -1403,8 +1515,8 @@ public:
     // sum for double, decimal
     DoubleVal sum_finalize_double() {
         double sum = 0;
-        for (auto& value : _set) {
-            sum += value.val;
+        for (auto& value : _set.values()) {
+            sum += value;
         }
         return DoubleVal(sum);
     }
@@ -1412,8 +1524,8 @@ public:
     // sum for largeint 
     LargeIntVal sum_finalize_largeint() {
         __int128 sum = 0;
-        for (auto& value : _set) {
-            sum += value.val;
+        for (auto& value : _set.values()) {
+            sum += value;
         }
         return LargeIntVal(sum);
     }
@@ -1421,8 +1533,8 @@ public:
     // sum for tinyint, smallint, int, bigint
     BigIntVal sum_finalize_bigint() {
         int64_t sum = 0;
-        for (auto& value : _set) {
-            sum += value.val;
+        for (auto& value : _set.values()) {
+            sum += value;
         }
         return BigIntVal(sum);
     }
@@ -1432,19 +1544,9 @@ public:
     }
 
 private:
+    using ValueType = decltype(T::val);
 
-    class NumericHashHelper {   
-    public:
-        size_t operator()(const T& obj) const {
-            size_t result = AnyValUtil::hash64_murmur(obj, HashUtil::MURMUR_SEED);   
-            return result;
-        }
-    };
-
-    std::unordered_set<T, NumericHashHelper> _set;
-    // Because Anyval does not provide the hash function, in order 
-    // to adopt the type different from the template, the pointer is used
-    // HybirdSetBase* _set;
+    DistinctValueSet<ValueType> _set;
     // _type is serialized into buffer by one byte
     FunctionContext::Type _type;
 };
@@ -1503,6 +1605,7 @@ public:
         return result;
     }
     
+    // adds the strings of the serialized set 'src' to this set
     void unserialize(StringVal& src) {
         uint8_t* reader = src.ptr;
         // skip type ,no used now
@@ -1519,12 +1622,8 @@ public:
         }
         DCHECK(reader == end);
     }
-   
-    // merge set 
-    void merge(MultiDistinctStringCountState& state) {
-        _set.insert(&(state._set));
-    }
-    
+
+
     BigIntVal finalize() {
         return BigIntVal(_set.size());
     }
@@ -1614,11 +1713,6 @@ public:
         return _type;
     }
 
-    // merge set
-    void merge(MultiDistinctDecimalState& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }    
-
     // count
     BigIntVal count_finalize() {
         return BigIntVal(_set.size());
@@ -1662,7 +1756,7 @@ public:
     }
 
     void update(DecimalV2Val& t) {
-        _set.insert(DecimalV2Value::from_decimal_val(t));
+        _set.insert(DecimalV2Value::from_decimal_val(t).value());
     }
 
     // type:one byte  value:sizeof(T)
@@ -1674,9 +1768,8 @@ public:
         *writer = (uint8_t)_type;
         writer++;
         // for int_length and frac_length, uint8_t will not overflow.
-        for (auto& value : _set) {
-            __int128 v = value.value();
-            memcpy(writer, &v, DECIMAL_BYTE_SIZE);
+        for (auto& value : _set.values()) {
+            memcpy(writer, &value, DECIMAL_BYTE_SIZE);
             writer += DECIMAL_BYTE_SIZE;
         }    
         return result;
@@ -1692,9 +1785,8 @@ public:
         while (reader < end) {
             __int128 v = 0;
             memcpy(&v, reader, DECIMAL_BYTE_SIZE);
-            DecimalV2Value value(v);
             reader += DECIMAL_BYTE_SIZE;
-            _set.insert(value);
+            _set.insert(v);
         }    
     }    
  
@@ -1702,11 +1794,6 @@ public:
         return _type;
     }
 
-    // merge set
-    void merge(MultiDistinctDecimalV2State& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }    
-
     // count
     BigIntVal count_finalize() {
         return BigIntVal(_set.size());
@@ -1714,8 +1801,8 @@ public:
 
     DecimalV2Val sum_finalize() {
         DecimalV2Value sum;
-        for (auto& value : _set) {
-             sum += value;
+        for (auto& value : _set.values()) {
+             sum += DecimalV2Value(value);
         }
         DecimalV2Val result;
         sum.to_decimal_val(&result); 
@@ -1725,7 +1812,8 @@ public:
 private:
     const int DECIMAL_BYTE_SIZE = 16;
     
-    std::unordered_set<DecimalV2Value> _set;
+    // the values of the decimals
+    DistinctValueSet<__int128> _set;
     FunctionContext::Type _type;
 };
 
@@ -1792,11 +1880,6 @@ public:
         }
     }
     
-    // merge set
-    void merge(MultiDistinctCountDateState& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }
-    
     // count
     BigIntVal count_finalize() {
         return BigIntVal(_set.size());
@@ -1892,14 +1975,9 @@ void AggregateFunctions::count_or_sum_distinct_numeric_merge(FunctionContext* ct
    DCHECK(!dst->is_null);
    DCHECK(!src.is_null);
    MultiDistinctNumericState<T>* dst_state = reinterpret_cast<MultiDistinctNumericState<T>*>(dst->ptr);
-   // unserialize src
-   StringVal src_state_val;
-   MultiDistinctNumericState<T>::create(&src_state_val); 
-   MultiDistinctNumericState<T>* src_state = reinterpret_cast<MultiDistinctNumericState<T>*>(src_state_val.ptr);
-   src_state->unserialize(src);
-   DCHECK(dst_state->set_type() == src_state->set_type());
-   dst_state->merge(*src_state);
-   MultiDistinctNumericState<T>::destory(src_state_val);
+   DCHECK_EQ(dst_state->set_type(), (FunctionContext::Type)*src.ptr);
+   // add the values of src without building a set for it first
+   dst_state->unserialize(src);
 }
     
 void AggregateFunctions::count_distinct_string_merge(FunctionContext* ctx, StringVal& src,
@@ -1907,14 +1985,9 @@ void AggregateFunctions::count_distinct_string_merge(FunctionContext* ctx, Strin
     DCHECK(!dst->is_null);
     DCHECK(!src.is_null);
     MultiDistinctStringCountState* dst_state = reinterpret_cast<MultiDistinctStringCountState*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctStringCountState::create(&src_state_val);
-    MultiDistinctStringCountState* src_state = reinterpret_cast<MultiDistinctStringCountState*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctStringCountState::destory(src_state_val); 
+    DCHECK_EQ(dst_state->set_type(), (FunctionContext::Type)*src.ptr);
+    // add the values of src without building a set for it first
+    dst_state->unserialize(src);
 }
 
 
@@ -1923,14 +1996,9 @@ void AggregateFunctions::count_or_sum_distinct_decimal_merge(FunctionContext* ct
     DCHECK(!dst->is_null);
     DCHECK(!src.is_null);
     MultiDistinctDecimalState* dst_state = reinterpret_cast<MultiDistinctDecimalState*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctDecimalState::create(&src_state_val);
-    MultiDistinctDecimalState* src_state = reinterpret_cast<MultiDistinctDecimalState*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctDecimalState::destory(src_state_val);
+    DCHECK_EQ(dst_state->set_type(), (FunctionContext::Type)*src.ptr);
+    // add the values of src without building a set for it first
+    dst_state->unserialize(src);
 }
 
 void AggregateFunctions::count_or_sum_distinct_decimalv2_merge(FunctionContext* ctx, StringVal& src,
@@ -1938,14 +2006,9 @@ void AggregateFunctions::count_or_sum_distinct_decimalv2_merge(FunctionContext*
     DCHECK(!dst->is_null);
     DCHECK(!src.is_null);
     MultiDistinctDecimalV2State* dst_state = reinterpret_cast<MultiDistinctDecimalV2State*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctDecimalV2State::create(&src_state_val);
-    MultiDistinctDecimalV2State* src_state = reinterpret_cast<MultiDistinctDecimalV2State*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctDecimalV2State::destory(src_state_val);
+    DCHECK_EQ(dst_state->set_type(), (FunctionContext::Type)*src.ptr);
+    // add the values of src without building a set for it first
+    dst_state->unserialize(src);
 }
     
 void AggregateFunctions::count_distinct_date_merge(FunctionContext* ctx, StringVal& src,
@@ -1953,14 +2016,9 @@ void AggregateFunctions::count_distinct_date_merge(FunctionContext* ctx, StringV
     DCHECK(!dst->is_null);
     DCHECK(!src.is_null);
     MultiDistinctCountDateState* dst_state = reinterpret_cast<MultiDistinctCountDateState*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctCountDateState::create(&src_state_val);
-    MultiDistinctCountDateState* src_state = reinterpret_cast<MultiDistinctCountDateState*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctCountDateState::destory(src_state_val);
+    DCHECK_EQ(dst_state->set_type(), (FunctionContext::Type)*src.ptr);
+    // add the values of src without building a set for it first
+    dst_state->unserialize(src);
 }
     
 template <typename T>
@@ -199,6 +199,7 @@ dst);
     // 1) Hyperloglog: The analysis of a near-optimal cardinality estimation
     // algorithm (2007)
     // 2) HyperLogLog in Practice (paper from google with some improvements)
+    // The intermediate is an HllVal, see udf.h.
     static void hll_init(doris_udf::FunctionContext*, doris_udf::StringVal* slot);
     template <typename T>
     static void hll_update(doris_udf::FunctionContext*, const T& src, doris_udf::StringVal* dst);
@@ -359,14 +360,12 @@ dst);
                                     doris_udf::StringVal* dst);
     static doris_udf::StringVal hll_union_agg_finalize(doris_udf::FunctionContext* ctx, const StringVal& src);
 
-    // calculate result
+    // calculate result from the registers of a full set
     static int64_t hll_algorithm(uint8_t *pdata, int data_len);
-    static int64_t hll_algorithm(const StringVal &dst) {
-        return hll_algorithm(dst.ptr, dst.len);
-    }
-    static int64_t hll_algorithm(const HllVal &dst) {
-        return hll_algorithm(dst.ptr + 1, dst.len - 1);
-    }
+    // calculate result of a set built by hll_union_agg_init() or hll_init()
+    static int64_t hll_algorithm(const HllVal &dst);
+    // estimate from the sum of 2^-register over all registers
+    static int64_t hll_estimate(float harmonic_mean, int num_zero_registers);
 
     //  HLL value type aggregate to HLL value type
     static void hll_raw_agg_init(
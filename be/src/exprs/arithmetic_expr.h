@@ -61,6 +61,19 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+
+    virtual void get_tiny_int_vals(ExprContext* context, RowBatch* batch,
+                                   const int* sel, int num_rows, TinyIntVal* vals);
+    virtual void get_small_int_vals(ExprContext* context, RowBatch* batch,
+                                    const int* sel, int num_rows, SmallIntVal* vals);
+    virtual void get_int_vals(ExprContext* context, RowBatch* batch,
+                              const int* sel, int num_rows, IntVal* vals);
+    virtual void get_big_int_vals(ExprContext* context, RowBatch* batch,
+                                  const int* sel, int num_rows, BigIntVal* vals);
+    virtual void get_float_vals(ExprContext* context, RowBatch* batch,
+                                const int* sel, int num_rows, FloatVal* vals);
+    virtual void get_double_vals(ExprContext* context, RowBatch* batch,
+                                 const int* sel, int num_rows, DoubleVal* vals);
 };
 
 class SubExpr : public ArithmeticExpr {
@@ -78,6 +91,19 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+
+    virtual void get_tiny_int_vals(ExprContext* context, RowBatch* batch,
+                                   const int* sel, int num_rows, TinyIntVal* vals);
+    virtual void get_small_int_vals(ExprContext* context, RowBatch* batch,
+                                    const int* sel, int num_rows, SmallIntVal* vals);
+    virtual void get_int_vals(ExprContext* context, RowBatch* batch,
+                              const int* sel, int num_rows, IntVal* vals);
+    virtual void get_big_int_vals(ExprContext* context, RowBatch* batch,
+                                  const int* sel, int num_rows, BigIntVal* vals);
+    virtual void get_float_vals(ExprContext* context, RowBatch* batch,
+                                const int* sel, int num_rows, FloatVal* vals);
+    virtual void get_double_vals(ExprContext* context, RowBatch* batch,
+                                 const int* sel, int num_rows, DoubleVal* vals);
 };
 
 class MulExpr : public ArithmeticExpr {
@@ -95,6 +121,19 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+
+    virtual void get_tiny_int_vals(ExprContext* context, RowBatch* batch,
+                                   const int* sel, int num_rows, TinyIntVal* vals);
+    virtual void get_small_int_vals(ExprContext* context, RowBatch* batch,
+                                    const int* sel, int num_rows, SmallIntVal* vals);
+    virtual void get_int_vals(ExprContext* context, RowBatch* batch,
+                              const int* sel, int num_rows, IntVal* vals);
+    virtual void get_big_int_vals(ExprContext* context, RowBatch* batch,
+                                  const int* sel, int num_rows, BigIntVal* vals);
+    virtual void get_float_vals(ExprContext* context, RowBatch* batch,
+                                const int* sel, int num_rows, FloatVal* vals);
+    virtual void get_double_vals(ExprContext* context, RowBatch* batch,
+                                 const int* sel, int num_rows, DoubleVal* vals);
 };
 
 class DivExpr : public ArithmeticExpr {
@@ -18,6 +18,7 @@
 #include "exprs/binary_predicate.h"
 
 #include <sstream>
+#include <vector>
 
 #include "codegen/llvm_codegen.h"
 #include "codegen/codegen_anyval.h"
@@ -435,6 +436,59 @@ BINARY_PRED_INT_FNS(LargeIntVal, get_large_int_val);
 BINARY_PRED_FLOAT_FNS(FloatVal, get_float_val);
 BINARY_PRED_FLOAT_FNS(DoubleVal, get_double_val);
 
+int BinaryPredicate::select_rows(const uint8_t* keep, int* sel, int num_rows) {
+    int num_kept = 0;
+    for (int i = 0; i < num_rows; ++i) {
+        sel[num_kept] = sel[i];
+        num_kept += keep[i];
+    }
+    return num_kept;
+}
+
+// Compares the values of both children for the whole batch in one loop without
+// branches. A constant right child, as in the common '<column> <op> <literal>', is
+// evaluated once and compared against directly.
+#define BINARY_PRED_FILTER_FN(CLASS, TYPE, FN, OP) \
+    int CLASS::filter_batch(ExprContext* ctx, RowBatch* batch, int* sel, int num_rows) { \
+        if (num_rows == 0 || is_constant()) { \
+            return Expr::filter_batch(ctx, batch, sel, num_rows); \
+        } \
+        std::vector<TYPE> lhs(num_rows); \
+        std::vector<uint8_t> keep(num_rows); \
+        _children[0]->FN##s(ctx, batch, sel, num_rows, &lhs[0]); \
+        if (_children[1]->is_constant()) { \
+            TYPE rhs = _children[1]->FN(ctx, NULL); \
+            if (rhs.is_null) { \
+                return 0; \
+            } \
+            for (int i = 0; i < num_rows; ++i) { \
+                keep[i] = !lhs[i].is_null & (lhs[i].val OP rhs.val); \
+            } \
+        } else { \
+            std::vector<TYPE> rhs(num_rows); \
+            _children[1]->FN##s(ctx, batch, sel, num_rows, &rhs[0]); \
+            for (int i = 0; i < num_rows; ++i) { \
+                keep[i] = !lhs[i].is_null & !rhs[i].is_null & (lhs[i].val OP rhs[i].val); \
+            } \
+        } \
+        return select_rows(&keep[0], sel, num_rows); \
+    }
+
+#define BINARY_PRED_FILTER_FNS(TYPE, FN) \
+    BINARY_PRED_FILTER_FN(Eq##TYPE##Pred, TYPE, FN, /**/ == /**/) \
+    BINARY_PRED_FILTER_FN(Ne##TYPE##Pred, TYPE, FN, /**/ != /**/) \
+    BINARY_PRED_FILTER_FN(Lt##TYPE##Pred, TYPE, FN, /**/ < /**/) \
+    BINARY_PRED_FILTER_FN(Le##TYPE##Pred, TYPE, FN, /**/ <= /**/) \
+    BINARY_PRED_FILTER_FN(Gt##TYPE##Pred, TYPE, FN, /**/ > /**/) \
+    BINARY_PRED_FILTER_FN(Ge##TYPE##Pred, TYPE, FN, /**/ >= /**/)
+
+BINARY_PRED_FILTER_FNS(TinyIntVal, get_tiny_int_val);
+BINARY_PRED_FILTER_FNS(SmallIntVal, get_small_int_val);
+BINARY_PRED_FILTER_FNS(IntVal, get_int_val);
+BINARY_PRED_FILTER_FNS(BigIntVal, get_big_int_val);
+BINARY_PRED_FILTER_FNS(FloatVal, get_float_val);
+BINARY_PRED_FILTER_FNS(DoubleVal, get_double_val);
+
 #define COMPLICATE_BINARY_PRED_FN(CLASS, TYPE, FN, DORIS_TYPE, FROM_FUNC, OP) \
     BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) { \
         TYPE v1 = _children[0]->FN(ctx, row); \
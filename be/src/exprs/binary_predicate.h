@@ -45,6 +45,10 @@ protected:
    
     Status codegen_compare_fn(
         RuntimeState* state, llvm::Function** fn, llvm::CmpInst::Predicate pred);
+
+    // Moves the rows sel[i] with keep[i] != 0 to the front of 'sel' and returns their
+    // number.
+    static int select_rows(const uint8_t* keep, int* sel, int num_rows);
 };
 
 #define BIN_PRED_CLASS_DEFINE(CLASS) \
@@ -67,14 +71,37 @@ protected:
     BIN_PRED_CLASS_DEFINE(Gt##TYPE##Pred) \
     BIN_PRED_CLASS_DEFINE(Ge##TYPE##Pred)
 
+// Like BIN_PRED_CLASS_DEFINE, for the types that have batch Get*Vals() functions.
+#define BIN_PRED_BATCH_CLASS_DEFINE(CLASS) \
+    class CLASS : public BinaryPredicate { \
+    public: \
+        CLASS(const TExprNode& node) : BinaryPredicate(node) { } \
+        virtual ~CLASS() { }  \
+        virtual Expr* clone(ObjectPool* pool) const override { \
+            return pool->add(new CLASS(*this)); }  \
+        \
+        virtual Status get_codegend_compute_fn(RuntimeState* state, llvm::Function** fn); \
+        virtual BooleanVal get_boolean_val(ExprContext* context, TupleRow* row); \
+        virtual int filter_batch(ExprContext* context, RowBatch* batch, \
+                                 int* sel, int num_rows) override; \
+    };
+
+#define BIN_PRED_BATCH_CLASSES_DEFINE(TYPE) \
+    BIN_PRED_BATCH_CLASS_DEFINE(Eq##TYPE##Pred) \
+    BIN_PRED_BATCH_CLASS_DEFINE(Ne##TYPE##Pred) \
+    BIN_PRED_BATCH_CLASS_DEFINE(Lt##TYPE##Pred) \
+    BIN_PRED_BATCH_CLASS_DEFINE(Le##TYPE##Pred) \
+    BIN_PRED_BATCH_CLASS_DEFINE(Gt##TYPE##Pred) \
+    BIN_PRED_BATCH_CLASS_DEFINE(Ge##TYPE##Pred)
+
 BIN_PRED_CLASSES_DEFINE(BooleanVal)
-BIN_PRED_CLASSES_DEFINE(TinyIntVal)
-BIN_PRED_CLASSES_DEFINE(SmallIntVal)
-BIN_PRED_CLASSES_DEFINE(IntVal)
-BIN_PRED_CLASSES_DEFINE(BigIntVal)
+BIN_PRED_BATCH_CLASSES_DEFINE(TinyIntVal)
+BIN_PRED_BATCH_CLASSES_DEFINE(SmallIntVal)
+BIN_PRED_BATCH_CLASSES_DEFINE(IntVal)
+BIN_PRED_BATCH_CLASSES_DEFINE(BigIntVal)
 BIN_PRED_CLASSES_DEFINE(LargeIntVal)
-BIN_PRED_CLASSES_DEFINE(FloatVal)
-BIN_PRED_CLASSES_DEFINE(DoubleVal)
+BIN_PRED_BATCH_CLASSES_DEFINE(FloatVal)
+BIN_PRED_BATCH_CLASSES_DEFINE(DoubleVal)
 BIN_PRED_CLASSES_DEFINE(StringVal)
 BIN_PRED_CLASSES_DEFINE(DateTimeVal)
 BIN_PRED_CLASSES_DEFINE(DecimalVal)
@@ -0,0 +1,108 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/bitmap_function.h"
+
+#include <limits>
+
+#include "common/logging.h"
+#include "util/bitmap_value.h"
+#include "util/string_parser.hpp"
+
+namespace doris {
+
+using doris_udf::BigIntVal;
+using doris_udf::FunctionContext;
+using doris_udf::StringVal;
+
+static StringVal serialize(FunctionContext* ctx, BitmapValue* bitmap) {
+    StringVal result(ctx, bitmap->serialized_size());
+    bitmap->serialize(reinterpret_cast<char*>(result.ptr));
+    return result;
+}
+
+void BitmapFunctions::init() {
+}
+
+void BitmapFunctions::bitmap_init(FunctionContext* ctx, StringVal* dst) {
+    dst->is_null = false;
+    dst->len = sizeof(BitmapValue);
+    dst->ptr = reinterpret_cast<uint8_t*>(new BitmapValue());
+}
+
+void BitmapFunctions::bitmap_union(FunctionContext* ctx, const StringVal& src, StringVal* dst) {
+    DCHECK(!dst->is_null);
+    if (src.is_null) {
+        return;
+    }
+    BitmapValue src_bitmap;
+    if (!src_bitmap.deserialize(reinterpret_cast<const char*>(src.ptr), src.len)) {
+        ctx->set_error("bitmap_union got an invalid bitmap");
+        return;
+    }
+    *reinterpret_cast<BitmapValue*>(dst->ptr) |= src_bitmap;
+}
+
+StringVal BitmapFunctions::bitmap_serialize(FunctionContext* ctx, const StringVal& src) {
+    DCHECK(!src.is_null);
+    BitmapValue* bitmap = reinterpret_cast<BitmapValue*>(src.ptr);
+    StringVal result = serialize(ctx, bitmap);
+    delete bitmap;
+    return result;
+}
+
+BigIntVal BitmapFunctions::bitmap_finalize(FunctionContext* ctx, const StringVal& src) {
+    DCHECK(!src.is_null);
+    BitmapValue* bitmap = reinterpret_cast<BitmapValue*>(src.ptr);
+    BigIntVal result(bitmap->cardinality());
+    delete bitmap;
+    return result;
+}
+
+StringVal BitmapFunctions::to_bitmap(FunctionContext* ctx, const StringVal& src) {
+    BitmapValue bitmap;
+    if (!src.is_null) {
+        StringParser::ParseResult parse_result = StringParser::PARSE_SUCCESS;
+        int64_t value = StringParser::string_to_int<int64_t>(
+            reinterpret_cast<const char*>(src.ptr), src.len, &parse_result);
+        if (parse_result != StringParser::PARSE_SUCCESS || value < 0
+                || value > std::numeric_limits<uint32_t>::max()) {
+            ctx->set_error("to_bitmap only supports integers in [0, 4294967295]");
+            return StringVal::null();
+        }
+        bitmap.add(static_cast<uint32_t>(value));
+    }
+    return serialize(ctx, &bitmap);
+}
+
+StringVal BitmapFunctions::bitmap_and(FunctionContext* ctx, const StringVal& lhs,
+                                      const StringVal& rhs) {
+    if (lhs.is_null || rhs.is_null) {
+        return StringVal::null();
+    }
+    BitmapValue bitmap;
+    BitmapValue rhs_bitmap;
+    if (!bitmap.deserialize(reinterpret_cast<const char*>(lhs.ptr), lhs.len)
+            || !rhs_bitmap.deserialize(reinterpret_cast<const char*>(rhs.ptr), rhs.len)) {
+        ctx->set_error("bitmap_and got an invalid bitmap");
+        return StringVal::null();
+    }
+    bitmap &= rhs_bitmap;
+    return serialize(ctx, &bitmap);
+}
+
+}
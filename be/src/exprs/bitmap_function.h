@@ -0,0 +1,57 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_QUERY_EXPRS_BITMAP_FUNCTION_H
+#define DORIS_BE_SRC_QUERY_EXPRS_BITMAP_FUNCTION_H
+
+#include "udf/udf.h"
+
+namespace doris {
+
+// Functions on bitmaps stored as serialized BitmapValue in VARCHAR values, e.g. in
+// BITMAP_UNION columns. They give exact distinct counts of uint32 values:
+//      select bitmap_count(uv) from t group by dt
+// where uv is a BITMAP_UNION column loaded with to_bitmap(user_id).
+class BitmapFunctions {
+public:
+    static void init();
+
+    // Aggregate functions bitmap_union and bitmap_count. The intermediate holds a
+    // pointer to a BitmapValue until it is serialized or finalized.
+    static void bitmap_init(doris_udf::FunctionContext* ctx, doris_udf::StringVal* dst);
+    // Used as update and merge, both get serialized bitmaps.
+    static void bitmap_union(doris_udf::FunctionContext* ctx, const doris_udf::StringVal& src,
+                             doris_udf::StringVal* dst);
+    static doris_udf::StringVal bitmap_serialize(doris_udf::FunctionContext* ctx,
+                                                 const doris_udf::StringVal& src);
+    static doris_udf::BigIntVal bitmap_finalize(doris_udf::FunctionContext* ctx,
+                                                const doris_udf::StringVal& src);
+
+    // Returns the bitmap of the single value 'src', which has to be an integer in
+    // [0, 4294967295]. NULL gives an empty bitmap.
+    static doris_udf::StringVal to_bitmap(doris_udf::FunctionContext* ctx,
+                                          const doris_udf::StringVal& src);
+
+    // Returns the intersection of two bitmaps.
+    static doris_udf::StringVal bitmap_and(doris_udf::FunctionContext* ctx,
+                                           const doris_udf::StringVal& lhs,
+                                           const doris_udf::StringVal& rhs);
+};
+
+}
+
+#endif
@@ -17,7 +17,9 @@
 
 #include "exprs/compound_predicate.h"
 
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include "codegen/llvm_codegen.h"
 #include "codegen/codegen_anyval.h"
@@ -84,6 +86,37 @@ BooleanVal OrPredicate::get_boolean_val(ExprContext* context, TupleRow* row) {
     return BooleanVal(false);
 }
 
+int AndPredicate::filter_batch(ExprContext* context, RowBatch* batch,
+                               int* sel, int num_rows) {
+    DCHECK_EQ(_children.size(), 2);
+    num_rows = _children[0]->filter_batch(context, batch, sel, num_rows);
+    if (num_rows == 0) {
+        return 0;
+    }
+    return _children[1]->filter_batch(context, batch, sel, num_rows);
+}
+
+int OrPredicate::filter_batch(ExprContext* context, RowBatch* batch,
+                              int* sel, int num_rows) {
+    DCHECK_EQ(_children.size(), 2);
+    std::vector<int> rows(sel, sel + num_rows);
+    int num_first = _children[0]->filter_batch(context, batch, sel, num_rows);
+    if (num_first == num_rows) {
+        return num_rows;
+    }
+    // Both lists are increasing, so the rejected rows are their difference.
+    std::vector<int> rest(num_rows - num_first);
+    std::set_difference(rows.begin(), rows.end(), sel, sel + num_first, rest.begin());
+    int num_second = _children[1]->filter_batch(
+        context, batch, &rest[0], rest.size());
+    if (num_second == 0) {
+        return num_first;
+    }
+    rows.assign(sel, sel + num_first);
+    std::merge(rows.begin(), rows.end(), rest.begin(), rest.begin() + num_second, sel);
+    return num_first + num_second;
+}
+
 BooleanVal NotPredicate::get_boolean_val(ExprContext* context, TupleRow* row) {
     BooleanVal val = _children[0]->get_boolean_val(context, row);
     if (val.is_null) {
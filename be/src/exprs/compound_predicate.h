@@ -60,6 +60,11 @@ public:
     }
     virtual doris_udf::BooleanVal get_boolean_val(ExprContext* context, TupleRow*);
 
+    // A row is selected if both children select it, so the second child only sees
+    // the rows that passed the first one.
+    virtual int filter_batch(ExprContext* context, RowBatch* batch,
+                             int* sel, int num_rows) override;
+
     virtual Status get_codegend_compute_fn(RuntimeState* state, llvm::Function** fn) {
         return CompoundPredicate::codegen_compute_fn(true, state, fn);
     }
@@ -86,6 +91,10 @@ public:
     }
     virtual doris_udf::BooleanVal get_boolean_val(ExprContext* context, TupleRow*);
 
+    // The second child only sees the rows the first one rejected.
+    virtual int filter_batch(ExprContext* context, RowBatch* batch,
+                             int* sel, int num_rows) override;
+
     virtual Status get_codegend_compute_fn(RuntimeState* state, llvm::Function** fn) {
         return CompoundPredicate::codegen_compute_fn(false, state, fn);
     }
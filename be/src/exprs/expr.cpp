@@ -17,6 +17,7 @@
 
 #include "exprs/expr.h"
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 #include <thrift/protocol/TDebugProtocol.h>
@@ -46,6 +47,7 @@
 #include "exprs/aggregate_functions.h"
 #include "gen_cpp/Exprs_types.h"
 #include "gen_cpp/Data_types.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/raw_value.h"
 #include "runtime/user_function_cache.h"
@@ -857,6 +859,40 @@ DecimalV2Val Expr::get_decimalv2_val(ExprContext* context, TupleRow* row) {
     return val;
 }
 
+#define GET_VALS_FN(TYPE, FN) \
+    void Expr::FN##s(ExprContext* context, RowBatch* batch, \
+                     const int* sel, int num_rows, TYPE* vals) { \
+        if (is_constant()) { \
+            std::fill(vals, vals + num_rows, FN(context, NULL)); \
+            return; \
+        } \
+        for (int i = 0; i < num_rows; ++i) { \
+            vals[i] = FN(context, batch->get_row(sel[i])); \
+        } \
+    }
+
+GET_VALS_FN(TinyIntVal, get_tiny_int_val);
+GET_VALS_FN(SmallIntVal, get_small_int_val);
+GET_VALS_FN(IntVal, get_int_val);
+GET_VALS_FN(BigIntVal, get_big_int_val);
+GET_VALS_FN(FloatVal, get_float_val);
+GET_VALS_FN(DoubleVal, get_double_val);
+
+int Expr::filter_batch(ExprContext* context, RowBatch* batch, int* sel, int num_rows) {
+    if (is_constant()) {
+        BooleanVal v = get_boolean_val(context, NULL);
+        return (v.is_null || !v.val) ? 0 : num_rows;
+    }
+    int num_kept = 0;
+    for (int i = 0; i < num_rows; ++i) {
+        BooleanVal v = get_boolean_val(context, batch->get_row(sel[i]));
+        if (!v.is_null && v.val) {
+            sel[num_kept++] = sel[i];
+        }
+    }
+    return num_kept;
+}
+
 Status Expr::get_fn_context_error(ExprContext* ctx) {
     if (_fn_context_index != -1) {
         FunctionContext* fn_ctx = ctx->fn_context(_fn_context_index);
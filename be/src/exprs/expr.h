@@ -55,6 +55,7 @@ namespace doris {
 class Expr;
 class LlvmCodeGen;
 class ObjectPool;
+class RowBatch;
 class RowDescriptor;
 class RuntimeState;
 class TColumnValue;
@@ -125,6 +126,31 @@ public:
     virtual DecimalVal get_decimal_val(ExprContext* context, TupleRow*);
     virtual DecimalV2Val get_decimalv2_val(ExprContext* context, TupleRow*);
 
+    /// Batch versions of the numeric Get*Val() functions. They evaluate the expr for the
+    /// rows sel[0, num_rows) of 'batch' and store the result of row sel[i] in vals[i].
+    /// The defaults call the row at a time functions, or only once if the expr is
+    /// constant; SlotRef and the arithmetic exprs override them with one loop over the
+    /// batch per expr node.
+    virtual void get_tiny_int_vals(ExprContext* context, RowBatch* batch,
+                                   const int* sel, int num_rows, TinyIntVal* vals);
+    virtual void get_small_int_vals(ExprContext* context, RowBatch* batch,
+                                    const int* sel, int num_rows, SmallIntVal* vals);
+    virtual void get_int_vals(ExprContext* context, RowBatch* batch,
+                              const int* sel, int num_rows, IntVal* vals);
+    virtual void get_big_int_vals(ExprContext* context, RowBatch* batch,
+                                  const int* sel, int num_rows, BigIntVal* vals);
+    virtual void get_float_vals(ExprContext* context, RowBatch* batch,
+                                const int* sel, int num_rows, FloatVal* vals);
+    virtual void get_double_vals(ExprContext* context, RowBatch* batch,
+                                 const int* sel, int num_rows, DoubleVal* vals);
+
+    /// Evaluates this predicate for the rows sel[0, num_rows) of 'batch' and keeps at the
+    /// front of 'sel' only the rows for which it is true, in their original order. The
+    /// row indices in 'sel' must be increasing. Returns the number of rows kept. The
+    /// default calls get_boolean_val() for every row, or only once if the predicate is
+    /// constant.
+    virtual int filter_batch(ExprContext* context, RowBatch* batch, int* sel, int num_rows);
+
     // Get the number of digits after the decimal that should be displayed for this
     // value. Returns -1 if no scale has been specified (currently the scale is only set for
     // doubles set by RoundUpTo). get_value() must have already been called.
@@ -416,6 +416,10 @@ void ExprContext::print_value(TupleRow* row, std::stringstream* stream) {
     RawValue::print_value(get_value(row), _root->type(), _root->_output_scale, stream);
 }
 
+int ExprContext::filter_batch(RowBatch* batch, int* sel, int num_rows) {
+    return _root->filter_batch(this, batch, sel, num_rows);
+}
+
 BooleanVal ExprContext::get_boolean_val(TupleRow* row) {
     return _root->get_boolean_val(this, row);
 }
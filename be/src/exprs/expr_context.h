@@ -36,6 +36,7 @@ class Expr;
 class MemPool;
 class MemTracker;
 class RuntimeState;
+class RowBatch;
 class RowDescriptor;
 class TColumnValue;
 class TupleRow;
@@ -129,6 +130,9 @@ public:
 
     bool is_nullable();
 
+    /// Calls filter_batch() on _root, see Expr::filter_batch()
+    int filter_batch(RowBatch* batch, int* sel, int num_rows);
+
     /// Calls Get*Val on _root
     BooleanVal get_boolean_val(TupleRow* row);
     TinyIntVal get_tiny_int_val(TupleRow* row);
@@ -175,6 +179,7 @@ private:
     friend class ScalarFnCall;
     friend class InPredicate;
     friend class OlapScanNode;
+    friend class CrossJoinNode;
     friend class EsScanNode;
     friend class EsPredicate;
 
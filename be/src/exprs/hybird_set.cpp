@@ -25,16 +25,16 @@ HybirdSetBase* HybirdSetBase::create_set(PrimitiveType type) {
         return new(std::nothrow) HybirdSet<bool>();
 
     case TYPE_TINYINT:
-        return new(std::nothrow) HybirdSet<int8_t>();
+        return new(std::nothrow) IntValueSet<int8_t>();
 
     case TYPE_SMALLINT:
-        return new(std::nothrow) HybirdSet<int16_t>();
+        return new(std::nothrow) IntValueSet<int16_t>();
 
     case TYPE_INT:
-        return new(std::nothrow) HybirdSet<int32_t>();
+        return new(std::nothrow) IntValueSet<int32_t>();
 
     case TYPE_BIGINT:
-        return new(std::nothrow) HybirdSet<int64_t>();
+        return new(std::nothrow) IntValueSet<int64_t>();
 
     case TYPE_FLOAT:
         return new(std::nothrow) HybirdSet<float>();
@@ -19,7 +19,10 @@
 #define DORIS_BE_SRC_QUERY_EXPRS_HYBIRD_SET_H
 
 #include <cstring>
+#include <deque>
+#include <string>
 #include <unordered_set>
+#include <vector>
 #include "common/status.h"
 #include "common/object_pool.h"
 #include "runtime/primitive_type.h"
@@ -27,6 +30,7 @@
 #include "runtime/datetime_value.h"
 #include "runtime/decimal_value.h"
 #include "runtime/decimalv2_value.h"
+#include "util/hash_util.hpp"
 
 namespace doris {
 
@@ -133,75 +137,237 @@ private:
     ObjectPool _pool;
 };
 
-class StringValueSet : public HybirdSetBase {
+template <class T>
+class VectorIterator : public HybirdSetBase::IteratorBase {
+public:
+    VectorIterator(typename std::vector<T>::const_iterator begin,
+                   typename std::vector<T>::const_iterator end)
+        : _begin(begin),
+          _end(end) {
+    }
+    virtual ~VectorIterator() {
+    }
+    virtual bool has_next() const {
+        return !(_begin == _end);
+    }
+    virtual const void* get_value() {
+        return &*_begin;
+    }
+    virtual void next() {
+        ++_begin;
+    }
+private:
+    typename std::vector<T>::const_iterator _begin;
+    typename std::vector<T>::const_iterator _end;
+};
+
+// Set for the values of integer columns, which are what most long IN lists hold.
+// Up to MAX_ARRAY_SIZE values are looked up by comparing against all of them in a
+// loop without branches, which the compiler turns into SIMD compares. Larger sets
+// also get an open addressing hash table with linear probing over the values
+// themselves, kept at most half full. 0 marks an empty slot, so it is tracked apart.
+template <class T>
+class IntValueSet : public HybirdSetBase {
 public:
-    StringValueSet() {
+    static const int MAX_ARRAY_SIZE = 16;
+
+    IntValueSet() : _mask(0), _has_zero(false) {
     }
 
-    virtual ~StringValueSet() {
+    virtual ~IntValueSet() {
     }
 
     virtual void insert(void* data) {
-        StringValue* value = reinterpret_cast<StringValue*>(data);
-        std::string str_value(value->ptr, value->len);
-        _set.insert(str_value);
+        T value = *reinterpret_cast<T*>(data);
+        if (find_value(value)) {
+            return;
+        }
+        _values.push_back(value);
+        if (_values.size() <= MAX_ARRAY_SIZE) {
+            return;
+        }
+        if (_values.size() * 2 > _slots.size()) {
+            rebuild();
+        } else {
+            insert_slot(value);
+        }
     }
 
-    void insert(HybirdSetBase* set) {
-        StringValueSet* string_set =  reinterpret_cast<StringValueSet*>(set);
-        _set.insert(string_set->_set.begin(), string_set->_set.end());
+    virtual void insert(HybirdSetBase* set) {
+        IntValueSet<T>* int_set = reinterpret_cast<IntValueSet<T>*>(set);
+        for (T value : int_set->_values) {
+            insert(&value);
+        }
     }
 
     virtual int size() {
-        return _set.size();
+        return _values.size();
     }
+
     virtual bool find(void* data) {
-        StringValue* value = reinterpret_cast<StringValue*>(data);
-        std::string str_value(value->ptr, value->len);
-        typename std::unordered_set<std::string>::iterator it = _set.find(str_value);
+        return find_value(*reinterpret_cast<T*>(data));
+    }
 
-        if (it == _set.end()) {
-            return false;
-        } else {
-            return true;
+    bool find_value(T value) const {
+        if (_slots.empty()) {
+            bool found = false;
+            for (size_t i = 0; i < _values.size(); ++i) {
+                found |= _values[i] == value;
+            }
+            return found;
+        }
+        if (value == 0) {
+            return _has_zero;
+        }
+        for (size_t i = hash(value) & _mask; ; i = (i + 1) & _mask) {
+            if (_slots[i] == value) {
+                return true;
+            }
+            if (_slots[i] == 0) {
+                return false;
+            }
         }
+    }
 
-        return false;
+    IteratorBase* begin() {
+        return _pool.add(new(std::nothrow) VectorIterator<T>(_values.begin(), _values.end()));
     }
 
-    class Iterator : public IteratorBase {
-    public:
-        Iterator(std::unordered_set<std::string>::iterator begin,
-                 std::unordered_set<std::string>::iterator end)
-            : _begin(begin),
-              _end(end) {
+private:
+    static size_t hash(T value) {
+        uint64_t h = static_cast<uint64_t>(value) * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 32);
+    }
+
+    void rebuild() {
+        size_t num_slots = 1;
+        while (num_slots < _values.size() * 4) {
+            num_slots <<= 1;
         }
-        virtual ~Iterator() {
+        _slots.assign(num_slots, 0);
+        _mask = num_slots - 1;
+        _has_zero = false;
+        for (T value : _values) {
+            insert_slot(value);
         }
-        virtual bool has_next() const {
-            return !(_begin == _end);
+    }
+
+    void insert_slot(T value) {
+        if (value == 0) {
+            _has_zero = true;
+            return;
         }
-        virtual const void* get_value() {
-            _value.ptr = const_cast<char*>(_begin->data());
-            _value.len = _begin->length();
-            return &_value;
+        size_t i = hash(value) & _mask;
+        while (_slots[i] != 0) {
+            i = (i + 1) & _mask;
         }
-        virtual void next() {
-            ++_begin;
+        _slots[i] = value;
+    }
+
+    // all values of the set, in insertion order
+    std::vector<T> _values;
+    std::vector<T> _slots;
+    size_t _mask;
+    bool _has_zero;
+    ObjectPool _pool;
+};
+
+// Set of strings hashed into an open addressing table with linear probing. Each slot
+// caches the hash of its string, so a probe only compares the bytes of strings with
+// the same hash, and nothing is copied to look a value up.
+class StringValueSet : public HybirdSetBase {
+public:
+    StringValueSet() : _mask(0) {
+    }
+
+    virtual ~StringValueSet() {
+    }
+
+    virtual void insert(void* data) {
+        StringValue* value = reinterpret_cast<StringValue*>(data);
+        uint32_t hash_value = hash(*value);
+        if (find_value(*value, hash_value)) {
+            return;
         }
-    private:
-        typename std::unordered_set<std::string>::iterator _begin;
-        typename std::unordered_set<std::string>::iterator _end;
-        StringValue _value;
-    };
+        _strings.emplace_back(value->ptr, value->len);
+        _values.push_back(StringValue(_strings.back()));
+        if (_values.size() * 2 > _slots.size()) {
+            rebuild();
+        } else {
+            insert_slot(hash_value, _values.size() - 1);
+        }
+    }
+
+    void insert(HybirdSetBase* set) {
+        StringValueSet* string_set = reinterpret_cast<StringValueSet*>(set);
+        for (StringValue value : string_set->_values) {
+            insert(&value);
+        }
+    }
+
+    virtual int size() {
+        return _values.size();
+    }
+
+    virtual bool find(void* data) {
+        StringValue* value = reinterpret_cast<StringValue*>(data);
+        return find_value(*value, hash(*value));
+    }
 
     IteratorBase* begin() {
-        return _pool.add(new(std::nothrow) Iterator(_set.begin(), _set.end()));
+        return _pool.add(new(std::nothrow) VectorIterator<StringValue>(
+                _values.begin(), _values.end()));
     }
 
 private:
+    struct Slot {
+        uint32_t hash;
+        // index into _values, -1 if the slot is empty
+        int32_t idx;
+    };
+
+    static uint32_t hash(const StringValue& value) {
+        return HashUtil::hash(value.ptr, value.len, 0);
+    }
+
+    bool find_value(const StringValue& value, uint32_t hash_value) const {
+        if (_slots.empty()) {
+            return false;
+        }
+        for (size_t i = hash_value & _mask; _slots[i].idx != -1; i = (i + 1) & _mask) {
+            if (_slots[i].hash == hash_value && _values[_slots[i].idx].eq(value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void rebuild() {
+        size_t num_slots = 16;
+        while (num_slots < _values.size() * 4) {
+            num_slots <<= 1;
+        }
+        _slots.assign(num_slots, Slot{0, -1});
+        _mask = num_slots - 1;
+        for (size_t i = 0; i < _values.size(); ++i) {
+            insert_slot(hash(_values[i]), i);
+        }
+    }
+
+    void insert_slot(uint32_t hash_value, int idx) {
+        size_t i = hash_value & _mask;
+        while (_slots[i].idx != -1) {
+            i = (i + 1) & _mask;
+        }
+        _slots[i] = Slot{hash_value, idx};
+    }
 
-    std::unordered_set<std::string> _set;
+    // owns the bytes of the strings; a deque never moves its elements, so the
+    // StringValues in '_values' stay valid
+    std::deque<std::string> _strings;
+    std::vector<StringValue> _values;
+    std::vector<Slot> _slots;
+    size_t _mask;
     ObjectPool _pool;
 };
 
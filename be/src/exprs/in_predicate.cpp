@@ -18,6 +18,7 @@
 #include "exprs/in_predicate.h"
 
 #include <sstream>
+#include <vector>
 
 #include "exprs/anyval_util.h"
 #include "exprs/anyval_util.h"
@@ -139,4 +140,45 @@ BooleanVal InPredicate::get_boolean_val(ExprContext* ctx, TupleRow* row) {
     return BooleanVal(_is_not_in);
 }
 
+template <typename T, typename VAL>
+int InPredicate::filter_batch_by_vals(
+        ExprContext* ctx, RowBatch* batch, int* sel, int num_rows,
+        void (Expr::*get_vals)(ExprContext*, RowBatch*, const int*, int, VAL*)) {
+    DCHECK(dynamic_cast<IntValueSet<T>*>(_hybird_set.get()) != NULL);
+    const IntValueSet<T>* set = static_cast<IntValueSet<T>*>(_hybird_set.get());
+    std::vector<VAL> vals(num_rows);
+    (_children[0]->*get_vals)(ctx, batch, sel, num_rows, &vals[0]);
+    // NOT IN is NULL rather than true for values not in the set if it holds a NULL
+    const bool keep_not_found = _is_not_in && !_null_in_set;
+    int num_kept = 0;
+    for (int i = 0; i < num_rows; ++i) {
+        bool found = set->find_value(vals[i].val);
+        sel[num_kept] = sel[i];
+        num_kept += !vals[i].is_null & (_is_not_in ? (!found & keep_not_found) : found);
+    }
+    return num_kept;
+}
+
+int InPredicate::filter_batch(ExprContext* ctx, RowBatch* batch, int* sel, int num_rows) {
+    if (num_rows == 0 || is_constant()) {
+        return Expr::filter_batch(ctx, batch, sel, num_rows);
+    }
+    switch (_children[0]->type().type) {
+    case TYPE_TINYINT:
+        return filter_batch_by_vals<int8_t>(
+            ctx, batch, sel, num_rows, &Expr::get_tiny_int_vals);
+    case TYPE_SMALLINT:
+        return filter_batch_by_vals<int16_t>(
+            ctx, batch, sel, num_rows, &Expr::get_small_int_vals);
+    case TYPE_INT:
+        return filter_batch_by_vals<int32_t>(
+            ctx, batch, sel, num_rows, &Expr::get_int_vals);
+    case TYPE_BIGINT:
+        return filter_batch_by_vals<int64_t>(
+            ctx, batch, sel, num_rows, &Expr::get_big_int_vals);
+    default:
+        return Expr::filter_batch(ctx, batch, sel, num_rows);
+    }
+}
+
 }
@@ -47,6 +47,11 @@ public:
 
     virtual BooleanVal get_boolean_val(ExprContext* context, TupleRow* row);
 
+    // For integer columns the values of the whole batch are fetched first and then
+    // looked up in the set without virtual calls.
+    virtual int filter_batch(ExprContext* context, RowBatch* batch,
+                             int* sel, int num_rows) override;
+
     virtual Status get_codegend_compute_fn(RuntimeState* state, llvm::Function** fn) override {
         return get_codegend_compute_fn_wrapper(state, fn);
     }
@@ -73,6 +78,11 @@ protected:
     virtual std::string debug_string() const;
 
 private:
+    template <typename T, typename VAL>
+    int filter_batch_by_vals(
+        ExprContext* context, RowBatch* batch, int* sel, int num_rows,
+        void (Expr::*get_vals)(ExprContext*, RowBatch*, const int*, int, VAL*));
+
     const bool _is_not_in;
     bool _is_prepare;
     bool _null_in_set;
@@ -18,6 +18,7 @@
 #include "exprs/json_functions.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 
 #include <sstream>
@@ -45,6 +46,208 @@ namespace doris {
 // json path cannot contains: ", [, ]
 static const re2::RE2 JSON_PATTERN("^([^\\\"\\[\\]]*)(?:\\[([0-9]+)\\])?");
 
+// Finds the value a json path points to by scanning the text, without building a
+// DOM of the document. Members and elements before the target are only skipped over
+// and the scan stops at the end of the target value, so only the prefix of the
+// document up to the value is looked at.
+//
+// Everything whose result depends on more than that prefix is left to the DOM walk
+// in get_json_object(): paths which look up a key in an array (the value of every
+// element is collected), escaped keys and malformed input.
+class JsonValueLocator {
+public:
+    enum Result {
+        FOUND,
+        NOT_FOUND,
+        UNSUPPORTED
+    };
+
+    JsonValueLocator(const char* begin, const char* end) : _p(begin), _end(end) { }
+
+    // 'paths' is the parsed path without the leading '$', all of it valid. Sets
+    // [*value_begin, *value_end) to the text of the value if FOUND.
+    Result locate(const std::vector<JsonPath>& paths,
+                  const char** value_begin, const char** value_end);
+
+private:
+    Result find_member(const std::string& key);
+    Result find_element(int idx);
+
+    void skip_ws() {
+        while (_p < _end && (*_p == ' ' || *_p == '\n' || *_p == '\r' || *_p == '\t')) {
+            ++_p;
+        }
+    }
+
+    // '_p' is at the opening quote, moves past the closing quote.
+    bool skip_string();
+
+    // Moves past the value starting at '_p'. Only the nesting of objects, arrays and
+    // strings is checked, which is enough to find where the value ends.
+    bool skip_value();
+
+    const char* _p;
+    const char* _end;
+};
+
+JsonValueLocator::Result JsonValueLocator::locate(
+        const std::vector<JsonPath>& paths,
+        const char** value_begin, const char** value_end) {
+    skip_ws();
+    for (size_t i = 1; i < paths.size(); ++i) {
+        if (!paths[i].key.empty()) {
+            Result res = find_member(paths[i].key);
+            if (res != FOUND) {
+                return res;
+            }
+        }
+        if (paths[i].idx != -1) {
+            Result res = find_element(paths[i].idx);
+            if (res != FOUND) {
+                return res;
+            }
+        }
+    }
+    *value_begin = _p;
+    if (!skip_value()) {
+        return UNSUPPORTED;
+    }
+    *value_end = _p;
+    return FOUND;
+}
+
+JsonValueLocator::Result JsonValueLocator::find_member(const std::string& key) {
+    if (_p >= _end || *_p == '[') {
+        // the DOM walk looks the key up in every element of an array
+        return UNSUPPORTED;
+    }
+    if (*_p != '{') {
+        return NOT_FOUND;
+    }
+    ++_p;
+    skip_ws();
+    if (_p < _end && *_p == '}') {
+        return NOT_FOUND;
+    }
+    while (_p < _end && *_p == '"') {
+        const char* name = _p + 1;
+        if (!skip_string()) {
+            return UNSUPPORTED;
+        }
+        size_t name_len = _p - 1 - name;
+        if (memchr(name, '\\', name_len) != NULL) {
+            // comparing escaped names needs them unescaped first
+            return UNSUPPORTED;
+        }
+        skip_ws();
+        if (_p >= _end || *_p != ':') {
+            return UNSUPPORTED;
+        }
+        ++_p;
+        skip_ws();
+        // the first member with the name wins, just like rapidjson's FindMember()
+        if (name_len == key.size() && memcmp(name, key.data(), name_len) == 0) {
+            return FOUND;
+        }
+        if (!skip_value()) {
+            return UNSUPPORTED;
+        }
+        skip_ws();
+        if (_p < _end && *_p == '}') {
+            return NOT_FOUND;
+        }
+        if (_p >= _end || *_p != ',') {
+            return UNSUPPORTED;
+        }
+        ++_p;
+        skip_ws();
+    }
+    return UNSUPPORTED;
+}
+
+JsonValueLocator::Result JsonValueLocator::find_element(int idx) {
+    if (_p >= _end) {
+        return UNSUPPORTED;
+    }
+    if (*_p != '[') {
+        return NOT_FOUND;
+    }
+    ++_p;
+    skip_ws();
+    if (_p < _end && *_p == ']') {
+        return NOT_FOUND;
+    }
+    for (int i = 0; i < idx; ++i) {
+        if (!skip_value()) {
+            return UNSUPPORTED;
+        }
+        skip_ws();
+        if (_p < _end && *_p == ']') {
+            return NOT_FOUND;
+        }
+        if (_p >= _end || *_p != ',') {
+            return UNSUPPORTED;
+        }
+        ++_p;
+        skip_ws();
+    }
+    return FOUND;
+}
+
+bool JsonValueLocator::skip_string() {
+    ++_p;
+    while (_p < _end) {
+        if (*_p == '"') {
+            ++_p;
+            return true;
+        }
+        _p += (*_p == '\\') ? 2 : 1;
+    }
+    return false;
+}
+
+bool JsonValueLocator::skip_value() {
+    if (_p >= _end) {
+        return false;
+    }
+    if (*_p == '"') {
+        return skip_string();
+    }
+    if (*_p == '{' || *_p == '[') {
+        int depth = 0;
+        while (_p < _end) {
+            switch (*_p) {
+            case '"':
+                if (!skip_string()) {
+                    return false;
+                }
+                continue;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0) {
+                    ++_p;
+                    return true;
+                }
+                break;
+            default:
+                break;
+            }
+            ++_p;
+        }
+        return false;
+    }
+    const char* start = _p;
+    while (_p < _end && *_p != ',' && *_p != '}' && *_p != ']'
+            && *_p != ' ' && *_p != '\n' && *_p != '\r' && *_p != '\t') {
+        ++_p;
+    }
+    return _p != start;
+}
+
 void JsonFunctions::init() {
 }
 
@@ -150,6 +353,30 @@ rapidjson::Value* JsonFunctions::get_json_object(
         }
     }
 
+    // Most paths only need the value they point to, parse just that.
+    bool all_valid = true;
+    for (int i = 1; i < (*parsed_paths).size(); i++) {
+        all_valid &= (*parsed_paths)[i].is_valid;
+    }
+    if (LIKELY(all_valid && (*parsed_paths).size() > 1)) {
+        JsonValueLocator locator(json_string.data(), json_string.data() + json_string.size());
+        const char* value_begin = NULL;
+        const char* value_end = NULL;
+        switch (locator.locate(*parsed_paths, &value_begin, &value_end)) {
+        case JsonValueLocator::FOUND:
+            document->Parse(value_begin, value_end - value_begin);
+            if (UNLIKELY(document->HasParseError())) {
+                document->SetNull();
+            }
+            return document;
+        case JsonValueLocator::NOT_FOUND:
+            document->SetNull();
+            return document;
+        case JsonValueLocator::UNSUPPORTED:
+            break;
+        }
+    }
+
     //rapidjson::Document document;
     document->Parse(json_string.c_str());
     if (UNLIKELY(document->HasParseError())) {
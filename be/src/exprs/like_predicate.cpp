@@ -50,14 +50,36 @@ static const re2::RE2 LIKE_EQUALS_RE("(((\\\\%)|(\\\\_)|([^%_]))+)");
 void LikePredicate::init() {
 }
 
+LikePredicate::LikePredicateState* LikePredicate::create_state(
+        FunctionContext* context, FunctionContext::FunctionStateScope scope) {
+    LikePredicateState* state = new LikePredicateState();
+    context->set_function_state(scope, state);
+    if (scope == FunctionContext::THREAD_LOCAL) {
+        LikePredicateState* fragment_state = reinterpret_cast<LikePredicateState*>(
+            context->get_function_state(FunctionContext::FRAGMENT_LOCAL));
+        if (fragment_state != NULL) {
+            state->copy_from(*fragment_state);
+            return NULL;
+        }
+    }
+    return state;
+}
+
+void LikePredicate::close_state(
+        FunctionContext* context, FunctionContext::FunctionStateScope scope) {
+    LikePredicateState* state = reinterpret_cast<LikePredicateState*>(
+        context->get_function_state(scope));
+    delete state;
+    context->set_function_state(scope, NULL);
+}
+
 void LikePredicate::like_prepare(
         FunctionContext* context, FunctionContext::FunctionStateScope scope) {
-    if (scope != FunctionContext::THREAD_LOCAL) {
+    LikePredicateState* state = create_state(context, scope);
+    if (state == NULL) {
         return;
     }
-    LikePredicateState* state = new LikePredicateState();
     state->function = like_fn;
-    context->set_function_state(scope, state);
     if (context->is_arg_constant(1)) {
         StringVal pattern_val = *reinterpret_cast<StringVal*>(context->get_constant_arg(1));
         if (pattern_val.is_null) {
@@ -66,6 +88,9 @@ void LikePredicate::like_prepare(
         StringValue pattern = StringValue::from_string_val(pattern_val);
         std::string pattern_str(pattern.ptr, pattern.len);
         std::string search_string;
+        std::vector<std::string> literals;
+        bool starts_with_literal = false;
+        bool ends_with_literal = false;
         if (RE2::FullMatch(pattern_str, LIKE_ENDS_WITH_RE, &search_string)) {
             remove_escape_character(&search_string);
             state->set_search_string(search_string);
@@ -82,10 +107,14 @@ void LikePredicate::like_prepare(
             remove_escape_character(&search_string);
             state->set_search_string(search_string);
             state->function = constant_starts_with_fn;
+        } else if (split_like_pattern(pattern_str, state->escape_char, &literals,
+                                      &starts_with_literal, &ends_with_literal)) {
+            state->set_literals(literals, starts_with_literal, ends_with_literal);
+            state->function = constant_literals_fn;
         } else {
             std::string re_pattern;
             convert_like_pattern(
-                context,
+                state->escape_char,
                 *reinterpret_cast<StringVal*>(context->get_constant_arg(1)), 
                 &re_pattern);
             RE2::Options opts;
@@ -111,21 +140,16 @@ BooleanVal LikePredicate::like(
 void LikePredicate::like_close(
         FunctionContext* context,
         FunctionContext::FunctionStateScope scope) {
-    if (scope == FunctionContext::THREAD_LOCAL) {
-        LikePredicateState* state = reinterpret_cast<LikePredicateState*>(
-            context->get_function_state(FunctionContext::THREAD_LOCAL));
-        delete state;
-    }
+    close_state(context, scope);
 }
 
 void LikePredicate::regex_prepare(
         FunctionContext* context,
         FunctionContext::FunctionStateScope scope) {
-    if (scope != FunctionContext::THREAD_LOCAL) {
+    LikePredicateState* state = create_state(context, scope);
+    if (state == NULL) {
         return;
     }
-    LikePredicateState* state = new LikePredicateState();
-    context->set_function_state(scope, state);
     state->function = regex_fn;
     if (context->is_arg_constant(1)) {
         StringVal* pattern = reinterpret_cast<StringVal*>(context->get_constant_arg(1));
@@ -178,11 +202,10 @@ BooleanVal LikePredicate::regex(
 // function. For the 2 parameter version, the RegexPrepare() function is used to prepare.
 void LikePredicate::regexp_like_prepare(
         FunctionContext* context, FunctionContext::FunctionStateScope scope) {
-    if (scope != FunctionContext::THREAD_LOCAL) {
+    LikePredicateState* state = create_state(context, scope);
+    if (state == NULL) {
         return;
     }
-    LikePredicateState* state = new LikePredicateState();
-    context->set_function_state(scope, state);
     // If both the pattern and the match parameter are constant, we pre-compile the
     // regular expression once here. Otherwise, the RE is compiled per row in RegexpLike()
     if (context->is_arg_constant(1) && context->is_arg_constant(2)) {
@@ -252,11 +275,7 @@ BooleanVal LikePredicate::regexp_like(
 
 void LikePredicate::regex_close(
         FunctionContext* context, FunctionContext::FunctionStateScope scope) {
-    if (scope == FunctionContext::THREAD_LOCAL) {
-        LikePredicateState* state = reinterpret_cast<LikePredicateState*>(
-            context->get_function_state(FunctionContext::THREAD_LOCAL));
-        delete state;
-    }
+    close_state(context, scope);
 }
 
 BooleanVal LikePredicate::regex_fn(
@@ -327,6 +346,44 @@ BooleanVal LikePredicate::constant_equals_fn(
     return BooleanVal(state->search_string_sv.eq(StringValue::from_string_val(val)));
 }
 
+BooleanVal LikePredicate::constant_literals_fn(
+        FunctionContext* context, const StringVal& val, const StringVal& pattern) {
+    if (val.is_null) {
+        return BooleanVal::null();
+    }
+    LikePredicateState* state = reinterpret_cast<LikePredicateState*>(
+        context->get_function_state(FunctionContext::THREAD_LOCAL));
+    char* ptr = reinterpret_cast<char*>(val.ptr);
+    int len = val.len;
+    int first = 0;
+    int last = state->literals.size();
+    if (state->starts_with_literal) {
+        const StringValue& prefix = state->literal_svs[first++];
+        if (len < prefix.len || memcmp(ptr, prefix.ptr, prefix.len) != 0) {
+            return BooleanVal(false);
+        }
+        ptr += prefix.len;
+        len -= prefix.len;
+    }
+    if (state->ends_with_literal) {
+        const StringValue& suffix = state->literal_svs[--last];
+        if (len < suffix.len || memcmp(ptr + len - suffix.len, suffix.ptr, suffix.len) != 0) {
+            return BooleanVal(false);
+        }
+        len -= suffix.len;
+    }
+    for (int i = first; i < last; ++i) {
+        StringValue rest(ptr, len);
+        int pos = state->literal_patterns[i].search(&rest);
+        if (pos == -1) {
+            return BooleanVal(false);
+        }
+        ptr += pos + state->literal_svs[i].len;
+        len -= pos + state->literal_svs[i].len;
+    }
+    return BooleanVal(true);
+}
+
 BooleanVal LikePredicate::constant_regex_fn_partial(
         FunctionContext* context, const StringVal& val, const StringVal& pattern) {
     if (val.is_null) {
@@ -373,7 +430,9 @@ BooleanVal LikePredicate::regex_match(
         opts.set_never_nl(false);
         opts.set_dot_nl(true);
         if (is_like_pattern) {
-            convert_like_pattern(context, pattern_value, &re_pattern);
+            LikePredicateState* state = reinterpret_cast<LikePredicateState*>(
+                context->get_function_state(FunctionContext::THREAD_LOCAL));
+            convert_like_pattern(state->escape_char, pattern_value, &re_pattern);
         } else {
             re_pattern =
                 std::string(reinterpret_cast<const char*>(pattern_value.ptr), pattern_value.len);
@@ -395,12 +454,10 @@ BooleanVal LikePredicate::regex_match(
 }
 
 void LikePredicate::convert_like_pattern(
-        FunctionContext* context, 
+        char escape_char,
         const StringVal& pattern,
         std::string* re_pattern) {
     re_pattern->clear();
-    LikePredicateState* state = reinterpret_cast<LikePredicateState*>(
-        context->get_function_state(FunctionContext::THREAD_LOCAL));
     bool is_escaped = false;
     for (int i = 0; i < pattern.len; ++i) {
         if (!is_escaped && pattern.ptr[i] == '%') {
@@ -408,7 +465,7 @@ void LikePredicate::convert_like_pattern(
         } else if (!is_escaped && pattern.ptr[i] == '_') {
             re_pattern->append(".");
             // check for escape char before checking for regex special chars, they might overlap
-        } else if (!is_escaped && pattern.ptr[i] == state->escape_char) {
+        } else if (!is_escaped && pattern.ptr[i] == escape_char) {
             is_escaped = true;
         } else if (
             pattern.ptr[i] == '.'
@@ -455,4 +512,46 @@ void LikePredicate::remove_escape_character(std::string* search_string) {
     }
 }
 
+bool LikePredicate::split_like_pattern(
+        const std::string& pattern, char escape_char,
+        std::vector<std::string>* literals, bool* starts_with_literal,
+        bool* ends_with_literal) {
+    literals->clear();
+    std::string literal;
+    bool is_escaped = false;
+    bool has_wildcard = false;
+    bool after_wildcard = false;
+    *starts_with_literal = true;
+    for (int i = 0; i < pattern.length(); ++i) {
+        char c = pattern[i];
+        if (!is_escaped && c == '_') {
+            return false;
+        } else if (!is_escaped && c == '%') {
+            if (i == 0) {
+                *starts_with_literal = false;
+            }
+            if (!literal.empty()) {
+                literals->push_back(literal);
+                literal.clear();
+            }
+            has_wildcard = true;
+            after_wildcard = true;
+        } else if (!is_escaped && c == escape_char) {
+            is_escaped = true;
+        } else {
+            literal.append(1, c);
+            is_escaped = false;
+            after_wildcard = false;
+        }
+    }
+    if (is_escaped || !has_wildcard) {
+        return false;
+    }
+    if (!literal.empty()) {
+        literals->push_back(literal);
+    }
+    *ends_with_literal = !after_wildcard;
+    return true;
+}
+
 }
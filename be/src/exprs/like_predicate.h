@@ -20,6 +20,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include <re2/re2.h>
 
 #include "exprs/predicate.h"
@@ -63,10 +64,24 @@ private:
         /// in the value.
         StringSearch substring_pattern;
 
+        /// Used for LIKE predicates if the pattern is a constant argument whose only
+        /// wildcards are '%', like 'abc%xyz' or '%a%b%'. These are the strings between
+        /// the '%', which have to be found in the value in this order. The first one has
+        /// to be at the start of the value if the pattern does not start with '%', the
+        /// last one at the end if it does not end with '%'.
+        std::vector<std::string> literals;
+        std::vector<StringValue> literal_svs;
+        std::vector<StringSearch> literal_patterns;
+        bool starts_with_literal;
+        bool ends_with_literal;
+
         /// Used for RLIKE and REGEXP predicates if the pattern is a constant argument.
-        std::unique_ptr<re2::RE2> regex;
+        /// RE2 can match from many threads at once, so this is compiled once in the
+        /// FRAGMENT_LOCAL state and shared by the THREAD_LOCAL states of all clones.
+        std::shared_ptr<re2::RE2> regex;
 
-        LikePredicateState() : escape_char('\\') {
+        LikePredicateState() : escape_char('\\'), function(NULL),
+                starts_with_literal(false), ends_with_literal(false) {
         }
 
         void set_search_string(const std::string& search_string_arg) {
@@ -74,6 +89,30 @@ private:
             search_string_sv = StringValue(search_string);
             substring_pattern = StringSearch(&search_string_sv);
         }
+
+        void set_literals(const std::vector<std::string>& literals_arg,
+                          bool starts_with_literal_arg, bool ends_with_literal_arg) {
+            literals = literals_arg;
+            literal_svs.clear();
+            literal_patterns.clear();
+            for (const std::string& literal : literals) {
+                literal_svs.push_back(StringValue(literal));
+            }
+            for (const StringValue& literal_sv : literal_svs) {
+                literal_patterns.push_back(StringSearch(&literal_sv));
+            }
+            starts_with_literal = starts_with_literal_arg;
+            ends_with_literal = ends_with_literal_arg;
+        }
+
+        /// Makes this a copy of the FRAGMENT_LOCAL state 'other', sharing its regex.
+        void copy_from(const LikePredicateState& other) {
+            escape_char = other.escape_char;
+            function = other.function;
+            set_search_string(other.search_string);
+            set_literals(other.literals, other.starts_with_literal, other.ends_with_literal);
+            regex = other.regex;
+        }
     };
 
     friend class OpcodeRegistry;
@@ -116,6 +155,17 @@ private:
         doris_udf::FunctionContext*,
         doris_udf::FunctionContext::FunctionStateScope scope);
 
+    /// Creates the state of 'scope'. The THREAD_LOCAL state is copied from the
+    /// FRAGMENT_LOCAL one if there is one. Returns NULL in that case, otherwise the
+    /// new state that still has to be set up from the constant arguments.
+    static LikePredicateState* create_state(
+        doris_udf::FunctionContext* context,
+        doris_udf::FunctionContext::FunctionStateScope scope);
+
+    static void close_state(
+        doris_udf::FunctionContext* context,
+        doris_udf::FunctionContext::FunctionStateScope scope);
+
     static doris_udf::BooleanVal regex_fn(
         doris_udf::FunctionContext* context,
         const doris_udf::StringVal& val,
@@ -150,6 +200,12 @@ private:
         const doris_udf::StringVal& val,
         const doris_udf::StringVal& pattern);
 
+    /// Handling of like predicates that are a sequence of literals separated by '%'
+    static doris_udf::BooleanVal constant_literals_fn(
+        doris_udf::FunctionContext* context,
+        const doris_udf::StringVal& val,
+        const doris_udf::StringVal& pattern);
+
     static doris_udf::BooleanVal constant_regex_fn_partial(
         doris_udf::FunctionContext* context, const doris_udf::StringVal& val,
         const doris_udf::StringVal& pattern);
@@ -166,11 +222,18 @@ private:
     /// Convert a LIKE pattern (with embedded % and _) into the corresponding
     /// regular expression pattern. Escaped chars are copied verbatim.
     static void convert_like_pattern(
-        doris_udf::FunctionContext* context,
+        char escape_char,
         const doris_udf::StringVal& pattern,
         std::string* re_pattern);
 
     static void remove_escape_character(std::string* search_string);
+
+    /// Splits a LIKE pattern into the literals between its '%'. Returns false if the
+    /// pattern has no '%', has a '_' wildcard or ends in the escape char.
+    static bool split_like_pattern(
+        const std::string& pattern, char escape_char,
+        std::vector<std::string>* literals, bool* starts_with_literal,
+        bool* ends_with_literal);
 };
 
 }
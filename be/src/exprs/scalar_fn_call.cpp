@@ -26,6 +26,7 @@
 #include "exprs/anyval_util.h"
 #include "exprs/expr_context.h"
 #include "runtime/user_function_cache.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "udf/udf_internal.h"
 #include "util/debug_util.h"
@@ -44,7 +45,8 @@ ScalarFnCall::ScalarFnCall(const TExprNode& node) :
         _scalar_fn_wrapper(NULL),
         _prepare_fn(NULL),
         _close_fn(NULL),
-        _scalar_fn(NULL) {
+        _scalar_fn(NULL),
+        _batch_fn(NULL) {
     DCHECK_NE(_fn.binary_type, TFunctionBinaryType::HIVE);
 }
 
@@ -155,6 +157,25 @@ Status ScalarFnCall::prepare(
         codegen->AddFunctionToJit(ir_udf_wrapper, &_scalar_fn_wrapper);
     }
 #endif
+    RETURN_IF_ERROR(status);
+
+    // Batch versions are only called by the batch Get*Vals() of numeric types. A UDF
+    // without one is still evaluated row by row.
+    bool numeric_ret = _type.type == TYPE_TINYINT || _type.type == TYPE_SMALLINT
+            || _type.type == TYPE_INT || _type.type == TYPE_BIGINT
+            || _type.type == TYPE_FLOAT || _type.type == TYPE_DOUBLE;
+    if (_fn.binary_type != TFunctionBinaryType::BUILTIN && numeric_ret
+            && _vararg_start_idx == -1) {
+        std::string batch_symbol = SymbolsUtil::mangle_batch_function(
+            SymbolsUtil::demangle_no_args(_fn.scalar_fn.symbol) + "_batch");
+        Status batch_status = UserFunctionCache::instance()->get_function_ptr(
+            _fn.id, batch_symbol, _fn.hdfs_location, _fn.checksum,
+            reinterpret_cast<void**>(&_batch_fn), &_cache_entry, true);
+        if (!batch_status.ok()) {
+            _batch_fn = NULL;
+        }
+    }
+
     if (_fn.scalar_fn.__isset.prepare_fn_symbol) {
         RETURN_IF_ERROR(get_function(state, _fn.scalar_fn.prepare_fn_symbol,
                                     reinterpret_cast<void**>(&_prepare_fn)));
@@ -580,6 +601,77 @@ void ScalarFnCall::evaluate_children(
     }
 }
 
+void ScalarFnCall::get_child_vals(ExprContext* context, int child_idx, RowBatch* batch,
+                                  const int* sel, int num_rows, std::vector<uint8_t>* buf) {
+    Expr* child = _children[child_idx];
+    const TypeDescriptor& type = child->type();
+    int val_size = AnyValUtil::any_val_size(type);
+    buf->resize(num_rows * val_size);
+    uint8_t* data = buf->data();
+    switch (type.type) {
+    case TYPE_TINYINT:
+        child->get_tiny_int_vals(context, batch, sel, num_rows,
+                                 reinterpret_cast<TinyIntVal*>(data));
+        break;
+    case TYPE_SMALLINT:
+        child->get_small_int_vals(context, batch, sel, num_rows,
+                                  reinterpret_cast<SmallIntVal*>(data));
+        break;
+    case TYPE_INT:
+        child->get_int_vals(context, batch, sel, num_rows, reinterpret_cast<IntVal*>(data));
+        break;
+    case TYPE_BIGINT:
+        child->get_big_int_vals(context, batch, sel, num_rows,
+                                reinterpret_cast<BigIntVal*>(data));
+        break;
+    case TYPE_FLOAT:
+        child->get_float_vals(context, batch, sel, num_rows, reinterpret_cast<FloatVal*>(data));
+        break;
+    case TYPE_DOUBLE:
+        child->get_double_vals(context, batch, sel, num_rows,
+                               reinterpret_cast<DoubleVal*>(data));
+        break;
+    default:
+        for (int i = 0; i < num_rows; ++i) {
+            void* slot = context->get_value(child, batch->get_row(sel[i]));
+            AnyValUtil::set_any_val(slot, type, reinterpret_cast<AnyVal*>(data + i * val_size));
+        }
+        break;
+    }
+}
+
+void ScalarFnCall::call_batch_fn(ExprContext* context, RowBatch* batch,
+                                 const int* sel, int num_rows, AnyVal* vals) {
+    DCHECK(_batch_fn != NULL);
+    if (num_rows == 0) {
+        return;
+    }
+    std::vector<std::vector<uint8_t>> bufs(_children.size());
+    std::vector<const AnyVal*> args(_children.size());
+    for (int i = 0; i < _children.size(); ++i) {
+        get_child_vals(context, i, batch, sel, num_rows, &bufs[i]);
+        args[i] = reinterpret_cast<const AnyVal*>(bufs[i].data());
+    }
+    _batch_fn(context->fn_context(_fn_context_index), num_rows, args.data(), vals);
+}
+
+#define SCALAR_FN_CALL_GET_VALS_FN(TYPE, FN) \
+    void ScalarFnCall::FN(ExprContext* context, RowBatch* batch, \
+                          const int* sel, int num_rows, TYPE* vals) { \
+        if (_batch_fn == NULL || is_constant()) { \
+            Expr::FN(context, batch, sel, num_rows, vals); \
+            return; \
+        } \
+        call_batch_fn(context, batch, sel, num_rows, vals); \
+    }
+
+SCALAR_FN_CALL_GET_VALS_FN(TinyIntVal, get_tiny_int_vals);
+SCALAR_FN_CALL_GET_VALS_FN(SmallIntVal, get_small_int_vals);
+SCALAR_FN_CALL_GET_VALS_FN(IntVal, get_int_vals);
+SCALAR_FN_CALL_GET_VALS_FN(BigIntVal, get_big_int_vals);
+SCALAR_FN_CALL_GET_VALS_FN(FloatVal, get_float_vals);
+SCALAR_FN_CALL_GET_VALS_FN(DoubleVal, get_double_vals);
+
 template<typename RETURN_TYPE>
 RETURN_TYPE ScalarFnCall::interpret_eval(ExprContext* context, TupleRow* row) {
     DCHECK(_scalar_fn != NULL);
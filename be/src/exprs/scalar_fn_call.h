@@ -19,6 +19,7 @@
 #define DORIS_BE_SRC_QUERY_EXPRS_SCALAR_FN_CALL_H
 
 #include <string>
+#include <vector>
 
 #include "common/object_pool.h"
 #include "exprs/expr.h"
@@ -82,6 +83,20 @@ protected:
     virtual doris_udf::DecimalV2Val get_decimalv2_val(ExprContext* context, TupleRow*);
     // virtual doris_udf::ArrayVal GetArrayVal(ExprContext* context, TupleRow*);
 
+    /// Call the UDF's batch version once for the rows if it has one, see UdfBatch.
+    virtual void get_tiny_int_vals(ExprContext* context, RowBatch* batch,
+                                   const int* sel, int num_rows, doris_udf::TinyIntVal* vals);
+    virtual void get_small_int_vals(ExprContext* context, RowBatch* batch,
+                                    const int* sel, int num_rows, doris_udf::SmallIntVal* vals);
+    virtual void get_int_vals(ExprContext* context, RowBatch* batch,
+                              const int* sel, int num_rows, doris_udf::IntVal* vals);
+    virtual void get_big_int_vals(ExprContext* context, RowBatch* batch,
+                                  const int* sel, int num_rows, doris_udf::BigIntVal* vals);
+    virtual void get_float_vals(ExprContext* context, RowBatch* batch,
+                                const int* sel, int num_rows, doris_udf::FloatVal* vals);
+    virtual void get_double_vals(ExprContext* context, RowBatch* batch,
+                                 const int* sel, int num_rows, doris_udf::DoubleVal* vals);
+
 private:
     /// If this function has var args, children()[_vararg_start_idx] is the first vararg
     /// argument.
@@ -106,6 +121,9 @@ private:
     /// scalar function.
     void* _scalar_fn;
 
+    /// Batch version of the UDF, if it has one and it can be used. See UdfBatch.
+    UdfBatch _batch_fn;
+
     /// Returns the number of non-vararg arguments
     int num_fixed_args() const {
         return _vararg_start_idx >= 0 ? _vararg_start_idx : _children.size();
@@ -124,6 +142,15 @@ private:
     void evaluate_children(ExprContext* context, TupleRow* row,
                           std::vector<doris_udf::AnyVal*>* input_vals);
 
+    /// Evaluates child 'child_idx' for the rows sel[0, num_rows) and stores the results
+    /// in 'buf' as num_rows *Vals of the child's type.
+    void get_child_vals(ExprContext* context, int child_idx, RowBatch* batch,
+                        const int* sel, int num_rows, std::vector<uint8_t>* buf);
+
+    /// Calls _batch_fn for the rows sel[0, num_rows) and stores the results in vals.
+    void call_batch_fn(ExprContext* context, RowBatch* batch,
+                       const int* sel, int num_rows, doris_udf::AnyVal* vals);
+
     /// Function to call _scalar_fn. Used in the interpreted path.
     template<typename RETURN_TYPE>
     RETURN_TYPE interpret_eval(ExprContext* context, TupleRow* row);
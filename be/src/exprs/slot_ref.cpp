@@ -22,6 +22,7 @@
 #include "codegen/codegen_anyval.h"
 #include "codegen/llvm_codegen.h"
 #include "gen_cpp/Exprs_types.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/types.h"
 
@@ -531,4 +532,30 @@ DecimalV2Val SlotRef::get_decimalv2_val(ExprContext* context, TupleRow* row) {
     return DecimalV2Val(reinterpret_cast<PackedInt128*>(t->get_slot(_slot_offset))->value);
 }
 
+template <typename T, typename VAL>
+void SlotRef::get_slot_vals(RowBatch* batch, const int* sel, int num_rows, VAL* vals) {
+    for (int i = 0; i < num_rows; ++i) {
+        Tuple* t = batch->get_row(sel[i])->get_tuple(_tuple_idx);
+        if (t == NULL || t->is_null(_null_indicator_offset)) {
+            vals[i] = VAL::null();
+        } else {
+            vals[i] = VAL(*reinterpret_cast<T*>(t->get_slot(_slot_offset)));
+        }
+    }
+}
+
+#define SLOT_REF_GET_VALS_FN(VAL, FN, T, TYPE) \
+    void SlotRef::FN(ExprContext* context, RowBatch* batch, \
+                     const int* sel, int num_rows, VAL* vals) { \
+        DCHECK_EQ(_type.type, TYPE); \
+        get_slot_vals<T>(batch, sel, num_rows, vals); \
+    }
+
+SLOT_REF_GET_VALS_FN(TinyIntVal, get_tiny_int_vals, int8_t, TYPE_TINYINT);
+SLOT_REF_GET_VALS_FN(SmallIntVal, get_small_int_vals, int16_t, TYPE_SMALLINT);
+SLOT_REF_GET_VALS_FN(IntVal, get_int_vals, int32_t, TYPE_INT);
+SLOT_REF_GET_VALS_FN(BigIntVal, get_big_int_vals, int64_t, TYPE_BIGINT);
+SLOT_REF_GET_VALS_FN(FloatVal, get_float_vals, float, TYPE_FLOAT);
+SLOT_REF_GET_VALS_FN(DoubleVal, get_double_vals, double, TYPE_DOUBLE);
+
 }
@@ -65,6 +65,14 @@ public:
     inline NullIndicatorOffset null_indicator_offset() const {
         return _null_indicator_offset;
     }
+    // Index of the referenced tuple within the row, valid after prepare().
+    int tuple_idx() const {
+        return _tuple_idx;
+    }
+    // Offset of the referenced slot within the tuple, valid after prepare().
+    int slot_offset() const {
+        return _slot_offset;
+    }
     virtual Status get_codegend_compute_fn(RuntimeState* state, llvm::Function** fn) override;
 
     virtual doris_udf::BooleanVal get_boolean_val(ExprContext* context, TupleRow*);
@@ -81,7 +89,24 @@ public:
     virtual doris_udf::DecimalV2Val get_decimalv2_val(ExprContext* context, TupleRow*);
     // virtual doris_udf::ArrayVal GetArrayVal(ExprContext* context, TupleRow*);
 
+    virtual void get_tiny_int_vals(ExprContext* context, RowBatch* batch,
+                                   const int* sel, int num_rows, doris_udf::TinyIntVal* vals);
+    virtual void get_small_int_vals(ExprContext* context, RowBatch* batch,
+                                    const int* sel, int num_rows, doris_udf::SmallIntVal* vals);
+    virtual void get_int_vals(ExprContext* context, RowBatch* batch,
+                              const int* sel, int num_rows, doris_udf::IntVal* vals);
+    virtual void get_big_int_vals(ExprContext* context, RowBatch* batch,
+                                  const int* sel, int num_rows, doris_udf::BigIntVal* vals);
+    virtual void get_float_vals(ExprContext* context, RowBatch* batch,
+                                const int* sel, int num_rows, doris_udf::FloatVal* vals);
+    virtual void get_double_vals(ExprContext* context, RowBatch* batch,
+                                 const int* sel, int num_rows, doris_udf::DoubleVal* vals);
+
 private:
+    // Gathers the slot of the rows 'sel' of 'batch', which holds a T, into 'vals'.
+    template <typename T, typename VAL>
+    void get_slot_vals(RowBatch* batch, const int* sel, int num_rows, VAL* vals);
+
     int _tuple_idx;  // within row
     int _slot_offset;  // within tuple
     NullIndicatorOffset _null_indicator_offset;  // within tuple
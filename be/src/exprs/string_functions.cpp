@@ -23,6 +23,7 @@
 #include "exprs/anyval_util.h"
 #include "runtime/string_value.hpp"
 #include "runtime/tuple_row.h"
+#include "util/simd_string_util.h"
 #include "util/url_parser.h"
 #include "math_functions.h"
 
@@ -194,6 +195,17 @@ IntVal StringFunctions::length(FunctionContext* context, const StringVal& str) {
     return IntVal(str.len);
 }
 
+// Implementation of CHAR_LENGTH
+//   int char_length(string input)
+// Returns the length in UTF-8 characters of input. If input == NULL, returns
+// NULL per MySQL
+IntVal StringFunctions::char_utf8_length(FunctionContext* context, const StringVal& str) {
+    if (str.is_null) {
+        return IntVal::null();
+    }
+    return IntVal(SimdStringUtil::utf8_length(str.ptr, str.len));
+}
+
 StringVal StringFunctions::lower(FunctionContext* context, const StringVal& str) {
     if (str.is_null) {
         return StringVal::null();
@@ -204,9 +216,7 @@ StringVal StringFunctions::lower(FunctionContext* context, const StringVal& str)
     if (UNLIKELY(result.is_null)) {
         return result;
     }
-    for (int i = 0; i < str.len; ++i) {
-        result.ptr[i] = ::tolower(str.ptr[i]);
-    }
+    SimdStringUtil::to_lower(str.ptr, str.len, result.ptr);
     return result;
 }
 
@@ -220,9 +230,7 @@ StringVal StringFunctions::upper(FunctionContext* context, const StringVal& str)
     if (UNLIKELY(result.is_null)) {
         return result;
     }
-    for (int i = 0; i < str.len; ++i) {
-        result.ptr[i] = ::toupper(str.ptr[i]);
-    }
+    SimdStringUtil::to_upper(str.ptr, str.len, result.ptr);
     return result;
 }
 
@@ -246,16 +254,11 @@ StringVal StringFunctions::trim(FunctionContext* context, const StringVal& str)
         return StringVal::null();
     }
     // Find new starting position.
-    int32_t begin = 0;
-    while (begin < str.len && str.ptr[begin] == ' ') {
-        ++begin;
-    }
+    int32_t begin = SimdStringUtil::count_leading(str.ptr, str.len, ' ');
     // Find new ending position.
-    int32_t end = str.len - 1;
-    while (end > begin && str.ptr[end] == ' ') {
-        --end;
-    }
-    return StringVal(str.ptr + begin, end - begin + 1);
+    int32_t len = str.len - begin
+        - SimdStringUtil::count_trailing(str.ptr + begin, str.len - begin, ' ');
+    return StringVal(str.ptr + begin, len);
 }
 
 StringVal StringFunctions::ltrim(FunctionContext* context, const StringVal& str) {
@@ -263,10 +266,7 @@ StringVal StringFunctions::ltrim(FunctionContext* context, const StringVal& str)
         return StringVal::null();
     }
     // Find new starting position.
-    int32_t begin = 0;
-    while (begin < str.len && str.ptr[begin] == ' ') {
-        ++begin;
-    }
+    int32_t begin = SimdStringUtil::count_leading(str.ptr, str.len, ' ');
     return StringVal(str.ptr + begin, str.len - begin);
 }
 
@@ -274,16 +274,8 @@ StringVal StringFunctions::rtrim(FunctionContext* context, const StringVal& str)
     if (str.is_null) {
         return StringVal::null();
     }
-    if (str.len == 0) {
-        return str;
-    }
     // Find new ending position.
-    int32_t end = str.len - 1;
-    while (end > 0 && str.ptr[end] == ' ') {
-        --end;
-    }
-    DCHECK_GE(end, 0);
-    return StringVal(str.ptr, (str.ptr[end] == ' ') ? end : end + 1);
+    return StringVal(str.ptr, str.len - SimdStringUtil::count_trailing(str.ptr, str.len, ' '));
 }
 
 IntVal StringFunctions::ascii(FunctionContext* context, const StringVal& str) {
@@ -391,13 +391,100 @@ DateTimeVal TimestampFunctions::timestamp(
     return val;
 }
 
+// The timezones of a timezone function resolved in prepare. Functions of the session
+// timezone only use 'from'.
+struct ResolvedTimezone {
+    ResolvedTimezone() : is_resolved(false), is_valid(false) { }
+
+    // false if the timezone is not constant and is resolved for every row
+    bool is_resolved;
+    bool is_valid;
+    TimezoneOffsets offsets;
+};
+
+struct TimezoneState {
+    ResolvedTimezone from;
+    ResolvedTimezone to;
+};
+
+static void resolve_timezone(const std::string& tz, ResolvedTimezone* resolved) {
+    resolved->is_resolved = true;
+    resolved->is_valid = TimezoneDatabase::find_timezone_offsets(tz, &resolved->offsets);
+}
+
+// Returns false if the timezone is not valid.
+static bool get_timezone(const ResolvedTimezone* resolved, const StringVal& tz,
+                         TimezoneOffsets* offsets) {
+    if (resolved != nullptr && resolved->is_resolved) {
+        *offsets = resolved->offsets;
+        return resolved->is_valid;
+    }
+    if (tz.is_null) {
+        return false;
+    }
+    return TimezoneDatabase::find_timezone_offsets(
+        std::string(reinterpret_cast<char*>(tz.ptr), tz.len), offsets);
+}
+
+static bool session_timezone(FunctionContext* context, TimezoneOffsets* offsets) {
+    TimezoneState* state = reinterpret_cast<TimezoneState*>(
+        context->get_function_state(FunctionContext::FRAGMENT_LOCAL));
+    if (state != nullptr) {
+        *offsets = state->from.offsets;
+        return state->from.is_valid;
+    }
+    return TimezoneDatabase::find_timezone_offsets(
+        context->impl()->state()->timezone(), offsets);
+}
+
+void TimestampFunctions::timezone_prepare(
+        FunctionContext* context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+    TimezoneState* state = new TimezoneState();
+    resolve_timezone(context->impl()->state()->timezone(), &state->from);
+    context->set_function_state(scope, state);
+}
+
+void TimestampFunctions::convert_tz_prepare(
+        FunctionContext* context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+    TimezoneState* state = new TimezoneState();
+    ResolvedTimezone* resolved[] = { &state->from, &state->to };
+    for (int i = 0; i < 2; ++i) {
+        if (!context->is_arg_constant(i + 1)) {
+            continue;
+        }
+        StringVal* tz = reinterpret_cast<StringVal*>(context->get_constant_arg(i + 1));
+        if (tz->is_null) {
+            resolved[i]->is_resolved = true;
+        } else {
+            resolve_timezone(std::string(reinterpret_cast<char*>(tz->ptr), tz->len),
+                             resolved[i]);
+        }
+    }
+    context->set_function_state(scope, state);
+}
+
+void TimestampFunctions::timezone_close(
+        FunctionContext* context, FunctionContext::FunctionStateScope scope) {
+    if (scope != FunctionContext::FRAGMENT_LOCAL) {
+        return;
+    }
+    delete reinterpret_cast<TimezoneState*>(context->get_function_state(scope));
+}
+
 StringVal TimestampFunctions::from_unix(
         FunctionContext* context, const IntVal& unix_time) {
     if (unix_time.is_null) {
         return StringVal::null();
     }
+    TimezoneOffsets timezone;
     DateTimeValue dtv;
-    if (!dtv.from_unixtime(unix_time.val, context->impl()->state()->timezone())) {
+    if (!session_timezone(context, &timezone) || !dtv.from_unixtime(unix_time.val, timezone)) {
         return StringVal::null();
     }
     char buf[64];
@@ -410,8 +497,9 @@ StringVal TimestampFunctions::from_unix(
     if (unix_time.is_null || fmt.is_null) {
         return StringVal::null();
     }
+    TimezoneOffsets timezone;
     DateTimeValue dtv;
-    if (!dtv.from_unixtime(unix_time.val, context->impl()->state()->timezone())) {
+    if (!session_timezone(context, &timezone) || !dtv.from_unixtime(unix_time.val, timezone)) {
         return StringVal::null();
     }
 
@@ -437,8 +525,9 @@ IntVal TimestampFunctions::to_unix(
         return IntVal::null();
     }
 
+    TimezoneOffsets timezone;
     int64_t timestamp;
-    if(!tv.unix_timestamp(&timestamp, context->impl()->state()->timezone())) {
+    if (!session_timezone(context, &timezone) || !tv.unix_timestamp(&timestamp, timezone)) {
         return IntVal::null();
     } else {
         return IntVal(timestamp);
@@ -452,8 +541,9 @@ IntVal TimestampFunctions::to_unix(
     }
     const DateTimeValue &tv = DateTimeValue::from_datetime_val(ts_val);
     
+    TimezoneOffsets timezone;
     int64_t timestamp;
-    if(!tv.unix_timestamp(&timestamp, context->impl()->state()->timezone())) {
+    if (!session_timezone(context, &timezone) || !tv.unix_timestamp(&timestamp, timezone)) {
         return IntVal::null();
     } else {
         return IntVal(timestamp);
@@ -472,9 +562,10 @@ DateTimeVal TimestampFunctions::utc_timestamp(FunctionContext* context) {
 }
 
 DateTimeVal TimestampFunctions::now(FunctionContext* context) {
+    TimezoneOffsets timezone;
     DateTimeValue dtv;
-    if (!dtv.from_unixtime(context->impl()->state()->timestamp_ms() / 1000,
-            context->impl()->state()->timezone())) {
+    if (!session_timezone(context, &timezone)
+            || !dtv.from_unixtime(context->impl()->state()->timestamp_ms() / 1000, timezone)) {
         return DateTimeVal::null();
     }
 
@@ -484,9 +575,10 @@ DateTimeVal TimestampFunctions::now(FunctionContext* context) {
 }
 
 DoubleVal TimestampFunctions::curtime(FunctionContext* context) {
+    TimezoneOffsets timezone;
     DateTimeValue dtv;
-    if (!dtv.from_unixtime(context->impl()->state()->timestamp_ms() / 1000,
-            context->impl()->state()->timezone())) {
+    if (!session_timezone(context, &timezone)
+            || !dtv.from_unixtime(context->impl()->state()->timestamp_ms() / 1000, timezone)) {
         return DoubleVal::null();
     }
 
@@ -495,18 +587,24 @@ DoubleVal TimestampFunctions::curtime(FunctionContext* context) {
 
 DateTimeVal TimestampFunctions::convert_tz(FunctionContext* ctx, const DateTimeVal& ts_val,
                                                const StringVal& from_tz, const StringVal& to_tz) {
-    if (TimezoneDatabase::find_timezone(std::string((char *)from_tz.ptr, from_tz.len)) == nullptr ||
-        TimezoneDatabase::find_timezone(std::string((char *)to_tz.ptr, to_tz.len)) == nullptr
-    ) {
+    if (ts_val.is_null) {
+        return DateTimeVal::null();
+    }
+    TimezoneState* state = reinterpret_cast<TimezoneState*>(
+        ctx->get_function_state(FunctionContext::FRAGMENT_LOCAL));
+    TimezoneOffsets from;
+    TimezoneOffsets to;
+    if (!get_timezone(state == nullptr ? nullptr : &state->from, from_tz, &from)
+            || !get_timezone(state == nullptr ? nullptr : &state->to, to_tz, &to)) {
         return DateTimeVal::null();
     }
     const DateTimeValue &ts_value = DateTimeValue::from_datetime_val(ts_val);
     int64_t timestamp;
-    if(!ts_value.unix_timestamp(&timestamp, std::string((char *)from_tz.ptr, from_tz.len))) {
+    if(!ts_value.unix_timestamp(&timestamp, from)) {
         return DateTimeVal::null();
     }
     DateTimeValue ts_value2;
-    if (!ts_value2.from_unixtime(timestamp, std::string((char *)to_tz.ptr, to_tz.len))) {
+    if (!ts_value2.from_unixtime(timestamp, to)) {
         return DateTimeVal::null();
     }
     
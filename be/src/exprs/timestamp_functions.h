@@ -162,6 +162,15 @@ public:
             const doris_udf::DateTimeVal& ts_val, const doris_udf::StringVal& from_tz,
             const doris_udf::StringVal& to_tz);
 
+    // Resolve the session timezone, or the constant timezone arguments of convert_tz,
+    // once instead of for every row. timezone_close() frees the state of both.
+    static void timezone_prepare(doris_udf::FunctionContext* context,
+                                 doris_udf::FunctionContext::FunctionStateScope scope);
+    static void convert_tz_prepare(doris_udf::FunctionContext* context,
+                                   doris_udf::FunctionContext::FunctionStateScope scope);
+    static void timezone_close(doris_udf::FunctionContext* context,
+                               doris_udf::FunctionContext::FunctionStateScope scope);
+
     // Helper function to check date/time format strings.
     // TODO: eventually return format converted from Java to Boost.
     static bool check_format(const StringVal& format, DateTimeValue& t);
@@ -16,8 +16,174 @@
 // under the License.
 #include "exprs/timezone_db.h"
 
+#include <ctype.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/compiler_util.h"
+
 namespace doris {
 boost::local_time::tz_database TimezoneDatabase::_s_tz_database;
+std::deque<TimezoneOffsets::Region> TimezoneDatabase::_s_regions;
+
+// Offsets of every region in _s_tz_database, filled by init() and read only after.
+static std::unordered_map<std::string, TimezoneOffsets> s_region_offsets;
+// Offsets of other timezones with DST rules, like "TMP+08:00DST,M3.2.0,M11.1.0",
+// resolved on first use.
+static std::mutex s_posix_offsets_lock;
+static std::unordered_map<std::string, TimezoneOffsets> s_posix_offsets;
+
+static int64_t to_epoch_seconds(const boost::posix_time::ptime& pt) {
+    static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return (pt - epoch).total_seconds();
+}
+
+// Computes the offset of 'utc' with the boost rules of 'tz'.
+static int32_t boost_offset_at(const boost::local_time::time_zone_ptr& tz, int64_t utc) {
+    boost::local_time::local_date_time lt(boost::posix_time::from_time_t(utc), tz);
+    return (lt.local_time() - lt.utc_time()).total_seconds();
+}
+
+// Returns the first second around 'approx' from which boost gives 'offset'. The rule
+// times are only a hint: boost decides on the date of the standard local time, so a
+// transition at midnight may take effect up to the DST length later.
+static int64_t find_transition(const boost::local_time::time_zone_ptr& tz,
+                               int64_t approx, int32_t offset) {
+    if (boost_offset_at(tz, approx) == offset && boost_offset_at(tz, approx - 1) != offset) {
+        return approx;
+    }
+    int64_t window = tz->dst_offset().total_seconds() * 2;
+    int64_t low = approx - window;
+    int64_t high = approx + window;
+    if (boost_offset_at(tz, low) == offset || boost_offset_at(tz, high) != offset) {
+        return approx;
+    }
+    // boost_offset_at(low) != offset && boost_offset_at(high) == offset
+    while (high - low > 1) {
+        int64_t mid = low + (high - low) / 2;
+        if (boost_offset_at(tz, mid) == offset) {
+            high = mid;
+        } else {
+            low = mid;
+        }
+    }
+    return high;
+}
+
+int32_t TimezoneOffsets::offset_at(int64_t utc) const {
+    if (_region == nullptr) {
+        return _std_offset;
+    }
+    if (UNLIKELY(utc < _region->begin_utc || utc >= _region->end_utc)) {
+        return boost_offset_at(_region->tz, utc);
+    }
+    // the first transition is begin_utc, so there is always one before 'utc'
+    size_t idx = std::upper_bound(_region->transitions.begin(), _region->transitions.end(),
+                                  utc) - _region->transitions.begin() - 1;
+    return _region->offsets[idx];
+}
+
+int64_t TimezoneOffsets::local_to_utc(int64_t local) const {
+    if (_region == nullptr) {
+        return local - _std_offset;
+    }
+    // Take 'local' as standard time first. If that instant has another offset, the
+    // time is either within DST or skipped by the start of DST; the offset at the
+    // instant this gives tells which.
+    int32_t offset = offset_at(local - _std_offset);
+    if (offset == _std_offset) {
+        return local - offset;
+    }
+    return local - offset_at(local - offset);
+}
+
+bool TimezoneDatabase::build_offsets(const boost::local_time::time_zone_ptr& tz,
+                                     TimezoneOffsets* offsets) {
+    offsets->_std_offset = tz->base_utc_offset().total_seconds();
+    offsets->_region = nullptr;
+    if (!tz->has_dst()) {
+        return false;
+    }
+    _s_regions.emplace_back();
+    TimezoneOffsets::Region* region = &_s_regions.back();
+    region->tz = tz;
+    int32_t std_offset = offsets->_std_offset;
+    int32_t dst_offset = std_offset + tz->dst_offset().total_seconds();
+    region->begin_utc = to_epoch_seconds(boost::posix_time::ptime(
+            boost::gregorian::date(TimezoneOffsets::TABLE_BEGIN_YEAR, 1, 1))) - std_offset;
+    region->end_utc = to_epoch_seconds(boost::posix_time::ptime(
+            boost::gregorian::date(TimezoneOffsets::TABLE_END_YEAR, 1, 1))) - std_offset;
+
+    std::vector<std::pair<int64_t, int32_t>> transitions;
+    transitions.emplace_back(region->begin_utc, boost_offset_at(tz, region->begin_utc));
+    for (int year = TimezoneOffsets::TABLE_BEGIN_YEAR;
+            year < TimezoneOffsets::TABLE_END_YEAR; ++year) {
+        // DST starts at a standard local time and ends at a DST local time
+        int64_t start = find_transition(
+            tz, to_epoch_seconds(tz->dst_local_start_time(year)) - std_offset, dst_offset);
+        int64_t end = find_transition(
+            tz, to_epoch_seconds(tz->dst_local_end_time(year)) - dst_offset, std_offset);
+        if (start > region->begin_utc && start < region->end_utc) {
+            transitions.emplace_back(start, dst_offset);
+        }
+        if (end > region->begin_utc && end < region->end_utc) {
+            transitions.emplace_back(end, std_offset);
+        }
+    }
+    std::sort(transitions.begin(), transitions.end());
+    for (auto& transition : transitions) {
+        region->transitions.push_back(transition.first);
+        region->offsets.push_back(transition.second);
+    }
+    offsets->_region = region;
+    return true;
+}
+
+bool TimezoneDatabase::find_timezone_offsets(const std::string& tz,
+                                             TimezoneOffsets* offsets) {
+    if (tz.find_first_of('/') != std::string::npos) {
+        auto it = s_region_offsets.find(tz);
+        if (it == s_region_offsets.end()) {
+            return false;
+        }
+        *offsets = it->second;
+        return true;
+    }
+    if (tz == "CST") {
+        offsets->_std_offset = 8 * 3600;
+        offsets->_region = nullptr;
+        return true;
+    }
+    // the common "+08:00" form
+    if (tz.size() == 6 && (tz[0] == '+' || tz[0] == '-') && isdigit(tz[1])
+            && isdigit(tz[2]) && tz[3] == ':' && isdigit(tz[4]) && isdigit(tz[5])) {
+        int32_t offset = ((tz[1] - '0') * 10 + (tz[2] - '0')) * 3600
+            + ((tz[4] - '0') * 10 + (tz[5] - '0')) * 60;
+        offsets->_std_offset = tz[0] == '-' ? -offset : offset;
+        offsets->_region = nullptr;
+        return true;
+    }
+    boost::local_time::time_zone_ptr tzp = find_timezone(tz);
+    if (tzp == nullptr) {
+        return false;
+    }
+    if (!tzp->has_dst()) {
+        offsets->_std_offset = tzp->base_utc_offset().total_seconds();
+        offsets->_region = nullptr;
+        return true;
+    }
+    std::lock_guard<std::mutex> l(s_posix_offsets_lock);
+    auto it = s_posix_offsets.find(tz);
+    if (it == s_posix_offsets.end()) {
+        build_offsets(tzp, offsets);
+        s_posix_offsets.emplace(tz, *offsets);
+    } else {
+        *offsets = it->second;
+    }
+    return true;
+}
 void TimezoneDatabase::init() {
     // Create a temporary file and write the timezone information.  The boost
     // interface only loads this format from a file.  We don't want to raise
@@ -51,6 +217,15 @@ void TimezoneDatabase::init() {
     _s_tz_database.load_from_file(std::string(filestr));
     unlink(filestr);
     close(fd);
+
+    if (!s_region_offsets.empty()) {
+        return;
+    }
+    for (auto& region : _s_tz_database.region_list()) {
+        TimezoneOffsets offsets;
+        build_offsets(_s_tz_database.time_zone_from_region(region), &offsets);
+        s_region_offsets.emplace(region, offsets);
+    }
 }
 
 boost::local_time::time_zone_ptr TimezoneDatabase::find_timezone(const std::string &tz) {
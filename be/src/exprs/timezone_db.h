@@ -21,7 +21,10 @@
 #include <stdint.h>
 #include <iostream>
 #include <cstddef>
+#include <deque>
 #include <sstream>
+#include <string>
+#include <vector>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/time_zone_base.hpp>
@@ -32,14 +35,69 @@
 
 namespace doris {
 
+// The UTC offsets of a timezone, precomputed from its boost rules so that converting
+// a time is a binary search over its DST transitions instead of building boost
+// local_date_times. Cheap to copy: the transitions of a region are computed once by
+// TimezoneDatabase, a fixed offset like "+08:00" only carries the offset.
+class TimezoneOffsets {
+public:
+    // The DST transitions of the years in [TABLE_BEGIN_YEAR, TABLE_END_YEAR) are
+    // precomputed, times outside of them fall back to boost.
+    static const int TABLE_BEGIN_YEAR = 1970;
+    static const int TABLE_END_YEAR = 2100;
+
+    TimezoneOffsets() : _std_offset(0), _region(nullptr) { }
+
+    // Returns the seconds local time is ahead of UTC at 'utc', in seconds since the
+    // epoch.
+    int32_t offset_at(int64_t utc) const;
+
+    int64_t utc_to_local(int64_t utc) const {
+        return utc + offset_at(utc);
+    }
+
+    // Local times which are skipped or repeated by a DST transition are taken as
+    // standard time.
+    int64_t local_to_utc(int64_t local) const;
+
+private:
+    friend class TimezoneDatabase;
+
+    struct Region {
+        boost::local_time::time_zone_ptr tz;
+        // offsets[i] applies from transitions[i] on, both cover
+        // [begin_utc, end_utc)
+        std::vector<int64_t> transitions;
+        std::vector<int32_t> offsets;
+        int64_t begin_utc;
+        int64_t end_utc;
+    };
+
+    int32_t _std_offset;
+    // NULL if the timezone has no DST
+    const Region* _region;
+};
+
 class TimezoneDatabase {
 public:
     static void init();
     static boost::local_time::time_zone_ptr find_timezone(const std::string &tz);
+
+    // Resolves 'tz' like find_timezone(). Returns false if it is not a valid
+    // timezone. Regions are looked up in the tables built by init(), so this does
+    // not allocate.
+    static bool find_timezone_offsets(const std::string& tz, TimezoneOffsets* offsets);
+
     static const std::string default_time_zone;
 private:
+    static bool build_offsets(const boost::local_time::time_zone_ptr& tz,
+                              TimezoneOffsets* offsets);
+
     static const char *_s_timezone_database_str;
     static boost::local_time::tz_database _s_tz_database;
+    // Owns the regions TimezoneOffsets point to. Only appended to, which keeps the
+    // pointers valid.
+    static std::deque<TimezoneOffsets::Region> _s_regions;
 };
 }
 #endif
@@ -258,6 +258,9 @@ void GeoFunctions::st_contains_prepare(doris_udf::FunctionContext* ctx,
                 contains_ctx->shapes[i] = GeoShape::from_encoded(str->ptr, str->len);
                 if (contains_ctx->shapes[i] == nullptr) {
                     contains_ctx->is_null = true;
+                } else if (i == 0 && contains_ctx->shapes[i]->type() == GEO_SHAPE_POLYGON) {
+                    // a constant polygon is checked against every row
+                    ((GeoPolygon*)contains_ctx->shapes[i])->prepare();
                 }
             }
         }
@@ -24,6 +24,7 @@
 #include <s2/s2latlng.h>
 #include <s2/s2cell.h>
 #include <s2/s2earth.h>
+#include <s2/s2region_coverer.h>
 #include <s2/util/coding/coder.h>
 #include <s2/util/units/length-units.h>
 
@@ -315,11 +316,40 @@ std::string GeoPolygon::as_wkt() const {
     return ss.str();
 }
 
+// max number of cells of a covering of prepared polygon, more cells make
+// coverings closer to the polygon, and take more time to search
+static const int PREPARED_POLYGON_MAX_CELLS = 256;
+
+void GeoPolygon::prepare() {
+    if (_prepared) {
+        return;
+    }
+    S2RegionCoverer::Options options;
+    options.set_max_cells(PREPARED_POLYGON_MAX_CELLS);
+    S2RegionCoverer coverer(options);
+    _covering = coverer.GetCovering(*_polygon);
+    _interior_covering = coverer.GetInteriorCovering(*_polygon);
+    _prepared = true;
+}
+
+bool GeoPolygon::_contains_point(const S2Point& point) const {
+    if (_prepared) {
+        S2CellId cell_id(point);
+        if (!_covering.Contains(cell_id)) {
+            return false;
+        }
+        if (_interior_covering.Contains(cell_id)) {
+            return true;
+        }
+    }
+    return _polygon->Contains(point);
+}
+
 bool GeoPolygon::contains(const GeoShape* rhs) const {
     switch (rhs->type()) {
     case GEO_SHAPE_POINT: {
         const GeoPoint* point = (const GeoPoint*)rhs;
-        return _polygon->Contains(point->point());
+        return _contains_point(point->point());
 #if 0
         if (_polygon->Contains(point->point())) {
             return true;
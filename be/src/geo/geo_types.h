@@ -22,6 +22,7 @@
 #include <vector>
 
 #include <s2/s2cap.h>
+#include <s2/s2cell_union.h>
 #include <s2/s2point.h>
 #include <s2/s2polyline.h>
 #include <s2/s2polygon.h>
@@ -112,6 +113,12 @@ public:
     GeoShapeType type() const override { return GEO_SHAPE_POLYGON; }
     const S2Polygon* polygon() const { return _polygon.get(); }
 
+    // Compute cell coverings of the polygon, so that most points are decided
+    // by a binary search of their cell ids, and only points in cells crossing
+    // edges of the polygon are checked exactly. It's worth for a polygon which
+    // is checked against many points, e.g. a constant one in st_contains.
+    void prepare();
+
     bool contains(const GeoShape* rhs) const override;
     std::string as_wkt() const override;
 
@@ -120,7 +127,15 @@ protected:
     bool decode(const void* data, size_t size) override;
 
 private:
+    bool _contains_point(const S2Point& point) const;
+
     std::unique_ptr<S2Polygon> _polygon;
+
+    bool _prepared = false;
+    // cells covering the polygon, points out of them are not contained
+    S2CellUnion _covering;
+    // cells contained by the polygon
+    S2CellUnion _interior_covering;
 };
 
 class GeoCircle : public GeoShape {
@@ -17,6 +17,10 @@
 
 #include "geo/wkt_parse.h"
 
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "geo/wkt_parse_ctx.h"
 #include "geo/geo_types.h"
 #include "geo/wkt_parse_type.h"
@@ -27,7 +31,149 @@
 
 namespace doris {
 
+// Hand written parser of POINT, LINESTRING and POLYGON in the same syntax as
+// wkt_yacc.y, which saves the cost of setting up flex and bison for every
+// row. Input which it doesn't understand is left to the bison parser, so that
+// error status of invalid WKT is the same as before.
+class WktFastParser {
+public:
+    WktFastParser(const char* str, size_t len) : _pos(str), _end(str + len) { }
+
+    // Return false if the input is left to the bison parser, otherwise
+    // 'status' and 'shape' are set.
+    bool parse(GeoParseStatus* status, GeoShape** shape) {
+        _skip_spaces();
+        if (_consume_keyword("POINT")) {
+            GeoCoordinate coord;
+            if (!_consume('(') || !_parse_coordinate(&coord) || !_consume(')') || !_at_end()) {
+                return false;
+            }
+            std::unique_ptr<GeoPoint> point(new GeoPoint());
+            *status = point->from_coord(coord);
+            *shape = *status == GEO_PARSE_OK ? point.release() : nullptr;
+            return true;
+        }
+        if (_consume_keyword("LINESTRING")) {
+            GeoCoordinateList coords;
+            if (!_parse_coordinate_list(&coords) || !_at_end()) {
+                return false;
+            }
+            std::unique_ptr<GeoLine> line(new GeoLine());
+            *status = line->from_coords(coords);
+            *shape = *status == GEO_PARSE_OK ? line.release() : nullptr;
+            return true;
+        }
+        if (_consume_keyword("POLYGON")) {
+            GeoCoordinateListList loops;
+            if (!_consume('(')) {
+                return false;
+            }
+            do {
+                std::unique_ptr<GeoCoordinateList> coords(new GeoCoordinateList());
+                if (!_parse_coordinate_list(coords.get())) {
+                    return false;
+                }
+                loops.add(coords.release());
+            } while (_consume(','));
+            if (!_consume(')') || !_at_end()) {
+                return false;
+            }
+            std::unique_ptr<GeoPolygon> polygon(new GeoPolygon());
+            *status = polygon->from_coords(loops);
+            *shape = *status == GEO_PARSE_OK ? polygon.release() : nullptr;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    void _skip_spaces() {
+        while (_pos < _end && (*_pos == ' ' || *_pos == '\t' || *_pos == '\n' || *_pos == '\r')) {
+            ++_pos;
+        }
+    }
+
+    bool _at_end() {
+        _skip_spaces();
+        return _pos == _end;
+    }
+
+    bool _consume(char c) {
+        _skip_spaces();
+        if (_pos < _end && *_pos == c) {
+            ++_pos;
+            return true;
+        }
+        return false;
+    }
+
+    // keywords are followed by '(' or spaces, MULTI* ones are left to bison
+    bool _consume_keyword(const char* keyword) {
+        size_t len = strlen(keyword);
+        if ((size_t)(_end - _pos) < len || memcmp(_pos, keyword, len) != 0) {
+            return false;
+        }
+        if (_pos + len < _end && isalpha(_pos[len])) {
+            return false;
+        }
+        _pos += len;
+        return true;
+    }
+
+    bool _parse_number(double* value) {
+        _skip_spaces();
+        const char* start = _pos;
+        const char* p = _pos;
+        while (p < _end && (isdigit(*p) || *p == '.' || *p == '-' || *p == '+'
+                            || *p == 'e' || *p == 'E')) {
+            ++p;
+        }
+        size_t len = p - start;
+        // numbers of lexer start with a digit, '.' or '-'
+        char buf[64];
+        if (len == 0 || len >= sizeof(buf) || *start == '+') {
+            return false;
+        }
+        memcpy(buf, start, len);
+        buf[len] = '\0';
+        char* num_end = nullptr;
+        *value = strtod(buf, &num_end);
+        if (num_end != buf + len) {
+            return false;
+        }
+        _pos = p;
+        return true;
+    }
+
+    bool _parse_coordinate(GeoCoordinate* coord) {
+        return _parse_number(&coord->x) && _parse_number(&coord->y);
+    }
+
+    bool _parse_coordinate_list(GeoCoordinateList* coords) {
+        if (!_consume('(')) {
+            return false;
+        }
+        do {
+            GeoCoordinate coord;
+            if (!_parse_coordinate(&coord)) {
+                return false;
+            }
+            coords->add(coord);
+        } while (_consume(','));
+        return _consume(')');
+    }
+
+    const char* _pos;
+    const char* _end;
+};
+
 GeoParseStatus WktParse::parse_wkt(const char* str, size_t len, GeoShape** shape) {
+    GeoParseStatus status = GEO_PARSE_OK;
+    WktFastParser fast_parser(str, len);
+    if (fast_parser.parse(&status, shape)) {
+        return status;
+    }
+
     WktParseContext ctx;
     // initialize lexer
     wkt_lex_init_extra(&ctx, &ctx.scaninfo);
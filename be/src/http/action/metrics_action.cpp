@@ -17,6 +17,7 @@
 
 #include "http/action/metrics_action.h"
 
+#include <atomic>
 #include <string>
 
 #include "http/http_request.h"
@@ -28,19 +29,35 @@
 
 namespace doris {
 
+// Metrics are appended to a string which is reserved as large as the last
+// exposition, instead of formatted by stringstream.
 class PrometheusMetricsVisitor : public MetricsVisitor {
 public:
+    PrometheusMetricsVisitor() {
+        _buf.reserve(_s_last_size.load());
+    }
     virtual ~PrometheusMetricsVisitor() {}
     void visit(const std::string& prefix, const std::string& name,
                MetricCollector* collector) override;
-    std::string to_string() const { return _ss.str(); }
+    std::string to_string() {
+        _s_last_size.store(_buf.size());
+        return std::move(_buf);
+    }
 private:
+    void _append_labels(const MetricLabels& labels, const std::string& extra_label);
     void _visit_simple_metric(
         const std::string& name, const MetricLabels& labels, SimpleMetric* metric);
+    void _visit_histogram(
+        const std::string& name, const MetricLabels& labels, IntHistogram* histogram);
+    void _visit_summary(
+        const std::string& name, const MetricLabels& labels, HdrHistogram* histogram);
 private:
-    std::stringstream _ss;
+    std::string _buf;
+    static std::atomic<size_t> _s_last_size;
 };
 
+std::atomic<size_t> PrometheusMetricsVisitor::_s_last_size{0};
+
 // eg:
 // palo_be_process_fd_num_used LONG 43
 // palo_be_process_thread_num LONG 240
@@ -83,7 +100,9 @@ void PrometheusMetricsVisitor::visit(const std::string& prefix,
         metric_name = prefix + "_" + name;
     }
     // Output metric type
-    _ss << "# TYPE " << metric_name << " " << collector->type() << "\n";
+    std::stringstream type;
+    type << collector->type();
+    _buf.append("# TYPE ").append(metric_name).append(" ").append(type.str()).append("\n");
     switch (collector->type()) {
     case MetricType::COUNTER:
     case MetricType::GAUGE:
@@ -91,27 +110,103 @@ void PrometheusMetricsVisitor::visit(const std::string& prefix,
             _visit_simple_metric(metric_name, it.first, (SimpleMetric*) it.second);
         }
         break;
+    case MetricType::HISTOGRAM:
+        for (auto& it : collector->metrics()) {
+            _visit_histogram(metric_name, it.first, (IntHistogram*) it.second);
+        }
+        break;
+    case MetricType::SUMMARY:
+        for (auto& it : collector->metrics()) {
+            _visit_summary(metric_name, it.first, (HdrHistogram*) it.second);
+        }
+        break;
     default:
         break;
     }
 }
 
+// 'extra_label' is appended as the last label if not empty
+void PrometheusMetricsVisitor::_append_labels(
+        const MetricLabels& labels, const std::string& extra_label) {
+    if (labels.empty() && extra_label.empty()) {
+        return;
+    }
+    _buf.append("{");
+    int i = 0;
+    for (auto& label : labels.labels) {
+        if (i++ > 0) {
+            _buf.append(",");
+        }
+        _buf.append(label.name).append("=\"").append(label.value).append("\"");
+    }
+    if (!extra_label.empty()) {
+        if (i > 0) {
+            _buf.append(",");
+        }
+        _buf.append(extra_label);
+    }
+    _buf.append("}");
+}
+
 void PrometheusMetricsVisitor::_visit_simple_metric(
         const std::string& name, const MetricLabels& labels, SimpleMetric* metric) {
-    _ss << name;
-    // labels
-    if (!labels.empty()) {
-        _ss << "{";
-        int i = 0;
-        for (auto& label : labels.labels) {
-            if (i++ > 0) {
-                _ss << ",";
-            }
-            _ss << label.name << "=\"" << label.value << "\"";
-        }
-        _ss << "}";
+    _buf.append(name);
+    _append_labels(labels, "");
+    _buf.append(" ").append(metric->to_string()).append("\n");
+}
+
+// eg:
+// palo_be_compaction_latency_ms_bucket{type="base",le="1"} 3
+// ...
+// palo_be_compaction_latency_ms_bucket{type="base",le="+Inf"} 10
+// palo_be_compaction_latency_ms_sum{type="base"} 12345
+// palo_be_compaction_latency_ms_count{type="base"} 10
+void PrometheusMetricsVisitor::_visit_histogram(
+        const std::string& name, const MetricLabels& labels, IntHistogram* histogram) {
+    const auto& bounds = histogram->bounds();
+    int64_t cumulative_count = 0;
+    for (size_t i = 0; i <= bounds.size(); ++i) {
+        cumulative_count += histogram->bucket_count(i);
+        std::string le = i < bounds.size() ? std::to_string(bounds[i]) : "+Inf";
+        _buf.append(name).append("_bucket");
+        _append_labels(labels, "le=\"" + le + "\"");
+        _buf.append(" ").append(std::to_string(cumulative_count)).append("\n");
+    }
+    _buf.append(name).append("_sum");
+    _append_labels(labels, "");
+    _buf.append(" ").append(std::to_string(histogram->sum())).append("\n");
+    _buf.append(name).append("_count");
+    _append_labels(labels, "");
+    // buckets are read one by one while they are updated, make the count
+    // consistent with them
+    _buf.append(" ").append(std::to_string(cumulative_count)).append("\n");
+}
+
+// eg:
+// palo_be_page_read_latency_us{quantile="0.5"} 191
+// ...
+// palo_be_page_read_latency_us_sum 1234567
+// palo_be_page_read_latency_us_count 1000
+void PrometheusMetricsVisitor::_visit_summary(
+        const std::string& name, const MetricLabels& labels, HdrHistogram* histogram) {
+    std::vector<int64_t> bucket_counts;
+    int64_t count = 0;
+    int64_t sum = 0;
+    histogram->snapshot(&bucket_counts, &count, &sum);
+    for (double quantile : HdrHistogram::exported_quantiles()) {
+        std::stringstream label;
+        label << "quantile=\"" << quantile << "\"";
+        _buf.append(name);
+        _append_labels(labels, label.str());
+        _buf.append(" ").append(std::to_string(
+                HdrHistogram::value_at_quantile(bucket_counts, count, quantile))).append("\n");
     }
-    _ss << " " << metric->to_string() << "\n";
+    _buf.append(name).append("_sum");
+    _append_labels(labels, "");
+    _buf.append(" ").append(std::to_string(sum)).append("\n");
+    _buf.append(name).append("_count");
+    _append_labels(labels, "");
+    _buf.append(" ").append(std::to_string(count)).append("\n");
 }
 
 void SimpleCoreMetricsVisitor::visit(const std::string& prefix,
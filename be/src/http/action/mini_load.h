@@ -58,6 +58,7 @@ public:
     void handle(HttpRequest *req) override;
 
     bool request_will_be_read_progressively() override { return true; }
+    bool is_data_plane() const override { return true; }
 
     int on_header(HttpRequest* req) override;
 
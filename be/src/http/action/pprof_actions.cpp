@@ -35,12 +35,17 @@
 #include "http/ev_http_server.h"
 #include "runtime/exec_env.h"
 #include "util/bfd_parser.h"
+#include "util/cpu_profiler.h"
+#include "util/uid_util.h"
 
 namespace doris {
 
 // pprof default sample time in seconds.
 static const std::string SECOND_KEY = "seconds";
 static const int kPprofDefaultSampleSecs = 30; 
+static const std::string QUERY_ID_KEY = "query_id";
+// look back further by default, because the query is usually finished
+static const int kQueryProfileDefaultSecs = 600;
 
 // Protect, only one thread can work
 static std::mutex kPprofActionMutex;
@@ -242,6 +247,46 @@ void SymbolAction::handle(HttpRequest* req) {
     }
 }
 
+// Folded stacks of the samples taken by CpuProfiler in the last 'seconds'
+// seconds, of the query 'query_id' if given. The output can be drawn by
+// flamegraph.pl directly.
+class QueryProfileAction : public HttpHandler {
+public:
+    QueryProfileAction(BfdParser* parser) : _parser(parser) { }
+    virtual ~QueryProfileAction() { }
+
+    virtual void handle(HttpRequest *req) override;
+
+private:
+    BfdParser* _parser;
+};
+
+void QueryProfileAction::handle(HttpRequest* req) {
+    int seconds = kQueryProfileDefaultSecs;
+    const std::string& seconds_str = req->param(SECOND_KEY);
+    if (!seconds_str.empty()) {
+        seconds = std::atoi(seconds_str.c_str());
+    }
+
+    TUniqueId query_id;
+    bool has_query_id = false;
+    // parse_id modifies its argument
+    std::string query_id_str = req->param(QUERY_ID_KEY);
+    if (!query_id_str.empty()) {
+        if (!parse_id(query_id_str, &query_id)) {
+            HttpChannel::send_reply(req, HttpStatus::BAD_REQUEST,
+                                    "invalid query_id: " + req->param(QUERY_ID_KEY));
+            return;
+        }
+        has_query_id = true;
+    }
+
+    std::string str;
+    CpuProfiler::instance()->get_folded_stacks(
+        has_query_id ? &query_id : nullptr, seconds, _parser, &str);
+    HttpChannel::send_reply(req, str);
+}
+
 Status PprofActions::setup(ExecEnv* exec_env, EvHttpServer* http_server) {
     http_server->register_handler(HttpMethod::GET, "/pprof/heap",
                                   new HeapAction());
@@ -259,6 +304,8 @@ Status PprofActions::setup(ExecEnv* exec_env, EvHttpServer* http_server) {
     http_server->register_handler(HttpMethod::GET, "/pprof/symbol", action);
     http_server->register_handler(HttpMethod::HEAD, "/pprof/symbol", action);
     http_server->register_handler(HttpMethod::POST, "/pprof/symbol", action);
+    http_server->register_handler(HttpMethod::GET, "/pprof/query_profile",
+                                  new QueryProfileAction(exec_env->bfd_parser()));
     return Status::OK();
 }
 
@@ -0,0 +1,57 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "http/action/query_trace_action.h"
+
+#include <string>
+
+#include "http/http_channel.h"
+#include "http/http_headers.h"
+#include "http/http_request.h"
+#include "http/http_status.h"
+#include "runtime/query_trace.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+static const std::string QUERY_ID_KEY = "query_id";
+static const std::string HEADER_JSON = "application/json";
+
+void QueryTraceAction::handle(HttpRequest* req) {
+    TUniqueId query_id;
+    // parse_id modifies its argument
+    std::string query_id_str = req->param(QUERY_ID_KEY);
+    if (query_id_str.empty() || !parse_id(query_id_str, &query_id)) {
+        HttpChannel::send_reply(req, HttpStatus::BAD_REQUEST,
+                                "invalid query_id: " + req->param(QUERY_ID_KEY));
+        return;
+    }
+
+    std::shared_ptr<QueryTrace> trace = QueryTraceMgr::instance()->get(query_id);
+    if (trace == nullptr) {
+        HttpChannel::send_reply(req, HttpStatus::NOT_FOUND,
+                                "no trace of query: " + req->param(QUERY_ID_KEY));
+        return;
+    }
+
+    std::string str;
+    trace->to_chrome_trace(&str);
+    req->add_output_header(HttpHeaders::CONTENT_TYPE, HEADER_JSON.c_str());
+    HttpChannel::send_reply(req, HttpStatus::OK, str);
+}
+
+} // end namespace doris
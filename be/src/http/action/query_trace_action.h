@@ -0,0 +1,39 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_HTTP_ACTION_QUERY_TRACE_ACTION_H
+#define DORIS_BE_SRC_HTTP_ACTION_QUERY_TRACE_ACTION_H
+
+#include "http/http_handler.h"
+
+namespace doris {
+
+// Export the spans recorded for a query (see enable_query_trace) in Chrome trace
+// format, which can be loaded by chrome://tracing or Perfetto.
+//   GET /api/query_trace?query_id=<query id>
+class QueryTraceAction : public HttpHandler {
+public:
+    QueryTraceAction() { }
+
+    virtual ~QueryTraceAction() { }
+
+    void handle(HttpRequest* req) override;
+};
+
+} // end namespace doris
+
+#endif // DORIS_BE_SRC_HTTP_ACTION_QUERY_TRACE_ACTION_H
@@ -19,7 +19,9 @@
 
 #include <deque>
 #include <future>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 // use string iequal 
 #include <event2/buffer.h>
@@ -34,6 +36,7 @@
 #include "gen_cpp/FrontendService.h"
 #include "gen_cpp/FrontendService_types.h"
 #include "gen_cpp/HeartbeatService_types.h"
+#include "http/ev_http_server.h"
 #include "http/http_channel.h"
 #include "http/http_common.h"
 #include "http/http_request.h"
@@ -49,6 +52,7 @@
 #include "runtime/stream_load/stream_load_pipe.h"
 #include "runtime/stream_load/stream_load_context.h"
 #include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/group_commit_mgr.h"
 #include "util/byte_buffer.h"
 #include "util/debug_util.h"
 #include "util/json_util.h"
@@ -71,6 +75,8 @@ TStreamLoadPutResult k_stream_load_put_result;
 static TFileFormatType::type parse_format(const std::string& format_str) {
     if (boost::iequals(format_str, "CSV")) {
         return TFileFormatType::FORMAT_CSV_PLAIN;
+    } else if (boost::iequals(format_str, "JSON")) {
+        return TFileFormatType::FORMAT_JSON;
     }
     return TFileFormatType::FORMAT_UNKNOWN;
 }
@@ -78,6 +84,7 @@ static TFileFormatType::type parse_format(const std::string& format_str) {
 static bool is_format_support_streaming(TFileFormatType::type format) {
     switch (format) {
     case TFileFormatType::FORMAT_CSV_PLAIN:
+    case TFileFormatType::FORMAT_JSON:
         return true;
     default:
         return false;
@@ -104,6 +111,7 @@ void StreamLoadAction::handle(HttpRequest* req) {
         return;
     }
 
+    ctx->status = _finish_body(ctx);
     // status already set to fail
     if (ctx->status.ok()) {
         ctx->status = _handle(ctx);
@@ -141,6 +149,10 @@ Status StreamLoadAction::_handle(StreamLoadContext* ctx) {
             << ", id=" << ctx->id;
         return Status::InternalError("receive body dont't equal with body bytes");
     }
+    if (ctx->group_commit) {
+        return _exec_env->group_commit_mgr()->append_and_wait(
+            ctx, static_cast<const GroupCommitBodySink&>(*ctx->body_sink));
+    }
     if (!ctx->use_streaming) {
         // if we use non-streaming, we need to close file first,
         // then execute_plan_fragment here
@@ -236,6 +248,13 @@ Status StreamLoadAction::_on_header(HttpRequest* http_req, StreamLoadContext* ct
         }
     }
 
+    // small loads are committed with others of the same table
+    if (boost::iequals(http_req->header(HTTP_GROUP_COMMIT), "true")
+            && ctx->format == TFileFormatType::FORMAT_CSV_PLAIN
+            && ctx->body_bytes > 0 && ctx->body_bytes <= config::group_commit_max_body_bytes) {
+        return _process_group_commit_put(http_req, ctx);
+    }
+
     TNetworkAddress master_addr = _exec_env->master_info()->network_address;
 
     // begin transaction
@@ -254,20 +273,115 @@ void StreamLoadAction::on_chunk_data(HttpRequest* req) {
     struct evhttp_request* ev_req = req->get_evhttp_request();
     auto evbuf = evhttp_request_get_input_buffer(ev_req);
 
-    while (evbuffer_get_length(evbuf) > 0) {
-        auto bb = ByteBuffer::allocate(4096);
-        auto remove_bytes = evbuffer_remove(evbuf, bb->ptr, bb->capacity);
-        bb->pos = remove_bytes;
-        bb->flip();
-        auto st = ctx->body_sink->append(bb);
+    size_t len = evbuffer_get_length(evbuf);
+    if (len == 0) {
+        return;
+    }
+    // Move the received chains out of the request's buffer, which doesn't copy
+    // them, and hand them over to the body sink by reference. The holder is
+    // released when the last chunk referencing it has been consumed.
+    std::shared_ptr<evbuffer> holder(evbuffer_new(), evbuffer_free);
+    if (holder == nullptr || evbuffer_add_buffer(holder.get(), evbuf) != 0) {
+        LOG(WARNING) << "move body content failed. " << ctx->brief();
+        ctx->status = Status::InternalError("move body content failed");
+        return;
+    }
+    int num_vecs = evbuffer_peek(holder.get(), -1, nullptr, nullptr, 0);
+    std::vector<evbuffer_iovec> vecs(num_vecs);
+    evbuffer_peek(holder.get(), -1, nullptr, vecs.data(), num_vecs);
+    if (req->event_loop() == nullptr) {
+        // not read by an event loop, nothing else would be blocked
+        for (auto& vec : vecs) {
+            if (vec.iov_len == 0) {
+                continue;
+            }
+            auto bb = ByteBuffer::wrap((char*)vec.iov_base, vec.iov_len, holder);
+            auto st = ctx->body_sink->append(bb);
+            if (!st.ok()) {
+                LOG(WARNING) << "append body content failed. errmsg=" << st.get_error_msg()
+                        << ctx->brief();
+                ctx->status = st;
+                return;
+            }
+            ctx->receive_bytes += vec.iov_len;
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> l(ctx->body_lock);
+    for (auto& vec : vecs) {
+        if (vec.iov_len == 0) {
+            continue;
+        }
+        ctx->pending_body.push_back(ByteBuffer::wrap((char*)vec.iov_base, vec.iov_len, holder));
+        ctx->receive_bytes += vec.iov_len;
+    }
+    if (!ctx->read_paused) {
+        _flush_pending_body(req, ctx);
+    }
+}
+
+// Hand the pending body over to body_sink without blocking the event loop.
+// If body_sink is full, reading from the client is paused until body_sink has
+// space, so that a slow load pushes back on its client instead of stalling all
+// the connections of the loop. Must be called in the loop with body_lock held.
+void StreamLoadAction::_flush_pending_body(HttpRequest* req, StreamLoadContext* ctx) {
+    while (!ctx->pending_body.empty()) {
+        bool appended = false;
+        EvLoop* loop = req->event_loop();
+        auto st = ctx->body_sink->try_append(ctx->pending_body.front(), &appended,
+                [this, loop, req, ctx] {
+            // may be called in the loop by cancel(), when body_lock is held
+            loop->queue_in_loop([this, req, ctx] {
+                {
+                    std::lock_guard<std::mutex> l(ctx->body_lock);
+                    // req may have been freed if body is finished
+                    if (!ctx->body_finished) {
+                        ctx->read_paused = false;
+                        _flush_pending_body(req, ctx);
+                        if (!ctx->read_paused) {
+                            req->resume_read();
+                        }
+                    }
+                }
+                if (ctx->unref()) {
+                    delete ctx;
+                }
+            });
+        });
         if (!st.ok()) {
             LOG(WARNING) << "append body content failed. errmsg=" << st.get_error_msg()
                     << ctx->brief();
             ctx->status = st;
+            ctx->pending_body.clear();
             return;
         }
-        ctx->receive_bytes += remove_bytes;
+        if (!appended) {
+            // released by the callback
+            ctx->ref();
+            ctx->read_paused = true;
+            req->pause_read();
+            return;
+        }
+        ctx->pending_body.pop_front();
+    }
+}
+
+// Called when the whole body is received, take over the pending body from the
+// event loop and append it to body_sink.
+Status StreamLoadAction::_finish_body(StreamLoadContext* ctx) {
+    std::deque<ByteBufferPtr> pending_body;
+    {
+        std::lock_guard<std::mutex> l(ctx->body_lock);
+        ctx->body_finished = true;
+        pending_body.swap(ctx->pending_body);
     }
+    if (!ctx->status.ok()) {
+        return ctx->status;
+    }
+    for (auto& buf : pending_body) {
+        RETURN_IF_ERROR(ctx->body_sink->append(buf));
+    }
+    return Status::OK();
 }
 
 void StreamLoadAction::free_handler_ctx(void* param) {
@@ -275,6 +389,10 @@ void StreamLoadAction::free_handler_ctx(void* param) {
     if (ctx == nullptr) {
         return;
     }
+    {
+        std::lock_guard<std::mutex> l(ctx->body_lock);
+        ctx->body_finished = true;
+    }
     // sender is going, make receiver know it
     if (ctx->body_sink != nullptr) {
         ctx->body_sink->cancel();
@@ -309,24 +427,7 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
         request.fileType = TFileType::FILE_LOCAL;
         ctx->body_sink = file_sink;
     }
-    if (!http_req->header(HTTP_COLUMNS).empty()) {
-        request.__set_columns(http_req->header(HTTP_COLUMNS));
-    }
-    if (!http_req->header(HTTP_WHERE).empty()) {
-        request.__set_where(http_req->header(HTTP_WHERE));
-    }
-    if (!http_req->header(HTTP_COLUMN_SEPARATOR).empty()) {
-        request.__set_columnSeparator(http_req->header(HTTP_COLUMN_SEPARATOR));
-    }
-    if (!http_req->header(HTTP_PARTITIONS).empty()) {
-        request.__set_partitions(http_req->header(HTTP_PARTITIONS));
-    }
-    if (!http_req->header(HTTP_NEGATIVE).empty()
-            && http_req->header(HTTP_NEGATIVE) == "true") {
-            request.__set_negative(true);
-    } else {
-        request.__set_negative(false);
-    }
+    _set_plan_params(http_req, &request);
 
     // plan this load
     TNetworkAddress master_addr = _exec_env->master_info()->network_address;
@@ -358,6 +459,47 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
     return _exec_env->stream_load_executor()->execute_plan_fragment(ctx);
 }
 
+void StreamLoadAction::_set_plan_params(HttpRequest* http_req, TStreamLoadPutRequest* request) {
+    if (!http_req->header(HTTP_COLUMNS).empty()) {
+        request->__set_columns(http_req->header(HTTP_COLUMNS));
+    }
+    if (!http_req->header(HTTP_WHERE).empty()) {
+        request->__set_where(http_req->header(HTTP_WHERE));
+    }
+    if (!http_req->header(HTTP_COLUMN_SEPARATOR).empty()) {
+        request->__set_columnSeparator(http_req->header(HTTP_COLUMN_SEPARATOR));
+    }
+    if (!http_req->header(HTTP_PARTITIONS).empty()) {
+        request->__set_partitions(http_req->header(HTTP_PARTITIONS));
+    }
+    if (!http_req->header(HTTP_JSONPATHS).empty()) {
+        request->__set_jsonpaths(http_req->header(HTTP_JSONPATHS));
+    }
+    if (!http_req->header(HTTP_NEGATIVE).empty()
+            && http_req->header(HTTP_NEGATIVE) == "true") {
+            request->__set_negative(true);
+    } else {
+        request->__set_negative(false);
+    }
+}
+
+Status StreamLoadAction::_process_group_commit_put(HttpRequest* http_req, StreamLoadContext* ctx) {
+    ctx->group_commit = true;
+    if (!http_req->header(HTTP_MAX_FILTER_RATIO).empty()) {
+        ctx->max_filter_ratio = strtod(http_req->header(HTTP_MAX_FILTER_RATIO).c_str(), nullptr);
+    }
+    // txn, load id and file type are set by the load of the group
+    TStreamLoadPutRequest& request = ctx->put_request;
+    set_request_auth(&request, ctx->auth);
+    request.db = ctx->db;
+    request.tbl = ctx->table;
+    request.formatType = ctx->format;
+    _set_plan_params(http_req, &request);
+    // the body is kept in memory until it's received completely
+    ctx->body_sink = std::make_shared<GroupCommitBodySink>();
+    return Status::OK();
+}
+
 Status StreamLoadAction::_data_saved_path(HttpRequest* req, std::string* file_path) {
     std::string prefix;
     RETURN_IF_ERROR(_exec_env->load_path_mgr()->allocate_dir(req->param(HTTP_DB_KEY), "", &prefix));
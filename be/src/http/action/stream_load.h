@@ -29,6 +29,7 @@ namespace doris {
 class ExecEnv;
 class Status;
 class StreamLoadContext;
+class TStreamLoadPutRequest;
 
 class StreamLoadAction : public HttpHandler {
 public:
@@ -38,6 +39,7 @@ public:
     void handle(HttpRequest *req) override;
 
     bool request_will_be_read_progressively() override { return true; }
+    bool is_data_plane() const override { return true; }
 
     int on_header(HttpRequest* req) override;
 
@@ -47,9 +49,13 @@ public:
 private:
     Status _on_header(HttpRequest* http_req, StreamLoadContext* ctx);
     Status _handle(StreamLoadContext* ctx);
+    void _flush_pending_body(HttpRequest* req, StreamLoadContext* ctx);
+    Status _finish_body(StreamLoadContext* ctx);
     Status _data_saved_path(HttpRequest* req, std::string* file_path);
     Status _execute_plan_fragment(StreamLoadContext* ctx);
     Status _process_put(HttpRequest* http_req, StreamLoadContext* ctx);
+    Status _process_group_commit_put(HttpRequest* http_req, StreamLoadContext* ctx);
+    void _set_plan_params(HttpRequest* http_req, TStreamLoadPutRequest* request);
 
 private:
     ExecEnv* _exec_env;
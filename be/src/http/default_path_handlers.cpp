@@ -27,6 +27,7 @@
 #include "common/logging.h"
 #include "runtime/mem_tracker.h"
 #include "util/debug_util.h"
+#include "util/doris_metrics.h"
 #include "util/logging.h"
 #include "util/pretty_printer.h"
 #include "http/web_page_handler.h"
@@ -101,9 +102,56 @@ void mem_usage_handler(MemTracker* mem_tracker, const WebPageHandler::ArgumentMa
 #endif
 }
 
+// Prints the quantiles of the latency histograms in DorisMetrics
+class LatencyPageVisitor : public MetricsVisitor {
+public:
+    LatencyPageVisitor(std::stringstream* output) : _output(output) { }
+    virtual ~LatencyPageVisitor() { }
+
+    void visit(const std::string& prefix, const std::string& name,
+               MetricCollector* collector) override {
+        if (collector->type() != MetricType::SUMMARY) {
+            return;
+        }
+        for (auto& it : collector->metrics()) {
+            HdrHistogram* histogram = (HdrHistogram*) it.second;
+            std::vector<int64_t> bucket_counts;
+            int64_t count = 0;
+            int64_t sum = 0;
+            histogram->snapshot(&bucket_counts, &count, &sum);
+            (*_output) << "<tr><td>" << name << "</td><td>" << it.first.to_string()
+                       << "</td><td>" << count << "</td>";
+            for (double quantile : HdrHistogram::exported_quantiles()) {
+                (*_output) << "<td>"
+                           << HdrHistogram::value_at_quantile(bucket_counts, count, quantile)
+                           << "</td>";
+            }
+            (*_output) << "</tr>";
+        }
+    }
+
+private:
+    std::stringstream* _output;
+};
+
+// Registered to handle "/latencyz"
+void latency_handler(const WebPageHandler::ArgumentMap& args, std::stringstream* output) {
+    (*output) << "<h2>Latency Histograms</h2>";
+    (*output) << "<table class='table table-bordered table-striped'>"
+              << "<tr><th>Name</th><th>Labels</th><th>Count</th>";
+    for (double quantile : HdrHistogram::exported_quantiles()) {
+        (*output) << "<th>P" << quantile * 100 << "</th>";
+    }
+    (*output) << "</tr>";
+    LatencyPageVisitor visitor(output);
+    DorisMetrics::metrics()->collect(&visitor);
+    (*output) << "</table>";
+}
+
 void add_default_path_handlers(WebPageHandler* web_page_handler, MemTracker* process_mem_tracker) {
     web_page_handler->register_page("/logs", logs_handler);
     web_page_handler->register_page("/varz", config_handler);
+    web_page_handler->register_page("/latencyz", latency_handler);
     web_page_handler->register_page(
             "/memz",
             boost::bind<void>(&mem_usage_handler, process_mem_tracker, _1, _2));
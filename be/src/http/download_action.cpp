@@ -34,6 +34,7 @@
 #include "http/http_request.h"
 #include "http/http_response.h"
 #include "http/http_status.h"
+#include "http/utils.h"
 #include "util/defer_op.h"
 #include "util/file_utils.h"
 #include "util/filesystem_util.h"
@@ -176,13 +177,35 @@ void DownloadAction::do_file_response(const std::string& file_path, HttpRequest
     int64_t file_size = st.st_size;
 
     // TODO(lingbin): process "IF_MODIFIED_SINCE" header
-    // TODO(lingbin): process "RANGE" header
+    // process "RANGE" header, so that an interrupted download can be resumed
+    int64_t offset = 0;
+    int64_t length = file_size;
+    HttpStatus status = HttpStatus::OK;
     const std::string& range_header = req->header(HttpHeaders::RANGE);
     if (!range_header.empty()) {
-        // analyse range header
+        Status st = parse_range_header(range_header, file_size, &offset, &length);
+        if (st.ok()) {
+            status = HttpStatus::PARTIAL_CONTENT;
+            std::stringstream content_range;
+            content_range << "bytes " << offset << "-" << (offset + length - 1) << "/" << file_size;
+            req->add_output_header(HttpHeaders::CONTENT_RANGE, content_range.str().c_str());
+        } else if (st.code() == TStatusCode::INVALID_ARGUMENT) {
+            close(fd);
+            LOG(WARNING) << "range is not satisfiable, file=" << file_path
+                         << ", file_size=" << file_size << ", range=" << range_header;
+            std::string content_range = "bytes */" + std::to_string(file_size);
+            req->add_output_header(HttpHeaders::CONTENT_RANGE, content_range.c_str());
+            HttpChannel::send_error(req, HttpStatus::REQUESTED_RANGE_NOT_SATISFIED);
+            return;
+        } else {
+            // ignore the header and send the whole file
+            offset = 0;
+            length = file_size;
+        }
     }
 
     req->add_output_header(HttpHeaders::CONTENT_TYPE, get_content_type(file_path).c_str());
+    req->add_output_header(HttpHeaders::ACCEPT_RANGES, "bytes");
 
     if (req->method() == HttpMethod::HEAD) {
         close(fd);
@@ -192,7 +215,8 @@ void DownloadAction::do_file_response(const std::string& file_path, HttpRequest
         return;
     }
 
-    HttpChannel::send_file(req, fd, 0, file_size);
+    // evbuffer_add_file sends the file by sendfile() or mmap()
+    HttpChannel::send_file(req, fd, offset, length, status);
 }
 
 // If 'file_name' contains a dot but does not consist solely of one or to two dots,
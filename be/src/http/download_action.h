@@ -29,8 +29,9 @@ class ExecEnv;
 
 // A simple handler that serves incoming HTTP requests of file-download to send their respective HTTP responses.
 //
-// TODO(lingbin): implements two useful header ('If-Modified-Since' and 'RANGE') to reduce
-// transmission consumption.
+// A single bytes range of 'Range' header is supported, so that an interrupted download
+// can be resumed.
+// TODO(lingbin): implements 'If-Modified-Since' header to reduce transmission consumption.
 // We use parameter named 'file' to specify the static resource path, it is an absolute path.
 class DownloadAction : public HttpHandler {
 public:
@@ -43,6 +44,8 @@ public:
 
     void handle(HttpRequest *req) override;
 
+    bool is_data_plane() const override { return true; }
+
 private:
     enum DOWNLOAD_TYPE {
         NORMAL = 1,
@@ -17,6 +17,11 @@
 
 #include "http/ev_http_server.h"
 
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <memory>
 #include <sstream>
 
@@ -53,15 +58,16 @@ static void on_request(struct evhttp_request *ev_req, void *arg) {
         // In this case, request's on_header return -1
         return;
     }
-    request->handler()->handle(request);
+    EvHttpServer* server = (EvHttpServer*)arg;
+    server->on_request(request);
 }
 
 static int on_header(struct evhttp_request* ev_req, void* param) {
-    EvHttpServer* server = (EvHttpServer*)ev_req->on_complete_cb_arg;
-    return server->on_header(ev_req);
+    EvLoop* loop = (EvLoop*)ev_req->on_complete_cb_arg;
+    return loop->server()->on_header(ev_req, loop);
 }
 
-// param is pointer of EvHttpServer
+// param is pointer of EvLoop
 static int on_connection(struct evhttp_request* req, void* param) {
     evhttp_request_set_header_cb(req, on_header);
     // only used on_complete_cb's argument
@@ -69,15 +75,97 @@ static int on_connection(struct evhttp_request* req, void* param) {
     return 0;
 }
 
-EvHttpServer::EvHttpServer(int port, int num_workers)
-        : _host("0.0.0.0"), _port(port), _num_workers(num_workers) {
+static std::string errno_msg() {
+    char buf[64];
+    std::stringstream ss;
+    ss << "errno=" << errno << ", errmsg=" << strerror_r(errno, buf, sizeof(buf));
+    return ss.str();
+}
+
+EvLoop::~EvLoop() {
+    if (_wakeup_event != nullptr) {
+        event_free(_wakeup_event);
+    }
+    if (_base != nullptr) {
+        event_base_free(_base);
+    }
+    for (auto fd : _wakeup_fds) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+Status EvLoop::init() {
+    _thread_id = std::this_thread::get_id();
+    _base = event_base_new();
+    if (_base == nullptr) {
+        return Status::InternalError("Couldn't create an event_base");
+    }
+    if (pipe2(_wakeup_fds, O_NONBLOCK | O_CLOEXEC) < 0) {
+        return Status::InternalError("create wakeup pipe failed, " + errno_msg());
+    }
+    _wakeup_event = event_new(_base, _wakeup_fds[0], EV_READ | EV_PERSIST, _on_wakeup, this);
+    if (_wakeup_event == nullptr || event_add(_wakeup_event, nullptr) < 0) {
+        return Status::InternalError("Couldn't add the wakeup event");
+    }
+    return Status::OK();
+}
+
+void EvLoop::run() {
+    event_base_dispatch(_base);
+}
+
+void EvLoop::run_in_loop(std::function<void()> fn) {
+    if (in_loop_thread()) {
+        fn();
+        return;
+    }
+    queue_in_loop(std::move(fn));
+}
+
+void EvLoop::queue_in_loop(std::function<void()> fn) {
+    bool need_wakeup = false;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        need_wakeup = _pending_functors.empty();
+        _pending_functors.push_back(std::move(fn));
+    }
+    if (need_wakeup) {
+        char c = 0;
+        // if the pipe is full, the loop has been woken up already
+        while (::write(_wakeup_fds[1], &c, 1) < 0 && errno == EINTR) {
+        }
+    }
+}
+
+void EvLoop::_on_wakeup(int fd, short what, void* arg) {
+    EvLoop* loop = (EvLoop*)arg;
+    char buf[64];
+    while (::read(fd, buf, sizeof(buf)) > 0) {
+    }
+    std::vector<std::function<void()>> functors;
+    {
+        std::lock_guard<std::mutex> l(loop->_lock);
+        functors.swap(loop->_pending_functors);
+    }
+    for (auto& fn : functors) {
+        fn();
+    }
+}
+
+EvHttpServer::EvHttpServer(int port, int num_workers, int num_data_plane_workers)
+        : _host("0.0.0.0"), _port(port), _num_workers(num_workers),
+        _num_data_plane_workers(num_data_plane_workers) {
     DCHECK_GT(_num_workers, 0);
     auto res = pthread_rwlock_init(&_rw_lock, nullptr);                
     DCHECK_EQ(res, 0);
 }
 
-EvHttpServer::EvHttpServer(const std::string& host, int port, int num_workers)
-        : _host(host), _port(port), _num_workers(num_workers) {
+EvHttpServer::EvHttpServer(const std::string& host, int port,
+                           int num_workers, int num_data_plane_workers)
+        : _host(host), _port(port), _num_workers(num_workers),
+        _num_data_plane_workers(num_data_plane_workers) {
     DCHECK_GT(_num_workers, 0);
     auto res = pthread_rwlock_init(&_rw_lock, nullptr);                
     DCHECK_EQ(res, 0);
@@ -89,33 +177,56 @@ EvHttpServer::~EvHttpServer() {
 
 Status EvHttpServer::start() {
     // bind to 
-    RETURN_IF_ERROR(_bind());
+    int fd = -1;
+    bool reuse_port = _num_workers > 1;
+    auto st = _bind(reuse_port, &fd);
+    if (!st.ok() && reuse_port) {
+        LOG(WARNING) << "listen with SO_REUSEPORT failed, workers will share one socket. "
+            << st.get_error_msg();
+        reuse_port = false;
+        st = _bind(false, &fd);
+    }
+    RETURN_IF_ERROR(st);
+    _server_fds.push_back(fd);
+    if (reuse_port) {
+        for (int i = 1; i < _num_workers; ++i) {
+            RETURN_IF_ERROR(_bind(true, &fd));
+            _server_fds.push_back(fd);
+        }
+    }
+
+    if (_num_data_plane_workers > 0) {
+        _data_plane_pool.reset(new ThreadPool(_num_data_plane_workers, 1024));
+    }
+    for (int i = 0; i < _num_workers; ++i) {
+        _loops.emplace_back(new EvLoop(this));
+    }
     for (int i = 0; i < _num_workers; ++i) {
         auto worker = [this, i] () {
             LOG(INFO) << "EvHttpServer worker start, id=" << i;
-            std::shared_ptr<event_base> base(
-                event_base_new(), [] (event_base* base) { event_base_free(base); });
-            if (base == nullptr) {
-                LOG(WARNING) << "Couldn't create an event_base.";
-                return; 
+            EvLoop* loop = _loops[i].get();
+            auto st = loop->init();
+            if (!st.ok()) {
+                LOG(WARNING) << "init event loop failed. " << st.get_error_msg();
+                return;
             }
             /* Create a new evhttp object to handle requests. */
             std::shared_ptr<evhttp> http(
-                evhttp_new(base.get()), [] (evhttp* http) { evhttp_free(http); });
+                evhttp_new(loop->base()), [] (evhttp* http) { evhttp_free(http); });
             if (http == nullptr) {
                 LOG(WARNING) << "Couldn't create an evhttp.";
                 return; 
             }
-            auto res = evhttp_accept_socket(http.get(), _server_fd);
+            auto res = evhttp_accept_socket(http.get(), _server_fds[i % _server_fds.size()]);
             if (res < 0) {
                 LOG(WARNING) << "evhttp accept socket failed";
                 return;
             }
 
-            evhttp_set_newreqcb(http.get(), on_connection, this);
+            evhttp_set_newreqcb(http.get(), on_connection, loop);
             evhttp_set_gencb(http.get(), on_request, this);
 
-            event_base_dispatch(base.get());
+            loop->run();
         };
         _workers.emplace_back(worker);
         _workers[i].detach();
@@ -129,7 +240,7 @@ void EvHttpServer::stop() {
 void EvHttpServer::join() {
 }
 
-Status EvHttpServer::_bind() {
+Status EvHttpServer::_bind(bool reuse_port, int* fd) {
     butil::EndPoint point;
     auto res = butil::hostname2endpoint(_host.c_str(), _port, &point);
     if (res < 0) {
@@ -137,22 +248,36 @@ Status EvHttpServer::_bind() {
         ss << "convert address failed, host=" << _host << ", port=" << _port;
         return Status::InternalError(ss.str());
     }
-    _server_fd = butil::tcp_listen(point, true);
-    if (_server_fd < 0) {
-        char buf[64];
-        std::stringstream ss;
-        ss << "tcp listen failed, errno=" << errno
-            << ", errmsg=" << strerror_r(errno, buf, sizeof(buf));
-        return Status::InternalError(ss.str());
+    // same as butil::tcp_listen(), which doesn't set SO_REUSEPORT
+    int sock = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) {
+        return Status::InternalError("create socket failed, " + errno_msg());
+    }
+    int on = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) != 0
+            || (reuse_port && setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0)) {
+        auto msg = "set socket option failed, " + errno_msg();
+        ::close(sock);
+        return Status::InternalError(msg);
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr = point.ip;
+    addr.sin_port = htons(point.port);
+    if (::bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0
+            || ::listen(sock, SOMAXCONN) != 0) {
+        auto msg = "tcp listen failed, " + errno_msg();
+        ::close(sock);
+        return Status::InternalError(msg);
     }
-    res = butil::make_non_blocking(_server_fd);
+    res = butil::make_non_blocking(sock);
     if (res < 0) {
-        char buf[64];
-        std::stringstream ss;
-        ss << "make socket to non_blocking failed, errno=" << errno
-            << ", errmsg=" << strerror_r(errno, buf, sizeof(buf));
-        return Status::InternalError(ss.str());
+        auto msg = "make socket to non_blocking failed, " + errno_msg();
+        ::close(sock);
+        return Status::InternalError(msg);
     }
+    *fd = sock;
     return Status::OK();
 }
 
@@ -197,8 +322,9 @@ bool EvHttpServer::register_handler(
     return result;
 }
 
-int EvHttpServer::on_header(struct evhttp_request* ev_req) {
+int EvHttpServer::on_header(struct evhttp_request* ev_req, EvLoop* loop) {
     std::unique_ptr<HttpRequest> request(new HttpRequest(ev_req));
+    request->set_event_loop(loop);
     auto res = request->init_from_evhttp();
     if (res < 0) {
         return -1;
@@ -229,6 +355,19 @@ int EvHttpServer::on_header(struct evhttp_request* ev_req) {
     return 0;
 }
 
+void EvHttpServer::on_request(HttpRequest* req) {
+    auto handler = req->handler();
+    if (_data_plane_pool != nullptr && handler->is_data_plane()) {
+        // The request isn't freed by libevent before it's replied, which is
+        // done in its loop by HttpChannel.
+        if (_data_plane_pool->offer([handler, req] { handler->handle(req); })) {
+            return;
+        }
+        LOG(WARNING) << "data plane pool is shut down, handle request in event loop";
+    }
+    handler->handle(req);
+}
+
 HttpHandler* EvHttpServer::_find_handler(HttpRequest* req) {
     auto& path = req->raw_path();
 
@@ -17,23 +17,77 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "common/status.h"
 #include "util/path_trie.hpp"
+#include "util/thread_pool.hpp"
 #include "http/http_method.h"
 
+struct event;
+struct event_base;
+struct evhttp_request;
+
 namespace doris {
 
+class EvHttpServer;
 class HttpHandler;
 class HttpRequest;
 
+// Event loop run by one worker of EvHttpServer. libevent objects of a loop
+// must only be used in its thread, other threads hand work over to the loop
+// by run_in_loop().
+class EvLoop {
+public:
+    EvLoop(EvHttpServer* server) : _server(server) { }
+    ~EvLoop();
+
+    // must be called in the thread which runs the loop
+    Status init();
+    void run();
+
+    EvHttpServer* server() const { return _server; }
+    event_base* base() const { return _base; }
+
+    bool in_loop_thread() const { return std::this_thread::get_id() == _thread_id; }
+
+    // Run fn in the loop, inline if called in it. Thread safe.
+    void run_in_loop(std::function<void()> fn);
+    // Run fn in the next iteration of the loop. Thread safe.
+    void queue_in_loop(std::function<void()> fn);
+
+private:
+    static void _on_wakeup(int fd, short what, void* arg);
+
+    EvHttpServer* _server;
+    event_base* _base = nullptr;
+    event* _wakeup_event = nullptr;
+    int _wakeup_fds[2] = {-1, -1};
+    std::thread::id _thread_id;
+
+    std::mutex _lock;
+    std::vector<std::function<void()>> _pending_functors;
+};
+
+// HTTP server running num_workers event loops. When SO_REUSEPORT is supported,
+// each loop listens on its own socket and the kernel spreads connections
+// among them, otherwise the loops accept from one shared socket.
+//
+// Handlers are called in the loop that reads the request, except handle() of
+// data plane handlers, e.g. loads and downloads, which is called in a pool of
+// num_data_plane_workers threads if it's not 0. So that a load waiting for its
+// plan fragment doesn't stall the other connections of the loop, like the
+// ones scraping /metrics.
 class EvHttpServer {
 public:
-    EvHttpServer(int port, int num_workers = 1);
-    EvHttpServer(const std::string& host, int port, int num_workers = 1);
+    EvHttpServer(int port, int num_workers = 1, int num_data_plane_workers = 0);
+    EvHttpServer(const std::string& host, int port,
+                 int num_workers = 1, int num_data_plane_workers = 0);
     ~EvHttpServer();
 
     // register handler for an a path-method pair
@@ -44,10 +98,11 @@ public:
     void join();
 
     // callback 
-    int on_header(struct evhttp_request* ev_req);
+    int on_header(struct evhttp_request* ev_req, EvLoop* loop);
+    void on_request(HttpRequest* req);
 
 private:
-    Status _bind();
+    Status _bind(bool reuse_port, int* fd);
     HttpHandler* _find_handler(HttpRequest* req);
 
 private:
@@ -55,9 +110,13 @@ private:
     std::string _host;
     int _port;
     int _num_workers;
+    int _num_data_plane_workers;
 
-    int _server_fd = -1;
+    // one listen socket per worker, or only one shared by all of them
+    std::vector<int> _server_fds;
+    std::vector<std::unique_ptr<EvLoop>> _loops;
     std::vector<std::thread> _workers;
+    std::unique_ptr<ThreadPool> _data_plane_pool;
 
     pthread_rwlock_t _rw_lock;
 
@@ -40,30 +40,42 @@ void HttpChannel::send_basic_challenge(HttpRequest* req, const std::string& real
     send_reply(req, HttpStatus::UNAUTHORIZED, s_prompt_str);
 }
 
+// Replies are sent in the event loop of the request, because handle() of data
+// plane handlers is called in other threads.
 void HttpChannel::send_error(HttpRequest* request, HttpStatus status) {
-    evhttp_send_error(request->get_evhttp_request(), status, defalut_reason(status).c_str());
+    request->run_in_loop([request, status] {
+        evhttp_send_error(request->get_evhttp_request(), status, defalut_reason(status).c_str());
+    });
 }
 
 void HttpChannel::send_reply(HttpRequest* request, HttpStatus status) {
-    evhttp_send_reply(request->get_evhttp_request(), status,
-                      defalut_reason(status).c_str(), nullptr);
+    request->run_in_loop([request, status] {
+        evhttp_send_reply(request->get_evhttp_request(), status,
+                          defalut_reason(status).c_str(), nullptr);
+    });
 }
 
 void HttpChannel::send_reply(
         HttpRequest* request, HttpStatus status, const std::string& content) {
     auto evb = evbuffer_new();
     evbuffer_add(evb, content.c_str(), content.size());
-    evhttp_send_reply(request->get_evhttp_request(), status, defalut_reason(status).c_str(), evb);
-    evbuffer_free(evb);
+    request->run_in_loop([request, status, evb] {
+        evhttp_send_reply(request->get_evhttp_request(), status,
+                          defalut_reason(status).c_str(), evb);
+        evbuffer_free(evb);
+    });
 }
 
-void HttpChannel::send_file(HttpRequest* request, int fd, size_t off, size_t size) {
+void HttpChannel::send_file(HttpRequest* request, int fd, size_t off, size_t size,
+                            HttpStatus status) {
     auto evb = evbuffer_new();
     evbuffer_add_file(evb, fd, off, size);
-    evhttp_send_reply(request->get_evhttp_request(),
-                      HttpStatus::OK,
-                      defalut_reason(HttpStatus::OK).c_str(), evb);
-    evbuffer_free(evb);
+    request->run_in_loop([request, status, evb] {
+        evhttp_send_reply(request->get_evhttp_request(),
+                          status,
+                          defalut_reason(status).c_str(), evb);
+        evbuffer_free(evb);
+    });
 }
 
 }
@@ -45,7 +45,10 @@ public:
 
     static void send_reply(HttpRequest* request, HttpStatus status, const std::string& content);
 
-    static void send_file(HttpRequest* request, int fd, size_t off, size_t size);
+    // send 'size' bytes from 'off' of 'fd' without copying to user space,
+    // 'fd' is closed after sent
+    static void send_file(HttpRequest* request, int fd, size_t off, size_t size,
+                          HttpStatus status = HttpStatus::OK);
 };
 
 }
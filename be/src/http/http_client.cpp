@@ -17,6 +17,8 @@
 
 #include "http/http_client.h"
 
+#include <sys/stat.h>
+
 namespace doris {
 
 HttpClient::HttpClient() {
@@ -47,6 +49,7 @@ Status HttpClient::init(const std::string& url) {
         curl_slist_free_all(_header_list);
         _header_list = nullptr;
     }
+    _max_download_speed_kbps = -1;
     // set error_buf
     _error_buf[0] = 0;
     auto code = curl_easy_setopt(_curl, CURLOPT_ERRORBUFFER, _error_buf);
@@ -167,20 +170,32 @@ Status HttpClient::execute(const std::function<bool(const void* data, size_t len
     return Status::OK();
 }
 
-Status HttpClient::download(const std::string& local_path) {
+Status HttpClient::download(const std::string& local_path, bool resume) {
     // set method to GET
     set_method(GET);
 
+    int64_t offset = 0;
+    if (resume) {
+        struct stat st;
+        if (stat(local_path.c_str(), &st) == 0) {
+            offset = st.st_size;
+        }
+    }
+    if (offset > 0) {
+        curl_easy_setopt(_curl, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)offset);
+    }
+
     // TODO(zc) Move this download speed limit outside to limit download speed
     // at system level
     curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_LIMIT,
                      config::download_low_speed_limit_kbps * 1024);
     curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_TIME, config::download_low_speed_time);
-    curl_easy_setopt(_curl, CURLOPT_MAX_RECV_SPEED_LARGE,
-                     config::max_download_speed_kbps * 1024);
+    int64_t max_speed_kbps = _max_download_speed_kbps > 0
+        ? _max_download_speed_kbps : config::max_download_speed_kbps;
+    curl_easy_setopt(_curl, CURLOPT_MAX_RECV_SPEED_LARGE, (curl_off_t)(max_speed_kbps * 1024));
 
     auto fp_closer = [] (FILE*fp) { fclose(fp); };
-    std::unique_ptr<FILE, decltype(fp_closer)> fp(fopen(local_path.c_str(), "w"), fp_closer);
+    std::unique_ptr<FILE, decltype(fp_closer)> fp(fopen(local_path.c_str(), offset > 0 ? "a" : "w"), fp_closer);
     if (fp == nullptr) {
         LOG(WARNING) << "open file failed, file=" << local_path;
         return Status::InternalError("open file failed");
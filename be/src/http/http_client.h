@@ -90,6 +90,11 @@ public:
         curl_easy_setopt(_curl, CURLOPT_TIMEOUT_MS, timeout_ms);
     }
 
+    // max speed of download(), which is config::max_download_speed_kbps by default
+    void set_max_download_speed_kbps(int64_t speed_kbps) {
+        _max_download_speed_kbps = speed_kbps;
+    }
+
     // used to get content length
     int64_t get_content_length() const {
         double cl = 0.0f;
@@ -110,8 +115,10 @@ public:
     }
 
     // helper function to download a file, you can call this function to downlaod
-    // a file to local_path 
-    Status download(const std::string& local_path);
+    // a file to local_path. If 'resume' is true and local_path exists, only the rest
+    // of the file is downloaded and appended to it, which fails if server does not
+    // support range.
+    Status download(const std::string& local_path, bool resume = false);
 
     Status execute_post_request(const std::string& payload, std::string* response);
 
@@ -134,6 +141,7 @@ private:
     const HttpCallback* _callback = nullptr;
     char _error_buf[CURL_ERROR_SIZE];
     curl_slist *_header_list = nullptr;
+    int64_t _max_download_speed_kbps = -1;
 };
 
 }
@@ -32,6 +32,8 @@ static const std::string HTTP_MAX_FILTER_RATIO = "max_filter_ratio";
 static const std::string HTTP_TIMEOUT = "timeout";
 static const std::string HTTP_PARTITIONS = "partitions";
 static const std::string HTTP_NEGATIVE = "negative";
+static const std::string HTTP_GROUP_COMMIT = "group_commit";
+static const std::string HTTP_JSONPATHS = "jsonpaths";
 
 static const std::string HTTP_100_CONTINUE = "100-continue";
 
@@ -31,6 +31,12 @@ public:
 
     virtual bool request_will_be_read_progressively() { return false; }
 
+    // Data plane handlers, e.g. loads and downloads, which may block for long
+    // in handle(), are called in EvHttpServer's data plane pool instead of the
+    // event loop. handle() of them must send replies through HttpChannel,
+    // which hands them over to the event loop.
+    virtual bool is_data_plane() const { return false; }
+
     // This funciton will called when all headers are recept.
     // return 0 if process successfully. otherwise return -1;
     // If return -1, on_header function should send_reply to HTTP client
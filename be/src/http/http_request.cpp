@@ -25,10 +25,12 @@
 
 #include <event2/buffer.h>
 #include <event2/bufferevent.h>
+#include <event2/event.h>
 #include <event2/http.h>
 #include <event2/http_struct.h>
 #include <event2/keyvalq_struct.h>
 
+#include "http/ev_http_server.h"
 #include "http/http_handler.h"
 
 #include "common/logging.h"
@@ -145,4 +147,27 @@ const char* HttpRequest::remote_host() const {
     return _ev_req->remote_host;
 }
 
+void HttpRequest::run_in_loop(std::function<void()> fn) {
+    if (_loop == nullptr) {
+        fn();
+        return;
+    }
+    _loop->run_in_loop(std::move(fn));
+}
+
+void HttpRequest::pause_read() {
+    // the connection is gone if client has closed it
+    auto evcon = evhttp_request_get_connection(_ev_req);
+    if (evcon != nullptr) {
+        bufferevent_disable(evhttp_connection_get_bufferevent(evcon), EV_READ);
+    }
+}
+
+void HttpRequest::resume_read() {
+    auto evcon = evhttp_request_get_connection(_ev_req);
+    if (evcon != nullptr) {
+        bufferevent_enable(evhttp_connection_get_bufferevent(evcon), EV_READ);
+    }
+}
+
 }
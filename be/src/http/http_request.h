@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_COMMON_UTIL_HTTP_REQUEST_H
 #define DORIS_BE_SRC_COMMON_UTIL_HTTP_REQUEST_H
 
+#include <functional>
 #include <map>
 #include <string>
 
@@ -33,6 +34,7 @@ struct evhttp_request;
 
 namespace doris {
 
+class EvLoop;
 class HttpHandler;
 
 class HttpRequest {
@@ -92,6 +94,19 @@ public:
 
     const char* remote_host() const;
 
+    // event loop reading this request, nullptr if it isn't read by EvHttpServer
+    EvLoop* event_loop() const { return _loop; }
+    void set_event_loop(EvLoop* loop) { _loop = loop; }
+
+    // Run fn in the event loop of this request, inline if there isn't one.
+    void run_in_loop(std::function<void()> fn);
+
+    // Stop and restart reading from the connection of this request, used to
+    // push back on the client when its body can't be consumed for now.
+    // Must be called in the event loop.
+    void pause_read();
+    void resume_read();
+
 private:
     HttpMethod _method;
     std::string _uri;
@@ -103,6 +118,7 @@ private:
 
     struct evhttp_request* _ev_req = nullptr; 
     HttpHandler* _handler = nullptr;
+    EvLoop* _loop = nullptr;
 
     void* _handler_ctx = nullptr;
     std::string _request_body;
@@ -17,6 +17,8 @@
 
 #include <http/utils.h>
 
+#include <algorithm>
+
 #include "common/logging.h"
 #include "common/utils.h"
 #include "http/http_common.h"
@@ -78,4 +80,64 @@ bool parse_basic_auth(const HttpRequest& req, AuthInfo* auth) {
     return true;
 }
 
+static bool parse_range_number(const std::string& str, int64_t* value) {
+    if (str.empty() || str.size() > 18) {
+        return false;
+    }
+    int64_t res = 0;
+    for (char c : str) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        res = res * 10 + (c - '0');
+    }
+    *value = res;
+    return true;
+}
+
+Status parse_range_header(const std::string& range, int64_t file_size,
+                          int64_t* offset, int64_t* length) {
+    static const std::string s_prefix = "bytes=";
+    if (range.compare(0, s_prefix.size(), s_prefix) != 0
+            || range.find(',') != std::string::npos) {
+        return Status::NotSupported("only single bytes range is supported");
+    }
+    auto pos = range.find('-', s_prefix.size());
+    if (pos == std::string::npos) {
+        return Status::NotSupported("invalid bytes range");
+    }
+    std::string first = range.substr(s_prefix.size(), pos - s_prefix.size());
+    std::string last = range.substr(pos + 1);
+
+    int64_t start = 0;
+    int64_t end = 0;
+    if (first.empty()) {
+        // suffix range, the last 'end' bytes
+        if (!parse_range_number(last, &end)) {
+            return Status::NotSupported("invalid bytes range");
+        }
+        if (end == 0 || file_size == 0) {
+            return Status::InvalidArgument("range is not satisfiable");
+        }
+        start = std::max<int64_t>(file_size - end, 0);
+        end = file_size - 1;
+    } else {
+        if (!parse_range_number(first, &start)) {
+            return Status::NotSupported("invalid bytes range");
+        }
+        if (last.empty()) {
+            end = file_size - 1;
+        } else if (!parse_range_number(last, &end) || end < start) {
+            return Status::NotSupported("invalid bytes range");
+        }
+        if (start >= file_size) {
+            return Status::InvalidArgument("range is not satisfiable");
+        }
+        end = std::min(end, file_size - 1);
+    }
+    *offset = start;
+    *length = end - start + 1;
+    return Status::OK();
+}
+
 }
@@ -19,6 +19,7 @@
 
 #include <string>
 
+#include "common/status.h"
 #include "common/utils.h"
 #include "http/http_common.h"
 
@@ -34,4 +35,12 @@ bool parse_basic_auth(const HttpRequest& req, std::string* user, std::string* pa
 
 bool parse_basic_auth(const HttpRequest& req, AuthInfo* auth);
 
+// Parse 'Range' header of a file whose size is 'file_size', only a single
+// range of bytes is supported, e.g. "bytes=0-99", "bytes=100-" or "bytes=-100".
+// Return OK with 'offset' and 'length' of the range, NotSupported if the header
+// should be ignored and the whole file is sent, InvalidArgument if the range
+// is not satisfiable.
+Status parse_range_header(const std::string& range, int64_t file_size,
+                          int64_t* offset, int64_t* length);
+
 }
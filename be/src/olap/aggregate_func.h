@@ -17,10 +17,12 @@
 
 #pragma once
 
+#include "common/logging.h"
 #include "olap/hll.h"
 #include "olap/types.h"
 #include "olap/row_cursor_cell.h"
 #include "util/arena.h"
+#include "util/bitmap_value.h"
 
 namespace doris {
 
@@ -285,6 +287,19 @@ struct AggregateFuncTraits<OLAP_FIELD_AGGREGATION_REPLACE, OLAP_FIELD_TYPE_VARCH
     : public AggregateFuncTraits<OLAP_FIELD_AGGREGATION_REPLACE, OLAP_FIELD_TYPE_CHAR> {
 };
 
+// Same as REPLACE but null values don't replace others, so that a load can
+// update some columns of rows by leaving the others null.
+template <FieldType field_type>
+struct AggregateFuncTraits<OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL, field_type>
+    : public BaseAggregateFuncs {
+    static void update(RowCursorCell* dst, const RowCursorCell& src, Arena* arena) {
+        if (src.is_null()) {
+            return;
+        }
+        AggregateFuncTraits<OLAP_FIELD_AGGREGATION_REPLACE, field_type>::update(dst, src, arena);
+    }
+};
+
 template <>
 struct AggregateFuncTraits<OLAP_FIELD_AGGREGATION_HLL_UNION, OLAP_FIELD_TYPE_HLL> : public BaseAggregateFuncs {
     static void init(char* dst, Arena* arena) {
@@ -340,6 +355,61 @@ struct AggregateFuncTraits<OLAP_FIELD_AGGREGATION_HLL_UNION, OLAP_FIELD_TYPE_HLL
     }
 };
 
+// BITMAP_UNION columns store serialized BitmapValues in VARCHAR cells. Unioning the
+// serialized form row by row would re-serialize the whole bitmap for every row, so
+// while rows are aggregated the cell instead points to a heap BitmapValue, marked by
+// BITMAP_STATE_SIZE as slice size. finalize() serializes the state into the arena
+// and frees it, so an arena must be passed to it.
+template <>
+struct AggregateFuncTraits<OLAP_FIELD_AGGREGATION_BITMAP_UNION, OLAP_FIELD_TYPE_VARCHAR>
+    : public BaseAggregateFuncs {
+    static const size_t BITMAP_STATE_SIZE = SIZE_MAX;
+
+    static void update(RowCursorCell* dst, const RowCursorCell& src, Arena* arena) {
+        if (src.is_null()) {
+            return;
+        }
+        const Slice* src_slice = reinterpret_cast<const Slice*>(src.cell_ptr());
+        BitmapValue src_bitmap;
+        if (!src_bitmap.deserialize(src_slice->data, src_slice->size)) {
+            LOG(WARNING) << "ignore invalid bitmap, size=" << src_slice->size;
+            return;
+        }
+        *get_state(dst) |= src_bitmap;
+    }
+
+    static void finalize(char* data, Arena* arena) {
+        Slice* slice = reinterpret_cast<Slice*>(data);
+        if (slice->size != BITMAP_STATE_SIZE) {
+            // No row was aggregated into this cell, it is still serialized.
+            return;
+        }
+        DCHECK(arena != nullptr);
+        BitmapValue* bitmap = reinterpret_cast<BitmapValue*>(slice->data);
+        slice->size = bitmap->serialized_size();
+        slice->data = arena->Allocate(slice->size);
+        bitmap->serialize(slice->data);
+        delete bitmap;
+    }
+
+private:
+    // Returns the aggregation state of 'cell', turning its value into one first.
+    static BitmapValue* get_state(RowCursorCell* cell) {
+        Slice* slice = reinterpret_cast<Slice*>(cell->mutable_cell_ptr());
+        if (!cell->is_null() && slice->size == BITMAP_STATE_SIZE) {
+            return reinterpret_cast<BitmapValue*>(slice->data);
+        }
+        BitmapValue* bitmap = new BitmapValue();
+        if (!cell->is_null() && !bitmap->deserialize(slice->data, slice->size)) {
+            LOG(WARNING) << "ignore invalid bitmap, size=" << slice->size;
+        }
+        cell->set_not_null();
+        slice->data = reinterpret_cast<char*>(bitmap);
+        slice->size = BITMAP_STATE_SIZE;
+        return bitmap;
+    }
+};
+
 template<FieldAggregationMethod aggMethod, FieldType fieldType>
 struct AggregateTraits : public AggregateFuncTraits<aggMethod, fieldType> {
     static const FieldAggregationMethod agg_method = aggMethod;
@@ -19,10 +19,16 @@
 #define DORIS_BE_SRC_OLAP_COLUMN_FILE_BLOOM_FILTER_HPP
 
 #include <math.h>
+#include <stdlib.h>
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "olap/olap_define.h"
 #include "olap/utils.h"
 #include "util/hash_util.hpp"
@@ -31,6 +37,12 @@ namespace doris {
 
 static const uint64_t DEFAULT_SEED = 104729;
 static const uint64_t BLOOM_FILTER_NULL_HASHCODE = 2862933555777941757ULL;
+// Salts of the 8 words of a bucket of BlockBloomFilter to get bit index from
+// the key, from "Cache-, Hash- and Space-Efficient Bloom Filters"
+static const uint32_t BLOCK_BLOOM_FILTER_SALT[8] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
 
 struct BloomFilterIndexHeader {
     uint64_t block_count;
@@ -296,6 +308,171 @@ private:
     uint32_t _hash_function_num;
 };
 
+// Split block bloom filter. The bit set is divided into buckets of 256 bits,
+// which are 8 words of 32 bits. Upper half of hash value selects the bucket,
+// and lower half sets one bit in every word of the bucket. So that adding
+// or testing a value touches only one cache line, instead of k cache lines
+// of BloomFilter.
+// Probe is done by AVX2 if it's enabled at compile time, otherwise by a loop
+// over the 8 words which can be vectorized by compiler.
+class BlockBloomFilter {
+public:
+    // Number of uint64_t words of one bucket
+    static const uint32_t BUCKET_WORDS = 4;
+
+    BlockBloomFilter() : _buckets(nullptr), _num_buckets(0), _owned(false) {}
+    ~BlockBloomFilter() {
+        reset();
+    }
+
+    // Create BlockBloomFilter with given entry num and fpp, which is used for loading data
+    bool init(int64_t expected_entries, double fpp) {
+        reset();
+        _num_buckets = _optimal_num_buckets(expected_entries, fpp);
+        size_t bytes = _num_buckets * sizeof(Bucket);
+        void* data = nullptr;
+        if (posix_memalign(&data, BUCKET_ALIGNMENT, bytes) != 0) {
+            _num_buckets = 0;
+            return false;
+        }
+        memset(data, 0, bytes);
+        _buckets = reinterpret_cast<Bucket*>(data);
+        _owned = true;
+        return true;
+    }
+
+    // Init BlockBloomFilter with given buffer, which is used for query. len is
+    // number of uint64_t words, which must be a multiple of BUCKET_WORDS.
+    // Buffer is not owned by filter, and it's better to be aligned to cache line.
+    bool init(uint64_t* data, uint32_t len) {
+        reset();
+        uint32_t num_buckets = len / BUCKET_WORDS;
+        if (num_buckets == 0 || num_buckets * BUCKET_WORDS != len) {
+            return false;
+        }
+        _buckets = reinterpret_cast<Bucket*>(data);
+        _num_buckets = num_buckets;
+        return true;
+    }
+
+    // Compute hash value of given buffer and add to BlockBloomFilter
+    void add_bytes(const char* buf, uint32_t len) {
+        uint64_t hash = buf == nullptr ?
+                BLOOM_FILTER_NULL_HASHCODE : HashUtil::hash64(buf, len, DEFAULT_SEED);
+        add_hash(hash);
+    }
+
+    void add_hash(uint64_t hash) {
+        Bucket& bucket = _buckets[_bucket_index(hash)];
+        uint32_t key = (uint32_t) hash;
+#ifdef __AVX2__
+        __m256i* ptr = reinterpret_cast<__m256i*>(bucket.words);
+        _mm256_storeu_si256(ptr, _mm256_or_si256(_mm256_loadu_si256(ptr), _make_mask(key)));
+#else
+        for (int i = 0; i < 8; ++i) {
+            bucket.words[i] |= 1U << ((key * BLOCK_BLOOM_FILTER_SALT[i]) >> 27);
+        }
+#endif
+    }
+
+    // Compute hash value of given buffer and verify whether exist in BlockBloomFilter
+    bool test_bytes(const char* buf, uint32_t len) const {
+        uint64_t hash = buf == nullptr ?
+                BLOOM_FILTER_NULL_HASHCODE : HashUtil::hash64(buf, len, DEFAULT_SEED);
+        return test_hash(hash);
+    }
+
+    bool test_hash(uint64_t hash) const {
+        const Bucket& bucket = _buckets[_bucket_index(hash)];
+        uint32_t key = (uint32_t) hash;
+#ifdef __AVX2__
+        __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bucket.words));
+        return _mm256_testc_si256(words, _make_mask(key));
+#else
+        uint32_t missed = 0;
+        for (int i = 0; i < 8; ++i) {
+            uint32_t mask = 1U << ((key * BLOCK_BLOOM_FILTER_SALT[i]) >> 27);
+            missed |= ~bucket.words[i] & mask;
+        }
+        return missed == 0;
+#endif
+    }
+
+    // Merge with another BlockBloomFilter, return false when the size is not equal
+    bool merge(const BlockBloomFilter& that) {
+        if (_num_buckets != that._num_buckets) {
+            return false;
+        }
+        uint64_t* dst = bit_set_data();
+        const uint64_t* src = that.bit_set_data();
+        for (uint32_t i = 0; i < bit_set_data_len(); ++i) {
+            dst[i] |= src[i];
+        }
+        return true;
+    }
+
+    void clear() {
+        memset(_buckets, 0, _num_buckets * sizeof(Bucket));
+    }
+
+    void reset() {
+        if (_owned) {
+            free(_buckets);
+        }
+        _buckets = nullptr;
+        _num_buckets = 0;
+        _owned = false;
+    }
+
+    uint32_t num_buckets() const {
+        return _num_buckets;
+    }
+
+    uint64_t* bit_set_data() const {
+        return reinterpret_cast<uint64_t*>(_buckets);
+    }
+
+    uint32_t bit_set_data_len() const {
+        return _num_buckets * BUCKET_WORDS;
+    }
+
+private:
+    static const size_t BUCKET_ALIGNMENT = 64;
+
+    struct Bucket {
+        uint32_t words[8];
+    };
+
+#ifdef __AVX2__
+    static __m256i _make_mask(uint32_t key) {
+        const __m256i salt = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(BLOCK_BLOOM_FILTER_SALT));
+        __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key), salt), 27);
+        return _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+    }
+#endif
+
+    // map upper half of hash to [0, _num_buckets) by multiply and shift,
+    // which is cheaper than modulo
+    uint32_t _bucket_index(uint64_t hash) const {
+        return (uint32_t) (((hash >> 32) * _num_buckets) >> 32);
+    }
+
+    // Compute the number of buckets to make false positive probability
+    // less than fpp, which is (1 - (1 - 1/32) ^ (n / num_buckets)) ^ 8, so
+    //     m = -8 * n / ln(1 - fpp ^ (1/8)) bits
+    // and round it up to buckets.
+    static uint32_t _optimal_num_buckets(int64_t n, double fpp) {
+        double bit_num = -8.0 * std::max<int64_t>(n, 1) / log(1 - pow(fpp, 1.0 / 8));
+        return (uint32_t) std::max(ceil(bit_num / 256), 1.0);
+    }
+
+    Bucket* _buckets;
+    uint32_t _num_buckets;
+    // whether _buckets is allocated by this filter
+    bool _owned;
+};
+
 }  // namespace doris
 
 #endif // DORIS_BE_SRC_OLAP_COLUMN_FILE_BLOOM_FILTER_HPP
@@ -18,9 +18,13 @@
 #ifndef DORIS_BE_SRC_OLAP_COLUMN_PREDICATE_H
 #define DORIS_BE_SRC_OLAP_COLUMN_PREDICATE_H
 
+#include <stdint.h>
+#include <algorithm>
+
 namespace doris {
 
 class VectorizedRowBatch;
+struct StringValue;
 
 class ColumnPredicate {
 public:
@@ -30,6 +34,54 @@ public:
     virtual void evaluate(VectorizedRowBatch* batch) const = 0;
 };
 
+// number of rows evaluated in one block by evaluate_dense()
+static const uint32_t PREDICATE_EVALUATE_BLOCK_SIZE = 256;
+
+// Whether values of null rows can be compared safely. StringValue of a null
+// row may point to nothing.
+template<class type>
+struct is_dense_evaluable {
+    static const bool value = true;
+};
+
+template<>
+struct is_dense_evaluable<StringValue> {
+    static const bool value = false;
+};
+
+// Evaluate predicate on rows [0, n) of a batch whose selection vector is not
+// in use. Rows are handled block by block: results of a block are written to
+// a byte mask first, which has no dependency between rows and can be
+// vectorized by compiler, and then compacted into the selection vector.
+// If is_null is not null, null rows are filtered. Values of null rows are
+// read as well, so this is only used for types which are safe to compare
+// whatever the value is.
+template<class type, class Predicate>
+inline uint16_t evaluate_dense(const type* col_vector, const bool* is_null,
+                               uint16_t n, uint16_t* sel, Predicate pred) {
+    uint8_t flags[PREDICATE_EVALUATE_BLOCK_SIZE];
+    uint16_t new_size = 0;
+    for (uint32_t base = 0; base < n; base += PREDICATE_EVALUATE_BLOCK_SIZE) {
+        uint32_t len = std::min<uint32_t>(n - base, PREDICATE_EVALUATE_BLOCK_SIZE);
+        const type* values = col_vector + base;
+        if (is_null == nullptr) {
+            for (uint32_t k = 0; k < len; ++k) {
+                flags[k] = pred(values[k]);
+            }
+        } else {
+            const bool* nulls = is_null + base;
+            for (uint32_t k = 0; k < len; ++k) {
+                flags[k] = (!nulls[k]) & pred(values[k]);
+            }
+        }
+        for (uint32_t k = 0; k < len; ++k) {
+            sel[new_size] = base + k;
+            new_size += flags[k];
+        }
+    }
+    return new_size;
+}
+
 } //namespace doris
 
 #endif //DORIS_BE_SRC_OLAP_COLUMN_PREDICATE_H
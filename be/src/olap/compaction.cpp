@@ -17,6 +17,11 @@
 
 #include "olap/compaction.h"
 
+#include "common/config.h"
+#include "olap/rowset/alpha_rowset.h"
+#include "olap/rowset/beta_rowset_writer.h"
+#include "olap/rowset_factory.h"
+
 using std::vector;
 
 namespace doris {
@@ -40,10 +45,38 @@ OLAPStatus Compaction::do_compaction() {
     _tablet->compute_version_hash_from_rowsets(_input_rowsets, &_output_version_hash);
 
     RETURN_NOT_OK(construct_output_rowset_writer());
+
+    if (config::enable_ordered_data_compaction && is_input_rowsets_non_overlapping()) {
+        // rows of input rowsets are already in order, link their files
+        RETURN_NOT_OK(do_compaction_by_linking());
+    } else {
+        RETURN_NOT_OK(do_compaction_by_merging());
+    }
+
+    // 4. modify rowsets in memory
+    RETURN_NOT_OK(modify_rowsets());
+    _tablet->update_primary_key_index(_input_rowsets, _output_rowset);
+
+    LOG(INFO) << "succeed to do " << compaction_name()
+              << ". tablet=" << _tablet->full_name()
+              << ", output_version=" << _output_version.first
+              << "-" << _output_version.second
+              << ". elapsed time=" << watch.get_elapse_second() << "s.";
+
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus Compaction::do_compaction_by_merging() {
     RETURN_NOT_OK(construct_input_rowset_readers());
 
     Merger merger(_tablet, compaction_type(), _output_rs_writer, _input_rs_readers);
-    OLAPStatus res = merger.merge();
+    OLAPStatus res = OLAP_SUCCESS;
+    if (config::enable_vertical_compaction
+            && std::dynamic_pointer_cast<BetaRowsetWriter>(_output_rs_writer) != nullptr) {
+        res = merger.vertical_merge();
+    } else {
+        res = merger.merge();
+    }
 
     // 2. 如果merge失败，执行清理工作，返回错误码退出
     if (res != OLAP_SUCCESS) {
@@ -65,19 +98,58 @@ OLAPStatus Compaction::do_compaction() {
 
     // 3. check correctness
     RETURN_NOT_OK(check_correctness(merger));
+    return OLAP_SUCCESS;
+}
 
-    // 4. modify rowsets in memory
-    RETURN_NOT_OK(modify_rowsets());
+OLAPStatus Compaction::do_compaction_by_linking() {
+    int64_t input_row_num = 0;
+    for (auto& rowset : _input_rowsets) {
+        RETURN_NOT_OK(rowset->load());
+        OLAPStatus res = _output_rs_writer->add_rowset(rowset);
+        if (res != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to link rowset in " << compaction_name()
+                         << ". res=" << res
+                         << ", tablet=" << _tablet->full_name()
+                         << ", rowset=" << rowset->rowset_id();
+            return res;
+        }
+        input_row_num += rowset->num_rows();
+    }
+    RETURN_NOT_OK(_output_rs_writer->flush());
 
-    LOG(INFO) << "succeed to do " << compaction_name()
-              << ". tablet=" << _tablet->full_name()
-              << ", output_version=" << _output_version.first
-              << "-" << _output_version.second
-              << ". elapsed time=" << watch.get_elapse_second() << "s.";
+    _output_rowset = _output_rs_writer->build();
+    if (_output_rowset == nullptr) {
+        LOG(WARNING) << "rowset writer build failed. writer version:"
+                     << ", output_version=" << _output_version.first
+                     << "-" << _output_version.second;
+        return OLAP_ERR_MALLOC_ERROR;
+    }
 
+    if (input_row_num != _output_rowset->num_rows()) {
+        LOG(WARNING) << "row_num does not match between input and linked output! "
+                     << "input_row_num=" << input_row_num
+                     << ", output_row_num=" << _output_rowset->num_rows();
+        return OLAP_ERR_CHECK_LINES_ERROR;
+    }
+    LOG(INFO) << "do " << compaction_name() << " by linking rowsets of ordered data."
+              << " tablet=" << _tablet->full_name()
+              << ", output_version=" << _output_version.first
+              << "-" << _output_version.second;
     return OLAP_SUCCESS;
 }
 
+bool Compaction::is_input_rowsets_non_overlapping() {
+    for (auto& rowset : _input_rowsets) {
+        // deleted rows should be filtered by merging
+        if (rowset->rowset_meta()->has_delete_predicate()
+                || rowset->rowset_meta()->delete_flag()) {
+            return false;
+        }
+    }
+    return AlphaRowset::is_rowsets_non_overlapping(
+            _input_rowsets, _tablet->tablet_schema().num_key_columns());
+}
+
 OLAPStatus Compaction::construct_output_rowset_writer() {
     RowsetId rowset_id = 0;
     RETURN_NOT_OK(_tablet->next_rowset_id(&rowset_id));
@@ -92,12 +164,11 @@ OLAPStatus Compaction::construct_output_rowset_writer() {
     context.tablet_schema = &(_tablet->tablet_schema());
     context.rowset_state = VISIBLE;
     context.data_dir = _tablet->data_dir();
+    context.io_class = IOClass::COMPACTION;
     context.version = _output_version;
     context.version_hash = _output_version_hash;
 
-    _output_rs_writer.reset(new (std::nothrow)AlphaRowsetWriter());
-    RETURN_NOT_OK(_output_rs_writer->init(context));
-    return OLAP_SUCCESS;
+    return RowsetFactory::create_rowset_writer(context, &_output_rs_writer);
 }
 
 OLAPStatus Compaction::construct_input_rowset_readers() {
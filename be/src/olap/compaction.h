@@ -54,6 +54,14 @@ protected:
     virtual ReaderType compaction_type() const = 0;
 
     OLAPStatus do_compaction();
+    // merge rows of input rowsets and write them into output rowset
+    OLAPStatus do_compaction_by_merging();
+    // build output rowset by hard linking files of input rowsets, only used
+    // when is_input_rowsets_non_overlapping() is true
+    OLAPStatus do_compaction_by_linking();
+    // return true if input rowsets have no deleted rows, and key ranges of
+    // all their segment groups are ordered and don't overlap with each other
+    bool is_input_rowsets_non_overlapping();
     OLAPStatus modify_rowsets();
     OLAPStatus gc_unused_rowsets();
 
@@ -61,6 +61,7 @@ COMPARISON_PRED_CONSTRUCTOR_STRING(GreaterEqualPredicate)
         } \
         uint16_t* sel = batch->selected(); \
         const type* col_vector = reinterpret_cast<const type*>(batch->column(_column_id)->col_data()); \
+        auto pred = [this](const type& value) -> bool { return value OP _value; }; \
         uint16_t new_size = 0; \
         if (batch->column(_column_id)->no_nulls()) { \
             if (batch->selected_in_use()) { \
@@ -71,10 +72,7 @@ COMPARISON_PRED_CONSTRUCTOR_STRING(GreaterEqualPredicate)
                 } \
                 batch->set_size(new_size); \
             } else { \
-                for (uint16_t i = 0; i !=n; ++i) { \
-                    sel[new_size] = i; \
-                    new_size += (col_vector[i] OP _value); \
-                } \
+                new_size = evaluate_dense(col_vector, nullptr, n, sel, pred); \
                 if (new_size < n) { \
                     batch->set_size(new_size); \
                     batch->set_selected_in_use(true); \
@@ -90,9 +88,13 @@ COMPARISON_PRED_CONSTRUCTOR_STRING(GreaterEqualPredicate)
                 } \
                 batch->set_size(new_size); \
             } else { \
-                for (uint16_t i = 0; i !=n; ++i) { \
-                    sel[new_size] = i; \
-                    new_size += (!is_null[i] && (col_vector[i] OP _value)); \
+                if (is_dense_evaluable<type>::value) { \
+                    new_size = evaluate_dense(col_vector, is_null, n, sel, pred); \
+                } else { \
+                    for (uint16_t i = 0; i !=n; ++i) { \
+                        sel[new_size] = i; \
+                        new_size += (!is_null[i] && (col_vector[i] OP _value)); \
+                    } \
                 } \
                 if (new_size < n) { \
                     batch->set_size(new_size); \
@@ -18,6 +18,7 @@
 #include "olap/data_dir.h"
 
 #include <ctype.h>
+#include <limits.h>
 #include <mntent.h>
 #include <mntent.h>
 #include <stdio.h>
@@ -26,9 +27,14 @@
 #include <sys/statfs.h>
 #include <utime.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <map>
 #include <set>
 #include <sstream>
+#include <thread>
+#include <tuple>
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -42,7 +48,10 @@
 #include "olap/olap_snapshot_converter.h"
 #include "olap/utils.h" // for check_dir_existed
 #include "service/backend_options.h"
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
 #include "util/file_utils.h"
+#include "util/thread_pool.hpp"
 #include "util/string_util.h"
 #include "olap/tablet_meta_manager.h"
 #include "olap/rowset/rowset_meta_manager.h"
@@ -105,11 +114,19 @@ Status DataDir::init() {
     RETURN_IF_ERROR(_init_file_system());
     RETURN_IF_ERROR(_init_meta());
 
+    int disk_id = DiskInfo::disk_id(_path.c_str());
+    if (disk_id >= 0 && DiskInfo::numa_node(disk_id) < CpuInfo::get_max_num_numa_nodes()) {
+        _numa_node = DiskInfo::numa_node(disk_id);
+    }
+    LOG(INFO) << "data dir " << _path << " is on numa node " << _numa_node;
+
     _id_generator = new RowsetIdGenerator(_meta);
     auto res = _id_generator->init();
     if (res != OLAP_SUCCESS) {
         return Status::InternalError("Id generator initialized failed.");
     }
+    _flush_pool.reset(new ThreadPool(config::flush_thread_num_per_store,
+                                     config::flush_queue_size_per_store));
 
     _is_used = true;
     return Status::OK();
@@ -260,8 +277,12 @@ Status DataDir::_init_file_system() {
     }
 
     bool is_find = false;
+    // data dirs are initialized in parallel, use reentrant version of getmntent
+    struct mntent mount_entry_buf;
+    char mount_str_buf[PATH_MAX * 4];
     struct mntent* mount_entry = NULL;
-    while ((mount_entry = getmntent(mount_tablet)) != NULL) {
+    while ((mount_entry = getmntent_r(mount_tablet, &mount_entry_buf,
+                                      mount_str_buf, sizeof(mount_str_buf))) != NULL) {
         if (strcmp(_path.c_str(), mount_entry->mnt_dir) == 0
                 || strcmp(_path.c_str(), mount_entry->mnt_fsname) == 0) {
             is_find = true;
@@ -760,25 +781,48 @@ OLAPStatus DataDir::load() {
 
     // load tablet
     // create tablet from tablet meta and add it to tablet mgr
+    // decoding tablet meta costs most of the time, so collect metas first
+    // and load tablets by several threads
     LOG(INFO) << "begin loading tablet from meta";
-    std::set<int64_t> tablet_ids;
-    auto load_tablet_func = [this, &tablet_ids](int64_t tablet_id,
+    std::vector<std::tuple<int64_t, int32_t, std::string>> tablet_metas;
+    auto collect_tablet_func = [&tablet_metas](int64_t tablet_id,
         int32_t schema_hash, const std::string& value) -> bool {
-        OLAPStatus status = _tablet_manager->load_tablet_from_meta(
-                                this, tablet_id, schema_hash, value, false, false);
-        if (status != OLAP_SUCCESS) {
-            LOG(WARNING) << "load tablet from header failed. status:" << status
-                << ", tablet=" << tablet_id << "." << schema_hash;
-        } else {
-            tablet_ids.insert(tablet_id);
-        }
+        tablet_metas.emplace_back(tablet_id, schema_hash, value);
         return true;
     };
-    OLAPStatus load_tablet_status = TabletMetaManager::traverse_headers(_meta, load_tablet_func);
+    OLAPStatus load_tablet_status = TabletMetaManager::traverse_headers(_meta, collect_tablet_func);
+
+    std::atomic<size_t> next_tablet_idx(0);
+    auto load_tablet_func = [this, &tablet_metas, &next_tablet_idx] {
+        for (size_t i = next_tablet_idx++; i < tablet_metas.size(); i = next_tablet_idx++) {
+            int64_t tablet_id = std::get<0>(tablet_metas[i]);
+            int32_t schema_hash = std::get<1>(tablet_metas[i]);
+            OLAPStatus status = _tablet_manager->load_tablet_from_meta(
+                                    this, tablet_id, schema_hash, std::get<2>(tablet_metas[i]),
+                                    false, false);
+            if (status != OLAP_SUCCESS) {
+                LOG(WARNING) << "load tablet from header failed. status:" << status
+                    << ", tablet=" << tablet_id << "." << schema_hash;
+            }
+            // release meta binary as soon as possible
+            std::string().swap(std::get<2>(tablet_metas[i]));
+        }
+    };
+    int32_t thread_num = std::max(1,
+        std::min(config::load_tablet_thread_num_per_store, static_cast<int32_t>(tablet_metas.size())));
+    std::vector<std::thread> load_threads;
+    for (int32_t i = 1; i < thread_num; ++i) {
+        load_threads.emplace_back(load_tablet_func);
+    }
+    load_tablet_func();
+    for (auto& thread : load_threads) {
+        thread.join();
+    }
     if (load_tablet_status != OLAP_SUCCESS) {
         LOG(WARNING) << "there is failure when loading tablet headers, path:" << _path;
     } else {
-        LOG(INFO) << "load rowset from meta finished, data dir: " << _path;
+        LOG(INFO) << "load tablet from meta finished, data dir: " << _path
+                  << ", tablet num: " << tablet_metas.size();
     }
 
     // tranverse rowset 
@@ -938,7 +982,11 @@ void DataDir::perform_path_gc_by_rowsetid() {
     // init the set of valid path
     // validate the path in data dir
     std::unique_lock<std::mutex> lck(_check_path_mutex);
-    cv.wait(lck, [this]{return _all_check_paths.size() > 0;});
+    int32_t interval = std::max(config::path_gc_check_interval_second, 1);
+    if (!cv.wait_for(lck, std::chrono::seconds(interval),
+                     [this]{return _all_check_paths.size() > 0;})) {
+        return;
+    }
     LOG(INFO) << "start to path gc by rowsetid.";
     int counter = 0;
     for (auto& path : _all_check_paths) {
@@ -946,6 +994,7 @@ void DataDir::perform_path_gc_by_rowsetid() {
         if (config::path_gc_check_step > 0 && counter % config::path_gc_check_step == 0) {
             usleep(config::path_gc_check_step_interval_ms * 1000);
         }
+        _io_scheduler.acquire(IOClass::GC, 1);
         TTabletId tablet_id = -1;
         TSchemaHash schema_hash = -1;
         bool is_valid = _tablet_manager->get_tablet_id_and_schema_hash_from_path(path,
@@ -983,6 +1032,106 @@ void DataDir::perform_path_gc_by_rowsetid() {
     LOG(INFO) << "finished one time path gc by rowsetid.";
 }
 
+void DataDir::add_gc_candidate_rowset(const std::string& rowset_path, RowsetId rowset_id) {
+    std::string key = GC_ROWSET_PREFIX + rowset_path + "/" + std::to_string(rowset_id);
+    OLAPStatus res = _meta->put(META_COLUMN_FAMILY_INDEX, key, "");
+    if (res != OLAP_SUCCESS) {
+        // files of this rowset are still collected by path gc after full path scan
+        LOG(WARNING) << "fail to add gc candidate rowset:" << key << ", res:" << res;
+    }
+}
+
+void DataDir::remove_gc_candidate_rowset(const std::string& rowset_path, RowsetId rowset_id) {
+    std::string key = GC_ROWSET_PREFIX + rowset_path + "/" + std::to_string(rowset_id);
+    OLAPStatus res = _meta->remove(META_COLUMN_FAMILY_INDEX, key);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to remove gc candidate rowset:" << key << ", res:" << res;
+    }
+}
+
+void DataDir::perform_path_gc_by_candidates() {
+    // rowset path -> candidate rowset ids under it
+    std::map<std::string, std::set<RowsetId>> candidates;
+    auto collect_func = [&candidates](const std::string& key, const std::string& value) -> bool {
+        size_t pos = key.rfind('/');
+        if (pos == std::string::npos || pos < GC_ROWSET_PREFIX.size()) {
+            LOG(WARNING) << "invalid gc candidate rowset key:" << key;
+            return true;
+        }
+        std::string rowset_path = key.substr(GC_ROWSET_PREFIX.size(),
+                                             pos - GC_ROWSET_PREFIX.size());
+        RowsetId rowset_id = std::strtoll(key.c_str() + pos + 1, nullptr, 10);
+        candidates[rowset_path].insert(rowset_id);
+        return true;
+    };
+    OLAPStatus res = _meta->iterate(META_COLUMN_FAMILY_INDEX, GC_ROWSET_PREFIX, collect_func);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to get gc candidate rowsets of data dir:" << _path << ", res:" << res;
+        return;
+    }
+    if (candidates.empty()) {
+        return;
+    }
+
+    LOG(INFO) << "start to path gc by candidates. rowset path num:" << candidates.size();
+    size_t finished_num = 0;
+    for (const auto& it : candidates) {
+        std::set<RowsetId> finished_ids;
+        _gc_candidate_rowsets(it.first, it.second, &finished_ids);
+        for (RowsetId rowset_id : finished_ids) {
+            remove_gc_candidate_rowset(it.first, rowset_id);
+        }
+        finished_num += finished_ids.size();
+    }
+    LOG(INFO) << "finished one time path gc by candidates. finished rowset num:" << finished_num;
+}
+
+void DataDir::_gc_candidate_rowsets(const std::string& rowset_path,
+                                    const std::set<RowsetId>& rowset_ids,
+                                    std::set<RowsetId>* finished_ids) {
+    TTabletId tablet_id = -1;
+    TSchemaHash schema_hash = -1;
+    TabletSharedPtr tablet;
+    if (_tablet_manager->get_tablet_id_and_schema_hash_from_path(rowset_path,
+            &tablet_id, &schema_hash) && tablet_id > 0 && schema_hash > 0) {
+        tablet = _tablet_manager->get_tablet(tablet_id, schema_hash);
+    }
+    if (tablet == nullptr || !check_dir_existed(rowset_path)) {
+        // files of dropped tablet are removed together with its dir
+        // by tablet gc and trash sweep
+        finished_ids->insert(rowset_ids.begin(), rowset_ids.end());
+        return;
+    }
+
+    _io_scheduler.acquire(IOClass::GC, 1);
+    std::set<std::string> files;
+    if (dir_walk(rowset_path, nullptr, &files) != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to walk dir. [path=" << rowset_path << "]";
+        return;
+    }
+
+    for (RowsetId rowset_id : rowset_ids) {
+        // rowset is still referenced or its files are not removed yet,
+        // check it again in next round
+        if (StorageEngine::instance()->check_rowset_id_in_unused_rowsets(rowset_id)
+                || _check_pending_ids(ROWSET_ID_PREFIX + std::to_string(rowset_id))) {
+            continue;
+        }
+        // files of rowset which is visible or committed in tablet are not garbage
+        if (!tablet->check_rowset_id(rowset_id)
+                && !RowsetMetaManager::check_rowset_meta(_meta, tablet->tablet_uid(), rowset_id)) {
+            std::string file_prefix = std::to_string(rowset_id) + "_";
+            for (const auto& file : files) {
+                if (boost::starts_with(file, file_prefix)) {
+                    _io_scheduler.acquire(IOClass::GC, 1);
+                    _process_garbage_path(rowset_path + "/" + file);
+                }
+            }
+        }
+        finished_ids->insert(rowset_id);
+    }
+}
+
 // path producer
 void DataDir::perform_path_scan() {
     {
@@ -1006,6 +1155,7 @@ void DataDir::perform_path_scan() {
                 continue;
             }
             for (const auto& tablet_id : tablet_ids) {
+                _io_scheduler.acquire(IOClass::GC, 1);
                 std::string tablet_id_path = shard_path + "/" + tablet_id;
                 _all_check_paths.insert(tablet_id_path);
                 std::set<std::string> schema_hashes;
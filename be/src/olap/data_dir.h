@@ -22,15 +22,19 @@
 #include <string>
 #include <mutex>
 #include <condition_variable>
+#include <memory>
 
 #include "common/status.h"
 #include "gen_cpp/Types_types.h"
+#include "olap/io_scheduler.h"
 #include "olap/olap_common.h"
 #include "olap/storage_engine.h"
 #include "olap/rowset/rowset_id_generator.h"
 
 namespace doris {
 
+class ThreadPool;
+
 // A DataDir used to manange data in same path.
 // Now, After DataDir was created, it will never be deleted for easy implementation.
 class DataDir {
@@ -74,6 +78,9 @@ public:
 
     TStorageMedium::type storage_medium() const { return _storage_medium; }
 
+    // NUMA node of the disk of this store, -1 if unknown
+    int numa_node() const { return _numa_node; }
+
     OLAPStatus register_tablet(Tablet* tablet);
     OLAPStatus deregister_tablet(Tablet* tablet);
     void clear_tablets(std::vector<TabletInfo>* tablet_infos);
@@ -113,14 +120,34 @@ public:
     // this function will collect garbage paths scaned by last function
     void perform_path_gc();
 
+    // wait at most path_gc_check_interval_second for paths scaned by
+    // perform_path_scan, and collect garbage rowset files among them
     void perform_path_gc_by_rowsetid();
 
+    // record that files of rowset `rowset_id` under `rowset_path` may become
+    // garbage, so that they are checked by perform_path_gc_by_candidates
+    // without scanning the whole data dir. Candidates are persisted in meta
+    // and survive restarts.
+    void add_gc_candidate_rowset(const std::string& rowset_path, RowsetId rowset_id);
+
+    void remove_gc_candidate_rowset(const std::string& rowset_path, RowsetId rowset_id);
+
+    // collect garbage files of rowsets recorded by add_gc_candidate_rowset
+    void perform_path_gc_by_candidates();
+
     OLAPStatus remove_old_meta_and_files();
 
     bool convert_old_data_success();
 
     OLAPStatus set_convert_finished();
 
+    // thread pool to flush memtables of tablets in this store, null if
+    // this store is not initialized
+    ThreadPool* flush_pool() { return _flush_pool.get(); }
+
+    // scheduler to limit total write rate of loads and compactions on this store
+    IOScheduler* io_scheduler() { return &_io_scheduler; }
+
 private:
     std::string _cluster_id_path() const { return _path + CLUSTER_ID_PREFIX; }
     Status _init_cluster_id();
@@ -144,6 +171,12 @@ private:
 
     bool _check_pending_ids(const std::string& id);
 
+    // check candidate rowsets under one tablet schema hash path, return ids of
+    // rowsets which are checked and should not be candidates any more
+    void _gc_candidate_rowsets(const std::string& rowset_path,
+                               const std::set<RowsetId>& rowset_ids,
+                               std::set<RowsetId>* finished_ids);
+
 private:
     std::string _path;
     size_t _path_hash;
@@ -163,6 +196,7 @@ private:
 
     std::mutex _mutex;
     TStorageMedium::type _storage_medium;  // 存储介质类型：SSD|HDD
+    int _numa_node = -1;
     std::set<TabletInfo> _tablet_set;
 
     static const size_t TEST_FILE_BUF_SIZE = 4096;
@@ -182,6 +216,11 @@ private:
 
     // used in convert process
     bool _convert_old_data_success;
+
+    std::unique_ptr<ThreadPool> _flush_pool;
+
+    // schedule IO of queries, loads and compactions on this data dir
+    IOScheduler _io_scheduler;
 };
 
 } // namespace doris
@@ -287,6 +287,7 @@ OLAPStatus DeleteHandler::init(const TabletSchema& schema,
                 OLAP_LOG_WARNING("fail to append condition.[res=%d]", res);
                 return res;
             }
+            temp.sub_conditions.push_back(condition);
         }
 
         _del_conds.push_back(temp);
@@ -29,6 +29,7 @@
 namespace doris {
 
 typedef google::protobuf::RepeatedPtrField<DeletePredicatePB> DelPredicateArray;
+class ColumnPredicate;
 class Conditions;
 class RowCursor;
 
@@ -77,6 +78,19 @@ struct DeleteConditions {
 
     int32_t filter_version; // 删除条件版本号
     Conditions* del_cond;   // 删除条件
+    // parsed sub predicates of del_cond, from which DeletePredicates are made
+    std::vector<TCondition> sub_conditions;
+};
+
+// Delete conditions of one version compiled into column predicates, so that
+// rows of a block are filtered together on VectorizedRowBatch instead of by
+// DeleteHandler::is_filter_data() row by row. Rows of versions not greater
+// than filter_version which satisfy all predicates are deleted.
+struct DeletePredicates {
+    int32_t filter_version = 0;
+    std::vector<ColumnPredicate*> predicates;
+    // columns of predicates, which must be read
+    std::vector<uint32_t> column_ids;
 };
 
 // 这个类主要用于判定一条数据(RowCursor)是否符合删除条件。这个类的使用流程如下：
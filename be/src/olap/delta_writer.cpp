@@ -23,27 +23,31 @@
 #include "olap/rowset/alpha_rowset_writer.h"
 #include "olap/rowset/rowset_meta_manager.h"
 #include "olap/rowset/rowset_id_generator.h"
+#include "runtime/mem_tracker.h"
+#include "util/thread_pool.hpp"
 
 namespace doris {
 
-OLAPStatus DeltaWriter::open(WriteRequest* req, DeltaWriter** writer) {
-    *writer = new DeltaWriter(req);
+OLAPStatus DeltaWriter::open(WriteRequest* req, DeltaWriter** writer, MemTracker* mem_tracker) {
+    *writer = new DeltaWriter(req, mem_tracker);
     return OLAP_SUCCESS;
 }
 
-DeltaWriter::DeltaWriter(WriteRequest* req)
+DeltaWriter::DeltaWriter(WriteRequest* req, MemTracker* mem_tracker)
     : _req(*req), _tablet(nullptr),
       _cur_rowset(nullptr), _new_rowset(nullptr), _new_tablet(nullptr),
-      _rowset_writer(nullptr), _mem_table(nullptr),
+      _rowset_writer(nullptr), _mem_table(nullptr), _mem_tracker(mem_tracker),
       _schema(nullptr), _tablet_schema(nullptr),
       _delta_written_success(false) {}
 
 DeltaWriter::~DeltaWriter() {
+    wait_flush();
     if (!_delta_written_success) {
         _garbage_collection();
     }
 
-    SAFE_DELETE(_mem_table);
+    _delete_mem_table(_mem_table, _mem_table_consumption);
+    _mem_table = nullptr;
     SAFE_DELETE(_schema);
     if (_rowset_writer != nullptr) {
         _rowset_writer->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX + std::to_string(_rowset_writer->rowset_id()));
@@ -154,8 +158,7 @@ OLAPStatus DeltaWriter::init() {
     }
     _tablet_schema = &(_tablet->tablet_schema());
     _schema = new Schema(*_tablet_schema);
-    _mem_table = new MemTable(_schema, _tablet_schema, &_col_ids,
-                              _req.tuple_desc, _tablet->keys_type());
+    _new_mem_table();
     _is_init = true;
     return OLAP_SUCCESS;
 }
@@ -169,16 +172,101 @@ OLAPStatus DeltaWriter::write(Tuple* tuple) {
     }
 
     _mem_table->insert(tuple);
+    ++_mem_table_num_rows;
+    if (_mem_tracker != nullptr) {
+        int64_t usage = _mem_table->memory_usage();
+        _mem_tracker->consume(usage - _mem_table_consumption);
+        _mem_table_consumption = usage;
+    }
     if (_mem_table->memory_usage() >= config::write_buffer_size) {
-        RETURN_NOT_OK(_mem_table->flush(_rowset_writer));
+        return flush_memtable();
+    }
+    return OLAP_SUCCESS;
+}
+
+int64_t DeltaWriter::mem_consumption() const {
+    if (_mem_table == nullptr || _mem_table_num_rows == 0) {
+        return 0;
+    }
+    return _mem_table->memory_usage();
+}
+
+OLAPStatus DeltaWriter::flush_memtable() {
+    if (_mem_table == nullptr || _mem_table_num_rows == 0) {
+        return OLAP_SUCCESS;
+    }
+    MemTable* mem_table = _mem_table;
+    int64_t consumption = _mem_table_consumption;
+    _new_mem_table();
+    return _flush_memtable_async(mem_table, consumption);
+}
+
+void DeltaWriter::_new_mem_table() {
+    _mem_table = new MemTable(_schema, _tablet_schema, &_col_ids,
+                              _req.tuple_desc, _tablet->keys_type());
+    _mem_table_num_rows = 0;
+    _mem_table_consumption = 0;
+    if (_mem_tracker != nullptr) {
+        _mem_table_consumption = _mem_table->memory_usage();
+        _mem_tracker->consume(_mem_table_consumption);
+    }
+}
 
-        SAFE_DELETE(_mem_table);
-        _mem_table = new MemTable(_schema, _tablet_schema, &_col_ids,
-                                  _req.tuple_desc, _tablet->keys_type());
+void DeltaWriter::_delete_mem_table(MemTable* mem_table, int64_t consumption) {
+    if (mem_table == nullptr) {
+        return;
+    }
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->release(consumption);
+    }
+    delete mem_table;
+}
+
+OLAPStatus DeltaWriter::_flush_memtable_async(MemTable* mem_table, int64_t consumption) {
+    {
+        std::unique_lock<std::mutex> l(_flush_lock);
+        while (_flush_running) {
+            _flush_cond.wait(l);
+        }
+        if (_flush_status != OLAP_SUCCESS) {
+            _delete_mem_table(mem_table, consumption);
+            return _flush_status;
+        }
+        _flush_running = true;
+    }
+    ThreadPool* flush_pool = _tablet->data_dir()->flush_pool();
+    if (flush_pool == nullptr
+            || !flush_pool->offer(boost::bind<void>(&DeltaWriter::_flush_memtable, this, mem_table, consumption))) {
+        // flush in current thread if data dir has no flush pool or it is shut down
+        _flush_memtable(mem_table, consumption);
     }
     return OLAP_SUCCESS;
 }
 
+void DeltaWriter::_flush_memtable(MemTable* mem_table, int64_t consumption) {
+    OLAPStatus st = mem_table->flush(_rowset_writer);
+    if (st != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to flush memtable. tablet_id: " << _req.tablet_id
+                     << ", txn_id: " << _req.txn_id << ", status: " << st;
+    }
+    _delete_mem_table(mem_table, consumption);
+
+    std::lock_guard<std::mutex> l(_flush_lock);
+    if (st != OLAP_SUCCESS) {
+        _flush_status = st;
+    }
+    _flush_running = false;
+    _flush_cond.notify_all();
+}
+
+OLAPStatus DeltaWriter::wait_flush() {
+    std::unique_lock<std::mutex> l(_flush_lock);
+    while (_flush_running) {
+        _flush_cond.wait(l);
+    }
+    return _flush_status;
+}
+
 OLAPStatus DeltaWriter::close(google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec) {
     if (!_is_init) {
         auto st = init();
@@ -186,7 +274,10 @@ OLAPStatus DeltaWriter::close(google::protobuf::RepeatedPtrField<PTabletInfo>* t
             return st;
         }
     }
+    RETURN_NOT_OK(wait_flush());
     RETURN_NOT_OK(_mem_table->close(_rowset_writer));
+    _delete_mem_table(_mem_table, _mem_table_consumption);
+    _mem_table = nullptr;
 
     OLAPStatus res = OLAP_SUCCESS;
     // use rowset meta manager to save meta
@@ -18,6 +18,9 @@
 #ifndef DORIS_BE_SRC_DELTA_WRITER_H
 #define DORIS_BE_SRC_DELTA_WRITER_H
 
+#include <condition_variable>
+#include <mutex>
+
 #include "olap/storage_engine.h"
 #include "olap/tablet.h"
 #include "olap/schema_change.h"
@@ -30,6 +33,7 @@ namespace doris {
 
 class SegmentGroup;
 class MemTable;
+class MemTracker;
 class Schema;
 
 enum WriteType {
@@ -51,9 +55,11 @@ struct WriteRequest {
 
 class DeltaWriter {
 public:
-    static OLAPStatus open(WriteRequest* req, DeltaWriter** writer);
+    // memory of memtables is consumed on mem_tracker if it is not null
+    static OLAPStatus open(WriteRequest* req, DeltaWriter** writer,
+                           MemTracker* mem_tracker = nullptr);
     OLAPStatus init();
-    DeltaWriter(WriteRequest* req);
+    DeltaWriter(WriteRequest* req, MemTracker* mem_tracker);
     ~DeltaWriter();
     OLAPStatus write(Tuple* tuple);
     OLAPStatus close(google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec);
@@ -61,10 +67,35 @@ public:
     OLAPStatus cancel();
 
     int64_t partition_id() const { return _req.partition_id; }
+    int64_t tablet_id() const { return _req.tablet_id; }
+    TabletSharedPtr tablet() const { return _tablet; }
+    // rowset committed by close, it is null before close succeeds
+    RowsetSharedPtr cur_rowset() const { return _cur_rowset; }
+
+    // memory used by the memtable being written, memtables being flushed
+    // are not counted because they can't be reduced any more
+    int64_t mem_consumption() const;
+
+    // flush the memtable being written in background to reduce memory,
+    // wait_flush() should be called to wait it finish
+    OLAPStatus flush_memtable();
+    // wait the pending flush to finish and return its status
+    OLAPStatus wait_flush();
 
 private:
     void _garbage_collection();
 
+    // Hand over the full memtable to the flush pool of data dir, so that
+    // the next memtable can be filled while it is being flushed. It blocks
+    // until the previous flush of this writer is done, because the rowset
+    // writer only accepts rows in order.
+    OLAPStatus _flush_memtable_async(MemTable* mem_table, int64_t consumption);
+    // flush and delete mem_table, run in flush pool
+    void _flush_memtable(MemTable* mem_table, int64_t consumption);
+    void _new_mem_table();
+    // consumption is the bytes consumed on mem_tracker for mem_table
+    void _delete_mem_table(MemTable* mem_table, int64_t consumption);
+
 private:
     bool _is_init = false;
     WriteRequest _req;
@@ -74,10 +105,22 @@ private:
     TabletSharedPtr _new_tablet;
     RowsetWriterSharedPtr _rowset_writer;
     MemTable* _mem_table;
+    size_t _mem_table_num_rows = 0;
+    // bytes consumed on mem_tracker for _mem_table, memory usage of a memtable
+    // may change during flush, so exactly these are released
+    int64_t _mem_table_consumption = 0;
+    MemTracker* _mem_tracker;
     Schema* _schema;
     const TabletSchema* _tablet_schema;
     std::vector<uint32_t> _col_ids;
     bool _delta_written_success;
+
+    std::mutex _flush_lock;
+    std::condition_variable _flush_cond;
+    // whether there is a memtable being flushed in flush pool
+    bool _flush_running = false;
+    // status of the last failed flush, write will fail after it
+    OLAPStatus _flush_status = OLAP_SUCCESS;
 };
 
 }  // namespace doris
@@ -312,8 +312,15 @@ template<typename DstCellType, typename SrcCellType>
 void Field::agg_init(DstCellType* dst, const SrcCellType& src) const {
     // TODO(zc): This function is also used to initialize key columns.
     // So, refactor this in later PR
-    if (OLAP_LIKELY(type() != OLAP_FIELD_TYPE_HLL)) {
+    bool is_bitmap_union = _agg_info != nullptr
+        && _agg_info->agg_method() == OLAP_FIELD_AGGREGATION_BITMAP_UNION;
+    if (OLAP_LIKELY(type() != OLAP_FIELD_TYPE_HLL && !is_bitmap_union)) {
         direct_copy(dst, src);
+    } else if (is_bitmap_union) {
+        // Start from an empty bitmap state rather than copying the serialized bitmap
+        // into dst, whose buffer is only as large as the column's declared length.
+        dst->set_is_null(true);
+        agg_update(dst, src);
     } else {
         bool is_null = src.is_null();
         // TODO(zc): If source is null, can we set this to null?
@@ -17,6 +17,7 @@
 
 #include "olap/file_helper.h"
 
+#include <fcntl.h>
 #include <stdio.h>
 #include <sys/stat.h>
 
@@ -25,10 +26,13 @@
 
 #include <errno.h>
 
+#include "gutil/strings/substitute.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/utils.h"
 #include "util/debug_util.h"
+#include "util/doris_metrics.h"
+#include "util/slice.h"
 
 using std::string;
 
@@ -89,12 +93,14 @@ OLAPStatus FileHandler::open_with_cache(const string& file_name, int flag) {
     Cache* fd_cache = get_fd_cache();
     _cache_handle = fd_cache->lookup(key);
     if (NULL != _cache_handle) {
+        DorisMetrics::fd_cache_hit_total.increment(1);
         FileDescriptor* file_desc =
             reinterpret_cast<FileDescriptor*>(fd_cache->value(_cache_handle));
         _fd = file_desc->fd;
         VLOG(3) << "success to open file with cache. file_name=" << file_name
                 << ", mode=" << flag << " fd=" << _fd;
     } else {
+        DorisMetrics::fd_cache_miss_total.increment(1);
         _fd = ::open(file_name.c_str(), flag);
         if (_fd < 0) {
             char errmsg[64];
@@ -164,9 +170,10 @@ OLAPStatus FileHandler::close() {
     } else {
         // try to sync page cache if have written some bytes
         if (_wr_length > 0) {
+            // Clean dirty pages and wait for io queue empty, then drop them
+            sync_file_range(_fd, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE
+                            | SYNC_FILE_RANGE_WAIT_AFTER);
             posix_fadvise(_fd, 0, 0, POSIX_FADV_DONTNEED);
-            // Clean dirty pages and wait for io queue empty and return
-            sync_file_range(_fd, 0, 0, SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
             _wr_length = 0;
         }
 
@@ -215,6 +222,18 @@ OLAPStatus FileHandler::pread(void* buf, size_t size, size_t offset) {
     return OLAP_SUCCESS;
 }
 
+OLAPStatus FileHandler::prefetch(size_t size, size_t offset) {
+    int res = ::posix_fadvise(_fd, offset, size, POSIX_FADV_WILLNEED);
+    if (res != 0) {
+        char errmsg[64];
+        LOG(WARNING) << "failed to fadvise file. [err= " << strerror_r(res, errmsg, 64)
+                     << " file_name='" << _file_name << "' fd=" << _fd << " size=" << size
+                     << " offset=" << offset << "]";
+        return OLAP_ERR_IO_ERROR;
+    }
+    return OLAP_SUCCESS;
+}
+
 OLAPStatus FileHandler::write(const void* buf, size_t buf_size) {
 
     size_t org_buf_size = buf_size;
@@ -242,9 +261,11 @@ OLAPStatus FileHandler::write(const void* buf, size_t buf_size) {
     _wr_length += org_buf_size;
     // try to sync page cache if cache size is bigger than threshold
     if (_wr_length >= _cache_threshold) {
+        // Clean dirty pages and wait for io queue empty, dirty pages can't
+        // be dropped from page cache before written back
+        sync_file_range(_fd, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE
+                        | SYNC_FILE_RANGE_WAIT_AFTER);
         posix_fadvise(_fd, 0, 0, POSIX_FADV_DONTNEED);
-        // Clean dirty pages and wait for io queue empty and return
-        sync_file_range(_fd, 0, 0, SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
         _wr_length = 0;
     }
     return OLAP_SUCCESS;
@@ -291,6 +312,50 @@ off_t FileHandler::length() const {
     return stat_data.st_size;
 }
 
+Status CachedRandomAccessFile::open(const std::string& fname,
+                                    std::unique_ptr<RandomAccessFile>* result) {
+    if (FileHandler::get_fd_cache() == nullptr) {
+        return Env::Default()->new_random_access_file(fname, result);
+    }
+    std::unique_ptr<CachedRandomAccessFile> file(new CachedRandomAccessFile(fname));
+    if (file->_file_handler.open_with_cache(fname, O_RDONLY) != OLAP_SUCCESS) {
+        return Status::IOError(strings::Substitute("fail to open file $0", fname));
+    }
+    *result = std::move(file);
+    return Status::OK();
+}
+
+Status CachedRandomAccessFile::read_at(uint64_t offset, const Slice& result) const {
+    return readv_at(offset, &result, 1);
+}
+
+Status CachedRandomAccessFile::readv_at(uint64_t offset, const Slice* res, size_t res_cnt) const {
+    for (size_t i = 0; i < res_cnt; ++i) {
+        if (_file_handler.pread(res[i].data, res[i].size, offset) != OLAP_SUCCESS) {
+            return Status::IOError(strings::Substitute(
+                    "fail to read file $0, offset=$1, size=$2", _file_name, offset, res[i].size));
+        }
+        offset += res[i].size;
+    }
+    return Status::OK();
+}
+
+Status CachedRandomAccessFile::prefetch(uint64_t offset, size_t size) const {
+    if (_file_handler.prefetch(size, offset) != OLAP_SUCCESS) {
+        return Status::IOError(strings::Substitute("fail to prefetch file $0", _file_name));
+    }
+    return Status::OK();
+}
+
+Status CachedRandomAccessFile::size(uint64_t* size) const {
+    off_t length = _file_handler.length();
+    if (length < 0) {
+        return Status::IOError(strings::Substitute("fail to get size of file $0", _file_name));
+    }
+    *size = length;
+    return Status::OK();
+}
+
 FileHandlerWithBuf::FileHandlerWithBuf() :
     _fp(NULL),
     _file_name("") {
@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "env/env.h"
 #include "olap/lru_cache.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
@@ -54,6 +55,8 @@ public:
     OLAPStatus release();
 
     OLAPStatus pread(void* buf, size_t size, size_t offset);
+    // 提示内核预读[offset, offset + size)的数据到page cache, 不等待读取完成
+    OLAPStatus prefetch(size_t size, size_t offset);
     OLAPStatus write(const void* buf, size_t buf_size);
     OLAPStatus pwrite(const void* buf, size_t buf_size, size_t offset);
 
@@ -119,6 +122,36 @@ private:
     Cache::Handle* _cache_handle;
 };
 
+// RandomAccessFile whose file descriptor is shared through the fd cache of
+// FileHandler, so that segment_v2 files opened again and again by short
+// queries take no open(2) and close(2) just like alpha segment files.
+class CachedRandomAccessFile : public RandomAccessFile {
+public:
+    // Open fname with the fd cache. Fall back to Env::Default() if fd cache
+    // is not set, e.g. in tests without storage engine.
+    static Status open(const std::string& fname, std::unique_ptr<RandomAccessFile>* result);
+
+    ~CachedRandomAccessFile() override { }
+
+    Status read_at(uint64_t offset, const Slice& result) const override;
+
+    Status readv_at(uint64_t offset, const Slice* res, size_t res_cnt) const override;
+
+    Status prefetch(uint64_t offset, size_t size) const override;
+
+    Status size(uint64_t* size) const override;
+
+    const std::string& file_name() const override { return _file_name; }
+
+private:
+    CachedRandomAccessFile(std::string file_name) : _file_name(std::move(file_name)) { }
+
+    std::string _file_name;
+    // pread() and length() of FileHandler change no state, so they are safe
+    // to be called by multiple threads
+    mutable FileHandler _file_handler;
+};
+
 class FileHandlerWithBuf {
 public:
     FileHandlerWithBuf();
@@ -18,6 +18,9 @@
 #include "olap/hll.h"
 
 #include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include <map>
 #include <sstream>
 #include <string>
@@ -86,11 +89,7 @@ void HllSetResolver::fill_registers(char* registers, int len) {
                 std::max((uint8_t)registers[iter->first], (uint8_t)iter->second);
         }
     } else if (_set_type == HLL_DATA_FULL) {
-        char* full_value = get_full_value();
-        for (int i = 0; i < len; i++) {
-            registers[i] = std::max((uint8_t)registers[i], (uint8_t)full_value[i]);
-        }
-
+        HllSetHelper::merge_registers((uint8_t*)registers, (uint8_t*)get_full_value(), len);
     } else {
         // HLL_DATA_EMPTY
     }
@@ -207,6 +206,21 @@ void HllSetHelper::set_max_register(char* registers, int registers_len,
     }
 }
 
+void HllSetHelper::merge_registers(uint8_t* dst, const uint8_t* src, int len) {
+    int i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= len; i += 16) {
+        __m128i dst_value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i src_value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_max_epu8(dst_value, src_value));
+    }
+#endif
+    for (; i < len; ++i) {
+        dst[i] = std::max(dst[i], src[i]);
+    }
+}
+
 void HllSetHelper::fill_set(const char* data, HllContext* context) {
     HllSetResolver resolver;
     const Slice* slice = reinterpret_cast<const Slice*>(data);
@@ -32,6 +32,12 @@ const static int HLL_EXPLICLIT_INT64_NUM = 160;
 const static int HLL_REGISTERS_COUNT = 16384;
 // maximum size in byte of serialized HLL: type(1) + registers (2^14)
 const static int HLL_COLUMN_DEFAULT_LEN = 16385;
+// sparse set: type(1) + number of registers(4), followed by index(2) + value(1)
+// for every register that is not zero
+const static int HLL_SPARSE_HEADER_LEN = 5;
+const static int HLL_SPARSE_ENTRY_LEN = 3;
+// sparse sets built by aggregation turn into full sets beyond this many registers
+const static int HLL_SPARSE_MAX_REGISTERS = 1024;
 
 struct HllContext {
     bool has_value;
@@ -144,6 +150,8 @@ public:
     static void set_max_register(char *registers,
                                  int registers_len,
                                  const std::set<uint64_t>& hash_set);
+    // dst[i] = max(dst[i], src[i]) for all registers
+    static void merge_registers(uint8_t* dst, const uint8_t* src, int len);
     static void fill_set(const char* data, HllContext* context);
     static void init_context(HllContext* context);
 };
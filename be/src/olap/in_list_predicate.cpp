@@ -16,6 +16,9 @@
 // under the License.
 
 #include "olap/in_list_predicate.h"
+
+#include <algorithm>
+
 #include "olap/field.h"
 #include "runtime/string_value.hpp"
 #include "runtime/vectorized_row_batch.h"
@@ -26,11 +29,31 @@ namespace doris {
 template<class type> \
 CLASS<type>::CLASS(int column_id, std::set<type>&& values) \
     : _column_id(column_id), \
-      _values(std::move(values)) {} \
+      _values(values.begin(), values.end()) {} \
 
 IN_LIST_PRED_CONSTRUCTOR(InListPredicate)
 IN_LIST_PRED_CONSTRUCTOR(NotInListPredicate)
 
+// in lists with no more values than this are probed by comparing with every
+// value, which has no branch and can be vectorized by compiler
+static const size_t IN_LIST_LINEAR_PROBE_SIZE = 16;
+
+#define IN_LIST_PRED_CONTAINS(CLASS) \
+template<class type> \
+bool CLASS<type>::_contains(const type& value) const { \
+    if (_values.size() <= IN_LIST_LINEAR_PROBE_SIZE) { \
+        bool found = false; \
+        for (const type& v : _values) { \
+            found |= (v == value); \
+        } \
+        return found; \
+    } \
+    return std::binary_search(_values.begin(), _values.end(), value); \
+} \
+
+IN_LIST_PRED_CONTAINS(InListPredicate)
+IN_LIST_PRED_CONTAINS(NotInListPredicate)
+
 #define IN_LIST_PRED_EVALUATE(CLASS, OP) \
 template<class type> \
 void CLASS<type>::evaluate(VectorizedRowBatch* batch) const { \
@@ -40,20 +63,18 @@ void CLASS<type>::evaluate(VectorizedRowBatch* batch) const { \
     } \
     uint16_t* sel = batch->selected(); \
     const type* col_vector = reinterpret_cast<const type*>(batch->column(_column_id)->col_data()); \
+    auto pred = [this](const type& value) -> bool { return _contains(value) OP true; }; \
     uint16_t new_size = 0; \
     if (batch->column(_column_id)->no_nulls()) { \
         if (batch->selected_in_use()) { \
             for (uint16_t j = 0; j != n; ++j) { \
                 uint16_t i = sel[j]; \
                 sel[new_size] = i; \
-                new_size += (_values.find(col_vector[i]) OP _values.end()); \
+                new_size += (_contains(col_vector[i]) OP true); \
             } \
             batch->set_size(new_size); \
         } else { \
-            for (uint16_t i = 0; i != n; ++i) { \
-                sel[new_size] = i; \
-                new_size += (_values.find(col_vector[i]) OP _values.end()); \
-            } \
+            new_size = evaluate_dense(col_vector, nullptr, n, sel, pred); \
             if (new_size < n) { \
                 batch->set_size(new_size); \
                 batch->set_selected_in_use(true); \
@@ -65,13 +86,17 @@ void CLASS<type>::evaluate(VectorizedRowBatch* batch) const { \
             for (uint16_t j = 0; j != n; ++j) { \
                 uint16_t i = sel[j]; \
                 sel[new_size] = i; \
-                new_size += (!is_null[i] && _values.find(col_vector[i]) OP _values.end()); \
+                new_size += (!is_null[i] && (_contains(col_vector[i]) OP true)); \
             } \
             batch->set_size(new_size); \
         } else { \
-            for (int i = 0; i != n; ++i) { \
-                sel[new_size] = i; \
-                new_size += (!is_null[i] && _values.find(col_vector[i]) OP _values.end()); \
+            if (is_dense_evaluable<type>::value) { \
+                new_size = evaluate_dense(col_vector, is_null, n, sel, pred); \
+            } else { \
+                for (uint16_t i = 0; i != n; ++i) { \
+                    sel[new_size] = i; \
+                    new_size += (!is_null[i] && (_contains(col_vector[i]) OP true)); \
+                } \
             } \
             if (new_size < n) { \
                 batch->set_size(new_size); \
@@ -81,8 +106,8 @@ void CLASS<type>::evaluate(VectorizedRowBatch* batch) const { \
     } \
 } \
 
-IN_LIST_PRED_EVALUATE(InListPredicate, !=)
-IN_LIST_PRED_EVALUATE(NotInListPredicate, ==)
+IN_LIST_PRED_EVALUATE(InListPredicate, ==)
+IN_LIST_PRED_EVALUATE(NotInListPredicate, !=)
 
 #define IN_LIST_PRED_CONSTRUCTOR_DECLARATION(CLASS) \
     template CLASS<int8_t>::CLASS(int column_id, std::set<int8_t>&& values); \
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 #include <set>
+#include <vector>
 #include "olap/column_predicate.h"
 
 namespace doris {
@@ -34,8 +35,10 @@ public: \
     virtual ~CLASS() {} \
     virtual void evaluate(VectorizedRowBatch* batch) const override; \
 private: \
+    bool _contains(const type& value) const; \
     int32_t _column_id; \
-    std::set<type> _values; \
+    /* sorted and unique values, probed linearly if there are few of them */ \
+    std::vector<type> _values; \
 }; \
 
 IN_LIST_PRED_CLASS_DEFINE(InListPredicate)
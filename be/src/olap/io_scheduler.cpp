@@ -0,0 +1,103 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/io_scheduler.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "util/time.h"
+
+namespace doris {
+
+IOScheduler::IOScheduler() : _last_query_io_us(0) {
+    for (int i = 0; i < IO_CLASS_NUM; ++i) {
+        _next_io_us[i] = 0;
+    }
+}
+
+void IOScheduler::record_query_io(int64_t bytes) {
+    if (bytes > 0) {
+        _last_query_io_us.store(MonotonicMicros(), std::memory_order_relaxed);
+    }
+}
+
+bool IOScheduler::is_query_active() const {
+    int64_t last_us = _last_query_io_us.load(std::memory_order_relaxed);
+    return last_us > 0
+        && MonotonicMicros() - last_us < config::data_dir_query_io_active_ms * 1000L;
+}
+
+int64_t IOScheduler::_rate_per_sec(IOClass io_class) const {
+    if (io_class == IOClass::GC) {
+        int64_t files_per_sec = config::path_gc_files_per_sec;
+        if (config::path_gc_files_per_sec_on_query > 0 && is_query_active()) {
+            int64_t on_query = config::path_gc_files_per_sec_on_query;
+            files_per_sec = files_per_sec > 0 ? std::min(files_per_sec, on_query) : on_query;
+        }
+        return files_per_sec > 0 ? files_per_sec : 0;
+    }
+
+    int64_t mbytes_per_sec = 0;
+    switch (io_class) {
+    case IOClass::LOAD:
+        mbytes_per_sec = config::data_dir_load_io_mbytes_per_sec;
+        break;
+    case IOClass::COMPACTION:
+        mbytes_per_sec = config::data_dir_compaction_io_mbytes_per_sec;
+        if (config::data_dir_compaction_io_mbytes_per_sec_on_query > 0 && is_query_active()) {
+            int64_t on_query = config::data_dir_compaction_io_mbytes_per_sec_on_query;
+            mbytes_per_sec = mbytes_per_sec > 0 ? std::min(mbytes_per_sec, on_query) : on_query;
+        }
+        break;
+    case IOClass::MIGRATION:
+        mbytes_per_sec = config::storage_migration_io_mbytes_per_sec;
+        if (config::data_dir_compaction_io_mbytes_per_sec_on_query > 0 && is_query_active()) {
+            int64_t on_query = config::data_dir_compaction_io_mbytes_per_sec_on_query;
+            mbytes_per_sec = mbytes_per_sec > 0 ? std::min(mbytes_per_sec, on_query) : on_query;
+        }
+        break;
+    default:
+        break;
+    }
+    return mbytes_per_sec > 0 ? mbytes_per_sec * 1024 * 1024 : 0;
+}
+
+void IOScheduler::acquire(IOClass io_class, int64_t bytes) {
+    int64_t rate = _rate_per_sec(io_class);
+    if (rate <= 0 || bytes <= 0) {
+        return;
+    }
+
+    int64_t wait_us = 0;
+    {
+        std::lock_guard<std::mutex> l(_mutex);
+        int64_t now_us = MonotonicMicros();
+        int64_t& next_io_us = _next_io_us[static_cast<int>(io_class)];
+        // bucket holds at most one second of IO
+        next_io_us = std::max(next_io_us, now_us - 1000L * 1000L);
+        next_io_us += bytes * 1000L * 1000L / rate;
+        wait_us = next_io_us - now_us;
+    }
+    if (wait_us > 0) {
+        usleep(wait_us);
+    }
+}
+
+} // namespace doris
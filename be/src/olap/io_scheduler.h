@@ -0,0 +1,76 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
+
+namespace doris {
+
+// Class of background IO issued to a data dir, each class has its own rate.
+// Reads of queries are not throttled, they are only recorded so that
+// background IO yields the disk to them.
+enum class IOClass {
+    LOAD = 0,
+    COMPACTION = 1,
+    // path gc and trash sweep, counted in files instead of bytes
+    GC = 2,
+    // copy of tablet files by storage medium migration
+    MIGRATION = 3,
+};
+
+// Scheduler of IO on one data dir, shared by all tasks running on it.
+// Every class of background IO is limited by a token bucket whose rate is
+// read from config on each request. Rate of compaction and migration are
+// lowered to data_dir_compaction_io_mbytes_per_sec_on_query, and rate of gc
+// is lowered to path_gc_files_per_sec_on_query, while queries are reading
+// the data dir.
+class IOScheduler {
+public:
+    IOScheduler();
+
+    // Record bytes read from this data dir by queries.
+    void record_query_io(int64_t bytes);
+
+    // Return true if queries read this data dir recently.
+    bool is_query_active() const;
+
+    // Wait until `bytes` of IO of `io_class` are allowed to be issued.
+    // For IOClass::GC, `bytes` is the number of files to check or remove.
+    void acquire(IOClass io_class, int64_t bytes);
+
+private:
+    static const int IO_CLASS_NUM = 4;
+
+    // Return limited rate of io_class in bytes (or files for gc) per second,
+    // 0 means no limit.
+    int64_t _rate_per_sec(IOClass io_class) const;
+
+    std::mutex _mutex;
+    // Time in microseconds when next IO of every class is allowed. Bucket
+    // refills while it's in the past, and at most one second of IO is saved.
+    int64_t _next_io_us[IO_CLASS_NUM];
+    std::atomic<int64_t> _last_query_io_us;
+
+    DISALLOW_COPY_AND_ASSIGN(IOScheduler);
+};
+
+} // namespace doris
@@ -23,6 +23,7 @@
 
 namespace doris {
 
+class Conditions;
 class RowCursor;
 class RowBlockV2;
 class Schema;
@@ -44,6 +45,13 @@ struct StorageReadOptions {
     // If include_upper_bound is true, data equal with upper_bound will
     // be read
     bool include_upper_bound;
+
+    // Conditions used to filter data. They are used to prune data by zone map,
+    // and rows which don't satisfy conditions on columns being read will not
+    // be returned.
+    // If conditions is null, all data will be returned.
+    // NOTE: the conditions should outlive the iterator
+    const Conditions* conditions = nullptr;
 };
 
 // Used to read data in RowBlockV2 one by one
@@ -7,6 +7,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <initializer_list>
 #include <sstream>
 #include <string>
 
@@ -161,89 +163,95 @@ bool HandleTable::_resize() {
     return true;
 }
 
-LRUCache::LRUCache() : _usage(0), _last_id(0), _lookup_count(0),
-    _hit_count(0) {
+// An entry hit more often survives more passes of the clock hand
+static const uint8_t kMaxHits = 3;
+
+LRUCache::LRUCache() : _cold_percent(0), _mutex(RWMutex::Priority::PREFER_WRITING),
+    _usage(0), _last_id(0), _hot_usage(0), _num_entries(0),
+    _lookup_count(0), _hit_count(0) {
         // Make empty circular linked list
-        _lru.next = &_lru;
-        _lru.prev = &_lru;
-        _in_use.next = &_in_use;
-        _in_use.prev = &_in_use;
+        _hot_ring.next = &_hot_ring;
+        _hot_ring.prev = &_hot_ring;
+        _cold_ring.next = &_cold_ring;
+        _cold_ring.prev = &_cold_ring;
     }
 
 LRUCache::~LRUCache() {
-    assert(_in_use.next == &_in_use);  // Error if caller has an unreleased handle
-    for (LRUHandle* e = _lru.next; e != &_lru;) {
-        LRUHandle* next = e->next;
-        assert(e->in_cache);
-        e->in_cache = false;
-        assert(e->refs == 1);  // Invariant of _lru list.
-        _unref(e);
-        e = next;
-    }
-}
-
-void LRUCache::_ref(LRUHandle* e) {
-    if (e->refs == 1 && e->in_cache) {  // If on _lru list, move to _in_use list.
-        _lru_remove(e);
-        _lru_append(&_in_use, e);
+    for (LRUHandle* ring : {&_hot_ring, &_cold_ring}) {
+        for (LRUHandle* e = ring->next; e != ring;) {
+            LRUHandle* next = e->next;
+            assert(e->in_cache);
+            e->in_cache = false;
+            assert(e->refs == 1);  // Error if caller has an unreleased handle
+            _unref(e);
+            e = next;
+        }
     }
-    e->refs++;
 }
 
 void LRUCache::_unref(LRUHandle* e) {
-    // assert(e->refs > 0);
-    if (e->refs <= 0) {
+    uint32_t refs = e->refs.fetch_sub(1, std::memory_order_acq_rel);
+    // assert(refs > 0);
+    if (refs <= 0) {
         LOG(FATAL) << "e->refs > 0, i do not know why, anyway, is something wrong."
-                   << "e->refs=" << e->refs;
+                   << "e->refs=" << refs;
         return;
     }
-    e->refs--;
-    if (e->refs == 0) { // Deallocate.
+    if (refs == 1) { // Deallocate.
         assert(!e->in_cache);
         (*e->deleter)(e->key(), e->value);
         free(e);
-    } else if (e->in_cache && e->refs == 1) {  // No longer in use; move to lru_ list.
-        _lru_remove(e);
-        _lru_append(&_lru, e);
     }
 }
 
-void LRUCache::_lru_remove(LRUHandle* e) {
+void LRUCache::_ring_remove(LRUHandle* e) {
     e->next->prev = e->prev;
     e->prev->next = e->next;
 }
 
-void LRUCache::_lru_append(LRUHandle* list, LRUHandle* e) {
-    // Make "e" newest entry by inserting just before *list
-    e->next = list;
-    e->prev = list->prev;
+void LRUCache::_ring_append(LRUHandle* ring, LRUHandle* e) {
+    // Make "e" the last entry the hand visits by inserting just before *ring
+    e->next = ring;
+    e->prev = ring->prev;
     e->prev->next = e;
     e->next->prev = e;
 }
 
 Cache::Handle* LRUCache::lookup(const CacheKey& key, uint32_t hash) {
-    MutexLock l(&_mutex);
-    ++_lookup_count;
+    ReadLock l(&_mutex);
+    _lookup_count.fetch_add(1, std::memory_order_relaxed);
     LRUHandle* e = _tablet.lookup(key, hash);
 
     if (e != NULL) {
-        ++_hit_count;
-        _ref(e);
+        _hit_count.fetch_add(1, std::memory_order_relaxed);
+        // the entry can not be evicted while the lock is held shared
+        e->refs.fetch_add(1, std::memory_order_relaxed);
+        if (e->is_prefetch.load(std::memory_order_relaxed)) {
+            // this is the first access of a prefetched entry
+            e->is_prefetch.store(false, std::memory_order_relaxed);
+        } else {
+            // a lost update of a concurrent hit is harmless, and a saturated
+            // counter is not written, to keep the cache line shared
+            uint8_t hits = e->hits.load(std::memory_order_relaxed);
+            if (hits < kMaxHits) {
+                e->hits.store(hits + 1, std::memory_order_relaxed);
+            }
+        }
     }
 
     return reinterpret_cast<Cache::Handle*>(e);
 }
 
 void LRUCache::release(Cache::Handle* handle) {
-    MutexLock l(&_mutex);
+    // an entry still in cache keeps the reference of the cache, so only
+    // entries already removed from the table and the rings are deleted here
     _unref(reinterpret_cast<LRUHandle*>(handle));
 }
 
 Cache::Handle* LRUCache::insert(
         const CacheKey& key, uint32_t hash, void* value, size_t charge,
-        void (*deleter)(const CacheKey& key, void* value)) {
-    MutexLock l(&_mutex);
-
+        void (*deleter)(const CacheKey& key, void* value),
+        CachePriority priority) {
     LRUHandle* e = reinterpret_cast<LRUHandle*>(
             malloc(sizeof(LRUHandle)-1 + key.size()));
     e->value = value;
@@ -252,58 +260,133 @@ Cache::Handle* LRUCache::insert(
     e->key_length = key.size();
     e->hash = hash;
     e->in_cache = false;
-    e->refs = 1;  // for the returned handle.
+    // without cold ring, all entries are hot
+    e->is_hot = (_cold_percent == 0);
+    e->is_prefetch.store(priority == CachePriority::PREFETCH, std::memory_order_relaxed);
+    e->hits.store(0, std::memory_order_relaxed);
+    e->refs.store(1, std::memory_order_relaxed);  // for the returned handle.
     memcpy(e->key_data, key.data(), key.size());
 
+    WriteLock l(&_mutex);
     if (_capacity > 0) {
-        e->refs++;  // for the cache's reference.
+        e->refs.fetch_add(1, std::memory_order_relaxed);  // for the cache's reference.
         e->in_cache = true;
-        _lru_append(&_in_use, e);
+        _ring_append(e->is_hot ? &_hot_ring : &_cold_ring, e);
+        ++_num_entries;
         _usage += charge;
+        if (e->is_hot) {
+            _hot_usage += charge;
+        }
         _finish_erase(_tablet.insert(e));
     } // else don't cache.  (Tests use capacity_==0 to turn off caching.)
 
-    while (_usage > _capacity && _lru.next != &_lru) {
-        LRUHandle* old = _lru.next;
-        assert(old->refs == 1);
-        bool erased = _finish_erase(_tablet.remove(old->key(), old->hash));
+    _evict();
+
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void LRUCache::_demote_hot_entries() {
+    if (_cold_percent == 0) {
+        return;
+    }
+    size_t hot_capacity = _capacity * (100 - std::min(_cold_percent, 100U)) / 100;
+    for (size_t i = 0; i <= kMaxHits * _num_entries
+            && _hot_usage > hot_capacity && _hot_ring.next != &_hot_ring; ++i) {
+        LRUHandle* old = _hot_ring.next;
+        _ring_remove(old);
+        uint8_t hits = old->hits.load(std::memory_order_relaxed);
+        if (hits > 0) {
+            old->hits.store(hits - 1, std::memory_order_relaxed);
+            _ring_append(&_hot_ring, old);
+            continue;
+        }
+        old->is_hot = false;
+        _hot_usage -= old->charge;
+        // demoted entry is the last one the cold hand visits, which is the midpoint
+        _ring_append(&_cold_ring, old);
+    }
+}
+
+void LRUCache::_evict() {
+    while (_usage > _capacity) {
+        if (!_evict_one(&_cold_ring) && !_evict_one(&_hot_ring)) {
+            // all entries are in use
+            break;
+        }
+    }
+}
+
+bool LRUCache::_evict_one(LRUHandle* ring) {
+    // an entry is passed at most once per hit, and once if in use
+    for (size_t i = 0; i <= (kMaxHits + 1) * _num_entries && ring->next != ring; ++i) {
+        LRUHandle* e = ring->next;
+        uint8_t hits = e->hits.load(std::memory_order_relaxed);
+        if (hits > 0) {
+            e->hits.store(hits - 1, std::memory_order_relaxed);
+            _ring_remove(e);
+            if (e->is_hot) {
+                _ring_append(ring, e);
+            } else {
+                // accessed again after insertion, promote it into hot ring
+                e->is_hot = true;
+                _hot_usage += e->charge;
+                _ring_append(&_hot_ring, e);
+                _demote_hot_entries();
+            }
+            continue;
+        }
+        // lookups are excluded, so the count of an unused entry can not grow
+        if (e->refs.load(std::memory_order_acquire) > 1) {
+            _ring_remove(e);
+            _ring_append(ring, e);
+            continue;
+        }
+        bool erased = _finish_erase(_tablet.remove(e->key(), e->hash));
         if (!erased) {  // to avoid unused variable when compiled NDEBUG
             assert(erased);
         }
+        return true;
     }
-
-    return reinterpret_cast<Cache::Handle*>(e);
+    return false;
 }
 
 // If e != NULL, finish removing *e from the cache; it has already been removed
-// from the hash tablet.  Return whether e != NULL.  Requires mutex_ held.
+// from the hash tablet.  Return whether e != NULL.  Requires mutex_ held exclusive.
 bool LRUCache::_finish_erase(LRUHandle* e) {
     if (e != NULL) {
         assert(e->in_cache);
-        _lru_remove(e);
+        _ring_remove(e);
         e->in_cache = false;
+        --_num_entries;
         _usage -= e->charge;
+        if (e->is_hot) {
+            _hot_usage -= e->charge;
+        }
         _unref(e);
     }
     return e != NULL;
 }
 
 void LRUCache::erase(const CacheKey& key, uint32_t hash) {
-    MutexLock l(&_mutex);
+    WriteLock l(&_mutex);
     _finish_erase(_tablet.remove(key, hash));
 }
 
 int LRUCache::prune() {
-    MutexLock l(&_mutex);
+    WriteLock l(&_mutex);
     int num_prune = 0;
-    while (_lru.next != &_lru) {
-        LRUHandle* e = _lru.next;
-        assert(e->refs == 1);
-        bool erased = _finish_erase(_tablet.remove(e->key(), e->hash));
-        if (!erased) {  // to avoid unused variable when compiled NDEBUG
-            assert(erased);
+    for (LRUHandle* ring : {&_cold_ring, &_hot_ring}) {
+        for (LRUHandle* e = ring->next; e != ring;) {
+            LRUHandle* next = e->next;
+            if (e->refs.load(std::memory_order_acquire) == 1) {
+                bool erased = _finish_erase(_tablet.remove(e->key(), e->hash));
+                if (!erased) {  // to avoid unused variable when compiled NDEBUG
+                    assert(erased);
+                }
+                num_prune++;
+            }
+            e = next;
         }
-        num_prune++;
     }
     return num_prune;
 }
@@ -316,12 +399,13 @@ uint32_t ShardedLRUCache::_shard(uint32_t hash) {
     return hash >> (32 - kNumShardBits);
 }
 
-ShardedLRUCache::ShardedLRUCache(size_t capacity)
+ShardedLRUCache::ShardedLRUCache(size_t capacity, uint32_t cold_percent)
     : _last_id(0) {
         const size_t per_shard = (capacity + (kNumShards - 1)) / kNumShards;
 
         for (int s = 0; s < kNumShards; s++) {
             _shards[s].set_capacity(per_shard);
+            _shards[s].set_cold_percent(cold_percent);
         }
     }
 
@@ -329,9 +413,10 @@ Cache::Handle* ShardedLRUCache::insert(
         const CacheKey& key,
         void* value,
         size_t charge,
-        void (*deleter)(const CacheKey& key, void* value)) {
+        void (*deleter)(const CacheKey& key, void* value),
+        CachePriority priority) {
     const uint32_t hash = _hash_slice(key);
-    return _shards[_shard(hash)].insert(key, hash, value, charge, deleter);
+    return _shards[_shard(hash)].insert(key, hash, value, charge, deleter, priority);
 }
 
 Cache::Handle* ShardedLRUCache::lookup(const CacheKey& key) {
@@ -414,8 +499,8 @@ void ShardedLRUCache::get_cache_status(rapidjson::Document* document) {
 
 }
 
-Cache* new_lru_cache(size_t capacity) {
-    return new ShardedLRUCache(capacity);
+Cache* new_lru_cache(size_t capacity, uint32_t cold_percent) {
+    return new ShardedLRUCache(capacity, cold_percent);
 }
 
 }  // namespace doris
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <atomic>
 #include <string>
 
 #include <rapidjson/document.h>
@@ -46,8 +47,18 @@ namespace doris {
     class CacheKey;
 
     // Create a new cache with a fixed size capacity.  This implementation
-    // of Cache uses a least-recently-used eviction policy.
-    extern Cache* new_lru_cache(size_t capacity);
+    // of Cache uses GCLOCK, an approximation of least-recently-used eviction:
+    // a hit only bumps a small counter of the entry, and the clock hand of
+    // eviction passes an entry once for every hit it counted. So lookup and
+    // release need no exclusive lock, only insert, erase and eviction do.
+    //
+    // If cold_percent is not 0, the cache uses midpoint insertion to be scan
+    // resistant: new entries are inserted into a cold ring which takes
+    // cold_percent of capacity at least, and only entries accessed again are
+    // promoted into the hot ring. Entries are evicted from the cold ring first,
+    // so that entries accessed only once, such as pages of a full scan, can not
+    // flush the frequently accessed entries.
+    extern Cache* new_lru_cache(size_t capacity, uint32_t cold_percent = 0);
 
     class CacheKey {
         public:
@@ -147,6 +158,13 @@ namespace doris {
             size_t _size;
     };
 
+    enum class CachePriority {
+        NORMAL = 0,
+        // entry is prefetched and has not been accessed, so its first lookup
+        // does not count as a hit
+        PREFETCH = 1
+    };
+
     class Cache {
         public:
             Cache() {}
@@ -171,7 +189,8 @@ namespace doris {
             virtual Handle* insert(
                     const CacheKey& key,
                     void* value, size_t charge,
-                    void (*deleter)(const CacheKey& key, void* value)) = 0;
+                    void (*deleter)(const CacheKey& key, void* value),
+                    CachePriority priority = CachePriority::NORMAL) = 0;
 
             // If the cache has no mapping for "key", returns NULL.
             //
@@ -227,7 +246,8 @@ namespace doris {
     };
 
     // An entry is a variable length heap-allocated structure.  Entries
-    // are kept in a circular doubly linked list ordered by access time.
+    // are kept in a circular doubly linked list, the ring of a clock, in
+    // the order the clock hand visits them.
     typedef struct LRUHandle {
         void* value;
         void (*deleter)(const CacheKey&, void* value);
@@ -237,7 +257,10 @@ namespace doris {
         size_t charge;
         size_t key_length;
         bool in_cache;      // Whether entry is in the cache.
-        uint32_t refs;
+        bool is_hot;        // Whether entry is in hot ring.
+        std::atomic<bool> is_prefetch;  // Whether entry is prefetched and not accessed yet.
+        std::atomic<uint8_t> hits;      // Hits since the hand passed, saturated at 3.
+        std::atomic<uint32_t> refs;
         uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
         char key_data[1];   // Beginning of key
 
@@ -299,23 +322,29 @@ namespace doris {
                 _capacity = capacity;
             }
 
+            // Percent of capacity kept for the cold ring, 0 means a single ring
+            void set_cold_percent(uint32_t cold_percent) {
+                _cold_percent = cold_percent;
+            }
+
             // Like Cache methods, but with an extra "hash" parameter.
             Cache::Handle* insert(
                     const CacheKey& key,
                     uint32_t hash,
                     void* value,
                     size_t charge,
-                    void (*deleter)(const CacheKey& key, void* value));
+                    void (*deleter)(const CacheKey& key, void* value),
+                    CachePriority priority = CachePriority::NORMAL);
             Cache::Handle* lookup(const CacheKey& key, uint32_t hash);
             void release(Cache::Handle* handle);
             void erase(const CacheKey& key, uint32_t hash);
             int prune();
 
             uint64_t get_lookup_count() {
-                return _lookup_count;
+                return _lookup_count.load(std::memory_order_relaxed);
             }
             uint64_t get_hit_count() {
-                return _hit_count;
+                return _hit_count.load(std::memory_order_relaxed);
             }
             size_t get_usage() {
                 return _usage;
@@ -323,35 +352,53 @@ namespace doris {
             size_t get_capacity() {
                 return _capacity;
             }
+            size_t get_hot_usage() {
+                return _hot_usage;
+            }
 
         private:
-            void _lru_remove(LRUHandle* e);
-            void _lru_append(LRUHandle* list, LRUHandle* e);
-            void _ref(LRUHandle* e);
+            void _ring_remove(LRUHandle* e);
+            void _ring_append(LRUHandle* ring, LRUHandle* e);
             void _unref(LRUHandle* e);
             bool _finish_erase(LRUHandle* e);
+            // move hot entries without hits into cold ring until hot entries
+            // fit into their part of capacity
+            void _demote_hot_entries();
+            // evict unused entries until usage fits into capacity
+            void _evict();
+            // sweep the clock of ring until an entry is evicted, returns false
+            // if no entry of ring can be evicted
+            bool _evict_one(LRUHandle* ring);
 
             // Initialized before use.
             size_t _capacity;
+            uint32_t _cold_percent;
 
-            // _mutex protects the following state.
-            Mutex _mutex;
+            // _mutex protects the following state. lookup takes it shared,
+            // everything changing the table or the rings takes it exclusive.
+            RWMutex _mutex;
             size_t _usage;
             uint64_t _last_id;
 
-            // Dummy head of LRU list.
-            // lru.prev is newest entry, lru.next is oldest entry.
-            // Entries have refs==1 and in_cache==true.
-            LRUHandle _lru;
+            // charge of in cache entries which are hot
+            size_t _hot_usage;
+
+            // number of in cache entries, bounds the sweeps of the clock hand
+            size_t _num_entries;
+
+            // Dummy head of the ring of hot entries.
+            // ring.next is the next entry the hand visits, ring.prev is the
+            // last one. Entries have in_cache==true, and refs >= 2 if in use.
+            LRUHandle _hot_ring;
 
-            // Dummy head of in-use list.
-            // Entries are in use by clients, and have refs >= 2 and in_cache==true.
-            LRUHandle _in_use;
+            // Dummy head of the ring of cold entries, which are inserted but
+            // not accessed again. It's always empty if _cold_percent is 0.
+            LRUHandle _cold_ring;
 
             HandleTable _tablet;
 
-            uint64_t _lookup_count;    // cache查找总次数
-            uint64_t _hit_count;       // 命中cache的总次数
+            std::atomic<uint64_t> _lookup_count;    // cache查找总次数
+            std::atomic<uint64_t> _hit_count;       // 命中cache的总次数
     };
 
     static const int kNumShardBits = 4;
@@ -359,14 +406,15 @@ namespace doris {
 
     class ShardedLRUCache : public Cache {
         public:
-            explicit ShardedLRUCache(size_t capacity);
+            explicit ShardedLRUCache(size_t capacity, uint32_t cold_percent = 0);
             // TODO(fdy): 析构时清除所有cache元素
             virtual ~ShardedLRUCache() {}
             virtual Handle* insert(
                     const CacheKey& key,
                     void* value,
                     size_t charge,
-                    void (*deleter)(const CacheKey& key, void* value));
+                    void (*deleter)(const CacheKey& key, void* value),
+                    CachePriority priority = CachePriority::NORMAL);
             virtual Handle* lookup(const CacheKey& key);
             virtual void release(Handle* handle);
             virtual void erase(const CacheKey& key);
@@ -17,6 +17,9 @@
 
 #include "olap/memtable.h"
 
+#include <algorithm>
+
+#include "common/config.h"
 #include "olap/hll.h"
 #include "olap/rowset/column_data_writer.h"
 #include "olap/row_cursor.h"
@@ -34,10 +37,16 @@ MemTable::MemTable(Schema* schema, const TabletSchema* tablet_schema,
       _tuple_desc(tuple_desc),
       _col_ids(col_ids),
       _keys_type(keys_type),
-      _row_comparator(_schema) {
+      _row_comparator(_schema),
+      _skip_list(nullptr),
+      // values of HLL columns are merged into the HllContext of the row of
+      // the same key in skiplist when inserted, which isn't done by sorted vector
+      _use_sorted_vector(config::memtable_use_sorted_vector && keys_type != KeysType::AGG_KEYS) {
     _schema_size = _schema->schema_size();
     _tuple_buf = _arena.Allocate(_schema_size);
-    _skip_list = new Table(_row_comparator, &_arena);
+    if (!_use_sorted_vector) {
+        _skip_list = new Table(_row_comparator, &_arena);
+    }
 }
 
 MemTable::~MemTable() {
@@ -54,7 +63,7 @@ int MemTable::RowCursorComparator::operator()(const char* left, const char* righ
 }
 
 size_t MemTable::memory_usage() {
-    return _arena.MemoryUsage();
+    return _arena.MemoryUsage() + (_rows.capacity() + _free_rows.capacity()) * sizeof(char*);
 }
 
 void MemTable::insert(Tuple* tuple) {
@@ -144,6 +153,20 @@ void MemTable::insert(Tuple* tuple) {
         }
     }
 
+    if (_use_sorted_vector) {
+        _rows.push_back(_tuple_buf);
+        _tuple_buf = _allocate_row();
+        // pre-aggregate only when unsorted rows are no less than sorted rows,
+        // so that every row is merged O(log n) times
+        size_t num_unsorted_rows = _rows.size() - _num_sorted_rows;
+        if (_keys_type != KeysType::DUP_KEYS
+                && num_unsorted_rows >= config::memtable_pre_aggregate_rows
+                && num_unsorted_rows >= _num_sorted_rows) {
+            _sort_rows();
+        }
+        return;
+    }
+
     bool overwritten = false;
     _skip_list->Insert(_tuple_buf, &overwritten, _keys_type);
     if (!overwritten) {
@@ -151,21 +174,68 @@ void MemTable::insert(Tuple* tuple) {
     }
 }
 
+char* MemTable::_allocate_row() {
+    if (_free_rows.empty()) {
+        return _arena.Allocate(_schema_size);
+    }
+    char* row = _free_rows.back();
+    _free_rows.pop_back();
+    return row;
+}
+
+void MemTable::_sort_rows() {
+    auto less = [this](const char* lhs, const char* rhs) {
+        return _row_comparator(lhs, rhs) < 0;
+    };
+    // rows with same key must keep the order they are inserted, so that
+    // REPLACE aggregation keeps the last value
+    auto middle = _rows.begin() + _num_sorted_rows;
+    std::stable_sort(middle, _rows.end(), less);
+    std::inplace_merge(_rows.begin(), middle, _rows.end(), less);
+
+    if (_keys_type != KeysType::DUP_KEYS && !_rows.empty()) {
+        size_t last = 0;
+        for (size_t i = 1; i < _rows.size(); ++i) {
+            if (_row_comparator(_rows[last], _rows[i]) == 0) {
+                ContiguousRow dst_row(_schema, _rows[last]);
+                ContiguousRow src_row(_schema, _rows[i]);
+                agg_update_row(&dst_row, src_row, &_arena);
+                _free_rows.push_back(_rows[i]);
+            } else {
+                _rows[++last] = _rows[i];
+            }
+        }
+        _rows.resize(last + 1);
+    }
+    _num_sorted_rows = _rows.size();
+}
+
 OLAPStatus MemTable::flush(RowsetWriterSharedPtr rowset_writer) {
     int64_t duration_ns = 0;
     {
         SCOPED_RAW_TIMER(&duration_ns);
-        Table::Iterator it(_skip_list);
-        for (it.SeekToFirst(); it.Valid(); it.Next()) {
-            char* row = (char*)it.key();
-            ContiguousRow dst_row(_schema, row);
-            agg_finalize_row(&dst_row, _skip_list->arena());
-            RETURN_NOT_OK(rowset_writer->add_row(dst_row));
+        if (_use_sorted_vector) {
+            _sort_rows();
+            for (char* row : _rows) {
+                ContiguousRow dst_row(_schema, row);
+                agg_finalize_row(&dst_row, &_arena);
+                RETURN_NOT_OK(rowset_writer->add_row(dst_row));
+            }
+        } else {
+            Table::Iterator it(_skip_list);
+            for (it.SeekToFirst(); it.Valid(); it.Next()) {
+                char* row = (char*)it.key();
+                ContiguousRow dst_row(_schema, row);
+                agg_finalize_row(&dst_row, _skip_list->arena());
+                RETURN_NOT_OK(rowset_writer->add_row(dst_row));
+            }
         }
         RETURN_NOT_OK(rowset_writer->flush());
     }
     DorisMetrics::memtable_flush_total.increment(1); 
     DorisMetrics::memtable_flush_duration_us.increment(duration_ns / 1000);
+    DorisMetrics::memtable_flush_latency_ms.add(duration_ns / 1000000);
+    DorisMetrics::memtable_flush_latency_us.add(duration_ns / 1000);
     return OLAP_SUCCESS;
 }
 
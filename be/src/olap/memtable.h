@@ -19,6 +19,7 @@
 #define DORIS_BE_SRC_OLAP_MEMTABLE_H
 
 #include <memory>
+#include <vector>
 
 #include "olap/schema.h"
 #include "olap/skiplist.h"
@@ -52,6 +53,11 @@ private:
         int operator()(const char* left, const char* right) const;
     };
 
+    // sort the unsorted rows and merge them with sorted rows, rows with same
+    // key are aggregated if table is not DUP_KEYS
+    void _sort_rows();
+    char* _allocate_row();
+
     RowCursorComparator _row_comparator;
     Arena _arena;
 
@@ -59,6 +65,15 @@ private:
     char* _tuple_buf;
     size_t _schema_size;
     Table* _skip_list;
+
+    // Used instead of _skip_list if config::memtable_use_sorted_vector is true,
+    // except for AGG_KEYS tables.
+    // Rows are appended to _rows, and _rows[0, _num_sorted_rows) are sorted.
+    bool _use_sorted_vector;
+    std::vector<char*> _rows;
+    size_t _num_sorted_rows = 0;
+    // buffers of rows aggregated into others, reused by later rows
+    std::vector<char*> _free_rows;
 }; // class MemTable
 
 } // namespace doris
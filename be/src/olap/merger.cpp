@@ -17,10 +17,13 @@
 
 #include "olap/merger.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
+#include "common/config.h"
 #include "olap/olap_define.h"
+#include "olap/rowset/beta_rowset_writer.h"
 #include "olap/rowset/segment_group.h"
 #include "olap/tablet.h"
 #include "olap/reader.h"
@@ -119,4 +122,123 @@ OLAPStatus Merger::merge() {
 
     return has_error ? OLAP_ERR_OTHER_ERROR : OLAP_SUCCESS;
 }
+
+OLAPStatus Merger::vertical_merge() {
+    auto beta_writer = std::dynamic_pointer_cast<BetaRowsetWriter>(_output_rs_writer);
+    if (beta_writer == nullptr) {
+        LOG(WARNING) << "vertical merge needs beta rowset writer. tablet=" << _tablet->full_name();
+        return OLAP_ERR_INPUT_PARAMETER_ERROR;
+    }
+    const TabletSchema& schema = _tablet->tablet_schema();
+    std::vector<uint32_t> key_columns;
+    for (uint32_t cid = 0; cid < schema.num_key_columns(); ++cid) {
+        key_columns.push_back(cid);
+    }
+    size_t num_columns_per_group = std::max(config::vertical_compaction_num_columns_per_group, 1);
+    std::vector<std::vector<uint32_t>> value_groups;
+    for (uint32_t cid = schema.num_key_columns(); cid < schema.num_columns(); ++cid) {
+        if (value_groups.empty() || value_groups.back().size() >= num_columns_per_group) {
+            value_groups.emplace_back();
+        }
+        value_groups.back().push_back(cid);
+    }
+
+    // input rowset readers can only be read once, create new readers for
+    // every group from the rowsets of them
+    std::vector<RowsetSharedPtr> input_rowsets;
+    for (auto& rs_reader : _input_rs_readers) {
+        input_rowsets.push_back(rs_reader->rowset());
+    }
+    auto create_readers = [this, &input_rowsets] () -> OLAPStatus {
+        _input_rs_readers.clear();
+        for (auto& rowset : input_rowsets) {
+            RowsetReaderSharedPtr rs_reader(rowset->create_reader());
+            if (rs_reader == nullptr) {
+                LOG(WARNING) << "rowset create reader failed. rowset:" << rowset->rowset_id();
+                return OLAP_ERR_ROWSET_CREATE_READER;
+            }
+            _input_rs_readers.push_back(rs_reader);
+        }
+        return OLAP_SUCCESS;
+    };
+
+    // key group decides the rows of output and merged/filtered rows
+    int64_t key_row_count = 0;
+    RETURN_NOT_OK(_merge_columns(key_columns, key_columns, &key_row_count));
+    int64_t merged_rows = _merged_rows;
+    int64_t filted_rows = _filted_rows;
+
+    for (auto& value_group : value_groups) {
+        RETURN_NOT_OK(create_readers());
+        std::vector<uint32_t> return_columns = key_columns;
+        return_columns.insert(return_columns.end(), value_group.begin(), value_group.end());
+        int64_t row_count = 0;
+        RETURN_NOT_OK(_merge_columns(return_columns, value_group, &row_count));
+        if (row_count != key_row_count) {
+            LOG(WARNING) << "row count of value columns does not match key columns. tablet="
+                         << _tablet->full_name() << ", key_row_count=" << key_row_count
+                         << ", value_row_count=" << row_count
+                         << ", first_value_column=" << value_group[0];
+            return OLAP_ERR_CHECK_LINES_ERROR;
+        }
+    }
+
+    if (_output_rs_writer->flush() != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to finalize writer. "
+                     << "tablet=" << _tablet->full_name();
+        return OLAP_ERR_OTHER_ERROR;
+    }
+    _row_count = key_row_count;
+    _merged_rows = merged_rows;
+    _filted_rows = filted_rows;
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus Merger::_merge_columns(const std::vector<uint32_t>& return_columns,
+                                  const std::vector<uint32_t>& write_columns,
+                                  int64_t* row_count) {
+    BetaRowsetWriter* beta_writer = static_cast<BetaRowsetWriter*>(_output_rs_writer.get());
+    Reader reader;
+    ReaderParams reader_params;
+    reader_params.tablet = _tablet;
+    reader_params.reader_type = _reader_type;
+    reader_params.rs_readers = _input_rs_readers;
+    reader_params.version = _output_rs_writer->version();
+    reader_params.return_columns = return_columns;
+
+    if (OLAP_SUCCESS != reader.init(reader_params)) {
+        LOG(WARNING) << "fail to initiate reader. tablet=" << _tablet->full_name();
+        return OLAP_ERR_INIT_FAILED;
+    }
+
+    RowCursor row_cursor;
+    if (OLAP_SUCCESS != row_cursor.init(_tablet->tablet_schema(), return_columns)) {
+        LOG(WARNING) << "fail to init row cursor.";
+        return OLAP_ERR_INIT_FAILED;
+    }
+    row_cursor.allocate_memory_for_string_type(_tablet->tablet_schema());
+
+    bool eof = false;
+    while (true) {
+        OLAPStatus res = reader.next_row_with_aggregation(&row_cursor, &eof);
+        if (OLAP_SUCCESS == res && eof) {
+            VLOG(3) << "reader read to the end.";
+            break;
+        } else if (OLAP_SUCCESS != res) {
+            LOG(WARNING) << "reader read failed.";
+            return OLAP_ERR_OTHER_ERROR;
+        }
+
+        if (OLAP_SUCCESS != beta_writer->add_columns(row_cursor, write_columns)) {
+            LOG(WARNING) << "add columns to builder failed. tablet=" << _tablet->full_name();
+            return OLAP_ERR_OTHER_ERROR;
+        }
+        ++(*row_count);
+    }
+
+    _merged_rows = reader.merged_rows();
+    _filted_rows = reader.filtered_rows();
+    return OLAP_SUCCESS;
+}
+
 }  // namespace doris
@@ -43,11 +43,25 @@ public:
                      int64_t* merged_rows, int64_t* filted_rows);
     OLAPStatus merge();
 
+    // Merge rows by column groups rather than all columns at once, the output
+    // writer must be a BetaRowsetWriter. The first group contains all key
+    // columns, and each following group contains key columns and at most
+    // config::vertical_compaction_num_columns_per_group value columns. Rows of
+    // every group are merged by the same keys and versions, so they come in
+    // the same order and are written into the same rows of output segment.
+    OLAPStatus vertical_merge();
+
     // 获取在做merge过程中累积的行数
     inline int64_t row_count() const { return _row_count; }
     inline int64_t merged_rows() const { return _merged_rows; }
     inline int64_t filted_rows() const { return _filted_rows; }
 private:
+    // merge return_columns of input rowsets, and add write_columns of merged
+    // rows to output writer
+    OLAPStatus _merge_columns(const std::vector<uint32_t>& return_columns,
+                              const std::vector<uint32_t>& write_columns,
+                              int64_t* row_count);
+
     TabletSharedPtr _tablet;
     RowsetWriterSharedPtr _output_rs_writer;
 
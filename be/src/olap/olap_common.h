@@ -148,7 +148,9 @@ enum FieldAggregationMethod {
     OLAP_FIELD_AGGREGATION_MAX = 3,
     OLAP_FIELD_AGGREGATION_REPLACE = 4,
     OLAP_FIELD_AGGREGATION_HLL_UNION = 5,
-    OLAP_FIELD_AGGREGATION_UNKNOWN = 6
+    OLAP_FIELD_AGGREGATION_UNKNOWN = 6,
+    OLAP_FIELD_AGGREGATION_BITMAP_UNION = 7,
+    OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL = 8
 };
 
 // 压缩算法类型
@@ -207,6 +209,20 @@ class Field;
 class WrapperField;
 using KeyRange = std::pair<WrapperField*, WrapperField*>;
 
+// Page cache statistics of one column in segment_v2
+struct ColumnPageCacheStatistics {
+    // data pages found in page cache
+    int64_t page_cache_hit = 0;
+    // data pages read from file
+    int64_t page_cache_miss = 0;
+    // data pages found in page cache in decompressed form, which are read
+    // without decompression
+    int64_t decompressed_page_cache_hit = 0;
+    // on-disk bytes of the data pages found in page cache and read from file
+    int64_t page_cache_hit_bytes = 0;
+    int64_t page_cache_miss_bytes = 0;
+};
+
 // ReaderStatistics used to collect statistics when scan data from storage
 struct OlapReaderStatistics {
     int64_t io_ns = 0;
@@ -232,6 +248,11 @@ struct OlapReaderStatistics {
     int64_t rows_del_filtered = 0;
 
     int64_t index_load_ns = 0;
+
+    // page cache statistics of each column read from segment_v2, keyed by column id.
+    // Empty until beta rowsets have a RowsetReader which passes them to
+    // ColumnIteratorOptions::page_cache_stats
+    std::map<uint32_t, ColumnPageCacheStatistics> column_page_cache_stats;
 };
 
 typedef uint32_t ColumnId;
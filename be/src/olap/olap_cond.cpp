@@ -22,6 +22,7 @@
 #include <utility>
 #include <thrift/protocol/TDebugProtocol.h>
 
+#include "olap/column_block.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/utils.h"
@@ -190,7 +191,10 @@ OLAPStatus Cond::init(const TCondition& tcond, const TabletColumn& column) {
     return OLAP_SUCCESS;
 }
 
-bool Cond::eval(const RowCursorCell& cell) const {
+template<typename CellType>
+static bool eval_cell(const Cond& cond, const CellType& cell) {
+    CondOp op = cond.op;
+    WrapperField* operand_field = cond.operand_field;
     if (cell.is_null() && op != OP_IS) {
         //任何operand和NULL的运算都是false
         return false;
@@ -210,7 +214,7 @@ bool Cond::eval(const RowCursorCell& cell) const {
     case OP_GE:
         return operand_field->field()->compare_cell(*operand_field, cell) <= 0;
     case OP_IN: {
-        for (const WrapperField* field : operand_set) {
+        for (const WrapperField* field : cond.operand_set) {
             if (field->field()->compare_cell(*field, cell) == 0) {
                 return true;
             }
@@ -230,6 +234,14 @@ bool Cond::eval(const RowCursorCell& cell) const {
     }
 }
 
+bool Cond::eval(const RowCursorCell& cell) const {
+    return eval_cell(*this, cell);
+}
+
+bool Cond::eval(const ColumnBlockCell& cell) const {
+    return eval_cell(*this, cell);
+}
+
 bool Cond::eval(const std::pair<WrapperField*, WrapperField*>& statistic) const {
     //通过单列上的单个查询条件对version进行过滤
     // When we apply column statistic, Field can be NULL when type is Varchar,
@@ -422,9 +434,11 @@ int Cond::del_eval(const std::pair<WrapperField*, WrapperField*>& stat) const {
     return ret;
 }
 
-bool Cond::eval(const BloomFilter& bf) const {
-    //通过单列上BloomFilter对block进行过滤。
-    switch (op) {
+// BloomFilter and BlockBloomFilter have the same test_bytes interface
+template<typename BloomFilterType>
+static bool eval_bloom_filter(const Cond& cond, const BloomFilterType& bf) {
+    WrapperField* operand_field = cond.operand_field;
+    switch (cond.op) {
     case OP_EQ: {
         bool existed = false;
         if (operand_field->is_string_type()) {
@@ -436,8 +450,8 @@ bool Cond::eval(const BloomFilter& bf) const {
         return existed;
     }
     case OP_IN: {
-        FieldSet::const_iterator it = operand_set.begin();
-        for (; it != operand_set.end(); ++it) {
+        Cond::FieldSet::const_iterator it = cond.operand_set.begin();
+        for (; it != cond.operand_set.end(); ++it) {
             bool existed = false;
             if ((*it)->is_string_type()) {
                 Slice* slice = (Slice*)((*it)->ptr());
@@ -462,6 +476,15 @@ bool Cond::eval(const BloomFilter& bf) const {
     return false;
 }
 
+bool Cond::eval(const BloomFilter& bf) const {
+    //通过单列上BloomFilter对block进行过滤。
+    return eval_bloom_filter(*this, bf);
+}
+
+bool Cond::eval(const BlockBloomFilter& bf) const {
+    return eval_bloom_filter(*this, bf);
+}
+
 CondColumn::~CondColumn() {
     for (auto& it : _conds) {
         delete it;
@@ -492,6 +515,15 @@ bool CondColumn::eval(const RowCursor& row) const {
     return true;
 }
 
+bool CondColumn::eval(const ColumnBlockCell& cell) const {
+    for (auto& each_cond : _conds) {
+        if (!each_cond->eval(cell)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool CondColumn::eval(const std::pair<WrapperField*, WrapperField*> &statistic) const {
     //通过一列上的所有查询条件对version进行过滤
     for (auto& each_cond : _conds) {
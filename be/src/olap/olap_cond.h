@@ -35,6 +35,7 @@ namespace doris {
 
 class WrapperField;
 class RowCursorCell;
+struct ColumnBlockCell;
 
 enum CondOp {
     OP_EQ = 0,      // equal
@@ -73,11 +74,14 @@ public:
     // 用一行数据的指定列同条件进行比较，如果符合过滤条件，
     // 即按照此条件，行应被过滤掉，则返回true，否则返回false
     bool eval(const RowCursorCell& cell) const;
+    // Same as above, used to evaluate cell in ColumnBlock
+    bool eval(const ColumnBlockCell& cell) const;
 
     bool eval(const KeyRange& statistic) const;
     int del_eval(const KeyRange& stat) const;
 
     bool eval(const BloomFilter& bf) const;
+    bool eval(const BlockBloomFilter& bf) const;
 
     CondOp op;
     // valid when op is not OP_IN
@@ -103,6 +107,8 @@ public:
 
     // 对一行数据中的指定列，用所有过滤条件进行比较，如果所有条件都满足，则过滤此行
     bool eval(const RowCursor& row) const;
+    // Return true if the cell satisfies all conditions of this column
+    bool eval(const ColumnBlockCell& cell) const;
 
     bool eval(const std::pair<WrapperField*, WrapperField*>& statistic) const;
     int del_eval(const std::pair<WrapperField*, WrapperField*>& statistic) const;
@@ -60,6 +60,10 @@ using StringOffsetType = uint32_t;
 using StringLengthType = uint16_t;
 static const uint16_t OLAP_STRING_MAX_BYTES = sizeof(StringLengthType);
 
+// the size at which the arena holding finalized aggregate values of merged rows
+// (e.g. BITMAP_UNION) is dropped, once the rows using it are consumed
+static const size_t OLAP_MAX_AGG_ARENA_BYTES = 4 * 1024 * 1024;
+
 enum OLAPDataVersion {
     OLAP_V1 = 0,
     DORIS_V1 = 1,
@@ -356,7 +360,8 @@ enum OLAPStatus {
     OLAP_ERR_ROWSET_TYPE_NOT_FOUND = -3105,
     OLAP_ERR_ROWSET_ALREADY_EXIST = -3106,
     OLAP_ERR_ROWSET_CREATE_READER = -3107,
-    OLAP_ERR_ROWSET_INVALID = -3108
+    OLAP_ERR_ROWSET_INVALID = -3108,
+    OLAP_ERR_ROWSET_LOAD_FAILED = -3109
 };
 
 enum ColumnFamilyIndex {
@@ -379,6 +384,8 @@ const std::string TABLET_ID_KEY = "tablet_id";
 const std::string TABLET_SCHEMA_HASH_KEY = "schema_hash";
 const std::string TABLET_ID_PREFIX = "t_";
 const std::string ROWSET_ID_PREFIX = "s_";
+// meta key prefix of rowsets whose files should be checked by path gc
+const std::string GC_ROWSET_PREFIX = "gcrowset_";
 
 #ifndef RETURN_NOT_OK
 #define RETURN_NOT_OK(s) do { \
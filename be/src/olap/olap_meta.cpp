@@ -113,7 +113,7 @@ OLAPStatus OlapMeta::put(const int column_family_index, const std::string& key,
     {
         SCOPED_RAW_TIMER(&duration_ns);
         WriteOptions write_options;
-        write_options.sync = config::sync_tablet_meta;
+        write_options.sync = _need_sync();
         s = _db->Put(write_options, handle, Slice(key), Slice(value));
     }
     DorisMetrics::meta_write_request_duration_us.increment(duration_ns / 1000);
@@ -132,7 +132,7 @@ OLAPStatus OlapMeta::remove(const int column_family_index, const std::string& ke
     {
         SCOPED_RAW_TIMER(&duration_ns);
         WriteOptions write_options;
-        write_options.sync = config::sync_tablet_meta;
+        write_options.sync = _need_sync();
         s = _db->Delete(write_options, handle, Slice(key));
     }
     DorisMetrics::meta_write_request_duration_us.increment(duration_ns / 1000);
@@ -177,6 +177,27 @@ OLAPStatus OlapMeta::iterate(const int column_family_index, const std::string& p
     return OLAP_SUCCESS;
 }
 
+OLAPStatus OlapMeta::sync() {
+    Status s = _db->SyncWAL();
+    if (!s.ok()) {
+        LOG(WARNING) << "rocks db sync wal failed, reason:" << s.ToString();
+        return OLAP_ERR_META_PUT;
+    }
+    return OLAP_SUCCESS;
+}
+
+bool OlapMeta::_need_sync() {
+    if (!config::sync_tablet_meta) {
+        return false;
+    }
+    OlapMetaSyncScope* scope = OlapMetaSyncScope::current();
+    if (scope == nullptr) {
+        return true;
+    }
+    scope->_metas.insert(this);
+    return false;
+}
+
 std::string OlapMeta::get_root_path() {
     return _root_path;
 }
@@ -202,4 +223,33 @@ OLAPStatus OlapMeta::set_tablet_convert_finished() {
     return s;
 }
 
+__thread OlapMetaSyncScope* OlapMetaSyncScope::_s_current = nullptr;
+
+OlapMetaSyncScope::OlapMetaSyncScope() : _parent(_s_current) {
+    _s_current = this;
+}
+
+OlapMetaSyncScope::~OlapMetaSyncScope() {
+    finish();
+}
+
+OLAPStatus OlapMetaSyncScope::finish() {
+    if (_finished) {
+        return OLAP_SUCCESS;
+    }
+    _finished = true;
+    DCHECK_EQ(_s_current, this);
+    _s_current = _parent;
+    OLAPStatus res = OLAP_SUCCESS;
+    for (OlapMeta* meta : _metas) {
+        OLAPStatus st = meta->sync();
+        if (st != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to sync meta. root_path=" << meta->get_root_path();
+            res = st;
+        }
+    }
+    _metas.clear();
+    return res;
+}
+
 }
@@ -20,6 +20,7 @@
 
 #include <string>
 #include <map>
+#include <set>
 #include <functional>
 
 #include "olap/olap_define.h"
@@ -50,12 +51,47 @@ public:
 
     OLAPStatus set_tablet_convert_finished();
 
+    // sync write ahead log to disk, all writes before are persisted
+    OLAPStatus sync();
+
 private:
+    // return true if a write should be synced to disk by itself
+    bool _need_sync();
+
     std::string _root_path;
     rocksdb::DB* _db;
     std::vector<rocksdb::ColumnFamilyHandle*> _handles;
 };
 
+// Meta writes of current thread are not synced one by one while an
+// OlapMetaSyncScope is alive. Instead, each OlapMeta written in the scope
+// syncs its write ahead log only once when finish() is called, so that
+// updating meta of many tablets, such as publishing a txn, costs one fsync
+// for each data dir.
+//
+// Writes are not guaranteed to be persisted until finish() returns
+// OLAP_SUCCESS, so caller should not report success before that.
+class OlapMetaSyncScope {
+public:
+    OlapMetaSyncScope();
+    // finish() is called if it is not called before
+    ~OlapMetaSyncScope();
+
+    OLAPStatus finish();
+
+private:
+    friend class OlapMeta;
+
+    static OlapMetaSyncScope* current() { return _s_current; }
+
+    // scopes can be nested, writes belong to the innermost one
+    OlapMetaSyncScope* _parent;
+    std::set<OlapMeta*> _metas;
+    bool _finished = false;
+
+    static __thread OlapMetaSyncScope* _s_current;
+};
+
 }
 
 #endif // DORIS_BE_SRC_OLAP_OLAP_OLAP_META_H
@@ -20,9 +20,15 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <ctime>
+#include <queue>
 #include <string>
+#include <utility>
+
+#include <boost/bind.hpp>
 
 #include <gperftools/profiler.h>
 
@@ -65,29 +71,50 @@ OLAPStatus StorageEngine::_start_bg_worker() {
         data_dirs.push_back(tmp_store.second);
     }
     int32_t data_dir_num = data_dirs.size();
-    // start be and ce threads for merge data
-    int32_t base_compaction_num_threads = config::base_compaction_num_threads_per_disk * data_dir_num;
-    _base_compaction_threads.reserve(base_compaction_num_threads);
-    for (uint32_t i = 0; i < base_compaction_num_threads; ++i) {
-        _base_compaction_threads.emplace_back(
-            [this, data_dir_num, data_dirs, i] {
-                _base_compaction_thread_callback(nullptr, data_dirs[i % data_dir_num]);
-            });
+    if (config::enable_merge_on_write) {
+        _primary_key_index_build_pool.reset(new ThreadPool(
+                std::max(config::primary_key_index_build_thread_num, 1),
+                std::max(config::primary_key_index_build_queue_size, 1)));
     }
-    for (auto& thread : _base_compaction_threads) {
-        thread.detach();
-    }
-
-    int32_t cumulative_compaction_num_threads = config::cumulative_compaction_num_threads_per_disk * data_dir_num;
-    _cumulative_compaction_threads.reserve(cumulative_compaction_num_threads);
-    for (uint32_t i = 0; i < cumulative_compaction_num_threads; ++i) {
-        _cumulative_compaction_threads.emplace_back(
-            [this, data_dir_num, data_dirs, i] {
-                _cumulative_compaction_thread_callback(nullptr, data_dirs[i % data_dir_num]);
+    if (config::enable_compaction_scheduler) {
+        _compaction_task_num_threads = config::compaction_task_num_threads;
+        if (_compaction_task_num_threads <= 0) {
+            _compaction_task_num_threads = (config::base_compaction_num_threads_per_disk
+                    + config::cumulative_compaction_num_threads_per_disk) * data_dir_num;
+        }
+        _compaction_task_num_threads = std::max(_compaction_task_num_threads, 1);
+        _compaction_task_pool.reset(new ThreadPool(_compaction_task_num_threads,
+                                                   _compaction_task_num_threads));
+        _compaction_scheduler_thread = std::thread(
+            [this] {
+                _compaction_scheduler_thread_callback(nullptr);
             });
-    }
-    for (auto& thread : _cumulative_compaction_threads) {
-        thread.detach();
+        _compaction_scheduler_thread.detach();
+    } else {
+        // start be and ce threads for merge data
+        int32_t base_compaction_num_threads = config::base_compaction_num_threads_per_disk * data_dir_num;
+        _base_compaction_threads.reserve(base_compaction_num_threads);
+        for (uint32_t i = 0; i < base_compaction_num_threads; ++i) {
+            _base_compaction_threads.emplace_back(
+                [this, data_dir_num, data_dirs, i] {
+                    _base_compaction_thread_callback(nullptr, data_dirs[i % data_dir_num]);
+                });
+        }
+        for (auto& thread : _base_compaction_threads) {
+            thread.detach();
+        }
+
+        int32_t cumulative_compaction_num_threads = config::cumulative_compaction_num_threads_per_disk * data_dir_num;
+        _cumulative_compaction_threads.reserve(cumulative_compaction_num_threads);
+        for (uint32_t i = 0; i < cumulative_compaction_num_threads; ++i) {
+            _cumulative_compaction_threads.emplace_back(
+                [this, data_dir_num, data_dirs, i] {
+                    _cumulative_compaction_thread_callback(nullptr, data_dirs[i % data_dir_num]);
+                });
+        }
+        for (auto& thread : _cumulative_compaction_threads) {
+            thread.detach();
+        }
     }
 
     _fd_cache_clean_thread = std::thread(
@@ -256,6 +283,137 @@ void* StorageEngine::_cumulative_compaction_thread_callback(void* arg, DataDir*
     return nullptr;
 }
 
+void* StorageEngine::_compaction_scheduler_thread_callback(void* arg) {
+#ifdef GOOGLE_PROFILER
+    ProfilerRegisterThread();
+#endif
+    LOG(INFO) << "try to start compaction scheduler process!";
+    int32_t interval_ms = config::compaction_schedule_interval_ms;
+    if (interval_ms <= 0) {
+        LOG(WARNING) << "compaction schedule interval config is illegal:" << interval_ms
+            << "will be forced set to 1000";
+        interval_ms = 1000;
+    }
+
+    while (true) {
+        _tablet_manager->update_tablets_query_load();
+        _schedule_compaction_tasks();
+        // rescore tablets when a task finishes, or the interval passes
+        std::unique_lock<std::mutex> l(_compaction_mutex);
+        _compaction_cond.wait_for(l, std::chrono::milliseconds(interval_ms));
+    }
+
+    return nullptr;
+}
+
+namespace {
+
+struct CompactionTaskCandidate {
+    CompactionTaskCandidate(TabletSharedPtr tablet_, CompactionType type_, double score_)
+        : tablet(std::move(tablet_)), type(type_), score(score_) { }
+    TabletSharedPtr tablet;
+    CompactionType type;
+    double score;
+};
+
+struct CompactionTaskCandidateComparator {
+    bool operator()(const CompactionTaskCandidate& a, const CompactionTaskCandidate& b) {
+        return a.score < b.score;
+    }
+};
+
+} // namespace
+
+void StorageEngine::_schedule_compaction_tasks() {
+    {
+        std::lock_guard<std::mutex> l(_compaction_mutex);
+        if (_running_compaction_task_num >= _compaction_task_num_threads) {
+            return;
+        }
+    }
+
+    // Score is the number of versions to merge, which is also the read
+    // amplification of queries, boosted by recent query load of tablet so
+    // that hot tablets are compacted before they have too many versions.
+    std::priority_queue<CompactionTaskCandidate, std::vector<CompactionTaskCandidate>,
+                        CompactionTaskCandidateComparator> candidates;
+    for (auto type : {CompactionType::CUMULATIVE_COMPACTION, CompactionType::BASE_COMPACTION}) {
+        std::vector<std::pair<TabletSharedPtr, uint32_t>> tablets;
+        _tablet_manager->get_compaction_candidates(type, &tablets);
+        for (auto& it : tablets) {
+            double weight = 1.0 + std::log2(1.0 + it.first->query_load());
+            candidates.emplace(it.first, type, it.second * weight);
+        }
+    }
+
+    while (!candidates.empty()) {
+        const CompactionTaskCandidate& candidate = candidates.top();
+        TabletSharedPtr tablet = candidate.tablet;
+        CompactionType type = candidate.type;
+        double score = candidate.score;
+        candidates.pop();
+        {
+            std::lock_guard<std::mutex> l(_compaction_mutex);
+            if (_running_compaction_task_num >= _compaction_task_num_threads) {
+                break;
+            }
+            // every disk has its own budget, so that a busy disk doesn't
+            // block compaction of others
+            int32_t& disk_task_num = _running_compaction_task_num_per_disk[tablet->data_dir()];
+            if (disk_task_num >= config::compaction_task_num_per_disk
+                    || _compacting_tablets.count(tablet->tablet_id()) > 0) {
+                continue;
+            }
+            ++disk_task_num;
+            ++_running_compaction_task_num;
+            _compacting_tablets.insert(tablet->tablet_id());
+        }
+        VLOG(3) << "schedule compaction task. type="
+                << (type == CompactionType::CUMULATIVE_COMPACTION ? "cumulative" : "base")
+                << ", tablet=" << tablet->full_name() << ", score=" << score;
+        // pool is large enough for running tasks, offer won't block
+        _compaction_task_pool->offer(
+            boost::bind<void>(&StorageEngine::_run_compaction_task, this, tablet, type));
+    }
+}
+
+bool StorageEngine::submit_primary_key_index_build(const TabletSharedPtr& tablet) {
+    if (_primary_key_index_build_pool == nullptr) {
+        return false;
+    }
+    // don't block queries on a full queue, the check races with other
+    // submitters but the queue is rarely full
+    if (static_cast<int32_t>(_primary_key_index_build_pool->get_queue_size())
+            >= config::primary_key_index_build_queue_size) {
+        return false;
+    }
+    return _primary_key_index_build_pool->offer(
+        boost::bind<void>(&StorageEngine::_build_primary_key_index, this, tablet));
+}
+
+void StorageEngine::_build_primary_key_index(TabletSharedPtr tablet) {
+    CgroupsMgr::apply_system_cgroup();
+    // failures are logged by the tablet, and the build is submitted again
+    // by a later query
+    tablet->build_primary_key_index();
+}
+
+void StorageEngine::_run_compaction_task(TabletSharedPtr tablet, CompactionType compaction_type) {
+    CgroupsMgr::apply_system_cgroup();
+    if (compaction_type == CompactionType::CUMULATIVE_COMPACTION) {
+        _perform_cumulative_compaction(tablet);
+    } else {
+        _perform_base_compaction(tablet);
+    }
+    {
+        std::lock_guard<std::mutex> l(_compaction_mutex);
+        --_running_compaction_task_num_per_disk[tablet->data_dir()];
+        --_running_compaction_task_num;
+        _compacting_tablets.erase(tablet->tablet_id());
+    }
+    _compaction_cond.notify_one();
+}
+
 void* StorageEngine::_unused_rowset_monitor_thread_callback(void* arg) {
 #ifdef GOOGLE_PROFILER
     ProfilerRegisterThread();
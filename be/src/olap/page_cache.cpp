@@ -17,6 +17,10 @@
 
 #include "olap/page_cache.h"
 
+#include <algorithm>
+
+#include "common/logging.h"
+
 namespace doris {
 
 // This should only be used in unit test. 1GB
@@ -24,30 +28,55 @@ static StoragePageCache s_ut_cache(1073741824);
 
 StoragePageCache* StoragePageCache::_s_instance = &s_ut_cache;
 
-void StoragePageCache::create_global_cache(size_t capacity) {
+void StoragePageCache::create_global_cache(size_t capacity, int32_t index_cache_percentage,
+                                           int32_t data_cold_percentage) {
     if (_s_instance == &s_ut_cache) {
-        _s_instance = new StoragePageCache(capacity);
+        _s_instance = new StoragePageCache(capacity, index_cache_percentage, data_cold_percentage);
+    }
+}
+
+StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percentage,
+                                   int32_t data_cold_percentage) {
+    if (index_cache_percentage < 0 || index_cache_percentage >= 100) {
+        LOG(WARNING) << "invalid index page cache percentage " << index_cache_percentage
+            << ", index pages will share cache with data pages";
+        index_cache_percentage = 0;
+    }
+    data_cold_percentage = std::min(std::max(data_cold_percentage, 0), 100);
+
+    size_t index_capacity = capacity / 100 * index_cache_percentage;
+    _data_page_cache.reset(new_lru_cache(capacity - index_capacity, data_cold_percentage));
+    if (index_capacity > 0) {
+        _index_page_cache.reset(new_lru_cache(index_capacity));
     }
 }
 
-StoragePageCache::StoragePageCache(size_t capacity) : _cache(new_lru_cache(capacity)) {
+std::string StoragePageCache::_encode_key(const CacheKey& key, PageCacheType type) {
+    std::string key_buf = key.encode();
+    if (type == PageCacheType::DECOMPRESSED_DATA_PAGE) {
+        key_buf.push_back('D');
+    }
+    return key_buf;
 }
 
-bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle) {
-    auto lru_handle = _cache->lookup(key.encode());
+bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle, PageCacheType type) {
+    Cache* cache = _get_cache(type);
+    auto lru_handle = cache->lookup(_encode_key(key, type));
     if (lru_handle == nullptr) {
         return false;
     }
-    *handle = PageCacheHandle(_cache.get(), lru_handle);
+    *handle = PageCacheHandle(cache, lru_handle);
     return true;
 }
 
-void StoragePageCache::insert(const CacheKey& key, const Slice& data, PageCacheHandle* handle) {
+void StoragePageCache::insert(const CacheKey& key, const Slice& data, PageCacheHandle* handle,
+                              PageCacheType type, CachePriority priority) {
     auto deleter = [](const doris::CacheKey& key, void* value) {
         delete[] (uint8_t*)value;
     };
-    auto lru_handle = _cache->insert(key.encode(), data.data, data.size, deleter);
-    *handle = PageCacheHandle(_cache.get(), lru_handle);
+    Cache* cache = _get_cache(type);
+    auto lru_handle = cache->insert(_encode_key(key, type), data.data, data.size, deleter, priority);
+    *handle = PageCacheHandle(cache, lru_handle);
 }
 
 }
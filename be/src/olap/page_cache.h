@@ -28,8 +28,19 @@ namespace doris {
 
 class PageCacheHandle;
 
+// Type of page in StoragePageCache, each type has its own capacity.
+enum class PageCacheType {
+    DATA_PAGE = 0,
+    INDEX_PAGE = 1,
+    // decompressed form of data page, it's cached with data pages but
+    // doesn't share key with the compressed form of the same page
+    DECOMPRESSED_DATA_PAGE = 2
+};
+
 // Warpper around Cache, and used for cache page of column datas
 // in Segment.
+// Index pages and data pages are cached in separate sharded LRU caches, so
+// that scanning data pages don't evict index pages.
 // TODO(zc): We should add some metric to see cache hit/miss rate.
 class StoragePageCache {
 public:
@@ -53,13 +64,18 @@ public:
     };
 
     // Create global instance of this class
-    static void create_global_cache(size_t capacity);
+    static void create_global_cache(size_t capacity, int32_t index_cache_percentage,
+                                    int32_t data_cold_percentage);
 
     // Return global instance.
     // Client should call create_global_cache before.
     static StoragePageCache* instance() { return _s_instance; }
 
-    StoragePageCache(size_t capacity);
+    // index_cache_percentage of capacity is used to cache index pages, if it's 0,
+    // index pages and data pages share the whole capacity.
+    // data_cold_percentage is passed to new_lru_cache as cold_percent of data pages.
+    StoragePageCache(size_t capacity, int32_t index_cache_percentage = 0,
+                     int32_t data_cold_percentage = 0);
 
     // Lookup the given page in the cache.
     //
@@ -68,18 +84,34 @@ public:
     // destructs.
     //
     // Return true if entry is found, otherwise return false.
-    bool lookup(const CacheKey& key, PageCacheHandle* handle);
+    bool lookup(const CacheKey& key, PageCacheHandle* handle,
+                PageCacheType type = PageCacheType::DATA_PAGE);
 
     // Insert a page with key into this cache.
     // Given hanlde will be set to valid reference.
     // This function is thread-safe, and when two clients insert two same key
     // concurrently, this function can assure that only one page is cached.
-    void insert(const CacheKey& key, const Slice& data, PageCacheHandle* handle);
+    // Pages read ahead should be inserted with CachePriority::PREFETCH.
+    void insert(const CacheKey& key, const Slice& data, PageCacheHandle* handle,
+                PageCacheType type = PageCacheType::DATA_PAGE,
+                CachePriority priority = CachePriority::NORMAL);
 private:
     StoragePageCache();
     static StoragePageCache* _s_instance;
 
-    std::unique_ptr<Cache> _cache = nullptr;
+    // encode key of page of type to the key of LRUCache
+    static std::string _encode_key(const CacheKey& key, PageCacheType type);
+
+    Cache* _get_cache(PageCacheType type) {
+        if (type == PageCacheType::INDEX_PAGE && _index_page_cache != nullptr) {
+            return _index_page_cache.get();
+        }
+        return _data_page_cache.get();
+    }
+
+    std::unique_ptr<Cache> _data_page_cache = nullptr;
+    // nullptr if index pages are cached in _data_page_cache
+    std::unique_ptr<Cache> _index_page_cache = nullptr;
 };
 
 // A handle for StoragePageCache entry. This class make it easy to handle
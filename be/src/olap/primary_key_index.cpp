@@ -0,0 +1,301 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/primary_key_index.h"
+
+#include <climits>
+
+#include "olap/delete_handler.h"
+#include "olap/olap_cond.h"
+#include "olap/row_block.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/alpha_rowset.h"
+#include "olap/rowset/column_data.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet_schema.h"
+
+namespace doris {
+
+// Encode key columns of 'row' into 'buf', which is used as the key of the
+// index only, so it doesn't need to keep the order of keys.
+static void encode_key(const RowCursor& row, size_t num_key_columns, std::string* buf) {
+    for (uint32_t cid = 0; cid < num_key_columns; ++cid) {
+        if (row.is_null(cid)) {
+            buf->push_back(0);
+            continue;
+        }
+        buf->push_back(1);
+        const Field* field = row.column_schema(cid);
+        const char* cell = row.cell_ptr(cid);
+        if (field->type() == OLAP_FIELD_TYPE_CHAR || field->type() == OLAP_FIELD_TYPE_VARCHAR) {
+            const Slice* slice = reinterpret_cast<const Slice*>(cell);
+            uint32_t size = slice->size;
+            buf->append(reinterpret_cast<const char*>(&size), sizeof(size));
+            buf->append(slice->data, slice->size);
+        } else {
+            buf->append(cell, field->size());
+        }
+    }
+}
+
+PrimaryKeyIndex::PrimaryKeyIndex(const TabletSchema* schema) : _schema(schema) {
+}
+
+OLAPStatus PrimaryKeyIndex::_scan_rows(
+        const RowsetSharedPtr& rowset,
+        const std::function<void(std::string&&, const RowLocation&)>& func) {
+    AlphaRowset* alpha_rowset = dynamic_cast<AlphaRowset*>(rowset.get());
+    if (alpha_rowset == nullptr) {
+        LOG(WARNING) << "only alpha rowsets are indexed. rowset_id=" << rowset->rowset_id();
+        return OLAP_ERR_ROWSET_TYPE_NOT_FOUND;
+    }
+    RETURN_NOT_OK(rowset->load());
+
+    std::vector<uint32_t> key_cids;
+    for (uint32_t cid = 0; cid < _schema->num_key_columns(); ++cid) {
+        key_cids.push_back(cid);
+    }
+    Conditions conditions;
+    conditions.set_tablet_schema(_schema);
+    std::set<uint32_t> load_bf_columns;
+    std::vector<ColumnPredicate*> predicates;
+    DeleteHandler delete_handler;
+    OlapReaderStatistics stats;
+    RowCursor cursor;
+    RETURN_NOT_OK(cursor.init(*_schema, key_cids));
+
+    RowLocation location;
+    location.rowset_id = rowset->rowset_id();
+    location.version = rowset->end_version();
+    for (auto& segment_group : alpha_rowset->segment_groups()) {
+        if (segment_group->empty() || segment_group->zero_num_rows()) {
+            continue;
+        }
+        std::unique_ptr<ColumnData> column_data(ColumnData::create(segment_group.get()));
+        RETURN_NOT_OK(column_data->init());
+        column_data->set_delete_handler(&delete_handler);
+        column_data->set_delete_status(DEL_NOT_SATISFIED);
+        column_data->set_stats(&stats);
+        column_data->set_lru_cache(StorageEngine::instance()->index_stream_lru_cache());
+        column_data->set_read_params(key_cids, key_cids, load_bf_columns, conditions,
+                                     predicates, false, nullptr);
+
+        location.segment_group_id = segment_group->segment_group_id();
+        RowBlock* block = nullptr;
+        OLAPStatus res = column_data->prepare_block_read(nullptr, false, nullptr, false, &block);
+        while (res == OLAP_SUCCESS && block != nullptr) {
+            // there are no conditions, so rows of the block are not filtered
+            uint32_t first_row_id = column_data->current_block_first_row_id();
+            location.segment_id = column_data->current_segment();
+            for (uint32_t i = 0; i < block->limit(); ++i) {
+                block->get_row(i, &cursor);
+                std::string key;
+                encode_key(cursor, key_cids.size(), &key);
+                location.row_id = first_row_id + i;
+                func(std::move(key), location);
+            }
+            res = column_data->get_next_block(&block);
+        }
+        if (res != OLAP_SUCCESS && res != OLAP_ERR_DATA_EOF) {
+            LOG(WARNING) << "fail to read keys of rowset. rowset_id=" << rowset->rowset_id()
+                         << ", res=" << res;
+            return res;
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+void PrimaryKeyIndex::_apply_deletes(
+        const std::map<SegmentKey, std::vector<std::pair<uint32_t, int64_t>>>& deletes) {
+    for (auto& it : deletes) {
+        std::shared_ptr<SegmentDeleteBitmap> bitmap;
+        auto old_it = _delete_bitmaps.find(it.first);
+        if (old_it != _delete_bitmaps.end()) {
+            // copy on write, the old one may be captured by readers
+            bitmap.reset(new SegmentDeleteBitmap(*old_it->second));
+        } else {
+            bitmap.reset(new SegmentDeleteBitmap());
+        }
+        for (auto& row : it.second) {
+            // keep the first version superseding the row
+            bitmap->emplace(row.first, row.second);
+        }
+        _delete_bitmaps[it.first] = bitmap;
+    }
+}
+
+OLAPStatus PrimaryKeyIndex::add_rowset(const RowsetSharedPtr& rowset) {
+    std::lock_guard<std::mutex> update_guard(_update_lock);
+    if (rowset->start_version() != max_version() + 1) {
+        LOG(WARNING) << "rowset is not next to indexed versions. rowset_id=" << rowset->rowset_id()
+                     << ", start_version=" << rowset->start_version()
+                     << ", max_version=" << max_version();
+        return OLAP_ERR_VERSION_NOT_EXIST;
+    }
+
+    std::vector<std::pair<std::string, RowLocation>> rows;
+    RETURN_NOT_OK(_scan_rows(rowset, [&rows](std::string&& key, const RowLocation& location) {
+        rows.emplace_back(std::move(key), location);
+    }));
+
+    std::lock_guard<std::mutex> l(_lock);
+    std::map<SegmentKey, std::vector<std::pair<uint32_t, int64_t>>> deletes;
+    for (auto& row : rows) {
+        auto it = _locations.find(row.first);
+        if (it == _locations.end()) {
+            _locations.emplace(std::move(row.first), row.second);
+            continue;
+        }
+        deletes[_segment_key(it->second)].emplace_back(it->second.row_id, rowset->end_version());
+        it->second = row.second;
+    }
+    _apply_deletes(deletes);
+    _rowset_ids.insert(rowset->rowset_id());
+    _max_version = rowset->end_version();
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus PrimaryKeyIndex::replace_rowsets(const std::vector<RowsetSharedPtr>& input_rowsets,
+                                            const RowsetSharedPtr& output_rowset) {
+    std::lock_guard<std::mutex> update_guard(_update_lock);
+    std::set<RowsetId> input_ids;
+    std::vector<RowsetSharedPtr> superseded_rowsets;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& rowset : input_rowsets) {
+            if (_rowset_ids.count(rowset->rowset_id()) == 0) {
+                LOG(WARNING) << "compacted rowset is not indexed. rowset_id=" << rowset->rowset_id();
+                return OLAP_ERR_VERSION_NOT_EXIST;
+            }
+            input_ids.insert(rowset->rowset_id());
+            // find input rowsets with rows superseded by rowsets out of the compaction
+            auto it = _delete_bitmaps.lower_bound(SegmentKey(rowset->rowset_id(), INT32_MIN, 0));
+            bool superseded = false;
+            for (; !superseded && it != _delete_bitmaps.end()
+                    && std::get<0>(it->first) == rowset->rowset_id(); ++it) {
+                for (auto& row : *it->second) {
+                    if (row.second > output_rowset->end_version()) {
+                        superseded = true;
+                        break;
+                    }
+                }
+            }
+            if (superseded) {
+                superseded_rowsets.push_back(rowset);
+            }
+        }
+    }
+
+    // The latest row of a key among input rowsets is superseded by the first
+    // version out of the compaction, which is found in its delete bitmap.
+    std::unordered_map<std::string, int64_t> superseded_keys;
+    for (auto& rowset : superseded_rowsets) {
+        std::shared_ptr<const SegmentDeleteBitmap> bitmap;
+        SegmentKey bitmap_key;
+        RETURN_NOT_OK(_scan_rows(rowset, [&](std::string&& key, const RowLocation& location) {
+            SegmentKey segment_key = _segment_key(location);
+            if (bitmap == nullptr || bitmap_key != segment_key) {
+                std::lock_guard<std::mutex> l(_lock);
+                auto it = _delete_bitmaps.find(segment_key);
+                bitmap = it != _delete_bitmaps.end()
+                    ? it->second : std::make_shared<const SegmentDeleteBitmap>();
+                bitmap_key = segment_key;
+            }
+            auto it = bitmap->find(location.row_id);
+            if (it != bitmap->end() && it->second > output_rowset->end_version()) {
+                superseded_keys[std::move(key)] = it->second;
+            }
+        }));
+    }
+
+    std::vector<std::pair<std::string, RowLocation>> rows;
+    RETURN_NOT_OK(_scan_rows(output_rowset, [&rows](std::string&& key, const RowLocation& location) {
+        rows.emplace_back(std::move(key), location);
+    }));
+
+    std::lock_guard<std::mutex> l(_lock);
+    std::map<SegmentKey, std::vector<std::pair<uint32_t, int64_t>>> deletes;
+    for (auto& row : rows) {
+        auto superseded_it = superseded_keys.find(row.first);
+        if (superseded_it != superseded_keys.end()) {
+            deletes[_segment_key(row.second)].emplace_back(row.second.row_id,
+                                                           superseded_it->second);
+        }
+        auto it = _locations.find(row.first);
+        if (it == _locations.end() || input_ids.count(it->second.rowset_id) > 0) {
+            _locations[row.first] = row.second;
+        }
+    }
+    // keys removed by delete conditions in base compaction
+    for (auto it = _locations.begin(); it != _locations.end();) {
+        if (input_ids.count(it->second.rowset_id) > 0) {
+            it = _locations.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // readers of input rowsets have captured their bitmaps
+    for (auto it = _delete_bitmaps.begin(); it != _delete_bitmaps.end();) {
+        if (input_ids.count(std::get<0>(it->first)) > 0) {
+            it = _delete_bitmaps.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _apply_deletes(deletes);
+    for (auto id : input_ids) {
+        _rowset_ids.erase(id);
+    }
+    _rowset_ids.insert(output_rowset->rowset_id());
+    return OLAP_SUCCESS;
+}
+
+bool PrimaryKeyIndex::capture_delete_bitmaps(const std::vector<RowsetSharedPtr>& rowsets,
+                                             DeleteBitmapSnapshot* snapshot) const {
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto& rowset : rowsets) {
+        if (_rowset_ids.count(rowset->rowset_id()) == 0) {
+            return false;
+        }
+        auto it = _delete_bitmaps.lower_bound(SegmentKey(rowset->rowset_id(), INT32_MIN, 0));
+        for (; it != _delete_bitmaps.end() && std::get<0>(it->first) == rowset->rowset_id(); ++it) {
+            snapshot->emplace(it->first, it->second);
+        }
+    }
+    return true;
+}
+
+bool PrimaryKeyIndex::covers(const std::vector<RowsetSharedPtr>& rowsets) const {
+    std::set<RowsetId> rowset_ids;
+    for (auto& rowset : rowsets) {
+        rowset_ids.insert(rowset->rowset_id());
+    }
+    std::lock_guard<std::mutex> l(_lock);
+    return rowset_ids == _rowset_ids;
+}
+
+int64_t PrimaryKeyIndex::max_version() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _max_version;
+}
+
+size_t PrimaryKeyIndex::num_keys() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _locations.size();
+}
+
+} // namespace doris
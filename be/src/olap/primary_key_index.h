@@ -0,0 +1,127 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_OLAP_PRIMARY_KEY_INDEX_H
+#define DORIS_BE_SRC_OLAP_PRIMARY_KEY_INDEX_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "olap/olap_common.h"
+#include "olap/olap_define.h"
+#include "olap/rowset/rowset.h"
+
+namespace doris {
+
+class TabletSchema;
+
+// Rows of a segment superseded by rows of later versions, row id -> the
+// version superseding it. A row is invisible to reads of versions not less
+// than it.
+typedef std::unordered_map<uint32_t, int64_t> SegmentDeleteBitmap;
+
+// (rowset id, segment group id, segment id)
+typedef std::tuple<RowsetId, int32_t, uint32_t> SegmentKey;
+
+// Delete bitmaps of the segments of some rowsets captured by a reader, the
+// bitmaps are immutable so that they are not changed by later loads.
+typedef std::map<SegmentKey, std::shared_ptr<const SegmentDeleteBitmap>> DeleteBitmapSnapshot;
+
+// Location of a row in an alpha rowset
+struct RowLocation {
+    RowsetId rowset_id;
+    // end version of the rowset
+    int64_t version;
+    int32_t segment_group_id;
+    uint32_t segment_id;
+    uint32_t row_id;
+};
+
+// Primary key index of a UNIQUE_KEYS tablet for merge-on-write. It maps every
+// key to the location of its latest row, and when a rowset is published, rows
+// of older rowsets with the same keys are marked in delete bitmaps. So a
+// reader can read rowsets one after another without merging them, skipping
+// rows in delete bitmaps.
+//
+// The index is in memory only. It's built in background when the tablet is
+// first queried and kept updated by publish and compaction. It's dropped if
+// rowsets are changed in other ways, e.g. by clone, and built again by a later
+// query. Queries merge rowsets as before while there is no index.
+class PrimaryKeyIndex {
+public:
+    explicit PrimaryKeyIndex(const TabletSchema* schema);
+
+    // Add rows of 'rowset', which must start from max_version() + 1. Rows of
+    // indexed rowsets and rows of former segment groups of 'rowset' with the
+    // same keys are marked deleted by the version of 'rowset'.
+    OLAPStatus add_rowset(const RowsetSharedPtr& rowset);
+
+    // Update the index after 'input_rowsets' are compacted into 'output_rowset'.
+    // Rows of 'output_rowset' superseded by rowsets out of the compaction
+    // are marked deleted.
+    OLAPStatus replace_rowsets(const std::vector<RowsetSharedPtr>& input_rowsets,
+                               const RowsetSharedPtr& output_rowset);
+
+    // Capture delete bitmaps of segments of 'rowsets' into 'snapshot'.
+    // Return false if any of them is not indexed.
+    bool capture_delete_bitmaps(const std::vector<RowsetSharedPtr>& rowsets,
+                                DeleteBitmapSnapshot* snapshot) const;
+
+    // Return true if the indexed rowsets are exactly 'rowsets'
+    bool covers(const std::vector<RowsetSharedPtr>& rowsets) const;
+
+    // rowsets of versions [0, max_version()] are indexed
+    int64_t max_version() const;
+
+    size_t num_keys() const;
+
+private:
+    // Call 'func' with the encoded key and location of every row of 'rowset'.
+    // Segment groups are scanned in order, so are rows of each segment.
+    OLAPStatus _scan_rows(const RowsetSharedPtr& rowset,
+                          const std::function<void(std::string&&, const RowLocation&)>& func);
+
+    // Add deleted rows into copies of the bitmaps of their segments.
+    // Caller should hold _lock.
+    void _apply_deletes(const std::map<SegmentKey, std::vector<std::pair<uint32_t, int64_t>>>& deletes);
+
+    static SegmentKey _segment_key(const RowLocation& location) {
+        return SegmentKey(location.rowset_id, location.segment_group_id, location.segment_id);
+    }
+
+    const TabletSchema* _schema;
+
+    // serialize updates, which read rowsets without holding _lock
+    std::mutex _update_lock;
+
+    mutable std::mutex _lock;
+    std::unordered_map<std::string, RowLocation> _locations;
+    std::map<SegmentKey, std::shared_ptr<const SegmentDeleteBitmap>> _delete_bitmaps;
+    std::set<RowsetId> _rowset_ids;
+    int64_t _max_version = -1;
+};
+
+} // namespace doris
+
+#endif // DORIS_BE_SRC_OLAP_PRIMARY_KEY_INDEX_H
@@ -17,6 +17,7 @@
 
 #include "olap/reader.h"
 
+#include "olap/rowset/alpha_rowset.h"
 #include "olap/rowset/column_data.h"
 #include "olap/tablet.h"
 #include "olap/row_block.h"
@@ -25,13 +26,19 @@
 #include "util/mem_util.hpp"
 #include "runtime/mem_tracker.h"
 #include "runtime/mem_pool.h"
+#include <strings.h>
+
+#include <algorithm>
 #include <sstream>
 
 #include "olap/comparison_predicate.h"
 #include "olap/in_list_predicate.h"
 #include "olap/null_predicate.h"
 #include "olap/storage_engine.h"
+#include "common/config.h"
 #include "olap/row.h"
+#include "olap/rowset/segment_v2/column_zone_map.h"
+#include "olap/wrapper_field.h"
 
 using std::nothrow;
 using std::set;
@@ -49,7 +56,7 @@ public:
 
     OLAPStatus add_child(RowsetReaderSharedPtr rs_reader);
 
-    // Get top row of the heap, NULL if reach end.
+    // Get top row of the merge tree, NULL if reach end.
     const RowCursor* current_row(bool* delete_flag) const {
         if (_cur_child != nullptr) {
             return _cur_child->current_row(delete_flag);
@@ -57,7 +64,7 @@ public:
         return nullptr;
     }
 
-    // Pop the top element and rebuild the heap to
+    // Move the top element to its next row and replay the merge tree to
     // get the next row cursor.
     inline OLAPStatus next(const RowCursor** row, bool* delete_flag);
 
@@ -78,6 +85,11 @@ private:
                 LOG(WARNING) << "failed to init row cursor, res=" << res;
                 return res;
             }
+            res = _last_row_cursor.init(_reader->_tablet->tablet_schema(), _reader->_seek_columns);
+            if (res != OLAP_SUCCESS) {
+                LOG(WARNING) << "failed to init row cursor, res=" << res;
+                return res;
+            }
             RETURN_NOT_OK(_refresh_current_row());
             return OLAP_SUCCESS;
         }
@@ -95,6 +107,19 @@ private:
             return _rs_reader->version().second;
         }
 
+        // sequence number of current row block, increased by one every time
+        // a new block is read from rowset reader, which may reuse the block
+        uint64_t block_seq() const {
+            return _block_seq;
+        }
+
+        // The last row of current row block, it is the max row of the block.
+        // Should only be called when current row is not nullptr.
+        const RowCursor* block_last_row() {
+            _row_block->get_row(_row_block->limit() - 1, &_last_row_cursor);
+            return &_last_row_cursor;
+        }
+
         OLAPStatus next(const RowCursor** row, bool* delete_flag) {
             _row_block->pos_inc();
             auto res = _refresh_current_row();
@@ -124,6 +149,7 @@ private:
                         _current_row = nullptr;
                         return res;
                     }
+                    ++_block_seq;
                 }
             } while (_row_block != nullptr);
             _current_row = nullptr;
@@ -136,14 +162,9 @@ private:
         Reader* _reader;
 
         RowCursor _row_cursor;
+        RowCursor _last_row_cursor;
         RowBlock* _row_block = nullptr;
-    };
-
-    // Compare row cursors between multiple merge elements,
-    // if row cursors equal, compare data version.
-    class ChildCtxComparator {
-    public:
-        bool operator()(const ChildCtx* a, const ChildCtx* b);
+        uint64_t _block_seq = 0;
     };
 
     inline OLAPStatus _merge_next(const RowCursor** row, bool* delete_flag);
@@ -152,8 +173,28 @@ private:
     // If _merge is true, result row must be ordered
     bool _merge = true;
 
-    typedef std::priority_queue<ChildCtx*, std::vector<ChildCtx*>, ChildCtxComparator> MergeHeap;
-    MergeHeap _heap;
+    // Return true if current row of lhs should be output before rhs, rows
+    // are compared by keys first, and then data versions. Child which reaches
+    // end is after all others.
+    bool _is_before(const ChildCtx* lhs, const ChildCtx* rhs) const;
+    bool _is_before(const RowCursor& lhs_row, const ChildCtx* lhs, const ChildCtx* rhs) const;
+
+    // Replay the merge tree from leaf of _children[idx] to root.
+    void _adjust_tree(int idx);
+    void _rebuild_tree();
+    // Try to start a run of the winner, all remaining rows of its current
+    // block are output without replaying the tree if the last row of the
+    // block is before current rows of all other children.
+    void _try_start_run();
+
+    // Loser tree of _children for merge, _tree[0] is index of the winner,
+    // and _tree[i] is the loser of internal node i. Leaf of _children[i] is
+    // node i + _children.size().
+    std::vector<int> _tree;
+    // index of winner in last replay, used to detect runs
+    int _last_winner = -1;
+    // block_seq of winner when it is in a run, or 0 if not in a run
+    uint64_t _run_block_seq = 0;
 
     std::vector<ChildCtx*> _children;
     ChildCtx* _cur_child = nullptr;
@@ -174,10 +215,14 @@ CollectIterator::~CollectIterator() {
 OLAPStatus CollectIterator::init(Reader* reader) {
     _reader = reader;
     // when aggregate is enabled or key_type is DUP_KEYS, we don't merge
-    // multiple data to aggregate for performance in user fetch
+    // multiple data to aggregate for performance in user fetch, neither when
+    // keys of rowsets don't overlap, which has nothing to aggregate. But rows
+    // of overlapping rowsets are still merged if they are needed in order.
     if (_reader->_reader_type == READER_QUERY &&
-            (_reader->_aggregation ||
-             _reader->_tablet->keys_type() == KeysType::DUP_KEYS)) {
+            (_reader->_skip_merge ||
+             (!_reader->_need_ordered_result &&
+              (_reader->_aggregation ||
+               _reader->_tablet->keys_type() == KeysType::DUP_KEYS)))) {
         _merge = false;
     }
     return OLAP_SUCCESS;
@@ -193,8 +238,8 @@ OLAPStatus CollectIterator::add_child(RowsetReaderSharedPtr rs_reader) {
     ChildCtx* child_ptr = child.release();
     _children.push_back(child_ptr);
     if (_merge) {
-        _heap.push(child_ptr);
-        _cur_child = _heap.top();
+        _rebuild_tree();
+        _cur_child = _children[_tree[0]];
     } else {
         if (_cur_child == nullptr) {
             _cur_child = _children[_child_idx];
@@ -213,22 +258,28 @@ inline OLAPStatus CollectIterator::next(const RowCursor** row, bool* delete_flag
 }
 
 inline OLAPStatus CollectIterator::_merge_next(const RowCursor** row, bool* delete_flag) {
-    _heap.pop();
     auto res = _cur_child->next(row, delete_flag);
-    if (res == OLAP_SUCCESS) {
-        _heap.push(_cur_child);
-        _cur_child = _heap.top();
-    } else if (res == OLAP_ERR_DATA_EOF) {
-        if (_heap.size() > 0) {
-            _cur_child = _heap.top();
-        } else {
-            _cur_child = nullptr;
-            return OLAP_ERR_DATA_EOF;
-        }
-    } else {
+    if (UNLIKELY(res != OLAP_SUCCESS && res != OLAP_ERR_DATA_EOF)) {
         LOG(WARNING) << "failed to get next from child, res=" << res;
         return res;
     }
+    // rows in the same block of a run are known to be before other children
+    if (res == OLAP_SUCCESS && _run_block_seq != 0
+            && _cur_child->block_seq() == _run_block_seq) {
+        return OLAP_SUCCESS;
+    }
+    _run_block_seq = 0;
+    _adjust_tree(_tree[0]);
+    _cur_child = _children[_tree[0]];
+    if (_cur_child->current_row() == nullptr) {
+        // winner reaches end, so do all children
+        _cur_child = nullptr;
+        return OLAP_ERR_DATA_EOF;
+    }
+    if (_tree[0] == _last_winner) {
+        _try_start_run();
+    }
+    _last_winner = _tree[0];
     *row = _cur_child->current_row(delete_flag);
     return OLAP_SUCCESS;
 }
@@ -254,22 +305,76 @@ inline OLAPStatus CollectIterator::_normal_next(const RowCursor** row, bool* del
     }
 }
 
-bool CollectIterator::ChildCtxComparator::operator()(const ChildCtx* a, const ChildCtx* b) {
-    // First compare row cursor.
-    const RowCursor* first = a->current_row();
-    const RowCursor* second = b->current_row();
-    int cmp_res = compare_row(*first, *second);
+bool CollectIterator::_is_before(const ChildCtx* lhs, const ChildCtx* rhs) const {
+    if (lhs->current_row() == nullptr) {
+        return false;
+    }
+    return _is_before(*lhs->current_row(), lhs, rhs);
+}
+
+bool CollectIterator::_is_before(const RowCursor& lhs_row,
+                                 const ChildCtx* lhs, const ChildCtx* rhs) const {
+    const RowCursor* rhs_row = rhs->current_row();
+    if (rhs_row == nullptr) {
+        return true;
+    }
+    int cmp_res = compare_row(lhs_row, *rhs_row);
     if (cmp_res != 0) {
-        return cmp_res > 0;
+        return cmp_res < 0;
     }
     // if row cursors equal, compare data version.
-    return a->version() > b->version();
+    return lhs->version() < rhs->version();
 }
 
-void CollectIterator::clear() {
-    while (_heap.size() > 0) {
-        _heap.pop();
+void CollectIterator::_adjust_tree(int idx) {
+    int winner = idx;
+    for (size_t node = (idx + _children.size()) / 2; node > 0; node /= 2) {
+        if (_tree[node] == -1) {
+            // only happens when building tree, the other subtree of this
+            // node has not been played yet
+            _tree[node] = winner;
+            return;
+        }
+        if (_is_before(_children[_tree[node]], _children[winner])) {
+            std::swap(_tree[node], winner);
+        }
+    }
+    _tree[0] = winner;
+}
+
+void CollectIterator::_rebuild_tree() {
+    _tree.assign(_children.size(), -1);
+    for (int i = _children.size() - 1; i >= 0; --i) {
+        _adjust_tree(i);
+    }
+    _last_winner = -1;
+    _run_block_seq = 0;
+}
+
+void CollectIterator::_try_start_run() {
+    // losers on the path of winner are best children of other subtrees, so
+    // the best of them is the runner-up of all children
+    int winner = _tree[0];
+    int runner_up = -1;
+    for (size_t node = (winner + _children.size()) / 2; node > 0; node /= 2) {
+        if (runner_up == -1 || _is_before(_children[_tree[node]], _children[runner_up])) {
+            runner_up = _tree[node];
+        }
+    }
+    if (runner_up == -1) {
+        // the only child
+        _run_block_seq = _cur_child->block_seq();
+        return;
+    }
+    if (_is_before(*_cur_child->block_last_row(), _cur_child, _children[runner_up])) {
+        _run_block_seq = _cur_child->block_seq();
     }
+}
+
+void CollectIterator::clear() {
+    _tree.clear();
+    _last_winner = -1;
+    _run_block_seq = 0;
     for (auto child : _children) {
         delete child;
     }
@@ -289,6 +394,7 @@ Reader::Reader()
         _merged_rows(0) {
     _tracker.reset(new MemTracker(-1));
     _predicate_mem_pool.reset(new MemPool(_tracker.get()));
+    _agg_arena.reset(new Arena());
 }
 
 Reader::~Reader() {
@@ -318,7 +424,7 @@ OLAPStatus Reader::init(const ReaderParams& read_params) {
         return res;
     }
 
-    switch (_tablet->keys_type()) {
+    switch (_skip_merge ? KeysType::DUP_KEYS : _tablet->keys_type()) {
     case KeysType::DUP_KEYS:
         _next_row_func = &Reader::_dup_key_next_row;
         break;
@@ -357,6 +463,9 @@ OLAPStatus Reader::_agg_key_next_row(RowCursor* row_cursor, bool* eof) {
         *eof = true;
         return OLAP_SUCCESS;
     }
+    if (UNLIKELY(_agg_arena->MemoryUsage() > OLAP_MAX_AGG_ARENA_BYTES)) {
+        _agg_arena.reset(new Arena());
+    }
     init_row_with_others(row_cursor, *_next_key);
     int64_t merged_count = 0;
     do {
@@ -381,7 +490,7 @@ OLAPStatus Reader::_agg_key_next_row(RowCursor* row_cursor, bool* eof) {
         ++merged_count;
     } while (true);
     _merged_rows += merged_count;
-    agg_finalize_row(_value_cids, row_cursor);
+    agg_finalize_row(_value_cids, row_cursor, _agg_arena.get());
     return OLAP_SUCCESS;
 }
 
@@ -411,12 +520,12 @@ OLAPStatus Reader::_unique_key_next_row(RowCursor* row_cursor, bool* eof) {
             //   1. DUP_KEYS keys type has no semantic to aggregate,
             //   2. to make cost of  each scan round reasonable, we will control merged_count.
             if (_aggregation && merged_count > config::doris_scanner_row_num) {
-                agg_finalize_row(_value_cids, row_cursor);
+                agg_finalize_row(_value_cids, row_cursor, _agg_arena.get());
                 break;
             }
             // break while can NOT doing aggregation
             if (!equal_row(_key_cids, *row_cursor, *_next_key)) {
-                agg_finalize_row(_value_cids, row_cursor);
+                agg_finalize_row(_value_cids, row_cursor, _agg_arena.get());
                 break;
             }
 
@@ -445,6 +554,11 @@ void Reader::close() {
     for (auto pred : _col_predicates) {
         delete pred;
     }
+    for (auto& del_preds : _delete_predicates) {
+        for (auto pred : del_preds.predicates) {
+            delete pred;
+        }
+    }
 
     delete _collect_iter;
 }
@@ -514,9 +628,20 @@ OLAPStatus Reader::_capture_rs_readers(const ReaderParams& read_params) {
 
     if (eof) { return OLAP_SUCCESS; }
 
+    std::vector<RowsetReaderSharedPtr> matched_rs_readers;
+    if (read_params.reader_type == READER_QUERY) {
+        for (auto& rs_reader : *rs_readers) {
+            if (_rowset_may_match(rs_reader->rowset())) {
+                matched_rs_readers.push_back(rs_reader);
+            }
+        }
+        rs_readers = &matched_rs_readers;
+    }
+
     _reader_context.reader_type = read_params.reader_type;
     _reader_context.tablet_schema = &_tablet->tablet_schema();
     _reader_context.preaggregation = _aggregation;
+    _reader_context.need_ordered_result = _need_ordered_result;
     _reader_context.return_columns = &_return_columns;
     _reader_context.seek_columns = &_seek_columns;
     _reader_context.load_bf_columns = &_load_bf_columns;
@@ -527,10 +652,33 @@ OLAPStatus Reader::_capture_rs_readers(const ReaderParams& read_params) {
     _reader_context.upper_bound_keys = &_keys_param.end_keys;
     _reader_context.is_upper_keys_included = &_is_upper_keys_included;
     _reader_context.delete_handler = &_delete_handler;
+    _reader_context.delete_predicates = _delete_predicates.empty() ? nullptr : &_delete_predicates;
+    if (_use_delete_bitmaps) {
+        _reader_context.delete_bitmaps = &_delete_bitmaps;
+        _reader_context.delete_bitmap_version = _version.second;
+    }
     _reader_context.stats = &_stats;
     _reader_context.is_using_cache = is_using_cache;
     _reader_context.lru_cache = StorageEngine::instance()->index_stream_lru_cache();
     _reader_context.runtime_state = read_params.runtime_state;
+    if (_is_unique_key_point_lookup(read_params)) {
+        // rowsets are from old to new, read them from the newest one until the key is found
+        for (auto it = rs_readers->rbegin(); it != rs_readers->rend(); ++it) {
+            (*it)->init(&_reader_context);
+            _rs_readers.push_back(*it);
+            OLAPStatus res = _collect_iter->add_child(*it);
+            if (res != OLAP_SUCCESS && res != OLAP_ERR_DATA_EOF) {
+                LOG(WARNING) << "failed to add child to iterator";
+                return res;
+            }
+            if (_collect_iter->current_row(&_next_delete_flag) != nullptr) {
+                break;
+            }
+        }
+        _next_key = _collect_iter->current_row(&_next_delete_flag);
+        return OLAP_SUCCESS;
+    }
+
     for (auto& rs_reader : *rs_readers) {
         rs_reader->init(&_reader_context);
         _rs_readers.push_back(rs_reader);
@@ -548,10 +696,78 @@ OLAPStatus Reader::_capture_rs_readers(const ReaderParams& read_params) {
     return OLAP_SUCCESS;
 }
 
+bool Reader::_rowset_may_match(const RowsetSharedPtr& rowset) const {
+    if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+        return true;
+    }
+    std::vector<ZoneMap> zone_maps;
+    rowset->rowset_meta()->zone_maps(&zone_maps);
+    const TabletSchema& schema = _tablet->tablet_schema();
+    if (zone_maps.size() != schema.num_columns()) {
+        return true;
+    }
+
+    for (auto& it : _conditions.columns()) {
+        const TabletColumn& column = schema.column(it.first);
+        // rows of value columns may be replaced or aggregated by rows in other rowsets
+        if (!column.is_key() && _tablet->keys_type() != DUP_KEYS) {
+            continue;
+        }
+        if (column.type() == OLAP_FIELD_TYPE_HLL) {
+            continue;
+        }
+        const ZoneMap& zone_map = zone_maps[it.first];
+        segment_v2::ZoneMapPB zone_map_pb;
+        zone_map_pb.set_min(zone_map.min());
+        zone_map_pb.set_max(zone_map.max());
+        zone_map_pb.set_null_flag(zone_map.null_flag());
+        zone_map_pb.set_has_not_null(zone_map.has_not_null());
+        std::unique_ptr<WrapperField> min_value(WrapperField::create(column));
+        std::unique_ptr<WrapperField> max_value(WrapperField::create(column));
+        if (!segment_v2::ColumnZoneMap::match_condition(zone_map_pb, it.second,
+                                                        min_value.get(), max_value.get())) {
+            return false;
+        }
+    }
+
+    // key ranges are ordered by all key columns, only the first key column
+    // bounds them by itself
+    if (_keys_param.start_keys.empty()
+            || _keys_param.end_keys.size() != _keys_param.start_keys.size()) {
+        return true;
+    }
+    const TabletColumn& first_key = schema.column(0);
+    const ZoneMap& zone_map = zone_maps[0];
+    std::unique_ptr<WrapperField> min_value(WrapperField::create(first_key));
+    std::unique_ptr<WrapperField> max_value(WrapperField::create(first_key));
+    // null is less than all other values
+    if (zone_map.null_flag()) {
+        min_value->set_null();
+    } else if (!segment_v2::ColumnZoneMap::set_field_value(zone_map.min(), min_value.get())) {
+        return true;
+    }
+    if (!zone_map.has_not_null()) {
+        max_value->set_null();
+    } else if (!segment_v2::ColumnZoneMap::set_field_value(zone_map.max(), max_value.get())) {
+        return true;
+    }
+    for (int i = 0; i < _keys_param.start_keys.size(); ++i) {
+        const RowCursor* start_key = _keys_param.start_keys[i];
+        const RowCursor* end_key = _keys_param.end_keys[i];
+        const Field* field = start_key->column_schema(0);
+        if (field->compare_cell(start_key->cell(0), *max_value) <= 0
+                && (end_key == nullptr || field->compare_cell(end_key->cell(0), *min_value) >= 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 OLAPStatus Reader::_init_params(const ReaderParams& read_params) {
     read_params.check_validation();
     OLAPStatus res = OLAP_SUCCESS;
     _aggregation = read_params.aggregation;
+    _need_ordered_result = read_params.need_ordered_result;
     _reader_type = read_params.reader_type;
     _tablet = read_params.tablet;
     _version = read_params.version;
@@ -592,12 +808,86 @@ OLAPStatus Reader::_init_params(const ReaderParams& read_params) {
         return res;
     }
 
+    _init_delete_predicates();
+
+    _use_delete_bitmaps = _capture_delete_bitmaps(read_params);
+    _skip_merge = _use_delete_bitmaps || _is_rowsets_non_overlapping(read_params);
+
     _collect_iter = new CollectIterator();
     _collect_iter->init(this);
 
     return res;
 }
 
+bool Reader::_is_rowsets_non_overlapping(const ReaderParams& read_params) {
+    if (read_params.reader_type != READER_QUERY
+            || _tablet->keys_type() == KeysType::DUP_KEYS
+            || read_params.rs_readers.size() < 1) {
+        return false;
+    }
+    std::vector<RowsetSharedPtr> rowsets;
+    for (auto& rs_reader : read_params.rs_readers) {
+        // rows with delete flag should replace the same keys in other rowsets
+        if (rs_reader->rowset()->rowset_meta()->delete_flag()) {
+            return false;
+        }
+        rowsets.push_back(rs_reader->rowset());
+    }
+    return AlphaRowset::is_rowsets_non_overlapping(
+            rowsets, _tablet->tablet_schema().num_key_columns());
+}
+
+bool Reader::_capture_delete_bitmaps(const ReaderParams& read_params) {
+    if (read_params.reader_type != READER_QUERY
+            || _tablet->keys_type() != KeysType::UNIQUE_KEYS
+            || _need_ordered_result
+            || read_params.rs_readers.empty()) {
+        return false;
+    }
+    std::shared_ptr<PrimaryKeyIndex> index = _tablet->primary_key_index();
+    if (index == nullptr || _version.second > index->max_version()) {
+        return false;
+    }
+    std::vector<RowsetSharedPtr> rowsets;
+    for (auto& rs_reader : read_params.rs_readers) {
+        if (rs_reader->rowset()->rowset_meta()->delete_flag()) {
+            return false;
+        }
+        rowsets.push_back(rs_reader->rowset());
+    }
+    return index->capture_delete_bitmaps(rowsets, &_delete_bitmaps);
+}
+
+bool Reader::_is_unique_key_point_lookup(const ReaderParams& read_params) {
+    if (read_params.reader_type != READER_QUERY
+            || _tablet->keys_type() != KeysType::UNIQUE_KEYS
+            || _keys_param.start_keys.size() != 1
+            || _keys_param.end_keys.size() != 1
+            || _keys_param.range != "ge" || _keys_param.end_range != "le") {
+        return false;
+    }
+    const RowCursor* start_key = _keys_param.start_keys[0];
+    if (start_key->field_count() != _tablet->num_key_columns()
+            || start_key->cmp(*_keys_param.end_keys[0]) != 0) {
+        return false;
+    }
+    // older versions of the row are needed for values left null in newer ones
+    for (size_t i = 0; i < _tablet->num_columns(); ++i) {
+        if (_tablet->tablet_schema().column(i).aggregation()
+                == OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL) {
+            return false;
+        }
+    }
+    // an older version of the row may be returned if the newest one is filtered by values
+    for (auto& condition : read_params.conditions) {
+        int32_t index = _tablet->field_index(condition.column_name);
+        if (index < 0 || !_tablet->tablet_schema().column(index).is_key()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 OLAPStatus Reader::_init_return_columns(const ReaderParams& read_params) {
     if (read_params.reader_type == READER_QUERY) {
         _return_columns = read_params.return_columns;
@@ -630,6 +920,28 @@ OLAPStatus Reader::_init_return_columns(const ReaderParams& read_params) {
             }
         }
         VLOG(3) << "return column is empty, using full column as defaut.";
+    } else if (read_params.reader_type == READER_BASE_COMPACTION
+               || read_params.reader_type == READER_CUMULATIVE_COMPACTION) {
+        // vertical compaction reads key columns with a group of value columns,
+        // rows should be filtered by delete conditions in the same way as the
+        // key group, so columns of delete conditions are read as well.
+        _return_columns = read_params.return_columns;
+        set<uint32_t> column_set(_return_columns.begin(), _return_columns.end());
+        for (auto conds : _delete_handler.get_delete_conditions()) {
+            for (auto cond_column : conds.del_cond->columns()) {
+                if (column_set.find(cond_column.first) == column_set.end()) {
+                    column_set.insert(cond_column.first);
+                    _return_columns.push_back(cond_column.first);
+                }
+            }
+        }
+        for (auto id : read_params.return_columns) {
+            if (_tablet->tablet_schema().column(id).is_key()) {
+                _key_cids.push_back(id);
+            } else {
+                _value_cids.push_back(id);
+            }
+        }
     } else if (read_params.reader_type == READER_CHECKSUM) {
         _return_columns = read_params.return_columns;
         for (auto id : read_params.return_columns) {
@@ -1069,4 +1381,57 @@ OLAPStatus Reader::_init_delete_condition(const ReaderParams& read_params) {
     }
 }
 
+void Reader::_init_delete_predicates() {
+    if (!config::enable_vectorized_delete_predicates || _delete_handler.empty()) {
+        return;
+    }
+    std::set<uint32_t> seek_columns(_seek_columns.begin(), _seek_columns.end());
+    bool compiled = true;
+    for (auto& del_conds : _delete_handler.get_delete_conditions()) {
+        DeletePredicates del_preds;
+        del_preds.filter_version = del_conds.filter_version;
+        for (auto& sub_cond : del_conds.sub_conditions) {
+            int index = _tablet->field_index(sub_cond.column_name);
+            // DeleteHandler only evaluates conditions on key columns, which are
+            // not aggregated, and "!=" can't be compiled
+            if (index < 0 || !_tablet->tablet_schema().column(index).is_key()
+                    || seek_columns.count(index) == 0) {
+                compiled = false;
+                break;
+            }
+            // operators of delete conditions are spelled differently
+            TCondition condition = sub_cond;
+            if (condition.condition_op == "=") {
+                condition.condition_op = "*=";
+            } else if (strcasecmp(condition.condition_op.c_str(), "is") == 0) {
+                condition.condition_op = "is";
+                std::transform(condition.condition_values[0].begin(),
+                               condition.condition_values[0].end(),
+                               condition.condition_values[0].begin(), ::tolower);
+            }
+            ColumnPredicate* predicate = _parse_to_predicate(condition);
+            if (predicate == nullptr) {
+                compiled = false;
+                break;
+            }
+            del_preds.predicates.push_back(predicate);
+            del_preds.column_ids.push_back(index);
+        }
+        if (!del_preds.predicates.empty()) {
+            _delete_predicates.push_back(std::move(del_preds));
+        }
+        if (!compiled) {
+            break;
+        }
+    }
+    if (!compiled) {
+        for (auto& del_preds : _delete_predicates) {
+            for (auto pred : del_preds.predicates) {
+                delete pred;
+            }
+        }
+        _delete_predicates.clear();
+    }
+}
+
 }  // namespace doris
@@ -33,6 +33,7 @@
 #include "olap/olap_cond.h"
 #include "olap/olap_define.h"
 #include "olap/row_cursor.h"
+#include "util/arena.h"
 #include "util/runtime_profile.h"
 
 #include "olap/column_predicate.h"
@@ -63,6 +64,9 @@ struct ReaderParams {
     // The ColumnData will be set when using Merger, eg Cumulative, BE.
     std::vector<RowsetReaderSharedPtr> rs_readers;
     std::vector<uint32_t> return_columns;
+    // rows are returned in order of keys even for DUP_KEYS tablets, which is
+    // needed when the first rows by keys are wanted
+    bool need_ordered_result;
     RuntimeProfile* profile;
     RuntimeState* runtime_state;
 
@@ -70,6 +74,7 @@ struct ReaderParams {
             reader_type(READER_QUERY),
             aggregation(false),
             version(-1, 0),
+            need_ordered_result(false),
             profile(NULL),
             runtime_state(NULL) {
         start_key.clear();
@@ -90,6 +95,7 @@ struct ReaderParams {
         ss << "tablet=" << tablet->full_name()
            << " reader_type=" << reader_type
            << " aggregation=" << aggregation
+           << " need_ordered_result=" << need_ordered_result
            << " version=" << version.first << "-" << version.second
            << " range=" << range
            << " end_range=" << end_range;
@@ -191,11 +197,35 @@ private:
 
     OLAPStatus _init_delete_condition(const ReaderParams& read_params);
 
+    // Compile delete conditions into _delete_predicates. Nothing is compiled if
+    // any of them can't be, then all of them are evaluated row by row.
+    void _init_delete_predicates();
+
     OLAPStatus _init_return_columns(const ReaderParams& read_params);
     OLAPStatus _init_seek_columns();
 
     OLAPStatus _init_load_bf_columns(const ReaderParams& read_params);
 
+    // Return true if rows of different rowsets never have the same key, so
+    // that a query can read rowsets one after another without merging and
+    // aggregating rows among them.
+    bool _is_rowsets_non_overlapping(const ReaderParams& read_params);
+
+    // Return true if delete bitmaps of all rowsets to read are captured from
+    // the primary key index of a merge-on-write tablet, so that superseded
+    // rows are skipped and rowsets are read without merging.
+    bool _capture_delete_bitmaps(const ReaderParams& read_params);
+
+    // Return true if a query reads the row of one full key of a UNIQUE_KEYS
+    // tablet without conditions on value columns, so that the newest rowset
+    // having the key decides the result and older rowsets need not be read.
+    bool _is_unique_key_point_lookup(const ReaderParams& read_params);
+
+    // Return false if the zone maps in meta of a beta rowset show that none of
+    // its rows can match the conditions or key ranges, so that the rowset need
+    // not be read at all.
+    bool _rowset_may_match(const RowsetSharedPtr& rowset) const;
+
     OLAPStatus _dup_key_next_row(RowCursor* row_cursor, bool* eof);
     OLAPStatus _agg_key_next_row(RowCursor* row_cursor, bool* eof);
     OLAPStatus _unique_key_next_row(RowCursor* row_cursor, bool* eof);
@@ -228,10 +258,17 @@ private:
     std::vector<ColumnPredicate*> _col_predicates;
 
     DeleteHandler _delete_handler;
+    std::vector<DeletePredicates> _delete_predicates;
+    // delete bitmaps of rowsets to read of a merge-on-write tablet
+    DeleteBitmapSnapshot _delete_bitmaps;
+    bool _use_delete_bitmaps = false;
 
     OLAPStatus (Reader::*_next_row_func)(RowCursor* row_cursor, bool* eof) = nullptr;
 
     bool _aggregation;
+    bool _need_ordered_result = false;
+    // true if rowsets are read one after another without merging
+    bool _skip_merge = false;
     bool _version_locked;
     ReaderType _reader_type;
     bool _next_delete_flag;
@@ -242,6 +279,11 @@ private:
 
     uint64_t _merged_rows;
 
+    // Memory of values which are finalized into new buffers (BITMAP_UNION). A returned
+    // row is consumed before the next one is read, so it is dropped once it grows
+    // beyond OLAP_MAX_AGG_ARENA_BYTES.
+    std::unique_ptr<Arena> _agg_arena;
+
     OlapReaderStatistics _stats;
     DISALLOW_COPY_AND_ASSIGN(Reader);
 
@@ -139,10 +139,10 @@ void agg_finalize_row(RowType* row, Arena* arena) {
 }
 
 template<typename RowType>
-void agg_finalize_row(const std::vector<uint32_t>& ids, RowType* row) {
+void agg_finalize_row(const std::vector<uint32_t>& ids, RowType* row, Arena* arena) {
     for (uint32_t id : ids) {
         auto cell = row->cell(id);
-        row->schema()->column(id)->agg_finalize(&cell);
+        row->schema()->column(id)->agg_finalize(&cell, arena);
     }
 }
 
@@ -19,6 +19,7 @@
 #include "olap/rowset/alpha_rowset_meta.h"
 #include "olap/rowset/rowset_meta_manager.h"
 #include "olap/row.h"
+#include "olap/wrapper_field.h"
 #include "util/hash_util.hpp"
 
 namespace doris {
@@ -397,4 +398,50 @@ OLAPStatus AlphaRowset::reset_sizeinfo() {
     return OLAP_SUCCESS;
 }
 
+// Return true if all rows of lhs are less than rows of rhs, which are given
+// by min/max values of key columns. If max of lhs equals to min of rhs in a
+// column, rows can only be ordered when both sides are constant in it, then
+// next column decides the order.
+static bool is_key_range_before(const std::vector<KeyRange>& lhs, const std::vector<KeyRange>& rhs) {
+    for (size_t i = 0; i < lhs.size() && i < rhs.size(); ++i) {
+        int cmp = lhs[i].second->cmp(rhs[i].first);
+        if (cmp < 0) {
+            return true;
+        } else if (cmp > 0) {
+            return false;
+        }
+        if (lhs[i].first->cmp(lhs[i].second) != 0 || rhs[i].first->cmp(rhs[i].second) != 0) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool AlphaRowset::is_rowsets_non_overlapping(const std::vector<RowsetSharedPtr>& rowsets,
+                                             size_t num_key_columns) {
+    const std::vector<KeyRange>* prev_zone_maps = nullptr;
+    for (auto& rowset : rowsets) {
+        if (rowset->rowset_meta()->rowset_type() != ALPHA_ROWSET) {
+            return false;
+        }
+        auto alpha_rowset = std::dynamic_pointer_cast<AlphaRowset>(rowset);
+        // segment groups of a rowset may overlap with each other too, so all
+        // of them should be in order
+        for (auto& segment_group : alpha_rowset->segment_groups()) {
+            if (segment_group->empty()) {
+                continue;
+            }
+            const std::vector<KeyRange>& zone_maps = segment_group->get_zone_maps();
+            if (zone_maps.size() != num_key_columns) {
+                return false;
+            }
+            if (prev_zone_maps != nullptr && !is_key_range_before(*prev_zone_maps, zone_maps)) {
+                return false;
+            }
+            prev_zone_maps = &zone_maps;
+        }
+    }
+    return true;
+}
+
 }  // namespace doris
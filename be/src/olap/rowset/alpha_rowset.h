@@ -79,6 +79,17 @@ public:
     // info by using segment's info
     OLAPStatus reset_sizeinfo();
 
+    const std::vector<std::shared_ptr<SegmentGroup>>& segment_groups() const {
+        return _segment_groups;
+    }
+
+    // Return true if key ranges of all segment groups of rowsets are ordered
+    // and don't overlap with each other, from the first rowset to the last
+    // one, which are decided by zone maps of key columns. Return false if
+    // any of rowsets is not an alpha rowset.
+    static bool is_rowsets_non_overlapping(const std::vector<RowsetSharedPtr>& rowsets,
+                                           size_t num_key_columns);
+
 protected:
     // add custom logic when rowset is published
     void make_visible_extra(Version version, VersionHash version_hash) override;
@@ -57,13 +57,17 @@ OLAPStatus AlphaRowsetReader::init(RowsetReaderContext* read_context) {
      *      there is not necessary to merge row in advance.
      *   2. QEURY task for DUP_KEYS tablet has no necessities
      *      to merge row in advance.
-     *   2. COMPACTION/CHECKSUM/ALTER_TABLET task should merge
-     *      row in advance.
+     *   3. COMPACTION/CHECKSUM/ALTER_TABLET task should merge
+     *      row in advance, so does QUERY task which needs ordered result.
      * For cumulative rowset, there are no necessities to merge row in advance.
      */
     RETURN_NOT_OK(_init_merge_ctxs(read_context));
     if (_is_singleton_rowset && _merge_ctxs.size() > 1) {
-        if (_current_read_context->reader_type == READER_QUERY
+        if (_current_read_context->need_ordered_result) {
+            // 3. QUERY task which needs rows in order of keys
+            _next_block = &AlphaRowsetReader::_merge_block;
+            merge = true;
+        } else if (_current_read_context->reader_type == READER_QUERY
                 && _current_read_context->preaggregation) {
             // 1. QUERY task which set pregaggregation to be true
             _next_block = &AlphaRowsetReader::_union_block;
@@ -71,6 +75,11 @@ OLAPStatus AlphaRowsetReader::init(RowsetReaderContext* read_context) {
                     && _current_read_context->tablet_schema->keys_type() == DUP_KEYS) {
             // 2. QUERY task for DUP_KEYS tablet
             _next_block = &AlphaRowsetReader::_union_block;
+        } else if (_current_read_context->reader_type == READER_QUERY
+                    && _current_read_context->delete_bitmaps != nullptr) {
+            // 2. QUERY task for merge-on-write tablet, superseded rows are
+            // skipped by ColumnData
+            _next_block = &AlphaRowsetReader::_union_block;
         } else {
             // 3. COMPACTION/CHECKSUM/ALTER_TABLET task
             _next_block = &AlphaRowsetReader::_merge_block;
@@ -296,6 +305,9 @@ OLAPStatus AlphaRowsetReader::_init_merge_ctxs(RowsetReaderContext* read_context
             return OLAP_ERR_READER_READING_ERROR;
         }
         new_column_data->set_delete_handler(read_context->delete_handler);
+        new_column_data->set_delete_predicates(read_context->delete_predicates);
+        new_column_data->set_delete_bitmaps(read_context->delete_bitmaps,
+                                            read_context->delete_bitmap_version);
         new_column_data->set_stats(_stats);
         new_column_data->set_lru_cache(read_context->lru_cache);
         if (read_context->reader_type == READER_ALTER_TABLE) {
@@ -342,7 +354,11 @@ OLAPStatus AlphaRowsetReader::_init_merge_ctxs(RowsetReaderContext* read_context
         _merge_ctxs.emplace_back(std::move(merge_ctx));
     }
 
-    if (!_is_singleton_rowset && _merge_ctxs.size() > 1) {
+    // a cumulative rowset made by linking ordered rowsets has many segment
+    // groups, which are read one by one as their keys don't overlap
+    if (!_is_singleton_rowset && _merge_ctxs.size() > 1
+            && !AlphaRowset::is_rowsets_non_overlapping(
+                    {_rowset}, read_context->tablet_schema->num_key_columns())) {
         LOG(WARNING) << "invalid column_datas for cumulative rowset. column_datas size:"
                      << _merge_ctxs.size();
         return OLAP_ERR_READER_READING_ERROR;
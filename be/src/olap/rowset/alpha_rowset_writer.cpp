@@ -262,9 +262,12 @@ OLAPStatus AlphaRowsetWriter::_init() {
     //_cur_segment_group->set_load_id(_rowset_writer_context.load_id);
     _segment_groups.push_back(_cur_segment_group);
 
+    IOScheduler* io_scheduler = _rowset_writer_context.data_dir != nullptr
+            ? _rowset_writer_context.data_dir->io_scheduler() : nullptr;
     _column_data_writer = ColumnDataWriter::create(_cur_segment_group, true,
                                                    _rowset_writer_context.tablet_schema->compress_kind(),
-                                                   _rowset_writer_context.tablet_schema->bloom_filter_fpp());
+                                                   _rowset_writer_context.tablet_schema->bloom_filter_fpp(),
+                                                   io_scheduler, _rowset_writer_context.io_class);
     DCHECK(_column_data_writer != nullptr) << "memory error occurs when creating writer";
     OLAPStatus res = _column_data_writer->init();
     if (res != OLAP_SUCCESS) {
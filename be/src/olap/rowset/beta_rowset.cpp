@@ -21,6 +21,7 @@
 #include <stdio.h>  // for remove()
 #include <unistd.h> // for link()
 #include "gutil/strings/substitute.h"
+#include "olap/segment_cache.h"
 #include "olap/utils.h"
 
 namespace doris {
@@ -55,11 +56,38 @@ std::shared_ptr<RowsetReader> BetaRowset::create_reader() {
     return nullptr;
 }
 
+OLAPStatus BetaRowset::load_segments(std::vector<segment_v2::SegmentSharedPtr>* segments) {
+    // copied only when some segment is not cached, so that segments never refer
+    // to a schema which may be released with its tablet
+    std::shared_ptr<TabletSchema> schema;
+    for (int i = 0; i < num_segments(); ++i) {
+        SegmentCache::CacheKey key(rowset_id(), i);
+        auto segment = SegmentCache::instance()->lookup(key);
+        if (segment == nullptr) {
+            if (schema == nullptr) {
+                schema = std::make_shared<TabletSchema>(*_schema);
+            }
+            std::string path = segment_file_path(_rowset_path, rowset_id(), i);
+            segment = std::make_shared<segment_v2::Segment>(
+                path, i, schema, _schema->num_rows_per_row_block());
+            auto s = segment->open();
+            if (!s.ok()) {
+                LOG(WARNING) << "failed to open segment " << path << ": " << s.to_string();
+                return OLAP_ERR_ROWSET_LOAD_FAILED;
+            }
+            SegmentCache::instance()->insert(key, segment, segment->mem_usage());
+        }
+        segments->push_back(std::move(segment));
+    }
+    return OLAP_SUCCESS;
+}
+
 OLAPStatus BetaRowset::remove() {
-    // TODO should we close and remove all segment reader first?
+    // segments being read are kept alive by their readers, only cached ones are dropped
     LOG(INFO) << "begin to remove files in rowset " << unique_id();
     bool success = true;
     for (int i = 0; i < num_segments(); ++i) {
+        SegmentCache::instance()->erase(SegmentCache::CacheKey(rowset_id(), i));
         std::string path = segment_file_path(_rowset_path, rowset_id(), i);
         LOG(INFO) << "deleting " << path;
         if (::remove(path.c_str()) != 0) {
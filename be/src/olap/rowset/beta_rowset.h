@@ -23,6 +23,7 @@
 #include "olap/rowset/rowset.h"
 #include "olap/rowset/rowset_meta.h"
 #include "olap/data_dir.h"
+#include "olap/rowset/segment_v2/segment.h"
 
 namespace doris {
 
@@ -59,8 +60,9 @@ public:
 
     bool check_path(const std::string& path) override;
 
-private:
-    // TODO segment readers member
+    // Get opened segments of this rowset. Segments are shared through the
+    // BE-wide SegmentCache, only those not cached are opened from files.
+    OLAPStatus load_segments(std::vector<segment_v2::SegmentSharedPtr>* segments);
 };
 
 } // namespace doris
@@ -17,6 +17,7 @@
 
 #include "olap/rowset/beta_rowset_writer.h"
 
+#include <algorithm>
 #include <cmath> // lround
 #include <cstdio> // remove
 #include <cstring> // strerror_r
@@ -26,12 +27,38 @@
 #include "common/logging.h"
 #include "olap/rowset/beta_rowset.h"
 #include <olap/rowset/segment_v2/segment_writer.h>
+#include "olap/data_dir.h"
 #include "olap/olap_define.h"
 #include "olap/row.h" // ContiguousRow
 #include "olap/row_cursor.h" // RowCursor
+#include "olap/row_block2.h" // RowBlockV2
+#include "olap/types.h" // TypeInfo
 
 namespace doris {
 
+static bool is_slice_type(FieldType type) {
+    return type == OLAP_FIELD_TYPE_VARCHAR
+        || type == OLAP_FIELD_TYPE_CHAR
+        || type == OLAP_FIELD_TYPE_HLL;
+}
+
+// Compare two values of zone map, which are in the memory format of cell
+static int compare_zone_map_value(const TypeInfo* type_info,
+                                  const std::string& left, const std::string& right) {
+    if (is_slice_type(type_info->type())) {
+        Slice left_slice(left);
+        Slice right_slice(right);
+        return type_info->cmp(&left_slice, &right_slice);
+    }
+    // copy to aligned buffers, the widest cell is 16 bytes
+    DCHECK(left.size() == type_info->size() && right.size() == type_info->size());
+    alignas(16) char left_buf[16];
+    alignas(16) char right_buf[16];
+    memcpy(left_buf, left.data(), std::min(left.size(), sizeof(left_buf)));
+    memcpy(right_buf, right.data(), std::min(right.size(), sizeof(right_buf)));
+    return type_info->cmp(left_buf, right_buf);
+}
+
 BetaRowsetWriter::BetaRowsetWriter()
     : _rowset_meta(nullptr),
       _num_segment(0),
@@ -84,7 +111,6 @@ OLAPStatus BetaRowsetWriter::_add_row(const RowType& row) {
     if (PREDICT_FALSE(_segment_writer == nullptr)) {
         RETURN_NOT_OK(_create_segment_writer());
     }
-    // TODO update rowset's zonemap
     auto s = _segment_writer->append_row(row);
     if (PREDICT_FALSE(!s.ok())) {
         LOG(WARNING) << "failed to append row: " << s.to_string();
@@ -97,6 +123,38 @@ OLAPStatus BetaRowsetWriter::_add_row(const RowType& row) {
     return OLAP_SUCCESS;
 }
 
+OLAPStatus BetaRowsetWriter::add_block(const RowBlockV2& block) {
+    if (PREDICT_FALSE(_segment_writer == nullptr)) {
+        RETURN_NOT_OK(_create_segment_writer());
+    }
+    auto s = _segment_writer->append_block(block);
+    if (PREDICT_FALSE(!s.ok())) {
+        LOG(WARNING) << "failed to append block: " << s.to_string();
+        return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+    }
+    if (PREDICT_FALSE(_segment_writer->estimate_segment_size() >= _max_segment_size)) {
+        RETURN_NOT_OK(_flush_segment_writer());
+    }
+    _num_rows_written += block.num_rows();
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowsetWriter::add_columns(const RowCursor& row,
+                                         const std::vector<uint32_t>& column_ids) {
+    if (PREDICT_FALSE(_segment_writer == nullptr)) {
+        RETURN_NOT_OK(_create_segment_writer());
+    }
+    auto s = _segment_writer->append_columns(row, column_ids);
+    if (PREDICT_FALSE(!s.ok())) {
+        LOG(WARNING) << "failed to append columns: " << s.to_string();
+        return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+    }
+    if (_context.tablet_schema->column(column_ids[0]).is_key()) {
+        _num_rows_written++;
+    }
+    return OLAP_SUCCESS;
+}
+
 template OLAPStatus BetaRowsetWriter::_add_row(const RowCursor& row);
 template OLAPStatus BetaRowsetWriter::_add_row(const ContiguousRow& row);
 
@@ -106,7 +164,17 @@ OLAPStatus BetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
     _num_rows_written += rowset->num_rows();
     _total_data_size += rowset->rowset_meta()->data_disk_size();
     _num_segment += rowset->num_segments();
-    // TODO update zonemap
+    if (rowset->num_rows() > 0) {
+        std::vector<ZoneMap> zone_maps;
+        rowset->rowset_meta()->zone_maps(&zone_maps);
+        if (zone_maps.size() == _context.tablet_schema->num_columns()) {
+            for (uint32_t cid = 0; cid < zone_maps.size(); ++cid) {
+                _merge_zone_map(cid, zone_maps[cid]);
+            }
+        } else {
+            _zone_maps_valid = false;
+        }
+    }
     if (rowset->rowset_meta()->has_delete_predicate()) {
         _rowset_meta->set_delete_predicate(rowset->rowset_meta()->delete_predicate());
     }
@@ -115,7 +183,8 @@ OLAPStatus BetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
 
 OLAPStatus BetaRowsetWriter::add_rowset_for_linked_schema_change(RowsetSharedPtr rowset,
                                                                  const SchemaMapping& schema_mapping) {
-    // TODO use schema_mapping to transfer zonemap
+    // columns of zone maps in rowset meta may not match the new schema
+    _zone_maps_valid = false;
     return add_rowset(rowset);
 }
 
@@ -131,7 +200,9 @@ RowsetSharedPtr BetaRowsetWriter::build() {
     _rowset_meta->set_total_disk_size(_total_data_size);
     _rowset_meta->set_data_disk_size(_total_data_size);
     _rowset_meta->set_index_disk_size(0); // TODO collect index size
-    // TODO write zonemap to meta
+    if (_zone_maps_valid && !_zone_maps.empty()) {
+        _rowset_meta->set_zone_maps(_zone_maps);
+    }
     _rowset_meta->set_empty(_num_rows_written == 0);
     _rowset_meta->set_creation_time(time(nullptr));
     _rowset_meta->set_num_segments(_num_segment);
@@ -154,9 +225,27 @@ RowsetSharedPtr BetaRowsetWriter::build() {
     return rowset;
 }
 
+segment_v2::CompressionTypePB BetaRowsetWriter::_compression_type() const {
+    std::string type_name = config::segment_v2_compression_type;
+    if (!config::segment_v2_hdd_compression_type.empty() && _context.data_dir != nullptr
+            && _context.data_dir->storage_medium() == TStorageMedium::HDD) {
+        type_name = config::segment_v2_hdd_compression_type;
+    }
+    segment_v2::CompressionTypePB type;
+    if (!segment_v2::CompressionTypePB_Parse(type_name, &type)
+            || type == segment_v2::UNKNOWN_COMPRESSION
+            || type == segment_v2::DEFAULT_COMPRESSION) {
+        LOG(WARNING) << "invalid segment_v2 compression type:" << type_name
+                     << ", pages are not compressed";
+        return segment_v2::NO_COMPRESSION;
+    }
+    return type;
+}
+
 OLAPStatus BetaRowsetWriter::_create_segment_writer() {
     auto path = BetaRowset::segment_file_path(_context.rowset_path_prefix, _context.rowset_id, _num_segment);
     segment_v2::SegmentWriterOptions writer_options;
+    writer_options.compression_type = _compression_type();
     _segment_writer.reset(new segment_v2::SegmentWriter(path, _num_segment, _context.tablet_schema, writer_options));
     // TODO set write_mbytes_per_sec based on writer type (load/base compaction/cumulative compaction)
     auto s = _segment_writer->init(config::push_write_mbytes_per_sec);
@@ -177,8 +266,64 @@ OLAPStatus BetaRowsetWriter::_flush_segment_writer() {
     }
     // TODO calc index size also
     _total_data_size += segment_size;
+    const segment_v2::SegmentFooterPB& footer = _segment_writer->footer();
+    if (footer.columns_size() == _context.tablet_schema->num_columns()) {
+        for (uint32_t cid = 0; cid < footer.columns_size(); ++cid) {
+            const segment_v2::ColumnMetaPB& column_meta = footer.columns(cid);
+            ZoneMap zone_map;
+            if (column_meta.has_segment_zone_map()) {
+                const segment_v2::ZoneMapPB& segment_zone_map = column_meta.segment_zone_map();
+                zone_map.set_min(segment_zone_map.min());
+                zone_map.set_max(segment_zone_map.max());
+                zone_map.set_null_flag(segment_zone_map.null_flag());
+                zone_map.set_has_not_null(segment_zone_map.has_not_null());
+            } else {
+                // column without zone map, such as HLL, matches everything
+                zone_map.set_min("");
+                zone_map.set_max("");
+                zone_map.set_null_flag(true);
+                zone_map.set_has_not_null(true);
+            }
+            _merge_zone_map(cid, zone_map);
+        }
+    } else {
+        _zone_maps_valid = false;
+    }
     _segment_writer.reset(nullptr);
     return OLAP_SUCCESS;
 }
 
+void BetaRowsetWriter::_merge_zone_map(uint32_t cid, const ZoneMap& zone_map) {
+    if (_zone_maps.empty()) {
+        _zone_maps.resize(_context.tablet_schema->num_columns());
+    }
+    ZoneMap& merged = _zone_maps[cid];
+    if (!merged.has_has_not_null()) {
+        // first zone map of this column
+        merged = zone_map;
+        return;
+    }
+    merged.set_null_flag(merged.null_flag() || zone_map.null_flag());
+    if (!zone_map.has_not_null()) {
+        return;
+    }
+    if (!merged.has_not_null()) {
+        merged.set_min(zone_map.min());
+        merged.set_max(zone_map.max());
+        merged.set_has_not_null(true);
+        return;
+    }
+    const TabletColumn& column = _context.tablet_schema->column(cid);
+    if (column.type() == OLAP_FIELD_TYPE_HLL) {
+        return;
+    }
+    const TypeInfo* type_info = get_type_info(column.type());
+    if (compare_zone_map_value(type_info, zone_map.min(), merged.min()) < 0) {
+        merged.set_min(zone_map.min());
+    }
+    if (compare_zone_map_value(type_info, zone_map.max(), merged.max()) > 0) {
+        merged.set_max(zone_map.max());
+    }
+}
+
 } // namespace doris
\ No newline at end of file
@@ -18,10 +18,13 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 #define DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 
+#include "gen_cpp/segment_v2.pb.h"
 #include "olap/rowset/rowset_writer.h"
 
 namespace doris {
 
+class RowBlockV2;
+
 namespace segment_v2 {
 class SegmentWriter;
 } // namespace segment_v2
@@ -41,6 +44,15 @@ public:
         return _add_row(row);
     }
 
+    // add all rows of block, which are encoded column by column
+    OLAPStatus add_block(const RowBlockV2& block);
+
+    // add cells of column_ids in row, used by vertical compaction which writes
+    // the rowset by column groups, the group of key columns must be added
+    // first. All groups are written into the current segment, which won't be
+    // rolled over until flush() is called.
+    OLAPStatus add_columns(const RowCursor& row, const std::vector<uint32_t>& column_ids);
+
     // add rowset by create hard link
     OLAPStatus add_rowset(RowsetSharedPtr rowset) override;
 
@@ -63,10 +75,16 @@ private:
     template<typename RowType>
     OLAPStatus _add_row(const RowType& row);
 
+    // compression of segment pages, by config and storage medium of data dir
+    segment_v2::CompressionTypePB _compression_type() const;
+
     OLAPStatus _create_segment_writer();
 
     OLAPStatus _flush_segment_writer();
 
+    // merge zone map of column cid of a segment or rowset into rowset's zone map
+    void _merge_zone_map(uint32_t cid, const ZoneMap& zone_map);
+
 private:
     RowsetWriterContext _context;
     std::shared_ptr<RowsetMeta> _rowset_meta;
@@ -78,7 +96,10 @@ private:
     // counters and statistics maintained during data write
     int64_t _num_rows_written;
     int64_t _total_data_size;
-    // TODO rowset's Zonemap
+    // rowset level zone maps, one for each column in tablet schema, empty if no
+    // data is written. They are dropped if any part of rowset has no zone maps.
+    std::vector<ZoneMap> _zone_maps;
+    bool _zone_maps_valid = true;
 
     bool _is_pending = false;
     bool _rowset_build = false;
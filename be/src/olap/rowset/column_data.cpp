@@ -17,9 +17,12 @@
 
 #include "olap/rowset/column_data.h"
 
+#include <algorithm>
+
 #include "olap/rowset/segment_reader.h"
 #include "olap/olap_cond.h"
 #include "olap/row_block.h"
+#include "util/time.h"
 
 namespace doris {
 
@@ -415,6 +418,10 @@ void ColumnData::set_read_params(
     _conditions = &conditions;
     _col_predicates = &col_predicates;
     _need_eval_predicates = !col_predicates.empty();
+    _predicate_stats.clear();
+    for (auto pred : col_predicates) {
+        _predicate_stats.push_back({pred, 0, 0, 0});
+    }
     _is_using_cache = is_using_cache;
     _runtime_state = runtime_state;
     _return_columns = return_columns;
@@ -654,15 +661,25 @@ OLAPStatus ColumnData::_get_block(bool without_filter, int rows_read) {
         if (res != OLAP_SUCCESS) {
             return res;
         }
+        if (!without_filter && _delete_bitmaps != nullptr && vec_batch->size() > 0) {
+            size_t old_size = vec_batch->size();
+            _filter_deleted_rows(vec_batch);
+            _stats->rows_del_filtered += old_size - vec_batch->size();
+        }
         // evaluate predicates
         if (!without_filter && _need_eval_predicates) {
             SCOPED_RAW_TIMER(&_stats->vec_cond_ns);
             size_t old_size = vec_batch->size();
-            for (auto pred : *_col_predicates) {
-                pred->evaluate(vec_batch);
-            }
+            _evaluate_predicates(vec_batch);
             _stats->rows_vec_cond_filtered += old_size - vec_batch->size();
         }
+        if (!without_filter && _delete_predicates != nullptr && vec_batch->size() > 0
+                && vec_batch->block_status() == DEL_PARTIAL_SATISFIED) {
+            SCOPED_RAW_TIMER(&_stats->vec_cond_ns);
+            size_t old_size = vec_batch->size();
+            _evaluate_delete_predicates(vec_batch);
+            _stats->rows_del_filtered += old_size - vec_batch->size();
+        }
         // if vector is empty after predicate evaluate, get next block
         if (vec_batch->size() == 0) {
             continue;
@@ -676,4 +693,130 @@ OLAPStatus ColumnData::_get_block(bool without_filter, int rows_read) {
     return OLAP_SUCCESS;
 }
 
+// order of predicates is revised after evaluating this number of batches
+static const int64_t PREDICATE_REORDER_BATCHES = 16;
+
+double ColumnData::PredicateStats::rank() const {
+    if (input_rows == 0) {
+        // try predicates never evaluated first to measure them
+        return 0;
+    }
+    double cost_per_row = (double)cost_ns / input_rows;
+    double filtered_ratio = 1 - (double)output_rows / input_rows;
+    return cost_per_row / std::max(filtered_ratio, 1e-6);
+}
+
+void ColumnData::_evaluate_predicates(VectorizedRowBatch* vec_batch) {
+    for (auto& stats : _predicate_stats) {
+        if (vec_batch->size() == 0) {
+            break;
+        }
+        size_t input_rows = vec_batch->size();
+        int64_t start_ns = MonotonicNanos();
+        stats.predicate->evaluate(vec_batch);
+        stats.cost_ns += MonotonicNanos() - start_ns;
+        stats.input_rows += input_rows;
+        stats.output_rows += vec_batch->size();
+    }
+    if (_predicate_stats.size() > 1 && ++_num_eval_batches % PREDICATE_REORDER_BATCHES == 0) {
+        std::stable_sort(_predicate_stats.begin(), _predicate_stats.end(),
+                         [](const PredicateStats& lhs, const PredicateStats& rhs) {
+                             return lhs.rank() < rhs.rank();
+                         });
+        // halve measures so that order follows changes of data
+        for (auto& stats : _predicate_stats) {
+            stats.input_rows /= 2;
+            stats.output_rows /= 2;
+            stats.cost_ns /= 2;
+        }
+    }
+}
+
+void ColumnData::_evaluate_delete_predicates(VectorizedRowBatch* vec_batch) {
+    for (auto& del_preds : *_delete_predicates) {
+        for (uint32_t cid : del_preds.column_ids) {
+            if (vec_batch->column(cid) == nullptr) {
+                // columns of delete conditions are not read, leave them to DeleteHandler
+                return;
+            }
+        }
+    }
+
+    uint16_t* sel = vec_batch->selected();
+    uint16_t num_rows = vec_batch->size();
+    _undeleted_rows.resize(num_rows);
+    if (vec_batch->selected_in_use()) {
+        std::copy(sel, sel + num_rows, _undeleted_rows.begin());
+    } else {
+        for (uint16_t i = 0; i < num_rows; ++i) {
+            _undeleted_rows[i] = i;
+        }
+    }
+
+    int32_t version = _segment_group->version().second;
+    for (auto& del_preds : *_delete_predicates) {
+        if (version > del_preds.filter_version) {
+            continue;
+        }
+        if (_undeleted_rows.empty()) {
+            break;
+        }
+        // evaluate on rows not deleted yet, the rows left satisfy this delete
+        std::copy(_undeleted_rows.begin(), _undeleted_rows.end(), sel);
+        vec_batch->set_size(_undeleted_rows.size());
+        vec_batch->set_selected_in_use(true);
+        for (auto pred : del_preds.predicates) {
+            if (vec_batch->size() == 0) {
+                break;
+            }
+            pred->evaluate(vec_batch);
+        }
+        // both are in ascending order
+        uint16_t num_deleted = vec_batch->size();
+        uint16_t j = 0;
+        size_t new_size = 0;
+        for (size_t i = 0; i < _undeleted_rows.size(); ++i) {
+            if (j < num_deleted && sel[j] == _undeleted_rows[i]) {
+                ++j;
+                continue;
+            }
+            _undeleted_rows[new_size++] = _undeleted_rows[i];
+        }
+        _undeleted_rows.resize(new_size);
+    }
+
+    std::copy(_undeleted_rows.begin(), _undeleted_rows.end(), sel);
+    vec_batch->set_size(_undeleted_rows.size());
+    vec_batch->set_selected_in_use(true);
+    vec_batch->set_block_status(DEL_NOT_SATISFIED);
+}
+
+uint32_t ColumnData::current_block_first_row_id() const {
+    return _current_block * _segment_reader->num_rows_in_block();
+}
+
+void ColumnData::_filter_deleted_rows(VectorizedRowBatch* vec_batch) {
+    auto it = _delete_bitmaps->find(SegmentKey(_segment_group->rowset_id(),
+                                                _segment_group->segment_group_id(),
+                                                _current_segment));
+    if (it == _delete_bitmaps->end()) {
+        return;
+    }
+    const SegmentDeleteBitmap& bitmap = *it->second;
+    uint32_t first_row_id = current_block_first_row_id();
+    uint16_t* sel = vec_batch->selected();
+    uint16_t num_rows = vec_batch->size();
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < num_rows; ++i) {
+        uint16_t row = vec_batch->selected_in_use() ? sel[i] : i;
+        auto deleted = bitmap.find(first_row_id + row);
+        if (deleted != bitmap.end() && deleted->second <= _delete_bitmap_version) {
+            continue;
+        }
+        sel[new_size++] = row;
+    }
+    vec_batch->set_size(new_size);
+    vec_batch->set_selected_in_use(true);
+}
+
 }  // namespace doris
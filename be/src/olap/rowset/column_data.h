@@ -26,6 +26,7 @@
 #include "olap/delete_handler.h"
 #include "olap/olap_common.h"
 #include "olap/olap_cond.h"
+#include "olap/primary_key_index.h"
 #include "olap/rowset/segment_group.h"
 #include "olap/row_block.h"
 #include "olap/row_cursor.h"
@@ -97,6 +98,17 @@ public:
         _delete_handler = delete_handler;
     }
 
+    void set_delete_predicates(const std::vector<DeletePredicates>* delete_predicates) {
+        _delete_predicates = delete_predicates;
+    }
+
+    // rows in 'delete_bitmaps' superseded by versions not greater than
+    // 'version' are skipped
+    void set_delete_bitmaps(const DeleteBitmapSnapshot* delete_bitmaps, int64_t version) {
+        _delete_bitmaps = delete_bitmaps;
+        _delete_bitmap_version = version;
+    }
+
     void set_delete_status(const DelCondSatisfied delete_status) {
         _delete_status = delete_status;
     }
@@ -119,6 +131,12 @@ public:
     int64_t num_rows() const { return _segment_group->num_rows(); }
     Tablet* tablet() const { return _tablet; }
 
+    // segment of the current block
+    uint32_t current_segment() const { return _current_segment; }
+    // row id in the segment of the first row of the current block, it's
+    // valid only if rows of the block are not filtered
+    uint32_t current_block_first_row_id() const;
+
     // To compatable with schmea change read, use this function to init column data
     // for schema change read. Only called in get_first_row_block
     OLAPStatus schema_change_init();
@@ -158,13 +176,41 @@ private:
         _read_block->get_row(_read_block->pos(), &_cursor);
         return &_cursor;
     }
+
+    // Evaluate predicates in order of measured cost and selectivity, so that
+    // cheap and selective ones run first and others only run on rows left.
+    void _evaluate_predicates(VectorizedRowBatch* vec_batch);
+
+    // Remove rows satisfying delete predicates from the batch, which is
+    // partially satisfied by delete conditions, and mark the batch as not
+    // satisfied, so rows of it are not checked by DeleteHandler again.
+    void _evaluate_delete_predicates(VectorizedRowBatch* vec_batch);
+
+    // Remove rows marked in delete bitmap of the current segment
+    void _filter_deleted_rows(VectorizedRowBatch* vec_batch);
 private:
+    // measured cost and selectivity of a predicate
+    struct PredicateStats {
+        ColumnPredicate* predicate;
+        int64_t input_rows;
+        int64_t output_rows;
+        int64_t cost_ns;
+
+        // cost of filtering out one row, smaller ones should be evaluated first
+        double rank() const;
+    };
+
     SegmentGroup* _segment_group;
     // 当到达文件末尾或者到达end key时设置此标志
     bool _eof;
     const Conditions* _conditions;
     const std::vector<ColumnPredicate*>* _col_predicates;
     const DeleteHandler*_delete_handler = nullptr;
+    const std::vector<DeletePredicates>* _delete_predicates = nullptr;
+    // rows of the batch being evaluated which are not deleted
+    std::vector<uint16_t> _undeleted_rows;
+    const DeleteBitmapSnapshot* _delete_bitmaps = nullptr;
+    int64_t _delete_bitmap_version = -1;
     DelCondSatisfied _delete_status;
     RuntimeState* _runtime_state;
     OlapReaderStatistics* _stats;
@@ -176,6 +222,9 @@ private:
     bool _is_using_cache;
     bool _segment_eof = false;
     bool _need_eval_predicates = false;
+    // in order of evaluation
+    std::vector<PredicateStats> _predicate_stats;
+    int64_t _num_eval_batches = 0;
 
     std::vector<uint32_t> _return_columns;
     std::vector<uint32_t> _seek_columns;
@@ -27,19 +27,24 @@
 namespace doris {
 
 ColumnDataWriter* ColumnDataWriter::create(SegmentGroup* segment_group, bool is_push_write,
-        CompressKind compress_kind, double bloom_filter_fpp) {
+        CompressKind compress_kind, double bloom_filter_fpp,
+        IOScheduler* io_scheduler, IOClass io_class) {
     ColumnDataWriter* writer = new (std::nothrow) ColumnDataWriter(segment_group, is_push_write,
-            compress_kind, bloom_filter_fpp);
+            compress_kind, bloom_filter_fpp, io_scheduler, io_class);
     return writer;
 }
 
 ColumnDataWriter::ColumnDataWriter(SegmentGroup* segment_group,
         bool is_push_write, CompressKind compress_kind,
-        double bloom_filter_fpp)
+        double bloom_filter_fpp,
+        IOScheduler* io_scheduler,
+        IOClass io_class)
     : _segment_group(segment_group),
       _is_push_write(is_push_write),
       _compress_kind(compress_kind),
       _bloom_filter_fpp(bloom_filter_fpp),
+      _io_scheduler(io_scheduler),
+      _io_class(io_class),
       _zone_maps(segment_group->get_num_key_columns(), KeyRange(NULL, NULL)),
       _row_index(0),
       _row_block(NULL),
@@ -246,7 +251,8 @@ OLAPStatus ColumnDataWriter::_add_segment() {
 
     file_name = _segment_group->construct_data_file_path(_segment);
     _segment_writer = new(std::nothrow) SegmentWriter(file_name, _segment_group,
-            OLAP_DEFAULT_COLUMN_STREAM_BUFFER_SIZE, _compress_kind, _bloom_filter_fpp);
+            OLAP_DEFAULT_COLUMN_STREAM_BUFFER_SIZE, _compress_kind, _bloom_filter_fpp,
+            _io_scheduler, _io_class);
 
     if (NULL == _segment_writer) {
         OLAP_LOG_WARNING("fail to allocate SegmentWriter");
@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_COLUMN_DATA_WRITER_H
 #define DORIS_BE_SRC_OLAP_ROWSET_COLUMN_DATA_WRITER_H
 
+#include "olap/io_scheduler.h"
 #include "olap/rowset/segment_group.h"
 #include "olap/row_block.h"
 #include "olap/schema.h"
@@ -32,10 +33,14 @@ class ColumnDataWriter {
 public:
     // Factory function
     // 调用者获得新建的对象, 并负责delete释放
+    // io_scheduler is the IO scheduler of data dir to write, which limits
+    // total write rate of io_class on the data dir, null means no limit.
     static ColumnDataWriter* create(SegmentGroup* segment_group, bool is_push_write,
-            CompressKind compress_kind, double bloom_filter_fpp);
+            CompressKind compress_kind, double bloom_filter_fpp,
+            IOScheduler* io_scheduler = nullptr, IOClass io_class = IOClass::LOAD);
     ColumnDataWriter(SegmentGroup* segment_group, bool is_push_write,
-            CompressKind compress_kind, double bloom_filter_fpp);
+            CompressKind compress_kind, double bloom_filter_fpp,
+            IOScheduler* io_scheduler = nullptr, IOClass io_class = IOClass::LOAD);
     ~ColumnDataWriter();
     OLAPStatus init();
     
@@ -62,6 +67,8 @@ private:
     bool _is_push_write;
     CompressKind _compress_kind;
     double _bloom_filter_fpp;
+    IOScheduler* _io_scheduler;
+    IOClass _io_class;
     // first is min, second is max
     std::vector<std::pair<WrapperField*, WrapperField*>> _zone_maps;
     uint32_t _row_index;
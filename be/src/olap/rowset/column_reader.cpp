@@ -425,6 +425,9 @@ OLAPStatus StringColumnDictionaryReader::next_vector(
     int64_t buffer_size = 0;
     OLAPStatus res = OLAP_SUCCESS;
 
+    // The values reference the dictionary, which lives as long as this reader,
+    // instead of copies of its strings. ColumnData switches the segment reader only
+    // after clearing the mem pool of the batch, so they live as long as copies did.
     column_vector->set_col_data(_values);
     if (column_vector->no_nulls()) {
         for (int i = 0; i < size; ++i) {
@@ -438,17 +441,9 @@ OLAPStatus StringColumnDictionaryReader::next_vector(
                                  index[i], _dictionary.size());
                 return OLAP_ERR_BUFFER_OVERFLOW;
             }
-            _values[i].size = _dictionary[index[i]].size();
-            buffer_size += _values[i].size;
-        }
-
-        char* string_buffer = reinterpret_cast<char*>(mem_pool->allocate(buffer_size));
-        for (int i = 0; i < size; ++i) {
-            memory_copy(string_buffer,
-                        _dictionary[index[i]].c_str(),
-                        _values[i].size);
-            _values[i].data = string_buffer;
-            string_buffer += _values[i].size;
+            const std::string& item = _dictionary[index[i]];
+            _values[i] = Slice(item.data(), item.size());
+            buffer_size += item.size();
         }
     } else {
         bool* is_null = column_vector->is_null();
@@ -464,19 +459,9 @@ OLAPStatus StringColumnDictionaryReader::next_vector(
                                      index[i], _dictionary.size());
                     return OLAP_ERR_BUFFER_OVERFLOW;
                 }
-                _values[i].size = _dictionary[index[i]].size();
-                buffer_size += _values[i].size;
-            }
-        }
-
-        char* string_buffer = reinterpret_cast<char*>(mem_pool->allocate(buffer_size));
-        for (int i = 0; i < size; ++i) {
-            if (!is_null[i]) {
-                memory_copy(string_buffer,
-                            _dictionary[index[i]].c_str(),
-                            _values[i].size);
-                _values[i].data = string_buffer;
-                string_buffer += _values[i].size;
+                const std::string& item = _dictionary[index[i]];
+                _values[i] = Slice(item.data(), item.size());
+                buffer_size += item.size();
             }
         }
     }
@@ -87,6 +87,11 @@ public:
     OLAPStatus skip(uint64_t row_count);
     // 返回当前行的数据，通过将内部指针移向下一行
     OLAPStatus next(int64_t* value);
+    // 读取接下来的num个数据到values中
+    template<class T>
+    OLAPStatus next_batch(T* values, size_t num) {
+        return _data_reader->next_batch(values, num);
+    }
     bool eof() {
         return _eof;
     }
@@ -533,25 +538,25 @@ public:
 
         column_vector->set_col_data(_values);
         if (column_vector->no_nulls()) {
-            for (uint32_t i = 0; i < size; ++i) {
-                int64_t value = 0;
-                res = _reader.next(&value);
-                if (OLAP_SUCCESS != res) {
-                    break;
-                }
-                _values[i] = value;
-            }
+            res = _reader.next_batch(_values, size);
         } else {
+            // read not null values to the front of _values, then move them
+            // to their rows from back to front, which never overwrites a
+            // value not moved yet.
             bool* is_null = column_vector->is_null();
+            uint32_t num_not_null = 0;
             for (uint32_t i = 0; i < size; ++i) {
-                int64_t value = 0;
-                if (!is_null[i]) {
-                    res = _reader.next(&value);
-                    if (OLAP_SUCCESS != res) {
-                        break;
+                num_not_null += !is_null[i];
+            }
+            res = _reader.next_batch(_values, num_not_null);
+            if (OLAP_SUCCESS == res) {
+                for (uint32_t i = size; i > 0; --i) {
+                    if (is_null[i - 1]) {
+                        _values[i - 1] = 0;
+                    } else {
+                        _values[i - 1] = _values[--num_not_null];
                     }
                 }
-                _values[i] = value;
             }
         }
         _stats->bytes_read += sizeof(T) * size;
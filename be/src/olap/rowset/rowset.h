@@ -117,6 +117,10 @@ public:
         return _rowset_path + "/" + std::to_string(rowset_id());
     }
 
+    DataDir* data_dir() const { return _data_dir; }
+
+    const std::string& rowset_path() const { return _rowset_path; }
+
     bool need_delete_file() const {
         return _need_delete_file;
     }
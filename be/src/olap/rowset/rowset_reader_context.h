@@ -20,6 +20,7 @@
 
 #include "olap/column_predicate.h"
 #include "olap/lru_cache.h"
+#include "olap/primary_key_index.h"
 #include "runtime/runtime_state.h"
 
 namespace doris {
@@ -27,12 +28,14 @@ namespace doris {
 class RowCursor;
 class Conditions;
 class DeleteHandler;
+struct DeletePredicates;
 class TabletSchema;
 
 struct RowsetReaderContext {
     RowsetReaderContext() : reader_type(READER_QUERY),
         tablet_schema(nullptr),
         preaggregation(false),
+        need_ordered_result(false),
         return_columns(nullptr),
         seek_columns(nullptr),
         load_bf_columns(nullptr),
@@ -43,6 +46,9 @@ struct RowsetReaderContext {
         upper_bound_keys(nullptr),
         is_upper_keys_included(nullptr),
         delete_handler(nullptr),
+        delete_predicates(nullptr),
+        delete_bitmaps(nullptr),
+        delete_bitmap_version(-1),
         stats(nullptr),
         is_using_cache(false),
         lru_cache(nullptr),
@@ -51,6 +57,8 @@ struct RowsetReaderContext {
     ReaderType reader_type;
     const TabletSchema* tablet_schema;
     bool preaggregation;
+    // rows of segment groups are merged in order of keys for query
+    bool need_ordered_result;
     // projection columns
     const std::vector<uint32_t>* return_columns;
     const std::vector<uint32_t>* seek_columns;
@@ -67,6 +75,13 @@ struct RowsetReaderContext {
     const std::vector<RowCursor*>* upper_bound_keys;
     const std::vector<bool>* is_upper_keys_included;
     const DeleteHandler* delete_handler;
+    // delete conditions evaluated on batches, nullptr if they are evaluated by
+    // delete_handler row by row
+    const std::vector<DeletePredicates>* delete_predicates;
+    // delete bitmaps of merge-on-write tablets captured at delete_bitmap_version,
+    // rowsets needn't be merged if it's not nullptr
+    const DeleteBitmapSnapshot* delete_bitmaps;
+    int64_t delete_bitmap_version;
     OlapReaderStatistics* stats;
     bool is_using_cache;
     Cache* lru_cache;
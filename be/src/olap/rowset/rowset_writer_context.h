@@ -20,6 +20,7 @@
 
 #include "gen_cpp/olap_file.pb.h"
 #include "olap/data_dir.h"
+#include "olap/io_scheduler.h"
 #include "olap/tablet_schema.h"
 
 namespace doris {
@@ -38,6 +39,7 @@ struct RowsetWriterContext {
         tablet_schema(nullptr),
         rowset_state(PREPARED),
         data_dir(nullptr),
+        io_class(IOClass::LOAD),
         version(Version(0, 0)),
         version_hash(0),
         txn_id(0) {
@@ -57,6 +59,8 @@ struct RowsetWriterContext {
     // VISIBLE for non-pending rowset
     RowsetStatePB rowset_state;
     DataDir* data_dir;
+    // class of write IO on data_dir, limited by IOScheduler of data_dir
+    IOClass io_class;
     // properties for non-pending rowset
     Version version;
     VersionHash version_hash;
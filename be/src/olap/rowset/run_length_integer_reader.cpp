@@ -372,9 +372,8 @@ OLAPStatus RunLengthIntegerReader::_read_short_repeat_values(uint8_t first_byte)
     }
 
     // repeat the value for length times
-    for (int32_t i = 0; i < len; i++) {
-        _literals[_num_literals++] = val;
-    }
+    std::fill_n(_literals + _num_literals, len, val);
+    _num_literals += len;
 
     return res;
 }
@@ -18,6 +18,8 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_RUN_LENGTH_INTEGER_READER_H
 #define DORIS_BE_SRC_OLAP_ROWSET_RUN_LENGTH_INTEGER_READER_H
 
+#include <algorithm>
+
 #include "olap/file_stream.h"
 #include "olap/rowset/run_length_integer_writer.h"
 #include "olap/stream_index_reader.h"
@@ -53,6 +55,34 @@ public:
         *value = _literals[_used++];
         return res;
     }
+    // Read next num values into values, which is much cheaper than calling
+    // next() for every value as decoded runs are copied in tight loops.
+    // Return OLAP_ERR_DATA_EOF or other errors if there are not enough
+    // values, in which case some of values may have been filled.
+    template<class T>
+    inline OLAPStatus next_batch(T* values, size_t num) {
+        while (num > 0) {
+            if (OLAP_UNLIKELY(_used == _num_literals)) {
+                _num_literals = 0;
+                _used = 0;
+
+                OLAPStatus res = _read_values();
+                if (OLAP_SUCCESS != res) {
+                    return res;
+                }
+            }
+
+            size_t count = std::min<size_t>(num, _num_literals - _used);
+            const int64_t* literals = _literals + _used;
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = static_cast<T>(literals[i]);
+            }
+            _used += count;
+            values += count;
+            num -= count;
+        }
+        return OLAP_SUCCESS;
+    }
     OLAPStatus seek(PositionProvider* position);
     OLAPStatus skip(uint64_t num_values);
 
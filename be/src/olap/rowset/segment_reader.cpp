@@ -19,6 +19,7 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <istream>
 
 #include "olap/file_stream.h"
@@ -285,6 +286,15 @@ OLAPStatus SegmentReader::seek_to_block(
             return res;
         }
     }
+    if (!_data_stream_ranges.empty()) {
+        // read ahead all data streams only if the whole segment is going
+        // to be read, otherwise most of them may be skipped
+        if (first_block == 0 && _end_block + 1 == _block_count
+                && (_without_filter || _remain_block == _block_count)) {
+            _prefetch_stream_ranges(&_data_stream_ranges);
+        }
+        _data_stream_ranges.clear();
+    }
     _seek_to_block(first_block, without_filter);
     *next_block_id = _next_block_id;
     *eof = _eof;
@@ -483,7 +493,8 @@ OLAPStatus SegmentReader::_pick_row_groups(uint32_t first_block, uint32_t last_b
     for (auto& i : _conditions->columns()) {
         FieldAggregationMethod aggregation = _get_aggregation_by_index(i.first);
         bool is_continue = (aggregation == OLAP_FIELD_AGGREGATION_NONE
-                || (aggregation == OLAP_FIELD_AGGREGATION_REPLACE
+                || ((aggregation == OLAP_FIELD_AGGREGATION_REPLACE
+                     || aggregation == OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL)
                 && _segment_group->version().first == 0));
         if (!is_continue) {
             continue;
@@ -524,7 +535,8 @@ OLAPStatus SegmentReader::_pick_row_groups(uint32_t first_block, uint32_t last_b
     for (uint32_t i : _load_bf_columns) {
         FieldAggregationMethod aggregation = _get_aggregation_by_index(i);
         bool is_continue = (aggregation == OLAP_FIELD_AGGREGATION_NONE
-                || (aggregation == OLAP_FIELD_AGGREGATION_REPLACE
+                || ((aggregation == OLAP_FIELD_AGGREGATION_REPLACE
+                     || aggregation == OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL)
                 && _segment_group->version().first == 0));
         if (!is_continue) {
             continue;
@@ -599,6 +611,41 @@ OLAPStatus SegmentReader::_load_index(bool is_using_cache) {
     uint64_t stream_length = 0;
     int32_t cache_handle_index = 0;
     uint64_t stream_offset = _header_length;
+
+    // read ahead index streams not in cache together before reading them
+    // one by one
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    for (int64_t stream_index = 0; stream_index < _header_message().stream_info_size();
+            ++stream_index, stream_offset += stream_length) {
+        const StreamInfoMessage& message = _header_message().stream_info(stream_index);
+        stream_length = message.length();
+        ColumnId unique_column_id = message.column_unique_id();
+        if (0 == _unique_id_to_segment_id_map.count(unique_column_id)) {
+            continue;
+        }
+        if (!(_is_column_included(unique_column_id)
+                && message.kind() == StreamInfoMessage::ROW_INDEX)
+                && !(_is_bf_column_included(unique_column_id)
+                && message.kind() == StreamInfoMessage::BLOOM_FILTER)) {
+            continue;
+        }
+        char key_buf[OLAP_LRU_CACHE_MAX_KEY_LENTH];
+        CacheKey key = _construct_index_stream_key(key_buf,
+                       sizeof(key_buf),
+                       _file_handler.file_name(),
+                       unique_column_id,
+                       message.kind());
+        Cache::Handle* handle = _lru_cache->lookup(key);
+        if (handle != nullptr) {
+            _lru_cache->release(handle);
+            continue;
+        }
+        ranges.emplace_back(stream_offset, stream_length);
+    }
+    _prefetch_stream_ranges(&ranges);
+
+    stream_length = 0;
+    stream_offset = _header_length;
     int64_t expected_blocks = static_cast<int64_t>(ceil(static_cast<double>(
             _header_message().number_of_rows()) /
             _header_message().num_rows_per_block()));
@@ -793,11 +840,42 @@ OLAPStatus SegmentReader::_read_all_data_streams(size_t* buffer_size) {
 
         *buffer_size += stream->get_buffer_size();
         _streams[name] = stream.release();
+        _data_stream_ranges.emplace_back(stream_offset, stream_length);
     }
 
     return OLAP_SUCCESS;
 }
 
+void SegmentReader::_prefetch_stream_ranges(std::vector<std::pair<uint64_t, uint64_t>>* ranges) {
+    uint64_t max_bytes = std::max<int64_t>(config::segment_read_coalesce_max_bytes, 0);
+    uint64_t gap_bytes = std::max<int64_t>(config::segment_read_coalesce_gap_bytes, 0);
+    if (max_bytes == 0 || ranges->empty()) {
+        return;
+    }
+    std::sort(ranges->begin(), ranges->end());
+
+    // a single stream larger than max_bytes is read ahead by several IOs
+    auto prefetch = [this, max_bytes] (uint64_t begin, uint64_t end) {
+        for (uint64_t offset = begin; offset < end; offset += max_bytes) {
+            _file_handler.prefetch(std::min(max_bytes, end - offset), offset);
+        }
+    };
+    uint64_t begin = ranges->front().first;
+    uint64_t end = begin + ranges->front().second;
+    for (size_t i = 1; i < ranges->size(); ++i) {
+        uint64_t range_begin = (*ranges)[i].first;
+        uint64_t range_end = range_begin + (*ranges)[i].second;
+        if (range_begin <= end + gap_bytes && range_end - begin <= max_bytes) {
+            end = std::max(end, range_end);
+        } else {
+            prefetch(begin, end);
+            begin = range_begin;
+            end = range_end;
+        }
+    }
+    prefetch(begin, end);
+}
+
 OLAPStatus SegmentReader::_create_reader(size_t* buffer_size) {
     _column_readers.resize(_segment_group->get_tablet_schema().num_columns(), nullptr);
     _column_indices.resize(_segment_group->get_tablet_schema().num_columns(), nullptr);
@@ -24,6 +24,8 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "olap/bloom_filter_reader.h"
 #include "olap/rowset/column_reader.h"
@@ -204,6 +206,10 @@ private:
     // 此意味着实际的数据读取， 而在这里并没有实际的读，只是圈出来需要的范围）
     OLAPStatus _read_all_data_streams(size_t* buffer_size);
 
+    // 将需要读取的流的范围(offset, length)按偏移排序, 相邻或间隔较小的范围合并成
+    // 少量的大IO, 并提示内核预读, 减少逐个流读取时的磁盘寻道
+    void _prefetch_stream_ranges(std::vector<std::pair<uint64_t, uint64_t>>* ranges);
+
     // 过滤并读取，（和_read_all_data_streams一样，也没有实际的读取数据）
     // 创建reader
     OLAPStatus _create_reader(size_t* buffer_size);
@@ -353,6 +359,8 @@ private:
     bool _is_using_mmap;                     // 这个标记为true时，使用mmap来读取文件
     bool _is_data_loaded;
     size_t _buffer_size;
+    // 需要读取的数据流的范围, 第一次seek时如果读取整个segment则预读
+    std::vector<std::pair<uint64_t, uint64_t>> _data_stream_ranges;
 
     std::vector<Cache::Handle*> _cache_handle;
     const FileHeader<ColumnDataHeaderMessage>* _file_header;
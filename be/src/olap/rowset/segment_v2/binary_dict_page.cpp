@@ -125,7 +125,9 @@ size_t BinaryDictPageBuilder::count() const {
 }
 
 Status BinaryDictPageBuilder::get_dictionary_page(Slice* dictionary_page) {
-    DCHECK(_finished) << "get dictionary page when the builder is not finished";
+    // dictionary page can be got when current data page is finished, or when
+    // all data pages have been finished and the builder is reset
+    DCHECK(_finished || count() == 0) << "get dictionary page when the builder is not finished";
     _dictionary.clear();
     _dict_builder->reset();
     size_t add_count = 1;
@@ -178,6 +180,16 @@ Status BinaryDictPageDecoder::seek_to_position_in_page(size_t pos) {
     return _data_page_decoder->seek_to_position_in_page(pos);
 }
 
+Status BinaryDictPageDecoder::_next_codes(size_t* n, ColumnBlockView* dst) {
+    _code_buf.resize((*n) * sizeof(int32_t));
+
+    // the data in page is not null
+    TypeInfo *type_info = get_type_info(OLAP_FIELD_TYPE_INT);
+    ColumnBlock column_block(type_info, _code_buf.data(), nullptr, dst->column_block()->arena());
+    ColumnBlockView tmp_block_view(&column_block);
+    return _data_page_decoder->next_batch(n, &tmp_block_view);
+}
+
 Status BinaryDictPageDecoder::next_batch(size_t* n, ColumnBlockView* dst) {
     if (_encoding_type == PLAIN_ENCODING) {
         return _data_page_decoder->next_batch(n, dst);
@@ -189,29 +201,38 @@ Status BinaryDictPageDecoder::next_batch(size_t* n, ColumnBlockView* dst) {
         return Status::OK();
     }
     Slice *out = reinterpret_cast<Slice *>(dst->data());
-    _code_buf.resize((*n) * sizeof(int32_t));
 
     // copy the codewords into a temporary buffer first
-    // And then copy the strings corresponding to the codewords to the destination buffer
-    TypeInfo *type_info = get_type_info(OLAP_FIELD_TYPE_INT);
-    // the data in page is not null
-    ColumnBlock column_block(type_info, _code_buf.data(), nullptr, dst->column_block()->arena());
-    ColumnBlockView tmp_block_view(&column_block);
-    RETURN_IF_ERROR(_data_page_decoder->next_batch(n, &tmp_block_view));
+    // And then point the values to the strings of the codewords in the dictionary,
+    // which is held by the ColumnReader and outlives the destination
+    RETURN_IF_ERROR(_next_codes(n, dst));
     for (int i = 0; i < *n; ++i) {
         int32_t codeword = *reinterpret_cast<int32_t *>(&_code_buf[i * sizeof(int32_t)]);
-        // get the string from the dict decoder
-        Slice element = _dict_decoder->string_at_index(codeword);
-        char *destination = dst->column_block()->arena()->Allocate(element.size);
-        if (destination == nullptr) {
-            return Status::MemoryAllocFailed(Substitute("memory allocate failed, size:$0", element.size));
-        }
-        element.relocate(destination);
-        *out = element;
+        *out = _dict_decoder->string_at_index(codeword);
         ++out;
     }
     return Status::OK();
 }
 
+Status BinaryDictPageDecoder::next_batch_with_dict_filter(size_t* n, ColumnBlockView* dst,
+                                                          const uint8_t* dict_filter,
+                                                          uint8_t* selection) {
+    DCHECK(_parsed);
+    DCHECK_EQ(_encoding_type, DICT_ENCODING);
+    if (PREDICT_FALSE(*n == 0)) {
+        *n = 0;
+        return Status::OK();
+    }
+    Slice *out = reinterpret_cast<Slice *>(dst->data());
+
+    RETURN_IF_ERROR(_next_codes(n, dst));
+    for (int i = 0; i < *n; ++i, ++out) {
+        int32_t codeword = *reinterpret_cast<int32_t *>(&_code_buf[i * sizeof(int32_t)]);
+        selection[i] = dict_filter[codeword];
+        *out = selection[i] ? _dict_decoder->string_at_index(codeword) : Slice();
+    }
+    return Status::OK();
+}
+
 } // namespace segment_v2
 } // namespace doris
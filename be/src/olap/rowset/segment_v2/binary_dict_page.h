@@ -104,6 +104,8 @@ public:
 
     Status seek_to_position_in_page(size_t pos) override;
 
+    // For a dictionary encoded page, the values point to the strings in the
+    // dictionary, which must outlive them, instead of copies in the arena of dst.
     Status next_batch(size_t* n, ColumnBlockView* dst) override;
 
     size_t count() const override {
@@ -114,6 +116,23 @@ public:
         return _data_page_decoder->current_index();
     }
 
+    // Return true if data of this page is encoded by dictionary, otherwise
+    // data is stored in plain format because the dictionary is full.
+    bool is_dict_encoding() const { return _encoding_type == DICT_ENCODING; }
+
+    // Same as next_batch, but only the values whose codeword is selected by dict_filter
+    // are materialized into dst.
+    // dict_filter has one byte for each item of the dictionary, and selection will be
+    // set to dict_filter's value for each value read. Values not selected are set to
+    // empty slices.
+    // Should only be called when is_dict_encoding() returns true.
+    Status next_batch_with_dict_filter(size_t* n, ColumnBlockView* dst,
+                                       const uint8_t* dict_filter, uint8_t* selection);
+
+private:
+    // decode next n codewords into _code_buf
+    Status _next_codes(size_t* n, ColumnBlockView* dst);
+
 private:
     Slice _data;
     PageDecoderOptions _options;
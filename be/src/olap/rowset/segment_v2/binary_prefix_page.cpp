@@ -0,0 +1,226 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/binary_prefix_page.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "gutil/strings/substitute.h" // for Substitute
+#include "util/arena.h"
+
+namespace doris {
+namespace segment_v2 {
+
+using strings::Substitute;
+
+Status BinaryPrefixPageBuilder::add(const uint8_t* vals, size_t* count) {
+    DCHECK(!_finished);
+    DCHECK_GT(*count, 0);
+    const Slice* src = reinterpret_cast<const Slice*>(vals);
+    size_t i = 0;
+    // If the page is full, should stop adding more items.
+    while (!is_page_full() && i < *count) {
+        size_t shared = 0;
+        if (_count % RESTART_POINT_INTERVAL == 0) {
+            _restart_points.push_back(_buffer.size());
+        } else {
+            size_t max_shared = std::min(_last_value.size(), src->size);
+            while (shared < max_shared && _last_value[shared] == src->data[shared]) {
+                ++shared;
+            }
+        }
+        size_t non_shared = src->size - shared;
+        put_varint32(&_buffer, shared);
+        put_varint32(&_buffer, non_shared);
+        _buffer.append(src->data + shared, non_shared);
+
+        _last_value.resize(shared);
+        _last_value.append(src->data + shared, non_shared);
+        ++_count;
+        ++i;
+        ++src;
+    }
+    *count = i;
+    return Status::OK();
+}
+
+Slice BinaryPrefixPageBuilder::finish() {
+    _finished = true;
+    for (auto restart_point : _restart_points) {
+        put_fixed32_le(&_buffer, restart_point);
+    }
+    put_fixed32_le(&_buffer, _count);
+    put_fixed32_le(&_buffer, _restart_points.size());
+    return Slice(_buffer.data(), _buffer.size());
+}
+
+void BinaryPrefixPageBuilder::reset() {
+    _restart_points.clear();
+    _count = 0;
+    _finished = false;
+    _buffer.clear();
+    _buffer.reserve(_options.data_page_size);
+    _last_value.clear();
+}
+
+Status BinaryPrefixPageDecoder::init() {
+    CHECK(!_parsed);
+    if (_data.size < TRAILER_SIZE) {
+        return Status::Corruption(Substitute(
+                "not enough bytes for trailer in BinaryPrefixPageDecoder, size:$0", _data.size));
+    }
+    const uint8_t* trailer = (const uint8_t*)_data.data + _data.size - TRAILER_SIZE;
+    _num_values = decode_fixed32_le(trailer);
+    _num_restarts = decode_fixed32_le(trailer + sizeof(uint32_t));
+    size_t restarts_size = _num_restarts * sizeof(uint32_t);
+    if (restarts_size > _data.size - TRAILER_SIZE
+            || _num_restarts != (_num_values + BinaryPrefixPageBuilder::RESTART_POINT_INTERVAL - 1)
+                / BinaryPrefixPageBuilder::RESTART_POINT_INTERVAL) {
+        return Status::Corruption(Substitute(
+                "bad restart points in BinaryPrefixPageDecoder, num values:$0, num restarts:$1",
+                _num_values, _num_restarts));
+    }
+    _restarts_ptr = trailer - restarts_size;
+    _entries_end = _restarts_ptr;
+
+    _parsed = true;
+    _cur_pos = 0;
+    if (_num_values > 0) {
+        RETURN_IF_ERROR(_seek_to_restart_point(0));
+    }
+    return Status::OK();
+}
+
+Status BinaryPrefixPageDecoder::_decode_restart_value(size_t restart_point_index, Slice* value) const {
+    uint32_t offset = _restart_point(restart_point_index);
+    const uint8_t* ptr = (const uint8_t*)_data.data + offset;
+    uint32_t shared = 0;
+    uint32_t non_shared = 0;
+    if (ptr >= _entries_end
+            || (ptr = decode_varint32_ptr(ptr, _entries_end, &shared)) == nullptr
+            || (ptr = decode_varint32_ptr(ptr, _entries_end, &non_shared)) == nullptr
+            || shared != 0 || ptr + non_shared > _entries_end) {
+        return Status::Corruption(Substitute("bad restart entry at offset $0", offset));
+    }
+    *value = Slice(ptr, non_shared);
+    return Status::OK();
+}
+
+Status BinaryPrefixPageDecoder::_seek_to_restart_point(size_t restart_point_index) {
+    _cur_pos = restart_point_index * BinaryPrefixPageBuilder::RESTART_POINT_INTERVAL;
+    _next_ptr = (const uint8_t*)_data.data + _restart_point(restart_point_index);
+    _current_value.clear();
+    return _read_next_value();
+}
+
+Status BinaryPrefixPageDecoder::_read_next_value() {
+    uint32_t shared = 0;
+    uint32_t non_shared = 0;
+    const uint8_t* ptr = _next_ptr;
+    if (ptr >= _entries_end
+            || (ptr = decode_varint32_ptr(ptr, _entries_end, &shared)) == nullptr
+            || (ptr = decode_varint32_ptr(ptr, _entries_end, &non_shared)) == nullptr
+            || shared > _current_value.size() || ptr + non_shared > _entries_end) {
+        return Status::Corruption(Substitute("bad entry of value $0 in BinaryPrefixPageDecoder", _cur_pos));
+    }
+    _current_value.resize(shared);
+    _current_value.append(ptr, non_shared);
+    _next_ptr = ptr + non_shared;
+    return Status::OK();
+}
+
+Status BinaryPrefixPageDecoder::seek_to_position_in_page(size_t pos) {
+    DCHECK(_parsed);
+    DCHECK_LE(pos, _num_values);
+    if (pos == _cur_pos) {
+        return Status::OK();
+    }
+    if (pos >= _num_values) {
+        _cur_pos = _num_values;
+        return Status::OK();
+    }
+    size_t restart_point_index = pos / BinaryPrefixPageBuilder::RESTART_POINT_INTERVAL;
+    // decode from current value if it is before pos in the same restart interval
+    if (_cur_pos > pos || _cur_pos >= _num_values
+            || _cur_pos / BinaryPrefixPageBuilder::RESTART_POINT_INTERVAL != restart_point_index) {
+        RETURN_IF_ERROR(_seek_to_restart_point(restart_point_index));
+    }
+    while (_cur_pos < pos) {
+        RETURN_IF_ERROR(_next_value());
+    }
+    return Status::OK();
+}
+
+Status BinaryPrefixPageDecoder::seek_at_or_after_value(const void* value, bool* exact_match) {
+    DCHECK(_parsed);
+    const Slice& target = *reinterpret_cast<const Slice*>(value);
+    if (_num_values == 0) {
+        return Status::NotFound("page is empty");
+    }
+    // find the last restart entry which is less than target
+    size_t left = 0;
+    size_t right = _num_restarts;
+    while (left + 1 < right) {
+        size_t mid = left + (right - left) / 2;
+        Slice mid_value;
+        RETURN_IF_ERROR(_decode_restart_value(mid, &mid_value));
+        if (mid_value.compare(target) < 0) {
+            left = mid;
+        } else {
+            right = mid;
+        }
+    }
+    RETURN_IF_ERROR(_seek_to_restart_point(left));
+    while (true) {
+        int cmp = Slice(_current_value.data(), _current_value.size()).compare(target);
+        if (cmp >= 0) {
+            *exact_match = cmp == 0;
+            return Status::OK();
+        }
+        RETURN_IF_ERROR(_next_value());
+        if (_cur_pos >= _num_values) {
+            return Status::NotFound("all values are less than target");
+        }
+    }
+}
+
+Status BinaryPrefixPageDecoder::next_batch(size_t* n, ColumnBlockView* dst) {
+    DCHECK(_parsed);
+    if (PREDICT_FALSE(*n == 0 || _cur_pos >= _num_values)) {
+        *n = 0;
+        return Status::OK();
+    }
+    size_t max_fetch = std::min(*n, static_cast<size_t>(_num_values - _cur_pos));
+
+    Slice* out = reinterpret_cast<Slice*>(dst->data());
+    for (size_t i = 0; i < max_fetch; ++i, ++out) {
+        out->size = _current_value.size();
+        out->data = reinterpret_cast<char*>(dst->arena()->Allocate(out->size));
+        if (out->data == nullptr && out->size > 0) {
+            return Status::MemoryAllocFailed(Substitute("memory allocate failed, size:$0", out->size));
+        }
+        memcpy(out->data, _current_value.data(), out->size);
+        RETURN_IF_ERROR(_next_value());
+    }
+
+    *n = max_fetch;
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
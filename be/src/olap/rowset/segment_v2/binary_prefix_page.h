@@ -0,0 +1,164 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/page_builder.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+#include "util/coding.h"
+#include "util/faststring.h"
+#include "util/slice.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// Front coding page encoding for strings, values are expected to be added in
+// sorted order, such as key columns, so that adjacent values share long prefix.
+//
+// The page consists of:
+// Entries:
+//   array of entry
+// entry:
+//   length of prefix shared with previous value (varint32)
+//   length of non-shared suffix (varint32)
+//   non-shared suffix
+// RestartPoints:
+//   offsets of restart entries, relative to page start (32-bit fixed * num_restarts)
+// Trailer:
+//   num_elems (32-bit fixed)
+//   num_restarts (32-bit fixed)
+//
+// Every RESTART_POINT_INTERVAL entries there is a restart entry which shares no
+// prefix with previous value, so that decoder can seek to an entry by decoding
+// at most RESTART_POINT_INTERVAL entries, and binary search can run over the
+// restart entries.
+class BinaryPrefixPageBuilder : public PageBuilder {
+public:
+    BinaryPrefixPageBuilder(const PageBuilderOptions& options) : _options(options) {
+        reset();
+    }
+
+    bool is_page_full() override {
+        return _buffer.size() >= _options.data_page_size;
+    }
+
+    Status add(const uint8_t* vals, size_t* count) override;
+
+    Slice finish() override;
+
+    void reset() override;
+
+    size_t count() const override {
+        return _count;
+    }
+
+    // this api will release the memory ownership of encoded data
+    // Note:
+    //     release() should be called after finish
+    //     reset() should be called after this function before reuse the builder
+    void release() override {
+        uint8_t* ret = _buffer.release();
+        (void) ret;
+    }
+
+    static const uint32_t RESTART_POINT_INTERVAL = 16;
+
+private:
+    PageBuilderOptions _options;
+    std::vector<uint32_t> _restart_points;
+    size_t _count = 0;
+    bool _finished = false;
+    faststring _buffer;
+    // copy of the last added value, used to compute shared prefix with next value
+    std::string _last_value;
+};
+
+class BinaryPrefixPageDecoder : public PageDecoder {
+public:
+    BinaryPrefixPageDecoder(Slice data, const PageDecoderOptions& options)
+        : _data(data), _options(options) { }
+
+    Status init() override;
+
+    Status seek_to_position_in_page(size_t pos) override;
+
+    // Seek to the first value which is greater than or equal to value, value
+    // should point to a Slice. exact_match is set to true if the found value
+    // equals to value. Return NotFound if all values are less than value.
+    // Restart entries are searched by binary search, and then at most
+    // RESTART_POINT_INTERVAL entries are decoded.
+    Status seek_at_or_after_value(const void* value, bool* exact_match);
+
+    Status next_batch(size_t* n, ColumnBlockView* dst) override;
+
+    size_t count() const override {
+        DCHECK(_parsed);
+        return _num_values;
+    }
+
+    size_t current_index() const override {
+        DCHECK(_parsed);
+        return _cur_pos;
+    }
+
+    static const size_t TRAILER_SIZE = sizeof(uint32_t) * 2;
+
+private:
+    uint32_t _restart_point(size_t restart_point_index) const {
+        return decode_fixed32_le(_restarts_ptr + restart_point_index * sizeof(uint32_t));
+    }
+
+    // decode the value of restart entry, which shares no prefix with others
+    Status _decode_restart_value(size_t restart_point_index, Slice* value) const;
+    Status _seek_to_restart_point(size_t restart_point_index);
+    // decode entry at _next_ptr into _current_value
+    Status _read_next_value();
+    // move to the next value, _cur_pos may be _num_values after this
+    Status _next_value() {
+        ++_cur_pos;
+        if (_cur_pos < _num_values) {
+            return _read_next_value();
+        }
+        return Status::OK();
+    }
+
+    Slice _data;
+    PageDecoderOptions _options;
+    bool _parsed = false;
+
+    uint32_t _num_values = 0;
+    uint32_t _num_restarts = 0;
+    const uint8_t* _restarts_ptr = nullptr;
+    // end of entries, it is also the start of restart points
+    const uint8_t* _entries_end = nullptr;
+
+    // index of _current_value in page, if it's equal to _num_values,
+    // there is no more value to read
+    uint32_t _cur_pos = 0;
+    // start of the entry after current value
+    const uint8_t* _next_ptr = nullptr;
+    faststring _current_value;
+};
+
+} // namespace segment_v2
+} // namespace doris
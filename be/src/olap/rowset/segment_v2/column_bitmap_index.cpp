@@ -0,0 +1,188 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/column_bitmap_index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "olap/column_block.h" // for ColumnBlock
+#include "olap/olap_cond.h" // for CondColumn
+#include "olap/types.h" // for TypeInfo
+#include "util/coding.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// max size of cell of all types, it is enough to hold int128 and Slice
+static const size_t kMaxCellSize = 16;
+
+static bool is_slice_type(FieldType type) {
+    return type == OLAP_FIELD_TYPE_CHAR
+        || type == OLAP_FIELD_TYPE_VARCHAR
+        || type == OLAP_FIELD_TYPE_HLL;
+}
+
+// Convert value stored in bitmap index to the memory format of cell. For slice
+// types, cell will reference the memory of value.
+static void value_to_cell(const TypeInfo* type_info, const Slice& value, uint8_t* cell) {
+    if (is_slice_type(type_info->type())) {
+        *reinterpret_cast<Slice*>(cell) = value;
+    } else {
+        DCHECK_EQ(type_info->size(), value.size);
+        memcpy(cell, value.data, value.size);
+    }
+}
+
+ColumnBitmapIndexBuilder::ColumnBitmapIndexBuilder(const TypeInfo* type_info)
+        : _type_info(type_info), _rowid(0) {
+    DCHECK_LE(_type_info->size(), kMaxCellSize);
+}
+
+void ColumnBitmapIndexBuilder::add(const uint8_t* vals, size_t count) {
+    size_t cell_size = _type_info->size();
+    bool is_slice = is_slice_type(_type_info->type());
+    for (size_t i = 0; i < count; ++i, vals += cell_size, ++_rowid) {
+        std::string value;
+        if (is_slice) {
+            const Slice* slice = reinterpret_cast<const Slice*>(vals);
+            value.assign(slice->data, slice->size);
+        } else {
+            value.assign((const char*)vals, cell_size);
+        }
+        auto it = _value_index.find(value);
+        if (it == _value_index.end()) {
+            it = _value_index.emplace(value, _values.size()).first;
+            _values.push_back(std::move(value));
+            _bitmaps.emplace_back();
+        }
+        _bitmaps[it->second].add(_rowid);
+    }
+}
+
+static void append_bitmap(Roaring* bitmap, std::string* buffer) {
+    bitmap->runOptimize();
+    size_t size = bitmap->getSizeInBytes();
+    put_varint32(buffer, size);
+    size_t offset = buffer->size();
+    buffer->resize(offset + size);
+    bitmap->write(&(*buffer)[offset]);
+}
+
+Slice ColumnBitmapIndexBuilder::finish() {
+    // sort values by the order of this type
+    std::vector<uint32_t> order(_values.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs) {
+        alignas(16) uint8_t lhs_cell[kMaxCellSize];
+        alignas(16) uint8_t rhs_cell[kMaxCellSize];
+        value_to_cell(_type_info, Slice(_values[lhs]), lhs_cell);
+        value_to_cell(_type_info, Slice(_values[rhs]), rhs_cell);
+        return _type_info->cmp(lhs_cell, rhs_cell) < 0;
+    });
+
+    _buffer.clear();
+    _buffer.resize(4);
+    encode_fixed32_le((uint8_t*)_buffer.data(), _values.size());
+    for (auto idx : order) {
+        put_varint32(&_buffer, _values[idx].size());
+        _buffer.append(_values[idx]);
+        append_bitmap(&_bitmaps[idx], &_buffer);
+    }
+    append_bitmap(&_null_bitmap, &_buffer);
+    return Slice(_buffer);
+}
+
+// decode a length prefixed slice, return nullptr if data is corrupted
+static const uint8_t* decode_slice(const uint8_t* ptr, const uint8_t* limit, Slice* slice) {
+    uint32_t length = 0;
+    ptr = decode_varint32_ptr(ptr, limit, &length);
+    if (ptr == nullptr || ptr + length > limit) {
+        return nullptr;
+    }
+    *slice = Slice(ptr, length);
+    return ptr + length;
+}
+
+Status ColumnBitmapIndex::load() {
+    if (_data.size < 4) {
+        return Status::Corruption("Bad bitmap index page, page size is too small");
+    }
+    const uint8_t* ptr = (const uint8_t*)_data.data;
+    const uint8_t* limit = (const uint8_t*)_data.data + _data.size;
+
+    uint32_t num_values = decode_fixed32_le(ptr);
+    ptr += 4;
+
+    bool is_slice = is_slice_type(_type_info->type());
+    _values.resize(num_values);
+    _bitmaps.resize(num_values);
+    for (uint32_t i = 0; i < num_values; ++i) {
+        ptr = decode_slice(ptr, limit, &_values[i]);
+        if (ptr == nullptr || (!is_slice && _values[i].size != _type_info->size())) {
+            return Status::Corruption("Bad bitmap index page, failed to decode value");
+        }
+        ptr = decode_slice(ptr, limit, &_bitmaps[i]);
+        if (ptr == nullptr) {
+            return Status::Corruption("Bad bitmap index page, failed to decode bitmap");
+        }
+    }
+    ptr = decode_slice(ptr, limit, &_null_bitmap);
+    if (ptr == nullptr) {
+        return Status::Corruption("Bad bitmap index page, failed to decode null bitmap");
+    }
+    return Status::OK();
+}
+
+Roaring ColumnBitmapIndex::_read_bitmap(const Slice& bitmap) const {
+    return Roaring::read(bitmap.data);
+}
+
+void ColumnBitmapIndex::get_row_bitmap(const CondColumn* cond_column, Roaring* row_bitmap) const {
+    std::vector<const Roaring*> matched_bitmaps;
+    std::vector<Roaring> bitmaps;
+    bitmaps.reserve(_values.size() + 1);
+
+    alignas(16) uint8_t cell[kMaxCellSize];
+    ColumnBlock block(_type_info, cell, nullptr, nullptr);
+    for (size_t i = 0; i < _values.size(); ++i) {
+        value_to_cell(_type_info, _values[i], cell);
+        if (cond_column->eval(block.cell(0))) {
+            bitmaps.push_back(_read_bitmap(_bitmaps[i]));
+        }
+    }
+
+    uint8_t null_flag = 0xFF;
+    ColumnBlock null_block(_type_info, cell, &null_flag, nullptr);
+    if (cond_column->eval(null_block.cell(0))) {
+        bitmaps.push_back(_read_bitmap(_null_bitmap));
+    }
+
+    for (auto& bitmap : bitmaps) {
+        matched_bitmaps.push_back(&bitmap);
+    }
+    if (matched_bitmaps.empty()) {
+        *row_bitmap = Roaring();
+    } else {
+        *row_bitmap = Roaring::fastunion(matched_bitmaps.size(), matched_bitmaps.data());
+    }
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,114 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "olap/rowset/segment_v2/common.h" // for rowid_t
+#include "roaring/roaring.hh"
+#include "util/slice.h"
+
+namespace doris {
+
+class CondColumn;
+class TypeInfo;
+
+namespace segment_v2 {
+
+// This class encode bitmap index of a column, which is made of the sorted
+// dictionary of all distinct values in segment and the bitmap of rows of
+// every value.
+// The binary format is like that
+// Header | Content | NullBitmap
+// Header:
+//      number of values (4 Bytes)
+// Content:
+//      array of value_bitmap_pair, sorted by value
+// value_bitmap_pair:
+//      length of value (varint32)
+//      value
+//      length of bitmap (varint32)
+//      bitmap of rows which equal to value (portable roaring format)
+// NullBitmap:
+//      length of bitmap (varint32)
+//      bitmap of rows which are null (portable roaring format)
+// NOTE: value is stored in the memory format of cell, for string types it is
+// the content of the Slice.
+class ColumnBitmapIndexBuilder {
+public:
+    explicit ColumnBitmapIndexBuilder(const TypeInfo* type_info);
+
+    // add count not-null values of the next rows
+    void add(const uint8_t* vals, size_t count);
+
+    // add count null values of the next rows
+    void add_nulls(size_t count) {
+        _null_bitmap.addRange(_rowid, _rowid + count);
+        _rowid += count;
+    }
+
+    // serialize the bitmap index
+    Slice finish();
+
+private:
+    const TypeInfo* _type_info;
+    // next rowid to add
+    rowid_t _rowid;
+    // from value to index of bitmap in _bitmaps
+    std::unordered_map<std::string, uint32_t> _value_index;
+    std::vector<std::string> _values;
+    std::vector<Roaring> _bitmaps;
+    Roaring _null_bitmap;
+
+    std::string _buffer;
+};
+
+// Read bitmap index from the bitmap index page. Memory of the page should
+// outlive this object, because values and bitmaps are not copied out.
+class ColumnBitmapIndex {
+public:
+    ColumnBitmapIndex(const TypeInfo* type_info, const Slice& data)
+        : _type_info(type_info), _data(data) { }
+
+    Status load();
+
+    size_t num_values() const { return _values.size(); }
+
+    // Get rows which satisfy all conditions in cond_column. Every distinct value
+    // is evaluated once, and the bitmaps of matched values are unioned.
+    void get_row_bitmap(const CondColumn* cond_column, Roaring* row_bitmap) const;
+
+private:
+    Roaring _read_bitmap(const Slice& bitmap) const;
+
+private:
+    const TypeInfo* _type_info;
+    Slice _data;
+
+    // valid after load
+    std::vector<Slice> _values;
+    std::vector<Slice> _bitmaps;
+    Slice _null_bitmap;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,196 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/column_bloom_filter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/compiler_util.h" // for CACHE_LINE_SIZE
+#include "olap/bloom_filter.hpp" // for BloomFilter, BlockBloomFilter
+#include "olap/olap_cond.h" // for CondColumn
+#include "olap/types.h" // for TypeInfo
+#include "util/coding.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+namespace segment_v2 {
+
+static bool is_slice_type(FieldType type) {
+    return type == OLAP_FIELD_TYPE_CHAR
+        || type == OLAP_FIELD_TYPE_VARCHAR
+        || type == OLAP_FIELD_TYPE_HLL;
+}
+
+ColumnBloomFilterBuilder::ColumnBloomFilterBuilder(const TypeInfo* type_info, double fpp,
+                                                   BloomFilterAlgorithmPB algorithm)
+        : _type_info(type_info), _fpp(fpp), _algorithm(algorithm), _num_pages(0) {
+    _buffer.reserve(4 * 1024);
+    // reserve space for number of elements
+    _buffer.resize(4);
+}
+
+void ColumnBloomFilterBuilder::add(const uint8_t* vals, size_t count) {
+    size_t cell_size = _type_info->size();
+    bool is_slice = is_slice_type(_type_info->type());
+    for (size_t i = 0; i < count; ++i, vals += cell_size) {
+        if (is_slice) {
+            const Slice* slice = reinterpret_cast<const Slice*>(vals);
+            _page_hashes.insert(HashUtil::hash64(slice->data, slice->size, DEFAULT_SEED));
+        } else {
+            _page_hashes.insert(HashUtil::hash64(vals, cell_size, DEFAULT_SEED));
+        }
+    }
+}
+
+void ColumnBloomFilterBuilder::add_nulls(size_t count) {
+    if (count > 0) {
+        _page_hashes.insert(BLOOM_FILTER_NULL_HASHCODE);
+    }
+}
+
+// number of hash functions recorded for BlockBloomFilter, one for each word of bucket
+static const uint32_t BLOCK_BLOOM_FILTER_HASH_FUNCTION_NUM = 8;
+
+Status ColumnBloomFilterBuilder::flush() {
+    int64_t expected_entries = std::max<int64_t>(_page_hashes.size(), 1);
+    if (_algorithm == BLOCK_BLOOM_FILTER) {
+        BlockBloomFilter bf;
+        if (!bf.init(expected_entries, _fpp)) {
+            return Status::InternalError("failed to init block bloom filter");
+        }
+        for (auto hash : _page_hashes) {
+            bf.add_hash(hash);
+        }
+        put_varint32(&_buffer, BLOCK_BLOOM_FILTER_HASH_FUNCTION_NUM);
+        put_varint32(&_buffer, bf.bit_set_data_len());
+        _buffer.append((const char*)bf.bit_set_data(), bf.bit_set_data_len() * sizeof(uint64_t));
+    } else {
+        BloomFilter bf;
+        if (!bf.init(expected_entries, _fpp)) {
+            return Status::InternalError("failed to init bloom filter");
+        }
+        for (auto hash : _page_hashes) {
+            bf.add_hash(hash);
+        }
+        put_varint32(&_buffer, bf.hash_function_num());
+        put_varint32(&_buffer, bf.bit_set_data_len());
+        _buffer.append((const char*)bf.bit_set_data(), bf.bit_set_data_len() * sizeof(uint64_t));
+    }
+    _num_pages++;
+
+    _page_hashes.clear();
+    return Status::OK();
+}
+
+Slice ColumnBloomFilterBuilder::finish() {
+    // encoded number of elements
+    encode_fixed32_le((uint8_t*)_buffer.data(), _num_pages);
+    return Slice(_buffer);
+}
+
+Status ColumnBloomFilter::load() {
+    if (_data.size < 4) {
+        return Status::Corruption("Bad bloom filter page, page size is too small");
+    }
+    const uint8_t* ptr = (const uint8_t*)_data.data;
+    const uint8_t* limit = (const uint8_t*)_data.data + _data.size;
+
+    _num_pages = decode_fixed32_le(ptr);
+    ptr += 4;
+
+    // decode headers of all pages first to allocate bit set words at once
+    std::vector<const uint8_t*> page_words;
+    _page_bloom_filters.resize(_num_pages);
+    uint32_t total_words = 0;
+    for (int i = 0; i < _num_pages; ++i) {
+        auto& page_bf = _page_bloom_filters[i];
+        ptr = decode_varint32_ptr(ptr, limit, &page_bf.hash_function_num);
+        if (ptr == nullptr) {
+            return Status::Corruption("Bad bloom filter page, failed to decode hash function number");
+        }
+        ptr = decode_varint32_ptr(ptr, limit, &page_bf.num_words);
+        if (ptr == nullptr || page_bf.num_words == 0
+                || ptr + page_bf.num_words * sizeof(uint64_t) > limit) {
+            return Status::Corruption("Bad bloom filter page, failed to decode bit set");
+        }
+        if (_algorithm == BLOCK_BLOOM_FILTER
+                && page_bf.num_words % BlockBloomFilter::BUCKET_WORDS != 0) {
+            return Status::Corruption("Bad bloom filter page, bit set is not made of buckets");
+        }
+        page_bf.offset = total_words;
+        total_words += page_bf.num_words;
+        page_words.push_back(ptr);
+        ptr += page_bf.num_words * sizeof(uint64_t);
+    }
+
+    void* words = nullptr;
+    if (posix_memalign(&words, CACHE_LINE_SIZE, std::max<uint32_t>(total_words, 1) * sizeof(uint64_t)) != 0) {
+        return Status::MemoryAllocFailed("failed to allocate bit set of bloom filter");
+    }
+    _words.reset(reinterpret_cast<uint64_t*>(words));
+    for (int i = 0; i < _num_pages; ++i) {
+        const auto& page_bf = _page_bloom_filters[i];
+        memcpy(_words.get() + page_bf.offset, page_words[i], page_bf.num_words * sizeof(uint64_t));
+    }
+    return Status::OK();
+}
+
+// Only =, IN and IS NULL can be evaluated by bloom filter
+static bool can_evaluate_by_bloom_filter(const Cond* cond) {
+    return cond->op == OP_EQ || cond->op == OP_IN
+        || (cond->op == OP_IS && cond->operand_field->is_null());
+}
+
+bool ColumnBloomFilter::can_evaluate(const CondColumn* cond_column) {
+    for (auto cond : cond_column->conds()) {
+        if (can_evaluate_by_bloom_filter(cond)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename BloomFilterType>
+bool ColumnBloomFilter::_match_condition(BloomFilterType* bf, const CondColumn* cond_column) const {
+    bool matched = true;
+    for (auto cond : cond_column->conds()) {
+        if (can_evaluate_by_bloom_filter(cond) && !cond->eval(*bf)) {
+            matched = false;
+            break;
+        }
+    }
+    // memory of bit set is owned by _words, detach it from bloom filter
+    bf->reset();
+    return matched;
+}
+
+bool ColumnBloomFilter::match_condition(int32_t page_index, const CondColumn* cond_column) const {
+    const auto& page_bf = _page_bloom_filters[page_index];
+    uint64_t* words = _words.get() + page_bf.offset;
+    if (_algorithm == BLOCK_BLOOM_FILTER) {
+        BlockBloomFilter bf;
+        bf.init(words, page_bf.num_words);
+        return _match_condition(&bf, cond_column);
+    }
+    BloomFilter bf;
+    bf.init(words, page_bf.num_words, page_bf.hash_function_num);
+    return _match_condition(&bf, cond_column);
+}
+
+} // namespace segment_v2
+} // namespace doris
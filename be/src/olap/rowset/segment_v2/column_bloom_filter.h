@@ -0,0 +1,127 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h" // for BloomFilterAlgorithmPB
+#include "olap/olap_define.h" // for BLOOM_FILTER_DEFAULT_FPP
+#include "util/slice.h"
+
+namespace doris {
+
+class CondColumn;
+class TypeInfo;
+
+namespace segment_v2 {
+
+// This class encode bloom filter of column pages.
+// The binary format is like that
+// Header | Content
+// Header:
+//      number of elements (4 Bytes)
+// Content:
+//      array of bloom_filter
+// bloom_filter:
+//      number of hash functions (varint32)
+//      number of uint64 words of bit set (varint32)
+//      words of bit set (8 Bytes * number of words)
+// Bloom filters are BlockBloomFilter by default, which needs one cache miss
+// for each probe, and its number of hash functions is always 8.
+// NOTE: values are hashed the same way as the legacy bloom filter index, that
+// is the memory of cell for fixed length types and the content of Slice for
+// string types, null is hashed to BLOOM_FILTER_NULL_HASHCODE.
+class ColumnBloomFilterBuilder {
+public:
+    ColumnBloomFilterBuilder(const TypeInfo* type_info, double fpp = BLOOM_FILTER_DEFAULT_FPP,
+                             BloomFilterAlgorithmPB algorithm = BLOCK_BLOOM_FILTER);
+
+    BloomFilterAlgorithmPB algorithm() const { return _algorithm; }
+
+    // add count not-null values to current page's bloom filter
+    void add(const uint8_t* vals, size_t count);
+
+    // add null to current page's bloom filter
+    void add_nulls(size_t count);
+
+    // build bloom filter of current page and start a new page
+    Status flush();
+
+    // serialize all pages' bloom filter
+    Slice finish();
+
+private:
+    const TypeInfo* _type_info;
+    double _fpp;
+    BloomFilterAlgorithmPB _algorithm;
+    // hash values of distinct values in current page, bloom filter is sized
+    // by the number of them when page is flushed
+    std::unordered_set<uint64_t> _page_hashes;
+
+    std::string _buffer;
+    uint32_t _num_pages;
+};
+
+// Read bloom filter of all pages from the bloom filter index page
+class ColumnBloomFilter {
+public:
+    ColumnBloomFilter(const Slice& data, BloomFilterAlgorithmPB algorithm = CLASSIC_BLOOM_FILTER)
+        : _data(data), _algorithm(algorithm), _num_pages(0), _words(nullptr, &free) { }
+
+    Status load();
+
+    int32_t num_pages() const { return _num_pages; }
+
+    // Return true if there may be some values in the page which match cond_column.
+    // Only =, IN and IS NULL conditions can be evaluated by bloom filter, other
+    // conditions are ignored.
+    bool match_condition(int32_t page_index, const CondColumn* cond_column) const;
+
+    // Return true if cond_column has condition which can be evaluated by bloom filter
+    static bool can_evaluate(const CondColumn* cond_column);
+
+private:
+    template<typename BloomFilterType>
+    bool _match_condition(BloomFilterType* bf, const CondColumn* cond_column) const;
+
+    struct PageBloomFilter {
+        uint32_t hash_function_num;
+        // offset and number of words in _words
+        uint32_t offset;
+        uint32_t num_words;
+    };
+
+    Slice _data;
+    BloomFilterAlgorithmPB _algorithm;
+
+    // valid after load
+    int32_t _num_pages;
+    std::vector<PageBloomFilter> _page_bloom_filters;
+    // bit set words of all pages, copied out to make sure they are aligned to
+    // cache line, so that every bucket of BlockBloomFilter is in one cache line
+    std::unique_ptr<uint64_t, decltype(&free)> _words;
+};
+
+} // namespace segment_v2
+} // namespace doris
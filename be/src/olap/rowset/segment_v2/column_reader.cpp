@@ -17,8 +17,13 @@
 
 #include "olap/rowset/segment_v2/column_reader.h"
 
+#include <algorithm> // for std::max
+#include <cstring> // for memset
+
+#include "common/config.h"
 #include "env/env.h" // for RandomAccessFile
 #include "gutil/strings/substitute.h" // for Substitute
+#include "olap/rowset/segment_v2/binary_dict_page.h" // for BinaryDictPageDecoder
 #include "olap/rowset/segment_v2/encoding_info.h" // for EncodingInfo
 #include "olap/rowset/segment_v2/page_decoder.h" // for PagePointer
 #include "olap/rowset/segment_v2/page_handle.h" // for PageHandle
@@ -26,9 +31,14 @@
 #include "olap/rowset/segment_v2/options.h" // for PageDecoderOptions
 #include "olap/types.h" // for TypeInfo
 #include "olap/column_block.h" // for ColumnBlockView
+#include "olap/olap_cond.h" // for CondColumn
 #include "olap/page_cache.h"
+#include "olap/wrapper_field.h" // for WrapperField
 #include "util/coding.h" // for get_varint32
+#include "util/block_compression.h" // for BlockCompressionCodec
+#include "util/doris_metrics.h"
 #include "util/rle_encoding.h" // for RleDecoder
+#include "util/stopwatch.hpp"
 
 namespace doris {
 namespace segment_v2 {
@@ -69,9 +79,11 @@ struct ParsedPage {
 
 ColumnReader::ColumnReader(const ColumnReaderOptions& opts,
                            const ColumnMetaPB& meta,
+                           uint64_t num_rows,
                            RandomAccessFile* file)
         : _opts(opts),
         _meta(meta),
+        _num_rows(num_rows),
         _file(file) {
 }
 
@@ -84,9 +96,20 @@ Status ColumnReader::init() {
         return Status::NotSupported(Substitute("unsupported typeinfo, type=$0", _meta.type()));
     }
     RETURN_IF_ERROR(EncodingInfo::get(_type_info, _meta.encoding(), &_encoding_info));
+    if (_opts.cache_decompressed_page
+            && (_meta.encoding() == BIT_SHUFFLE || _meta.encoding() == FOR_ENCODING)) {
+        // decompressed values of these encodings are in the same format as
+        // PLAIN_ENCODING, types without PLAIN_ENCODING are cached compressed
+        if (!EncodingInfo::get(_type_info, PLAIN_ENCODING, &_decompressed_encoding_info).ok()) {
+            _decompressed_encoding_info = nullptr;
+        }
+    }
 
-    // TODO(zc): do with compress type
     RETURN_IF_ERROR(_init_ordinal_index());
+    RETURN_IF_ERROR(_init_zone_map());
+    RETURN_IF_ERROR(_init_dict());
+    RETURN_IF_ERROR(_init_bloom_filter());
+    RETURN_IF_ERROR(_init_bitmap_index());
 
     return Status::OK();
 }
@@ -100,38 +123,180 @@ Status ColumnReader::read_page(const PagePointer& pp, PageHandle* handle) {
     auto cache = StoragePageCache::instance();
     PageCacheHandle cache_handle;
     StoragePageCache::CacheKey cache_key(_file->file_name(), pp.offset);
-    if (cache->lookup(cache_key, &cache_handle)) {
+    if (cache->lookup(cache_key, &cache_handle, PageCacheType::INDEX_PAGE)) {
         // we find page in cache, use it
         *handle = PageHandle(std::move(cache_handle));
         return Status::OK();
     }
-    // Now we read this from file. we 
-    size_t data_size = pp.size;
-    if (has_checksum() && data_size < sizeof(uint32_t)) {
-        return Status::Corruption("Bad page, page size is too small");
+    std::vector<PageCacheHandle> cache_handles;
+    RETURN_IF_ERROR(_read_pages({pp}, PageCacheType::INDEX_PAGE, &cache_handles));
+    *handle = PageHandle(std::move(cache_handles[0]));
+    return Status::OK();
+}
+
+Status ColumnReader::read_page(const OrdinalPageIndexIterator& iter, PageHandle* handle,
+                               bool* cache_hit, uint64_t* read_end_offset) {
+    auto cache = StoragePageCache::instance();
+    const PagePointer& pp = iter.page();
+    PageCacheHandle cache_handle;
+    if (cache->lookup(StoragePageCache::CacheKey(_file->file_name(), pp.offset), &cache_handle)) {
+        *handle = PageHandle(std::move(cache_handle));
+        if (cache_hit != nullptr) {
+            *cache_hit = true;
+        }
+        return Status::OK();
+    }
+    if (cache_hit != nullptr) {
+        *cache_hit = false;
+    }
+
+    // collect following pages to read ahead, stop at the first page which is
+    // not adjacent to previous one or is already cached
+    std::vector<PagePointer> pages{pp};
+    size_t max_pages = std::max(config::segment_page_read_ahead_num, 1);
+    OrdinalPageIndexIterator next_iter = iter;
+    for (next_iter.next(); next_iter.valid() && pages.size() < max_pages; next_iter.next()) {
+        const PagePointer& next_pp = next_iter.page();
+        const PagePointer& last_pp = pages.back();
+        if (next_pp.offset != last_pp.offset + last_pp.size) {
+            break;
+        }
+        PageCacheHandle next_handle;
+        if (cache->lookup(StoragePageCache::CacheKey(_file->file_name(), next_pp.offset), &next_handle)) {
+            break;
+        }
+        pages.push_back(next_pp);
     }
-    if (has_checksum()) {
-        data_size -= sizeof(uint32_t);
+
+    std::vector<PageCacheHandle> cache_handles;
+    RETURN_IF_ERROR(_read_pages(pages, PageCacheType::DATA_PAGE, &cache_handles));
+    *handle = PageHandle(std::move(cache_handles[0]));
+    if (read_end_offset != nullptr) {
+        *read_end_offset = pages.back().offset + pages.back().size;
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::prefetch_page(rowid_t rowid) {
+    OrdinalPageIndexIterator iter;
+    RETURN_IF_ERROR(seek_at_or_before(rowid, &iter));
+    const PagePointer& pp = iter.page();
+    PageCacheHandle cache_handle;
+    if (StoragePageCache::instance()->lookup(
+            StoragePageCache::CacheKey(_file->file_name(), pp.offset), &cache_handle)) {
+        return Status::OK();
+    }
+    return _file->prefetch(pp.offset, pp.size);
+}
+
+bool ColumnReader::lookup_decompressed_page(const PagePointer& pp, PageHandle* handle) {
+    PageCacheHandle cache_handle;
+    StoragePageCache::CacheKey cache_key(_file->file_name(), pp.offset);
+    if (!StoragePageCache::instance()->lookup(
+            cache_key, &cache_handle, PageCacheType::DECOMPRESSED_DATA_PAGE)) {
+        return false;
     }
-    uint8_t* buf = new uint8_t[data_size];
-    Slice data(buf, data_size);
+    *handle = PageHandle(std::move(cache_handle));
+    return true;
+}
 
-    uint8_t checksum_buf[sizeof(uint32_t)];
-    Slice slices[2] = { data, Slice(checksum_buf, 4) };
+void ColumnReader::insert_decompressed_page(const PagePointer& pp, const Slice& data,
+                                            PageHandle* handle) {
+    PageCacheHandle cache_handle;
+    StoragePageCache::CacheKey cache_key(_file->file_name(), pp.offset);
+    StoragePageCache::instance()->insert(
+        cache_key, data, &cache_handle, PageCacheType::DECOMPRESSED_DATA_PAGE);
+    *handle = PageHandle(std::move(cache_handle));
+}
 
+Status ColumnReader::_read_pages(const std::vector<PagePointer>& pages, PageCacheType type,
+                                 std::vector<PageCacheHandle>* handles) {
+    // Pages are adjacent in file, so they are read by one readv_at. Checksum of
+    // a page must be read to reach the next page, except the last one.
+    std::vector<std::unique_ptr<uint8_t[]>> bufs;
+    std::vector<Slice> data_slices;
+    std::vector<Slice> slices;
+    std::vector<uint8_t> checksum_bufs(pages.size() * sizeof(uint32_t));
     bool verify_checksum = has_checksum() && _opts.verify_checksum;
-    RETURN_IF_ERROR(_file->readv_at(pp.offset, slices, verify_checksum ? 2 : 1));
+    for (size_t i = 0; i < pages.size(); ++i) {
+        size_t data_size = pages[i].size;
+        if (has_checksum() && data_size < sizeof(uint32_t)) {
+            return Status::Corruption("Bad page, page size is too small");
+        }
+        if (has_checksum()) {
+            data_size -= sizeof(uint32_t);
+        }
+        bufs.emplace_back(new uint8_t[data_size]);
+        data_slices.emplace_back(bufs.back().get(), data_size);
+        slices.push_back(data_slices.back());
+        if (has_checksum() && (i + 1 < pages.size() || verify_checksum)) {
+            slices.emplace_back(&checksum_bufs[i * sizeof(uint32_t)], sizeof(uint32_t));
+        }
+    }
+    MonotonicStopWatch watch;
+    watch.start();
+    RETURN_IF_ERROR(_file->readv_at(pages[0].offset, slices.data(), slices.size()));
+    DorisMetrics::page_read_latency_us.add(watch.elapsed_time() / 1000);
 
     if (verify_checksum) {
         // TODO(zc): verify checksum
     }
 
-    // TODO(zc): compress
-    
-    // insert this into cache and return the cache handle
-    cache->insert(cache_key, data, &cache_handle);
-    *handle = PageHandle(std::move(cache_handle));
+    if (has_compressed_pages()) {
+        for (size_t i = 0; i < pages.size(); ++i) {
+            RETURN_IF_ERROR(_decompress_page(&bufs[i], &data_slices[i]));
+        }
+    }
 
+    // insert pages into cache and return the cache handles
+    auto cache = StoragePageCache::instance();
+    handles->resize(pages.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        StoragePageCache::CacheKey cache_key(_file->file_name(), pages[i].offset);
+        // page cache takes the ownership of data
+        bufs[i].release();
+        cache->insert(cache_key, data_slices[i], &(*handles)[i], type,
+                      i == 0 ? CachePriority::NORMAL : CachePriority::PREFETCH);
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::_decompress_page(std::unique_ptr<uint8_t[]>* buf, Slice* data) {
+    static const size_t trailer_size = sizeof(uint32_t) + 1;
+    if (data->size < trailer_size) {
+        return Status::Corruption("Bad page, page size is too small for compression trailer");
+    }
+    data->size -= trailer_size;
+    const uint8_t* trailer = (const uint8_t*)data->data + data->size;
+    uint32_t uncompressed_size = decode_fixed32_le(trailer);
+    uint8_t type = trailer[sizeof(uint32_t)];
+    if (type == NO_COMPRESSION) {
+        if (uncompressed_size != data->size) {
+            return Status::Corruption(
+                Substitute("Bad page, size $0 is not equal to uncompressed size $1",
+                           data->size, uncompressed_size));
+        }
+        return Status::OK();
+    }
+
+    BlockCompressionCodec* codec = nullptr;
+    if (!CompressionTypePB_IsValid(type)) {
+        return Status::Corruption(Substitute("Bad page, unknown compression type $0", type));
+    }
+    RETURN_IF_ERROR(get_block_compression_codec((CompressionTypePB)type, &codec));
+    if (codec == nullptr) {
+        return Status::Corruption(Substitute("Bad page, invalid compression type $0", type));
+    }
+    std::unique_ptr<uint8_t[]> decompressed_buf(new uint8_t[uncompressed_size]);
+    Slice decompressed(decompressed_buf.get(), uncompressed_size);
+    RETURN_IF_ERROR(codec->decompress(*data, &decompressed));
+    if (decompressed.size != uncompressed_size) {
+        return Status::Corruption(
+            Substitute("Bad page, decompressed size $0 is not equal to $1",
+                       decompressed.size, uncompressed_size));
+    }
+    *buf = std::move(decompressed_buf);
+    *data = decompressed;
     return Status::OK();
 }
 
@@ -147,6 +312,152 @@ Status ColumnReader::_init_ordinal_index() {
     return Status::OK();
 }
 
+Status ColumnReader::_init_zone_map() {
+    if (!_meta.has_zone_map_page()) {
+        return Status::OK();
+    }
+    PagePointer pp = _meta.zone_map_page();
+    PageHandle ph;
+    RETURN_IF_ERROR(read_page(pp, &ph));
+
+    // zone maps are copied out when loading, so we don't need to hold the page
+    _column_zone_map.reset(new ColumnZoneMap(ph.data()));
+    RETURN_IF_ERROR(_column_zone_map->load());
+    if (_column_zone_map->num_pages() != _ordinal_index->num_pages()) {
+        return Status::Corruption(
+            Substitute("Bad zone map, number of zone maps $0 is not equal to number of pages $1",
+                       _column_zone_map->num_pages(), _ordinal_index->num_pages()));
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::_init_bloom_filter() {
+    if (!_meta.has_bloom_filter_page()) {
+        return Status::OK();
+    }
+    PagePointer pp = _meta.bloom_filter_page();
+    PageHandle ph;
+    RETURN_IF_ERROR(read_page(pp, &ph));
+
+    // bloom filters are copied out when loading, so we don't need to hold the page
+    _column_bloom_filter.reset(new ColumnBloomFilter(ph.data(), _meta.bloom_filter_algorithm()));
+    RETURN_IF_ERROR(_column_bloom_filter->load());
+    if (_column_bloom_filter->num_pages() != _ordinal_index->num_pages()) {
+        return Status::Corruption(
+            Substitute("Bad bloom filter, number of bloom filters $0 is not equal to number of pages $1",
+                       _column_bloom_filter->num_pages(), _ordinal_index->num_pages()));
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::_init_bitmap_index() {
+    if (!_meta.has_bitmap_index_page()) {
+        return Status::OK();
+    }
+    PagePointer pp = _meta.bitmap_index_page();
+    RETURN_IF_ERROR(read_page(pp, &_bitmap_index_page_handle));
+
+    _column_bitmap_index.reset(new ColumnBitmapIndex(_type_info, _bitmap_index_page_handle.data()));
+    RETURN_IF_ERROR(_column_bitmap_index->load());
+    return Status::OK();
+}
+
+Status ColumnReader::_init_dict() {
+    if (_encoding_info->encoding() != DICT_ENCODING) {
+        return Status::OK();
+    }
+    if (!_meta.has_dict_page()) {
+        return Status::Corruption("Bad column meta, dictionary page is missing");
+    }
+    PagePointer pp = _meta.dict_page();
+    RETURN_IF_ERROR(read_page(pp, &_dict_page_handle));
+
+    PageDecoderOptions options;
+    _dict_decoder.reset(new BinaryPlainPageDecoder(_dict_page_handle.data(), options));
+    RETURN_IF_ERROR(_dict_decoder->init());
+    return Status::OK();
+}
+
+Status ColumnReader::get_row_ranges_by_zone_map(const TabletColumn& column,
+                                                const CondColumn* cond_column,
+                                                RowRanges* row_ranges) {
+    if (cond_column == nullptr || _column_zone_map == nullptr) {
+        *row_ranges = RowRanges::create_single(_num_rows);
+        return Status::OK();
+    }
+    std::unique_ptr<WrapperField> min_value(WrapperField::create(column));
+    std::unique_ptr<WrapperField> max_value(WrapperField::create(column));
+    if (min_value == nullptr || max_value == nullptr) {
+        return Status::InternalError(
+            Substitute("Failed to create field to evaluate zone map, type=$0", column.type()));
+    }
+
+    // first check the segment zone map, if it's not matched, we can skip all the pages
+    if (_meta.has_segment_zone_map()
+            && !ColumnZoneMap::match_condition(_meta.segment_zone_map(), cond_column,
+                                               min_value.get(), max_value.get())) {
+        row_ranges->clear();
+        return Status::OK();
+    }
+
+    std::vector<uint32_t> page_indexes;
+    _get_filtered_pages(cond_column, min_value.get(), max_value.get(), &page_indexes);
+    _calculate_row_ranges(page_indexes, row_ranges);
+    return Status::OK();
+}
+
+Status ColumnReader::get_row_ranges_by_bloom_filter(const CondColumn* cond_column,
+                                                   RowRanges* row_ranges) {
+    if (cond_column == nullptr || _column_bloom_filter == nullptr
+            || !ColumnBloomFilter::can_evaluate(cond_column)) {
+        *row_ranges = RowRanges::create_single(_num_rows);
+        return Status::OK();
+    }
+    std::vector<uint32_t> page_indexes;
+    for (int32_t i = 0; i < _column_bloom_filter->num_pages(); ++i) {
+        if (_column_bloom_filter->match_condition(i, cond_column)) {
+            page_indexes.push_back(i);
+        }
+    }
+    _calculate_row_ranges(page_indexes, row_ranges);
+    return Status::OK();
+}
+
+Status ColumnReader::get_row_bitmap_by_bitmap_index(const CondColumn* cond_column,
+                                                   Roaring* row_bitmap) {
+    if (cond_column == nullptr || _column_bitmap_index == nullptr) {
+        *row_bitmap = Roaring();
+        row_bitmap->addRange(0, _num_rows);
+        return Status::OK();
+    }
+    _column_bitmap_index->get_row_bitmap(cond_column, row_bitmap);
+    return Status::OK();
+}
+
+void ColumnReader::_get_filtered_pages(const CondColumn* cond_column,
+                                       WrapperField* min_value, WrapperField* max_value,
+                                       std::vector<uint32_t>* page_indexes) {
+    auto& zone_maps = _column_zone_map->get_column_zone_map();
+    for (uint32_t i = 0; i < zone_maps.size(); ++i) {
+        if (ColumnZoneMap::match_condition(zone_maps[i], cond_column, min_value, max_value)) {
+            page_indexes->push_back(i);
+        }
+    }
+}
+
+void ColumnReader::_calculate_row_ranges(const std::vector<uint32_t>& page_indexes,
+                                         RowRanges* row_ranges) {
+    row_ranges->clear();
+    for (auto page_index : page_indexes) {
+        rowid_t page_first_id = _ordinal_index->get_first_row_id(page_index);
+        rowid_t page_last_id = _num_rows;
+        if (page_index + 1 < _ordinal_index->num_pages()) {
+            page_last_id = _ordinal_index->get_first_row_id(page_index + 1);
+        }
+        row_ranges->add(RowRange(page_first_id, page_last_id));
+    }
+}
+
 Status ColumnReader::seek_to_first(OrdinalPageIndexIterator* iter) {
     *iter = _ordinal_index->begin();
     if (!iter->valid()) {
@@ -163,6 +474,18 @@ Status ColumnReader::seek_at_or_before(rowid_t rowid, OrdinalPageIndexIterator*
     return Status::OK();
 }
 
+Status ColumnIterator::next_batch_and_evaluate(size_t* n, ColumnBlockView* dst,
+                                               const CondColumn* cond_column,
+                                               uint8_t* selection) {
+    ColumnBlock* block = dst->column_block();
+    size_t first_row = dst->first_row_index();
+    RETURN_IF_ERROR(next_batch(n, dst));
+    for (size_t i = 0; i < *n; ++i) {
+        selection[i] = cond_column->eval(block->cell(first_row + i));
+    }
+    return Status::OK();
+}
+
 FileColumnIterator::FileColumnIterator(ColumnReader* reader) : _reader(reader) {
 }
 
@@ -196,6 +519,13 @@ Status FileColumnIterator::seek_to_ordinal(rowid_t rid) {
     return Status::OK();
 }
 
+Status FileColumnIterator::prefetch(rowid_t rid) {
+    if (_page != nullptr && _page->contains(rid)) {
+        return Status::OK();
+    }
+    return _reader->prefetch_page(rid);
+}
+
 void FileColumnIterator::_seek_to_pos_in_page(ParsedPage* page, uint32_t offset_in_page) {
     if (page->offset_in_page == offset_in_page) {
         // fast path, do nothing
@@ -224,8 +554,8 @@ void FileColumnIterator::_seek_to_pos_in_page(ParsedPage* page, uint32_t offset_
     page->offset_in_page = offset_in_page;
 }
 
-Status FileColumnIterator::next_batch(size_t* n, ColumnBlock* dst) {
-    ColumnBlockView column_view(dst);
+Status FileColumnIterator::next_batch(size_t* n, ColumnBlockView* dst) {
+    ColumnBlockView& column_view = *dst;
     size_t remaining = *n;
     while (remaining > 0) {
         if (!_page->has_remaining()) {
@@ -284,6 +614,92 @@ Status FileColumnIterator::next_batch(size_t* n, ColumnBlock* dst) {
     return Status::OK();
 }
 
+Status FileColumnIterator::next_batch_and_evaluate(size_t* n, ColumnBlockView* dst,
+                                                   const CondColumn* cond_column,
+                                                   uint8_t* selection) {
+    if (_reader->dict_decoder() == nullptr) {
+        return ColumnIterator::next_batch_and_evaluate(n, dst, cond_column, selection);
+    }
+    _init_dict_filter(cond_column);
+
+    ColumnBlockView& column_view = *dst;
+    size_t remaining = *n;
+    while (remaining > 0) {
+        if (!_page->has_remaining()) {
+            bool eos = false;
+            RETURN_IF_ERROR(_load_next_page(&eos));
+            if (eos) {
+                break;
+            }
+        }
+        auto decoder = static_cast<BinaryDictPageDecoder*>(_page->data_decoder);
+
+        // number of rows to be read from this page
+        size_t nrows_in_page = std::min(remaining, _page->remaining());
+        size_t nrows_to_read = nrows_in_page;
+        while (nrows_to_read > 0) {
+            bool is_null = false;
+            size_t this_run = nrows_to_read;
+            if (_reader->is_nullable()) {
+                this_run = _page->null_decoder.GetNextRun(&is_null, nrows_to_read);
+            }
+            // null bits should be set before evaluating cells
+            if (column_view.is_nullable()) {
+                column_view.set_null_bits(this_run, is_null);
+            }
+
+            // we use num_rows only for CHECK
+            size_t num_rows = this_run;
+            if (is_null) {
+                memset(selection, _null_selected, this_run);
+            } else if (decoder->is_dict_encoding()) {
+                RETURN_IF_ERROR(decoder->next_batch_with_dict_filter(
+                        &num_rows, &column_view, _dict_filter.data(), selection));
+                DCHECK_EQ(this_run, num_rows);
+            } else {
+                // this page is plain encoded because dictionary is full
+                RETURN_IF_ERROR(decoder->next_batch(&num_rows, &column_view));
+                DCHECK_EQ(this_run, num_rows);
+                ColumnBlock* block = column_view.column_block();
+                for (size_t i = 0; i < this_run; ++i) {
+                    selection[i] = cond_column->eval(
+                        block->cell(column_view.first_row_index() + i));
+                }
+            }
+
+            selection += this_run;
+            nrows_to_read -= this_run;
+            _page->offset_in_page += this_run;
+            column_view.advance(this_run);
+            _current_rowid += this_run;
+        }
+        remaining -= nrows_in_page;
+    }
+    *n -= remaining;
+    return Status::OK();
+}
+
+void FileColumnIterator::_init_dict_filter(const CondColumn* cond_column) {
+    if (_dict_filter_cond == cond_column) {
+        return;
+    }
+    const TypeInfo* type_info = _reader->type_info();
+    auto& dict_decoder = _reader->dict_decoder();
+    size_t dict_size = dict_decoder->count();
+    _dict_filter.resize(dict_size);
+    for (size_t i = 0; i < dict_size; ++i) {
+        Slice item = dict_decoder->string_at_index(i);
+        ColumnBlock block(type_info, (uint8_t*)&item, nullptr, nullptr);
+        _dict_filter[i] = cond_column->eval(block.cell(0));
+    }
+
+    Slice null_item;
+    uint8_t null_bitmap = 0xFF;
+    ColumnBlock null_block(type_info, (uint8_t*)&null_item, &null_bitmap, nullptr);
+    _null_selected = cond_column->eval(null_block.cell(0));
+    _dict_filter_cond = cond_column;
+}
+
 Status FileColumnIterator::_load_next_page(bool* eos) {
     _page_iter.next();
     if (!_page_iter.valid()) {
@@ -301,8 +717,43 @@ Status FileColumnIterator::_load_next_page(bool* eos) {
 // it ready to read
 Status FileColumnIterator::_read_page(const OrdinalPageIndexIterator& iter, ParsedPage* page) {
     page->page_pointer = iter.page();
-    RETURN_IF_ERROR(_reader->read_page(page->page_pointer, &page->page_handle));
-    // TODO(zc): read page from file
+    const EncodingInfo* decompressed_encoding_info = _reader->decompressed_encoding_info();
+    if (decompressed_encoding_info != nullptr
+            && _reader->lookup_decompressed_page(page->page_pointer, &page->page_handle)) {
+        if (_opts.page_cache_stats != nullptr) {
+            _opts.page_cache_stats->decompressed_page_cache_hit++;
+            _opts.page_cache_stats->page_cache_hit_bytes += page->page_pointer.size;
+        }
+        return _parse_page(decompressed_encoding_info, page);
+    }
+
+    bool cache_hit = false;
+    uint64_t read_end_offset = 0;
+    RETURN_IF_ERROR(_reader->read_page(iter, &page->page_handle, &cache_hit, &read_end_offset));
+    bool read_ahead = page->page_pointer.offset > _read_ahead_begin
+        && page->page_pointer.offset < _read_ahead_end;
+    if (!cache_hit) {
+        _read_ahead_begin = page->page_pointer.offset;
+        _read_ahead_end = read_end_offset;
+    }
+    if (_opts.page_cache_stats != nullptr) {
+        if (cache_hit) {
+            _opts.page_cache_stats->page_cache_hit++;
+            _opts.page_cache_stats->page_cache_hit_bytes += page->page_pointer.size;
+        } else {
+            _opts.page_cache_stats->page_cache_miss++;
+            _opts.page_cache_stats->page_cache_miss_bytes += page->page_pointer.size;
+        }
+    }
+    RETURN_IF_ERROR(_parse_page(_reader->encoding_info(), page));
+    // page found in cache is read again, so it's hot and worth caching decompressed
+    if (decompressed_encoding_info != nullptr && cache_hit && !read_ahead) {
+        RETURN_IF_ERROR(_cache_decompressed_page(page));
+    }
+    return Status::OK();
+}
+
+Status FileColumnIterator::_parse_page(const EncodingInfo* encoding_info, ParsedPage* page) {
     Slice data = page->page_handle.data();
 
     // decode first rowid
@@ -331,7 +782,10 @@ Status FileColumnIterator::_read_page(const OrdinalPageIndexIterator& iter, Pars
 
     // create page data decoder
     PageDecoderOptions options;
-    RETURN_IF_ERROR(_reader->encoding_info()->create_page_decoder(data, options, &page->data_decoder));
+    options.dict_decoder = _reader->dict_decoder();
+    delete page->data_decoder;
+    page->data_decoder = nullptr;
+    RETURN_IF_ERROR(encoding_info->create_page_decoder(data, options, &page->data_decoder));
     RETURN_IF_ERROR(page->data_decoder->init());
 
     page->offset_in_page = 0;
@@ -339,5 +793,102 @@ Status FileColumnIterator::_read_page(const OrdinalPageIndexIterator& iter, Pars
     return Status::OK();
 }
 
+// Decompressed page has the same layout with data page, except that values
+// are in the format of PLAIN_ENCODING page.
+Status FileColumnIterator::_cache_decompressed_page(ParsedPage* page) {
+    size_t num_values = page->data_decoder->count();
+    size_t values_size = num_values * _reader->type_info()->size();
+
+    faststring buf;
+    put_varint32(&buf, page->first_rowid);
+    put_varint32(&buf, page->num_rows);
+    if (_reader->is_nullable()) {
+        put_varint32(&buf, page->null_bitmap.size);
+        buf.append(page->null_bitmap.data, page->null_bitmap.size);
+    }
+    put_fixed32_le(&buf, num_values);
+    size_t values_offset = buf.size();
+    buf.resize(values_offset + values_size);
+    if (num_values > 0) {
+        ColumnBlock block(_reader->type_info(), &buf[values_offset], nullptr, nullptr);
+        ColumnBlockView dst(&block);
+        size_t n = num_values;
+        RETURN_IF_ERROR(page->data_decoder->next_batch(&n, &dst));
+        if (n != num_values) {
+            return Status::Corruption(
+                Substitute("Bad page, decode $0 values, expected $1", n, num_values));
+        }
+    }
+
+    size_t size = buf.size();
+    Slice data(buf.release(), size);
+    _reader->insert_decompressed_page(page->page_pointer, data, &page->page_handle);
+    return _parse_page(_reader->decompressed_encoding_info(), page);
+}
+
+Status DefaultValueIterator::init(const ColumnIteratorOptions& opts) {
+    RETURN_IF_ERROR(ColumnIterator::init(opts));
+    _type_info = get_type_info(_type);
+    if (_type_info == nullptr) {
+        return Status::NotSupported(Substitute("unsupported type for default value, type=$0", _type));
+    }
+    // be consistent with SchemaChangeHandler::_init_column_mapping()
+    if (!_has_default_value) {
+        _default_value.clear();
+    }
+    if (_is_nullable && _default_value.empty()) {
+        _is_default_value_null = true;
+        return Status::OK();
+    }
+
+    _value.reset(new char[_type_info->size()]);
+    memset(_value.get(), 0, _type_info->size());
+    if (_type == OLAP_FIELD_TYPE_CHAR || _type == OLAP_FIELD_TYPE_VARCHAR) {
+        // CHAR is padded with 0 to its schema length
+        size_t buf_len = std::max(_schema_length, _default_value.length());
+        _string_buf.reset(new char[buf_len]);
+        memset(_string_buf.get(), 0, buf_len);
+        Slice* slice = reinterpret_cast<Slice*>(_value.get());
+        slice->data = _string_buf.get();
+        slice->size = _type == OLAP_FIELD_TYPE_CHAR ? _schema_length : buf_len;
+    }
+    if (_type_info->from_string(_value.get(), _default_value) != OLAP_SUCCESS) {
+        return Status::InternalError(Substitute("invalid default value, value=$0", _default_value));
+    }
+    return Status::OK();
+}
+
+Status DefaultValueIterator::next_batch(size_t* n, ColumnBlockView* dst) {
+    if (_is_default_value_null) {
+        dst->set_null_bits(*n, true);
+    } else {
+        if (dst->is_nullable()) {
+            dst->set_null_bits(*n, false);
+        }
+        const size_t cell_size = _type_info->size();
+        char* cell = reinterpret_cast<char*>(dst->data());
+        if (_type == OLAP_FIELD_TYPE_CHAR || _type == OLAP_FIELD_TYPE_VARCHAR) {
+            // copy the content to arena once, and all cells refer to it
+            Slice value = *reinterpret_cast<const Slice*>(_value.get());
+            char* data = dst->arena()->Allocate(value.size);
+            if (data == nullptr) {
+                return Status::MemoryAllocFailed("failed to allocate default value");
+            }
+            memcpy(data, value.data, value.size);
+            value.data = data;
+            for (size_t i = 0; i < *n; ++i) {
+                memcpy(cell + i * cell_size, &value, sizeof(Slice));
+            }
+        } else {
+            for (size_t i = 0; i < *n; ++i) {
+                memcpy(cell + i * cell_size, _value.get(), cell_size);
+            }
+        }
+    }
+    dst->advance(*n);
+    _current_rowid += *n;
+    return Status::OK();
+}
+
 }
 }
@@ -20,29 +20,50 @@
 #include <cstdint> // for uint32_t
 #include <cstddef> // for size_t
 #include <memory> // for unique_ptr
+#include <string>
+#include <vector>
 
 #include "common/status.h" // for Status
 #include "gen_cpp/segment_v2.pb.h" // for ColumnMetaPB
+#include "olap/column_block.h" // for ColumnBlockView
+#include "olap/olap_common.h" // for ColumnPageCacheStatistics
 #include "olap/rowset/segment_v2/common.h" // for rowid_t
+#include "olap/rowset/segment_v2/column_bitmap_index.h" // for ColumnBitmapIndex
+#include "olap/rowset/segment_v2/column_bloom_filter.h" // for ColumnBloomFilter
+#include "olap/rowset/segment_v2/column_zone_map.h" // for ColumnZoneMap
 #include "olap/rowset/segment_v2/ordinal_page_index.h" // for OrdinalPageIndexIterator
+#include "olap/rowset/segment_v2/page_handle.h" // for PageHandle
+#include "olap/rowset/segment_v2/row_ranges.h" // for RowRanges
 
 namespace doris {
 
-class ColumnBlock;
 class Arena;
+class CondColumn;
 class RandomAccessFile;
+class TabletColumn;
 class TypeInfo;
+class WrapperField;
 
 namespace segment_v2 {
 
+class BinaryPlainPageDecoder;
 class EncodingInfo;
-class PageHandle;
 class PagePointer;
 class ParsedPage;
 class ColumnIterator;
 
 struct ColumnReaderOptions {
     bool verify_checksum = false;
+    // If true, data pages of fixed length columns encoded by BIT_SHUFFLE or
+    // FOR_ENCODING are cached in decompressed form when they are found in page
+    // cache, so that reading hot pages again needs no decompression. Cold pages
+    // which are read only once are cached in compressed form.
+    bool cache_decompressed_page = false;
+};
+
+struct ColumnIteratorOptions {
+    // If not null, page cache hit/miss of the column is added into it
+    ColumnPageCacheStatistics* page_cache_stats = nullptr;
 };
 
 // Used to read one column's data. And user should pass ColumnData meta
@@ -53,7 +74,8 @@ struct ColumnReaderOptions {
 // This will cache data shared by all reader
 class ColumnReader {
 public:
-    ColumnReader(const ColumnReaderOptions& opts, const ColumnMetaPB& meta, RandomAccessFile* file);
+    ColumnReader(const ColumnReaderOptions& opts, const ColumnMetaPB& meta,
+                 uint64_t num_rows, RandomAccessFile* file);
     ~ColumnReader();
 
     Status init();
@@ -65,16 +87,88 @@ public:
     Status seek_to_first(OrdinalPageIndexIterator* iter);
     Status seek_at_or_before(rowid_t rowid, OrdinalPageIndexIterator* iter);
 
-    // read a page from file into a page handle
+    // read an index page, such as ordinal index or zone map page, from file
+    // into a page handle. dict page is cached as index page too.
     Status read_page(const PagePointer& pp, PageHandle* handle);
 
+    // Read the data page iter points to. If the page is not in page cache, at most
+    // config::segment_page_read_ahead_num - 1 following pages, which are adjacent
+    // in file and not cached, are read by the same IO and inserted into page cache.
+    // If cache_hit is not null, it's set to true if the page is found in page cache.
+    // If read_end_offset is not null and the page is read from file, it's set to the
+    // end offset of the last page read, pages before it are read ahead.
+    Status read_page(const OrdinalPageIndexIterator& iter, PageHandle* handle,
+                     bool* cache_hit = nullptr, uint64_t* read_end_offset = nullptr);
+
+    // Start reading the data page containing rowid from file without waiting
+    // for it, if the page is not in page cache.
+    Status prefetch_page(rowid_t rowid);
+
+    // Encoding info to decode pages cached in decompressed form, null if pages of
+    // this column are not cached in decompressed form.
+    const EncodingInfo* decompressed_encoding_info() const { return _decompressed_encoding_info; }
+    // Lookup the decompressed form of data page pp in page cache
+    bool lookup_decompressed_page(const PagePointer& pp, PageHandle* handle);
+    // Insert the decompressed form of data page pp into page cache, page cache
+    // takes the ownership of data.
+    void insert_decompressed_page(const PagePointer& pp, const Slice& data, PageHandle* handle);
+
     bool is_nullable() const { return _meta.is_nullable(); }
     bool has_checksum() const { return _meta.has_checksum(); }
+    // whether every page ends with its uncompressed size and compression type
+    bool has_compressed_pages() const {
+        return _meta.has_compression() && _meta.compression() != NO_COMPRESSION;
+    }
     const EncodingInfo* encoding_info() const { return _encoding_info; }
     const TypeInfo* type_info() const { return _type_info; }
 
+    bool has_zone_map() const { return _meta.has_zone_map_page(); }
+
+    // decoder of dictionary page, null if this column is not dictionary encoded
+    const std::shared_ptr<BinaryPlainPageDecoder>& dict_decoder() const { return _dict_decoder; }
+
+    // Get the row ranges of this column which may satisfy the input condition
+    // according to the segment and page zone maps. If this column has no zone
+    // map, all rows will be returned. column is the schema of this column.
+    Status get_row_ranges_by_zone_map(const TabletColumn& column,
+                                      const CondColumn* cond_column,
+                                      RowRanges* row_ranges);
+
+    bool has_bloom_filter() const { return _meta.has_bloom_filter_page(); }
+
+    // Get the row ranges of this column which may satisfy the input condition
+    // according to the page bloom filters. Only =, IN and IS NULL conditions
+    // are used, if there is no such condition or no bloom filter, all rows
+    // will be returned.
+    Status get_row_ranges_by_bloom_filter(const CondColumn* cond_column, RowRanges* row_ranges);
+
+    bool has_bitmap_index() const { return _meta.has_bitmap_index_page(); }
+
+    // Get the rows of this column which satisfy the input condition according
+    // to the bitmap index. Different from zone map and bloom filter, the result
+    // is exact. If this column has no bitmap index, all rows will be returned.
+    Status get_row_bitmap_by_bitmap_index(const CondColumn* cond_column, Roaring* row_bitmap);
+
 private:
+    // read pages which are adjacent in file by one IO into page cache, pages
+    // except the first one are inserted as prefetched pages
+    Status _read_pages(const std::vector<PagePointer>& pages, PageCacheType type,
+                       std::vector<PageCacheHandle>* handles);
+
+    // strip the trailer of a page read from file, and decompress its data
+    // into a new buffer if it is compressed
+    Status _decompress_page(std::unique_ptr<uint8_t[]>* buf, Slice* data);
+
     Status _init_ordinal_index();
+    Status _init_zone_map();
+    Status _init_dict();
+    Status _init_bloom_filter();
+    Status _init_bitmap_index();
+
+    void _get_filtered_pages(const CondColumn* cond_column,
+                             WrapperField* min_value, WrapperField* max_value,
+                             std::vector<uint32_t>* page_indexes);
+    void _calculate_row_ranges(const std::vector<uint32_t>& page_indexes, RowRanges* row_ranges);
 
 private:
     // input param
@@ -82,13 +176,32 @@ private:
     // we need colun data to parse column data.
     // use shared_ptr here is to make things simple
     ColumnMetaPB _meta;
+    uint64_t _num_rows;
     RandomAccessFile* _file = nullptr;
 
     const TypeInfo* _type_info = nullptr;
     const EncodingInfo* _encoding_info = nullptr;
+    // PLAIN_ENCODING info of this type if pages are cached in decompressed form
+    const EncodingInfo* _decompressed_encoding_info = nullptr;
 
     // get page pointer from index
     std::unique_ptr<OrdinalPageIndex> _ordinal_index;
+
+    // zone map of every page, null if this column has no zone map
+    std::unique_ptr<ColumnZoneMap> _column_zone_map;
+
+    // bloom filter of every page, null if this column has no bloom filter
+    std::unique_ptr<ColumnBloomFilter> _column_bloom_filter;
+
+    // bitmap index of this column, null if this column has no bitmap index.
+    // _bitmap_index_page_handle is held because _column_bitmap_index references its data
+    PageHandle _bitmap_index_page_handle;
+    std::unique_ptr<ColumnBitmapIndex> _column_bitmap_index;
+
+    // dictionary shared by all data pages of a dictionary encoded column,
+    // _dict_page_handle is held because _dict_decoder references its data
+    PageHandle _dict_page_handle;
+    std::shared_ptr<BinaryPlainPageDecoder> _dict_decoder;
 };
 
 // Base iterator to read one column data
@@ -97,6 +210,11 @@ public:
     ColumnIterator() { }
     virtual ~ColumnIterator() { }
 
+    virtual Status init(const ColumnIteratorOptions& opts) {
+        _opts = opts;
+        return Status::OK();
+    }
+
     // Seek to the first entry in the column.
     virtual Status seek_to_first() = 0;
 
@@ -106,14 +224,35 @@ public:
     // then returns false.
     virtual Status seek_to_ordinal(rowid_t ord_idx) = 0;
 
+    // Hint that this iterator is going to seek to ord_idx, so that data can be
+    // read in advance without blocking. Default implementation does nothing.
+    virtual Status prefetch(rowid_t ord_idx) { return Status::OK(); }
+
     // After one seek, we can call this function many times to read data 
     // into ColumnBlock. when read string type data, memory will allocated
     // from Arena
-    virtual Status next_batch(size_t* n, ColumnBlock* dst) = 0;
+    Status next_batch(size_t* n, ColumnBlock* dst) {
+        ColumnBlockView column_view(dst);
+        return next_batch(n, &column_view);
+    }
+
+    // Same as above, but data will be read into dst from its current offset.
+    // dst will be advanced for the rows that have been read.
+    virtual Status next_batch(size_t* n, ColumnBlockView* dst) = 0;
+
+    // Same as above, and evaluate cond_column on the rows read. selection should have
+    // space for n bytes, selection[i] is set to 1 if the i-th row satisfies cond_column,
+    // otherwise 0. Data of rows which are not selected may not be materialized.
+    // Default implementation reads all data and evaluates cond_column on every cell.
+    virtual Status next_batch_and_evaluate(size_t* n, ColumnBlockView* dst,
+                                           const CondColumn* cond_column, uint8_t* selection);
 
     // Get current oridinal
     virtual rowid_t get_current_oridinal() const = 0;
 
+protected:
+    ColumnIteratorOptions _opts;
+
 #if 0
     // Call this function every time before next_batch.
     // This function will preload pages from disk into memory if necessary.
@@ -134,10 +273,50 @@ public:
 #endif
 };
 
-#if 0
+// This iterator is used to read a column which is not in the segment, e.g. a value
+// column added by linked schema change after the segment was written. All rows are
+// the default value of the column, or null if it has no default value.
 class DefaultValueIterator : public ColumnIterator {
+public:
+    DefaultValueIterator(bool has_default_value, const std::string& default_value,
+                         bool is_nullable, FieldType type, size_t schema_length)
+        : _has_default_value(has_default_value),
+          _default_value(default_value),
+          _is_nullable(is_nullable),
+          _type(type),
+          _schema_length(schema_length) { }
+
+    Status init(const ColumnIteratorOptions& opts) override;
+
+    Status seek_to_first() override {
+        _current_rowid = 0;
+        return Status::OK();
+    }
+
+    Status seek_to_ordinal(rowid_t ord_idx) override {
+        _current_rowid = ord_idx;
+        return Status::OK();
+    }
+
+    using ColumnIterator::next_batch;
+    Status next_batch(size_t* n, ColumnBlockView* dst) override;
+
+    rowid_t get_current_oridinal() const override { return _current_rowid; }
+
+private:
+    bool _has_default_value;
+    std::string _default_value;
+    bool _is_nullable;
+    FieldType _type;
+    size_t _schema_length;
+
+    const TypeInfo* _type_info = nullptr;
+    bool _is_default_value_null = false;
+    // cell of the default value, and the content of it if it is a string
+    std::unique_ptr<char[]> _value;
+    std::unique_ptr<char[]> _string_buf;
+    rowid_t _current_rowid = 0;
 };
-#endif
 
 // This iterator is used to read column data from file
 class FileColumnIterator : public ColumnIterator {
@@ -149,7 +328,15 @@ public:
 
     Status seek_to_ordinal(rowid_t ord_idx) override;
 
-    Status next_batch(size_t* n, ColumnBlock* dst) override;
+    Status prefetch(rowid_t ord_idx) override;
+
+    using ColumnIterator::next_batch;
+    Status next_batch(size_t* n, ColumnBlockView* dst) override;
+
+    // For dictionary encoded column, cond_column is evaluated once for each item
+    // in the dictionary, and rows are filtered by their codewords.
+    Status next_batch_and_evaluate(size_t* n, ColumnBlockView* dst,
+                                   const CondColumn* cond_column, uint8_t* selection) override;
 
     // Get current oridinal
     rowid_t get_current_oridinal() const override { return _current_rowid; }
@@ -158,6 +345,11 @@ private:
     void _seek_to_pos_in_page(ParsedPage* page, uint32_t offset_in_page);
     Status _load_next_page(bool* eos);
     Status _read_page(const OrdinalPageIndexIterator& iter, ParsedPage* page);
+    // parse page data in page_handle, encoding_info is used to create data decoder
+    Status _parse_page(const EncodingInfo* encoding_info, ParsedPage* page);
+    // cache the decompressed form of a parsed page, and parse it again
+    Status _cache_decompressed_page(ParsedPage* page);
+    void _init_dict_filter(const CondColumn* cond_column);
 
 private:
     ColumnReader* _reader;
@@ -174,6 +366,17 @@ private:
 
     // current rowid
     rowid_t _current_rowid = 0;
+
+    // file range of pages read ahead by the last page cache miss of this iterator,
+    // hitting them in page cache doesn't mean they are hot
+    uint64_t _read_ahead_begin = 0;
+    uint64_t _read_ahead_end = 0;
+
+    // result of evaluating _dict_filter_cond on every item of the dictionary,
+    // and on null value
+    const CondColumn* _dict_filter_cond = nullptr;
+    std::vector<uint8_t> _dict_filter;
+    uint8_t _null_selected = 0;
 };
 
 }
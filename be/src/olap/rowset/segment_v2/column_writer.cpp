@@ -17,16 +17,22 @@
 
 #include "olap/rowset/segment_v2/column_writer.h"
 
+#include <algorithm>
 #include <cstddef>
 
+#include "common/config.h"
 #include "common/logging.h" // for LOG
 #include "env/env.h" // for LOG
 #include "gutil/strings/substitute.h" // for Substitute
+#include "olap/rowset/segment_v2/column_bitmap_index.h" // for ColumnBitmapIndexBuilder
+#include "olap/rowset/segment_v2/column_bloom_filter.h" // for ColumnBloomFilterBuilder
+#include "olap/rowset/segment_v2/column_zone_map.h" // for ColumnZoneMapBuilder
 #include "olap/rowset/segment_v2/encoding_info.h" // for EncodingInfo
 #include "olap/rowset/segment_v2/options.h" // for PageBuilderOptions
 #include "olap/rowset/segment_v2/ordinal_page_index.h" // for OrdinalPageIndexBuilder
 #include "olap/rowset/segment_v2/page_builder.h" // for PageBuilder
 #include "olap/types.h" // for TypeInfo
+#include "util/block_compression.h" // for BlockCompressionCodec
 #include "util/faststring.h" // for fastring
 #include "util/rle_encoding.h" // for RleEncoder
 
@@ -35,6 +41,10 @@ namespace segment_v2 {
 
 using strings::Substitute;
 
+// max number of pages stored uncompressed without trying after pages are
+// compressed poorly
+static const uint32_t MAX_PAGES_TO_SKIP_COMPRESSION = 64;
+
 class NullBitmapBuilder {
 public:
     NullBitmapBuilder() : _offset(0), _bitmap_buf(512), _rle_encoder(&_bitmap_buf, 1) { }
@@ -86,9 +96,7 @@ ColumnWriter::~ColumnWriter() {
 
 Status ColumnWriter::init() {
     RETURN_IF_ERROR(EncodingInfo::get(_type_info, _opts.encoding_type, &_encoding_info));
-    if (_opts.compression_type != NO_COMPRESSION) {
-        // TODO(zc):
-    }
+    RETURN_IF_ERROR(get_block_compression_codec(_opts.compression_type, &_codec));
 
     // create page builder
     PageBuilder* page_builder = nullptr;
@@ -107,11 +115,29 @@ Status ColumnWriter::init() {
     if (_is_nullable) {
         _null_bitmap_builder.reset(new NullBitmapBuilder());
     }
+    if (_opts.need_zone_map) {
+        _column_zone_map_builder.reset(new ColumnZoneMapBuilder(_type_info));
+    }
+    if (_opts.need_bloom_filter) {
+        _column_bloom_filter_builder.reset(new ColumnBloomFilterBuilder(_type_info));
+    }
+    if (_opts.need_bitmap_index) {
+        _column_bitmap_index_builder.reset(new ColumnBitmapIndexBuilder(_type_info));
+    }
     return Status::OK();
 }
 
 Status ColumnWriter::append_nulls(size_t num_rows) {
     _null_bitmap_builder->add_run(true, num_rows);
+    if (_opts.need_zone_map) {
+        _column_zone_map_builder->add_nulls(num_rows);
+    }
+    if (_opts.need_bloom_filter) {
+        _column_bloom_filter_builder->add_nulls(num_rows);
+    }
+    if (_opts.need_bitmap_index) {
+        _column_bitmap_index_builder->add_nulls(num_rows);
+    }
     _next_rowid += num_rows;
     return Status::OK();
 }
@@ -128,6 +154,15 @@ Status ColumnWriter::_append_data(const uint8_t** ptr, size_t num_rows) {
     while (remaining > 0) {
         size_t num_written = remaining;
         RETURN_IF_ERROR(_page_builder->add(*ptr, &num_written));
+        if (_opts.need_zone_map) {
+            _column_zone_map_builder->add(*ptr, num_written);
+        }
+        if (_opts.need_bloom_filter) {
+            _column_bloom_filter_builder->add(*ptr, num_written);
+        }
+        if (_opts.need_bitmap_index) {
+            _column_bitmap_index_builder->add(*ptr, num_written);
+        }
 
         bool is_page_full = (num_written < remaining);
         remaining -= num_written;
@@ -139,8 +174,6 @@ Status ColumnWriter::_append_data(const uint8_t** ptr, size_t num_rows) {
             _null_bitmap_builder->add_run(false, num_written);
         }
 
-        // TODO(zc): update statistics for this page
-
         if (is_page_full) {
             RETURN_IF_ERROR(_finish_current_page());
         }
@@ -157,6 +190,15 @@ Status ColumnWriter::append_nullable(
     while ((this_run = null_iter.Next(&is_null)) > 0) {
         if (is_null) {
             _null_bitmap_builder->add_run(true, this_run);
+            if (_opts.need_zone_map) {
+                _column_zone_map_builder->add_nulls(this_run);
+            }
+            if (_opts.need_bloom_filter) {
+                _column_bloom_filter_builder->add_nulls(this_run);
+            }
+            if (_opts.need_bitmap_index) {
+                _column_bitmap_index_builder->add_nulls(this_run);
+            }
             _next_rowid += this_run;
         } else {
             RETURN_IF_ERROR(_append_data(&ptr, this_run));
@@ -175,6 +217,9 @@ Status ColumnWriter::write_data() {
         RETURN_IF_ERROR(_write_data_page(page));
         page = page->next;
     }
+    if (_encoding_info->encoding() == DICT_ENCODING) {
+        RETURN_IF_ERROR(_write_dict_page());
+    }
     // write ordinal index
     // auto slice = _ordinal_index_builer->finish();
     // file->append
@@ -187,6 +232,33 @@ Status ColumnWriter::write_ordinal_index() {
     return _write_physical_page(&slices, &_ordinal_index_pp);
 }
 
+Status ColumnWriter::write_zone_map() {
+    if (!_opts.need_zone_map) {
+        return Status::OK();
+    }
+    Slice data = _column_zone_map_builder->finish();
+    std::vector<Slice> slices{data};
+    return _write_physical_page(&slices, &_zone_map_pp);
+}
+
+Status ColumnWriter::write_bloom_filter() {
+    if (!_opts.need_bloom_filter) {
+        return Status::OK();
+    }
+    Slice data = _column_bloom_filter_builder->finish();
+    std::vector<Slice> slices{data};
+    return _write_physical_page(&slices, &_bloom_filter_pp);
+}
+
+Status ColumnWriter::write_bitmap_index() {
+    if (!_opts.need_bitmap_index) {
+        return Status::OK();
+    }
+    Slice data = _column_bitmap_index_builder->finish();
+    std::vector<Slice> slices{data};
+    return _write_physical_page(&slices, &_bitmap_index_pp);
+}
+
 void ColumnWriter::write_meta(ColumnMetaPB* meta) {
     meta->set_type(_type_info->type());
     meta->set_encoding(_opts.encoding_type);
@@ -194,6 +266,20 @@ void ColumnWriter::write_meta(ColumnMetaPB* meta) {
     meta->set_is_nullable(_is_nullable);
     meta->set_has_checksum(_opts.need_checksum);
     _ordinal_index_pp.to_proto(meta->mutable_ordinal_index_page());
+    if (_encoding_info->encoding() == DICT_ENCODING) {
+        _dict_page_pp.to_proto(meta->mutable_dict_page());
+    }
+    if (_opts.need_zone_map) {
+        _zone_map_pp.to_proto(meta->mutable_zone_map_page());
+        _column_zone_map_builder->fill_segment_zone_map(meta->mutable_segment_zone_map());
+    }
+    if (_opts.need_bloom_filter) {
+        _bloom_filter_pp.to_proto(meta->mutable_bloom_filter_page());
+        meta->set_bloom_filter_algorithm(_column_bloom_filter_builder->algorithm());
+    }
+    if (_opts.need_bitmap_index) {
+        _bitmap_index_pp.to_proto(meta->mutable_bitmap_index_page());
+    }
 }
 
 // write a page into file and update ordinal index
@@ -222,14 +308,48 @@ Status ColumnWriter::_write_data_page(Page* page) {
     return Status::OK();
 }
 
+// write the dictionary page shared by all data pages of this column
+Status ColumnWriter::_write_dict_page() {
+    Slice dict_page;
+    RETURN_IF_ERROR(_page_builder->get_dictionary_page(&dict_page));
+    // memory of dictionary page is released by page builder, we should delete it
+    std::unique_ptr<char[]> dict_page_holder(dict_page.data);
+    std::vector<Slice> origin_data{dict_page};
+    return _write_physical_page(&origin_data, &_dict_page_pp);
+}
+
 // write a physical page in to files
 Status ColumnWriter::_write_physical_page(std::vector<Slice>* origin_data, PagePointer* pp) {
     std::vector<Slice>* output_data = origin_data;
     std::vector<Slice> compressed_data;
-    // TODO(zc): support compress
-    // if (_need_compress) {
-    //     output_data = &compressed_data;
-    // }
+    faststring compressed_buf;
+    uint8_t trailer_buf[sizeof(uint32_t) + 1];
+    if (_codec != nullptr) {
+        size_t uncompressed_size = Slice::compute_total_size(*origin_data);
+        CompressionTypePB page_compression = NO_COMPRESSION;
+        if (_num_pages_to_skip_compression > 0) {
+            --_num_pages_to_skip_compression;
+        } else {
+            compressed_buf.resize(_codec->max_compressed_len(uncompressed_size));
+            Slice compressed_slice(compressed_buf.data(), compressed_buf.size());
+            RETURN_IF_ERROR(_codec->compress(*origin_data, &compressed_slice));
+            size_t max_size = uncompressed_size
+                * (100 - config::segment_v2_compression_min_saving_percent) / 100;
+            if (compressed_slice.size <= max_size) {
+                page_compression = _opts.compression_type;
+                compressed_data.push_back(compressed_slice);
+                output_data = &compressed_data;
+                _num_pages_to_skip_on_poor_ratio = 1;
+            } else {
+                _num_pages_to_skip_compression = _num_pages_to_skip_on_poor_ratio;
+                _num_pages_to_skip_on_poor_ratio = std::min(
+                    _num_pages_to_skip_on_poor_ratio * 2, MAX_PAGES_TO_SKIP_COMPRESSION);
+            }
+        }
+        encode_fixed32_le(trailer_buf, uncompressed_size);
+        trailer_buf[sizeof(uint32_t)] = page_compression;
+        output_data->emplace_back(trailer_buf, sizeof(trailer_buf));
+    }
 
     // checksum
     uint8_t checksum_buf[sizeof(uint32_t)];
@@ -282,6 +402,12 @@ Status ColumnWriter::_finish_current_page() {
         _null_bitmap_builder->release();
         _null_bitmap_builder->reset();
     }
+    if (_opts.need_zone_map) {
+        RETURN_IF_ERROR(_column_zone_map_builder->flush());
+    }
+    if (_opts.need_bloom_filter) {
+        RETURN_IF_ERROR(_column_bloom_filter_builder->flush());
+    }
     // update last first rowid
     _last_first_rowid = _next_rowid;
 
@@ -28,6 +28,7 @@
 
 namespace doris {
 
+class BlockCompressionCodec;
 class TypeInfo;
 class WritableFile;
 
@@ -35,11 +36,23 @@ namespace segment_v2 {
 
 struct ColumnWriterOptions {
     EncodingTypePB encoding_type = DEFAULT_ENCODING;
+    // if it is not NO_COMPRESSION, every page ends with its uncompressed size
+    // and the compression type of this page, because pages compressed poorly
+    // are stored uncompressed
     CompressionTypePB compression_type = NO_COMPRESSION;
     bool need_checksum = false;
     size_t data_page_size = 64 * 1024;
+    // whether to build zone map for every page and the whole segment
+    bool need_zone_map = false;
+    // whether to build bloom filter for every page
+    bool need_bloom_filter = false;
+    // whether to build bitmap index of all rows
+    bool need_bitmap_index = false;
 };
 
+class ColumnBitmapIndexBuilder;
+class ColumnBloomFilterBuilder;
+class ColumnZoneMapBuilder;
 class EncodingInfo;
 class NullBitmapBuilder;
 class OrdinalPageIndexBuilder;
@@ -88,6 +101,9 @@ public:
     // write all data into file
     Status write_data();
     Status write_ordinal_index();
+    Status write_zone_map();
+    Status write_bloom_filter();
+    Status write_bitmap_index();
     void write_meta(ColumnMetaPB* meta);
 
 private:
@@ -127,6 +143,7 @@ private:
     uint32_t _compute_checksum(const std::vector<Slice>& data);
 
     Status _write_data_page(Page* page);
+    Status _write_dict_page();
     Status _write_physical_page(std::vector<Slice>* origin_data, PagePointer* pp);
 private:
     ColumnWriterOptions _opts;
@@ -140,14 +157,26 @@ private:
     rowid_t _next_rowid = 0;
 
     const EncodingInfo* _encoding_info = nullptr;
-    // const CompressionCodec* _codec = nullptr;
-    // TODO(zc): compression type
+    // null if pages are not compressed
+    BlockCompressionCodec* _codec = nullptr;
+    // pages compressed poorly are stored uncompressed, and the following
+    // pages are stored uncompressed without trying, the number of skipped
+    // pages doubles on every poor page until a page is compressed well
+    uint32_t _num_pages_to_skip_compression = 0;
+    uint32_t _num_pages_to_skip_on_poor_ratio = 1;
 
     std::unique_ptr<PageBuilder> _page_builder;
     std::unique_ptr<NullBitmapBuilder> _null_bitmap_builder;
     std::unique_ptr<OrdinalPageIndexBuilder> _ordinal_index_builer;
+    std::unique_ptr<ColumnZoneMapBuilder> _column_zone_map_builder;
+    std::unique_ptr<ColumnBloomFilterBuilder> _column_bloom_filter_builder;
+    std::unique_ptr<ColumnBitmapIndexBuilder> _column_bitmap_index_builder;
 
     PagePointer _ordinal_index_pp;
+    PagePointer _zone_map_pp;
+    PagePointer _dict_page_pp;
+    PagePointer _bloom_filter_pp;
+    PagePointer _bitmap_index_pp;
     uint64_t _written_size = 0;
 };
 
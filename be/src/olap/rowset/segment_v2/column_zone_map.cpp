@@ -0,0 +1,217 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/column_zone_map.h"
+
+#include "olap/olap_cond.h" // for CondColumn
+#include "olap/types.h" // for TypeInfo
+#include "olap/wrapper_field.h" // for WrapperField
+#include "util/coding.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static bool is_slice_type(FieldType type) {
+    return type == OLAP_FIELD_TYPE_CHAR
+        || type == OLAP_FIELD_TYPE_VARCHAR
+        || type == OLAP_FIELD_TYPE_HLL;
+}
+
+ColumnZoneMapBuilder::ColumnZoneMapBuilder(const TypeInfo* type_info)
+        : _type_info(type_info), _num_pages(0) {
+    _segment_zone_map.min_value = _segment_arena.AllocateAligned(_type_info->size());
+    _segment_zone_map.max_value = _segment_arena.AllocateAligned(_type_info->size());
+    _reset_page_zone_map();
+
+    _buffer.reserve(4 * 1024);
+    // reserve space for number of elements
+    _buffer.resize(4);
+}
+
+void ColumnZoneMapBuilder::add(const uint8_t* vals, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    size_t cell_size = _type_info->size();
+    const uint8_t* cell = vals;
+    size_t i = 0;
+    if (!_page_zone_map.has_not_null) {
+        _type_info->copy_with_arena(_page_zone_map.min_value, cell, _page_arena.get());
+        _type_info->copy_with_arena(_page_zone_map.max_value, cell, _page_arena.get());
+        _page_zone_map.has_not_null = true;
+        cell += cell_size;
+        i++;
+    }
+    for (; i < count; ++i, cell += cell_size) {
+        if (_type_info->cmp(_page_zone_map.min_value, cell) > 0) {
+            _type_info->copy_with_arena(_page_zone_map.min_value, cell, _page_arena.get());
+        } else if (_type_info->cmp(_page_zone_map.max_value, cell) < 0) {
+            _type_info->copy_with_arena(_page_zone_map.max_value, cell, _page_arena.get());
+        }
+    }
+}
+
+Status ColumnZoneMapBuilder::flush() {
+    // merge page zone map into segment zone map
+    if (_page_zone_map.has_not_null) {
+        if (!_segment_zone_map.has_not_null) {
+            _type_info->copy_with_arena(_segment_zone_map.min_value,
+                                        _page_zone_map.min_value, &_segment_arena);
+            _type_info->copy_with_arena(_segment_zone_map.max_value,
+                                        _page_zone_map.max_value, &_segment_arena);
+            _segment_zone_map.has_not_null = true;
+        } else {
+            if (_type_info->cmp(_segment_zone_map.min_value, _page_zone_map.min_value) > 0) {
+                _type_info->copy_with_arena(_segment_zone_map.min_value,
+                                            _page_zone_map.min_value, &_segment_arena);
+            }
+            if (_type_info->cmp(_segment_zone_map.max_value, _page_zone_map.max_value) < 0) {
+                _type_info->copy_with_arena(_segment_zone_map.max_value,
+                                            _page_zone_map.max_value, &_segment_arena);
+            }
+        }
+    }
+    if (_page_zone_map.has_null) {
+        _segment_zone_map.has_null = true;
+    }
+
+    ZoneMapPB zone_map_pb;
+    _fill_zone_map_to_pb(_page_zone_map, &zone_map_pb);
+    std::string serialized_zone_map;
+    if (!zone_map_pb.SerializeToString(&serialized_zone_map)) {
+        return Status::InternalError("failed to serialize page zone map");
+    }
+    put_varint32(&_buffer, serialized_zone_map.size());
+    _buffer.append(serialized_zone_map);
+    _num_pages++;
+
+    _reset_page_zone_map();
+    return Status::OK();
+}
+
+Slice ColumnZoneMapBuilder::finish() {
+    // encoded number of elements
+    encode_fixed32_le((uint8_t*)_buffer.data(), _num_pages);
+    return Slice(_buffer);
+}
+
+void ColumnZoneMapBuilder::_reset_page_zone_map() {
+    // min/max values of slice type is allocated from arena, so we rebuild the
+    // arena for each page to avoid holding memory of all pages.
+    _page_arena.reset(new Arena());
+    _page_zone_map.min_value = _page_arena->AllocateAligned(_type_info->size());
+    _page_zone_map.max_value = _page_arena->AllocateAligned(_type_info->size());
+    _page_zone_map.has_null = false;
+    _page_zone_map.has_not_null = false;
+}
+
+void ColumnZoneMapBuilder::_fill_zone_map_to_pb(const ZoneMap& zone_map, ZoneMapPB* to) const {
+    to->set_null_flag(zone_map.has_null);
+    to->set_has_not_null(zone_map.has_not_null);
+    if (!zone_map.has_not_null) {
+        return;
+    }
+    if (is_slice_type(_type_info->type())) {
+        const Slice* min_slice = reinterpret_cast<const Slice*>(zone_map.min_value);
+        const Slice* max_slice = reinterpret_cast<const Slice*>(zone_map.max_value);
+        to->set_min(min_slice->data, min_slice->size);
+        to->set_max(max_slice->data, max_slice->size);
+    } else {
+        to->set_min(zone_map.min_value, _type_info->size());
+        to->set_max(zone_map.max_value, _type_info->size());
+    }
+}
+
+Status ColumnZoneMap::load() {
+    if (_data.size < 4) {
+        return Status::Corruption("Bad zone map page, page size is too small");
+    }
+    const uint8_t* ptr = (const uint8_t*)_data.data;
+    const uint8_t* limit = (const uint8_t*)_data.data + _data.size;
+
+    _num_pages = decode_fixed32_le(ptr);
+    ptr += 4;
+
+    _page_zone_maps.resize(_num_pages);
+    for (int i = 0; i < _num_pages; ++i) {
+        uint32_t length = 0;
+        ptr = decode_varint32_ptr(ptr, limit, &length);
+        if (ptr == nullptr || ptr + length > limit) {
+            return Status::Corruption("Bad zone map page, failed to decode zone map length");
+        }
+        if (!_page_zone_maps[i].ParseFromArray(ptr, length)) {
+            return Status::Corruption("Bad zone map page, failed to parse zone map");
+        }
+        ptr += length;
+    }
+    return Status::OK();
+}
+
+bool ColumnZoneMap::set_field_value(const std::string& value, WrapperField* field) {
+    field->set_not_null();
+    if (field->is_string_type()) {
+        Slice* slice = reinterpret_cast<Slice*>(field->mutable_cell_ptr());
+        slice->data = const_cast<char*>(value.data());
+        slice->size = value.size();
+        return true;
+    }
+    if (value.size() != field->size()) {
+        return false;
+    }
+    memcpy(field->mutable_cell_ptr(), value.data(), value.size());
+    return true;
+}
+
+bool ColumnZoneMap::match_condition(const ZoneMapPB& zone_map,
+                                    const CondColumn* cond_column,
+                                    WrapperField* min_value,
+                                    WrapperField* max_value) {
+    bool has_value = false;
+    for (auto cond : cond_column->conds()) {
+        if (cond->op == OP_IS) {
+            if (cond->operand_field->is_null()) {
+                // IS NULL
+                if (!zone_map.null_flag()) {
+                    return false;
+                }
+            } else if (!zone_map.has_not_null()) {
+                // IS NOT NULL
+                return false;
+            }
+            continue;
+        }
+        // all values in this zone are null, which can't satisfy other conditions
+        if (!zone_map.has_not_null()) {
+            return false;
+        }
+        if (!has_value) {
+            if (!set_field_value(zone_map.min(), min_value)
+                    || !set_field_value(zone_map.max(), max_value)) {
+                // bad zone map, we can't use it to filter data
+                return true;
+            }
+            has_value = true;
+        }
+        if (!cond->eval(std::make_pair(min_value, max_value))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace segment_v2
+} // namespace doris
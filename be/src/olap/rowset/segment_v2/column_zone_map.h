@@ -0,0 +1,137 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "util/arena.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class CondColumn;
+class TypeInfo;
+class WrapperField;
+
+namespace segment_v2 {
+
+struct ZoneMap {
+    // min value of zone, only valid when has_not_null is true
+    char* min_value = nullptr;
+    // max value of zone, only valid when has_not_null is true
+    char* max_value = nullptr;
+
+    // if both has_null and has_not_null is false, means no rows.
+    bool has_null = false;
+    bool has_not_null = false;
+};
+
+// This class encode column pages' zone map.
+// The binary format is like that
+// Header | Content
+// Header:
+//      number of elements (4 Bytes)
+// Content:
+//      array of zone_map_pair
+// zone_map_pair:
+//      length of serialized ZoneMapPB (varint32)
+//      serialized ZoneMapPB
+// NOTE: min and max in ZoneMapPB are stored in the memory format of cell,
+// for string types they are the content of the Slice.
+class ColumnZoneMapBuilder {
+public:
+    explicit ColumnZoneMapBuilder(const TypeInfo* type_info);
+
+    // update current page's zone map with count not-null values
+    void add(const uint8_t* vals, size_t count);
+
+    // update current page's zone map with count null values
+    void add_nulls(size_t count) {
+        _page_zone_map.has_null = true;
+    }
+
+    // finish current page's zone map, merge it into segment's zone map
+    // and start a new page
+    Status flush();
+
+    // serialize all pages' zone map
+    Slice finish();
+
+    // fill segment level zone map
+    void fill_segment_zone_map(ZoneMapPB* to) const {
+        _fill_zone_map_to_pb(_segment_zone_map, to);
+    }
+
+private:
+    void _reset_page_zone_map();
+    void _fill_zone_map_to_pb(const ZoneMap& zone_map, ZoneMapPB* to) const;
+
+private:
+    const TypeInfo* _type_info;
+    // used to hold min/max values of current page, it is rebuilt for every page
+    std::unique_ptr<Arena> _page_arena;
+    // used to hold min/max values of this segment
+    Arena _segment_arena;
+    ZoneMap _page_zone_map;
+    ZoneMap _segment_zone_map;
+
+    std::string _buffer;
+    uint32_t _num_pages;
+};
+
+// Read zone map of all pages from the zone map index page
+class ColumnZoneMap {
+public:
+    ColumnZoneMap(const Slice& data) : _data(data), _num_pages(0) { }
+
+    Status load();
+
+    const std::vector<ZoneMapPB>& get_column_zone_map() const {
+        return _page_zone_maps;
+    }
+
+    int32_t num_pages() const { return _num_pages; }
+
+    // Return true if there may be some values in the zone which match cond_column.
+    // min_value and max_value are used to hold the min/max value of zone when
+    // evaluating conditions, they should be created with the column's type.
+    static bool match_condition(const ZoneMapPB& zone_map,
+                                const CondColumn* cond_column,
+                                WrapperField* min_value,
+                                WrapperField* max_value);
+
+    // Set a min/max value of zone map to field. For slice types, field will
+    // reference the memory of value, so value should outlive the field's usage.
+    // Return false if the value doesn't match the field's type.
+    static bool set_field_value(const std::string& value, WrapperField* field);
+
+private:
+    Slice _data;
+
+    // valid after load
+    int32_t _num_pages;
+    std::vector<ZoneMapPB> _page_zone_maps;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,410 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "gutil/port.h"
+#include "olap/olap_common.h"
+#include "olap/types.h"
+#include "olap/rowset/segment_v2/common.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/page_builder.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+#include "util/coding.h"
+#include "util/faststring.h"
+
+namespace doris {
+namespace segment_v2 {
+
+enum {
+    FOR_PAGE_HEADER_SIZE = 4,
+    // number of values in a frame, values of a frame share one reference and bit width
+    FOR_FRAME_SIZE = 128,
+    // zero bytes appended to the page, so that decoder can always load 8 bytes at once
+    FOR_PAGE_PADDING_SIZE = 8
+};
+
+enum ForFrameMode : uint8_t {
+    // values are stored as (value - min value of frame)
+    FOR_FRAME_REFERENCE = 0,
+    // first value is stored as is, following values are stored as
+    // (value - previous value - min delta of frame)
+    FOR_FRAME_DELTA = 1
+};
+
+// Pack the lowest bit_width bits of n values into out, the first value is at
+// the lowest bits. Values should have no bits set beyond bit_width.
+template<typename T>
+inline void for_bit_pack(const T* input, size_t n, int bit_width, faststring* out) {
+    if (bit_width == 0) {
+        return;
+    }
+    uint64_t buffered = 0;
+    int bit_offset = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v = input[i];
+        buffered |= v << bit_offset;
+        bit_offset += bit_width;
+        if (bit_offset >= 64) {
+            out->append(&buffered, sizeof(uint64_t));
+            bit_offset -= 64;
+            // write out bits of v that did not fit
+            buffered = bit_offset == 0 ? 0 : v >> (bit_width - bit_offset);
+        }
+    }
+    out->append(&buffered, (bit_offset + 7) / 8);
+}
+
+// Unpack n values of bit_width bits from input. Because 8 bytes are loaded at
+// once, there must be at least 8 readable bytes after the packed data.
+template<typename T>
+inline void for_bit_unpack(const uint8_t* input, size_t n, int bit_width, T* output) {
+    if (bit_width == 0) {
+        memset(output, 0, n * sizeof(T));
+        return;
+    }
+    uint64_t mask = bit_width == 64 ? ~0ULL : (1ULL << bit_width) - 1;
+    size_t bit_offset = 0;
+    for (size_t i = 0; i < n; ++i, bit_offset += bit_width) {
+        const uint8_t* ptr = input + (bit_offset >> 3);
+        int shift = bit_offset & 7;
+        uint64_t word;
+        memcpy(&word, ptr, sizeof(uint64_t));
+        uint64_t v = word >> shift;
+        if (PREDICT_FALSE(shift + bit_width > 64)) {
+            v |= static_cast<uint64_t>(ptr[8]) << (64 - shift);
+        }
+        output[i] = static_cast<T>(v & mask);
+    }
+}
+
+template<typename T>
+inline int for_bit_width(T bits) {
+    uint64_t v = bits;
+    return v == 0 ? 0 : 64 - __builtin_clzll(v);
+}
+
+// Frame-of-reference builder for integer types. It is efficient for clustered
+// values like timestamps, and for monotonic values like sequential ids whose
+// deltas are tiny.
+//
+// The page format is as follows:
+//
+// 1. Header: (4 bytes total)
+//
+//    <num_elements> [32-bit]
+//      The number of elements encoded in the page.
+//
+// 2. Frames
+//
+//    Every FOR_FRAME_SIZE values are encoded as a frame, the last frame may
+//    have less values.
+//
+//    <mode> [8-bit]
+//      FOR_FRAME_REFERENCE or FOR_FRAME_DELTA, whichever is smaller.
+//
+//    <bit_width> [8-bit]
+//      Bits of every packed value.
+//
+//    <reference> [size of type]
+//      For FOR_FRAME_REFERENCE it is min value of frame,
+//      for FOR_FRAME_DELTA it is the first value of frame.
+//
+//    <min_delta> [size of type]
+//      Only for FOR_FRAME_DELTA, min delta between adjacent values of frame.
+//
+//    <packed values> [ceil(num_packed_values * bit_width / 8) bytes]
+//      Bit packed values, num_packed_values is the number of values in frame
+//      for FOR_FRAME_REFERENCE, and one less for FOR_FRAME_DELTA.
+//
+// 3. Padding: (8 bytes total)
+//
+//   NOTE: all on-disk ints are encoded little-endian
+template<FieldType Type>
+class FrameOfReferencePageBuilder : public PageBuilder {
+public:
+    FrameOfReferencePageBuilder(const PageBuilderOptions& options) :
+            _options(options),
+            _count(0),
+            _remain_element_capacity(0),
+            _finished(false) {
+        reset();
+    }
+
+    bool is_page_full() override {
+        return _remain_element_capacity == 0;
+    }
+
+    Status add(const uint8_t* vals, size_t* count) override {
+        DCHECK(!_finished);
+        size_t to_add = std::min<size_t>(_remain_element_capacity, *count);
+        const CppType* new_vals = reinterpret_cast<const CppType*>(vals);
+        _values.insert(_values.end(), new_vals, new_vals + to_add);
+        _count += to_add;
+        _remain_element_capacity -= to_add;
+        *count = to_add;
+        return Status::OK();
+    }
+
+    Slice finish() override {
+        encode_fixed32_le(&_buffer[0], _count);
+        for (size_t i = 0; i < _count; i += FOR_FRAME_SIZE) {
+            _encode_frame(&_values[i], std::min<size_t>(FOR_FRAME_SIZE, _count - i));
+        }
+        uint8_t padding[FOR_PAGE_PADDING_SIZE] = {0};
+        _buffer.append(padding, FOR_PAGE_PADDING_SIZE);
+        _finished = true;
+        return Slice(_buffer.data(), _buffer.size());
+    }
+
+    void reset() override {
+        _count = 0;
+        _values.clear();
+        _buffer.clear();
+        _buffer.reserve(_options.data_page_size);
+        _buffer.resize(FOR_PAGE_HEADER_SIZE);
+        _finished = false;
+        _remain_element_capacity = std::max<size_t>(_options.data_page_size / SIZE_OF_TYPE, 1);
+    }
+
+    size_t count() const override {
+        return _count;
+    }
+
+    // this api will release the memory ownership of encoded data
+    // Note:
+    //     release() should be called after finish
+    //     reset() should be called after this function before reuse the builder
+    void release() override {
+        uint8_t* ret = _buffer.release();
+        (void)ret;
+    }
+
+private:
+    typedef typename TypeTraits<Type>::CppType CppType;
+    typedef typename std::make_unsigned<CppType>::type UnsignedType;
+    enum {
+        SIZE_OF_TYPE = TypeTraits<Type>::size
+    };
+    static_assert(SIZE_OF_TYPE <= sizeof(uint64_t), "frame of reference only supports integers up to 64 bits");
+
+    void _encode_frame(const CppType* vals, size_t n) {
+        const UnsignedType* uvals = reinterpret_cast<const UnsignedType*>(vals);
+        CppType min_value = *std::min_element(vals, vals + n);
+        UnsignedType for_bits = 0;
+        for (size_t i = 0; i < n; ++i) {
+            _packed[i] = static_cast<UnsignedType>(uvals[i] - static_cast<UnsignedType>(min_value));
+            for_bits |= _packed[i];
+        }
+        int for_width = for_bit_width(for_bits);
+
+        // deltas are computed with wrap-around, so they can be restored exactly
+        // even if the subtraction overflows
+        int delta_width = 0;
+        CppType min_delta = 0;
+        if (n > 1) {
+            for (size_t i = 1; i < n; ++i) {
+                _deltas[i - 1] = static_cast<UnsignedType>(uvals[i] - uvals[i - 1]);
+            }
+            min_delta = *std::min_element(
+                reinterpret_cast<const CppType*>(_deltas), reinterpret_cast<const CppType*>(_deltas) + n - 1);
+            UnsignedType delta_bits = 0;
+            for (size_t i = 0; i < n - 1; ++i) {
+                _deltas[i] = static_cast<UnsignedType>(_deltas[i] - static_cast<UnsignedType>(min_delta));
+                delta_bits |= _deltas[i];
+            }
+            delta_width = for_bit_width(delta_bits);
+        }
+
+        bool use_delta = n > 1
+            && SIZE_OF_TYPE * 8 + delta_width * (n - 1) < for_width * n;
+        if (use_delta) {
+            _buffer.push_back(FOR_FRAME_DELTA);
+            _buffer.push_back(delta_width);
+            _buffer.append(vals, SIZE_OF_TYPE);
+            _buffer.append(&min_delta, SIZE_OF_TYPE);
+            for_bit_pack(_deltas, n - 1, delta_width, &_buffer);
+        } else {
+            _buffer.push_back(FOR_FRAME_REFERENCE);
+            _buffer.push_back(for_width);
+            _buffer.append(&min_value, SIZE_OF_TYPE);
+            for_bit_pack(_packed, n, for_width, &_buffer);
+        }
+    }
+
+    PageBuilderOptions _options;
+    size_t _count;
+    size_t _remain_element_capacity;
+    bool _finished;
+    std::vector<CppType> _values;
+    // buffers to hold values of a frame before packing
+    UnsignedType _packed[FOR_FRAME_SIZE];
+    UnsignedType _deltas[FOR_FRAME_SIZE];
+    faststring _buffer;
+};
+
+template<FieldType Type>
+class FrameOfReferencePageDecoder : public PageDecoder {
+public:
+    FrameOfReferencePageDecoder(Slice data, const PageDecoderOptions& options) :
+        _data(data),
+        _options(options),
+        _parsed(false),
+        _num_elements(0),
+        _cur_index(0),
+        _decoded_frame(-1) { }
+
+    Status init() override {
+        CHECK(!_parsed);
+        if (_data.size < FOR_PAGE_HEADER_SIZE + FOR_PAGE_PADDING_SIZE) {
+            return Status::Corruption(
+                "not enough bytes for header in FrameOfReferencePageDecoder");
+        }
+        _num_elements = decode_fixed32_le((const uint8_t*)&_data[0]);
+
+        // locate all the frames, they have variable length
+        size_t num_frames = (_num_elements + FOR_FRAME_SIZE - 1) / FOR_FRAME_SIZE;
+        _frame_offsets.resize(num_frames);
+        size_t offset = FOR_PAGE_HEADER_SIZE;
+        size_t limit = _data.size - FOR_PAGE_PADDING_SIZE;
+        for (size_t i = 0; i < num_frames; ++i) {
+            _frame_offsets[i] = offset;
+            size_t frame_size = std::min<size_t>(FOR_FRAME_SIZE, _num_elements - i * FOR_FRAME_SIZE);
+            if (offset + 2 > limit) {
+                return Status::Corruption("bad frame header in FrameOfReferencePageDecoder");
+            }
+            uint8_t mode = _data[offset];
+            uint8_t bit_width = _data[offset + 1];
+            if (mode > FOR_FRAME_DELTA || bit_width > SIZE_OF_TYPE * 8) {
+                return Status::Corruption("bad frame header in FrameOfReferencePageDecoder");
+            }
+            size_t num_packed = mode == FOR_FRAME_DELTA ? frame_size - 1 : frame_size;
+            offset += 2 + SIZE_OF_TYPE * (mode == FOR_FRAME_DELTA ? 2 : 1)
+                + (num_packed * bit_width + 7) / 8;
+            if (offset > limit) {
+                return Status::Corruption("not enough bytes for frame in FrameOfReferencePageDecoder");
+            }
+        }
+
+        _parsed = true;
+        seek_to_position_in_page(0);
+        return Status::OK();
+    }
+
+    Status seek_to_position_in_page(size_t pos) override {
+        DCHECK(_parsed) << "Must call init()";
+        DCHECK_LE(pos, _num_elements) << "Tried to seek to " << pos << " which is > number of elements ("
+                << _num_elements << ") in the block!";
+        // frame is decoded lazily when reading
+        _cur_index = pos;
+        return Status::OK();
+    }
+
+    Status next_batch(size_t* n, ColumnBlockView* dst) override {
+        DCHECK(_parsed);
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+
+        size_t to_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
+        size_t remaining = to_fetch;
+        uint8_t* data_ptr = dst->data();
+        while (remaining > 0) {
+            int32_t frame = _cur_index / FOR_FRAME_SIZE;
+            size_t offset_in_frame = _cur_index % FOR_FRAME_SIZE;
+            size_t frame_size = std::min<size_t>(FOR_FRAME_SIZE, _num_elements - frame * FOR_FRAME_SIZE);
+            size_t this_run = std::min(remaining, frame_size - offset_in_frame);
+            if (offset_in_frame == 0 && this_run == FOR_FRAME_SIZE) {
+                // decode the whole frame into destination directly
+                _decode_frame(frame, reinterpret_cast<UnsignedType*>(data_ptr));
+            } else {
+                if (_decoded_frame != frame) {
+                    _decode_frame(frame, _frame_values);
+                    _decoded_frame = frame;
+                }
+                memcpy(data_ptr, &_frame_values[offset_in_frame], this_run * SIZE_OF_TYPE);
+            }
+            data_ptr += this_run * SIZE_OF_TYPE;
+            _cur_index += this_run;
+            remaining -= this_run;
+        }
+
+        *n = to_fetch;
+        return Status::OK();
+    }
+
+    size_t count() const override {
+        return _num_elements;
+    }
+
+    size_t current_index() const override {
+        return _cur_index;
+    }
+
+private:
+    typedef typename TypeTraits<Type>::CppType CppType;
+    typedef typename std::make_unsigned<CppType>::type UnsignedType;
+    enum {
+        SIZE_OF_TYPE = TypeTraits<Type>::size
+    };
+
+    void _decode_frame(int32_t frame, UnsignedType* output) {
+        const uint8_t* ptr = (const uint8_t*)_data.data + _frame_offsets[frame];
+        size_t frame_size = std::min<size_t>(FOR_FRAME_SIZE, _num_elements - frame * FOR_FRAME_SIZE);
+        uint8_t mode = ptr[0];
+        int bit_width = ptr[1];
+        UnsignedType reference;
+        memcpy(&reference, ptr + 2, SIZE_OF_TYPE);
+        ptr += 2 + SIZE_OF_TYPE;
+        if (mode == FOR_FRAME_REFERENCE) {
+            for_bit_unpack(ptr, frame_size, bit_width, output);
+            for (size_t i = 0; i < frame_size; ++i) {
+                output[i] = static_cast<UnsignedType>(output[i] + reference);
+            }
+        } else {
+            UnsignedType min_delta;
+            memcpy(&min_delta, ptr, SIZE_OF_TYPE);
+            ptr += SIZE_OF_TYPE;
+            output[0] = reference;
+            for_bit_unpack(ptr, frame_size - 1, bit_width, output + 1);
+            for (size_t i = 1; i < frame_size; ++i) {
+                output[i] = static_cast<UnsignedType>(output[i - 1] + output[i] + min_delta);
+            }
+        }
+    }
+
+    Slice _data;
+    PageDecoderOptions _options;
+    bool _parsed;
+    uint32_t _num_elements;
+    size_t _cur_index;
+    // offset of every frame in _data
+    std::vector<uint32_t> _frame_offsets;
+    // index and values of the frame cached in _frame_values
+    int32_t _decoded_frame;
+    UnsignedType _frame_values[FOR_FRAME_SIZE];
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -99,6 +99,14 @@ public:
         return OrdinalPageIndexIterator(this, _num_pages);
     }
 
+    int32_t num_pages() const { return _num_pages; }
+
+    // return the first row id of the page_index-th page
+    rowid_t get_first_row_id(int32_t page_index) const {
+        DCHECK(page_index >= 0 && page_index < _num_pages);
+        return _rowids[page_index];
+    }
+
 private:
     uint32_t _header_size() const { return 4; }
 
@@ -17,9 +17,11 @@
 
 #include "olap/rowset/segment_v2/segment.h"
 
+#include "common/config.h"
 #include "common/logging.h" // LOG
 #include "env/env.h" // RandomAccessFile
 #include "gutil/strings/substitute.h"
+#include "olap/file_helper.h" // CachedRandomAccessFile
 #include "olap/rowset/segment_v2/column_reader.h" // ColumnReader
 #include "olap/rowset/segment_v2/segment_writer.h" // k_segment_magic_length
 #include "olap/rowset/segment_v2/segment_iterator.h"
@@ -48,7 +50,7 @@ Segment::~Segment() {
 }
 
 Status Segment::open() {
-    RETURN_IF_ERROR(Env::Default()->new_random_access_file(_fname, &_input_file));
+    RETURN_IF_ERROR(CachedRandomAccessFile::open(_fname, &_input_file));
     RETURN_IF_ERROR(_input_file->size(&_file_size));
 
     // 24: 1 * magic + 1 * checksum + 1 * footer length
@@ -70,6 +72,11 @@ Status Segment::open() {
     return Status::OK();
 }
 
+size_t Segment::mem_usage() const {
+    return sizeof(Segment) + _footer.SpaceUsed() + _sk_index_buf.capacity()
+        + _column_readers.size() * sizeof(ColumnReader);
+}
+
 Status Segment::new_iterator(const Schema& schema, std::unique_ptr<SegmentIterator>* output) {
     output->reset(new SegmentIterator(this->shared_from_this(), schema));
     return Status::OK();
@@ -162,8 +169,9 @@ Status Segment::_initial_column_readers() {
         }
 
         ColumnReaderOptions opts;
+        opts.cache_decompressed_page = config::segment_cache_decompressed_page;
         std::unique_ptr<ColumnReader> reader(
-            new ColumnReader(opts, _footer.columns(iter->second), _input_file.get()));
+            new ColumnReader(opts, _footer.columns(iter->second), _footer.num_rows(), _input_file.get()));
         RETURN_IF_ERROR(reader->init());
 
         _column_readers[ordinal] = reader.release();
@@ -173,8 +181,11 @@ Status Segment::_initial_column_readers() {
 
 Status Segment::new_column_iterator(uint32_t cid, ColumnIterator** iter) {
     if (_column_readers[cid] == nullptr) {
-        // TODO(zc): create a DefaultValueIterator for this column
-        // create
+        // this segment is written with an old schema without this column
+        const TabletColumn& column = _tablet_schema->column(cid);
+        *iter = new DefaultValueIterator(column.has_default_value(), column.default_value(),
+                                         column.is_nullable(), column.type(), column.length());
+        return Status::OK();
     }
     return _column_readers[cid]->new_iterator(iter);
 }
@@ -43,6 +43,8 @@ namespace segment_v2 {
 class ColumnReader;
 class ColumnIterator;
 class SegmentIterator;
+class Segment;
+using SegmentSharedPtr = std::shared_ptr<Segment>;
 
 // A Segment is used to represent a segment in memory format. When segment is
 // generated, it won't be modified, so this struct aimed to help read operation.
@@ -67,6 +69,9 @@ public:
 
     uint32_t num_rows() const { return _footer.num_rows(); }
 
+    // Estimated memory held by this opened segment, used as its charge in SegmentCache.
+    size_t mem_usage() const;
+
 private:
     friend class SegmentIterator;
 
@@ -17,14 +17,17 @@
 
 #include "olap/rowset/segment_v2/segment_iterator.h"
 
+#include <cstring>
 #include <set>
 
 #include "gutil/strings/substitute.h"
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/olap_cond.h"
 #include "olap/row_block2.h"
 #include "olap/row_cursor.h"
 #include "olap/short_key_index.h"
+#include "roaring/roaring.hh"
 
 using strings::Substitute;
 
@@ -46,8 +49,93 @@ SegmentIterator::~SegmentIterator() {
 
 Status SegmentIterator::init(const StorageReadOptions& opts) {
     _opts = opts;
-    RETURN_IF_ERROR(_init_short_key_range());
+    // use zone map, bloom filter and bitmap index to prune segment and pages first, if the
+    // whole segment is filtered, we needn't look up short key index
+    RowRanges condition_row_ranges;
+    RETURN_IF_ERROR(_get_row_ranges_by_column_conditions(&condition_row_ranges));
+    if (condition_row_ranges.is_empty()) {
+        _lower_rowid = _upper_rowid = 0;
+        _row_ranges.clear();
+    } else {
+        RETURN_IF_ERROR(_init_short_key_range());
+        RowRanges::ranges_intersection(
+            RowRanges::create_single(_lower_rowid, std::max(_lower_rowid, _upper_rowid)),
+            condition_row_ranges, &_row_ranges);
+    }
     RETURN_IF_ERROR(_init_column_iterators());
+    _init_predicate_columns();
+    return Status::OK();
+}
+
+// Convert rows in bitmap to row ranges, consecutive rows are merged into one range
+static void bitmap_to_row_ranges(const Roaring& bitmap, RowRanges* row_ranges) {
+    row_ranges->clear();
+    rowid_t from = 0;
+    rowid_t to = 0;
+    for (uint32_t rowid : bitmap) {
+        if (rowid != to) {
+            row_ranges->add(RowRange(from, to));
+            from = rowid;
+        }
+        to = rowid + 1;
+    }
+    row_ranges->add(RowRange(from, to));
+}
+
+// Filter pages and the whole segment with zone map and bloom filter of condition
+// columns, then filter rows with bitmap index. Rows that may match all conditions
+// will be returned in condition_row_ranges.
+Status SegmentIterator::_get_row_ranges_by_column_conditions(RowRanges* condition_row_ranges) {
+    *condition_row_ranges = RowRanges::create_single(num_rows());
+    if (_opts.conditions == nullptr) {
+        return Status::OK();
+    }
+    // rows satisfying conditions of all columns which have bitmap index
+    Roaring bitmap_index_rows;
+    bool has_bitmap_index = false;
+    for (auto& column_condition : _opts.conditions->columns()) {
+        int32_t cid = column_condition.first;
+        // no data for this column in this segment
+        if (cid < 0 || cid >= (int32_t)_segment->_column_readers.size()
+                || _segment->_column_readers[cid] == nullptr) {
+            continue;
+        }
+        ColumnReader* column_reader = _segment->_column_readers[cid];
+        if (column_reader->has_zone_map()) {
+            RowRanges column_row_ranges;
+            RETURN_IF_ERROR(column_reader->get_row_ranges_by_zone_map(
+                    _segment->_tablet_schema->column(cid), column_condition.second, &column_row_ranges));
+            RowRanges::ranges_intersection(*condition_row_ranges, column_row_ranges, condition_row_ranges);
+        }
+        if (!condition_row_ranges->is_empty() && column_reader->has_bloom_filter()) {
+            RowRanges column_row_ranges;
+            RETURN_IF_ERROR(column_reader->get_row_ranges_by_bloom_filter(
+                    column_condition.second, &column_row_ranges));
+            RowRanges::ranges_intersection(*condition_row_ranges, column_row_ranges, condition_row_ranges);
+        }
+        if (!condition_row_ranges->is_empty() && column_reader->has_bitmap_index()) {
+            Roaring column_rows;
+            RETURN_IF_ERROR(column_reader->get_row_bitmap_by_bitmap_index(
+                    column_condition.second, &column_rows));
+            if (has_bitmap_index) {
+                bitmap_index_rows &= column_rows;
+            } else {
+                bitmap_index_rows = std::move(column_rows);
+                has_bitmap_index = true;
+            }
+            if (bitmap_index_rows.isEmpty()) {
+                condition_row_ranges->clear();
+            }
+        }
+        if (condition_row_ranges->is_empty()) {
+            return Status::OK();
+        }
+    }
+    if (has_bitmap_index) {
+        RowRanges bitmap_row_ranges;
+        bitmap_to_row_ranges(bitmap_index_rows, &bitmap_row_ranges);
+        RowRanges::ranges_intersection(*condition_row_ranges, bitmap_row_ranges, condition_row_ranges);
+    }
     return Status::OK();
 }
 
@@ -115,22 +203,55 @@ Status SegmentIterator::_prepare_seek() {
 }
 
 Status SegmentIterator::_init_column_iterators() {
-    _cur_rowid = _lower_rowid;
-    if (_cur_rowid >= num_rows()) {
+    _cur_range_id = 0;
+    if (_row_ranges.is_empty()) {
+        _cur_rowid = num_rows();
         return Status::OK();
     }
+    _cur_rowid = _row_ranges.get_range_from(0);
     for (auto cid : _schema.column_ids()) {
         if (_column_iterators[cid] == nullptr) {
             RETURN_IF_ERROR(_create_column_iterator(cid, &_column_iterators[cid]));
         }
+    }
+    return _seek_columns(_schema.column_ids(), _cur_rowid);
+}
 
-        _column_iterators[cid]->seek_to_ordinal(_cur_rowid);
+// Only conditions on columns in schema are evaluated here, conditions on
+// other columns are just used to prune data by zone map.
+void SegmentIterator::_init_predicate_columns() {
+    _predicate_column_ids.clear();
+    _non_predicate_column_ids.clear();
+    for (auto cid : _schema.column_ids()) {
+        if (_opts.conditions != nullptr && _opts.conditions->columns().count(cid) > 0) {
+            _predicate_column_ids.push_back(cid);
+        } else {
+            _non_predicate_column_ids.push_back(cid);
+        }
+    }
+}
+
+Status SegmentIterator::_seek_columns(const std::vector<ColumnId>& column_ids, rowid_t rowid) {
+    // submit reads of pages of all columns before waiting for any of them,
+    // so that they are served by disk concurrently
+    if (column_ids.size() > 1) {
+        for (auto cid : column_ids) {
+            Status st = _column_iterators[cid]->prefetch(rowid);
+            if (!st.ok()) {
+                VLOG(3) << "fail to prefetch column " << cid << ": " << st.to_string();
+                break;
+            }
+        }
+    }
+    for (auto cid : column_ids) {
+        RETURN_IF_ERROR(_column_iterators[cid]->seek_to_ordinal(rowid));
     }
     return Status::OK();
 }
 
 Status SegmentIterator::_create_column_iterator(uint32_t cid, ColumnIterator** iter) {
-    return _segment->new_column_iterator(cid, iter);
+    RETURN_IF_ERROR(_segment->new_column_iterator(cid, iter));
+    return (*iter)->init(ColumnIteratorOptions());
 }
 
 // Schema of lhs and rhs are different.
@@ -209,26 +330,25 @@ Status SegmentIterator::_lookup_ordinal(const RowCursor& key, bool is_include,
 
 // seek to the row and load that row to _key_cursor
 Status SegmentIterator::_seek_and_peek(rowid_t rowid) {
-    for (auto cid : _seek_schema->column_ids()) {
-        _column_iterators[cid]->seek_to_ordinal(rowid);
-    }
+    RETURN_IF_ERROR(_seek_columns(_seek_schema->column_ids(), rowid));
     size_t num_rows = 1;
     _seek_block->resize(num_rows);
-    RETURN_IF_ERROR(_next_batch(_seek_block.get(), &num_rows));
+    RETURN_IF_ERROR(_read_columns(_seek_schema->column_ids(), _seek_block.get(), 0, &num_rows));
     return Status::OK();
 }
 
-// Try to read data as much to block->num_rows(). The number of read rows
-// will be set in rows_read when return OK. rows_read will small than
-// block->num_rows() when reach the end of this segment
-Status SegmentIterator::_next_batch(RowBlockV2* block, size_t* rows_read) {
+// Try to read rows_read rows of column_ids into block from row_offset. The number
+// of read rows will be set in rows_read when return OK. rows_read will small than
+// input value when reach the end of this segment
+Status SegmentIterator::_read_columns(const std::vector<ColumnId>& column_ids, RowBlockV2* block,
+                                      size_t row_offset, size_t* rows_read) {
     bool has_read = false;
     size_t first_read = 0;
-    for (int i = 0; i < block->schema()->column_ids().size(); ++i) {
-        auto cid = block->schema()->column_ids()[i];
-        size_t num_rows = has_read ? first_read : block->num_rows();
-        auto column_block = block->column_block(i);
-        RETURN_IF_ERROR(_column_iterators[cid]->next_batch(&num_rows, &column_block));
+    for (auto cid : column_ids) {
+        size_t num_rows = has_read ? first_read : *rows_read;
+        auto column_block = block->column_block(cid);
+        ColumnBlockView dst(&column_block, row_offset);
+        RETURN_IF_ERROR(_column_iterators[cid]->next_batch(&num_rows, &dst));
         if (!has_read) {
             has_read = true;
             first_read = num_rows;
@@ -236,21 +356,135 @@ Status SegmentIterator::_next_batch(RowBlockV2* block, size_t* rows_read) {
             return Status::InternalError(
                 Substitute("Read different rows in different columns"
                            ", column($0) read $1 vs column($2) read $3",
-                           block->schema()->column_ids()[0], first_read, cid, num_rows));
+                           column_ids[0], first_read, cid, num_rows));
         }
     }
     *rows_read = first_read;
     return Status::OK();
 }
 
-Status SegmentIterator::next_batch(RowBlockV2* block) {
-    size_t rows_to_read = std::min((rowid_t)block->capacity(), _upper_rowid - _cur_rowid);
-    block->resize(rows_to_read);
-    if (rows_to_read == 0) {
+// Read predicate columns for rows [row_offset, row_offset + *rows_read) in block and
+// evaluate conditions on them. Offsets of rows passing all conditions are saved in
+// _sel_rowids, and these rows of predicate columns are moved to be contiguous from
+// row_offset. Column iterators evaluate conditions themselves, so that they can skip
+// materializing data which is filtered, e.g. by evaluating on dictionary codewords.
+Status SegmentIterator::_read_and_evaluate_predicate_columns(RowBlockV2* block, size_t row_offset,
+                                                             size_t* rows_read) {
+    size_t num_rows = *rows_read;
+    _selection.assign(num_rows, 1);
+    _column_selection.resize(num_rows);
+    for (auto cid : _predicate_column_ids) {
+        const CondColumn* cond_column = _opts.conditions->columns().find(cid)->second;
+        auto column_block = block->column_block(cid);
+        ColumnBlockView dst(&column_block, row_offset);
+        size_t column_rows = num_rows;
+        RETURN_IF_ERROR(_column_iterators[cid]->next_batch_and_evaluate(
+                &column_rows, &dst, cond_column, _column_selection.data()));
+        if (cid == _predicate_column_ids[0]) {
+            num_rows = column_rows;
+        } else if (column_rows != num_rows) {
+            return Status::InternalError(
+                Substitute("Read different rows in different columns"
+                           ", column($0) read $1 vs column($2) read $3",
+                           _predicate_column_ids[0], num_rows, cid, column_rows));
+        }
+        for (size_t i = 0; i < num_rows; ++i) {
+            _selection[i] &= _column_selection[i];
+        }
+    }
+    *rows_read = num_rows;
+
+    _sel_rowids.clear();
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (_selection[i]) {
+            _sel_rowids.push_back(i);
+        }
+    }
+    size_t num_selected = _sel_rowids.size();
+    if (num_selected == num_rows) {
+        return Status::OK();
+    }
+
+    for (auto cid : _predicate_column_ids) {
+        auto column_block = block->column_block(cid);
+        size_t cell_size = column_block.type_info()->size();
+        for (size_t i = 0; i < num_selected; ++i) {
+            size_t src = row_offset + _sel_rowids[i];
+            size_t dst = row_offset + i;
+            if (src == dst) {
+                continue;
+            }
+            memcpy(column_block.mutable_cell_ptr(dst), column_block.cell_ptr(src), cell_size);
+            if (column_block.is_nullable()) {
+                column_block.set_is_null(dst, column_block.is_null(src));
+            }
+        }
+    }
+    return Status::OK();
+}
+
+// Read non-predicate columns only for rows in _sel_rowids. Consecutive selected
+// rows are read in one batch, rows between them are skipped by seeking.
+Status SegmentIterator::_read_non_predicate_columns(RowBlockV2* block, size_t row_offset) {
+    if (_non_predicate_column_ids.empty()) {
         return Status::OK();
     }
-    RETURN_IF_ERROR(_next_batch(block, &rows_to_read));
-    _cur_rowid += rows_to_read;
+    size_t dst_offset = row_offset;
+    size_t i = 0;
+    while (i < _sel_rowids.size()) {
+        size_t j = i + 1;
+        while (j < _sel_rowids.size() && _sel_rowids[j] == _sel_rowids[j - 1] + 1) {
+            ++j;
+        }
+        size_t run_rows = j - i;
+        RETURN_IF_ERROR(_seek_columns(_non_predicate_column_ids, _cur_rowid + _sel_rowids[i]));
+        size_t rows_read = run_rows;
+        RETURN_IF_ERROR(_read_columns(_non_predicate_column_ids, block, dst_offset, &rows_read));
+        if (rows_read != run_rows) {
+            return Status::InternalError(
+                Substitute("Failed to read data at row $0 of segment $1",
+                           _cur_rowid + _sel_rowids[i], segment_id()));
+        }
+        dst_offset += run_rows;
+        i = j;
+    }
+    return Status::OK();
+}
+
+Status SegmentIterator::next_batch(RowBlockV2* block) {
+    size_t rows_read = 0;
+    while (rows_read < block->capacity() && _cur_range_id < _row_ranges.range_size()) {
+        rowid_t range_to = _row_ranges.get_range_to(_cur_range_id);
+        if (_cur_rowid >= range_to) {
+            // current range is finished, seek to the start of next range
+            _cur_range_id++;
+            if (_cur_range_id >= _row_ranges.range_size()) {
+                break;
+            }
+            _cur_rowid = _row_ranges.get_range_from(_cur_range_id);
+            RETURN_IF_ERROR(_seek_columns(_schema.column_ids(), _cur_rowid));
+            continue;
+        }
+        size_t rows_to_read = std::min(block->capacity() - rows_read, (size_t)(range_to - _cur_rowid));
+        size_t rows_selected = 0;
+        if (_predicate_column_ids.empty()) {
+            RETURN_IF_ERROR(_read_columns(_schema.column_ids(), block, rows_read, &rows_to_read));
+            rows_selected = rows_to_read;
+        } else {
+            // late materialization: read predicate columns and evaluate conditions
+            // first, then read other columns only for rows passing conditions
+            RETURN_IF_ERROR(_read_and_evaluate_predicate_columns(block, rows_read, &rows_to_read));
+            RETURN_IF_ERROR(_read_non_predicate_columns(block, rows_read));
+            rows_selected = _sel_rowids.size();
+        }
+        if (rows_to_read == 0) {
+            return Status::InternalError(
+                Substitute("Failed to read data at row $0 of segment $1", _cur_rowid, segment_id()));
+        }
+        _cur_rowid += rows_to_read;
+        rows_read += rows_selected;
+    }
+    block->resize(rows_read);
     return Status::OK();
 }
 
@@ -22,6 +22,7 @@
 
 #include "common/status.h"
 #include "olap/rowset/segment_v2/common.h"
+#include "olap/rowset/segment_v2/row_ranges.h"
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/iterators.h"
 #include "olap/schema.h"
@@ -47,13 +48,20 @@ public:
 private:
     Status _init_short_key_range();
     Status _prepare_seek();
+    Status _get_row_ranges_by_column_conditions(RowRanges* condition_row_ranges);
     Status _init_column_iterators();
+    void _init_predicate_columns();
     Status _create_column_iterator(uint32_t cid, ColumnIterator** iter);
 
     Status _lookup_ordinal(const RowCursor& key, bool is_include,
                            rowid_t upper_bound, rowid_t* rowid);
+    Status _seek_columns(const std::vector<ColumnId>& column_ids, rowid_t rowid);
     Status _seek_and_peek(rowid_t rowid);
-    Status _next_batch(RowBlockV2* block, size_t* rows_read);
+    Status _read_columns(const std::vector<ColumnId>& column_ids, RowBlockV2* block,
+                         size_t row_offset, size_t* rows_read);
+    Status _read_and_evaluate_predicate_columns(RowBlockV2* block, size_t row_offset,
+                                                size_t* rows_read);
+    Status _read_non_predicate_columns(RowBlockV2* block, size_t row_offset);
 
     uint32_t segment_id() const { return _segment->id(); }
     uint32_t num_rows() const { return _segment->num_rows(); }
@@ -79,8 +87,27 @@ private:
 
     rowid_t _lower_rowid;
     rowid_t _upper_rowid;
+
+    // row ranges to read, it is the intersection of short key range and
+    // the ranges surviving zone map, bloom filter and bitmap index pruning
+    RowRanges _row_ranges;
+    // index of the range in _row_ranges which is being read
+    size_t _cur_range_id = 0;
     rowid_t _cur_rowid;
 
+    // Columns in schema which have conditions on them. They are read and
+    // evaluated first, other columns are only read for rows passing all
+    // conditions, which saves decoding cost when conditions are selective.
+    std::vector<ColumnId> _predicate_column_ids;
+    std::vector<ColumnId> _non_predicate_column_ids;
+    // offsets (relative to the first row of current read) of rows
+    // which pass all conditions, in ascending order
+    std::vector<uint16_t> _sel_rowids;
+    // selection of rows in current read, 1 means the row passes all conditions
+    std::vector<uint8_t> _selection;
+    // selection of one column in current read
+    std::vector<uint8_t> _column_selection;
+
     Arena _arena;
 };
 
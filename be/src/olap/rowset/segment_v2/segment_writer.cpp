@@ -17,9 +17,11 @@
 
 #include "olap/rowset/segment_v2/segment_writer.h"
 
+#include "common/config.h"
 #include "env/env.h" // Env
 #include "olap/row.h" // ContiguousRow
 #include "olap/row_block.h" // RowBlock
+#include "olap/row_block2.h" // RowBlockV2
 #include "olap/row_cursor.h" // RowCursor
 #include "olap/rowset/segment_v2/column_writer.h" // ColumnWriter
 #include "olap/short_key_index.h"
@@ -47,7 +49,11 @@ SegmentWriter::~SegmentWriter() {
 
 Status SegmentWriter::init(uint32_t write_mbytes_per_sec) {
     // create for write
-    RETURN_IF_ERROR(Env::Default()->new_writable_file(_fname, &_output_file));
+    // segment files are written in large batches by flush and compaction,
+    // keep them out of page cache like alpha segment files
+    WritableFileOptions opts;
+    opts.drop_cache_bytes = config::segment_write_drop_cache_bytes;
+    RETURN_IF_ERROR(Env::Default()->new_writable_file(opts, _fname, &_output_file));
 
     uint32_t column_id = 0;
     for (auto& column : _tablet_schema->columns()) {
@@ -63,6 +69,15 @@ Status SegmentWriter::init(uint32_t write_mbytes_per_sec) {
         DCHECK(type_info != nullptr);
 
         ColumnWriterOptions opts;
+        opts.compression_type = _opts.compression_type;
+        // key columns are sorted, adjacent values share long prefix
+        if (column.is_key() && column.type() == OLAP_FIELD_TYPE_VARCHAR) {
+            opts.encoding_type = PREFIX_ENCODING;
+        }
+        // zone map of HLL column is meaningless
+        opts.need_zone_map = column.type() != OLAP_FIELD_TYPE_HLL;
+        opts.need_bloom_filter = column.is_bf_column();
+        opts.need_bitmap_index = column.is_bitmap_column();
         std::unique_ptr<ColumnWriter> writer(new ColumnWriter(opts, type_info, is_nullable, _output_file.get()));
         RETURN_IF_ERROR(writer->init());
         _column_writers.push_back(writer.release());
@@ -91,6 +106,60 @@ Status SegmentWriter::append_row(const RowType& row) {
 template Status SegmentWriter::append_row(const RowCursor& row);
 template Status SegmentWriter::append_row(const ContiguousRow& row);
 
+template<typename RowType>
+Status SegmentWriter::append_columns(const RowType& row, const std::vector<uint32_t>& column_ids) {
+    DCHECK(!column_ids.empty());
+    for (auto cid : column_ids) {
+        auto cell = row.cell(cid);
+        RETURN_IF_ERROR(_column_writers[cid]->append(cell));
+    }
+    // only the key group maintains row count and short key index
+    if (!_tablet_schema->column(column_ids[0]).is_key()) {
+        return Status::OK();
+    }
+    if ((_row_count % _opts.num_rows_per_block) == 0) {
+        std::string encoded_key;
+        encode_key(&encoded_key, row, _tablet_schema->num_short_key_columns());
+        RETURN_IF_ERROR(_index_builder->add_item(encoded_key));
+        _block_count++;
+    }
+    _row_count++;
+    return Status::OK();
+}
+
+template Status SegmentWriter::append_columns(const RowCursor& row,
+                                              const std::vector<uint32_t>& column_ids);
+
+Status SegmentWriter::append_block(const RowBlockV2& block) {
+    DCHECK_EQ(block.schema()->num_columns(), _column_writers.size());
+    size_t num_rows = block.num_rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    for (size_t cid = 0; cid < _column_writers.size(); ++cid) {
+        auto column_block = block.column_block(cid);
+        if (column_block.is_nullable()) {
+            RETURN_IF_ERROR(_column_writers[cid]->append_nullable(
+                    column_block.null_bitmap(), column_block.data(), num_rows));
+        } else {
+            RETURN_IF_ERROR(_column_writers[cid]->append(column_block.data(), num_rows));
+        }
+    }
+
+    // add short key of the first row of every block in segment
+    size_t num_rows_per_block = _opts.num_rows_per_block;
+    size_t offset = _row_count % num_rows_per_block;
+    size_t i = (offset == 0) ? 0 : num_rows_per_block - offset;
+    for (; i < num_rows; i += num_rows_per_block) {
+        std::string encoded_key;
+        encode_key(&encoded_key, block.row(i), _tablet_schema->num_short_key_columns());
+        RETURN_IF_ERROR(_index_builder->add_item(encoded_key));
+        _block_count++;
+    }
+    _row_count += num_rows;
+    return Status::OK();
+}
+
 uint64_t SegmentWriter::estimate_segment_size() {
     return 0;
 }
@@ -102,6 +171,9 @@ Status SegmentWriter::finalize(uint32_t* segment_file_size) {
     RETURN_IF_ERROR(_write_raw_data({k_segment_magic}));
     RETURN_IF_ERROR(_write_data());
     RETURN_IF_ERROR(_write_ordinal_index());
+    RETURN_IF_ERROR(_write_zone_map());
+    RETURN_IF_ERROR(_write_bloom_filter());
+    RETURN_IF_ERROR(_write_bitmap_index());
     RETURN_IF_ERROR(_write_short_key_index());
     RETURN_IF_ERROR(_write_footer());
     return Status::OK();
@@ -123,6 +195,27 @@ Status SegmentWriter::_write_ordinal_index() {
     return Status::OK();
 }
 
+Status SegmentWriter::_write_zone_map() {
+    for (auto column_writer : _column_writers) {
+        RETURN_IF_ERROR(column_writer->write_zone_map());
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::_write_bloom_filter() {
+    for (auto column_writer : _column_writers) {
+        RETURN_IF_ERROR(column_writer->write_bloom_filter());
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::_write_bitmap_index() {
+    for (auto column_writer : _column_writers) {
+        RETURN_IF_ERROR(column_writer->write_bitmap_index());
+    }
+    return Status::OK();
+}
+
 Status SegmentWriter::_write_short_key_index() {
     std::vector<Slice> slices;
     // TODO(zc): we should get segment_size
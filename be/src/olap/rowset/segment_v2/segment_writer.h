@@ -32,6 +32,7 @@ namespace doris {
 class WritableFile;
 class RowBlock;
 class RowCursor;
+class RowBlockV2;
 class ShortKeyIndexBuilder;
 
 namespace segment_v2 {
@@ -43,6 +44,8 @@ extern const uint32_t k_segment_magic_length;
 
 struct SegmentWriterOptions {
     uint32_t num_rows_per_block = 1024;
+    // compression of pages of all columns
+    CompressionTypePB compression_type = NO_COMPRESSION;
 };
 
 class SegmentWriter {
@@ -58,13 +61,31 @@ public:
     template<typename RowType>
     Status append_row(const RowType& row);
 
+    // Append all rows of block, block should contain all columns of tablet
+    // schema. Data of each column is handed to its ColumnWriter in one call,
+    // so that it is encoded in batch rather than cell by cell.
+    Status append_block(const RowBlockV2& block);
+
+    // Append cells of column_ids in row, used to write a segment by column
+    // groups. The group containing key columns must be appended first, it
+    // decides the number of rows and the short key index of this segment,
+    // then the other groups should append the same number of rows.
+    template<typename RowType>
+    Status append_columns(const RowType& row, const std::vector<uint32_t>& column_ids);
+
     uint64_t estimate_segment_size();
 
     Status finalize(uint32_t* segment_file_size);
 
+    // footer of this segment, valid after finalize
+    const SegmentFooterPB& footer() const { return _footer; }
+
 private:
     Status _write_data();
     Status _write_ordinal_index();
+    Status _write_zone_map();
+    Status _write_bloom_filter();
+    Status _write_bitmap_index();
     Status _write_short_key_index();
     Status _write_footer();
     Status _write_raw_data(const std::vector<Slice>& slices);
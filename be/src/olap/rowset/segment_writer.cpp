@@ -31,7 +31,9 @@ SegmentWriter::SegmentWriter(
         SegmentGroup* segment_group,
         uint32_t stream_buffer_size,
         CompressKind compress_kind,
-        double bloom_filter_fpp) : 
+        double bloom_filter_fpp,
+        IOScheduler* io_scheduler,
+        IOClass io_class) : 
         _file_name(file_name),
         _segment_group(segment_group),
         _stream_buffer_size(stream_buffer_size),
@@ -39,7 +41,10 @@ SegmentWriter::SegmentWriter(
         _bloom_filter_fpp(bloom_filter_fpp),
         _stream_factory(NULL),
         _row_count(0),
-        _block_count(0) {}
+        _block_count(0),
+        _write_mbytes_per_sec(0),
+        _io_scheduler(io_scheduler),
+        _io_class(io_class) {}
 
 SegmentWriter::~SegmentWriter() {
     SAFE_DELETE(_stream_factory);
@@ -250,6 +255,9 @@ OLAPStatus SegmentWriter::finalize(uint32_t* segment_file_size) {
             checksum = stream->crc32(checksum);
             VLOG(3) << "stream id=" << it->first.unique_column_id()
                     << ", type=" << it->first.kind();
+            if (_io_scheduler != nullptr) {
+                _io_scheduler->acquire(_io_class, stream->get_stream_length());
+            }
             res = stream->write_to_file(
                     &file_handle, _write_mbytes_per_sec);
             if (OLAP_SUCCESS != res) {
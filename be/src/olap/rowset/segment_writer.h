@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_SEGMENT_WRITER_H
 #define DORIS_BE_SRC_OLAP_ROWSET_SEGMENT_WRITER_H
 
+#include "olap/io_scheduler.h"
 #include "olap/olap_define.h"
 #include "olap/rowset/column_data_writer.h"
 
@@ -33,7 +34,9 @@ public:
             SegmentGroup* segment_group,
             uint32_t stream_buffer_size,
             CompressKind compress_kind,
-            double bloom_filter_fpp);
+            double bloom_filter_fpp,
+            IOScheduler* io_scheduler = nullptr,
+            IOClass io_class = IOClass::LOAD);
     ~SegmentWriter();
     OLAPStatus init(uint32_t write_mbytes_per_sec);
     OLAPStatus write_batch(RowBlock* block, RowCursor* cursor, bool is_finalize);
@@ -59,6 +62,9 @@ private:
 
     // write limit
     uint32_t _write_mbytes_per_sec;
+    // write limit shared by all writers of the data dir, may be null
+    IOScheduler* _io_scheduler;
+    IOClass _io_class;
 
     DISALLOW_COPY_AND_ASSIGN(SegmentWriter);
 };
@@ -18,6 +18,8 @@
 #include "olap/rowset_factory.h"
 #include "gen_cpp/olap_file.pb.h"
 #include "olap/rowset/alpha_rowset.h"
+#include "olap/rowset/alpha_rowset_writer.h"
+#include "olap/rowset/beta_rowset_writer.h"
 
 namespace doris {
 
@@ -35,4 +37,19 @@ OLAPStatus RowsetFactory::load_rowset(const TabletSchema& schema,
     }
 }
 
+OLAPStatus RowsetFactory::create_rowset_writer(const RowsetWriterContext& context,
+                                               RowsetWriterSharedPtr* output) {
+    if (context.rowset_type == ALPHA_ROWSET) {
+        output->reset(new (std::nothrow) AlphaRowsetWriter());
+    } else if (context.rowset_type == BETA_ROWSET) {
+        output->reset(new (std::nothrow) BetaRowsetWriter());
+    } else {
+        return OLAP_ERR_ROWSET_TYPE_NOT_FOUND;
+    }
+    if (*output == nullptr) {
+        return OLAP_ERR_MALLOC_ERROR;
+    }
+    return (*output)->init(context);
+}
+
 } // namespace doris
@@ -20,6 +20,8 @@
 
 #include "gen_cpp/olap_file.pb.h"
 #include "olap/data_dir.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/rowset_writer_context.h"
 
 namespace doris {
 
@@ -31,6 +33,10 @@ public:
                                   DataDir* data_dir,
                                   RowsetMetaSharedPtr rowset_meta,
                                   RowsetSharedPtr* rowset);
+
+    // create and init a rowset writer for context.rowset_type
+    static OLAPStatus create_rowset_writer(const RowsetWriterContext& context,
+                                           RowsetWriterSharedPtr* output);
 };
 
 } // namespace doris
@@ -73,6 +73,7 @@ OLAPStatus RowsetGraph::construct_rowset_graph(const std::vector<RowsetMetaShare
 }
 
 OLAPStatus RowsetGraph::reconstruct_rowset_graph(const std::vector<RowsetMetaSharedPtr>& rs_metas) {
+    _invalidate_cached_path();
     for (auto& vertex : _version_graph) {
         SAFE_DELETE(vertex.edges);
     }
@@ -85,6 +86,7 @@ OLAPStatus RowsetGraph::add_version_to_graph(const Version& version) {
     // Add version.first as new vertex of version graph if not exist.
     int64_t start_vertex_value = version.first;
     int64_t end_vertex_value = version.second + 1;
+    bool is_new_end_vertex = _vertex_index_map.find(end_vertex_value) == _vertex_index_map.end();
 
     // Add vertex to graph.
     OLAPStatus status = _add_vertex_to_graph(start_vertex_value);
@@ -111,6 +113,19 @@ OLAPStatus RowsetGraph::add_version_to_graph(const Version& version) {
     std::list<int64_t>* r_edges = _version_graph[end_vertex_index].edges;
     r_edges->insert(r_edges->begin(), start_vertex_index);
 
+    {
+        std::lock_guard<std::mutex> l(_cached_path_lock);
+        if (is_new_end_vertex && !_cached_path.empty()
+                && _cached_spec_version.second + 1 == version.first) {
+            // The only edge to the new end vertex is this version, so the shortest
+            // path to it is the cached one followed by this version.
+            _cached_path.push_back(version);
+            _cached_spec_version.second = version.second;
+        } else {
+            _cached_spec_version = {-1, -1};
+            _cached_path.clear();
+        }
+    }
     return OLAP_SUCCESS;
 }
 
@@ -125,6 +140,7 @@ OLAPStatus RowsetGraph::delete_version_from_graph(const Version& version) {
         return OLAP_ERR_HEADER_DELETE_VERSION;
     }
 
+    _invalidate_cached_path();
     int64_t start_vertex_index = _vertex_index_map[start_vertex_value];
     int64_t end_vertex_index = _vertex_index_map[end_vertex_value];
     // Remove edge and its reverse edge.
@@ -153,6 +169,12 @@ OLAPStatus RowsetGraph::_add_vertex_to_graph(int64_t vertex_value) {
     return OLAP_SUCCESS;
 }
 
+void RowsetGraph::_invalidate_cached_path() {
+    std::lock_guard<std::mutex> l(_cached_path_lock);
+    _cached_spec_version = {-1, -1};
+    _cached_path.clear();
+}
+
 OLAPStatus RowsetGraph::capture_consistent_versions(
                             const Version& spec_version,
                             std::vector<Version>* version_path) const {
@@ -167,6 +189,22 @@ OLAPStatus RowsetGraph::capture_consistent_versions(
         return OLAP_ERR_INPUT_PARAMETER_ERROR;
     }
 
+    std::lock_guard<std::mutex> l(_cached_path_lock);
+    if (!_cached_path.empty() && _cached_spec_version == spec_version) {
+        version_path->insert(version_path->end(), _cached_path.begin(), _cached_path.end());
+        return OLAP_SUCCESS;
+    }
+    size_t path_start = version_path->size();
+    RETURN_NOT_OK(_find_consistent_versions(spec_version, version_path));
+    _cached_spec_version = spec_version;
+    _cached_path.assign(version_path->begin() + path_start, version_path->end());
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus RowsetGraph::_find_consistent_versions(
+                            const Version& spec_version,
+                            std::vector<Version>* version_path) const {
+
     // bfs_queue's element is vertex_index.
     std::queue<int64_t> bfs_queue;
     // predecessor[i] means the predecessor of vertex_index 'i'.
@@ -181,13 +219,13 @@ OLAPStatus RowsetGraph::capture_consistent_versions(
     // -1 is valid vertex index.
     int64_t end_vertex_index = -1;
 
-    for (size_t i = 0; i < _version_graph.size(); ++i) {
-        if (_version_graph[i].value == start_vertex_value) {
-            start_vertex_index = i;
-        }
-        if (_version_graph[i].value == end_vertex_value) {
-            end_vertex_index = i;
-        }
+    auto start_it = _vertex_index_map.find(start_vertex_value);
+    if (start_it != _vertex_index_map.end()) {
+        start_vertex_index = start_it->second;
+    }
+    auto end_it = _vertex_index_map.find(end_vertex_value);
+    if (end_it != _vertex_index_map.end()) {
+        end_vertex_index = end_it->second;
     }
 
     if (start_vertex_index < 0 || end_vertex_index < 0) {
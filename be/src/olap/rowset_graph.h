@@ -18,6 +18,8 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_GRAPH_H
 #define DORIS_BE_SRC_OLAP_ROWSET_GRAPH_H
 
+#include <mutex>
+
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/rowset/rowset_meta.h"
@@ -34,6 +36,9 @@ public:
                                            std::vector<Version>* version_path) const;
 private:
     OLAPStatus _add_vertex_to_graph(int64_t vertex_value);
+    OLAPStatus _find_consistent_versions(const Version& spec_version,
+                                         std::vector<Version>* version_path) const;
+    void _invalidate_cached_path();
 
     // OLAP version contains two parts, [start_version, end_version]. In order
     // to construct graph, the OLAP version has two corresponding vertex, one
@@ -45,6 +50,16 @@ private:
     // vertex value --> vertex_index of _version_graph
     // It is easy to find vertex index according to vertex value.
     std::unordered_map<int64_t, int64_t> _vertex_index_map;
+
+    // Path of the last version captured. Queries almost always capture the path
+    // from version 0 to the latest version, so it is kept to save the bfs. It is
+    // extended when a version following it is added, and dropped on any other
+    // change of the graph.
+    // capture_consistent_versions() is called under the read lock of the tablet
+    // meta, so the cached path is protected by its own lock.
+    mutable std::mutex _cached_path_lock;
+    mutable Version _cached_spec_version = {-1, -1};
+    mutable std::vector<Version> _cached_path;
 };
 
 }  // namespace doris
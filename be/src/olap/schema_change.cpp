@@ -21,6 +21,9 @@
 #include <signal.h>
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "olap/merger.h"
@@ -30,8 +33,10 @@
 #include "olap/row_cursor.h"
 #include "olap/wrapper_field.h"
 #include "olap/row.h"
+#include "util/arena.h"
 #include "olap/rowset/rowset_id_generator.h"
 #include "olap/rowset/alpha_rowset_writer.h"
+#include "olap/rowset_factory.h"
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
 #include "common/resource_tls.h"
@@ -568,6 +573,8 @@ bool RowBlockMerger::merge(
         uint64_t* merged_rows) {
     uint64_t tmp_merged_rows = 0;
     RowCursor row_cursor;
+    // Holds the values finalized by BITMAP_UNION, rows are copied by add_row().
+    std::unique_ptr<Arena> agg_arena(new Arena());
     if (row_cursor.init(_tablet->tablet_schema()) != OLAP_SUCCESS) {
         LOG(WARNING) << "fail to init row cursor.";
         goto MERGE_ERR;
@@ -595,8 +602,11 @@ bool RowBlockMerger::merge(
                 goto MERGE_ERR;
             }
         }
-        agg_finalize_row(&row_cursor, nullptr);
+        agg_finalize_row(&row_cursor, agg_arena.get());
         rowset_writer->add_row(row_cursor);
+        if (agg_arena->MemoryUsage() > OLAP_MAX_AGG_ARENA_BYTES) {
+            agg_arena.reset(new Arena());
+        }
     }
     if (rowset_writer->flush() != OLAP_SUCCESS) {
         LOG(WARNING) << "failed to finalizing writer.";
@@ -1064,11 +1074,6 @@ bool SchemaChangeWithSorting::_internal_sorting(const vector<RowBlock*>& row_blo
     uint64_t merged_rows = 0;
     RowBlockMerger merger(new_tablet);
 
-    RowsetWriterSharedPtr rowset_writer(new AlphaRowsetWriter());
-    if (rowset_writer == nullptr) {
-        LOG(WARNING) << "new rowset builder failed";
-        return false;
-    }
     RowsetId rowset_id = 0;
     OLAPStatus status = new_tablet->next_rowset_id(&rowset_id);
     if (status != OLAP_SUCCESS) {
@@ -1086,11 +1091,16 @@ bool SchemaChangeWithSorting::_internal_sorting(const vector<RowBlock*>& row_blo
     context.tablet_schema = &(new_tablet->tablet_schema());
     context.rowset_state = VISIBLE;
     context.data_dir = new_tablet->data_dir();
+    context.io_class = IOClass::COMPACTION;
     context.version = version;
     context.version_hash = version_hash;
     VLOG(3) << "init rowset builder. tablet=" << new_tablet->full_name()
             << ", block_row_size=" << new_tablet->num_rows_per_row_block();
-    rowset_writer->init(context);
+    RowsetWriterSharedPtr rowset_writer;
+    if (RowsetFactory::create_rowset_writer(context, &rowset_writer) != OLAP_SUCCESS) {
+        LOG(WARNING) << "new rowset builder failed";
+        return false;
+    }
     if (!merger.merge(row_block_arr, rowset_writer, &merged_rows)) {
         LOG(WARNING) << "failed to merge row blocks.";
         new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX + std::to_string(rowset_writer->rowset_id()));
@@ -1680,11 +1690,13 @@ OLAPStatus SchemaChangeHandler::schema_version_convert(
     writer_context.rowset_path_prefix = new_tablet->tablet_path();
     writer_context.tablet_schema = &(new_tablet->tablet_schema());
     writer_context.rowset_state = PREPARED;
+    writer_context.data_dir = new_tablet->data_dir();
+    writer_context.io_class = IOClass::COMPACTION;
     writer_context.txn_id = (*base_rowset)->txn_id();
     writer_context.load_id.set_hi((*base_rowset)->load_id().hi());
     writer_context.load_id.set_lo((*base_rowset)->load_id().lo());
-    RowsetWriterSharedPtr rowset_writer(new AlphaRowsetWriter());
-    rowset_writer->init(writer_context);
+    RowsetWriterSharedPtr rowset_writer;
+    RETURN_NOT_OK(RowsetFactory::create_rowset_writer(writer_context, &rowset_writer));
 
     if (!sc_procedure->process(rowset_reader, rowset_writer, new_tablet, base_tablet)) {
         if ((*base_rowset)->is_pending()) {
@@ -1853,7 +1865,7 @@ OLAPStatus SchemaChangeHandler::_convert_historical_rowsets(const SchemaChangePa
 
     bool sc_sorting = false;
     bool sc_directly = false;
-    SchemaChange* sc_procedure = nullptr;
+    std::vector<SchemaChange*> sc_procedures;
 
     // a. 解析Alter请求，转换成内部的表示形式
     OLAPStatus res = _parse_request(sc_params.base_tablet, sc_params.new_tablet,
@@ -1864,109 +1876,71 @@ OLAPStatus SchemaChangeHandler::_convert_historical_rowsets(const SchemaChangePa
     }
 
     // b. 生成历史数据转换器
-    if (sc_sorting) {
-        size_t memory_limitation = config::memory_limitation_per_thread_for_schema_change;
-        LOG(INFO) << "doing schema change with sorting.";
-        sc_procedure = new(nothrow) SchemaChangeWithSorting(rb_changer,
-                                                            memory_limitation * 1024 * 1024 * 1024);
-    } else if (sc_directly) {
-        LOG(INFO) << "doing schema change directly.";
-        sc_procedure = new(nothrow) SchemaChangeDirectly(rb_changer);
-    } else {
-        LOG(INFO) << "doing linked schema change.";
-        sc_procedure = new(nothrow) LinkedSchemaChange(rb_changer);
-    }
+    // rowsets are converted by several threads, each of which has its own SchemaChange
+    // sharing the same RowBlockChanger
+    {
+        int num_threads = std::min<int>(
+                std::max(config::schema_change_convert_thread_num, 1),
+                std::max<int>(sc_params.ref_rowset_readers.size(), 1));
+        LOG(INFO) << "doing " << (sc_sorting ? "schema change with sorting"
+                                  : (sc_directly ? "schema change directly" : "linked schema change"))
+                  << " by " << num_threads << " threads.";
+        for (int i = 0; i < num_threads; ++i) {
+            SchemaChange* sc_procedure = nullptr;
+            if (sc_sorting) {
+                size_t memory_limitation = config::memory_limitation_per_thread_for_schema_change;
+                sc_procedure = new(nothrow) SchemaChangeWithSorting(rb_changer,
+                                                                    memory_limitation * 1024 * 1024 * 1024);
+            } else if (sc_directly) {
+                sc_procedure = new(nothrow) SchemaChangeDirectly(rb_changer);
+            } else {
+                sc_procedure = new(nothrow) LinkedSchemaChange(rb_changer);
+            }
 
-    if (sc_procedure == nullptr) {
-        LOG(WARNING) << "failed to malloc SchemaChange. "
-                     << "malloc_size=" << sizeof(SchemaChangeWithSorting);
-        res = OLAP_ERR_MALLOC_ERROR;
-        goto PROCESS_ALTER_EXIT;
+            if (sc_procedure == nullptr) {
+                LOG(WARNING) << "failed to malloc SchemaChange. "
+                             << "malloc_size=" << sizeof(SchemaChangeWithSorting);
+                res = OLAP_ERR_MALLOC_ERROR;
+                goto PROCESS_ALTER_EXIT;
+            }
+            sc_procedures.push_back(sc_procedure);
+        }
     }
 
     // c. 转换历史数据
-    for (auto& rs_reader : sc_params.ref_rowset_readers) {
-        VLOG(10) << "begin to convert a history rowset. version="
-                 << rs_reader->version().first << "-" << rs_reader->version().second;
-
-        // set status for monitor
-        // 只要有一个new_table为running，ref table就设置为running
-        // NOTE 如果第一个sub_table先fail，这里会继续按正常走
-
-        RowsetId rowset_id = 0;
-        TabletSharedPtr new_tablet = sc_params.new_tablet;
-        res = sc_params.new_tablet->next_rowset_id(&rowset_id);
-        if (res != OLAP_SUCCESS) {
-            LOG(WARNING) << "generate next id failed";
-            goto PROCESS_ALTER_EXIT;
-        }
-
-        RowsetWriterContext writer_context;
-        writer_context.rowset_id = rowset_id;
-        writer_context.tablet_uid = new_tablet->tablet_uid();
-        writer_context.tablet_id = new_tablet->tablet_id();
-        writer_context.partition_id = new_tablet->partition_id();
-        writer_context.tablet_schema_hash = new_tablet->schema_hash();
-        writer_context.rowset_type = ALPHA_ROWSET;
-        writer_context.rowset_path_prefix = new_tablet->tablet_path();
-        writer_context.tablet_schema = &(new_tablet->tablet_schema());
-        writer_context.rowset_state = VISIBLE;
-        writer_context.version = rs_reader->version();
-        writer_context.version_hash = rs_reader->version_hash();
-        RowsetWriterSharedPtr rowset_writer(new AlphaRowsetWriter());
-        OLAPStatus status = rowset_writer->init(writer_context);
-        if (status != OLAP_SUCCESS) {
-            res = OLAP_ERR_ROWSET_BUILDER_INIT;
-            goto PROCESS_ALTER_EXIT;
-        }
-
-        if (!sc_procedure->process(rs_reader, rowset_writer, sc_params.new_tablet, sc_params.base_tablet)) {
-            LOG(WARNING) << "failed to process the version."
-                         << " version=" << rs_reader->version().first
-                         << "-" << rs_reader->version().second;
-            res = OLAP_ERR_INPUT_PARAMETER_ERROR;
-            new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX + std::to_string(rowset_writer->rowset_id()));
-            goto PROCESS_ALTER_EXIT;
+    {
+        std::atomic<size_t> next_reader_idx(0);
+        std::mutex res_lock;
+        auto convert_worker = [&] (SchemaChange* sc_procedure) {
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> l(res_lock);
+                    if (res != OLAP_SUCCESS) {
+                        break;
+                    }
+                }
+                size_t idx = next_reader_idx++;
+                if (idx >= sc_params.ref_rowset_readers.size()) {
+                    break;
+                }
+                OLAPStatus st = _convert_historical_rowset(
+                        sc_params, sc_procedure, sc_params.ref_rowset_readers[idx]);
+                if (st != OLAP_SUCCESS) {
+                    std::lock_guard<std::mutex> l(res_lock);
+                    if (res == OLAP_SUCCESS) {
+                        res = st;
+                    }
+                }
+            }
+        };
+        std::vector<std::thread> convert_threads;
+        for (size_t i = 1; i < sc_procedures.size(); ++i) {
+            convert_threads.emplace_back(convert_worker, sc_procedures[i]);
         }
-        new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX + std::to_string(rowset_writer->rowset_id()));
-        // 将新版本的数据加入header
-        // 为了防止死锁的出现，一定要先锁住旧表，再锁住新表
-        sc_params.new_tablet->obtain_push_lock();
-        RowsetSharedPtr new_rowset = rowset_writer->build();
-        if (new_rowset == nullptr) {
-            LOG(WARNING) << "failed to build rowset, exit alter process";
-            sc_params.new_tablet->release_push_lock();
-            goto PROCESS_ALTER_EXIT;
-        }
-        res = sc_params.new_tablet->add_rowset(new_rowset);
-        if (res == OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
-            LOG(WARNING) << "version already exist, version revert occured. "
-                         << "tablet=" << sc_params.new_tablet->full_name()
-                         << ", version='" << rs_reader->version().first
-                         << "-" << rs_reader->version().second;
-            new_rowset->remove();
-            res = OLAP_SUCCESS;
-        } else if (res != OLAP_SUCCESS) {
-            LOG(WARNING) << "failed to register new version. "
-                         << " tablet=" << sc_params.new_tablet->full_name()
-                         << ", version=" << rs_reader->version().first
-                         << "-" << rs_reader->version().second;
-            new_rowset->remove();
-            sc_params.new_tablet->release_push_lock();
-            goto PROCESS_ALTER_EXIT;
-        } else {
-            VLOG(3) << "register new version. tablet=" << sc_params.new_tablet->full_name()
-                    << ", version=" << rs_reader->version().first
-                    << "-" << rs_reader->version().second;
+        convert_worker(sc_procedures[0]);
+        for (auto& thread : convert_threads) {
+            thread.join();
         }
-        sc_params.new_tablet->release_push_lock();
-
-        VLOG(10) << "succeed to convert a history version."
-                 << " version=" << rs_reader->version().first
-                 << "-" << rs_reader->version().second;
-
-        // 释放RowsetReader
-        rs_reader->close();
     }
     // XXX: 此时应该不取消SchemaChange状态，因为新Delta还要转换成新旧Schema的版本
 PROCESS_ALTER_EXIT:
@@ -1978,7 +1952,9 @@ PROCESS_ALTER_EXIT:
     for (auto& rs_reader : sc_params.ref_rowset_readers) {
         rs_reader->close();
     }
-    SAFE_DELETE(sc_procedure);
+    for (auto sc_procedure : sc_procedures) {
+        delete sc_procedure;
+    }
 
     LOG(INFO) << "finish converting rowsets for new_tablet from base_tablet. "
               << "base_tablet=" << sc_params.base_tablet->full_name()
@@ -1986,6 +1962,89 @@ PROCESS_ALTER_EXIT:
     return res;
 }
 
+OLAPStatus SchemaChangeHandler::_convert_historical_rowset(const SchemaChangeParams& sc_params,
+                                                           SchemaChange* sc_procedure,
+                                                           RowsetReaderSharedPtr rs_reader) {
+    VLOG(10) << "begin to convert a history rowset. version="
+             << rs_reader->version().first << "-" << rs_reader->version().second;
+
+    RowsetId rowset_id = 0;
+    TabletSharedPtr new_tablet = sc_params.new_tablet;
+    OLAPStatus res = sc_params.new_tablet->next_rowset_id(&rowset_id);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "generate next id failed";
+        return res;
+    }
+
+    RowsetWriterContext writer_context;
+    writer_context.rowset_id = rowset_id;
+    writer_context.tablet_uid = new_tablet->tablet_uid();
+    writer_context.tablet_id = new_tablet->tablet_id();
+    writer_context.partition_id = new_tablet->partition_id();
+    writer_context.tablet_schema_hash = new_tablet->schema_hash();
+    writer_context.rowset_type = ALPHA_ROWSET;
+    writer_context.rowset_path_prefix = new_tablet->tablet_path();
+    writer_context.tablet_schema = &(new_tablet->tablet_schema());
+    writer_context.rowset_state = VISIBLE;
+    writer_context.data_dir = new_tablet->data_dir();
+    writer_context.io_class = IOClass::COMPACTION;
+    writer_context.version = rs_reader->version();
+    writer_context.version_hash = rs_reader->version_hash();
+    RowsetWriterSharedPtr rowset_writer;
+    OLAPStatus status = RowsetFactory::create_rowset_writer(writer_context, &rowset_writer);
+    if (status != OLAP_SUCCESS) {
+        return OLAP_ERR_ROWSET_BUILDER_INIT;
+    }
+
+    if (!sc_procedure->process(rs_reader, rowset_writer, sc_params.new_tablet, sc_params.base_tablet)) {
+        LOG(WARNING) << "failed to process the version."
+                     << " version=" << rs_reader->version().first
+                     << "-" << rs_reader->version().second;
+        new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX + std::to_string(rowset_writer->rowset_id()));
+        return OLAP_ERR_INPUT_PARAMETER_ERROR;
+    }
+    new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX + std::to_string(rowset_writer->rowset_id()));
+    // 将新版本的数据加入header
+    // 为了防止死锁的出现，一定要先锁住旧表，再锁住新表
+    sc_params.new_tablet->obtain_push_lock();
+    RowsetSharedPtr new_rowset = rowset_writer->build();
+    if (new_rowset == nullptr) {
+        LOG(WARNING) << "failed to build rowset, exit alter process";
+        sc_params.new_tablet->release_push_lock();
+        return OLAP_ERR_ROWSET_BUILDER_INIT;
+    }
+    res = sc_params.new_tablet->add_rowset(new_rowset);
+    if (res == OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
+        LOG(WARNING) << "version already exist, version revert occured. "
+                     << "tablet=" << sc_params.new_tablet->full_name()
+                     << ", version='" << rs_reader->version().first
+                     << "-" << rs_reader->version().second;
+        new_rowset->remove();
+        res = OLAP_SUCCESS;
+    } else if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "failed to register new version. "
+                     << " tablet=" << sc_params.new_tablet->full_name()
+                     << ", version=" << rs_reader->version().first
+                     << "-" << rs_reader->version().second;
+        new_rowset->remove();
+        sc_params.new_tablet->release_push_lock();
+        return res;
+    } else {
+        VLOG(3) << "register new version. tablet=" << sc_params.new_tablet->full_name()
+                << ", version=" << rs_reader->version().first
+                << "-" << rs_reader->version().second;
+    }
+    sc_params.new_tablet->release_push_lock();
+
+    VLOG(10) << "succeed to convert a history version."
+             << " version=" << rs_reader->version().first
+             << "-" << rs_reader->version().second;
+
+    // 释放RowsetReader
+    rs_reader->close();
+    return OLAP_SUCCESS;
+}
+
 // @static
 // 分析column的mapping以及filter key的mapping
 OLAPStatus SchemaChangeHandler::_parse_request(TabletSharedPtr base_tablet,
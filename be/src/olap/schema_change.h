@@ -253,6 +253,11 @@ private:
 
     static OLAPStatus _convert_historical_rowsets(const SchemaChangeParams& sc_params);
 
+    // convert one rowset of base tablet by 'sc_procedure' and add it to new tablet
+    static OLAPStatus _convert_historical_rowset(const SchemaChangeParams& sc_params,
+                                                 SchemaChange* sc_procedure,
+                                                 RowsetReaderSharedPtr rs_reader);
+
     static OLAPStatus _parse_request(TabletSharedPtr base_tablet,
                                      TabletSharedPtr new_tablet,
                                      RowBlockChanger* rb_changer,
@@ -0,0 +1,62 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/segment_cache.h"
+
+#include "olap/rowset/segment_v2/segment.h"
+
+namespace doris {
+
+// This should only be used in unit test. 256MB
+static SegmentCache s_ut_cache(268435456);
+
+SegmentCache* SegmentCache::_s_instance = &s_ut_cache;
+
+void SegmentCache::create_global_cache(size_t capacity) {
+    if (_s_instance == &s_ut_cache) {
+        _s_instance = new SegmentCache(capacity);
+    }
+}
+
+SegmentCache::SegmentCache(size_t capacity) : _cache(new_lru_cache(capacity)) {
+}
+
+std::shared_ptr<segment_v2::Segment> SegmentCache::lookup(const CacheKey& key) {
+    auto lru_handle = _cache->lookup(key.encode());
+    if (lru_handle == nullptr) {
+        return nullptr;
+    }
+    auto segment = *reinterpret_cast<std::shared_ptr<segment_v2::Segment>*>(_cache->value(lru_handle));
+    _cache->release(lru_handle);
+    return segment;
+}
+
+void SegmentCache::insert(const CacheKey& key, std::shared_ptr<segment_v2::Segment> segment,
+                          size_t charge) {
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        delete reinterpret_cast<std::shared_ptr<segment_v2::Segment>*>(value);
+    };
+    auto value = new std::shared_ptr<segment_v2::Segment>(std::move(segment));
+    auto lru_handle = _cache->insert(key.encode(), value, charge, deleter);
+    _cache->release(lru_handle);
+}
+
+void SegmentCache::erase(const CacheKey& key) {
+    _cache->erase(key.encode());
+}
+
+}
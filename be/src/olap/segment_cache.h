@@ -0,0 +1,85 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
+#include "olap/lru_cache.h"
+#include "olap/olap_common.h"
+
+namespace doris {
+
+namespace segment_v2 {
+class Segment;
+}
+
+// BE-wide cache of opened segment_v2 Segments. An opened Segment holds the parsed
+// footer, the column readers and the short key index of a segment file, building
+// them costs several IOs and protobuf parsing, so short queries on tablets with
+// many rowsets spend most of their time in Segment::open without this cache.
+//
+// Entries are keyed by rowset id and segment id, and are charged by the memory
+// used by the segment. Segments are shared with readers by shared_ptr, so an
+// evicted segment lives until the last reader using it is destroyed.
+// Rowsets must erase their segments when they are removed.
+class SegmentCache {
+public:
+    struct CacheKey {
+        CacheKey(RowsetId rowset_id_, uint32_t segment_id_)
+            : rowset_id(rowset_id_), segment_id(segment_id_) { }
+        RowsetId rowset_id;
+        uint32_t segment_id;
+
+        // Encode to a flat binary which can be used as LRUCache's key
+        std::string encode() const {
+            std::string key_buf((char*)&rowset_id, sizeof(rowset_id));
+            key_buf.append((char*)&segment_id, sizeof(segment_id));
+            return key_buf;
+        }
+    };
+
+    // Create global instance of this class
+    static void create_global_cache(size_t capacity);
+
+    // Return global instance.
+    // Client should call create_global_cache before.
+    static SegmentCache* instance() { return _s_instance; }
+
+    SegmentCache(size_t capacity);
+
+    // Lookup the segment of the given key, return nullptr if not found.
+    std::shared_ptr<segment_v2::Segment> lookup(const CacheKey& key);
+
+    // Insert an opened segment into this cache, charge is the memory used by it.
+    // If the key is already cached, the old entry is replaced.
+    void insert(const CacheKey& key, std::shared_ptr<segment_v2::Segment> segment, size_t charge);
+
+    // Remove the segment of the given key from this cache.
+    void erase(const CacheKey& key);
+
+private:
+    static SegmentCache* _s_instance;
+
+    std::unique_ptr<Cache> _cache = nullptr;
+
+    DISALLOW_COPY_AND_ASSIGN(SegmentCache);
+};
+
+}
@@ -17,9 +17,12 @@
 
 #include "olap/short_key_index.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "util/coding.h"
+#include "gutil/endian.h"
 #include "gutil/strings/substitute.h"
 
 using strings::Substitute;
@@ -111,7 +114,48 @@ Status ShortKeyIndexDecoder::parse() {
         return Status::Corruption("Still has data after parse all key offset");
     }
 
+    std::vector<uint64_t> prefixes(num_items());
+    for (uint32_t i = 0; i < num_items(); ++i) {
+        prefixes[i] = _encode_prefix(key(i));
+    }
+    _eytzinger_prefixes.resize(num_items() + 1);
+    _eytzinger_ordinals.resize(num_items() + 1);
+    _build_eytzinger(prefixes, 0, 1);
+
     return Status::OK();
 }
 
+uint64_t ShortKeyIndexDecoder::_encode_prefix(const Slice& key) {
+    uint8_t buf[sizeof(uint64_t)] = {0};
+    memcpy(buf, key.data, std::min(key.size, sizeof(uint64_t)));
+    return BigEndian::Load64(buf);
+}
+
+uint32_t ShortKeyIndexDecoder::_build_eytzinger(const std::vector<uint64_t>& prefixes,
+                                                uint32_t ordinal, uint32_t k) {
+    // in-order traversal of the tree visits keys in sorted order
+    if (k <= num_items()) {
+        ordinal = _build_eytzinger(prefixes, ordinal, 2 * k);
+        _eytzinger_prefixes[k] = prefixes[ordinal];
+        _eytzinger_ordinals[k] = ordinal;
+        ordinal++;
+        ordinal = _build_eytzinger(prefixes, ordinal, 2 * k + 1);
+    }
+    return ordinal;
+}
+
+uint32_t ShortKeyIndexDecoder::_prefix_lower_bound(uint64_t prefix) const {
+    uint32_t n = num_items();
+    uint32_t k = 1;
+    while (k <= n) {
+        // prefetch the 16 consecutive descendants 4 levels below
+        __builtin_prefetch(_eytzinger_prefixes.data() + std::min(16 * k, n));
+        k = 2 * k + (_eytzinger_prefixes[k] < prefix);
+    }
+    // k went right at every level after the answer node, cancel these moves
+    // and the last left move to get the answer node.
+    k >>= __builtin_ffs(~static_cast<int>(k));
+    return k == 0 ? n : _eytzinger_ordinals[k];
+}
+
 }
@@ -204,6 +204,10 @@ private:
 };
 
 // Used to decode short key to header and encoded index data.
+// To make seek cache friendly, decoder keeps the first 8 bytes of every key as
+// a big endian integer in an array of Eytzinger layout, that is a binary search
+// tree stored in BFS order. Seek searches this array first to get the range of
+// keys sharing the same prefix, and then compares full keys only in the range.
 // Usage:
 //      MemIndex index;
 //      ShortKeyIndexDecoder decoder(slice)
@@ -247,13 +251,30 @@ private:
         auto comparator = [this] (const Slice& lhs, const Slice& rhs) {
             return lhs.compare(rhs) < 0;
         };
+        // Keys whose prefix is less than key's are always less than key, and keys
+        // whose prefix is greater are always greater, so only keys in
+        // [first, last) need to be compared.
+        uint64_t prefix = _encode_prefix(key);
+        ShortKeyIndexIterator first(this, _prefix_lower_bound(prefix));
+        ShortKeyIndexIterator last(this,
+            prefix == UINT64_MAX ? num_items() : _prefix_lower_bound(prefix + 1));
         if (lower_bound) {
-            return std::lower_bound(begin(), end(), key, comparator);
+            return std::lower_bound(first, last, key, comparator);
         } else {
-            return std::upper_bound(begin(), end(), key, comparator);
+            return std::upper_bound(first, last, key, comparator);
         }
     }
 
+    // Return first 8 bytes of key as big endian integer, padding 0 if key is
+    // shorter than 8 bytes. Order of prefixes is consistent with order of keys.
+    static uint64_t _encode_prefix(const Slice& key);
+
+    // Build _eytzinger_prefixes and _eytzinger_ordinals from sorted prefixes.
+    uint32_t _build_eytzinger(const std::vector<uint64_t>& prefixes, uint32_t ordinal, uint32_t k);
+
+    // Return ordinal of the first key whose prefix is not less than the given one.
+    uint32_t _prefix_lower_bound(uint64_t prefix) const;
+
 private:
     Slice _data;
 
@@ -261,6 +282,11 @@ private:
     segment_v2::ShortKeyFooterPB _footer;
     std::vector<uint32_t> _offsets;
     Slice _key_data;
+    // prefixes of keys in Eytzinger layout, node k's children are 2k and 2k+1,
+    // and index 0 is unused
+    std::vector<uint64_t> _eytzinger_prefixes;
+    // ordinal of key of every node in _eytzinger_prefixes
+    std::vector<uint32_t> _eytzinger_ordinals;
 };
 
 inline Slice ShortKeyIndexIterator::operator*() const {
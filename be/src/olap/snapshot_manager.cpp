@@ -374,7 +374,6 @@ OLAPStatus SnapshotManager::_create_snapshot_files(
     path boost_path(snapshot_id_path);
     string snapshot_id = canonical(boost_path).string();
     do {
-        DataDir* data_dir = ref_tablet->data_dir();
         TabletMetaSharedPtr new_tablet_meta(new (nothrow) TabletMeta());
         if (new_tablet_meta == nullptr) {
             LOG(WARNING) << "fail to malloc TabletMeta.";
@@ -382,6 +381,7 @@ OLAPStatus SnapshotManager::_create_snapshot_files(
             break;
         }
         vector<RowsetSharedPtr> consistent_rowsets;
+        TabletMetaPB tablet_meta_pb;
         if (request.__isset.missing_version) {
             ReadLock rdlock(ref_tablet->get_header_lock_ptr());
             for (int64_t missed_version : request.missing_version) {
@@ -401,11 +401,12 @@ OLAPStatus SnapshotManager::_create_snapshot_files(
             if (res != OLAP_SUCCESS) {
                 break;
             }
-            res = TabletMetaManager::get_meta(data_dir, ref_tablet->tablet_id(),
-                                                ref_tablet->schema_hash(), new_tablet_meta);
+            // copy meta in memory instead of loading it from meta store, which
+            // is consistent with the rowsets captured under the same lock
+            res = ref_tablet->tablet_meta()->to_meta_pb(&tablet_meta_pb);
             if (res != OLAP_SUCCESS) {
-                LOG(WARNING) << "fail to load header. res=" << res
-                             << " tablet_id=" << ref_tablet->tablet_id() 
+                LOG(WARNING) << "fail to copy tablet meta. res=" << res
+                             << " tablet_id=" << ref_tablet->tablet_id()
                              << " schema_hash=" << ref_tablet->schema_hash();
                 break;
             }
@@ -445,16 +446,26 @@ OLAPStatus SnapshotManager::_create_snapshot_files(
                 break;
             }
 
-            res = TabletMetaManager::get_meta(data_dir, ref_tablet->tablet_id(),
-                                                ref_tablet->schema_hash(), new_tablet_meta);
+            // copy meta in memory instead of loading it from meta store, which
+            // is consistent with the rowsets captured under the same lock
+            res = ref_tablet->tablet_meta()->to_meta_pb(&tablet_meta_pb);
             if (res != OLAP_SUCCESS) {
-                LOG(WARNING) << "fail to load header. res=" << res
-                             << " tablet_id=" << ref_tablet->tablet_id() 
+                LOG(WARNING) << "fail to copy tablet meta. res=" << res
+                             << " tablet_id=" << ref_tablet->tablet_id()
                              << " schema_hash=" << ref_tablet->schema_hash();
                 break;
             }
         }
 
+        // deserialize meta after header lock is released
+        res = new_tablet_meta->init_from_pb(tablet_meta_pb);
+        if (res != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to init tablet meta. res=" << res
+                         << " tablet_id=" << ref_tablet->tablet_id()
+                         << " schema_hash=" << ref_tablet->schema_hash();
+            break;
+        }
+
         vector<RowsetMetaSharedPtr> rs_metas;
         for (auto& rs : consistent_rowsets) {
             res = rs->link_files_to(schema_full_path, rs->rowset_id());
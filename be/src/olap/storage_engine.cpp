@@ -164,15 +164,32 @@ void StorageEngine::load_data_dirs(const std::vector<DataDir*>& data_dirs) {
 
 OLAPStatus StorageEngine::open() {
     // init store_map
+    // stores are independent from each other, init them in parallel because
+    // opening meta of a store may take a long time
+    std::vector<DataDir*> stores;
     for (auto& path : _options.store_paths) {
-        DataDir* store = new DataDir(path.path, path.capacity_bytes,
-                _tablet_manager.get(), _txn_manager.get());
-        auto st = store->init();
-        if (!st.ok()) {
-            LOG(WARNING) << "Store load failed, path=" << path.path;
+        stores.push_back(new DataDir(path.path, path.capacity_bytes,
+                _tablet_manager.get(), _txn_manager.get()));
+    }
+    std::vector<Status> init_status(stores.size());
+    std::vector<std::thread> init_threads;
+    for (size_t i = 0; i < stores.size(); ++i) {
+        init_threads.emplace_back([&stores, &init_status, i] {
+            init_status[i] = stores[i]->init();
+        });
+    }
+    for (auto& thread : init_threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < stores.size(); ++i) {
+        if (!init_status[i].ok()) {
+            LOG(WARNING) << "Store load failed, path=" << stores[i]->path();
+            for (size_t j = i; j < stores.size(); ++j) {
+                delete stores[j];
+            }
             return OLAP_ERR_INVALID_ROOT_PATH;
         }
-        _store_map.emplace(path.path, store);
+        _store_map.emplace(stores[i]->path(), stores[i]);
     }
     _effective_cluster_id = config::cluster_id;
     auto res = check_all_root_path_cluster_id();
@@ -565,37 +582,51 @@ void StorageEngine::start_clean_fd_cache() {
 void StorageEngine::perform_cumulative_compaction(DataDir* data_dir) {
     TabletSharedPtr best_tablet = _tablet_manager->find_best_tablet_to_compaction(CompactionType::CUMULATIVE_COMPACTION, data_dir);
     if (best_tablet == nullptr) { return; }
+    _perform_cumulative_compaction(best_tablet);
+}
 
+void StorageEngine::_perform_cumulative_compaction(TabletSharedPtr tablet) {
     DorisMetrics::cumulative_compaction_request_total.increment(1);
-    CumulativeCompaction cumulative_compaction(best_tablet);
+    CumulativeCompaction cumulative_compaction(tablet);
 
+    MonotonicStopWatch watch;
+    watch.start();
     OLAPStatus res = cumulative_compaction.compact();
+    DorisMetrics::cumulative_compaction_latency_ms.add(watch.elapsed_time() / 1000000);
+    DorisMetrics::cumulative_compaction_latency_us.add(watch.elapsed_time() / 1000);
     if (res != OLAP_SUCCESS) {
         DorisMetrics::cumulative_compaction_request_failed.increment(1);
-        best_tablet->set_last_compaction_failure_time(UnixMillis());
+        tablet->set_last_compaction_failure_time(UnixMillis());
         LOG(WARNING) << "failed to do cumulative compaction. res=" << res
-                     << ", table=" << best_tablet->full_name()
+                     << ", table=" << tablet->full_name()
                      << ", res=" << res;
         return;
     }
-    best_tablet->set_last_compaction_failure_time(0);
+    tablet->set_last_compaction_failure_time(0);
 }
 
 void StorageEngine::perform_base_compaction(DataDir* data_dir) {
     TabletSharedPtr best_tablet = _tablet_manager->find_best_tablet_to_compaction(CompactionType::BASE_COMPACTION, data_dir);
     if (best_tablet == nullptr) { return; }
+    _perform_base_compaction(best_tablet);
+}
 
+void StorageEngine::_perform_base_compaction(TabletSharedPtr tablet) {
     DorisMetrics::base_compaction_request_total.increment(1);
-    BaseCompaction base_compaction(best_tablet);
+    BaseCompaction base_compaction(tablet);
+    MonotonicStopWatch watch;
+    watch.start();
     OLAPStatus res = base_compaction.compact();
+    DorisMetrics::base_compaction_latency_ms.add(watch.elapsed_time() / 1000000);
+    DorisMetrics::base_compaction_latency_us.add(watch.elapsed_time() / 1000);
     if (res != OLAP_SUCCESS) {
         DorisMetrics::base_compaction_request_failed.increment(1);
-        best_tablet->set_last_compaction_failure_time(UnixMillis());
+        tablet->set_last_compaction_failure_time(UnixMillis());
         LOG(WARNING) << "failed to init base compaction. res=" << res
-                     << ", table=" << best_tablet->full_name();
+                     << ", table=" << tablet->full_name();
         return;
     }
-    best_tablet->set_last_compaction_failure_time(0);
+    tablet->set_last_compaction_failure_time(0);
 }
 
 void StorageEngine::get_cache_status(rapidjson::Document* document) const {
@@ -634,8 +665,10 @@ OLAPStatus StorageEngine::start_trash_sweep(double* usage) {
         *usage = *usage > curr_usage ? *usage : curr_usage;
 
         OLAPStatus curr_res = OLAP_SUCCESS;
+        DataDir* data_dir = get_store(info.path);
+        IOScheduler* io_scheduler = data_dir != nullptr ? data_dir->io_scheduler() : nullptr;
         string snapshot_path = info.path + SNAPSHOT_PREFIX;
-        curr_res = _do_sweep(snapshot_path, local_now, snapshot_expire);
+        curr_res = _do_sweep(snapshot_path, local_now, snapshot_expire, io_scheduler);
         if (curr_res != OLAP_SUCCESS) {
             LOG(WARNING) << "failed to sweep snapshot. path=" << snapshot_path
                     << ", err_code=" << curr_res;
@@ -644,7 +677,7 @@ OLAPStatus StorageEngine::start_trash_sweep(double* usage) {
 
         string trash_path = info.path + TRASH_PREFIX;
         curr_res = _do_sweep(trash_path, local_now,
-                curr_usage > guard_space ? 0 : trash_expire);
+                curr_usage > guard_space ? 0 : trash_expire, io_scheduler);
         if (curr_res != OLAP_SUCCESS) {
             LOG(WARNING) << "failed to sweep trash. [path=%s" << trash_path
                     << ", err_code=" << curr_res;
@@ -679,7 +712,8 @@ void StorageEngine::_clean_unused_txns() {
 }
 
 OLAPStatus StorageEngine::_do_sweep(
-        const string& scan_root, const time_t& local_now, const uint32_t expire) {
+        const string& scan_root, const time_t& local_now, const uint32_t expire,
+        IOScheduler* io_scheduler) {
     OLAPStatus res = OLAP_SUCCESS;
     if (!check_dir_existed(scan_root)) {
         // dir not existed. no need to sweep trash.
@@ -701,6 +735,9 @@ OLAPStatus StorageEngine::_do_sweep(
                 continue;
             }
             if (difftime(local_now, mktime(&local_tm_create)) >= expire) {
+                if (io_scheduler != nullptr) {
+                    io_scheduler->acquire(IOClass::GC, 1);
+                }
                 if (remove_all_dir(path_name) != OLAP_SUCCESS) {
                     LOG(WARNING) << "fail to remove file or directory. path=" << path_name;
                     res = OLAP_ERR_OS_ERROR;
@@ -726,6 +763,11 @@ void StorageEngine::start_delete_unused_rowset() {
                     << ", version:" << it->second->version().first << "-" << it->second->version().second;
             OLAPStatus status = it->second->remove();
             LOG(INFO) << "remove rowset:" << it->second->rowset_id() << " finished. status:" << status;
+            // files left by failed removal are collected by path gc later
+            if (status == OLAP_SUCCESS && it->second->data_dir() != nullptr) {
+                it->second->data_dir()->remove_gc_candidate_rowset(
+                        it->second->rowset_path(), it->second->rowset_id());
+            }
             it = _unused_rowsets.erase(it);
         }
     }
@@ -741,6 +783,11 @@ void StorageEngine::add_unused_rowset(RowsetSharedPtr rowset) {
             << ", unique id:" << rowset->unique_id();
     auto it = _unused_rowsets.find(rowset->unique_id());
     if (it == _unused_rowsets.end()) {
+        // persist the rowset before removing its files, so that files left by
+        // a crash or failed removal are collected without full path scan
+        if (rowset->data_dir() != nullptr) {
+            rowset->data_dir()->add_gc_candidate_rowset(rowset->rowset_path(), rowset->rowset_id());
+        }
         rowset->set_need_delete_file();
         _unused_rowsets[rowset->unique_id()] = rowset;
     }
@@ -937,18 +984,14 @@ void* StorageEngine::_path_gc_thread_callback(void* arg) {
 #endif
 
     LOG(INFO) << "try to start path gc thread!";
-    uint32_t interval = config::path_gc_check_interval_second;
-    if (interval <= 0) {
-        LOG(WARNING) << "path gc thread check interval config is illegal:" << interval
-            << "will be forced set to half hour";
-        interval = 1800; // 0.5 hour
-    }
-
+    DataDir* data_dir = (DataDir*)arg;
     while (true) {
-        LOG(INFO) << "try to perform path gc!";
-        // perform path gc by rowset id
-        ((DataDir*)arg)->perform_path_gc_by_rowsetid();
-        usleep(interval * 1000000);
+        // files of unused rowsets are checked frequently, while all files in
+        // data dir are only checked after each full path scan. Both yield to
+        // queries by the gc io class of data dir.
+        data_dir->perform_path_gc_by_candidates();
+        // wait at most path_gc_check_interval_second for full path scan
+        data_dir->perform_path_gc_by_rowsetid();
     }
 
     return nullptr;
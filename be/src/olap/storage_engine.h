@@ -46,11 +46,13 @@
 #include "olap/tablet_manager.h"
 #include "olap/txn_manager.h"
 #include "olap/task/engine_task.h"
+#include "util/thread_pool.hpp"
 
 namespace doris {
 
 class Tablet;
 class DataDir;
+class IOScheduler;
 class EngineTask;
 
 // StorageEngine singleton to manage all Table pointers.
@@ -194,6 +196,11 @@ public:
 
     bool check_rowset_id_in_unused_rowsets(RowsetId rowset_id);
 
+    // Submit a task building the primary key index of 'tablet', return false
+    // if it's not submitted because merge-on-write is disabled or too many
+    // builds are waiting.
+    bool submit_primary_key_index_build(const TabletSharedPtr& tablet);
+
 private:
     OLAPStatus check_all_root_path_cluster_id();
 
@@ -218,7 +225,8 @@ private:
     void _clean_unused_txns();
     
     OLAPStatus _do_sweep(
-            const std::string& scan_root, const time_t& local_tm_now, const uint32_t expire);
+            const std::string& scan_root, const time_t& local_tm_now, const uint32_t expire,
+            IOScheduler* io_scheduler);
 
     // Thread functions
     // unused rowset monitor thread
@@ -236,6 +244,16 @@ private:
     // cumulative process function
     void* _cumulative_compaction_thread_callback(void* arg, DataDir* data_dir);
 
+    // compaction scheduler thread process function, which scores tablets of
+    // all disks and hands out compaction tasks to _compaction_task_pool
+    void* _compaction_scheduler_thread_callback(void* arg);
+    void _schedule_compaction_tasks();
+    void _run_compaction_task(TabletSharedPtr tablet, CompactionType compaction_type);
+    void _build_primary_key_index(TabletSharedPtr tablet);
+
+    void _perform_cumulative_compaction(TabletSharedPtr tablet);
+    void _perform_base_compaction(TabletSharedPtr tablet);
+
     // clean file descriptors cache
     void* _fd_cache_clean_callback(void* arg);
 
@@ -315,6 +333,23 @@ private:
     // thread to check cumulative
     std::vector<std::thread> _cumulative_compaction_threads;
 
+    // global compaction scheduler, used instead of above threads when
+    // config::enable_compaction_scheduler is true
+    std::thread _compaction_scheduler_thread;
+    std::unique_ptr<ThreadPool> _compaction_task_pool;
+    int32_t _compaction_task_num_threads = 0;
+    // protect following members, _compaction_cond is notified when a task finishes
+    std::mutex _compaction_mutex;
+    std::condition_variable _compaction_cond;
+    int32_t _running_compaction_task_num = 0;
+    std::map<DataDir*, int32_t> _running_compaction_task_num_per_disk;
+    // tablets which have a scheduled compaction task
+    std::set<int64_t> _compacting_tablets;
+
+    // builds primary key indexes of merge-on-write tablets, created if
+    // config::enable_merge_on_write is true
+    std::unique_ptr<ThreadPool> _primary_key_index_build_pool;
+
     std::thread _fd_cache_clean_thread;
 
     std::vector<std::thread> _path_gc_threads;
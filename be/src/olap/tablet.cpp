@@ -36,6 +36,7 @@
 #include "olap/rowset/alpha_rowset.h"
 #include "olap/tablet_meta_manager.h"
 #include "olap/utils.h"
+#include "util/stopwatch.hpp"
 #include "util/time.h"
 
 namespace doris {
@@ -95,7 +96,10 @@ Tablet::Tablet(TabletMetaSharedPtr tablet_meta, DataDir* data_dir)
     _schema(tablet_meta->tablet_schema()),
     _data_dir(data_dir),
     _is_bad(false),
-    _last_compaction_failure_time(UnixMillis()) {
+    _last_compaction_failure_time(UnixMillis()),
+    _query_count(0),
+    _last_query_count(0),
+    _query_load(0) {
     _tablet_path.append(_data_dir->path());
     _tablet_path.append(DATA_PREFIX);
     _tablet_path.append("/");
@@ -152,6 +156,20 @@ OLAPStatus Tablet::init_once() {
 
     _cumulative_point = -1;
 
+    if (config::enable_merge_on_write && keys_type() == UNIQUE_KEYS) {
+        // superseded rows are skipped rather than aggregated, so columns which
+        // keep values of older rows are not supported
+        bool has_replace_if_not_null = false;
+        for (size_t i = 0; i < num_columns(); ++i) {
+            if (_schema.column(i).aggregation() == OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL) {
+                has_replace_if_not_null = true;
+            }
+        }
+        // the index is built in background when the tablet is first queried,
+        // so that loading tablets doesn't scan their rowsets
+        _merge_on_write = !has_replace_if_not_null;
+    }
+
     return res;
 }
 
@@ -254,6 +272,7 @@ OLAPStatus Tablet::revise_tablet_meta(
     }
 
     _rs_graph.reconstruct_rowset_graph(_tablet_meta->all_rs_metas());
+    _drop_primary_key_index();
 
     LOG(INFO) << "finish to clone data to tablet. res=" << res << ", "
               << "table=" << full_name() << ", "
@@ -270,12 +289,15 @@ OLAPStatus Tablet::deregister_tablet_from_dir() {
 }
 
 OLAPStatus Tablet::add_rowset(RowsetSharedPtr rowset) {
-    WriteLock wrlock(&_meta_lock);
-    RETURN_NOT_OK(_check_added_rowset(rowset));
-    RETURN_NOT_OK(_tablet_meta->add_rs_meta(rowset->rowset_meta()));
-    _rs_version_map[rowset->version()] = rowset;
-    RETURN_NOT_OK(_rs_graph.add_version_to_graph(rowset->version()));
-    RETURN_NOT_OK(save_meta());
+    {
+        WriteLock wrlock(&_meta_lock);
+        RETURN_NOT_OK(_check_added_rowset(rowset));
+        RETURN_NOT_OK(_tablet_meta->add_rs_meta(rowset->rowset_meta()));
+        _rs_version_map[rowset->version()] = rowset;
+        RETURN_NOT_OK(_rs_graph.add_version_to_graph(rowset->version()));
+        RETURN_NOT_OK(save_meta());
+    }
+    _add_rowset_to_primary_key_index(rowset);
     return OLAP_SUCCESS;
 }
 
@@ -364,15 +386,19 @@ RowsetSharedPtr Tablet::rowset_with_largest_size() {
 }
 
 OLAPStatus Tablet::add_inc_rowset(const RowsetSharedPtr& rowset) {
-    WriteLock wrlock(&_meta_lock);
-    // check if the rowset id is valid
-    RETURN_NOT_OK(_check_added_rowset(rowset));
-    RETURN_NOT_OK(_tablet_meta->add_rs_meta(rowset->rowset_meta()));
-    _rs_version_map[rowset->version()] = rowset;
-    _inc_rs_version_map[rowset->version()] = rowset;
-    RETURN_NOT_OK(_rs_graph.add_version_to_graph(rowset->version()));
-    RETURN_NOT_OK(_tablet_meta->add_inc_rs_meta(rowset->rowset_meta()));
-    RETURN_NOT_OK(_tablet_meta->save_meta(_data_dir));
+    {
+        WriteLock wrlock(&_meta_lock);
+        // check if the rowset id is valid
+        RETURN_NOT_OK(_check_added_rowset(rowset));
+        RETURN_NOT_OK(_tablet_meta->add_rs_meta(rowset->rowset_meta()));
+        _rs_version_map[rowset->version()] = rowset;
+        _inc_rs_version_map[rowset->version()] = rowset;
+        RETURN_NOT_OK(_rs_graph.add_version_to_graph(rowset->version()));
+        RETURN_NOT_OK(_tablet_meta->add_inc_rs_meta(rowset->rowset_meta()));
+        RETURN_NOT_OK(_tablet_meta->save_meta(_data_dir));
+    }
+    // queries of the new version merge rowsets until the index is updated
+    _add_rowset_to_primary_key_index(rowset);
     return OLAP_SUCCESS;
 }
 
@@ -536,6 +562,10 @@ bool Tablet::version_for_delete_predicate(const Version& version) {
     return _tablet_meta->version_for_delete_predicate(version);
 }
 
+bool Tablet::has_delete_predicate_until(int64_t version) {
+    return _tablet_meta->has_delete_predicate_until(version);
+}
+
 bool Tablet::version_for_load_deletion(const Version& version) {
     RowsetSharedPtr rowset = _rs_version_map.at(version);
     return rowset->delete_flag();
@@ -1001,4 +1031,138 @@ void Tablet::pick_candicate_rowsets_to_base_compaction(std::vector<RowsetSharedP
     }
 }
 
+std::shared_ptr<PrimaryKeyIndex> Tablet::primary_key_index() {
+    {
+        std::lock_guard<std::mutex> l(_primary_key_index_lock);
+        if (_primary_key_index != nullptr || !_merge_on_write || _primary_key_index_building) {
+            return _primary_key_index;
+        }
+        _primary_key_index_building = true;
+    }
+    StorageEngine* engine = StorageEngine::instance();
+    if (engine == nullptr || !engine->submit_primary_key_index_build(shared_from_this())) {
+        std::lock_guard<std::mutex> l(_primary_key_index_lock);
+        _primary_key_index_building = false;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<PrimaryKeyIndex> Tablet::_get_primary_key_index() {
+    std::lock_guard<std::mutex> l(_primary_key_index_lock);
+    return _primary_key_index;
+}
+
+void Tablet::update_primary_key_index(const std::vector<RowsetSharedPtr>& input_rowsets,
+                                      const RowsetSharedPtr& output_rowset) {
+    std::shared_ptr<PrimaryKeyIndex> index = _get_primary_key_index();
+    if (index == nullptr) {
+        return;
+    }
+    OLAPStatus res = index->replace_rowsets(input_rowsets, output_rowset);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to update primary key index after compaction, drop it. tablet="
+                     << full_name() << ", res=" << res;
+        _drop_primary_key_index();
+    }
+}
+
+OLAPStatus Tablet::_catch_up_primary_key_index(PrimaryKeyIndex* index) {
+    vector<RowsetSharedPtr> rowsets;
+    {
+        ReadLock rdlock(&_meta_lock);
+        int64_t max = max_version().second;
+        if (max <= index->max_version()) {
+            return OLAP_SUCCESS;
+        }
+        RETURN_NOT_OK(capture_consistent_rowsets(Version(index->max_version() + 1, max), &rowsets));
+    }
+    for (auto& rowset : rowsets) {
+        RETURN_NOT_OK(index->add_rowset(rowset));
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus Tablet::build_primary_key_index() {
+    // Rounds of catching up with loads, and of building the index again if
+    // rowsets are compacted or cloned while being indexed
+    static const int kMaxBuildRounds = 10;
+    MonotonicStopWatch watch;
+    watch.start();
+    OLAPStatus res = OLAP_SUCCESS;
+    std::shared_ptr<PrimaryKeyIndex> index(new PrimaryKeyIndex(&_schema));
+    for (int round = 0; round < kMaxBuildRounds; ++round) {
+        res = _catch_up_primary_key_index(index.get());
+        if (res == OLAP_ERR_VERSION_ALREADY_MERGED || res == OLAP_ERR_CAPTURE_ROWSET_ERROR) {
+            // indexed rowsets are compacted
+            index.reset(new PrimaryKeyIndex(&_schema));
+            continue;
+        }
+        if (res != OLAP_SUCCESS) {
+            break;
+        }
+        ReadLock rdlock(&_meta_lock);
+        int64_t max = max_version().second;
+        if (max != index->max_version()) {
+            // loaded while being indexed
+            continue;
+        }
+        vector<RowsetSharedPtr> rowsets;
+        if (max >= 0) {
+            res = capture_consistent_rowsets(Version(0, max), &rowsets);
+            if (res != OLAP_SUCCESS) {
+                break;
+            }
+        }
+        if (!index->covers(rowsets)) {
+            // compacted or cloned while being indexed
+            index.reset(new PrimaryKeyIndex(&_schema));
+            continue;
+        }
+        // publish and compaction update the index after releasing header
+        // lock, so they see it if their rowsets are not indexed yet
+        std::lock_guard<std::mutex> l(_primary_key_index_lock);
+        _primary_key_index = index;
+        _primary_key_index_building = false;
+        LOG(INFO) << "build primary key index. tablet=" << full_name()
+                  << ", rowsets=" << rowsets.size() << ", keys=" << index->num_keys()
+                  << ", cost_ms=" << watch.elapsed_time() / 1000000;
+        return OLAP_SUCCESS;
+    }
+
+    std::lock_guard<std::mutex> l(_primary_key_index_lock);
+    _primary_key_index_building = false;
+    if (res == OLAP_SUCCESS) {
+        // busy loading, try again by a later query
+        LOG(INFO) << "primary key index can't catch up with loads, build it later. tablet="
+                  << full_name();
+        return OLAP_ERR_OTHER_ERROR;
+    }
+    if (res == OLAP_ERR_ROWSET_TYPE_NOT_FOUND) {
+        // rowsets can't be indexed, don't try again
+        _merge_on_write = false;
+    }
+    LOG(WARNING) << "fail to build primary key index. tablet=" << full_name()
+                 << ", res=" << res;
+    return res;
+}
+
+void Tablet::_add_rowset_to_primary_key_index(const RowsetSharedPtr& rowset) {
+    std::shared_ptr<PrimaryKeyIndex> index = _get_primary_key_index();
+    if (index == nullptr || rowset->end_version() <= index->max_version()) {
+        // being built, or built after the rowset is added
+        return;
+    }
+    OLAPStatus res = index->add_rowset(rowset);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to add rowset to primary key index, drop it. tablet=" << full_name()
+                     << ", rowset_id=" << rowset->rowset_id() << ", res=" << res;
+        _drop_primary_key_index();
+    }
+}
+
+void Tablet::_drop_primary_key_index() {
+    std::lock_guard<std::mutex> l(_primary_key_index_lock);
+    _primary_key_index.reset();
+}
+
 }  // namespace doris
@@ -20,6 +20,7 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -28,6 +29,7 @@
 #include "gen_cpp/AgentService_types.h"
 #include "gen_cpp/olap_file.pb.h"
 #include "olap/olap_define.h"
+#include "olap/primary_key_index.h"
 #include "olap/tuple.h"
 #include "olap/rowset_graph.h"
 #include "olap/rowset/rowset.h"
@@ -142,6 +144,7 @@ public:
     DelPredicateArray delete_predicates() { return _tablet_meta->delete_predicates(); }
     OLAPStatus add_delete_predicate(const DeletePredicatePB& delete_predicate, int64_t version);
     bool version_for_delete_predicate(const Version& version);
+    bool has_delete_predicate_until(int64_t version);
     bool version_for_load_deletion(const Version& version);
 
     // message for alter task
@@ -216,6 +219,19 @@ public:
         _last_compaction_failure_time = time;
     }
 
+    // called every time this tablet is scanned by a query
+    void increase_query_count() { _query_count.fetch_add(1, std::memory_order_relaxed); }
+
+    // Update the recent query load of this tablet, which counts queries since
+    // the last update and decays the older load by half. It is only called by
+    // the compaction scheduler thread once per round, as well as query_load().
+    void update_query_load() {
+        int64_t query_count = _query_count.load(std::memory_order_relaxed);
+        _query_load = _query_load / 2 + (query_count - _last_query_count);
+        _last_query_count = query_count;
+    }
+    int64_t query_load() const { return _query_load; }
+
     void delete_all_files();
 
     bool check_path(const std::string& check_path);
@@ -239,9 +255,28 @@ public:
 
     OLAPStatus calculate_cumulative_point();
 
+    // Primary key index of merge-on-write UNIQUE_KEYS tablet, nullptr if it's
+    // not enabled or not built yet. If it's not built, a background task is
+    // submitted to build it, and queries merge rowsets until it's ready.
+    std::shared_ptr<PrimaryKeyIndex> primary_key_index();
+    // Build the primary key index from all rowsets and install it. Loads and
+    // compactions going on are caught up with. Run by the build pool of
+    // StorageEngine, caller should not hold header lock.
+    OLAPStatus build_primary_key_index();
+    // Update the primary key index after compaction, caller should not hold
+    // header lock.
+    void update_primary_key_index(const std::vector<RowsetSharedPtr>& input_rowsets,
+                                  const RowsetSharedPtr& output_rowset);
+
 private:
     void _print_missed_versions(const std::vector<Version>& missed_versions) const;
     OLAPStatus _check_added_rowset(const RowsetSharedPtr& rowset);
+    // Return the primary key index without submitting a build
+    std::shared_ptr<PrimaryKeyIndex> _get_primary_key_index();
+    // Add rowsets of versions after max version of 'index' into it
+    OLAPStatus _catch_up_primary_key_index(PrimaryKeyIndex* index);
+    void _add_rowset_to_primary_key_index(const RowsetSharedPtr& rowset);
+    void _drop_primary_key_index();
 
 private:
     TabletState _state;
@@ -261,8 +296,22 @@ private:
     std::unordered_map<Version, RowsetSharedPtr, HashOfVersion> _rs_version_map;
     std::unordered_map<Version, RowsetSharedPtr, HashOfVersion> _inc_rs_version_map;
 
+    // protect following members. _primary_key_index is updated out of header
+    // lock because updating it reads rowsets. Header lock should be acquired
+    // before this lock if both are held.
+    std::mutex _primary_key_index_lock;
+    std::shared_ptr<PrimaryKeyIndex> _primary_key_index;
+    // if the tablet keeps a primary key index
+    bool _merge_on_write = false;
+    // if a build of the index is submitted and not finished
+    bool _primary_key_index_building = false;
+
     std::atomic<bool> _is_bad;   // if this tablet is broken, set to true. default is false
     std::atomic<int64_t> _last_compaction_failure_time; // timestamp of last compaction failure
+    std::atomic<int64_t> _query_count; // number of queries which scanned this tablet
+    // used by compaction scheduler to compute recent query load
+    int64_t _last_query_count;
+    int64_t _query_load;
 
     int64_t _cumulative_point;
     DISALLOW_COPY_AND_ASSIGN(Tablet);
@@ -78,8 +78,35 @@ bool _sort_tablet_by_creation_time(const TabletSharedPtr& a, const TabletSharedP
 }
 
 TabletManager::TabletManager()
-    : _tablet_stat_cache_update_time_ms(0),
-      _available_storage_medium_type_count(0) { }
+    : _tablets_shards(config::tablet_map_shard_size),
+      _tablets_shards_mask(config::tablet_map_shard_size - 1),
+      _tablets_version(0),
+      _tablet_stat_cache_update_time_ms(0),
+      _available_storage_medium_type_count(0) {
+    CHECK_GT(config::tablet_map_shard_size, 0);
+    CHECK_EQ(config::tablet_map_shard_size & _tablets_shards_mask, 0)
+        << "tablet_map_shard_size should be power of 2";
+}
+
+std::shared_ptr<const std::vector<TabletSharedPtr>> TabletManager::_get_tablets_snapshot() {
+    MutexLock lock(&_tablets_snapshot_lock);
+    // read version before rebuilding, if any tablet is changed during
+    // building, snapshot will be rebuilt in next call
+    uint64_t version = _tablets_version.load();
+    if (_tablets_snapshot == nullptr || _tablets_snapshot_version != version) {
+        std::shared_ptr<std::vector<TabletSharedPtr>> tablets(new std::vector<TabletSharedPtr>());
+        for (auto& shard : _tablets_shards) {
+            ReadLock rlock(&shard.lock);
+            for (auto& item : shard.tablet_map) {
+                tablets->insert(tablets->end(), item.second.table_arr.begin(),
+                                item.second.table_arr.end());
+            }
+        }
+        _tablets_snapshot = tablets;
+        _tablets_snapshot_version = version;
+    }
+    return _tablets_snapshot;
+}
 
 OLAPStatus TabletManager::_add_tablet_unlock(TTabletId tablet_id, SchemaHash schema_hash,
                                  const TabletSharedPtr& tablet, bool update_meta, bool force) {
@@ -88,14 +115,7 @@ OLAPStatus TabletManager::_add_tablet_unlock(TTabletId tablet_id, SchemaHash sch
             << "tablet_id=" << tablet_id << ", schema_hash=" << schema_hash
             << ", force=" << force;
 
-    TabletSharedPtr table_item = nullptr;
-    for (TabletSharedPtr item : _tablet_map[tablet_id].table_arr) {
-        if (item->equal(tablet_id, schema_hash)) {
-            table_item = item;
-            break;
-        }
-    }
-
+    TabletSharedPtr table_item = _get_tablet_with_no_lock(tablet_id, schema_hash);
     if (table_item == nullptr) {
         VLOG(3) << "not find exist tablet just add it to map"
                 << " tablet_id = " << tablet_id
@@ -139,7 +159,7 @@ OLAPStatus TabletManager::_add_tablet_unlock(TTabletId tablet_id, SchemaHash sch
     /*
      * In restore process, we replace all origin files in tablet dir with
      * the downloaded snapshot files. Than we try to reload tablet header.
-     * force == true means we forcibly replace the Tablet in _tablet_map
+     * force == true means we forcibly replace the Tablet in tablet map
      * with the new one. But if we do so, the files in the tablet dir will be
      * dropped when the origin Tablet deconstruct.
      * So we set keep_files == true to not delete files when the
@@ -198,8 +218,13 @@ OLAPStatus TabletManager::_add_tablet_to_map(TTabletId tablet_id, SchemaHash sch
                         << ", data_dir=" << tablet->data_dir()->path();
         return res;
     }
-    _tablet_map[tablet_id].table_arr.push_back(tablet);
-    _tablet_map[tablet_id].table_arr.sort(_sort_tablet_by_creation_time);
+    {
+        TabletsShard& shard = _get_tablets_shard(tablet_id);
+        WriteLock wlock(&shard.lock);
+        shard.tablet_map[tablet_id].table_arr.push_back(tablet);
+        shard.tablet_map[tablet_id].table_arr.sort(_sort_tablet_by_creation_time);
+        ++_tablets_version;
+    }
 
     // add the tablet id to partition map
     _partition_tablet_map[tablet->partition_id()].insert(tablet->get_tablet_info());
@@ -217,86 +242,106 @@ void TabletManager::cancel_unfinished_schema_change() {
     uint64_t canceled_num = 0;
     LOG(INFO) << "begin to cancel unfinished schema change.";
 
-    for (const auto& tablet_instance : _tablet_map) {
-        for (TabletSharedPtr tablet : tablet_instance.second.table_arr) {
-            if (tablet == nullptr) {
-                LOG(WARNING) << "tablet does not exist. tablet_id=" << tablet_instance.first;
-                continue;
-            }
-            AlterTabletTaskSharedPtr alter_task = tablet->alter_task();
-            // if alter task's state == finished, could not do anything
-            if (alter_task == nullptr || alter_task->alter_state() == ALTER_FINISHED) {
-                continue;
-            }
-
-            OLAPStatus res = tablet->set_alter_state(ALTER_FAILED);
-            if (res != OLAP_SUCCESS) {
-                LOG(FATAL) << "fail to set alter state. res=" << res
-                        << ", base_tablet=" << tablet->full_name();
-                return;
-            }
-            res = tablet->save_meta();
-            if (res != OLAP_SUCCESS) {
-                LOG(FATAL) << "fail to save base tablet meta. res=" << res
-                        << ", base_tablet=" << tablet->full_name();
-                return;
-            }
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& tablet : *tablets) {
+        AlterTabletTaskSharedPtr alter_task = tablet->alter_task();
+        // if alter task's state == finished, could not do anything
+        if (alter_task == nullptr || alter_task->alter_state() == ALTER_FINISHED) {
+            continue;
+        }
 
-            LOG(INFO) << "cancel unfinished alter tablet task. base_tablet=" << tablet->full_name();
-            ++canceled_num;
+        OLAPStatus res = tablet->set_alter_state(ALTER_FAILED);
+        if (res != OLAP_SUCCESS) {
+            LOG(FATAL) << "fail to set alter state. res=" << res
+                    << ", base_tablet=" << tablet->full_name();
+            return;
         }
+        res = tablet->save_meta();
+        if (res != OLAP_SUCCESS) {
+            LOG(FATAL) << "fail to save base tablet meta. res=" << res
+                    << ", base_tablet=" << tablet->full_name();
+            return;
+        }
+
+        LOG(INFO) << "cancel unfinished alter tablet task. base_tablet=" << tablet->full_name();
+        ++canceled_num;
     }
 
     LOG(INFO) << "finish to cancel unfinished schema change! canceled_num=" << canceled_num;
 }
 
 bool TabletManager::check_tablet_id_exist(TTabletId tablet_id) {
-    ReadLock rlock(&_tablet_map_lock);
+    ReadLock rlock(&_get_tablets_shard(tablet_id).lock);
     return _check_tablet_id_exist_unlock(tablet_id);
 } // check_tablet_id_exist
 
 bool TabletManager::_check_tablet_id_exist_unlock(TTabletId tablet_id) {
     bool is_exist = false;
 
-    tablet_map_t::iterator it = _tablet_map.find(tablet_id);
-    if (it != _tablet_map.end() && it->second.table_arr.size() != 0) {
+    tablet_map_t& tablet_map = _get_tablets_shard(tablet_id).tablet_map;
+    tablet_map_t::iterator it = tablet_map.find(tablet_id);
+    if (it != tablet_map.end() && it->second.table_arr.size() != 0) {
         is_exist = true;
     }
     return is_exist;
 } // check_tablet_id_exist
 
 void TabletManager::clear() {
-    _tablet_map.clear();
+    MutexLock lock(&_tablet_map_write_lock);
+    for (auto& shard : _tablets_shards) {
+        WriteLock wlock(&shard.lock);
+        shard.tablet_map.clear();
+    }
+    ++_tablets_version;
+    {
+        MutexLock snapshot_lock(&_tablets_snapshot_lock);
+        _tablets_snapshot.reset();
+    }
+    _partition_tablet_map.clear();
+    MutexLock shutdown_lock(&_shutdown_tablets_lock);
     _shutdown_tablets.clear();
 } // clear
 
 OLAPStatus TabletManager::create_tablet(const TCreateTabletReq& request,
     std::vector<DataDir*> stores) {
-    WriteLock wrlock(&_tablet_map_lock);
     LOG(INFO) << "begin to process create tablet. tablet=" << request.tablet_id
               << ", schema_hash=" << request.tablet_schema.schema_hash;
     OLAPStatus res = OLAP_SUCCESS;
     DorisMetrics::create_tablet_requests_total.increment(1);
-    // Make sure create_tablet operation is idempotent:
-    // return success if tablet with same tablet_id and schema_hash exist,
-    //        false if tablet with same tablet_id but different schema_hash exist
-    // during alter, if the tablet(same tabletid and schema hash) already exist
-    // then just return true, if tablet id with different schema hash exist, wait report
-    // task to delete the tablet
-    if (_check_tablet_id_exist_unlock(request.tablet_id)) {
-        TabletSharedPtr tablet = _get_tablet_with_no_lock(
-                request.tablet_id, request.tablet_schema.schema_hash);
-        if (tablet != nullptr) {
-            LOG(INFO) << "create tablet success for tablet already exist.";
-            return OLAP_SUCCESS;
-        } else {
-            LOG(WARNING) << "tablet with different schema hash already exists.";
+    {
+        MutexLock lock(&_tablet_map_write_lock);
+        // Make sure create_tablet operation is idempotent:
+        // return success if tablet with same tablet_id and schema_hash exist,
+        //        false if tablet with same tablet_id but different schema_hash exist
+        // during alter, if the tablet(same tabletid and schema hash) already exist
+        // then just return true, if tablet id with different schema hash exist, wait report
+        // task to delete the tablet
+        if (_check_tablet_id_exist_unlock(request.tablet_id)) {
+            TabletSharedPtr tablet = _get_tablet_with_no_lock(
+                    request.tablet_id, request.tablet_schema.schema_hash);
+            if (tablet != nullptr) {
+                LOG(INFO) << "create tablet success for tablet already exist.";
+                return OLAP_SUCCESS;
+            } else {
+                LOG(WARNING) << "tablet with different schema hash already exists.";
+                return OLAP_ERR_CE_TABLET_ID_EXIST;
+            }
+        }
+        if (!_creating_tablet_ids.insert(request.tablet_id).second) {
+            LOG(WARNING) << "tablet is being created by another task. tablet=" << request.tablet_id;
             return OLAP_ERR_CE_TABLET_ID_EXIST;
         }
     }
+
+    // meta, dirs and initial rowset of the tablet are created without holding
+    // _tablet_map_write_lock, so that create tablet tasks run in parallel.
     // set alter type to schema change. it is useless
-    TabletSharedPtr tablet = _internal_create_tablet(AlterTabletType::SCHEMA_CHANGE, request, false, nullptr, stores);
-    if (tablet == nullptr) {
+    TabletSharedPtr tablet = _init_new_tablet(
+            AlterTabletType::SCHEMA_CHANGE, request, false, nullptr, stores);
+
+    MutexLock lock(&_tablet_map_write_lock);
+    _creating_tablet_ids.erase(request.tablet_id);
+    if (tablet == nullptr || _add_new_tablet_unlock(request, tablet) != OLAP_SUCCESS) {
         res = OLAP_ERR_CE_CMD_PARAMS_ERROR;
         LOG(WARNING) << "fail to create tablet. res=" << res;
     }
@@ -309,7 +354,7 @@ TabletSharedPtr TabletManager::create_tablet(const AlterTabletType alter_type,
         const TCreateTabletReq& request, const bool is_schema_change_tablet,
         const TabletSharedPtr ref_tablet, std::vector<DataDir*> data_dirs) {
     DCHECK(is_schema_change_tablet && ref_tablet != nullptr);
-    WriteLock wrlock(&_tablet_map_lock);
+    MutexLock lock(&_tablet_map_write_lock);
     return _internal_create_tablet(alter_type, request, is_schema_change_tablet,
         ref_tablet, data_dirs);
 }
@@ -320,13 +365,23 @@ TabletSharedPtr TabletManager::_internal_create_tablet(const AlterTabletType alt
     DCHECK((is_schema_change_tablet && ref_tablet != nullptr) || (!is_schema_change_tablet && ref_tablet == nullptr));
     // check if the tablet with specified tablet id and schema hash already exists
     TabletSharedPtr checked_tablet = _get_tablet_with_no_lock(request.tablet_id, request.tablet_schema.schema_hash);
-    if (checked_tablet != nullptr) {
+    if (checked_tablet != nullptr || _creating_tablet_ids.count(request.tablet_id) > 0) {
         LOG(WARNING) << "failed to create tablet because tablet already exist." 
                      << " tablet id = " << request.tablet_id
                      << " schema hash = " << request.tablet_schema.schema_hash;
         return nullptr;
     }
-    bool is_tablet_added = false;
+    TabletSharedPtr tablet = _init_new_tablet(alter_type, request, is_schema_change_tablet,
+        ref_tablet, data_dirs);
+    if (tablet == nullptr || _add_new_tablet_unlock(request, tablet) != OLAP_SUCCESS) {
+        return nullptr;
+    }
+    return tablet;
+} // create_tablet
+
+TabletSharedPtr TabletManager::_init_new_tablet(const AlterTabletType alter_type,
+        const TCreateTabletReq& request, const bool is_schema_change_tablet,
+        const TabletSharedPtr ref_tablet, std::vector<DataDir*> data_dirs) {
     TabletSharedPtr tablet = _create_tablet_meta_and_dir(request, is_schema_change_tablet, 
         ref_tablet, data_dirs);
     if (tablet == nullptr) {
@@ -379,6 +434,24 @@ TabletSharedPtr TabletManager::_internal_create_tablet(const AlterTabletType alt
             // convert finished
             tablet->set_tablet_state(TabletState::TABLET_NOTREADY);
         }
+    } while (0);
+
+    // clear environment
+    if (res != OLAP_SUCCESS) {
+        DorisMetrics::create_tablet_requests_failed.increment(1);
+        tablet->data_dir()->remove_pending_ids(TABLET_ID_PREFIX + std::to_string(request.tablet_id));
+        tablet->delete_all_files();
+        TabletMetaManager::remove(tablet->data_dir(), request.tablet_id, request.tablet_schema.schema_hash);
+        return nullptr;
+    }
+    return tablet;
+}
+
+OLAPStatus TabletManager::_add_new_tablet_unlock(const TCreateTabletReq& request,
+                                                 TabletSharedPtr tablet) {
+    bool is_tablet_added = false;
+    OLAPStatus res = OLAP_SUCCESS;
+    do {
         // Add tablet to StorageEngine will make it visiable to user
         res = _add_tablet_unlock(request.tablet_id, request.tablet_schema.schema_hash, tablet, true, false);
         if (res != OLAP_SUCCESS) {
@@ -410,12 +483,11 @@ TabletSharedPtr TabletManager::_internal_create_tablet(const AlterTabletType alt
             tablet->delete_all_files();
             TabletMetaManager::remove(tablet->data_dir(), request.tablet_id, request.tablet_schema.schema_hash);
         }
-        return nullptr;
-    } else {
-        LOG(INFO) << "finish to process create tablet. res=" << res;
-        return tablet;
+        return res;
     }
-} // create_tablet
+    LOG(INFO) << "finish to process create tablet. res=" << res;
+    return res;
+}
 
 TabletSharedPtr TabletManager::_create_tablet_meta_and_dir(
         const TCreateTabletReq& request, const bool is_schema_change_tablet,
@@ -486,7 +558,7 @@ TabletSharedPtr TabletManager::_create_tablet_meta_and_dir(
 //          drop specified tablet and clear schema change info.
 OLAPStatus TabletManager::drop_tablet(
         TTabletId tablet_id, SchemaHash schema_hash, bool keep_files) {
-    WriteLock wlock(&_tablet_map_lock);
+    MutexLock lock(&_tablet_map_write_lock);
     return _drop_tablet_unlock(tablet_id, schema_hash, keep_files);
 } // drop_tablet
 
@@ -584,7 +656,7 @@ OLAPStatus TabletManager::_drop_tablet_unlock(
 OLAPStatus TabletManager::drop_tablets_on_error_root_path(
         const vector<TabletInfo>& tablet_info_vec) {
     OLAPStatus res = OLAP_SUCCESS;
-    WriteLock wlock(&_tablet_map_lock);
+    MutexLock lock(&_tablet_map_write_lock);
 
     for (const TabletInfo& tablet_info : tablet_info_vec) {
         TTabletId tablet_id = tablet_info.tablet_id;
@@ -598,18 +670,21 @@ OLAPStatus TabletManager::drop_tablets_on_error_root_path(
                          << " schema_hash=" << schema_hash;
             continue;
         } else {
-            for (list<TabletSharedPtr>::iterator it = _tablet_map[tablet_id].table_arr.begin();
-                    it != _tablet_map[tablet_id].table_arr.end();) {
+            TabletsShard& shard = _get_tablets_shard(tablet_id);
+            WriteLock wlock(&shard.lock);
+            std::list<TabletSharedPtr>& table_arr = shard.tablet_map[tablet_id].table_arr;
+            for (list<TabletSharedPtr>::iterator it = table_arr.begin(); it != table_arr.end();) {
                 if ((*it)->equal(tablet_id, schema_hash)) {
-                    it = _tablet_map[tablet_id].table_arr.erase(it);
                     _partition_tablet_map[(*it)->partition_id()].erase((*it)->get_tablet_info());
                     if (_partition_tablet_map[(*it)->partition_id()].empty()) {
                         _partition_tablet_map.erase((*it)->partition_id());
-                    } 
+                    }
+                    it = table_arr.erase(it);
                 } else {
                     ++it;
                 }
             }
+            ++_tablets_version;
         }
     }
 
@@ -618,7 +693,7 @@ OLAPStatus TabletManager::drop_tablets_on_error_root_path(
 
 TabletSharedPtr TabletManager::get_tablet(TTabletId tablet_id, SchemaHash schema_hash,
                                           bool include_deleted, std::string* err) {
-    ReadLock rlock(&_tablet_map_lock);
+    ReadLock rlock(&_get_tablets_shard(tablet_id).lock);
     return _get_tablet(tablet_id, schema_hash, include_deleted, err);
 } // get_tablet
 
@@ -627,6 +702,7 @@ TabletSharedPtr TabletManager::_get_tablet(TTabletId tablet_id, SchemaHash schem
     TabletSharedPtr tablet;
     tablet = _get_tablet_with_no_lock(tablet_id, schema_hash);
     if (tablet == nullptr && include_deleted) {
+        MutexLock lock(&_shutdown_tablets_lock);
         for (auto& deleted_tablet : _shutdown_tablets) {
             CHECK(deleted_tablet != nullptr) << "deleted tablet in nullptr";
             if (deleted_tablet->tablet_id() == tablet_id && deleted_tablet->schema_hash() == schema_hash) {
@@ -652,7 +728,7 @@ TabletSharedPtr TabletManager::_get_tablet(TTabletId tablet_id, SchemaHash schem
 TabletSharedPtr TabletManager::get_tablet(TTabletId tablet_id, SchemaHash schema_hash,
                                           TabletUid tablet_uid, bool include_deleted,
                                           std::string* err) {
-    ReadLock rlock(&_tablet_map_lock);
+    ReadLock rlock(&_get_tablets_shard(tablet_id).lock);
     TabletSharedPtr tablet = _get_tablet(tablet_id, schema_hash, include_deleted, err);
     if (tablet != nullptr && tablet->tablet_uid() == tablet_uid) {
         return tablet;
@@ -705,7 +781,7 @@ void TabletManager::get_tablet_stat(TTabletStatResult& result) {
 
     // get current time
     int64_t current_time = UnixMillis();
-    WriteLock wlock(&_tablet_map_lock);
+    MutexLock lock(&_tablet_stat_cache_lock);
     // update cache if too old
     if (current_time - _tablet_stat_cache_update_time_ms >
         config::tablet_stat_cache_update_interval_second * 1000) {
@@ -716,59 +792,64 @@ void TabletManager::get_tablet_stat(TTabletStatResult& result) {
     result.__set_tablets_stats(_tablet_stat_cache);
 } // get_tablet_stat
 
-TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
-            CompactionType compaction_type, DataDir* data_dir) {
-    ReadLock tablet_map_rdlock(&_tablet_map_lock);
-    uint32_t highest_score = 0;
-    TabletSharedPtr best_tablet;
-    int64_t now = UnixMillis();
-    for (tablet_map_t::value_type& table_ins : _tablet_map){
-        for (TabletSharedPtr& table_ptr : table_ins.second.table_arr) {
-            AlterTabletTaskSharedPtr cur_alter_task = table_ptr->alter_task();
-            if (cur_alter_task != nullptr && cur_alter_task->alter_state() != ALTER_FINISHED 
-                && cur_alter_task->alter_state() != ALTER_FAILED) {
-                    TabletSharedPtr related_tablet = _get_tablet_with_no_lock(cur_alter_task->related_tablet_id(), 
-                        cur_alter_task->related_schema_hash());
-                    if (related_tablet != nullptr && table_ptr->creation_time() > related_tablet->creation_time()) {
-                        // it means cur tablet is a new tablet during schema change or rollup, skip compaction
-                        continue;
-                    }
+uint32_t TabletManager::_get_compaction_score(const TabletSharedPtr& tablet,
+        CompactionType compaction_type, DataDir* data_dir, int64_t now) {
+    AlterTabletTaskSharedPtr cur_alter_task = tablet->alter_task();
+    if (cur_alter_task != nullptr && cur_alter_task->alter_state() != ALTER_FINISHED 
+        && cur_alter_task->alter_state() != ALTER_FAILED) {
+            TabletSharedPtr related_tablet;
+            {
+                ReadLock rlock(&_get_tablets_shard(cur_alter_task->related_tablet_id()).lock);
+                related_tablet = _get_tablet_with_no_lock(cur_alter_task->related_tablet_id(),
+                    cur_alter_task->related_schema_hash());
             }
-
-            if (table_ptr->data_dir()->path_hash() != data_dir->path_hash()
-                    || !table_ptr->is_used() || !table_ptr->init_succeeded() || !table_ptr->can_do_compaction()) {
-                continue;
+            if (related_tablet != nullptr && tablet->creation_time() > related_tablet->creation_time()) {
+                // it means cur tablet is a new tablet during schema change or rollup, skip compaction
+                return 0;
             }
+    }
 
-            if (now - table_ptr->last_compaction_failure_time() <= config::min_compaction_failure_interval_sec * 1000) {
-                continue;
-            }
+    if ((data_dir != nullptr && tablet->data_dir()->path_hash() != data_dir->path_hash())
+            || !tablet->is_used() || !tablet->init_succeeded() || !tablet->can_do_compaction()) {
+        return 0;
+    }
 
-            if (compaction_type == CompactionType::CUMULATIVE_COMPACTION) {
-                MutexLock lock(table_ptr->get_cumulative_lock(), TRY_LOCK);
-                if (!lock.own_lock()) {
-                    continue;
-                }
-            }
+    if (now - tablet->last_compaction_failure_time() <= config::min_compaction_failure_interval_sec * 1000) {
+        return 0;
+    }
 
-            if (compaction_type == CompactionType::BASE_COMPACTION) {
-                MutexLock lock(table_ptr->get_base_lock(), TRY_LOCK);
-                if (!lock.own_lock()) {
-                    continue;
-                }
-            }
+    if (compaction_type == CompactionType::CUMULATIVE_COMPACTION) {
+        MutexLock lock(tablet->get_cumulative_lock(), TRY_LOCK);
+        if (!lock.own_lock()) {
+            return 0;
+        }
+    }
 
-            ReadLock rdlock(table_ptr->get_header_lock_ptr());
-            uint32_t table_score = 0;
-            if (compaction_type == CompactionType::BASE_COMPACTION) {
-                table_score = table_ptr->calc_base_compaction_score();
-            } else if (compaction_type == CompactionType::CUMULATIVE_COMPACTION) {
-                table_score = table_ptr->calc_cumulative_compaction_score();
-            }
-            if (table_score > highest_score) {
-                highest_score = table_score;
-                best_tablet = table_ptr;
-            }
+    if (compaction_type == CompactionType::BASE_COMPACTION) {
+        MutexLock lock(tablet->get_base_lock(), TRY_LOCK);
+        if (!lock.own_lock()) {
+            return 0;
+        }
+    }
+
+    ReadLock rdlock(tablet->get_header_lock_ptr());
+    if (compaction_type == CompactionType::BASE_COMPACTION) {
+        return tablet->calc_base_compaction_score();
+    }
+    return tablet->calc_cumulative_compaction_score();
+}
+
+TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
+            CompactionType compaction_type, DataDir* data_dir) {
+    uint32_t highest_score = 0;
+    TabletSharedPtr best_tablet;
+    int64_t now = UnixMillis();
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& table_ptr : *tablets) {
+        uint32_t table_score = _get_compaction_score(table_ptr, compaction_type, data_dir, now);
+        if (table_score > highest_score) {
+            highest_score = table_score;
+            best_tablet = table_ptr;
         }
     }
 
@@ -780,9 +861,29 @@ TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
     return best_tablet;
 }
 
+void TabletManager::get_compaction_candidates(CompactionType compaction_type,
+        std::vector<std::pair<TabletSharedPtr, uint32_t>>* candidates) {
+    int64_t now = UnixMillis();
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& table_ptr : *tablets) {
+        uint32_t table_score = _get_compaction_score(table_ptr, compaction_type, nullptr, now);
+        if (table_score > 0) {
+            candidates->emplace_back(table_ptr, table_score);
+        }
+    }
+}
+
+void TabletManager::update_tablets_query_load() {
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& table_ptr : *tablets) {
+        table_ptr->update_query_load();
+    }
+}
+
 OLAPStatus TabletManager::load_tablet_from_meta(DataDir* data_dir, TTabletId tablet_id,
         TSchemaHash schema_hash, const std::string& meta_binary, bool update_meta, bool force) {
-    WriteLock wlock(&_tablet_map_lock);
+    // decoding meta and initializing tablet don't touch tablet map, and are
+    // done out of the lock, so that tablets of data dirs can be loaded in parallel
     TabletMetaSharedPtr tablet_meta(new TabletMeta());
     OLAPStatus status = tablet_meta->deserialize(meta_binary);
     if (status != OLAP_SUCCESS) {
@@ -815,6 +916,7 @@ OLAPStatus TabletManager::load_tablet_from_meta(DataDir* data_dir, TTabletId tab
         LOG(INFO) << "tablet is to be deleted, skip load it"
                   << " tablet id = " << tablet_meta->tablet_id()
                   << " schema hash = " << tablet_meta->schema_hash();
+        MutexLock shutdown_lock(&_shutdown_tablets_lock);
         _shutdown_tablets.push_back(tablet);
         return OLAP_ERR_TABLE_ALREADY_DELETED_ERROR;
     }
@@ -831,6 +933,7 @@ OLAPStatus TabletManager::load_tablet_from_meta(DataDir* data_dir, TTabletId tab
         LOG(WARNING) << "tablet init failed. tablet:" << tablet->full_name();
         return res;
     }
+    MutexLock lock(&_tablet_map_write_lock);
     res = _add_tablet_unlock(tablet_id, schema_hash, tablet, update_meta, force);
     if (res != OLAP_SUCCESS) {
         // insert existed tablet return OLAP_SUCCESS
@@ -902,10 +1005,11 @@ OLAPStatus TabletManager::load_tablet_from_dir(
 
 void TabletManager::release_schema_change_lock(TTabletId tablet_id) {
     VLOG(3) << "release_schema_change_lock begin. tablet_id=" << tablet_id;
-    ReadLock rlock(&_tablet_map_lock);
+    TabletsShard& shard = _get_tablets_shard(tablet_id);
+    ReadLock rlock(&shard.lock);
 
-    tablet_map_t::iterator it = _tablet_map.find(tablet_id);
-    if (it == _tablet_map.end()) {
+    tablet_map_t::iterator it = shard.tablet_map.find(tablet_id);
+    if (it == shard.tablet_map.end()) {
         LOG(WARNING) << "tablet does not exists. tablet=" << tablet_id;
     } else {
         it->second.schema_change_lock.unlock();
@@ -937,47 +1041,32 @@ OLAPStatus TabletManager::report_tablet_info(TTabletInfo* tablet_info) {
 
 OLAPStatus TabletManager::report_all_tablets_info(std::map<TTabletId, TTablet>* tablets_info) {
     LOG(INFO) << "begin to process report all tablets info.";
-    ReadLock rlock(&_tablet_map_lock);
     DorisMetrics::report_all_tablets_requests_total.increment(1);
 
     if (tablets_info == nullptr) {
         return OLAP_ERR_INPUT_PARAMETER_ERROR;
     }
 
-    for (const auto& item : _tablet_map) {
-        if (item.second.table_arr.size() == 0) {
-            continue;
-        }
+    // tablets of the same tablet id are adjacent in snapshot
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& tablet_ptr : *tablets) {
+        TTabletInfo tablet_info;
+        _build_tablet_info(tablet_ptr, &tablet_info);
 
-        TTablet tablet;
-        for (TabletSharedPtr tablet_ptr : item.second.table_arr) {
-            if (tablet_ptr == nullptr) {
-                continue;
-            }
-
-            TTabletInfo tablet_info;
-            _build_tablet_info(tablet_ptr, &tablet_info);
-
-            // report expire transaction
-            vector<int64_t> transaction_ids;
-            // TODO(ygl): tablet manager and txn manager may be dead lock
-            StorageEngine::instance()->txn_manager()->get_expire_txns(tablet_ptr->tablet_id(), 
-                tablet_ptr->schema_hash(), tablet_ptr->tablet_uid(), &transaction_ids);
-            tablet_info.__set_transaction_ids(transaction_ids);
-
-            if (_available_storage_medium_type_count > 1) {
-                tablet_info.__set_storage_medium(tablet_ptr->data_dir()->storage_medium());
-            }
-
-            tablet_info.__set_version_count(tablet_ptr->version_count());
-            tablet_info.__set_path_hash(tablet_ptr->data_dir()->path_hash());
+        // report expire transaction
+        vector<int64_t> transaction_ids;
+        StorageEngine::instance()->txn_manager()->get_expire_txns(tablet_ptr->tablet_id(), 
+            tablet_ptr->schema_hash(), tablet_ptr->tablet_uid(), &transaction_ids);
+        tablet_info.__set_transaction_ids(transaction_ids);
 
-            tablet.tablet_infos.push_back(tablet_info);
+        if (_available_storage_medium_type_count > 1) {
+            tablet_info.__set_storage_medium(tablet_ptr->data_dir()->storage_medium());
         }
 
-        if (tablet.tablet_infos.size() != 0) {
-            tablets_info->insert(pair<TTabletId, TTablet>(tablet.tablet_infos[0].tablet_id, tablet));
-        }
+        tablet_info.__set_version_count(tablet_ptr->version_count());
+        tablet_info.__set_path_hash(tablet_ptr->data_dir()->path_hash());
+
+        (*tablets_info)[tablet_ptr->tablet_id()].tablet_infos.push_back(tablet_info);
     }
 
     LOG(INFO) << "success to process report all tablets info. tablet_num=" << tablets_info->size();
@@ -986,41 +1075,36 @@ OLAPStatus TabletManager::report_all_tablets_info(std::map<TTabletId, TTablet>*
 
 OLAPStatus TabletManager::start_trash_sweep() {
     {
-        ReadLock rlock(&_tablet_map_lock);
-        std::vector<int64_t> tablets_to_clean;
-        for (auto& item : _tablet_map) {
-            // try to clean empty item
-            if (item.second.table_arr.empty()) {
+        MutexLock lock(&_tablet_map_write_lock);
+        for (auto& shard : _tablets_shards) {
+            WriteLock wlock(&shard.lock);
+            for (auto it = shard.tablet_map.begin(); it != shard.tablet_map.end();) {
+                // try to clean empty item
                 // try to get schema change lock if could get schema change lock, then nobody 
                 // own the lock could remove the item
                 // it will core if schema change thread may hold the lock and this thread will deconstruct lock
-                if (item.second.schema_change_lock.trylock() == OLAP_SUCCESS) {
-                    item.second.schema_change_lock.unlock();
-                    tablets_to_clean.push_back(item.first);
-                }
-            }
-            for (TabletSharedPtr tablet : item.second.table_arr) {
-                if (tablet == nullptr) {
-                    continue;
+                if (it->second.table_arr.empty()
+                        && it->second.schema_change_lock.trylock() == OLAP_SUCCESS) {
+                    it->second.schema_change_lock.unlock();
+                    it = shard.tablet_map.erase(it);
+                } else {
+                    ++it;
                 }
-                tablet->delete_expired_inc_rowsets();
-            }
-        }
-        // clean empty tablet id item
-        for (const auto& tablet_id_to_clean : tablets_to_clean) {
-            if (_tablet_map[tablet_id_to_clean].table_arr.empty()) {
-                _tablet_map.erase(tablet_id_to_clean);
             }
         }
     }
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& tablet : *tablets) {
+        tablet->delete_expired_inc_rowsets();
+    }
 
     int32_t clean_num = 0;
     do {
         sleep(1);
         clean_num = 0;
-        // should get write lock here, because it will remove tablet from shut_down_tablets
+        // should get lock here, because it will remove tablet from shut_down_tablets
         // and get tablet will access shut_down_tablets
-        WriteLock wlock(&_tablet_map_lock);
+        MutexLock lock(&_shutdown_tablets_lock);
         auto it = _shutdown_tablets.begin();
         for (; it != _shutdown_tablets.end();) { 
             // check if the meta has the tablet info and its state is shutdown
@@ -1098,10 +1182,11 @@ OLAPStatus TabletManager::start_trash_sweep() {
 bool TabletManager::try_schema_change_lock(TTabletId tablet_id) {
     bool res = false;
     VLOG(3) << "try_schema_change_lock begin. tablet_id=" << tablet_id;
-    ReadLock rlock(&_tablet_map_lock);
+    TabletsShard& shard = _get_tablets_shard(tablet_id);
+    ReadLock rlock(&shard.lock);
 
-    tablet_map_t::iterator it = _tablet_map.find(tablet_id);
-    if (it == _tablet_map.end()) {
+    tablet_map_t::iterator it = shard.tablet_map.find(tablet_id);
+    if (it == shard.tablet_map.end()) {
         LOG(WARNING) << "tablet does not exists. tablet_id=" << tablet_id;
     } else {
         res = (it->second.schema_change_lock.trylock() == OLAP_SUCCESS);
@@ -1112,19 +1197,16 @@ bool TabletManager::try_schema_change_lock(TTabletId tablet_id) {
 
 void TabletManager::update_root_path_info(std::map<std::string, DataDirInfo>* path_map,
     int* tablet_counter) {
-    ReadLock rlock(&_tablet_map_lock);
-    for (auto& entry : _tablet_map) {
-        TableInstances& instance = entry.second;
-        for (auto& tablet : instance.table_arr) {
-            (*tablet_counter) ++ ;
-            int64_t data_size = tablet->tablet_footprint();
-            auto find = path_map->find(tablet->data_dir()->path());
-            if (find == path_map->end()) {
-                continue;
-            }
-            if (find->second.is_used) {
-                find->second.data_used_capacity += data_size;
-            }
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& tablet : *tablets) {
+        (*tablet_counter) ++ ;
+        int64_t data_size = tablet->tablet_footprint();
+        auto find = path_map->find(tablet->data_dir()->path());
+        if (find == path_map->end()) {
+            continue;
+        }
+        if (find->second.is_used) {
+            find->second.data_used_capacity += data_size;
         }
     }
 } // update_root_path_info
@@ -1148,27 +1230,21 @@ void TabletManager::_build_tablet_info(TabletSharedPtr tablet, TTabletInfo* tabl
 
 void TabletManager::_build_tablet_stat() {
     _tablet_stat_cache.clear();
-    for (const auto& item : _tablet_map) {
-        if (item.second.table_arr.size() == 0) {
+    auto tablets = _get_tablets_snapshot();
+    for (const TabletSharedPtr& tablet : *tablets) {
+        // we only get base tablet's stat, which is the first one of tablets
+        // with the same tablet id
+        if (_tablet_stat_cache.count(tablet->tablet_id()) > 0) {
             continue;
         }
-
         TTabletStat stat;
-        stat.tablet_id = item.first;
-        for (TabletSharedPtr tablet : item.second.table_arr) {
-            if (tablet == nullptr) {
-                continue;
-            }
-            // we only get base tablet's stat
-            stat.__set_data_size(tablet->tablet_footprint());
-            stat.__set_row_num(tablet->num_rows());
-            VLOG(3) << "tablet_id=" << item.first
-                    << ", data_size=" << tablet->tablet_footprint()
-                    << ", row_num:" << tablet->num_rows();
-            break;
-        }
-
-        _tablet_stat_cache.emplace(item.first, stat);
+        stat.tablet_id = tablet->tablet_id();
+        stat.__set_data_size(tablet->tablet_footprint());
+        stat.__set_row_num(tablet->num_rows());
+        VLOG(3) << "tablet_id=" << tablet->tablet_id()
+                << ", data_size=" << tablet->tablet_footprint()
+                << ", row_num:" << tablet->num_rows();
+        _tablet_stat_cache.emplace(tablet->tablet_id(), stat);
     }
 
     _tablet_stat_cache_update_time_ms = UnixMillis();
@@ -1323,38 +1399,50 @@ OLAPStatus TabletManager::_drop_tablet_directly_unlocked(
         return OLAP_ERR_TABLE_NOT_FOUND;
     }
 
-    for (list<TabletSharedPtr>::iterator it = _tablet_map[tablet_id].table_arr.begin();
-            it != _tablet_map[tablet_id].table_arr.end();) {
-        if ((*it)->equal(tablet_id, schema_hash)) {
-            TabletSharedPtr tablet = *it;
-            _partition_tablet_map[(*it)->partition_id()].erase((*it)->get_tablet_info());
-            if (_partition_tablet_map[(*it)->partition_id()].empty()) {
-                _partition_tablet_map.erase((*it)->partition_id());
-            } 
-            it = _tablet_map[tablet_id].table_arr.erase(it);
-            if (!keep_files) {
-                // drop tablet will update tablet meta, should lock
-                WriteLock wrlock(tablet->get_header_lock_ptr()); 
-                LOG(INFO) << "set tablet to shutdown state and remove it from memory"
-                          << " tablet_id=" << tablet_id
-                          << " schema_hash=" << schema_hash
-                          << " tablet path=" << dropped_tablet->tablet_path();
-                // has to update tablet here, must not update tablet meta directly
-                // because other thread may hold the tablet object, they may save meta too
-                // if update meta directly here, other thread may override the meta
-                // and the tablet will be loaded at restart time.
-                tablet->set_tablet_state(TABLET_SHUTDOWN);
-                res = tablet->save_meta();
-                if (res != OLAP_SUCCESS) {
-                    LOG(WARNING) << "fail to drop tablet. " 
-                                 << " tablet_id=" << tablet_id
-                                 << " schema_hash=" << schema_hash;
-                    return res;
+    std::vector<TabletSharedPtr> dropped_tablets;
+    {
+        TabletsShard& shard = _get_tablets_shard(tablet_id);
+        WriteLock wlock(&shard.lock);
+        std::list<TabletSharedPtr>& table_arr = shard.tablet_map[tablet_id].table_arr;
+        for (list<TabletSharedPtr>::iterator it = table_arr.begin(); it != table_arr.end();) {
+            if ((*it)->equal(tablet_id, schema_hash)) {
+                _partition_tablet_map[(*it)->partition_id()].erase((*it)->get_tablet_info());
+                if (_partition_tablet_map[(*it)->partition_id()].empty()) {
+                    _partition_tablet_map.erase((*it)->partition_id());
                 }
-                _shutdown_tablets.push_back(tablet);
+                dropped_tablets.push_back(*it);
+                it = table_arr.erase(it);
+            } else {
+                ++it;
             }
-        } else {
-            ++it;
+        }
+        ++_tablets_version;
+    }
+
+    // meta of dropped tablets is saved after releasing shard lock, to not
+    // block getting other tablets of this shard
+    for (TabletSharedPtr& tablet : dropped_tablets) {
+        if (!keep_files) {
+            // drop tablet will update tablet meta, should lock
+            WriteLock wrlock(tablet->get_header_lock_ptr()); 
+            LOG(INFO) << "set tablet to shutdown state and remove it from memory"
+                      << " tablet_id=" << tablet_id
+                      << " schema_hash=" << schema_hash
+                      << " tablet path=" << dropped_tablet->tablet_path();
+            // has to update tablet here, must not update tablet meta directly
+            // because other thread may hold the tablet object, they may save meta too
+            // if update meta directly here, other thread may override the meta
+            // and the tablet will be loaded at restart time.
+            tablet->set_tablet_state(TABLET_SHUTDOWN);
+            res = tablet->save_meta();
+            if (res != OLAP_SUCCESS) {
+                LOG(WARNING) << "fail to drop tablet. " 
+                             << " tablet_id=" << tablet_id
+                             << " schema_hash=" << schema_hash;
+                return res;
+            }
+            MutexLock lock(&_shutdown_tablets_lock);
+            _shutdown_tablets.push_back(tablet);
         }
     }
 
@@ -1371,8 +1459,9 @@ OLAPStatus TabletManager::_drop_tablet_directly_unlocked(
 TabletSharedPtr TabletManager::_get_tablet_with_no_lock(TTabletId tablet_id, SchemaHash schema_hash) {
     VLOG(3) << "begin to get tablet. tablet_id=" << tablet_id
             << ", schema_hash=" << schema_hash;
-    tablet_map_t::iterator it = _tablet_map.find(tablet_id);
-    if (it != _tablet_map.end()) {
+    tablet_map_t& tablet_map = _get_tablets_shard(tablet_id).tablet_map;
+    tablet_map_t::iterator it = tablet_map.find(tablet_id);
+    if (it != tablet_map.end()) {
         for (TabletSharedPtr tablet : it->second.table_arr) {
             CHECK(tablet != nullptr) << "tablet is nullptr:" << tablet;
             if (tablet->equal(tablet_id, schema_hash)) {
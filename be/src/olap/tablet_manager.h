@@ -18,9 +18,11 @@
 #ifndef DORIS_BE_SRC_OLAP_TABLET_MANAGER_H
 #define DORIS_BE_SRC_OLAP_TABLET_MANAGER_H
 
+#include <atomic>
 #include <ctime>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <condition_variable>
 #include <set>
@@ -55,7 +57,7 @@ public:
     TabletManager();
 
     ~TabletManager() {
-        _tablet_map.clear();
+        clear();
     }
 
     void cancel_unfinished_schema_change();
@@ -88,6 +90,14 @@ public:
 
     TabletSharedPtr find_best_tablet_to_compaction(CompactionType compaction_type, DataDir* data_dir);
 
+    // Get tablets of all data dirs which can do compaction_type of compaction
+    // now, together with their compaction scores.
+    void get_compaction_candidates(CompactionType compaction_type,
+                                   std::vector<std::pair<TabletSharedPtr, uint32_t>>* candidates);
+
+    // update recent query load of all tablets, called by compaction scheduler
+    void update_tablets_query_load();
+
     // Get tablet pointer
     TabletSharedPtr get_tablet(TTabletId tablet_id, SchemaHash schema_hash,
                                bool include_deleted = false, std::string* err = nullptr);
@@ -147,6 +157,11 @@ private:
                                  const TabletSharedPtr& tablet, bool update_meta, 
                                  bool keep_files, bool drop_old);
 
+    // Return compaction score of tablet, or 0 if it can't do compaction now.
+    // If data_dir is not nullptr, tablets on other data dirs are skipped.
+    uint32_t _get_compaction_score(const TabletSharedPtr& tablet, CompactionType compaction_type,
+                                   DataDir* data_dir, int64_t now);
+
     void _build_tablet_info(TabletSharedPtr tablet, TTabletInfo* tablet_info);
     
     void _build_tablet_stat();
@@ -175,28 +190,69 @@ private:
     TabletSharedPtr _create_tablet_meta_and_dir(const TCreateTabletReq& request, const bool is_schema_change_tablet,
         const TabletSharedPtr ref_tablet, std::vector<DataDir*> data_dirs);
 
+    // create meta, dirs and initial rowset of a new tablet without adding it
+    // to tablet map, so it does not need _tablet_map_write_lock.
+    // return nullptr and clean up if failed.
+    TabletSharedPtr _init_new_tablet(const AlterTabletType alter_type, const TCreateTabletReq& request,
+        const bool is_schema_change_tablet, const TabletSharedPtr ref_tablet, std::vector<DataDir*> data_dirs);
+
+    // add tablet created by _init_new_tablet to tablet map, drop it if failed
+    OLAPStatus _add_new_tablet_unlock(const TCreateTabletReq& request, TabletSharedPtr tablet);
+
 private:
     struct TableInstances {
         Mutex schema_change_lock;
         std::list<TabletSharedPtr> table_arr;
     };
     typedef std::map<int64_t, TableInstances> tablet_map_t;
-    RWMutex _tablet_map_lock;
+
+    // Tablets are sharded by tablet id, each shard has its own lock, so that
+    // getting a tablet only contends with operations on the same shard.
+    struct TabletsShard {
+        RWMutex lock;
+        tablet_map_t tablet_map;
+    };
+
+    TabletsShard& _get_tablets_shard(TTabletId tablet_id) {
+        return _tablets_shards[tablet_id & _tablets_shards_mask];
+    }
+
+    // Return all tablets of all shards. The snapshot is rebuilt only if any
+    // tablet is added or dropped since last call, so it is cheap to iterate
+    // all tablets frequently, and no lock of shards is held while iterating.
+    std::shared_ptr<const std::vector<TabletSharedPtr>> _get_tablets_snapshot();
+
+    // Serializes operations which add or drop tablets. Tablet maps are only
+    // modified when it is held, together with write lock of the shard, so
+    // these operations can read maps of all shards without shard locks.
+    Mutex _tablet_map_write_lock;
     RWMutex _create_tablet_lock;
-    tablet_map_t _tablet_map;
+    // ids of tablets being created out of _tablet_map_write_lock, protected
+    // by _tablet_map_write_lock
+    std::set<TTabletId> _creating_tablet_ids;
+    std::vector<TabletsShard> _tablets_shards;
+    int64_t _tablets_shards_mask;
     std::map<std::string, DataDir*> _store_map;
 
+    // increased when any tablet is added or dropped
+    std::atomic<uint64_t> _tablets_version;
+    Mutex _tablets_snapshot_lock;
+    std::shared_ptr<const std::vector<TabletSharedPtr>> _tablets_snapshot;
+    uint64_t _tablets_snapshot_version = 0;
+
     // cache to save tablets' statistics, such as data size and row
     // TODO(cmy): for now, this is a naive implementation
     std::map<int64_t, TTabletStat> _tablet_stat_cache;
     // last update time of tablet stat cache
     int64_t _tablet_stat_cache_update_time_ms;
+    Mutex _tablet_stat_cache_lock;
 
     uint32_t _available_storage_medium_type_count;
 
     std::vector<TabletSharedPtr> _shutdown_tablets;
+    Mutex _shutdown_tablets_lock;
 
-    // map from partition id to tablet_id
+    // map from partition id to tablet_id, protected by _tablet_map_write_lock
     std::map<int64_t, std::set<TabletInfo>> _partition_tablet_map;
 
     DISALLOW_COPY_AND_ASSIGN(TabletManager);
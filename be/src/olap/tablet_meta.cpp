@@ -679,6 +679,16 @@ bool TabletMeta::version_for_delete_predicate(const Version& version) {
     return false;
 }
 
+bool TabletMeta::has_delete_predicate_until(int64_t version) const {
+    for (auto& del_pred : _del_pred_array) {
+        if (del_pred.version() <= version) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 OLAPStatus TabletMeta::get_next_rowset_id(RowsetId* gen_rowset_id, DataDir* data_dir) {
     WriteLock wrlock(&_meta_lock);
     if (_next_rowset_id >= _end_rowset_id) {
@@ -174,6 +174,8 @@ public:
     OLAPStatus remove_delete_predicate_by_version(const Version& version);
     DelPredicateArray delete_predicates() const;
     bool version_for_delete_predicate(const Version& version);
+    // whether any delete predicate takes effect on reads up to the version
+    bool has_delete_predicate_until(int64_t version) const;
     AlterTabletTaskSharedPtr alter_task();
     OLAPStatus add_alter_task(const AlterTabletTask& alter_task);
     OLAPStatus delete_alter_task();
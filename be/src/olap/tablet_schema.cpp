@@ -91,8 +91,12 @@ FieldAggregationMethod TabletColumn::get_aggregation_type_by_string(const std::s
         aggregation_type = OLAP_FIELD_AGGREGATION_MAX;
     } else if (0 == upper_str.compare("REPLACE")) {
         aggregation_type = OLAP_FIELD_AGGREGATION_REPLACE;
+    } else if (0 == upper_str.compare("REPLACE_IF_NOT_NULL")) {
+        aggregation_type = OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL;
     } else if (0 == upper_str.compare("HLL_UNION")) {
         aggregation_type = OLAP_FIELD_AGGREGATION_HLL_UNION;
+    } else if (0 == upper_str.compare("BITMAP_UNION")) {
+        aggregation_type = OLAP_FIELD_AGGREGATION_BITMAP_UNION;
     } else {
         LOG(WARNING) << "invalid aggregation type string. [aggregation='" << str << "']";
         aggregation_type = OLAP_FIELD_AGGREGATION_UNKNOWN;
@@ -188,9 +192,15 @@ std::string TabletColumn::get_string_by_aggregation_type(FieldAggregationMethod
         case OLAP_FIELD_AGGREGATION_REPLACE:
             return "REPLACE";
 
+        case OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL:
+            return "REPLACE_IF_NOT_NULL";
+
         case OLAP_FIELD_AGGREGATION_HLL_UNION:
             return "HLL_UNION";
 
+        case OLAP_FIELD_AGGREGATION_BITMAP_UNION:
+            return "BITMAP_UNION";
+
         default:
             return "UNKNOWN";
     }
@@ -265,6 +275,11 @@ OLAPStatus TabletColumn::init_from_pb(const ColumnPB& column) {
     } else {
         _is_bf_column = false;
     }
+    if (column.has_is_bitmap_column()) {
+        _is_bitmap_column = column.is_bitmap_column();
+    } else {
+        _is_bitmap_column = false;
+    }
     _has_referenced_column = column.has_referenced_column_id();
     if (_has_referenced_column) {
         _referenced_column_id = column.referenced_column_id();
@@ -293,6 +308,9 @@ OLAPStatus TabletColumn::to_schema_pb(ColumnPB* column) {
     if (_is_bf_column) {
         column->set_is_bf_column(_is_bf_column);
     }
+    if (_is_bitmap_column) {
+        column->set_is_bitmap_column(_is_bitmap_column);
+    }
     column->set_aggregation(get_string_by_aggregation_type(_aggregation));
     if (_has_referenced_column) {
         column->set_referenced_column_id(_referenced_column_id);
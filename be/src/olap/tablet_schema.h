@@ -39,6 +39,7 @@ public:
     inline bool is_key() const { return _is_key; }
     inline bool is_nullable() const { return _is_nullable; }
     inline bool is_bf_column() const { return _is_bf_column; }
+    inline bool is_bitmap_column() const { return _is_bitmap_column; }
     bool has_default_value() const { return _has_default_value; }
     std::string default_value() const { return _default_value; }
     bool has_reference_column() const { return _has_referenced_column; }
@@ -74,7 +75,8 @@ private:
     int32_t _length;
     int32_t _index_length;
 
-    bool _is_bf_column;
+    bool _is_bf_column = false;
+    bool _is_bitmap_column = false;
 
     bool _has_referenced_column;
     int32_t _referenced_column_id;
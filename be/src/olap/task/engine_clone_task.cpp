@@ -17,7 +17,10 @@
 
 #include "olap/task/engine_clone_task.h"
 
+#include <algorithm>
+#include <atomic>
 #include <set>
+#include <thread>
 
 #include "http/http_client.h"
 #include "olap/olap_snapshot_converter.h"
@@ -27,6 +30,7 @@
 #include "olap/rowset/rowset.h"
 #include "olap/rowset/rowset_id_generator.h"
 #include "olap/rowset/rowset_writer.h"
+#include "util/defer_op.h"
 
 using std::set;
 using std::stringstream;
@@ -40,6 +44,19 @@ const uint32_t DOWNLOAD_FILE_MAX_RETRY = 3;
 const uint32_t LIST_REMOTE_FILE_TIMEOUT = 15;
 const uint32_t GET_LENGTH_TIMEOUT = 10;
 
+// number of files being downloaded by all clone tasks
+static std::atomic<int64_t> s_downloading_file_num(0);
+
+// share of config::clone_max_download_speed_kbps of a file to download
+static int64_t clone_download_speed_share_kbps() {
+    if (config::clone_max_download_speed_kbps <= 0) {
+        return -1;
+    }
+    int64_t share = config::clone_max_download_speed_kbps / std::max<int64_t>(s_downloading_file_num, 1);
+    // keep above the low speed limit, otherwise curl aborts the download
+    return std::max<int64_t>(share, config::download_low_speed_limit_kbps * 2);
+}
+
 EngineCloneTask::EngineCloneTask(const TCloneReq& clone_req, 
                     const TMasterInfo& master_info,  
                     int64_t signature, 
@@ -437,11 +454,11 @@ AgentStatus EngineCloneTask::_clone_copy(
         }
 
         // Get copy from remote
-        uint64_t total_file_size = 0;
+        std::atomic<uint64_t> downloaded_file_size(0);
         MonotonicStopWatch watch;
         watch.start();
-        for (auto& file_name : file_name_list) {
-            remote_file_path = http_host + HTTP_REQUEST_PREFIX
+        auto download_file = [&] (const string& file_name) {
+            std::string remote_file_path = http_host + HTTP_REQUEST_PREFIX
                 + HTTP_REQUEST_TOKEN_PARAM + token
                 + HTTP_REQUEST_FILE_PARAM + src_file_full_path + file_name;
 
@@ -454,17 +471,16 @@ AgentStatus EngineCloneTask::_clone_copy(
                 file_size = client->get_content_length();
                 return Status::OK();
             };
-            download_status = HttpClient::execute_with_retry(
+            Status st = HttpClient::execute_with_retry(
                 DOWNLOAD_FILE_MAX_RETRY, 1, get_file_size_cb);
-            if (!download_status.ok()) {
+            if (!st.ok()) {
                 LOG(WARNING) << "clone copy get file length failed over max time. remote_path="
                     << remote_file_path
                     << ", signature=" << signature;
-                status = DORIS_ERROR;
-                break;
+                return st;
             }
 
-            total_file_size += file_size;
+            downloaded_file_size += file_size;
             uint64_t estimate_timeout = file_size / config::download_low_speed_limit_kbps / 1024;
             if (estimate_timeout < config::download_low_speed_time) {
                 estimate_timeout = config::download_low_speed_time;
@@ -472,38 +488,96 @@ AgentStatus EngineCloneTask::_clone_copy(
 
             std::string local_file_path = local_file_full_path + file_name;
 
+            s_downloading_file_num++;
+            DeferOp dec_downloading_file_num([] () { s_downloading_file_num--; });
             auto download_cb = [&remote_file_path,
                                 estimate_timeout,
                                 &local_file_path,
                                 file_size] (HttpClient* client) {
                 RETURN_IF_ERROR(client->init(remote_file_path));
                 client->set_timeout_ms(estimate_timeout * 1000);
-                RETURN_IF_ERROR(client->download(local_file_path));
+                client->set_max_download_speed_kbps(clone_download_speed_share_kbps());
+                // resume the part downloaded by the last failed try
+                boost::system::error_code ec;
+                uint64_t local_file_size = boost::filesystem::file_size(local_file_path, ec);
+                bool resume = !ec && local_file_size > 0 && local_file_size < file_size;
+                Status st = client->download(local_file_path, resume);
+                if (!st.ok()) {
+                    if (resume) {
+                        // source may not support range, download the whole file next time
+                        boost::filesystem::remove(local_file_path, ec);
+                    }
+                    return st;
+                }
 
                 // Check file length
-                uint64_t local_file_size = boost::filesystem::file_size(local_file_path);
+                local_file_size = boost::filesystem::file_size(local_file_path);
                 if (local_file_size != file_size) {
                     LOG(WARNING) << "download file length error"
                         << ", remote_path=" << remote_file_path
                         << ", file_size=" << file_size
                         << ", local_file_size=" << local_file_size;
+                    boost::filesystem::remove(local_file_path, ec);
                     return Status::InternalError("downloaded file size is not equal");
                 }
                 chmod(local_file_path.c_str(), S_IRUSR | S_IWUSR);
                 return Status::OK();
             };
-            download_status = HttpClient::execute_with_retry(
+            st = HttpClient::execute_with_retry(
                 DOWNLOAD_FILE_MAX_RETRY, 1, download_cb);
-            if (!download_status.ok()) {
+            if (!st.ok()) {
                 LOG(WARNING) << "download file failed over max retry."
                     << ", remote_path=" << remote_file_path
                     << ", signature=" << signature
-                    << ", errormsg=" << download_status.get_error_msg();
+                    << ", errormsg=" << st.get_error_msg();
+            }
+            return st;
+        };
+
+        // header files are at the end of file_name_list, and they are
+        // downloaded after all data files are downloaded
+        size_t num_data_files = 0;
+        while (num_data_files < file_name_list.size()
+                && !(file_name_list[num_data_files].size() > 4
+                    && file_name_list[num_data_files].substr(
+                        file_name_list[num_data_files].size() - 4, 4) == ".hdr")) {
+            ++num_data_files;
+        }
+        if (status == DORIS_SUCCESS) {
+            std::atomic<size_t> next_file_idx(0);
+            std::atomic<bool> download_failed(false);
+            auto download_worker = [&] () {
+                while (!download_failed) {
+                    size_t idx = next_file_idx++;
+                    if (idx >= num_data_files) {
+                        break;
+                    }
+                    if (!download_file(file_name_list[idx]).ok()) {
+                        download_failed = true;
+                    }
+                }
+            };
+            int num_threads = std::min<int>(
+                std::max(config::clone_download_file_thread_num, 1), num_data_files);
+            std::vector<std::thread> download_threads;
+            for (int i = 1; i < num_threads; ++i) {
+                download_threads.emplace_back(download_worker);
+            }
+            download_worker();
+            for (auto& thread : download_threads) {
+                thread.join();
+            }
+            if (download_failed) {
+                status = DORIS_ERROR;
+            }
+        }
+        for (size_t i = num_data_files; status == DORIS_SUCCESS && i < file_name_list.size(); ++i) {
+            if (!download_file(file_name_list[i]).ok()) {
                 status = DORIS_ERROR;
-                break;
             }
         } // Clone files from remote backend
 
+        uint64_t total_file_size = downloaded_file_size;
         uint64_t total_time_ms = watch.elapsed_time() / 1000 / 1000;
         total_time_ms = total_time_ms > 0 ? total_time_ms : 0;
         double copy_rate = 0.0;
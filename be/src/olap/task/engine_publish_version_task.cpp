@@ -17,8 +17,11 @@
 
 #include "olap/task/engine_publish_version_task.h"
 #include "olap/data_dir.h"
+#include "olap/olap_meta.h"
 #include "olap/rowset/rowset_meta_manager.h"
 #include "olap/tablet_manager.h"
+#include "util/doris_metrics.h"
+#include "util/stopwatch.hpp"
 #include <map>
 
 namespace doris {
@@ -34,8 +37,13 @@ OLAPStatus EnginePublishVersionTask::finish() {
     LOG(INFO) << "begin to process publish version. transaction_id="
               << _publish_version_req.transaction_id;
 
+    MonotonicStopWatch watch;
+    watch.start();
     int64_t transaction_id = _publish_version_req.transaction_id;
     OLAPStatus res = OLAP_SUCCESS;
+    // meta of all tablets is synced once when all of them are published
+    OlapMetaSyncScope sync_scope;
+    std::vector<TTabletId> published_tablet_ids;
 
     // each partition
     for (auto& partitionVersionInfo
@@ -109,12 +117,23 @@ OLAPStatus EnginePublishVersionTask::finish() {
                       << ", res=" << publish_status;
             // delete rowset from meta env, because add inc rowset alreay saved the rowset meta to tablet meta
             RowsetMetaManager::remove(tablet->data_dir()->get_meta(), tablet->tablet_uid(), rowset->rowset_id());
+            published_tablet_ids.push_back(tablet_info.tablet_id);
         }
     }
 
+    OLAPStatus sync_status = sync_scope.finish();
+    if (sync_status != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to sync meta of published tablets. transaction_id=" << transaction_id
+                     << ", res=" << sync_status;
+        _error_tablet_ids->insert(_error_tablet_ids->end(),
+                                  published_tablet_ids.begin(), published_tablet_ids.end());
+        res = sync_status;
+    }
+
     LOG(INFO) << "finish to publish version on transaction."
               << "transaction_id=" << transaction_id
               << ", error_tablet_size=" << _error_tablet_ids->size();
+    DorisMetrics::publish_version_latency_us.add(watch.elapsed_time() / 1000);
     return res;
 }
 
@@ -0,0 +1,298 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/task/engine_pull_rowset_task.h"
+
+#include <sys/stat.h>
+
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+#include "common/config.h"
+#include "http/http_client.h"
+#include "olap/data_dir.h"
+#include "olap/schema_change.h"
+#include "olap/rowset/alpha_rowset.h"
+#include "olap/rowset/alpha_rowset_meta.h"
+#include "olap/rowset/alpha_rowset_writer.h"
+#include "olap/rowset/rowset_id_generator.h"
+#include "olap/rowset/rowset_writer.h"
+
+namespace doris {
+
+static const std::string PULL_ROWSET_HTTP_PREFIX = "/api/_tablet/_download?token=";
+static const uint32_t PULL_ROWSET_MAX_RETRY = 3;
+static const uint32_t PULL_ROWSET_LIST_FILE_TIMEOUT = 15;
+
+EnginePullRowsetTask::EnginePullRowsetTask(const PTabletWriterPullRowsetRequest& request,
+                                           const std::string& token)
+        : _request(request), _token(token) {
+}
+
+OLAPStatus EnginePullRowsetTask::execute() {
+    _tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+        _request.tablet_id(), _request.schema_hash());
+    if (_tablet == nullptr) {
+        LOG(WARNING) << "tablet_id: " << _request.tablet_id() << ", "
+                     << "schema_hash: " << _request.schema_hash() << " not found";
+        return OLAP_ERR_TABLE_NOT_FOUND;
+    }
+
+    // rowset files are downloaded to snapshot path of the same data dir,
+    // so that they can be linked into tablet path
+    std::stringstream local_path_ss;
+    local_path_ss << _tablet->data_dir()->path() << SNAPSHOT_PREFIX
+        << "/single_replica_pull_" << _request.txn_id() << "_" << _request.tablet_id() << "/";
+    std::string local_path = local_path_ss.str();
+
+    OLAPStatus res = _download_files(local_path);
+    if (res == OLAP_SUCCESS) {
+        res = _commit_rowset(local_path);
+    }
+    if (res != OLAP_SUCCESS) {
+        _garbage_collection();
+    }
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(local_path, ec);
+    return res;
+}
+
+OLAPStatus EnginePullRowsetTask::_download_files(const std::string& local_path) {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(local_path, ec);
+    if (!boost::filesystem::create_directories(local_path, ec)) {
+        LOG(WARNING) << "fail to create dir. path=" << local_path << ", error=" << ec.message();
+        return OLAP_ERR_CANNOT_CREATE_DIR;
+    }
+
+    std::stringstream remote_dir_ss;
+    remote_dir_ss << "http://" << _request.host() << ":" << _request.http_port()
+        << PULL_ROWSET_HTTP_PREFIX << _token << "&file=" << _request.path();
+    std::string remote_dir = remote_dir_ss.str();
+
+    std::string file_list_str;
+    auto list_files_cb = [&remote_dir, &file_list_str] (HttpClient* client) {
+        RETURN_IF_ERROR(client->init(remote_dir));
+        client->set_timeout_ms(PULL_ROWSET_LIST_FILE_TIMEOUT * 1000);
+        RETURN_IF_ERROR(client->execute(&file_list_str));
+        return Status::OK();
+    };
+    Status st = HttpClient::execute_with_retry(PULL_ROWSET_MAX_RETRY, 1, list_files_cb);
+    if (!st.ok()) {
+        LOG(WARNING) << "fail to list remote rowset files. path=" << remote_dir
+                     << ", errmsg=" << st.get_error_msg();
+        return OLAP_ERR_OTHER_ERROR;
+    }
+
+    std::vector<std::string> file_names;
+    size_t start = 0;
+    while (start < file_list_str.size()) {
+        size_t end = file_list_str.find("\n", start);
+        if (end == std::string::npos) {
+            end = file_list_str.size();
+        }
+        if (end > start) {
+            file_names.push_back(file_list_str.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+
+    for (auto& file_name : file_names) {
+        std::string remote_file = remote_dir + file_name;
+        std::string local_file = local_path + file_name;
+
+        uint64_t file_size = 0;
+        auto get_file_size_cb = [&remote_file, &file_size] (HttpClient* client) {
+            RETURN_IF_ERROR(client->init(remote_file));
+            client->set_timeout_ms(PULL_ROWSET_LIST_FILE_TIMEOUT * 1000);
+            RETURN_IF_ERROR(client->head());
+            file_size = client->get_content_length();
+            return Status::OK();
+        };
+        st = HttpClient::execute_with_retry(PULL_ROWSET_MAX_RETRY, 1, get_file_size_cb);
+        if (!st.ok()) {
+            LOG(WARNING) << "fail to get length of remote file. path=" << remote_file
+                         << ", errmsg=" << st.get_error_msg();
+            return OLAP_ERR_OTHER_ERROR;
+        }
+
+        uint64_t estimate_timeout = file_size / config::download_low_speed_limit_kbps / 1024;
+        if (estimate_timeout < config::download_low_speed_time) {
+            estimate_timeout = config::download_low_speed_time;
+        }
+        auto download_cb = [&remote_file, &local_file, estimate_timeout, file_size] (
+                HttpClient* client) {
+            RETURN_IF_ERROR(client->init(remote_file));
+            client->set_timeout_ms(estimate_timeout * 1000);
+            RETURN_IF_ERROR(client->download(local_file));
+            uint64_t local_file_size = boost::filesystem::file_size(local_file);
+            if (local_file_size != file_size) {
+                LOG(WARNING) << "download file length error"
+                    << ", remote_path=" << remote_file
+                    << ", file_size=" << file_size
+                    << ", local_file_size=" << local_file_size;
+                return Status::InternalError("downloaded file size is not equal");
+            }
+            chmod(local_file.c_str(), S_IRUSR | S_IWUSR);
+            return Status::OK();
+        };
+        st = HttpClient::execute_with_retry(PULL_ROWSET_MAX_RETRY, 1, download_cb);
+        if (!st.ok()) {
+            LOG(WARNING) << "fail to download remote file. path=" << remote_file
+                         << ", errmsg=" << st.get_error_msg();
+            return OLAP_ERR_OTHER_ERROR;
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus EnginePullRowsetTask::_commit_rowset(const std::string& local_path) {
+    RowsetMetaPB rowset_meta_pb;
+    if (!rowset_meta_pb.ParseFromString(_request.rowset_meta())) {
+        LOG(WARNING) << "fail to parse rowset meta. tablet_id=" << _request.tablet_id()
+                     << ", txn_id=" << _request.txn_id();
+        return OLAP_ERR_PARSE_PROTOBUF_ERROR;
+    }
+    RowsetMetaSharedPtr remote_rowset_meta(new AlphaRowsetMeta());
+    remote_rowset_meta->init_from_pb(rowset_meta_pb);
+    RowsetSharedPtr remote_rowset(new AlphaRowset(&(_tablet->tablet_schema()), local_path,
+                                                  _tablet->data_dir(), remote_rowset_meta));
+    RETURN_NOT_OK(remote_rowset->init());
+    // do not use cache, because files in local path are removed soon
+    RETURN_NOT_OK(remote_rowset->load(false));
+
+    {
+        ReadLock base_migration_rlock(_tablet->get_migration_lock_ptr(), TRY_LOCK);
+        if (!base_migration_rlock.own_lock()) {
+            return OLAP_ERR_RWLOCK_ERROR;
+        }
+        MutexLock push_lock(_tablet->get_push_lock());
+        RETURN_NOT_OK(StorageEngine::instance()->txn_manager()->prepare_txn(
+                            _request.partition_id(), _request.txn_id(),
+                            _request.tablet_id(), _request.schema_hash(), _tablet->tablet_uid(),
+                            _request.id()));
+        if (_request.need_gen_rollup()) {
+            AlterTabletTaskSharedPtr alter_task = _tablet->alter_task();
+            if (alter_task != nullptr && alter_task->alter_state() != ALTER_FAILED) {
+                _new_tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+                    alter_task->related_tablet_id(), alter_task->related_schema_hash());
+                if (_new_tablet == nullptr) {
+                    LOG(WARNING) << "find alter task, but could not find new tablet tablet_id: "
+                                 << alter_task->related_tablet_id()
+                                 << ", schema_hash: " << alter_task->related_schema_hash();
+                    return OLAP_ERR_TABLE_NOT_FOUND;
+                }
+                RETURN_NOT_OK(StorageEngine::instance()->txn_manager()->prepare_txn(
+                                    _request.partition_id(), _request.txn_id(),
+                                    _new_tablet->tablet_id(), _new_tablet->schema_hash(),
+                                    _new_tablet->tablet_uid(), _request.id()));
+            }
+        }
+    }
+
+    RowsetId rowset_id = 0;
+    OLAPStatus res = _tablet->next_rowset_id(&rowset_id);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "generate rowset id failed, status:" << res;
+        return OLAP_ERR_ROWSET_GENERATE_ID_FAILED;
+    }
+    RowsetWriterContext writer_context;
+    writer_context.rowset_id = rowset_id;
+    writer_context.tablet_uid = _tablet->tablet_uid();
+    writer_context.tablet_id = _request.tablet_id();
+    writer_context.partition_id = _request.partition_id();
+    writer_context.tablet_schema_hash = _request.schema_hash();
+    writer_context.rowset_type = ALPHA_ROWSET;
+    writer_context.rowset_path_prefix = _tablet->tablet_path();
+    writer_context.tablet_schema = &(_tablet->tablet_schema());
+    writer_context.rowset_state = PREPARED;
+    writer_context.data_dir = _tablet->data_dir();
+    writer_context.txn_id = _request.txn_id();
+    writer_context.load_id = _request.id();
+
+    // files are linked into tablet path with new rowset id
+    RowsetWriterSharedPtr rowset_writer(new AlphaRowsetWriter());
+    RETURN_NOT_OK(rowset_writer->init(writer_context));
+    res = rowset_writer->add_rowset(remote_rowset);
+    if (res == OLAP_SUCCESS) {
+        _rowset = rowset_writer->build();
+        if (_rowset == nullptr) {
+            LOG(WARNING) << "fail to build rowset";
+            res = OLAP_ERR_MALLOC_ERROR;
+        }
+    }
+    if (res == OLAP_SUCCESS) {
+        res = StorageEngine::instance()->txn_manager()->commit_txn(
+            _tablet->data_dir()->get_meta(), _request.partition_id(), _request.txn_id(),
+            _request.tablet_id(), _request.schema_hash(), _tablet->tablet_uid(),
+            _request.id(), _rowset, false);
+        if (res == OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST) {
+            res = OLAP_SUCCESS;
+        }
+    }
+    _tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX + std::to_string(rowset_id));
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "commit txn: " << _request.txn_id()
+                     << " for pulled rowset of tablet: " << _request.tablet_id()
+                     << " failed, res=" << res;
+        return res;
+    }
+
+    if (_new_tablet != nullptr) {
+        LOG(INFO) << "convert version for schema change";
+        SchemaChangeHandler schema_change;
+        res = schema_change.schema_version_convert(_tablet, _new_tablet, &_rowset, &_new_rowset);
+        if (res != OLAP_SUCCESS) {
+            LOG(WARNING) << "failed to convert delta for new tablet in schema change."
+                         << "res: " << res << ", "
+                         << "new_tablet: " << _new_tablet->full_name();
+            return res;
+        }
+        res = StorageEngine::instance()->txn_manager()->commit_txn(
+            _new_tablet->data_dir()->get_meta(), _request.partition_id(), _request.txn_id(),
+            _new_tablet->tablet_id(), _new_tablet->schema_hash(), _new_tablet->tablet_uid(),
+            _request.id(), _new_rowset, false);
+        if (res != OLAP_SUCCESS && res != OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST) {
+            LOG(WARNING) << "save pending rowset failed. rowset_id:"
+                         << _new_rowset->rowset_id();
+            return res;
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+void EnginePullRowsetTask::_garbage_collection() {
+    // same as DeltaWriter, rowset can't be deleted if rollback is failed,
+    // because it may have been published
+    OLAPStatus rollback_status = StorageEngine::instance()->txn_manager()->rollback_txn(
+        _request.partition_id(), _request.txn_id(), _request.tablet_id(),
+        _request.schema_hash(), _tablet->tablet_uid());
+    if (rollback_status == OLAP_SUCCESS && _rowset != nullptr) {
+        StorageEngine::instance()->add_unused_rowset(_rowset);
+    }
+    if (_new_tablet != nullptr) {
+        rollback_status = StorageEngine::instance()->txn_manager()->rollback_txn(
+            _request.partition_id(), _request.txn_id(), _new_tablet->tablet_id(),
+            _new_tablet->schema_hash(), _new_tablet->tablet_uid());
+        if (rollback_status == OLAP_SUCCESS && _new_rowset != nullptr) {
+            StorageEngine::instance()->add_unused_rowset(_new_rowset);
+        }
+    }
+}
+
+} // doris
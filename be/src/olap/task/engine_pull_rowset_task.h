@@ -0,0 +1,61 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_OLAP_TASK_ENGINE_PULL_ROWSET_TASK_H
+#define DORIS_BE_SRC_OLAP_TASK_ENGINE_PULL_ROWSET_TASK_H
+
+#include <string>
+
+#include "gen_cpp/internal_service.pb.h"
+#include "olap/olap_define.h"
+#include "olap/rowset/rowset.h"
+#include "olap/task/engine_task.h"
+
+namespace doris {
+
+// Used in single replica load. The rowset of a load is only built by one
+// replica, other replicas download files of the rowset from it by http and
+// commit a rowset with the same data in transaction, so that data is not
+// sorted and encoded again in every replica.
+class EnginePullRowsetTask : public EngineTask {
+public:
+    virtual OLAPStatus execute();
+
+public:
+    EnginePullRowsetTask(const PTabletWriterPullRowsetRequest& request,
+                         const std::string& token);
+    ~EnginePullRowsetTask() {}
+
+private:
+    // download all files in remote path to local_path
+    OLAPStatus _download_files(const std::string& local_path);
+    // build a rowset of tablet from downloaded files, and commit it in txn
+    OLAPStatus _commit_rowset(const std::string& local_path);
+    void _garbage_collection();
+
+private:
+    const PTabletWriterPullRowsetRequest& _request;
+    std::string _token;
+
+    TabletSharedPtr _tablet;
+    TabletSharedPtr _new_tablet;
+    RowsetSharedPtr _rowset;
+    RowsetSharedPtr _new_rowset;
+}; // EnginePullRowsetTask
+
+} // doris
+#endif //DORIS_BE_SRC_OLAP_TASK_ENGINE_PULL_ROWSET_TASK_H
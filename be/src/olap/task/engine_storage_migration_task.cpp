@@ -17,6 +17,9 @@
 
 #include "olap/task/engine_storage_migration_task.h"
 
+#include <stdio.h>
+
+#include "olap/data_dir.h"
 #include "olap/snapshot_manager.h"
 #include "olap/tablet_meta_manager.h"
 
@@ -69,8 +72,61 @@ OLAPStatus EngineStorageMigrationTask::_storage_medium_migrate(
         return OLAP_SUCCESS;
     }
 
+    // files of the current rowsets are copied without blocking loads, reads
+    // are served by the old tablet until the new one is loaded
+    vector<RowsetSharedPtr> consistent_rowsets;
+    res = _capture_consistent_rowsets(tablet, &consistent_rowsets);
+    if (res != OLAP_SUCCESS) {
+        return res;
+    }
+
+    // generate schema hash path where files will be migrated
+    auto stores = StorageEngine::instance()->get_stores_for_create_tablet(storage_medium);
+    if (stores.empty()) {
+        LOG(WARNING) << "fail to get root path for create tablet.";
+        return OLAP_ERR_INVALID_ROOT_PATH;
+    }
+
+    uint64_t shard = 0;
+    res = stores[0]->get_shard(&shard);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to get root path shard. res=" << res;
+        return res;
+    }
+
+    stringstream root_path_stream;
+    root_path_stream << stores[0]->path() << DATA_PREFIX << "/" << shard;
+    string schema_hash_path = SnapshotManager::instance()->get_schema_hash_full_path(tablet, root_path_stream.str());
+    // if dir already exist then return err, it should not happen
+    // should not remove the dir directly
+    if (check_dir_existed(schema_hash_path)) {
+        LOG(INFO) << "schema hash path already exist, skip this path. "
+                  << "schema_hash_path=" << schema_hash_path;
+        return OLAP_ERR_FILE_ALREADY_EXIST;
+    }
+
+    TabletMetaSharedPtr new_tablet_meta(new(std::nothrow) TabletMeta());
+    res = TabletMetaManager::get_meta(stores[0], tablet->tablet_id(), tablet->schema_hash(), new_tablet_meta);
+    if (res != OLAP_ERR_META_KEY_NOT_FOUND) {
+        LOG(WARNING) << "tablet_meta already exists. "
+                     << "data_dir:" << stores[0]->path()
+                     << "tablet:" << tablet->full_name();
+        return OLAP_ERR_META_ALREADY_EXIST;
+    }
+    create_dirs(schema_hash_path);
+
+    // migrate all index and data files but header file
+    std::set<RowsetId> copied_rowset_ids;
+    res = _copy_index_and_data_files(schema_hash_path, stores[0], consistent_rowsets,
+                                     &copied_rowset_ids);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to copy index and data files when migrate. res=" << res;
+        return res;
+    }
+
     WriteLock migration_wlock(tablet->get_migration_lock_ptr(), TRY_LOCK);
     if (!migration_wlock.own_lock()) {
+        remove_all_dir(schema_hash_path);
         return OLAP_ERR_RWLOCK_ERROR;
     }
 
@@ -81,6 +137,7 @@ OLAPStatus EngineStorageMigrationTask::_storage_medium_migrate(
     if (transaction_ids.size() > 0) {
         LOG(WARNING) << "could not migration because has unfinished txns, "
                      << " tablet=" << tablet->full_name();
+        remove_all_dir(schema_hash_path);
         return OLAP_ERR_HEADER_HAS_PENDING_DATA;
     }
 
@@ -88,72 +145,20 @@ OLAPStatus EngineStorageMigrationTask::_storage_medium_migrate(
 
     // TODO(ygl): the tablet should not under schema change or rollup or load
     do {
-        // get all versions to be migrate
-        tablet->obtain_header_rdlock();
-        const RowsetSharedPtr lastest_version = tablet->rowset_with_max_version();
-        if (lastest_version == nullptr) {
-            tablet->release_header_lock();
-            res = OLAP_ERR_VERSION_NOT_EXIST;
-            LOG(WARNING) << "tablet has not any version.";
-            break;
-        }
-
-        int32_t end_version = lastest_version->end_version();
-        vector<RowsetSharedPtr> consistent_rowsets;
-        res = tablet->capture_consistent_rowsets(Version(0, end_version), &consistent_rowsets);
-        if (consistent_rowsets.empty()) {
-            tablet->release_header_lock();
-            res = OLAP_ERR_VERSION_NOT_EXIST;
-            LOG(WARNING) << "fail to capture consistent rowsets. tablet=" << tablet->full_name()
-                         << ", version=" << end_version;
-            break;
-        }
-        tablet->release_header_lock();
-
-        // generate schema hash path where files will be migrated
-        auto stores = StorageEngine::instance()->get_stores_for_create_tablet(storage_medium);
-        if (stores.empty()) {
-            res = OLAP_ERR_INVALID_ROOT_PATH;
-            LOG(WARNING) << "fail to get root path for create tablet.";
-            break;
-        }
-
-        uint64_t shard = 0;
-        res = stores[0]->get_shard(&shard);
+        // only rowsets added by loads and compactions during the copy above
+        // are copied while loads are blocked
+        res = _capture_consistent_rowsets(tablet, &consistent_rowsets);
         if (res != OLAP_SUCCESS) {
-            LOG(WARNING) << "fail to get root path shard. res=" << res;
-            break;
-        }
-
-        stringstream root_path_stream;
-        root_path_stream << stores[0]->path() << DATA_PREFIX << "/" << shard;
-        string schema_hash_path = SnapshotManager::instance()->get_schema_hash_full_path(tablet, root_path_stream.str());
-        // if dir already exist then return err, it should not happen
-        // should not remove the dir directly
-        if (check_dir_existed(schema_hash_path)) {
-            LOG(INFO) << "schema hash path already exist, skip this path. "
-                      << "schema_hash_path=" << schema_hash_path;
-            res = OLAP_ERR_FILE_ALREADY_EXIST;
+            remove_all_dir(schema_hash_path);
             break;
         }
-
-        TabletMetaSharedPtr new_tablet_meta(new(std::nothrow) TabletMeta());
-        res = TabletMetaManager::get_meta(stores[0], tablet->tablet_id(), tablet->schema_hash(), new_tablet_meta);
-        if (res != OLAP_ERR_META_KEY_NOT_FOUND) {
-            LOG(WARNING) << "tablet_meta already exists. "
-                         << "data_dir:" << stores[0]->path()
-                         << "tablet:" << tablet->full_name();
-            res = OLAP_ERR_META_ALREADY_EXIST;
-            break;
-        }
-        create_dirs(schema_hash_path);
-
-        // migrate all index and data files but header file
-        res = _copy_index_and_data_files(schema_hash_path, tablet, consistent_rowsets);
+        res = _copy_index_and_data_files(schema_hash_path, stores[0], consistent_rowsets,
+                                         &copied_rowset_ids);
         if (res != OLAP_SUCCESS) {
             LOG(WARNING) << "fail to copy index and data files when migrate. res=" << res;
             break;
         }
+        _remove_stale_files(schema_hash_path, consistent_rowsets, copied_rowset_ids);
 
         res = _generate_new_header(stores[0], shard, tablet, consistent_rowsets, new_tablet_meta);
         if (res != OLAP_SUCCESS) {
@@ -215,6 +220,28 @@ OLAPStatus EngineStorageMigrationTask::_storage_medium_migrate(
     return res;
 }
 
+OLAPStatus EngineStorageMigrationTask::_capture_consistent_rowsets(
+        const TabletSharedPtr& tablet,
+        std::vector<RowsetSharedPtr>* consistent_rowsets) {
+    consistent_rowsets->clear();
+    // get all versions to be migrate
+    ReadLock rdlock(tablet->get_header_lock_ptr());
+    const RowsetSharedPtr lastest_version = tablet->rowset_with_max_version();
+    if (lastest_version == nullptr) {
+        LOG(WARNING) << "tablet has not any version.";
+        return OLAP_ERR_VERSION_NOT_EXIST;
+    }
+
+    int32_t end_version = lastest_version->end_version();
+    tablet->capture_consistent_rowsets(Version(0, end_version), consistent_rowsets);
+    if (consistent_rowsets->empty()) {
+        LOG(WARNING) << "fail to capture consistent rowsets. tablet=" << tablet->full_name()
+                     << ", version=" << end_version;
+        return OLAP_ERR_VERSION_NOT_EXIST;
+    }
+    return OLAP_SUCCESS;
+}
+
 // TODO(ygl): lost some infomation here, such as cumulative layer point
 OLAPStatus EngineStorageMigrationTask::_generate_new_header(
         DataDir* store, const uint64_t new_shard,
@@ -248,10 +275,17 @@ OLAPStatus EngineStorageMigrationTask::_generate_new_header(
 
 OLAPStatus EngineStorageMigrationTask::_copy_index_and_data_files(
         const string& schema_hash_path,
-        const TabletSharedPtr& ref_tablet,
-        std::vector<RowsetSharedPtr>& consistent_rowsets) {
+        DataDir* dest_store,
+        const std::vector<RowsetSharedPtr>& consistent_rowsets,
+        std::set<RowsetId>* copied_rowset_ids) {
     OLAPStatus status = OLAP_SUCCESS;
     for (auto& rs : consistent_rowsets) {
+        if (copied_rowset_ids->count(rs->rowset_id()) > 0) {
+            continue;
+        }
+        // limit write rate on destination data dir, so that migration yields
+        // the disk to loads and queries
+        dest_store->io_scheduler()->acquire(IOClass::MIGRATION, rs->data_disk_size());
         status = rs->copy_files_to(schema_hash_path);
         if (status != OLAP_SUCCESS) {
             if (remove_all_dir(schema_hash_path) != OLAP_SUCCESS) {
@@ -260,8 +294,41 @@ OLAPStatus EngineStorageMigrationTask::_copy_index_and_data_files(
             }
             break;
         }
+        copied_rowset_ids->insert(rs->rowset_id());
     }
     return status;
 }
 
+void EngineStorageMigrationTask::_remove_stale_files(
+        const string& schema_hash_path,
+        const std::vector<RowsetSharedPtr>& consistent_rowsets,
+        const std::set<RowsetId>& copied_rowset_ids) {
+    std::set<RowsetId> stale_rowset_ids = copied_rowset_ids;
+    for (auto& rs : consistent_rowsets) {
+        stale_rowset_ids.erase(rs->rowset_id());
+    }
+    if (stale_rowset_ids.empty()) {
+        return;
+    }
+
+    std::set<std::string> files;
+    if (dir_walk(schema_hash_path, nullptr, &files) != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to walk dir. [path=" << schema_hash_path << "]";
+        return;
+    }
+    // files of rowsets merged by compaction during the copy are not in the
+    // new tablet meta
+    for (RowsetId rowset_id : stale_rowset_ids) {
+        std::string file_prefix = std::to_string(rowset_id) + "_";
+        for (const auto& file : files) {
+            if (file.compare(0, file_prefix.size(), file_prefix) == 0) {
+                std::string file_path = schema_hash_path + "/" + file;
+                if (remove(file_path.c_str()) != 0) {
+                    LOG(WARNING) << "fail to remove stale file when migrate. file=" << file_path;
+                }
+            }
+        }
+    }
+}
+
 } // doris
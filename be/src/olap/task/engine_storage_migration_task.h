@@ -18,6 +18,8 @@
 #ifndef DORIS_BE_SRC_OLAP_TASK_ENGINE_STORAGE_MIGRATION_TASK_H
 #define DORIS_BE_SRC_OLAP_TASK_ENGINE_STORAGE_MIGRATION_TASK_H
 
+#include <set>
+
 #include "gen_cpp/AgentService_types.h"
 #include "olap/olap_define.h"
 #include "olap/task/engine_task.h"
@@ -45,12 +47,20 @@ private:
                                     const std::vector<RowsetSharedPtr>& consistent_rowsets,
                                     TabletMetaSharedPtr new_tablet_meta);
     
-    // TODO: hkp
-    // rewrite this function
+    OLAPStatus _capture_consistent_rowsets(const TabletSharedPtr& tablet,
+                                           std::vector<RowsetSharedPtr>* consistent_rowsets);
+
+    // copy files of rowsets not in copied_rowset_ids, and add their ids
     OLAPStatus _copy_index_and_data_files(
             const std::string& header_path,
-            const TabletSharedPtr& ref_tablet,
-            std::vector<RowsetSharedPtr>& consistent_rowsets);
+            DataDir* dest_store,
+            const std::vector<RowsetSharedPtr>& consistent_rowsets,
+            std::set<RowsetId>* copied_rowset_ids);
+
+    // remove copied files of rowsets which are not consistent rowsets any more
+    void _remove_stale_files(const std::string& header_path,
+                             const std::vector<RowsetSharedPtr>& consistent_rowsets,
+                             const std::set<RowsetId>& copied_rowset_ids);
 
 private:
     const TStorageMediumMigrateReq& _storage_medium_migrate_req;
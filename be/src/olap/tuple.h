@@ -59,6 +59,10 @@ public:
         _values.clear();
         _nulls.clear();
     }
+
+    bool operator==(const OlapTuple& other) const {
+        return _values == other._values && _nulls == other._nulls;
+    }
 private:
     friend std::ostream& operator<<(std::ostream& os, const OlapTuple& tuple);
 
@@ -70,12 +70,42 @@ using std::vector;
 
 namespace doris {
 
-TxnManager::TxnManager() {
+TxnManager::TxnManager()
+        : _txn_map_shards(config::txn_map_shard_size),
+          _txn_map_shard_mask(config::txn_map_shard_size - 1) {
+    CHECK_GT(config::txn_map_shard_size, 0);
+    CHECK_EQ(config::txn_map_shard_size & _txn_map_shard_mask, 0)
+        << "txn_map_shard_size should be power of 2";
     for (int i = 0; i < _txn_lock_num; ++i) {
         _txn_locks[i] = std::make_shared<RWMutex>();
     }
 }
 
+void TxnManager::_insert_txn_unlocked(TxnMapShard* shard, const TxnKey& key,
+                                      const TabletInfo& tablet_info,
+                                      const TabletTxnInfo& load_info) {
+    shard->txn_tablet_map[key][tablet_info] = load_info;
+    shard->tablet_txn_map[tablet_info].insert(key);
+}
+
+void TxnManager::_erase_txn_unlocked(TxnMapShard* shard, const TxnKey& key,
+                                     const TabletInfo& tablet_info) {
+    auto it = shard->txn_tablet_map.find(key);
+    if (it != shard->txn_tablet_map.end()) {
+        it->second.erase(tablet_info);
+        if (it->second.empty()) {
+            shard->txn_tablet_map.erase(it);
+        }
+    }
+    auto tablet_it = shard->tablet_txn_map.find(tablet_info);
+    if (tablet_it != shard->tablet_txn_map.end()) {
+        tablet_it->second.erase(key);
+        if (tablet_it->second.empty()) {
+            shard->tablet_txn_map.erase(tablet_it);
+        }
+    }
+}
+
 // prepare txn should always be allowed because ingest task will be retried 
 // could not distinguish rollup, schema change or base table, prepare txn successfully will allow
 // ingest retried
@@ -86,10 +116,11 @@ OLAPStatus TxnManager::prepare_txn(
 
     pair<int64_t, int64_t> key(partition_id, transaction_id);
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
+    TxnMapShard& shard = _get_txn_map_shard(transaction_id);
     WriteLock wrlock(_get_txn_lock(transaction_id));
-    WriteLock txn_wrlock(&_txn_map_lock);
-    auto it = _txn_tablet_map.find(key);
-    if (it != _txn_tablet_map.end()) {
+    WriteLock txn_wrlock(&shard.lock);
+    auto it = shard.txn_tablet_map.find(key);
+    if (it != shard.txn_tablet_map.end()) {
         auto load_itr = it->second.find(tablet_info);
         if (load_itr != it->second.end()) {
             // found load for txn,tablet
@@ -111,7 +142,7 @@ OLAPStatus TxnManager::prepare_txn(
     // case 1: user start a new txn, rowset_ptr = null
     // case 2: loading txn from meta env
     TabletTxnInfo load_info(load_id, nullptr);
-    _txn_tablet_map[key][tablet_info] = load_info;
+    _insert_txn_unlocked(&shard, key, tablet_info, load_info);
     LOG(INFO) << "add transaction to engine successfully."
             << "partition_id: " << key.first
             << ", transaction_id: " << key.second
@@ -138,12 +169,13 @@ OLAPStatus TxnManager::commit_txn(
                      << ", tablet: " << tablet_info.to_string();
         return OLAP_ERR_ROWSET_INVALID;
     }
+    TxnMapShard& shard = _get_txn_map_shard(transaction_id);
     WriteLock wrlock(_get_txn_lock(transaction_id));
     {
         // get tx
-        ReadLock rdlock(&_txn_map_lock);
-        auto it = _txn_tablet_map.find(key);
-        if (it != _txn_tablet_map.end()) {
+        ReadLock rdlock(&shard.lock);
+        auto it = shard.txn_tablet_map.find(key);
+        if (it != shard.txn_tablet_map.end()) {
             auto load_itr = it->second.find(tablet_info);
             if (load_itr != it->second.end()) {
                 // found load for txn,tablet
@@ -194,9 +226,9 @@ OLAPStatus TxnManager::commit_txn(
     }
 
     {
-        WriteLock wrlock(&_txn_map_lock);
+        WriteLock wrlock(&shard.lock);
         TabletTxnInfo load_info(load_id, rowset_ptr);
-        _txn_tablet_map[key][tablet_info] = load_info;
+        _insert_txn_unlocked(&shard, key, tablet_info, load_info);
         LOG(INFO) << "commit transaction to engine successfully."
                 << " partition_id: " << key.first
                 << ", transaction_id: " << key.second
@@ -213,11 +245,12 @@ OLAPStatus TxnManager::publish_txn(OlapMeta* meta, TPartitionId partition_id, TT
     pair<int64_t, int64_t> key(partition_id, transaction_id);
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
     RowsetSharedPtr rowset_ptr = nullptr;
+    TxnMapShard& shard = _get_txn_map_shard(transaction_id);
     WriteLock wrlock(_get_txn_lock(transaction_id));
     {
-        ReadLock rlock(&_txn_map_lock);
-        auto it = _txn_tablet_map.find(key);
-        if (it != _txn_tablet_map.end()) {
+        ReadLock rlock(&shard.lock);
+        auto it = shard.txn_tablet_map.find(key);
+        if (it != shard.txn_tablet_map.end()) {
             auto load_itr = it->second.find(tablet_info);
             if (load_itr != it->second.end()) {
                 // found load for txn,tablet
@@ -247,19 +280,13 @@ OLAPStatus TxnManager::publish_txn(OlapMeta* meta, TPartitionId partition_id, TT
         return OLAP_ERR_TRANSACTION_NOT_EXIST;
     }
     {
-        WriteLock wrlock(&_txn_map_lock);
-        auto it = _txn_tablet_map.find(key);
-        if (it != _txn_tablet_map.end()) {
-            it->second.erase(tablet_info);
-            LOG(INFO) << "publish txn successfully."
-                      << " partition_id: " << key.first
-                      << ", txn_id: " << key.second
-                      << ", tablet: " << tablet_info.to_string()
-                      << ", rowsetid: " << rowset_ptr->rowset_id();
-            if (it->second.empty()) {
-                _txn_tablet_map.erase(it);
-            }
-        }
+        WriteLock wrlock(&shard.lock);
+        _erase_txn_unlocked(&shard, key, tablet_info);
+        LOG(INFO) << "publish txn successfully."
+                  << " partition_id: " << key.first
+                  << ", txn_id: " << key.second
+                  << ", tablet: " << tablet_info.to_string()
+                  << ", rowsetid: " << rowset_ptr->rowset_id();
         return OLAP_SUCCESS;
     }
 }
@@ -272,10 +299,11 @@ OLAPStatus TxnManager::rollback_txn(TPartitionId partition_id, TTransactionId tr
                                     TTabletId tablet_id, SchemaHash schema_hash, TabletUid tablet_uid) {
     pair<int64_t, int64_t> key(partition_id, transaction_id);
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
+    TxnMapShard& shard = _get_txn_map_shard(transaction_id);
     WriteLock wrlock(_get_txn_lock(transaction_id));
-    WriteLock txn_wrlock(&_txn_map_lock);
-    auto it = _txn_tablet_map.find(key);
-    if (it != _txn_tablet_map.end()) {
+    WriteLock txn_wrlock(&shard.lock);
+    auto it = shard.txn_tablet_map.find(key);
+    if (it != shard.txn_tablet_map.end()) {
         auto load_itr = it->second.find(tablet_info);
         if (load_itr != it->second.end()) {
             // found load for txn,tablet
@@ -287,14 +315,11 @@ OLAPStatus TxnManager::rollback_txn(TPartitionId partition_id, TTransactionId tr
                 return OLAP_ERR_TRANSACTION_ALREADY_COMMITTED;
             }
         }
-        it->second.erase(tablet_info);
+        _erase_txn_unlocked(&shard, key, tablet_info);
         LOG(INFO) << "rollback transaction from engine successfully."
                   << " partition_id: " << key.first
                   << ", transaction_id: " << key.second
                   << ", tablet: " << tablet_info.to_string();
-        if (it->second.empty()) {
-            _txn_tablet_map.erase(it);
-        }
         return OLAP_SUCCESS;
     }
     return OLAP_SUCCESS;
@@ -306,10 +331,11 @@ OLAPStatus TxnManager::delete_txn(OlapMeta* meta, TPartitionId partition_id, TTr
                                   TTabletId tablet_id, SchemaHash schema_hash, TabletUid tablet_uid) {
     pair<int64_t, int64_t> key(partition_id, transaction_id);
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
+    TxnMapShard& shard = _get_txn_map_shard(transaction_id);
     WriteLock wrlock(_get_txn_lock(transaction_id));
-    WriteLock txn_wrlock(&_txn_map_lock);
-    auto it = _txn_tablet_map.find(key);
-    if (it == _txn_tablet_map.end()) {
+    WriteLock txn_wrlock(&shard.lock);
+    auto it = shard.txn_tablet_map.find(key);
+    if (it == shard.txn_tablet_map.end()) {
         return OLAP_ERR_TRANSACTION_NOT_EXIST;
     }
     auto load_itr = it->second.find(tablet_info);
@@ -341,10 +367,7 @@ OLAPStatus TxnManager::delete_txn(OlapMeta* meta, TPartitionId partition_id, TTr
             }
         }
     }
-    it->second.erase(tablet_info);
-    if (it->second.empty()) {
-        _txn_tablet_map.erase(it);
-    }
+    _erase_txn_unlocked(&shard, key, tablet_info);
     return OLAP_SUCCESS;
 }
 
@@ -356,14 +379,18 @@ void TxnManager::get_tablet_related_txns(TTabletId tablet_id, SchemaHash schema_
     }
 
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
-    ReadLock txn_rdlock(&_txn_map_lock);
-    for (auto& it : _txn_tablet_map) {
-        if (it.second.find(tablet_info) != it.second.end()) {
-            *partition_id = it.first.first;
-            transaction_ids->insert(it.first.second);
+    for (auto& shard : _txn_map_shards) {
+        ReadLock txn_rdlock(&shard.lock);
+        auto tablet_it = shard.tablet_txn_map.find(tablet_info);
+        if (tablet_it == shard.tablet_txn_map.end()) {
+            continue;
+        }
+        for (const TxnKey& key : tablet_it->second) {
+            *partition_id = key.first;
+            transaction_ids->insert(key.second);
             VLOG(3) << "find transaction on tablet."
-                    << "partition_id: " << it.first.first
-                    << ", transaction_id: " << it.first.second
+                    << "partition_id: " << key.first
+                    << ", transaction_id: " << key.second
                     << ", tablet: " << tablet_info.to_string();
         }
     }
@@ -373,11 +400,16 @@ void TxnManager::get_tablet_related_txns(TTabletId tablet_id, SchemaHash schema_
 // maybe lock error, because not get txn lock before remove from meta
 void TxnManager::force_rollback_tablet_related_txns(OlapMeta* meta, TTabletId tablet_id, SchemaHash schema_hash, TabletUid tablet_uid) {
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
-    WriteLock txn_wrlock(&_txn_map_lock);
-    for (auto& it : _txn_tablet_map) {
-        auto load_itr = it.second.find(tablet_info);
-        if (load_itr != it.second.end()) {
-            TabletTxnInfo& load_info = load_itr->second;
+    for (auto& shard : _txn_map_shards) {
+        WriteLock txn_wrlock(&shard.lock);
+        auto tablet_it = shard.tablet_txn_map.find(tablet_info);
+        if (tablet_it == shard.tablet_txn_map.end()) {
+            continue;
+        }
+        // copy keys, because the index is changed when erasing txns
+        std::set<TxnKey> keys = tablet_it->second;
+        for (const TxnKey& key : keys) {
+            TabletTxnInfo& load_info = shard.txn_tablet_map.at(key).at(tablet_info);
             if (load_info.rowset != nullptr && meta != nullptr) {
                 LOG(INFO) << " delete transaction from engine "
                           << ", tablet: " << tablet_info.to_string()
@@ -385,14 +417,11 @@ void TxnManager::force_rollback_tablet_related_txns(OlapMeta* meta, TTabletId ta
                 RowsetMetaManager::remove(meta, tablet_uid, load_info.rowset->rowset_id());
             }
             LOG(INFO) << "remove tablet related txn."
-                      << " partition_id: " << it.first.first
-                      << ", transaction_id: " << it.first.second
+                      << " partition_id: " << key.first
+                      << ", transaction_id: " << key.second
                       << ", tablet: " << tablet_info.to_string()
                       << ", rowset: " << (load_info.rowset != nullptr ?  load_info.rowset->rowset_id(): 0);
-            it.second.erase(tablet_info);
-        }
-        if (it.second.empty()) {
-            _txn_tablet_map.erase(it.first);
+            _erase_txn_unlocked(&shard, key, tablet_info);
         }
     }
 }
@@ -402,10 +431,11 @@ void TxnManager::get_txn_related_tablets(const TTransactionId transaction_id,
                                          std::map<TabletInfo, RowsetSharedPtr>* tablet_infos) {
     // get tablets in this transaction
     pair<int64_t, int64_t> key(partition_id, transaction_id);
+    TxnMapShard& shard = _get_txn_map_shard(transaction_id);
     ReadLock rdlock(_get_txn_lock(transaction_id));
-    ReadLock txn_rdlock(&_txn_map_lock);
-    auto it = _txn_tablet_map.find(key);
-    if (it == _txn_tablet_map.end()) {
+    ReadLock txn_rdlock(&shard.lock);
+    auto it = shard.txn_tablet_map.find(key);
+    if (it == shard.txn_tablet_map.end()) {
         LOG(WARNING) << "could not find tablet for"
                      << " partition_id=" << partition_id 
                      << ", transaction_id=" << transaction_id;
@@ -423,10 +453,10 @@ void TxnManager::get_txn_related_tablets(const TTransactionId transaction_id,
 }
 
 void TxnManager::get_all_related_tablets(std::set<TabletInfo>* tablet_infos) {
-    ReadLock txn_rdlock(&_txn_map_lock);
-    for (auto& it : _txn_tablet_map) {
-        for (auto& tablet_load_it : it.second) {
-            tablet_infos->emplace(tablet_load_it.first);
+    for (auto& shard : _txn_map_shards) {
+        ReadLock txn_rdlock(&shard.lock);
+        for (auto& it : shard.tablet_txn_map) {
+            tablet_infos->emplace(it.first);
         }
     }
 }                                
@@ -435,10 +465,11 @@ bool TxnManager::has_txn(TPartitionId partition_id, TTransactionId transaction_i
                          TTabletId tablet_id, SchemaHash schema_hash, TabletUid tablet_uid) {
     pair<int64_t, int64_t> key(partition_id, transaction_id);
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
+    TxnMapShard& shard = _get_txn_map_shard(transaction_id);
     ReadLock rdlock(_get_txn_lock(transaction_id));
-    ReadLock txn_rdlock(&_txn_map_lock);
-    auto it = _txn_tablet_map.find(key);
-    bool found = it != _txn_tablet_map.end()
+    ReadLock txn_rdlock(&shard.lock);
+    auto it = shard.txn_tablet_map.find(key);
+    bool found = it != shard.txn_tablet_map.end()
                  && it->second.find(tablet_info) != it->second.end();
 
     return found;
@@ -452,18 +483,22 @@ bool TxnManager::get_expire_txns(TTabletId tablet_id, SchemaHash schema_hash, Ta
     }
     time_t now = time(nullptr);
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
-    ReadLock txn_rdlock(&_txn_map_lock);
-    for (auto& it : _txn_tablet_map) {
-        auto txn_info = it.second.find(tablet_info);
-        if (txn_info != it.second.end()) {
-            double diff = difftime(now, txn_info->second.creation_time);
+    for (auto& shard : _txn_map_shards) {
+        ReadLock txn_rdlock(&shard.lock);
+        auto tablet_it = shard.tablet_txn_map.find(tablet_info);
+        if (tablet_it == shard.tablet_txn_map.end()) {
+            continue;
+        }
+        for (const TxnKey& key : tablet_it->second) {
+            const TabletTxnInfo& txn_info = shard.txn_tablet_map.at(key).at(tablet_info);
+            double diff = difftime(now, txn_info.creation_time);
             if (diff >= config::pending_data_expire_time_sec) {
-                transaction_ids->push_back(it.first.second);
+                transaction_ids->push_back(key.second);
                 LOG(INFO) << "find expire pending data. " 
                         << " tablet_id=" << tablet_id
                         << " schema_hash=" << schema_hash 
                         << " tablet_uid=" << tablet_uid.to_string()
-                        << " transaction_id=" << it.first.second 
+                        << " transaction_id=" << key.second 
                         << " exist_sec=" << diff;
             }
         }
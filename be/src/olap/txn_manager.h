@@ -69,7 +69,7 @@ public:
     TxnManager();
 
     ~TxnManager() {
-        _txn_tablet_map.clear();
+        _txn_map_shards.clear();
         _txn_locks.clear();
     }
     // add a txn to manager
@@ -117,14 +117,40 @@ public:
     void force_rollback_tablet_related_txns(OlapMeta* meta, TTabletId tablet_id, SchemaHash schema_hash, TabletUid tablet_uid);
     
 private:
+    using TxnKey = std::pair<int64_t, int64_t>; // partition_id, transaction_id;
+    typedef std::map<TxnKey, std::map<TabletInfo, TabletTxnInfo>> txn_tablet_map_t;
+    typedef std::map<TabletInfo, std::set<TxnKey>> tablet_txn_map_t;
+
+    // Txns are sharded by transaction id, each shard has its own lock, so
+    // that operations on different txns don't contend with each other.
+    struct TxnMapShard {
+        RWMutex lock;
+        txn_tablet_map_t txn_tablet_map;
+        // index from tablet to its txns in this shard, so that getting txns
+        // of a tablet doesn't scan txns of other tablets
+        tablet_txn_map_t tablet_txn_map;
+    };
+
     RWMutex* _get_txn_lock(TTransactionId txn_id) {
         return _txn_locks[txn_id % _txn_lock_num].get();
     }
 
+    TxnMapShard& _get_txn_map_shard(TTransactionId txn_id) {
+        return _txn_map_shards[txn_id & _txn_map_shard_mask];
+    }
+
+    // Add or replace load info of tablet in txn, and update the index of
+    // tablet. Caller should hold write lock of shard.
+    void _insert_txn_unlocked(TxnMapShard* shard, const TxnKey& key,
+                              const TabletInfo& tablet_info, const TabletTxnInfo& load_info);
+
+    // Remove tablet from txn, txn is removed too if it has no tablet any more.
+    // Caller should hold write lock of shard.
+    void _erase_txn_unlocked(TxnMapShard* shard, const TxnKey& key, const TabletInfo& tablet_info);
+
 private:
-    RWMutex _txn_map_lock;
-    using TxnKey = std::pair<int64_t, int64_t>; // partition_id, transaction_id;
-    std::map<TxnKey, std::map<TabletInfo, TabletTxnInfo>> _txn_tablet_map;
+    std::vector<TxnMapShard> _txn_map_shards;
+    int64_t _txn_map_shard_mask;
 
     const int32_t _txn_lock_num = 100;
     std::map<int32_t, std::shared_ptr<RWMutex>> _txn_locks;
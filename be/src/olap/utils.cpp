@@ -42,6 +42,7 @@
 #include "olap/new_status.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
+#include "util/time.h"
 
 using std::string;
 using std::set;
@@ -1026,6 +1027,27 @@ OLAPStatus move_to_trash(const boost::filesystem::path& schema_hash_root,
     return OLAP_SUCCESS;
 }
 
+bool LockWaitStats::_s_enabled = false;
+__thread LockWaitStats LockWaitStats::_s_current;
+
+// Lock by 'lock_fn' and count the wait if LockWaitStats is enabled and the
+// lock can't be obtained by 'try_lock_fn' at once
+template<typename TryLockFn, typename LockFn>
+static void lock_with_wait_stats(TryLockFn try_lock_fn, LockFn lock_fn) {
+    if (!LockWaitStats::enabled()) {
+        lock_fn();
+        return;
+    }
+    if (try_lock_fn() == 0) {
+        return;
+    }
+    int64_t start = MonotonicNanos();
+    lock_fn();
+    LockWaitStats* stats = LockWaitStats::current();
+    stats->wait_count++;
+    stats->wait_ns += MonotonicNanos() - start;
+}
+
 Mutex::Mutex() {
     PTHREAD_MUTEX_INIT_WITH_LOG(&_lock, NULL);
 }
@@ -1035,7 +1057,8 @@ Mutex::~Mutex() {
 }
 
 OLAPStatus Mutex::lock() {
-    PTHREAD_MUTEX_LOCK_WITH_LOG(&_lock);
+    lock_with_wait_stats([this] { return pthread_mutex_trylock(&_lock); },
+                         [this] { PTHREAD_MUTEX_LOCK_WITH_LOG(&_lock); });
     return OLAP_SUCCESS;
 }
 
@@ -1084,7 +1107,8 @@ RWMutex::~RWMutex() {
 }
 
 OLAPStatus RWMutex::rdlock() {
-    PTHREAD_RWLOCK_RDLOCK_WITH_LOG(&_lock);
+    lock_with_wait_stats([this] { return pthread_rwlock_tryrdlock(&_lock); },
+                         [this] { PTHREAD_RWLOCK_RDLOCK_WITH_LOG(&_lock); });
     return OLAP_SUCCESS;
 }
 
@@ -1107,7 +1131,8 @@ OLAPStatus RWMutex::trywrlock() {
 }
 
 OLAPStatus RWMutex::wrlock() {
-    PTHREAD_RWLOCK_WRLOCK_WITH_LOG(&_lock);
+    lock_with_wait_stats([this] { return pthread_rwlock_trywrlock(&_lock); },
+                         [this] { PTHREAD_RWLOCK_WRLOCK_WITH_LOG(&_lock); });
     return OLAP_SUCCESS;
 }
 
@@ -163,6 +163,24 @@ OLAPStatus gen_timestamp_string(std::string* out_string);
 OLAPStatus move_to_trash(const boost::filesystem::path& schema_hash_root,
                          const boost::filesystem::path& file_path);
 
+// Number and time of the waits of the current thread for Mutex and RWMutex
+// held by other threads. Waits are only counted when enabled, and a lock is
+// tried first then, so that uncontended locks are not timed. It's used by
+// benchmarks to measure lock contention, and should be enabled before
+// starting the threads.
+struct LockWaitStats {
+    int64_t wait_count;
+    int64_t wait_ns;
+
+    static void set_enabled(bool enabled) { _s_enabled = enabled; }
+    static bool enabled() { return _s_enabled; }
+    static LockWaitStats* current() { return &_s_current; }
+
+private:
+    static bool _s_enabled;
+    static __thread LockWaitStats _s_current;
+};
+
 // encapsulation of pthread_mutex to lock the critical sources.
 class Mutex {
 public:
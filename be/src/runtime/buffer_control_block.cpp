@@ -47,7 +47,13 @@ void GetResultBatchCtx::on_close(int64_t packet_seq,
 void GetResultBatchCtx::on_data(TFetchDataResult* t_result, int64_t packet_seq, bool eos) {
     uint8_t* buf = nullptr;
     uint32_t len = 0;
-    ThriftSerializer ser(false, 4096);
+    // size the buffer for the whole batch up front, growing it by doubling copies
+    // large result batches several times
+    size_t buf_size = 64;
+    for (auto& row : t_result->result_batch.rows) {
+        buf_size += row.size() + 4;
+    }
+    ThriftSerializer ser(false, buf_size);
     auto st = ser.serialize(&t_result->result_batch, &len, &buf);
     if (st.ok()) {
         cntl->response_attachment().append(buf, len);
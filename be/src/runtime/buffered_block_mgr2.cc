@@ -17,12 +17,14 @@
 
 #include "runtime/buffered_block_mgr2.h"
 
+#include "common/config.h"
 #include "runtime/exec_env.h"
 #include "runtime/runtime_state.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/mem_pool.h"
 #include "runtime/tmp_file_mgr.h"
 #include "util/bit_util.h"
+#include "util/block_compression.h"
 #include "util/runtime_profile.h"
 #include "util/disk_info.h"
 #include "util/filesystem_util.h"
@@ -133,6 +135,8 @@ BufferedBlockMgr2::Block::Block(BufferedBlockMgr2* block_mgr) :
         _write_range(NULL),
         _tmp_file(NULL),
         _valid_data_len(0),
+        _compress_buffer(NULL),
+        _is_compressed(false),
         _num_rows(0) {
 }
 
@@ -208,8 +212,10 @@ string BufferedBlockMgr2::Block::debug_string() const {
 BufferedBlockMgr2::BufferedBlockMgr2(RuntimeState* state, TmpFileMgr* tmp_file_mgr,
         int64_t block_size) :
     _max_block_size(block_size),
-    // Keep two writes in flight per scratch disk so the disks can stay busy.
-    _block_write_threshold(tmp_file_mgr->num_active_tmp_devices() * 2),
+    // Keep several writes in flight per scratch disk so the disks can stay busy.
+    _block_write_threshold(tmp_file_mgr->num_active_tmp_devices()
+            * std::max(config::spill_writes_per_scratch_dir, 1)),
+    _compress_codec(NULL),
     // _disable_spill(state->query_ctx().disable_spilling),
     _disable_spill(false),
     _query_id(state->query_id()),
@@ -590,6 +596,10 @@ BufferedBlockMgr2::~BufferedBlockMgr2() {
         _mem_tracker->release(buffer->len);
         delete[] buffer->buffer;
     }
+    BOOST_FOREACH(uint8_t* buffer, _free_compress_buffers) {
+        delete[] buffer;
+    }
+    _free_compress_buffers.clear();
     DCHECK_EQ(_mem_tracker->consumption(), 0);
     _mem_tracker->unregister_from_parent();
     _mem_tracker.reset();
@@ -678,11 +688,24 @@ Status BufferedBlockMgr2::pin_block(Block* block, bool* pinned, Block* release_b
 
     // Read the block from disk if it was not in memory.
     DCHECK(block->_write_range != NULL) << block->debug_string() << endl << release_block;
+    RETURN_IF_ERROR(read_block(block));
+    return delete_or_unpin_block(release_block, unpin);
+}
+
+Status BufferedBlockMgr2::read_block(Block* block) {
     SCOPED_TIMER(_disk_read_timer);
+    int64_t read_len = block->_write_range->len();
+    uint8_t* read_buffer = block->buffer();
+    scoped_array<uint8_t> compressed;
+    if (block->_is_compressed) {
+        compressed.reset(new uint8_t[read_len]);
+        read_buffer = compressed.get();
+    }
+
     // Create a ScanRange to perform the read.
     DiskIoMgr::ScanRange* scan_range =
         _obj_pool.add(new DiskIoMgr::ScanRange());
-    scan_range->reset(NULL, block->_write_range->file(), block->_write_range->len(),
+    scan_range->reset(NULL, block->_write_range->file(), read_len,
             block->_write_range->offset(), block->_write_range->disk_id(), false, block,
             DiskIoMgr::ScanRange::NEVER_CACHE);
     vector<DiskIoMgr::ScanRange*> ranges(1, scan_range);
@@ -694,14 +717,26 @@ Status BufferedBlockMgr2::pin_block(Block* block, bool* pinned, Block* release_b
     do {
         DiskIoMgr::BufferDescriptor* io_mgr_buffer;
         RETURN_IF_ERROR(scan_range->get_next(&io_mgr_buffer));
-        memcpy(block->buffer() + offset, io_mgr_buffer->buffer(), io_mgr_buffer->len());
+        memcpy(read_buffer + offset, io_mgr_buffer->buffer(), io_mgr_buffer->len());
         offset += io_mgr_buffer->len();
         buffer_eosr = io_mgr_buffer->eosr();
         io_mgr_buffer->return_buffer();
     } while (!buffer_eosr);
-    DCHECK_EQ(offset, block->_write_range->len());
-
-    return delete_or_unpin_block(release_block, unpin);
+    DCHECK_EQ(offset, read_len);
+
+    if (block->_is_compressed) {
+        SCOPED_TIMER(_compression_timer);
+        Slice output(block->buffer(), block->buffer_len());
+        RETURN_IF_ERROR(_compress_codec->decompress(Slice(read_buffer, read_len), &output));
+        if (output.size != block->_valid_data_len) {
+            std::stringstream error_msg;
+            error_msg << "spilled block decompressed to " << output.size
+                << " bytes, expected " << block->_valid_data_len << ". path: "
+                << block->tmp_file_path();
+            return Status::InternalError(error_msg.str());
+        }
+    }
+    return Status::OK();
 }
 
 Status BufferedBlockMgr2::unpin_block(Block* block) {
@@ -782,17 +817,34 @@ Status BufferedBlockMgr2::write_unpinned_block(Block* block) {
         block->_tmp_file = tmp_file;
     }
 
-    uint8_t* outbuf = NULL;
-    outbuf = block->buffer();
+    DCHECK(block->_compress_buffer == NULL);
+    uint8_t* outbuf = block->buffer();
+    int64_t outlen = block->_valid_data_len;
+    block->_is_compressed = _compress_codec != NULL && compress_block(block, &outlen);
+    if (block->_is_compressed) {
+        outbuf = block->_compress_buffer;
+    }
 
-    block->_write_range->set_data(outbuf, block->_valid_data_len);
+    block->_write_range->set_data(outbuf, outlen);
 
     // Issue write through DiskIoMgr.
-    RETURN_IF_ERROR(_io_mgr->add_write_range(_io_request_context, block->_write_range));
+    Status status = _io_mgr->add_write_range(_io_request_context, block->_write_range);
+    if (!status.ok()) {
+        if (block->_compress_buffer != NULL) {
+            _free_compress_buffers.push_back(block->_compress_buffer);
+            block->_compress_buffer = NULL;
+        }
+        return status;
+    }
     block->_in_write = true;
     DCHECK(block->validate()) << endl << block->debug_string();
     _outstanding_writes_counter->update(1);
-    _bytes_written_counter->update(block->_valid_data_len);
+    _bytes_written_counter->update(outlen);
+    // the block mgr is shared by the fragment instances of a query, account the
+    // spilled bytes to the instance of the client
+    if (block->_client->_state != NULL) {
+        block->_client->_state->update_spill_bytes(outlen);
+    }
     ++_writes_issued;
     if (_writes_issued == 1) {
 #if 0
@@ -804,6 +856,31 @@ Status BufferedBlockMgr2::write_unpinned_block(Block* block) {
     return Status::OK();
 }
 
+bool BufferedBlockMgr2::compress_block(Block* block, int64_t* compressed_len) {
+    // Assumes block manager lock is already taken.
+    SCOPED_TIMER(_compression_timer);
+    size_t buffer_len = _compress_codec->max_compressed_len(_max_block_size);
+    uint8_t* compress_buffer = NULL;
+    if (_free_compress_buffers.empty()) {
+        compress_buffer = new uint8_t[buffer_len];
+    } else {
+        compress_buffer = _free_compress_buffers.back();
+        _free_compress_buffers.pop_back();
+    }
+    Slice output(compress_buffer, buffer_len);
+    Status status = _compress_codec->compress(
+            Slice(block->buffer(), block->_valid_data_len), &output);
+    if (!status.ok() || output.size >= block->_valid_data_len) {
+        LOG_IF(WARNING, !status.ok()) << "Failed to compress spilled block, write it raw: "
+            << status.get_error_msg();
+        _free_compress_buffers.push_back(compress_buffer);
+        return false;
+    }
+    block->_compress_buffer = compress_buffer;
+    *compressed_len = output.size;
+    return true;
+}
+
 Status BufferedBlockMgr2::allocate_scratch_space(int64_t block_size,
         TmpFileMgr::File** tmp_file, int64_t* file_offset) {
     // Assumes block manager lock is already taken.
@@ -848,6 +925,10 @@ void BufferedBlockMgr2::write_complete(Block* block, const Status& write_status)
 
     // Explicitly release our temporarily allocated buffer here so that it doesn't
     // hang around needlessly.
+    if (block->_compress_buffer != NULL) {
+        _free_compress_buffers.push_back(block->_compress_buffer);
+        block->_compress_buffer = NULL;
+    }
 
     // return_unused_block() will clear the block, so save the client pointer.
     // We have to be careful while touching the state because it may have been cleaned up by
@@ -1282,6 +1363,16 @@ void BufferedBlockMgr2::init(
     _buffer_wait_timer = ADD_TIMER(_profile.get(), "TotalBufferWaitTime");
     _encryption_timer = ADD_TIMER(_profile.get(), "TotalEncryptionTime");
     _integrity_check_timer = ADD_TIMER(_profile.get(), "TotalIntegrityCheckTime");
+    _compression_timer = ADD_TIMER(_profile.get(), "TotalCompressionTime");
+
+    if (config::spill_compression) {
+        Status status = get_block_compression_codec(segment_v2::LZ4, &_compress_codec);
+        if (!status.ok()) {
+            LOG(WARNING) << "Spill blocks uncompressed, failed to get LZ4 codec: "
+                << status.get_error_msg();
+            _compress_codec = NULL;
+        }
+    }
 
     // Create a new mem_tracker and allocate buffers.
     // _mem_tracker.reset(new MemTracker(
@@ -28,6 +28,7 @@
 
 namespace doris {
 
+class BlockCompressionCodec;
 class RuntimeState;
 
 // The BufferedBlockMgr2 is used to allocate and manage blocks of data using a fixed memory
@@ -260,6 +261,15 @@ public:
         // Length of valid (i.e. allocated) data within the block.
         int64_t _valid_data_len;
 
+        // Buffer holding the compressed data while the block is being written, NULL if
+        // the block is written uncompressed. Returned to the block manager in
+        // write_complete().
+        uint8_t* _compress_buffer;
+
+        // True if the last write of this block was compressed. The on-disk length is
+        // then _write_range->len(), and _valid_data_len is the decompressed length.
+        bool _is_compressed;
+
         // Number of rows in this block.
         int _num_rows;
 
@@ -483,6 +493,16 @@ private:
     // Issues the write for this block to the DiskIoMgr.
     Status write_unpinned_block(Block* block);
 
+    // Compresses the block's data into a buffer taken from _free_compress_buffers, sets
+    // block->_compress_buffer and '*compressed_len' and returns true. Returns false and
+    // leaves the block uncompressed if compression fails or does not save space.
+    // Must be called with the _lock already taken.
+    bool compress_block(Block* block, int64_t* compressed_len);
+
+    // Reads the data of an evicted block back into its buffer, decompressing it if it
+    // was written compressed.
+    Status read_block(Block* block);
+
     // Allocate block_size bytes in a temporary file. Try multiple disks if error occurs.
     // Returns an error only if no temporary files are usable.
     Status allocate_scratch_space(int64_t block_size, TmpFileMgr::File** tmp_file,
@@ -512,9 +532,12 @@ private:
     const int64_t _max_block_size;
 
     // Unpinned blocks are written when the number of free buffers is below this threshold.
-    // Equal to the number of disks.
+    // Equal to the number of disks times config::spill_writes_per_scratch_dir.
     const int _block_write_threshold;
 
+    // Codec used to compress spilled blocks, NULL if config::spill_compression is false.
+    BlockCompressionCodec* _compress_codec;
+
     // If true, spilling is disabled. The client calls will fail if there is not enough
     // memory.
     const bool _disable_spill;
@@ -549,6 +572,10 @@ private:
     // This does not include client-local writes.
     int _non_local_outstanding_writes;
 
+    // Compression buffers of completed writes, reused by later writes. There are at most
+    // as many buffers as writes ever in flight at once. Protected by _lock.
+    std::vector<uint8_t*> _free_compress_buffers;
+
     // Signal availability of free buffers.
     boost::condition_variable _buffer_available_cv;
 
@@ -622,6 +649,9 @@ private:
     // Time spent in disk spill encryption and decryption.
     RuntimeProfile::Counter* _encryption_timer;
 
+    // Time spent in disk spill compression and decompression.
+    RuntimeProfile::Counter* _compression_timer;
+
     // Time spent in disk spill integrity generation and checking.
     RuntimeProfile::Counter* _integrity_check_timer;
 
@@ -26,8 +26,11 @@
 #include "runtime/data_stream_recvr.h"
 #include "runtime/raw_value.h"
 #include "runtime/runtime_state.h"
+#include "service/brpc.h"
+#include "util/block_compression.h"
 #include "util/uid_util.h"
 
+#include "gen_cpp/segment_v2.pb.h"
 #include "gen_cpp/types.pb.h" // PUniqueId
 #include "gen_cpp/BackendService.h"
 #include "gen_cpp/PaloInternalService_types.h"
@@ -93,7 +96,9 @@ shared_ptr<DataStreamRecvr> DataStreamMgr::find_recvr(
     return shared_ptr<DataStreamRecvr>();
 }
 
-Status DataStreamMgr::transmit_data(const PTransmitDataParams* request, ::google::protobuf::Closure** done) {
+Status DataStreamMgr::transmit_data(const PTransmitDataParams* request,
+                                    const butil::IOBuf* attachment,
+                                    ::google::protobuf::Closure** done) {
     const PUniqueId& finst_id = request->finst_id();
     TUniqueId t_finst_id;
     t_finst_id.hi = finst_id.hi();
@@ -120,8 +125,25 @@ Status DataStreamMgr::transmit_data(const PTransmitDataParams* request, ::google
 
     bool eos = request->eos();
     if (request->has_row_batch()) {
-        recvr->add_batch(request->row_batch(), request->sender_id(), 
-                request->be_number(), request->packet_seq(), eos ? nullptr : done);
+        AttachedTupleData attached;
+        if (request->has_attachment_compression_type()) {
+            BlockCompressionCodec* codec = nullptr;
+            auto st = get_block_compression_codec(
+                    (segment_v2::CompressionTypePB)request->attachment_compression_type(), &codec);
+            if (!st.ok() || attachment == nullptr) {
+                LOG(WARNING) << "tuple data is not found in attachment, cancel stream: "
+                    << "fragment_instance_id=" << t_finst_id << " node_id=" << request->node_id();
+                recvr->cancel_stream();
+                return st.ok() ? Status::InternalError("tuple data is not found in attachment") : st;
+            }
+            attached.data = attachment;
+            attached.codec = codec;
+            attached.uncompressed_size = request->attachment_uncompressed_size();
+        }
+        recvr->add_batch(request->row_batch(),
+                request->has_attachment_compression_type() ? &attached : nullptr,
+                request->sender_id(), request->be_number(), request->packet_seq(),
+                eos ? nullptr : done);
     }
 
     if (eos) {
@@ -35,6 +35,10 @@
 #include "gen_cpp/palo_internal_service.pb.h"
 #include "gen_cpp/Types_types.h"  // for TUniqueId
 
+namespace butil {
+class IOBuf;
+}
+
 namespace google {
 namespace protobuf {
 class Closure;
@@ -80,11 +84,23 @@ public:
             int num_senders, int buffer_size, RuntimeProfile* profile,
             bool is_merging, std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr);
 
-    Status transmit_data(const PTransmitDataParams* request, ::google::protobuf::Closure** done);
+    // 'attachment' is the attachment of the rpc carrying 'request', it holds the tuple
+    // data of the row batch if request->has_attachment_compression_type().
+    Status transmit_data(const PTransmitDataParams* request, const butil::IOBuf* attachment,
+                         ::google::protobuf::Closure** done);
 
     // Closes all receivers registered for fragment_instance_id immediately.
     void cancel(const TUniqueId& fragment_instance_id);
 
+    // Return the receiver for given fragment_instance_id/node_id,
+    // or NULL if not found. If 'acquire_lock' is false, assumes _lock is already being
+    // held and won't try to acquire it.
+    // Also used by DataStreamSender to hand row batches to receivers of this backend
+    // directly.
+    boost::shared_ptr<DataStreamRecvr> find_recvr(
+            const TUniqueId& fragment_instance_id, PlanNodeId node_id,
+            bool acquire_lock = true);
+
 private:
     friend class DataStreamRecvr;
 
@@ -121,13 +137,6 @@ private:
     typedef std::set<std::pair<TUniqueId, PlanNodeId>, ComparisonOp > FragmentStreamSet;
     FragmentStreamSet _fragment_stream_set;
 
-    // Return the receiver for given fragment_instance_id/node_id,
-    // or NULL if not found. If 'acquire_lock' is false, assumes _lock is already being
-    // held and won't try to acquire it.
-    boost::shared_ptr<DataStreamRecvr> find_recvr(
-            const TUniqueId& fragment_instance_id, PlanNodeId node_id,
-            bool acquire_lock = true);
-
     // Remove receiver block for fragment_instance_id/node_id from the map.
     Status deregister_recvr(const TUniqueId& fragment_instance_id, PlanNodeId node_id);
 
@@ -17,12 +17,13 @@
 
 #include "runtime/data_stream_recvr.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include <unordered_map>
-#include <deque>
 
 #include <boost/thread/locks.hpp>
 #include <boost/thread/mutex.hpp>
+#include <butil/iobuf.h>
 #include <google/protobuf/stubs/common.h>
 
 #include "gen_cpp/data.pb.h"
@@ -66,15 +67,18 @@ public:
     // must acquire data from the returned batch before the next call to get_batch().
     Status get_batch(RowBatch** next_batch);
 
-    // Adds a row batch to this sender queue if this stream has not been cancelled;
-    // blocks if this will make the stream exceed its buffer limit.
-    // If the total size of the batches in this queue would exceed the allowed buffer size,
-    // the queue is considered full and the call blocks until a batch is dequeued.
+    // Adds a row batch to this sender queue if this stream has not been cancelled.
+    // If the sender is throttled (see should_throttle()), *done is taken over and run
+    // once the sender's batches were consumed below its share of the buffer limit.
     void add_batch(
-        const PRowBatch& pb_batch,
+        const PRowBatch& pb_batch, const AttachedTupleData* attached,
         int be_number, int64_t packet_seq,
         ::google::protobuf::Closure** done);
 
+    // Adds the rows of 'batch' of a sender on this backend, see
+    // DataStreamRecvr::add_batch(RowBatch*, int, int, bool).
+    void add_batch(RowBatch* batch, int be_number, bool use_move);
+
     // Decrement the number of remaining senders for this queue and signal eos ("new data")
     // if the count drops to 0. The number of senders will be 1 for a merging
     // DataStreamRecvr.
@@ -93,6 +97,14 @@ public:
     }
 
 private:
+    // Returns true if the batches of sender 'be_number' must not be acked: the stream is
+    // over its buffer limit or the query over its memory limit, and this sender buffers
+    // more than its share of the buffer limit. Senders below their share keep going.
+    bool should_throttle(int be_number);
+
+    // Runs the deferred acks of all senders which are not throttled anymore.
+    void release_pending_closures();
+
     // Receiver of which this queue is a member.
     DataStreamRecvr* _recvr;
 
@@ -112,9 +124,15 @@ private:
     // signal removal of data by stream consumer
     condition_variable _data_removal_cv;
 
-    // queue of (batch length, batch) pairs.  The SenderQueue block owns memory to
+    struct BufferedBatch {
+        int size;
+        int be_number;
+        RowBatch* batch;
+    };
+
+    // queue of received batches. The SenderQueue block owns memory to
     // these batches. They are handed off to the caller via get_batch.
-    typedef list<pair<int, RowBatch*> > RowBatchQueue;
+    typedef list<BufferedBatch> RowBatchQueue;
     RowBatchQueue _batch_queue;
 
     // The batch that was most recently returned via get_batch(), i.e. the current batch
@@ -128,7 +146,13 @@ private:
     std::unordered_set<int> _sender_eos_set; // sender_id
     std::unordered_map<int, int64_t> _packet_seq_map; // be_number => packet_seq
 
-    std::deque<google::protobuf::Closure*> _pending_closures;
+    // bytes of the batches in _batch_queue of every sender, be_number => bytes
+    std::unordered_map<int, int64_t> _sender_buffered_bytes;
+
+    // Deferred ack of every throttled sender, be_number => closure. A sender waits for
+    // the ack of its last rpc before sending the next one, so every ack is the credit
+    // for one more batch and there is at most one deferred ack per sender.
+    std::unordered_map<int, google::protobuf::Closure*> _pending_closures;
 };
 
 DataStreamRecvr::SenderQueue::SenderQueue(
@@ -139,6 +163,28 @@ DataStreamRecvr::SenderQueue::SenderQueue(
     _received_first_batch(false) {
 }
 
+bool DataStreamRecvr::SenderQueue::should_throttle(int be_number) {
+    if (!_recvr->exceeds_limit(0) && !_recvr->mem_tracker()->any_limit_exceeded()) {
+        return false;
+    }
+    auto it = _sender_buffered_bytes.find(be_number);
+    return it != _sender_buffered_bytes.end()
+        && it->second > _recvr->_sender_buffer_limit;
+}
+
+void DataStreamRecvr::SenderQueue::release_pending_closures() {
+    for (auto it = _pending_closures.begin(); it != _pending_closures.end();) {
+        if (should_throttle(it->first)) {
+            ++it;
+            continue;
+        }
+        it->second->Run();
+        it = _pending_closures.erase(it);
+    }
+    // senders on this backend check should_throttle() themselves
+    _data_removal_cv.notify_all();
+}
+
 Status DataStreamRecvr::SenderQueue::get_batch(RowBatch** next_batch) {
     unique_lock<mutex> l(_lock);
     // wait until something shows up or we know we're done
@@ -168,25 +214,22 @@ Status DataStreamRecvr::SenderQueue::get_batch(RowBatch** next_batch) {
     _received_first_batch = true;
 
     DCHECK(!_batch_queue.empty());
-    RowBatch* result = _batch_queue.front().second;
-    _recvr->_num_buffered_bytes -= _batch_queue.front().first;
+    const BufferedBatch& front = _batch_queue.front();
+    RowBatch* result = front.batch;
+    _recvr->_num_buffered_bytes -= front.size;
+    _sender_buffered_bytes[front.be_number] -= front.size;
     VLOG_ROW << "fetched #rows=" << result->num_rows();
     _batch_queue.pop_front();
-    // _data_removal_cv.notify_one();
     _current_batch.reset(result);
     *next_batch = _current_batch.get();
 
-    if (!_pending_closures.empty()) {
-        auto done = _pending_closures.front();
-        done->Run();
-        _pending_closures.pop_front();
-    }
+    release_pending_closures();
 
     return Status::OK();
 }
 
 void DataStreamRecvr::SenderQueue::add_batch(
-        const PRowBatch& pb_batch,
+        const PRowBatch& pb_batch, const AttachedTupleData* attached,
         int be_number, int64_t packet_seq,
         ::google::protobuf::Closure** done) {
     unique_lock<mutex> l(_lock);
@@ -206,6 +249,9 @@ void DataStreamRecvr::SenderQueue::add_batch(
     }
 
     int batch_size = RowBatch::get_batch_size(pb_batch);
+    if (attached != nullptr) {
+        batch_size += attached->data->size();
+    }
     COUNTER_UPDATE(_recvr->_bytes_received_counter, batch_size);
 
     // Following situation will match the following condition.
@@ -240,20 +286,79 @@ void DataStreamRecvr::SenderQueue::add_batch(
         // Note: if this function makes a row batch, the batch *must* be added
         // to _batch_queue. It is not valid to create the row batch and destroy
         // it in this thread.
-        batch = new RowBatch(_recvr->row_desc(), pb_batch, _recvr->mem_tracker());
+        if (attached != nullptr) {
+            batch = new RowBatch(_recvr->row_desc(), pb_batch, *attached->data,
+                                 attached->codec, attached->uncompressed_size,
+                                 _recvr->mem_tracker());
+        } else {
+            batch = new RowBatch(_recvr->row_desc(), pb_batch, _recvr->mem_tracker());
+        }
+    }
+    if (!batch->valid()) {
+        // Rows of this stream are lost, so the query can't return a correct result.
+        LOG(WARNING) << "corrupted tuple data in attachment, cancel stream: "
+            << "fragment_instance_id=" << _recvr->fragment_instance_id()
+            << " node_id=" << _recvr->dest_node_id();
+        delete batch;
+        _is_cancelled = true;
+        _data_arrival_cv.notify_all();
+        return;
     }
    
     VLOG_ROW << "added #rows=" << batch->num_rows()
         << " batch_size=" << batch_size << "\n";
-    _batch_queue.emplace_back(batch_size, batch);
+    _batch_queue.push_back({batch_size, be_number, batch});
+    _recvr->_num_buffered_bytes += batch_size;
+    _sender_buffered_bytes[be_number] += batch_size;
     // if done is nullptr, this function can't delay this response
-    if (done != nullptr && _recvr->exceeds_limit(batch_size)) {
+    if (done != nullptr && should_throttle(be_number)) {
         DCHECK(*done != nullptr);
-        _pending_closures.push_back(*done);
+        auto& pending = _pending_closures[be_number];
+        if (pending != nullptr) {
+            // not expected as the sender waits for the ack, but don't lose it
+            pending->Run();
+        }
+        pending = *done;
         *done = nullptr;
     }
+    _data_arrival_cv.notify_one();
+}
+
+void DataStreamRecvr::SenderQueue::add_batch(RowBatch* batch, int be_number, bool use_move) {
+    unique_lock<mutex> l(_lock);
+    if (_is_cancelled) {
+        return;
+    }
+    if (_num_remaining_senders <= 0) {
+        return;
+    }
+
+    // Copied or moved under _lock like the deserialization of a remote batch, close()
+    // releases the memory tracker of the receiver once _is_cancelled is set.
+    RowBatch* recvr_batch = new RowBatch(
+            _recvr->row_desc(), batch->capacity(), _recvr->mem_tracker());
+    if (use_move) {
+        recvr_batch->acquire_state(batch);
+    } else {
+        batch->deep_copy_to(recvr_batch);
+    }
+    int batch_size = recvr_batch->tuple_data_pool()->total_allocated_bytes();
+    COUNTER_UPDATE(_recvr->_bytes_received_counter, batch_size);
+
+    VLOG_ROW << "added local #rows=" << recvr_batch->num_rows()
+        << " batch_size=" << batch_size << "\n";
+    // Enqueued regardless of the buffer limit for the same reason as a remote batch.
+    _batch_queue.push_back({batch_size, be_number, recvr_batch});
     _recvr->_num_buffered_bytes += batch_size;
+    _sender_buffered_bytes[be_number] += batch_size;
     _data_arrival_cv.notify_one();
+
+    if (should_throttle(be_number)) {
+        SCOPED_TIMER(_recvr->_buffer_full_total_timer);
+        while (!_is_cancelled && should_throttle(be_number)) {
+            _data_removal_cv.wait(l);
+        }
+    }
 }
 
 void DataStreamRecvr::SenderQueue::decrement_senders(int be_number) {
@@ -287,14 +392,14 @@ void DataStreamRecvr::SenderQueue::cancel() {
     // Wake up all threads waiting to produce/consume batches.  They will all
     // notice that the stream is cancelled and handle it.
     _data_arrival_cv.notify_all();
-    // _data_removal_cv.notify_all();
+    _data_removal_cv.notify_all();
     // PeriodicCounterUpdater::StopTimeSeriesCounter(
     //         _recvr->_bytes_received_time_series_counter);
 
     {
         boost::lock_guard<boost::mutex> l(_lock);
-        for (auto done : _pending_closures) {
-            done->Run();
+        for (auto& it : _pending_closures) {
+            it.second->Run();
         }
         _pending_closures.clear();
     }
@@ -308,16 +413,17 @@ void DataStreamRecvr::SenderQueue::close() {
         boost::lock_guard<boost::mutex> l(_lock);
         _is_cancelled = true;
 
-        for (auto done : _pending_closures) {
-            done->Run();
+        for (auto& it : _pending_closures) {
+            it.second->Run();
         }
         _pending_closures.clear();
     }
+    _data_removal_cv.notify_all();
 
     // Delete any batches queued in _batch_queue
     for (RowBatchQueue::iterator it = _batch_queue.begin();
             it != _batch_queue.end(); ++it) {
-        delete it->second;
+        delete it->batch;
     }
 
     _current_batch.reset();
@@ -357,6 +463,7 @@ DataStreamRecvr::DataStreamRecvr(
             _fragment_instance_id(fragment_instance_id),
             _dest_node_id(dest_node_id),
             _total_buffer_limit(total_buffer_limit),
+            _sender_buffer_limit(std::max(1, total_buffer_limit / std::max(num_senders, 1))),
             _row_desc(row_desc),
             _is_merging(is_merging),
             _num_buffered_bytes(0),
@@ -393,12 +500,18 @@ Status DataStreamRecvr::get_next(RowBatch* output_batch, bool* eos) {
 }
 
 void DataStreamRecvr::add_batch(
-        const PRowBatch& batch, int sender_id,
-        int be_number, int64_t packet_seq,
+        const PRowBatch& batch, const AttachedTupleData* attached,
+        int sender_id, int be_number, int64_t packet_seq,
         ::google::protobuf::Closure** done) {
     int use_sender_id = _is_merging ? sender_id : 0;
     // Add all batches to the same queue if _is_merging is false.
-    _sender_queues[use_sender_id]->add_batch(batch, be_number, packet_seq, done);
+    _sender_queues[use_sender_id]->add_batch(batch, attached, be_number, packet_seq, done);
+}
+
+void DataStreamRecvr::add_batch(RowBatch* batch, int sender_id, int be_number,
+                                bool use_move) {
+    int use_sender_id = _is_merging ? sender_id : 0;
+    _sender_queues[use_sender_id]->add_batch(batch, be_number, use_move);
 }
 
 void DataStreamRecvr::remove_sender(int sender_id, int be_number) {
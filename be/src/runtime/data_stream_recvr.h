@@ -34,6 +34,10 @@ class Closure;
 }
 }
 
+namespace butil {
+class IOBuf;
+}
+
 namespace doris {
 
 class DataStreamMgr;
@@ -42,6 +46,16 @@ class MemTracker;
 class RowBatch;
 class RuntimeProfile;
 class PRowBatch;
+class BlockCompressionCodec;
+
+// Tuple data of a PRowBatch which was sent in the rpc attachment instead of in the
+// PRowBatch itself.
+struct AttachedTupleData {
+    // compressed by 'codec', or uncompressed if 'codec' is null
+    const butil::IOBuf* data = nullptr;
+    const BlockCompressionCodec* codec = nullptr;
+    size_t uncompressed_size = 0;
+};
 
 // Single receiver of an m:n data stream.
 // DataStreamRecvr maintains one or more queues of row batches received by a
@@ -104,6 +118,16 @@ public:
         _sub_plan_query_statistics_recvr->insert(statistics, sender_id);
     }
 
+    // Adds the rows of 'batch' from a sender running on this backend. If 'use_move' is
+    // true, the tuples and the memory of 'batch' are taken over and 'batch' is left
+    // empty, otherwise they are deep copied. Like the ack of a transmit_data rpc, returns
+    // only once the sender is not throttled anymore.
+    void add_batch(RowBatch* batch, int sender_id, int be_number, bool use_move);
+
+    // Indicate that a particular sender is done. Delegated to the appropriate
+    // sender queue. Called from DataStreamMgr and from senders on this backend.
+    void remove_sender(int sender_id, int be_number);
+
 private:
     friend class DataStreamMgr;
     class SenderQueue;
@@ -115,14 +139,12 @@ private:
             std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr);
 
     // If receive queue is full, done is enqueue pending, and return with *done is nullptr
-    void add_batch(const PRowBatch& batch, int sender_id,
-                   int be_number, int64_t packet_seq,
+    // 'attached' is the tuple data of 'batch' if it was sent in the rpc attachment,
+    // nullptr otherwise.
+    void add_batch(const PRowBatch& batch, const AttachedTupleData* attached,
+                   int sender_id, int be_number, int64_t packet_seq,
                    ::google::protobuf::Closure** done);
 
-    // Indicate that a particular sender is done. Delegated to the appropriate
-    // sender queue. Called from DataStreamMgr.
-    void remove_sender(int sender_id, int be_number);
-
     // Empties the sender queues and notifies all waiting consumers of cancellation.
     void cancel_stream();
 
@@ -140,10 +162,13 @@ private:
     PlanNodeId _dest_node_id;
 
     // soft upper limit on the total amount of buffering allowed for this stream across
-    // all sender queues. we stop acking incoming data once the amount of buffered data
-    // exceeds this value
+    // all sender queues. once the amount of buffered data exceeds this value we stop
+    // acking incoming data of the senders which buffer more than _sender_buffer_limit
     int _total_buffer_limit;
 
+    // share of _total_buffer_limit of every sender
+    int _sender_buffer_limit;
+
     // Row schema, copied from the caller of CreateRecvr().
     RowDescriptor _row_desc;
 
@@ -20,29 +20,38 @@
 #include <iostream>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/unordered_map.hpp>
 #include <thrift/protocol/TDebugProtocol.h>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "exprs/expr.h"
+#include "runtime/data_stream_mgr.h"
+#include "runtime/data_stream_recvr.h"
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
 #include "runtime/tuple_row.h"
 #include "runtime/row_batch.h"
 #include "runtime/raw_value.h"
+#include "runtime/query_trace.h"
 #include "runtime/runtime_state.h"
 #include "runtime/client_cache.h"
 #include "runtime/dpp_sink_internal.h"
 #include "runtime/mem_tracker.h"
+#include "service/backend_options.h"
+#include "util/block_compression.h"
 #include "util/debug_util.h"
 #include "util/network_util.h"
 #include "util/thrift_client.h"
 #include "util/thrift_util.h"
+#include "util/uid_util.h"
 
 #include "gen_cpp/Types_types.h"
 #include "gen_cpp/PaloInternalService_types.h"
 #include "gen_cpp/BackendService.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "gen_cpp/palo_internal_service.pb.h"
+#include "gen_cpp/segment_v2.pb.h"
 
 #include <arpa/inet.h>
 
@@ -53,6 +62,19 @@
 #include "util/ref_count_closure.h"
 
 namespace doris {
+
+// Tuple data of a serialized row batch which is sent in the rpc attachment, see
+// config::data_stream_sender_use_attachment.
+struct DataStreamSender::TupleDataAttachment {
+    butil::IOBuf buf;
+    segment_v2::CompressionTypePB compression_type = segment_v2::NO_COMPRESSION;
+    int64_t uncompressed_size = 0;
+};
+
+// Tuple data which doesn't become smaller than this fraction of its size is not worth
+// compressing, and the next SKIP_COMPRESSION_BATCHES batches are sent uncompressed.
+static const double MAX_COMPRESSED_FRACTION = 0.9;
+static const int SKIP_COMPRESSION_BATCHES = 64;
  
 // A channel sends data asynchronously via calls to transmit_data
 // to a single destination ipaddress/node.
@@ -109,7 +131,10 @@ public:
     // Returns the status of the most recently finished transmit_data
     // rpc (or OK if there wasn't one that hasn't been reported yet).
     // if batch is nullptr, send the eof packet
-    Status send_batch(PRowBatch* batch, bool eos = false);
+    // If 'attachment' is not nullptr, it holds the tuple data of 'batch' and is sent
+    // in the rpc attachment.
+    Status send_batch(PRowBatch* batch, bool eos = false,
+                      const TupleDataAttachment* attachment = nullptr);
 
     // Flush buffered rows and close channel.
     // Returns error status if any of the preceding rpcs failed, OK otherwise.
@@ -123,6 +148,21 @@ public:
         return &_pb_batch;
     }
 
+    TupleDataAttachment* attachment() {
+        return &_attachment;
+    }
+
+    // True if the receiver of this channel is on this backend. Row batches are then
+    // handed to it by send_local_batch() instead of being serialized and sent by rpc.
+    bool is_local() const {
+        return _is_local;
+    }
+
+    // Hands the rows of 'batch' to the local receiver. If 'use_move' is true the
+    // receiver takes over the memory of 'batch' and 'batch' is left empty, otherwise
+    // the rows are deep copied.
+    Status send_local_batch(RowBatch* batch, bool use_move);
+
 private:
     inline Status _wait_last_brpc() {
         auto cntl = &_closure->cntl;
@@ -142,6 +182,11 @@ private:
     Status send_current_batch(bool eos = false);
     Status close_internal();
 
+    // Looks up the local receiver if it isn't yet. Returns false if it is not registered
+    // (anymore), rows for it are dropped then like transmit_data() does.
+    bool find_local_recvr();
+    void send_local_query_statistics();
+
     DataStreamSender* _parent;
     int _buffer_size;
 
@@ -164,6 +209,8 @@ private:
     // TODO(zc): initused for brpc
     PUniqueId _finst_id;
     PRowBatch _pb_batch;
+    // tuple data of _pb_batch if the parent sends it in rpc attachment
+    TupleDataAttachment _attachment;
     PTransmitDataParams _brpc_request;
     palo::PInternalService_Stub* _brpc_stub = nullptr;
     RefCountClosure<PTransmitDataResult>* _closure = nullptr;
@@ -171,6 +218,9 @@ private:
     // whether the dest can be treated as query statistics transfer chain.
     bool _is_transfer_chain;
     bool _send_query_statistics_with_every_batch;
+
+    bool _is_local = false;
+    boost::shared_ptr<DataStreamRecvr> _local_recvr;
 };
 
 Status DataStreamSender::Channel::init(RuntimeState* state) {
@@ -197,11 +247,16 @@ Status DataStreamSender::Channel::init(RuntimeState* state) {
     _brpc_timeout_ms = std::min(3600, state->query_options().query_timeout) * 1000;
     _brpc_stub = state->exec_env()->brpc_stub_cache()->get_stub(_brpc_dest_addr);
 
+    _is_local = config::enable_local_exchange
+        && _brpc_dest_addr.hostname == BackendOptions::get_localhost()
+        && _brpc_dest_addr.port == config::brpc_port;
+
     _need_close = true;
     return Status::OK();
 }
 
-Status DataStreamSender::Channel::send_batch(PRowBatch* batch, bool eos) {
+Status DataStreamSender::Channel::send_batch(PRowBatch* batch, bool eos,
+                                             const TupleDataAttachment* attachment) {
     if (_closure == nullptr) {
         _closure = new RefCountClosure<PTransmitDataResult>();
         _closure->ref();
@@ -220,6 +275,15 @@ Status DataStreamSender::Channel::send_batch(PRowBatch* batch, bool eos) {
     if (batch != nullptr) {
         _brpc_request.set_allocated_row_batch(batch);
     }
+    if (batch != nullptr && attachment != nullptr) {
+        // only references the blocks of 'attachment', the data is not copied
+        _closure->cntl.request_attachment().append(attachment->buf);
+        _brpc_request.set_attachment_compression_type(attachment->compression_type);
+        _brpc_request.set_attachment_uncompressed_size(attachment->uncompressed_size);
+    } else {
+        _brpc_request.clear_attachment_compression_type();
+        _brpc_request.clear_attachment_uncompressed_size();
+    }
     _brpc_request.set_packet_seq(_packet_seq++);
 
     _closure->ref();
@@ -231,6 +295,37 @@ Status DataStreamSender::Channel::send_batch(PRowBatch* batch, bool eos) {
     return Status::OK();
 }
 
+bool DataStreamSender::Channel::find_local_recvr() {
+    if (_local_recvr == nullptr) {
+        _local_recvr = _parent->_state->exec_env()->stream_mgr()->find_recvr(
+                _fragment_instance_id, _dest_node_id);
+    }
+    return _local_recvr != nullptr;
+}
+
+void DataStreamSender::Channel::send_local_query_statistics() {
+    PQueryStatistics statistics;
+    _parent->_query_statistics->to_pb(&statistics);
+    _local_recvr->add_sub_plan_statistics(statistics, _parent->_sender_id);
+}
+
+Status DataStreamSender::Channel::send_local_batch(RowBatch* batch, bool use_move) {
+    VLOG_ROW << "Channel::send_local_batch() instance_id=" << _fragment_instance_id
+             << " dest_node=" << _dest_node_id;
+    if (!find_local_recvr()) {
+        if (use_move) {
+            batch->reset();
+        }
+        return Status::OK();
+    }
+    if (_is_transfer_chain && _send_query_statistics_with_every_batch) {
+        send_local_query_statistics();
+    }
+    COUNTER_UPDATE(_parent->_local_rows_sent_counter, batch->num_rows());
+    _local_recvr->add_batch(batch, _parent->_sender_id, _be_number, use_move);
+    return Status::OK();
+}
+
 Status DataStreamSender::Channel::add_row(TupleRow* row) {
     int row_num = _batch->add_row();
 
@@ -260,6 +355,15 @@ Status DataStreamSender::Channel::add_row(TupleRow* row) {
 }
 
 Status DataStreamSender::Channel::send_current_batch(bool eos) {
+    if (_is_local) {
+        return send_local_batch(_batch.get(), true);
+    }
+    if (_parent->_attachment_codec != nullptr) {
+        RETURN_IF_ERROR(_parent->serialize_batch_to_attachment(
+                _batch.get(), &_pb_batch, &_attachment));
+        _batch->reset();
+        return send_batch(&_pb_batch, eos, &_attachment);
+    }
     {
         SCOPED_TIMER(_parent->_serialize_batch_timer);
         int uncompressed_bytes = _batch->serialize(&_pb_batch);
@@ -278,6 +382,19 @@ Status DataStreamSender::Channel::close_internal() {
     VLOG_RPC << "Channel::close() instance_id=" << _fragment_instance_id
              << " dest_node=" << _dest_node_id
              << " #rows= " << ((_batch == nullptr) ? 0 : _batch->num_rows());
+    if (_is_local) {
+        if (_batch != NULL && _batch->num_rows() > 0) {
+            RETURN_IF_ERROR(send_local_batch(_batch.get(), true));
+        }
+        if (find_local_recvr()) {
+            if (_is_transfer_chain) {
+                send_local_query_statistics();
+            }
+            _local_recvr->remove_sender(_parent->_sender_id, _be_number);
+        }
+        _need_close = false;
+        return Status::OK();
+    }
     if (_batch != NULL && _batch->num_rows() > 0) {
         RETURN_IF_ERROR(send_current_batch(true));
     } else {
@@ -315,18 +432,33 @@ DataStreamSender::DataStreamSender(
     DCHECK(sink.output_partition.type == TPartitionType::UNPARTITIONED
             || sink.output_partition.type == TPartitionType::HASH_PARTITIONED
             || sink.output_partition.type == TPartitionType::RANDOM
-            || sink.output_partition.type == TPartitionType::RANGE_PARTITIONED);
+            || sink.output_partition.type == TPartitionType::RANGE_PARTITIONED
+            || sink.output_partition.type == TPartitionType::BUCKET_SHUFFLE_HASH_PARTITIONED);
+    // index in _channels of every destination fragment instance
+    boost::unordered_map<TUniqueId, int> fragment_instance_channel_idx;
     // TODO: use something like google3's linked_ptr here (scoped_ptr isn't copyable)
     for (int i = 0; i < destinations.size(); ++i) {
+        const TUniqueId& fragment_instance_id = destinations[i].fragment_instance_id;
+        if (_part_type == TPartitionType::BUCKET_SHUFFLE_HASH_PARTITIONED) {
+            auto it = fragment_instance_channel_idx.find(fragment_instance_id);
+            if (it != fragment_instance_channel_idx.end()) {
+                _bucket_channels.push_back(_channels[it->second]);
+                continue;
+            }
+            fragment_instance_channel_idx.emplace(fragment_instance_id, _channels.size());
+        }
         // Select first dest as transfer chain.
         bool is_transfer_chain = (i == 0);
         _channel_shared_ptrs.emplace_back(
             new Channel(this, row_desc,
                         destinations[i].brpc_server,
-                        destinations[i].fragment_instance_id,
+                        fragment_instance_id,
                         sink.dest_node_id, per_channel_buffer_size, 
                         is_transfer_chain, send_query_statistics_with_every_batch));
-        _channels.push_back(_channel_shared_ptrs[i].get());
+        _channels.push_back(_channel_shared_ptrs.back().get());
+        if (_part_type == TPartitionType::BUCKET_SHUFFLE_HASH_PARTITIONED) {
+            _bucket_channels.push_back(_channels.back());
+        }
     }
 }
 
@@ -339,7 +471,8 @@ static bool compare_part_use_range(const PartitionInfo* v1, const PartitionInfo*
 Status DataStreamSender::init(const TDataSink& tsink) {
     RETURN_IF_ERROR(DataSink::init(tsink));
     const TDataStreamSink& t_stream_sink = tsink.stream_sink;
-    if (_part_type == TPartitionType::HASH_PARTITIONED) {
+    if (_part_type == TPartitionType::HASH_PARTITIONED
+            || _part_type == TPartitionType::BUCKET_SHUFFLE_HASH_PARTITIONED) {
         RETURN_IF_ERROR(Expr::create_expr_trees(
                 _pool, t_stream_sink.output_partition.partition_exprs, &_partition_expr_ctxs));
     } else if (_part_type == TPartitionType::RANGE_PARTITIONED) {
@@ -381,7 +514,8 @@ Status DataStreamSender::prepare(RuntimeState* state) {
         // Randomize the order we open/transmit to channels to avoid thundering herd problems.
         srand(reinterpret_cast<uint64_t>(this));
         random_shuffle(_channels.begin(), _channels.end());
-    } else if (_part_type == TPartitionType::HASH_PARTITIONED) {
+    } else if (_part_type == TPartitionType::HASH_PARTITIONED
+            || _part_type == TPartitionType::BUCKET_SHUFFLE_HASH_PARTITIONED) {
         RETURN_IF_ERROR(Expr::prepare(
                 _partition_expr_ctxs, state, _row_desc, _expr_mem_tracker.get()));
     } else {
@@ -398,6 +532,8 @@ Status DataStreamSender::prepare(RuntimeState* state) {
         ADD_COUNTER(profile(), "UncompressedRowBatchSize", TUnit::BYTES);
     _ignore_rows =
         ADD_COUNTER(profile(), "IgnoreRows", TUnit::UNIT);
+    _local_rows_sent_counter =
+        ADD_COUNTER(profile(), "LocalRowsSent", TUnit::UNIT);
     _serialize_batch_timer =
         ADD_TIMER(profile(), "SerializeBatchTime");
     _thrift_transmit_timer = ADD_TIMER(profile(), "ThriftTransmitTime(*)");
@@ -409,8 +545,15 @@ Status DataStreamSender::prepare(RuntimeState* state) {
         profile()->add_derived_counter("OverallThroughput", TUnit::BYTES_PER_SECOND,
         boost::bind<int64_t>(&RuntimeProfile::units_per_second, _bytes_sent_counter,
                                              profile()->total_time_counter()), "");
+    if (config::data_stream_sender_use_attachment) {
+        RETURN_IF_ERROR(get_block_compression_codec(segment_v2::LZ4, &_attachment_codec));
+        _attachment.reset(new TupleDataAttachment());
+    }
     for (int i = 0; i < _channels.size(); ++i) {
         RETURN_IF_ERROR(_channels[i]->init(state));
+        if (_channels[i]->is_local()) {
+            ++_num_local_channels;
+        }
     }
 
     return Status::OK();
@@ -433,20 +576,46 @@ Status DataStreamSender::open(RuntimeState* state) {
 
 Status DataStreamSender::send(RuntimeState* state, RowBatch* batch) {
     SCOPED_TIMER(_profile->total_time_counter());
+    SCOPED_TRACE_SPAN(state, "ExchangeSend", "exchange");
 
     // Unpartition or _channel size
     if (_part_type == TPartitionType::UNPARTITIONED || _channels.size() == 1) {
-        RETURN_IF_ERROR(serialize_batch(batch, _current_pb_batch, _channels.size()));
+        // 'batch' is still owned by the caller, so local channels get a copy of it
+        int num_remote_channels = _channels.size() - _num_local_channels;
+        if (num_remote_channels > 0) {
+            if (_attachment_codec != nullptr) {
+                RETURN_IF_ERROR(serialize_batch_to_attachment(
+                        batch, _current_pb_batch, _attachment.get(), num_remote_channels));
+            } else {
+                RETURN_IF_ERROR(serialize_batch(batch, _current_pb_batch, num_remote_channels));
+            }
+        }
         for (auto channel : _channels) {
-            RETURN_IF_ERROR(channel->send_batch(_current_pb_batch));
+            if (channel->is_local()) {
+                RETURN_IF_ERROR(channel->send_local_batch(batch, false));
+            } else {
+                RETURN_IF_ERROR(channel->send_batch(
+                        _current_pb_batch, false, _attachment.get()));
+            }
+        }
+        if (num_remote_channels > 0) {
+            _current_pb_batch = (_current_pb_batch == &_pb_batch1 ? &_pb_batch2 : &_pb_batch1);
         }
-        _current_pb_batch = (_current_pb_batch == &_pb_batch1 ? &_pb_batch2 : &_pb_batch1);
     } else if (_part_type == TPartitionType::RANDOM) {
         // Round-robin batches among channels. Wait for the current channel to finish its
         // rpc before overwriting its batch.
         Channel* current_channel = _channels[_current_channel_idx];
-        RETURN_IF_ERROR(serialize_batch(batch, current_channel->pb_batch()));
-        RETURN_IF_ERROR(current_channel->send_batch(current_channel->pb_batch()));
+        if (current_channel->is_local()) {
+            RETURN_IF_ERROR(current_channel->send_local_batch(batch, false));
+        } else if (_attachment_codec != nullptr) {
+            RETURN_IF_ERROR(serialize_batch_to_attachment(
+                    batch, current_channel->pb_batch(), current_channel->attachment()));
+            RETURN_IF_ERROR(current_channel->send_batch(
+                    current_channel->pb_batch(), false, current_channel->attachment()));
+        } else {
+            RETURN_IF_ERROR(serialize_batch(batch, current_channel->pb_batch()));
+            RETURN_IF_ERROR(current_channel->send_batch(current_channel->pb_batch()));
+        }
         _current_channel_idx = (_current_channel_idx + 1) % _channels.size();
     } else if (_part_type == TPartitionType::HASH_PARTITIONED) {
         // hash-partition batch's rows across channels
@@ -467,6 +636,15 @@ Status DataStreamSender::send(RuntimeState* state, RowBatch* batch) {
             }
             RETURN_IF_ERROR(_channels[hash_val % num_channels]->add_row(row));
         }
+    } else if (_part_type == TPartitionType::BUCKET_SHUFFLE_HASH_PARTITIONED) {
+        // send every row to the instance which scans the tablet bucket of its
+        // distribution key, so the rows don't have to be shuffled on the other side
+        int num_buckets = _bucket_channels.size();
+        for (int i = 0; i < batch->num_rows(); ++i) {
+            TupleRow* row = batch->get_row(i);
+            uint32_t hash_val = compute_distribute_hash(_partition_expr_ctxs, row);
+            RETURN_IF_ERROR(_bucket_channels[hash_val % num_buckets]->add_row(row));
+        }
     } else {
         // Range partition
         int num_channels = _channels.size();
@@ -550,11 +728,10 @@ Status DataStreamSender::find_partition(
     return Status::OK();
 }
 
-Status DataStreamSender::process_distribute(
-        RuntimeState* state, TupleRow* row,
-        const PartitionInfo* part, size_t* code) {
+uint32_t DataStreamSender::compute_distribute_hash(
+        const std::vector<ExprContext*>& ctxs, TupleRow* row) {
     uint32_t hash_val = 0;
-    for (auto& ctx: part->distributed_expr_ctxs()) {
+    for (auto& ctx: ctxs) {
         void* partition_val = ctx->get_value(row);
         if (partition_val != NULL) {
             hash_val = RawValue::zlib_crc32(partition_val, ctx->root()->type(), hash_val);
@@ -565,6 +742,13 @@ Status DataStreamSender::process_distribute(
             hash_val = RawValue::zlib_crc32(&INT_VALUE, INT_TYPE, hash_val);
         }
     }
+    return hash_val;
+}
+
+Status DataStreamSender::process_distribute(
+        RuntimeState* state, TupleRow* row,
+        const PartitionInfo* part, size_t* code) {
+    uint32_t hash_val = compute_distribute_hash(part->distributed_expr_ctxs(), row);
     hash_val %= part->distributed_bucket();
 
     int64_t part_id = part->id();
@@ -624,6 +808,52 @@ Status DataStreamSender::serialize_batch(RowBatch* src, T* dest, int num_receive
     return Status::OK();
 }
 
+Status DataStreamSender::serialize_batch_to_attachment(
+        RowBatch* src, PRowBatch* dest, TupleDataAttachment* attachment, int num_receivers) {
+    VLOG_ROW << "serializing " << src->num_rows() << " rows to attachment";
+    SCOPED_TIMER(_serialize_batch_timer);
+    attachment->buf.clear();
+    attachment->compression_type = segment_v2::NO_COMPRESSION;
+    int uncompressed_bytes = src->total_byte_size();
+    attachment->uncompressed_size = uncompressed_bytes;
+    if (uncompressed_bytes == 0) {
+        src->serialize(dest, nullptr, 0);
+    } else if (_num_batches_to_skip_compression > 0) {
+        --_num_batches_to_skip_compression;
+        // serialize directly into a buffer owned by attachment, so that uncompressed
+        // tuple data is sent without being copied
+        char* buf = reinterpret_cast<char*>(malloc(uncompressed_bytes));
+        src->serialize(dest, buf, uncompressed_bytes);
+        attachment->buf.append_user_data(buf, uncompressed_bytes, free);
+    } else {
+        _tuple_data_buf.resize(uncompressed_bytes);
+        src->serialize(dest, const_cast<char*>(_tuple_data_buf.data()), uncompressed_bytes);
+        Slice input(_tuple_data_buf);
+        size_t max_len = _attachment_codec->max_compressed_len(input.size);
+        // buffer is owned by attachment after appended, so that it is not copied
+        char* buf = reinterpret_cast<char*>(malloc(max_len));
+        Slice output(buf, max_len);
+        auto st = _attachment_codec->compress(input, &output);
+        if (!st.ok()) {
+            free(buf);
+            LOG(WARNING) << "fail to compress tuple data, msg=" << st.get_error_msg();
+            return st;
+        }
+        if (output.size <= input.size * MAX_COMPRESSED_FRACTION) {
+            attachment->buf.append_user_data(buf, output.size, free);
+            attachment->compression_type = segment_v2::LZ4;
+        } else {
+            free(buf);
+            _num_batches_to_skip_compression = SKIP_COMPRESSION_BATCHES;
+            attachment->buf.append(input.data, input.size);
+        }
+    }
+    int bytes = RowBatch::get_batch_size(*dest) + attachment->buf.size();
+    COUNTER_UPDATE(_bytes_sent_counter, bytes * num_receivers);
+    COUNTER_UPDATE(_uncompressed_bytes_counter, uncompressed_bytes * num_receivers);
+    return Status::OK();
+}
+
 int64_t DataStreamSender::get_num_data_bytes_sent() const {
     // TODO: do we need synchronization here or are reads & writes to 8-byte ints
     // atomic?
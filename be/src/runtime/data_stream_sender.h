@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_RUNTIME_DATA_STREAM_SENDER_H
 #define DORIS_BE_RUNTIME_DATA_STREAM_SENDER_H
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -40,6 +41,7 @@ class PartitionInfo;
 class TupleRow;
 class PartRangeKey;
 class MemTracker;
+class BlockCompressionCodec;
 
 // Single sender of an m:n data stream.
 // Row batch data is routed to destinations based on the provided
@@ -55,7 +57,10 @@ public:
     // Per_channel_buffer_size is the buffer size allocated to each channel
     // and is specified in bytes.
     // The RowDescriptor must live until close() is called.
-    // NOTE: supported partition types are UNPARTITIONED (broadcast) and HASH_PARTITIONED
+    // NOTE: supported partition types are UNPARTITIONED (broadcast), RANDOM,
+    // HASH_PARTITIONED, RANGE_PARTITIONED and BUCKET_SHUFFLE_HASH_PARTITIONED. For the
+    // latter destinations[i] is the instance scanning bucket i, an instance scanning
+    // several buckets appears several times but gets a single channel.
     DataStreamSender(ObjectPool* pool, int sender_id,
                      const RowDescriptor& row_desc, const TDataStreamSink& sink,
                      const std::vector<TPlanFragmentDestination>& destinations,
@@ -99,6 +104,13 @@ public:
 
 private:
     class Channel;
+    struct TupleDataAttachment;
+
+    // Like serialize_batch(), but the tuple data of 'src' is put in 'attachment'
+    // instead of 'dest', compressed by LZ4 unless recent batches didn't compress well.
+    Status serialize_batch_to_attachment(RowBatch* src, PRowBatch* dest,
+                                         TupleDataAttachment* attachment,
+                                         int num_receivers = 1);
 
     Status compute_range_part_code(
         RuntimeState* state,
@@ -115,6 +127,11 @@ private:
         RuntimeState* state, TupleRow* row,
         const PartitionInfo* part, size_t* hash_val);
 
+    // Hash of the distribution key of 'row' like OlapTablePartitionParam computes it,
+    // its remainder by the bucket number is the tablet bucket of 'row'.
+    static uint32_t compute_distribute_hash(const std::vector<ExprContext*>& ctxs,
+                                            TupleRow* row);
+
     // Sender instance id, unique within a fragment.
     int _sender_id;
 
@@ -136,10 +153,26 @@ private:
     PRowBatch _pb_batch2;
     PRowBatch* _current_pb_batch = nullptr;
 
+    // Set if config::data_stream_sender_use_attachment is true. The tuple data of
+    // broadcast batches is kept in '_attachment', which doesn't need to be double
+    // buffered since every rpc holds its own reference to the data.
+    BlockCompressionCodec* _attachment_codec = nullptr;
+    std::unique_ptr<TupleDataAttachment> _attachment;
+    // uncompressed tuple data of the batch being compressed into an attachment
+    std::string _tuple_data_buf;
+    // number of following batches whose tuple data is sent uncompressed because
+    // compression didn't pay off for the last one
+    int _num_batches_to_skip_compression = 0;
+
     std::vector<ExprContext*> _partition_expr_ctxs;  // compute per-row partition values
 
     std::vector<Channel*> _channels;
+    // channel of every bucket for BUCKET_SHUFFLE_HASH_PARTITIONED, points into _channels
+    std::vector<Channel*> _bucket_channels;
     std::vector<std::shared_ptr<Channel>> _channel_shared_ptrs;
+    // number of channels whose receiver is on this backend, they don't need
+    // serialized batches, see config::enable_local_exchange
+    int _num_local_channels = 0;
 
     // map from range value to partition_id
     // sorted in ascending orderi by range for binary search
@@ -151,6 +184,7 @@ private:
     RuntimeProfile::Counter* _bytes_sent_counter;
     RuntimeProfile::Counter* _uncompressed_bytes_counter;
     RuntimeProfile::Counter* _ignore_rows;
+    RuntimeProfile::Counter* _local_rows_sent_counter = nullptr;
 
     std::unique_ptr<MemTracker> _mem_tracker;
 
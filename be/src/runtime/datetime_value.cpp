@@ -24,6 +24,7 @@
 #include <limits>
 #include <sstream>
 
+#include "common/compiler_util.h"
 #include "common/logging.h"
 
 namespace doris {
@@ -101,10 +102,70 @@ bool DateTimeValue::check_date() const {
     return false;
 }
 
+// Converts the 'n' ascii digits starting at 's', returns false if any isn't a digit.
+// The digits are checked together so the common valid case takes no branch per digit.
+static inline bool parse_fixed_digits(const char* s, int n, uint32_t* val) {
+    uint32_t res = 0;
+    uint32_t invalid = 0;
+    for (int i = 0; i < n; ++i) {
+        uint32_t digit = static_cast<uint8_t>(s[i]) - '0';
+        invalid |= (digit > 9);
+        res = res * 10 + digit;
+    }
+    *val = res;
+    return invalid == 0;
+}
+
+bool DateTimeValue::from_fixed_date_str(const char* date_str, int len, bool* valid) {
+    if (len != 10 && len != 19) {
+        return false;
+    }
+    if (date_str[4] != '-' || date_str[7] != '-') {
+        return false;
+    }
+    uint32_t year = 0;
+    uint32_t month = 0;
+    uint32_t day = 0;
+    uint32_t hour = 0;
+    uint32_t minute = 0;
+    uint32_t second = 0;
+    bool ok = parse_fixed_digits(date_str, 4, &year)
+        & parse_fixed_digits(date_str + 5, 2, &month)
+        & parse_fixed_digits(date_str + 8, 2, &day);
+    if (len == 19) {
+        if (date_str[10] != ' ' || date_str[13] != ':' || date_str[16] != ':') {
+            return false;
+        }
+        ok = ok & parse_fixed_digits(date_str + 11, 2, &hour)
+            & parse_fixed_digits(date_str + 14, 2, &minute)
+            & parse_fixed_digits(date_str + 17, 2, &second);
+    }
+    if (!ok) {
+        return false;
+    }
+    _neg = false;
+    _type = (len == 10) ? TIME_DATE : TIME_DATETIME;
+    _year = year;
+    _month = month;
+    _day = day;
+    _hour = hour;
+    _minute = minute;
+    _second = second;
+    _microsecond = 0;
+    *valid = !check_range() && !check_date();
+    return true;
+}
+
 // The interval format is that with no delimiters
 // YYYY-MM-DD HH-MM-DD.FFFFFF AM in default format
 // 0    1  2  3  4  5  6      7
 bool DateTimeValue::from_date_str(const char* date_str, int len) {
+    // Loads mostly carry dates in exactly this layout, which needs no field scanning.
+    bool valid = false;
+    if (LIKELY(from_fixed_date_str(date_str, len, &valid))) {
+        return valid;
+    }
+
     const char* ptr = date_str;
     const char* end = date_str + len;
     // ONLY 2, 6 can follow by a sapce
@@ -1453,7 +1514,7 @@ bool DateTimeValue::date_add_interval(const TimeInterval& interval, TimeUnit uni
     case DAY_MINUTE:
     case DAY_HOUR: {
         // This may change the day information 
-        int64_t microseconds = _microsecond + sign * interval.microsecond;
+        int64_t microseconds = static_cast<int64_t>(_microsecond) + sign * interval.microsecond;
         int64_t extra_second = microseconds / 1000000L;
         microseconds %= 1000000L;
 
@@ -1525,40 +1586,47 @@ bool DateTimeValue::date_add_interval(const TimeInterval& interval, TimeUnit uni
 }
 
 bool DateTimeValue::unix_timestamp(int64_t* timestamp, const std::string& timezone) const{
-    boost::local_time::time_zone_ptr local_time_zone = TimezoneDatabase::find_timezone(timezone);
-    if (local_time_zone == nullptr) {
+    TimezoneOffsets offsets;
+    if (!TimezoneDatabase::find_timezone_offsets(timezone, &offsets)) {
         return false;
     }
-    char buf[64];
-    char* to = to_datetime_string(buf);
-    boost::posix_time::ptime pt = boost::posix_time::time_from_string(std::string(buf, to - buf -1));
+    return unix_timestamp(timestamp, offsets);
+}
+
+bool DateTimeValue::from_unixtime(int64_t timestamp, const std::string& timezone) {
+    TimezoneOffsets offsets;
+    if (!TimezoneDatabase::find_timezone_offsets(timezone, &offsets)) {
+        return false;
+    }
+    return from_unixtime(timestamp, offsets);
+}
 
-    boost::local_time::local_date_time lt(pt.date(), pt.time_of_day(), local_time_zone,
-                                              boost::local_time::local_date_time::NOT_DATE_TIME_ON_ERROR);
+// daynr() of 1970-01-01
+static const int64_t EPOCH_DAYNR = 719528;
 
-    boost::posix_time::ptime utc_ptime = lt.utc_time();
-    boost::posix_time::ptime utc_start(boost::gregorian::date(1970, 1, 1));
-    boost::posix_time::time_duration dur = utc_ptime - utc_start;
-    *timestamp =  dur.total_milliseconds() / 1000;
+bool DateTimeValue::unix_timestamp(int64_t* timestamp, const TimezoneOffsets& timezone) const {
+    int64_t local = (static_cast<int64_t>(daynr()) - EPOCH_DAYNR) * 86400
+        + _hour * 3600 + _minute * 60 + _second;
+    *timestamp = timezone.local_to_utc(local);
     return true;
 }
 
-bool DateTimeValue::from_unixtime(int64_t timestamp, const std::string& timezone) {
-    boost::local_time::time_zone_ptr local_time_zone = TimezoneDatabase::find_timezone(timezone);
-    if (local_time_zone == nullptr) {
-        return false;                            
+bool DateTimeValue::from_unixtime(int64_t timestamp, const TimezoneOffsets& timezone) {
+    int64_t local = timezone.utc_to_local(timestamp);
+    int64_t days = local / 86400;
+    int64_t seconds = local % 86400;
+    if (seconds < 0) {
+        days--;
+        seconds += 86400;
+    }
+    if (!get_date_from_daynr(days + EPOCH_DAYNR)) {
+        return false;
     }
-    boost::local_time::local_date_time lt(boost::posix_time::from_time_t(timestamp), local_time_zone);
-    boost::posix_time::ptime local_ptime = lt.local_time();
-        
     _neg = 0;
     _type = TIME_DATETIME;
-    _year = local_ptime.date().year();
-    _month = local_ptime.date().month();
-    _day = local_ptime.date().day();
-    _hour = local_ptime.time_of_day().hours();
-    _minute = local_ptime.time_of_day().minutes();
-    _second = local_ptime.time_of_day().seconds();
+    _hour = seconds / 3600;
+    _minute = seconds / 60 % 60;
+    _second = seconds % 60;
     _microsecond = 0;
 
     return true;
@@ -1598,7 +1666,7 @@ std::size_t operator-(const DateTimeValue& v1, const DateTimeValue& v2) {
 }
 
 std::size_t hash_value(DateTimeValue const& value) {
-    return HashUtil::hash(&value, sizeof(DateTimeValue), 0);
+    return value.hash(0);
 }
 
 }
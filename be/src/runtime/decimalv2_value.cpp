@@ -16,9 +16,12 @@
 // under the License.
 
 #include "runtime/decimalv2_value.h"
+
+#include "common/compiler_util.h"
 #include "util/string_parser.hpp"
 
 #include <algorithm>
+#include <limits>
 #include <iostream>
 #include <utility>
 
@@ -28,6 +31,38 @@ const char* DecimalV2Value::_s_llvm_class_name = "class.doris::DecimalV2Value";
 
 static inline int128_t abs(const int128_t& x) { return (x < 0) ? -x : x; }
 
+// Most decimals seen in practice are below 9223372036.854775807 and so fit in an int64.
+// Sums of those can't reach MAX_DECIMAL_VALUE and their products can't overflow an
+// int128, which lets the operators below skip most of the checks and 128-bit divisions.
+static inline bool fits_int64(int128_t x) {
+    return static_cast<int64_t>(x) == x;
+}
+
+// 'x' and 'y' are absolute values fitting in an int64. Gives the same result as
+// do_mul, but splits the integer parts off so that all the divisions are on 64 bits.
+static inline int128_t do_mul_64(uint64_t x, uint64_t y) {
+    const uint64_t one_billion = DecimalV2Value::ONE_BILLION;
+    uint64_t x_int = x / one_billion;
+    uint64_t x_frac = x % one_billion;
+    uint64_t y_int = y / one_billion;
+    uint64_t y_frac = y % one_billion;
+    // Below 10^18, no overflow
+    uint64_t frac_product = x_frac * y_frac;
+
+    int128_t result = static_cast<int128_t>(x_int) * y_int * one_billion
+        + static_cast<int128_t>(x_int) * y_frac + static_cast<int128_t>(x_frac) * y_int
+        + frac_product / one_billion;
+    // overflow
+    if (result > DecimalV2Value::MAX_DECIMAL_VALUE) {
+        return DecimalV2Value::MAX_DECIMAL_VALUE;
+    }
+    // truncate with round
+    if (frac_product % one_billion >= (one_billion >> 1)) {
+        result += 1;
+    }
+    return result;
+}
+
 // x>=0 && y>=0
 static int do_add(int128_t x, int128_t y, int128_t* result) {
     int error = E_DEC_OK;
@@ -121,6 +156,9 @@ DecimalV2Value operator+(const DecimalV2Value& v1, const DecimalV2Value& v2) {
     int128_t result;
     int128_t x = v1.value();
     int128_t y = v2.value();
+    if (LIKELY(fits_int64(x) && fits_int64(y))) {
+        return DecimalV2Value(x + y);
+    }
     if (x == 0) {
        result = y;
     } else if (y == 0) {
@@ -147,6 +185,9 @@ DecimalV2Value operator-(const DecimalV2Value& v1, const DecimalV2Value& v2) {
     int128_t result;
     int128_t x = v1.value();
     int128_t y = v2.value();
+    if (LIKELY(fits_int64(x) && fits_int64(y))) {
+        return DecimalV2Value(x - y);
+    }
     if (x == 0) {
        result = -y;
     } else if (y == 0) {
@@ -179,7 +220,11 @@ DecimalV2Value operator*(const DecimalV2Value& v1, const DecimalV2Value& v2){
 
     bool is_positive = (x > 0 && y > 0) || (x < 0 && y < 0);
 
-    do_mul(abs(x), abs(y), &result);
+    if (LIKELY(fits_int64(x) && fits_int64(y))) {
+        result = do_mul_64(abs(x), abs(y));
+    } else {
+        do_mul(abs(x), abs(y), &result);
+    }
 
     if (!is_positive) result = -result;
 
@@ -194,7 +239,21 @@ DecimalV2Value operator/(const DecimalV2Value& v1, const DecimalV2Value& v2){
     //todo: return 0 for divide zero 
     if (x == 0 || y == 0) return DecimalV2Value(0);
     bool is_positive = (x > 0 && y > 0) || (x < 0 && y < 0);
-    do_div(abs(x), abs(y), &result);
+    int128_t abs_x = abs(x);
+    int128_t abs_y = abs(y);
+    if (abs_x <= std::numeric_limits<uint64_t>::max() / DecimalV2Value::ONE_BILLION
+            && abs_y <= std::numeric_limits<uint64_t>::max()) {
+        // The scaled dividend still fits in 64 bits, same rounding as do_div
+        uint64_t dividend = static_cast<uint64_t>(abs_x) * DecimalV2Value::ONE_BILLION;
+        uint64_t divisor = static_cast<uint64_t>(abs_y);
+        result = dividend / divisor;
+        uint64_t remainder = dividend % divisor;
+        if (remainder != 0 && remainder >= (divisor >> 1)) {
+            result += 1;
+        }
+    } else {
+        do_div(abs_x, abs_y, &result);
+    }
 
     if (!is_positive) result = -result;
 
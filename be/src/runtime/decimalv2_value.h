@@ -51,6 +51,8 @@ public:
     static const int64_t MAX_INT_VALUE = 999999999999999999;
     static const int32_t MAX_FRAC_VALUE = 999999999;
     static const int64_t MAX_INT64 = 9223372036854775807ll;
+    // Integers up to 2^53 are exactly representable in a double
+    static const int64_t MAX_EXACT_DOUBLE_INT = 1ll << 53;
 
     static const int128_t MAX_DECIMAL_VALUE = 
         static_cast<int128_t>(MAX_INT64) * ONE_BILLION + MAX_FRAC_VALUE;
@@ -115,6 +117,9 @@ public:
     // Discard the scale part
     // ATTN: invoker must make sure no OVERFLOW
     operator int64_t() const {
+        if (static_cast<int64_t>(_value) == _value) {
+            return static_cast<int64_t>(_value) / ONE_BILLION;
+        }
         return static_cast<int64_t>(_value / ONE_BILLION);
     }
 
@@ -151,6 +156,11 @@ public:
     }
 
     operator double() const {
+        // Both operands are exact doubles, so the division is rounded the same way
+        // as parsing the decimal string
+        if (_value >= -MAX_EXACT_DOUBLE_INT && _value <= MAX_EXACT_DOUBLE_INT) {
+            return static_cast<double>(_value) / ONE_BILLION;
+        }
         std::string str_buff = to_string();
         double result = std::strtod(str_buff.c_str(), nullptr);
         return result;
@@ -169,6 +179,9 @@ public:
     // ATTN: the max length of fraction part in OLAP is 9, so the 'big digits' except the first one
     // will be truncated.
     int32_t frac_value() const {
+        if (static_cast<int64_t>(_value) == _value) {
+            return static_cast<int64_t>(_value) % ONE_BILLION;
+        }
         return static_cast<int64_t>(_value % ONE_BILLION);
     }
 
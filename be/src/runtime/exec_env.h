@@ -34,6 +34,7 @@ class EtlJobMgr;
 class EvHttpServer;
 class ExternalScanContextMgr;
 class FragmentMgr;
+class GroupCommitMgr;
 class LoadPathMgr;
 class LoadStreamMgr;
 class MemTracker;
@@ -101,6 +102,8 @@ public:
     PoolMemTrackerRegistry* pool_mem_trackers() { return _pool_mem_trackers; }
     ThreadResourceMgr* thread_mgr() { return _thread_mgr; }
     PriorityThreadPool* thread_pool() { return _thread_pool; }
+    // nullptr if small scans share thread pool with others
+    PriorityThreadPool* small_scan_thread_pool() { return _small_scan_thread_pool; }
     ThreadPool* etl_thread_pool() { return _etl_thread_pool; }
     CgroupsMgr* cgroups_mgr() { return _cgroups_mgr; }
     FragmentMgr* fragment_mgr() { return _fragment_mgr; }
@@ -126,6 +129,7 @@ public:
 
     StreamLoadExecutor* stream_load_executor() { return _stream_load_executor; }
     RoutineLoadTaskExecutor* routine_load_task_executor() { return _routine_load_task_executor; }
+    GroupCommitMgr* group_commit_mgr() { return _group_commit_mgr; }
 
 private:
     Status _init(const std::vector<StorePath>& store_paths);
@@ -152,6 +156,7 @@ private:
     PoolMemTrackerRegistry* _pool_mem_trackers = nullptr;
     ThreadResourceMgr* _thread_mgr = nullptr;
     PriorityThreadPool* _thread_pool = nullptr;
+    PriorityThreadPool* _small_scan_thread_pool = nullptr;
     ThreadPool* _etl_thread_pool = nullptr;
     CgroupsMgr* _cgroups_mgr = nullptr;
     FragmentMgr* _fragment_mgr = nullptr;
@@ -175,6 +180,7 @@ private:
 
     StreamLoadExecutor* _stream_load_executor = nullptr;
     RoutineLoadTaskExecutor* _routine_load_task_executor = nullptr;
+    GroupCommitMgr* _group_commit_mgr = nullptr;
     SmallFileMgr* _small_file_mgr = nullptr;
 };
 
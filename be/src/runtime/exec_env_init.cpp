@@ -32,6 +32,7 @@
 #include "runtime/mem_tracker.h"
 #include "runtime/thread_resource_mgr.h"
 #include "runtime/fragment_mgr.h"
+#include "runtime/fragment_result_cache.h"
 #include "runtime/tablet_writer_mgr.h"
 #include "runtime/tmp_file_mgr.h"
 #include "runtime/bufferpool/reservation_tracker.h"
@@ -42,6 +43,7 @@
 #include "util/debug_util.h"
 #include "olap/storage_engine.h"
 #include "olap/page_cache.h"
+#include "olap/segment_cache.h"
 #include "util/network_util.h"
 #include "util/bfd_parser.h"
 #include "runtime/etl_job_mgr.h"
@@ -50,6 +52,7 @@
 #include "runtime/routine_load/routine_load_task_executor.h"
 #include "runtime/stream_load/load_stream_mgr.h"
 #include "runtime/stream_load/stream_load_executor.h"
+#include "runtime/stream_load/group_commit_mgr.h"
 #include "runtime/small_file_mgr.h"
 #include "util/pretty_printer.h"
 #include "util/doris_metrics.h"
@@ -85,7 +88,14 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     _thread_mgr = new ThreadResourceMgr();
     _thread_pool = new PriorityThreadPool(
         config::doris_scanner_thread_pool_thread_num,
-        config::doris_scanner_thread_pool_queue_size);
+        config::doris_scanner_thread_pool_queue_size,
+        config::doris_scanner_thread_pool_numa_aware);
+    if (config::doris_small_scanner_thread_pool_thread_num > 0) {
+        _small_scan_thread_pool = new PriorityThreadPool(
+            config::doris_small_scanner_thread_pool_thread_num,
+            config::doris_scanner_thread_pool_queue_size,
+            config::doris_scanner_thread_pool_numa_aware);
+    }
     _etl_thread_pool = new ThreadPool(
         config::etl_thread_pool_size,
         config::etl_thread_pool_queue_size);
@@ -104,6 +114,7 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     _brpc_stub_cache = new BrpcStubCache();
     _stream_load_executor = new StreamLoadExecutor(this);
     _routine_load_task_executor = new RoutineLoadTaskExecutor(this);
+    _group_commit_mgr = new GroupCommitMgr(this);
     _small_file_mgr = new SmallFileMgr(this, config::small_file_dir);
 
     _backend_client_cache->init_metrics(DorisMetrics::metrics(), "backend");
@@ -191,7 +202,17 @@ Status ExecEnv::_init_mem_tracker() {
             << config::storage_page_cache_limit
             << ", memory=" << MemInfo::physical_mem();
     }
-    StoragePageCache::create_global_cache(storage_cache_limit);
+    StoragePageCache::create_global_cache(storage_cache_limit,
+                                          config::index_page_cache_percentage,
+                                          config::storage_page_cache_cold_percentage);
+
+    int64_t segment_cache_limit = ParseUtil::parse_mem_spec(
+        config::segment_cache_limit, &is_percent);
+    SegmentCache::create_global_cache(segment_cache_limit > 0 ? segment_cache_limit : 0);
+
+    int64_t result_cache_limit = ParseUtil::parse_mem_spec(
+        config::fragment_result_cache_limit, &is_percent);
+    FragmentResultCache::create_global_cache(result_cache_limit > 0 ? result_cache_limit : 0);
 
     // TODO(zc): The current memory usage configuration is a bit confusing,
     // we need to sort out the use of memory
@@ -208,6 +229,7 @@ void ExecEnv::_init_buffer_pool(int64_t min_page_size,
 }
 
 void ExecEnv::_destory() {
+    delete _group_commit_mgr;
     delete _brpc_stub_cache;
     delete _load_stream_mgr;
     delete _tablet_writer_mgr;
@@ -222,6 +244,7 @@ void ExecEnv::_destory() {
     delete _fragment_mgr;
     delete _cgroups_mgr;
     delete _etl_thread_pool;
+    delete _small_scan_thread_pool;
     delete _thread_pool;
     delete _thread_mgr;
     delete _pool_mem_trackers;
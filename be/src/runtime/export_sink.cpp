@@ -18,7 +18,10 @@
 #include "runtime/export_sink.h"
 #include <sstream>
 
+#include "common/config.h"
 #include "exprs/expr.h"
+#include "gutil/strings/numbers.h"
+#include "runtime/large_int_value.h"
 #include "runtime/runtime_state.h"
 #include "runtime/mysql_table_sink.h"
 #include "runtime/mem_tracker.h"
@@ -39,6 +42,8 @@ ExportSink::ExportSink(ObjectPool* pool,
         _pool(pool),
         _row_desc(row_desc),
         _t_output_expr(t_exprs),
+        _file_bytes(0),
+        _file_idx(0),
         _bytes_written_counter(nullptr),
         _rows_written_counter(nullptr),
         _write_timer(nullptr) {
@@ -92,67 +97,89 @@ Status ExportSink::send(RuntimeState* state, RowBatch* batch) {
     VLOG_ROW << "debug: export_sink send batch: " << batch->to_string();
     SCOPED_TIMER(_profile->total_time_counter());
     int num_rows = batch->num_rows();
-    // we send at most 1024 rows at a time
-    int batch_send_rows = num_rows > 1024 ? 1024 : num_rows;
-    std::stringstream ss;
-    for (int i = 0; i < num_rows;) {
-        ss.str("");
-        for (int j = 0; j < batch_send_rows && i < num_rows; ++j, ++i) {
-            RETURN_IF_ERROR(gen_row_buffer(batch->get_row(i), &ss));
+    for (int i = 0; i < num_rows; ++i) {
+        RETURN_IF_ERROR(gen_row_buffer(batch->get_row(i), &_buffer));
+        // send rpc by large buffer instead of by rows
+        if (_buffer.size() >= static_cast<size_t>(config::export_sink_write_buffer_bytes)) {
+            RETURN_IF_ERROR(flush_buffer());
         }
+    }
+    COUNTER_UPDATE(_rows_written_counter, num_rows);
+    return Status::OK();
+}
 
-        VLOG_ROW << "debug: export_sink send row: " << ss.str();
-        const std::string& buf = ss.str();
-        size_t written_len = 0;
+Status ExportSink::flush_buffer() {
+    if (_buffer.empty()) {
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(open_file_writer());
 
+    VLOG_ROW << "debug: export_sink send row: " << _buffer;
+    size_t written_len = 0;
+    {
         SCOPED_TIMER(_write_timer);
-        // TODO(lingbin): for broker writer, we should not send rpc each row.
-        RETURN_IF_ERROR(_file_writer->write(reinterpret_cast<const uint8_t*>(buf.c_str()),
-                buf.size(),
+        RETURN_IF_ERROR(_file_writer->write(reinterpret_cast<const uint8_t*>(_buffer.data()),
+                _buffer.size(),
                 &written_len));
-        COUNTER_UPDATE(_bytes_written_counter, buf.size());
     }
-    COUNTER_UPDATE(_rows_written_counter, num_rows);
+    COUNTER_UPDATE(_bytes_written_counter, _buffer.size());
+    _file_bytes += _buffer.size();
+    _buffer.clear();
+
+    if (config::export_max_file_size_bytes > 0
+            && _file_bytes >= config::export_max_file_size_bytes) {
+        RETURN_IF_ERROR(close_file_writer());
+    }
     return Status::OK();
 }
 
-Status ExportSink::gen_row_buffer(TupleRow* row, std::stringstream* ss) {
+Status ExportSink::gen_row_buffer(TupleRow* row, std::string* buf) {
     int num_columns = _output_expr_ctxs.size();
-    // const TupleDescriptor& desc = row_desc().TupleDescriptor;
+    // large enough for all numbers and datetime
+    char tmp[64];
     for (int i = 0; i < num_columns; ++i) {
         void* item = _output_expr_ctxs[i]->get_value(row);
         if (item == nullptr) {
-            (*ss) << "\\N";
+            buf->append("\\N");
         } else {
             switch (_output_expr_ctxs[i]->root()->type().type) {
                 case TYPE_BOOLEAN:
                 case TYPE_TINYINT:
-                    (*ss) << (int)*static_cast<int8_t*>(item);
+                    buf->append(tmp, FastInt32ToBufferLeft(*static_cast<int8_t*>(item), tmp) - tmp);
                     break;
                 case TYPE_SMALLINT:
-                    (*ss) << *static_cast<int16_t*>(item);
+                    buf->append(tmp, FastInt32ToBufferLeft(*static_cast<int16_t*>(item), tmp) - tmp);
                     break;
                 case TYPE_INT:
-                    (*ss) << *static_cast<int32_t*>(item);
+                    buf->append(tmp, FastInt32ToBufferLeft(*static_cast<int32_t*>(item), tmp) - tmp);
                     break;
                 case TYPE_BIGINT:
-                    (*ss) << *static_cast<int64_t*>(item);
+                    buf->append(tmp, FastInt64ToBufferLeft(*static_cast<int64_t*>(item), tmp) - tmp);
                     break;
-                case TYPE_LARGEINT:
-                    (*ss) << reinterpret_cast<PackedInt128*>(item)->value;
+                case TYPE_LARGEINT: {
+                    int len = sizeof(tmp);
+                    char* start = LargeIntValue::to_string(
+                            reinterpret_cast<PackedInt128*>(item)->value, tmp, &len);
+                    buf->append(start, len);
                     break;
-                case TYPE_FLOAT:
-                    (*ss) << *static_cast<float*>(item);
+                }
+                case TYPE_FLOAT: {
+                    // same as the default format of std::ostream
+                    int len = snprintf(tmp, sizeof(tmp), "%g", *static_cast<float*>(item));
+                    buf->append(tmp, len);
                     break;
-                case TYPE_DOUBLE:
-                    (*ss) << *static_cast<double*>(item);
+                }
+                case TYPE_DOUBLE: {
+                    int len = snprintf(tmp, sizeof(tmp), "%g", *static_cast<double*>(item));
+                    buf->append(tmp, len);
                     break;
+                }
                 case TYPE_DATE:
                 case TYPE_DATETIME: {
-                    char buf[64];
                     const DateTimeValue* time_val = (const DateTimeValue*)(item);
-                    time_val->to_string(buf);
-                    (*ss) << buf;
+                    // to_string() returns the end after '\0'
+                    char* end = time_val->to_string(tmp);
+                    buf->append(tmp, end - tmp - 1);
                     break;
                 }
                 case TYPE_VARCHAR:
@@ -162,37 +189,33 @@ Status ExportSink::gen_row_buffer(TupleRow* row, std::stringstream* ss) {
                     if (string_val->ptr == NULL) {
                         if (string_val->len == 0) {
                         } else {
-                            (*ss) << "\\N";
+                            buf->append("\\N");
                         }
                     } else {
-                        (*ss) << std::string(string_val->ptr, string_val->len);
+                        buf->append(string_val->ptr, string_val->len);
                     }
                     break;
                 }
                 case TYPE_DECIMAL: {
                     const DecimalValue* decimal_val = reinterpret_cast<const DecimalValue*>(item);
-                    std::string decimal_str;
                     int output_scale = _output_expr_ctxs[i]->root()->output_scale();
 
                     if (output_scale > 0 && output_scale <= 30) {
-                        decimal_str = decimal_val->to_string(output_scale);
+                        buf->append(decimal_val->to_string(output_scale));
                     } else {
-                        decimal_str = decimal_val->to_string();
+                        buf->append(decimal_val->to_string());
                     }
-                    (*ss) << decimal_str;
                     break;
                 }
                 case TYPE_DECIMALV2: {
                     const DecimalV2Value decimal_val(reinterpret_cast<const PackedInt128*>(item)->value);
-                    std::string decimal_str;
                     int output_scale = _output_expr_ctxs[i]->root()->output_scale();
 
                     if (output_scale > 0 && output_scale <= 30) {
-                        decimal_str = decimal_val.to_string(output_scale);
+                        buf->append(decimal_val.to_string(output_scale));
                     } else {
-                        decimal_str = decimal_val.to_string();
+                        buf->append(decimal_val.to_string());
                     }
-                    (*ss) << decimal_str;
                     break;
                 }
                 default: {
@@ -204,20 +227,34 @@ Status ExportSink::gen_row_buffer(TupleRow* row, std::stringstream* ss) {
         }
 
         if (i < num_columns - 1) {
-            (*ss) << _t_export_sink.column_separator;
+            buf->append(_t_export_sink.column_separator);
         }
     }
-    (*ss) << _t_export_sink.line_delimiter;
+    buf->append(_t_export_sink.line_delimiter);
 
     return Status::OK();
 }
 
 Status ExportSink::close(RuntimeState* state, Status exec_status) {
+    Status status = Status::OK();
+    // rows buffered are useless if the plan failed
+    if (exec_status.ok()) {
+        status = flush_buffer();
+    }
     Expr::close(_output_expr_ctxs, state);
+    Status close_status = close_file_writer();
+    if (status.ok()) {
+        status = close_status;
+    }
+    return status;
+}
+
+Status ExportSink::close_file_writer() {
     if (_file_writer != nullptr) {
         _file_writer->close();
         _file_writer = nullptr;
     }
+    _file_bytes = 0;
     return Status::OK();
 }
 
@@ -255,6 +292,7 @@ Status ExportSink::open_file_writer() {
     }
 
     _state->add_export_output_file(_t_export_sink.export_path + "/" + file_name);
+    ++_file_idx;
     return Status::OK();
 }
 
@@ -268,6 +306,10 @@ std::string ExportSink::gen_file_name() {
     std::stringstream file_name;
     file_name << "export-data-" << print_id(id) << "-"
             << (tv.tv_sec * 1000 + tv.tv_usec / 1000);
+    // files rolled by size in the same millisecond
+    if (_file_idx > 0) {
+        file_name << "-" << _file_idx;
+    }
     return file_name.str();
 }
 
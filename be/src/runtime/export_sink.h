@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_RUNTIME_EXPORT_SINK_H
 #define DORIS_BE_SRC_RUNTIME_EXPORT_SINK_H
 
+#include <string>
 #include <vector>
 
 #include "common/status.h"
@@ -62,7 +63,11 @@ public:
 
 private:
     Status open_file_writer();
-    Status gen_row_buffer(TupleRow* row, std::stringstream* ss);
+    // write buffered rows to file writer, and roll to a new file
+    // if the current one is large enough
+    Status flush_buffer();
+    Status close_file_writer();
+    Status gen_row_buffer(TupleRow* row, std::string* buf);
     std::string gen_file_name();
 
     RuntimeState* _state;
@@ -76,6 +81,12 @@ private:
 
     TExportSink _t_export_sink;
     std::unique_ptr<FileWriter> _file_writer;
+    // rows formatted but not written yet, reused between batches
+    std::string _buffer;
+    // bytes written to the current file
+    int64_t _file_bytes;
+    // number of files opened, to make file names unique
+    int _file_idx;
 
     RuntimeProfile* _profile;
 
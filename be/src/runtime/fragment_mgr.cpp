@@ -26,6 +26,7 @@
 #include "agent/cgroups_mgr.h"
 #include "common/object_pool.h"
 #include "common/resource_tls.h"
+#include "exec/shared_hash_table_ctx.h"
 #include "service/backend_options.h"
 #include "runtime/plan_fragment_executor.h"
 #include "runtime/exec_env.h"
@@ -75,7 +76,8 @@ public:
 
     ~FragmentExecState();
 
-    Status prepare(const TExecPlanFragmentParams& params);
+    Status prepare(const TExecPlanFragmentParams& params,
+                   const std::shared_ptr<FragmentSharedState>& shared_state);
 
     // just no use now
     void callback(const Status& status, RuntimeProfile* profile, bool done);
@@ -113,6 +115,11 @@ public:
         _group = info.group;
     }
 
+    // Resource user of this fragment, empty if the coordinator did not send one.
+    const std::string& user() const {
+        return _user;
+    }
+
     bool is_timeout(const DateTimeValue& now) const {
         if (_timeout_second <= 0) {
             return false;
@@ -171,7 +178,8 @@ FragmentExecState::FragmentExecState(
 FragmentExecState::~FragmentExecState() {
 }
 
-Status FragmentExecState::prepare(const TExecPlanFragmentParams& params) {
+Status FragmentExecState::prepare(const TExecPlanFragmentParams& params,
+                                  const std::shared_ptr<FragmentSharedState>& shared_state) {
     if (params.__isset.query_options) {
         _timeout_second = params.query_options.query_timeout;
     }
@@ -180,7 +188,7 @@ Status FragmentExecState::prepare(const TExecPlanFragmentParams& params) {
         set_group(params.resource_info);
     }
 
-    return _executor.prepare(params);
+    return _executor.prepare(params, shared_state);
 }
 
 static void register_cgroups(const std::string& user, const std::string& group) {
@@ -210,6 +218,7 @@ Status FragmentExecState::execute() {
     }
     DorisMetrics::fragment_requests_total.increment(1);
     DorisMetrics::fragment_request_duration_us.increment(duration_ns / 1000);
+    DorisMetrics::fragment_request_latency_ms.add(duration_ns / 1000000);
     return Status::OK();
 }
 
@@ -349,7 +358,8 @@ FragmentMgr::FragmentMgr(ExecEnv* exec_env) :
         _cancel_thread(std::bind<void>(&FragmentMgr::cancel_worker, this)),
         // TODO(zc): we need a better thread-pool
         // now one user can use all the thread pool, others have no resource.
-        _thread_pool(config::fragment_pool_thread_num, config::fragment_pool_queue_size) {
+        _thread_pool(config::fragment_pool_thread_num, config::fragment_pool_queue_size),
+        _num_queued_fragments(0) {
 }
 
 FragmentMgr::~FragmentMgr() {
@@ -387,9 +397,45 @@ void FragmentMgr::exec_actual(
     }
     // Callback after remove from this id
     cb(exec_state->executor());
+    if (config::max_running_fragments_per_user > 0) {
+        admit_next(exec_state->user());
+    }
     // NOTE: 'exec_state' is desconstructed here without lock
 }
 
+void FragmentMgr::admit_next(const std::string& user) {
+    while (true) {
+        std::shared_ptr<FragmentExecState> exec_state;
+        FinishCallback cb;
+        {
+            std::lock_guard<std::mutex> lock(_admission_lock);
+            auto iter = _admissions.find(user);
+            DCHECK(iter != _admissions.end()) << "user=" << user;
+            UserAdmission& admission = iter->second;
+            if (admission.queued.empty()) {
+                if (--admission.num_running == 0) {
+                    _admissions.erase(iter);
+                }
+                return;
+            }
+            // The slot of the finished fragment is handed over to the queued one
+            exec_state = admission.queued.front().first;
+            cb = admission.queued.front().second;
+            admission.queued.pop_front();
+            --_num_queued_fragments;
+        }
+        Status status = start_fragment(exec_state, cb);
+        if (status.ok()) {
+            return;
+        }
+        LOG(WARNING) << "fail to start queued fragment, instance_id="
+            << exec_state->fragment_instance_id() << ", error=" << status.get_error_msg();
+        exec_state->cancel(PPlanFragmentCancelReason::INTERNAL_ERROR);
+        exec_state->update_status(status);
+        cb(exec_state->executor());
+    }
+}
+
 Status FragmentMgr::exec_plan_fragment(
         const TExecPlanFragmentParams& params) {
     return exec_plan_fragment(params, std::bind<void>(&empty_function, std::placeholders::_1));
@@ -404,7 +450,8 @@ static void* fragment_executor(void* param) {
 
 Status FragmentMgr::exec_plan_fragment(
         const TExecPlanFragmentParams& params,
-        FinishCallback cb) {
+        FinishCallback cb,
+        const std::shared_ptr<FragmentSharedState>& shared_state) {
     const TUniqueId& fragment_instance_id = params.params.fragment_instance_id;
     std::shared_ptr<FragmentExecState> exec_state;
     {
@@ -421,8 +468,7 @@ Status FragmentMgr::exec_plan_fragment(
             params.backend_num,
             _exec_env,
             params.coord));
-    RETURN_IF_ERROR(exec_state->prepare(params));
-    bool use_pool = true;
+    RETURN_IF_ERROR(exec_state->prepare(params, shared_state));
     {
         std::lock_guard<std::mutex> lock(_lock);
         auto iter = _fragment_map.find(fragment_instance_id);
@@ -432,9 +478,81 @@ Status FragmentMgr::exec_plan_fragment(
         }
         // register exec_state before starting exec thread
         _fragment_map.insert(std::make_pair(fragment_instance_id, exec_state));
+    }
 
-        // Now, we the fragement is
-        if (_fragment_map.size() >= config::fragment_pool_thread_num) {
+    if (config::max_running_fragments_per_user > 0) {
+        bool rejected = false;
+        {
+            std::lock_guard<std::mutex> lock(_admission_lock);
+            UserAdmission& admission = _admissions[exec_state->user()];
+            if (admission.num_running < config::max_running_fragments_per_user) {
+                ++admission.num_running;
+            } else if (admission.queued.size() < config::max_queued_fragments_per_user) {
+                // Started by admit_next() once a running fragment of this user finishes.
+                // Still registered, so it can be cancelled and timed out while queued.
+                admission.queued.emplace_back(exec_state, cb);
+                ++_num_queued_fragments;
+                return Status::OK();
+            } else {
+                rejected = true;
+            }
+        }
+        if (rejected) {
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                _fragment_map.erase(fragment_instance_id);
+            }
+            std::stringstream ss;
+            ss << "too many fragments of user '" << exec_state->user()
+                << "' are waiting for admission, limit is "
+                << config::max_queued_fragments_per_user;
+            return Status::InternalError(ss.str());
+        }
+        Status status = start_fragment(exec_state, cb);
+        if (!status.ok()) {
+            admit_next(exec_state->user());
+        }
+        return status;
+    }
+    return start_fragment(exec_state, cb);
+}
+
+Status FragmentMgr::exec_plan_fragment_batch(TExecPlanFragmentBatchParams* params) {
+    if (params->instance_params.size() != params->backend_nums.size()) {
+        std::stringstream ss;
+        ss << "invalid fragment batch, num_instances=" << params->instance_params.size()
+            << ", num_backend_nums=" << params->backend_nums.size();
+        return Status::InternalError(ss.str());
+    }
+    TExecPlanFragmentParams& common = params->common;
+    // Descriptors cache the llvm types of their tuples for one LlvmCodeGen, so only
+    // instances without codegen can share them.
+    std::shared_ptr<FragmentSharedState> shared_state;
+    if (common.query_options.disable_codegen && common.__isset.desc_tbl) {
+        shared_state = std::make_shared<FragmentSharedState>();
+        RETURN_IF_ERROR(DescriptorTbl::create(
+                &shared_state->obj_pool, common.desc_tbl, &shared_state->desc_tbl));
+    }
+    auto cb = std::bind<void>(&empty_function, std::placeholders::_1);
+    for (int i = 0; i < params->instance_params.size(); ++i) {
+        // the instance params are not needed after exec_plan_fragment() returns,
+        // so they are swapped in rather than copied
+        using std::swap;
+        swap(common.params, params->instance_params[i]);
+        common.__isset.params = true;
+        common.__set_backend_num(params->backend_nums[i]);
+        RETURN_IF_ERROR(exec_plan_fragment(common, cb, shared_state));
+    }
+    return Status::OK();
+}
+
+Status FragmentMgr::start_fragment(
+        std::shared_ptr<FragmentExecState> exec_state, FinishCallback cb) {
+    bool use_pool = true;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        // Now, we the fragement is. Fragments waiting for admission don't take threads.
+        if (_fragment_map.size() - _num_queued_fragments >= config::fragment_pool_thread_num) {
             use_pool = false;
         }
     }
@@ -445,7 +563,7 @@ Status FragmentMgr::exec_plan_fragment(
             {
                 // Remove the exec state added
                 std::lock_guard<std::mutex> lock(_lock);
-                _fragment_map.erase(fragment_instance_id);
+                _fragment_map.erase(exec_state->fragment_instance_id());
             }
             return Status::InternalError("Put planfragment to failed.");
         }
@@ -461,6 +579,10 @@ Status FragmentMgr::exec_plan_fragment(
             err_msg.append(strerror(ret));
             err_msg.append(",");
             err_msg.append(std::to_string(ret));
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                _fragment_map.erase(exec_state->fragment_instance_id());
+            }
             return Status::InternalError(err_msg);
         }
         pthread_detach(id);
@@ -491,6 +613,25 @@ void FragmentMgr::cancel_worker() {
     while (!_stop) {
         std::vector<TUniqueId> to_delete;
         DateTimeValue now = DateTimeValue::local_time();
+        {
+            std::lock_guard<std::mutex> lock(_shared_hash_tables_lock);
+            auto query_it = _shared_hash_tables.begin();
+            while (query_it != _shared_hash_tables.end()) {
+                auto& node_tables = query_it->second;
+                for (auto it = node_tables.begin(); it != node_tables.end();) {
+                    if (it->second.expired()) {
+                        it = node_tables.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                if (node_tables.empty()) {
+                    query_it = _shared_hash_tables.erase(query_it);
+                } else {
+                    ++query_it;
+                }
+            }
+        }
         {
             std::lock_guard<std::mutex> lock(_lock);
             for (auto& it : _fragment_map) {
@@ -510,6 +651,21 @@ void FragmentMgr::cancel_worker() {
     LOG(INFO) << "FragmentMgr cancel worker is going to exit.";
 }
 
+std::shared_ptr<SharedHashTableCtx> FragmentMgr::get_shared_hash_table(
+        const TUniqueId& query_id, int node_id, int64_t mem_limit,
+        MemTracker* parent, bool* is_builder) {
+    std::lock_guard<std::mutex> lock(_shared_hash_tables_lock);
+    std::weak_ptr<SharedHashTableCtx>& entry = _shared_hash_tables[query_id][node_id];
+    std::shared_ptr<SharedHashTableCtx> ctx = entry.lock();
+    *is_builder = (ctx == nullptr);
+    if (ctx == nullptr) {
+        // Either the first instance or all earlier ones are done already.
+        ctx = std::make_shared<SharedHashTableCtx>(mem_limit, parent);
+        entry = ctx;
+    }
+    return ctx;
+}
+
 Status FragmentMgr::trigger_profile_report(const PTriggerProfileReportRequest* request) {
     if (request->instance_ids_size() > 0) {
         for (int i = 0; i < request->instance_ids_size(); i++) {
@@ -541,6 +697,13 @@ void FragmentMgr::debug(std::stringstream& ss) {
     std::lock_guard<std::mutex> lock(_lock);
 
     ss << "FragmentMgr have " << _fragment_map.size() << " jobs.\n";
+    {
+        std::lock_guard<std::mutex> admission_lock(_admission_lock);
+        for (auto& it : _admissions) {
+            ss << "user '" << it.first << "' has " << it.second.num_running
+                << " running and " << it.second.queued.size() << " queued jobs.\n";
+        }
+    }
     ss << "job_id\t\tstart_time\t\texecute_time(s)\n";
     DateTimeValue now = DateTimeValue::local_time();
     for (auto& it : _fragment_map) {
@@ -18,6 +18,8 @@
 #ifndef DORIS_BE_RUNTIME_FRAGMENT_MGR_H
 #define DORIS_BE_RUNTIME_FRAGMENT_MGR_H
 
+#include <atomic>
+#include <deque>
 #include <mutex>
 #include <memory>
 #include <unordered_map>
@@ -37,9 +39,13 @@ namespace doris {
 
 class ExecEnv;
 class FragmentExecState;
+class MemTracker;
 class TExecPlanFragmentParams;
+class TExecPlanFragmentBatchParams;
+struct FragmentSharedState;
 class TUniqueId;
 class PlanFragmentExecutor;
+class SharedHashTableCtx;
 
 std::string to_load_error_http_path(const std::string& file_name);
 
@@ -55,7 +61,13 @@ public:
     Status exec_plan_fragment(const TExecPlanFragmentParams& params);
 
     // TODO(zc): report this is over
-    Status exec_plan_fragment(const TExecPlanFragmentParams& params, FinishCallback cb);
+    Status exec_plan_fragment(const TExecPlanFragmentParams& params, FinishCallback cb,
+                              const std::shared_ptr<FragmentSharedState>& shared_state = nullptr);
+
+    // execute the instances of one plan fragment, whose common params are
+    // deserialized once and whose descriptor table is shared if possible.
+    // 'params' is modified to build the params of each instance in place.
+    Status exec_plan_fragment_batch(TExecPlanFragmentBatchParams* params);
 
     Status cancel(const TUniqueId& fragment_id) {
         return cancel(fragment_id, PPlanFragmentCancelReason::INTERNAL_ERROR);
@@ -74,10 +86,32 @@ public:
     // execute external query, all query info are packed in TScanOpenParams
     Status exec_external_plan_fragment(const TScanOpenParams& params, const TUniqueId& fragment_instance_id, std::vector<TScanColumnDesc>* selected_columns);
 
+    // Returns the build side that the instances of 'query_id' on this backend share for
+    // the broadcast join 'node_id'. Sets 'is_builder' to true for the caller which
+    // created it, who has to build the hash table. The build side lives as long as any
+    // instance holds it, 'mem_limit' and 'parent' are only used to create it.
+    std::shared_ptr<SharedHashTableCtx> get_shared_hash_table(
+            const TUniqueId& query_id, int node_id, int64_t mem_limit,
+            MemTracker* parent, bool* is_builder);
+
 private:
     void exec_actual(std::shared_ptr<FragmentExecState> exec_state,
                      FinishCallback cb);
 
+    // Runs 'exec_state' on the thread pool, or on a new thread if the pool is busy.
+    // 'exec_state' must be registered in _fragment_map, it is removed on failure.
+    Status start_fragment(std::shared_ptr<FragmentExecState> exec_state, FinishCallback cb);
+
+    // Gives the running slot of a finished fragment of 'user' to the next queued
+    // fragment of that user, if any.
+    void admit_next(const std::string& user);
+
+    // Admission state of the fragments of one resource user.
+    struct UserAdmission {
+        int num_running = 0;
+        std::deque<std::pair<std::shared_ptr<FragmentExecState>, FinishCallback>> queued;
+    };
+
     // This is input params
     ExecEnv* _exec_env;
 
@@ -86,12 +120,26 @@ private:
     // Make sure that remove this before no data reference FragmentExecState
     std::unordered_map<TUniqueId, std::shared_ptr<FragmentExecState>> _fragment_map;
 
+    // Shared build sides of broadcast joins by query id and join node id. Expired ones
+    // are erased by cancel_worker().
+    std::mutex _shared_hash_tables_lock;
+    std::unordered_map<TUniqueId, std::unordered_map<int, std::weak_ptr<SharedHashTableCtx>>>
+        _shared_hash_tables;
+
+    // Admission state by resource user, only used if
+    // config::max_running_fragments_per_user > 0. Taken after _lock if both are held.
+    std::mutex _admission_lock;
+    std::unordered_map<std::string, UserAdmission> _admissions;
+
     // Cancel thread
     bool _stop;
     std::thread _cancel_thread;
     // every job is a pool
     ThreadPool _thread_pool;
 
+    // Number of fragments in _admissions queues, they are also in _fragment_map.
+    std::atomic<int> _num_queued_fragments;
+
 };
 
 }
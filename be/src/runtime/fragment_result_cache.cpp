@@ -0,0 +1,172 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/fragment_result_cache.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include "common/logging.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "util/md5.h"
+#include "util/thrift_util.h"
+
+namespace doris {
+
+FragmentResultCache* FragmentResultCache::_s_instance = nullptr;
+
+// functions whose results differ between executions of the same plan
+static const char* const kNondeterministicFunctions[] = {
+    "rand", "random", "uuid", "sleep", "now", "current_timestamp", "localtime",
+    "localtimestamp", "curdate", "current_date", "curtime", "current_time",
+    "utc_timestamp", "unix_timestamp"
+};
+
+static bool is_deterministic(const std::vector<TExpr>& exprs) {
+    for (auto& expr : exprs) {
+        for (auto& node : expr.nodes) {
+            if (!node.__isset.fn) {
+                continue;
+            }
+            for (const char* name : kNondeterministicFunctions) {
+                if (node.fn.name.function_name == name) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void FragmentResultCache::create_global_cache(size_t capacity) {
+    DCHECK(_s_instance == nullptr);
+    if (capacity == 0) {
+        return;
+    }
+    static FragmentResultCache instance(capacity);
+    _s_instance = &instance;
+}
+
+FragmentResultCache::FragmentResultCache(size_t capacity)
+        : _cache(new_lru_cache(capacity)) {
+}
+
+std::string FragmentResultCache::make_key(const TExecPlanFragmentParams& request) {
+    if (!request.query_options.enable_fragment_result_cache
+            || !request.fragment.__isset.output_sink
+            || request.fragment.output_sink.type != TDataSinkType::DATA_STREAM_SINK) {
+        return "";
+    }
+    const std::vector<TPlanNode>& nodes = request.fragment.plan.nodes;
+    if (nodes.empty() || nodes[0].node_type != TPlanNodeType::AGGREGATION_NODE) {
+        return "";
+    }
+    int olap_scan_node_id = -1;
+    for (auto& node : nodes) {
+        if (!is_deterministic(node.conjuncts)) {
+            return "";
+        }
+        if (node.node_type == TPlanNodeType::AGGREGATION_NODE) {
+            if (!is_deterministic(node.agg_node.aggregate_functions)
+                    || !is_deterministic(node.agg_node.grouping_exprs)) {
+                return "";
+            }
+        } else if (node.node_type == TPlanNodeType::OLAP_SCAN_NODE && olap_scan_node_id == -1) {
+            olap_scan_node_id = node.node_id;
+        } else {
+            return "";
+        }
+    }
+    if (olap_scan_node_id == -1 || !is_deterministic(request.fragment.output_exprs)) {
+        return "";
+    }
+
+    // (tablet id, version, version hash) of the scanned tablets
+    std::vector<std::tuple<int64_t, int64_t, int64_t>> tablets;
+    auto it = request.params.per_node_scan_ranges.find(olap_scan_node_id);
+    if (it != request.params.per_node_scan_ranges.end()) {
+        for (auto& scan_range : it->second) {
+            const TPaloScanRange& palo_range = scan_range.scan_range.palo_scan_range;
+            tablets.emplace_back(palo_range.tablet_id,
+                                 strtoll(palo_range.version.c_str(), nullptr, 10),
+                                 strtoll(palo_range.version_hash.c_str(), nullptr, 10));
+        }
+    }
+    std::sort(tablets.begin(), tablets.end());
+
+    // The descriptors are in the digest because the layout of cached batches
+    // depends on them. Slot and tuple ids are assigned by the planner in the
+    // same order every time, so identical queries get identical digests.
+    ThriftSerializer serializer(false, 4096);
+    std::string buf;
+    Md5Digest digest;
+    if (!serializer.serialize(&request.fragment.plan, &buf).ok()) {
+        return "";
+    }
+    digest.update(buf.data(), buf.size());
+    if (!serializer.serialize(&request.desc_tbl, &buf).ok()) {
+        return "";
+    }
+    digest.update(buf.data(), buf.size());
+    for (auto& expr : request.fragment.output_exprs) {
+        if (!serializer.serialize(&expr, &buf).ok()) {
+            return "";
+        }
+        digest.update(buf.data(), buf.size());
+    }
+    // results of date and time functions depend on the time zone
+    if (request.query_globals.__isset.time_zone) {
+        digest.update(request.query_globals.time_zone.data(),
+                      request.query_globals.time_zone.size());
+    }
+    digest.digest();
+
+    std::string key = digest.hex();
+    for (auto& tablet : tablets) {
+        key.append((const char*)&std::get<0>(tablet), sizeof(int64_t));
+        key.append((const char*)&std::get<1>(tablet), sizeof(int64_t));
+        key.append((const char*)&std::get<2>(tablet), sizeof(int64_t));
+    }
+    return key;
+}
+
+std::shared_ptr<const FragmentResult> FragmentResultCache::lookup(const std::string& key) {
+    Cache::Handle* handle = _cache->lookup(CacheKey(key));
+    if (handle == nullptr) {
+        return nullptr;
+    }
+    std::shared_ptr<const FragmentResult> result =
+        *reinterpret_cast<std::shared_ptr<const FragmentResult>*>(_cache->value(handle));
+    _cache->release(handle);
+    return result;
+}
+
+static void delete_result(const CacheKey& key, void* value) {
+    delete reinterpret_cast<std::shared_ptr<const FragmentResult>*>(value);
+}
+
+void FragmentResultCache::insert(const std::string& key,
+                                 std::shared_ptr<const FragmentResult> result) {
+    size_t charge = result->bytes + key.size();
+    auto value = new std::shared_ptr<const FragmentResult>(std::move(result));
+    Cache::Handle* handle = _cache->insert(CacheKey(key), value, charge, &delete_result);
+    _cache->release(handle);
+}
+
+} // end namespace doris
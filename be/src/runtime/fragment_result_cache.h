@@ -0,0 +1,75 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_RUNTIME_FRAGMENT_RESULT_CACHE_H
+#define DORIS_BE_RUNTIME_FRAGMENT_RESULT_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gen_cpp/data.pb.h"
+#include "olap/lru_cache.h"
+
+namespace doris {
+
+class TExecPlanFragmentParams;
+
+// Output batches of a fragment instance, as they were passed to its sink
+struct FragmentResult {
+    std::vector<PRowBatch> batches;
+    size_t bytes = 0;
+};
+
+// Cache for the outputs of fragment instances which aggregate data of olap
+// tablets, e.g. the first phase aggregation of dashboards, which are run
+// again and again over partitions that seldom change.
+//
+// The key is made of the digest of the plan fragment and the (tablet id,
+// version) of every scanned tablet. A load bumps the version of its tablets,
+// so later queries read with new keys and the stale entries are evicted by
+// LRU, thus there is no explicit invalidation.
+class FragmentResultCache {
+public:
+    // Create global instance of this class, the cache is disabled if capacity is 0
+    static void create_global_cache(size_t capacity);
+
+    // Return global instance, nullptr if the cache is disabled
+    static FragmentResultCache* instance() { return _s_instance; }
+
+    FragmentResultCache(size_t capacity);
+
+    // Return the key of the result of the fragment instance, or an empty
+    // string if the result can't be cached: only fragments whose root is an
+    // aggregation over an olap scan, without nondeterministic functions like
+    // rand() and now(), and sink to a data stream are cached.
+    static std::string make_key(const TExecPlanFragmentParams& request);
+
+    // Return nullptr if not found
+    std::shared_ptr<const FragmentResult> lookup(const std::string& key);
+
+    void insert(const std::string& key, std::shared_ptr<const FragmentResult> result);
+
+private:
+    static FragmentResultCache* _s_instance;
+
+    std::unique_ptr<Cache> _cache;
+};
+
+} // end namespace doris
+
+#endif // DORIS_BE_RUNTIME_FRAGMENT_RESULT_CACHE_H
@@ -17,6 +17,7 @@
 
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/memory/chunk_allocator.h"
 #include "util/bit_util.h"
 #include "util/doris_metrics.h"
 
@@ -55,11 +56,20 @@ MemPool::ChunkInfo::ChunkInfo(int64_t size, uint8_t* buf)
    DorisMetrics::memory_pool_bytes_total.increment(size);
 }
 
+void MemPool::free_chunk(const ChunkInfo& chunk) {
+  // Chunks may be reused by any pool, don't let it see our poisoned region
+  ASAN_UNPOISON_MEMORY_REGION(chunk.data, chunk.size);
+  Chunk released;
+  released.data = chunk.data;
+  released.size = chunk.size;
+  ChunkAllocator::instance()->free(released);
+}
+
 MemPool::~MemPool() {
   int64_t total_bytes_released = 0;
   for (size_t i = 0; i < chunks_.size(); ++i) {
     total_bytes_released += chunks_[i].size;
-    free(chunks_[i].data);
+    free_chunk(chunks_[i]);
   }
  
   mem_tracker_->release(total_bytes_released);
@@ -85,7 +95,7 @@ void MemPool::free_all() {
   int64_t total_bytes_released = 0;
   for (auto& chunk: chunks_) {
     total_bytes_released += chunk.size;
-    free(chunk.data);
+    free_chunk(chunk);
   }
   chunks_.clear();
   next_chunk_size_ = INITIAL_CHUNK_SIZE;
@@ -141,12 +151,13 @@ bool MemPool::FindChunk(size_t min_size, bool check_limits) {
     mem_tracker_->consume(chunk_size);
   }
 
-  // Allocate a new chunk. Return early if malloc fails.
-  uint8_t* buf = reinterpret_cast<uint8_t*>(malloc(chunk_size));
-  if (UNLIKELY(buf == NULL)) {
+  // Allocate a new chunk. Return early if allocate fails.
+  Chunk chunk;
+  if (UNLIKELY(!ChunkAllocator::instance()->allocate(chunk_size, &chunk))) {
     mem_tracker_->release(chunk_size);
     return false;
   }
+  uint8_t* buf = chunk.data;
 
   ASAN_POISON_MEMORY_REGION(buf, chunk_size);
 
@@ -233,6 +233,9 @@ class MemPool {
   /// new chunk exceeds the mem limits.
   bool FindChunk(size_t min_size, bool check_limits);
 
+  /// Gives the memory of 'chunk' back to the ChunkAllocator.
+  static void free_chunk(const ChunkInfo& chunk);
+
   /// Check integrity of the supporting data structures; always returns true but DCHECKs
   /// all invariants.
   /// If 'check_current_chunk_empty' is true, checks that the current chunk contains no
@@ -267,7 +270,8 @@ class MemPool {
       }
     }
 
-    // If we couldn't allocate a new chunk, return NULL. malloc() guarantees alignment
+    // If we couldn't allocate a new chunk, return NULL. Chunks come from malloc() or
+    // mmap(), which guarantee alignment
     // of alignof(std::max_align_t), so we do not need to do anything additional to
     // guarantee alignment.
     //static_assert(
@@ -113,6 +113,11 @@ void MemTracker::Init() {
 
 // TODO chenhao , set MemTracker close state
 void MemTracker::close() {
+    // _consumption may be owned by a profile which outlives this tracker, flush the
+    // buffered bytes so that it shows the final value.
+    for (int i = 0; i < _pending_bytes.size(); ++i) {
+        _consumption->add(__sync_lock_test_and_set(_pending_bytes.access_at_core(i), 0));
+    }
 }
 
 void MemTracker::enable_reservation_reporting(const ReservationTrackerCounters& counters) {
@@ -183,7 +188,7 @@ MemTracker* MemTracker::CreateQueryMemTracker(const TUniqueId& id,
 }
 
 MemTracker::~MemTracker() {
-    DCHECK_EQ(_consumption->current_value(), 0) << _label << "\n"
+    DCHECK_EQ(consumption(), 0) << _label << "\n"
         << get_stack_trace() << "\n"
         << LogUsage("");
     // TODO chenhao
@@ -24,7 +24,9 @@
 #include <mutex>
 #include <unordered_map>
 
+#include "common/config.h"
 #include "gen_cpp/Types_types.h"
+#include "util/core_local.h"
 #include "util/metrics.h"
 #include "util/runtime_profile.h"
 #include "util/spinlock.h"
@@ -135,10 +137,7 @@ public:
         }
         for (std::vector<MemTracker*>::iterator tracker = _all_trackers.begin();
              tracker != _all_trackers.end(); ++tracker) {
-            (*tracker)->_consumption->add(bytes);
-            if ((*tracker)->_consumption_metric == NULL) {
-                DCHECK_GE((*tracker)->_consumption->current_value(), 0);
-            }
+            (*tracker)->add_batched(bytes);
         }
     }
 
@@ -181,10 +180,14 @@ public:
                 // there are concurrent consumers because we don't take a lock before trying to
                 // update _consumption.
                 while (true) {
-                    if (LIKELY(tracker->_consumption->try_add(bytes, limit))) break;
+                    // The bytes buffered per core are part of the consumption too
+                    if (LIKELY(tracker->_consumption->try_add(
+                                bytes, limit - tracker->pending_bytes()))) {
+                        break;
+                    }
 
                     VLOG_RPC << "TryConsume failed, bytes=" << bytes
-                        << " consumption=" << tracker->_consumption->current_value()
+                        << " consumption=" << tracker->consumption()
                         << " limit=" << limit << " attempting to GC";
                     if (UNLIKELY(tracker->GcMemory(limit - bytes))) {
                         DCHECK_GE(i, 0);
@@ -195,7 +198,7 @@ public:
                         return false;
                     }
                     VLOG_RPC << "GC succeeded, TryConsume bytes=" << bytes
-                        << " consumption=" << tracker->_consumption->current_value()
+                        << " consumption=" << tracker->consumption()
                         << " limit=" << limit;
                 }
             }
@@ -218,17 +221,10 @@ public:
         }
         for (std::vector<MemTracker*>::iterator tracker = _all_trackers.begin();
              tracker != _all_trackers.end(); ++tracker) {
-            (*tracker)->_consumption->add(-bytes);
-            /// If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
-            /// reported amount, the subsequent call to FunctionContext::Free() may cause the
-            /// process mem tracker to go negative until it is synced back to the tcmalloc
-            /// metric. Don't blow up in this case. (Note that this doesn't affect non-process
-            /// trackers since we can enforce that the reported memory usage is internally
-            /// consistent.)
-            if ((*tracker)->_consumption_metric == NULL) {
-                DCHECK_GE((*tracker)->_consumption->current_value(), 0)
-                    << std::endl << (*tracker)->LogUsage();
-            }
+            // Consumption is no longer checked to be non-negative here: a release
+            // buffered on one core may reach the counter before the consume buffered
+            // on another one. The d'tor still checks that everything was released.
+            (*tracker)->add_batched(-bytes);
         }
 
         /// TODO: Release brokered memory?
@@ -302,7 +298,7 @@ public:
     int64_t GetPoolMemReserved() const;
 
     int64_t consumption() const {
-        return _consumption->current_value();;
+        return _consumption->current_value() + pending_bytes();
     }
 
 
@@ -372,7 +368,7 @@ public:
     std::string debug_string() {
         std::stringstream msg;
         msg << "limit: " << _limit << "; "
-            << "consumption: " << _consumption->current_value() << "; "
+            << "consumption: " << consumption() << "; "
             << "label: " << _label << "; "
             << "all tracker size: " << _all_trackers.size() << "; "
             << "limit trackers size: " << _limit_trackers.size() << "; "
@@ -395,6 +391,31 @@ private:
     // Walks the MemTracker hierarchy and populates _all_trackers and _limit_trackers
     void Init();
 
+    // Adds 'bytes' to the buffer of the current core, and moves the buffer into
+    // _consumption once it holds config::mem_tracker_consume_batch_bytes or more.
+    // Larger deltas go to _consumption directly.
+    void add_batched(int64_t bytes) {
+        const int64_t batch_bytes = config::mem_tracker_consume_batch_bytes;
+        if (bytes >= batch_bytes || bytes <= -batch_bytes) {
+            _consumption->add(bytes);
+            return;
+        }
+        int64_t* pending = _pending_bytes.access();
+        int64_t value = __sync_add_and_fetch(pending, bytes);
+        if (UNLIKELY(value >= batch_bytes || value <= -batch_bytes)) {
+            _consumption->add(__sync_lock_test_and_set(pending, 0));
+        }
+    }
+
+    // Sum of the bytes buffered on all cores and not yet in _consumption.
+    int64_t pending_bytes() const {
+        int64_t sum = 0;
+        for (int i = 0; i < _pending_bytes.size(); ++i) {
+            sum += *_pending_bytes.access_at_core(i);
+        }
+        return sum;
+    }
+
     // Adds tracker to _child_trackers
     void add_child_tracker(MemTracker* tracker) {
         std::lock_guard<std::mutex> l(_child_trackers_lock);
@@ -438,6 +459,12 @@ private:
     /// holds _consumption counter if not tied to a profile
     RuntimeProfile::HighWaterMarkCounter _local_counter;
 
+    /// Per core consume()/release() deltas not yet added to _consumption. Threads on
+    /// different cores would otherwise keep stealing the cache line of _consumption
+    /// from each other, which hurts most on the process and query trackers shared by
+    /// all fragment threads. consumption() includes these bytes.
+    CoreLocalValue<int64_t> _pending_bytes;
+
     /// If non-NULL, used to measure consumption (in bytes) rather than the values provided
     /// to Consume()/Release(). Only used for the process tracker, thus parent_ should be
     /// NULL if _consumption_metric is set.
@@ -0,0 +1,175 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/memory/chunk_allocator.h"
+
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#include "common/compiler_util.h"
+#include "common/config.h"
+#include "common/logging.h"
+#include "util/bit_util.h"
+#include "util/cpu_info.h"
+#include "util/spinlock.h"
+
+namespace doris {
+
+static const int64_t HUGE_PAGE_SIZE = 2LL * 1024 * 1024;
+
+// Only chunks of these sizes are kept in the free lists
+static inline bool is_pooled_size(size_t size) {
+    return size > 0 && BitUtil::IsPowerOf2(size);
+}
+
+// Free lists of one core, indexed by the log2 of the chunk size.
+class ChunkArena {
+public:
+    ChunkArena() : _chunk_lists(64) { }
+
+    bool pop_free_chunk(size_t size, uint8_t** data) {
+        int idx = BitUtil::Log2Ceiling64(size);
+        std::lock_guard<SpinLock> l(_lock);
+        std::vector<uint8_t*>& free_chunks = _chunk_lists[idx];
+        if (free_chunks.empty()) {
+            return false;
+        }
+        *data = free_chunks.back();
+        free_chunks.pop_back();
+        return true;
+    }
+
+    void push_free_chunk(uint8_t* data, size_t size) {
+        int idx = BitUtil::Log2Ceiling64(size);
+        std::lock_guard<SpinLock> l(_lock);
+        _chunk_lists[idx].push_back(data);
+    }
+
+    const std::vector<std::vector<uint8_t*>>& chunk_lists() const { return _chunk_lists; }
+
+private:
+    SpinLock _lock;
+    std::vector<std::vector<uint8_t*>> _chunk_lists;
+    // Keeps the locks of two cores out of the same cache line.
+    char _padding[CACHE_LINE_SIZE];
+};
+
+ChunkAllocator* ChunkAllocator::instance() {
+    // Never destroyed, pools may still free chunks while the process exits
+    static ChunkAllocator* s_instance = new ChunkAllocator(config::chunk_reserved_bytes_limit);
+    return s_instance;
+}
+
+ChunkAllocator::ChunkAllocator(int64_t reserve_limit)
+        : _reserve_limit(reserve_limit),
+        _use_mmap(config::mmap_buffers),
+        _reserved_bytes(0) {
+    int num_arenas = std::max<int>(1, std::thread::hardware_concurrency());
+    for (int i = 0; i < num_arenas; ++i) {
+        _arenas.emplace_back(new ChunkArena());
+    }
+}
+
+ChunkAllocator::~ChunkAllocator() {
+    for (auto& arena : _arenas) {
+        const std::vector<std::vector<uint8_t*>>& chunk_lists = arena->chunk_lists();
+        for (size_t idx = 0; idx < chunk_lists.size(); ++idx) {
+            for (uint8_t* data : chunk_lists[idx]) {
+                free_to_system(data, 1ULL << idx);
+            }
+        }
+    }
+}
+
+ChunkArena* ChunkAllocator::current_arena() const {
+    return _arenas[CpuInfo::get_current_core() % _arenas.size()].get();
+}
+
+bool ChunkAllocator::allocate(size_t size, Chunk* chunk) {
+    chunk->size = size;
+    if (!is_pooled_size(size)) {
+        chunk->data = allocate_from_system(size);
+        return chunk->data != nullptr;
+    }
+    ChunkArena* arena = current_arena();
+    if (arena->pop_free_chunk(size, &chunk->data)) {
+        _reserved_bytes.fetch_sub(size, std::memory_order_relaxed);
+        return true;
+    }
+    // Only bother the other cores if there may be a chunk to take
+    if (reserved_bytes() >= static_cast<int64_t>(size)) {
+        for (auto& other : _arenas) {
+            if (other.get() != arena && other->pop_free_chunk(size, &chunk->data)) {
+                _reserved_bytes.fetch_sub(size, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    chunk->data = allocate_from_system(size);
+    return chunk->data != nullptr;
+}
+
+void ChunkAllocator::free(const Chunk& chunk) {
+    const int64_t size = chunk.size;
+    int64_t old_reserved = reserved_bytes();
+    do {
+        if (!is_pooled_size(chunk.size) || old_reserved + size > _reserve_limit) {
+            free_to_system(chunk.data, chunk.size);
+            return;
+        }
+    } while (!_reserved_bytes.compare_exchange_weak(old_reserved, old_reserved + size));
+    // The chunk goes to the core of the thread freeing it, which is likely to allocate
+    // again soon.
+    current_arena()->push_free_chunk(chunk.data, chunk.size);
+}
+
+uint8_t* ChunkAllocator::allocate_from_system(size_t size) {
+    if (!_use_mmap) {
+        return reinterpret_cast<uint8_t*>(malloc(size));
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (data == MAP_FAILED) {
+        LOG(WARNING) << "failed to mmap chunk, size=" << size << ", errno=" << errno;
+        return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    if (config::madvise_huge_pages && size % HUGE_PAGE_SIZE == 0) {
+        // Only a hint, chunks are still usable if the kernel doesn't take it.
+        int rc;
+        do {
+            rc = madvise(data, size, MADV_HUGEPAGE);
+        } while (rc == -1 && errno == EAGAIN);
+    }
+#endif
+    return reinterpret_cast<uint8_t*>(data);
+}
+
+void ChunkAllocator::free_to_system(uint8_t* data, size_t size) {
+    if (!_use_mmap) {
+        ::free(data);
+        return;
+    }
+    int rc = munmap(data, size);
+    DCHECK_EQ(rc, 0) << "Unexpected munmap() error: " << errno;
+}
+
+}
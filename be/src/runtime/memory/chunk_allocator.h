@@ -0,0 +1,81 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace doris {
+
+class ChunkArena;
+
+// A block of memory handed out by ChunkAllocator.
+struct Chunk {
+    uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// Process wide allocator of the chunks backing MemPool and Arena. Short queries create
+// and destroy lots of pools, so freed chunks are kept in free lists, one per power of
+// two size, each core having its own lists. A chunk is taken from the lists of the
+// current core, then from the other cores, and only then from the system (malloc, or
+// mmap if config::mmap_buffers is set). At most 'reserve_limit' bytes are kept in the
+// lists, chunks freed past that go back to the system. Chunks whose size is not a
+// power of two are never kept.
+//
+// This class is thread-safe.
+class ChunkAllocator {
+public:
+    // The allocator shared by the whole process, its reserve limit is
+    // config::chunk_reserved_bytes_limit.
+    static ChunkAllocator* instance();
+
+    ChunkAllocator(int64_t reserve_limit);
+    ~ChunkAllocator();
+
+    // Allocates a chunk of 'size' bytes. Returns false if the system is out of memory.
+    bool allocate(size_t size, Chunk* chunk);
+
+    // Gives 'chunk' back, its memory may be returned by a later allocate() of the
+    // same size.
+    void free(const Chunk& chunk);
+
+    // Bytes of the free chunks kept by this allocator.
+    int64_t reserved_bytes() const {
+        return _reserved_bytes.load(std::memory_order_relaxed);
+    }
+
+private:
+    uint8_t* allocate_from_system(size_t size);
+    void free_to_system(uint8_t* data, size_t size);
+
+    ChunkArena* current_arena() const;
+
+    const int64_t _reserve_limit;
+    // Taken from config::mmap_buffers once, so that chunks are freed the way they were
+    // allocated even if the config is changed.
+    const bool _use_mmap;
+    std::atomic<int64_t> _reserved_bytes;
+    std::vector<std::unique_ptr<ChunkArena>> _arenas;
+};
+
+}
@@ -70,79 +70,107 @@ Status MemoryScratchSink::send(RuntimeState* state, RowBatch* batch) {
     if (NULL == batch || 0 == batch->num_rows()) {
         return Status::OK();
     }
-    Status status;
-    // convert one batch
+    // convert one batch column by column, so that the type of a column is resolved once
+    // per batch and its values are appended to one vector at a time
     std::shared_ptr<TScanRowBatch> t_scan_row_batch = std::make_shared<TScanRowBatch>();
     t_scan_row_batch->__set_num_rows(batch->num_rows());
     int num_columns = _output_expr_ctxs.size();
-    std::vector<TScanColumnData> cols;
-    for (int i =0 ; i < num_columns; i++) {
-        TScanColumnData all_col_data;
-        cols.push_back(all_col_data);
-    }
-    t_scan_row_batch->__set_cols(std::move(cols));
-    for (int i = 0; status.ok() && i < batch->num_rows(); ++i) {
-        TupleRow* row = batch->get_row(i);
-        status = add_per_col(state, row, t_scan_row_batch);
+    std::vector<TScanColumnData> cols(num_columns);
+    for (int i = 0; i < num_columns; ++i) {
+        Status status = add_column(state, i, batch, &cols[i]);
         if (!status.ok()) {
             return Status::InternalError("convert row failed");
         }
     }
+    t_scan_row_batch->__set_cols(std::move(cols));
     _queue->blocking_put(t_scan_row_batch);
     return Status::OK();
 }
 
-// add all col data for TScanRowBatch
-Status MemoryScratchSink::add_per_col(RuntimeState* state, TupleRow* row, std::shared_ptr<TScanRowBatch> result) {
-    int num_cols = _output_expr_ctxs.size();
-    for (int i = 0; i < num_cols; ++i) {
-        void* item = _output_expr_ctxs[i]->get_value(row);
+// add the data of column i of all rows in batch to col
+Status MemoryScratchSink::add_column(RuntimeState* state, int i, RowBatch* batch,
+                                     TScanColumnData* col) {
+    ExprContext* ctx = _output_expr_ctxs[i];
+    int num_rows = batch->num_rows();
+    col->is_null.reserve(num_rows);
+    switch (ctx->root()->type().type) {
+        case TYPE_BOOLEAN:
+        case TYPE_TINYINT:
+            col->__isset.byte_vals = true;
+            col->byte_vals.reserve(num_rows);
+            break;
+        case TYPE_SMALLINT:
+            col->__isset.short_vals = true;
+            col->short_vals.reserve(num_rows);
+            break;
+        case TYPE_INT:
+            col->__isset.int_vals = true;
+            col->int_vals.reserve(num_rows);
+            break;
+        case TYPE_BIGINT:
+        case TYPE_DATE:
+        case TYPE_DATETIME:
+            col->__isset.long_vals = true;
+            col->long_vals.reserve(num_rows);
+            break;
+        case TYPE_FLOAT:
+        case TYPE_DOUBLE:
+            col->__isset.double_vals = true;
+            col->double_vals.reserve(num_rows);
+            break;
+        case TYPE_LARGEINT:
+        case TYPE_TIME:
+        case TYPE_VARCHAR:
+        case TYPE_HLL:
+        case TYPE_CHAR:
+        case TYPE_DECIMAL:
+        case TYPE_DECIMALV2:
+            col->__isset.string_vals = true;
+            col->string_vals.reserve(num_rows);
+            break;
+        default: {
+            LOG(WARNING) << "can't convert this type. type = " << ctx->root()->type();
+            return Status::InternalError("unsupported column type");
+        }
+    }
+
+    for (int j = 0; j < num_rows; ++j) {
+        void* item = ctx->get_value(batch->get_row(j));
+        col->is_null.push_back(item == nullptr);
         if (item == nullptr) {
-            result->cols[i].is_null.push_back(true);
             continue;
-        } else {
-            result->cols[i].is_null.push_back(false);
         }
-        switch (_output_expr_ctxs[i]->root()->type().type) {
+        switch (ctx->root()->type().type) {
             case TYPE_BOOLEAN:
             case TYPE_TINYINT:
-                result->cols[i].__isset.byte_vals = true;
-                result->cols[i].byte_vals.push_back(*static_cast<int8_t*>(item));
+                col->byte_vals.push_back(*static_cast<int8_t*>(item));
                 break;
             case TYPE_SMALLINT:
-                result->cols[i].__isset.short_vals = true;
-                result->cols[i].short_vals.push_back(*static_cast<int16_t*>(item));
+                col->short_vals.push_back(*static_cast<int16_t*>(item));
                 break;
             case TYPE_INT:
-                result->cols[i].__isset.int_vals = true;
-                result->cols[i].int_vals.push_back(*static_cast<int32_t*>(item));
+                col->int_vals.push_back(*static_cast<int32_t*>(item));
                 break;
             case TYPE_BIGINT:
-                result->cols[i].__isset.long_vals = true;
-                result->cols[i].long_vals.push_back(*static_cast<int64_t*>(item));
+                col->long_vals.push_back(*static_cast<int64_t*>(item));
                 break;
             case TYPE_LARGEINT: {
                 char buf[48];
                 int len = 48;
-                char* v = LargeIntValue::to_string(reinterpret_cast<const PackedInt128*>(item)->value, buf, &len);
-                std::string temp(v, len);
-                result->cols[i].__isset.string_vals = true;
-                result->cols[i].string_vals.push_back(std::move(temp));
+                char* v = LargeIntValue::to_string(
+                        reinterpret_cast<const PackedInt128*>(item)->value, buf, &len);
+                col->string_vals.emplace_back(v, len);
                 break;
             }
             case TYPE_FLOAT:
-                result->cols[i].__isset.double_vals = true;
-                result->cols[i].double_vals.push_back(*static_cast<float*>(item));
+                col->double_vals.push_back(*static_cast<float*>(item));
                 break;
             case TYPE_DOUBLE:
-                result->cols[i].__isset.double_vals = true;
-                result->cols[i].double_vals.push_back(*static_cast<double*>(item));         
+                col->double_vals.push_back(*static_cast<double*>(item));
                 break;
             case TYPE_TIME: {
                 double time = *static_cast<double *>(item);
-                std::string time_str = time_str_from_int((int) time);
-                result->cols[i].__isset.string_vals = true;
-                result->cols[i].string_vals.push_back(std::move(time_str));
+                col->string_vals.push_back(time_str_from_int((int) time));
                 break;
             }
             case TYPE_DATE:
@@ -150,10 +178,9 @@ Status MemoryScratchSink::add_per_col(RuntimeState* state, TupleRow* row, std::s
                 const DateTimeValue* time_val = (const DateTimeValue*)(item);
                 int64_t ts = 0;
                 if (time_val->unix_timestamp(&ts, state->timezone())) {
-                    result->cols[i].__isset.long_vals = true;
-                    result->cols[i].long_vals.push_back(ts);
+                    col->long_vals.push_back(ts);
                 } else {
-                    result->cols[i].is_null.back() = true;
+                    col->is_null.back() = true;
                 }
                 break;
             }
@@ -163,52 +190,38 @@ Status MemoryScratchSink::add_per_col(RuntimeState* state, TupleRow* row, std::s
                 const StringValue* string_val = (const StringValue*)(item);
                 if (string_val->ptr == NULL) {
                     if (string_val->len == 0) {
-                        // 0x01 is a magic num, not usefull actually, just for present ""
-                        //char* tmp_val = reinterpret_cast<char*>(0x01);
-                        result->cols[i].__isset.string_vals = true;
-                        result->cols[i].string_vals.push_back("");          
+                        col->string_vals.emplace_back();
                     } else {
-                        result->cols[i].is_null[i] = true;
+                        col->is_null.back() = true;
                     }
                 } else {
-                    result->cols[i].__isset.string_vals = true;
-                    result->cols[i].string_vals.push_back(std::move(string_val->to_string()));
+                    col->string_vals.emplace_back(string_val->ptr, string_val->len);
                 }
                 break;
             }
             case TYPE_DECIMAL: {
-                result->cols[i].__isset.string_vals = true;
                 const DecimalValue* decimal_val = reinterpret_cast<const DecimalValue*>(item);
-                std::string decimal_str;
-                int output_scale = _output_expr_ctxs[i]->root()->output_scale();
-
+                int output_scale = ctx->root()->output_scale();
                 if (output_scale > 0 && output_scale <= 30) {
-                    decimal_str = decimal_val->to_string(output_scale);
+                    col->string_vals.push_back(decimal_val->to_string(output_scale));
                 } else {
-                    decimal_str = decimal_val->to_string();
+                    col->string_vals.push_back(decimal_val->to_string());
                 }
-                result->cols[i].string_vals.push_back(std::move(decimal_str));          
                 break;
             }
             case TYPE_DECIMALV2: {
-                result->cols[i].__isset.string_vals = true;
                 DecimalV2Value decimal_val(reinterpret_cast<const PackedInt128*>(item)->value);
-                std::string decimal_str;
-                int output_scale = _output_expr_ctxs[i]->root()->output_scale();
-
+                int output_scale = ctx->root()->output_scale();
                 if (output_scale > 0 && output_scale <= 30) {
-                    decimal_str = decimal_val.to_string(output_scale);
+                    col->string_vals.push_back(decimal_val.to_string(output_scale));
                 } else {
-                    decimal_str = decimal_val.to_string();
+                    col->string_vals.push_back(decimal_val.to_string());
                 }
-                result->cols[i].string_vals.push_back(std::move(decimal_str));          
                 break;
             }
-            default:{
-                LOG(WARNING) << "can't convert this type. type = " <<
-                            _output_expr_ctxs[i]->root()->type();
-                return Status::InternalError("unsupported column type");
-            }
+            default:
+                // rejected above
+                break;
         }
     }
     return Status::OK();
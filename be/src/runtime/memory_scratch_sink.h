@@ -69,7 +69,8 @@ private:
 
     Status prepare_exprs(RuntimeState* state);
 
-    Status add_per_col(RuntimeState* state, TupleRow* row, std::shared_ptr<TScanRowBatch> result);
+    // Converts the values of output column i of all rows in batch into col.
+    Status add_column(RuntimeState* state, int i, RowBatch* batch, TScanColumnData* col);
 
     ObjectPool* _obj_pool;
     // Owned by the RuntimeState.
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "common/status.h"
 
 #include "util/byte_buffer.h"
@@ -30,6 +32,15 @@ public:
     virtual Status append(const ByteBufferPtr& buf) {
         return append(buf->ptr, buf->remaining());
     }
+    // Append buf if it can be done without waiting. Otherwise buf isn't taken,
+    // *appended is set to false and on_space will be called once, from any
+    // thread, when there may be space for it or the sink is cancelled.
+    // on_space must not call back into the sink.
+    virtual Status try_append(const ByteBufferPtr& buf, bool* appended,
+                              std::function<void()> on_space) {
+        *appended = true;
+        return append(buf);
+    }
     // called when all data has been append
     virtual Status finish() {
         return Status::OK();
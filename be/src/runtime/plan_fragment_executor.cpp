@@ -23,6 +23,7 @@
 #include <boost/foreach.hpp>
 
 #include "codegen/llvm_codegen.h"
+#include "common/config.h"
 #include "common/logging.h"
 #include "common/object_pool.h"
 #include "exec/data_sink.h"
@@ -36,7 +37,10 @@
 #include "runtime/result_buffer_mgr.h"
 #include "runtime/row_batch.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/fragment_result_cache.h"
+#include "runtime/query_trace.h"
 #include "util/cpu_info.h"
+#include "util/cpu_profiler.h"
 #include "util/uid_util.h"
 #include "util/container_util.hpp"
 #include "util/parse_util.h"
@@ -67,9 +71,11 @@ PlanFragmentExecutor::~PlanFragmentExecutor() {
     DCHECK(!_report_thread_active);
 }
 
-Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request) {
+Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request,
+                                     const std::shared_ptr<FragmentSharedState>& shared_state) {
     const TPlanFragmentExecParams& params = request.params;
     _query_id = params.query_id;
+    _shared_state = shared_state;
 
     LOG(INFO) << "Prepare(): query_id=" << print_id(_query_id)
                << " fragment_instance_id=" << print_id(params.fragment_instance_id)
@@ -97,6 +103,10 @@ Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request) {
     if (request.query_options.__isset.is_report_success) {
         _is_report_success = request.query_options.is_report_success;
     }
+    if (request.query_options.enable_query_trace) {
+        _runtime_state->set_query_trace(QueryTraceMgr::instance()->get_or_create(_query_id));
+    }
+    SCOPED_TRACE_SPAN(_runtime_state, "FragmentPrepare", "fragment");
 
     // Reserve one main thread from the pool
     _runtime_state->resource_pool()->acquire_thread_token();
@@ -136,8 +146,12 @@ Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request) {
 
     // set up desc tbl
     DescriptorTbl* desc_tbl = NULL;
-    DCHECK(request.__isset.desc_tbl);
-    RETURN_IF_ERROR(DescriptorTbl::create(obj_pool(), request.desc_tbl, &desc_tbl));
+    if (_shared_state != nullptr && _shared_state->desc_tbl != nullptr) {
+        desc_tbl = _shared_state->desc_tbl;
+    } else {
+        DCHECK(request.__isset.desc_tbl);
+        RETURN_IF_ERROR(DescriptorTbl::create(obj_pool(), request.desc_tbl, &desc_tbl));
+    }
     _runtime_state->set_desc_tbl(desc_tbl);
 
     // set up plan
@@ -201,6 +215,10 @@ Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request) {
 
         _collect_query_statistics_with_every_batch = params.__isset.send_query_statistics_with_every_batch ?
             params.send_query_statistics_with_every_batch : false;
+
+        if (FragmentResultCache::instance() != nullptr) {
+            _result_cache_key = FragmentResultCache::make_key(request);
+        }
     } else {
         _sink.reset(NULL);
     }
@@ -262,6 +280,7 @@ void PlanFragmentExecutor::print_volume_ids(
 }
 
 Status PlanFragmentExecutor::open() {
+    CpuProfileTag profile_tag(_runtime_state->query_id(), _runtime_state->fragment_instance_id());
     LOG(INFO) << "Open(): fragment_instance_id=" << print_id(_runtime_state->fragment_instance_id());
 
     // we need to start the profile-reporting thread before calling Open(), since it
@@ -277,7 +296,11 @@ Status PlanFragmentExecutor::open() {
         _report_thread_active = true;
     }
 
-    optimize_llvm_module();
+    if (config::enable_async_codegen && _runtime_state->codegen_created()) {
+        _codegen_thread = boost::thread(&PlanFragmentExecutor::optimize_llvm_module, this);
+    } else {
+        optimize_llvm_module();
+    }
 
     Status status = open_internal();
 
@@ -293,8 +316,20 @@ Status PlanFragmentExecutor::open() {
 }
 
 Status PlanFragmentExecutor::open_internal() {
-    {
+    SCOPED_TRACE_SPAN(_runtime_state, "FragmentExecute", "fragment");
+    _cpu_watch.start();
+    std::shared_ptr<const FragmentResult> cached_result;
+    if (!_result_cache_key.empty()) {
+        cached_result = FragmentResultCache::instance()->lookup(_result_cache_key);
+        profile()->add_info_string("FragmentResultCache",
+                                   cached_result != nullptr ? "Hit" : "Miss");
+        if (cached_result == nullptr) {
+            _result_to_cache.reset(new FragmentResult());
+        }
+    }
+    if (cached_result == nullptr) {
         SCOPED_TIMER(profile()->total_time_counter());
+        SCOPED_TRACE_SPAN(_runtime_state, "FragmentOpen", "fragment");
         RETURN_IF_ERROR(_plan->open(_runtime_state.get()));
     }
 
@@ -302,6 +337,9 @@ Status PlanFragmentExecutor::open_internal() {
         return Status::OK();
     }
     RETURN_IF_ERROR(_sink->open(runtime_state()));
+    if (cached_result != nullptr) {
+        RETURN_IF_ERROR(send_cached_result(*cached_result));
+    }
 
     // If there is a sink, do all the work of driving it here, so that
     // when this returns the query has actually finished
@@ -329,8 +367,19 @@ Status PlanFragmentExecutor::open_internal() {
         if (_collect_query_statistics_with_every_batch) {
             collect_query_statistics();
         }
+        if (_result_to_cache != nullptr) {
+            _result_to_cache->batches.emplace_back();
+            batch->serialize(&_result_to_cache->batches.back());
+            _result_to_cache->bytes += _result_to_cache->batches.back().ByteSize();
+            if ((int64_t)_result_to_cache->bytes > config::fragment_result_cache_max_entry_bytes) {
+                _result_to_cache.reset();
+            }
+        }
         RETURN_IF_ERROR(_sink->send(runtime_state(), batch));
     }
+    if (_result_to_cache != nullptr) {
+        FragmentResultCache::instance()->insert(_result_cache_key, std::move(_result_to_cache));
+    }
 
     // Close the sink *before* stopping the report thread. Close may
     // need to add some important information to the last report that
@@ -365,6 +414,10 @@ Status PlanFragmentExecutor::open_internal() {
 void PlanFragmentExecutor::collect_query_statistics() {
     _query_statistics->clear();
     _plan->collect_query_statistics(_query_statistics.get());
+    _query_statistics->add_cpu_ns(_cpu_watch.elapsed_time());
+    _query_statistics->add_spill_bytes(_runtime_state->spill_bytes());
+    _query_statistics->update_max_peak_memory_bytes(
+            _runtime_state->query_mem_tracker()->peak_consumption());
 }
 
 void PlanFragmentExecutor::report_profile() {
@@ -489,6 +542,17 @@ Status PlanFragmentExecutor::get_next(RowBatch** batch) {
     return status;
 }
 
+Status PlanFragmentExecutor::send_cached_result(const FragmentResult& result) {
+    SCOPED_TIMER(profile()->total_time_counter());
+    for (auto& pb_batch : result.batches) {
+        RowBatch batch(row_desc(), pb_batch, _runtime_state->instance_mem_tracker());
+        COUNTER_UPDATE(_rows_produced_counter, batch.num_rows());
+        RETURN_IF_ERROR(_sink->send(runtime_state(), &batch));
+    }
+    _done = true;
+    return Status::OK();
+}
+
 Status PlanFragmentExecutor::get_next_internal(RowBatch** batch) {
     if (_done) {
         *batch = NULL;
@@ -563,6 +627,12 @@ void PlanFragmentExecutor::close() {
 
     _row_batch.reset(NULL);
 
+    // The jitted code and the llvm objects it is compiled from belong to the
+    // runtime state, wait for the compilation before tearing down the fragment.
+    if (_codegen_thread.joinable()) {
+        _codegen_thread.join();
+    }
+
     // Prepare may not have been called, which sets _runtime_state
     if (_runtime_state.get() != NULL) {
         
@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_RUNTIME_PLAN_FRAGMENT_EXECUTOR_H
 #define DORIS_BE_RUNTIME_PLAN_FRAGMENT_EXECUTOR_H
 
+#include <memory>
 #include <vector>
 #include <boost/scoped_ptr.hpp>
 #include <boost/function.hpp>
@@ -26,11 +27,13 @@
 #include "common/object_pool.h"
 #include "runtime/query_statistics.h"
 #include "runtime/runtime_state.h"
+#include "util/stopwatch.hpp"
 
 namespace doris {
 
 class HdfsFsCache;
 class ExecNode;
+struct FragmentResult;
 class RowDescriptor;
 class RowBatch;
 class DataSink;
@@ -41,6 +44,15 @@ class TPlanExecRequest;
 class TPlanFragment;
 class TPlanFragmentExecParams;
 class TPlanExecParams;
+class DescriptorTbl;
+
+// Parts of a fragment which are built once for all of its instances on this backend
+// started by one exec_plan_fragment_batch rpc, and live as long as any of them.
+struct FragmentSharedState {
+    ObjectPool obj_pool;
+    // null if the instances have to build their own descriptor tables
+    DescriptorTbl* desc_tbl = nullptr;
+};
 
 // PlanFragmentExecutor handles all aspects of the execution of a single plan fragment,
 // including setup and tear-down, both in the success and error case.
@@ -90,7 +102,10 @@ public:
     // If request.query_options.mem_limit > 0, it is used as an approximate limit on the
     // number of bytes this query can consume at runtime.
     // The query will be aborted (MEM_LIMIT_EXCEEDED) if it goes over that limit.
-    Status prepare(const TExecPlanFragmentParams& request);
+    // 'shared_state', if not null, holds the parts of the fragment shared with the other
+    // instances of the same batch.
+    Status prepare(const TExecPlanFragmentParams& request,
+                   const std::shared_ptr<FragmentSharedState>& shared_state = nullptr);
 
     // Start execution. Call this prior to get_next().
     // If this fragment has a sink, open() will send all rows produced
@@ -147,6 +162,8 @@ public:
 
 private:
     ExecEnv* _exec_env;  // not owned
+    // declared before _runtime_state, which may refer to its descriptor table
+    std::shared_ptr<FragmentSharedState> _shared_state;
     ExecNode* _plan;  // lives in _runtime_state->obj_pool()
     TUniqueId _query_id;
     // MemTracker* _mem_tracker;
@@ -157,6 +174,10 @@ private:
     boost::thread _report_thread;
     boost::mutex _report_thread_lock;
 
+    // Runs optimize_llvm_module() while the fragment executes interpreted, if
+    // config::enable_async_codegen is set. Joined in close().
+    boost::thread _codegen_thread;
+
     // Indicates that profile reporting thread should stop.
     // Tied to _report_thread_lock.
     boost::condition_variable _stop_report_thread_cv;
@@ -218,6 +239,15 @@ private:
     // multithreaded access.
     std::shared_ptr<QueryStatistics> _query_statistics;
     bool _collect_query_statistics_with_every_batch;    
+    // cpu time of the thread driving the fragment in open_internal(), which also
+    // collects query statistics
+    ThreadCpuStopWatch _cpu_watch;
+
+    // key in FragmentResultCache, empty if the result of this fragment isn't cached
+    std::string _result_cache_key;
+    // output batches to be inserted into FragmentResultCache, reset when they
+    // exceed config::fragment_result_cache_max_entry_bytes
+    std::shared_ptr<FragmentResult> _result_to_cache;
 
     ObjectPool* obj_pool() {
         return _runtime_state->obj_pool();
@@ -247,6 +277,8 @@ private:
     /// PlanFragmentExecutor()::Prepare() to allow starting plan fragments more
     /// quickly and in parallel (in a deep plan tree, the fragments are started
     /// in level order).
+    /// With config::enable_async_codegen it runs in _codegen_thread instead, and the
+    /// nodes switch to the jitted functions once finalize_module() publishes them.
     void optimize_llvm_module();
 
     // Executes open() logic and returns resulting status. Does not set _status.
@@ -257,6 +289,10 @@ private:
     // have been stopped. _sink will be set to NULL after successful execution.
     Status open_internal();
 
+    // Send the cached output batches to the sink instead of executing the plan,
+    // sets _done.
+    Status send_cached_result(const FragmentResult& result);
+
     // Executes get_next() logic and returns resulting status.
     Status get_next_internal(RowBatch** batch);
 
@@ -33,12 +33,17 @@ class QueryStatisticsRecvr;
 class QueryStatistics {
 public:
 
-    QueryStatistics() : scan_rows(0), scan_bytes(0) {
+    QueryStatistics() : scan_rows(0), scan_bytes(0), cpu_ns(0), scan_bytes_from_page_cache(0),
+            spill_bytes(0), max_peak_memory_bytes(0) {
     }
 
     void merge(const QueryStatistics& other) {
         scan_rows += other.scan_rows;
         scan_bytes += other.scan_bytes;
+        cpu_ns += other.cpu_ns;
+        scan_bytes_from_page_cache += other.scan_bytes_from_page_cache;
+        spill_bytes += other.spill_bytes;
+        update_max_peak_memory_bytes(other.max_peak_memory_bytes);
     }
 
     void add_scan_rows(int64_t scan_rows) {
@@ -49,28 +54,64 @@ public:
         this->scan_bytes += scan_bytes;
     }
 
+    void add_cpu_ns(int64_t cpu_ns) {
+        this->cpu_ns += cpu_ns;
+    }
+
+    void add_scan_bytes_from_page_cache(int64_t scan_bytes_from_page_cache) {
+        this->scan_bytes_from_page_cache += scan_bytes_from_page_cache;
+    }
+
+    void add_spill_bytes(int64_t spill_bytes) {
+        this->spill_bytes += spill_bytes;
+    }
+
+    void update_max_peak_memory_bytes(int64_t peak_memory_bytes) {
+        if (peak_memory_bytes > max_peak_memory_bytes) {
+            max_peak_memory_bytes = peak_memory_bytes;
+        }
+    }
+
     void merge(QueryStatisticsRecvr* recvr);
 
     void clear() {
         scan_rows = 0;
         scan_bytes = 0;
+        cpu_ns = 0;
+        scan_bytes_from_page_cache = 0;
+        spill_bytes = 0;
+        max_peak_memory_bytes = 0;
     }
 
     void to_pb(PQueryStatistics* statistics) {
         DCHECK(statistics != nullptr);
         statistics->set_scan_rows(scan_rows);
         statistics->set_scan_bytes(scan_bytes);
+        statistics->set_cpu_ms(cpu_ns / NANOS_PER_MILLIS);
+        statistics->set_scan_bytes_from_page_cache(scan_bytes_from_page_cache);
+        statistics->set_spill_bytes(spill_bytes);
+        statistics->set_max_peak_memory_bytes(max_peak_memory_bytes);
     }
 
     void merge_pb(const PQueryStatistics& statistics) {
         scan_rows += statistics.scan_rows();
         scan_bytes += statistics.scan_bytes();
+        cpu_ns += statistics.cpu_ms() * NANOS_PER_MILLIS;
+        scan_bytes_from_page_cache += statistics.scan_bytes_from_page_cache();
+        spill_bytes += statistics.spill_bytes();
+        update_max_peak_memory_bytes(statistics.max_peak_memory_bytes());
     }
 
 private:
 
+    static const int64_t NANOS_PER_MILLIS = 1000000;
+
     int64_t scan_rows;
     int64_t scan_bytes;
+    int64_t cpu_ns;
+    int64_t scan_bytes_from_page_cache;
+    int64_t spill_bytes;
+    int64_t max_peak_memory_bytes;
 };
 
 // It is used for collecting sub plan query statistics in DataStreamRecvr.
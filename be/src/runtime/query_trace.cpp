@@ -0,0 +1,143 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/query_trace.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "common/config.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+static int64_t current_tid() {
+    static __thread int64_t tid = 0;
+    if (tid == 0) {
+        tid = syscall(SYS_gettid);
+    }
+    return tid;
+}
+
+QueryTrace::QueryTrace(const TUniqueId& query_id, int64_t max_spans)
+        : _query_id(query_id), _max_spans(max_spans) {
+}
+
+void QueryTrace::add_span(const char* name, const char* category,
+                          const TUniqueId& fragment_instance_id,
+                          int64_t start_us, int64_t end_us) {
+    Span span;
+    span.name = name;
+    span.category = category;
+    span.tid = current_tid();
+    span.start_us = start_us;
+    span.duration_us = end_us - start_us;
+    span.fragment_instance_id = fragment_instance_id;
+
+    std::lock_guard<std::mutex> l(_lock);
+    if ((int64_t)_spans.size() >= _max_spans) {
+        _num_dropped_spans++;
+        return;
+    }
+    _spans.push_back(span);
+}
+
+void QueryTrace::to_chrome_trace(std::string* out) const {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    std::string query_id = print_id(_query_id);
+    writer.StartObject();
+    writer.Key("traceEvents");
+    writer.StartArray();
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& span : _spans) {
+            // complete events, of which the process is the backend
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(span.name);
+            writer.Key("cat");
+            writer.String(span.category);
+            writer.Key("ph");
+            writer.String("X");
+            writer.Key("ts");
+            writer.Int64(span.start_us);
+            writer.Key("dur");
+            writer.Int64(span.duration_us);
+            writer.Key("pid");
+            writer.Int64(getpid());
+            writer.Key("tid");
+            writer.Int64(span.tid);
+            writer.Key("args");
+            writer.StartObject();
+            writer.Key("fragment_instance_id");
+            writer.String(print_id(span.fragment_instance_id).c_str());
+            writer.EndObject();
+            writer.EndObject();
+        }
+    }
+    writer.EndArray();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("otherData");
+    writer.StartObject();
+    writer.Key("query_id");
+    writer.String(query_id.c_str());
+    writer.Key("dropped_spans");
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        writer.Int64(_num_dropped_spans);
+    }
+    writer.EndObject();
+    writer.EndObject();
+    out->append(buffer.GetString(), buffer.GetSize());
+}
+
+std::shared_ptr<QueryTrace> QueryTraceMgr::get_or_create(const TUniqueId& query_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _traces.find(query_id);
+    if (it != _traces.end()) {
+        return it->second;
+    }
+    std::shared_ptr<QueryTrace> trace(
+        new QueryTrace(query_id, config::query_trace_max_spans_per_query));
+    _traces.emplace(query_id, trace);
+    _query_ids.push_back(query_id);
+    // traces of running queries are still recorded after being evicted, as
+    // their fragment instances hold them
+    while ((int32_t)_query_ids.size() > std::max(config::query_trace_max_queries, 1)) {
+        _traces.erase(_query_ids.front());
+        _query_ids.pop_front();
+    }
+    return trace;
+}
+
+std::shared_ptr<QueryTrace> QueryTraceMgr::get(const TUniqueId& query_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _traces.find(query_id);
+    if (it == _traces.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+}
@@ -0,0 +1,135 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_RUNTIME_QUERY_TRACE_H
+#define DORIS_BE_RUNTIME_QUERY_TRACE_H
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gen_cpp/Types_types.h"
+#include "util/hash_util.hpp"
+#include "util/runtime_profile.h"
+#include "util/time.h"
+
+namespace doris {
+
+// Timestamped spans of one query on this backend, e.g. fragment prepare and
+// open, scanner runs and exchange sends, with the threads they ran on. Unlike
+// counters of RuntimeProfile, they tell when things happened across threads.
+// The trace is exported in Chrome trace format, which can be viewed by
+// chrome://tracing or Perfetto.
+//
+// Tracing is enabled by query option enable_query_trace, and the trace is
+// served by /api/query_trace?query_id=xxx.
+class QueryTrace {
+public:
+    QueryTrace(const TUniqueId& query_id, int64_t max_spans);
+
+    // 'name' and 'category' must be string literals. Spans after max_spans are
+    // dropped and only counted.
+    void add_span(const char* name, const char* category,
+                  const TUniqueId& fragment_instance_id,
+                  int64_t start_us, int64_t end_us);
+
+    // Append the trace as a Chrome trace JSON object to 'out'
+    void to_chrome_trace(std::string* out) const;
+
+    const TUniqueId& query_id() const { return _query_id; }
+
+private:
+    struct Span {
+        const char* name;
+        const char* category;
+        int64_t tid;
+        int64_t start_us;
+        int64_t duration_us;
+        TUniqueId fragment_instance_id;
+    };
+
+    const TUniqueId _query_id;
+    const int64_t _max_spans;
+
+    mutable std::mutex _lock;
+    std::vector<Span> _spans;
+    int64_t _num_dropped_spans = 0;
+};
+
+// Traces of the latest config::query_trace_max_queries traced queries,
+// which stay after the queries finish, so they can be downloaded later.
+class QueryTraceMgr {
+public:
+    static QueryTraceMgr* instance() {
+        static QueryTraceMgr s_mgr;
+        return &s_mgr;
+    }
+
+    // Return the trace of 'query_id', which is shared by its fragment instances
+    std::shared_ptr<QueryTrace> get_or_create(const TUniqueId& query_id);
+
+    // Return nullptr if 'query_id' is not traced or its trace has been evicted
+    std::shared_ptr<QueryTrace> get(const TUniqueId& query_id);
+
+private:
+    QueryTraceMgr() { }
+
+    std::mutex _lock;
+    std::unordered_map<TUniqueId, std::shared_ptr<QueryTrace>> _traces;
+    // query ids in the order of the creation of their traces
+    std::deque<TUniqueId> _query_ids;
+};
+
+// Record a span of the calling thread into 'trace' during the lifetime of
+// this object. Do nothing if 'trace' is nullptr.
+class ScopedTraceSpan {
+public:
+    ScopedTraceSpan(QueryTrace* trace, const TUniqueId& fragment_instance_id,
+                    const char* name, const char* category)
+            : _trace(trace), _fragment_instance_id(fragment_instance_id),
+              _name(name), _category(category), _start_us(0) {
+        if (_trace != nullptr) {
+            _start_us = MonotonicMicros();
+        }
+    }
+
+    ~ScopedTraceSpan() {
+        if (_trace != nullptr) {
+            _trace->add_span(_name, _category, _fragment_instance_id,
+                             _start_us, MonotonicMicros());
+        }
+    }
+
+private:
+    QueryTrace* _trace;
+    const TUniqueId& _fragment_instance_id;
+    const char* _name;
+    const char* _category;
+    int64_t _start_us;
+};
+
+// 'state' is a RuntimeState*
+#define SCOPED_TRACE_SPAN(state, name, category) \
+      ScopedTraceSpan MACRO_CONCAT(SCOPED_TRACE_SPAN, __COUNTER__)( \
+          (state)->query_trace(), (state)->fragment_instance_id(), name, category)
+
+}
+
+#endif
@@ -288,7 +288,7 @@ inline uint32_t RawValue::get_hash_value(
 
     case TYPE_DATE:
     case TYPE_DATETIME:
-        return HashUtil::hash(v, 16, seed);
+        return reinterpret_cast<const DateTimeValue*>(v)->hash(seed);
 
     case TYPE_DECIMAL:
         return HashUtil::hash(v, 40, seed);
@@ -345,8 +345,10 @@ inline uint32_t RawValue::get_hash_value_fvn(
         return HashUtil::fnv_hash(v, 8, seed);
 
     case TYPE_DATE:
-    case TYPE_DATETIME:
-        return HashUtil::fnv_hash(v, 16, seed);
+    case TYPE_DATETIME: {
+        uint64_t key = reinterpret_cast<const DateTimeValue*>(v)->packed_key();
+        return HashUtil::fnv_hash(&key, sizeof(key), seed);
+    }
 
     case TYPE_DECIMAL:
         return ((DecimalValue *) v)->hash(seed);
@@ -91,7 +91,7 @@ int RawValue::compare(const void* v1, const void* v2, const TypeDescriptor& type
     case TYPE_DATETIME:
         ts_value1 = reinterpret_cast<const DateTimeValue*>(v1);
         ts_value2 = reinterpret_cast<const DateTimeValue*>(v2);
-        return *ts_value1 > *ts_value2 ? 1 : (*ts_value1 < *ts_value2 ? -1 : 0);
+        return ts_value1->compare(*ts_value2);
 
     case TYPE_DECIMAL:
         decimal_value1 = reinterpret_cast<const DecimalValue*>(v1);
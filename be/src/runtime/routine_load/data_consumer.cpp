@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "service/backend_options.h"
 #include "runtime/small_file_mgr.h"
@@ -31,6 +32,10 @@
 
 namespace doris {
 
+// a batch which is not full is put to queue after this time,
+// so that msgs coming slowly are not held by consumers
+static const int64_t MAX_BATCH_WAIT_TIME_NS = 100 * 1000 * 1000;
+
 // init kafka consumer will only set common configs such as
 // brokers, groupid
 Status KafkaDataConsumer::init(StreamLoadContext* ctx) {
@@ -162,7 +167,7 @@ Status KafkaDataConsumer::assign_topic_partitions(
 }
 
 Status KafkaDataConsumer::group_consume(
-        BlockingQueue<RdKafka::Message*>* queue,
+        BlockingQueue<KafkaMessageBatch*>* queue,
         int64_t max_running_time_ms) {
     _last_visit_time = time(nullptr);
     int64_t left_time = max_running_time_ms;
@@ -175,6 +180,26 @@ Status KafkaDataConsumer::group_consume(
     MonotonicStopWatch consumer_watch;
     MonotonicStopWatch watch;
     watch.start();
+
+    // msgs are copied to the batch here, and put to queue when it is full
+    std::unique_ptr<KafkaMessageBatch> batch;
+    MonotonicStopWatch batch_watch;
+    // return false if queue is shutdown
+    auto put_batch = [&] () {
+        if (batch == nullptr) {
+            return true;
+        }
+        int64_t rows = batch->rows;
+        if (!queue->blocking_put(batch.get())) {
+            batch.reset();
+            return false;
+        }
+        // release the ownership, batch will be deleted after being processed
+        batch.release();
+        put_rows += rows;
+        return true;
+    };
+
     while (true) {
         {
             std::unique_lock<std::mutex> l(_lock);
@@ -190,19 +215,33 @@ Status KafkaDataConsumer::group_consume(
         consumer_watch.stop();
         switch (msg->err()) {
             case RdKafka::ERR_NO_ERROR:
-                if (!queue->blocking_put(msg.get())) {
-                    // queue is shutdown
+                ++received_rows;
+                if (batch != nullptr && !batch->has_room(msg->len())) {
+                    if (!put_batch()) {
+                        // queue is shutdown
+                        done = true;
+                        break;
+                    }
+                }
+                if (batch == nullptr) {
+                    batch.reset(new KafkaMessageBatch(std::max<size_t>(
+                            config::routine_load_consumer_batch_bytes, msg->len() + 1)));
+                    batch_watch = MonotonicStopWatch();
+                    batch_watch.start();
+                }
+                batch->append(msg.get());
+                // do not hold msgs too long if they come slowly
+                if (batch_watch.elapsed_time() > MAX_BATCH_WAIT_TIME_NS && !put_batch()) {
                     done = true;
-                } else {
-                    ++put_rows;
-                    msg.release(); // release the ownership, msg will be deleted after being processed
                 }
-                ++received_rows;
                 break;
             case RdKafka::ERR__TIMED_OUT:
                 // leave the status as OK, because this may happend
                 // if there is no data in kafka.
                 LOG(INFO) << "kafka consume timeout: " << _id;
+                if (!put_batch()) {
+                    done = true;
+                }
                 break;
             default:
                 LOG(WARNING) << "kafka consume failed: " << _id
@@ -215,6 +254,8 @@ Status KafkaDataConsumer::group_consume(
         left_time = max_running_time_ms - watch.elapsed_time() / 1000 / 1000;
         if (done) { break; }
     }
+    // msgs left in batch are not committed if queue is already shutdown
+    put_batch();
 
     LOG(INFO) << "kafka conumer done: " << _id << ", grp: " << _grp_id
             << ". cancelled: " << _cancelled
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <ctime>
+#include <map>
 #include <mutex>
 #include <unordered_map>
 
@@ -25,6 +26,7 @@
 
 #include "runtime/stream_load/stream_load_context.h"
 #include "util/blocking_queue.hpp"
+#include "util/byte_buffer.h"
 #include "util/uid_util.h"
 
 namespace doris {
@@ -109,6 +111,32 @@ public:
     }
 };
 
+// Messages of one kafka consumer copied into one pipe chunk, each followed by
+// a line delimiter. Consumers hand over messages by batches, so that they are
+// appended to the pipe without locking the queue and the pipe per message.
+struct KafkaMessageBatch {
+    KafkaMessageBatch(size_t capacity) : buf(ByteBuffer::allocate(capacity)) { }
+
+    bool has_room(size_t len) const {
+        return buf->capacity - buf->pos >= len + 1;
+    }
+
+    void append(RdKafka::Message* msg) {
+        buf->put_bytes(static_cast<const char*>(msg->payload()), msg->len());
+        buf->put_bytes("\n", 1);
+        ++rows;
+        bytes += msg->len();
+        offsets[msg->partition()] = msg->offset();
+    }
+
+    ByteBufferPtr buf;
+    int64_t rows = 0;
+    // bytes of messages, without line delimiters
+    int64_t bytes = 0;
+    // partition -> offset of the last message in this batch
+    std::map<int32_t, int64_t> offsets;
+};
+
 class KafkaDataConsumer : public DataConsumer {
 public:
     KafkaDataConsumer(StreamLoadContext* ctx):
@@ -139,8 +167,8 @@ public:
             const std::string& topic,
             StreamLoadContext* ctx);
 
-    // start the consumer and put msgs to queue
-    Status group_consume(BlockingQueue<RdKafka::Message*>* queue, int64_t max_running_time_ms);
+    // start the consumer and put batches of msgs to queue
+    Status group_consume(BlockingQueue<KafkaMessageBatch*>* queue, int64_t max_running_time_ms);
 
     // get the partitions ids of the topic
     Status get_partition_meta(std::vector<int32_t>* partition_ids);
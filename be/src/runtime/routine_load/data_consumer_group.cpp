@@ -48,10 +48,9 @@ KafkaDataConsumerGroup::~KafkaDataConsumerGroup() {
     // clean the msgs left in queue
     _queue.shutdown();
     while(true) {
-        RdKafka::Message* msg;
-        if (_queue.blocking_get(&msg)) {
-            delete msg;
-            msg = nullptr;
+        KafkaMessageBatch* batch;
+        if (_queue.blocking_get(&batch)) {
+            delete batch;
         } else {
             break;
         }
@@ -144,29 +143,29 @@ Status KafkaDataConsumerGroup::start_all(StreamLoadContext* ctx) {
             }
         }
 
-        RdKafka::Message* msg;
-        bool res = _queue.blocking_get(&msg);
+        KafkaMessageBatch* batch;
+        bool res = _queue.blocking_get(&batch);
         if (res) {
-            VLOG(3) << "get kafka message"
-                << ", partition: " << msg->partition()
-                << ", offset: " << msg->offset()
-                << ", len: " << msg->len();
-
-            st = kafka_pipe->append_with_line_delimiter(
-                    static_cast<const char *>(msg->payload()),
-                    static_cast<size_t>(msg->len()));
+            std::unique_ptr<KafkaMessageBatch> batch_holder(batch);
+            VLOG(3) << "get kafka message batch"
+                << ", rows: " << batch->rows
+                << ", bytes: " << batch->bytes;
+
+            // the batch is queued by reference without being copied again
+            st = kafka_pipe->append(batch->buf);
             if (st.ok()) {
-                left_rows--;
-                left_bytes -= msg->len();
-                cmt_offset[msg->partition()] = msg->offset();
-                VLOG(3) << "consume partition[" << msg->partition()
-                    << " - " << msg->offset() << "]";
+                left_rows -= batch->rows;
+                left_bytes -= batch->bytes;
+                for (auto& kv : batch->offsets) {
+                    cmt_offset[kv.first] = kv.second;
+                    VLOG(3) << "consume partition[" << kv.first
+                        << " - " << kv.second << "]";
+                }
             } else {
-                // failed to append this msg, we must stop
+                // failed to append this batch, we must stop
                 LOG(WARNING) << "failed to append msg to pipe. grp: " << _grp_id;
                 eos = true;
             }
-            delete msg;
         } else {
             // queue is empty and shutdown
             eos = true;   
@@ -180,7 +179,7 @@ Status KafkaDataConsumerGroup::start_all(StreamLoadContext* ctx) {
 
 void KafkaDataConsumerGroup::actual_consume(
         std::shared_ptr<DataConsumer> consumer,
-        BlockingQueue<RdKafka::Message*>* queue,
+        BlockingQueue<KafkaMessageBatch*>* queue,
         int64_t max_running_time_ms,
         ConsumeFinishCallback cb) {
     Status st = std::static_pointer_cast<KafkaDataConsumer>(consumer)->group_consume(queue, max_running_time_ms);
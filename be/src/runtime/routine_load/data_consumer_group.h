@@ -71,7 +71,7 @@ class KafkaDataConsumerGroup : public DataConsumerGroup {
 public:
     KafkaDataConsumerGroup():
         DataConsumerGroup(),
-        _queue(500) {}
+        _queue(16) {}
 
     virtual ~KafkaDataConsumerGroup();
 
@@ -83,13 +83,13 @@ private:
     // start a single consumer
     void actual_consume(
             std::shared_ptr<DataConsumer> consumer,
-            BlockingQueue<RdKafka::Message*>* queue,
+            BlockingQueue<KafkaMessageBatch*>* queue,
             int64_t max_running_time_ms,
             ConsumeFinishCallback cb);
 
 private:
-    // blocking queue to receive msgs from all consumers
-    BlockingQueue<RdKafka::Message*> _queue; 
+    // blocking queue to receive batches of msgs from all consumers
+    BlockingQueue<KafkaMessageBatch*> _queue;
 };
 
 } // end namespace doris
@@ -19,6 +19,7 @@
 
 #include <stdint.h>  // for intptr_t
 #include <snappy/snappy.h>
+#include <butil/iobuf.h>
 
 #include "runtime/exec_env.h"
 #include "runtime/runtime_state.h"
@@ -28,6 +29,7 @@
 //#include "runtime/mem_tracker.h"
 #include "gen_cpp/Data_types.h"
 #include "gen_cpp/data.pb.h"
+#include "util/block_compression.h"
 #include "util/debug_util.h"
 
 using std::vector;
@@ -54,7 +56,7 @@ RowBatch::RowBatch(const RowDescriptor& row_desc, int capacity, MemTracker* mem_
     _tuple_ptrs_size = _capacity * _num_tuples_per_row * sizeof(Tuple*);
     DCHECK_GT(_tuple_ptrs_size, 0);
     // TODO: switch to Init() pattern so we can check memory limit and return Status.
-    if (config::enable_partitioned_aggregation || config::enable_new_partitioned_aggregation) {
+    if (config::enable_new_partitioned_aggregation) {
         _mem_tracker->consume(_tuple_ptrs_size);
         _tuple_ptrs = reinterpret_cast<Tuple**>(malloc(_tuple_ptrs_size));
         DCHECK(_tuple_ptrs != NULL);
@@ -83,17 +85,7 @@ RowBatch::RowBatch(const RowDescriptor& row_desc,
             _auxiliary_mem_usage(0),
             _need_to_return(false),
             _tuple_data_pool(new MemPool(_mem_tracker)) {
-    DCHECK(_mem_tracker != nullptr);
-    _tuple_ptrs_size = _num_rows * _num_tuples_per_row * sizeof(Tuple*);
-    DCHECK_GT(_tuple_ptrs_size, 0);
-    // TODO: switch to Init() pattern so we can check memory limit and return Status.
-    if (config::enable_partitioned_aggregation || config::enable_new_partitioned_aggregation) {
-        _mem_tracker->consume(_tuple_ptrs_size);
-        _tuple_ptrs = reinterpret_cast<Tuple**>(malloc(_tuple_ptrs_size));
-        DCHECK(_tuple_ptrs != nullptr);
-    } else {
-        _tuple_ptrs = reinterpret_cast<Tuple**>(_tuple_data_pool->allocate(_tuple_ptrs_size));
-    }
+    _alloc_tuple_ptrs();
 
     uint8_t* tuple_data = nullptr;
     if (input_batch.is_compressed()) {
@@ -114,6 +106,102 @@ RowBatch::RowBatch(const RowDescriptor& row_desc,
         memcpy(tuple_data, input_batch.tuple_data().c_str(), input_batch.tuple_data().size());
     }
 
+    _convert_offsets_to_pointers(input_batch, tuple_data);
+}
+
+RowBatch::RowBatch(const RowDescriptor& row_desc,
+                   const PRowBatch& input_batch,
+                   const butil::IOBuf& tuple_data,
+                   const BlockCompressionCodec* codec,
+                   size_t uncompressed_size,
+                   MemTracker* tracker)
+            : _mem_tracker(tracker),
+            _has_in_flight_row(false),
+            _num_rows(input_batch.num_rows()),
+            _capacity(_num_rows),
+            _flush(FlushMode::NO_FLUSH_RESOURCES),
+            _needs_deep_copy(false),
+            _num_tuples_per_row(input_batch.row_tuples_size()),
+            _row_desc(row_desc),
+            _auxiliary_mem_usage(0),
+            _need_to_return(false),
+            _tuple_data_pool(new MemPool(_mem_tracker)) {
+    _alloc_tuple_ptrs();
+
+    uint8_t* data = nullptr;
+    size_t data_size = 0;
+    if (codec == nullptr) {
+        // copy directly from the blocks of tuple_data, they needn't be contiguous
+        data_size = tuple_data.size();
+        data = _tuple_data_pool->allocate(data_size);
+        tuple_data.copy_to(data, data_size);
+    } else if (tuple_data.backing_block_num() == 1) {
+        // decompress directly from tuple_data if it is contiguous
+        auto block = tuple_data.backing_block(0);
+        data_size = uncompressed_size;
+        data = _decompress_tuple_data(Slice(block.data(), block.size()), codec, uncompressed_size);
+    } else {
+        std::string buf;
+        tuple_data.copy_to(&buf);
+        data_size = uncompressed_size;
+        data = _decompress_tuple_data(Slice(buf), codec, uncompressed_size);
+    }
+    _init_from_tuple_data(input_batch, data, data_size);
+}
+
+uint8_t* RowBatch::_decompress_tuple_data(const Slice& tuple_data,
+                                          const BlockCompressionCodec* codec,
+                                          size_t uncompressed_size) {
+    uint8_t* data = _tuple_data_pool->allocate(uncompressed_size);
+    Slice output(data, uncompressed_size);
+    auto st = codec->decompress(tuple_data, &output);
+    if (!st.ok() || output.size != uncompressed_size) {
+        LOG(WARNING) << "fail to decompress tuple data, uncompressed_size="
+            << uncompressed_size << ", compressed_size=" << tuple_data.size
+            << ", msg=" << st.get_error_msg();
+        return nullptr;
+    }
+    return data;
+}
+
+void RowBatch::_init_from_tuple_data(const PRowBatch& input_batch, uint8_t* data,
+                                     size_t data_size) {
+    _valid = data != nullptr;
+    if (_valid && input_batch.tuple_offsets_size() != _num_rows * _num_tuples_per_row) {
+        LOG(WARNING) << "bad number of tuple offsets, num_rows=" << _num_rows
+            << ", num_tuple_offsets=" << input_batch.tuple_offsets_size();
+        _valid = false;
+    }
+    for (int i = 0; _valid && i < input_batch.tuple_offsets_size(); ++i) {
+        auto offset = input_batch.tuple_offsets(i);
+        if (offset < -1 || (offset >= 0 && offset >= data_size)) {
+            LOG(WARNING) << "bad tuple offset, offset=" << offset << ", tuple_data_size=" << data_size;
+            _valid = false;
+        }
+    }
+    if (!_valid) {
+        _num_rows = 0;
+        return;
+    }
+
+    _convert_offsets_to_pointers(input_batch, data);
+}
+
+void RowBatch::_alloc_tuple_ptrs() {
+    DCHECK(_mem_tracker != nullptr);
+    _tuple_ptrs_size = _num_rows * _num_tuples_per_row * sizeof(Tuple*);
+    DCHECK_GT(_tuple_ptrs_size, 0);
+    // TODO: switch to Init() pattern so we can check memory limit and return Status.
+    if (config::enable_new_partitioned_aggregation) {
+        _mem_tracker->consume(_tuple_ptrs_size);
+        _tuple_ptrs = reinterpret_cast<Tuple**>(malloc(_tuple_ptrs_size));
+        DCHECK(_tuple_ptrs != nullptr);
+    } else {
+        _tuple_ptrs = reinterpret_cast<Tuple**>(_tuple_data_pool->allocate(_tuple_ptrs_size));
+    }
+}
+
+void RowBatch::_convert_offsets_to_pointers(const PRowBatch& input_batch, uint8_t* tuple_data) {
     // convert input_batch.tuple_offsets into pointers
     int tuple_idx = 0;
     for (auto offset : input_batch.tuple_offsets()) {
@@ -178,7 +266,7 @@ RowBatch::RowBatch(const RowDescriptor& row_desc, const TRowBatch& input_batch,
     _tuple_ptrs_size = _num_rows * input_batch.row_tuples.size() * sizeof(Tuple*);
     DCHECK_GT(_tuple_ptrs_size, 0);
     // TODO: switch to Init() pattern so we can check memory limit and return Status.
-    if (config::enable_partitioned_aggregation || config::enable_new_partitioned_aggregation) {
+    if (config::enable_new_partitioned_aggregation) {
         _mem_tracker->consume(_tuple_ptrs_size);
         _tuple_ptrs = reinterpret_cast<Tuple**>(malloc(_tuple_ptrs_size));
         DCHECK(_tuple_ptrs != NULL);
@@ -272,7 +360,7 @@ void RowBatch::clear() {
     for (int i = 0; i < _blocks.size(); ++i) {
         _blocks[i]->del();
     }
-    if (config::enable_partitioned_aggregation || config::enable_new_partitioned_aggregation) {
+    if (config::enable_new_partitioned_aggregation) {
         DCHECK(_tuple_ptrs != NULL);
         free(_tuple_ptrs);
         _mem_tracker->release(_tuple_ptrs_size);
@@ -352,7 +440,7 @@ int RowBatch::serialize(TRowBatch* output_batch) {
     return get_batch_size(*output_batch) - output_batch->tuple_data.size() + size;
 }
 
-int RowBatch::serialize(PRowBatch* output_batch) {
+void RowBatch::_serialize_rows(PRowBatch* output_batch, char* tuple_data, int size) {
     // num_rows
     output_batch->set_num_rows(_num_rows);
     // row_tuples
@@ -362,15 +450,10 @@ int RowBatch::serialize(PRowBatch* output_batch) {
     output_batch->mutable_tuple_offsets()->Reserve(_num_rows * _num_tuples_per_row);
     // is_compressed
     output_batch->set_is_compressed(false);
-    // tuple data
-    int size = total_byte_size();
-    auto mutable_tuple_data = output_batch->mutable_tuple_data();
-    mutable_tuple_data->resize(size);
 
-    // Copy tuple data, including strings, into output_batch (converting string
+    // Copy tuple data, including strings, into tuple_data (converting string
     // pointers into offsets in the process)
-    int offset = 0; // current offset into output_batch->tuple_data
-    char* tuple_data = const_cast<char*>(mutable_tuple_data->data());
+    int offset = 0; // current offset into tuple_data
     for (int i = 0; i < _num_rows; ++i) {
         TupleRow* row = get_row(i);
         const vector<TupleDescriptor*>& tuple_descs = _row_desc.tuple_descriptors();
@@ -389,6 +472,25 @@ int RowBatch::serialize(PRowBatch* output_batch) {
     }
 
     DCHECK_EQ(offset, size);
+}
+
+int RowBatch::serialize(PRowBatch* output_batch, std::string* tuple_data) {
+    tuple_data->resize(total_byte_size());
+    serialize(output_batch, const_cast<char*>(tuple_data->data()), tuple_data->size());
+    return tuple_data->size();
+}
+
+void RowBatch::serialize(PRowBatch* output_batch, char* tuple_data, int size) {
+    _serialize_rows(output_batch, tuple_data, size);
+    // tuple_data is a required field
+    output_batch->set_tuple_data("");
+}
+
+int RowBatch::serialize(PRowBatch* output_batch) {
+    auto mutable_tuple_data = output_batch->mutable_tuple_data();
+    int size = total_byte_size();
+    mutable_tuple_data->resize(size);
+    _serialize_rows(output_batch, const_cast<char*>(mutable_tuple_data->data()), size);
 
     if (config::compress_rowbatches && size > 0) {
         // Try compressing tuple_data to _compression_scratch, swap if compressed data is
@@ -481,7 +583,7 @@ void RowBatch::reset() {
     }
     _blocks.clear();
     _auxiliary_mem_usage = 0;
-    if (!config::enable_partitioned_aggregation && !config::enable_new_partitioned_aggregation) {
+    if (!config::enable_new_partitioned_aggregation) {
         _tuple_ptrs = reinterpret_cast<Tuple**>(_tuple_data_pool->allocate(_tuple_ptrs_size));
     }
     _need_to_return = false;
@@ -526,7 +628,7 @@ void RowBatch::transfer_resource_ownership(RowBatch* dest) {
     _blocks.clear();
     dest->_need_to_return |= _need_to_return;
     _auxiliary_mem_usage = 0;
-    if (!config::enable_partitioned_aggregation && !config::enable_new_partitioned_aggregation) {
+    if (!config::enable_new_partitioned_aggregation) {
         _tuple_ptrs = NULL;
     }
 
@@ -578,7 +680,7 @@ void RowBatch::acquire_state(RowBatch* src) {
     _num_rows = src->_num_rows;
     _capacity = src->_capacity;
     _need_to_return = src->_need_to_return;
-    if (!config::enable_partitioned_aggregation && !config::enable_new_partitioned_aggregation) {
+    if (!config::enable_new_partitioned_aggregation) {
         // Tuple pointers are allocated from tuple_data_pool_ so are transferred.
         _tuple_ptrs = src->_tuple_ptrs;
         src->_tuple_ptrs = NULL;
@@ -589,6 +691,20 @@ void RowBatch::acquire_state(RowBatch* src) {
     src->transfer_resource_ownership(this);
 }
 
+void RowBatch::deep_copy_to(RowBatch* dst) {
+    DCHECK(dst->_row_desc.equals(_row_desc));
+    DCHECK_EQ(dst->_num_rows, 0);
+    DCHECK_GE(dst->_capacity, _num_rows);
+    dst->add_rows(_num_rows);
+    for (int i = 0; i < _num_rows; ++i) {
+        TupleRow* src_row = get_row(i);
+        TupleRow* dst_row = dst->get_row(i);
+        src_row->deep_copy(dst_row, _row_desc.tuple_descriptors(),
+                           dst->_tuple_data_pool.get(), false);
+    }
+    dst->commit_rows(_num_rows);
+}
+
 void RowBatch::swap(RowBatch* other) {
     DCHECK(_row_desc.equals(other->_row_desc));
     DCHECK_EQ(_num_tuples_per_row, other->_num_tuples_per_row);
@@ -601,7 +717,7 @@ void RowBatch::swap(RowBatch* other) {
     std::swap(_has_in_flight_row, other->_has_in_flight_row);
     std::swap(_num_rows, other->_num_rows);
     std::swap(_capacity, other->_capacity);
-    if (!config::enable_partitioned_aggregation && !config::enable_new_partitioned_aggregation) {
+    if (!config::enable_new_partitioned_aggregation) {
         // Tuple pointers are allocated from tuple_data_pool_ so are transferred.
         _tuple_ptrs = other->_tuple_ptrs;
         other->_tuple_ptrs = NULL;
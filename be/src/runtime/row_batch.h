@@ -32,6 +32,10 @@
 #include "runtime/mem_pool.h"
 #include "runtime/row_batch_interface.hpp"
 
+namespace butil {
+class IOBuf;
+}
+
 namespace doris {
 
 class BufferedTupleStream2;
@@ -40,6 +44,8 @@ class Tuple;
 class TupleRow;
 class TupleDescriptor;
 class PRowBatch;
+class BlockCompressionCodec;
+class Slice;
 
 // A RowBatch encapsulates a batch of rows, each composed of a number of tuples.
 // The maximum number of rows is fixed at the time of construction, and the caller
@@ -94,6 +100,16 @@ public:
 
     RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch, MemTracker* tracker);
 
+    // Populate a row batch from input_batch whose tuple data is carried in
+    // tuple_data instead of input_batch, e.g. rpc attachment. If codec is not
+    // null, tuple_data is compressed by it and is decompressed directly into
+    // the row batch's mempool, uncompressed_size is the size after decompression.
+    // Otherwise tuple_data is copied once from its blocks into the mempool.
+    // valid() should be checked after construction.
+    RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch,
+             const butil::IOBuf& tuple_data, const BlockCompressionCodec* codec,
+             size_t uncompressed_size, MemTracker* tracker);
+
     // Releases all resources accumulated at this row batch.  This includes
     //  - tuple_ptrs
     //  - tuple mem pool data
@@ -370,6 +386,19 @@ public:
     int serialize(TRowBatch* output_batch);
     int serialize(PRowBatch* output_batch);
 
+    // Like serialize(PRowBatch*), but tuple data is not compressed and is put in
+    // tuple_data instead of output_batch, so that it can be sent separately from
+    // the protobuf message. Returns the size of tuple data.
+    int serialize(PRowBatch* output_batch, std::string* tuple_data);
+
+    // Like serialize(PRowBatch*, std::string*), but tuple data is written to
+    // tuple_data whose size must be total_byte_size(), so that the caller can
+    // hand over the buffer, e.g. to an rpc attachment, without copying it.
+    void serialize(PRowBatch* output_batch, char* tuple_data, int size);
+
+    // false if tuple data is corrupted when constructed from PRowBatch
+    bool valid() const { return _valid; }
+
     // Utility function: returns total size of batch.
     static int get_batch_size(const TRowBatch& batch);
     static int get_batch_size(const PRowBatch& batch);
@@ -423,6 +452,14 @@ public:
         return _scanner_id;
     }
 
+    // NUMA node of the thread that first filled this batch, -1 if unknown
+    void set_numa_node(int node) {
+        _numa_node = node;
+    }
+    int numa_node() const {
+        return _numa_node;
+    }
+
     // Computes the maximum size needed to store tuple data for this row batch.
     int max_tuple_buffer_size();
 
@@ -435,6 +472,27 @@ private:
     // Close owned tuple streams and delete if needed.
     void close_tuple_streams();
 
+    // Allocate _tuple_ptrs for rows constructed from PRowBatch.
+    void _alloc_tuple_ptrs();
+
+    // Convert tuple offsets of input_batch and string offsets in tuple_data
+    // into pointers.
+    void _convert_offsets_to_pointers(const PRowBatch& input_batch, uint8_t* tuple_data);
+
+    // Serialize rows except tuple data into output_batch, and tuple data into tuple_data
+    // whose size must be total_byte_size().
+    void _serialize_rows(PRowBatch* output_batch, char* tuple_data, int size);
+
+    // Decompress tuple data by codec into the mempool, returns null if failed.
+    uint8_t* _decompress_tuple_data(const Slice& tuple_data, const BlockCompressionCodec* codec,
+                                    size_t uncompressed_size);
+
+    // Check tuple offsets of input_batch against the tuple data of data_size bytes,
+    // and convert them into pointers if valid.
+    void _init_from_tuple_data(const PRowBatch& input_batch, uint8_t* data, size_t data_size);
+
+    bool _valid = true;
+
     // All members need to be handled in RowBatch::swap()
 
     bool _has_in_flight_row;  // if true, last row hasn't been committed yet
@@ -458,7 +516,7 @@ private:
     // The memory ownership depends on whether legacy joins and aggs are enabled.
     //
     // Memory is malloc'd and owned by RowBatch:
-    // If enable_partitioned_hash_join=true and enable_partitioned_aggregation=true
+    // If enable_new_partitioned_aggregation=true
     // then the memory is owned by this RowBatch and is freed upon its destruction.
     // This mode is more performant especially with SubplanNodes in the ExecNode tree
     // because the tuple pointers are not transferred and do not have to be re-created
@@ -512,6 +570,7 @@ private:
     std::string _compression_scratch;
 
     int _scanner_id;
+    int _numa_node = -1;
     bool _cleared = false;
 };
 
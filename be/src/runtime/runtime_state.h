@@ -60,6 +60,7 @@ class LoadErrorHub;
 class ReservationTracker;
 class InitialReservations;
 class RowDescriptor;
+class QueryTrace;
 
 // A collection of items that are part of the global state of a
 // query and shared across all execution nodes of that query.
@@ -440,6 +441,15 @@ public:
         _num_rows_load_unselected.fetch_add(num_rows);
     }
 
+    // bytes spilled to disk by the operators of this fragment instance
+    int64_t spill_bytes() const {
+        return _spill_bytes.load();
+    }
+
+    void update_spill_bytes(int64_t bytes) {
+        _spill_bytes.fetch_add(bytes);
+    }
+
     void export_load_error(const std::string& error_msg);
 
     void set_per_fragment_instance_idx(int idx) {
@@ -474,6 +484,19 @@ public:
         return _query_options.disable_stream_preaggregations;
     }
 
+    bool enable_perf_counters() const {
+        return _query_options.enable_perf_counters;
+    }
+
+    // nullptr unless enable_query_trace is set in query options, see SCOPED_TRACE_SPAN
+    QueryTrace* query_trace() const {
+        return _query_trace.get();
+    }
+
+    void set_query_trace(std::shared_ptr<QueryTrace> query_trace) {
+        _query_trace = std::move(query_trace);
+    }
+
      // the following getters are only valid after Prepare()
     InitialReservations* initial_reservations() const { 
         return _initial_reservations; 
@@ -602,6 +625,7 @@ private:
     std::atomic<int64_t> _num_rows_load_filtered;   // unqualified rows
     std::atomic<int64_t> _num_rows_load_unselected; // rows filtered by predicates
     std::atomic<int64_t> _num_print_error_rows;
+    std::atomic<int64_t> _spill_bytes{0};
 
     std::vector<std::string> _export_output_files;
 
@@ -617,6 +641,9 @@ private:
     std::string _error_log_file_path;
     std::ofstream* _error_log_file; // error file path, absolute path
     std::unique_ptr<LoadErrorHub> _error_hub;
+    // Protects _error_log_file and _error_hub, load scanners of one fragment append
+    // error rows from several threads
+    boost::mutex _error_log_file_lock;
     std::vector<TTabletCommitInfo> _tablet_commit_infos;
 
     //TODO chenhao , remove this to QueryState 
@@ -639,6 +666,9 @@ private:
     /// TODO: not needed if we call ReleaseResources() in a timely manner (IMPALA-1575).
     AtomicInt32 _initial_reservation_refcnt;
 
+    // shared by fragment instances of the query on this backend
+    std::shared_ptr<QueryTrace> _query_trace;
+
     // prohibit copies
     RuntimeState(const RuntimeState&);
 };
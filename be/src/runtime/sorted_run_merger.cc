@@ -17,6 +17,7 @@
 
 #include "runtime/sorted_run_merger.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "exprs/expr.h"
@@ -82,6 +83,11 @@ public:
         return Status::OK();
     }
 
+    // True once all rows of the run have been returned.
+    bool is_done() const {
+        return _input_row_batch == NULL;
+    }
+
     TupleRow* current_row() const {
         return _input_row_batch->get_row(_input_row_batch_index);
     }
@@ -102,29 +108,39 @@ private:
     SortedRunMerger* _parent;
 };
 
-void SortedRunMerger::heapify(int parent_index) {
-    int left_index = 2 * parent_index + 1;
-    int right_index = left_index + 1;
-    if (left_index >= _min_heap.size()) {
-        return;
+bool SortedRunMerger::run_less_than(int lhs, int rhs) const {
+    if (_runs[lhs]->is_done()) {
+        return false;
     }
-    int least_child = 0;
-    // Find the least child of parent.
-    if (right_index >= _min_heap.size() ||
-            _compare_less_than(_min_heap[left_index]->current_row(),
-                _min_heap[right_index]->current_row())) {
-        least_child = left_index;
-    } else {
-        least_child = right_index;
+    if (_runs[rhs]->is_done()) {
+        return true;
     }
+    return _compare_less_than(_runs[lhs]->current_row(), _runs[rhs]->current_row());
+}
 
-    // If the parent is out of place, swap it with the least child and invoke
-    // heapify recursively.
-    if (_compare_less_than(_min_heap[least_child]->current_row(),
-                _min_heap[parent_index]->current_row())) {
-        iter_swap(_min_heap.begin() + least_child, _min_heap.begin() + parent_index);
-        heapify(least_child);
+int SortedRunMerger::build_tree(int node) {
+    int num_runs = _runs.size();
+    if (node >= num_runs) {
+        return node - num_runs;
     }
+    int left_winner = build_tree(2 * node);
+    int right_winner = build_tree(2 * node + 1);
+    if (run_less_than(right_winner, left_winner)) {
+        _losers[node] = left_winner;
+        return right_winner;
+    }
+    _losers[node] = right_winner;
+    return left_winner;
+}
+
+void SortedRunMerger::replay_winner() {
+    int winner = _losers[0];
+    for (int node = (winner + _runs.size()) / 2; node > 0; node /= 2) {
+        if (run_less_than(_losers[node], winner)) {
+            std::swap(_losers[node], winner);
+        }
+    }
+    _losers[0] = winner;
 }
 
 SortedRunMerger::SortedRunMerger(const TupleRowComparator& compare_less_than,
@@ -137,35 +153,35 @@ SortedRunMerger::SortedRunMerger(const TupleRowComparator& compare_less_than,
     }
 
 Status SortedRunMerger::prepare(const vector<RunBatchSupplier>& input_runs) {
-    DCHECK_EQ(_min_heap.size(), 0);
-    _min_heap.reserve(input_runs.size());
+    DCHECK_EQ(_runs.size(), 0);
+    _runs.reserve(input_runs.size());
     BOOST_FOREACH(const RunBatchSupplier& input_run, input_runs) {
         BatchedRowSupplier* new_elem = _pool.add(new BatchedRowSupplier(this, input_run));
         DCHECK(new_elem != NULL);
         bool empty = false;
         RETURN_IF_ERROR(new_elem->init(&empty));
         if (!empty) {
-            _min_heap.push_back(new_elem);
+            _runs.push_back(new_elem);
         }
     }
 
-    // Construct the min heap from the sorted runs.
-    const int last_parent = (_min_heap.size() / 2) - 1;
-    for (int i = last_parent; i >= 0; --i) {
-        heapify(i);
+    // Play the initial tournament between the sorted runs.
+    if (!_runs.empty()) {
+        _losers.resize(_runs.size());
+        _losers[0] = build_tree(1);
     }
     return Status::OK();
 }
 
 Status SortedRunMerger::get_next(RowBatch* output_batch, bool* eos) {
     ScopedTimer<MonotonicStopWatch> timer(_get_next_timer);
-    if (_min_heap.empty()) {
+    if (_runs.empty() || _runs[_losers[0]]->is_done()) {
         *eos = true;
         return Status::OK();
     }
 
     while (!output_batch->at_capacity()) {
-        BatchedRowSupplier* min = _min_heap[0];
+        BatchedRowSupplier* min = _runs[_losers[0]];
         int output_row_index = output_batch->add_row();
         TupleRow* output_row = output_batch->get_row(output_row_index);
         if (_deep_copy_input) {
@@ -184,17 +200,14 @@ Status SortedRunMerger::get_next(RowBatch* output_batch, bool* eos) {
         // resource ownership if the input batch in min is exhausted.
         RETURN_IF_ERROR(min->next(_deep_copy_input ? NULL : output_batch,
                     &min_run_complete));
-        if (min_run_complete) {
-            // Remove the element from the heap.
-            iter_swap(_min_heap.begin(), _min_heap.end() - 1);
-            _min_heap.pop_back();
-            if (_min_heap.empty()) break;
+        replay_winner();
+        if (_runs[_losers[0]]->is_done()) {
+            // The winner is only an exhausted run once all runs are exhausted.
+            break;
         }
-
-        heapify(0);
     }
 
-    *eos = _min_heap.empty();
+    *eos = _runs[_losers[0]]->is_done();
     return Status::OK();
 }
 
@@ -54,8 +54,8 @@ public:
     ~SortedRunMerger() {}
 
     // Prepare this merger to merge and return rows from the sorted runs in 'input_runs'.
-    // Retrieves the first batch from each run and sets up the binary heap implementing
-    // the priority queue.
+    // Retrieves the first batch from each run and sets up the tournament tree
+    // implementing the priority queue.
     Status prepare(const std::vector<RunBatchSupplier>& input_runs);
 
     // Return the next batch of sorted rows from this merger.
@@ -68,18 +68,31 @@ public:
 private:
     class BatchedRowSupplier;
 
-    // Assuming the element at parent_index is the only out of place element in the heap,
-    // restore the heap property (i.e. swap elements so parent <= children).
-    void heapify(int parent_index);
-
-    // The binary min-heap used to merge rows from the sorted input runs. Since the heap is
-    // stored in a 0-indexed array, the 0-th element is the minimum element in the heap,
-    // and the children of the element at index i are 2*i+1 and 2*i+2. The heap property is
-    // that row of the parent element is <= the rows of the child elements according to the
-    // comparator _compare_less_than.
-    // The BatchedRowSupplier objects used in the _min_heap are owned by this
-    // SortedRunMerger instance.
-    std::vector<BatchedRowSupplier*> _min_heap;
+    // Returns true if the current row of _runs[lhs] sorts before the one of _runs[rhs].
+    // Exhausted runs sort after all rows.
+    bool run_less_than(int lhs, int rhs) const;
+
+    // Plays the matches of the subtree rooted at 'node' for the initial tree. Stores the
+    // loser of every match in _losers and returns the index of the winning run.
+    int build_tree(int node);
+
+    // Replays the matches from the leaf of the winner _losers[0] up to the root after
+    // it advanced to its next row.
+    void replay_winner();
+
+    // The sorted input runs. Runs stay at their index after they are exhausted, so the
+    // shape of the tree doesn't change. The BatchedRowSupplier objects are owned by
+    // this SortedRunMerger instance.
+    std::vector<BatchedRowSupplier*> _runs;
+
+    // Tournament (loser) tree over _runs. With k runs, leaf i is at position k + i
+    // (implicitly), the internal nodes are 1 .. k-1 and the children of node n are 2n
+    // and 2n+1. Each internal node holds the index of the run that lost the match
+    // played there, and _losers[0] holds the overall winner, i.e. the run with the
+    // smallest current row. Unlike a binary heap, which needs two comparisons per
+    // level to sift the new row down, advancing the winner replays exactly one match
+    // per level on its path to the root.
+    std::vector<int> _losers;
 
     // Row comparator. Returns true if lhs < rhs.
     TupleRowComparator _compare_less_than;
@@ -17,12 +17,21 @@
 
 #include "runtime/spill_sorter.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <string>
 #include <sstream>
 
 #include <boost/mem_fn.hpp>
+#include <boost/thread/thread.hpp>
 
+#include "common/config.h"
+#include "exprs/slot_ref.h"
 #include "runtime/buffered_block_mgr2.h"
+#include "runtime/datetime_value.h"
+#include "runtime/query_trace.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/sorted_run_merger.h"
@@ -246,19 +255,25 @@ private:
 class SpillSorter::TupleSorter {
 public:
     TupleSorter(const TupleRowComparator& less_than_comp, int64_t block_size,
-            int tuple_size, RuntimeState* state);
+            const TupleDescriptor* sort_tuple_desc, RuntimeState* state);
 
     ~TupleSorter();
 
     // Performs a quicksort for tuples in 'run' followed by an insertion sort to
-    // finish smaller blocks.
+    // finish smaller blocks. If 'helpers' is not empty, the run is first partitioned
+    // into independent ranges which this sorter and one thread per helper then take
+    // one by one and sort in parallel. Helpers must have their own comparator.
     // Returns early if _stste->is_cancelled() is true. No status
     // is returned - the caller must check for cancellation.
-    void sort(Run* run);
+    void sort(Run* run, const std::vector<TupleSorter*>& helpers);
 
 private:
     static const int INSERTION_THRESHOLD = 16;
 
+    // Number of ranges per thread a run is partitioned into for a parallel sort, more
+    // than one so that threads finishing early can take over the work of others.
+    static const int RANGES_PER_THREAD = 4;
+
     // Helper class used to iterate over tuples in a run during quick sort and insertion sort.
     class TupleIterator {
     public:
@@ -348,6 +363,27 @@ private:
     // Tuple comparator that returns true if lhs < rhs.
     const TupleRowComparator _less_than_comp;
 
+    // If the first ordering expr is a slot of the sort tuple with a type listed in
+    // init_prefix(), every tuple of the run gets a 64 bit normalized key prefix of that
+    // slot in '_prefixes', indexed like the tuples and moved along with them. Prefixes
+    // compare as unsigned integers in sort order, NULLs and the ordering direction
+    // included, so the comparator only has to be called when two prefixes are equal.
+    // If '_prefix_is_exact', equal prefixes mean equal rows and the comparator is not
+    // called at all.
+    const SlotDescriptor* _prefix_slot;
+    bool _prefix_is_asc;
+    bool _prefix_nulls_first;
+    bool _prefix_is_exact;
+    std::vector<uint64_t> _prefixes;
+
+    // Start of the prefixes of the run being sorted. Points into '_prefixes' of the
+    // sorter that computed them, which is not this one for the helpers of a parallel
+    // sort.
+    uint64_t* _prefix_data;
+
+    // Prefix of the tuple in _temp_tuple_buffer.
+    uint64_t _temp_prefix;
+
     // Runtime state instance to check for cancellation. Not owned.
     RuntimeState* const _state;
 
@@ -368,7 +404,8 @@ private:
     // tuples in the second group are >= pivot. Tuples are swapped in place to create the
     // groups and the index to the first element in the second group is returned.
     // Checks _state->is_cancelled() and returns early with an invalid result if true.
-    TupleIterator partition(TupleIterator first, TupleIterator last, Tuple* pivot);
+    TupleIterator partition(TupleIterator first, TupleIterator last, Tuple* pivot,
+            uint64_t pivot_prefix);
 
     // Performs a quicksort of rows in the range [first, last) followed by insertion sort
     // for smaller groups of elements.
@@ -376,7 +413,32 @@ private:
     void sort_helper(TupleIterator first, TupleIterator last);
 
     // Swaps tuples pointed to by left and right using the swap buffer.
-    void swap(uint8_t* left, uint8_t* right);
+    void swap(const TupleIterator& left, const TupleIterator& right);
+
+    // Sets up '_prefix_slot' and the other prefix members for 'sort_tuple_desc'.
+    void init_prefix(const TupleDescriptor* sort_tuple_desc);
+
+    // Computes the normalized key prefix of 'tuple'.
+    uint64_t compute_prefix(const Tuple* tuple) const;
+
+    uint64_t prefix(const TupleIterator& iter) const {
+        return _prefix_slot == NULL ? 0 : _prefix_data[iter._index];
+    }
+
+    // Returns true if the tuple 'lhs' with prefix 'lhs_prefix' sorts strictly before
+    // 'rhs'.
+    bool less_than(uint8_t* lhs, uint64_t lhs_prefix, uint8_t* rhs, uint64_t rhs_prefix) {
+        if (_prefix_slot != NULL) {
+            if (lhs_prefix != rhs_prefix) {
+                return lhs_prefix < rhs_prefix;
+            }
+            if (_prefix_is_exact) {
+                return false;
+            }
+        }
+        return _less_than_comp(reinterpret_cast<TupleRow*>(&lhs),
+                reinterpret_cast<TupleRow*>(&rhs));
+    }
 }; // class TupleSorter
 
 // SpillSorter::Run methods
@@ -570,6 +632,7 @@ void SpillSorter::Run::delete_all_blocks() {
 }
 
 Status SpillSorter::Run::unpin_all_blocks() {
+    SCOPED_TRACE_SPAN(_sorter->_state, "SortSpill", "spill");
     vector<BufferedBlockMgr2::Block*> sorted_var_len_blocks;
     sorted_var_len_blocks.reserve(_var_len_blocks.size());
     vector<StringValue*> string_values;
@@ -871,15 +934,22 @@ void SpillSorter::Run::copy_var_len_data_convert_offset(char* dest, int64_t offs
 // SpillSorter::TupleSorter methods.
 SpillSorter::TupleSorter::TupleSorter(
     const TupleRowComparator& comp, int64_t block_size,
-    int tuple_size, RuntimeState* state) :
-        _tuple_size(tuple_size),
-        _block_capacity(block_size / tuple_size),
-        _last_tuple_block_offset(tuple_size * ((block_size / tuple_size) - 1)),
+    const TupleDescriptor* sort_tuple_desc, RuntimeState* state) :
+        _tuple_size(sort_tuple_desc->byte_size()),
+        _block_capacity(block_size / _tuple_size),
+        _last_tuple_block_offset(_tuple_size * ((block_size / _tuple_size) - 1)),
         _less_than_comp(comp),
+        _prefix_slot(NULL),
+        _prefix_is_asc(true),
+        _prefix_nulls_first(false),
+        _prefix_is_exact(false),
+        _prefix_data(NULL),
+        _temp_prefix(0),
         _state(state) {
-    _temp_tuple_buffer = new uint8_t[tuple_size];
+    _temp_tuple_buffer = new uint8_t[_tuple_size];
     _temp_tuple_row = reinterpret_cast<TupleRow*>(&_temp_tuple_buffer);
-    _swap_buffer = new uint8_t[tuple_size];
+    _swap_buffer = new uint8_t[_tuple_size];
+    init_prefix(sort_tuple_desc);
 }
 
 SpillSorter::TupleSorter::~TupleSorter() {
@@ -887,10 +957,157 @@ SpillSorter::TupleSorter::~TupleSorter() {
     delete[] _swap_buffer;
 }
 
-void SpillSorter::TupleSorter::sort(Run* run) {
+void SpillSorter::TupleSorter::init_prefix(const TupleDescriptor* sort_tuple_desc) {
+    const std::vector<ExprContext*>& ordering_ctxs = _less_than_comp.key_expr_ctxs_lhs();
+    if (ordering_ctxs.empty() || !ordering_ctxs[0]->root()->is_slotref()) {
+        return;
+    }
+    SlotId slot_id = static_cast<SlotRef*>(ordering_ctxs[0]->root())->slot_id();
+    const SlotDescriptor* slot_desc = NULL;
+    for (const SlotDescriptor* slot : sort_tuple_desc->slots()) {
+        if (slot->id() == slot_id && slot->is_materialized()) {
+            slot_desc = slot;
+            break;
+        }
+    }
+    if (slot_desc == NULL) {
+        return;
+    }
+    switch (slot_desc->type().type) {
+    case TYPE_BOOLEAN:
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+        // These are encoded away from 0 and UINT64_MAX, so a NULL never has the
+        // prefix of a value and the prefix holds the whole key.
+        _prefix_is_exact = ordering_ctxs.size() == 1;
+        break;
+    case TYPE_BIGINT:
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+        break;
+    default:
+        // Floating point values don't have a total order consistent with
+        // RawValue::compare() (-0.0 == 0.0), and 128 bit values are not worth it.
+        return;
+    }
+    _prefix_slot = slot_desc;
+    _prefix_is_asc = _less_than_comp.is_asc()[0];
+    _prefix_nulls_first = _less_than_comp.nulls_first()[0] < 0;
+}
+
+uint64_t SpillSorter::TupleSorter::compute_prefix(const Tuple* tuple) const {
+    // NULLs sort at one end regardless of the ordering direction.
+    if (tuple->is_null(_prefix_slot->null_indicator_offset())) {
+        return _prefix_nulls_first ? 0 : std::numeric_limits<uint64_t>::max();
+    }
+    // Map the value to an unsigned integer which compares like RawValue::compare().
+    // Signed values are made unsigned by flipping the sign bit, narrow ones by moving
+    // them into [2^31, 3 * 2^31) so neither 0 nor UINT64_MAX, which NULLs use, can be
+    // hit even after inverting for a descending order.
+    const void* value = tuple->get_slot(_prefix_slot->tuple_offset());
+    uint64_t prefix = 0;
+    switch (_prefix_slot->type().type) {
+    case TYPE_BOOLEAN:
+        prefix = *reinterpret_cast<const bool*>(value) + (1LL << 32);
+        break;
+    case TYPE_TINYINT:
+        prefix = *reinterpret_cast<const int8_t*>(value) + (1LL << 32);
+        break;
+    case TYPE_SMALLINT:
+        prefix = *reinterpret_cast<const int16_t*>(value) + (1LL << 32);
+        break;
+    case TYPE_INT:
+        prefix = *reinterpret_cast<const int32_t*>(value) + (1LL << 32);
+        break;
+    case TYPE_BIGINT:
+        prefix = static_cast<uint64_t>(*reinterpret_cast<const int64_t*>(value)) ^ (1ULL << 63);
+        break;
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+        prefix = static_cast<uint64_t>(reinterpret_cast<const DateTimeValue*>(
+                    value)->to_int64_datetime_packed()) ^ (1ULL << 63);
+        break;
+    case TYPE_CHAR:
+    case TYPE_VARCHAR: {
+        // The first 8 bytes in big endian order, zero padded. A shorter string sorts
+        // before all of its extensions, so the padding keeps the order.
+        const StringValue* str = reinterpret_cast<const StringValue*>(value);
+        int len = std::min<int>(str->len, sizeof(uint64_t));
+        for (int i = 0; i < len; ++i) {
+            prefix |= static_cast<uint64_t>(static_cast<uint8_t>(str->ptr[i])) << (56 - 8 * i);
+        }
+        break;
+    }
+    default:
+        DCHECK(false) << "invalid type: " << _prefix_slot->type().type;
+    }
+    return _prefix_is_asc ? prefix : ~prefix;
+}
+
+void SpillSorter::TupleSorter::sort(Run* run, const std::vector<TupleSorter*>& helpers) {
     _run = run;
-    sort_helper(TupleIterator(this, 0), TupleIterator(this, _run->_num_tuples));
+    if (_prefix_slot != NULL) {
+        _prefixes.resize(_run->_num_tuples);
+        TupleIterator iter(this, 0);
+        for (int64_t i = 0; i < _run->_num_tuples; ++i, iter.next()) {
+            _prefixes[i] = compute_prefix(reinterpret_cast<Tuple*>(iter._current_tuple));
+        }
+    }
+    _prefix_data = _prefixes.data();
+    if (helpers.empty()) {
+        sort_helper(TupleIterator(this, 0), TupleIterator(this, _run->_num_tuples));
+    } else {
+        // Split the largest range around its middle tuple like sort_helper() does until
+        // there are enough ranges. Every tuple of a range sorts no later than the tuples
+        // of the ranges after it, so the ranges can be sorted independently.
+        typedef std::pair<int64_t, int64_t> Range;
+        auto range_size = [](const Range& range) { return range.second - range.first; };
+        auto smaller = [&range_size](const Range& lhs, const Range& rhs) {
+            return range_size(lhs) < range_size(rhs);
+        };
+        std::vector<Range> ranges(1, Range(0, _run->_num_tuples));
+        size_t num_ranges = (helpers.size() + 1) * RANGES_PER_THREAD;
+        while (ranges.size() < num_ranges && range_size(ranges.front()) > INSERTION_THRESHOLD
+                && !_state->is_cancelled()) {
+            std::pop_heap(ranges.begin(), ranges.end(), smaller);
+            Range range = ranges.back();
+            TupleIterator first(this, range.first);
+            TupleIterator iter(this, range.first + range_size(range) / 2);
+            TupleIterator cut = partition(first, TupleIterator(this, range.second),
+                    reinterpret_cast<Tuple*>(iter._current_tuple), prefix(iter));
+            ranges.back() = Range(range.first, cut._index);
+            std::push_heap(ranges.begin(), ranges.end(), smaller);
+            ranges.push_back(Range(cut._index, range.second));
+            std::push_heap(ranges.begin(), ranges.end(), smaller);
+        }
+        // Largest ranges first, so the last ones taken are small and threads finish
+        // at about the same time.
+        std::sort_heap(ranges.begin(), ranges.end(), smaller);
+        std::reverse(ranges.begin(), ranges.end());
+
+        std::atomic<size_t> next_range(0);
+        auto sort_ranges = [&ranges, &next_range](TupleSorter* sorter) {
+            for (size_t i = next_range++; i < ranges.size(); i = next_range++) {
+                sorter->sort_helper(TupleIterator(sorter, ranges[i].first),
+                        TupleIterator(sorter, ranges[i].second));
+            }
+        };
+        boost::thread_group threads;
+        for (TupleSorter* helper : helpers) {
+            helper->_run = _run;
+            helper->_prefix_data = _prefix_data;
+            threads.create_thread(std::bind(sort_ranges, helper));
+        }
+        sort_ranges(this);
+        threads.join_all();
+    }
     run->_is_sorted = true;
+    // Don't keep the prefixes of a large run around until the next one is sorted.
+    std::vector<uint64_t>().swap(_prefixes);
+    _prefix_data = NULL;
 }
 
 // Sort the sequence of tuples from [first, last).
@@ -908,6 +1125,7 @@ void SpillSorter::TupleSorter::insertion_sort(const TupleIterator& first,
         // be inserted into the sorted sequence. Copy to _temp_tuple_row since it may be
         // overwritten by the one at position 'insert_iter - 1'
         memcpy(_temp_tuple_buffer, insert_iter._current_tuple, _tuple_size);
+        _temp_prefix = prefix(insert_iter);
 
         // 'iter' points to the tuple that _temp_tuple_row will be compared to.
         // 'copy_to' is the where iter should be copied to if it is >= _temp_tuple_row.
@@ -915,10 +1133,15 @@ void SpillSorter::TupleSorter::insertion_sort(const TupleIterator& first,
         TupleIterator iter = insert_iter;
         iter.prev();
         uint8_t* copy_to = insert_iter._current_tuple;
-        while (_less_than_comp(_temp_tuple_row,
-                    reinterpret_cast<TupleRow*>(&iter._current_tuple))) {
+        int64_t copy_to_index = insert_iter._index;
+        while (less_than(_temp_tuple_buffer, _temp_prefix,
+                    iter._current_tuple, prefix(iter))) {
             memcpy(copy_to, iter._current_tuple, _tuple_size);
+            if (_prefix_slot != NULL) {
+                _prefix_data[copy_to_index] = _prefix_data[iter._index];
+            }
             copy_to = iter._current_tuple;
+            copy_to_index = iter._index;
             // Break if 'iter' has reached the first row, meaning that _temp_tuple_row
             // will be inserted in position 'first'
             if (iter._index <= first._index) {
@@ -928,24 +1151,27 @@ void SpillSorter::TupleSorter::insertion_sort(const TupleIterator& first,
         }
 
         memcpy(copy_to, _temp_tuple_buffer, _tuple_size);
+        if (_prefix_slot != NULL) {
+            _prefix_data[copy_to_index] = _temp_prefix;
+        }
     }
 }
 
 SpillSorter::TupleSorter::TupleIterator SpillSorter::TupleSorter::partition(
-        TupleIterator first, TupleIterator last, Tuple* pivot) {
+        TupleIterator first, TupleIterator last, Tuple* pivot, uint64_t pivot_prefix) {
     // Copy pivot into temp_tuple since it points to a tuple within [first, last).
     memcpy(_temp_tuple_buffer, pivot, _tuple_size);
+    _temp_prefix = pivot_prefix;
 
     last.prev();
     while (true) {
         // Search for the first and last out-of-place elements, and swap them.
-        while (_less_than_comp(
-                    reinterpret_cast<TupleRow*>(&first._current_tuple),
-                    _temp_tuple_row)) {
+        while (less_than(first._current_tuple, prefix(first),
+                    _temp_tuple_buffer, _temp_prefix)) {
             first.next();
         }
-        while (_less_than_comp(_temp_tuple_row,
-                    reinterpret_cast<TupleRow*>(&last._current_tuple))) {
+        while (less_than(_temp_tuple_buffer, _temp_prefix,
+                    last._current_tuple, prefix(last))) {
             last.prev();
         }
 
@@ -953,7 +1179,7 @@ SpillSorter::TupleSorter::TupleIterator SpillSorter::TupleSorter::partition(
             break;
         }
         // Swap first and last tuples.
-        swap(first._current_tuple, last._current_tuple);
+        swap(first, last);
 
         first.next();
         last.prev();
@@ -973,7 +1199,7 @@ void SpillSorter::TupleSorter::sort_helper(TupleIterator first, TupleIterator la
         // partition() splits the tuples in [first, last) into two groups (<= pivot
         // and >= pivot) in-place. 'cut' is the index of the first tuple in the second group.
         TupleIterator cut = partition(first, last,
-                reinterpret_cast<Tuple*>(iter._current_tuple));
+                reinterpret_cast<Tuple*>(iter._current_tuple), prefix(iter));
         sort_helper(cut, last);
         last = cut;
         if (UNLIKELY(_state->is_cancelled())) {
@@ -984,10 +1210,14 @@ void SpillSorter::TupleSorter::sort_helper(TupleIterator first, TupleIterator la
     insertion_sort(first, last);
 }
 
-inline void SpillSorter::TupleSorter::swap(uint8_t* left, uint8_t* right) {
-    memcpy(_swap_buffer, left, _tuple_size);
-    memcpy(left, right, _tuple_size);
-    memcpy(right, _swap_buffer, _tuple_size);
+inline void SpillSorter::TupleSorter::swap(
+        const TupleIterator& left, const TupleIterator& right) {
+    memcpy(_swap_buffer, left._current_tuple, _tuple_size);
+    memcpy(left._current_tuple, right._current_tuple, _tuple_size);
+    memcpy(right._current_tuple, _swap_buffer, _tuple_size);
+    if (_prefix_slot != NULL) {
+        std::swap(_prefix_data[left._index], _prefix_data[right._index]);
+    }
 }
 
 // SpillSorter methods
@@ -1026,6 +1256,9 @@ SpillSorter::~SpillSorter() {
         _unsorted_run->delete_all_blocks();
     }
     _block_mgr->clear_reservations(_block_mgr_client);
+    for (auto& ctxs : _helper_expr_ctxs) {
+        Expr::close(ctxs, _state);
+    }
 }
 
 Status SpillSorter::init() {
@@ -1033,7 +1266,7 @@ Status SpillSorter::init() {
     TupleDescriptor* sort_tuple_desc = _output_row_desc->tuple_descriptors()[0];
     _has_var_len_slots = sort_tuple_desc->has_varlen_slots();
     _in_mem_tuple_sorter.reset(new TupleSorter(_compare_less_than,
-                _block_mgr->max_block_size(), sort_tuple_desc->byte_size(), _state));
+                _block_mgr->max_block_size(), sort_tuple_desc, _state));
     _unsorted_run = _obj_pool.add(new Run(this, sort_tuple_desc, true));
 
     _initial_runs_counter = ADD_COUNTER(_profile, "InitialRunsCreated", TUnit::UNIT);
@@ -1175,7 +1408,29 @@ Status SpillSorter::sort_run() {
     }
     {
         SCOPED_TIMER(_in_mem_sort_timer);
-        _in_mem_tuple_sorter->sort(_unsorted_run);
+        int num_threads = 1;
+        if (_unsorted_run->_num_tuples >= config::sort_parallel_min_tuples) {
+            while (num_threads < config::sort_thread_num
+                    && _state->resource_pool()->try_acquire_thread_token()) {
+                ++num_threads;
+            }
+        }
+        vector<TupleSorter*> helpers;
+        if (num_threads > 1) {
+            Status status = create_sort_helpers(num_threads - 1);
+            if (status.ok()) {
+                for (int i = 0; i < num_threads - 1; ++i) {
+                    helpers.push_back(_helper_sorters[i].get());
+                }
+            } else {
+                LOG(WARNING) << "Sort run on one thread, failed to clone ordering exprs: "
+                    << status.get_error_msg();
+            }
+        }
+        _in_mem_tuple_sorter->sort(_unsorted_run, helpers);
+        for (int i = 1; i < num_threads; ++i) {
+            _state->resource_pool()->release_thread_token(false);
+        }
         RETURN_IF_CANCELLED(_state);
     }
     _sorted_runs.push_back(_unsorted_run);
@@ -1183,6 +1438,29 @@ Status SpillSorter::sort_run() {
     return Status::OK();
 }
 
+Status SpillSorter::create_sort_helpers(int num_helpers) {
+    TupleDescriptor* sort_tuple_desc = _output_row_desc->tuple_descriptors()[0];
+    vector<bool> nulls_first;
+    for (int8_t nulls_first_i : _compare_less_than.nulls_first()) {
+        nulls_first.push_back(nulls_first_i < 0);
+    }
+    while (_helper_sorters.size() < num_helpers) {
+        _helper_expr_ctxs.emplace_back();
+        vector<ExprContext*>* lhs_ctxs = &_helper_expr_ctxs.back();
+        RETURN_IF_ERROR(Expr::clone_if_not_exists(
+                _compare_less_than.key_expr_ctxs_lhs(), _state, lhs_ctxs));
+        _helper_expr_ctxs.emplace_back();
+        vector<ExprContext*>* rhs_ctxs = &_helper_expr_ctxs.back();
+        RETURN_IF_ERROR(Expr::clone_if_not_exists(
+                _compare_less_than.key_expr_ctxs_rhs(), _state, rhs_ctxs));
+        TupleRowComparator less_than(*lhs_ctxs, *rhs_ctxs,
+                _compare_less_than.is_asc(), nulls_first);
+        _helper_sorters.emplace_back(new TupleSorter(less_than,
+                _block_mgr->max_block_size(), sort_tuple_desc, _state));
+    }
+    return Status::OK();
+}
+
 uint64_t SpillSorter::estimate_merge_mem(
         uint64_t available_blocks, RowDescriptor* row_desc, int merge_batch_size) {
     bool has_var_len_slots = row_desc->tuple_descriptors()[0]->has_varlen_slots();
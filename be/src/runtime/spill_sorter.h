@@ -19,6 +19,8 @@
 #define DORIS_BE_SRC_RUNTIME_SPILL_SORTER_H
 
 #include <deque>
+#include <memory>
+#include <vector>
 
 #include "runtime/buffered_block_mgr2.h"
 #include "util/tuple_row_compare.h"
@@ -151,6 +153,10 @@ private:
     // blocks at the end of the run. Updates the sort bytes counter if necessary.
     Status sort_run();
 
+    // Creates helper TupleSorters for a parallel in-memory sort until there are
+    // 'num_helpers' of them.
+    Status create_sort_helpers(int num_helpers);
+
     // Runtime state instance used to check for cancellation. Not owned.
     RuntimeState* const _state;
 
@@ -158,6 +164,14 @@ private:
     TupleRowComparator _compare_less_than;
     boost::scoped_ptr<TupleSorter> _in_mem_tuple_sorter;
 
+    // TupleSorters for the extra threads of a parallel in-memory sort, created by the
+    // first one. ExprContexts can't be evaluated on several threads at once, so each
+    // of them compares with its own clones of the ordering exprs in
+    // _helper_expr_ctxs, lhs and rhs ones. A deque keeps them at the same address for
+    // the comparators which reference them.
+    std::vector<std::unique_ptr<TupleSorter>> _helper_sorters;
+    std::deque<std::vector<ExprContext*>> _helper_expr_ctxs;
+
     // Block manager object used to allocate, pin and release runs. Not owned by SpillSorter.
     BufferedBlockMgr2* _block_mgr;
 
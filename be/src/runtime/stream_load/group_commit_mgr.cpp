@@ -0,0 +1,325 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/stream_load/group_commit_mgr.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "common/utils.h"
+#include "gen_cpp/FrontendService.h"
+#include "gen_cpp/FrontendService_types.h"
+#include "gen_cpp/HeartbeatService_types.h"
+#include "runtime/exec_env.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_context.h"
+#include "runtime/stream_load/stream_load_executor.h"
+#include "runtime/stream_load/stream_load_pipe.h"
+#include "util/frontend_helper.h"
+#include "util/time.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+#ifdef BE_TEST
+TStreamLoadPutResult k_group_commit_put_result;
+#endif
+
+struct GroupCommitMgr::GroupLoad {
+    std::string key;
+    int64_t begin_ms = 0;
+    // context of the load of this group, owned by this group
+    StreamLoadContext* ctx = nullptr;
+    std::shared_ptr<StreamLoadPipe> pipe;
+
+    // serializes data of small loads, so that rows of each are appended whole
+    std::mutex append_lock;
+    // protected by append_lock, no data can be appended after it's closed
+    bool closed = false;
+    int64_t append_bytes = 0;
+    int64_t num_loads = 0;
+
+    // protected by GroupCommitMgr::_lock
+    bool commit_scheduled = false;
+
+    // result of this group, statistics are valid after the result is set
+    std::promise<Status> promise;
+    std::shared_future<Status> result = promise.get_future().share();
+    int64_t txn_id = -1;
+    std::string label;
+    int64_t number_total_rows = 0;
+    int64_t number_loaded_rows = 0;
+    int64_t number_filtered_rows = 0;
+    int64_t number_unselected_rows = 0;
+    std::string error_url;
+};
+
+GroupCommitMgr::GroupCommitMgr(ExecEnv* exec_env)
+        : _exec_env(exec_env),
+        _commit_pool(8, 1024) {
+    _check_thread = std::thread([this] {
+        std::unique_lock<std::mutex> l(_lock);
+        while (!_stopped) {
+            _cond.wait_for(l, std::chrono::milliseconds(
+                    std::max(config::group_commit_interval_ms / 4, 10)));
+            l.unlock();
+            _check_loads();
+            l.lock();
+        }
+    });
+}
+
+GroupCommitMgr::~GroupCommitMgr() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _stopped = true;
+    }
+    _cond.notify_all();
+    _check_thread.join();
+    _commit_pool.shutdown();
+    _commit_pool.join();
+}
+
+std::string GroupCommitMgr::_group_key(const StreamLoadContext* ctx) {
+    // loads are executed with the auth of the first load of a group, so
+    // only loads of the same user are grouped
+    const TStreamLoadPutRequest& request = ctx->put_request;
+    std::stringstream ss;
+    ss << ctx->db << '\1' << ctx->table
+        << '\1' << ctx->auth.user << '\1' << ctx->auth.passwd << '\1' << ctx->auth.cluster
+        << '\1' << ctx->max_filter_ratio << '\1' << request.formatType
+        << '\1' << (request.__isset.columns ? request.columns : "")
+        << '\1' << (request.__isset.where ? request.where : "")
+        << '\1' << (request.__isset.columnSeparator ? request.columnSeparator : "")
+        << '\1' << (request.__isset.partitions ? request.partitions : "")
+        << '\1' << (request.__isset.negative && request.negative);
+    return ss.str();
+}
+
+Status GroupCommitMgr::append_and_wait(StreamLoadContext* ctx, const GroupCommitBodySink& sink) {
+    std::shared_ptr<GroupLoad> load;
+    while (true) {
+        RETURN_IF_ERROR(_get_or_begin_load(ctx, &load));
+        std::lock_guard<std::mutex> l(load->append_lock);
+        if (load->closed) {
+            // the load is being committed, append to the next one
+            continue;
+        }
+        const ByteBufferPtr* last = nullptr;
+        for (auto& buf : sink.bufs()) {
+            if (!buf->has_remaining()) {
+                continue;
+            }
+            RETURN_IF_ERROR(load->pipe->append(buf));
+            load->append_bytes += buf->remaining();
+            last = &buf;
+        }
+        // rows of different loads must not be joined
+        if (last != nullptr && (*last)->ptr[(*last)->limit - 1] != '\n') {
+            RETURN_IF_ERROR(load->pipe->append("\n", 1));
+            load->append_bytes += 1;
+        }
+        load->num_loads++;
+        break;
+    }
+    if (load->append_bytes >= config::group_commit_data_bytes) {
+        _schedule_commit(load);
+    }
+
+    Status st = load->result.get();
+    ctx->txn_id = load->txn_id;
+    ctx->number_total_rows = load->number_total_rows;
+    ctx->number_loaded_rows = load->number_loaded_rows;
+    ctx->number_filtered_rows = load->number_filtered_rows;
+    ctx->number_unselected_rows = load->number_unselected_rows;
+    ctx->error_url = load->error_url;
+    if (!st.ok()) {
+        std::stringstream ss;
+        ss << "group commit load " << load->label << " failed: " << st.get_error_msg();
+        return Status::InternalError(ss.str());
+    }
+    return Status::OK();
+}
+
+Status GroupCommitMgr::_get_or_begin_load(StreamLoadContext* ctx,
+                                          std::shared_ptr<GroupLoad>* load) {
+    std::string key = _group_key(ctx);
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_stopped) {
+            return Status::InternalError("group commit is stopped");
+        }
+        auto it = _loads.find(key);
+        if (it != _loads.end()) {
+            *load = it->second;
+            return Status::OK();
+        }
+        // register the new load before it's begun, so that concurrent small
+        // loads wait for it instead of beginning their own
+        load->reset(new GroupLoad());
+        (*load)->key = key;
+        (*load)->begin_ms = MonotonicMillis();
+        _loads.emplace(key, *load);
+    }
+    // held until the load is begun, small loads of this group wait on it
+    std::lock_guard<std::mutex> l((*load)->append_lock);
+    Status st = _begin_load(ctx, *load);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to begin group commit load of table " << ctx->table
+            << ", errmsg=" << st.get_error_msg();
+        {
+            std::lock_guard<std::mutex> map_lock(_lock);
+            _loads.erase(key);
+        }
+        (*load)->closed = true;
+        (*load)->promise.set_value(st);
+        if ((*load)->ctx != nullptr && (*load)->ctx->unref()) {
+            delete (*load)->ctx;
+        }
+        (*load)->ctx = nullptr;
+    }
+    return st;
+}
+
+Status GroupCommitMgr::_begin_load(StreamLoadContext* ctx, std::shared_ptr<GroupLoad> load) {
+    StreamLoadContext* group_ctx = new StreamLoadContext(_exec_env);
+    group_ctx->ref();
+    load->ctx = group_ctx;
+    group_ctx->load_type = TLoadType::MANUL_LOAD;
+    group_ctx->load_src_type = TLoadSourceType::RAW;
+    group_ctx->db = ctx->db;
+    group_ctx->table = ctx->table;
+    group_ctx->auth = ctx->auth;
+    group_ctx->label = "group_commit_" + generate_uuid_string();
+    group_ctx->max_filter_ratio = ctx->max_filter_ratio;
+    group_ctx->format = ctx->format;
+    group_ctx->use_streaming = true;
+    load->label = group_ctx->label;
+    LOG(INFO) << "begin group commit load." << group_ctx->brief()
+        << ", db: " << group_ctx->db << ", tbl: " << group_ctx->table;
+
+    RETURN_IF_ERROR(_exec_env->stream_load_executor()->begin_txn(group_ctx));
+    load->txn_id = group_ctx->txn_id;
+
+    load->pipe = std::make_shared<StreamLoadPipe>();
+    RETURN_IF_ERROR(_exec_env->load_stream_mgr()->put(group_ctx->id, load->pipe));
+    group_ctx->body_sink = load->pipe;
+
+    TStreamLoadPutRequest request = ctx->put_request;
+    request.txnId = group_ctx->txn_id;
+    request.__set_loadId(group_ctx->id.to_thrift());
+    request.fileType = TFileType::FILE_STREAM;
+#ifndef BE_TEST
+    TNetworkAddress master_addr = _exec_env->master_info()->network_address;
+    RETURN_IF_ERROR(FrontendHelper::rpc(
+            master_addr.hostname, master_addr.port,
+            [&request, group_ctx] (FrontendServiceConnection& client) {
+                client->streamLoadPut(group_ctx->put_result, request);
+            }));
+#else
+    group_ctx->put_result = k_group_commit_put_result;
+#endif
+    Status plan_status(group_ctx->put_result.status);
+    if (!plan_status.ok()) {
+        LOG(WARNING) << "plan group commit load failed. errmsg=" << plan_status.get_error_msg()
+            << group_ctx->brief();
+        return plan_status;
+    }
+    return _exec_env->stream_load_executor()->execute_plan_fragment(group_ctx);
+}
+
+void GroupCommitMgr::_schedule_commit(const std::shared_ptr<GroupLoad>& load) {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (load->commit_scheduled) {
+            return;
+        }
+        load->commit_scheduled = true;
+        auto it = _loads.find(load->key);
+        if (it != _loads.end() && it->second == load) {
+            _loads.erase(it);
+        }
+    }
+    if (!_commit_pool.offer(std::bind(&GroupCommitMgr::_commit_load, this, load))) {
+        _commit_load(load);
+    }
+}
+
+void GroupCommitMgr::_check_loads() {
+    std::vector<std::shared_ptr<GroupLoad>> expired_loads;
+    int64_t now = MonotonicMillis();
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& it : _loads) {
+            if (now - it.second->begin_ms >= config::group_commit_interval_ms) {
+                expired_loads.push_back(it.second);
+            }
+        }
+    }
+    for (auto& load : expired_loads) {
+        _schedule_commit(load);
+    }
+}
+
+void GroupCommitMgr::_commit_load(std::shared_ptr<GroupLoad> load) {
+    {
+        std::lock_guard<std::mutex> l(load->append_lock);
+        if (load->closed) {
+            // failed to begin, result is already set
+            return;
+        }
+        load->closed = true;
+    }
+    StreamLoadContext* ctx = load->ctx;
+    Status st = ctx->body_sink->finish();
+    if (st.ok()) {
+        st = ctx->future.get();
+    }
+    if (st.ok()) {
+        st = _exec_env->stream_load_executor()->commit_txn(ctx);
+    }
+    ctx->load_cost_nanos = MonotonicNanos() - ctx->start_nanos;
+    if (!st.ok()) {
+        LOG(WARNING) << "group commit load failed, errmsg=" << st.get_error_msg()
+            << ctx->brief();
+        ctx->status = st;
+        if (ctx->need_rollback) {
+            _exec_env->stream_load_executor()->rollback_txn(ctx);
+            ctx->need_rollback = false;
+        }
+        ctx->body_sink->cancel();
+    } else {
+        LOG(INFO) << "group commit load committed." << ctx->brief()
+            << ", loads: " << load->num_loads << ", bytes: " << load->append_bytes
+            << ", cost_ms: " << ctx->load_cost_nanos / 1000000;
+    }
+    load->number_total_rows = ctx->number_total_rows;
+    load->number_loaded_rows = ctx->number_loaded_rows;
+    load->number_filtered_rows = ctx->number_filtered_rows;
+    load->number_unselected_rows = ctx->number_unselected_rows;
+    load->error_url = ctx->error_url;
+    load->promise.set_value(st);
+    load->ctx = nullptr;
+    if (ctx->unref()) {
+        delete ctx;
+    }
+}
+
+}
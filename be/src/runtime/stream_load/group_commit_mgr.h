@@ -0,0 +1,111 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "runtime/message_body_sink.h"
+#include "util/byte_buffer.h"
+#include "util/thread_pool.hpp"
+
+namespace doris {
+
+class ExecEnv;
+class StreamLoadContext;
+
+// Keep the whole body of a group commit load in memory, it's appended to the
+// load of its group after it is received completely.
+class GroupCommitBodySink : public MessageBodySink {
+public:
+    Status append(const char* data, size_t size) override {
+        auto buf = ByteBuffer::allocate(size);
+        buf->put_bytes(data, size);
+        buf->flip();
+        _bufs.push_back(std::move(buf));
+        return Status::OK();
+    }
+
+    Status append(const ByteBufferPtr& buf) override {
+        _bufs.push_back(buf);
+        return Status::OK();
+    }
+
+    const std::vector<ByteBufferPtr>& bufs() const { return _bufs; }
+
+private:
+    std::vector<ByteBufferPtr> _bufs;
+};
+
+// Small stream loads of the same table with the same load parameters are
+// committed together. Their data is appended into one in-flight load of the
+// table, which is executed by one plan fragment within one transaction, and
+// is committed when it has been open for group_commit_interval_ms or has
+// received group_commit_data_bytes. Every small load waits for the commit of
+// its group, so that it's acknowledged only after its data is committed.
+//
+// This turns many tiny transactions and rowsets into one per interval, at the
+// cost of the latency of waiting for the group, and of all loads of a group
+// failing together.
+class GroupCommitMgr {
+public:
+    GroupCommitMgr(ExecEnv* exec_env);
+    ~GroupCommitMgr();
+
+    // Append the body of ctx received by sink into the in-flight load of its
+    // table, and wait until that load is committed. ctx->put_request holds the
+    // parameters to plan the load.
+    Status append_and_wait(StreamLoadContext* ctx, const GroupCommitBodySink& sink);
+
+private:
+    struct GroupLoad;
+
+    // the key of loads which can be committed together
+    static std::string _group_key(const StreamLoadContext* ctx);
+
+    Status _get_or_begin_load(StreamLoadContext* ctx, std::shared_ptr<GroupLoad>* load);
+    Status _begin_load(StreamLoadContext* ctx, std::shared_ptr<GroupLoad> load);
+
+    // remove load from in-flight loads and commit it in thread pool
+    void _schedule_commit(const std::shared_ptr<GroupLoad>& load);
+    void _commit_load(std::shared_ptr<GroupLoad> load);
+
+    // check and schedule loads which have been open for group_commit_interval_ms
+    void _check_loads();
+
+private:
+    ExecEnv* _exec_env;
+
+    std::mutex _lock;
+    // group key -> in-flight load
+    std::unordered_map<std::string, std::shared_ptr<GroupLoad>> _loads;
+    bool _stopped = false;
+    std::condition_variable _cond;
+
+    std::thread _check_thread;
+    ThreadPool _commit_pool;
+};
+
+}
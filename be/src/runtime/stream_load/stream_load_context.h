@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <deque>
 #include <future>
+#include <mutex>
 #include <sstream>
 #include <rapidjson/prettywriter.h>
 
@@ -31,6 +33,7 @@
 #include "runtime/stream_load/load_stream_mgr.h"
 #include "runtime/stream_load/stream_load_executor.h"
 #include "service/backend_options.h"
+#include "util/byte_buffer.h"
 #include "util/string_util.h"
 #include "util/time.h"
 #include "util/uid_util.h"
@@ -155,6 +158,20 @@ public:
 
     std::shared_ptr<MessageBodySink> body_sink;
 
+    // Body received from HTTP but not taken by body_sink yet, because it was
+    // full. Reading from the client is paused until they are taken.
+    std::mutex body_lock;
+    std::deque<ByteBufferPtr> pending_body;
+    bool read_paused = false;
+    // set when the body is complete or the request is gone, after which the
+    // event loop doesn't touch pending_body any more
+    bool body_finished = false;
+
+    // if true, data of this load is committed together with other small loads
+    // of the same table by GroupCommitMgr, instead of in its own transaction
+    bool group_commit = false;
+    // parameters to plan this load, only kept for group commit
+    TStreamLoadPutRequest put_request;
     TStreamLoadPutResult put_result;
 
     std::vector<TTabletCommitInfo> commit_infos;
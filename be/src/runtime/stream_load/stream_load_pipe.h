@@ -19,6 +19,7 @@
 
 #include <condition_variable>
 #include <deque>
+#include <functional>
 #include <mutex>
 
 #include "exec/file_reader.h"
@@ -29,7 +30,9 @@
 namespace doris {
 
 // StreamLoadPipe use to transfer data from producer to consumer
-// Data in pip is stored in chunks.
+// Data in pip is stored in chunks. Chunks appended as ByteBuffer are queued
+// by reference, e.g. the ones wrapping libevent's input buffer, and the pipe
+// is bounded by the bytes of queued chunks instead of the number of them.
 class StreamLoadPipe : public MessageBodySink, public FileReader {
 public:
     StreamLoadPipe(size_t max_buffered_bytes = 1024 * 1024,
@@ -77,10 +80,39 @@ public:
         return _append(buf);
     }
 
+    Status try_append(const ByteBufferPtr& buf, bool* appended,
+                      std::function<void()> on_space) override {
+        if (_write_buf != nullptr) {
+            _write_buf->flip();
+            RETURN_IF_ERROR(_append(_write_buf));
+            _write_buf.reset();
+        }
+        {
+            std::unique_lock<std::mutex> l(_lock);
+            if (_cancelled) {
+                return Status::InternalError("cancelled");
+            }
+            if (!_buf_queue.empty() &&
+                    _buffered_bytes + buf->remaining() > _max_buffered_bytes) {
+                _on_space = std::move(on_space);
+                *appended = false;
+                return Status::OK();
+            }
+            _buf_queue.push_back(buf);
+            _buffered_bytes += buf->remaining();
+        }
+        *appended = true;
+        _get_cond.notify_one();
+        return Status::OK();
+    }
+
+    // Copy data out of the queued chunks. The lock is held across chunks and
+    // only released while waiting for the producer, so that reading a large
+    // block doesn't contend with the producer once per chunk.
     Status read(uint8_t* data, size_t* data_size, bool* eof) override {
         size_t bytes_read = 0;
+        std::unique_lock<std::mutex> l(_lock);
         while (bytes_read < *data_size) {
-            std::unique_lock<std::mutex> l(_lock);
             while (!_cancelled && !_finished && _buf_queue.empty()) {
                 _get_cond.wait(l);
             }
@@ -95,14 +127,15 @@ public:
                 *eof = (bytes_read == 0);
                 return Status::OK();
             }
-            auto buf = _buf_queue.front();
+            auto& buf = _buf_queue.front();
             size_t copy_size = std::min(*data_size - bytes_read, buf->remaining());
             buf->get_bytes((char*)data + bytes_read, copy_size);
             bytes_read += copy_size;
             if (!buf->has_remaining()) {
-                _buf_queue.pop_front();
                 _buffered_bytes -= buf->limit;
+                _buf_queue.pop_front();
                 _put_cond.notify_one();
+                _notify_space();
             }
         }
         DCHECK(bytes_read == *data_size)
@@ -156,6 +189,7 @@ public:
         {
             std::lock_guard<std::mutex> l(_lock);
             _cancelled = true;
+            _notify_space();
         }
         _get_cond.notify_all();
         _put_cond.notify_all();
@@ -181,6 +215,15 @@ private:
         return Status::OK();
     }
 
+    // must be called with _lock held
+    void _notify_space() {
+        if (_on_space) {
+            auto on_space = std::move(_on_space);
+            _on_space = nullptr;
+            on_space();
+        }
+    }
+
     // Blocking queue
     std::mutex _lock;
     size_t _buffered_bytes;
@@ -189,6 +232,8 @@ private:
     std::deque<ByteBufferPtr> _buf_queue;
     std::condition_variable _put_cond;
     std::condition_variable _get_cond;
+    // set by try_append() when the pipe is full
+    std::function<void()> _on_space;
 
     bool _finished;
     bool _cancelled;
@@ -57,14 +57,17 @@
 #include <vector>
 #include <cstring>
 #include <boost/cstdint.hpp>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "common/logging.h"
 #include "runtime/string_value.h"
 
 namespace doris {
 
-// TODO: This can be sped up with SIDD_CMP_EQUAL_ORDERED or at the very least rewritten
-// from published algorithms.
+// Boyer-Moore-Horspool style search, with an SSE2 scan over candidate positions
+// where available.
 class StringSearch {
 
 public:
@@ -121,11 +124,34 @@ public:
         }
 
         // General case.
+        int i = 0;
+#ifdef __SSE2__
+        // Compare the first and the last char of the pattern against 16 positions at
+        // a time, and only compare the rest of the pattern at the positions where both
+        // match. The positions left over are handled by the loop below.
+        const __m128i first = _mm_set1_epi8(p[0]);
+        const __m128i last = _mm_set1_epi8(p[mlast]);
+        for (; i + 15 <= w; i += 16) {
+            const __m128i block_first =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            const __m128i block_last =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + mlast));
+            uint32_t mask = _mm_movemask_epi8(_mm_and_si128(
+                _mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+            while (mask != 0) {
+                int pos = i + __builtin_ctz(mask);
+                if (memcmp(s + pos + 1, p + 1, m - 2) == 0) {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+#endif
         int j;
         // TODO: the original code seems to have an off by one error. It is possible
         // to index at w + m which is the length of the input string. Checks have
         // been added to make sure that w + m < str->len.
-        for (int i = 0; i <= w; i++) {
+        for (; i <= w; i++) {
             // note: using mlast in the skip path slows things down on x86
             if (s[i + m - 1] == p[m - 1]) {
                 // candidate match
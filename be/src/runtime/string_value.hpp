@@ -67,6 +67,21 @@ static inline int string_compare(const char* s1, int n1, const char* s2, int n2,
     return n1 - n2;
 }
 
+// Number of leading bytes compared as one integer by string_prefix()
+static const int STRING_PREFIX_LEN = sizeof(uint64_t);
+
+// Returns the first min(len, STRING_PREFIX_LEN) bytes of s as a big-endian integer
+// padded with zeros, so that integers order like the byte strings they come from.
+static inline uint64_t string_prefix(const char* s, int len) {
+    uint64_t prefix = 0;
+    if (len >= STRING_PREFIX_LEN) {
+        memcpy(&prefix, s, STRING_PREFIX_LEN);
+    } else {
+        memcpy(&prefix, s, len);
+    }
+    return __builtin_bswap64(prefix);
+}
+
 inline int StringValue::compare(const StringValue& other) const {
     int l = std::min(len, other.len);
 
@@ -81,15 +96,34 @@ inline int StringValue::compare(const StringValue& other) const {
         }
     }
 
-    return string_compare(this->ptr, this->len, other.ptr, other.len, l);
+    // Most strings differ in their first bytes, and short strings have no more
+    // bytes to compare, so the prefixes decide without the byte loop.
+    uint64_t prefix1 = string_prefix(this->ptr, l);
+    uint64_t prefix2 = string_prefix(other.ptr, l);
+    if (prefix1 != prefix2) {
+        return prefix1 < prefix2 ? -1 : 1;
+    }
+    if (l <= STRING_PREFIX_LEN) {
+        return this->len - other.len;
+    }
+    return string_compare(this->ptr + STRING_PREFIX_LEN, this->len - STRING_PREFIX_LEN,
+                          other.ptr + STRING_PREFIX_LEN, other.len - STRING_PREFIX_LEN,
+                          l - STRING_PREFIX_LEN);
 }
 
 inline bool StringValue::eq(const StringValue& other) const {
     if (this->len != other.len) {
         return false;
     }
-
-    return string_compare(this->ptr, this->len, other.ptr, other.len, this->len) == 0;
+    if (this->len <= STRING_PREFIX_LEN) {
+        return string_prefix(this->ptr, this->len) == string_prefix(other.ptr, other.len);
+    }
+    if (string_prefix(this->ptr, this->len) != string_prefix(other.ptr, other.len)) {
+        return false;
+    }
+    int rest = this->len - STRING_PREFIX_LEN;
+    return string_compare(this->ptr + STRING_PREFIX_LEN, rest,
+                          other.ptr + STRING_PREFIX_LEN, rest, rest) == 0;
 }
 
 inline StringValue StringValue::substring(int start_pos) const {
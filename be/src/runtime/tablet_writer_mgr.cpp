@@ -17,35 +17,73 @@
 
 #include "runtime/tablet_writer_mgr.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <map>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 
+#include <boost/filesystem.hpp>
+
 #include "common/object_pool.h"
 #include "exec/tablet_info.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/row_batch.h"
 #include "runtime/tuple_row.h"
 #include "service/backend_options.h"
+#include "service/brpc.h"
 #include "util/bitmap.h"
+#include "util/block_compression.h"
+#include "util/brpc_stub_cache.h"
+#include "util/count_down_latch.hpp"
+#include "util/ref_count_closure.h"
 #include "util/stopwatch.hpp"
+#include "util/thread_pool.hpp"
+#include "olap/data_dir.h"
 #include "olap/delta_writer.h"
 #include "olap/lru_cache.h"
+#include "olap/olap_meta.h"
 
 namespace doris {
 
+// an add batch request which is handled, or parked in TabletsChannel until
+// the packets before it are added
+struct AddBatchPacket {
+    const PTabletWriterAddBatchRequest* request = nullptr;
+    google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec = nullptr;
+    const butil::IOBuf* attachment = nullptr;
+    TabletWriterMgr::AddBatchCallback callback;
+    int64_t wait_lock_time_ns = 0;
+};
+
 // channel that process all data for this load
 class TabletsChannel {
 public:
-    TabletsChannel(const TabletsChannelKey& key) : _key(key), _closed_senders(64) { }
+    TabletsChannel(const TabletsChannelKey& key, MemTracker* memtable_mem_tracker)
+        : _key(key), _closed_senders(64), _memtable_mem_tracker(memtable_mem_tracker) { }
     ~TabletsChannel();
 
     Status open(const PTabletWriterOpenRequest& params);
 
-    Status add_batch(const PTabletWriterAddBatchRequest& batch);
+    // Packets of one sender may arrive out of order when sender has multiple
+    // packets in flight, they are added in order of packet_seq. Return true
+    // if packet is moved into the channel to wait for packets before it,
+    // the thread handling the last of them pops and handles it then.
+    bool park_packet(AddBatchPacket* packet);
+
+    // Pop a parked packet of sender which can be handled now, that is the
+    // next one in order of sender, or any one after a packet failed.
+    bool pop_parked_packet(int sender_id, AddBatchPacket* packet);
 
-    Status close(int sender_id, bool* finished,
+    // if pool is not null, rows of different tablets are written in pool
+    // in parallel
+    Status add_batch(const PTabletWriterAddBatchRequest& batch,
+                     const butil::IOBuf* attachment, ThreadPool* pool);
+
+    Status close(int sender_id, int64_t packet_seq, bool* finished,
         const google::protobuf::RepeatedField<int64_t>& partition_ids,
         google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec);
 
@@ -53,20 +91,39 @@ public:
         return _last_updated_time;
     }
 
+    // append memory consumption of memtables of all tablets to mem_consumptions
+    void get_mem_consumptions(std::vector<std::pair<int64_t, int64_t>>* mem_consumptions);
+
+    // flush memtables of tablets and wait them finish
+    void flush_memtables(const std::vector<int64_t>& tablet_ids);
+
 private:
     // open all writer
     Status _open_all_writers(const PTabletWriterOpenRequest& params);
 
+    Status _add_batch(const PTabletWriterAddBatchRequest& batch,
+                      const butil::IOBuf* attachment, ThreadPool* pool);
+
+    // In single replica load, ask followers of closed writers to pull the
+    // rowsets, and add followers succeed to pull into tablet infos. Each writer
+    // is paired with the index of its first tablet info in tablet_vec.
+    void _send_rowsets_to_followers(const std::vector<std::pair<DeltaWriter*, int>>& writers,
+                                    google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec);
+
 private:
     // id of this load channel, just for 
     TabletsChannelKey _key;
 
     // make execute sequece
     std::mutex _lock;
+    // status of the first failed packet, packets after it will fail
+    Status _add_batch_status;
 
     // initialized in open function
     int64_t _txn_id = -1;
     int64_t _index_id = -1;
+    PUniqueId _load_id;
+    bool _need_gen_rollup = false;
     OlapTableSchemaParam* _schema = nullptr;
     TupleDescriptor* _tuple_desc = nullptr;
     // row_desc used to construct
@@ -76,22 +133,35 @@ private:
     // next sequence we expect
     int _num_remaining_senders = 0;
     std::vector<int64_t> _next_seqs;
+    // sender id -> packet seq -> packet arrived before its former packets
+    std::vector<std::map<int64_t, AddBatchPacket>> _parked_packets;
     Bitmap _closed_senders;
     Status _close_status;
 
     // tablet_id -> TabletChannel
     std::unordered_map<int64_t, DeltaWriter*> _tablet_writers;
+    // tablet_id -> replicas which receive rowset from this one in single replica load
+    std::unordered_map<int64_t, std::vector<PTabletReplica>> _tablet_followers;
 
     std::unordered_set<int64_t> _partition_ids;
 
     // TODO(zc): to add this tracker to somewhere
     MemTracker _mem_tracker;
+    // tracker of memtables of all loads, owned by TabletWriterMgr
+    MemTracker* _memtable_mem_tracker;
 
     //use to erase timeout TabletsChannel in _tablets_channels
     time_t _last_updated_time;
 };
 
 TabletsChannel::~TabletsChannel() {
+    // packets whose former packets never arrive, sender has given up them
+    for (auto& packets : _parked_packets) {
+        for (auto& it : packets) {
+            it.second.callback(Status::Cancelled("tablets channel is closed"),
+                               it.second.wait_lock_time_ns);
+        }
+    }
     for (auto& it : _tablet_writers) {
         delete it.second;
     }
@@ -108,6 +178,8 @@ Status TabletsChannel::open(const PTabletWriterOpenRequest& params) {
     LOG(INFO) << "open tablets channel: " << _key;
     _txn_id = params.txn_id();
     _index_id = params.index_id();
+    _load_id = params.id();
+    _need_gen_rollup = params.need_gen_rollup();
     _schema = new OlapTableSchemaParam();
     RETURN_IF_ERROR(_schema->init(params.schema()));
     _tuple_desc = _schema->tuple_desc();
@@ -115,6 +187,7 @@ Status TabletsChannel::open(const PTabletWriterOpenRequest& params) {
 
     _num_remaining_senders = params.num_senders();
     _next_seqs.resize(_num_remaining_senders, 0);
+    _parked_packets.resize(_num_remaining_senders);
     _closed_senders.Reset(_num_remaining_senders);
 
     RETURN_IF_ERROR(_open_all_writers(params));
@@ -124,10 +197,58 @@ Status TabletsChannel::open(const PTabletWriterOpenRequest& params) {
     return Status::OK();
 }
 
-Status TabletsChannel::add_batch(const PTabletWriterAddBatchRequest& params) {
-    DCHECK(params.tablet_ids_size() == params.row_batch().num_rows());
+bool TabletsChannel::park_packet(AddBatchPacket* packet) {
+    std::lock_guard<std::mutex> l(_lock);
+    int sender_id = packet->request->sender_id();
+    int64_t packet_seq = packet->request->packet_seq();
+    if (!_opened || !_add_batch_status.ok() || sender_id < 0
+            || sender_id >= _next_seqs.size() || packet_seq <= _next_seqs[sender_id]) {
+        return false;
+    }
+    auto& packets = _parked_packets[sender_id];
+    if (packets.count(packet_seq) > 0) {
+        // a duplicated packet is handled, and fails as a lost packet
+        return false;
+    }
+    packets.emplace(packet_seq, std::move(*packet));
+    return true;
+}
+
+bool TabletsChannel::pop_parked_packet(int sender_id, AddBatchPacket* packet) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (sender_id < 0 || sender_id >= _parked_packets.size()) {
+        return false;
+    }
+    auto& packets = _parked_packets[sender_id];
+    if (packets.empty()) {
+        return false;
+    }
+    auto it = packets.begin();
+    if (_add_batch_status.ok() && it->first > _next_seqs[sender_id]) {
+        return false;
+    }
+    *packet = std::move(it->second);
+    packets.erase(it);
+    return true;
+}
+
+Status TabletsChannel::add_batch(const PTabletWriterAddBatchRequest& params,
+                                 const butil::IOBuf* attachment, ThreadPool* pool) {
     std::lock_guard<std::mutex> l(_lock);
     DCHECK(_opened);
+    if (!_add_batch_status.ok()) {
+        return _add_batch_status;
+    }
+    auto st = _add_batch(params, attachment, pool);
+    if (!st.ok()) {
+        _add_batch_status = st;
+    }
+    return st;
+}
+
+Status TabletsChannel::_add_batch(const PTabletWriterAddBatchRequest& params,
+                                  const butil::IOBuf* attachment, ThreadPool* pool) {
+    DCHECK(params.tablet_ids_size() == params.row_batch().num_rows());
     auto next_seq = _next_seqs[params.sender_id()];
     // check packet
     if (params.packet_seq() < next_seq) {
@@ -140,22 +261,78 @@ Status TabletsChannel::add_batch(const PTabletWriterAddBatchRequest& params) {
         return Status::InternalError("lost data packet");
     }
 
-    RowBatch row_batch(*_row_desc, params.row_batch(), &_mem_tracker);
+    std::unique_ptr<RowBatch> row_batch;
+    if (params.has_attachment_compression_type()) {
+        if (attachment == nullptr) {
+            return Status::InternalError("tuple data is not found in attachment");
+        }
+        BlockCompressionCodec* codec = nullptr;
+        RETURN_IF_ERROR(get_block_compression_codec(
+                (segment_v2::CompressionTypePB)params.attachment_compression_type(), &codec));
+        row_batch.reset(new RowBatch(*_row_desc, params.row_batch(), *attachment,
+                                     codec, params.attachment_uncompressed_size(), &_mem_tracker));
+        if (!row_batch->valid()) {
+            return Status::InternalError("corrupted tuple data in attachment");
+        }
+    } else {
+        row_batch.reset(new RowBatch(*_row_desc, params.row_batch(), &_mem_tracker));
+    }
+    if (row_batch->num_rows() != params.tablet_ids_size()) {
+        return Status::InternalError("number of rows and tablet ids does not match");
+    }
 
-    // iterator all data
+    // rows of every tablet, tablets are kept in the order they first appear
+    std::vector<std::pair<DeltaWriter*, std::vector<int>>> tablet_rows;
+    std::unordered_map<int64_t, size_t> tablet_to_idx;
     for (int i = 0; i < params.tablet_ids_size(); ++i) {
         auto tablet_id = params.tablet_ids(i);
-        auto it = _tablet_writers.find(tablet_id);
-        if (it == std::end(_tablet_writers)) {
-            std::stringstream ss;
-            ss << "unknown tablet to append data, tablet=" << tablet_id;
-            return Status::InternalError(ss.str());
+        auto idx_it = tablet_to_idx.find(tablet_id);
+        if (idx_it == std::end(tablet_to_idx)) {
+            auto it = _tablet_writers.find(tablet_id);
+            if (it == std::end(_tablet_writers)) {
+                std::stringstream ss;
+                ss << "unknown tablet to append data, tablet=" << tablet_id;
+                return Status::InternalError(ss.str());
+            }
+            idx_it = tablet_to_idx.emplace(tablet_id, tablet_rows.size()).first;
+            tablet_rows.emplace_back(it->second, std::vector<int>());
         }
-        auto st = it->second->write(row_batch.get_row(i)->get_tuple(0));
-        if (st != OLAP_SUCCESS) {
+        tablet_rows[idx_it->second].second.push_back(i);
+    }
+
+    std::vector<OLAPStatus> statuses(tablet_rows.size(), OLAP_SUCCESS);
+    auto write_tablet = [&tablet_rows, &statuses, &row_batch](size_t idx) {
+        DeltaWriter* writer = tablet_rows[idx].first;
+        for (int row : tablet_rows[idx].second) {
+            statuses[idx] = writer->write(row_batch->get_row(row)->get_tuple(0));
+            if (statuses[idx] != OLAP_SUCCESS) {
+                return;
+            }
+        }
+    };
+    if (pool == nullptr || tablet_rows.size() <= 1) {
+        for (size_t i = 0; i < tablet_rows.size(); ++i) {
+            write_tablet(i);
+        }
+    } else {
+        CountDownLatch latch(tablet_rows.size());
+        for (size_t i = 0; i < tablet_rows.size(); ++i) {
+            auto task = [&write_tablet, &latch, i] {
+                write_tablet(i);
+                latch.count_down();
+            };
+            if (!pool->offer(task)) {
+                task();
+            }
+        }
+        latch.await();
+    }
+
+    for (size_t i = 0; i < tablet_rows.size(); ++i) {
+        if (statuses[i] != OLAP_SUCCESS) {
             std::stringstream ss;
-            ss << "tablet writer write failed, tablet_id=" << it->first
-                << ", transaction_id=" << _txn_id << ", status=" <<  st;
+            ss << "tablet writer write failed, tablet_id=" << tablet_rows[i].first->tablet_id()
+                << ", transaction_id=" << _txn_id << ", status=" <<  statuses[i];
             LOG(WARNING) << ss.str();
             return Status::InternalError(ss.str() + ", be: " + BackendOptions::get_localhost());
         }
@@ -165,10 +342,14 @@ Status TabletsChannel::add_batch(const PTabletWriterAddBatchRequest& params) {
     return Status::OK();
 }
 
-Status TabletsChannel::close(int sender_id, bool* finished,
+Status TabletsChannel::close(int sender_id, int64_t packet_seq, bool* finished,
         const google::protobuf::RepeatedField<int64_t>& partition_ids,
         google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec) {
     std::lock_guard<std::mutex> l(_lock);
+    if (!_add_batch_status.ok()) {
+        *finished = false;
+        return _add_batch_status;
+    }
     if (_closed_senders.Get(sender_id)) {
         // Double close from one sender, just return OK
         *finished = (_num_remaining_senders == 0);
@@ -183,8 +364,12 @@ Status TabletsChannel::close(int sender_id, bool* finished,
     *finished = (_num_remaining_senders == 0);
     if (*finished) {
         // All senders are closed
+        std::vector<std::pair<DeltaWriter*, int>> closed_writers;
+        // rowset meta of all committed tablets is synced once
+        OlapMetaSyncScope sync_scope;
         for (auto& it : _tablet_writers) {
             if (_partition_ids.count(it.second->partition_id()) > 0) {
+                closed_writers.emplace_back(it.second, tablet_vec->size());
                 auto st = it.second->close(tablet_vec);
                 if (st != OLAP_SUCCESS) {
                     LOG(WARNING) << "close tablet writer failed, tablet_id=" << it.first
@@ -200,10 +385,146 @@ Status TabletsChannel::close(int sender_id, bool* finished,
                 }
             }
         }
+        if (sync_scope.finish() != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to sync meta of committed tablets, transaction_id=" << _txn_id;
+            _close_status = Status::InternalError("sync tablet meta failed");
+            return _close_status;
+        }
+        if (!_tablet_followers.empty()) {
+            _send_rowsets_to_followers(closed_writers, tablet_vec);
+        }
     }
     return Status::OK();
 }
 
+void TabletsChannel::_send_rowsets_to_followers(
+        const std::vector<std::pair<DeltaWriter*, int>>& writers,
+        google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec) {
+    struct PullRowsetCall {
+        int64_t node_id;
+        // range of tablet infos in tablet_vec
+        int begin;
+        int end;
+        RefCountClosure<PTabletWriterPullRowsetResult>* closure;
+    };
+    std::vector<PullRowsetCall> calls;
+    std::vector<std::string> snapshot_paths;
+    for (int i = 0; i < writers.size(); ++i) {
+        DeltaWriter* writer = writers[i].first;
+        auto it = _tablet_followers.find(writer->tablet_id());
+        if (it == std::end(_tablet_followers) || it->second.empty()) {
+            continue;
+        }
+        // link rowset files to snapshot path, then they are only downloaded
+        // from this path and won't be changed by compaction
+        TabletSharedPtr tablet = writer->tablet();
+        RowsetSharedPtr rowset = writer->cur_rowset();
+        std::stringstream path_ss;
+        path_ss << tablet->data_dir()->path() << SNAPSHOT_PREFIX << "/single_replica_load_"
+            << _txn_id << "_" << tablet->tablet_id() << "/";
+        std::string path = path_ss.str();
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(path, ec);
+        if (!boost::filesystem::create_directories(path, ec)) {
+            LOG(WARNING) << "fail to create snapshot path of rowset, path=" << path
+                << ", error=" << ec.message();
+            continue;
+        }
+        snapshot_paths.push_back(path);
+        if (rowset->link_files_to(path, rowset->rowset_id()) != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to link rowset files to snapshot path, path=" << path;
+            continue;
+        }
+
+        RowsetMetaPB rowset_meta_pb;
+        rowset->to_rowset_pb(&rowset_meta_pb);
+        PTabletWriterPullRowsetRequest request;
+        *request.mutable_id() = _load_id;
+        request.set_txn_id(_txn_id);
+        request.set_partition_id(writer->partition_id());
+        request.set_tablet_id(tablet->tablet_id());
+        request.set_schema_hash(tablet->schema_hash());
+        request.set_need_gen_rollup(_need_gen_rollup);
+        request.set_rowset_meta(rowset_meta_pb.SerializeAsString());
+        request.set_host(BackendOptions::get_localhost());
+        request.set_http_port(config::webserver_port);
+        request.set_path(path);
+
+        int end = (i + 1 < writers.size()) ? writers[i + 1].second : tablet_vec->size();
+        for (auto& follower : it->second) {
+            auto stub = ExecEnv::GetInstance()->brpc_stub_cache()->get_stub(
+                follower.host(), follower.brpc_port());
+            if (stub == nullptr) {
+                LOG(WARNING) << "get rpc stub failed, host=" << follower.host()
+                    << ", port=" << follower.brpc_port();
+                continue;
+            }
+            auto closure = new RefCountClosure<PTabletWriterPullRowsetResult>();
+            // one ref is released by rpc, the other by this function
+            closure->ref();
+            closure->ref();
+            closure->cntl.set_timeout_ms(config::tablet_writer_rpc_timeout_sec * 1000);
+            stub->tablet_writer_pull_rowset(&closure->cntl, &request,
+                                            &closure->result, closure);
+            calls.push_back({follower.node_id(), writers[i].second, end, closure});
+        }
+    }
+
+    for (auto& call : calls) {
+        call.closure->join();
+        if (call.closure->cntl.Failed()) {
+            LOG(WARNING) << "fail to send rowset to follower, node_id=" << call.node_id
+                << ", error=" << berror(call.closure->cntl.ErrorCode())
+                << ", error_text=" << call.closure->cntl.ErrorText();
+        } else if (!Status(call.closure->result.status()).ok()) {
+            LOG(WARNING) << "follower failed to pull rowset, node_id=" << call.node_id
+                << ", txn_id=" << _txn_id
+                << ", errmsg=" << Status(call.closure->result.status()).get_error_msg();
+        } else {
+            // failed followers are not reported, they are repaired by clone later
+            for (int i = call.begin; i < call.end; ++i) {
+                tablet_vec->Mutable(i)->add_follower_node_ids(call.node_id);
+            }
+        }
+        if (call.closure->unref()) {
+            delete call.closure;
+        }
+    }
+    for (auto& path : snapshot_paths) {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(path, ec);
+    }
+}
+
+void TabletsChannel::get_mem_consumptions(
+        std::vector<std::pair<int64_t, int64_t>>* mem_consumptions) {
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto& it : _tablet_writers) {
+        int64_t mem = it.second->mem_consumption();
+        if (mem > 0) {
+            mem_consumptions->emplace_back(mem, it.first);
+        }
+    }
+}
+
+void TabletsChannel::flush_memtables(const std::vector<int64_t>& tablet_ids) {
+    std::lock_guard<std::mutex> l(_lock);
+    std::vector<DeltaWriter*> writers;
+    for (auto tablet_id : tablet_ids) {
+        auto it = _tablet_writers.find(tablet_id);
+        if (it == std::end(_tablet_writers)) {
+            continue;
+        }
+        // failure is returned by later write or close of this writer
+        if (it->second->flush_memtable() == OLAP_SUCCESS) {
+            writers.push_back(it->second);
+        }
+    }
+    for (auto writer : writers) {
+        writer->wait_flush();
+    }
+}
+
 Status TabletsChannel::_open_all_writers(const PTabletWriterOpenRequest& params) {
     std::vector<SlotDescriptor*>* columns = nullptr;
     int32_t schema_hash = 0;
@@ -231,7 +552,7 @@ Status TabletsChannel::_open_all_writers(const PTabletWriterOpenRequest& params)
         request.tuple_desc = _tuple_desc;
 
         DeltaWriter* writer = nullptr;
-        auto st = DeltaWriter::open(&request, &writer);
+        auto st = DeltaWriter::open(&request, &writer, _memtable_mem_tracker);
         if (st != OLAP_SUCCESS) {
             LOG(WARNING) << "open delta writer failed, tablet_id=" << tablet.tablet_id()
                 << ", txn_id=" << _txn_id
@@ -240,12 +561,22 @@ Status TabletsChannel::_open_all_writers(const PTabletWriterOpenRequest& params)
             return Status::InternalError("open tablet writer failed");
         }
         _tablet_writers.emplace(tablet.tablet_id(), writer);
+        if (tablet.followers_size() > 0) {
+            _tablet_followers[tablet.tablet_id()].assign(
+                tablet.followers().begin(), tablet.followers().end());
+        }
     }
     DCHECK(_tablet_writers.size() == params.tablets_size());
     return Status::OK();
 }
 
 TabletWriterMgr::TabletWriterMgr(ExecEnv* exec_env) :_exec_env(exec_env) {
+    _mem_tracker.reset(new MemTracker(config::load_process_max_memory_limit_bytes,
+                                      "TabletWriterMgr"));
+    if (config::tablet_writer_add_batch_thread_num > 0) {
+        _add_batch_pool.reset(new ThreadPool(config::tablet_writer_add_batch_thread_num,
+                                             config::tablet_writer_add_batch_thread_num * 4));
+    }
     _tablets_channels.init(2011);
     _lastest_success_channel = new_lru_cache(1024);
 }
@@ -264,7 +595,7 @@ Status TabletWriterMgr::open(const PTabletWriterOpenRequest& params) {
             channel = *val;
         } else {
             // create a new 
-            channel.reset(new TabletsChannel(key));
+            channel.reset(new TabletsChannel(key, _mem_tracker.get()));
             _tablets_channels.insert(key, channel);
         }
     }
@@ -275,38 +606,68 @@ Status TabletWriterMgr::open(const PTabletWriterOpenRequest& params) {
 static void dummy_deleter(const CacheKey& key, void* value) {
 }
 
-Status TabletWriterMgr::add_batch(
+void TabletWriterMgr::add_batch(
         const PTabletWriterAddBatchRequest& request,
         google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec,
-        int64_t* wait_lock_time_ns) {
+        const butil::IOBuf* attachment,
+        AddBatchCallback callback) {
+    AddBatchPacket packet;
+    packet.request = &request;
+    packet.tablet_vec = tablet_vec;
+    packet.attachment = attachment;
+    packet.callback = std::move(callback);
+
     TabletsChannelKey key(request.id(), request.index_id());
     std::shared_ptr<TabletsChannel> channel;
     {
         MonotonicStopWatch timer;
         timer.start();
-        std::lock_guard<std::mutex> l(_lock);
-        *wait_lock_time_ns += timer.elapsed_time();
+        std::unique_lock<std::mutex> l(_lock);
+        packet.wait_lock_time_ns += timer.elapsed_time();
         auto value = _tablets_channels.seek(key);
         if (value == nullptr) {
             auto handle = _lastest_success_channel->lookup(key.to_string());
+            l.unlock();
             // success only when eos be true
             if (handle != nullptr && request.has_eos() && request.eos()) {
                 _lastest_success_channel->release(handle);
-                return Status::OK();
+                packet.callback(Status::OK(), packet.wait_lock_time_ns);
+                return;
+            }
+            if (handle != nullptr) {
+                _lastest_success_channel->release(handle);
             }
             std::stringstream ss;
             ss << "TabletWriter add batch with unknown id, key=" << key;
-            return Status::InternalError(ss.str());
+            packet.callback(Status::InternalError(ss.str()), packet.wait_lock_time_ns);
+            return;
         }
         channel = *value;
     }
+    if (channel->park_packet(&packet)) {
+        return;
+    }
+    // handle this packet, and then the parked packets of sender which follow it
+    int sender_id = request.sender_id();
+    do {
+        auto st = _handle_packet(key, channel.get(), &packet);
+        // request may be released by callback
+        packet.callback(st, packet.wait_lock_time_ns);
+    } while (channel->pop_parked_packet(sender_id, &packet));
+}
+
+Status TabletWriterMgr::_handle_packet(const TabletsChannelKey& key, TabletsChannel* channel,
+                                       AddBatchPacket* packet) {
+    const PTabletWriterAddBatchRequest& request = *packet->request;
     if (request.has_row_batch()) {
-        RETURN_IF_ERROR(channel->add_batch(request));
+        _handle_mem_exceed_limit();
+        RETURN_IF_ERROR(channel->add_batch(request, packet->attachment, _add_batch_pool.get()));
     }
     Status st;
     if (request.has_eos() && request.eos()) {
         bool finished = false;
-        st = channel->close(request.sender_id(), &finished, request.partition_ids(), tablet_vec);
+        st = channel->close(request.sender_id(), request.packet_seq(), &finished,
+                            request.partition_ids(), packet->tablet_vec);
         if (!st.ok()) {
             LOG(WARNING) << "channle close failed, key=" << key
                 << ", sender_id=" << request.sender_id()
@@ -316,7 +677,7 @@ Status TabletWriterMgr::add_batch(
             MonotonicStopWatch timer;
             timer.start();
             std::lock_guard<std::mutex> l(_lock);
-            *wait_lock_time_ns += timer.elapsed_time();
+            packet->wait_lock_time_ns += timer.elapsed_time();
             _tablets_channels.erase(key);
             if (st.ok()) {
                 auto handle = _lastest_success_channel->insert(
@@ -328,6 +689,61 @@ Status TabletWriterMgr::add_batch(
     return st;
 }
 
+void TabletWriterMgr::_handle_mem_exceed_limit() {
+    if (!_mem_tracker->limit_exceeded()) {
+        return;
+    }
+    // other threads wait here until memory is reduced
+    std::lock_guard<std::mutex> reduce_lock(_reduce_mem_lock);
+    if (!_mem_tracker->limit_exceeded()) {
+        return;
+    }
+    std::vector<std::shared_ptr<TabletsChannel>> channels;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& kv : _tablets_channels) {
+            channels.push_back(kv.second);
+        }
+    }
+
+    // (mem consumption, channel index, tablet id) of all memtables
+    std::vector<std::tuple<int64_t, size_t, int64_t>> tablets;
+    for (size_t i = 0; i < channels.size(); ++i) {
+        std::vector<std::pair<int64_t, int64_t>> mem_consumptions;
+        channels[i]->get_mem_consumptions(&mem_consumptions);
+        for (auto& mem : mem_consumptions) {
+            tablets.emplace_back(mem.first, i, mem.second);
+        }
+    }
+    std::sort(tablets.begin(), tablets.end(),
+              [](const std::tuple<int64_t, size_t, int64_t>& lhs,
+                 const std::tuple<int64_t, size_t, int64_t>& rhs) {
+        return std::get<0>(lhs) > std::get<0>(rhs);
+    });
+
+    // flush the largest memtables until memory is reduced to 80% of limit,
+    // so that flush is not triggered again by the next batch
+    int64_t mem_to_reduce = _mem_tracker->consumption() - _mem_tracker->limit() * 4 / 5;
+    std::vector<std::vector<int64_t>> tablets_to_flush(channels.size());
+    size_t num_flush = 0;
+    for (auto& tablet : tablets) {
+        if (mem_to_reduce <= 0) {
+            break;
+        }
+        tablets_to_flush[std::get<1>(tablet)].push_back(std::get<2>(tablet));
+        mem_to_reduce -= std::get<0>(tablet);
+        ++num_flush;
+    }
+    LOG(INFO) << "memory of memtables exceeds limit, consumption="
+        << _mem_tracker->consumption() << ", limit=" << _mem_tracker->limit()
+        << ", num memtables to flush=" << num_flush;
+    for (size_t i = 0; i < channels.size(); ++i) {
+        if (!tablets_to_flush[i].empty()) {
+            channels[i]->flush_memtables(tablets_to_flush[i]);
+        }
+    }
+}
+
 Status TabletWriterMgr::cancel(const PTabletWriterCancelRequest& params) {
     TabletsChannelKey key(params.id(), params.index_id());
     {
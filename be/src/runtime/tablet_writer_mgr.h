@@ -24,6 +24,7 @@
 #include <sstream>
 #include <thread>
 #include <ctime>
+#include <functional>
 
 #include "common/status.h"
 #include "gen_cpp/Types_types.h"
@@ -36,8 +37,11 @@
 
 namespace doris {
 
+struct AddBatchPacket;
 class ExecEnv;
+class MemTracker;
 class TabletsChannel;
+class ThreadPool;
 
 struct TabletsChannelKey {
     UniqueId id;
@@ -73,11 +77,22 @@ public:
     // open a new backend
     Status open(const PTabletWriterOpenRequest& request);
 
+    // called with status of an add batch request and the time waiting for
+    // the lock of channel map when the request is handled
+    typedef std::function<void(const Status& st, int64_t wait_lock_time_ns)> AddBatchCallback;
+
     // this batch must belong to a index in one transaction
     // when batch.
-    Status add_batch(const PTabletWriterAddBatchRequest& request,
-                     google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec,
-                     int64_t* wait_lock_time_ns);
+    // attachment is the rpc attachment of request, it holds tuple data if
+    // request.attachment_compression_type is set.
+    // callback is run before return, unless the request arrives before former
+    // packets of its sender. It's parked then without blocking this thread,
+    // and callback is run by the thread which adds the last packet before it.
+    // request, tablet_vec and attachment must be valid until callback is run.
+    void add_batch(const PTabletWriterAddBatchRequest& request,
+                   google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec,
+                   const butil::IOBuf* attachment,
+                   AddBatchCallback callback);
 
     // cancel all tablet stream for 'load_id' load
     // id: stream load's id
@@ -87,6 +102,13 @@ public:
 
 private:
     ExecEnv* _exec_env;
+    // memory of all memtables in this backend, it is declared before
+    // channels so it outlives all delta writers
+    std::unique_ptr<MemTracker> _mem_tracker;
+    // make only one thread reduce memory of memtables at one time
+    std::mutex _reduce_mem_lock;
+    // write rows of one batch to tablets in parallel, null if disabled
+    std::unique_ptr<ThreadPool> _add_batch_pool;
     // lock protect the channel map
     std::mutex _lock;
 
@@ -102,6 +124,14 @@ private:
     std::thread _tablets_channel_clean_thread;
 
     Status _start_tablets_channel_clean();
+
+    // flush the largest memtables of all loads if memory of memtables
+    // exceeds the limit
+    void _handle_mem_exceed_limit();
+
+    // add batch and close channel for sender if request is eos
+    Status _handle_packet(const TabletsChannelKey& key, TabletsChannel* channel,
+                          AddBatchPacket* packet);
 };
 
 std::ostream& operator<<(std::ostream& os, const TabletsChannelKey&);
@@ -184,7 +184,8 @@ Status UserFunctionCache::get_function_ptr(
         const std::string& url,
         const std::string& checksum,
         void** fn_ptr,
-        UserFunctionCacheEntry** output_entry) {
+        UserFunctionCacheEntry** output_entry,
+        bool optional) {
     auto symbol = get_real_symbol(orig_symbol);
     if (fid == 0) {
         // Just loading a function ptr in the current process. No need to take any locks.
@@ -215,7 +216,7 @@ Status UserFunctionCache::get_function_ptr(
             status = dynamic_lookup(entry->lib_handle, symbol.c_str(), fn_ptr);
             if (status.ok()) {
                 entry->fptr_map.emplace(symbol, *fn_ptr);
-            } else {
+            } else if (!optional) {
                 LOG(WARNING) << "fail to lookup symbol in library, symbol=" << symbol
                     << ", file=" << entry->lib_file;
             }
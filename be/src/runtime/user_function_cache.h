@@ -60,12 +60,15 @@ public:
     // cache entry if didn't need it.
     // If *entry is not true means that we should find symbol in this
     // entry.
+    // If optional is true, the symbol isn't required to exist, and it's not
+    // logged if it doesn't.
     Status get_function_ptr(int64_t fid,
                            const std::string& symbol,
                            const std::string& url,
                            const std::string& checksum,
                            void** fn_ptr,
-                           UserFunctionCacheEntry** entry);
+                           UserFunctionCacheEntry** entry,
+                           bool optional = false);
     void release_entry(UserFunctionCacheEntry* entry);
 
 private:
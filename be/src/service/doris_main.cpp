@@ -44,6 +44,7 @@
 #include "util/thrift_util.h"
 #include "util/thrift_server.h"
 #include "util/debug_util.h"
+#include "util/cpu_profiler.h"
 #include "agent/heartbeat_server.h"
 #include "agent/status.h"
 #include "agent/topic_subscriber.h"
@@ -146,6 +147,11 @@ int main(int argc, char** argv) {
     doris::init_daemon(argc, argv, paths);
 
     doris::ResourceTls::init();
+    auto profiler_st = doris::CpuProfiler::instance()->start(
+        doris::config::cpu_profile_sample_hz, doris::config::cpu_profile_buffer_samples);
+    if (!profiler_st.ok()) {
+        LOG(WARNING) << "fail to start cpu profiler: " << profiler_st.get_error_msg();
+    }
     if (!doris::BackendOptions::init()) {
         exit(-1);
     }
@@ -188,7 +194,8 @@ int main(int argc, char** argv) {
     }
 
     doris::HttpService http_service(
-        exec_env, doris::config::webserver_port, doris::config::webserver_num_workers);
+        exec_env, doris::config::webserver_port, doris::config::webserver_num_workers,
+        doris::config::webserver_num_data_plane_workers);
     status = http_service.start();
     if (!status.ok()) {
         LOG(ERROR) << "Doris Be http service did not start correctly, exiting";
@@ -23,6 +23,7 @@
 #include "http/action/metrics_action.h"
 #include "http/action/mini_load.h"
 #include "http/action/pprof_actions.h"
+#include "http/action/query_trace_action.h"
 #include "http/action/reload_tablet_action.h"
 #include "http/action/restore_tablet_action.h"
 #include "http/action/snapshot_action.h"
@@ -39,9 +40,9 @@
 
 namespace doris {
 
-HttpService::HttpService(ExecEnv* env, int port, int num_threads)
+HttpService::HttpService(ExecEnv* env, int port, int num_threads, int num_data_plane_threads)
         : _env(env),
-        _ev_http_server(new EvHttpServer(port, num_threads)),
+        _ev_http_server(new EvHttpServer(port, num_threads, num_data_plane_threads)),
         _web_page_handler(new WebPageHandler(_ev_http_server.get())) {
 }
 
@@ -86,6 +87,9 @@ Status HttpService::start() {
     // register pprof actions
     PprofActions::setup(_env, _ev_http_server.get());
 
+    // register query trace export
+    _ev_http_server->register_handler(HttpMethod::GET, "/api/query_trace", new QueryTraceAction());
+
     // register metrics
     {
         auto action = new MetricsAction(DorisMetrics::metrics());
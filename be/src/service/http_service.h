@@ -30,7 +30,7 @@ class WebPageHandler;
 // HTTP service for Doris BE
 class HttpService {
 public:
-    HttpService(ExecEnv* env, int port, int num_threads);
+    HttpService(ExecEnv* env, int port, int num_threads, int num_data_plane_threads = 0);
     ~HttpService();
 
     Status start();
@@ -20,10 +20,14 @@
 #include "common/config.h"
 #include "runtime/tablet_writer_mgr.h"
 #include "gen_cpp/BackendService.h"
+#include "olap/storage_engine.h"
+#include "olap/task/engine_pull_rowset_task.h"
 #include "runtime/exec_env.h"
 #include "runtime/data_stream_mgr.h"
 #include "runtime/fragment_mgr.h"
 #include "service/brpc.h"
+#include "util/doris_metrics.h"
+#include "util/stopwatch.hpp"
 #include "util/uid_util.h"
 #include "util/thrift_util.h"
 #include "runtime/buffer_control_block.h"
@@ -35,7 +39,8 @@ namespace doris {
 template<typename T>
 PInternalServiceImpl<T>::PInternalServiceImpl(ExecEnv* exec_env)
         : _exec_env(exec_env),
-        _tablet_worker_pool(config::number_tablet_writer_threads, 10240) {
+        _tablet_worker_pool(config::number_tablet_writer_threads, 10240),
+        _pull_rowset_pool(config::tablet_writer_pull_rowset_thread_num, 10240) {
 }
 
 template<typename T>
@@ -49,8 +54,18 @@ void PInternalServiceImpl<T>::transmit_data(google::protobuf::RpcController* cnt
                                          google::protobuf::Closure* done) {
     VLOG_ROW << "transmit data: fragment_instance_id=" << print_id(request->finst_id())
             << " node=" << request->node_id();
-    _exec_env->stream_mgr()->transmit_data(request, &done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    MonotonicStopWatch watch;
+    watch.start();
+    auto st = _exec_env->stream_mgr()->transmit_data(request, &cntl->request_attachment(), &done);
+    DorisMetrics::transmit_data_latency_us.add(watch.elapsed_time() / 1000);
+    if (!st.ok()) {
+        LOG(WARNING) << "transmit data failed, fragment_instance_id="
+            << print_id(request->finst_id()) << ", node=" << request->node_id()
+            << ", error=" << st.get_error_msg();
+    }
     if (done != nullptr) {
+        st.to_protobuf(response->mutable_status());
         done->Run();
     }
 }
@@ -88,6 +103,21 @@ void PInternalServiceImpl<T>::exec_plan_fragment(
     st.to_protobuf(response->mutable_status());
 }
 
+template<typename T>
+void PInternalServiceImpl<T>::exec_plan_fragment_batch(
+        google::protobuf::RpcController* cntl_base,
+        const PExecPlanFragmentRequest* request,
+        PExecPlanFragmentResult* response,
+        google::protobuf::Closure* done) {
+    brpc::ClosureGuard closure_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    auto st = _exec_plan_fragment_batch(cntl);
+    if (!st.ok()) {
+        LOG(WARNING) << "exec plan fragment batch failed, errmsg=" << st.get_error_msg();
+    }
+    st.to_protobuf(response->mutable_status());
+}
+
 template<typename T>
 void PInternalServiceImpl<T>::tablet_writer_add_batch(google::protobuf::RpcController* controller,
                                                    const PTabletWriterAddBatchRequest* request,
@@ -100,23 +130,28 @@ void PInternalServiceImpl<T>::tablet_writer_add_batch(google::protobuf::RpcContr
     // this will influence query execute, because of no bthread. So, we put this to 
     // a local thread pool to process
     _tablet_worker_pool.offer(
-        [request, response, done, this] () {
-            brpc::ClosureGuard closure_guard(done);
-            int64_t execution_time_ns = 0;
-            int64_t wait_lock_time_ns = 0;
-            { 
-                SCOPED_RAW_TIMER(&execution_time_ns);
-                auto st = _exec_env->tablet_writer_mgr()->add_batch(*request, response->mutable_tablet_vec(), &wait_lock_time_ns);
-                if (!st.ok()) {
-                    LOG(WARNING) << "tablet writer add batch failed, message=" << st.get_error_msg()
-                        << ", id=" << request->id()
-                        << ", index_id=" << request->index_id()
-                        << ", sender_id=" << request->sender_id();
-                }
-                st.to_protobuf(response->mutable_status());
-            }
-            response->set_execution_time_us(execution_time_ns / 1000);
-            response->set_wait_lock_time_us(wait_lock_time_ns / 1000);
+        [controller, request, response, done, this] () {
+            brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+            MonotonicStopWatch watch;
+            watch.start();
+            // a packet arriving before former packets of its sender is parked,
+            // and the callback is run later by the thread adding the last of them
+            _exec_env->tablet_writer_mgr()->add_batch(
+                *request, response->mutable_tablet_vec(), &cntl->request_attachment(),
+                [request, response, done, watch] (const Status& st, int64_t wait_lock_time_ns) {
+                    brpc::ClosureGuard closure_guard(done);
+                    if (!st.ok()) {
+                        LOG(WARNING) << "tablet writer add batch failed, message=" << st.get_error_msg()
+                            << ", id=" << request->id()
+                            << ", index_id=" << request->index_id()
+                            << ", sender_id=" << request->sender_id();
+                    }
+                    st.to_protobuf(response->mutable_status());
+                    int64_t execution_time_ns = watch.elapsed_time();
+                    response->set_execution_time_us(execution_time_ns / 1000);
+                    DorisMetrics::tablet_writer_add_batch_latency_us.add(execution_time_ns / 1000);
+                    response->set_wait_lock_time_us(wait_lock_time_ns / 1000);
+                });
         });
 }
 
@@ -137,6 +172,31 @@ void PInternalServiceImpl<T>::tablet_writer_cancel(google::protobuf::RpcControll
     }
 }
 
+template<typename T>
+void PInternalServiceImpl<T>::tablet_writer_pull_rowset(google::protobuf::RpcController* controller,
+                                                     const PTabletWriterPullRowsetRequest* request,
+                                                     PTabletWriterPullRowsetResult* response,
+                                                     google::protobuf::Closure* done) {
+    VLOG_RPC << "tablet writer pull rowset, id=" << request->id()
+        << ", tablet_id=" << request->tablet_id()
+        << ", txn_id=" << request->txn_id();
+    _pull_rowset_pool.offer(
+        [request, response, done, this] () {
+            brpc::ClosureGuard closure_guard(done);
+            EnginePullRowsetTask task(*request, _exec_env->master_info()->token);
+            Status st;
+            OLAPStatus res = StorageEngine::instance()->execute_task(&task);
+            if (res != OLAP_SUCCESS) {
+                LOG(WARNING) << "tablet writer pull rowset failed, res=" << res
+                    << ", id=" << request->id()
+                    << ", tablet_id=" << request->tablet_id()
+                    << ", txn_id=" << request->txn_id();
+                st = Status::InternalError("pull rowset failed");
+            }
+            st.to_protobuf(response->mutable_status());
+        });
+}
+
 template<typename T>
 Status PInternalServiceImpl<T>::_exec_plan_fragment(brpc::Controller* cntl) {
     auto ser_request = cntl->request_attachment().to_string();
@@ -151,6 +211,23 @@ Status PInternalServiceImpl<T>::_exec_plan_fragment(brpc::Controller* cntl) {
     return _exec_env->fragment_mgr()->exec_plan_fragment(t_request);
 }
 
+template<typename T>
+Status PInternalServiceImpl<T>::_exec_plan_fragment_batch(brpc::Controller* cntl) {
+    auto ser_request = cntl->request_attachment().to_string();
+    TExecPlanFragmentBatchParams t_request;
+    {
+        const uint8_t* buf = (const uint8_t*)ser_request.data();
+        uint32_t len = ser_request.size();
+        RETURN_IF_ERROR(deserialize_thrift_msg(buf, &len, false, &t_request));
+    }
+    LOG(INFO) << "exec plan fragment batch, query_id="
+        << (t_request.instance_params.empty()
+            ? "" : print_id(t_request.instance_params[0].query_id))
+        << ", num_instances=" << t_request.instance_params.size()
+        << ", coord=" << t_request.common.coord;
+    return _exec_env->fragment_mgr()->exec_plan_fragment_batch(&t_request);
+}
+
 template<typename T>
 void PInternalServiceImpl<T>::cancel_plan_fragment(
         google::protobuf::RpcController* cntl_base,
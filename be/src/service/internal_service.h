@@ -47,6 +47,12 @@ public:
         PExecPlanFragmentResult* result,
         google::protobuf::Closure* done) override;
 
+    void exec_plan_fragment_batch(
+        google::protobuf::RpcController* controller,
+        const PExecPlanFragmentRequest* request,
+        PExecPlanFragmentResult* result,
+        google::protobuf::Closure* done) override;
+
     void cancel_plan_fragment(
         google::protobuf::RpcController* controller,
         const PCancelPlanFragmentRequest* request,
@@ -74,6 +80,11 @@ public:
                               PTabletWriterCancelResult* response,
                               google::protobuf::Closure* done) override;
 
+    void tablet_writer_pull_rowset(google::protobuf::RpcController* controller,
+                                   const PTabletWriterPullRowsetRequest* request,
+                                   PTabletWriterPullRowsetResult* response,
+                                   google::protobuf::Closure* done) override;
+
     void trigger_profile_report(
         google::protobuf::RpcController* controller,
         const PTriggerProfileReportRequest* request,
@@ -88,9 +99,13 @@ public:
 
 private:
     Status _exec_plan_fragment(brpc::Controller* cntl);
+    Status _exec_plan_fragment_batch(brpc::Controller* cntl);
 private:
     ExecEnv* _exec_env;
     ThreadPool _tablet_worker_pool;
+    // replica writing data waits in _tablet_worker_pool until followers pull
+    // its rowset, so pulling is done in another pool to avoid dead lock
+    ThreadPool _pull_rowset_pool;
 };
 
 }
@@ -0,0 +1,716 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Runs one cumulative or base compaction of a tablet offline, either of a
+// tablet in a copy of a data dir, or of a synthetic tablet with overlapping
+// rowsets, and reports its throughput, amplification, peak memory and where
+// the time goes.
+//
+// The time is broken down by running the same input rowsets three times:
+//   read:            every input rowset is read by itself, block by block
+//   merge+aggregate: the input rowsets are merged and aggregated by Reader,
+//                    as Merger does, but rows are not written
+//   compaction:      the compaction itself, writing into a RowsetWriter
+// so that merge+aggregate is the second minus the first, and write is the
+// third minus the second. All of them run with warm caches, after a pass
+// which is not measured.
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <gflags/gflags.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "common/config.h"
+#include "common/status.h"
+#include "gen_cpp/AgentService_types.h"
+#include "olap/base_compaction.h"
+#include "olap/cumulative_compaction.h"
+#include "olap/delete_handler.h"
+#include "olap/olap_cond.h"
+#include "olap/options.h"
+#include "olap/reader.h"
+#include "olap/row_block.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset_factory.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/tablet_manager.h"
+#include "olap/utils.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/cpu_info.h"
+#include "util/stopwatch.hpp"
+
+using boost::filesystem::canonical;
+using boost::filesystem::path;
+
+DEFINE_string(operation, "synthetic", "valid operation: replay, synthetic");
+DEFINE_string(root_path, "", "storage root path, which is modified by the compaction");
+DEFINE_int64(tablet_id, 0, "tablet_id of the tablet to replay");
+DEFINE_int32(schema_hash, 0, "schema_hash of the tablet to replay");
+DEFINE_string(compaction_type, "cumulative", "compaction to run: cumulative or base");
+DEFINE_bool(warmup, true, "read the input rowsets once before measuring");
+DEFINE_string(keys_type, "dup", "keys type of the synthetic tablet: dup, agg or unique");
+DEFINE_int32(num_key_columns, 3, "number of INT key columns of the synthetic tablet");
+DEFINE_int32(num_value_columns, 4, "number of BIGINT value columns of the synthetic tablet");
+DEFINE_int32(num_rowsets, 10, "number of overlapping rowsets of the synthetic tablet");
+DEFINE_int64(rows_per_rowset, 100000, "number of rows of each synthetic rowset");
+DEFINE_string(key_distribution, "uniform", "distribution of synthetic keys: uniform or zipf");
+DEFINE_int64(key_cardinality, 1000000, "number of distinct synthetic keys");
+DEFINE_double(zipf_exponent, 0.99, "exponent of the zipf distribution of keys");
+DEFINE_string(output_json, "", "write the result into this file as JSON");
+
+namespace doris {
+
+static const int64_t kSyntheticTabletId = 10000;
+static const int32_t kSyntheticSchemaHash = 1111;
+static const int64_t kPartitionId = 10;
+static const uint64_t kSeed = 20191101;
+
+std::string get_usage(const std::string& progname) {
+    std::stringstream ss;
+    ss << progname << " runs a compaction of one tablet offline and measures it.\n";
+    ss << "Stop BE and copy its storage path first, the compaction modifies the copy.\n";
+    ss << "Usage:\n";
+    ss << "./compaction_tool --operation=replay --root_path=/path/to/copy/of/storage/path"
+          " --tablet_id=tabletid --schema_hash=schemahash --compaction_type=cumulative\n";
+    ss << "./compaction_tool --operation=synthetic --root_path=/path/to/scratch/dir"
+          " --keys_type=agg --num_rowsets=10 --rows_per_rowset=100000"
+          " --key_distribution=zipf --compaction_type=base\n";
+    return ss.str();
+}
+
+struct PassResult {
+    std::string name;
+    int64_t rows = 0;
+    int64_t real_ns = 0;
+    int64_t cpu_ns = 0;
+    int64_t peak_memory_bytes = 0;
+};
+
+struct CompactionResult {
+    std::string tablet;
+    std::string compaction_type;
+    bool by_linking = false;
+    int64_t num_input_rowsets = 0;
+    int64_t input_rows = 0;
+    int64_t input_bytes = 0;
+    // bytes of the input rowsets which are loaded, rather than compacted
+    int64_t loaded_bytes = 0;
+    int64_t output_rows = 0;
+    int64_t output_bytes = 0;
+    int64_t merged_rows = 0;
+    int64_t filtered_rows = 0;
+    OlapReaderStatistics reader_stats;
+    PassResult read;
+    PassResult merge;
+    PassResult compaction;
+};
+
+static int64_t process_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// return the value of 'field' in /proc/self/status in bytes, -1 if not found
+static int64_t proc_status_bytes(const std::string& field) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, field.size(), field) == 0 && line[field.size()] == ':') {
+            return atol(line.c_str() + field.size() + 1) * 1024L;
+        }
+    }
+    return -1;
+}
+
+// The peak RSS of the process is reset to the current RSS by writing 5 into
+// clear_refs, which is supported since Linux 4.0. Otherwise the peak is the
+// one since the process starts.
+static int64_t reset_peak_rss() {
+    std::ofstream out("/proc/self/clear_refs");
+    out << "5";
+    out.close();
+    int64_t rss = proc_status_bytes("VmRSS");
+    if (rss < 0) {
+        rss = 0;
+    }
+    return rss;
+}
+
+static int64_t peak_rss() {
+    int64_t peak = proc_status_bytes("VmHWM");
+    if (peak < 0) {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        peak = usage.ru_maxrss * 1024L;
+    }
+    return peak;
+}
+
+template<typename Func>
+static OLAPStatus measure(PassResult* result, Func func) {
+    int64_t base_rss = reset_peak_rss();
+    MonotonicStopWatch watch;
+    watch.start();
+    int64_t cpu_start = process_cpu_ns();
+    OLAPStatus res = func();
+    result->cpu_ns = process_cpu_ns() - cpu_start;
+    result->real_ns = watch.elapsed_time();
+    result->peak_memory_bytes = std::max<int64_t>(peak_rss() - base_rss, 0);
+    return res;
+}
+
+// Exposes the steps of CompactionType::compact(), which are protected, so
+// that input rowsets can be picked before the compaction is measured.
+template<typename CompactionType>
+class CompactionRunner : public CompactionType {
+public:
+    explicit CompactionRunner(TabletSharedPtr tablet) : CompactionType(tablet) { }
+
+    OLAPStatus pick_rowsets() {
+        if (is_cumulative()) {
+            RETURN_NOT_OK(this->_tablet->calculate_cumulative_point());
+        }
+        return this->pick_rowsets_to_compact();
+    }
+
+    OLAPStatus run() {
+        RETURN_NOT_OK(this->do_compaction());
+        this->_state = Compaction::SUCCESS;
+        if (is_cumulative()) {
+            this->_tablet->set_cumulative_layer_point(
+                this->_input_rowsets.back()->end_version() + 1);
+        }
+        return this->gc_unused_rowsets();
+    }
+
+    const std::vector<RowsetSharedPtr>& input_rowsets() const { return this->_input_rowsets; }
+    RowsetSharedPtr output_rowset() const { return this->_output_rowset; }
+    ReaderType reader_type() const { return this->compaction_type(); }
+    bool by_linking() {
+        return config::enable_ordered_data_compaction && this->is_input_rowsets_non_overlapping();
+    }
+
+private:
+    static bool is_cumulative() {
+        return std::is_same<CompactionType, CumulativeCompaction>::value;
+    }
+};
+
+// Read every rowset by itself, without merging them
+static OLAPStatus read_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
+                               const std::vector<RowsetSharedPtr>& rowsets, int64_t* rows) {
+    const TabletSchema& schema = tablet->tablet_schema();
+    std::vector<uint32_t> columns;
+    for (uint32_t i = 0; i < schema.num_columns(); ++i) {
+        columns.push_back(i);
+    }
+    std::set<uint32_t> load_bf_columns;
+    Conditions conditions;
+    conditions.set_tablet_schema(&schema);
+    std::vector<ColumnPredicate*> predicates;
+    std::vector<RowCursor*> keys;
+    std::vector<bool> keys_included;
+    DeleteHandler delete_handler;
+    OlapReaderStatistics stats;
+
+    RowsetReaderContext context;
+    context.reader_type = reader_type;
+    context.tablet_schema = &schema;
+    context.return_columns = &columns;
+    context.seek_columns = &columns;
+    context.load_bf_columns = &load_bf_columns;
+    context.conditions = &conditions;
+    context.predicates = &predicates;
+    context.lower_bound_keys = &keys;
+    context.is_lower_keys_included = &keys_included;
+    context.upper_bound_keys = &keys;
+    context.is_upper_keys_included = &keys_included;
+    context.delete_handler = &delete_handler;
+    context.stats = &stats;
+    context.lru_cache = StorageEngine::instance()->index_stream_lru_cache();
+
+    *rows = 0;
+    for (auto& rowset : rowsets) {
+        RowsetReaderSharedPtr rs_reader(rowset->create_reader());
+        RETURN_NOT_OK(rs_reader->init(&context));
+        RowBlock* block = nullptr;
+        while (true) {
+            OLAPStatus res = rs_reader->next_block(&block);
+            if (res == OLAP_ERR_DATA_EOF) {
+                break;
+            } else if (res != OLAP_SUCCESS) {
+                return res;
+            }
+            *rows += block->remaining();
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+// Merge and aggregate rowsets as Merger::merge() does, without writing rows
+static OLAPStatus merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
+                                const std::vector<RowsetSharedPtr>& rowsets,
+                                CompactionResult* result) {
+    ReaderParams reader_params;
+    reader_params.tablet = tablet;
+    reader_params.reader_type = reader_type;
+    for (auto& rowset : rowsets) {
+        reader_params.rs_readers.emplace_back(rowset->create_reader());
+    }
+    reader_params.version = Version(rowsets.front()->start_version(),
+                                    rowsets.back()->end_version());
+    Reader reader;
+    RETURN_NOT_OK(reader.init(reader_params));
+
+    RowCursor row_cursor;
+    RETURN_NOT_OK(row_cursor.init(tablet->tablet_schema()));
+    row_cursor.allocate_memory_for_string_type(tablet->tablet_schema());
+    bool eof = false;
+    int64_t rows = 0;
+    while (true) {
+        RETURN_NOT_OK(reader.next_row_with_aggregation(&row_cursor, &eof));
+        if (eof) {
+            break;
+        }
+        ++rows;
+    }
+    result->merge.rows = rows;
+    result->merged_rows = reader.merged_rows();
+    result->filtered_rows = reader.filtered_rows();
+    result->reader_stats = reader.stats();
+    return OLAP_SUCCESS;
+}
+
+template<typename CompactionType>
+static OLAPStatus run_compaction(TabletSharedPtr tablet, CompactionResult* result) {
+    CompactionRunner<CompactionType> runner(tablet);
+    OLAPStatus res = runner.pick_rowsets();
+    if (res != OLAP_SUCCESS) {
+        std::cout << "no rowsets to compact, status:" << res << std::endl;
+        return res;
+    }
+    const std::vector<RowsetSharedPtr>& rowsets = runner.input_rowsets();
+    result->tablet = tablet->full_name();
+    result->num_input_rowsets = rowsets.size();
+    result->by_linking = runner.by_linking();
+    for (auto& rowset : rowsets) {
+        result->input_rows += rowset->num_rows();
+        result->input_bytes += rowset->data_disk_size();
+        if (rowset->start_version() == rowset->end_version()) {
+            result->loaded_bytes += rowset->data_disk_size();
+        }
+    }
+
+    ReaderType reader_type = runner.reader_type();
+    if (FLAGS_warmup) {
+        int64_t rows = 0;
+        RETURN_NOT_OK(read_rowsets(tablet, reader_type, rowsets, &rows));
+    }
+    result->read.name = "read";
+    RETURN_NOT_OK(measure(&result->read, [&] {
+        return read_rowsets(tablet, reader_type, rowsets, &result->read.rows);
+    }));
+    result->merge.name = "merge+aggregate";
+    RETURN_NOT_OK(measure(&result->merge, [&] {
+        return merge_rowsets(tablet, reader_type, rowsets, result);
+    }));
+    result->compaction.name = "compaction";
+    RETURN_NOT_OK(measure(&result->compaction, [&] {
+        return runner.run();
+    }));
+
+    RowsetSharedPtr output = runner.output_rowset();
+    result->output_rows = output->num_rows();
+    result->output_bytes = output->data_disk_size();
+    result->compaction.rows = result->input_rows;
+    return OLAP_SUCCESS;
+}
+
+static TKeysType::type keys_type_from_flag() {
+    if (FLAGS_keys_type == "agg") {
+        return TKeysType::AGG_KEYS;
+    } else if (FLAGS_keys_type == "unique") {
+        return TKeysType::UNIQUE_KEYS;
+    }
+    return TKeysType::DUP_KEYS;
+}
+
+// Columns are named k<i> and v<i> for INT keys and BIGINT values
+static void create_tablet_request(TCreateTabletReq* request) {
+    TKeysType::type keys_type = keys_type_from_flag();
+    request->tablet_id = kSyntheticTabletId;
+    request->__set_version(1);
+    request->__set_version_hash(0);
+    request->tablet_schema.schema_hash = kSyntheticSchemaHash;
+    request->tablet_schema.short_key_column_count = std::min(FLAGS_num_key_columns, 3);
+    request->tablet_schema.keys_type = keys_type;
+    request->tablet_schema.storage_type = TStorageType::COLUMN;
+
+    for (int i = 0; i < FLAGS_num_key_columns; ++i) {
+        TColumn column;
+        column.column_name = "k" + std::to_string(i);
+        column.__set_is_key(true);
+        column.column_type.type = TPrimitiveType::INT;
+        request->tablet_schema.columns.push_back(column);
+    }
+    for (int i = 0; i < FLAGS_num_value_columns; ++i) {
+        TColumn column;
+        column.column_name = "v" + std::to_string(i);
+        column.__set_is_key(false);
+        column.column_type.type = TPrimitiveType::BIGINT;
+        if (keys_type == TKeysType::AGG_KEYS) {
+            column.__set_aggregation_type(TAggregationType::SUM);
+        } else if (keys_type == TKeysType::UNIQUE_KEYS) {
+            column.__set_aggregation_type(TAggregationType::REPLACE);
+        } else {
+            column.__set_aggregation_type(TAggregationType::NONE);
+        }
+        request->tablet_schema.columns.push_back(column);
+    }
+}
+
+// Generates sorted keys of rowsets, which overlap each other as all of them
+// are drawn from the same distribution
+class KeyGenerator {
+public:
+    KeyGenerator() : _rng(kSeed) {
+        if (FLAGS_key_distribution == "zipf") {
+            // key i is the (i + 1)th most frequent one
+            _zipf_cdf.resize(FLAGS_key_cardinality);
+            double sum = 0;
+            for (int64_t i = 0; i < FLAGS_key_cardinality; ++i) {
+                sum += 1.0 / pow(i + 1, FLAGS_zipf_exponent);
+                _zipf_cdf[i] = sum;
+            }
+        }
+    }
+
+    void next_rowset(bool distinct, std::vector<int32_t>* keys) {
+        keys->resize(FLAGS_rows_per_rowset);
+        if (_zipf_cdf.empty()) {
+            std::uniform_int_distribution<int64_t> uniform(0, FLAGS_key_cardinality - 1);
+            for (auto& key : *keys) {
+                key = uniform(_rng);
+            }
+        } else {
+            std::uniform_real_distribution<double> uniform(0, _zipf_cdf.back());
+            for (auto& key : *keys) {
+                int64_t rank = std::lower_bound(_zipf_cdf.begin(), _zipf_cdf.end(),
+                                                uniform(_rng)) - _zipf_cdf.begin();
+                key = std::min(rank, FLAGS_key_cardinality - 1);
+            }
+        }
+        std::sort(keys->begin(), keys->end());
+        // rows of the same key in one rowset are aggregated by memtable when loading
+        if (distinct) {
+            keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
+        }
+    }
+
+    int64_t next_value() { return _rng() % 1000; }
+
+private:
+    std::mt19937_64 _rng;
+    std::vector<double> _zipf_cdf;
+};
+
+// Create the synthetic tablet, of which rowset [0-1] is empty and rowsets
+// [2-2] to [num_rowsets+1 - num_rowsets+1] are generated.
+static OLAPStatus create_synthetic_tablet(StorageEngine* engine, TabletSharedPtr* tablet) {
+    TCreateTabletReq request;
+    create_tablet_request(&request);
+    RETURN_NOT_OK(engine->create_tablet(request));
+    *tablet = engine->tablet_manager()->get_tablet(kSyntheticTabletId, kSyntheticSchemaHash);
+    if (*tablet == nullptr) {
+        return OLAP_ERR_TABLE_NOT_FOUND;
+    }
+
+    const TabletSchema& schema = (*tablet)->tablet_schema();
+    bool distinct = (*tablet)->keys_type() != KeysType::DUP_KEYS;
+    MemTracker tracker(-1);
+    MemPool mem_pool(&tracker);
+    RowCursor row;
+    RETURN_NOT_OK(row.init(schema));
+    KeyGenerator generator;
+    std::vector<int32_t> keys;
+    for (int i = 0; i < FLAGS_num_rowsets; ++i) {
+        int64_t version = i + 2;
+        RowsetWriterContext context;
+        RETURN_NOT_OK((*tablet)->next_rowset_id(&context.rowset_id));
+        context.tablet_uid = (*tablet)->tablet_uid();
+        context.tablet_id = (*tablet)->tablet_id();
+        context.partition_id = kPartitionId;
+        context.tablet_schema_hash = (*tablet)->schema_hash();
+        context.rowset_type = ALPHA_ROWSET;
+        context.rowset_path_prefix = (*tablet)->tablet_path();
+        context.tablet_schema = &schema;
+        context.rowset_state = VISIBLE;
+        context.data_dir = (*tablet)->data_dir();
+        context.version = Version(version, version);
+        context.version_hash = version;
+        RowsetWriterSharedPtr writer;
+        RETURN_NOT_OK(RowsetFactory::create_rowset_writer(context, &writer));
+
+        generator.next_rowset(distinct, &keys);
+        for (int32_t key : keys) {
+            for (int j = 0; j < FLAGS_num_key_columns; ++j) {
+                // the other key columns are functions of the first one, so the
+                // order of rows is the order of the first key column
+                int32_t value = j == 0 ? key : (int32_t)((key * 2654435761L + j) & 0x7fffffff);
+                row.set_not_null(j);
+                row.set_field_content(j, (const char*)&value, &mem_pool);
+            }
+            for (int j = 0; j < FLAGS_num_value_columns; ++j) {
+                int64_t value = generator.next_value();
+                row.set_not_null(FLAGS_num_key_columns + j);
+                row.set_field_content(FLAGS_num_key_columns + j, (const char*)&value, &mem_pool);
+            }
+            RETURN_NOT_OK(writer->add_row(row));
+        }
+        RETURN_NOT_OK(writer->flush());
+        RowsetSharedPtr rowset = writer->build();
+        if (rowset == nullptr) {
+            return OLAP_ERR_MALLOC_ERROR;
+        }
+        RETURN_NOT_OK((*tablet)->add_rowset(rowset));
+    }
+    if (FLAGS_compaction_type == "base") {
+        // all the rowsets are under the cumulative point, as if they had been
+        // compacted by cumulative compactions
+        (*tablet)->set_cumulative_layer_point((*tablet)->max_version().second + 1);
+    }
+    return OLAP_SUCCESS;
+}
+
+static double ratio(int64_t a, int64_t b) {
+    return b > 0 ? (double)a / b : 0;
+}
+
+static void print_result(const CompactionResult& r) {
+    std::cout << r.compaction_type << " compaction of tablet " << r.tablet
+              << (r.by_linking ? ", by linking files of input rowsets" : "") << std::endl;
+    printf("input:  %ld rowsets, %ld rows, %.1f MB\n", r.num_input_rowsets, r.input_rows,
+           r.input_bytes / 1024.0 / 1024);
+    printf("output: %ld rows, %.1f MB, %ld rows merged, %ld rows filtered\n",
+           r.output_rows, r.output_bytes / 1024.0 / 1024, r.merged_rows, r.filtered_rows);
+    printf("throughput: %.1f Krows/s\n",
+           r.compaction.real_ns > 0 ? r.input_rows / (r.compaction.real_ns / 1e9) / 1000 : 0);
+    printf("read amplification: %.2f, write amplification: %.2f\n",
+           ratio(r.input_bytes, r.output_bytes), ratio(r.output_bytes, r.loaded_bytes));
+    printf("\n%-20s %12s %12s %12s %14s\n", "Pass", "Rows", "Seconds", "CPU seconds",
+           "Peak memory MB");
+    for (const PassResult* p : { &r.read, &r.merge, &r.compaction }) {
+        printf("%-20s %12ld %12.3f %12.3f %14.1f\n", p->name.c_str(), p->rows,
+               p->real_ns / 1e9, p->cpu_ns / 1e9, p->peak_memory_bytes / 1024.0 / 1024);
+    }
+    int64_t merge_ns = std::max<int64_t>(r.merge.real_ns - r.read.real_ns, 0);
+    int64_t write_ns = std::max<int64_t>(r.compaction.real_ns - r.merge.real_ns, 0);
+    printf("\ntime breakdown of compaction: read %.3fs, merge+aggregate %.3fs, write %.3fs\n",
+           r.read.real_ns / 1e9, merge_ns / 1e9, write_ns / 1e9);
+    printf("reader: io %.3fs, decompress %.3fs, block load %.3fs, %ld raw rows read\n",
+           r.reader_stats.io_ns / 1e9, r.reader_stats.decompress_ns / 1e9,
+           r.reader_stats.block_load_ns / 1e9, r.reader_stats.raw_rows_read);
+}
+
+static void write_pass(rapidjson::PrettyWriter<rapidjson::StringBuffer>* writer,
+                       const PassResult& p) {
+    writer->Key(p.name.c_str());
+    writer->StartObject();
+    writer->Key("rows");
+    writer->Int64(p.rows);
+    writer->Key("real_ns");
+    writer->Int64(p.real_ns);
+    writer->Key("cpu_ns");
+    writer->Int64(p.cpu_ns);
+    writer->Key("peak_memory_bytes");
+    writer->Int64(p.peak_memory_bytes);
+    writer->EndObject();
+}
+
+static std::string to_json(const CompactionResult& r) {
+    rapidjson::StringBuffer s;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
+    writer.StartObject();
+    writer.Key("tablet");
+    writer.String(r.tablet.c_str());
+    writer.Key("compaction_type");
+    writer.String(r.compaction_type.c_str());
+    writer.Key("by_linking");
+    writer.Bool(r.by_linking);
+    writer.Key("num_input_rowsets");
+    writer.Int64(r.num_input_rowsets);
+    writer.Key("input_rows");
+    writer.Int64(r.input_rows);
+    writer.Key("input_bytes");
+    writer.Int64(r.input_bytes);
+    writer.Key("loaded_bytes");
+    writer.Int64(r.loaded_bytes);
+    writer.Key("output_rows");
+    writer.Int64(r.output_rows);
+    writer.Key("output_bytes");
+    writer.Int64(r.output_bytes);
+    writer.Key("merged_rows");
+    writer.Int64(r.merged_rows);
+    writer.Key("filtered_rows");
+    writer.Int64(r.filtered_rows);
+    writer.Key("read_amplification");
+    writer.Double(ratio(r.input_bytes, r.output_bytes));
+    writer.Key("write_amplification");
+    writer.Double(ratio(r.output_bytes, r.loaded_bytes));
+    writer.Key("reader_io_ns");
+    writer.Int64(r.reader_stats.io_ns);
+    writer.Key("reader_decompress_ns");
+    writer.Int64(r.reader_stats.decompress_ns);
+    writer.Key("reader_block_load_ns");
+    writer.Int64(r.reader_stats.block_load_ns);
+    writer.Key("passes");
+    writer.StartObject();
+    write_pass(&writer, r.read);
+    write_pass(&writer, r.merge);
+    write_pass(&writer, r.compaction);
+    writer.EndObject();
+    writer.EndObject();
+    return s.GetString();
+}
+
+static int run(const std::string& root_path) {
+    // nothing else compacts the tablet during the measurement
+    config::enable_compaction_scheduler = false;
+    config::base_compaction_num_threads_per_disk = 0;
+    config::cumulative_compaction_num_threads_per_disk = 0;
+    config::path_gc_check = false;
+
+    EngineOptions options;
+    options.store_paths.emplace_back(root_path, -1);
+    StorageEngine* engine = nullptr;
+    Status st = StorageEngine::open(options, &engine);
+    if (!st.ok()) {
+        std::cout << "open storage engine failed, status:" << st.to_string() << std::endl;
+        return -1;
+    }
+    std::unique_ptr<StorageEngine> engine_ptr(engine);
+
+    TabletSharedPtr tablet;
+    if (FLAGS_operation == "replay") {
+        tablet = engine->tablet_manager()->get_tablet(FLAGS_tablet_id, FLAGS_schema_hash);
+        if (tablet == nullptr) {
+            std::cout << "no tablet for tablet_id:" << FLAGS_tablet_id
+                      << ", schema_hash:" << FLAGS_schema_hash << std::endl;
+            return -1;
+        }
+    } else {
+        OLAPStatus res = create_synthetic_tablet(engine, &tablet);
+        if (res != OLAP_SUCCESS) {
+            std::cout << "create synthetic tablet failed, status:" << res << std::endl;
+            return -1;
+        }
+    }
+
+    CompactionResult result;
+    result.compaction_type = FLAGS_compaction_type;
+    OLAPStatus res = OLAP_SUCCESS;
+    if (FLAGS_compaction_type == "base") {
+        res = run_compaction<BaseCompaction>(tablet, &result);
+    } else {
+        res = run_compaction<CumulativeCompaction>(tablet, &result);
+    }
+    if (res != OLAP_SUCCESS) {
+        std::cout << FLAGS_compaction_type << " compaction failed, status:" << res << std::endl;
+        return -1;
+    }
+
+    print_result(result);
+    if (!FLAGS_output_json.empty()) {
+        std::ofstream out(FLAGS_output_json);
+        out << to_json(result) << std::endl;
+        if (!out.good()) {
+            std::cout << "write " << FLAGS_output_json << " failed" << std::endl;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+}  // namespace doris
+
+int main(int argc, char** argv) {
+    std::string usage = doris::get_usage(argv[0]);
+    gflags::SetUsageMessage(usage);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    if (FLAGS_operation != "replay" && FLAGS_operation != "synthetic") {
+        std::cout << "invalid operation:" << FLAGS_operation << "\n" << usage << std::endl;
+        return -1;
+    }
+    if (FLAGS_root_path.empty()) {
+        std::cout << "root_path is required\n" << usage << std::endl;
+        return -1;
+    }
+    if (FLAGS_compaction_type != "cumulative" && FLAGS_compaction_type != "base") {
+        std::cout << "invalid compaction type:" << FLAGS_compaction_type << std::endl;
+        return -1;
+    }
+    if (FLAGS_operation == "synthetic"
+            && (FLAGS_num_rowsets <= 1 || FLAGS_rows_per_rowset <= 0
+                || FLAGS_key_cardinality <= 0 || FLAGS_num_key_columns <= 0)) {
+        std::cout << "num_rowsets must be larger than 1, and rows_per_rowset, "
+                  << "key_cardinality and num_key_columns must be positive" << std::endl;
+        return -1;
+    }
+    if (!doris::config::init(nullptr, false)) {
+        std::cout << "init config failed" << std::endl;
+        return -1;
+    }
+    doris::CpuInfo::init();
+
+    if (FLAGS_operation == "synthetic") {
+        doris::remove_all_dir(FLAGS_root_path);
+        if (doris::create_dir(FLAGS_root_path) != doris::OLAP_SUCCESS) {
+            std::cout << "create root path failed:" << FLAGS_root_path << std::endl;
+            return -1;
+        }
+    }
+    path root_path(FLAGS_root_path);
+    try {
+        root_path = canonical(root_path);
+    } catch (...) {
+        std::cout << "invalid root path:" << FLAGS_root_path << std::endl;
+        return -1;
+    }
+
+    int ret = doris::run(root_path.string());
+    gflags::ShutDownCommandLineFlags();
+    return ret;
+}
@@ -16,6 +16,7 @@
 // under the License.
 
 #include "udf/udf.h"
+#include "common/config.h"
 #include "common/logging.h"
 #include "olap/hll.h"
 
@@ -451,58 +452,152 @@ const FunctionContext::TypeDesc* FunctionContext::get_arg_type(int arg_idx) cons
     return &_impl->_arg_types[arg_idx];
 }
 
-void HllVal::init(FunctionContext* ctx) {
-    len = doris::HLL_COLUMN_DEFAULT_LEN;
-    ptr = ctx->allocate(len);
-    memset(ptr, 0, len);
-    // the HLL type is HLL_DATA_FULL in UDF or UDAF
-    ptr[0] = doris::HllDataType::HLL_DATA_FULL;
+namespace {
 
-    is_null = false;
+int32_t hll_sparse_count(const uint8_t* data) {
+    int32_t count;
+    memcpy(&count, data + 1, sizeof(count));
+    return count;
+}
+
+void set_hll_sparse_count(uint8_t* data, int32_t count) {
+    memcpy(data + 1, &count, sizeof(count));
 }
 
-void HllVal::agg_parse_and_cal(const HllVal &other) {
-    doris::HllSetResolver resolver;
-    resolver.init((char*)other.ptr, other.len);
-    resolver.parse();
+int hll_sparse_index(const uint8_t* entry) {
+    return entry[0] | (entry[1] << 8);
+}
 
-    if (resolver.get_hll_data_type() == doris::HLL_DATA_EMPTY) {
-        return;
+// Turns the sparse set 'hll' into a full set.
+void hll_to_full(FunctionContext* ctx, HllVal* hll) {
+    uint8_t* full = ctx->allocate(doris::HLL_COLUMN_DEFAULT_LEN);
+    memset(full, 0, doris::HLL_COLUMN_DEFAULT_LEN);
+    full[0] = doris::HLL_DATA_FULL;
+    uint8_t* registers = full + 1;
+    int32_t count = hll_sparse_count(hll->ptr);
+    const uint8_t* entry = hll->ptr + doris::HLL_SPARSE_HEADER_LEN;
+    for (int32_t i = 0; i < count; ++i, entry += doris::HLL_SPARSE_ENTRY_LEN) {
+        registers[hll_sparse_index(entry)] = entry[2];
     }
+    ctx->free(hll->ptr);
+    hll->ptr = full;
+    hll->len = doris::HLL_COLUMN_DEFAULT_LEN;
+}
 
-    uint8_t* pdata = ptr + 1;
-    int data_len = doris::HLL_REGISTERS_COUNT;
+// Sets register 'idx' of 'hll' to at least 'value'. Registers of a sparse set are
+// kept sorted by index.
+void hll_update_register(FunctionContext* ctx, HllVal* hll, int idx, uint8_t value) {
+    if (value == 0) {
+        return;
+    }
+    if (hll->ptr[0] == doris::HLL_DATA_FULL) {
+        uint8_t* reg = hll->ptr + 1 + idx;
+        *reg = std::max(*reg, value);
+        return;
+    }
 
-    if (resolver.get_hll_data_type() == doris::HLL_DATA_EXPLICIT) {
-        for (int i = 0; i < resolver.get_explicit_count(); i++) {
-            uint64_t hash_value = resolver.get_explicit_value(i);
-            int idx = hash_value % data_len;
-            uint8_t first_one_bit = __builtin_ctzl(hash_value >> doris::HLL_COLUMN_PRECISION) + 1;
-            pdata[idx] = std::max(pdata[idx], first_one_bit);
-        }
-    } else if (resolver.get_hll_data_type() == doris::HLL_DATA_SPRASE) {
-        std::map<doris::HllSetResolver::SparseIndexType,
-                 doris::HllSetResolver::SparseValueType>&
-                     sparse_map = resolver.get_sparse_map();
-        for (std::map<doris::HllSetResolver::SparseIndexType,
-                doris::HllSetResolver::SparseValueType>::iterator iter = sparse_map.begin();
-                                    iter != sparse_map.end(); iter++) {
-            pdata[iter->first] = std::max(pdata[iter->first], (uint8_t)iter->second);
-        }
-    } else if (resolver.get_hll_data_type() == doris::HLL_DATA_FULL) {
-        char* full_value = resolver.get_full_value();
-        for (int i = 0; i < doris::HLL_REGISTERS_COUNT; i++) {
-            pdata[i] = std::max(pdata[i], (uint8_t)full_value[i]);
+    int32_t count = hll_sparse_count(hll->ptr);
+    uint8_t* entries = hll->ptr + doris::HLL_SPARSE_HEADER_LEN;
+    int32_t low = 0;
+    int32_t high = count;
+    while (low < high) {
+        int32_t mid = (low + high) / 2;
+        if (hll_sparse_index(entries + mid * doris::HLL_SPARSE_ENTRY_LEN) < idx) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
     }
+    uint8_t* entry = entries + low * doris::HLL_SPARSE_ENTRY_LEN;
+    if (low < count && hll_sparse_index(entry) == idx) {
+        entry[2] = std::max(entry[2], value);
+        return;
+    }
+    if (count >= doris::HLL_SPARSE_MAX_REGISTERS) {
+        hll_to_full(ctx, hll);
+        hll->ptr[1 + idx] = value;
+        return;
+    }
+
+    hll->len += doris::HLL_SPARSE_ENTRY_LEN;
+    hll->ptr = ctx->reallocate(hll->ptr, hll->len);
+    entry = hll->ptr + doris::HLL_SPARSE_HEADER_LEN + low * doris::HLL_SPARSE_ENTRY_LEN;
+    memmove(entry + doris::HLL_SPARSE_ENTRY_LEN, entry,
+            (count - low) * doris::HLL_SPARSE_ENTRY_LEN);
+    entry[0] = idx & 0xff;
+    entry[1] = (idx >> 8) & 0xff;
+    entry[2] = value;
+    set_hll_sparse_count(hll->ptr, count + 1);
 }
 
-void HllVal::agg_merge(const HllVal &other) {
-    uint8_t* pdata = ptr + 1;
-    uint8_t* pdata_other = other.ptr + 1;
+}
 
-    for (int i = 0; i < doris::HLL_REGISTERS_COUNT; ++i) {
-        pdata[i] = std::max(pdata[i], pdata_other[i]);
+void HllVal::init(FunctionContext* ctx) {
+    if (doris::config::enable_sparse_hll_intermediate) {
+        len = doris::HLL_SPARSE_HEADER_LEN;
+        ptr = ctx->allocate(len);
+        ptr[0] = doris::HLL_DATA_SPRASE;
+        set_hll_sparse_count(ptr, 0);
+    } else {
+        len = doris::HLL_COLUMN_DEFAULT_LEN;
+        ptr = ctx->allocate(len);
+        memset(ptr, 0, len);
+        ptr[0] = doris::HLL_DATA_FULL;
+    }
+
+    is_null = false;
+}
+
+void HllVal::agg_update_hash(FunctionContext* ctx, uint64_t hash_value) {
+    int idx = hash_value % doris::HLL_REGISTERS_COUNT;
+    uint8_t first_one_bit = __builtin_ctzl(hash_value >> doris::HLL_COLUMN_PRECISION) + 1;
+    hll_update_register(ctx, this, idx, first_one_bit);
+}
+
+void HllVal::agg_parse_and_cal(FunctionContext* ctx, const HllVal& other) {
+    if (other.len == 0) {
+        return;
+    }
+    if (other.len == doris::HLL_REGISTERS_COUNT) {
+        // registers of the ndv intermediate of older backends, which has no type
+        if (ptr[0] != doris::HLL_DATA_FULL) {
+            hll_to_full(ctx, this);
+        }
+        doris::HllSetHelper::merge_registers(ptr + 1, other.ptr, doris::HLL_REGISTERS_COUNT);
+        return;
+    }
+    switch (other.ptr[0]) {
+    case doris::HLL_DATA_EXPLICIT: {
+        int num = other.ptr[1];
+        const uint8_t* hash_values = other.ptr + 2;
+        for (int i = 0; i < num; ++i) {
+            uint64_t hash_value;
+            memcpy(&hash_value, hash_values + i * sizeof(uint64_t), sizeof(uint64_t));
+            agg_update_hash(ctx, hash_value);
+        }
+        break;
+    }
+    case doris::HLL_DATA_SPRASE: {
+        int32_t count = hll_sparse_count(other.ptr);
+        if (ptr[0] != doris::HLL_DATA_FULL
+                && hll_sparse_count(ptr) + count > doris::HLL_SPARSE_MAX_REGISTERS) {
+            hll_to_full(ctx, this);
+        }
+        const uint8_t* entry = other.ptr + doris::HLL_SPARSE_HEADER_LEN;
+        for (int32_t i = 0; i < count; ++i, entry += doris::HLL_SPARSE_ENTRY_LEN) {
+            hll_update_register(ctx, this, hll_sparse_index(entry), entry[2]);
+        }
+        break;
+    }
+    case doris::HLL_DATA_FULL:
+        if (ptr[0] != doris::HLL_DATA_FULL) {
+            hll_to_full(ctx, this);
+        }
+        doris::HllSetHelper::merge_registers(ptr + 1, other.ptr + 1, doris::HLL_REGISTERS_COUNT);
+        break;
+    default:
+        // HLL_DATA_EMPTY
+        break;
     }
 }
 
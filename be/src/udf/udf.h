@@ -296,6 +296,31 @@ typedef void (*UdfPrepare)(FunctionContext* context,
 typedef void (*UdfClose)(FunctionContext* context,
                          FunctionContext::FunctionStateScope scope);
 
+/// --- Batch Functions ---
+/// -----------------------
+/// The UDF can also optionally include a batch version of itself, which is called once
+/// for many rows instead of once per row. It's found by name: for the UDF "ns::Fn", it's
+/// "ns::Fn_batch" with the signature below. args[i] points to the values of the i-th
+/// argument for the num_rows rows, e.g. to num_rows IntVals for an INT argument, and the
+/// result of row j must be stored in results[j], which is of the return type. A value
+/// is NULL if its is_null is set.
+//
+/// The batch version is used instead of the UDF where rows are evaluated in batches,
+/// e.g. in predicates, if the UDF returns TINYINT, SMALLINT, INT, BIGINT, FLOAT or
+/// DOUBLE and has no variable arguments. It must return the same results as the UDF.
+/// Example:
+///  void AddOne_batch(FunctionContext* context, int num_rows, const AnyVal** args,
+///                    AnyVal* results) {
+///    const IntVal* a = reinterpret_cast<const IntVal*>(args[0]);
+///    IntVal* r = reinterpret_cast<IntVal*>(results);
+///    for (int i = 0; i < num_rows; ++i) {
+///      r[i].is_null = a[i].is_null;
+///      r[i].val = a[i].val + 1;
+///    }
+///  }
+typedef void (*UdfBatch)(FunctionContext* context, int num_rows,
+                         const AnyVal** args, AnyVal* results);
+
 //----------------------------------------------------------------------------
 //------------------------------- UDAs ---------------------------------------
 //----------------------------------------------------------------------------
@@ -345,6 +370,13 @@ typedef void (*UdaUpdate2)(FunctionContext* context, const InputType& input,
 typedef void (*UdaMerge)(FunctionContext* context, const IntermediateType& src,
                          IntermediateType* dst);
 
+// The update and merge functions can optionally have batch versions, found by name like
+// the ones of UDFs, e.g. "ns::Update_batch" for "ns::Update". They update 'result' with
+// num_rows rows at once, args[i] points to the num_rows values of the i-th input, or
+// of the intermediate values to merge. They are used when aggregating without GROUP BY.
+typedef void (*UdaUpdateBatch)(FunctionContext* context, int num_rows,
+                               const InputType** args, IntermediateType* result);
+
 // Serialize the intermediate type. The serialized data is then sent across the
 // wire. This is not called unless the intermediate type is String.
 // No additional functions will be called with this FunctionContext object and the
@@ -765,14 +797,22 @@ struct LargeIntVal : public AnyVal {
     }
 };
 
+// Intermediate state of the hll aggregate functions. If
+// config::enable_sparse_hll_intermediate is true, it starts as an empty sparse set
+// and turns into a full set (all 2^14 registers) only once it holds more than
+// HLL_SPARSE_MAX_REGISTERS registers, so groups with few distinct values stay small.
+// Otherwise it's a full set from the start, which older backends can merge.
 struct HllVal : public StringVal {
     HllVal() : StringVal() { }
 
     void init(FunctionContext* ctx);
 
-    void agg_parse_and_cal(const HllVal &other);
+    // Adds the element with hash value 'hash_value'.
+    void agg_update_hash(FunctionContext* ctx, uint64_t hash_value);
 
-    void agg_merge(const HllVal &other);
+    // Unions 'other', a serialized hll set of any type or the untagged registers of
+    // the ndv intermediate of older backends, into this set.
+    void agg_parse_and_cal(FunctionContext* ctx, const HllVal& other);
 };
 
 
@@ -4,6 +4,7 @@
 
 #include "util/arena.h"
 #include <assert.h>
+#include <new>
 
 namespace doris {
 
@@ -16,7 +17,7 @@ Arena::Arena() : memory_usage_(0) {
 
 Arena::~Arena() {
     for (size_t i = 0; i < blocks_.size(); i++) {
-        delete[] blocks_[i];
+        ChunkAllocator::instance()->free(blocks_[i]);
     }
 }
 
@@ -58,8 +59,12 @@ char* Arena::AllocateAligned(size_t bytes) {
 }
 
 char* Arena::AllocateNewBlock(size_t block_bytes) {
-    char* result = new char[block_bytes];
-    blocks_.push_back(result);
+    Chunk chunk;
+    if (!ChunkAllocator::instance()->allocate(block_bytes, &chunk)) {
+        throw std::bad_alloc();
+    }
+    blocks_.push_back(chunk);
+    char* result = reinterpret_cast<char*>(chunk.data);
     memory_usage_.store(MemoryUsage() + block_bytes + sizeof(char*),
             std::memory_order_relaxed);
     return result;
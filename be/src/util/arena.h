@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "common/compiler_util.h"
+#include "runtime/memory/chunk_allocator.h"
 
 namespace doris {
 
@@ -42,8 +43,8 @@ private:
     char* alloc_ptr_;
     size_t alloc_bytes_remaining_;
 
-    // Array of new[] allocated memory blocks
-    std::vector<char*> blocks_;
+    // Memory blocks from the ChunkAllocator
+    std::vector<Chunk> blocks_;
 
     // Total memory usage of the arena.
     std::atomic<size_t> memory_usage_;
@@ -0,0 +1,220 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "roaring/roaring.hh"
+#include "util/coding.h"
+
+namespace doris {
+
+// Set of uint32 values used for exact distinct counting, e.g. by BITMAP_UNION columns
+// and the bitmap_* functions.
+//
+// Most bitmaps built on load hold a single value (to_bitmap() of one row), so an empty
+// or a single value bitmap is kept without a Roaring. The serialized format is one
+// type byte followed by
+//      EMPTY:  nothing
+//      SINGLE: the value, 4 bytes little endian
+//      BITMAP: the bitmap in portable roaring format
+class BitmapValue {
+public:
+    enum Type {
+        EMPTY = 0,
+        SINGLE = 1,
+        BITMAP = 2
+    };
+
+    BitmapValue() : _type(EMPTY), _sv(0) { }
+
+    explicit BitmapValue(uint32_t value) : _type(SINGLE), _sv(value) { }
+
+    void add(uint32_t value) {
+        switch (_type) {
+        case EMPTY:
+            _sv = value;
+            _type = SINGLE;
+            break;
+        case SINGLE:
+            if (_sv != value) {
+                _bitmap.add(_sv);
+                _bitmap.add(value);
+                _type = BITMAP;
+            }
+            break;
+        case BITMAP:
+            _bitmap.add(value);
+            break;
+        }
+    }
+
+    BitmapValue& operator|=(const BitmapValue& rhs) {
+        switch (rhs._type) {
+        case EMPTY:
+            break;
+        case SINGLE:
+            add(rhs._sv);
+            break;
+        case BITMAP:
+            if (_type == BITMAP) {
+                _bitmap |= rhs._bitmap;
+            } else {
+                bool had_single = (_type == SINGLE);
+                _bitmap = rhs._bitmap;
+                if (had_single) {
+                    _bitmap.add(_sv);
+                }
+                _type = BITMAP;
+            }
+            break;
+        }
+        return *this;
+    }
+
+    BitmapValue& operator&=(const BitmapValue& rhs) {
+        switch (_type) {
+        case EMPTY:
+            break;
+        case SINGLE:
+            if (!rhs.contains(_sv)) {
+                _type = EMPTY;
+            }
+            break;
+        case BITMAP:
+            if (rhs._type == BITMAP) {
+                _bitmap &= rhs._bitmap;
+                _shrink();
+            } else {
+                bool keep = rhs._type == SINGLE && _bitmap.contains(rhs._sv);
+                _bitmap = Roaring();
+                _type = keep ? SINGLE : EMPTY;
+                _sv = rhs._sv;
+            }
+            break;
+        }
+        return *this;
+    }
+
+    bool contains(uint32_t value) const {
+        switch (_type) {
+        case EMPTY:
+            return false;
+        case SINGLE:
+            return _sv == value;
+        default:
+            return _bitmap.contains(value);
+        }
+    }
+
+    int64_t cardinality() const {
+        switch (_type) {
+        case EMPTY:
+            return 0;
+        case SINGLE:
+            return 1;
+        default:
+            return _bitmap.cardinality();
+        }
+    }
+
+    // Number of bytes serialize() writes. Run-length encodes the roaring bitmap
+    // first, so the serialized form is as compact as possible.
+    size_t serialized_size() {
+        switch (_type) {
+        case EMPTY:
+            return 1;
+        case SINGLE:
+            return 1 + sizeof(uint32_t);
+        default:
+            _bitmap.runOptimize();
+            _bitmap.shrinkToFit();
+            return 1 + _bitmap.getSizeInBytes();
+        }
+    }
+
+    // Writes serialized_size() bytes to dst.
+    void serialize(char* dst) const {
+        *dst = static_cast<char>(_type);
+        switch (_type) {
+        case EMPTY:
+            break;
+        case SINGLE:
+            encode_fixed32_le(reinterpret_cast<uint8_t*>(dst + 1), _sv);
+            break;
+        default:
+            _bitmap.write(dst + 1);
+            break;
+        }
+    }
+
+    // Replaces the content with the bitmap serialized in src. Returns false and
+    // leaves an empty bitmap if src is not a valid serialized bitmap.
+    bool deserialize(const char* src, size_t len) {
+        _type = EMPTY;
+        _bitmap = Roaring();
+        if (len == 0) {
+            return false;
+        }
+        switch (*src) {
+        case EMPTY:
+            return len == 1;
+        case SINGLE:
+            if (len != 1 + sizeof(uint32_t)) {
+                return false;
+            }
+            _sv = decode_fixed32_le(reinterpret_cast<const uint8_t*>(src + 1));
+            _type = SINGLE;
+            return true;
+        case BITMAP:
+            try {
+                _bitmap = Roaring::readSafe(src + 1, len - 1);
+            } catch (const std::runtime_error& e) {
+                return false;
+            }
+            _type = BITMAP;
+            _shrink();
+            return true;
+        default:
+            return false;
+        }
+    }
+
+private:
+    // Switches back to the inline representation once at most one value is left.
+    void _shrink() {
+        uint64_t num = _bitmap.cardinality();
+        if (num > 1) {
+            return;
+        }
+        if (num == 1) {
+            _sv = _bitmap.minimum();
+            _type = SINGLE;
+        } else {
+            _type = EMPTY;
+        }
+        _bitmap = Roaring();
+    }
+
+    Type _type;
+    uint32_t _sv;
+    Roaring _bitmap;
+};
+
+}
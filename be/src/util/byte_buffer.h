@@ -21,6 +21,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <utility>
 
 #include "common/logging.h"
 
@@ -35,7 +36,20 @@ struct ByteBuffer {
         return ptr;
     }
 
-    ~ByteBuffer() { delete[] ptr; }
+    // Wrap 'size' bytes at 'data' without copying them. The memory is owned by
+    // 'owner', which is kept alive as long as the returned buffer. The returned
+    // buffer is ready to be read, and must not be written.
+    static ByteBufferPtr wrap(char* data, size_t size, std::shared_ptr<void> owner) {
+        DCHECK(owner != nullptr);
+        ByteBufferPtr ptr(new ByteBuffer(data, size, std::move(owner)));
+        return ptr;
+    }
+
+    ~ByteBuffer() {
+        if (_owner == nullptr) {
+            delete[] ptr;
+        }
+    }
 
     void put_bytes(const char* data, size_t size) {
         memcpy(ptr + pos , data, size);
@@ -65,6 +79,14 @@ private:
         : ptr(new char[capacity_]), pos(0),
         limit(capacity_), capacity(capacity_) {
     }
+
+    ByteBuffer(char* data, size_t size, std::shared_ptr<void> owner)
+        : ptr(data), pos(0), limit(size), capacity(size),
+        _owner(std::move(owner)) {
+    }
+
+    // hold the memory of wrapped buffer, nullptr if ptr is allocated by us
+    std::shared_ptr<void> _owner;
 };
 
 }
@@ -47,6 +47,8 @@ class CoreDataAllocatorImpl : public CoreDataAllocator {
 public:
     virtual ~CoreDataAllocatorImpl();
     void* get_or_create(size_t id) override {
+        // CoreLocalValues may be created by many threads at once, e.g. with MemTrackers
+        std::lock_guard<std::mutex> l(_lock);
         size_t block_id = id / ELEMENTS_PER_BLOCK;
         if (block_id >= _blocks.size()) {
             _blocks.resize(block_id + 1);
@@ -61,6 +63,7 @@ public:
     }
 private:
     static constexpr int ELEMENTS_PER_BLOCK = BLOCK_SIZE / ELEMENT_BYTES;
+    std::mutex _lock;
     std::vector<CoreDataBlock*> _blocks;
 };
 
@@ -0,0 +1,258 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/cpu_profiler.h"
+
+#include <errno.h>
+#include <execinfo.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "common/logging.h"
+#include "util/bfd_parser.h"
+#include "util/time.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+// frames of the signal handler itself, skipped if the interrupted pc is not
+// found in the captured stack
+static const int kHandlerFrames = 3;
+
+static __thread CpuProfiler::Tag t_tag;
+
+static int profile_signal() {
+    // SIGRTMIN and SIGRTMIN + 1 are used by some thread libraries
+    return SIGRTMIN + 4;
+}
+
+CpuProfiler::Tag CpuProfiler::get_thread_tag() {
+    return t_tag;
+}
+
+void CpuProfiler::set_thread_tag(const Tag& tag) {
+    t_tag = tag;
+    // the tag is read by the signal handler on this thread
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+Status CpuProfiler::start(int sample_hz, int64_t buffer_samples) {
+    if (sample_hz <= 0 || buffer_samples <= 0) {
+        return Status::OK();
+    }
+    std::lock_guard<std::mutex> l(_lock);
+    if (_started || _samples != nullptr) {
+        return Status::InternalError("cpu profiler can only be started once");
+    }
+    sample_hz = std::min(sample_hz, 1000);
+
+    // backtrace() loads libgcc on its first call, which is not async signal safe
+    void* warm_up[1];
+    backtrace(warm_up, 1);
+
+    _capacity = buffer_samples;
+    _samples.reset(new Sample[_capacity]);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = _signal_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(profile_signal(), &sa, nullptr) != 0) {
+        char buf[64];
+        std::stringstream ss;
+        ss << "install cpu profile signal failed, errmsg=" << strerror_r(errno, buf, sizeof(buf));
+        return Status::InternalError(ss.str());
+    }
+
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = profile_signal();
+    if (timer_create(CLOCK_PROCESS_CPUTIME_ID, &sev, &_timer) != 0) {
+        char buf[64];
+        std::stringstream ss;
+        ss << "create cpu profile timer failed, errmsg=" << strerror_r(errno, buf, sizeof(buf));
+        return Status::InternalError(ss.str());
+    }
+    _timer_created = true;
+
+    struct itimerspec its;
+    its.it_interval.tv_sec = 0;
+    its.it_interval.tv_nsec = 1000000000L / sample_hz;
+    its.it_value = its.it_interval;
+    if (timer_settime(_timer, 0, &its, nullptr) != 0) {
+        char buf[64];
+        std::stringstream ss;
+        ss << "start cpu profile timer failed, errmsg=" << strerror_r(errno, buf, sizeof(buf));
+        return Status::InternalError(ss.str());
+    }
+    _started = true;
+    LOG(INFO) << "cpu profiler started, sample_hz=" << sample_hz
+        << ", buffer_samples=" << _capacity;
+    return Status::OK();
+}
+
+void CpuProfiler::stop() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_timer_created) {
+        timer_delete(_timer);
+        _timer_created = false;
+    }
+    // the signal handler and the buffer are kept, because a signal may
+    // still be pending
+    _started = false;
+}
+
+void CpuProfiler::_signal_handler(int signo, siginfo_t* info, void* context) {
+    int saved_errno = errno;
+    instance()->_record(context);
+    errno = saved_errno;
+}
+
+void CpuProfiler::_record(void* context) {
+    void* frames[MAX_FRAMES + kHandlerFrames];
+    int num_frames = backtrace(frames, MAX_FRAMES + kHandlerFrames);
+
+    // start from the interrupted function instead of the signal handler
+    int skip = std::min(kHandlerFrames, num_frames);
+#if defined(__x86_64__)
+    void* pc = (void*)((ucontext_t*)context)->uc_mcontext.gregs[REG_RIP];
+    for (int i = 0; i < num_frames && i <= kHandlerFrames + 1; ++i) {
+        if (frames[i] == pc) {
+            skip = i;
+            break;
+        }
+    }
+#endif
+
+    uint64_t index = _next_index.fetch_add(1, std::memory_order_relaxed);
+    Sample& sample = _samples[index % _capacity];
+    sample.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    sample.time_s = MonotonicSeconds();
+    sample.tag = t_tag;
+    sample.num_frames = std::min(num_frames - skip, (int)MAX_FRAMES);
+    memcpy(sample.frames, frames + skip, sample.num_frames * sizeof(void*));
+    sample.seq.store(2 * index + 2, std::memory_order_release);
+}
+
+static std::string id_string(int64_t hi, int64_t lo) {
+    if (hi == 0 && lo == 0) {
+        return "untagged";
+    }
+    TUniqueId id;
+    id.__set_hi(hi);
+    id.__set_lo(lo);
+    return print_id(id);
+}
+
+void CpuProfiler::get_folded_stacks(const TUniqueId* query_id, int64_t seconds,
+                                    BfdParser* parser, std::string* out) {
+    if (_samples == nullptr) {
+        out->append("cpu profiler is not started, set cpu_profile_sample_hz to enable it\n");
+        return;
+    }
+
+    // the outermost frame is the fragment instance when looking at one query,
+    // or the query otherwise, so they are separated in the flame graph
+    std::map<std::pair<std::string, std::vector<void*>>, int64_t> stacks;
+    int64_t min_time_s = MonotonicSeconds() - seconds;
+    uint64_t end = _next_index.load(std::memory_order_acquire);
+    uint64_t begin = end > _capacity ? end - _capacity : 0;
+    for (uint64_t index = begin; index < end; ++index) {
+        const Sample& sample = _samples[index % _capacity];
+        uint64_t seq = sample.seq.load(std::memory_order_acquire);
+        if (seq != 2 * index + 2) {
+            continue;
+        }
+        int64_t time_s = sample.time_s;
+        Tag tag = sample.tag;
+        int num_frames = std::max(0, std::min(sample.num_frames, (int)MAX_FRAMES));
+        std::vector<void*> frames(sample.frames, sample.frames + num_frames);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sample.seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+
+        if (time_s < min_time_s) {
+            continue;
+        }
+        std::string root;
+        if (query_id != nullptr) {
+            if (tag.query_hi != query_id->hi || tag.query_lo != query_id->lo) {
+                continue;
+            }
+            root = id_string(tag.instance_hi, tag.instance_lo);
+        } else {
+            root = id_string(tag.query_hi, tag.query_lo);
+        }
+        stacks[std::make_pair(std::move(root), std::move(frames))]++;
+    }
+
+    std::unordered_map<void*, std::string> symbols;
+    auto symbolize = [&symbols, parser](void* addr, bool is_return_addr) -> const std::string& {
+        auto it = symbols.find(addr);
+        if (it != symbols.end()) {
+            return it->second;
+        }
+        char buf[32];
+        // a return address points to the instruction after the call
+        snprintf(buf, sizeof(buf), "%lx", (unsigned long)addr - (is_return_addr ? 1 : 0));
+        std::string name;
+        if (parser != nullptr) {
+            std::string file_name;
+            unsigned int lineno = 0;
+            const char* end = nullptr;
+            if (parser->decode_address(buf, &end, &file_name, &name, &lineno) != 0) {
+                name.clear();
+            }
+        }
+        if (name.empty()) {
+            name = std::string("0x") + buf;
+        }
+        // ';' separates frames in folded stacks
+        std::replace(name.begin(), name.end(), ';', ':');
+        return symbols[addr] = std::move(name);
+    };
+
+    // different addresses in the same function are merged after symbolized
+    std::map<std::string, int64_t> folded_stacks;
+    for (auto& it : stacks) {
+        std::string folded = it.first.first;
+        const std::vector<void*>& frames = it.first.second;
+        for (int i = frames.size() - 1; i >= 0; --i) {
+            folded.push_back(';');
+            folded.append(symbolize(frames[i], i > 0));
+        }
+        folded_stacks[folded] += it.second;
+    }
+    for (auto& it : folded_stacks) {
+        out->append(it.first);
+        out->push_back(' ');
+        out->append(std::to_string(it.second));
+        out->push_back('\n');
+    }
+}
+
+}
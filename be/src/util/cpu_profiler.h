@@ -0,0 +1,132 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <signal.h>
+#include <time.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+
+namespace doris {
+
+class BfdParser;
+
+// An always-on sampling cpu profiler.
+//
+// A process cpu timer sends a signal every 1/sample_hz seconds of cpu time
+// used by the process, and the thread which is running when it fires records
+// its stack, together with the query and fragment instance tagged on the
+// thread by CpuProfileTag, into a fixed size ring buffer. So the stacks of a
+// query can be examined after it finished, as long as its samples are not
+// overwritten by newer ones.
+//
+// SIGPROF is left to gperftools, which is used by /pprof/profile, so the two
+// profilers can run at the same time.
+class CpuProfiler {
+public:
+    static const int MAX_FRAMES = 32;
+
+    static CpuProfiler* instance() {
+        static CpuProfiler s_profiler;
+        return &s_profiler;
+    }
+
+    // Start sampling at 'sample_hz' samples per second of cpu time, keeping
+    // the latest 'buffer_samples' samples. Do nothing if 'sample_hz' <= 0.
+    // Can only be started once.
+    Status start(int sample_hz, int64_t buffer_samples);
+
+    // Stop sampling, samples already taken are still available
+    void stop();
+
+    // Aggregate the samples taken in the last 'seconds' seconds into folded
+    // stacks, one "frame;frame;frame count" line per distinct stack with the
+    // outermost frame first, which is the input of flamegraph.pl.
+    // Only the samples of 'query_id' are included if it is not nullptr.
+    // Frames are symbolized by 'parser', or printed as addresses if it is nullptr.
+    void get_folded_stacks(const TUniqueId* query_id, int64_t seconds,
+                           BfdParser* parser, std::string* out);
+
+    // Tag the samples taken on the calling thread. Use CpuProfileTag instead
+    // of calling these directly.
+    struct Tag {
+        int64_t query_hi = 0;
+        int64_t query_lo = 0;
+        int64_t instance_hi = 0;
+        int64_t instance_lo = 0;
+    };
+    static Tag get_thread_tag();
+    static void set_thread_tag(const Tag& tag);
+
+private:
+    struct Sample {
+        // 2 * index + 1 while being written and 2 * index + 2 after written,
+        // where index is the position of this sample in the whole sequence of
+        // samples. Readers skip a sample whose seq changed during reading.
+        std::atomic<uint64_t> seq{0};
+        int64_t time_s;
+        Tag tag;
+        int num_frames;
+        void* frames[MAX_FRAMES];
+    };
+
+    CpuProfiler() { }
+
+    static void _signal_handler(int signo, siginfo_t* info, void* context);
+    // called in the signal handler, must be async signal safe
+    void _record(void* context);
+
+    std::mutex _lock;
+    bool _started = false;
+    bool _timer_created = false;
+    timer_t _timer;
+
+    std::unique_ptr<Sample[]> _samples;
+    uint64_t _capacity = 0;
+    std::atomic<uint64_t> _next_index{0};
+};
+
+// Tag the cpu profile samples taken on this thread with the given query and
+// fragment instance during the lifetime of this object.
+class CpuProfileTag {
+public:
+    CpuProfileTag(const TUniqueId& query_id, const TUniqueId& fragment_instance_id)
+            : _saved(CpuProfiler::get_thread_tag()) {
+        CpuProfiler::Tag tag;
+        tag.query_hi = query_id.hi;
+        tag.query_lo = query_id.lo;
+        tag.instance_hi = fragment_instance_id.hi;
+        tag.instance_lo = fragment_instance_id.lo;
+        CpuProfiler::set_thread_tag(tag);
+    }
+
+    ~CpuProfileTag() {
+        CpuProfiler::set_thread_tag(_saved);
+    }
+
+private:
+    CpuProfiler::Tag _saved;
+};
+
+}
@@ -116,6 +116,18 @@ void DiskInfo::get_device_names() {
         if (rotational.is_open()) {
             rotational.close();
         }
+
+        // The NUMA node is exposed by the device, or by its parent for
+        // devices like nvme namespaces
+        const char* numa_files[] = {"/device/numa_node", "/device/device/numa_node"};
+        for (const char* numa_file : numa_files) {
+            std::ifstream numa(("/sys/block/" + _s_disks[i].name + numa_file).c_str());
+            int node = -1;
+            if (numa.good() && (numa >> node) && node >= 0) {
+                _s_disks[i].numa_node = node;
+                break;
+            }
+        }
     }
 }
 
@@ -97,6 +97,23 @@ IntCounter DorisMetrics::stream_load_rows_total;
 IntCounter DorisMetrics::memtable_flush_total;
 IntCounter DorisMetrics::memtable_flush_duration_us;
 
+IntHistogram DorisMetrics::fragment_request_latency_ms;
+IntHistogram DorisMetrics::memtable_flush_latency_ms;
+IntHistogram DorisMetrics::base_compaction_latency_ms;
+IntHistogram DorisMetrics::cumulative_compaction_latency_ms;
+IntHistogram DorisMetrics::query_scan_latency_ms;
+
+HdrHistogram DorisMetrics::page_read_latency_us;
+HdrHistogram DorisMetrics::transmit_data_latency_us;
+HdrHistogram DorisMetrics::tablet_writer_add_batch_latency_us;
+HdrHistogram DorisMetrics::memtable_flush_latency_us;
+HdrHistogram DorisMetrics::publish_version_latency_us;
+HdrHistogram DorisMetrics::base_compaction_latency_us;
+HdrHistogram DorisMetrics::cumulative_compaction_latency_us;
+
+IntCounter DorisMetrics::fd_cache_hit_total;
+IntCounter DorisMetrics::fd_cache_miss_total;
+
 // gauges
 IntGauge DorisMetrics::memory_pool_bytes_total;
 IntGauge DorisMetrics::process_thread_num;
@@ -144,6 +161,28 @@ void DorisMetrics::initialize(
     REGISTER_DORIS_METRIC(memtable_flush_total);
     REGISTER_DORIS_METRIC(memtable_flush_duration_us);
 
+    REGISTER_DORIS_METRIC(fragment_request_latency_ms);
+    REGISTER_DORIS_METRIC(memtable_flush_latency_ms);
+    REGISTER_DORIS_METRIC(query_scan_latency_ms);
+    _metrics->register_metric(
+        "compaction_latency_ms", MetricLabels().add("type", "base"),
+        &base_compaction_latency_ms);
+    _metrics->register_metric(
+        "compaction_latency_ms", MetricLabels().add("type", "cumulative"),
+        &cumulative_compaction_latency_ms);
+
+    REGISTER_DORIS_METRIC(page_read_latency_us);
+    REGISTER_DORIS_METRIC(transmit_data_latency_us);
+    REGISTER_DORIS_METRIC(tablet_writer_add_batch_latency_us);
+    REGISTER_DORIS_METRIC(memtable_flush_latency_us);
+    REGISTER_DORIS_METRIC(publish_version_latency_us);
+    _metrics->register_metric(
+        "compaction_latency_us", MetricLabels().add("type", "base"),
+        &base_compaction_latency_us);
+    _metrics->register_metric(
+        "compaction_latency_us", MetricLabels().add("type", "cumulative"),
+        &cumulative_compaction_latency_us);
+
     // push request
     _metrics->register_metric(
         "push_requests_total", MetricLabels().add("status", "SUCCESS"),
@@ -232,6 +271,13 @@ void DorisMetrics::initialize(
         "txn_request", MetricLabels().add("type", "exec"),
         &txn_exec_plan_total);
 
+    _metrics->register_metric(
+        "fd_cache_requests_total", MetricLabels().add("type", "hit"),
+        &fd_cache_hit_total);
+    _metrics->register_metric(
+        "fd_cache_requests_total", MetricLabels().add("type", "miss"),
+        &fd_cache_miss_total);
+
     _metrics->register_metric(
         "stream_load", MetricLabels().add("type", "receive_bytes"),
         &stream_receive_bytes_total);
@@ -21,6 +21,7 @@
 #include <set>
 #include <string>
 #include <vector>
+#include <tuple>
 #include <unordered_map>
 
 #include "util/metrics.h"
@@ -39,7 +40,9 @@ public:
     }   
 
     IntGauge* set_key(const std::string& key) {
-        metrics.emplace(key, IntGauge());
+        // gauges are not copyable
+        metrics.emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple());
         return &metrics.find(key)->second;
     }
 
@@ -117,6 +120,25 @@ public:
     static IntCounter memtable_flush_total;
     static IntCounter memtable_flush_duration_us;
 
+    // latency histograms
+    static IntHistogram fragment_request_latency_ms;
+    static IntHistogram memtable_flush_latency_ms;
+    static IntHistogram base_compaction_latency_ms;
+    static IntHistogram cumulative_compaction_latency_ms;
+    static IntHistogram query_scan_latency_ms;
+
+    // latency distributions of hot paths in microseconds
+    static HdrHistogram page_read_latency_us;
+    static HdrHistogram transmit_data_latency_us;
+    static HdrHistogram tablet_writer_add_batch_latency_us;
+    static HdrHistogram memtable_flush_latency_us;
+    static HdrHistogram publish_version_latency_us;
+    static HdrHistogram base_compaction_latency_us;
+    static HdrHistogram cumulative_compaction_latency_us;
+
+    static IntCounter fd_cache_hit_total;
+    static IntCounter fd_cache_miss_total;
+
     // Gauges
     static IntGauge memory_pool_bytes_total;
     static IntGauge process_thread_num;
@@ -17,6 +17,13 @@
 
 #include "util/metrics.h"
 
+#include <sched.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/logging.h"
+
 namespace doris {
 
 MetricLabels MetricLabels::EmptyLabels;
@@ -53,6 +60,117 @@ void Metric::hide() {
     _registry = nullptr;
 }
 
+IntHistogram::IntHistogram(const std::vector<int64_t>& bounds)
+        : Metric(MetricType::HISTOGRAM),
+          _bounds(bounds),
+          _buckets(new std::atomic<int64_t>[bounds.size() + 1]),
+          _count(0),
+          _sum(0) {
+    DCHECK(std::is_sorted(_bounds.begin(), _bounds.end()));
+    for (size_t i = 0; i <= _bounds.size(); ++i) {
+        _buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void IntHistogram::add(int64_t value) {
+    size_t idx = std::lower_bound(_bounds.begin(), _bounds.end(), value) - _bounds.begin();
+    _buckets[idx].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+const std::vector<int64_t>& IntHistogram::latency_ms_bounds() {
+    static const std::vector<int64_t> bounds = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000,
+        10000, 20000, 50000, 100000};
+    return bounds;
+}
+
+HdrHistogram::HdrHistogram()
+        : Metric(MetricType::SUMMARY),
+          _shards(new Shard[NUM_SHARDS]) {
+    for (int i = 0; i < NUM_SHARDS; ++i) {
+        for (int j = 0; j < NUM_BUCKETS; ++j) {
+            _shards[i].counts[j].store(0, std::memory_order_relaxed);
+        }
+        _shards[i].sum.store(0, std::memory_order_relaxed);
+    }
+}
+
+// Values less than SUB_BUCKETS have a bucket each. For larger values, every
+// range [2^n, 2^(n+1)) is divided into SUB_BUCKETS buckets.
+int HdrHistogram::bucket_index(int64_t value) {
+    if (value < SUB_BUCKETS) {
+        return value < 0 ? 0 : value;
+    }
+    int highest_bit = 63 - __builtin_clzll(value);
+    if (highest_bit >= MAX_VALUE_BITS) {
+        return NUM_BUCKETS - 1;
+    }
+    int shift = highest_bit - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + (value >> shift) - SUB_BUCKETS;
+}
+
+int64_t HdrHistogram::bucket_max_value(int idx) {
+    if (idx < SUB_BUCKETS) {
+        return idx;
+    }
+    int shift = idx / SUB_BUCKETS - 1;
+    int64_t sub_bucket = idx % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void HdrHistogram::add(int64_t value) {
+    Shard& shard = _shards[sched_getcpu() & (NUM_SHARDS - 1)];
+    shard.counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void HdrHistogram::snapshot(std::vector<int64_t>* bucket_counts,
+                            int64_t* count, int64_t* sum) const {
+    bucket_counts->assign(NUM_BUCKETS, 0);
+    *count = 0;
+    *sum = 0;
+    for (int i = 0; i < NUM_SHARDS; ++i) {
+        for (int j = 0; j < NUM_BUCKETS; ++j) {
+            int64_t bucket_count = _shards[i].counts[j].load(std::memory_order_relaxed);
+            (*bucket_counts)[j] += bucket_count;
+            *count += bucket_count;
+        }
+        *sum += _shards[i].sum.load(std::memory_order_relaxed);
+    }
+}
+
+int64_t HdrHistogram::value_at_quantile(const std::vector<int64_t>& bucket_counts,
+                                        int64_t count, double quantile) {
+    if (count == 0) {
+        return 0;
+    }
+    // rank of the value in [1, count]
+    int64_t rank = std::max<int64_t>(1, std::ceil(quantile * count));
+    int64_t seen = 0;
+    for (int i = 0; i < bucket_counts.size(); ++i) {
+        seen += bucket_counts[i];
+        if (seen >= rank) {
+            return bucket_max_value(i);
+        }
+    }
+    return bucket_max_value(bucket_counts.size() - 1);
+}
+
+int64_t HdrHistogram::value_at_quantile(double quantile) const {
+    std::vector<int64_t> bucket_counts;
+    int64_t count = 0;
+    int64_t sum = 0;
+    snapshot(&bucket_counts, &count, &sum);
+    return value_at_quantile(bucket_counts, count, quantile);
+}
+
+const std::vector<double>& HdrHistogram::exported_quantiles() {
+    static const std::vector<double> quantiles = {0.5, 0.9, 0.99, 0.999};
+    return quantiles;
+}
+
 bool MetricCollector::add_metic(const MetricLabels& labels, Metric* metric) {
     if (empty()) {
         _type = metric->type();
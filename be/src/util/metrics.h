@@ -25,6 +25,8 @@
 #include <string>
 #include <mutex>
 #include <iomanip>
+#include <memory>
+#include <vector>
 
 #include "util/spinlock.h"
 #include "util/core_local.h"
@@ -108,9 +110,7 @@ public:
     virtual ~CoreLocalCounter() { }
 
     std::string to_string() const override {
-        std::stringstream ss;
-        ss << value();
-        return ss.str();
+        return std::to_string(value());
     }
     
     T value() const {
@@ -143,6 +143,62 @@ public:
     virtual ~LockGauge() { }
 };
 
+// Gauge of integral type, which is updated without lock
+template<typename T>
+class AtomicGauge : public SimpleMetric {
+public:
+    AtomicGauge() :SimpleMetric(MetricType::GAUGE), _value(T()) { }
+    virtual ~AtomicGauge() { }
+
+    std::string to_string() const override {
+        return std::to_string(value());
+    }
+
+    T value() const {
+        return _value.load(std::memory_order_relaxed);
+    }
+
+    void increment(const T& delta) {
+        _value.fetch_add(delta, std::memory_order_relaxed);
+    }
+    void set_value(const T& value) {
+        _value.store(value, std::memory_order_relaxed);
+    }
+private:
+    std::atomic<T> _value;
+};
+
+// Histogram of observed values such as latencies, which counts the values in
+// buckets of fixed upper bounds. It is updated without lock.
+class IntHistogram : public Metric {
+public:
+    // buckets for latency in milliseconds
+    IntHistogram() : IntHistogram(latency_ms_bounds()) { }
+    // 'bounds' are the inclusive upper bounds of the buckets in ascending order,
+    // values larger than the last bound are counted in the +Inf bucket
+    IntHistogram(const std::vector<int64_t>& bounds);
+    virtual ~IntHistogram() { }
+
+    void add(int64_t value);
+
+    const std::vector<int64_t>& bounds() const { return _bounds; }
+    // Number of values in bucket 'idx', not including the smaller buckets.
+    // 'idx' of the +Inf bucket is bounds().size().
+    int64_t bucket_count(size_t idx) const {
+        return _buckets[idx].load(std::memory_order_relaxed);
+    }
+    int64_t count() const { return _count.load(std::memory_order_relaxed); }
+    int64_t sum() const { return _sum.load(std::memory_order_relaxed); }
+
+    // 1, 2, 5, 10, 20, 50 ... 100000
+    static const std::vector<int64_t>& latency_ms_bounds();
+private:
+    const std::vector<int64_t> _bounds;
+    std::unique_ptr<std::atomic<int64_t>[]> _buckets;
+    std::atomic<int64_t> _count;
+    std::atomic<int64_t> _sum;
+};
+
 // one key-value pair used to
 struct MetricLabel {
     std::string name;
@@ -243,6 +299,51 @@ struct MetricLabels {
     }
 };
 
+// Histogram of non-negative values such as latencies in microseconds. Like
+// HdrHistogram, it keeps values with a relative precision of 1/8 in buckets
+// whose width grows with the value, so that any quantile can be computed.
+// Buckets are sharded by cpu, so recording is cheap and rarely contended.
+// It is exported as a summary of some quantiles.
+class HdrHistogram : public Metric {
+public:
+    HdrHistogram();
+    virtual ~HdrHistogram() { }
+
+    void add(int64_t value);
+
+    // Get the number of values of every bucket, and the total count and sum,
+    // summed over all shards
+    void snapshot(std::vector<int64_t>* bucket_counts, int64_t* count, int64_t* sum) const;
+
+    // Get the value at 'quantile' in [0, 1] from a snapshot, which is the
+    // largest value of the bucket it is in
+    static int64_t value_at_quantile(const std::vector<int64_t>& bucket_counts,
+                                     int64_t count, double quantile);
+
+    int64_t value_at_quantile(double quantile) const;
+
+    // the quantiles exported
+    static const std::vector<double>& exported_quantiles();
+
+private:
+    static const int SUB_BUCKET_BITS = 3;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // values not less than 2^MAX_VALUE_BITS are counted in the last bucket
+    static const int MAX_VALUE_BITS = 40;
+    static const int NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+    static const int NUM_SHARDS = 16;
+
+    static int bucket_index(int64_t value);
+    static int64_t bucket_max_value(int idx);
+
+    // shards are large, so they hardly share cache lines
+    struct Shard {
+        std::atomic<int64_t> counts[NUM_BUCKETS];
+        std::atomic<int64_t> sum;
+    };
+    std::unique_ptr<Shard[]> _shards;
+};
+
 class MetricCollector;
 
 class MetricsVisitor {
@@ -338,8 +439,8 @@ using IntCounter = CoreLocalCounter<int64_t>;
 using IntLockCounter = LockCounter<int64_t>;
 using UIntCounter = CoreLocalCounter<uint64_t>;
 using DoubleCounter = LockCounter<double>;
-using IntGauge = LockGauge<int64_t>;
-using UIntGauge = LockGauge<uint64_t>;
+using IntGauge = AtomicGauge<int64_t>;
+using UIntGauge = AtomicGauge<uint64_t>;
 using DoubleGauge = LockGauge<double>;
 
 }
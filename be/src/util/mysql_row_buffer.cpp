@@ -17,7 +17,6 @@
 
 #include "util/mysql_row_buffer.h"
 
-#include <stdio.h>
 #include <stdlib.h>
 
 #include "common/logging.h"
@@ -102,20 +101,14 @@ int MysqlRowBuffer::reserve(int size) {
 
 int MysqlRowBuffer::push_tinyint(int8_t data) {
     // 1 for string trail, 1 for length, 1 for sign, other for digits
-    int ret = reserve(3 + MAX_TINYINT_WIDTH);
+    int ret = reserve(3 + MAX_INT_WIDTH);
 
     if (0 != ret) {
         LOG(ERROR) << "mysql row buffer reserver failed.";
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_TINYINT_WIDTH + 2, "%d", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
-
+    int length = FastInt32ToBufferLeft(data, _pos + 1) - (_pos + 1);
     int1store(_pos, length);
     _pos += length + 1;
     return 0;
@@ -123,20 +116,14 @@ int MysqlRowBuffer::push_tinyint(int8_t data) {
 
 int MysqlRowBuffer::push_smallint(int16_t data) {
     // 1 for string trail, 1 for length, 1 for sign, other for digits
-    int ret = reserve(3 + MAX_SMALLINT_WIDTH);
+    int ret = reserve(3 + MAX_INT_WIDTH);
 
     if (0 != ret) {
         LOG(ERROR) << "mysql row buffer reserver failed.";
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_SMALLINT_WIDTH + 2, "%d", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
-
+    int length = FastInt32ToBufferLeft(data, _pos + 1) - (_pos + 1);
     int1store(_pos, length);
     _pos += length + 1;
     return 0;
@@ -151,13 +138,7 @@ int MysqlRowBuffer::push_int(int32_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_INT_WIDTH + 2, "%d", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
-
+    int length = FastInt32ToBufferLeft(data, _pos + 1) - (_pos + 1);
     int1store(_pos, length);
     _pos += length + 1;
     return 0;
@@ -172,13 +153,7 @@ int MysqlRowBuffer::push_bigint(int64_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_BIGINT_WIDTH + 2, "%ld", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
-
+    int length = FastInt64ToBufferLeft(data, _pos + 1) - (_pos + 1);
     int1store(_pos, length);
     _pos += length + 1;
     return 0;
@@ -193,13 +168,7 @@ int MysqlRowBuffer::push_unsigned_bigint(uint64_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_BIGINT_WIDTH + 3, "%ld", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
-
+    int length = FastUInt64ToBufferLeft(data, _pos + 1) - (_pos + 1);
     int1store(_pos, length);
     _pos += length + 1;
     return 0;
@@ -20,16 +20,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 
 #include <sys/syscall.h>
 #include <linux/perf_event.h>
 
 #include "util/debug_util.h"
+#include "util/pretty_printer.h"
+
+using std::endl;
+using std::ifstream;
+using std::ios;
+using std::istringstream;
+using std::ostream;
+using std::setw;
+using std::string;
+using std::stringstream;
+using std::vector;
 
 namespace doris {
 
@@ -76,7 +89,7 @@ static bool init_event_attr(perf_event_attr* attr, PerfCounters::Counter counter
 
     case PerfCounters::PERF_COUNTER_SW_CONTEXT_SWITCHES:
         attr->type = PERF_TYPE_SOFTWARE;
-        attr->config = PERF_COUNT_SW_PAGE_FAULTS;
+        attr->config = PERF_COUNT_SW_CONTEXT_SWITCHES;
         break;
 
     case PerfCounters::PERF_COUNTER_SW_CPU_MIGRATIONS:
@@ -267,7 +280,7 @@ bool PerfCounters::init_proc_self_status_counter(Counter counter) {
         break;
 
     case PerfCounters::PERF_COUNTER_RESIDENT_SET_SIZE:
-        data.proc_status_field = "VmRS";
+        data.proc_status_field = "VmRSS";
         break;
 
     default:
@@ -492,7 +505,7 @@ const vector<int64_t>* PerfCounters::counters(int snapshot) const {
 
 void PerfCounters::pretty_print(ostream* s) const {
     std::ostream& stream = *s;
-    std::stream << setw(8) << "snapshot";
+    stream << setw(8) << "snapshot";
 
     for (int i = 0; i < _counter_names.size(); ++i) {
         stream << setw(PRETTY_PRINT_WIDTH) << _counter_names[i];
@@ -515,5 +528,85 @@ void PerfCounters::pretty_print(ostream* s) const {
     stream << endl;
 }
 
+// The read_format of the group is PERF_FORMAT_GROUP, in which the values of
+// all events follow the number of them.
+struct GroupReadFormat {
+    uint64_t nr;
+    uint64_t values[ThreadPerfCounters::NUM_EVENTS];
+};
+
+ThreadPerfCounters* ThreadPerfCounters::current() {
+    static thread_local std::unique_ptr<ThreadPerfCounters> counters;
+    static thread_local bool opened = false;
+    if (!opened) {
+        opened = true;
+        counters.reset(new ThreadPerfCounters());
+        if (!counters->open()) {
+            counters.reset();
+        }
+    }
+    return counters.get();
+}
+
+ThreadPerfCounters::ThreadPerfCounters() : _group_fd(-1), _num_opened(0) {
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        _value_index[i] = -1;
+        _fds[i] = -1;
+    }
+}
+
+ThreadPerfCounters::~ThreadPerfCounters() {
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        if (_fds[i] >= 0) {
+            close(_fds[i]);
+        }
+    }
+}
+
+bool ThreadPerfCounters::open() {
+    static const uint64_t configs[NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES,
+    };
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(perf_event_attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // counters of the calling thread on any cpu
+        int fd = sys_perf_event_open(&attr, 0, -1, _group_fd, 0);
+        if (fd < 0) {
+            // the group can't be opened without the leader
+            if (_group_fd == -1) {
+                return false;
+            }
+            continue;
+        }
+        if (_group_fd == -1) {
+            _group_fd = fd;
+        }
+        _fds[i] = fd;
+        _value_index[i] = _num_opened++;
+    }
+    return true;
+}
+
+bool ThreadPerfCounters::read(int64_t* values) const {
+    GroupReadFormat data;
+    ssize_t num_bytes = ::read(_group_fd, &data, sizeof(data));
+    if (num_bytes < (ssize_t)sizeof(uint64_t) || data.nr != (uint64_t)_num_opened) {
+        return false;
+    }
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        values[i] = _value_index[i] >= 0 ? data.values[_value_index[i]] : 0;
+    }
+    return true;
+}
+
 }
 
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "util/debug_util.h"
+#include "util/runtime_profile.h"
 
 // This is a utility class that aggregates counters from the kernel.  These counters
 // come from different sources.
@@ -139,6 +140,87 @@ private:
     int _group_fd;
 };
 
+// Hardware counters of the calling thread, which count in user space since the
+// thread uses them first, and are read together as one perf_event group.
+// Unlike PerfCounters, they are used to measure pieces of code running on
+// different threads, e.g. get_next() of exec nodes, by the differences of
+// the values read before and after the code.
+class ThreadPerfCounters {
+public:
+    enum Event {
+        CPU_CYCLES = 0,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        NUM_EVENTS
+    };
+
+    // Return the counters of the calling thread, which are opened on the
+    // first call and closed when the thread exits. Return nullptr if the
+    // cpu cycles counter can't be opened, e.g. in a VM without PMU or when
+    // kernel.perf_event_paranoid forbids it.
+    static ThreadPerfCounters* current();
+
+    // Read the values of all events into 'values', the events which can't be
+    // opened are always 0. Return false if the group can't be read.
+    bool read(int64_t* values) const;
+
+    ~ThreadPerfCounters();
+
+private:
+    ThreadPerfCounters();
+    bool open();
+
+    int _group_fd;
+    int _num_opened;
+    // index of the value of each event in the group, or -1 if not opened
+    int _value_index[NUM_EVENTS];
+    int _fds[NUM_EVENTS];
+
+    ThreadPerfCounters(const ThreadPerfCounters&);
+    ThreadPerfCounters& operator=(const ThreadPerfCounters&);
+};
+
+// Adds the increments of the hardware counters of the calling thread during
+// its lifetime into 'counters', which are indexed by ThreadPerfCounters::Event.
+// Nothing is read if 'counters' is empty, so that it costs only a branch when
+// it is disabled.
+class ScopedPerfCounters {
+public:
+    explicit ScopedPerfCounters(const std::vector<RuntimeProfile::Counter*>& counters)
+            : _counters(counters), _thread_counters(nullptr) {
+        if (!_counters.empty()) {
+            _thread_counters = ThreadPerfCounters::current();
+            if (_thread_counters != nullptr && !_thread_counters->read(_start)) {
+                _thread_counters = nullptr;
+            }
+        }
+    }
+
+    ~ScopedPerfCounters() {
+        if (_thread_counters == nullptr) {
+            return;
+        }
+        int64_t end[ThreadPerfCounters::NUM_EVENTS];
+        if (!_thread_counters->read(end)) {
+            return;
+        }
+        for (int i = 0; i < ThreadPerfCounters::NUM_EVENTS && i < _counters.size(); ++i) {
+            if (_counters[i] != nullptr) {
+                _counters[i]->update(end[i] - _start[i]);
+            }
+        }
+    }
+
+private:
+    const std::vector<RuntimeProfile::Counter*>& _counters;
+    ThreadPerfCounters* _thread_counters;
+    int64_t _start[ThreadPerfCounters::NUM_EVENTS];
+};
+
+#define SCOPED_PERF_COUNTERS(c) \
+      ScopedPerfCounters MACRO_CONCAT(SCOPED_PERF_COUNTERS, __COUNTER__)(c)
+
 }
 
 #endif
@@ -18,47 +18,100 @@
 #ifndef DORIS_BE_SRC_COMMON_UTIL_PRIORITY_THREAD_POOL_HPP
 #define DORIS_BE_SRC_COMMON_UTIL_PRIORITY_THREAD_POOL_HPP
 
-#include "util/blocking_priority_queue.hpp"
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
 
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/bind/mem_fn.hpp>
 
+#include "common/config.h"
+#include "util/aligned_new.h"
+#include "util/cpu_info.h"
+#include "util/spinlock.h"
+
 namespace doris {
 
-// Simple threadpool which processes items (of type T) in parallel which were placed on a
-// blocking queue by Offer(). Each item is processed by a single user-supplied method.
+// Threadpool which runs tasks in parallel in the order of their priority. Tasks with a
+// higher priority value run first.
+//
+// Every thread owns a queue, which keeps one FIFO per priority level under a spin lock.
+// offer() spreads tasks round-robin over the queues, a thread takes the best task of its
+// own queue and steals from the queues of the other threads when its own is empty, so
+// offering and taking a task never serializes on a lock shared by the whole pool. The
+// priority order is therefore per queue, not global.
+//
+// Waiting tasks age: a task gains AGING_STEP of priority for every
+// priority_queue_remaining_tasks_increased_frequency tasks the pool has taken since
+// it was offered, so big low priority queries are not starved. Since the tasks of a
+// level are aged alike, only the head of every level has to be looked at.
+//
+// A pool created with numa_aware = true on a multi-node machine splits its threads
+// evenly across NUMA nodes and pins each thread to the cores of its node. A task whose
+// numa_node is set is offered to a thread of that node, and threads steal from the
+// threads of their own node first, so the memory a task touches first (e.g. the
+// RowBatches of a scanner) is allocated node-locally.
 class PriorityThreadPool {
 public:
-    // Signature of a work-processing function. Takes the integer id of the thread which is
-    // calling it (ids run from 0 to num_threads - 1) and a reference to the item to
-    // process.
+    // Signature of a work-processing function.
     typedef boost::function<void ()> WorkFunction;
 
     struct Task {
     public:
         int priority;
         WorkFunction work_function;
-        bool operator< (const Task& o) const {
-            return priority < o.priority;
-        }
-
-        Task& operator++() {
-            priority += 2;
-            return *this;
-        }
+        // preferred NUMA node of the task, -1 if it has none
+        int numa_node = -1;
     };
 
     // Creates a new thread pool and start num_threads threads.
     //  -- num_threads: how many threads are part of this pool
-    //  -- queue_size: the maximum size of the queue on which work items are offered. If the
-    //     queue exceeds this size, subsequent calls to Offer will block until there is
-    //     capacity available.
-    //  -- work_function: the function to run every time an item is consumed from the queue
-    PriorityThreadPool(uint32_t num_threads, uint32_t queue_size) :
+    //  -- queue_size: the maximum number of queued tasks per NUMA node. If the pool holds
+    //     more, subsequent calls to offer will block until there is capacity available.
+    //  -- numa_aware: whether to pin threads to NUMA nodes, see class comment.
+    PriorityThreadPool(uint32_t num_threads, uint32_t queue_size, bool numa_aware = false) :
             _thread_num(num_threads),
-            _work_queue(queue_size),
             _shutdown(false) {
+        DCHECK_GT(num_threads, 0);
+        int num_nodes = 1;
+        if (numa_aware && CpuInfo::get_max_num_numa_nodes() > 1
+                && num_threads >= static_cast<uint32_t>(CpuInfo::get_max_num_numa_nodes())) {
+            num_nodes = CpuInfo::get_max_num_numa_nodes();
+            _numa_aware = true;
+        }
+        _capacity = queue_size * num_nodes;
+        _node_workers.resize(num_nodes);
+        _node_num_tasks.reset(new std::atomic<int32_t>[num_nodes]);
+        for (int node = 0; node < num_nodes; ++node) {
+            _node_num_tasks[node] = 0;
+        }
+        for (int i = 0; i < num_threads; ++i) {
+            _worker_queues.emplace_back(new WorkerQueue());
+            _worker_queues[i]->node = i % num_nodes;
+            _node_workers[i % num_nodes].push_back(i);
+        }
+        // steal from the threads of the same node first, starting after the thief so that
+        // thieves do not all go for the same queue
+        for (int i = 0; i < num_threads; ++i) {
+            int node = _worker_queues[i]->node;
+            for (int j = 1; j < num_threads; ++j) {
+                int victim = (i + j) % num_threads;
+                if (_worker_queues[victim]->node == node) {
+                    _worker_queues[i]->victims.push_back(victim);
+                }
+            }
+            for (int j = 1; j < num_threads; ++j) {
+                int victim = (i + j) % num_threads;
+                if (_worker_queues[victim]->node != node) {
+                    _worker_queues[i]->victims.push_back(victim);
+                }
+            }
+        }
         for (int i = 0; i < num_threads; ++i) {
             _threads.create_thread(
                     boost::bind<void>(
@@ -85,7 +138,32 @@ public:
     // Returns true if the work item was successfully added to the queue, false otherwise
     // (which typically means that the thread pool has already been shut down).
     bool offer(Task task) {
-        return _work_queue.blocking_put(task);
+        if (!_reserve_slot()) {
+            return false;
+        }
+        WorkerQueue* queue = _worker_queues[_choose_worker(task.numa_node)].get();
+        int level = task.priority < 0 ? 0
+                : (task.priority > MAX_PRIORITY_LEVEL ? MAX_PRIORITY_LEVEL : task.priority);
+        uint64_t epoch = _current_epoch();
+        {
+            boost::lock_guard<SpinLock> l(queue->lock);
+            queue->levels[level].emplace_back(std::move(task), epoch);
+            queue->level_mask |= 1u << level;
+            queue->size.fetch_add(1, std::memory_order_relaxed);
+        }
+        _node_num_tasks[queue->node].fetch_add(1, std::memory_order_relaxed);
+        if (_num_idle_threads.load() > 0) {
+            boost::lock_guard<boost::mutex> l(_lock);
+            _work_cv.notify_one();
+        }
+        return true;
+    }
+
+    bool is_numa_aware() const { return _numa_aware; }
+
+    // Returns the NUMA node of the core the calling thread is running on
+    static int current_numa_node() {
+        return CpuInfo::get_numa_node_of_core(CpuInfo::get_current_core());
     }
 
     // Shuts the thread pool down, causing the work queue to cease accepting offered work
@@ -97,7 +175,8 @@ public:
             boost::lock_guard<boost::mutex> l(_lock);
             _shutdown = true;
         }
-        _work_queue.shutdown();
+        _work_cv.notify_all();
+        _put_cv.notify_all();
     }
 
     // Blocks until all threads are finished. shutdown does not need to have been called,
@@ -107,7 +186,7 @@ public:
     }
 
     uint32_t get_queue_size() const {
-        return _work_queue.get_size();
+        return _num_tasks.load();
     }
 
     // Blocks until the work queue is empty, and then calls shutdown to stop the worker
@@ -116,7 +195,7 @@ public:
     void drain_and_shutdown() {
         {
             boost::unique_lock<boost::mutex> l(_lock);
-            while (_work_queue.get_size() != 0) {
+            while (get_queue_size() != 0) {
                 _empty_cv.wait(l);
             }
         }
@@ -125,40 +204,235 @@ public:
     }
 
 private:
-    // Driver method for each thread in the pool. Continues to read work from the queue
+    // Priorities above this share the highest level
+    static const int MAX_PRIORITY_LEVEL = 31;
+    // Priority a queued task gains per aging epoch
+    static const int AGING_STEP = 2;
+
+    struct QueuedTask {
+        QueuedTask(Task&& task_, uint64_t epoch_) : task(std::move(task_)), epoch(epoch_) { }
+        Task task;
+        // aging epoch in which the task was offered
+        uint64_t epoch;
+    };
+
+    // Queue owned by one thread
+    struct WorkerQueue : public CacheLineAligned {
+        // guards level_mask and levels
+        SpinLock lock;
+        // bit i is set iff levels[i] is not empty
+        uint32_t level_mask = 0;
+        std::deque<QueuedTask> levels[MAX_PRIORITY_LEVEL + 1];
+        // number of queued tasks, to skip empty queues without locking them
+        std::atomic<uint32_t> size{0};
+        int node = 0;
+        // ids of the threads to steal from, in order
+        std::vector<int> victims;
+    };
+
+    // Driver method for each thread in the pool. Continues to read work from the queues
     // until the pool is shutdown.
     void work_thread(int thread_id) {
+        WorkerQueue* queue = _worker_queues[thread_id].get();
+        if (_numa_aware) {
+            _bind_to_numa_node(queue->node);
+        }
         while (!is_shutdown()) {
             Task task;
-            if (_work_queue.blocking_get(&task)) {
-                task.work_function();
+            if (!_take(queue, &task)) {
+                _wait_for_work();
+                continue;
             }
-            if (_work_queue.get_size() == 0) {
+            task.work_function();
+            if (get_queue_size() == 0) {
+                boost::lock_guard<boost::mutex> l(_lock);
                 _empty_cv.notify_all();
             }
         }
     }
 
-    // Returns value of _shutdown under a lock, forcing visibility to threads in the pool.
+    // Takes the best task of the own queue, or steals one. Returns false if all queues
+    // are empty.
+    bool _take(WorkerQueue* own, Task* task) {
+        uint64_t epoch = _current_epoch();
+        WorkerQueue* from = own;
+        bool found = _pop_best(own, epoch, task);
+        for (int i = 0; !found && i < own->victims.size(); ++i) {
+            from = _worker_queues[own->victims[i]].get();
+            found = _pop_best(from, epoch, task);
+        }
+        if (!found) {
+            return false;
+        }
+        _node_num_tasks[from->node].fetch_sub(1, std::memory_order_relaxed);
+        _num_taken.fetch_add(1, std::memory_order_relaxed);
+        _num_tasks.fetch_sub(1);
+        if (_num_blocked_offers.load() > 0) {
+            boost::lock_guard<boost::mutex> l(_lock);
+            _put_cv.notify_one();
+        }
+        return true;
+    }
+
+    // Pops the task of 'queue' with the highest aged priority. Within a level the oldest
+    // task is the most aged one, so only the heads of the levels are compared.
+    bool _pop_best(WorkerQueue* queue, uint64_t epoch, Task* task) {
+        if (queue->size.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        boost::lock_guard<SpinLock> l(queue->lock);
+        uint32_t mask = queue->level_mask;
+        if (mask == 0) {
+            return false;
+        }
+        int best_level = -1;
+        int64_t best_priority = 0;
+        while (mask != 0) {
+            int level = 31 - __builtin_clz(mask);
+            mask &= ~(1u << level);
+            // the head may have been offered after 'epoch' was read
+            int64_t age = static_cast<int64_t>(epoch - queue->levels[level].front().epoch);
+            int64_t priority = level + AGING_STEP * age;
+            if (best_level < 0 || priority > best_priority) {
+                best_level = level;
+                best_priority = priority;
+            }
+        }
+        std::deque<QueuedTask>& tasks = queue->levels[best_level];
+        *task = std::move(tasks.front().task);
+        tasks.pop_front();
+        if (tasks.empty()) {
+            queue->level_mask &= ~(1u << best_level);
+        }
+        queue->size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Sleeps until a task is offered or the pool is shut down.
+    void _wait_for_work() {
+        boost::unique_lock<boost::mutex> l(_lock);
+        // offer() increases _num_tasks before it reads _num_idle_threads, so either it
+        // sees this thread idle and notifies it, or the task is seen here.
+        _num_idle_threads.fetch_add(1);
+        while (_num_tasks.load() == 0 && !_shutdown) {
+            _work_cv.wait(l);
+        }
+        _num_idle_threads.fetch_sub(1);
+    }
+
+    // Reserves room for one task, blocking while the pool is full. Returns false if the
+    // pool is shut down.
+    bool _reserve_slot() {
+        uint32_t num = _num_tasks.load();
+        while (true) {
+            if (_shutdown) {
+                return false;
+            }
+            if (num < _capacity) {
+                if (_num_tasks.compare_exchange_weak(num, num + 1)) {
+                    return true;
+                }
+                continue;
+            }
+            boost::unique_lock<boost::mutex> l(_lock);
+            _num_blocked_offers.fetch_add(1);
+            while ((num = _num_tasks.load()) >= _capacity && !_shutdown) {
+                _put_cv.wait(l);
+            }
+            _num_blocked_offers.fetch_sub(1);
+        }
+    }
+
+    // Tasks go to the threads of their node unless that node is behind the least loaded
+    // node by more than a round of its threads, so that a skewed placement of data dirs
+    // does not leave the threads of other nodes idle.
+    int _choose_worker(int numa_node) {
+        uint32_t next = _next_worker.fetch_add(1, std::memory_order_relaxed);
+        if (!_numa_aware) {
+            return next % _thread_num;
+        }
+        int num_nodes = _node_workers.size();
+        int shortest = 0;
+        for (int i = 1; i < num_nodes; ++i) {
+            if (_node_num_tasks[i].load(std::memory_order_relaxed)
+                    < _node_num_tasks[shortest].load(std::memory_order_relaxed)) {
+                shortest = i;
+            }
+        }
+        int node = numa_node;
+        if (node < 0 || node >= num_nodes
+                || _node_num_tasks[node].load(std::memory_order_relaxed)
+                    > _node_num_tasks[shortest].load(std::memory_order_relaxed)
+                        + static_cast<int>(_node_workers[node].size())) {
+            node = shortest;
+        }
+        return _node_workers[node][next % _node_workers[node].size()];
+    }
+
+    uint64_t _current_epoch() const {
+        return _num_taken.load(std::memory_order_relaxed)
+                / std::max(1, config::priority_queue_remaining_tasks_increased_frequency);
+    }
+
+    static void _bind_to_numa_node(int node) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (int core : CpuInfo::get_cores_of_numa_node(node)) {
+            CPU_SET(core, &cpuset);
+        }
+        int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+        if (ret != 0) {
+            LOG(WARNING) << "failed to bind thread to numa node " << node << ", ret=" << ret;
+        }
+    }
+
     bool is_shutdown() {
-        boost::lock_guard<boost::mutex> l(_lock);
-        return _shutdown;
+        return _shutdown.load();
     }
 
     uint32_t _thread_num;
 
-    // Queue on which work items are held until a thread is available to process them in
-    // FIFO order.
-    BlockingPriorityQueue<Task> _work_queue;
+    // Maximum number of queued tasks
+    uint32_t _capacity;
+
+    // One queue per thread
+    std::vector<std::unique_ptr<WorkerQueue>> _worker_queues;
+
+    // Ids of the threads of each NUMA node
+    std::vector<std::vector<int>> _node_workers;
+
+    // Number of tasks queued at the threads of each NUMA node
+    std::unique_ptr<std::atomic<int32_t>[]> _node_num_tasks;
+
+    bool _numa_aware = false;
+
+    // Number of queued tasks, including those being offered
+    std::atomic<uint32_t> _num_tasks{0};
+
+    // Number of tasks taken, drives the aging epochs
+    std::atomic<uint64_t> _num_taken{0};
+
+    // Used to spread offered tasks over the threads
+    std::atomic<uint32_t> _next_worker{0};
+
+    std::atomic<int32_t> _num_idle_threads{0};
+    std::atomic<int32_t> _num_blocked_offers{0};
 
     // Collection of worker threads that process work from the queue.
     boost::thread_group _threads;
 
-    // Guards _shutdown and _empty_cv
+    // Guards the condition variables below. Only taken to sleep and to wake up
+    // sleeping threads.
     boost::mutex _lock;
 
     // Set to true when threads should stop doing work and terminate.
-    bool _shutdown;
+    std::atomic<bool> _shutdown;
+
+    // Signalled when a task is offered
+    boost::condition_variable _work_cv;
+
+    // Signalled when a task is taken from a full pool
+    boost::condition_variable _put_cv;
 
     // Signalled when the queue becomes empty
     boost::condition_variable _empty_cv;
@@ -51,6 +51,13 @@ namespace doris {
       ScopedTimer<MonotonicStopWatch> MACRO_CONCAT(SCOPED_TIMER, __COUNTER__)(c)
 #define SCOPED_RAW_TIMER(c) \
       ScopedRawTimer<MonotonicStopWatch> MACRO_CONCAT(SCOPED_RAW_TIMER, __COUNTER__)(c)
+// Cheaper timers for scopes in inner loops, see CpuStopWatch and ScopedSampledTimer
+#define SCOPED_CPU_TIMER(c) \
+      ScopedTimer<CpuStopWatch> MACRO_CONCAT(SCOPED_CPU_TIMER, __COUNTER__)(c)
+#define SCOPED_SAMPLED_TIMER(c, sample_rate) \
+      static __thread uint32_t MACRO_CONCAT(SAMPLED_TIMER_TICKS, __LINE__) = 0; \
+      ScopedSampledTimer<CpuStopWatch> MACRO_CONCAT(SCOPED_SAMPLED_TIMER, __LINE__)( \
+          c, sample_rate, &MACRO_CONCAT(SAMPLED_TIMER_TICKS, __LINE__))
 #define COUNTER_UPDATE(c, v) (c)->update(v)
 #define COUNTER_SET(c, v) (c)->set(v)
 #define ADD_THREAD_COUNTERS(profile, prefix) (profile)->add_thread_counters(prefix)
@@ -62,6 +69,8 @@ namespace doris {
 #define ADD_TIMER(profile, name) NULL
 #define SCOPED_TIMER(c)
 #define SCOPED_RAW_TIMER(c)
+#define SCOPED_CPU_TIMER(c)
+#define SCOPED_SAMPLED_TIMER(c, sample_rate)
 #define COUNTER_UPDATE(c, v)
 #define COUNTER_SET(c, v)
 #define ADD_THREADCOUNTERS(profile, prefix) NULL
@@ -735,6 +744,46 @@ private:
     int64_t* _counter;
 };
 
+// Utility class to time a very hot scope, which only measures one of every
+// 'sample_rate' times the scope is entered, and counts the elapsed time of the
+// measured one 'sample_rate' times. 'ticks' is the number of times the scope
+// has been entered, which should be thread local to each scope so that it is
+// not contended, see SCOPED_SAMPLED_TIMER.
+template<class T>
+class ScopedSampledTimer {
+public:
+    ScopedSampledTimer(RuntimeProfile::Counter* counter, uint32_t sample_rate, uint32_t* ticks) :
+            _counter(counter),
+            _sample_rate(sample_rate) {
+        if (counter == NULL) {
+            return;
+        }
+        DCHECK(counter->type() == TUnit::TIME_NS);
+        DCHECK_GT(sample_rate, 0);
+        if (++(*ticks) >= sample_rate) {
+            *ticks = 0;
+            _sampled = true;
+            _sw.start();
+        }
+    }
+
+    ~ScopedSampledTimer() {
+        if (_sampled) {
+            _counter->update(_sw.elapsed_time() * _sample_rate);
+        }
+    }
+
+private:
+    // Disable copy constructor and assignment
+    ScopedSampledTimer(const ScopedSampledTimer& timer);
+    ScopedSampledTimer& operator=(const ScopedSampledTimer& timer);
+
+    T _sw;
+    RuntimeProfile::Counter* _counter;
+    uint32_t _sample_rate;
+    bool _sampled = false;
+};
+
 }
 
 #endif
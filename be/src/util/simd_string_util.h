@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_UTIL_SIMD_STRING_UTIL_H
+#define DORIS_BE_SRC_UTIL_SIMD_STRING_UTIL_H
+
+#include <stdint.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace doris {
+
+// Byte string kernels of the string functions which handle 16 bytes per step with
+// SSE2, and a byte at a time for the tail or without SSE2.
+class SimdStringUtil {
+public:
+    // Writes 'src' with the ASCII letters converted to lower/upper case into 'dst',
+    // which may be 'src'. Other bytes, including all of multi byte UTF-8 characters,
+    // are copied unchanged, like ::tolower() in the C locale.
+    static void to_lower(const uint8_t* src, int64_t len, uint8_t* dst) {
+        convert_case<'A', 'Z'>(src, len, dst);
+    }
+
+    static void to_upper(const uint8_t* src, int64_t len, uint8_t* dst) {
+        convert_case<'a', 'z'>(src, len, dst);
+    }
+
+    // Returns the number of leading 'c' bytes of 'src'.
+    static int64_t count_leading(const uint8_t* src, int64_t len, uint8_t c) {
+        int64_t i = 0;
+#ifdef __SSE2__
+        const __m128i pattern = _mm_set1_epi8(c);
+        for (; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, pattern)) ^ 0xFFFF;
+            if (mask != 0) {
+                return i + __builtin_ctz(mask);
+            }
+        }
+#endif
+        while (i < len && src[i] == c) {
+            ++i;
+        }
+        return i;
+    }
+
+    // Returns the number of trailing 'c' bytes of 'src'.
+    static int64_t count_trailing(const uint8_t* src, int64_t len, uint8_t c) {
+        int64_t end = len;
+#ifdef __SSE2__
+        const __m128i pattern = _mm_set1_epi8(c);
+        for (; end >= 16; end -= 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + end - 16));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, pattern)) ^ 0xFFFF;
+            if (mask != 0) {
+                // the highest set bit is the last byte which is not 'c'
+                return len - (end - 16 + 31 - __builtin_clz(mask)) - 1;
+            }
+        }
+#endif
+        while (end > 0 && src[end - 1] == c) {
+            --end;
+        }
+        return len - end;
+    }
+
+    // Returns the number of UTF-8 characters in 'src', which is the number of bytes
+    // which are not continuation bytes (10xxxxxx). Invalid UTF-8 is not detected.
+    static int64_t utf8_length(const uint8_t* src, int64_t len) {
+        int64_t continuation_bytes = 0;
+        int64_t i = 0;
+#ifdef __SSE2__
+        // continuation bytes are the signed bytes below -64 (0xC0)
+        const __m128i threshold = _mm_set1_epi8(-64);
+        for (; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            continuation_bytes += __builtin_popcount(
+                _mm_movemask_epi8(_mm_cmplt_epi8(v, threshold)));
+        }
+#endif
+        for (; i < len; ++i) {
+            continuation_bytes += (src[i] & 0xC0) == 0x80;
+        }
+        return len - continuation_bytes;
+    }
+
+private:
+    template <uint8_t FROM_BEGIN, uint8_t FROM_END>
+    static void convert_case(const uint8_t* src, int64_t len, uint8_t* dst) {
+        int64_t i = 0;
+#ifdef __SSE2__
+        // Shift [FROM_BEGIN, FROM_END] to the bottom of the signed byte range so that
+        // a single signed compare finds the letters, then flip their case bit.
+        const __m128i shift = _mm_set1_epi8(static_cast<char>(0x80 - FROM_BEGIN));
+        const __m128i bound = _mm_set1_epi8(static_cast<char>(0x80 + FROM_END - FROM_BEGIN + 1));
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        for (; i + 16 <= len; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i letters = _mm_cmplt_epi8(_mm_add_epi8(v, shift), bound);
+            v = _mm_xor_si128(v, _mm_and_si128(letters, case_bit));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+        }
+#endif
+        for (; i < len; ++i) {
+            uint8_t c = src[i];
+            dst[i] = (c >= FROM_BEGIN && c <= FROM_END) ? (c ^ 0x20) : c;
+        }
+    }
+};
+
+}
+
+#endif
@@ -31,7 +31,10 @@ private:
     BOOST_STATIC_ASSERT(offsetof(StringValue, len) == 8);
     // Datetime value
     BOOST_STATIC_ASSERT(sizeof(DateTimeValue) == 16);
-    // BOOST_STATIC_ASSERT(offsetof(DateTimeValue, _year) == 8);
+    // DateTimeValue::packed_key() reads the first 8 bytes as an integer
+    BOOST_STATIC_ASSERT(offsetof(DateTimeValue, _year) == 6);
+    BOOST_STATIC_ASSERT(offsetof(DateTimeValue, _microsecond) == 8);
+    BOOST_STATIC_ASSERT(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
     BOOST_STATIC_ASSERT(sizeof(DecimalValue) == 40);
 };
 
@@ -21,6 +21,8 @@
 #include <boost/cstdint.hpp>
 #include <time.h>
 
+#include "util/cpu_info.h"
+
 namespace doris {
 
 // Utility class to measure time.  This is measured using the cpu tick counter which
@@ -53,11 +55,11 @@ public:
         return _running ? rdtsc() - _start : _total_time;
     }
 
+    // Not serialized by cpuid, which costs 100+ cycles and even traps to the
+    // hypervisor in a virtual machine. The few instructions which may be
+    // reordered around it do not matter for what we measure.
     static uint64_t rdtsc() {
         uint32_t lo, hi;
-        __asm__ __volatile__(
-            "xorl %%eax,%%eax \n        cpuid"
-            ::: "%rax", "%rbx", "%rcx", "%rdx");
         __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
         return (uint64_t)hi << 32 | lo;
     }
@@ -67,6 +69,32 @@ private:
     bool _running;
 };
 
+// Same as StopWatch, except that the elapsed time is returned in nanosec, so that
+// it can be used to update TIME_NS counters. It is cheaper than MonotonicStopWatch
+// and is meant for short scopes in inner loops. Like StopWatch, it is inaccurate
+// if the thread is switched away or migrated to another cpu.
+class CpuStopWatch {
+public:
+    void start() {
+        _sw.start();
+    }
+
+    void stop() {
+        _sw.stop();
+    }
+
+    // Returns time in nanosecond.
+    uint64_t elapsed_time() const {
+        uint64_t ticks = _sw.elapsed_time();
+        uint64_t ticks_per_ms = CpuInfo::cycles_per_ms();
+        // avoid overflow for long scopes
+        return ticks / ticks_per_ms * 1000000 + ticks % ticks_per_ms * 1000000 / ticks_per_ms;
+    }
+
+private:
+    StopWatch _sw;
+};
+
 // Stop watch for reporting elapsed time in nanosec based on CLOCK_MONOTONIC.
 // It is as fast as Rdtsc.
 // It is also accurate because it not affected by cpu frequency changes and
@@ -123,6 +151,47 @@ private:
     bool _running;
 };
 
+// Stop watch for reporting the cpu time used by the calling thread in nanosec, based
+// on CLOCK_THREAD_CPUTIME_ID. It must be started, stopped and read in the same thread.
+class ThreadCpuStopWatch {
+public:
+    ThreadCpuStopWatch() {
+        _total_time = 0;
+        _running = false;
+    }
+
+    void start() {
+        if (!_running) {
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &_start);
+            _running = true;
+        }
+    }
+
+    void stop() {
+        if (_running) {
+            _total_time = elapsed_time();
+            _running = false;
+        }
+    }
+
+    // Returns time in nanosecond.
+    uint64_t elapsed_time() const {
+        if (!_running) {
+            return _total_time;
+        }
+
+        timespec end;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+        return _total_time + (end.tv_sec - _start.tv_sec) * 1000L * 1000L * 1000L +
+               (end.tv_nsec - _start.tv_nsec);
+    }
+
+private:
+    timespec _start;
+    uint64_t _total_time; // in nanosec
+    bool _running;
+};
+
 }
 
 #endif
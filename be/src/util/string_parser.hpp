@@ -47,9 +47,8 @@ namespace doris {
 //
 // Things we tried that did not work:
 //  - lookup table for converting character to digit
-// Improvements (TODO):
-//  - Validate input using _sidd_compare_ranges
-//  - Since we know the length, we can parallelize this: i.e. result = 100*s[0] + 10*s[1] + s[2]
+// Runs of 8 digits are validated and converted with a few 64-bit multiplies instead of
+// one multiply-add per digit (see is_eight_digits()/parse_eight_digits()).
 class StringParser {
 public:
     enum ParseResult {
@@ -180,6 +179,35 @@ private:
     template <typename T>
     static inline T string_to_float_internal(const char* s, int len, ParseResult* result);
 
+    // Converts plain decimals of up to 19 significant digits ([+-]digits[.digits]) of
+    // which the result is exactly representable as a double (Clinger's fast path), so
+    // the result is the same as strtod's. Returns false for everything else, in which
+    // case nothing is written.
+    static inline bool string_to_double_fast(const char* s, int len, double* val);
+
+    // Accumulates the leading ascii digits of s into 'val' and returns their number.
+    static inline int accumulate_digits(const char* s, int len, uint64_t* val);
+
+    // Returns true if the 8 bytes starting at s are all ascii digits.
+    static inline bool is_eight_digits(const char* s) {
+        uint64_t val;
+        memcpy(&val, s, sizeof(val));
+        return ((val & 0xF0F0F0F0F0F0F0F0ULL)
+                | (((val + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+            == 0x3333333333333333ULL;
+    }
+
+    // Converts the 8 ascii digits starting at s, which must pass is_eight_digits().
+    // Pairs of digits, then pairs of 2-digit and 4-digit numbers are combined in
+    // parallel within one word. Assumes a little endian machine.
+    static inline uint32_t parse_eight_digits(const char* s) {
+        uint64_t val;
+        memcpy(&val, s, sizeof(val));
+        val = (val & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+        val = (val & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+        return static_cast<uint32_t>((val & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32);
+    }
+
     // parses a string for 'true' or 'false', case insensitive
     // Return PARSE_FAILURE on leading whitespace. Trailing whitespace is allowed.
     static inline bool string_to_bool_internal(const char* s, int len, ParseResult* result);
@@ -338,7 +366,15 @@ inline T StringParser::string_to_int_no_overflow(const char* s, int len, ParseRe
         *result = PARSE_FAILURE;
         return 0;
     }
-    for (int i = 1; i < len; ++i) {
+    int i = 1;
+    // 8 digits only fit into types of at least 32 bits.
+    if (sizeof(T) >= sizeof(uint32_t)) {
+        while (len - i >= 8 && is_eight_digits(s + i)) {
+            val = val * 100000000 + parse_eight_digits(s + i);
+            i += 8;
+        }
+    }
+    for (; i < len; ++i) {
         if (LIKELY(s[i] >= '0' && s[i] <= '9')) {
             T digit = s[i] - '0';
             val = val * 10 + digit;
@@ -355,6 +391,47 @@ inline T StringParser::string_to_int_no_overflow(const char* s, int len, ParseRe
     return val;
 }
 
+inline int StringParser::accumulate_digits(const char* s, int len, uint64_t* val) {
+    int i = 0;
+    while (len - i >= 8 && is_eight_digits(s + i)) {
+        *val = *val * 100000000 + parse_eight_digits(s + i);
+        i += 8;
+    }
+    while (i < len && s[i] >= '0' && s[i] <= '9') {
+        *val = *val * 10 + (s[i] - '0');
+        ++i;
+    }
+    return i;
+}
+
+inline bool StringParser::string_to_double_fast(const char* s, int len, double* val) {
+    // Powers of ten which are exactly representable as a double.
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    bool negative = (*s == '-');
+    int i = (negative || *s == '+') ? 1 : 0;
+    // 'mantissa' wraps around past 19 digits, such input is rejected below.
+    uint64_t mantissa = 0;
+    int int_digits = accumulate_digits(s + i, len - i, &mantissa);
+    i += int_digits;
+    int frac_digits = 0;
+    if (i < len && s[i] == '.') {
+        ++i;
+        frac_digits = accumulate_digits(s + i, len - i, &mantissa);
+        i += frac_digits;
+    }
+    int num_digits = int_digits + frac_digits;
+    if (i != len || num_digits == 0 || num_digits > 19 || frac_digits > 22
+            || mantissa > (1ULL << 53)) {
+        return false;
+    }
+    double d = static_cast<double>(mantissa) / pow10[frac_digits];
+    *val = negative ? -d : d;
+    return true;
+}
+
 template <typename T>
 inline T StringParser::string_to_float_internal(const char* s, int len, ParseResult* result) {
     if (UNLIKELY(len <= 0)) {
@@ -364,6 +441,11 @@ inline T StringParser::string_to_float_internal(const char* s, int len, ParseRes
 
     // Use double here to not lose precision while accumulating the result
     double val = 0;
+    if (LIKELY(string_to_double_fast(s, len, &val))) {
+        *result = PARSE_SUCCESS;
+        return static_cast<T>(val);
+    }
+
     bool negative = false;
     int i = 0;
     double divide = 1;
@@ -290,5 +290,47 @@ std::string SymbolsUtil::mangle_prepare_or_close_function(const std::string& fn_
 
     return ss.str();
 }
+
+std::string SymbolsUtil::mangle_batch_function(const std::string& fn_name) {
+    std::vector<std::string> name_tokens;
+    split_regex(name_tokens, fn_name, regex("::"));
+
+    // See mangle_prepare_or_close_function()
+    int seq_id = 0;
+
+    std::stringstream ss;
+    ss << MANGLE_PREFIX;
+    if (name_tokens.size() > 1) {
+        ss << "N";  // Start namespace
+        seq_id += name_tokens.size() - 1; // Append for all the name space tokens.
+    }
+    for (int i = 0; i < name_tokens.size(); ++i) {
+        append_mangled_token(name_tokens[i], &ss);
+    }
+    if (name_tokens.size() > 1) {
+        ss << "E"; // End fn namespace
+    }
+
+    ss << "PN"; // FunctionContext* argument and start of FunctionContext namespace
+    append_mangled_token("doris_udf", &ss);
+    int doris_udf_seq_id = seq_id++;
+    append_mangled_token("FunctionContext", &ss);
+    ++seq_id;
+    ss << "E"; // E indicates end of namespace
+    ++seq_id; // For FunctionContext*
+
+    ss << "i"; // num_rows argument
+
+    ss << "PPKN"; // const doris_udf::AnyVal** argument
+    append_seq_id(doris_udf_seq_id, &ss);
+    append_mangled_token("AnyVal", &ss);
+    ss << "E";
+    int any_val_seq_id = seq_id;
+
+    ss << "P"; // doris_udf::AnyVal* argument
+    append_seq_id(any_val_seq_id, &ss);
+
+    return ss.str();
 }
 
+}
@@ -65,6 +65,11 @@ public:
     /// Mangles fn_name assuming arguments
     /// (doris_udf::FunctionContext*, doris_udf::FunctionContext::FunctionStateScope).
     static std::string mangle_prepare_or_close_function(const std::string& fn_name);
+
+    /// Mangles fn_name assuming arguments (doris_udf::FunctionContext*, int,
+    /// const doris_udf::AnyVal**, doris_udf::AnyVal*), the signature of batch UDFs
+    /// and of batch update functions of UDAs.
+    static std::string mangle_batch_function(const std::string& fn_name);
 };
 
 }
@@ -136,8 +136,9 @@ public:
                 : _compression(compression),
                   _max_processed(processedSize(mergedSize, compression)),
                   _max_unprocessed(unprocessedSize(unmergedSize, compression)) {
-        _processed.reserve(_max_processed);
-        _unprocessed.reserve(_max_unprocessed + 1);
+        // The buffers are not reserved up front: with the default compression that would
+        // be 160KB, which is far too much for each group of a GROUP BY. They grow to at
+        // most _max_processed and _max_unprocessed + 1 centroids.
     }
 
     TDigest(std::vector<Centroid>&& processed, std::vector<Centroid>&& unprocessed, Value compression,
@@ -390,7 +391,9 @@ public:
 
     void add(Value x) { add(x, 1); }
 
-    inline void compress() { process(); }
+    inline void compress() {
+        if (haveUnprocessed() || isDirty()) process();
+    }
 
     // add a single centroid to the unprocessed vector, processing previously unprocessed sorted if our limit has
     // been reached.
@@ -409,18 +412,23 @@ public:
             const size_t diff = std::distance(iter, end);
             const size_t room = _max_unprocessed - _unprocessed.size();
             auto mid = iter + std::min(diff, room);
-            while (iter != mid) _unprocessed.push_back(*(iter++));
+            while (iter != mid) {
+                _unprocessed_weight += iter->weight();
+                _unprocessed.push_back(*(iter++));
+            }
             if (_unprocessed.size() >= _max_unprocessed) {
                 process();
             }
         }
     }
         
+    // The cumulative weights are not serialized but recomputed by unserialize(), only
+    // their (zero) count is kept to stay readable by older versions. Call compress()
+    // first to serialize as few centroids as possible.
     uint32_t serialized_size() {
-        return sizeof(Value) * 5 + sizeof(Index) * 2 + sizeof(size_t) * 3
+        return sizeof(Value) * 5 + sizeof(Index) * 2 + sizeof(uint32_t) * 3
                + _processed.size() * sizeof(Centroid)
-               + _unprocessed.size() * sizeof(Centroid)
-               + _cumulative.size() * sizeof(Weight);
+               + _unprocessed.size() * sizeof(Centroid);
     }
 
     void serialize(uint8_t* writer) {
@@ -455,13 +463,8 @@ public:
             writer += sizeof(Centroid);
         }
 
-        size = _cumulative.size();
+        size = 0;
         memcpy(writer, &size, sizeof(uint32_t));
-        writer += sizeof(uint32_t);
-        for (int i = 0; i < size; i++) {
-            memcpy(writer, &_cumulative[i], sizeof(Weight));
-            writer += sizeof(Weight);
-        }
     }
 
     void unserialize(const uint8_t* type_reader) {
@@ -496,13 +499,8 @@ public:
             memcpy(&_unprocessed[i], type_reader, sizeof(Centroid));
             type_reader += sizeof(Centroid);
         }
-        memcpy(&size, type_reader, sizeof(uint32_t));
-        type_reader += sizeof(uint32_t);
-        _cumulative.resize(size);
-        for (int i = 0; i < size; i++) {
-            memcpy(&_cumulative[i], type_reader, sizeof(Weight));
-            type_reader += sizeof(Weight);
-        }
+        // cumulative weights written by older versions are recomputed as well
+        updateCumulative();
     }
 
 private:
@@ -510,7 +508,7 @@ private:
 
     Value _min = std::numeric_limits<Value>::max();
 
-    Value _max = std::numeric_limits<Value>::min();
+    Value _max = std::numeric_limits<Value>::lowest();
 
     Index _max_processed;
 
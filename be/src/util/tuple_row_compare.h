@@ -134,8 +134,10 @@ public:
     // All exprs (_key_exprs_lhs and _key_exprs_rhs) must have been prepared and opened
     // before calling this.
     bool operator() (TupleRow* lhs, TupleRow* rhs) const {
-        int result = _codegend_compare_fn == NULL ? compare(lhs, rhs)
-            : _codegend_compare_fn(&_key_expr_ctxs_lhs[0], &_key_expr_ctxs_rhs[0], lhs, rhs);
+        // set by the codegen thread once the module is compiled
+        CompareFn compare_fn = __atomic_load_n(&_codegend_compare_fn, __ATOMIC_ACQUIRE);
+        int result = compare_fn == NULL ? compare(lhs, rhs)
+            : compare_fn(&_key_expr_ctxs_lhs[0], &_key_expr_ctxs_rhs[0], lhs, rhs);
         if (result < 0) {
             return true;
         }
@@ -150,6 +152,13 @@ public:
 
     bool codegen(RuntimeState* state);
 
+    const std::vector<ExprContext*>& key_expr_ctxs_lhs() const { return _key_expr_ctxs_lhs; }
+    const std::vector<ExprContext*>& key_expr_ctxs_rhs() const { return _key_expr_ctxs_rhs; }
+    const std::vector<bool>& is_asc() const { return _is_asc; }
+
+    // -1 if NULLs of the i-th key sort before all other values, 1 otherwise.
+    const std::vector<int8_t>& nulls_first() const { return _nulls_first; }
+
 private:
     const std::vector<ExprContext*>& _key_expr_ctxs_lhs;
     const std::vector<ExprContext*>& _key_expr_ctxs_rhs;
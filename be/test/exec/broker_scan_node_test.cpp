@@ -23,6 +23,7 @@
 
 #include <gtest/gtest.h>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "runtime/tuple.h"
 #include "exec/local_file_reader.h"
@@ -402,20 +403,21 @@ TEST_F(BrokerScanNodeTest, normal) {
     // Get batch
     RowBatch batch(scan_node.row_desc(), _runtime_state.batch_size(), &tracker);
 
+    // ranges are scanned by several scanners, so batches come in any order
     bool eos = false;
-    status = scan_node.get_next(&_runtime_state, &batch, &eos);
-    ASSERT_EQ(3, batch.num_rows());
-    ASSERT_FALSE(eos);
-
-    batch.reset();
-    status = scan_node.get_next(&_runtime_state, &batch, &eos);
-    ASSERT_EQ(1, batch.num_rows());
-    ASSERT_FALSE(eos);
-
-    batch.reset();
-    status = scan_node.get_next(&_runtime_state, &batch, &eos);
-    ASSERT_EQ(0, batch.num_rows());
-    ASSERT_TRUE(eos);
+    int num_batches = 0;
+    int num_rows = 0;
+    while (!eos) {
+        batch.reset();
+        status = scan_node.get_next(&_runtime_state, &batch, &eos);
+        ASSERT_TRUE(status.ok());
+        if (batch.num_rows() > 0) {
+            num_batches++;
+            num_rows += batch.num_rows();
+        }
+    }
+    ASSERT_EQ(2, num_batches);
+    ASSERT_EQ(4, num_rows);
 
     scan_node.close(&_runtime_state);
     {
@@ -425,6 +427,57 @@ TEST_F(BrokerScanNodeTest, normal) {
     }
 }
 
+TEST_F(BrokerScanNodeTest, split_range) {
+    int64_t split_bytes = config::broker_scanner_split_bytes;
+    config::broker_scanner_split_bytes = 5;
+
+    BrokerScanNode scan_node(&_obj_pool, _tnode, *_desc_tbl);
+    auto status = scan_node.prepare(&_runtime_state);
+    ASSERT_TRUE(status.ok());
+
+    std::vector<TScanRangeParams> scan_ranges;
+    {
+        TScanRangeParams scan_range_params;
+
+        TBrokerScanRange broker_scan_range;
+        broker_scan_range.params = _params;
+
+        TBrokerRangeDesc range;
+        range.path = "./be/test/exec/test_data/broker_scanner/normal.csv";
+        range.start_offset = 0;
+        range.size = 29;
+        range.file_type = TFileType::FILE_LOCAL;
+        range.format_type = TFileFormatType::FORMAT_CSV_PLAIN;
+        range.splittable = true;
+        broker_scan_range.ranges.push_back(range);
+
+        scan_range_params.scan_range.__set_broker_scan_range(broker_scan_range);
+
+        scan_ranges.push_back(scan_range_params);
+    }
+    scan_node.set_scan_ranges(scan_ranges);
+
+    status = scan_node.open(&_runtime_state);
+    ASSERT_TRUE(status.ok());
+
+    MemTracker tracker;
+    RowBatch batch(scan_node.row_desc(), _runtime_state.batch_size(), &tracker);
+
+    // every line is read by exactly one piece of the file
+    bool eos = false;
+    int num_rows = 0;
+    while (!eos) {
+        batch.reset();
+        status = scan_node.get_next(&_runtime_state, &batch, &eos);
+        ASSERT_TRUE(status.ok());
+        num_rows += batch.num_rows();
+    }
+    ASSERT_EQ(3, num_rows);
+
+    scan_node.close(&_runtime_state);
+    config::broker_scanner_split_bytes = split_bytes;
+}
+
 }
 
 int main(int argc, char** argv) {
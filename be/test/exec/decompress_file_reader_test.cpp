@@ -0,0 +1,162 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/decompress_file_reader.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "exec/local_file_reader.h"
+#include "exec/decompressor.h"
+#include "exec/plain_text_line_reader.h"
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+class DecompressFileReaderTest : public testing::Test {
+public:
+    DecompressFileReaderTest() : _profile(&_obj_pool, "TestProfile") {
+    }
+
+protected:
+    virtual void SetUp() {
+    }
+    virtual void TearDown() {
+    }
+
+    // read all content of 'path' decompressed by 'type', 'buf_len' bytes a time
+    std::string read_all(const std::string& path, CompressType type,
+                         int max_chunks, size_t buf_len) {
+        LocalFileReader file_reader(path, 0);
+        EXPECT_TRUE(file_reader.open().ok());
+
+        Decompressor* decompressor = nullptr;
+        EXPECT_TRUE(Decompressor::create_decompressor(type, &decompressor).ok());
+        std::unique_ptr<Decompressor> decompressor_holder(decompressor);
+
+        DecompressFileReader reader(&_profile, &file_reader, decompressor, max_chunks);
+        EXPECT_TRUE(reader.open().ok());
+
+        std::string content;
+        std::unique_ptr<uint8_t[]> buf(new uint8_t[buf_len]);
+        while (true) {
+            size_t read_len = buf_len;
+            bool eof = false;
+            EXPECT_TRUE(reader.read(buf.get(), &read_len, &eof).ok());
+            if (eof) {
+                EXPECT_EQ(0, read_len);
+                break;
+            }
+            content.append((const char*)buf.get(), read_len);
+        }
+        reader.close();
+        return content;
+    }
+
+private:
+    ObjectPool _obj_pool;
+    RuntimeProfile _profile;
+};
+
+TEST_F(DecompressFileReaderTest, gzip_read) {
+    std::string content = read_all(
+            "./be/test/exec/test_data/plain_text_line_reader/limit.csv.gz",
+            CompressType::GZIP, 2, 1024);
+    ASSERT_STREQ("1,2,3\n\n2,3,4\n3,4\n4,5\n", content.c_str());
+
+    // small buffer, only one chunk ahead
+    content = read_all(
+            "./be/test/exec/test_data/plain_text_line_reader/limit.csv.gz",
+            CompressType::GZIP, 1, 3);
+    ASSERT_STREQ("1,2,3\n\n2,3,4\n3,4\n4,5\n", content.c_str());
+}
+
+TEST_F(DecompressFileReaderTest, bzip_read) {
+    std::string content = read_all(
+            "./be/test/exec/test_data/plain_text_line_reader/limit.csv.bz2",
+            CompressType::BZIP2, 2, 4);
+    ASSERT_STREQ("1,2,3\n\n2,3,4\n3,4\n4,5\n", content.c_str());
+}
+
+TEST_F(DecompressFileReaderTest, lz4frame_read) {
+    std::string content = read_all(
+            "./be/test/exec/test_data/plain_text_line_reader/limit.csv.lz4",
+            CompressType::LZ4FRAME, 2, 5);
+    ASSERT_STREQ("1,2,3\n\n2,3,4\n3,4\n4,5\n", content.c_str());
+}
+
+TEST_F(DecompressFileReaderTest, line_reader) {
+    LocalFileReader file_reader(
+            "./be/test/exec/test_data/plain_text_line_reader/test_file.csv.gz", 0);
+    auto st = file_reader.open();
+    ASSERT_TRUE(st.ok());
+
+    Decompressor* decompressor;
+    st = Decompressor::create_decompressor(CompressType::GZIP, &decompressor);
+    ASSERT_TRUE(st.ok());
+    std::unique_ptr<Decompressor> decompressor_holder(decompressor);
+
+    DecompressFileReader reader(&_profile, &file_reader, decompressor, 2);
+    st = reader.open();
+    ASSERT_TRUE(st.ok());
+
+    PlainTextLineReader line_reader(&_profile, &reader, nullptr, -1, '\n');
+    const uint8_t* ptr;
+    size_t size;
+    bool eof;
+
+    // 1,2
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_STREQ("1,2", std::string((const char*)ptr, size).c_str());
+    ASSERT_FALSE(eof);
+
+    // Empty
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(0, size);
+    ASSERT_FALSE(eof);
+
+    // 1,2,3,4
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_STREQ("1,2,3,4", std::string((const char*)ptr, size).c_str());
+    ASSERT_FALSE(eof);
+
+    // Empty
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(eof);
+
+    // Empty
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(eof);
+
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_TRUE(eof);
+}
+
+} // end namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -75,7 +75,7 @@ TEST_F(BooleanQueryBuilderTest, range_query) {
     range_value.Accept(writer);
     std::string actual_json = buffer.GetString();
     //LOG(INFO) << "range query" << actual_json;
-    ASSERT_STREQ("{\"range\":{\"k\":{\"ge\":\"a\"}}}", actual_json.c_str());
+    ASSERT_STREQ("{\"range\":{\"k\":{\"gte\":\"a\"}}}", actual_json.c_str());
 }
 
 TEST_F(BooleanQueryBuilderTest, es_query) {
@@ -229,7 +229,7 @@ TEST_F(BooleanQueryBuilderTest, bool_query) {
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     bool_query_value.Accept(writer);
     std::string actual_json = buffer.GetString();
-    std::string expected_json = "{\"bool\":{\"should\":[{\"wildcard\":{\"content\":\"a*e*g?\"}},{\"bool\":{\"must_not\":{\"exists\":{\"field\":\"f1\"}}}},{\"range\":{\"k\":{\"ge\":\"a\"}}},{\"term\":{\"content\":\"wyf\"}}]}}";
+    std::string expected_json = "{\"bool\":{\"should\":[{\"wildcard\":{\"content\":\"a*e*g?\"}},{\"bool\":{\"must_not\":{\"exists\":{\"field\":\"f1\"}}}},{\"range\":{\"k\":{\"gte\":\"a\"}}},{\"term\":{\"content\":\"wyf\"}}]}}";
     //LOG(INFO) << "bool query" << actual_json;
     ASSERT_STREQ(expected_json.c_str(), actual_json.c_str());
 }
@@ -313,10 +313,68 @@ TEST_F(BooleanQueryBuilderTest, compound_bool_query) {
     rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
     compound_bool_value.Accept(writer);
     std::string actual_bool_json = buffer.GetString();
-    std::string expected_json = "{\"bool\":{\"filter\":[{\"bool\":{\"should\":[{\"wildcard\":{\"content\":\"a*e*g?\"}},{\"bool\":{\"must_not\":{\"exists\":{\"field\":\"f1\"}}}}]}},{\"bool\":{\"should\":[{\"range\":{\"k\":{\"ge\":\"a\"}}}]}},{\"bool\":{\"should\":[{\"bool\":{\"must_not\":[{\"term\":{\"content\":\"wyf\"}}]}}]}},{\"bool\":{\"should\":[{\"bool\":{\"must_not\":[{\"terms\":{\"fv\":[\"8.0\",\"16.0\"]}}]}}]}}]}}";
+    std::string expected_json = "{\"bool\":{\"filter\":[{\"bool\":{\"should\":[{\"wildcard\":{\"content\":\"a*e*g?\"}},{\"bool\":{\"must_not\":{\"exists\":{\"field\":\"f1\"}}}}]}},{\"bool\":{\"should\":[{\"range\":{\"k\":{\"gte\":\"a\"}}}]}},{\"bool\":{\"should\":[{\"bool\":{\"must_not\":[{\"term\":{\"content\":\"wyf\"}}]}}]}},{\"bool\":{\"should\":[{\"bool\":{\"must_not\":[{\"terms\":{\"fv\":[\"8.0\",\"16.0\"]}}]}}]}}]}}";
     //LOG(INFO) << "compound bool query" << actual_bool_json;
     ASSERT_STREQ(expected_json.c_str(), actual_bool_json.c_str());
 }
+TEST_F(BooleanQueryBuilderTest, nested_bool_query) {
+    // content is null
+    std::string null_field_name = "content";
+    TypeDescriptor null_type_desc = TypeDescriptor::create_varchar_type(3);
+    ExtIsNullPredicate* is_null_predicate = new ExtIsNullPredicate(TExprNodeType::IS_NULL_PRED, null_field_name, null_type_desc, false);
+    std::vector<ExtPredicate*> bool_predicates_1 = {is_null_predicate};
+    EsPredicate* bool_predicate_1 = new EsPredicate(bool_predicates_1);
+
+    // k > "a" and k <= "c"
+    char lower_value_str[] = "a";
+    StringValue lower_value(lower_value_str, 1);
+    ExtLiteral lower_literal(TYPE_VARCHAR, &lower_value);
+    char upper_value_str[] = "c";
+    StringValue upper_value(upper_value_str, 1);
+    ExtLiteral upper_literal(TYPE_VARCHAR, &upper_value);
+    TypeDescriptor range_type_desc = TypeDescriptor::create_varchar_type(1);
+    std::string range_field_name = "k";
+    ExtBinaryPredicate* lower_predicate = new ExtBinaryPredicate(TExprNodeType::BINARY_PRED, range_field_name, range_type_desc, TExprOpcode::GT, lower_literal);
+    ExtBinaryPredicate* upper_predicate = new ExtBinaryPredicate(TExprNodeType::BINARY_PRED, range_field_name, range_type_desc, TExprOpcode::LE, upper_literal);
+    std::vector<ExtPredicate*> bool_predicates_2 = {lower_predicate};
+    EsPredicate* bool_predicate_2 = new EsPredicate(bool_predicates_2);
+    std::vector<ExtPredicate*> bool_predicates_3 = {upper_predicate};
+    EsPredicate* bool_predicate_3 = new EsPredicate(bool_predicates_3);
+
+    // (content = "wyf" and f1 is not null) or k = "c"
+    char term_str[] = "wyf";
+    StringValue term_value(term_str, 3);
+    ExtLiteral term_literal(TYPE_VARCHAR, &term_value);
+    TypeDescriptor term_type_desc = TypeDescriptor::create_varchar_type(3);
+    std::string term_field_name = "content";
+    ExtBinaryPredicate* term_predicate = new ExtBinaryPredicate(TExprNodeType::BINARY_PRED, term_field_name, term_type_desc, TExprOpcode::EQ, term_literal);
+    std::string not_null_field_name = "f1";
+    ExtIsNullPredicate* not_null_predicate = new ExtIsNullPredicate(TExprNodeType::IS_NULL_PRED, not_null_field_name, term_type_desc, true);
+    std::vector<ExtPredicate*> and_children = {term_predicate, not_null_predicate};
+    ExtCompoundPredicate* and_predicate = new ExtCompoundPredicate(TExprNodeType::COMPOUND_PRED, TExprOpcode::COMPOUND_AND, and_children);
+    ExtBinaryPredicate* k_predicate = new ExtBinaryPredicate(TExprNodeType::BINARY_PRED, range_field_name, range_type_desc, TExprOpcode::EQ, upper_literal);
+    std::vector<ExtPredicate*> bool_predicates_4 = {and_predicate, k_predicate};
+    EsPredicate* bool_predicate_4 = new EsPredicate(bool_predicates_4);
+
+    std::vector<EsPredicate*> and_bool_predicates = {bool_predicate_1, bool_predicate_2, bool_predicate_3, bool_predicate_4};
+    std::vector<bool> result;
+    BooleanQueryBuilder::validate(and_bool_predicates, &result);
+    std::vector<bool> expected = {true, true, true, true};
+    ASSERT_TRUE(result == expected);
+
+    rapidjson::Document document;
+    rapidjson::Value compound_bool_value(rapidjson::kObjectType);
+    compound_bool_value.SetObject();
+    BooleanQueryBuilder::to_query(and_bool_predicates, &document, &compound_bool_value);
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    compound_bool_value.Accept(writer);
+    std::string actual_bool_json = buffer.GetString();
+    std::string expected_json = "{\"bool\":{\"filter\":[{\"bool\":{\"should\":[{\"bool\":{\"must_not\":[{\"exists\":{\"field\":\"content\"}}]}}]}},{\"bool\":{\"should\":[{\"range\":{\"k\":{\"gt\":\"a\",\"lte\":\"c\"}}}]}},{\"bool\":{\"should\":[{\"bool\":{\"filter\":[{\"term\":{\"content\":\"wyf\"}},{\"exists\":{\"field\":\"f1\"}}]}},{\"term\":{\"k\":\"c\"}}]}}]}}";
+    //LOG(INFO) << "nested bool query" << actual_bool_json;
+    ASSERT_STREQ(expected_json.c_str(), actual_bool_json.c_str());
+}
+
 TEST_F(BooleanQueryBuilderTest, validate_esquery) {
     std::string function_name = "esquery";
     char field[] = "random";
@@ -237,6 +237,37 @@ TEST_F(MockESServerTest, workflow) {
     auto cst = reader.close();
     ASSERT_TRUE(cst.ok());
 }
+
+TEST_F(MockESServerTest, sliced_doc_value_query) {
+    std::vector<std::string> fields = {"id", "value"};
+    std::map<std::string, std::string> props;
+    props[ESScanReader::KEY_BATCH_SIZE] = "100";
+    props[ESScanReader::KEY_SLICE_ID] = "1";
+    props[ESScanReader::KEY_SLICE_MAX] = "4";
+    props[ESScanReader::KEY_DOC_VALUE_MODE] = "true";
+    std::vector<EsPredicate*> predicates;
+    std::string query = ESScrollQueryBuilder::build(props, fields, predicates);
+
+    rapidjson::Document query_doc;
+    query_doc.Parse<0>(query.c_str());
+    ASSERT_FALSE(query_doc.HasParseError());
+    ASSERT_EQ(1, query_doc["slice"]["id"].GetInt());
+    ASSERT_EQ(4, query_doc["slice"]["max"].GetInt());
+    ASSERT_EQ(2, query_doc["docvalue_fields"].Size());
+    ASSERT_STREQ("value", query_doc["docvalue_fields"][1].GetString());
+    ASSERT_FALSE(query_doc["_source"].GetBool());
+
+    // no slice for only one slice
+    props[ESScanReader::KEY_SLICE_ID] = "0";
+    props[ESScanReader::KEY_SLICE_MAX] = "1";
+    props.erase(ESScanReader::KEY_DOC_VALUE_MODE);
+    query = ESScrollQueryBuilder::build(props, fields, predicates);
+    query_doc.Parse<0>(query.c_str());
+    ASSERT_FALSE(query_doc.HasParseError());
+    ASSERT_FALSE(query_doc.HasMember("slice"));
+    ASSERT_FALSE(query_doc.HasMember("docvalue_fields"));
+    ASSERT_EQ(2, query_doc["_source"].Size());
+}
 }
 
 int main(int argc, char* argv[]) {
@@ -19,16 +19,25 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "common/compiler_util.h"
+#include "common/config.h"
 #include "exec/hash_table.hpp"
+#include "exec/shared_hash_table_ctx.h"
 #include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
 #include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
 #include "runtime/string_value.h"
-#include "runtime/mem_limit.hpp"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
 #include "util/cpu_info.h"
 #include "util/runtime_profile.h"
 
@@ -40,13 +49,14 @@ using std::map;
 
 class HashTableTest : public testing::Test {
 public:
-    HashTableTest() : _mem_pool() {}
+    HashTableTest() : _mem_pool(&_tracker) {}
 
 protected:
     ObjectPool _pool;
+    MemTracker _tracker;
     MemPool _mem_pool;
-    vector<Expr*> _build_expr;
-    vector<Expr*> _probe_expr;
+    vector<ExprContext*> _build_expr_ctxs;
+    vector<ExprContext*> _probe_expr_ctxs;
 
     virtual void SetUp() {
         RowDescriptor desc;
@@ -55,21 +65,42 @@ protected:
         // Not very easy to test complex tuple layouts so this test will use the
         // simplest.  The purpose of these tests is to exercise the hash map
         // internals so a simple build/probe expr is fine.
-        _build_expr.push_back(_pool.add(new SlotRef(TYPE_INT, 0)));
-        status = Expr::prepare(_build_expr, NULL, desc);
+        Expr* expr = _pool.add(new SlotRef(TYPE_INT, 0));
+        _build_expr_ctxs.push_back(_pool.add(new ExprContext(expr)));
+        status = Expr::prepare(_build_expr_ctxs, NULL, desc, &_tracker);
+        EXPECT_TRUE(status.ok());
+        status = Expr::open(_build_expr_ctxs, NULL);
         EXPECT_TRUE(status.ok());
 
-        _probe_expr.push_back(_pool.add(new SlotRef(TYPE_INT, 0)));
-        status = Expr::prepare(_probe_expr, NULL, desc);
+        expr = _pool.add(new SlotRef(TYPE_INT, 0));
+        _probe_expr_ctxs.push_back(_pool.add(new ExprContext(expr)));
+        status = Expr::prepare(_probe_expr_ctxs, NULL, desc, &_tracker);
+        EXPECT_TRUE(status.ok());
+        status = Expr::open(_probe_expr_ctxs, NULL);
         EXPECT_TRUE(status.ok());
     }
 
+    virtual void TearDown() {
+        Expr::close(_build_expr_ctxs, NULL);
+        Expr::close(_probe_expr_ctxs, NULL);
+        _mem_pool.free_all();
+    }
+
+    // Creates and opens a context of a SlotRef over the INT at offset 0 of tuple 0
+    void create_slot_ref_ctx(vector<ExprContext*>* ctxs) {
+        RowDescriptor desc;
+        ctxs->push_back(_pool.add(new ExprContext(_pool.add(new SlotRef(TYPE_INT, 0)))));
+        EXPECT_TRUE(Expr::prepare(*ctxs, NULL, desc, &_tracker).ok());
+        EXPECT_TRUE(Expr::open(*ctxs, NULL).ok());
+    }
+
     TupleRow* create_tuple_row(int32_t val);
 
     // Wrapper to call private methods on HashTable
     // TODO: understand google testing, there must be a more natural way to do this
     void resize_table(HashTable* table, int64_t new_size) {
-        table->resize_buckets(new_size);
+        DCHECK(!table->is_two_level());
+        table->resize_buckets(&table->_sub_tables[0], new_size);
     }
 
     // Do a full table scan on table.  All values should be between [min,max).  If
@@ -82,7 +113,7 @@ protected:
 
         while (iter != table->end()) {
             TupleRow* row = iter.get_row();
-            int32_t val = *reinterpret_cast<int32_t*>(_build_expr[0]->get_value(row));
+            int32_t val = *reinterpret_cast<int32_t*>(_build_expr_ctxs[0]->get_value(row));
             EXPECT_GE(val, min);
             EXPECT_LT(val, max);
 
@@ -100,8 +131,10 @@ protected:
     // evaluated over build_exprs
     void validate_match(TupleRow* probe_row, TupleRow* build_row) {
         EXPECT_TRUE(probe_row != build_row);
-        int32_t build_val = *reinterpret_cast<int32_t*>(_build_expr[0]->get_value(probe_row));
-        int32_t probe_val = *reinterpret_cast<int32_t*>(_probe_expr[0]->get_value(build_row));
+        int32_t build_val =
+            *reinterpret_cast<int32_t*>(_build_expr_ctxs[0]->get_value(probe_row));
+        int32_t probe_val =
+            *reinterpret_cast<int32_t*>(_probe_expr_ctxs[0]->get_value(build_row));
         EXPECT_EQ(build_val, probe_val);
     }
 
@@ -131,7 +164,7 @@ protected:
 
                     EXPECT_EQ(matched.size(), data[i].expected_build_rows.size());
 
-                    for (int j = 0; i < data[j].expected_build_rows.size(); ++j) {
+                    for (int j = 0; j < data[i].expected_build_rows.size(); ++j) {
                         EXPECT_TRUE(matched[data[i].expected_build_rows[j]]);
                     }
                 } else {
@@ -143,14 +176,29 @@ protected:
             }
         }
     }
+
+    // Returns the number of rows found for 'val'
+    int num_matches(HashTable* table, int32_t val) {
+        TupleRow* probe_row = create_tuple_row(val);
+        HashTable::Iterator iter = table->find(probe_row);
+        int num = 0;
+
+        while (iter != table->end()) {
+            validate_match(probe_row, iter.get_row());
+            ++num;
+            iter.next<true>();
+        }
+
+        return num;
+    }
 };
 
 TupleRow* HashTableTest::create_tuple_row(int32_t val) {
     uint8_t* tuple_row_mem = _mem_pool.allocate(sizeof(int32_t*));
-    uint8_t* tuple_mem = _mem_pool.allocate(sizeof(int32_t));
+    Tuple* tuple_mem = Tuple::create(sizeof(int32_t), &_mem_pool);
     *reinterpret_cast<int32_t*>(tuple_mem) = val;
     TupleRow* row = reinterpret_cast<TupleRow*>(tuple_row_mem);
-    row->set_tuple(0, reinterpret_cast<Tuple*>(tuple_mem));
+    row->set_tuple(0, tuple_mem);
     return row;
 }
 
@@ -160,10 +208,14 @@ TEST_F(HashTableTest, SetupTest) {
     TupleRow* probe_row3 = create_tuple_row(3);
     TupleRow* probe_row4 = create_tuple_row(4);
 
-    int32_t* val_row1 = reinterpret_cast<int32_t*>(_build_expr[0]->get_value(build_row1));
-    int32_t* val_row2 = reinterpret_cast<int32_t*>(_build_expr[0]->get_value(build_row2));
-    int32_t* val_row3 = reinterpret_cast<int32_t*>(_probe_expr[0]->get_value(probe_row3));
-    int32_t* val_row4 = reinterpret_cast<int32_t*>(_probe_expr[0]->get_value(probe_row4));
+    int32_t* val_row1 =
+        reinterpret_cast<int32_t*>(_build_expr_ctxs[0]->get_value(build_row1));
+    int32_t* val_row2 =
+        reinterpret_cast<int32_t*>(_build_expr_ctxs[0]->get_value(build_row2));
+    int32_t* val_row3 =
+        reinterpret_cast<int32_t*>(_probe_expr_ctxs[0]->get_value(probe_row3));
+    int32_t* val_row4 =
+        reinterpret_cast<int32_t*>(_probe_expr_ctxs[0]->get_value(probe_row4));
 
     EXPECT_EQ(*val_row1, 1);
     EXPECT_EQ(*val_row2, 2);
@@ -194,7 +246,8 @@ TEST_F(HashTableTest, BasicTest) {
     }
 
     // Create the hash table and insert the build rows
-    HashTable hash_table(_build_expr, _probe_expr, 1, false, 0);
+    MemTracker mem_tracker(-1);
+    HashTable hash_table(_build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_tracker, 16);
 
     for (int i = 0; i < 5; ++i) {
         hash_table.insert(build_rows[i]);
@@ -214,26 +267,22 @@ TEST_F(HashTableTest, BasicTest) {
     full_scan(&hash_table, 0, 5, true, scan_rows, build_rows);
     probe_test(&hash_table, probe_rows, 10, false);
 
-    // Resize to two and cause some collisions
-    resize_table(&hash_table, 2);
-    EXPECT_EQ(hash_table.num_buckets(), 2);
+    // Resize back to a single group of buckets
+    resize_table(&hash_table, 16);
+    EXPECT_EQ(hash_table.num_buckets(), 16);
     EXPECT_EQ(hash_table.size(), 5);
     memset(scan_rows, 0, sizeof(scan_rows));
     full_scan(&hash_table, 0, 5, true, scan_rows, build_rows);
     probe_test(&hash_table, probe_rows, 10, false);
 
-    // Resize to one and turn it into a linked list
-    resize_table(&hash_table, 1);
-    EXPECT_EQ(hash_table.num_buckets(), 1);
-    EXPECT_EQ(hash_table.size(), 5);
-    memset(scan_rows, 0, sizeof(scan_rows));
-    full_scan(&hash_table, 0, 5, true, scan_rows, build_rows);
-    probe_test(&hash_table, probe_rows, 10, false);
+    hash_table.close();
+    EXPECT_EQ(mem_tracker.consumption(), 0);
 }
 
 // This tests makes sure we can scan ranges of buckets
 TEST_F(HashTableTest, ScanTest) {
-    HashTable hash_table(_build_expr, _probe_expr, 1, false, 0);
+    MemTracker mem_tracker(-1);
+    HashTable hash_table(_build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_tracker, 16);
     // Add 1 row with val 1, 2 with val 2, etc
     vector<TupleRow*> build_rows;
     ProbeTestData probe_rows[15];
@@ -267,25 +316,268 @@ TEST_F(HashTableTest, ScanTest) {
     EXPECT_EQ(hash_table.num_buckets(), 16);
     probe_test(&hash_table, probe_rows, 15, true);
 
-    resize_table(&hash_table, 2);
-    EXPECT_EQ(hash_table.num_buckets(), 2);
-    probe_test(&hash_table, probe_rows, 15, true);
+    hash_table.close();
 }
 
-// This test continues adding to the hash table to trigger the resize code paths
+// Keys beyond config::hash_table_two_level_threshold split the table into sub
+// tables, which keep growing on their own.
+TEST_F(HashTableTest, TwoLevelTest) {
+    int64_t old_threshold = config::hash_table_two_level_threshold;
+    config::hash_table_two_level_threshold = 1000;
+    int num_keys = 50000;
+    MemTracker mem_tracker(-1);
+    HashTable hash_table(_build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_tracker, 16);
+
+    for (int i = 0; i < num_keys; ++i) {
+        hash_table.insert(create_tuple_row(i));
+        if (i % 10 == 0) {
+            hash_table.insert(create_tuple_row(i));
+        }
+    }
+
+    EXPECT_TRUE(hash_table.is_two_level());
+    EXPECT_EQ(hash_table.size(), num_keys + num_keys / 10);
+
+    for (int i = 0; i < num_keys; ++i) {
+        EXPECT_EQ(num_matches(&hash_table, i), i % 10 == 0 ? 2 : 1);
+    }
+    EXPECT_EQ(num_matches(&hash_table, num_keys), 0);
+
+    int num_scanned = 0;
+    for (HashTable::Iterator iter = hash_table.begin(); iter != hash_table.end();
+            iter.next<false>()) {
+        ++num_scanned;
+    }
+    EXPECT_EQ(num_scanned, hash_table.size());
+
+    hash_table.close();
+    EXPECT_EQ(mem_tracker.consumption(), 0);
+    config::hash_table_two_level_threshold = old_threshold;
+}
+
+// Appends rows with duplicate keys and places them with several threads, which makes
+// the table two level. Every key has to find all of its rows.
+TEST_F(HashTableTest, ParallelBuildTest) {
+    int num_keys = 100000;
+    int num_dups = 3;
+    MemTracker mem_limit(-1);
+    HashTable hash_table(
+        _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_limit, 1024);
+    EXPECT_TRUE(hash_table.can_build_in_parallel());
+
+    for (int i = 0; i < num_dups; ++i) {
+        for (int j = 0; j < num_keys; ++j) {
+            hash_table.append(create_tuple_row(j));
+        }
+    }
+    hash_table.build_in_parallel(4);
+    EXPECT_EQ(hash_table.size(), num_keys * num_dups);
+
+    for (int i = 0; i < num_keys; ++i) {
+        EXPECT_EQ(num_matches(&hash_table, i), num_dups);
+    }
+
+    TupleRow* probe_row = create_tuple_row(num_keys);
+    EXPECT_TRUE(hash_table.find(probe_row) == hash_table.end());
+    hash_table.close();
+}
+
+// Tables built by append() and build_in_parallel() chain rows of equal keys in
+// the same order as insert() does, whether the table ends up two level or not.
+TEST_F(HashTableTest, ParallelBuildMatchesInsertTest) {
+    int64_t old_threshold = config::hash_table_two_level_threshold;
+    config::hash_table_two_level_threshold = 1000;
+
+    for (int num_keys : { 100, 20000 }) {
+        vector<TupleRow*> build_rows;
+        for (int i = 0; i < num_keys * 3; ++i) {
+            // keys in a scattered order, every key three times
+            build_rows.push_back(create_tuple_row((i * 7919) % num_keys));
+        }
+
+        MemTracker mem_tracker(-1);
+        HashTable inserted(_build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_tracker, 16);
+        HashTable parallel(_build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_tracker, 16);
+        for (TupleRow* row : build_rows) {
+            inserted.insert(row);
+            parallel.append(row);
+        }
+        parallel.build_in_parallel(8);
+
+        EXPECT_EQ(parallel.size(), inserted.size());
+        EXPECT_EQ(parallel.is_two_level(), num_keys >= 1000);
+
+        for (int i = 0; i <= num_keys; ++i) {
+            TupleRow* probe_row = create_tuple_row(i);
+            vector<Tuple*> inserted_rows;
+            for (HashTable::Iterator iter = inserted.find(probe_row); iter != inserted.end();
+                    iter.next<true>()) {
+                inserted_rows.push_back(iter.get_row()->get_tuple(0));
+            }
+            vector<Tuple*> parallel_rows;
+            for (HashTable::Iterator iter = parallel.find(probe_row); iter != parallel.end();
+                    iter.next<true>()) {
+                parallel_rows.push_back(iter.get_row()->get_tuple(0));
+            }
+            EXPECT_EQ(inserted_rows.size(), i < num_keys ? 3 : 0);
+            EXPECT_EQ(inserted_rows, parallel_rows);
+        }
+
+        inserted.close();
+        parallel.close();
+        EXPECT_EQ(mem_tracker.consumption(), 0);
+    }
+
+    config::hash_table_two_level_threshold = old_threshold;
+}
+
+// A table sharing the rows of another one finds them without copying any, and
+// closing it leaves the other table intact.
+TEST_F(HashTableTest, ShareFromTest) {
+    MemTracker mem_limit(-1);
+    HashTable build_table(
+        _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_limit, 1024);
+    for (int i = 0; i < 10000; ++i) {
+        build_table.insert(create_tuple_row(i));
+    }
+    int64_t build_bytes = mem_limit.consumption();
+
+    HashTable probe_table(
+        _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_limit, 1024);
+    probe_table.share_from(build_table);
+    EXPECT_EQ(mem_limit.consumption(), build_bytes);
+    EXPECT_EQ(probe_table.size(), build_table.size());
+
+    for (int i = 0; i < 10000; i += 7) {
+        TupleRow* probe_row = create_tuple_row(i);
+        HashTable::Iterator iter = probe_table.find(probe_row);
+        EXPECT_TRUE(iter != probe_table.end());
+        validate_match(probe_row, iter.get_row());
+    }
+    EXPECT_TRUE(probe_table.find(create_tuple_row(10000)) == probe_table.end());
+
+    probe_table.close();
+    TupleRow* probe_row = create_tuple_row(42);
+    EXPECT_TRUE(build_table.find(probe_row) != build_table.end());
+    build_table.close();
+}
+
+// Fragment instances probe tables sharing one two level build table concurrently,
+// each with exprs of its own.
+TEST_F(HashTableTest, ShareFromConcurrentFindTest) {
+    int64_t old_threshold = config::hash_table_two_level_threshold;
+    config::hash_table_two_level_threshold = 1000;
+    int num_keys = 20000;
+    int num_threads = 4;
+    MemTracker mem_tracker(-1);
+    HashTable build_table(
+        _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_tracker, 16);
+    for (int i = 0; i < num_keys; ++i) {
+        build_table.insert(create_tuple_row(i));
+        build_table.insert(create_tuple_row(i));
+    }
+    EXPECT_TRUE(build_table.is_two_level());
+
+    // rows are created up front, _mem_pool is not thread safe
+    vector<TupleRow*> probe_rows;
+    for (int i = 0; i < num_keys * 2; ++i) {
+        probe_rows.push_back(create_tuple_row(i));
+    }
+
+    vector<vector<ExprContext*>> build_ctxs(num_threads);
+    vector<vector<ExprContext*>> probe_ctxs(num_threads);
+    vector<int64_t> matches_per_thread(num_threads, 0);
+    vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        create_slot_ref_ctx(&build_ctxs[t]);
+        create_slot_ref_ctx(&probe_ctxs[t]);
+    }
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            HashTable probe_table(build_ctxs[t], probe_ctxs[t], 1, false, 0, &mem_tracker, 16);
+            probe_table.share_from(build_table);
+            for (TupleRow* probe_row : probe_rows) {
+                for (HashTable::Iterator iter = probe_table.find(probe_row);
+                        iter != probe_table.end(); iter.next<true>()) {
+                    ++matches_per_thread[t];
+                }
+            }
+            probe_table.close();
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < num_threads; ++t) {
+        EXPECT_EQ(matches_per_thread[t], num_keys * 2);
+        Expr::close(build_ctxs[t], NULL);
+        Expr::close(probe_ctxs[t], NULL);
+    }
+    build_table.close();
+    EXPECT_EQ(mem_tracker.consumption(), 0);
+    config::hash_table_two_level_threshold = old_threshold;
+}
+
+// The build rows and the table of a SharedHashTableCtx are tracked by its own
+// MemTracker and released once the last instance drops it. Only the first build
+// status counts, and waiters stop waiting on cancellation.
+TEST_F(HashTableTest, SharedHashTableCtxTest) {
+    MemTracker query_tracker(-1);
+    RuntimeState state((TQueryGlobals()));
+    state.set_is_cancelled(false);
+    {
+        std::shared_ptr<SharedHashTableCtx> ctx =
+            std::make_shared<SharedHashTableCtx>(-1, &query_tracker);
+        ctx->set_hash_tbl(new HashTable(
+            _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, ctx->mem_tracker(), 1024));
+
+        Status wait_status;
+        std::thread waiter([&]() { wait_status = ctx->wait_for_build(&state); });
+        for (int i = 0; i < 1000; ++i) {
+            uint8_t* row_mem = ctx->build_pool()->allocate(sizeof(Tuple*));
+            Tuple* tuple = Tuple::create(sizeof(int32_t), ctx->build_pool());
+            *reinterpret_cast<int32_t*>(tuple) = i;
+            TupleRow* row = reinterpret_cast<TupleRow*>(row_mem);
+            row->set_tuple(0, tuple);
+            ctx->hash_tbl()->insert(row);
+        }
+        ctx->set_build_status(Status::OK());
+        ctx->set_build_status(Status::InternalError("too late"));
+        waiter.join();
+        EXPECT_TRUE(wait_status.ok());
+        EXPECT_TRUE(ctx->wait_for_build(&state).ok());
+        EXPECT_GT(query_tracker.consumption(), 0);
+
+        MemTracker instance_tracker(-1);
+        HashTable probe_table(
+            _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &instance_tracker, 1024);
+        probe_table.share_from(*ctx->hash_tbl());
+        EXPECT_EQ(instance_tracker.consumption(), 0);
+        EXPECT_EQ(num_matches(&probe_table, 42), 1);
+        probe_table.close();
+    }
+    EXPECT_EQ(query_tracker.consumption(), 0);
+
+    SharedHashTableCtx never_built(-1, &query_tracker);
+    state.set_is_cancelled(true);
+    EXPECT_TRUE(never_built.wait_for_build(&state).is_cancelled());
+}
+
+// This test continues adding to the hash table to trigger the resize code paths.
+// Once the mem limit is exceeded buckets can't grow normally anymore, but no row
+// may be dropped: full sub tables grow past the limit instead.
 TEST_F(HashTableTest, GrowTableTest) {
     int build_row_val = 0;
     int num_to_add = 4;
     int expected_size = 0;
     MemTracker mem_limit(1024 * 1024);
-    vector<MemTracker*> mem_limits;
-    mem_limits.push_back(&mem_limit);
     HashTable hash_table(
-        _build_expr, _probe_expr, 1, false, 0, mem_limits, num_to_add);
+        _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_limit, num_to_add);
     EXPECT_TRUE(!mem_limit.limit_exceeded());
 
-    // This inserts about 5M entries
-    for (int i = 0; i < 20; ++i) {
+    // This inserts about 256K entries
+    for (int i = 0; i < 16; ++i) {
         for (int j = 0; j < num_to_add; ++build_row_val, ++j) {
             hash_table.insert(create_tuple_row(build_row_val));
         }
@@ -296,38 +588,52 @@ TEST_F(HashTableTest, GrowTableTest) {
     }
 
     EXPECT_TRUE(mem_limit.limit_exceeded());
+    EXPECT_TRUE(hash_table.exceeded_limit());
 
     // Validate that we can find the entries
-    for (int i = 0; i < expected_size * 5; i += 100000) {
-        TupleRow* probe_row = create_tuple_row(i);
-        HashTable::Iterator iter = hash_table.find(probe_row);
+    for (int i = 0; i < expected_size * 2; ++i) {
+        EXPECT_EQ(num_matches(&hash_table, i), i < expected_size ? 1 : 0);
+    }
+    hash_table.close();
+}
 
-        if (i < expected_size) {
-            EXPECT_TRUE(iter != hash_table.end());
-            validate_match(probe_row, iter.get_row());
-        } else {
-            EXPECT_TRUE(iter == hash_table.end());
-        }
+// Same as GrowTableTest, but without two level tables, so the single table is the
+// one that runs full.
+TEST_F(HashTableTest, GrowSingleLevelTableTest) {
+    int64_t old_threshold = config::hash_table_two_level_threshold;
+    config::hash_table_two_level_threshold = 0;
+    int num_keys = 100000;
+    MemTracker mem_limit(256 * 1024);
+    HashTable hash_table(
+        _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_limit, 16);
+
+    for (int i = 0; i < num_keys; ++i) {
+        hash_table.insert(create_tuple_row(i));
     }
+
+    EXPECT_FALSE(hash_table.is_two_level());
+    EXPECT_TRUE(hash_table.exceeded_limit());
+    EXPECT_EQ(hash_table.size(), num_keys);
+    for (int i = 0; i < num_keys; ++i) {
+        EXPECT_EQ(num_matches(&hash_table, i), 1);
+    }
+    hash_table.close();
+    config::hash_table_two_level_threshold = old_threshold;
 }
 
 // This test continues adding to the hash table to trigger the resize code paths
 TEST_F(HashTableTest, GrowTableTest2) {
     int build_row_val = 0;
     int num_to_add = 1024;
-    int expected_size = 0;
     MemTracker mem_limit(1024 * 1024);
-    vector<MemTracker*> mem_limits;
-    mem_limits.push_back(&mem_limit);
     HashTable hash_table(
-        _build_expr, _probe_expr, 1, false, 0, mem_limits, num_to_add);
+        _build_expr_ctxs, _probe_expr_ctxs, 1, false, 0, &mem_limit, num_to_add);
 
     LOG(INFO) << time(NULL);
 
     // This inserts about 5M entries
     for (int i = 0; i < 5 * 1024 * 1024; ++i) {
         hash_table.insert(create_tuple_row(build_row_val));
-        expected_size += num_to_add;
     }
 
     LOG(INFO) << time(NULL);
@@ -339,17 +645,12 @@ TEST_F(HashTableTest, GrowTableTest2) {
     }
 
     LOG(INFO) << time(NULL);
+    hash_table.close();
 }
 
 }
 
 int main(int argc, char** argv) {
-    std::string conffile = std::string(getenv("DORIS_HOME")) + "/conf/be.conf";
-    if (!doris::config::init(conffile.c_str(), false)) {
-        fprintf(stderr, "error read config file. \n");
-        return -1;
-    }
-    init_glog("be-test");
     ::testing::InitGoogleTest(&argc, argv);
     doris::CpuInfo::init();
     return RUN_ALL_TESTS();
@@ -0,0 +1,356 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/merge_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/bufferpool/buffer_pool.h"
+#include "runtime/bufferpool/reservation_tracker.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/cpu_info.h"
+#include "util/descriptor_helper.h"
+
+namespace doris {
+
+// a row of the left or the right side, whose INT key may be NULL
+struct InputRow {
+    bool key_is_null;
+    int32_t key;
+    int32_t value;
+};
+
+static InputRow row(int32_t key, int32_t value) {
+    return { false, key, value };
+}
+
+static InputRow null_key_row(int32_t value) {
+    return { true, 0, value };
+}
+
+// Returns rows of prebuilt tuples, like a scan node reading in order of keys below
+// the join.
+class TupleSourceNode : public ExecNode {
+public:
+    TupleSourceNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                    std::vector<Tuple*> tuples)
+            : ExecNode(pool, tnode, descs), _tuples(std::move(tuples)) {
+    }
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        while (_next < _tuples.size() && !row_batch->at_capacity()) {
+            int idx = row_batch->add_row();
+            row_batch->get_row(idx)->set_tuple(0, _tuples[_next++]);
+            row_batch->commit_last_row();
+            ++_num_rows_returned;
+        }
+        *eos = _next == _tuples.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<Tuple*> _tuples;
+    size_t _next = 0;
+};
+
+class MergeJoinNodeTest : public testing::Test {
+public:
+    MergeJoinNodeTest() : _tuple_pool(&_tracker) { }
+
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_thread_mgr = new ThreadResourceMgr();
+        env->_init_buffer_pool(1024, 1024L * 1024 * 1024, 0);
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_buffer_reservation->Close();
+        delete env->_buffer_reservation;
+        env->_buffer_reservation = nullptr;
+        delete env->_buffer_pool;
+        env->_buffer_pool = nullptr;
+        delete env->_thread_mgr;
+        env->_thread_mgr = nullptr;
+    }
+
+protected:
+    void SetUp() override {
+        // tuple 0 is the left side and tuple 1 the right side, both of a nullable
+        // INT key and an INT value
+        TDescriptorTableBuilder dtb;
+        for (int i = 0; i < 2; ++i) {
+            TTupleDescriptorBuilder tuple_builder;
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).nullable(true).column_pos(0).build());
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).nullable(false).column_pos(1).build());
+            tuple_builder.build(&dtb);
+        }
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+    }
+
+    void TearDown() override {
+        if (_state != nullptr) {
+            ExecEnv::GetInstance()->thread_mgr()->unregister_pool(_state->resource_pool());
+            _state.reset();
+        }
+    }
+
+    void create_runtime_state(int batch_size) {
+        TExecPlanFragmentParams params;
+        params.params.query_id.hi = 0;
+        params.params.query_id.lo = 1;
+        params.params.fragment_instance_id = params.params.query_id;
+        TQueryOptions query_options;
+        query_options.__set_batch_size(batch_size);
+        _state.reset(new RuntimeState(params, query_options, TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        _state->set_desc_tbl(_desc_tbl);
+        ASSERT_TRUE(_state->init_mem_trackers(params.params.query_id).ok());
+    }
+
+    std::vector<Tuple*> create_tuples(TTupleId tuple_id, const std::vector<InputRow>& rows) {
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(tuple_id);
+        const SlotDescriptor* key_slot = tuple_desc->slots()[0];
+        const SlotDescriptor* value_slot = tuple_desc->slots()[1];
+        std::vector<Tuple*> tuples;
+        for (const InputRow& input : rows) {
+            Tuple* tuple = Tuple::create(tuple_desc->byte_size(), &_tuple_pool);
+            if (input.key_is_null) {
+                tuple->set_null(key_slot->null_indicator_offset());
+            } else {
+                tuple->set_not_null(key_slot->null_indicator_offset());
+                *(int32_t*)tuple->get_slot(key_slot->tuple_offset()) = input.key;
+            }
+            *(int32_t*)tuple->get_slot(value_slot->tuple_offset()) = input.value;
+            tuples.push_back(tuple);
+        }
+        return tuples;
+    }
+
+    // "key:value" of the tuple of 'tuple_id' in 'row', "NULL" for a NULL key or
+    // tuple
+    std::string tuple_to_string(TTupleId tuple_id, TupleRow* row) {
+        Tuple* tuple = row->get_tuple(tuple_id);
+        if (tuple == nullptr) {
+            return "NULL";
+        }
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(tuple_id);
+        const SlotDescriptor* key_slot = tuple_desc->slots()[0];
+        const SlotDescriptor* value_slot = tuple_desc->slots()[1];
+        std::stringstream ss;
+        if (tuple->is_null(key_slot->null_indicator_offset())) {
+            ss << "NULL";
+        } else {
+            ss << *(int32_t*)tuple->get_slot(key_slot->tuple_offset());
+        }
+        ss << ":" << *(int32_t*)tuple->get_slot(value_slot->tuple_offset());
+        return ss.str();
+    }
+
+    static TExpr slot_ref(const SlotDescriptor* slot) {
+        TTypeNode type_node;
+        type_node.type = TTypeNodeType::SCALAR;
+        type_node.__isset.scalar_type = true;
+        type_node.scalar_type.type = TPrimitiveType::INT;
+        TExprNode node;
+        node.node_type = TExprNodeType::SLOT_REF;
+        node.type.types.push_back(type_node);
+        node.num_children = 0;
+        node.output_scale = -1;
+        TSlotRef ref;
+        ref.slot_id = slot->id();
+        ref.tuple_id = slot->parent();
+        node.__set_slot_ref(ref);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    static TPlanNode plan_node(int id, TPlanNodeType::type type,
+                               const std::vector<TTupleId>& row_tuples,
+                               const std::vector<bool>& nullable_tuples, int num_children) {
+        TPlanNode tnode;
+        tnode.node_id = id;
+        tnode.node_type = type;
+        tnode.num_children = num_children;
+        tnode.limit = -1;
+        tnode.row_tuples = row_tuples;
+        tnode.nullable_tuples = nullable_tuples;
+        tnode.compact_data = false;
+        return tnode;
+    }
+
+    // Joins 'left_rows' with 'right_rows', both ordered by their keys, and returns
+    // the output rows as "<left tuple>,<right tuple>" in 'result' in the order
+    // they are returned.
+    Status join(const std::vector<InputRow>& left_rows, const std::vector<InputRow>& right_rows,
+                std::vector<std::string>* result, int batch_size = 1024) {
+        create_runtime_state(batch_size);
+        ObjectPool* pool = _state->obj_pool();
+
+        TPlanNode tnode = plan_node(0, TPlanNodeType::MERGE_JOIN_NODE, { 0, 1 },
+                                    { false, false }, 2);
+        TEqJoinCondition cmp_conjunct;
+        cmp_conjunct.left = slot_ref(_desc_tbl->get_tuple_descriptor(0)->slots()[0]);
+        cmp_conjunct.right = slot_ref(_desc_tbl->get_tuple_descriptor(1)->slots()[0]);
+        tnode.merge_join_node.cmp_conjuncts.push_back(cmp_conjunct);
+        tnode.__isset.merge_join_node = true;
+
+        MergeJoinNode* node = pool->add(new MergeJoinNode(pool, tnode, *_desc_tbl));
+        const std::vector<InputRow>* inputs[] = { &left_rows, &right_rows };
+        for (int i = 0; i < 2; ++i) {
+            TPlanNode source_tnode = plan_node(i + 1, TPlanNodeType::OLAP_SCAN_NODE, { i },
+                                               { false }, 0);
+            ExecNode* source = pool->add(new TupleSourceNode(pool, source_tnode, *_desc_tbl,
+                                                             create_tuples(i, *inputs[i])));
+            RETURN_IF_ERROR(source->init(source_tnode, _state.get()));
+            node->add_child(source);
+        }
+
+        Status status = run(node, tnode, result);
+        Status close_status = node->close(_state.get());
+        RETURN_IF_ERROR(status);
+        return close_status;
+    }
+
+    Status run(ExecNode* node, const TPlanNode& tnode, std::vector<std::string>* result) {
+        RETURN_IF_ERROR(node->init(tnode, _state.get()));
+        RETURN_IF_ERROR(node->prepare(_state.get()));
+        RETURN_IF_ERROR(node->open(_state.get()));
+        RowBatch batch(node->row_desc(), _state->batch_size(), _state->instance_mem_tracker());
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_ERROR(node->get_next(_state.get(), &batch, &eos));
+            for (int i = 0; i < batch.num_rows(); ++i) {
+                TupleRow* out_row = batch.get_row(i);
+                result->push_back(tuple_to_string(0, out_row) + "," + tuple_to_string(1, out_row));
+            }
+            batch.reset();
+        }
+        return Status::OK();
+    }
+
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    MemTracker _tracker;
+    MemPool _tuple_pool;
+    std::unique_ptr<RuntimeState> _state;
+};
+
+TEST_F(MergeJoinNodeTest, duplicate_keys) {
+    std::vector<std::string> result;
+    ASSERT_TRUE(join({ row(1, 10), row(2, 20), row(2, 21), row(3, 30), row(5, 50) },
+                     { row(2, 200), row(2, 201), row(3, 300), row(4, 400) }, &result).ok());
+    // every left row of a key is joined with every right row of it, in order of keys
+    std::vector<std::string> expected = {
+        "2:20,2:200", "2:20,2:201", "2:21,2:200", "2:21,2:201", "3:30,3:300" };
+    ASSERT_EQ(expected, result);
+}
+
+TEST_F(MergeJoinNodeTest, null_keys) {
+    // NULL keys are read first from storage and match nothing, not even NULL
+    std::vector<std::string> result;
+    ASSERT_TRUE(join({ null_key_row(1), null_key_row(2), row(1, 10), row(2, 20) },
+                     { null_key_row(100), row(2, 200), row(2, 201) }, &result).ok());
+    std::vector<std::string> expected = { "2:20,2:200", "2:20,2:201" };
+    ASSERT_EQ(expected, result);
+    TearDown();
+
+    result.clear();
+    ASSERT_TRUE(join({ null_key_row(1), null_key_row(2) },
+                     { null_key_row(100), null_key_row(101) }, &result).ok());
+    ASSERT_TRUE(result.empty());
+}
+
+TEST_F(MergeJoinNodeTest, empty_input) {
+    const std::vector<InputRow> rows = { row(1, 10), row(2, 20) };
+    std::vector<std::string> result;
+    ASSERT_TRUE(join({}, rows, &result).ok());
+    ASSERT_TRUE(result.empty());
+    TearDown();
+
+    ASSERT_TRUE(join(rows, {}, &result).ok());
+    ASSERT_TRUE(result.empty());
+    TearDown();
+
+    ASSERT_TRUE(join({}, {}, &result).ok());
+    ASSERT_TRUE(result.empty());
+    TearDown();
+
+    // no keys in common
+    ASSERT_TRUE(join(rows, { row(0, 0), row(3, 30) }, &result).ok());
+    ASSERT_TRUE(result.empty());
+}
+
+TEST_F(MergeJoinNodeTest, groups_across_batches) {
+    // with batches of 4 rows, groups of equal keys on both sides span batches
+    const int num_keys = 100;
+    std::vector<InputRow> left_rows;
+    for (int i = 0; i < 3 * num_keys; ++i) {
+        left_rows.push_back(row(i / 3, i));
+    }
+    std::vector<InputRow> right_rows;
+    for (int i = 0; i < 5 * num_keys; ++i) {
+        // only even keys are on the right side
+        if ((i / 5) % 2 == 0) {
+            right_rows.push_back(row(i / 5, i));
+        }
+    }
+
+    std::vector<std::string> result;
+    ASSERT_TRUE(join(left_rows, right_rows, &result, 4).ok());
+    std::vector<std::string> expected;
+    for (int i = 0; i < 3 * num_keys; ++i) {
+        int key = i / 3;
+        if (key % 2 != 0) {
+            continue;
+        }
+        for (int j = key * 5; j < key * 5 + 5; ++j) {
+            expected.push_back(std::to_string(key) + ":" + std::to_string(i) + ","
+                               + std::to_string(key) + ":" + std::to_string(j));
+        }
+    }
+    ASSERT_EQ(expected, result);
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,402 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/partitioned_hash_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/bufferpool/buffer_pool.h"
+#include "runtime/bufferpool/reservation_tracker.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/cpu_info.h"
+#include "util/descriptor_helper.h"
+
+namespace doris {
+
+static const int64_t kPageLen = 64 * 1024;
+
+// a row of the probe or the build side, whose INT key may be NULL
+struct InputRow {
+    bool key_is_null;
+    int32_t key;
+    int32_t value;
+};
+
+static InputRow row(int32_t key, int32_t value) {
+    return { false, key, value };
+}
+
+static InputRow null_key_row(int32_t value) {
+    return { true, 0, value };
+}
+
+// Returns rows of prebuilt tuples, like a scan node below the join.
+class TupleSourceNode : public ExecNode {
+public:
+    TupleSourceNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                    std::vector<Tuple*> tuples)
+            : ExecNode(pool, tnode, descs), _tuples(std::move(tuples)) {
+    }
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        while (_next < _tuples.size() && !row_batch->at_capacity()) {
+            int idx = row_batch->add_row();
+            row_batch->get_row(idx)->set_tuple(0, _tuples[_next++]);
+            row_batch->commit_last_row();
+            ++_num_rows_returned;
+        }
+        *eos = _next == _tuples.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<Tuple*> _tuples;
+    size_t _next = 0;
+};
+
+class PartitionedHashJoinNodeTest : public testing::Test {
+public:
+    PartitionedHashJoinNodeTest() : _tuple_pool(&_tracker) { }
+
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_thread_mgr = new ThreadResourceMgr();
+        env->_init_buffer_pool(1024, 1024L * 1024 * 1024, 0);
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_buffer_reservation->Close();
+        delete env->_buffer_reservation;
+        env->_buffer_reservation = nullptr;
+        delete env->_buffer_pool;
+        env->_buffer_pool = nullptr;
+        delete env->_thread_mgr;
+        env->_thread_mgr = nullptr;
+    }
+
+protected:
+    void SetUp() override {
+        // tuple 0 is the probe side and tuple 1 the build side, both of a nullable
+        // INT key and an INT value
+        TDescriptorTableBuilder dtb;
+        for (int i = 0; i < 2; ++i) {
+            TTupleDescriptorBuilder tuple_builder;
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).nullable(true).column_pos(0).build());
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).nullable(false).column_pos(1).build());
+            tuple_builder.build(&dtb);
+        }
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+    }
+
+    void TearDown() override {
+        if (_state != nullptr) {
+            ExecEnv::GetInstance()->thread_mgr()->unregister_pool(_state->resource_pool());
+            _state.reset();
+        }
+    }
+
+    void create_runtime_state(int batch_size) {
+        TExecPlanFragmentParams params;
+        params.params.query_id.hi = 0;
+        params.params.query_id.lo = 1;
+        params.params.fragment_instance_id = params.params.query_id;
+        TQueryOptions query_options;
+        query_options.__set_batch_size(batch_size);
+        _state.reset(new RuntimeState(params, query_options, TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        _state->set_desc_tbl(_desc_tbl);
+        ASSERT_TRUE(_state->init_mem_trackers(params.params.query_id).ok());
+    }
+
+    std::vector<Tuple*> create_tuples(TTupleId tuple_id, const std::vector<InputRow>& rows) {
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(tuple_id);
+        const SlotDescriptor* key_slot = tuple_desc->slots()[0];
+        const SlotDescriptor* value_slot = tuple_desc->slots()[1];
+        std::vector<Tuple*> tuples;
+        for (const InputRow& input : rows) {
+            Tuple* tuple = Tuple::create(tuple_desc->byte_size(), &_tuple_pool);
+            if (input.key_is_null) {
+                tuple->set_null(key_slot->null_indicator_offset());
+            } else {
+                tuple->set_not_null(key_slot->null_indicator_offset());
+                *(int32_t*)tuple->get_slot(key_slot->tuple_offset()) = input.key;
+            }
+            *(int32_t*)tuple->get_slot(value_slot->tuple_offset()) = input.value;
+            tuples.push_back(tuple);
+        }
+        return tuples;
+    }
+
+    // "key:value" of the tuple of 'tuple_id' in 'row', "NULL" for a NULL key or
+    // tuple
+    std::string tuple_to_string(TTupleId tuple_id, TupleRow* row) {
+        Tuple* tuple = row->get_tuple(tuple_id);
+        if (tuple == nullptr) {
+            return "NULL";
+        }
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(tuple_id);
+        const SlotDescriptor* key_slot = tuple_desc->slots()[0];
+        const SlotDescriptor* value_slot = tuple_desc->slots()[1];
+        std::stringstream ss;
+        if (tuple->is_null(key_slot->null_indicator_offset())) {
+            ss << "NULL";
+        } else {
+            ss << *(int32_t*)tuple->get_slot(key_slot->tuple_offset());
+        }
+        ss << ":" << *(int32_t*)tuple->get_slot(value_slot->tuple_offset());
+        return ss.str();
+    }
+
+    static TExpr slot_ref(const SlotDescriptor* slot) {
+        TTypeNode type_node;
+        type_node.type = TTypeNodeType::SCALAR;
+        type_node.__isset.scalar_type = true;
+        type_node.scalar_type.type = TPrimitiveType::INT;
+        TExprNode node;
+        node.node_type = TExprNodeType::SLOT_REF;
+        node.type.types.push_back(type_node);
+        node.num_children = 0;
+        node.output_scale = -1;
+        TSlotRef ref;
+        ref.slot_id = slot->id();
+        ref.tuple_id = slot->parent();
+        node.__set_slot_ref(ref);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+    static TPlanNode plan_node(int id, TPlanNodeType::type type,
+                               const std::vector<TTupleId>& row_tuples,
+                               const std::vector<bool>& nullable_tuples, int num_children) {
+        TPlanNode tnode;
+        tnode.node_id = id;
+        tnode.node_type = type;
+        tnode.num_children = num_children;
+        tnode.limit = -1;
+        tnode.row_tuples = row_tuples;
+        tnode.nullable_tuples = nullable_tuples;
+        tnode.compact_data = false;
+        return tnode;
+    }
+
+    // Joins 'probe_rows' with 'build_rows' on their keys and returns the sorted
+    // output rows as "<probe tuple>,<build tuple>" in 'result'. The node may
+    // reserve at most 'max_reservation' bytes.
+    Status join(TJoinOp::type join_op, const std::vector<InputRow>& probe_rows,
+                const std::vector<InputRow>& build_rows, std::vector<std::string>* result,
+                int batch_size = 1024, int64_t max_reservation = 64L * 1024 * 1024) {
+        create_runtime_state(batch_size);
+        ObjectPool* pool = _state->obj_pool();
+
+        std::vector<bool> nullable_tuples = {
+            join_op == TJoinOp::RIGHT_OUTER_JOIN || join_op == TJoinOp::FULL_OUTER_JOIN,
+            join_op == TJoinOp::LEFT_OUTER_JOIN || join_op == TJoinOp::FULL_OUTER_JOIN };
+        TPlanNode tnode = plan_node(0, TPlanNodeType::HASH_JOIN_NODE, { 0, 1 },
+                                    nullable_tuples, 2);
+        TEqJoinCondition eq_join_conjunct;
+        eq_join_conjunct.left = slot_ref(_desc_tbl->get_tuple_descriptor(0)->slots()[0]);
+        eq_join_conjunct.right = slot_ref(_desc_tbl->get_tuple_descriptor(1)->slots()[0]);
+        tnode.hash_join_node.join_op = join_op;
+        tnode.hash_join_node.eq_join_conjuncts.push_back(eq_join_conjunct);
+        tnode.__isset.hash_join_node = true;
+        tnode.resource_profile.min_reservation = 0;
+        tnode.resource_profile.max_reservation = max_reservation;
+        tnode.resource_profile.__set_spillable_buffer_size(kPageLen);
+        tnode.resource_profile.__set_max_row_buffer_size(kPageLen);
+        tnode.__isset.resource_profile = true;
+
+        PartitionedHashJoinNode* node =
+            pool->add(new PartitionedHashJoinNode(pool, tnode, *_desc_tbl));
+        const std::vector<InputRow>* inputs[] = { &probe_rows, &build_rows };
+        for (int i = 0; i < 2; ++i) {
+            TPlanNode source_tnode = plan_node(i + 1, TPlanNodeType::EXCHANGE_NODE, { i },
+                                               { false }, 0);
+            ExecNode* source = pool->add(new TupleSourceNode(pool, source_tnode, *_desc_tbl,
+                                                             create_tuples(i, *inputs[i])));
+            RETURN_IF_ERROR(source->init(source_tnode, _state.get()));
+            node->add_child(source);
+        }
+
+        Status status = run(node, tnode, result);
+        Status close_status = node->close(_state.get());
+        RETURN_IF_ERROR(status);
+        std::sort(result->begin(), result->end());
+        return close_status;
+    }
+
+    Status run(ExecNode* node, const TPlanNode& tnode, std::vector<std::string>* result) {
+        RETURN_IF_ERROR(node->init(tnode, _state.get()));
+        RETURN_IF_ERROR(node->prepare(_state.get()));
+        RETURN_IF_ERROR(node->open(_state.get()));
+        RowBatch batch(node->row_desc(), _state->batch_size(), _state->instance_mem_tracker());
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_ERROR(node->get_next(_state.get(), &batch, &eos));
+            for (int i = 0; i < batch.num_rows(); ++i) {
+                TupleRow* out_row = batch.get_row(i);
+                result->push_back(tuple_to_string(0, out_row) + "," + tuple_to_string(1, out_row));
+            }
+            batch.reset();
+        }
+        return Status::OK();
+    }
+
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    MemTracker _tracker;
+    MemPool _tuple_pool;
+    std::unique_ptr<RuntimeState> _state;
+
+    const std::vector<InputRow> _probe_rows = {
+        row(1, 10), row(2, 20), row(2, 21), row(3, 30), null_key_row(50) };
+    const std::vector<InputRow> _build_rows = {
+        row(2, 200), row(2, 201), row(3, 300), row(4, 400), null_key_row(500) };
+};
+
+TEST_F(PartitionedHashJoinNodeTest, inner_join) {
+    std::vector<std::string> result;
+    ASSERT_TRUE(join(TJoinOp::INNER_JOIN, _probe_rows, _build_rows, &result).ok());
+    // every duplicate key matches, NULL keys match nothing
+    std::vector<std::string> expected = {
+        "2:20,2:200", "2:20,2:201", "2:21,2:200", "2:21,2:201", "3:30,3:300" };
+    ASSERT_EQ(expected, result);
+}
+
+TEST_F(PartitionedHashJoinNodeTest, left_outer_join) {
+    std::vector<std::string> result;
+    ASSERT_TRUE(join(TJoinOp::LEFT_OUTER_JOIN, _probe_rows, _build_rows, &result).ok());
+    std::vector<std::string> expected = {
+        "1:10,NULL", "2:20,2:200", "2:20,2:201", "2:21,2:200", "2:21,2:201", "3:30,3:300",
+        "NULL:50,NULL" };
+    ASSERT_EQ(expected, result);
+}
+
+TEST_F(PartitionedHashJoinNodeTest, right_outer_join) {
+    std::vector<std::string> result;
+    ASSERT_TRUE(join(TJoinOp::RIGHT_OUTER_JOIN, _probe_rows, _build_rows, &result).ok());
+    // build rows with NULL keys are kept and, like in HashJoinNode, NULL keys match
+    // each other
+    std::vector<std::string> expected = {
+        "2:20,2:200", "2:20,2:201", "2:21,2:200", "2:21,2:201", "3:30,3:300",
+        "NULL,4:400", "NULL:50,NULL:500" };
+    ASSERT_EQ(expected, result);
+}
+
+TEST_F(PartitionedHashJoinNodeTest, left_semi_and_anti_join) {
+    std::vector<std::string> result;
+    ASSERT_TRUE(join(TJoinOp::LEFT_SEMI_JOIN, _probe_rows, _build_rows, &result).ok());
+    std::vector<std::string> expected = { "2:20,2:200", "2:21,2:200", "3:30,3:300" };
+    ASSERT_EQ(result.size(), expected.size());
+    for (int i = 0; i < result.size(); ++i) {
+        // any build row of the key may be the first match
+        ASSERT_EQ(expected[i].substr(0, 5), result[i].substr(0, 5));
+    }
+    TearDown();
+
+    result.clear();
+    ASSERT_TRUE(join(TJoinOp::LEFT_ANTI_JOIN, _probe_rows, _build_rows, &result).ok());
+    expected = { "1:10,NULL", "NULL:50,NULL" };
+    ASSERT_EQ(expected, result);
+}
+
+TEST_F(PartitionedHashJoinNodeTest, empty_input) {
+    std::vector<std::string> result;
+    ASSERT_TRUE(join(TJoinOp::INNER_JOIN, _probe_rows, {}, &result).ok());
+    ASSERT_TRUE(result.empty());
+    TearDown();
+
+    result.clear();
+    ASSERT_TRUE(join(TJoinOp::LEFT_OUTER_JOIN, _probe_rows, {}, &result).ok());
+    std::vector<std::string> expected = {
+        "1:10,NULL", "2:20,NULL", "2:21,NULL", "3:30,NULL", "NULL:50,NULL" };
+    ASSERT_EQ(expected, result);
+    TearDown();
+
+    result.clear();
+    ASSERT_TRUE(join(TJoinOp::RIGHT_OUTER_JOIN, {}, _build_rows, &result).ok());
+    expected = { "NULL,2:200", "NULL,2:201", "NULL,3:300", "NULL,4:400", "NULL,NULL:500" };
+    ASSERT_EQ(expected, result);
+}
+
+TEST_F(PartitionedHashJoinNodeTest, many_batches) {
+    // enough keys for rows in every partition, returned in batches of 16 rows
+    const int num_keys = 1000;
+    std::vector<InputRow> probe_rows;
+    for (int i = 0; i < 3 * num_keys; ++i) {
+        probe_rows.push_back(row(i % (2 * num_keys), i));
+    }
+    std::vector<InputRow> build_rows;
+    for (int i = 0; i < num_keys; ++i) {
+        build_rows.push_back(row(i, i * 10));
+    }
+
+    std::vector<std::string> result;
+    ASSERT_TRUE(join(TJoinOp::FULL_OUTER_JOIN, probe_rows, build_rows, &result, 16).ok());
+    std::vector<std::string> expected;
+    for (int i = 0; i < 3 * num_keys; ++i) {
+        int key = i % (2 * num_keys);
+        std::string build = key < num_keys ? std::to_string(key) + ":" + std::to_string(key * 10)
+                                           : "NULL";
+        expected.push_back(std::to_string(key) + ":" + std::to_string(i) + "," + build);
+    }
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(expected, result);
+}
+
+TEST_F(PartitionedHashJoinNodeTest, not_enough_reservation) {
+    // one page per partition, the build side needs a lot more
+    std::vector<InputRow> build_rows;
+    for (int i = 0; i < 200000; ++i) {
+        build_rows.push_back(row(i, i));
+    }
+    std::vector<std::string> result;
+    Status status = join(TJoinOp::INNER_JOIN, _probe_rows, build_rows, &result, 1024,
+                         16 * kPageLen);
+    // fails instead of returning a partial result
+    ASSERT_TRUE(status.is_mem_limit_exceeded()) << status.get_error_msg();
+    ASSERT_TRUE(result.empty());
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    return RUN_ALL_TESTS();
+}
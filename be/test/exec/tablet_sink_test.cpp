@@ -265,6 +265,143 @@ TDataSink get_decimal_sink(TDescriptorTable* desc_tbl) {
     return data_sink;
 }
 
+TDataSink get_agg_sink(TDescriptorTable* desc_tbl) {
+    int64_t db_id = 1;
+    int64_t table_id = 2;
+    int64_t partition_id = 3;
+    int64_t index1_id = 4;
+    int64_t tablet1_id = 6;
+    int64_t tablet2_id = 7;
+
+    TDataSink data_sink;
+    data_sink.type = TDataSinkType::OLAP_TABLE_SINK;
+    data_sink.__isset.olap_table_sink = true;
+
+    TOlapTableSink& tsink = data_sink.olap_table_sink;
+    tsink.load_id.hi = 123;
+    tsink.load_id.lo = 456;
+    tsink.txn_id = 789;
+    tsink.db_id = 1;
+    tsink.table_id = 2;
+    tsink.tuple_id = 0;
+    tsink.num_replicas = 3;
+    tsink.db_name = "testDb";
+    tsink.table_name = "testTable";
+
+    // aggregate table: k1 INT key, v1 BIGINT SUM, v2 INT MAX, v3 VARCHAR REPLACE
+    TOlapTableSchemaParam& tschema = tsink.schema;
+    tschema.db_id = 1;
+    tschema.table_id = 2;
+    tschema.version = 0;
+    tschema.__set_keys_type(TKeysType::AGG_KEYS);
+
+    // descriptor
+    {
+        TDescriptorTableBuilder dtb;
+        {
+            TTupleDescriptorBuilder tuple_builder;
+
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).nullable(true)
+                .column_name("k1").column_pos(1).build());
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_BIGINT).nullable(true)
+                .column_name("v1").column_pos(2).build());
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).nullable(true)
+                .column_name("v2").column_pos(3).build());
+            tuple_builder.add_slot(
+                TSlotDescriptorBuilder().string_type(10).nullable(true)
+                .column_name("v3").column_pos(4).build());
+
+            tuple_builder.build(&dtb);
+        }
+
+        *desc_tbl = dtb.desc_tbl();
+        tschema.slot_descs = desc_tbl->slotDescriptors;
+        tschema.tuple_desc = desc_tbl->tupleDescriptors[0];
+    }
+    // index
+    tschema.indexes.resize(1);
+    tschema.indexes[0].id = index1_id;
+    tschema.indexes[0].columns = {"k1", "v1", "v2", "v3"};
+    tschema.indexes[0].__set_aggregation_types({
+        TAggregationType::NONE, TAggregationType::SUM,
+        TAggregationType::MAX, TAggregationType::REPLACE});
+    // partition
+    TOlapTablePartitionParam& tpartition = tsink.partition;
+    tpartition.db_id = db_id;
+    tpartition.table_id = table_id;
+    tpartition.version = table_id;
+    tpartition.__set_partition_column("k1");
+    tpartition.__set_distributed_columns({"k1"});
+    tpartition.partitions.resize(1);
+    tpartition.partitions[0].id = partition_id;
+    tpartition.partitions[0].num_buckets = 2;
+    tpartition.partitions[0].indexes.resize(1);
+    tpartition.partitions[0].indexes[0].index_id = index1_id;
+    tpartition.partitions[0].indexes[0].tablets = {tablet1_id, tablet2_id};
+    // location
+    TOlapTableLocationParam& location = tsink.location;
+    location.db_id = db_id;
+    location.table_id = table_id;
+    location.version = 0;
+    location.tablets.resize(2);
+    location.tablets[0].tablet_id = tablet1_id;
+    location.tablets[0].node_ids = {0, 1, 2};
+    location.tablets[1].tablet_id = tablet2_id;
+    location.tablets[1].node_ids = {0, 1, 2};
+    // location
+    TPaloNodesInfo& nodes_info = tsink.nodes_info;
+    nodes_info.nodes.resize(3);
+    nodes_info.nodes[0].id = 0;
+    nodes_info.nodes[0].host = "127.0.0.1";
+    nodes_info.nodes[0].async_internal_port = 4356;
+    nodes_info.nodes[1].id = 1;
+    nodes_info.nodes[1].host = "127.0.0.1";
+    nodes_info.nodes[1].async_internal_port = 4356;
+    nodes_info.nodes[2].id = 2;
+    nodes_info.nodes[2].host = "127.0.0.1";
+    nodes_info.nodes[2].async_internal_port = 4357;
+
+    return data_sink;
+}
+
+// add a row of the aggregate table of get_agg_sink(), null if a pointer is null
+void add_agg_row(RowBatch* batch, TupleDescriptor* tuple_desc,
+                 const int32_t* k1, const int64_t* v1, const int32_t* v2, const char* v3) {
+    Tuple* tuple = (Tuple*)batch->tuple_data_pool()->allocate(tuple_desc->byte_size());
+    batch->get_row(batch->add_row())->set_tuple(0, tuple);
+    memset(tuple, 0, tuple_desc->byte_size());
+
+    auto& slots = tuple_desc->slots();
+    if (k1 == nullptr) {
+        tuple->set_null(slots[0]->null_indicator_offset());
+    } else {
+        *reinterpret_cast<int32_t*>(tuple->get_slot(slots[0]->tuple_offset())) = *k1;
+    }
+    if (v1 == nullptr) {
+        tuple->set_null(slots[1]->null_indicator_offset());
+    } else {
+        *reinterpret_cast<int64_t*>(tuple->get_slot(slots[1]->tuple_offset())) = *v1;
+    }
+    if (v2 == nullptr) {
+        tuple->set_null(slots[2]->null_indicator_offset());
+    } else {
+        *reinterpret_cast<int32_t*>(tuple->get_slot(slots[2]->tuple_offset())) = *v2;
+    }
+    if (v3 == nullptr) {
+        tuple->set_null(slots[3]->null_indicator_offset());
+    } else {
+        StringValue* str_val = reinterpret_cast<StringValue*>(
+            tuple->get_slot(slots[3]->tuple_offset()));
+        str_val->len = strlen(v3);
+        str_val->ptr = (char*)batch->tuple_data_pool()->allocate(str_val->len);
+        memcpy(str_val->ptr, v3, str_val->len);
+    }
+    batch->commit_last_row();
+}
+
 class TestInternalService : public palo::PInternalService {
 public:
     TestInternalService() { }
@@ -934,6 +1071,124 @@ TEST_F(OlapTableSinkTest, decimal) {
     delete server;
 }
 
+TEST_F(OlapTableSinkTest, pre_aggregate) {
+    config::olap_table_sink_pre_aggregate_rows = 1024;
+    // start brpc service first
+    auto server = new brpc::Server();
+    auto service = new TestInternalService();
+    server->AddService(service, brpc::SERVER_OWNS_SERVICE);
+    brpc::ServerOptions options;
+    server->Start(4356, &options);
+
+    TUniqueId fragment_id;
+    TQueryOptions query_options;
+    query_options.batch_size = 1;
+    RuntimeState state(fragment_id, query_options, TQueryGlobals(), &_env);
+    state._instance_mem_tracker.reset(new MemTracker());
+
+    ObjectPool obj_pool;
+    TDescriptorTable tdesc_tbl;
+    auto t_data_sink = get_agg_sink(&tdesc_tbl);
+
+    // crate desc_tabl
+    DescriptorTbl* desc_tbl = nullptr;
+    auto st = DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    ASSERT_TRUE(st.ok());
+    state._desc_tbl = desc_tbl;
+
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+    service->_row_desc = &row_desc;
+    std::set<std::string> output_set;
+    service->_output_set = &output_set;
+
+    OlapTableSink sink(&obj_pool, row_desc, {}, &st);
+    ASSERT_TRUE(st.ok());
+    st = sink.init(t_data_sink);
+    ASSERT_TRUE(st.ok());
+    st = sink.prepare(&state);
+    ASSERT_TRUE(st.ok());
+    st = sink.open(&state);
+    ASSERT_TRUE(st.ok());
+
+    // rows of different keys, which may be in different tablets, are interleaved
+    int32_t k[] = {1, 2, 3};
+    int64_t s[] = {1, 2, 3, 4, 5, 10};
+    int32_t m[] = {1, 3, 5, 6, 7};
+    MemTracker tracker;
+    RowBatch batch(row_desc, 1024, &tracker);
+    add_agg_row(&batch, tuple_desc, &k[0], &s[5], &m[2], "a");
+    add_agg_row(&batch, tuple_desc, &k[1], &s[0], &m[0], "x");
+    add_agg_row(&batch, tuple_desc, nullptr, &s[2], &m[1], "n1");
+    add_agg_row(&batch, tuple_desc, &k[0], nullptr, &m[4], "b");
+    add_agg_row(&batch, tuple_desc, &k[1], &s[1], nullptr, nullptr);
+    add_agg_row(&batch, tuple_desc, nullptr, &s[3], &m[0], "n2");
+    add_agg_row(&batch, tuple_desc, &k[0], &s[4], &m[3], "c");
+    add_agg_row(&batch, tuple_desc, &k[2], &s[0], &m[0], "z");
+    st = sink.send(&state, &batch);
+    ASSERT_TRUE(st.ok());
+    st = sink.close(&state, Status::OK());
+    ASSERT_TRUE(st.ok());
+
+    // SUM and MAX ignore nulls, REPLACE keeps the last value even if it's null
+    ASSERT_EQ(4, output_set.size());
+    ASSERT_TRUE(output_set.count("[(1 15 7 c)]") > 0);
+    ASSERT_TRUE(output_set.count("[(2 3 1 null)]") > 0);
+    ASSERT_TRUE(output_set.count("[(null 7 3 n2)]") > 0);
+    ASSERT_TRUE(output_set.count("[(3 1 1 z)]") > 0);
+    // 4 rows are received by each of the 2 available replicas
+    ASSERT_EQ(8, service->row_counters);
+
+    server->Stop(100);
+    server->Join();
+    delete server;
+    config::olap_table_sink_pre_aggregate_rows = 0;
+}
+
+TEST_F(OlapTableSinkTest, pre_aggregate_batch) {
+    ObjectPool obj_pool;
+    TDescriptorTable tdesc_tbl;
+    get_agg_sink(&tdesc_tbl);
+    DescriptorTbl* desc_tbl = nullptr;
+    auto st = DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    ASSERT_TRUE(st.ok());
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+
+    NodeChannel channel(nullptr, 4, 0, 0);
+    auto& slots = tuple_desc->slots();
+    channel._key_slots = {slots[0]};
+    channel._value_slots = {slots[1], slots[2], slots[3]};
+    channel._value_agg_types = {
+        TAggregationType::SUM, TAggregationType::MAX, TAggregationType::REPLACE};
+
+    // the same key in two tablets, whose rows are interleaved
+    int32_t k1 = 1;
+    int64_t s[] = {1, 2, 3, 4};
+    int32_t m[] = {1, 2, 3, 0};
+    MemTracker tracker;
+    RowBatch batch(row_desc, 1024, &tracker);
+    google::protobuf::RepeatedField<int64_t> tablet_ids;
+    add_agg_row(&batch, tuple_desc, &k1, &s[0], &m[0], "a");
+    tablet_ids.Add(7);
+    add_agg_row(&batch, tuple_desc, &k1, &s[1], &m[1], "b");
+    tablet_ids.Add(6);
+    add_agg_row(&batch, tuple_desc, &k1, &s[2], &m[2], "c");
+    tablet_ids.Add(7);
+    add_agg_row(&batch, tuple_desc, &k1, &s[3], &m[3], "d");
+    tablet_ids.Add(6);
+
+    channel._pre_aggregate_batch(&batch, &tablet_ids);
+
+    // rows are sorted by tablet, and rows of different tablets are not aggregated
+    ASSERT_EQ(2, batch.num_rows());
+    ASSERT_EQ(2, tablet_ids.size());
+    ASSERT_EQ(6, tablet_ids.Get(0));
+    ASSERT_EQ(7, tablet_ids.Get(1));
+    ASSERT_STREQ("[(1 6 2 d)]", batch.get_row(0)->to_string(row_desc).c_str());
+    ASSERT_STREQ("[(1 4 3 c)]", batch.get_row(1)->to_string(row_desc).c_str());
+}
+
 }
 }
 
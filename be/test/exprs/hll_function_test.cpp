@@ -0,0 +1,162 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/aggregate_functions.h"
+#include "common/config.h"
+#include "exprs/hll_hash_function.h"
+#include "olap/hll.h"
+#include "testutil/function_utils.h"
+#include <gtest/gtest.h>
+
+namespace doris {
+
+class HllFunctionTest : public testing::Test {
+public:
+    HllFunctionTest() {}
+
+protected:
+    void SetUp() override {
+        config::enable_sparse_hll_intermediate = true;
+    }
+
+    void TearDown() override {
+        config::enable_sparse_hll_intermediate = false;
+    }
+};
+
+static StringVal ndv_of(FunctionContext* ctx, int begin, int end) {
+    StringVal dst;
+    AggregateFunctions::hll_init(ctx, &dst);
+    for (int i = begin; i < end; ++i) {
+        AggregateFunctions::hll_update(ctx, IntVal(i), &dst);
+    }
+    return dst;
+}
+
+static int64_t ndv_result(FunctionContext* ctx, const StringVal& src) {
+    StringVal result = AggregateFunctions::hll_finalize(ctx, src);
+    return std::stoll(std::string((char*)result.ptr, result.len));
+}
+
+TEST_F(HllFunctionTest, sparse) {
+    FunctionUtils futil;
+    FunctionContext* ctx = futil.get_fn_ctx();
+
+    StringVal dst = ndv_of(ctx, 0, 100);
+    ASSERT_EQ(HLL_DATA_SPRASE, dst.ptr[0]);
+    ASSERT_LT(dst.len, HLL_SPARSE_HEADER_LEN + 100 * HLL_SPARSE_ENTRY_LEN + 1);
+    ASSERT_NEAR(100, ndv_result(ctx, dst), 2);
+
+    // merging sparse sets gives the same set as updating with all values
+    StringVal merged = ndv_of(ctx, 0, 50);
+    AggregateFunctions::hll_merge(ctx, ndv_of(ctx, 50, 100), &merged);
+    ASSERT_EQ(dst.len, merged.len);
+    ASSERT_EQ(0, memcmp(dst.ptr, merged.ptr, dst.len));
+}
+
+TEST_F(HllFunctionTest, full) {
+    FunctionUtils futil;
+    FunctionContext* ctx = futil.get_fn_ctx();
+
+    StringVal dst = ndv_of(ctx, 0, 100000);
+    ASSERT_EQ(HLL_DATA_FULL, dst.ptr[0]);
+    ASSERT_EQ(HLL_COLUMN_DEFAULT_LEN, dst.len);
+    ASSERT_NEAR(100000, ndv_result(ctx, dst), 2000);
+
+    // sparse into full and full into sparse
+    StringVal merged = ndv_of(ctx, 0, 100);
+    AggregateFunctions::hll_merge(ctx, ndv_of(ctx, 100, 100000), &merged);
+    ASSERT_EQ(HLL_DATA_FULL, merged.ptr[0]);
+    ASSERT_EQ(0, memcmp(dst.ptr, merged.ptr, dst.len));
+
+    merged = ndv_of(ctx, 100, 100000);
+    AggregateFunctions::hll_merge(ctx, ndv_of(ctx, 0, 100), &merged);
+    ASSERT_EQ(0, memcmp(dst.ptr, merged.ptr, dst.len));
+}
+
+TEST_F(HllFunctionTest, hll_union_agg) {
+    FunctionUtils futil;
+    FunctionContext* ctx = futil.get_fn_ctx();
+
+    HllVal dst;
+    AggregateFunctions::hll_union_agg_init(ctx, &dst);
+    for (int i = 0; i < 1000; ++i) {
+        std::string value = std::to_string(i % 500);
+        StringVal hll = HllHashFunctions::hll_hash(
+            ctx, StringVal((uint8_t*)value.data(), value.size()));
+        AggregateFunctions::hll_union_agg_update(ctx, static_cast<const HllVal&>(hll), &dst);
+    }
+    ASSERT_EQ(HLL_DATA_SPRASE, dst.ptr[0]);
+    int64_t cardinality = AggregateFunctions::hll_union_agg_finalize(ctx, dst).val;
+    ASSERT_NEAR(500, cardinality, 10);
+
+    // hll_raw_agg keeps the set sparse
+    HllVal result = AggregateFunctions::hll_raw_agg_finalize(ctx, dst);
+    ASSERT_EQ(dst.len, result.len);
+    ASSERT_EQ(cardinality, HllHashFunctions::hll_cardinality(ctx, result).val);
+}
+
+TEST_F(HllFunctionTest, sparse_disabled) {
+    config::enable_sparse_hll_intermediate = false;
+    FunctionUtils futil;
+    FunctionContext* ctx = futil.get_fn_ctx();
+
+    // ndv keeps the untagged registers of older backends
+    StringVal dst = ndv_of(ctx, 0, 100);
+    ASSERT_EQ(HLL_REGISTERS_COUNT, dst.len);
+    ASSERT_NEAR(100, ndv_result(ctx, dst), 2);
+    StringVal merged = ndv_of(ctx, 0, 50);
+    AggregateFunctions::hll_merge(ctx, ndv_of(ctx, 50, 100), &merged);
+    ASSERT_EQ(HLL_REGISTERS_COUNT, merged.len);
+    ASSERT_EQ(0, memcmp(dst.ptr, merged.ptr, dst.len));
+
+    // hll_union_agg starts as a full set
+    HllVal hll;
+    AggregateFunctions::hll_union_agg_init(ctx, &hll);
+    ASSERT_EQ(HLL_DATA_FULL, hll.ptr[0]);
+    ASSERT_EQ(HLL_COLUMN_DEFAULT_LEN, hll.len);
+}
+
+TEST_F(HllFunctionTest, merge_both_formats) {
+    FunctionUtils futil;
+    FunctionContext* ctx = futil.get_fn_ctx();
+    StringVal expected = ndv_of(ctx, 0, 100);
+    int64_t expected_ndv = ndv_result(ctx, expected);
+
+    // backends of a query during a rolling upgrade exchange both formats
+    config::enable_sparse_hll_intermediate = false;
+    StringVal legacy_low = ndv_of(ctx, 0, 50);
+    StringVal legacy_high = ndv_of(ctx, 50, 100);
+    config::enable_sparse_hll_intermediate = true;
+    StringVal sparse_low = ndv_of(ctx, 0, 50);
+    StringVal sparse_high = ndv_of(ctx, 50, 100);
+
+    AggregateFunctions::hll_merge(ctx, legacy_high, &sparse_low);
+    ASSERT_EQ(HLL_DATA_FULL, sparse_low.ptr[0]);
+    ASSERT_EQ(expected_ndv, ndv_result(ctx, sparse_low));
+
+    AggregateFunctions::hll_merge(ctx, sparse_high, &legacy_low);
+    ASSERT_EQ(HLL_DATA_FULL, legacy_low.ptr[0]);
+    ASSERT_EQ(expected_ndv, ndv_result(ctx, legacy_low));
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -371,6 +371,54 @@ TEST_F(HybirdSetTest, timestamp) {
     ASSERT_FALSE(set->find(&v23));
 }
 
+TEST_F(HybirdSetTest, large_bigint) {
+    // enough values to go from the array lookup to the hash table
+    HybirdSetBase* set = HybirdSetBase::create_set(TYPE_BIGINT);
+    for (int64_t i = -500; i < 500; ++i) {
+        int64_t a = i * 3;
+        set->insert(&a);
+        set->insert(&a);
+    }
+    ASSERT_EQ(1000, set->size());
+    for (int64_t i = -1500; i < 1500; ++i) {
+        ASSERT_EQ(i % 3 == 0, set->find(&i)) << i;
+    }
+
+    int num_values = 0;
+    HybirdSetBase::IteratorBase* base = set->begin();
+    while (base->has_next()) {
+        ASSERT_EQ(0, *(int64_t*)base->get_value() % 3);
+        ++num_values;
+        base->next();
+    }
+    ASSERT_EQ(1000, num_values);
+}
+
+TEST_F(HybirdSetTest, large_string) {
+    HybirdSetBase* set = HybirdSetBase::create_set(TYPE_VARCHAR);
+    for (int i = 0; i < 1000; ++i) {
+        std::string str = std::to_string(i * 2);
+        StringValue a(str);
+        set->insert(&a);
+        set->insert(&a);
+    }
+    ASSERT_EQ(1000, set->size());
+    for (int i = 0; i < 2000; ++i) {
+        std::string str = std::to_string(i);
+        StringValue b(str);
+        ASSERT_EQ(i % 2 == 0, set->find(&b)) << i;
+    }
+
+    HybirdSetBase* other = HybirdSetBase::create_set(TYPE_VARCHAR);
+    other->insert(set);
+    ASSERT_EQ(1000, other->size());
+    std::string str = "1998";
+    StringValue c(str);
+    ASSERT_TRUE(other->find(&c));
+    delete other;
+    delete set;
+}
+
 }
 
 int main(int argc, char** argv) {
@@ -186,6 +186,50 @@ TEST_F(JsonFunctionTest, special_char)
     ASSERT_EQ(std::string(res3->GetString()), "v1");
 }
 
+TEST_F(JsonFunctionTest, skip_values)
+{
+    // the value is found by skipping the members and elements before it
+    std::string json_string("{\"a\": {\"x\": \"}]\\\"\", \"y\": [1, {\"b\": 2}]},"
+            " \"b\": [ {\"c\": \"[\"}, [3, 4], {\"d\": 5.5} ], \"e\": null}");
+    rapidjson::Document document;
+    rapidjson::Value* res = JsonFunctions::get_json_object(nullptr, json_string, "$.b[2].d",
+                      JSON_FUN_DOUBLE, &document);
+    ASSERT_EQ(res->GetDouble(), 5.5);
+
+    rapidjson::Document document2;
+    rapidjson::Value* res2 = JsonFunctions::get_json_object(nullptr, json_string, "$.b[1]",
+                      JSON_FUN_STRING, &document2);
+    rapidjson::StringBuffer buf2;
+    rapidjson::Writer<rapidjson::StringBuffer> writer2(buf2);
+    res2->Accept(writer2);
+    ASSERT_EQ(std::string(buf2.GetString()), "[3,4]");
+
+    rapidjson::Document document3;
+    rapidjson::Value* res3 = JsonFunctions::get_json_object(nullptr, json_string, "$.a.x",
+                      JSON_FUN_STRING, &document3);
+    ASSERT_EQ(std::string(res3->GetString()), "}]\"");
+
+    // missing members, out of range indexes and nested lookups into null are null
+    rapidjson::Document document4;
+    ASSERT_TRUE(JsonFunctions::get_json_object(nullptr, json_string, "$.f",
+                JSON_FUN_INT, &document4)->IsNull());
+    rapidjson::Document document5;
+    ASSERT_TRUE(JsonFunctions::get_json_object(nullptr, json_string, "$.b[3]",
+                JSON_FUN_INT, &document5)->IsNull());
+    rapidjson::Document document6;
+    ASSERT_TRUE(JsonFunctions::get_json_object(nullptr, json_string, "$.e.f",
+                JSON_FUN_INT, &document6)->IsNull());
+
+    // a key on an array still collects the members of all of its elements
+    rapidjson::Document document7;
+    rapidjson::Value* res7 = JsonFunctions::get_json_object(nullptr, json_string, "$.b.c",
+                      JSON_FUN_STRING, &document7);
+    rapidjson::StringBuffer buf7;
+    rapidjson::Writer<rapidjson::StringBuffer> writer7(buf7);
+    res7->Accept(writer7);
+    ASSERT_EQ(std::string(buf7.GetString()), "[\"[\"]");
+}
+
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/aggregate_functions.h"
+#include "testutil/function_utils.h"
+#include <gtest/gtest.h>
+
+namespace doris {
+
+class MultiDistinctTest : public testing::Test {
+public:
+    MultiDistinctTest() {}
+};
+
+static StringVal distinct_bigint_of(FunctionContext* ctx, int begin, int end) {
+    StringVal dst;
+    AggregateFunctions::count_or_sum_distinct_numeric_init<BigIntVal>(ctx, &dst);
+    for (int i = begin; i < end; ++i) {
+        // every value twice
+        BigIntVal value(i / 2);
+        AggregateFunctions::count_or_sum_distinct_numeric_update(ctx, value, &dst);
+    }
+    return AggregateFunctions::count_or_sum_distinct_numeric_serialize<BigIntVal>(ctx, dst);
+}
+
+TEST_F(MultiDistinctTest, numeric) {
+    FunctionUtils futil;
+    FunctionContext* ctx = futil.get_fn_ctx();
+
+    for (int num : {0, 1, 10, 100000}) {
+        StringVal dst;
+        AggregateFunctions::count_or_sum_distinct_numeric_init<BigIntVal>(ctx, &dst);
+        StringVal src = distinct_bigint_of(ctx, 0, num);
+        AggregateFunctions::count_or_sum_distinct_numeric_merge<BigIntVal>(ctx, src, &dst);
+        // overlaps with the first half
+        src = distinct_bigint_of(ctx, num / 2, num * 2);
+        AggregateFunctions::count_or_sum_distinct_numeric_merge<BigIntVal>(ctx, src, &dst);
+        ASSERT_EQ(num, AggregateFunctions::count_or_sum_distinct_numeric_finalize<BigIntVal>(
+                ctx, dst).val);
+    }
+
+    StringVal dst;
+    AggregateFunctions::count_or_sum_distinct_numeric_init<BigIntVal>(ctx, &dst);
+    StringVal src = distinct_bigint_of(ctx, 0, 200);
+    AggregateFunctions::count_or_sum_distinct_numeric_merge<BigIntVal>(ctx, src, &dst);
+    ASSERT_EQ(99 * 100 / 2, AggregateFunctions::sum_distinct_bigint_finalize<BigIntVal>(
+            ctx, dst).val);
+}
+
+TEST_F(MultiDistinctTest, string) {
+    FunctionUtils futil;
+    FunctionContext* ctx = futil.get_fn_ctx();
+
+    StringVal dst;
+    AggregateFunctions::count_distinct_string_init(ctx, &dst);
+    for (int part = 0; part < 3; ++part) {
+        StringVal state;
+        AggregateFunctions::count_distinct_string_init(ctx, &state);
+        for (int i = 0; i < 1000; ++i) {
+            std::string str = "value" + std::to_string(part * 500 + i);
+            StringVal value((uint8_t*)str.data(), str.size());
+            AggregateFunctions::count_distinct_string_update(ctx, value, &state);
+        }
+        StringVal src = AggregateFunctions::count_distinct_string_serialize(ctx, state);
+        AggregateFunctions::count_distinct_string_merge(ctx, src, &dst);
+    }
+    ASSERT_EQ(2000, AggregateFunctions::count_distinct_string_finalize(ctx, dst).val);
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
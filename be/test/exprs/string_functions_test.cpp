@@ -157,6 +157,38 @@ TEST_F(StringFunctionsTest, split_part) {
             StringFunctions::split_part(context, StringVal("abcdabda"), StringVal("a"), 4));
 }
 
+TEST_F(StringFunctionsTest, case_and_trim) {
+    doris_udf::FunctionContext* context = new doris_udf::FunctionContext();
+
+    // longer than one 16 byte block, so both the vectorized loop and the tail run
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("hello, world @[`{ 2019年9月 abcxyz")),
+            StringFunctions::lower(context, StringVal("HeLLo, WORLD @[`{ 2019年9月 ABCxyz")));
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("HELLO, WORLD @[`{ 2019年9月 ABCXYZ")),
+            StringFunctions::upper(context, StringVal("HeLLo, WORLD @[`{ 2019年9月 ABCxyz")));
+
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("a  b")),
+            StringFunctions::trim(context, StringVal("                    a  b                  ")));
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("a  b                  ")),
+            StringFunctions::ltrim(context, StringVal("                    a  b                  ")));
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("                    a  b")),
+            StringFunctions::rtrim(context, StringVal("                    a  b                  ")));
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("")),
+            StringFunctions::trim(context, StringVal("                                  ")));
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("")),
+            StringFunctions::rtrim(context, StringVal("                                  ")));
+}
+
+TEST_F(StringFunctionsTest, char_length) {
+    doris_udf::FunctionContext* context = new doris_udf::FunctionContext();
+
+    ASSERT_EQ(IntVal(0), StringFunctions::char_utf8_length(context, StringVal("")));
+    ASSERT_EQ(IntVal(5), StringFunctions::char_utf8_length(context, StringVal("hello")));
+    ASSERT_EQ(IntVal(6), StringFunctions::char_utf8_length(context, StringVal("2019年9月")));
+    ASSERT_EQ(IntVal(24), StringFunctions::char_utf8_length(context,
+            StringVal("2019年9月8日 hello, world 😀")));
+    ASSERT_EQ(IntVal::null(), StringFunctions::char_utf8_length(context, StringVal::null()));
+}
+
 }
 
 int main(int argc, char** argv) {
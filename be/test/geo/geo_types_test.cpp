@@ -180,6 +180,35 @@ TEST_F(GeoTypesTest, polygon_hole_contains) {
     }
 }
 
+TEST_F(GeoTypesTest, prepared_polygon_contains) {
+    const char* wkt = "POLYGON ((10 10, 50 10, 50 50, 10 50, 10 10), (20 20, 40 20, 40 40, 20 40, 20 20))";
+    GeoParseStatus status;
+    std::unique_ptr<GeoShape> polygon(GeoShape::from_wkt(wkt, strlen(wkt), &status));
+    ASSERT_EQ(GEO_PARSE_OK, status);
+    std::unique_ptr<GeoShape> prepared(GeoShape::from_wkt(wkt, strlen(wkt), &status));
+    ASSERT_EQ(GEO_PARSE_OK, status);
+    ((GeoPolygon*)prepared.get())->prepare();
+
+    for (int x = 0; x < 60; ++x) {
+        for (int y = 0; y < 60; ++y) {
+            GeoPoint point;
+            point.from_coord(x + 0.5, y + 0.5);
+            ASSERT_EQ(polygon->contains(&point), prepared->contains(&point))
+                << "x=" << x + 0.5 << ", y=" << y + 0.5;
+        }
+    }
+    {
+        GeoPoint point;
+        point.from_coord(15, 15);
+        ASSERT_TRUE(prepared->contains(&point));
+    }
+    {
+        GeoPoint point;
+        point.from_coord(25, 25);
+        ASSERT_FALSE(prepared->contains(&point));
+    }
+}
+
 TEST_F(GeoTypesTest, circle) {
     GeoCircle circle;
     auto res = circle.init(110.123, 64, 1000);
@@ -50,6 +50,59 @@ TEST_F(WktParseTest, invalid_wkt) {
     ASSERT_EQ(nullptr, shape);
 }
 
+TEST_F(WktParseTest, shapes) {
+    const char* wkts[] = {
+        "POINT (1.5 -2e1)",
+        "  LINESTRING(1 1, 2 2 , 3 3)\n",
+        "POLYGON ((10 10, 50 10, 50 50, 10 50, 10 10), (20 20, 40 20, 40 40, 20 40, 20 20))",
+    };
+    GeoShapeType types[] = { GEO_SHAPE_POINT, GEO_SHAPE_LINE_STRING, GEO_SHAPE_POLYGON };
+    for (int i = 0; i < 3; ++i) {
+        GeoShape* shape = nullptr;
+        auto status = WktParse::parse_wkt(wkts[i], strlen(wkts[i]), &shape);
+        ASSERT_EQ(GEO_PARSE_OK, status) << wkts[i];
+        ASSERT_NE(nullptr, shape);
+        ASSERT_EQ(types[i], shape->type());
+        delete shape;
+    }
+
+    // input is not required to end with '\0'
+    std::string wkt = "POINT(1 2)3";
+    GeoShape* shape = nullptr;
+    auto status = WktParse::parse_wkt(wkt.data(), wkt.size() - 1, &shape);
+    ASSERT_EQ(GEO_PARSE_OK, status);
+    ASSERT_EQ(GEO_SHAPE_POINT, shape->type());
+    ASSERT_DOUBLE_EQ(2, ((GeoPoint*)shape)->y());
+    delete shape;
+}
+
+TEST_F(WktParseTest, invalid_shapes) {
+    {
+        const char* wkt = "POINT(1 2";
+        GeoShape* shape = nullptr;
+        ASSERT_EQ(GEO_PARSE_WKT_SYNTAX_ERROR, WktParse::parse_wkt(wkt, strlen(wkt), &shape));
+        ASSERT_EQ(nullptr, shape);
+    }
+    {
+        const char* wkt = "POINT(+1 2)";
+        GeoShape* shape = nullptr;
+        ASSERT_EQ(GEO_PARSE_WKT_SYNTAX_ERROR, WktParse::parse_wkt(wkt, strlen(wkt), &shape));
+        ASSERT_EQ(nullptr, shape);
+    }
+    {
+        const char* wkt = "POINT(200 2)";
+        GeoShape* shape = nullptr;
+        ASSERT_EQ(GEO_PARSE_COORD_INVALID, WktParse::parse_wkt(wkt, strlen(wkt), &shape));
+        ASSERT_EQ(nullptr, shape);
+    }
+    {
+        const char* wkt = "POLYGON ((10 10, 50 10, 50 50, 10 50))";
+        GeoShape* shape = nullptr;
+        ASSERT_EQ(GEO_PARSE_LOOP_NOT_CLOSED, WktParse::parse_wkt(wkt, strlen(wkt), &shape));
+        ASSERT_EQ(nullptr, shape);
+    }
+}
+
 }
 
 int main(int argc, char* argv[]) {
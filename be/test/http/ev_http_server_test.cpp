@@ -0,0 +1,324 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "http/ev_http_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <set>
+#include <sstream>
+
+#include <event2/buffer.h>
+#include <event2/http.h>
+#include <gtest/gtest.h>
+
+#include "common/logging.h"
+#include "http/http_channel.h"
+#include "http/http_client.h"
+#include "http/http_handler.h"
+#include "http/http_request.h"
+
+namespace doris {
+
+static const int s_port = 29996;
+
+// threads in which handlers are called
+static std::mutex s_lock;
+static std::set<std::thread::id> s_loop_threads;
+static std::set<std::thread::id> s_data_plane_threads;
+
+// GET /loop, handled in the loop which reads the request
+class LoopHandler : public HttpHandler {
+public:
+    void handle(HttpRequest* req) override {
+        {
+            std::lock_guard<std::mutex> l(s_lock);
+            s_loop_threads.insert(std::this_thread::get_id());
+        }
+        in_loop = in_loop && req->event_loop()->in_loop_thread();
+        HttpChannel::send_reply(req, "loop");
+    }
+
+    std::atomic<bool> in_loop {true};
+};
+
+// GET /slow, a data plane handler which blocks until it is released
+class SlowHandler : public HttpHandler {
+public:
+    bool is_data_plane() const override { return true; }
+
+    void handle(HttpRequest* req) override {
+        {
+            std::lock_guard<std::mutex> l(s_lock);
+            s_data_plane_threads.insert(std::this_thread::get_id());
+        }
+        in_loop = req->event_loop()->in_loop_thread();
+        {
+            std::unique_lock<std::mutex> l(_lock);
+            _started = true;
+            _cond.notify_all();
+            _cond.wait_for(l, std::chrono::seconds(10), [this] { return _released; });
+        }
+        HttpChannel::send_reply(req, "slow");
+    }
+
+    void wait_started() {
+        std::unique_lock<std::mutex> l(_lock);
+        _cond.wait_for(l, std::chrono::seconds(10), [this] { return _started; });
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> l(_lock);
+        _released = true;
+        _cond.notify_all();
+    }
+
+    std::atomic<bool> in_loop {true};
+
+private:
+    std::mutex _lock;
+    std::condition_variable _cond;
+    bool _started = false;
+    bool _released = false;
+};
+
+// PUT /upload, a data plane handler whose body is read progressively in the
+// loop, and which replies the number of bytes received
+class UploadHandler : public HttpHandler {
+public:
+    struct UploadCtx {
+        size_t bytes = 0;
+    };
+
+    bool is_data_plane() const override { return true; }
+    bool request_will_be_read_progressively() override { return true; }
+
+    int on_header(HttpRequest* req) override {
+        req->set_handler_ctx(new UploadCtx());
+        return 0;
+    }
+
+    void on_chunk_data(HttpRequest* req) override {
+        if (!req->event_loop()->in_loop_thread()) {
+            chunk_not_in_loop = true;
+        }
+        auto ctx = (UploadCtx*)req->handler_ctx();
+        auto evbuf = evhttp_request_get_input_buffer(req->get_evhttp_request());
+        size_t len = evbuffer_get_length(evbuf);
+        ctx->bytes += len;
+        evbuffer_drain(evbuf, len);
+    }
+
+    void handle(HttpRequest* req) override {
+        if (req->event_loop()->in_loop_thread()) {
+            handled_in_loop = true;
+        }
+        {
+            std::lock_guard<std::mutex> l(s_lock);
+            s_data_plane_threads.insert(std::this_thread::get_id());
+        }
+        auto ctx = (UploadCtx*)req->handler_ctx();
+        HttpChannel::send_reply(req, std::to_string(ctx->bytes));
+    }
+
+    void free_handler_ctx(void* ctx) override {
+        delete (UploadCtx*)ctx;
+    }
+
+    std::atomic<bool> chunk_not_in_loop {false};
+    std::atomic<bool> handled_in_loop {false};
+};
+
+static LoopHandler s_loop_handler;
+static SlowHandler s_slow_handler;
+static UploadHandler s_upload_handler;
+static EvHttpServer* s_server = nullptr;
+
+static Status get(const std::string& path, std::string* response) {
+    HttpClient client;
+    RETURN_IF_ERROR(client.init("http://127.0.0.1:" + std::to_string(s_port) + path));
+    client.set_method(GET);
+    return client.execute(response);
+}
+
+// send a chunked PUT /upload whose body is split into chunks of chunk_sizes,
+// each written separately, and return the body of the response
+static std::string upload_chunked(const std::vector<size_t>& chunk_sizes) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return "";
+    }
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(s_port);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        ::close(fd);
+        return "";
+    }
+    std::vector<std::string> parts;
+    parts.push_back("PUT /upload HTTP/1.1\r\nHost: 127.0.0.1\r\n"
+                    "Transfer-Encoding: chunked\r\nConnection: close\r\n\r\n");
+    for (auto size : chunk_sizes) {
+        std::stringstream ss;
+        ss << std::hex << size << "\r\n" << std::string(size, 'a') << "\r\n";
+        parts.push_back(ss.str());
+    }
+    parts.push_back("0\r\n\r\n");
+    for (auto& part : parts) {
+        size_t sent = 0;
+        while (sent < part.size()) {
+            auto res = ::write(fd, part.data() + sent, part.size() - sent);
+            if (res <= 0) {
+                ::close(fd);
+                return "";
+            }
+            sent += res;
+        }
+        usleep(10 * 1000);
+    }
+    std::string response;
+    char buf[1024];
+    ssize_t res = 0;
+    while ((res = ::read(fd, buf, sizeof(buf))) > 0) {
+        response.append(buf, res);
+    }
+    ::close(fd);
+    if (response.compare(0, 12, "HTTP/1.1 200") != 0) {
+        return response;
+    }
+    auto pos = response.find("\r\n\r\n");
+    return pos == std::string::npos ? "" : response.substr(pos + 4);
+}
+
+class EvHttpServerTest : public testing::Test {
+public:
+    EvHttpServerTest() { }
+    ~EvHttpServerTest() override { }
+
+    static void SetUpTestCase() {
+        // 4 loops and 2 data plane workers
+        s_server = new EvHttpServer(s_port, 4, 2);
+        s_server->register_handler(GET, "/loop", &s_loop_handler);
+        s_server->register_handler(GET, "/slow", &s_slow_handler);
+        s_server->register_handler(PUT, "/upload", &s_upload_handler);
+        ASSERT_TRUE(s_server->start().ok());
+    }
+
+    static void TearDownTestCase() {
+        delete s_server;
+    }
+};
+
+TEST_F(EvHttpServerTest, concurrent_requests) {
+    std::atomic<int> num_failed(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&num_failed] {
+            for (int j = 0; j < 8; ++j) {
+                std::string response;
+                if (!get("/loop", &response).ok() || response != "loop") {
+                    num_failed++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(0, num_failed.load());
+    ASSERT_TRUE(s_loop_handler.in_loop);
+
+    std::lock_guard<std::mutex> l(s_lock);
+    ASSERT_LE(s_loop_threads.size(), 4u);
+    if (s_server->_server_fds.size() > 1) {
+        // with SO_REUSEPORT, the kernel spreads 128 connections among the loops
+        ASSERT_GT(s_loop_threads.size(), 1u);
+    }
+}
+
+TEST_F(EvHttpServerTest, data_plane) {
+    std::string slow_response;
+    Status slow_status;
+    std::thread slow_thread([&slow_response, &slow_status] {
+        slow_status = get("/slow", &slow_response);
+    });
+    s_slow_handler.wait_started();
+
+    // the slow request blocks a data plane worker, not its loop
+    int num_loop_replies = 0;
+    for (int i = 0; i < 16; ++i) {
+        std::string response;
+        if (get("/loop", &response).ok() && response == "loop") {
+            num_loop_replies++;
+        }
+    }
+    // the other data plane worker handles uploads meanwhile
+    std::string upload_response = upload_chunked({1000, 2000});
+
+    s_slow_handler.release();
+    slow_thread.join();
+    ASSERT_EQ(16, num_loop_replies);
+    ASSERT_EQ("3000", upload_response);
+    ASSERT_TRUE(slow_status.ok());
+    ASSERT_EQ("slow", slow_response);
+    ASSERT_FALSE(s_slow_handler.in_loop);
+}
+
+TEST_F(EvHttpServerTest, chunked_upload) {
+    std::vector<std::string> responses(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < responses.size(); ++i) {
+        threads.emplace_back([i, &responses] {
+            responses[i] = upload_chunked({100, 1024 * (i + 1), 10});
+        });
+    }
+    // requests to the loops are served while uploads are in flight
+    for (int i = 0; i < 16; ++i) {
+        std::string response;
+        ASSERT_TRUE(get("/loop", &response).ok());
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (size_t i = 0; i < responses.size(); ++i) {
+        ASSERT_EQ(std::to_string(110 + 1024 * (i + 1)), responses[i]);
+    }
+    // body is read in the loop, and handle() is called in the data plane pool
+    ASSERT_FALSE(s_upload_handler.chunk_not_in_loop);
+    ASSERT_FALSE(s_upload_handler.handled_in_loop);
+
+    std::lock_guard<std::mutex> l(s_lock);
+    ASSERT_LE(s_data_plane_threads.size(), 2u);
+    for (auto& id : s_data_plane_threads) {
+        ASSERT_EQ(0u, s_loop_threads.count(id));
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -92,6 +92,36 @@ TEST_F(HttpUtilsTest, parse_basic_auth) {
     }
 }
 
+TEST_F(HttpUtilsTest, parse_range_header) {
+    int64_t offset = 0;
+    int64_t length = 0;
+    ASSERT_TRUE(parse_range_header("bytes=0-99", 1000, &offset, &length).ok());
+    ASSERT_EQ(0, offset);
+    ASSERT_EQ(100, length);
+    ASSERT_TRUE(parse_range_header("bytes=900-", 1000, &offset, &length).ok());
+    ASSERT_EQ(900, offset);
+    ASSERT_EQ(100, length);
+    ASSERT_TRUE(parse_range_header("bytes=-100", 1000, &offset, &length).ok());
+    ASSERT_EQ(900, offset);
+    ASSERT_EQ(100, length);
+    // end is larger than file size
+    ASSERT_TRUE(parse_range_header("bytes=500-2000", 1000, &offset, &length).ok());
+    ASSERT_EQ(500, offset);
+    ASSERT_EQ(500, length);
+
+    // not satisfiable
+    auto st = parse_range_header("bytes=1000-", 1000, &offset, &length);
+    ASSERT_EQ(TStatusCode::INVALID_ARGUMENT, st.code());
+    st = parse_range_header("bytes=-0", 1000, &offset, &length);
+    ASSERT_EQ(TStatusCode::INVALID_ARGUMENT, st.code());
+
+    // ignored
+    ASSERT_FALSE(parse_range_header("bytes=0-1,5-6", 1000, &offset, &length).ok());
+    ASSERT_FALSE(parse_range_header("items=0-1", 1000, &offset, &length).ok());
+    ASSERT_FALSE(parse_range_header("bytes=10-1", 1000, &offset, &length).ok());
+    ASSERT_FALSE(parse_range_header("bytes=a-", 1000, &offset, &length).ok());
+}
+
 }
 
 int main(int argc, char** argv) {
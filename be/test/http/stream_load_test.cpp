@@ -26,9 +26,12 @@
 #include "exec/schema_scanner/schema_helper.h"
 #include "gen_cpp/HeartbeatService_types.h"
 #include "http/http_channel.h"
+#include "http/http_common.h"
 #include "http/http_request.h"
 #include "runtime/exec_env.h"
 #include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/group_commit_mgr.h"
+#include "runtime/stream_load/stream_load_context.h"
 #include "runtime/stream_load/stream_load_executor.h"
 #include "runtime/thread_resource_mgr.h"
 #include "util/brpc_stub_cache.h"
@@ -83,10 +86,14 @@ public:
         _env._load_stream_mgr = new LoadStreamMgr();
         _env._brpc_stub_cache = new BrpcStubCache();
         _env._stream_load_executor = new StreamLoadExecutor(&_env);
+        config::group_commit_interval_ms = 10;
+        _env._group_commit_mgr = new GroupCommitMgr(&_env);
 
         _evhttp_req = evhttp_request_new(nullptr, nullptr);
     }
     void TearDown() override {
+        delete _env._group_commit_mgr;
+        _env._group_commit_mgr = nullptr;
         delete _env._brpc_stub_cache;
         _env._brpc_stub_cache = nullptr;
         delete _env._load_stream_mgr;
@@ -233,6 +240,32 @@ TEST_F(StreamLoadActionTest, begin_fail) {
     ASSERT_STREQ("Fail", doc["Status"].GetString());
 }
 
+TEST_F(StreamLoadActionTest, group_commit) {
+    DorisMetrics::instance()->initialize("StreamLoadActionTest");
+    StreamLoadAction action(&_env);
+
+    HttpRequest request(_evhttp_req);
+    struct evhttp_request ev_req;
+    ev_req.remote_host = nullptr;
+    request._ev_req = &ev_req;
+    request._headers.emplace(HttpHeaders::AUTHORIZATION, "Basic cm9vdDo=");
+    request._headers.emplace(HttpHeaders::CONTENT_LENGTH, "16");
+    request._headers.emplace(HTTP_GROUP_COMMIT, "true");
+    k_stream_load_begin_result.__set_txnId(1000);
+    action.on_header(&request);
+
+    auto ctx = (StreamLoadContext*)request.handler_ctx();
+    ASSERT_TRUE(ctx->group_commit);
+    ASSERT_TRUE(ctx->body_sink->append("1,2,3\n4,5,6\n7,8,", 16).ok());
+    ctx->receive_bytes = 16;
+    action.handle(&request);
+
+    rapidjson::Document doc;
+    doc.Parse(k_response_str.c_str());
+    ASSERT_STREQ("Success", doc["Status"].GetString());
+    ASSERT_EQ(1000, doc["TxnId"].GetInt64());
+}
+
 #if 0
 TEST_F(StreamLoadActionTest, receive_failed) {
     DorisMetrics::instance()->initialize("StreamLoadActionTest");
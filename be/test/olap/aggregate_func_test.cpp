@@ -21,6 +21,7 @@
 
 #include "olap/decimal12.h"
 #include "olap/uint24.h"
+#include "util/bitmap_value.h"
 
 namespace doris {
 
@@ -377,6 +378,160 @@ TEST_F(AggregateFuncTest, replace) {
     test_replace_string<OLAP_FIELD_TYPE_VARCHAR>();
 }
 
+template<FieldType field_type>
+void test_replace_if_not_null() {
+    using CppType = typename CppTypeTraits<field_type>::CppType;
+
+    char buf[64];
+    RowCursorCell dst(buf);
+
+    Arena arena;
+    const AggregateInfo* agg = get_aggregate_info(
+        OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL, field_type);
+    agg->init(buf, &arena);
+
+    // null
+    {
+        char val_buf[16];
+        *(bool*)val_buf = true;
+        agg->update(&dst, val_buf, &arena);
+        ASSERT_TRUE(*(bool*)(buf));
+    }
+    // 100
+    {
+        char val_buf[16];
+        *(bool*)val_buf = false;
+        CppType val = 100;
+        memcpy(val_buf + 1, &val, sizeof(CppType));
+        agg->update(&dst, val_buf, &arena);
+        ASSERT_FALSE(*(bool*)(buf));
+        memcpy(&val, buf + 1, sizeof(CppType));
+        ASSERT_EQ(100, val);
+    }
+    // null keeps 100
+    {
+        char val_buf[16];
+        *(bool*)val_buf = true;
+        agg->update(&dst, val_buf, &arena);
+        ASSERT_FALSE(*(bool*)(buf));
+        CppType val;
+        memcpy(&val, buf + 1, sizeof(CppType));
+        ASSERT_EQ(100, val);
+    }
+    // 50
+    {
+        char val_buf[16];
+        *(bool*)val_buf = false;
+        CppType val = 50;
+        memcpy(val_buf + 1, &val, sizeof(CppType));
+        agg->update(&dst, val_buf, &arena);
+        ASSERT_FALSE(*(bool*)(buf));
+        memcpy(&val, buf + 1, sizeof(CppType));
+        ASSERT_EQ(50, val);
+    }
+    agg->finalize(buf, &arena);
+    ASSERT_FALSE(*(bool*)(buf));
+    CppType val;
+    memcpy(&val, buf + 1, sizeof(CppType));
+    ASSERT_EQ(50, val);
+}
+
+TEST_F(AggregateFuncTest, replace_if_not_null) {
+    test_replace_if_not_null<OLAP_FIELD_TYPE_INT>();
+    test_replace_if_not_null<OLAP_FIELD_TYPE_LARGEINT>();
+
+    constexpr size_t string_field_size = sizeof(bool) + sizeof(Slice);
+    char dst[string_field_size];
+    RowCursorCell dst_cell(dst);
+    auto dst_slice = reinterpret_cast<Slice*>(dst_cell.mutable_cell_ptr());
+    dst_slice->data = nullptr;
+    dst_slice->size = 0;
+
+    Arena arena;
+    const AggregateInfo* agg = get_aggregate_info(
+        OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL, OLAP_FIELD_TYPE_VARCHAR);
+    agg->init(dst, &arena);
+
+    char src[string_field_size];
+    RowCursorCell src_cell(src);
+    auto src_slice = reinterpret_cast<Slice*>(src_cell.mutable_cell_ptr());
+    src_cell.set_not_null();
+    src_slice->data = (char*)"abc";
+    src_slice->size = 3;
+    agg->update(&dst_cell, src_cell, &arena);
+    ASSERT_FALSE(dst_cell.is_null());
+    ASSERT_STREQ("abc", dst_slice->to_string().c_str());
+
+    src_cell.set_null();
+    agg->update(&dst_cell, src_cell, &arena);
+    ASSERT_FALSE(dst_cell.is_null());
+    ASSERT_STREQ("abc", dst_slice->to_string().c_str());
+}
+
+static Slice serialize_bitmap(BitmapValue* bitmap, Arena* arena) {
+    size_t size = bitmap->serialized_size();
+    char* data = arena->Allocate(size);
+    bitmap->serialize(data);
+    return Slice(data, size);
+}
+
+TEST_F(AggregateFuncTest, bitmap_union) {
+    constexpr size_t string_field_size = sizeof(bool) + sizeof(Slice);
+
+    Arena arena;
+    const AggregateInfo* agg = get_aggregate_info(
+        OLAP_FIELD_AGGREGATION_BITMAP_UNION, OLAP_FIELD_TYPE_VARCHAR);
+
+    char dst[string_field_size];
+    RowCursorCell dst_cell(dst);
+    auto dst_slice = reinterpret_cast<Slice*>(dst_cell.mutable_cell_ptr());
+    agg->init(dst, &arena);
+
+    char src[string_field_size];
+    RowCursorCell src_cell(src);
+    auto src_slice = reinterpret_cast<Slice*>(src_cell.mutable_cell_ptr());
+    // null is ignored
+    {
+        src_cell.set_null();
+        agg->update(&dst_cell, src_cell, &arena);
+        ASSERT_TRUE(dst_cell.is_null());
+    }
+    // single values, with a duplicate
+    for (uint32_t value : {1, 2, 2, 3}) {
+        BitmapValue bitmap(value);
+        src_cell.set_not_null();
+        *src_slice = serialize_bitmap(&bitmap, &arena);
+        agg->update(&dst_cell, src_cell, &arena);
+        ASSERT_FALSE(dst_cell.is_null());
+    }
+    // a bitmap
+    {
+        BitmapValue bitmap;
+        for (uint32_t i = 3; i < 1000; ++i) {
+            bitmap.add(i);
+        }
+        src_cell.set_not_null();
+        *src_slice = serialize_bitmap(&bitmap, &arena);
+        agg->update(&dst_cell, src_cell, &arena);
+    }
+    // invalid input is ignored
+    {
+        src_cell.set_not_null();
+        src_slice->data = (char*)"abc";
+        src_slice->size = 3;
+        agg->update(&dst_cell, src_cell, &arena);
+    }
+    agg->finalize(dst, &arena);
+    ASSERT_FALSE(dst_cell.is_null());
+
+    BitmapValue result;
+    ASSERT_TRUE(result.deserialize(dst_slice->data, dst_slice->size));
+    ASSERT_EQ(999, result.cardinality());
+    ASSERT_FALSE(result.contains(0));
+    ASSERT_TRUE(result.contains(1));
+    ASSERT_TRUE(result.contains(999));
+}
+
 }
 
 int main(int argc, char **argv) {
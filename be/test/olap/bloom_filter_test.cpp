@@ -102,6 +102,56 @@ TEST_F(TestBloomFilter, add_and_test_bytes) {
     ASSERT_TRUE(bf.test_bytes(bytes.c_str(), bytes.size()));
 }
 
+// Add hash values to BlockBloomFilter and verify existence and false positive
+TEST_F(TestBloomFilter, block_bloom_filter) {
+    {
+        BlockBloomFilter bf;
+        ASSERT_TRUE(bf.init(1024, 0.05));
+        ASSERT_EQ(28, bf.num_buckets());
+        ASSERT_EQ(28 * BlockBloomFilter::BUCKET_WORDS, bf.bit_set_data_len());
+        ASSERT_EQ(0, (uintptr_t)bf.bit_set_data() % 64);
+    }
+
+    BlockBloomFilter bf;
+    ASSERT_TRUE(bf.init(10000, 0.05));
+    for (int i = 0; i < 10000; ++i) {
+        bf.add_bytes((const char*)&i, sizeof(i));
+    }
+    bf.add_bytes(nullptr, 0);
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(bf.test_bytes((const char*)&i, sizeof(i)));
+    }
+    ASSERT_TRUE(bf.test_bytes(nullptr, 0));
+    int false_positive = 0;
+    for (int i = 10000; i < 20000; ++i) {
+        if (bf.test_bytes((const char*)&i, sizeof(i))) {
+            false_positive++;
+        }
+    }
+    ASSERT_LT(false_positive, 10000 * 0.1);
+
+    // init with buffer of another filter, buffer is not owned
+    BlockBloomFilter query_bf;
+    ASSERT_TRUE(query_bf.init(bf.bit_set_data(), bf.bit_set_data_len()));
+    for (int i = 0; i < 10000; ++i) {
+        ASSERT_TRUE(query_bf.test_bytes((const char*)&i, sizeof(i)));
+    }
+    query_bf.reset();
+    ASSERT_EQ(nullptr, query_bf.bit_set_data());
+    ASSERT_FALSE(query_bf.init(bf.bit_set_data(), 3));
+
+    // merge filters of the same size
+    BlockBloomFilter new_bf;
+    ASSERT_TRUE(new_bf.init(10000, 0.05));
+    string bytes = "world";
+    new_bf.add_bytes(bytes.c_str(), bytes.size());
+    ASSERT_TRUE(bf.merge(new_bf));
+    ASSERT_TRUE(bf.test_bytes(bytes.c_str(), bytes.size()));
+    BlockBloomFilter small_bf;
+    ASSERT_TRUE(small_bf.init(10, 0.05));
+    ASSERT_FALSE(bf.merge(small_bf));
+}
+
 // Print bloom filter buffer and points of specified string
 TEST_F(TestBloomFilter, bloom_filter_info) {
     string bytes;
@@ -939,6 +939,65 @@ TEST_F(TestDeleteHandler, FilterDataVersion) {
     _delete_handler.finalize();
 }
 
+TEST_F(TestDeleteHandler, CountRowsAfterDelete) {
+    OLAPStatus res;
+    DeleteConditionHandler cond_handler;
+    std::vector<TCondition> conditions;
+
+    // 删除条件：k1=3，版本号为3
+    TCondition condition;
+    condition.column_name = "k1";
+    condition.condition_op = "=";
+    condition.condition_values.clear();
+    condition.condition_values.push_back("3");
+    conditions.push_back(condition);
+
+    DeletePredicatePB del_pred;
+    res = _delete_condition_handler.generate_delete_predicate(tablet->tablet_schema(), conditions, &del_pred);
+    ASSERT_EQ(OLAP_SUCCESS, res);
+    res = tablet->add_delete_predicate(del_pred, 3);
+    ASSERT_EQ(OLAP_SUCCESS, res);
+
+    // 读取版本2时没有删除条件生效，可以直接使用元数据中的行数
+    ASSERT_FALSE(tablet->has_delete_predicate_until(2));
+    // 读取版本3及以后时删除条件生效，元数据中的行数不再准确
+    ASSERT_TRUE(tablet->has_delete_predicate_until(3));
+    ASSERT_TRUE(tablet->has_delete_predicate_until(4));
+
+    res = _delete_handler.init(tablet->tablet_schema(), tablet->delete_predicates(), 3);
+    ASSERT_EQ(OLAP_SUCCESS, res);
+    ASSERT_EQ(1, _delete_handler.conditions_num());
+
+    // 版本2中导入的5行数据，k1分别为1到5
+    int64_t num_rows = 0;
+    int64_t num_left_rows = 0;
+    for (int k1 = 1; k1 <= 5; ++k1) {
+        vector<string> data_str;
+        data_str.push_back(std::to_string(k1));
+        data_str.push_back("6");
+        data_str.push_back("8");
+        data_str.push_back("-1");
+        data_str.push_back("16");
+        data_str.push_back("1.2");
+        data_str.push_back("2014-01-01");
+        data_str.push_back("2014-01-01 00:00:00");
+        data_str.push_back("YWFH");
+        data_str.push_back("YWFH==");
+        data_str.push_back("1");
+        OlapTuple tuple(data_str);
+        res = _data_row_cursor.from_tuple(tuple);
+        ASSERT_EQ(OLAP_SUCCESS, res);
+        ++num_rows;
+        if (!_delete_handler.is_filter_data(2, _data_row_cursor)) {
+            ++num_left_rows;
+        }
+    }
+    ASSERT_EQ(5, num_rows);
+    ASSERT_EQ(4, num_left_rows);
+
+    _delete_handler.finalize();
+}
+
 }  // namespace doris
 
 int main(int argc, char** argv) {
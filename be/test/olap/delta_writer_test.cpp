@@ -33,6 +33,7 @@
 #include "util/logging.h"
 #include "olap/options.h"
 #include "olap/tablet_meta_manager.h"
+#include "runtime/mem_tracker.h"
 
 namespace doris {
 
@@ -329,8 +330,9 @@ TEST_F(TestDeltaWriter, write) {
     load_id.set_lo(0);
     WriteRequest write_req = {10004, 270068376, WriteType::LOAD,
                               20002, 30002, load_id, false, tuple_desc};
+    MemTracker mem_tracker(-1, "delta_writer");
     DeltaWriter* delta_writer = nullptr;
-    DeltaWriter::open(&write_req, &delta_writer); 
+    DeltaWriter::open(&write_req, &delta_writer, &mem_tracker);
     ASSERT_NE(delta_writer, nullptr);
 
     const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
@@ -392,6 +394,8 @@ TEST_F(TestDeltaWriter, write) {
 
     res = delta_writer->close(nullptr);
     ASSERT_EQ(OLAP_SUCCESS, res);
+    // all the bytes consumed by memtables are released after they are flushed
+    ASSERT_EQ(0, mem_tracker.consumption());
 
     // publish version success
     TabletSharedPtr tablet = k_engine->tablet_manager()->get_tablet(write_req.tablet_id, write_req.schema_hash);
@@ -100,6 +100,38 @@ TEST_F(FileHandlerTest, TestWrite) {
     }
 }
 
+TEST_F(FileHandlerTest, TestCachedRandomAccessFile) {
+    std::string file_name = _s_test_data_path + "/cached_file.txt";
+    FileHandler file_handler;
+    ASSERT_EQ(OLAP_SUCCESS, file_handler.open_with_mode(file_name,
+            O_CREAT | O_EXCL | O_WRONLY, S_IRUSR | S_IWUSR));
+    ASSERT_EQ(OLAP_SUCCESS, file_handler.write("0123456789", 10));
+    ASSERT_EQ(OLAP_SUCCESS, file_handler.close());
+
+    Cache* cache = new_lru_cache(10);
+    FileHandler::set_fd_cache(cache);
+    {
+        std::unique_ptr<RandomAccessFile> file1;
+        ASSERT_TRUE(CachedRandomAccessFile::open(file_name, &file1).ok());
+        std::unique_ptr<RandomAccessFile> file2;
+        ASSERT_TRUE(CachedRandomAccessFile::open(file_name, &file2).ok());
+
+        uint64_t size = 0;
+        ASSERT_TRUE(file2->size(&size).ok());
+        ASSERT_EQ(10U, size);
+        char buf1[3];
+        char buf2[4];
+        Slice slices[2] = {Slice(buf1, 3), Slice(buf2, 4)};
+        ASSERT_TRUE(file1->readv_at(2, slices, 2).ok());
+        ASSERT_EQ("234", std::string(buf1, 3));
+        ASSERT_EQ("5678", std::string(buf2, 4));
+        // read beyond the end of file
+        ASSERT_FALSE(file2->read_at(8, Slice(buf2, 4)).ok());
+    }
+    FileHandler::set_fd_cache(nullptr);
+    delete cache;
+}
+
 }  // namespace doris
 
 int main(int argc, char **argv) {
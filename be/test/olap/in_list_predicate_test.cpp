@@ -190,6 +190,58 @@ TEST_IN_LIST_PREDICATE(int32_t, INT, "INT")
 TEST_IN_LIST_PREDICATE(int64_t, BIGINT, "BIGINT")
 TEST_IN_LIST_PREDICATE(int128_t, LARGEINT, "LARGEINT")
 
+TEST_F(TestInListPredicate, LARGE_IN_LIST) {
+    TabletSchema tablet_schema;
+    SetTabletSchema(std::string("LARGE_IN_LIST"), "INT",
+                 "REPLACE", 1, false, true, &tablet_schema);
+    // rows are more than one evaluating block
+    int size = 1000;
+    std::vector<uint32_t> return_columns;
+    for (int i = 0; i < tablet_schema.num_columns(); ++i) {
+        return_columns.push_back(i);
+    }
+    InitVectorizedBatch(&tablet_schema, return_columns, size);
+    ColumnVector* col_vector = _vectorized_batch->column(0);
+
+    // for no nulls
+    col_vector->set_no_nulls(true);
+    int32_t* col_data = reinterpret_cast<int32_t*>(_mem_pool->allocate(size * sizeof(int32_t)));
+    col_vector->set_col_data(col_data);
+    for (int i = 0; i < size; ++i) {
+        *(col_data + i) = i;
+    }
+    // values are more than the ones probed linearly
+    std::set<int32_t> values;
+    for (int i = 0; i < 20; ++i) {
+        values.insert(i * 50);
+    }
+    ColumnPredicate* pred = new InListPredicate<int32_t>(0, std::move(values));
+    pred->evaluate(_vectorized_batch);
+    ASSERT_EQ(_vectorized_batch->size(), 20);
+    uint16_t* sel = _vectorized_batch->selected();
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(*(col_data + sel[i]), i * 50);
+    }
+
+    // for has nulls
+    col_vector->set_no_nulls(false);
+    bool* is_null = reinterpret_cast<bool*>(_mem_pool->allocate(size));
+    memset(is_null, 0, size);
+    col_vector->set_is_null(is_null);
+    for (int i = 0; i < size; ++i) {
+        is_null[i] = (i % 100 == 0);
+    }
+    _vectorized_batch->set_size(size);
+    _vectorized_batch->set_selected_in_use(false);
+    pred->evaluate(_vectorized_batch);
+    ASSERT_EQ(_vectorized_batch->size(), 10);
+    sel = _vectorized_batch->selected();
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(*(col_data + sel[i]), i * 100 + 50);
+    }
+    delete pred;
+}
+
 TEST_F(TestInListPredicate, FLOAT_COLUMN) {
     TabletSchema tablet_schema;
     SetTabletSchema(std::string("FLOAT_COLUMN"), "FLOAT",
@@ -0,0 +1,121 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "olap/io_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+#include "util/time.h"
+
+namespace doris {
+
+class IOSchedulerTest : public testing::Test {
+public:
+    void TearDown() override {
+        config::data_dir_compaction_io_mbytes_per_sec = 0;
+        config::data_dir_compaction_io_mbytes_per_sec_on_query = 0;
+        config::data_dir_load_io_mbytes_per_sec = 0;
+        config::path_gc_files_per_sec = 0;
+        config::path_gc_files_per_sec_on_query = 0;
+        config::storage_migration_io_mbytes_per_sec = 0;
+    }
+};
+
+TEST_F(IOSchedulerTest, no_limit) {
+    config::path_gc_files_per_sec = 0;
+    IOScheduler scheduler;
+    int64_t start_us = MonotonicMicros();
+    for (int i = 0; i < 100; ++i) {
+        scheduler.acquire(IOClass::COMPACTION, 1024 * 1024 * 1024);
+        scheduler.acquire(IOClass::LOAD, 1024 * 1024 * 1024);
+        scheduler.acquire(IOClass::GC, 1000 * 1000);
+    }
+    ASSERT_LT(MonotonicMicros() - start_us, 1000 * 1000);
+}
+
+TEST_F(IOSchedulerTest, limit_rate) {
+    config::data_dir_compaction_io_mbytes_per_sec = 10;
+    IOScheduler scheduler;
+    int64_t start_us = MonotonicMicros();
+    // first second of IO is allowed at once, then 5MB needs 500ms
+    scheduler.acquire(IOClass::COMPACTION, 10 * 1024 * 1024);
+    ASSERT_LT(MonotonicMicros() - start_us, 100 * 1000);
+    scheduler.acquire(IOClass::COMPACTION, 5 * 1024 * 1024);
+    ASSERT_GE(MonotonicMicros() - start_us, 400 * 1000);
+
+    // rate of other class is not affected
+    start_us = MonotonicMicros();
+    scheduler.acquire(IOClass::LOAD, 100 * 1024 * 1024);
+    ASSERT_LT(MonotonicMicros() - start_us, 100 * 1000);
+}
+
+TEST_F(IOSchedulerTest, yield_to_query) {
+    config::data_dir_compaction_io_mbytes_per_sec_on_query = 10;
+    IOScheduler scheduler;
+    ASSERT_FALSE(scheduler.is_query_active());
+    int64_t start_us = MonotonicMicros();
+    scheduler.acquire(IOClass::COMPACTION, 100 * 1024 * 1024);
+    ASSERT_LT(MonotonicMicros() - start_us, 100 * 1000);
+
+    scheduler.record_query_io(0);
+    ASSERT_FALSE(scheduler.is_query_active());
+    scheduler.record_query_io(4096);
+    ASSERT_TRUE(scheduler.is_query_active());
+    start_us = MonotonicMicros();
+    scheduler.acquire(IOClass::COMPACTION, 15 * 1024 * 1024);
+    ASSERT_GE(MonotonicMicros() - start_us, 400 * 1000);
+}
+
+TEST_F(IOSchedulerTest, migration_yield_to_query) {
+    config::storage_migration_io_mbytes_per_sec = 100;
+    config::data_dir_compaction_io_mbytes_per_sec_on_query = 10;
+    IOScheduler scheduler;
+    int64_t start_us = MonotonicMicros();
+    scheduler.acquire(IOClass::MIGRATION, 100 * 1024 * 1024);
+    ASSERT_LT(MonotonicMicros() - start_us, 100 * 1000);
+
+    scheduler.record_query_io(4096);
+    start_us = MonotonicMicros();
+    scheduler.acquire(IOClass::MIGRATION, 15 * 1024 * 1024);
+    ASSERT_GE(MonotonicMicros() - start_us, 400 * 1000);
+}
+
+TEST_F(IOSchedulerTest, gc_files) {
+    config::path_gc_files_per_sec = 1000;
+    config::path_gc_files_per_sec_on_query = 100;
+    IOScheduler scheduler;
+    int64_t start_us = MonotonicMicros();
+    for (int i = 0; i < 1500; ++i) {
+        scheduler.acquire(IOClass::GC, 1);
+    }
+    ASSERT_GE(MonotonicMicros() - start_us, 400 * 1000);
+
+    // gc yields to queries
+    scheduler.record_query_io(4096);
+    start_us = MonotonicMicros();
+    for (int i = 0; i < 50; ++i) {
+        scheduler.acquire(IOClass::GC, 1);
+    }
+    ASSERT_GE(MonotonicMicros() - start_us, 400 * 1000);
+}
+
+} // namespace doris
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -15,6 +15,7 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -234,6 +235,134 @@ TEST_F(CacheTest, NewId) {
     ASSERT_NE(a, b);
 }
 
+static void noop_deleter(const CacheKey& key, void* value) {
+}
+
+static void insert_shard(LRUCache* shard, int key, CachePriority priority = CachePriority::NORMAL) {
+    std::string result;
+    shard->release(shard->insert(EncodeKey(&result, key), key, EncodeValue(key), 1,
+                                 &noop_deleter, priority));
+}
+
+static bool lookup_shard(LRUCache* shard, int key) {
+    std::string result;
+    Cache::Handle* handle = shard->lookup(EncodeKey(&result, key), key);
+    if (handle == nullptr) {
+        return false;
+    }
+    shard->release(handle);
+    return true;
+}
+
+TEST(LRUCacheShardTest, ScanResistant) {
+    for (uint32_t cold_percent : {0, 50}) {
+        LRUCache shard;
+        shard.set_capacity(100);
+        shard.set_cold_percent(cold_percent);
+
+        // entries accessed twice
+        for (int i = 0; i < 10; ++i) {
+            insert_shard(&shard, i);
+            ASSERT_TRUE(lookup_shard(&shard, i));
+        }
+        // a scan accessing every entry only once
+        for (int i = 1000; i < 2000; ++i) {
+            insert_shard(&shard, i);
+        }
+        for (int i = 0; i < 10; ++i) {
+            // with plain LRU, the scan flushes hot entries
+            ASSERT_EQ(cold_percent != 0, lookup_shard(&shard, i));
+        }
+        ASSERT_LE(shard.get_usage(), 100);
+    }
+}
+
+TEST(LRUCacheShardTest, HotCapacity) {
+    LRUCache shard;
+    shard.set_capacity(100);
+    shard.set_cold_percent(30);
+    for (int i = 0; i < 100; ++i) {
+        insert_shard(&shard, i);
+        ASSERT_TRUE(lookup_shard(&shard, i));
+    }
+    // entries are promoted when the hand passes them
+    ASSERT_EQ(0, shard.get_hot_usage());
+    ASSERT_EQ(100, shard.get_usage());
+
+    // the hand promotes the referenced entries and demotes the oldest hot
+    // entries to cold ring, then new entries evict the demoted entries first
+    for (int i = 100; i < 130; ++i) {
+        insert_shard(&shard, i);
+    }
+    ASSERT_EQ(70, shard.get_hot_usage());
+    ASSERT_EQ(100, shard.get_usage());
+    ASSERT_FALSE(lookup_shard(&shard, 0));
+    ASSERT_TRUE(lookup_shard(&shard, 99));
+}
+
+TEST(LRUCacheShardTest, Prefetch) {
+    LRUCache shard;
+    shard.set_capacity(100);
+    shard.set_cold_percent(50);
+    insert_shard(&shard, 1, CachePriority::PREFETCH);
+    insert_shard(&shard, 2, CachePriority::PREFETCH);
+    // first access of prefetched entry does not count
+    ASSERT_TRUE(lookup_shard(&shard, 1));
+    ASSERT_TRUE(lookup_shard(&shard, 2));
+    ASSERT_TRUE(lookup_shard(&shard, 2));
+    for (int i = 1000; i < 1200; ++i) {
+        insert_shard(&shard, i);
+    }
+    ASSERT_FALSE(lookup_shard(&shard, 1));
+    ASSERT_TRUE(lookup_shard(&shard, 2));
+    ASSERT_EQ(1, shard.get_hot_usage());
+}
+
+TEST(LRUCacheShardTest, InUse) {
+    LRUCache shard;
+    shard.set_capacity(10);
+    std::string result;
+    Cache::Handle* handle = shard.insert(EncodeKey(&result, 0), 0, EncodeValue(0), 1,
+                                         &noop_deleter);
+    // the hand passes entries in use
+    for (int i = 1; i < 100; ++i) {
+        insert_shard(&shard, i);
+    }
+    ASSERT_TRUE(lookup_shard(&shard, 0));
+    ASSERT_EQ(10, shard.get_usage());
+    ASSERT_EQ(9, shard.prune());
+    shard.release(handle);
+    ASSERT_EQ(1, shard.prune());
+    ASSERT_EQ(0, shard.get_usage());
+}
+
+TEST(LRUCacheShardTest, Concurrent) {
+    LRUCache shard;
+    shard.set_capacity(64);
+    shard.set_cold_percent(50);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&shard, t]() {
+            for (int i = 0; i < 10000; ++i) {
+                int key = (i * 7 + t) % 128;
+                std::string result;
+                Cache::Handle* handle = shard.lookup(EncodeKey(&result, key), key);
+                if (handle == nullptr) {
+                    insert_shard(&shard, key);
+                } else {
+                    ASSERT_EQ(key, DecodeValue(reinterpret_cast<LRUHandle*>(handle)->value));
+                    shard.release(handle);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_LE(shard.get_usage(), 64);
+    ASSERT_LE(shard.get_hot_usage(), 32);
+}
+
 }  // namespace doris
 
 int main(int argc, char** argv) {
@@ -93,6 +93,30 @@ TEST_F(OlapMetaTest, TestRemove) {
     ASSERT_EQ(OLAP_SUCCESS, s);
 }
 
+TEST_F(OlapMetaTest, TestSyncScope) {
+    std::string value = "value";
+    {
+        OlapMetaSyncScope sync_scope;
+        for (int i = 0; i < 10; i++) {
+            OLAPStatus s = _meta->put(META_COLUMN_FAMILY_INDEX, "sync_key_" + std::to_string(i), value);
+            ASSERT_EQ(OLAP_SUCCESS, s);
+        }
+        OLAPStatus s = _meta->remove(META_COLUMN_FAMILY_INDEX, "sync_key_0");
+        ASSERT_EQ(OLAP_SUCCESS, s);
+        ASSERT_EQ(OLAP_SUCCESS, sync_scope.finish());
+        // finish twice is ok
+        ASSERT_EQ(OLAP_SUCCESS, sync_scope.finish());
+    }
+    std::string value_get;
+    OLAPStatus s = _meta->get(META_COLUMN_FAMILY_INDEX, "sync_key_0", &value_get);
+    ASSERT_EQ(OLAP_ERR_META_KEY_NOT_FOUND, s);
+    for (int i = 1; i < 10; i++) {
+        s = _meta->get(META_COLUMN_FAMILY_INDEX, "sync_key_" + std::to_string(i), &value_get);
+        ASSERT_EQ(OLAP_SUCCESS, s);
+        ASSERT_EQ(value, value_get);
+    }
+}
+
 TEST_F(OlapMetaTest, TestIterate) {
     // normal cases
     std::string key = "hdr_key";
@@ -0,0 +1,432 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/primary_key_index.h"
+
+#include <unistd.h>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gen_cpp/AgentService_types.h"
+#include "olap/data_dir.h"
+#include "olap/delete_handler.h"
+#include "olap/olap_cond.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/alpha_rowset.h"
+#include "olap/rowset/alpha_rowset_writer.h"
+#include "olap/rowset/rowset_reader_context.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/tablet_manager.h"
+#include "olap/utils.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/logging.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+
+StorageEngine* k_engine = nullptr;
+
+void set_up() {
+    config::path_gc_check = false;
+    // the pool building indexes of tablets is created when the engine starts
+    config::enable_merge_on_write = true;
+    char buffer[MAX_PATH_LEN];
+    getcwd(buffer, MAX_PATH_LEN);
+    config::storage_root_path = std::string(buffer) + "/data_primary_key_index_test";
+    remove_all_dir(config::storage_root_path);
+    ASSERT_EQ(OLAP_SUCCESS, create_dir(config::storage_root_path));
+    std::string rowset_path = config::storage_root_path + "/data/0/12345/1111";
+    ASSERT_EQ(OLAP_SUCCESS, create_dirs(rowset_path));
+    std::vector<StorePath> paths;
+    paths.emplace_back(config::storage_root_path, -1);
+
+    doris::EngineOptions options;
+    options.store_paths = paths;
+    doris::StorageEngine::open(options, &k_engine);
+}
+
+void tear_down() {
+    delete k_engine;
+    k_engine = nullptr;
+    remove_all_dir(config::storage_root_path);
+    remove_all_dir(std::string(getenv("DORIS_HOME")) + UNUSED_PREFIX);
+    config::enable_merge_on_write = false;
+}
+
+// UNIQUE_KEYS schema of (k1 INT, k2 VARCHAR, v1 INT REPLACE)
+void create_tablet_schema(TabletSchema* tablet_schema) {
+    TabletSchemaPB tablet_schema_pb;
+    tablet_schema_pb.set_keys_type(UNIQUE_KEYS);
+    tablet_schema_pb.set_num_short_key_columns(2);
+    tablet_schema_pb.set_num_rows_per_row_block(1024);
+    tablet_schema_pb.set_compress_kind(COMPRESS_NONE);
+    tablet_schema_pb.set_next_column_unique_id(4);
+
+    ColumnPB* column_1 = tablet_schema_pb.add_column();
+    column_1->set_unique_id(1);
+    column_1->set_name("k1");
+    column_1->set_type("INT");
+    column_1->set_is_key(true);
+    column_1->set_length(4);
+    column_1->set_index_length(4);
+    column_1->set_is_nullable(true);
+    column_1->set_is_bf_column(false);
+
+    ColumnPB* column_2 = tablet_schema_pb.add_column();
+    column_2->set_unique_id(2);
+    column_2->set_name("k2");
+    column_2->set_type("VARCHAR");
+    column_2->set_length(20);
+    column_2->set_index_length(20);
+    column_2->set_is_key(true);
+    column_2->set_is_nullable(true);
+    column_2->set_is_bf_column(false);
+
+    ColumnPB* column_3 = tablet_schema_pb.add_column();
+    column_3->set_unique_id(3);
+    column_3->set_name("v1");
+    column_3->set_type("INT");
+    column_3->set_length(4);
+    column_3->set_is_key(false);
+    column_3->set_is_nullable(false);
+    column_3->set_is_bf_column(false);
+    column_3->set_aggregation("REPLACE");
+
+    tablet_schema->init_from_pb(tablet_schema_pb);
+}
+
+class PrimaryKeyIndexTest : public testing::Test {
+public:
+    virtual void SetUp() {
+        set_up();
+        _data_dir = k_engine->get_store(config::storage_root_path);
+        ASSERT_TRUE(_data_dir != nullptr);
+        create_tablet_schema(&_tablet_schema);
+        _mem_tracker.reset(new MemTracker(-1));
+        _mem_pool.reset(new MemPool(_mem_tracker.get()));
+    }
+
+    virtual void TearDown() {
+        tear_down();
+    }
+
+    // Write rows of keys [start_key, end_key) with value 'value' to a rowset
+    RowsetSharedPtr write_rowset(RowsetId rowset_id, Version version,
+                                 int32_t start_key, int32_t end_key, int32_t value) {
+        RowsetWriterContext context;
+        context.rowset_id = rowset_id;
+        context.tablet_id = 12345;
+        context.tablet_schema_hash = 1111;
+        context.partition_id = 10;
+        context.rowset_type = ALPHA_ROWSET;
+        context.rowset_path_prefix = config::storage_root_path + "/data/0/12345/1111";
+        context.rowset_state = VISIBLE;
+        context.data_dir = _data_dir;
+        context.tablet_schema = &_tablet_schema;
+        context.version = version;
+        context.version_hash = 110;
+        AlphaRowsetWriter rowset_writer;
+        rowset_writer.init(context);
+        RowCursor row;
+        row.init(_tablet_schema);
+        for (int32_t key = start_key; key < end_key; ++key) {
+            row.set_field_content(0, reinterpret_cast<char*>(&key), _mem_pool.get());
+            Slice field_1("well");
+            row.set_field_content(1, reinterpret_cast<char*>(&field_1), _mem_pool.get());
+            row.set_field_content(2, reinterpret_cast<char*>(&value), _mem_pool.get());
+            rowset_writer.add_row(row);
+        }
+        rowset_writer.flush();
+        RowsetSharedPtr rowset = rowset_writer.build();
+        if (rowset != nullptr) {
+            rowset->load();
+        }
+        return rowset;
+    }
+
+    // Read keys of 'rowset' as a query of 'version' skipping rows in 'snapshot'
+    std::vector<int32_t> read_keys(const RowsetSharedPtr& rowset,
+                                   const DeleteBitmapSnapshot* snapshot, int64_t version) {
+        std::vector<uint32_t> return_columns;
+        for (uint32_t i = 0; i < _tablet_schema.num_columns(); ++i) {
+            return_columns.push_back(i);
+        }
+        DeleteHandler delete_handler;
+        std::set<uint32_t> load_bf_columns;
+        std::vector<ColumnPredicate*> predicates;
+        Conditions conditions;
+        conditions.set_tablet_schema(&_tablet_schema);
+        OlapReaderStatistics stats;
+        RowsetReaderContext context;
+        context.reader_type = READER_QUERY;
+        context.tablet_schema = &_tablet_schema;
+        context.return_columns = &return_columns;
+        context.seek_columns = &return_columns;
+        context.load_bf_columns = &load_bf_columns;
+        context.conditions = &conditions;
+        context.predicates = &predicates;
+        context.delete_handler = &delete_handler;
+        context.delete_bitmaps = snapshot;
+        context.delete_bitmap_version = version;
+        context.stats = &stats;
+        context.lru_cache = k_engine->index_stream_lru_cache();
+
+        std::vector<int32_t> keys;
+        RowsetReaderSharedPtr rowset_reader = rowset->create_reader();
+        EXPECT_EQ(OLAP_SUCCESS, rowset_reader->init(&context));
+        RowCursor row;
+        row.init(_tablet_schema);
+        RowBlock* block = nullptr;
+        while (rowset_reader->next_block(&block) == OLAP_SUCCESS && block != nullptr) {
+            for (size_t i = 0; i < block->remaining(); ++i) {
+                block->get_row(i, &row);
+                keys.push_back(*reinterpret_cast<int32_t*>(row.cell_ptr(0)));
+            }
+        }
+        return keys;
+    }
+
+    // Row ids of 'rowset' in 'snapshot' superseded by versions not greater than 'version'
+    static std::set<uint32_t> deleted_rows(const DeleteBitmapSnapshot& snapshot,
+                                           const RowsetSharedPtr& rowset, int64_t version) {
+        std::set<uint32_t> rows;
+        for (auto& it : snapshot) {
+            if (std::get<0>(it.first) != rowset->rowset_id()) {
+                continue;
+            }
+            for (auto& row : *it.second) {
+                if (row.second <= version) {
+                    rows.insert(row.first);
+                }
+            }
+        }
+        return rows;
+    }
+
+    static std::set<uint32_t> row_range(uint32_t start, uint32_t end) {
+        std::set<uint32_t> rows;
+        for (uint32_t i = start; i < end; ++i) {
+            rows.insert(i);
+        }
+        return rows;
+    }
+
+protected:
+    DataDir* _data_dir = nullptr;
+    TabletSchema _tablet_schema;
+    std::unique_ptr<MemTracker> _mem_tracker;
+    std::unique_ptr<MemPool> _mem_pool;
+};
+
+TEST_F(PrimaryKeyIndexTest, AddRowsetMarksSupersededRows) {
+    RowsetSharedPtr rowset_0 = write_rowset(10000, {0, 0}, 0, 10, 0);
+    RowsetSharedPtr rowset_1 = write_rowset(10001, {1, 1}, 5, 15, 1);
+    ASSERT_TRUE(rowset_0 != nullptr);
+    ASSERT_TRUE(rowset_1 != nullptr);
+
+    PrimaryKeyIndex index(&_tablet_schema);
+    ASSERT_EQ(-1, index.max_version());
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_0));
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_1));
+    ASSERT_EQ(1, index.max_version());
+    ASSERT_EQ(15u, index.num_keys());
+
+    DeleteBitmapSnapshot snapshot;
+    ASSERT_TRUE(index.capture_delete_bitmaps({rowset_0, rowset_1}, &snapshot));
+    // keys [5, 10) of version 0 are superseded by version 1
+    ASSERT_EQ(row_range(5, 10), deleted_rows(snapshot, rowset_0, 1));
+    ASSERT_TRUE(deleted_rows(snapshot, rowset_0, 0).empty());
+    ASSERT_TRUE(deleted_rows(snapshot, rowset_1, 1).empty());
+}
+
+TEST_F(PrimaryKeyIndexTest, RejectNonContiguousVersion) {
+    RowsetSharedPtr rowset_0 = write_rowset(10000, {0, 0}, 0, 10, 0);
+    RowsetSharedPtr rowset_2 = write_rowset(10002, {2, 2}, 0, 10, 2);
+    ASSERT_TRUE(rowset_0 != nullptr);
+    ASSERT_TRUE(rowset_2 != nullptr);
+
+    PrimaryKeyIndex index(&_tablet_schema);
+    ASSERT_EQ(OLAP_ERR_VERSION_NOT_EXIST, index.add_rowset(rowset_2));
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_0));
+    ASSERT_EQ(OLAP_ERR_VERSION_NOT_EXIST, index.add_rowset(rowset_2));
+    ASSERT_EQ(0, index.max_version());
+
+    // the rowset isn't indexed, so bitmaps of it can't be captured
+    DeleteBitmapSnapshot snapshot;
+    ASSERT_FALSE(index.capture_delete_bitmaps({rowset_0, rowset_2}, &snapshot));
+    ASSERT_TRUE(index.covers({rowset_0}));
+    ASSERT_FALSE(index.covers({rowset_0, rowset_2}));
+}
+
+TEST_F(PrimaryKeyIndexTest, CapturedBitmapsAreImmutable) {
+    RowsetSharedPtr rowset_0 = write_rowset(10000, {0, 0}, 0, 10, 0);
+    RowsetSharedPtr rowset_1 = write_rowset(10001, {1, 1}, 5, 15, 1);
+    RowsetSharedPtr rowset_2 = write_rowset(10002, {2, 2}, 0, 3, 2);
+    ASSERT_TRUE(rowset_0 != nullptr);
+    ASSERT_TRUE(rowset_1 != nullptr);
+    ASSERT_TRUE(rowset_2 != nullptr);
+
+    PrimaryKeyIndex index(&_tablet_schema);
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_0));
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_1));
+    DeleteBitmapSnapshot old_snapshot;
+    ASSERT_TRUE(index.capture_delete_bitmaps({rowset_0, rowset_1}, &old_snapshot));
+
+    // a later load doesn't change bitmaps captured before it
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_2));
+    ASSERT_EQ(row_range(5, 10), deleted_rows(old_snapshot, rowset_0, 2));
+
+    DeleteBitmapSnapshot new_snapshot;
+    ASSERT_TRUE(index.capture_delete_bitmaps({rowset_0, rowset_1, rowset_2}, &new_snapshot));
+    std::set<uint32_t> expected = row_range(0, 3);
+    for (uint32_t row : row_range(5, 10)) {
+        expected.insert(row);
+    }
+    ASSERT_EQ(expected, deleted_rows(new_snapshot, rowset_0, 2));
+    // superseded rows are visible to reads of former versions
+    ASSERT_EQ(row_range(5, 10), deleted_rows(new_snapshot, rowset_0, 1));
+}
+
+TEST_F(PrimaryKeyIndexTest, ReplaceRowsetsAfterCompaction) {
+    RowsetSharedPtr rowset_0 = write_rowset(10000, {0, 0}, 0, 10, 0);
+    RowsetSharedPtr rowset_1 = write_rowset(10001, {1, 1}, 5, 15, 1);
+    RowsetSharedPtr rowset_2 = write_rowset(10002, {2, 2}, 0, 3, 2);
+    // the output of compacting versions 0 and 1, keys [0, 15)
+    RowsetSharedPtr output_rowset = write_rowset(10003, {0, 1}, 0, 15, 1);
+    ASSERT_TRUE(rowset_0 != nullptr);
+    ASSERT_TRUE(rowset_1 != nullptr);
+    ASSERT_TRUE(rowset_2 != nullptr);
+    ASSERT_TRUE(output_rowset != nullptr);
+
+    PrimaryKeyIndex index(&_tablet_schema);
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_0));
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_1));
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_2));
+    ASSERT_EQ(OLAP_SUCCESS, index.replace_rowsets({rowset_0, rowset_1}, output_rowset));
+    ASSERT_EQ(2, index.max_version());
+    ASSERT_EQ(15u, index.num_keys());
+    ASSERT_TRUE(index.covers({output_rowset, rowset_2}));
+
+    // compacted rowsets are not indexed any more
+    DeleteBitmapSnapshot snapshot;
+    ASSERT_FALSE(index.capture_delete_bitmaps({rowset_0, rowset_1, rowset_2}, &snapshot));
+
+    // keys [0, 3) of the output are superseded by version 2 out of the compaction
+    snapshot.clear();
+    ASSERT_TRUE(index.capture_delete_bitmaps({output_rowset, rowset_2}, &snapshot));
+    ASSERT_EQ(row_range(0, 3), deleted_rows(snapshot, output_rowset, 2));
+    ASSERT_TRUE(deleted_rows(snapshot, output_rowset, 1).empty());
+
+    // later loads supersede rows of the output
+    RowsetSharedPtr rowset_3 = write_rowset(10004, {3, 3}, 10, 12, 3);
+    ASSERT_TRUE(rowset_3 != nullptr);
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_3));
+    snapshot.clear();
+    ASSERT_TRUE(index.capture_delete_bitmaps({output_rowset, rowset_2, rowset_3}, &snapshot));
+    std::set<uint32_t> expected = row_range(0, 3);
+    expected.insert(10);
+    expected.insert(11);
+    ASSERT_EQ(expected, deleted_rows(snapshot, output_rowset, 3));
+}
+
+TEST_F(PrimaryKeyIndexTest, ReadSkipsDeletedRows) {
+    RowsetSharedPtr rowset_0 = write_rowset(10000, {0, 0}, 0, 10, 0);
+    RowsetSharedPtr rowset_1 = write_rowset(10001, {1, 1}, 5, 15, 1);
+    ASSERT_TRUE(rowset_0 != nullptr);
+    ASSERT_TRUE(rowset_1 != nullptr);
+
+    PrimaryKeyIndex index(&_tablet_schema);
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_0));
+    ASSERT_EQ(OLAP_SUCCESS, index.add_rowset(rowset_1));
+    DeleteBitmapSnapshot snapshot;
+    ASSERT_TRUE(index.capture_delete_bitmaps({rowset_0, rowset_1}, &snapshot));
+
+    // a read of version 1 gets keys [0, 5) from version 0 and all from version 1
+    std::vector<int32_t> expected = {0, 1, 2, 3, 4};
+    ASSERT_EQ(expected, read_keys(rowset_0, &snapshot, 1));
+    ASSERT_EQ(10u, read_keys(rowset_1, &snapshot, 1).size());
+
+    // a read of version 0 sees all rows of version 0
+    ASSERT_EQ(10u, read_keys(rowset_0, &snapshot, 0).size());
+}
+
+TEST_F(PrimaryKeyIndexTest, BuildTabletIndexInBackground) {
+    TCreateTabletReq request;
+    request.tablet_id = 12346;
+    request.__set_version(1);
+    request.__set_version_hash(0);
+    request.tablet_schema.schema_hash = 1112;
+    request.tablet_schema.short_key_column_count = 1;
+    request.tablet_schema.keys_type = TKeysType::UNIQUE_KEYS;
+    request.tablet_schema.storage_type = TStorageType::COLUMN;
+    TColumn k1;
+    k1.column_name = "k1";
+    k1.__set_is_key(true);
+    k1.column_type.type = TPrimitiveType::INT;
+    request.tablet_schema.columns.push_back(k1);
+    TColumn v1;
+    v1.column_name = "v1";
+    v1.__set_is_key(false);
+    v1.column_type.type = TPrimitiveType::INT;
+    v1.__set_aggregation_type(TAggregationType::REPLACE);
+    request.tablet_schema.columns.push_back(v1);
+    ASSERT_EQ(OLAP_SUCCESS, k_engine->create_tablet(request));
+    TabletSharedPtr tablet = k_engine->tablet_manager()->get_tablet(12346, 1112);
+    ASSERT_TRUE(tablet != nullptr);
+
+    // loading the tablet doesn't build the index, the first query submits
+    // a build and merges rowsets until it's done
+    ASSERT_TRUE(tablet->_primary_key_index == nullptr);
+    ASSERT_TRUE(tablet->primary_key_index() == nullptr);
+    std::shared_ptr<PrimaryKeyIndex> index;
+    for (int i = 0; i < 100 && index == nullptr; ++i) {
+        usleep(50 * 1000);
+        index = tablet->primary_key_index();
+    }
+    ASSERT_TRUE(index != nullptr);
+    ASSERT_EQ(tablet->max_version().second, index->max_version());
+
+    // a dropped index is built again
+    tablet->_drop_primary_key_index();
+    ASSERT_EQ(OLAP_SUCCESS, tablet->build_primary_key_index());
+    index = tablet->primary_key_index();
+    ASSERT_TRUE(index != nullptr);
+    ASSERT_EQ(tablet->max_version().second, index->max_version());
+    ASSERT_FALSE(tablet->_primary_key_index_building);
+}
+
+}  // namespace doris
+
+int main(int argc, char **argv) {
+    std::string conffile = std::string(getenv("DORIS_HOME")) + "/conf/be.conf";
+    if (!doris::config::init(conffile.c_str(), false)) {
+        fprintf(stderr, "error read config file. \n");
+        return -1;
+    }
+    doris::init_glog("be-test");
+    ::testing::InitGoogleTest(&argc, argv);
+    int ret = RUN_ALL_TESTS();
+    google::protobuf::ShutdownProtobufLibrary();
+    return ret;
+}
@@ -255,6 +255,92 @@ TEST_F(AlphaRowsetTest, TestAlphaRowsetReader) {
     ASSERT_EQ(1, row_block->remaining());
 }
 
+// Write rows of keys [start_key, end_key) to a rowset of version
+static RowsetSharedPtr write_rowset(TabletSchema* tablet_schema, DataDir* data_dir,
+        RowsetId rowset_id, Version version, int32_t start_key, int32_t end_key, MemPool* mem_pool) {
+    RowsetWriterContext rowset_writer_context;
+    create_rowset_writer_context(tablet_schema, data_dir, &rowset_writer_context);
+    rowset_writer_context.rowset_id = rowset_id;
+    rowset_writer_context.version = version;
+    AlphaRowsetWriter rowset_writer;
+    rowset_writer.init(rowset_writer_context);
+    RowCursor row;
+    row.init(*tablet_schema);
+    for (int32_t key = start_key; key < end_key; ++key) {
+        row.set_field_content(0, reinterpret_cast<char*>(&key), mem_pool);
+        Slice field_1("well");
+        row.set_field_content(1, reinterpret_cast<char*>(&field_1), mem_pool);
+        int32_t field_2 = key * 10;
+        row.set_field_content(2, reinterpret_cast<char*>(&field_2), mem_pool);
+        rowset_writer.add_row(row);
+    }
+    rowset_writer.flush();
+    RowsetSharedPtr rowset = rowset_writer.build();
+    if (rowset != nullptr) {
+        rowset->load();
+    }
+    return rowset;
+}
+
+TEST_F(AlphaRowsetTest, TestReadLinkedOrderedRowsets) {
+    TabletSchema tablet_schema;
+    create_tablet_schema(AGG_KEYS, &tablet_schema);
+    std::vector<RowsetSharedPtr> input_rowsets;
+    input_rowsets.push_back(write_rowset(&tablet_schema, _data_dir, 10000, {2, 2}, 0, 10, _mem_pool.get()));
+    input_rowsets.push_back(write_rowset(&tablet_schema, _data_dir, 10001, {3, 3}, 10, 20, _mem_pool.get()));
+    ASSERT_TRUE(input_rowsets[0] != nullptr);
+    ASSERT_TRUE(input_rowsets[1] != nullptr);
+    ASSERT_TRUE(AlphaRowset::is_rowsets_non_overlapping(input_rowsets, 2));
+    ASSERT_FALSE(AlphaRowset::is_rowsets_non_overlapping({input_rowsets[1], input_rowsets[0]}, 2));
+
+    // link input rowsets to a cumulative rowset as compaction of ordered data does
+    RowsetWriterContext rowset_writer_context;
+    create_rowset_writer_context(&tablet_schema, _data_dir, &rowset_writer_context);
+    rowset_writer_context.rowset_id = 10002;
+    rowset_writer_context.version = {2, 3};
+    AlphaRowsetWriter rowset_writer;
+    rowset_writer.init(rowset_writer_context);
+    for (auto& rowset : input_rowsets) {
+        ASSERT_EQ(OLAP_SUCCESS, rowset_writer.add_rowset(rowset));
+    }
+    ASSERT_EQ(OLAP_SUCCESS, rowset_writer.flush());
+    RowsetSharedPtr output_rowset = rowset_writer.build();
+    ASSERT_TRUE(output_rowset != nullptr);
+    ASSERT_EQ(OLAP_SUCCESS, output_rowset->load());
+    ASSERT_EQ(20, output_rowset->num_rows());
+
+    // segment groups of the cumulative rowset are read in order
+    RowsetReaderSharedPtr rowset_reader = output_rowset->create_reader();
+    ASSERT_TRUE(rowset_reader != nullptr);
+    std::vector<uint32_t> return_columns;
+    for (int i = 0;  i < tablet_schema.num_columns(); ++i) {
+        return_columns.push_back(i);
+    }
+    DeleteHandler delete_handler;
+    DelPredicateArray predicate_array;
+    ASSERT_EQ(OLAP_SUCCESS, delete_handler.init(tablet_schema, predicate_array, 4));
+    RowsetReaderContext rowset_reader_context;
+    std::set<uint32_t> load_bf_columns;
+    std::vector<ColumnPredicate*> predicates;
+    Conditions conditions;
+    create_rowset_reader_context(&tablet_schema, &return_columns, &delete_handler,
+            &predicates, &load_bf_columns, &conditions, &rowset_reader_context);
+    ASSERT_EQ(OLAP_SUCCESS, rowset_reader->init(&rowset_reader_context));
+
+    RowCursor row;
+    ASSERT_EQ(OLAP_SUCCESS, row.init(tablet_schema));
+    int32_t expected_key = 0;
+    RowBlock* row_block = nullptr;
+    while (rowset_reader->next_block(&row_block) == OLAP_SUCCESS) {
+        for (size_t i = 0; i < row_block->remaining(); ++i) {
+            row_block->get_row(i, &row);
+            ASSERT_EQ(expected_key, *reinterpret_cast<int32_t*>(row.cell_ptr(0)));
+            ++expected_key;
+        }
+    }
+    ASSERT_EQ(20, expected_key);
+}
+
 }  // namespace doris
 
 int main(int argc, char **argv) {
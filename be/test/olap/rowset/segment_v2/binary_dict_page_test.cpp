@@ -87,6 +87,11 @@ public:
         ASSERT_EQ("Nature", values[5].to_string());
         ASSERT_EQ("Captain", values[6].to_string());
         ASSERT_EQ("Xmas", values[7].to_string());
+        // values reference the dictionary page rather than copies in arena
+        for (int i = 0; i < size; ++i) {
+            ASSERT_GE(values[i].data, dict_slice.data);
+            ASSERT_LE(values[i].data + values[i].size, dict_slice.data + dict_slice.size);
+        }
 
         status = page_decoder.seek_to_position_in_page(5);
         status = page_decoder.next_batch(&size, &block_view);
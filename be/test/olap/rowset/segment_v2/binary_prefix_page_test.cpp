@@ -0,0 +1,159 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+#include "common/logging.h"
+#include "olap/rowset/segment_v2/page_builder.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+#include "olap/rowset/segment_v2/binary_prefix_page.h"
+#include "olap/olap_common.h"
+#include "olap/types.h"
+#include "util/arena.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class BinaryPrefixPageTest : public testing::Test {
+public:
+    BinaryPrefixPageTest() {}
+
+    virtual ~BinaryPrefixPageTest() {
+    }
+
+    void test_encode_and_decode(const std::vector<std::string>& strings) {
+        std::vector<Slice> slices;
+        for (auto& str : strings) {
+            slices.emplace_back(str);
+        }
+
+        PageBuilderOptions options;
+        options.data_page_size = 256 * 1024;
+        BinaryPrefixPageBuilder page_builder(options);
+        size_t count = slices.size();
+        Status ret = page_builder.add(reinterpret_cast<const uint8_t*>(slices.data()), &count);
+        ASSERT_TRUE(ret.ok());
+        ASSERT_EQ(slices.size(), count);
+        Slice s = page_builder.finish();
+        ASSERT_EQ(slices.size(), page_builder.count());
+
+        PageDecoderOptions decoder_options;
+        BinaryPrefixPageDecoder page_decoder(s, decoder_options);
+        Status status = page_decoder.init();
+        ASSERT_TRUE(status.ok());
+        ASSERT_EQ(slices.size(), page_decoder.count());
+
+        Arena arena;
+        size_t size = slices.size();
+        Slice* values = reinterpret_cast<Slice*>(arena.Allocate(size * sizeof(Slice)));
+        ColumnBlock block(get_type_info(OLAP_FIELD_TYPE_VARCHAR), (uint8_t*)values, nullptr, &arena);
+        ColumnBlockView column_block_view(&block);
+        status = page_decoder.next_batch(&size, &column_block_view);
+        ASSERT_TRUE(status.ok());
+        ASSERT_EQ(slices.size(), size);
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(strings[i], values[i].to_string());
+        }
+
+        // seek by position, both forward and backward
+        for (int i = 0; i < 100; ++i) {
+            size_t pos = random() % slices.size();
+            ASSERT_TRUE(page_decoder.seek_to_position_in_page(pos).ok());
+            ASSERT_EQ(pos, page_decoder.current_index());
+            Slice value;
+            ColumnBlock one_block(get_type_info(OLAP_FIELD_TYPE_VARCHAR), (uint8_t*)&value, nullptr, &arena);
+            ColumnBlockView one_view(&one_block);
+            size_t n = 1;
+            ASSERT_TRUE(page_decoder.next_batch(&n, &one_view).ok());
+            ASSERT_EQ(1, n);
+            ASSERT_EQ(strings[pos], value.to_string());
+        }
+    }
+};
+
+TEST_F(BinaryPrefixPageTest, TestSortedValues) {
+    std::vector<std::string> strings;
+    for (int i = 0; i < 1000; ++i) {
+        char buf[64];
+        snprintf(buf, 64, "http://doris.apache.org/docs/page_%06d.html", i);
+        strings.emplace_back(buf);
+    }
+    test_encode_and_decode(strings);
+
+    std::vector<Slice> slices;
+    size_t raw_size = 0;
+    for (auto& str : strings) {
+        slices.emplace_back(str);
+        raw_size += str.size();
+    }
+    PageBuilderOptions options;
+    BinaryPrefixPageBuilder page_builder(options);
+    size_t count = slices.size();
+    ASSERT_TRUE(page_builder.add(reinterpret_cast<const uint8_t*>(slices.data()), &count).ok());
+    Slice s = page_builder.finish();
+    // shared prefix is stored only once every restart interval
+    ASSERT_LT(s.size, raw_size / 3);
+
+    PageDecoderOptions decoder_options;
+    BinaryPrefixPageDecoder page_decoder(s, decoder_options);
+    ASSERT_TRUE(page_decoder.init().ok());
+
+    bool exact_match = false;
+    Slice target("http://doris.apache.org/docs/page_000500.html");
+    ASSERT_TRUE(page_decoder.seek_at_or_after_value(&target, &exact_match).ok());
+    ASSERT_TRUE(exact_match);
+    ASSERT_EQ(500, page_decoder.current_index());
+
+    target = Slice("http://doris.apache.org/docs/page_000500.htm");
+    ASSERT_TRUE(page_decoder.seek_at_or_after_value(&target, &exact_match).ok());
+    ASSERT_FALSE(exact_match);
+    ASSERT_EQ(500, page_decoder.current_index());
+
+    target = Slice("a");
+    ASSERT_TRUE(page_decoder.seek_at_or_after_value(&target, &exact_match).ok());
+    ASSERT_FALSE(exact_match);
+    ASSERT_EQ(0, page_decoder.current_index());
+
+    target = Slice("z");
+    ASSERT_FALSE(page_decoder.seek_at_or_after_value(&target, &exact_match).ok());
+}
+
+TEST_F(BinaryPrefixPageTest, TestUnsortedValues) {
+    std::vector<std::string> strings = {"Hello", ",", "", "Doris", "Dor", "Dorisdb", ""};
+    test_encode_and_decode(strings);
+}
+
+TEST_F(BinaryPrefixPageTest, TestEmptyPage) {
+    PageBuilderOptions options;
+    BinaryPrefixPageBuilder page_builder(options);
+    Slice s = page_builder.finish();
+
+    PageDecoderOptions decoder_options;
+    BinaryPrefixPageDecoder page_decoder(s, decoder_options);
+    ASSERT_TRUE(page_decoder.init().ok());
+    ASSERT_EQ(0, page_decoder.count());
+}
+
+}
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
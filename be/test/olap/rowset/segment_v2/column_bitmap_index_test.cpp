@@ -0,0 +1,149 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/column_bitmap_index.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "common/logging.h"
+#include "olap/olap_cond.h"
+#include "olap/tablet_schema_helper.h"
+#include "olap/types.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class ColumnBitmapIndexTest : public testing::Test {
+public:
+    ColumnBitmapIndexTest() { }
+    virtual ~ColumnBitmapIndexTest() { }
+};
+
+static Roaring get_rows(const TabletSchema& tablet_schema, const ColumnBitmapIndex& bitmap_index,
+                        const std::string& op, const std::vector<std::string>& values) {
+    CondColumn cond_column(tablet_schema, 0);
+    TCondition condition;
+    condition.column_name = "1";
+    condition.condition_op = op;
+    condition.condition_values = values;
+    EXPECT_EQ(OLAP_SUCCESS, cond_column.add_cond(condition, tablet_schema.column(0)));
+    Roaring rows;
+    bitmap_index.get_row_bitmap(&cond_column, &rows);
+    return rows;
+}
+
+TEST_F(ColumnBitmapIndexTest, IntColumn) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_INT);
+    ColumnBitmapIndexBuilder builder(type_info);
+
+    // rows [0, 1000) are i % 10, rows [1000, 1010) are null, rows [1010, 1020) are -1
+    std::vector<int32_t> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i % 10);
+    }
+    builder.add((const uint8_t*)values.data(), values.size());
+    builder.add_nulls(10);
+    std::vector<int32_t> values2(10, -1);
+    builder.add((const uint8_t*)values2.data(), values2.size());
+
+    Slice data = builder.finish();
+    ColumnBitmapIndex bitmap_index(type_info, data);
+    ASSERT_TRUE(bitmap_index.load().ok());
+    ASSERT_EQ(11, bitmap_index.num_values());
+    // values are sorted
+    ASSERT_EQ(-1, *(int32_t*)bitmap_index._values[0].data);
+    ASSERT_EQ(9, *(int32_t*)bitmap_index._values[10].data);
+
+    TabletSchema tablet_schema;
+    tablet_schema._cols.push_back(create_int_key(1));
+    tablet_schema._num_columns = 1;
+    tablet_schema._num_key_columns = 1;
+
+    Roaring rows = get_rows(tablet_schema, bitmap_index, "=", {"3"});
+    ASSERT_EQ(100, rows.cardinality());
+    for (uint32_t rowid : rows) {
+        ASSERT_EQ(3, rowid % 10);
+        ASSERT_LT(rowid, 1000);
+    }
+
+    rows = get_rows(tablet_schema, bitmap_index, "*=", {"1", "-1", "100"});
+    ASSERT_EQ(110, rows.cardinality());
+    ASSERT_TRUE(rows.contains(1));
+    ASSERT_TRUE(rows.contains(1015));
+    ASSERT_FALSE(rows.contains(2));
+
+    rows = get_rows(tablet_schema, bitmap_index, "is", {"null"});
+    ASSERT_EQ(10, rows.cardinality());
+    ASSERT_EQ(1000, rows.minimum());
+    ASSERT_EQ(1009, rows.maximum());
+
+    rows = get_rows(tablet_schema, bitmap_index, "is", {"not null"});
+    ASSERT_EQ(1010, rows.cardinality());
+
+    rows = get_rows(tablet_schema, bitmap_index, "<", {"0"});
+    ASSERT_EQ(10, rows.cardinality());
+    ASSERT_EQ(1010, rows.minimum());
+
+    rows = get_rows(tablet_schema, bitmap_index, "=", {"100"});
+    ASSERT_TRUE(rows.isEmpty());
+}
+
+TEST_F(ColumnBitmapIndexTest, StringColumn) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_VARCHAR);
+    ColumnBitmapIndexBuilder builder(type_info);
+
+    std::vector<std::string> strings = {"ccc", "aaa", "bbb", "aaa", "ddd", "ccc"};
+    std::vector<Slice> values;
+    for (auto& str : strings) {
+        values.emplace_back(str);
+    }
+    builder.add((const uint8_t*)values.data(), values.size());
+
+    Slice data = builder.finish();
+    ColumnBitmapIndex bitmap_index(type_info, data);
+    ASSERT_TRUE(bitmap_index.load().ok());
+    ASSERT_EQ(4, bitmap_index.num_values());
+    ASSERT_EQ("aaa", bitmap_index._values[0].to_string());
+    ASSERT_EQ("ddd", bitmap_index._values[3].to_string());
+
+    TabletSchema tablet_schema;
+    tablet_schema._cols.push_back(create_varchar_key(1));
+    tablet_schema._num_columns = 1;
+    tablet_schema._num_key_columns = 1;
+
+    Roaring rows = get_rows(tablet_schema, bitmap_index, "=", {"aaa"});
+    ASSERT_EQ(2, rows.cardinality());
+    ASSERT_TRUE(rows.contains(1));
+    ASSERT_TRUE(rows.contains(3));
+
+    rows = get_rows(tablet_schema, bitmap_index, "*=", {"bbb", "ddd"});
+    ASSERT_EQ(2, rows.cardinality());
+    ASSERT_TRUE(rows.contains(2));
+    ASSERT_TRUE(rows.contains(4));
+
+    rows = get_rows(tablet_schema, bitmap_index, "is", {"null"});
+    ASSERT_TRUE(rows.isEmpty());
+}
+
+}
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
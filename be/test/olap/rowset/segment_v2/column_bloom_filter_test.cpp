@@ -0,0 +1,153 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/column_bloom_filter.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "common/logging.h"
+#include "olap/olap_cond.h"
+#include "olap/tablet_schema_helper.h"
+#include "olap/types.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class ColumnBloomFilterTest : public testing::Test {
+public:
+    ColumnBloomFilterTest() { }
+    virtual ~ColumnBloomFilterTest() { }
+};
+
+static bool match(const TabletSchema& tablet_schema, const ColumnBloomFilter& column_bf,
+                  int32_t page_index, const std::string& op,
+                  const std::vector<std::string>& values) {
+    CondColumn cond_column(tablet_schema, 0);
+    TCondition condition;
+    condition.column_name = "1";
+    condition.condition_op = op;
+    condition.condition_values = values;
+    EXPECT_EQ(OLAP_SUCCESS, cond_column.add_cond(condition, tablet_schema.column(0)));
+    return column_bf.match_condition(page_index, &cond_column);
+}
+
+TEST_F(ColumnBloomFilterTest, IntPage) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_INT);
+    ColumnBloomFilterBuilder builder(type_info);
+
+    // page 0: [0, 1024), page 1: [1024, 2048) and null
+    std::vector<int32_t> values;
+    for (int i = 0; i < 2048; ++i) {
+        values.push_back(i);
+    }
+    builder.add((const uint8_t*)values.data(), 1024);
+    ASSERT_TRUE(builder.flush().ok());
+    builder.add((const uint8_t*)(values.data() + 1024), 1024);
+    builder.add_nulls(10);
+    ASSERT_TRUE(builder.flush().ok());
+
+    Slice data = builder.finish();
+    ColumnBloomFilter column_bf(data, builder.algorithm());
+    ASSERT_TRUE(column_bf.load().ok());
+    ASSERT_EQ(2, column_bf.num_pages());
+
+    TabletSchema tablet_schema;
+    tablet_schema._cols.push_back(create_int_key(1));
+    tablet_schema._num_columns = 1;
+    tablet_schema._num_key_columns = 1;
+
+    // values added must be matched
+    for (int i = 0; i < 1024; i += 100) {
+        ASSERT_TRUE(match(tablet_schema, column_bf, 0, "=", {std::to_string(i)}));
+        ASSERT_TRUE(match(tablet_schema, column_bf, 1, "=", {std::to_string(i + 1024)}));
+    }
+    // most of values not added should be filtered
+    int page0_false_positive = 0;
+    for (int i = 1024; i < 2048; ++i) {
+        if (match(tablet_schema, column_bf, 0, "=", {std::to_string(i)})) {
+            page0_false_positive++;
+        }
+    }
+    ASSERT_LT(page0_false_positive, 1024 * 0.1);
+
+    ASSERT_TRUE(match(tablet_schema, column_bf, 0, "*=", {"5000", "10"}));
+    ASSERT_TRUE(match(tablet_schema, column_bf, 1, "is", {"null"}));
+    // conditions which can't be evaluated by bloom filter are ignored
+    ASSERT_TRUE(match(tablet_schema, column_bf, 0, ">", {"100000"}));
+    ASSERT_TRUE(match(tablet_schema, column_bf, 0, "is", {"not null"}));
+}
+
+TEST_F(ColumnBloomFilterTest, ClassicBloomFilter) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_INT);
+    ColumnBloomFilterBuilder builder(type_info, BLOOM_FILTER_DEFAULT_FPP, CLASSIC_BLOOM_FILTER);
+    ASSERT_EQ(CLASSIC_BLOOM_FILTER, builder.algorithm());
+
+    std::vector<int32_t> values;
+    for (int i = 0; i < 1024; ++i) {
+        values.push_back(i);
+    }
+    builder.add((const uint8_t*)values.data(), values.size());
+    ASSERT_TRUE(builder.flush().ok());
+
+    Slice data = builder.finish();
+    ColumnBloomFilter column_bf(data, CLASSIC_BLOOM_FILTER);
+    ASSERT_TRUE(column_bf.load().ok());
+    ASSERT_EQ(1, column_bf.num_pages());
+
+    TabletSchema tablet_schema;
+    tablet_schema._cols.push_back(create_int_key(1));
+    tablet_schema._num_columns = 1;
+    tablet_schema._num_key_columns = 1;
+    for (int i = 0; i < 1024; i += 100) {
+        ASSERT_TRUE(match(tablet_schema, column_bf, 0, "=", {std::to_string(i)}));
+    }
+}
+
+TEST_F(ColumnBloomFilterTest, StringPage) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_VARCHAR);
+    ColumnBloomFilterBuilder builder(type_info);
+
+    std::vector<std::string> strings = {"user_1", "user_2", "user_3"};
+    std::vector<Slice> values;
+    for (auto& str : strings) {
+        values.emplace_back(str);
+    }
+    builder.add((const uint8_t*)values.data(), values.size());
+    ASSERT_TRUE(builder.flush().ok());
+
+    Slice data = builder.finish();
+    ColumnBloomFilter column_bf(data, builder.algorithm());
+    ASSERT_TRUE(column_bf.load().ok());
+    ASSERT_EQ(1, column_bf.num_pages());
+
+    TabletSchema tablet_schema;
+    tablet_schema._cols.push_back(create_varchar_key(1));
+    tablet_schema._num_columns = 1;
+    tablet_schema._num_key_columns = 1;
+    for (auto& str : strings) {
+        ASSERT_TRUE(match(tablet_schema, column_bf, 0, "=", {str}));
+    }
+}
+
+}
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
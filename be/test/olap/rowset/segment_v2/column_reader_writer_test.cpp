@@ -21,11 +21,15 @@
 #include <gtest/gtest.h>
 #include <iostream>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
 #include "olap/olap_common.h"
+#include "olap/olap_cond.h"
+#include "olap/tablet_schema_helper.h"
 #include "olap/types.h"
 #include "olap/column_block.h"
+#include "olap/page_cache.h"
 #include "util/file_utils.h"
 #include "util/arena.h"
 
@@ -40,7 +44,8 @@ public:
 };
 
 template<FieldType type, EncodingTypePB encoding>
-void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows, std::string test_name) {
+void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows, std::string test_name,
+                        CompressionTypePB compression = NO_COMPRESSION) {
     using Type = typename TypeTraits<type>::CppType;
     Type* src = (Type*)src_data;
     const TypeInfo* type_info = get_type_info(type);
@@ -58,6 +63,8 @@ void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows, s
 
         ColumnWriterOptions writer_opts;
         writer_opts.encoding_type = encoding;
+        writer_opts.compression_type = compression;
+        writer_opts.need_zone_map = true;
 
         ColumnWriter writer(writer_opts, type_info, true, wfile.get());
         st = writer.init();
@@ -75,6 +82,8 @@ void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows, s
         ASSERT_TRUE(st.ok());
         st = writer.write_ordinal_index();
         ASSERT_TRUE(st.ok());
+        st = writer.write_zone_map();
+        ASSERT_TRUE(st.ok());
 
         writer.write_meta(&meta);
 
@@ -89,7 +98,7 @@ void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows, s
         ASSERT_TRUE(st.ok());
 
         ColumnReaderOptions reader_opts;
-        ColumnReader reader(reader_opts, meta, rfile.get());
+        ColumnReader reader(reader_opts, meta, num_rows, rfile.get());
 
         st = reader.init();
         ASSERT_TRUE(st.ok());
@@ -193,6 +202,341 @@ TEST_F(ColumnReaderWriterTest, test_nullable) {
     delete[] double_vals;
 }
 
+TEST_F(ColumnReaderWriterTest, test_compression) {
+    size_t num_rows = 256 * 1024;
+    uint8_t* is_null = new uint8_t[BitmapSize(num_rows)];
+    int32_t* vals = new int32_t[num_rows];
+    for (int i = 0; i < num_rows; ++i) {
+        vals[i] = i / 16;
+        BitmapChange(is_null, i, (i % 8) == 0);
+    }
+    test_nullable_data<OLAP_FIELD_TYPE_INT, PLAIN_ENCODING>(
+        (uint8_t*)vals, is_null, num_rows, "compress_int_lz4f", LZ4F);
+    test_nullable_data<OLAP_FIELD_TYPE_INT, PLAIN_ENCODING>(
+        (uint8_t*)vals, is_null, num_rows, "compress_int_zstd", ZSTD);
+    test_nullable_data<OLAP_FIELD_TYPE_INT, BIT_SHUFFLE>(
+        (uint8_t*)vals, is_null, num_rows, "compress_int_bs_snappy", SNAPPY);
+
+    // random values are compressed poorly, pages are stored uncompressed
+    for (int i = 0; i < num_rows; ++i) {
+        vals[i] = rand();
+    }
+    test_nullable_data<OLAP_FIELD_TYPE_INT, PLAIN_ENCODING>(
+        (uint8_t*)vals, is_null, num_rows, "compress_random_int_lz4f", LZ4F);
+    delete[] vals;
+    delete[] is_null;
+}
+
+TEST_F(ColumnReaderWriterTest, test_dict_evaluate) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_VARCHAR);
+    std::vector<std::string> words = {"china", "usa", "japan", "france", "uk"};
+    size_t num_rows = 10000;
+    // row i is null if i % 7 == 0, otherwise its value is words[i % 5]
+    auto is_null_row = [](size_t i) { return (i % 7) == 0; };
+
+    ColumnMetaPB meta;
+    std::string dname = "./ut_dir/column_reader_writer_test";
+    FileUtils::create_dir(dname);
+    std::string fname = dname + "/dict_evaluate";
+    {
+        std::unique_ptr<WritableFile> wfile;
+        auto st = Env::Default()->new_writable_file(fname, &wfile);
+        ASSERT_TRUE(st.ok());
+
+        ColumnWriterOptions writer_opts;
+        writer_opts.encoding_type = DICT_ENCODING;
+        writer_opts.data_page_size = 4 * 1024;
+        ColumnWriter writer(writer_opts, type_info, true, wfile.get());
+        ASSERT_TRUE(writer.init().ok());
+        for (size_t i = 0; i < num_rows; ++i) {
+            Slice value(words[i % 5]);
+            ASSERT_TRUE(writer.append(is_null_row(i), &value).ok());
+        }
+        ASSERT_TRUE(writer.finish().ok());
+        ASSERT_TRUE(writer.write_data().ok());
+        ASSERT_TRUE(writer.write_ordinal_index().ok());
+        writer.write_meta(&meta);
+        ASSERT_TRUE(meta.has_dict_page());
+        wfile.reset();
+    }
+
+    std::unique_ptr<RandomAccessFile> rfile;
+    auto st = Env::Default()->new_random_access_file(fname, &rfile);
+    ASSERT_TRUE(st.ok());
+    ColumnReaderOptions reader_opts;
+    ColumnReader reader(reader_opts, meta, num_rows, rfile.get());
+    ASSERT_TRUE(reader.init().ok());
+    ASSERT_TRUE(reader.dict_decoder() != nullptr);
+
+    TabletSchema tablet_schema;
+    tablet_schema._cols.push_back(create_varchar_key(1));
+    tablet_schema._num_columns = 1;
+    tablet_schema._num_key_columns = 1;
+
+    auto check = [&](const std::string& op, const std::vector<std::string>& values) {
+        CondColumn cond_column(tablet_schema, 0);
+        TCondition condition;
+        condition.column_name = "1";
+        condition.condition_op = op;
+        condition.condition_values = values;
+        ASSERT_EQ(OLAP_SUCCESS, cond_column.add_cond(condition, tablet_schema.column(0)));
+
+        ColumnIterator* iter = nullptr;
+        ASSERT_TRUE(reader.new_iterator(&iter).ok());
+        std::unique_ptr<ColumnIterator> iter_holder(iter);
+        ASSERT_TRUE(iter->seek_to_first().ok());
+
+        Arena arena;
+        Slice vals[1024];
+        uint8_t is_null[1024];
+        uint8_t selection[1024];
+        ColumnBlock col(type_info, (uint8_t*)vals, is_null, &arena);
+
+        size_t idx = 0;
+        while (idx < num_rows) {
+            size_t rows_read = 1024;
+            ColumnBlockView dst(&col);
+            ASSERT_TRUE(iter->next_batch_and_evaluate(&rows_read, &dst, &cond_column, selection).ok());
+            ASSERT_GT(rows_read, 0);
+            for (size_t j = 0; j < rows_read; ++j, ++idx) {
+                bool expected = false;
+                if (!is_null_row(idx)) {
+                    for (auto& value : values) {
+                        expected |= (words[idx % 5] == value);
+                    }
+                }
+                ASSERT_EQ(expected, (bool)selection[j]);
+                if (expected) {
+                    ASSERT_FALSE(BitmapTest(is_null, j));
+                    ASSERT_EQ(words[idx % 5], vals[j].to_string());
+                }
+            }
+        }
+    };
+    check("=", {"usa"});
+    check("*=", {"china", "uk"});
+    check("=", {"korea"});
+}
+
+TEST_F(ColumnReaderWriterTest, test_read_ahead) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_INT);
+    size_t num_rows = 100000;
+
+    ColumnMetaPB meta;
+    std::string dname = "./ut_dir/column_reader_writer_test";
+    FileUtils::create_dir(dname);
+    std::string fname = dname + "/read_ahead";
+    {
+        std::unique_ptr<WritableFile> wfile;
+        auto st = Env::Default()->new_writable_file(fname, &wfile);
+        ASSERT_TRUE(st.ok());
+
+        ColumnWriterOptions writer_opts;
+        writer_opts.encoding_type = PLAIN_ENCODING;
+        writer_opts.data_page_size = 4 * 1024;
+        ColumnWriter writer(writer_opts, type_info, false, wfile.get());
+        ASSERT_TRUE(writer.init().ok());
+        for (int32_t i = 0; i < num_rows; ++i) {
+            ASSERT_TRUE(writer.append(&i, 1).ok());
+        }
+        ASSERT_TRUE(writer.finish().ok());
+        ASSERT_TRUE(writer.write_data().ok());
+        ASSERT_TRUE(writer.write_ordinal_index().ok());
+        writer.write_meta(&meta);
+        wfile.reset();
+    }
+
+    std::unique_ptr<RandomAccessFile> rfile;
+    auto st = Env::Default()->new_random_access_file(fname, &rfile);
+    ASSERT_TRUE(st.ok());
+    ColumnReaderOptions reader_opts;
+    ColumnReader reader(reader_opts, meta, num_rows, rfile.get());
+    ASSERT_TRUE(reader.init().ok());
+    ASSERT_GT(reader._ordinal_index->num_pages(), 8);
+
+    auto is_cached = [&](int32_t page_index) {
+        OrdinalPageIndexIterator iter(reader._ordinal_index.get(), page_index);
+        PageCacheHandle handle;
+        StoragePageCache::CacheKey key(rfile->file_name(), iter.page().offset);
+        return StoragePageCache::instance()->lookup(key, &handle);
+    };
+
+    int32_t old_read_ahead_num = config::segment_page_read_ahead_num;
+    config::segment_page_read_ahead_num = 4;
+    {
+        // reading page 2 reads page 2 to page 5 into page cache
+        PageHandle handle;
+        ASSERT_TRUE(reader.read_page(OrdinalPageIndexIterator(reader._ordinal_index.get(), 2), &handle).ok());
+        ASSERT_FALSE(is_cached(1));
+        for (int32_t i = 2; i < 6; ++i) {
+            ASSERT_TRUE(is_cached(i));
+        }
+        ASSERT_FALSE(is_cached(6));
+    }
+    {
+        // read ahead stops at page 2 which is already cached
+        PageHandle handle;
+        ASSERT_TRUE(reader.read_page(OrdinalPageIndexIterator(reader._ordinal_index.get(), 0), &handle).ok());
+        ASSERT_TRUE(is_cached(0));
+        ASSERT_TRUE(is_cached(1));
+    }
+    config::segment_page_read_ahead_num = old_read_ahead_num;
+
+    // the read ahead pages can be read back correctly
+    ColumnIterator* iter = nullptr;
+    ASSERT_TRUE(reader.new_iterator(&iter).ok());
+    std::unique_ptr<ColumnIterator> iter_holder(iter);
+    ASSERT_TRUE(iter->seek_to_first().ok());
+    Arena arena;
+    int32_t vals[1024];
+    ColumnBlock col(type_info, (uint8_t*)vals, nullptr, &arena);
+    int32_t idx = 0;
+    while (idx < num_rows) {
+        size_t rows_read = 1024;
+        ASSERT_TRUE(iter->next_batch(&rows_read, &col).ok());
+        ASSERT_GT(rows_read, 0);
+        for (size_t j = 0; j < rows_read; ++j, ++idx) {
+            ASSERT_EQ(idx, vals[j]);
+        }
+    }
+}
+
+TEST_F(ColumnReaderWriterTest, test_decompressed_page_cache) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_INT);
+    size_t num_rows = 20000;
+    // row i is null if i % 3 == 0, otherwise its value is i
+    auto is_null_row = [](size_t i) { return (i % 3) == 0; };
+
+    ColumnMetaPB meta;
+    std::string dname = "./ut_dir/column_reader_writer_test";
+    FileUtils::create_dir(dname);
+    std::string fname = dname + "/decompressed_page_cache";
+    {
+        std::unique_ptr<WritableFile> wfile;
+        auto st = Env::Default()->new_writable_file(fname, &wfile);
+        ASSERT_TRUE(st.ok());
+
+        ColumnWriterOptions writer_opts;
+        writer_opts.encoding_type = BIT_SHUFFLE;
+        writer_opts.data_page_size = 4 * 1024;
+        ColumnWriter writer(writer_opts, type_info, true, wfile.get());
+        ASSERT_TRUE(writer.init().ok());
+        for (int32_t i = 0; i < num_rows; ++i) {
+            ASSERT_TRUE(writer.append(is_null_row(i), &i).ok());
+        }
+        ASSERT_TRUE(writer.finish().ok());
+        ASSERT_TRUE(writer.write_data().ok());
+        ASSERT_TRUE(writer.write_ordinal_index().ok());
+        writer.write_meta(&meta);
+        wfile.reset();
+    }
+
+    std::unique_ptr<RandomAccessFile> rfile;
+    auto st = Env::Default()->new_random_access_file(fname, &rfile);
+    ASSERT_TRUE(st.ok());
+    ColumnReaderOptions reader_opts;
+    reader_opts.cache_decompressed_page = true;
+    ColumnReader reader(reader_opts, meta, num_rows, rfile.get());
+    ASSERT_TRUE(reader.init().ok());
+    ASSERT_TRUE(reader.decompressed_encoding_info() != nullptr);
+    int64_t num_pages = reader._ordinal_index->num_pages();
+    ASSERT_GT(num_pages, 1);
+
+    auto read_all = [&](ColumnPageCacheStatistics* stats) {
+        ColumnIterator* iter = nullptr;
+        ASSERT_TRUE(reader.new_iterator(&iter).ok());
+        std::unique_ptr<ColumnIterator> iter_holder(iter);
+        ColumnIteratorOptions iter_opts;
+        iter_opts.page_cache_stats = stats;
+        ASSERT_TRUE(iter->init(iter_opts).ok());
+        ASSERT_TRUE(iter->seek_to_first().ok());
+
+        Arena arena;
+        int32_t vals[1024];
+        uint8_t is_null[1024];
+        ColumnBlock col(type_info, (uint8_t*)vals, is_null, &arena);
+        size_t idx = 0;
+        while (idx < num_rows) {
+            size_t rows_read = 1024;
+            ASSERT_TRUE(iter->next_batch(&rows_read, &col).ok());
+            ASSERT_GT(rows_read, 0);
+            for (size_t j = 0; j < rows_read; ++j, ++idx) {
+                ASSERT_EQ(is_null_row(idx), BitmapTest(is_null, j));
+                if (!is_null_row(idx)) {
+                    ASSERT_EQ(idx, vals[j]);
+                }
+            }
+        }
+    };
+
+    int32_t old_read_ahead_num = config::segment_page_read_ahead_num;
+    config::segment_page_read_ahead_num = 1;
+    // pages read for the first time are cached in compressed form
+    ColumnPageCacheStatistics stats;
+    read_all(&stats);
+    ASSERT_EQ(num_pages, stats.page_cache_miss);
+    ASSERT_EQ(0, stats.page_cache_hit);
+    ASSERT_EQ(0, stats.decompressed_page_cache_hit);
+    // pages hit in cache are hot, they are cached in decompressed form
+    read_all(&stats);
+    ASSERT_EQ(num_pages, stats.page_cache_miss);
+    ASSERT_EQ(num_pages, stats.page_cache_hit);
+    ASSERT_EQ(0, stats.decompressed_page_cache_hit);
+    // read without decompression
+    read_all(&stats);
+    ASSERT_EQ(num_pages, stats.page_cache_hit);
+    ASSERT_EQ(num_pages, stats.decompressed_page_cache_hit);
+    config::segment_page_read_ahead_num = old_read_ahead_num;
+}
+
+TEST_F(ColumnReaderWriterTest, test_default_value_iterator) {
+    auto read_all = [](ColumnIterator* iter, FieldType type, size_t num_rows,
+                       uint8_t* vals, uint8_t* is_null, Arena* arena) {
+        ASSERT_TRUE(iter->init(ColumnIteratorOptions()).ok());
+        ASSERT_TRUE(iter->seek_to_ordinal(10).ok());
+        ColumnBlock col(get_type_info(type), vals, is_null, arena);
+        ColumnBlockView dst(&col);
+        size_t rows_read = num_rows;
+        ASSERT_TRUE(iter->next_batch(&rows_read, &dst).ok());
+        ASSERT_EQ(num_rows, rows_read);
+        ASSERT_EQ(10 + num_rows, iter->get_current_oridinal());
+    };
+
+    const size_t num_rows = 100;
+    uint8_t is_null[num_rows / 8 + 1];
+    {
+        Arena arena;
+        int32_t vals[num_rows];
+        DefaultValueIterator iter(true, "10", true, OLAP_FIELD_TYPE_INT, 4);
+        read_all(&iter, OLAP_FIELD_TYPE_INT, num_rows, (uint8_t*)vals, is_null, &arena);
+        for (int i = 0; i < num_rows; ++i) {
+            ASSERT_FALSE(BitmapTest(is_null, i));
+            ASSERT_EQ(10, vals[i]);
+        }
+    }
+    {
+        Arena arena;
+        Slice vals[num_rows];
+        DefaultValueIterator iter(true, "abc", true, OLAP_FIELD_TYPE_CHAR, 5);
+        read_all(&iter, OLAP_FIELD_TYPE_CHAR, num_rows, (uint8_t*)vals, is_null, &arena);
+        for (int i = 0; i < num_rows; ++i) {
+            ASSERT_FALSE(BitmapTest(is_null, i));
+            ASSERT_EQ(5, vals[i].size);
+            ASSERT_EQ(0, memcmp("abc\0\0", vals[i].data, 5));
+        }
+    }
+    {
+        // nullable column without default value is read as null
+        Arena arena;
+        int32_t vals[num_rows];
+        DefaultValueIterator iter(false, "", true, OLAP_FIELD_TYPE_INT, 4);
+        read_all(&iter, OLAP_FIELD_TYPE_INT, num_rows, (uint8_t*)vals, is_null, &arena);
+        for (int i = 0; i < num_rows; ++i) {
+            ASSERT_TRUE(BitmapTest(is_null, i));
+        }
+    }
+}
+
 }
 }
 
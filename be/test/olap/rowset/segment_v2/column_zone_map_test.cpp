@@ -0,0 +1,149 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/column_zone_map.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "common/logging.h"
+#include "olap/olap_cond.h"
+#include "olap/tablet_schema_helper.h"
+#include "olap/types.h"
+#include "olap/wrapper_field.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class ColumnZoneMapTest : public testing::Test {
+public:
+    ColumnZoneMapTest() { }
+    virtual ~ColumnZoneMapTest() { }
+};
+
+TEST_F(ColumnZoneMapTest, IntPage) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_INT);
+    ColumnZoneMapBuilder builder(type_info);
+
+    // page 0: [1, 9], page 1: [10, 19] and null, page 2: all null
+    std::vector<int32_t> values1 = {5, 1, 9, 3};
+    builder.add((const uint8_t*)values1.data(), values1.size());
+    ASSERT_TRUE(builder.flush().ok());
+    std::vector<int32_t> values2 = {10, 19, 15};
+    builder.add((const uint8_t*)values2.data(), values2.size());
+    builder.add_nulls(2);
+    ASSERT_TRUE(builder.flush().ok());
+    builder.add_nulls(10);
+    ASSERT_TRUE(builder.flush().ok());
+
+    Slice data = builder.finish();
+    ColumnZoneMap column_zone_map(data);
+    ASSERT_TRUE(column_zone_map.load().ok());
+    ASSERT_EQ(3, column_zone_map.num_pages());
+
+    auto& zone_maps = column_zone_map.get_column_zone_map();
+    ASSERT_EQ(1, *(int32_t*)zone_maps[0].min().data());
+    ASSERT_EQ(9, *(int32_t*)zone_maps[0].max().data());
+    ASSERT_FALSE(zone_maps[0].null_flag());
+    ASSERT_TRUE(zone_maps[0].has_not_null());
+
+    ASSERT_EQ(10, *(int32_t*)zone_maps[1].min().data());
+    ASSERT_EQ(19, *(int32_t*)zone_maps[1].max().data());
+    ASSERT_TRUE(zone_maps[1].null_flag());
+    ASSERT_TRUE(zone_maps[1].has_not_null());
+
+    ASSERT_TRUE(zone_maps[2].null_flag());
+    ASSERT_FALSE(zone_maps[2].has_not_null());
+
+    ZoneMapPB segment_zone_map;
+    builder.fill_segment_zone_map(&segment_zone_map);
+    ASSERT_EQ(1, *(int32_t*)segment_zone_map.min().data());
+    ASSERT_EQ(19, *(int32_t*)segment_zone_map.max().data());
+    ASSERT_TRUE(segment_zone_map.null_flag());
+    ASSERT_TRUE(segment_zone_map.has_not_null());
+
+    // match conditions
+    TabletSchema tablet_schema;
+    tablet_schema._cols.push_back(create_int_key(1));
+    tablet_schema._num_columns = 1;
+    tablet_schema._num_key_columns = 1;
+    TabletColumn& column = tablet_schema._cols[0];
+    std::unique_ptr<WrapperField> min_value(WrapperField::create(column));
+    std::unique_ptr<WrapperField> max_value(WrapperField::create(column));
+
+    auto match = [&](const std::string& op, const std::string& value, bool* results) {
+        CondColumn cond_column(tablet_schema, 0);
+        TCondition condition;
+        condition.column_name = "1";
+        condition.condition_op = op;
+        condition.condition_values.push_back(value);
+        ASSERT_EQ(OLAP_SUCCESS, cond_column.add_cond(condition, column));
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_EQ(results[i], ColumnZoneMap::match_condition(
+                    zone_maps[i], &cond_column, min_value.get(), max_value.get()));
+        }
+    };
+    {
+        bool results[] = {true, false, false};
+        match("=", "5", results);
+    }
+    {
+        bool results[] = {false, true, false};
+        match(">", "9", results);
+    }
+    {
+        bool results[] = {true, false, false};
+        match("<=", "9", results);
+    }
+    {
+        bool results[] = {false, true, true};
+        match("is", "null", results);
+    }
+    {
+        bool results[] = {true, true, false};
+        match("is", "not null", results);
+    }
+}
+
+TEST_F(ColumnZoneMapTest, StringPage) {
+    const TypeInfo* type_info = get_type_info(OLAP_FIELD_TYPE_VARCHAR);
+    ColumnZoneMapBuilder builder(type_info);
+
+    std::vector<std::string> strings = {"ccc", "aaa", "bbb", "ddd"};
+    std::vector<Slice> values;
+    for (auto& str : strings) {
+        values.emplace_back(str);
+    }
+    builder.add((const uint8_t*)values.data(), values.size());
+    ASSERT_TRUE(builder.flush().ok());
+
+    Slice data = builder.finish();
+    ColumnZoneMap column_zone_map(data);
+    ASSERT_TRUE(column_zone_map.load().ok());
+    ASSERT_EQ(1, column_zone_map.num_pages());
+    auto& zone_maps = column_zone_map.get_column_zone_map();
+    ASSERT_EQ("aaa", zone_maps[0].min());
+    ASSERT_EQ("ddd", zone_maps[0].max());
+}
+
+}
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "olap/rowset/segment_v2/frame_of_reference_page.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/page_builder.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+#include "util/arena.h"
+#include "util/logging.h"
+
+using doris::segment_v2::PageBuilderOptions;
+using doris::segment_v2::PageDecoderOptions;
+
+namespace doris {
+
+class FrameOfReferencePageTest : public testing::Test {
+public:
+    virtual ~FrameOfReferencePageTest() { }
+
+    template<FieldType type, class PageDecoderType>
+    void copy_one(PageDecoderType* decoder, typename TypeTraits<type>::CppType* ret) {
+        Arena arena;
+        uint8_t null_bitmap = 0;
+        ColumnBlock block(get_type_info(type), (uint8_t*)ret, &null_bitmap, &arena);
+        ColumnBlockView column_block_view(&block);
+
+        size_t n = 1;
+        decoder->next_batch(&n, &column_block_view);
+        ASSERT_EQ(1, n);
+    }
+
+    template <FieldType Type>
+    size_t test_encode_decode_page_template(typename TypeTraits<Type>::CppType* src, size_t size) {
+        typedef typename TypeTraits<Type>::CppType CppType;
+        PageBuilderOptions builder_options;
+        builder_options.data_page_size = 256 * 1024;
+        segment_v2::FrameOfReferencePageBuilder<Type> page_builder(builder_options);
+        page_builder.add(reinterpret_cast<const uint8_t *>(src), &size);
+        Slice s = page_builder.finish();
+        EXPECT_EQ(size, page_builder.count());
+        LOG(INFO) << "FOR Encoded size for " << size << " values: " << s.size
+                << ", original size:" << size * sizeof(CppType);
+
+        PageDecoderOptions decoder_options;
+        segment_v2::FrameOfReferencePageDecoder<Type> page_decoder(s, decoder_options);
+        Status status = page_decoder.init();
+        EXPECT_TRUE(status.ok());
+        EXPECT_EQ(0, page_decoder.current_index());
+        EXPECT_EQ(size, page_decoder.count());
+
+        Arena arena;
+        CppType* values = reinterpret_cast<CppType*>(arena.Allocate(size * sizeof(CppType)));
+        uint8_t* null_bitmap = reinterpret_cast<uint8_t*>(arena.Allocate(BitmapSize(size)));
+        ColumnBlock block(get_type_info(Type), (uint8_t*)values, null_bitmap, &arena);
+        ColumnBlockView column_block_view(&block);
+        size_t size_to_fetch = size;
+        status = page_decoder.next_batch(&size_to_fetch, &column_block_view);
+        EXPECT_TRUE(status.ok());
+        EXPECT_EQ(size, size_to_fetch);
+
+        for (uint i = 0; i < size; i++) {
+            if (src[i] != values[i]) {
+                ADD_FAILURE() << "Fail at index " << i <<
+                    " inserted=" << src[i] << " got=" << values[i];
+                return s.size;
+            }
+        }
+
+        // Test Seek within block by ordinal
+        for (int i = 0; i < 100; i++) {
+            int seek_off = random() % size;
+            page_decoder.seek_to_position_in_page(seek_off);
+            EXPECT_EQ((int32_t )(seek_off), page_decoder.current_index());
+            CppType ret;
+            copy_one<Type, segment_v2::FrameOfReferencePageDecoder<Type>>(&page_decoder, &ret);
+            EXPECT_EQ(values[seek_off], ret);
+        }
+        return s.size;
+    }
+};
+
+TEST_F(FrameOfReferencePageTest, TestInt32Random) {
+    const uint32_t size = 10000;
+
+    std::unique_ptr<int32_t[]> ints(new int32_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = random() - (RAND_MAX / 2);
+    }
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_INT>(ints.get(), size);
+}
+
+TEST_F(FrameOfReferencePageTest, TestInt32Extremes) {
+    const uint32_t size = 1000;
+
+    std::unique_ptr<int32_t[]> ints(new int32_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = i % 2 == 0 ? INT32_MIN : INT32_MAX;
+    }
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_INT>(ints.get(), size);
+}
+
+TEST_F(FrameOfReferencePageTest, TestInt32Equal) {
+    const uint32_t size = 10000;
+
+    std::unique_ptr<int32_t[]> ints(new int32_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = 12345;
+    }
+    size_t encoded_size = test_encode_decode_page_template<OLAP_FIELD_TYPE_INT>(ints.get(), size);
+    // only headers of frames are stored
+    ASSERT_LT(encoded_size, 1000);
+}
+
+TEST_F(FrameOfReferencePageTest, TestInt64Sequence) {
+    const uint32_t size = 10000;
+
+    std::unique_ptr<int64_t[]> ints(new int64_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = 1000000000000L + i;
+    }
+    size_t encoded_size = test_encode_decode_page_template<OLAP_FIELD_TYPE_BIGINT>(ints.get(), size);
+    // deltas are all equal, so no bits are needed for packed values
+    ASSERT_LT(encoded_size, 10000 / 128 * 20);
+}
+
+TEST_F(FrameOfReferencePageTest, TestDatetimeClustered) {
+    const uint32_t size = 10000;
+
+    std::unique_ptr<int64_t[]> ints(new int64_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = 20190801000000L + random() % 60;
+    }
+    size_t encoded_size = test_encode_decode_page_template<OLAP_FIELD_TYPE_DATETIME>(ints.get(), size);
+    // 6 bits for every value
+    ASSERT_LT(encoded_size, size);
+}
+
+TEST_F(FrameOfReferencePageTest, TestInt8Random) {
+    const uint32_t size = 1000;
+
+    std::unique_ptr<int8_t[]> ints(new int8_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = random();
+    }
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_TINYINT>(ints.get(), size);
+}
+
+TEST_F(FrameOfReferencePageTest, TestInt32Size) {
+    std::vector<size_t> sizes = {1, 2, 127, 128, 129, 300};
+    for (auto size : sizes) {
+        std::unique_ptr<int32_t[]> ints(new int32_t[size]);
+        for (int i = 0; i < size; i++) {
+            ints.get()[i] = 100 - i * 3;
+        }
+        test_encode_decode_page_template<OLAP_FIELD_TYPE_INT>(ints.get(), size);
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
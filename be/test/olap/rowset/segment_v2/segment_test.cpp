@@ -19,11 +19,13 @@
 #include "olap/rowset/segment_v2/segment_writer.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include <iostream>
 
 #include "common/logging.h"
 #include "olap/olap_common.h"
+#include "olap/olap_cond.h"
 #include "olap/row_cursor.h"
 #include "olap/tablet_schema.h"
 #include "olap/row_block.h"
@@ -246,6 +248,256 @@ TEST_F(SegmentReaderWriterTest, normal) {
             ASSERT_TRUE(st.ok());
             ASSERT_EQ(0, block.num_rows());
         }
+        // test zone map, segment is filtered
+        {
+            std::unique_ptr<SegmentIterator> iter;
+            st = segment->new_iterator(schema, &iter);
+            ASSERT_TRUE(st.ok());
+
+            Conditions conditions;
+            conditions.set_tablet_schema(tablet_schema.get());
+            TCondition condition;
+            condition.column_name = "4";
+            condition.condition_op = ">";
+            condition.condition_values.push_back("100000");
+            ASSERT_EQ(OLAP_SUCCESS, conditions.append_condition(condition));
+
+            StorageReadOptions read_opts;
+            read_opts.conditions = &conditions;
+            st = iter->init(read_opts);
+            ASSERT_TRUE(st.ok());
+
+            Arena arena;
+            RowBlockV2 block(schema, 100, &arena);
+            st = iter->next_batch(&block);
+            ASSERT_TRUE(st.ok());
+            ASSERT_EQ(0, block.num_rows());
+            conditions.finalize();
+        }
+        // test zone map, segment is not filtered
+        {
+            std::unique_ptr<SegmentIterator> iter;
+            st = segment->new_iterator(schema, &iter);
+            ASSERT_TRUE(st.ok());
+
+            Conditions conditions;
+            conditions.set_tablet_schema(tablet_schema.get());
+            TCondition condition;
+            condition.column_name = "4";
+            condition.condition_op = "<";
+            condition.condition_values.push_back("100");
+            ASSERT_EQ(OLAP_SUCCESS, conditions.append_condition(condition));
+
+            StorageReadOptions read_opts;
+            read_opts.conditions = &conditions;
+            st = iter->init(read_opts);
+            ASSERT_TRUE(st.ok());
+
+            Arena arena;
+            RowBlockV2 block(schema, 100, &arena);
+            st = iter->next_batch(&block);
+            ASSERT_TRUE(st.ok());
+            // only rows 0~9 satisfy the condition, other columns are
+            // read only for these rows
+            ASSERT_EQ(10, block.num_rows());
+            for (int j = 0; j < block.schema()->column_ids().size(); ++j) {
+                auto cid = block.schema()->column_ids()[j];
+                auto column_block = block.column_block(j);
+                for (int i = 0; i < 10; ++i) {
+                    ASSERT_EQ(i * 10 + cid, *(int*)column_block.cell_ptr(i));
+                }
+            }
+            st = iter->next_batch(&block);
+            ASSERT_TRUE(st.ok());
+            ASSERT_EQ(0, block.num_rows());
+            conditions.finalize();
+        }
+    }
+}
+
+TEST_F(SegmentReaderWriterTest, append_block) {
+    size_t num_rows_per_block = 10;
+
+    std::shared_ptr<TabletSchema> tablet_schema(new TabletSchema());
+    tablet_schema->_num_columns = 4;
+    tablet_schema->_num_key_columns = 3;
+    tablet_schema->_num_short_key_columns = 2;
+    tablet_schema->_num_rows_per_row_block = num_rows_per_block;
+    tablet_schema->_cols.push_back(create_int_key(1));
+    tablet_schema->_cols.push_back(create_int_key(2));
+    tablet_schema->_cols.push_back(create_int_key(3));
+    tablet_schema->_cols.push_back(create_int_value(4));
+
+    std::string dname = "./ut_dir/segment_test";
+    FileUtils::create_dir(dname);
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = num_rows_per_block;
+
+    std::string fname = dname + "/append_block_case";
+    SegmentWriter writer(fname, 0, tablet_schema.get(), opts);
+    auto st = writer.init(10);
+    ASSERT_TRUE(st.ok());
+
+    // blocks are not aligned to num_rows_per_block
+    Schema schema(*tablet_schema);
+    Arena write_arena;
+    RowBlockV2 write_block(schema, 333, &write_arena);
+    int rowid = 0;
+    while (rowid < 4096) {
+        int num_rows = std::min(333, 4096 - rowid);
+        for (int j = 0; j < 4; ++j) {
+            auto column_block = write_block.column_block(j);
+            for (int i = 0; i < num_rows; ++i) {
+                if (column_block.is_nullable()) {
+                    column_block.set_is_null(i, false);
+                }
+                *(int*)column_block.mutable_cell_ptr(i) = (rowid + i) * 10 + j;
+            }
+        }
+        write_block.resize(num_rows);
+        ASSERT_TRUE(writer.append_block(write_block).ok());
+        rowid += num_rows;
+    }
+
+    uint32_t file_size = 0;
+    st = writer.finalize(&file_size);
+    ASSERT_TRUE(st.ok());
+
+    std::shared_ptr<Segment> segment(new Segment(fname, 0, tablet_schema, num_rows_per_block));
+    st = segment->open();
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(4096, segment->num_rows());
+    // scan all rows
+    {
+        std::unique_ptr<SegmentIterator> iter;
+        st = segment->new_iterator(schema, &iter);
+        ASSERT_TRUE(st.ok());
+        StorageReadOptions read_opts;
+        st = iter->init(read_opts);
+        ASSERT_TRUE(st.ok());
+
+        Arena arena;
+        RowBlockV2 block(schema, 1024, &arena);
+        rowid = 0;
+        while (rowid < 4096) {
+            st = iter->next_batch(&block);
+            ASSERT_TRUE(st.ok());
+            ASSERT_EQ(1024, block.num_rows());
+            for (int j = 0; j < 4; ++j) {
+                auto column_block = block.column_block(j);
+                for (int i = 0; i < block.num_rows(); ++i) {
+                    ASSERT_EQ((rowid + i) * 10 + j, *(int*)column_block.cell_ptr(i));
+                }
+            }
+            rowid += block.num_rows();
+        }
+    }
+    // seek by short key index
+    {
+        std::unique_ptr<SegmentIterator> iter;
+        st = segment->new_iterator(schema, &iter);
+        ASSERT_TRUE(st.ok());
+
+        StorageReadOptions read_opts;
+        read_opts.lower_bound.reset(new RowCursor());
+        RowCursor* lower_bound = read_opts.lower_bound.get();
+        lower_bound->init(*tablet_schema, 1);
+        {
+            auto cell = lower_bound->cell(0);
+            cell.set_not_null();
+            *(int*)cell.mutable_cell_ptr() = 33330;
+        }
+        read_opts.include_lower_bound = true;
+        st = iter->init(read_opts);
+        ASSERT_TRUE(st.ok());
+
+        Arena arena;
+        RowBlockV2 block(schema, 100, &arena);
+        st = iter->next_batch(&block);
+        ASSERT_TRUE(st.ok());
+        ASSERT_EQ(100, block.num_rows());
+        ASSERT_EQ(33330, *(int*)block.column_block(0).cell_ptr(0));
+    }
+}
+
+TEST_F(SegmentReaderWriterTest, append_columns) {
+    size_t num_rows_per_block = 10;
+
+    std::shared_ptr<TabletSchema> tablet_schema(new TabletSchema());
+    tablet_schema->_num_columns = 5;
+    tablet_schema->_num_key_columns = 2;
+    tablet_schema->_num_short_key_columns = 2;
+    tablet_schema->_num_rows_per_row_block = num_rows_per_block;
+    tablet_schema->_cols.push_back(create_int_key(1));
+    tablet_schema->_cols.push_back(create_int_key(2));
+    tablet_schema->_cols.push_back(create_int_value(3));
+    tablet_schema->_cols.push_back(create_int_value(4));
+    tablet_schema->_cols.push_back(create_int_value(5));
+
+    std::string dname = "./ut_dir/segment_test";
+    FileUtils::create_dir(dname);
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = num_rows_per_block;
+
+    std::string fname = dname + "/append_columns_case";
+    SegmentWriter writer(fname, 0, tablet_schema.get(), opts);
+    auto st = writer.init(10);
+    ASSERT_TRUE(st.ok());
+
+    // write key group first, then value groups
+    std::vector<std::vector<uint32_t>> groups = {{0, 1}, {2, 3}, {4}};
+    for (auto& group : groups) {
+        std::vector<uint32_t> columns = {0, 1};
+        for (auto cid : group) {
+            if (cid >= 2) {
+                columns.push_back(cid);
+            }
+        }
+        RowCursor row;
+        ASSERT_EQ(OLAP_SUCCESS, row.init(*tablet_schema, columns));
+        for (int i = 0; i < 4096; ++i) {
+            for (auto cid : columns) {
+                auto cell = row.cell(cid);
+                cell.set_not_null();
+                *(int*)cell.mutable_cell_ptr() = i * 10 + cid;
+            }
+            ASSERT_TRUE(writer.append_columns(row, group).ok());
+        }
+    }
+
+    uint32_t file_size = 0;
+    st = writer.finalize(&file_size);
+    ASSERT_TRUE(st.ok());
+
+    std::shared_ptr<Segment> segment(new Segment(fname, 0, tablet_schema, num_rows_per_block));
+    st = segment->open();
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(4096, segment->num_rows());
+
+    Schema schema(*tablet_schema);
+    std::unique_ptr<SegmentIterator> iter;
+    st = segment->new_iterator(schema, &iter);
+    ASSERT_TRUE(st.ok());
+    StorageReadOptions read_opts;
+    st = iter->init(read_opts);
+    ASSERT_TRUE(st.ok());
+
+    Arena arena;
+    RowBlockV2 block(schema, 1024, &arena);
+    int rowid = 0;
+    while (rowid < 4096) {
+        st = iter->next_batch(&block);
+        ASSERT_TRUE(st.ok());
+        ASSERT_EQ(1024, block.num_rows());
+        for (int j = 0; j < 5; ++j) {
+            auto column_block = block.column_block(j);
+            for (int i = 0; i < block.num_rows(); ++i) {
+                ASSERT_EQ((rowid + i) * 10 + j, *(int*)column_block.cell_ptr(i));
+            }
+        }
+        rowid += block.num_rows();
     }
 }
 
@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset_graph.h"
+
+#include <gtest/gtest.h>
+
+namespace doris {
+
+TEST(RowsetGraphTest, cached_path) {
+    RowsetGraph graph;
+    for (int64_t v = 0; v <= 5; ++v) {
+        ASSERT_EQ(OLAP_SUCCESS, graph.add_version_to_graph(Version(v, v)));
+    }
+
+    std::vector<Version> path;
+    ASSERT_EQ(OLAP_SUCCESS, graph.capture_consistent_versions(Version(0, 5), &path));
+    ASSERT_EQ(6, path.size());
+
+    // a new version following the cached path extends it
+    ASSERT_EQ(OLAP_SUCCESS, graph.add_version_to_graph(Version(6, 6)));
+    path.clear();
+    ASSERT_EQ(OLAP_SUCCESS, graph.capture_consistent_versions(Version(0, 6), &path));
+    ASSERT_EQ(7, path.size());
+    ASSERT_EQ(Version(6, 6), path.back());
+
+    // a compacted version makes a shorter path
+    ASSERT_EQ(OLAP_SUCCESS, graph.add_version_to_graph(Version(0, 4)));
+    path.clear();
+    ASSERT_EQ(OLAP_SUCCESS, graph.capture_consistent_versions(Version(0, 6), &path));
+    ASSERT_EQ(3, path.size());
+    ASSERT_EQ(Version(0, 4), path[0]);
+
+    // versions merged are removed from graph
+    for (int64_t v = 0; v <= 4; ++v) {
+        ASSERT_EQ(OLAP_SUCCESS, graph.delete_version_from_graph(Version(v, v)));
+    }
+    ASSERT_EQ(OLAP_SUCCESS, graph.delete_version_from_graph(Version(0, 4)));
+    path.clear();
+    ASSERT_NE(OLAP_SUCCESS, graph.capture_consistent_versions(Version(0, 6), &path));
+    path.clear();
+    ASSERT_EQ(OLAP_SUCCESS, graph.capture_consistent_versions(Version(5, 6), &path));
+    ASSERT_EQ(2, path.size());
+}
+
+} // namespace doris
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
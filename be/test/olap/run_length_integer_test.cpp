@@ -583,6 +583,30 @@ TEST_F(TestRunLengthUnsignInteger, ReadWriteMassInteger) {
 
 }
 
+TEST_F(TestRunLengthUnsignInteger, ReadWriteMassIntegerByBatch) {
+    // write data, with both repeated runs and delta runs
+    for (int64_t i = 0; i < 100000; i++) {
+        ASSERT_EQ(OLAP_SUCCESS, _writer->write(i % 1000 < 500 ? 7 : i));
+    }
+
+    ASSERT_EQ(OLAP_SUCCESS, _writer->flush());
+
+    // read data, batches don't align with runs
+    CreateReader();
+
+    int32_t values[1023];
+    int64_t i = 0;
+    while (i < 100000) {
+        size_t num = std::min<int64_t>(1023, 100000 - i);
+        ASSERT_EQ(OLAP_SUCCESS, _reader->next_batch(values, num));
+        for (size_t j = 0; j < num; ++j, ++i) {
+            ASSERT_EQ(values[j], i % 1000 < 500 ? 7 : i);
+        }
+    }
+    ASSERT_FALSE(_reader->has_next());
+    ASSERT_NE(OLAP_SUCCESS, _reader->next_batch(values, 1));
+}
+
 TEST_F(TestRunLengthSignInteger, PatchedBaseEncoding1) { 
     // write data
     int64_t write_data[] = {1703, 6054, -876012345678912, 902, 9292, 184932,873624, 827364, 999, 8,
@@ -0,0 +1,63 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/segment_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/tablet_schema.h"
+
+namespace doris {
+
+using segment_v2::Segment;
+using segment_v2::SegmentSharedPtr;
+
+TEST(SegmentCacheTest, normal) {
+    SegmentCache cache(10 * 1024);
+    auto schema = std::make_shared<TabletSchema>();
+
+    SegmentCache::CacheKey key(10001, 0);
+    SegmentSharedPtr segment = std::make_shared<Segment>("10001_0.dat", 0, schema, 1024);
+    cache.insert(key, segment, 1024);
+    // cache hit
+    ASSERT_EQ(segment, cache.lookup(key));
+    // cache miss on other segment of the same rowset and same segment of other rowset
+    ASSERT_EQ(nullptr, cache.lookup(SegmentCache::CacheKey(10001, 1)));
+    ASSERT_EQ(nullptr, cache.lookup(SegmentCache::CacheKey(10002, 0)));
+
+    // erased segment is still usable by its holder
+    cache.erase(key);
+    ASSERT_EQ(nullptr, cache.lookup(key));
+    ASSERT_EQ(1, segment.use_count());
+
+    cache.insert(key, segment, 1024);
+    // put too many segments to evict the first one
+    for (int i = 1; i <= 200; ++i) {
+        cache.insert(SegmentCache::CacheKey(10001, i),
+                     std::make_shared<Segment>("10001_x.dat", i, schema, 1024), 1024);
+    }
+    ASSERT_EQ(nullptr, cache.lookup(key));
+    ASSERT_EQ(1, segment.use_count());
+}
+
+} // namespace doris
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -90,6 +90,43 @@ TEST_F(ShortKeyIndexTest, buider) {
 }
 
 
+// keys share prefixes longer than 8 bytes, which can't be distinguished by
+// prefix array of decoder
+TEST_F(ShortKeyIndexTest, long_common_prefix) {
+    ShortKeyIndexBuilder builder(0, 1024);
+    std::vector<std::string> keys;
+    keys.emplace_back("");
+    keys.emplace_back("aaaa");
+    for (int i = 1000; i < 2000; i += 2) {
+        keys.emplace_back("aaaaaaaaaaaa" + std::to_string(i));
+    }
+    keys.emplace_back("aaaab");
+    keys.emplace_back("\xff\xff\xff\xff\xff\xff\xff\xff\xff");
+    for (auto& key : keys) {
+        builder.add_item(key);
+    }
+    std::vector<Slice> slices;
+    ASSERT_TRUE(builder.finalize(10000, keys.size() * 1024, &slices).ok());
+    std::string buf;
+    for (auto& slice : slices) {
+        buf.append(slice.data, slice.size);
+    }
+
+    ShortKeyIndexDecoder decoder(buf);
+    ASSERT_TRUE(decoder.parse().ok());
+    ASSERT_EQ(keys.size(), decoder.num_items());
+
+    for (int i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(i, decoder.lower_bound(keys[i]).ordinal());
+        ASSERT_EQ(i + 1, decoder.upper_bound(keys[i]).ordinal());
+    }
+    ASSERT_STREQ("aaaaaaaaaaaa1500", (*decoder.lower_bound("aaaaaaaaaaaa1499")).to_string().c_str());
+    ASSERT_STREQ("aaaaaaaaaaaa1000", (*decoder.upper_bound("aaaaaaaaaaaa")).to_string().c_str());
+    ASSERT_STREQ("aaaab", (*decoder.upper_bound("aaaaaaaaaaaa1998")).to_string().c_str());
+    ASSERT_FALSE(decoder.upper_bound("\xff\xff\xff\xff\xff\xff\xff\xff\xff").valid());
+    ASSERT_EQ(keys.size() - 1, decoder.lower_bound("\xff\xff\xff\xff\xff\xff\xff\xff").ordinal());
+}
+
 TEST_F(ShortKeyIndexTest, enocde) {
     TabletSchema tablet_schema;
     tablet_schema._cols.push_back(create_int_key(0));
@@ -212,6 +212,56 @@ TEST_F(TabletMgrTest, DropTablet) {
     ASSERT_TRUE(!dir_exist);
 }
 
+TEST_F(TabletMgrTest, IterateTabletsOfAllShards) {
+    TColumnType col_type;
+    col_type.__set_type(TPrimitiveType::SMALLINT);
+    TColumn col1;
+    col1.__set_column_name("col1");
+    col1.__set_column_type(col_type);
+    col1.__set_is_key(true);
+    std::vector<TColumn> cols;
+    cols.push_back(col1);
+    TTabletSchema tablet_schema;
+    tablet_schema.__set_short_key_column_count(1);
+    tablet_schema.__set_schema_hash(3333);
+    tablet_schema.__set_keys_type(TKeysType::AGG_KEYS);
+    tablet_schema.__set_storage_type(TStorageType::COLUMN);
+    tablet_schema.__set_columns(cols);
+    TCreateTabletReq create_tablet_req;
+    create_tablet_req.__set_tablet_schema(tablet_schema);
+    create_tablet_req.__set_version(2);
+    create_tablet_req.__set_version_hash(3333);
+    vector<DataDir*> data_dirs;
+    data_dirs.push_back(_data_dir);
+    // tablets are in different shards of tablet map
+    for (int64_t tablet_id = 111; tablet_id < 115; ++tablet_id) {
+        create_tablet_req.__set_tablet_id(tablet_id);
+        OLAPStatus create_st = _tablet_mgr.create_tablet(create_tablet_req, data_dirs);
+        ASSERT_TRUE(create_st == OLAP_SUCCESS);
+    }
+
+    std::map<std::string, DataDirInfo> path_map;
+    int tablet_counter = 0;
+    _tablet_mgr.update_root_path_info(&path_map, &tablet_counter);
+    ASSERT_EQ(4, tablet_counter);
+    for (int64_t tablet_id = 111; tablet_id < 115; ++tablet_id) {
+        ASSERT_TRUE(_tablet_mgr.get_tablet(tablet_id, 3333) != nullptr);
+    }
+
+    // dropped tablet should not be iterated any more
+    OLAPStatus drop_st = _tablet_mgr.drop_tablet(112, 3333, false);
+    ASSERT_TRUE(drop_st == OLAP_SUCCESS);
+    tablet_counter = 0;
+    _tablet_mgr.update_root_path_info(&path_map, &tablet_counter);
+    ASSERT_EQ(3, tablet_counter);
+    ASSERT_TRUE(_tablet_mgr.get_tablet(112, 3333) == nullptr);
+
+    for (int64_t tablet_id = 111; tablet_id < 115; ++tablet_id) {
+        drop_st = _tablet_mgr.drop_tablet(tablet_id, 3333, false);
+        ASSERT_TRUE(drop_st == OLAP_SUCCESS);
+    }
+}
+
 }  // namespace doris
 
 int main(int argc, char **argv) {
@@ -251,6 +251,40 @@ TEST_F(TxnManagerTest, DeleteCommittedTxn) {
     ASSERT_TRUE(status != OLAP_SUCCESS);
 }
 
+TEST_F(TxnManagerTest, GetAndRollbackTabletRelatedTxns) {
+    // txns are in different shards of txn map
+    for (TTransactionId txn_id = transaction_id; txn_id < transaction_id + 3; ++txn_id) {
+        OLAPStatus status = _txn_mgr.prepare_txn(partition_id, txn_id,
+            tablet_id, schema_hash, _tablet_uid, load_id);
+        ASSERT_TRUE(status == OLAP_SUCCESS);
+    }
+    // txn of another tablet should not be returned
+    OLAPStatus status = _txn_mgr.prepare_txn(partition_id, transaction_id,
+        tablet_id + 1, schema_hash, _tablet_uid, load_id);
+    ASSERT_TRUE(status == OLAP_SUCCESS);
+
+    int64_t related_partition_id = 0;
+    std::set<int64_t> transaction_ids;
+    _txn_mgr.get_tablet_related_txns(tablet_id, schema_hash, _tablet_uid,
+        &related_partition_id, &transaction_ids);
+    ASSERT_EQ(partition_id, related_partition_id);
+    ASSERT_EQ(3, transaction_ids.size());
+
+    std::set<TabletInfo> tablet_infos;
+    _txn_mgr.get_all_related_tablets(&tablet_infos);
+    ASSERT_EQ(2, tablet_infos.size());
+
+    _txn_mgr.force_rollback_tablet_related_txns(_meta, tablet_id, schema_hash, _tablet_uid);
+    transaction_ids.clear();
+    _txn_mgr.get_tablet_related_txns(tablet_id, schema_hash, _tablet_uid,
+        &related_partition_id, &transaction_ids);
+    ASSERT_TRUE(transaction_ids.empty());
+    ASSERT_FALSE(_txn_mgr.has_txn(partition_id, transaction_id + 1,
+        tablet_id, schema_hash, _tablet_uid));
+    ASSERT_TRUE(_txn_mgr.has_txn(partition_id, transaction_id,
+        tablet_id + 1, schema_hash, _tablet_uid));
+}
+
 }  // namespace doris
 
 int main(int argc, char **argv) {
@@ -1260,6 +1260,21 @@ TEST_F(BufferedBlockMgrTest, Multi4Random_plain) {
     TestRandomInternalMulti(4, 8 * 1024 * 1024);
 }
 
+TEST_F(BufferedBlockMgrTest, SingleRandom_compressed) {
+    config::spill_compression = true;
+    TestRandomInternalSingle(1024);
+    TestRandomInternalSingle(8 * 1024);
+    TestRandomInternalSingle(8 * 1024 * 1024);
+    config::spill_compression = false;
+}
+
+TEST_F(BufferedBlockMgrTest, Multi2Random_compressed) {
+    config::spill_compression = true;
+    TestRandomInternalMulti(2, 1024);
+    TestRandomInternalMulti(2, 8 * 1024);
+    config::spill_compression = false;
+}
+
 // TODO: Enable when we improve concurrency/scalability of block mgr.
 TEST_F(BufferedBlockMgrTest, DISABLED_Multi8Random_plain) {
     TestRandomInternalMulti(8, 1024);
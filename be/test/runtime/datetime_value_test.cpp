@@ -248,6 +248,44 @@ TEST_F(DateTimeValueTest, check_date) {
     ASSERT_FALSE(value.check_date());
 }
 
+TEST_F(DateTimeValueTest, from_fixed_date_str) {
+    // 'YYYY-MM-DD' and 'YYYY-MM-DD HH:MM:SS' take a fast path, which has to agree with
+    // the generic parsing of the same value in another layout.
+    const char* cases[][2] = {
+        {"2019-07-15", "2019/07/15"},
+        {"2019-07-15 12:34:56", "2019/07/15 12.34.56"},
+        {"0000-01-01 00:00:00", "0000/01/01 00.00.00"},
+        {"9999-12-31 23:59:59", "9999/12/31 23.59.59"},
+        {"2000-02-29", "2000/02/29"},
+    };
+    for (auto& c : cases) {
+        DateTimeValue fixed;
+        DateTimeValue generic;
+        ASSERT_TRUE(fixed.from_date_str(c[0], strlen(c[0]))) << c[0];
+        ASSERT_TRUE(generic.from_date_str(c[1], strlen(c[1]))) << c[1];
+        ASSERT_EQ(generic._type, fixed._type);
+        ASSERT_EQ(generic.to_int64(), fixed.to_int64());
+        char buf[64];
+        fixed.to_string(buf);
+        ASSERT_STREQ(c[0], buf);
+    }
+
+    const char* invalid[] = {
+        "2019-02-29", "2019-13-01", "2019-00-10", "2019-07-32",
+        "2019-07-15 24:00:00", "2019-07-15 12:60:00", "2019-07-15 12:00:60",
+    };
+    for (auto str : invalid) {
+        DateTimeValue value;
+        ASSERT_FALSE(value.from_date_str(str, strlen(str))) << str;
+    }
+
+    // Same lengths but not the fixed layout, handled by the generic parsing.
+    DateTimeValue value;
+    ASSERT_TRUE(value.from_date_str("2019/07/15", 10));
+    ASSERT_EQ(20190715, value.to_int64());
+    ASSERT_TRUE(value.from_date_str("2019-07-15T12:34:56", 19));
+}
+
 // Calculate format
 TEST_F(DateTimeValueTest, week) {
     std::string date_str;
@@ -324,6 +362,42 @@ TEST_F(DateTimeValueTest, unix_timestamp) {
     ASSERT_EQ(2147529600, timestamp);
 }
 
+TEST_F(DateTimeValueTest, dst_region) {
+    char str[MAX_DTVALUE_STR_LEN];
+    DateTimeValue value;
+    // Daylight saving time starts at 2019-03-10 02:00:00 PST and ends at
+    // 2019-11-03 02:00:00 PDT
+    value.from_unixtime(1552211999, "America/Los_Angeles");
+    value.to_string(str);
+    ASSERT_STREQ("2019-03-10 01:59:59", str);
+    value.from_unixtime(1552212000, "America/Los_Angeles");
+    value.to_string(str);
+    ASSERT_STREQ("2019-03-10 03:00:00", str);
+    value.from_unixtime(1572771599, "America/Los_Angeles");
+    value.to_string(str);
+    ASSERT_STREQ("2019-11-03 01:59:59", str);
+    value.from_unixtime(1572771600, "America/Los_Angeles");
+    value.to_string(str);
+    ASSERT_STREQ("2019-11-03 01:00:00", str);
+    // past the precomputed transitions
+    value.from_unixtime(10429473600, "America/Los_Angeles");
+    value.to_string(str);
+    ASSERT_STREQ("2300-07-01 05:00:00", str);
+
+    int64_t timestamp;
+    value.from_date_int64(20190806013857);
+    value.unix_timestamp(&timestamp, "America/Los_Angeles");
+    ASSERT_EQ(1565080737, timestamp);
+    value.from_date_int64(20190106013857);
+    value.unix_timestamp(&timestamp, "America/Los_Angeles");
+    ASSERT_EQ(1546767537, timestamp);
+    value.from_date_int64(23000701050000);
+    value.unix_timestamp(&timestamp, "America/Los_Angeles");
+    ASSERT_EQ(10429473600, timestamp);
+
+    ASSERT_FALSE(value.from_unixtime(0, "Mars/Olympus_Mons"));
+}
+
 // Calculate format
 TEST_F(DateTimeValueTest, add_interval) {
     // Used to check
@@ -1396,6 +1470,34 @@ TEST_F(DateTimeValueTest, packed_time) {
 
 }
 
+TEST_F(DateTimeValueTest, packed_key) {
+    const int64_t values[] = {
+        101000000L, 19991231235959L, 20000101000000L, 20000101000001L,
+        20000101000100L, 20000101010000L, 20000102000000L, 20000201000000L,
+        20010101000000L, 99991231235959L};
+    for (int i = 1; i < sizeof(values) / sizeof(values[0]); ++i) {
+        DateTimeValue v1;
+        DateTimeValue v2;
+        ASSERT_TRUE(v1.from_date_int64(values[i - 1]));
+        ASSERT_TRUE(v2.from_date_int64(values[i]));
+        ASSERT_LT(v1.packed_key(), v2.packed_key());
+        ASSERT_LT(v1.compare(v2), 0);
+        ASSERT_GT(v2.compare(v1), 0);
+        ASSERT_TRUE(v1 < v2);
+        ASSERT_EQ(v1.to_int64_datetime_packed() < v2.to_int64_datetime_packed(),
+                  v1 < v2);
+    }
+
+    // a date equals the datetime at its midnight, so they hash the same
+    DateTimeValue date;
+    date.from_date_int64(20190716);
+    DateTimeValue datetime;
+    datetime.from_date_int64(20190716000000L);
+    ASSERT_EQ(0, date.compare(datetime));
+    ASSERT_EQ(date.hash(0), datetime.hash(0));
+    ASSERT_EQ(hash_value(date), hash_value(datetime));
+}
+
 }
 
 int main(int argc, char** argv) {
@@ -271,6 +271,35 @@ TEST_F(DecimalV2ValueTest, div) {
         std::cout << "div_result1: " << div_result1.get_debug_info() << std::endl;
         ASSERT_EQ(DecimalV2Value(std::string("0.054197328")), div_result1);
     }
+    {
+        DecimalV2Value value11(std::string("2"));
+        DecimalV2Value value12(std::string("-3"));
+        ASSERT_EQ("-0.666666667", (value11 / value12).to_string());
+        ASSERT_EQ("0.333333333", (DecimalV2Value(std::string("1")) / -value12).to_string());
+    }
+}
+
+// Operands fitting in an int64 take the 64-bit paths, results must not change.
+TEST_F(DecimalV2ValueTest, small_value_arith) {
+    DecimalV2Value one_nano(std::string("0.000000001"));
+    ASSERT_EQ("0.000000002", (DecimalV2Value(std::string("1.5")) * one_nano).to_string());
+    ASSERT_EQ("-0.000000001", (DecimalV2Value(std::string("-1.4")) * one_nano).to_string());
+    ASSERT_EQ("-7006294.627600743",
+              (DecimalV2Value(std::string("-1234.56789")) * DecimalV2Value(std::string("5675.0987")))
+              .to_string());
+
+    // Both operands fit in an int64, but the product overflows
+    DecimalV2Value big(std::string("9000000000"));
+    ASSERT_EQ(DecimalV2Value(DecimalV2Value::MAX_DECIMAL_VALUE), big * big);
+
+    DecimalV2Value max_int64(static_cast<int128_t>(DecimalV2Value::MAX_INT64));
+    ASSERT_EQ("18446744073.709551614", (max_int64 + max_int64).to_string());
+    ASSERT_EQ("-18446744073.709551614", (-max_int64 - max_int64).to_string());
+
+    ASSERT_EQ(0.1, (double)DecimalV2Value(std::string("0.1")));
+    ASSERT_EQ(-123456.789, (double)DecimalV2Value(std::string("-123456.789")));
+    ASSERT_EQ(-1234, DecimalV2Value(std::string("-1234.56789")).int_value());
+    ASSERT_EQ(-567890000, DecimalV2Value(std::string("-1234.56789")).frac_value());
 }
 
 TEST_F(DecimalV2ValueTest, unary_minus_operator) {
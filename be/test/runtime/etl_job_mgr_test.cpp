@@ -26,7 +26,8 @@
 namespace doris {
 // Mock fragment mgr
 Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params,
-                                       FinishCallback cb) {
+                                       FinishCallback cb,
+                                       const std::shared_ptr<FragmentSharedState>& shared_state) {
     return Status::OK();
 }
 
@@ -29,7 +29,8 @@
 namespace doris {
 
 // Mock fragment mgr
-Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, FinishCallback cb) {
+Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, FinishCallback cb,
+                                       const std::shared_ptr<FragmentSharedState>& shared_state) {
     return Status::OK();
 }
 
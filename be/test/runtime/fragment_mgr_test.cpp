@@ -15,6 +15,8 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <atomic>
+
 #include <gtest/gtest.h>
 #include "runtime/fragment_mgr.h"
 #include "runtime/plan_fragment_executor.h"
@@ -36,7 +38,8 @@ PlanFragmentExecutor::PlanFragmentExecutor(ExecEnv* exec_env,
 PlanFragmentExecutor::~PlanFragmentExecutor() {
 }
 
-Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request) {
+Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request,
+                                     const std::shared_ptr<FragmentSharedState>& shared_state) {
     return s_prepare_status;
 }
 
@@ -120,6 +123,64 @@ TEST_F(FragmentMgrTest, PrepareFailed) {
     ASSERT_FALSE(mgr.exec_plan_fragment(params).ok());
 }
 
+TEST_F(FragmentMgrTest, Batch) {
+    FragmentMgr mgr(nullptr);
+    TExecPlanFragmentBatchParams params;
+    for (int i = 0; i < 4; ++i) {
+        TPlanFragmentExecParams instance_params;
+        instance_params.fragment_instance_id.__set_hi(100 + i);
+        instance_params.fragment_instance_id.__set_lo(200);
+        params.instance_params.push_back(instance_params);
+        params.backend_nums.push_back(i);
+    }
+    ASSERT_TRUE(mgr.exec_plan_fragment_batch(&params).ok());
+    // the instances are registered
+    for (int i = 0; i < 4; ++i) {
+        TUniqueId id;
+        id.__set_hi(100 + i);
+        id.__set_lo(200);
+        ASSERT_TRUE(mgr.cancel(id).ok());
+    }
+
+    // every instance needs its backend num
+    params.backend_nums.pop_back();
+    ASSERT_FALSE(mgr.exec_plan_fragment_batch(&params).ok());
+}
+
+TEST_F(FragmentMgrTest, AdmissionQueue) {
+    config::max_running_fragments_per_user = 1;
+    config::max_queued_fragments_per_user = 2;
+    std::atomic<int> num_finished(0);
+    FragmentMgr mgr(nullptr);
+    for (int i = 0; i < 4; ++i) {
+        TExecPlanFragmentParams params;
+        params.params.fragment_instance_id = TUniqueId();
+        params.params.fragment_instance_id.__set_hi(100 + i);
+        params.params.fragment_instance_id.__set_lo(200);
+        TResourceInfo resource_info;
+        resource_info.user = "etl";
+        resource_info.group = "low";
+        params.__set_resource_info(resource_info);
+        Status status = mgr.exec_plan_fragment(params,
+                [&num_finished](PlanFragmentExecutor* executor) { ++num_finished; });
+        // One running, two queued, the last one is rejected
+        ASSERT_EQ(i < 3, status.ok());
+    }
+    // Fragments of other users are not affected
+    TExecPlanFragmentParams params;
+    params.params.fragment_instance_id = TUniqueId();
+    params.params.fragment_instance_id.__set_hi(200);
+    params.params.fragment_instance_id.__set_lo(200);
+    ASSERT_TRUE(mgr.exec_plan_fragment(params,
+            [&num_finished](PlanFragmentExecutor* executor) { ++num_finished; }).ok());
+
+    for (int i = 0; i < 100 && num_finished < 4; ++i) {
+        usleep(50000);
+    }
+    ASSERT_EQ(4, num_finished);
+    config::max_running_fragments_per_user = 0;
+}
+
 }
 
 int main(int argc, char** argv) {
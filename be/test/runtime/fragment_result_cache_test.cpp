@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/fragment_result_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "gen_cpp/PaloInternalService_types.h"
+
+namespace doris {
+
+class FragmentResultCacheTest : public testing::Test {
+public:
+    FragmentResultCacheTest() { }
+    virtual ~FragmentResultCacheTest() { }
+};
+
+static void add_scan_range(int64_t tablet_id, const std::string& version,
+                           TExecPlanFragmentParams* request) {
+    TScanRangeParams scan_range;
+    scan_range.scan_range.__isset.palo_scan_range = true;
+    scan_range.scan_range.palo_scan_range.tablet_id = tablet_id;
+    scan_range.scan_range.palo_scan_range.version = version;
+    scan_range.scan_range.palo_scan_range.version_hash = "0";
+    request->params.per_node_scan_ranges[1].push_back(scan_range);
+}
+
+// agg(0) <- olap scan(1)
+static TExecPlanFragmentParams make_request() {
+    TExecPlanFragmentParams request;
+    request.query_options.__set_enable_fragment_result_cache(true);
+    request.fragment.__isset.output_sink = true;
+    request.fragment.output_sink.type = TDataSinkType::DATA_STREAM_SINK;
+
+    TPlanNode agg_node;
+    agg_node.node_id = 0;
+    agg_node.node_type = TPlanNodeType::AGGREGATION_NODE;
+    agg_node.num_children = 1;
+    request.fragment.plan.nodes.push_back(agg_node);
+    TPlanNode scan_node;
+    scan_node.node_id = 1;
+    scan_node.node_type = TPlanNodeType::OLAP_SCAN_NODE;
+    request.fragment.plan.nodes.push_back(scan_node);
+
+    add_scan_range(10001, "5", &request);
+    add_scan_range(10002, "6", &request);
+    return request;
+}
+
+TEST_F(FragmentResultCacheTest, make_key) {
+    TExecPlanFragmentParams request = make_request();
+    std::string key = FragmentResultCache::make_key(request);
+    ASSERT_FALSE(key.empty());
+
+    // order of scan ranges doesn't matter
+    TExecPlanFragmentParams reordered = make_request();
+    std::reverse(reordered.params.per_node_scan_ranges[1].begin(),
+                 reordered.params.per_node_scan_ranges[1].end());
+    ASSERT_EQ(key, FragmentResultCache::make_key(reordered));
+
+    // a load bumps the version
+    TExecPlanFragmentParams loaded = make_request();
+    loaded.params.per_node_scan_ranges[1][1].scan_range.palo_scan_range.version = "7";
+    ASSERT_NE(key, FragmentResultCache::make_key(loaded));
+
+    TExecPlanFragmentParams disabled = make_request();
+    disabled.query_options.__set_enable_fragment_result_cache(false);
+    ASSERT_TRUE(FragmentResultCache::make_key(disabled).empty());
+
+    TExecPlanFragmentParams nondeterministic = make_request();
+    TExprNode fn_node;
+    fn_node.__isset.fn = true;
+    fn_node.fn.name.function_name = "rand";
+    TExpr expr;
+    expr.nodes.push_back(fn_node);
+    nondeterministic.fragment.plan.nodes[1].conjuncts.push_back(expr);
+    ASSERT_TRUE(FragmentResultCache::make_key(nondeterministic).empty());
+
+    TExecPlanFragmentParams no_agg = make_request();
+    no_agg.fragment.plan.nodes.erase(no_agg.fragment.plan.nodes.begin());
+    ASSERT_TRUE(FragmentResultCache::make_key(no_agg).empty());
+}
+
+TEST_F(FragmentResultCacheTest, lookup) {
+    FragmentResultCache cache(1024 * 1024);
+    ASSERT_TRUE(cache.lookup("key") == nullptr);
+
+    std::shared_ptr<FragmentResult> result(new FragmentResult());
+    result->batches.emplace_back();
+    result->batches.back().set_num_rows(3);
+    result->bytes = 100;
+    cache.insert("key", result);
+
+    std::shared_ptr<const FragmentResult> cached = cache.lookup("key");
+    ASSERT_TRUE(cached != nullptr);
+    ASSERT_EQ(1U, cached->batches.size());
+    ASSERT_EQ(3, cached->batches[0].num_rows());
+
+    // replaced by another instance of the same fragment
+    std::shared_ptr<FragmentResult> other(new FragmentResult());
+    cache.insert("key", other);
+    ASSERT_EQ(0U, cache.lookup("key")->batches.size());
+    // the replaced result is still valid for its users
+    ASSERT_EQ(3, cached->batches[0].num_rows());
+}
+
+} // end namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
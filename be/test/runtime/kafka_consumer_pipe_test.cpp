@@ -68,6 +68,38 @@ TEST_F(KafkaConsumerPipeTest, append_read) {
     ASSERT_EQ(eof, true);
 }
 
+TEST_F(KafkaConsumerPipeTest, append_batch) {
+    KafkaConsumerPipe k_pipe(1024 * 1024, 64 * 1024);
+
+    // msgs batched by consumer are appended as one chunk
+    std::string msgs = "i have a dream\nThis is from kafka\n";
+    ByteBufferPtr batch = ByteBuffer::allocate(256);
+    batch->put_bytes(msgs.c_str(), msgs.length());
+    batch->flip();
+
+    Status st;
+    st = k_pipe.append_with_line_delimiter("first", 5);
+    ASSERT_TRUE(st.ok());
+    st = k_pipe.append(batch);
+    ASSERT_TRUE(st.ok());
+    st = k_pipe.finish();
+    ASSERT_TRUE(st.ok());
+
+    char buf[1024];
+    size_t data_size = 1024;
+    bool eof = false;
+    st = k_pipe.read((uint8_t*) buf, &data_size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(eof, false);
+    ASSERT_EQ("first\n" + msgs, std::string(buf, data_size));
+
+    data_size = 1024;
+    st = k_pipe.read((uint8_t*) buf, &data_size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(data_size, 0);
+    ASSERT_EQ(eof, true);
+}
+
 }
 
 int main(int argc, char* argv[]) {
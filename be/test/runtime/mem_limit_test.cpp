@@ -17,6 +17,9 @@
 
 #include "runtime/mem_tracker.h"
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "util/metrics.h"
@@ -188,6 +191,48 @@ TEST(MemTestTest, TrackerHierarchyTryConsume) {
     EXPECT_FALSE(p.limit_exceeded());
 }
 
+TEST(MemTestTest, BatchedConsumption) {
+    MemTracker p(1000);
+    MemTracker c(-1, "", &p);
+
+    // Small deltas are buffered per core, but still counted everywhere
+    c.consume(600);
+    EXPECT_EQ(c.consumption(), 600);
+    EXPECT_EQ(p.consumption(), 600);
+    EXPECT_FALSE(c.try_consume(500));
+    EXPECT_EQ(p.consumption(), 600);
+    EXPECT_TRUE(c.try_consume(400));
+    EXPECT_EQ(p.consumption(), 1000);
+    c.release(1000);
+    EXPECT_EQ(c.consumption(), 0);
+    EXPECT_EQ(p.consumption(), 0);
+
+    // Deltas over the batch size go to the counter directly
+    int64_t big = config::mem_tracker_consume_batch_bytes;
+    MemTracker t(-1);
+    t.consume(big);
+    EXPECT_EQ(t.peak_consumption(), big);
+    t.release(big);
+    EXPECT_EQ(t.consumption(), 0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&t]() {
+            for (int j = 0; j < 10000; ++j) {
+                t.consume(j % 100 + 1);
+            }
+            for (int j = 0; j < 10000; ++j) {
+                t.release(j % 100 + 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(t.consumption(), 0);
+    EXPECT_GT(t.peak_consumption(), 0);
+}
+
 #if 0
 class GcFunctionHelper {
     public:
@@ -0,0 +1,103 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/memory/chunk_allocator.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/arena.h"
+
+namespace doris {
+
+TEST(ChunkAllocatorTest, ReuseFreedChunks) {
+    ChunkAllocator allocator(1024 * 1024);
+    Chunk chunk;
+    ASSERT_TRUE(allocator.allocate(4096, &chunk));
+    ASSERT_EQ(4096, chunk.size);
+    uint8_t* data = chunk.data;
+    allocator.free(chunk);
+    ASSERT_EQ(4096, allocator.reserved_bytes());
+
+    // Same size is served from the free list, other sizes are not
+    ASSERT_TRUE(allocator.allocate(8192, &chunk));
+    ASSERT_EQ(4096, allocator.reserved_bytes());
+    allocator.free(chunk);
+    ASSERT_EQ(4096 + 8192, allocator.reserved_bytes());
+    ASSERT_TRUE(allocator.allocate(4096, &chunk));
+    ASSERT_EQ(data, chunk.data);
+    ASSERT_EQ(8192, allocator.reserved_bytes());
+    allocator.free(chunk);
+
+    // Not a power of two, never kept
+    ASSERT_TRUE(allocator.allocate(5000, &chunk));
+    allocator.free(chunk);
+    ASSERT_EQ(4096 + 8192, allocator.reserved_bytes());
+}
+
+TEST(ChunkAllocatorTest, ReserveLimit) {
+    ChunkAllocator allocator(64 * 1024);
+    std::vector<Chunk> chunks(32);
+    for (auto& chunk : chunks) {
+        ASSERT_TRUE(allocator.allocate(4096, &chunk));
+    }
+    for (auto& chunk : chunks) {
+        allocator.free(chunk);
+    }
+    ASSERT_EQ(64 * 1024, allocator.reserved_bytes());
+}
+
+TEST(ChunkAllocatorTest, MultiThreads) {
+    ChunkAllocator allocator(1024 * 1024);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&allocator]() {
+            for (int j = 0; j < 10000; ++j) {
+                Chunk chunk;
+                ASSERT_TRUE(allocator.allocate(4096 << (j % 4), &chunk));
+                chunk.data[0] = j;
+                chunk.data[chunk.size - 1] = j;
+                allocator.free(chunk);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_LE(allocator.reserved_bytes(), 1024 * 1024);
+}
+
+TEST(ChunkAllocatorTest, Arena) {
+    for (int i = 0; i < 2; ++i) {
+        Arena arena;
+        for (int j = 0; j < 1000; ++j) {
+            char* data = arena.Allocate(j % 2000 + 1);
+            data[0] = 'a';
+        }
+        ASSERT_GT(arena.MemoryUsage(), 0);
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/query_trace.h"
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+
+#include "common/config.h"
+
+namespace doris {
+
+class QueryTraceTest : public testing::Test {
+public:
+    QueryTraceTest() { }
+    virtual ~QueryTraceTest() { }
+};
+
+static TUniqueId make_id(int64_t hi, int64_t lo) {
+    TUniqueId id;
+    id.hi = hi;
+    id.lo = lo;
+    return id;
+}
+
+TEST_F(QueryTraceTest, chrome_trace) {
+    TUniqueId query_id = make_id(1, 2);
+    TUniqueId instance_id = make_id(1, 3);
+    QueryTrace trace(query_id, 2);
+    trace.add_span("FragmentPrepare", "fragment", instance_id, 100, 150);
+    {
+        ScopedTraceSpan span(&trace, instance_id, "OlapScanner", "scan");
+    }
+    // exceed max spans
+    trace.add_span("ExchangeSend", "exchange", instance_id, 200, 300);
+    {
+        ScopedTraceSpan span(nullptr, instance_id, "OlapScanner", "scan");
+    }
+
+    std::string str;
+    trace.to_chrome_trace(&str);
+    rapidjson::Document doc;
+    doc.Parse(str.c_str());
+    ASSERT_FALSE(doc.HasParseError());
+
+    const rapidjson::Value& events = doc["traceEvents"];
+    ASSERT_EQ(2U, events.Size());
+    ASSERT_STREQ("FragmentPrepare", events[0]["name"].GetString());
+    ASSERT_STREQ("fragment", events[0]["cat"].GetString());
+    ASSERT_STREQ("X", events[0]["ph"].GetString());
+    ASSERT_EQ(100, events[0]["ts"].GetInt64());
+    ASSERT_EQ(50, events[0]["dur"].GetInt64());
+    ASSERT_STREQ("OlapScanner", events[1]["name"].GetString());
+    ASSERT_EQ(1, doc["otherData"]["dropped_spans"].GetInt64());
+}
+
+TEST_F(QueryTraceTest, evict) {
+    config::query_trace_max_queries = 2;
+    QueryTraceMgr* mgr = QueryTraceMgr::instance();
+    std::shared_ptr<QueryTrace> trace1 = mgr->get_or_create(make_id(10, 1));
+    ASSERT_EQ(trace1, mgr->get_or_create(make_id(10, 1)));
+    mgr->get_or_create(make_id(10, 2));
+    ASSERT_EQ(trace1, mgr->get(make_id(10, 1)));
+
+    mgr->get_or_create(make_id(10, 3));
+    ASSERT_TRUE(mgr->get(make_id(10, 1)) == nullptr);
+    ASSERT_TRUE(mgr->get(make_id(10, 2)) != nullptr);
+    ASSERT_TRUE(mgr->get(make_id(10, 3)) != nullptr);
+}
+
+} // end namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
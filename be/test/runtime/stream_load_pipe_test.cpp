@@ -19,6 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <memory>
+#include <string>
 #include <thread>
 
 namespace doris {
@@ -196,6 +199,93 @@ TEST_F(StreamLoadPipeTest, append_mix) {
     t1.join();
 }
 
+TEST_F(StreamLoadPipeTest, append_wrapped_buffer) {
+    StreamLoadPipe pipe(66, 64);
+
+    // memory of wrapped buffers is owned by holder, and released after all
+    // of them are consumed
+    std::shared_ptr<std::string> holder(new std::string());
+    for (int i = 0; i < 128; ++i) {
+        holder->push_back('0' + (i % 10));
+    }
+    std::weak_ptr<std::string> weak_holder = holder;
+
+    auto appender = [&pipe, holder] () mutable {
+        for (int i = 0; i < 4; ++i) {
+            auto byte_buf = ByteBuffer::wrap(&(*holder)[i * 32], 32, holder);
+            ASSERT_EQ(32, byte_buf->remaining());
+            pipe.append(byte_buf);
+        }
+        holder.reset();
+        pipe.finish();
+    };
+    holder.reset();
+    std::thread t1(appender);
+
+    char buf[256];
+    size_t buf_len = 256;
+    bool eof = false;
+    auto st = pipe.read((uint8_t*)buf, &buf_len, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(128, buf_len);
+    ASSERT_FALSE(eof);
+    for (int i = 0; i < 128; ++i) {
+        ASSERT_EQ('0' + (i % 10), buf[i]);
+    }
+    t1.join();
+    ASSERT_TRUE(weak_holder.expired());
+}
+
+TEST_F(StreamLoadPipeTest, try_append) {
+    StreamLoadPipe pipe(66, 64);
+
+    auto make_buf = [] (char c) {
+        auto byte_buf = ByteBuffer::allocate(64);
+        char buf[64];
+        memset(buf, c, 64);
+        byte_buf->put_bytes(buf, 64);
+        byte_buf->flip();
+        return byte_buf;
+    };
+    int num_on_space = 0;
+    auto on_space = [&num_on_space] { num_on_space++; };
+
+    // first buffer is always taken
+    bool appended = false;
+    auto st = pipe.try_append(make_buf('a'), &appended, on_space);
+    ASSERT_TRUE(st.ok());
+    ASSERT_TRUE(appended);
+
+    // pipe is full now
+    auto second = make_buf('b');
+    st = pipe.try_append(second, &appended, on_space);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(appended);
+    ASSERT_EQ(0, num_on_space);
+
+    char buf[64];
+    size_t buf_len = 64;
+    bool eof = false;
+    st = pipe.read((uint8_t*)buf, &buf_len, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(64, buf_len);
+    ASSERT_EQ('a', buf[0]);
+    ASSERT_EQ(1, num_on_space);
+
+    st = pipe.try_append(second, &appended, on_space);
+    ASSERT_TRUE(st.ok());
+    ASSERT_TRUE(appended);
+
+    // callback is also called when the pipe is cancelled
+    st = pipe.try_append(make_buf('c'), &appended, on_space);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(appended);
+    pipe.cancel();
+    ASSERT_EQ(2, num_on_space);
+    st = pipe.try_append(make_buf('c'), &appended, on_space);
+    ASSERT_FALSE(st.ok());
+}
+
 TEST_F(StreamLoadPipeTest, cancel) {
     StreamLoadPipe pipe(66, 64);
 
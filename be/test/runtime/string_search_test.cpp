@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "runtime/string_search.hpp"
+
+#include <string>
+#include <gtest/gtest.h>
+
+namespace doris {
+
+// Finds the pattern with std::string::find() to check StringSearch against.
+static int expected_pos(const std::string& str, const std::string& pattern) {
+    size_t pos = str.find(pattern);
+    return pos == std::string::npos ? -1 : pos;
+}
+
+static int search(const std::string& str, const std::string& pattern) {
+    StringValue pattern_sv(const_cast<char*>(pattern.data()), pattern.size());
+    StringValue str_sv(const_cast<char*>(str.data()), str.size());
+    StringSearch search(&pattern_sv);
+    return search.search(&str_sv);
+}
+
+TEST(StringSearchTest, Basic) {
+    EXPECT_EQ(-1, search("abc", ""));
+    EXPECT_EQ(-1, search("", "a"));
+    EXPECT_EQ(0, search("abc", "a"));
+    EXPECT_EQ(2, search("abc", "c"));
+    EXPECT_EQ(0, search("abc", "abc"));
+    EXPECT_EQ(-1, search("abc", "abcd"));
+    EXPECT_EQ(1, search("abcbc", "bc"));
+    EXPECT_EQ(-1, search("abcbc", "cc"));
+}
+
+TEST(StringSearchTest, LongStrings) {
+    // Cover matches inside and across the 16 byte blocks compared at a time, and in
+    // the positions left over after the last full block.
+    std::string str;
+    for (int i = 0; i < 100; ++i) {
+        str.append(1, 'a' + i % 7);
+    }
+    const char* patterns[] = {"ab", "ga", "bcd", "gabcdefg", "aa", "fgabcdefgabcdefga"};
+    for (int len = 0; len <= static_cast<int>(str.size()); ++len) {
+        std::string prefix = str.substr(0, len);
+        for (const char* pattern : patterns) {
+            EXPECT_EQ(expected_pos(prefix, pattern), search(prefix, pattern))
+                << "len=" << len << " pattern=" << pattern;
+        }
+        std::string tail = prefix + "xyz";
+        EXPECT_EQ(len, search(tail, "xyz"));
+        EXPECT_EQ(len, search(tail, "xy"));
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -81,6 +81,24 @@ TEST(StringValueTest, TestCompare) {
     }
 }
 
+TEST(StringValueTest, TestComparePrefix) {
+    // around the 8 bytes compared as one integer, and with bytes above 0x7f
+    // which must compare as unsigned
+    std::string strs[] = {"", "a", "abcdefg", "abcdefgh", "abcdefgh\x01", "abcdefghij",
+                          "abcdefghik", "abcdefh", "abd", "\x80", "\xff\xff"};
+    const int num_strings = sizeof(strs) / sizeof(strs[0]);
+    for (int i = 0; i < num_strings; ++i) {
+        StringValue v1 = FromStdString(strs[i]);
+        for (int j = 0; j < num_strings; ++j) {
+            StringValue v2 = FromStdString(strs[j]);
+            int expected = (i < j) ? -1 : (i > j ? 1 : 0);
+            int result = v1.compare(v2);
+            EXPECT_EQ(expected, (result > 0) - (result < 0)) << i << " " << j;
+            EXPECT_EQ(i == j, v1.eq(v2)) << i << " " << j;
+        }
+    }
+}
+
 }
 
 int main(int argc, char** argv) {
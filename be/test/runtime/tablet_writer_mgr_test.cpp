@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "gen_cpp/Descriptors_types.h"
 #include "gen_cpp/PaloInternalService_types.h"
@@ -29,6 +30,7 @@
 #include "runtime/mem_tracker.h"
 #include "runtime/row_batch.h"
 #include "runtime/tuple_row.h"
+#include "util/block_compression.h"
 #include "util/descriptor_helper.h"
 #include "util/thrift_util.h"
 #include "olap/delta_writer.h"
@@ -42,7 +44,7 @@ OLAPStatus close_status;
 int64_t wait_lock_time_ns;
 
 // mock
-DeltaWriter::DeltaWriter(WriteRequest* req) : _req(*req) {
+DeltaWriter::DeltaWriter(WriteRequest* req, MemTracker* mem_tracker) : _req(*req) {
 }
 
 DeltaWriter::~DeltaWriter() {
@@ -52,11 +54,11 @@ OLAPStatus DeltaWriter::init() {
     return OLAP_SUCCESS;
 }
 
-OLAPStatus DeltaWriter::open(WriteRequest* req, DeltaWriter** writer) {
+OLAPStatus DeltaWriter::open(WriteRequest* req, DeltaWriter** writer, MemTracker* mem_tracker) {
     if (open_status != OLAP_SUCCESS) {
         return open_status;
     }
-    *writer = new DeltaWriter(req);
+    *writer = new DeltaWriter(req, mem_tracker);
     return open_status;
 }
 
@@ -77,6 +79,18 @@ OLAPStatus DeltaWriter::cancel() {
     return OLAP_SUCCESS;
 }
 
+int64_t DeltaWriter::mem_consumption() const {
+    return 0;
+}
+
+OLAPStatus DeltaWriter::flush_memtable() {
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus DeltaWriter::wait_flush() {
+    return OLAP_SUCCESS;
+}
+
 class TabletWriterMgrTest : public testing::Test {
 public:
     TabletWriterMgrTest() { }
@@ -86,6 +100,8 @@ public:
         open_status = OLAP_SUCCESS;
         add_status = OLAP_SUCCESS;
         close_status = OLAP_SUCCESS;
+        // mocked DeltaWriter::write is not thread safe
+        config::tablet_writer_add_batch_thread_num = 0;
     }
 private:
 };
@@ -145,6 +161,20 @@ void create_schema(DescriptorTbl* desc_tbl, POlapTableSchemaParam* pschema) {
     indexes->set_schema_hash(123);
 }
 
+// add batch of a packet which is handled at once, that is not ahead of
+// former packets of its sender
+Status add_batch(TabletWriterMgr* mgr, const PTabletWriterAddBatchRequest& request,
+                 google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec,
+                 const butil::IOBuf* attachment = nullptr) {
+    Status status = Status::InternalError("add batch is parked");
+    mgr->add_batch(request, tablet_vec, attachment,
+                   [&status] (const Status& st, int64_t wait_ns) {
+        status = st;
+        wait_lock_time_ns += wait_ns;
+    });
+    return status;
+}
+
 TEST_F(TabletWriterMgrTest, normal) {
     ExecEnv env;
     TabletWriterMgr mgr(&env);
@@ -224,7 +254,7 @@ TEST_F(TabletWriterMgrTest, normal) {
         }
         row_batch.serialize(request.mutable_row_batch());
         google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
-        auto st = mgr.add_batch(request, &tablet_vec, &wait_lock_time_ns);
+        auto st = add_batch(&mgr, request, &tablet_vec);
         request.release_id();
         ASSERT_TRUE(st.ok());
     }
@@ -233,6 +263,239 @@ TEST_F(TabletWriterMgrTest, normal) {
     ASSERT_EQ(_k_tablet_recorder[21], 1);
 }
 
+TEST_F(TabletWriterMgrTest, out_of_order_packets) {
+    ExecEnv env;
+    TabletWriterMgr mgr(&env);
+
+    auto tdesc_tbl = create_descriptor_table();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    auto tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+    MemTracker tracker;
+    PUniqueId load_id;
+    load_id.set_hi(2);
+    load_id.set_lo(3);
+    {
+        PTabletWriterOpenRequest request;
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_txn_id(1);
+        create_schema(desc_tbl, request.mutable_schema());
+        for (int i = 0; i < 2; ++i) {
+            auto tablet = request.add_tablets();
+            tablet->set_partition_id(10 + i);
+            tablet->set_tablet_id(20 + i);
+        }
+        request.set_num_senders(1);
+        request.set_need_gen_rollup(false);
+        auto st = mgr.open(request);
+        request.release_id();
+        ASSERT_TRUE(st.ok());
+    }
+
+    // packet i has one row for tablet 20 + i
+    PTabletWriterAddBatchRequest requests[2];
+    for (int i = 0; i < 2; ++i) {
+        auto& request = requests[i];
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_sender_id(0);
+        request.set_eos(i == 1);
+        request.set_packet_seq(i);
+        request.add_tablet_ids(20 + i);
+
+        RowBatch row_batch(row_desc, 1024, &tracker);
+        auto id = row_batch.add_row();
+        auto tuple = (Tuple*)row_batch.tuple_data_pool()->allocate(tuple_desc->byte_size());
+        row_batch.get_row(id)->set_tuple(0, tuple);
+        memset(tuple, 0, tuple_desc->byte_size());
+        *(int*)tuple->get_slot(tuple_desc->slots()[0]->tuple_offset()) = i;
+        row_batch.commit_last_row();
+        row_batch.serialize(request.mutable_row_batch());
+    }
+
+    // the second packet arrives first, it's parked without blocking this thread
+    google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec1;
+    bool finished1 = false;
+    Status st1;
+    mgr.add_batch(requests[1], &tablet_vec1, nullptr,
+                  [&finished1, &st1] (const Status& st, int64_t wait_ns) {
+        finished1 = true;
+        st1 = st;
+    });
+    ASSERT_FALSE(finished1);
+    ASSERT_EQ(0, _k_tablet_recorder.count(21));
+
+    // the first packet adds itself and then the parked one
+    google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec0;
+    auto st0 = add_batch(&mgr, requests[0], &tablet_vec0);
+    for (auto& request : requests) {
+        request.release_id();
+    }
+    ASSERT_TRUE(st0.ok());
+    ASSERT_TRUE(finished1);
+    ASSERT_TRUE(st1.ok());
+    ASSERT_EQ(_k_tablet_recorder[20], 1);
+    ASSERT_EQ(_k_tablet_recorder[21], 1);
+}
+
+TEST_F(TabletWriterMgrTest, tuple_data_in_attachment) {
+    ExecEnv env;
+    TabletWriterMgr mgr(&env);
+
+    auto tdesc_tbl = create_descriptor_table();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    auto tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+    MemTracker tracker;
+    PUniqueId load_id;
+    load_id.set_hi(2);
+    load_id.set_lo(3);
+    {
+        PTabletWriterOpenRequest request;
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_txn_id(1);
+        create_schema(desc_tbl, request.mutable_schema());
+        for (int i = 0; i < 2; ++i) {
+            auto tablet = request.add_tablets();
+            tablet->set_partition_id(10 + i);
+            tablet->set_tablet_id(20 + i);
+        }
+        request.set_num_senders(1);
+        request.set_need_gen_rollup(false);
+        auto st = mgr.open(request);
+        request.release_id();
+        ASSERT_TRUE(st.ok());
+    }
+
+    // add a batch
+    {
+        PTabletWriterAddBatchRequest request;
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_sender_id(0);
+        request.set_eos(true);
+        request.set_packet_seq(0);
+
+        RowBatch row_batch(row_desc, 1024, &tracker);
+        for (int i = 0; i < 100; ++i) {
+            request.add_tablet_ids(20 + i % 2);
+            auto id = row_batch.add_row();
+            auto tuple = (Tuple*)row_batch.tuple_data_pool()->allocate(tuple_desc->byte_size());
+            row_batch.get_row(id)->set_tuple(0, tuple);
+            memset(tuple, 0, tuple_desc->byte_size());
+            *(int*)tuple->get_slot(tuple_desc->slots()[0]->tuple_offset()) = i;
+            *(int64_t*)tuple->get_slot(tuple_desc->slots()[1]->tuple_offset()) = 1234567899876;
+            row_batch.commit_last_row();
+        }
+        std::string tuple_data;
+        row_batch.serialize(request.mutable_row_batch(), &tuple_data);
+        ASSERT_TRUE(request.row_batch().tuple_data().empty());
+
+        BlockCompressionCodec* codec = nullptr;
+        ASSERT_TRUE(get_block_compression_codec(segment_v2::LZ4, &codec).ok());
+        std::string compressed(codec->max_compressed_len(tuple_data.size()), '\0');
+        Slice output(compressed);
+        ASSERT_TRUE(codec->compress(Slice(tuple_data), &output).ok());
+        butil::IOBuf attachment;
+        attachment.append(output.data, output.size);
+        request.set_attachment_compression_type(segment_v2::LZ4);
+        request.set_attachment_uncompressed_size(tuple_data.size());
+
+        google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
+        auto st = add_batch(&mgr, request, &tablet_vec, &attachment);
+        request.release_id();
+        ASSERT_TRUE(st.ok());
+    }
+    // check content
+    ASSERT_EQ(_k_tablet_recorder[20], 50);
+    ASSERT_EQ(_k_tablet_recorder[21], 50);
+}
+
+TEST_F(TabletWriterMgrTest, uncompressed_tuple_data_in_attachment) {
+    ExecEnv env;
+    TabletWriterMgr mgr(&env);
+
+    auto tdesc_tbl = create_descriptor_table();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    auto tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+    MemTracker tracker;
+    PUniqueId load_id;
+    load_id.set_hi(2);
+    load_id.set_lo(3);
+    {
+        PTabletWriterOpenRequest request;
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_txn_id(1);
+        create_schema(desc_tbl, request.mutable_schema());
+        for (int i = 0; i < 2; ++i) {
+            auto tablet = request.add_tablets();
+            tablet->set_partition_id(10 + i);
+            tablet->set_tablet_id(20 + i);
+        }
+        request.set_num_senders(1);
+        request.set_need_gen_rollup(false);
+        auto st = mgr.open(request);
+        request.release_id();
+        ASSERT_TRUE(st.ok());
+    }
+
+    // add a batch
+    {
+        PTabletWriterAddBatchRequest request;
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_sender_id(0);
+        request.set_eos(true);
+        request.set_packet_seq(0);
+
+        RowBatch row_batch(row_desc, 1024, &tracker);
+        for (int i = 0; i < 100; ++i) {
+            request.add_tablet_ids(20 + i % 2);
+            auto id = row_batch.add_row();
+            auto tuple = (Tuple*)row_batch.tuple_data_pool()->allocate(tuple_desc->byte_size());
+            row_batch.get_row(id)->set_tuple(0, tuple);
+            memset(tuple, 0, tuple_desc->byte_size());
+            *(int*)tuple->get_slot(tuple_desc->slots()[0]->tuple_offset()) = i;
+            *(int64_t*)tuple->get_slot(tuple_desc->slots()[1]->tuple_offset()) = 1234567899876;
+            row_batch.commit_last_row();
+        }
+        std::string tuple_data;
+        row_batch.serialize(request.mutable_row_batch(), &tuple_data);
+        ASSERT_TRUE(request.row_batch().tuple_data().empty());
+
+        // tuple data spans two blocks of attachment, and is used uncompressed
+        size_t half = tuple_data.size() / 2;
+        char* first = reinterpret_cast<char*>(malloc(half));
+        memcpy(first, tuple_data.data(), half);
+        char* second = reinterpret_cast<char*>(malloc(tuple_data.size() - half));
+        memcpy(second, tuple_data.data() + half, tuple_data.size() - half);
+        butil::IOBuf attachment;
+        attachment.append_user_data(first, half, free);
+        attachment.append_user_data(second, tuple_data.size() - half, free);
+        ASSERT_EQ(2U, attachment.backing_block_num());
+        request.set_attachment_compression_type(segment_v2::NO_COMPRESSION);
+        request.set_attachment_uncompressed_size(tuple_data.size());
+
+        google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
+        auto st = add_batch(&mgr, request, &tablet_vec, &attachment);
+        request.release_id();
+        ASSERT_TRUE(st.ok());
+    }
+    // check content
+    ASSERT_EQ(_k_tablet_recorder[20], 50);
+    ASSERT_EQ(_k_tablet_recorder[21], 50);
+}
+
 TEST_F(TabletWriterMgrTest, cancel) {
     ExecEnv env;
     TabletWriterMgr mgr(&env);
@@ -388,7 +651,7 @@ TEST_F(TabletWriterMgrTest, add_failed) {
         row_batch.serialize(request.mutable_row_batch());
         add_status = OLAP_ERR_TABLE_NOT_FOUND;
         google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
-        auto st = mgr.add_batch(request, &tablet_vec, &wait_lock_time_ns);
+        auto st = add_batch(&mgr, request, &tablet_vec);
         request.release_id();
         ASSERT_FALSE(st.ok());
     }
@@ -477,7 +740,7 @@ TEST_F(TabletWriterMgrTest, close_failed) {
         row_batch.serialize(request.mutable_row_batch());
         close_status = OLAP_ERR_TABLE_NOT_FOUND;
         google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
-        auto st = mgr.add_batch(request, &tablet_vec, &wait_lock_time_ns);
+        auto st = add_batch(&mgr, request, &tablet_vec);
         request.release_id();
         ASSERT_FALSE(st.ok());
     }
@@ -562,7 +825,7 @@ TEST_F(TabletWriterMgrTest, unknown_tablet) {
         }
         row_batch.serialize(request.mutable_row_batch());
         google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
-        auto st = mgr.add_batch(request, &tablet_vec, &wait_lock_time_ns);
+        auto st = add_batch(&mgr, request, &tablet_vec);
         request.release_id();
         ASSERT_FALSE(st.ok());
     }
@@ -647,10 +910,10 @@ TEST_F(TabletWriterMgrTest, duplicate_packet) {
         }
         row_batch.serialize(request.mutable_row_batch());
         google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec1;
-        auto st = mgr.add_batch(request, &tablet_vec1, &wait_lock_time_ns);
+        auto st = add_batch(&mgr, request, &tablet_vec1);
         ASSERT_TRUE(st.ok());
         google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec2;
-        st = mgr.add_batch(request, &tablet_vec2, &wait_lock_time_ns);
+        st = add_batch(&mgr, request, &tablet_vec2);
         request.release_id();
         ASSERT_TRUE(st.ok());
     }
@@ -663,7 +926,7 @@ TEST_F(TabletWriterMgrTest, duplicate_packet) {
         request.set_eos(true);
         request.set_packet_seq(0);
         google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
-        auto st = mgr.add_batch(request, &tablet_vec, &wait_lock_time_ns);
+        auto st = add_batch(&mgr, request, &tablet_vec);
         request.release_id();
         ASSERT_TRUE(st.ok());
     }
@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/bitmap_value.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace doris {
+
+static std::string serialize(BitmapValue* bitmap) {
+    std::string buf(bitmap->serialized_size(), '\0');
+    bitmap->serialize(&buf[0]);
+    return buf;
+}
+
+TEST(BitmapValueTest, add_and_union) {
+    BitmapValue bitmap;
+    ASSERT_EQ(0, bitmap.cardinality());
+    ASSERT_FALSE(bitmap.contains(1));
+
+    bitmap.add(1);
+    bitmap.add(1);
+    ASSERT_EQ(BitmapValue::SINGLE, bitmap._type);
+    ASSERT_EQ(1, bitmap.cardinality());
+
+    bitmap.add(2);
+    ASSERT_EQ(BitmapValue::BITMAP, bitmap._type);
+    ASSERT_EQ(2, bitmap.cardinality());
+
+    BitmapValue other(3);
+    other |= bitmap;
+    ASSERT_EQ(3, other.cardinality());
+    ASSERT_TRUE(other.contains(1));
+    ASSERT_TRUE(other.contains(3));
+
+    BitmapValue empty;
+    empty |= BitmapValue();
+    ASSERT_EQ(0, empty.cardinality());
+    empty |= other;
+    ASSERT_EQ(3, empty.cardinality());
+}
+
+TEST(BitmapValueTest, intersect) {
+    BitmapValue lhs;
+    BitmapValue rhs;
+    for (uint32_t i = 0; i < 100; ++i) {
+        lhs.add(i);
+        rhs.add(i + 99);
+    }
+    // only 99 is left, kept as a single value
+    lhs &= rhs;
+    ASSERT_EQ(BitmapValue::SINGLE, lhs._type);
+    ASSERT_EQ(1, lhs.cardinality());
+    ASSERT_TRUE(lhs.contains(99));
+
+    lhs &= BitmapValue(100);
+    ASSERT_EQ(0, lhs.cardinality());
+
+    BitmapValue single(150);
+    single &= rhs;
+    ASSERT_EQ(1, single.cardinality());
+    rhs &= BitmapValue(1);
+    ASSERT_EQ(BitmapValue::EMPTY, rhs._type);
+}
+
+TEST(BitmapValueTest, serialize) {
+    BitmapValue empty;
+    std::string buf = serialize(&empty);
+    ASSERT_EQ(1, buf.size());
+    BitmapValue result(5);
+    ASSERT_TRUE(result.deserialize(buf.data(), buf.size()));
+    ASSERT_EQ(0, result.cardinality());
+
+    BitmapValue single(4000000000U);
+    buf = serialize(&single);
+    ASSERT_EQ(5, buf.size());
+    ASSERT_TRUE(result.deserialize(buf.data(), buf.size()));
+    ASSERT_EQ(1, result.cardinality());
+    ASSERT_TRUE(result.contains(4000000000U));
+
+    BitmapValue bitmap;
+    for (uint32_t i = 0; i < 100000; ++i) {
+        bitmap.add(i * 2);
+    }
+    buf = serialize(&bitmap);
+    ASSERT_TRUE(result.deserialize(buf.data(), buf.size()));
+    ASSERT_EQ(100000, result.cardinality());
+    ASSERT_TRUE(result.contains(199998));
+    ASSERT_FALSE(result.contains(199999));
+
+    // a run is stored compactly
+    BitmapValue run;
+    for (uint32_t i = 0; i < 100000; ++i) {
+        run.add(i);
+    }
+    ASSERT_LT(serialize(&run).size(), 100);
+}
+
+TEST(BitmapValueTest, deserialize_invalid) {
+    BitmapValue result;
+    ASSERT_FALSE(result.deserialize("", 0));
+    ASSERT_FALSE(result.deserialize("\x01\x02", 2));
+    ASSERT_FALSE(result.deserialize("\x02\x01\x02\x03", 4));
+    ASSERT_FALSE(result.deserialize("\x09", 1));
+    ASSERT_EQ(0, result.cardinality());
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
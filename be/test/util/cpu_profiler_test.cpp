@@ -0,0 +1,97 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/cpu_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "util/uid_util.h"
+
+namespace doris {
+
+static volatile int64_t s_sink = 0;
+
+static void burn_cpu(int64_t millis) {
+    timespec start;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+    while (true) {
+        int64_t sum = 0;
+        for (int i = 0; i < 100000; ++i) {
+            sum += i * s_sink;
+        }
+        s_sink = sum;
+        timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        if ((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000 >= millis) {
+            break;
+        }
+    }
+}
+
+TEST(CpuProfilerTest, TaggedSamples) {
+    ASSERT_TRUE(CpuProfiler::instance()->start(200, 4096).ok());
+    // can only be started once
+    ASSERT_FALSE(CpuProfiler::instance()->start(200, 4096).ok());
+
+    TUniqueId query1;
+    query1.__set_hi(1);
+    query1.__set_lo(2);
+    TUniqueId query2;
+    query2.__set_hi(3);
+    query2.__set_lo(4);
+
+    std::vector<std::thread> threads;
+    for (auto& query_id : { query1, query2 }) {
+        threads.emplace_back([query_id] {
+            CpuProfileTag tag(query_id, query_id);
+            burn_cpu(500);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::string query1_stacks;
+    CpuProfiler::instance()->get_folded_stacks(&query1, 600, nullptr, &query1_stacks);
+    // the outermost frame is the fragment instance
+    ASSERT_EQ(0, query1_stacks.find(print_id(query1) + ";"));
+    ASSERT_EQ(std::string::npos, query1_stacks.find(print_id(query2)));
+
+    std::string all_stacks;
+    CpuProfiler::instance()->get_folded_stacks(nullptr, 600, nullptr, &all_stacks);
+    ASSERT_NE(std::string::npos, all_stacks.find(print_id(query1) + ";"));
+    ASSERT_NE(std::string::npos, all_stacks.find(print_id(query2) + ";"));
+
+    TUniqueId unknown;
+    unknown.__set_hi(5);
+    unknown.__set_lo(6);
+    std::string unknown_stacks;
+    CpuProfiler::instance()->get_folded_stacks(&unknown, 600, nullptr, &unknown_stacks);
+    ASSERT_TRUE(unknown_stacks.empty());
+
+    CpuProfiler::instance()->stop();
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
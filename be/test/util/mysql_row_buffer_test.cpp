@@ -0,0 +1,83 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/mysql_row_buffer.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace doris {
+
+class MysqlRowBufferTest : public testing::Test {
+public:
+    MysqlRowBufferTest() { }
+    virtual ~MysqlRowBufferTest() { }
+};
+
+// Returns the length encoded cells of buffer, separated by '|'
+static std::string cells(const MysqlRowBuffer& buffer) {
+    std::string res;
+    const char* pos = buffer.buf();
+    while (pos < buffer.pos()) {
+        int len = (uint8_t)*pos++;
+        if (!res.empty()) {
+            res.append("|");
+        }
+        res.append(pos, len);
+        pos += len;
+    }
+    return res;
+}
+
+TEST_F(MysqlRowBufferTest, integers) {
+    MysqlRowBuffer buffer;
+    ASSERT_EQ(0, buffer.push_tinyint(-128));
+    ASSERT_EQ(0, buffer.push_smallint(32767));
+    ASSERT_EQ(0, buffer.push_int(0));
+    ASSERT_EQ(0, buffer.push_int(-2147483648));
+    ASSERT_EQ(0, buffer.push_bigint(-9223372036854775807L - 1));
+    ASSERT_EQ(0, buffer.push_unsigned_bigint(18446744073709551615UL));
+    ASSERT_EQ("-128|32767|0|-2147483648|-9223372036854775808|18446744073709551615",
+              cells(buffer));
+
+    buffer.reset();
+    ASSERT_EQ(0, buffer.length());
+    ASSERT_EQ(0, buffer.push_bigint(1234567890123L));
+    ASSERT_EQ("1234567890123", cells(buffer));
+}
+
+TEST_F(MysqlRowBufferTest, grow) {
+    MysqlRowBuffer buffer;
+    std::string expected;
+    for (int i = 0; i < 2000; ++i) {
+        ASSERT_EQ(0, buffer.push_int(i * 1000));
+        if (i > 0) {
+            expected.append("|");
+        }
+        expected.append(std::to_string(i * 1000));
+    }
+    ASSERT_EQ(expected, cells(buffer));
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
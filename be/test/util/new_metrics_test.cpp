@@ -125,6 +125,46 @@ TEST_F(MetricsTest, Gauge) {
     }
 }
 
+TEST_F(MetricsTest, Histogram) {
+    IntHistogram histogram({10, 100});
+    ASSERT_EQ(2, histogram.bounds().size());
+    histogram.add(1);
+    histogram.add(10);
+    histogram.add(11);
+    histogram.add(1000);
+    ASSERT_EQ(2, histogram.bucket_count(0));
+    ASSERT_EQ(1, histogram.bucket_count(1));
+    ASSERT_EQ(1, histogram.bucket_count(2));
+    ASSERT_EQ(4, histogram.count());
+    ASSERT_EQ(1022, histogram.sum());
+}
+
+TEST_F(MetricsTest, HdrHistogram) {
+    HdrHistogram histogram;
+    ASSERT_EQ(0, histogram.value_at_quantile(0.99));
+    for (int i = 1; i <= 1000; ++i) {
+        histogram.add(i);
+    }
+    std::vector<int64_t> bucket_counts;
+    int64_t count = 0;
+    int64_t sum = 0;
+    histogram.snapshot(&bucket_counts, &count, &sum);
+    ASSERT_EQ(1000, count);
+    ASSERT_EQ(500500, sum);
+    // values are kept with relative precision of 1/8
+    int64_t p50 = HdrHistogram::value_at_quantile(bucket_counts, count, 0.5);
+    ASSERT_GE(p50, 500);
+    ASSERT_LE(p50, 500 + 500 / 8);
+    int64_t p99 = HdrHistogram::value_at_quantile(bucket_counts, count, 0.99);
+    ASSERT_GE(p99, 990);
+    ASSERT_LE(p99, 990 + 990 / 8);
+    ASSERT_EQ(1, HdrHistogram::value_at_quantile(bucket_counts, count, 0));
+    // small values are exact
+    HdrHistogram small;
+    small.add(3);
+    ASSERT_EQ(3, small.value_at_quantile(1));
+}
+
 TEST_F(MetricsTest, MetricLabel) {
     std::string put("put");
     MetricLabel label("type", put);
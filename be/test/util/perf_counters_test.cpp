@@ -14,71 +14,68 @@
 // KIND, either express or implied.  See the License for the
 // specific language governing permissions and limitations
 // under the License.
-
-#include <stdlib.h>
-#include <stdio.h>
-#include <iostream>
-#include <gtest/gtest.h>
-#include "util/cpu_info.h"
-#include "util/disk_info.h"
-#include "util/mem_info.h"
 #include "util/perf_counters.h"
 
-using namespace std;
-
-namespace impala {
-
-TEST(PerfCounterTest, Basic) {
-    PerfCounters counters;
-    EXPECT_TRUE(counters.AddDefaultCounters());
+#include <gtest/gtest.h>
 
-    counters.Snapshot("Before");
+#include <thread>
 
-    double result = 0;
+#include "common/logging.h"
+#include "common/object_pool.h"
 
-    for (int i = 0; i < 1000000; i++) {
-        double d1 = rand() / (double) RAND_MAX;
-        double d2 = rand() / (double) RAND_MAX;
-        result = d1 * d1 + d2 * d2;
-    }
+namespace doris {
 
-    counters.Snapshot("After");
+static volatile int64_t s_sink = 0;
 
-    for (int i = 0; i < 1000000; i++) {
-        double d1 = rand() / (double) RAND_MAX;
-        double d2 = rand() / (double) RAND_MAX;
-        result = d1 * d1 + d2 * d2;
+static void burn_cpu() {
+    int64_t sum = 0;
+    for (int i = 0; i < 1000000; ++i) {
+        sum += i * s_sink;
     }
-
-    counters.Snapshot("After2");
-    counters.PrettyPrint(&cout);
+    s_sink = sum;
 }
 
-TEST(CpuInfoTest, Basic) {
-    cout << CpuInfo::DebugString();
+TEST(ThreadPerfCountersTest, Scoped) {
+    // hardware counters are not available in some VMs and containers
+    if (ThreadPerfCounters::current() == nullptr) {
+        LOG(INFO) << "hardware counters are not available, skip the test";
+        return;
+    }
+    ObjectPool pool;
+    RuntimeProfile profile(&pool, "Profile");
+    std::vector<RuntimeProfile::Counter*> counters;
+    counters.push_back(profile.add_counter("HWCycles", TUnit::UNIT));
+    counters.push_back(profile.add_counter("HWInstructions", TUnit::UNIT));
+    {
+        SCOPED_PERF_COUNTERS(counters);
+        burn_cpu();
+    }
+    ASSERT_GT(counters[ThreadPerfCounters::CPU_CYCLES]->value(), 0);
+    // one million iterations are at least one million instructions
+    ASSERT_GT(counters[ThreadPerfCounters::INSTRUCTIONS]->value(), 1000000);
+
+    // counters of another thread are opened by itself
+    ThreadPerfCounters* main_counters = ThreadPerfCounters::current();
+    ThreadPerfCounters* other_counters = nullptr;
+    std::thread thread([&other_counters] {
+        other_counters = ThreadPerfCounters::current();
+    });
+    thread.join();
+    ASSERT_NE(main_counters, other_counters);
 }
 
-TEST(DiskInfoTest, Basic) {
-    cout << DiskInfo::DebugString();
-    cout << "Device name for disk 0: " << DiskInfo::device_name(0) << endl;
-
-    int disk_id_home_dir = DiskInfo::disk_id("/home");
-    cout << "Device name for '/home': " << DiskInfo::device_name(disk_id_home_dir) << endl;
+TEST(ThreadPerfCountersTest, Disabled) {
+    std::vector<RuntimeProfile::Counter*> counters;
+    {
+        SCOPED_PERF_COUNTERS(counters);
+        burn_cpu();
+    }
+    ASSERT_TRUE(counters.empty());
 }
 
-}
+}  // namespace doris
 
 int main(int argc, char** argv) {
-    std::string conffile = std::string(getenv("DORIS_HOME")) + "/conf/be.conf";
-    if (!doris::config::init(conffile.c_str(), false)) {
-        fprintf(stderr, "error read config file. \n");
-        return -1;
-    }
-    init_glog("be-test");
     ::testing::InitGoogleTest(&argc, argv);
-    impala::CpuInfo::Init();
-    impala::DiskInfo::Init();
-    impala::MemInfo::Init();
     return RUN_ALL_TESTS();
 }
-
@@ -0,0 +1,192 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/priority_thread_pool.hpp"
+
+#include <atomic>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+#include "util/count_down_latch.hpp"
+
+namespace doris {
+
+class PriorityThreadPoolTest : public testing::Test {
+public:
+    PriorityThreadPoolTest() { }
+    virtual ~PriorityThreadPoolTest() { }
+
+    void SetUp() override {
+        _old_frequency = config::priority_queue_remaining_tasks_increased_frequency;
+    }
+    void TearDown() override {
+        config::priority_queue_remaining_tasks_increased_frequency = _old_frequency;
+    }
+
+protected:
+    // Offers a task which blocks the thread running it until 'release' is counted
+    // down, and waits until it runs.
+    static void block_pool(PriorityThreadPool* pool, int priority,
+                           CountDownLatch* started, CountDownLatch* release) {
+        PriorityThreadPool::Task task;
+        task.priority = priority;
+        task.work_function = [started, release]() {
+            started->count_down();
+            release->await();
+        };
+        ASSERT_TRUE(pool->offer(task));
+        started->await();
+    }
+
+    int32_t _old_frequency = 0;
+};
+
+TEST_F(PriorityThreadPoolTest, normal) {
+    const int num_tasks = 10000;
+    std::atomic<int64_t> sum{0};
+    PriorityThreadPool pool(8, 256);
+    for (int i = 1; i <= num_tasks; ++i) {
+        PriorityThreadPool::Task task;
+        task.priority = i % 20;
+        task.work_function = [&sum, i]() { sum += i; };
+        ASSERT_TRUE(pool.offer(task));
+    }
+    pool.drain_and_shutdown();
+
+    ASSERT_EQ(0, pool.get_queue_size());
+    ASSERT_EQ((int64_t)num_tasks * (num_tasks + 1) / 2, sum.load());
+
+    PriorityThreadPool::Task task;
+    task.priority = 0;
+    task.work_function = []() { };
+    ASSERT_FALSE(pool.offer(task));
+}
+
+TEST_F(PriorityThreadPoolTest, priority) {
+    config::priority_queue_remaining_tasks_increased_frequency = 1000;
+    PriorityThreadPool pool(1, 256);
+    CountDownLatch started(1);
+    CountDownLatch release(1);
+    block_pool(&pool, 0, &started, &release);
+
+    boost::mutex lock;
+    std::vector<int> order;
+    // out of range priorities are clamped
+    std::vector<int> priorities = {3, 18, -5, 20, 100, 3};
+    for (int priority : priorities) {
+        PriorityThreadPool::Task task;
+        task.priority = priority;
+        task.work_function = [&lock, &order, priority]() {
+            boost::lock_guard<boost::mutex> l(lock);
+            order.push_back(priority);
+        };
+        ASSERT_TRUE(pool.offer(task));
+    }
+    ASSERT_EQ(priorities.size(), pool.get_queue_size());
+    release.count_down();
+    pool.drain_and_shutdown();
+
+    std::vector<int> expected = {100, 20, 18, 3, 3, -5};
+    ASSERT_EQ(expected, order);
+}
+
+TEST_F(PriorityThreadPoolTest, aging) {
+    // every task taken starts a new epoch
+    config::priority_queue_remaining_tasks_increased_frequency = 1;
+    PriorityThreadPool pool(1, 256);
+    CountDownLatch started(1);
+    CountDownLatch release(1);
+    block_pool(&pool, 0, &started, &release);
+
+    boost::mutex lock;
+    std::vector<int> order;
+    auto offer = [&](int id, int priority) {
+        PriorityThreadPool::Task task;
+        task.priority = priority;
+        task.work_function = [&lock, &order, id]() {
+            boost::lock_guard<boost::mutex> l(lock);
+            order.push_back(id);
+        };
+        ASSERT_TRUE(pool.offer(task));
+    };
+    offer(0, 0);
+    CountDownLatch started2(1);
+    CountDownLatch release2(1);
+    // taken before task 0, which does not age in between
+    PriorityThreadPool::Task task;
+    task.priority = 10;
+    task.work_function = [&]() {
+        {
+            boost::lock_guard<boost::mutex> l(lock);
+            order.push_back(10);
+        }
+        started2.count_down();
+        release2.await();
+    };
+    ASSERT_TRUE(pool.offer(task));
+    release.count_down();
+    started2.await();
+
+    // task 0 has aged by one epoch to priority 2 when these are offered
+    for (int i = 1; i <= 3; ++i) {
+        offer(i, 1);
+    }
+    release2.count_down();
+    pool.drain_and_shutdown();
+
+    std::vector<int> expected = {10, 0, 1, 2, 3};
+    ASSERT_EQ(expected, order);
+}
+
+TEST_F(PriorityThreadPoolTest, full) {
+    PriorityThreadPool pool(1, 2);
+    CountDownLatch started(1);
+    CountDownLatch release(1);
+    block_pool(&pool, 0, &started, &release);
+
+    std::atomic<int> count{0};
+    PriorityThreadPool::Task task;
+    task.priority = 0;
+    task.work_function = [&count]() { ++count; };
+    ASSERT_TRUE(pool.offer(task));
+    ASSERT_TRUE(pool.offer(task));
+    ASSERT_EQ(2, pool.get_queue_size());
+
+    // the third offer blocks until the pool thread takes a task
+    std::atomic<bool> offered{false};
+    boost::thread offer_thread([&]() {
+        ASSERT_TRUE(pool.offer(task));
+        offered = true;
+    });
+    usleep(50 * 1000);
+    ASSERT_FALSE(offered.load());
+    release.count_down();
+    offer_thread.join();
+    ASSERT_TRUE(offered.load());
+    pool.drain_and_shutdown();
+    ASSERT_EQ(3, count.load());
+}
+
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -250,6 +250,24 @@ TEST(StringToInt, Int8_Exhaustive) {
     }
 }
 
+TEST(StringToInt, DigitRuns) {
+    // Runs of 8 digits are converted at once, make sure every split of the string
+    // into such runs and single digits gives the right value.
+    test_int_value<int32_t>("12345678", 12345678, StringParser::PARSE_SUCCESS);
+    test_int_value<int32_t>("123456789", 123456789, StringParser::PARSE_SUCCESS);
+    test_int_value<int32_t>("-100000009", -100000009, StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("1234567890123456", 1234567890123456L,
+            StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("12345678901234567", 12345678901234567L,
+            StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("-999999999999999999", -999999999999999999L,
+            StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("000000000000000001", 1, StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("1234567/", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int64_t>("12345678:", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int64_t>("1234a5678", 0, StringParser::PARSE_FAILURE);
+}
+
 TEST(StringToIntWithBase, Basic) {
     test_int_value<int8_t>("123", 10, 123, StringParser::PARSE_SUCCESS);
     test_int_value<int16_t>("123", 10, 123, StringParser::PARSE_SUCCESS);
@@ -461,6 +479,22 @@ TEST(StringToFloat, Basic) {
     test_all_float_variants("ThisIsANaN", StringParser::PARSE_FAILURE);
 }
 
+TEST(StringToFloat, ExactDecimals) {
+    // Decimals with few enough digits are converted without strtod, they still have
+    // to give the same result.
+    test_all_float_variants("1.1", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("0.3", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("123456789.987654321", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("9007199254740992", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("9007199254740993", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("0.0000000000000000000001", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("1234567812345678.5", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("3.4028234e38", StringParser::PARSE_SUCCESS);
+    test_all_float_variants("1.", StringParser::PARSE_SUCCESS);
+    test_float_value<double>("1.2.3", StringParser::PARSE_FAILURE);
+    test_float_value<double>("12345678.x", StringParser::PARSE_FAILURE);
+}
+
 TEST(StringToFloat, InvalidLeadingTrailing) {
     // Test that trailing garbage is not allowed.
     test_float_value<double>("123xyz   ", StringParser::PARSE_FAILURE);
@@ -242,6 +242,43 @@ TEST_F(TDigestTest, Montonicity) {
     }
 }
 
+TEST_F(TDigestTest, SerializeAndMerge) {
+    std::vector<double> values;
+    TDigest merged(1000);
+    std::uniform_real_distribution<> reals(-1000.0, -100.0);
+    std::random_device gen;
+    for (int i = 0; i < 4; ++i) {
+        TDigest digest(1000);
+        for (int j = 0; j < 50000; ++j) {
+            double value = reals(gen);
+            digest.add(value);
+            values.push_back(value);
+        }
+        digest.compress();
+        std::vector<uint8_t> buf(digest.serialized_size());
+        digest.serialize(buf.data());
+
+        TDigest unserialized(1000);
+        unserialized.unserialize(buf.data());
+        EXPECT_EQ(digest.processed().size(), unserialized.processed().size());
+        EXPECT_EQ(digest.quantile(0.5), unserialized.quantile(0.5));
+        merged.merge(&unserialized);
+    }
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values.size(), merged.totalWeight());
+    for (double q : {0.0, 0.01, 0.5, 0.99, 1.0}) {
+        EXPECT_NEAR(quantile(q, values), merged.quantile(q), 2) << "q = " << q;
+    }
+}
+
+TEST_F(TDigestTest, AddCentroids) {
+    TDigest digest(100);
+    std::vector<Centroid> centroids{Centroid(1, 2), Centroid(2, 3)};
+    digest.add(centroids.cbegin(), centroids.cend());
+    EXPECT_EQ(5, digest.totalWeight());
+    EXPECT_NEAR(1.6, digest.quantile(0.5), 1);
+}
+
 }  // namespace stesting
 
 int main(int argc, char** argv) {
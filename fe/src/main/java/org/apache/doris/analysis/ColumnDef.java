@@ -141,6 +141,11 @@ public class ColumnDef {
                 throw new AnalysisException(String.format("Aggregate type %s is not compatible with primitive type %s",
                         toString(), type.toSql()));
             }
+
+            // null values are loaded to leave the column unchanged
+            if (aggregateType == AggregateType.REPLACE_IF_NOT_NULL && !isAllowNull) {
+                throw new AnalysisException("REPLACE_IF_NOT_NULL column must be nullable: " + name);
+            }
         }
 
         if (type.getPrimitiveType() == PrimitiveType.FLOAT || type.getPrimitiveType() == PrimitiveType.DOUBLE) {
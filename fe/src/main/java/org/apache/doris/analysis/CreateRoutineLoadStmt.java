@@ -27,6 +27,7 @@ import org.apache.doris.load.RoutineLoadDesc;
 import org.apache.doris.load.routineload.KafkaProgress;
 import org.apache.doris.load.routineload.LoadDataSourceType;
 import org.apache.doris.load.routineload.RoutineLoadJob;
+import org.apache.doris.thrift.TFileFormatType;
 
 import com.google.common.base.Strings;
 import com.google.common.collect.ImmutableSet;
@@ -87,6 +88,10 @@ public class CreateRoutineLoadStmt extends DdlStmt {
     public static final String MAX_BATCH_INTERVAL_SEC_PROPERTY = "max_batch_interval";
     public static final String MAX_BATCH_ROWS_PROPERTY = "max_batch_rows";
     public static final String MAX_BATCH_SIZE_PROPERTY = "max_batch_size";
+    // format of messages, csv or json. A json message is one json object in one line
+    public static final String FORMAT_PROPERTY = "format";
+    // json array of json paths of the source columns, only for json format
+    public static final String JSONPATHS_PROPERTY = "jsonpaths";
 
     // kafka type properties
     public static final String KAFKA_BROKER_LIST_PROPERTY = "kafka_broker_list";
@@ -104,6 +109,8 @@ public class CreateRoutineLoadStmt extends DdlStmt {
             .add(MAX_BATCH_INTERVAL_SEC_PROPERTY)
             .add(MAX_BATCH_ROWS_PROPERTY)
             .add(MAX_BATCH_SIZE_PROPERTY)
+            .add(FORMAT_PROPERTY)
+            .add(JSONPATHS_PROPERTY)
             .build();
 
     private static final ImmutableSet<String> KAFKA_PROPERTIES_SET = new ImmutableSet.Builder<String>()
@@ -130,6 +137,8 @@ public class CreateRoutineLoadStmt extends DdlStmt {
     private long maxBatchIntervalS = -1;
     private long maxBatchRows = -1;
     private long maxBatchSizeBytes = -1;
+    private TFileFormatType formatType = TFileFormatType.FORMAT_CSV_PLAIN;
+    private String jsonPaths;
 
     // kafka related properties
     private String kafkaBrokerList;
@@ -196,6 +205,14 @@ public class CreateRoutineLoadStmt extends DdlStmt {
         return maxBatchSizeBytes;
     }
 
+    public TFileFormatType getFormatType() {
+        return formatType;
+    }
+
+    public String getJsonPaths() {
+        return jsonPaths;
+    }
+
     public String getKafkaBrokerList() {
         return kafkaBrokerList;
     }
@@ -304,6 +321,23 @@ public class CreateRoutineLoadStmt extends DdlStmt {
         maxBatchSizeBytes = Util.getLongPropertyOrDefault(jobProperties.get(MAX_BATCH_SIZE_PROPERTY),
                 RoutineLoadJob.DEFAULT_MAX_BATCH_SIZE, MAX_BATCH_SIZE_PRED,
                 MAX_BATCH_SIZE_PROPERTY + " should between 100MB and 1GB");
+
+        checkFormatProperties();
+    }
+
+    public void checkFormatProperties() throws AnalysisException {
+        String format = jobProperties.get(FORMAT_PROPERTY);
+        if (format == null || format.equalsIgnoreCase("csv")) {
+            formatType = TFileFormatType.FORMAT_CSV_PLAIN;
+        } else if (format.equalsIgnoreCase("json")) {
+            formatType = TFileFormatType.FORMAT_JSON;
+        } else {
+            throw new AnalysisException(FORMAT_PROPERTY + " should be csv or json");
+        }
+        jsonPaths = jobProperties.get(JSONPATHS_PROPERTY);
+        if (jsonPaths != null && formatType != TFileFormatType.FORMAT_JSON) {
+            throw new AnalysisException(JSONPATHS_PROPERTY + " is only valid for json format");
+        }
     }
 
     private void checkDataSourceProperties() throws AnalysisException {
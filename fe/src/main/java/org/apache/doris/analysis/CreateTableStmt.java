@@ -224,6 +224,9 @@ public class CreateTableStmt extends DdlStmt {
                         type = AggregateType.NONE;
                     }
                     for (int i = keysDesc.keysColumnSize(); i < columnDefs.size(); ++i) {
+                        if (columnDefs.get(i).getAggregateType() == AggregateType.REPLACE_IF_NOT_NULL) {
+                            continue;
+                        }
                         columnDefs.get(i).setAggregateType(type, true);
                     }
                 }
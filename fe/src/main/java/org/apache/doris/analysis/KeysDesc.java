@@ -17,6 +17,7 @@
 
 package org.apache.doris.analysis;
 
+import org.apache.doris.catalog.AggregateType;
 import org.apache.doris.catalog.KeysType;
 import org.apache.doris.common.AnalysisException;
 import org.apache.doris.common.io.Text;
@@ -86,6 +87,14 @@ public class KeysDesc implements Writable {
                     throw new AnalysisException(type.name() + " table should specify aggregate type for "
                             + "non-key column[" + cols.get(i).getName() + "]");
                 }
+            } else if (type == KeysType.UNIQUE_KEYS) {
+                // values of a UNIQUE_KEYS table may keep the older ones when loaded with nulls,
+                // so that loads only fill the columns to update
+                if (cols.get(i).getAggregateType() != null
+                        && cols.get(i).getAggregateType() != AggregateType.REPLACE_IF_NOT_NULL) {
+                    throw new AnalysisException(type.name() + " table should not specify aggregate type "
+                            + "other than REPLACE_IF_NOT_NULL for non-key column[" + cols.get(i).getName() + "]");
+                }
             } else {
                 if (cols.get(i).getAggregateType() != null) {
                     throw new AnalysisException(type.name() + " table should not specify aggregate type for "
@@ -34,7 +34,9 @@ public enum AggregateType {
     MAX("MAX"),
     REPLACE("REPLACE"),
     HLL_UNION("HLL_UNION"),
-    NONE("NONE");
+    NONE("NONE"),
+    BITMAP_UNION("BITMAP_UNION"),
+    REPLACE_IF_NOT_NULL("REPLACE_IF_NOT_NULL");
 
     private static EnumMap<AggregateType, EnumSet<PrimitiveType>> compatibilityMap;
 
@@ -83,10 +85,18 @@ public enum AggregateType {
 
         primitiveTypeList.clear();
         compatibilityMap.put(REPLACE, EnumSet.allOf(PrimitiveType.class));
+
+        primitiveTypeList.clear();
+        compatibilityMap.put(REPLACE_IF_NOT_NULL, EnumSet.allOf(PrimitiveType.class));
        
         primitiveTypeList.clear();
         primitiveTypeList.add(PrimitiveType.HLL);
         compatibilityMap.put(HLL_UNION, EnumSet.copyOf(primitiveTypeList));
+
+        // bitmaps are stored serialized in varchar columns
+        primitiveTypeList.clear();
+        primitiveTypeList.add(PrimitiveType.VARCHAR);
+        compatibilityMap.put(BITMAP_UNION, EnumSet.copyOf(primitiveTypeList));
     
         compatibilityMap.put(NONE, EnumSet.allOf(PrimitiveType.class));
     }
@@ -127,6 +137,10 @@ public enum AggregateType {
                 return TAggregationType.NONE;
             case HLL_UNION:
                 return TAggregationType.HLL_UNION;
+            case BITMAP_UNION:
+                return TAggregationType.BITMAP_UNION;
+            case REPLACE_IF_NOT_NULL:
+                return TAggregationType.REPLACE_IF_NOT_NULL;
             default:
                 return null;
         }
@@ -186,9 +186,10 @@ public class BrokerTable extends Table {
             switch (fileFormat) {
                 case "csv":
                 case "parquet":
+                case "orc":
                     break;
                 default:
-                    throw new DdlException("Invalid file type: " + copiedProps.toString() + ".Only support csv and parquet.");
+                    throw new DdlException("Invalid file type: " + copiedProps.toString() + ".Only support csv, parquet and orc.");
             }
         }
 
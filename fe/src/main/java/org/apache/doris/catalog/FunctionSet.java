@@ -957,6 +957,25 @@ public class FunctionSet {
                     null, false, true, false));
         }
 
+        // bitmap_union and bitmap_count, over bitmaps serialized in varchar
+        final String bitmapPrefix = "_ZN5doris15BitmapFunctions";
+        addBuiltin(AggregateFunction.createBuiltin("bitmap_union",
+                Lists.<Type>newArrayList(Type.VARCHAR), Type.VARCHAR, Type.VARCHAR,
+                bitmapPrefix + "11bitmap_initEPN9doris_udf15FunctionContextEPNS1_9StringValE",
+                bitmapPrefix + "12bitmap_unionEPN9doris_udf15FunctionContextERKNS1_9StringValEPS4_",
+                bitmapPrefix + "12bitmap_unionEPN9doris_udf15FunctionContextERKNS1_9StringValEPS4_",
+                bitmapPrefix + "16bitmap_serializeEPN9doris_udf15FunctionContextERKNS1_9StringValE",
+                bitmapPrefix + "16bitmap_serializeEPN9doris_udf15FunctionContextERKNS1_9StringValE",
+                true, false, true));
+        addBuiltin(AggregateFunction.createBuiltin("bitmap_count",
+                Lists.<Type>newArrayList(Type.VARCHAR), Type.BIGINT, Type.VARCHAR,
+                bitmapPrefix + "11bitmap_initEPN9doris_udf15FunctionContextEPNS1_9StringValE",
+                bitmapPrefix + "12bitmap_unionEPN9doris_udf15FunctionContextERKNS1_9StringValEPS4_",
+                bitmapPrefix + "12bitmap_unionEPN9doris_udf15FunctionContextERKNS1_9StringValEPS4_",
+                bitmapPrefix + "16bitmap_serializeEPN9doris_udf15FunctionContextERKNS1_9StringValE",
+                bitmapPrefix + "15bitmap_finalizeEPN9doris_udf15FunctionContextERKNS1_9StringValE",
+                true, false, true));
+
         //PercentileApprox
         addBuiltin(AggregateFunction.createBuiltin("percentile_approx",
                 Lists.<Type>newArrayList(Type.DOUBLE, Type.DOUBLE), Type.DOUBLE, Type.VARCHAR,
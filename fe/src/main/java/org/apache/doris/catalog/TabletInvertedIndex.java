@@ -102,7 +102,11 @@ public class TabletInvertedIndex {
         this.lock.writeLock().unlock();
     }
 
-    public void tabletReport(long backendId, Map<Long, TTablet> backendTablets,
+    /*
+     * if isIncremental is true, backendTablets only contain the tablets changed since last report,
+     * so tablets not in it are not considered as (meta - be).
+     */
+    public void tabletReport(long backendId, Map<Long, TTablet> backendTablets, boolean isIncremental,
                              final HashMap<Long, TStorageMedium> storageMediumMap,
                              ListMultimap<Long, Long> tabletSyncMap,
                              ListMultimap<Long, Long> tabletDeleteFromMeta,
@@ -222,7 +226,7 @@ public class TabletInvertedIndex {
                                 foundTabletsWithInvalidSchema.put(tabletId, backendTabletInfo);
                             } // end for be tablet info
                         }
-                    }  else {
+                    }  else if (!isIncremental) {
                         // 2. (meta - be)
                         // may need delete from meta
                         LOG.debug("backend[{}] does not report tablet[{}-{}]", backendId, tabletId, tabletMeta);
@@ -705,6 +705,14 @@ public class Config extends ConfigBase {
      */
     @ConfField(mutable = true)
     public static long remote_fragment_exec_timeout_ms = 5000; // 5 sec
+
+    /*
+     * If true, the instances of a fragment on the same backend are started by one rpc,
+     * which carries the fragment, descriptor table and options once.
+     * Backends must be upgraded to a version supporting exec_plan_fragment_batch first.
+     */
+    @ConfField(mutable = true)
+    public static boolean enable_batch_exec_plan_fragment = true;
     
     /*
      * The number of query retries. 
@@ -46,6 +46,7 @@ import org.apache.doris.persist.RoutineLoadOperation;
 import org.apache.doris.planner.StreamLoadPlanner;
 import org.apache.doris.task.StreamLoadTask;
 import org.apache.doris.thrift.TExecPlanFragmentParams;
+import org.apache.doris.thrift.TFileFormatType;
 import org.apache.doris.thrift.TUniqueId;
 import org.apache.doris.transaction.AbstractTxnStateChangeCallback;
 import org.apache.doris.transaction.TransactionException;
@@ -140,6 +141,8 @@ public abstract class RoutineLoadJob extends AbstractTxnStateChangeCallback impl
     protected List<ImportColumnDesc> columnDescs; // optional
     protected Expr whereExpr; // optional
     protected ColumnSeparator columnSeparator; // optional
+    protected TFileFormatType formatType = TFileFormatType.FORMAT_CSV_PLAIN; // optional
+    protected String jsonPaths; // optional
     protected int desireTaskConcurrentNum; // optional
     protected JobState state = JobState.NEED_SCHEDULE;
     protected LoadDataSourceType dataSourceType;
@@ -241,6 +244,8 @@ public abstract class RoutineLoadJob extends AbstractTxnStateChangeCallback impl
         if (stmt.getMaxBatchSize() != -1) {
             this.maxBatchSizeBytes = stmt.getMaxBatchSize();
         }
+        this.formatType = stmt.getFormatType();
+        this.jsonPaths = stmt.getJsonPaths();
     }
 
     private void setRoutineLoadDesc(RoutineLoadDesc routineLoadDesc) {
@@ -366,6 +371,14 @@ public abstract class RoutineLoadJob extends AbstractTxnStateChangeCallback impl
         return columnSeparator;
     }
 
+    public TFileFormatType getFormatType() {
+        return formatType;
+    }
+
+    public String getJsonPaths() {
+        return jsonPaths;
+    }
+
     public RoutineLoadProgress getProgress() {
         return progress;
     }
@@ -1037,6 +1050,8 @@ public abstract class RoutineLoadJob extends AbstractTxnStateChangeCallback impl
         jobProperties.put("columnToColumnExpr", columnDescs == null ? STAR_STRING : Joiner.on(",").join(columnDescs));
         jobProperties.put("whereExpr", whereExpr == null ? STAR_STRING : whereExpr.toSql());
         jobProperties.put("columnSeparator", columnSeparator == null ? "\t" : columnSeparator.toString());
+        jobProperties.put("format", formatType == TFileFormatType.FORMAT_JSON ? "json" : "csv");
+        jobProperties.put("jsonpaths", jsonPaths == null ? STAR_STRING : jsonPaths);
         jobProperties.put("maxErrorNum", String.valueOf(maxErrorNum));
         jobProperties.put("maxBatchIntervalS", String.valueOf(maxBatchIntervalS));
         jobProperties.put("maxBatchRows", String.valueOf(maxBatchRows));
@@ -1167,6 +1182,10 @@ public abstract class RoutineLoadJob extends AbstractTxnStateChangeCallback impl
             stmt = (CreateRoutineLoadStmt) parser.parse().value;
             stmt.checkLoadProperties();
             setRoutineLoadDesc(stmt.getRoutineLoadDesc());
+            // format is not written, it is a job property of the origin stmt
+            stmt.checkFormatProperties();
+            formatType = stmt.getFormatType();
+            jsonPaths = stmt.getJsonPaths();
         } catch (Exception e) {
             throw new IOException("error happens when parsing create routine load stmt: " + origStmt, e);
         }
@@ -74,6 +74,7 @@ import com.google.common.collect.Lists;
 import com.google.common.collect.Maps;
 import com.google.common.collect.Queues;
 import com.google.common.collect.SetMultimap;
+import com.google.common.collect.Sets;
 
 import org.apache.commons.lang.StringUtils;
 import org.apache.logging.log4j.LogManager;
@@ -93,6 +94,10 @@ public class ReportHandler extends Daemon {
 
     private BlockingQueue<ReportTask> reportQueue = Queues.newLinkedBlockingQueue();
 
+    // backends whose tablet report is dropped or failed after being received, they're
+    // asked to report all tablets again since they only keep the changes until received
+    private Set<Long> backendsNeedFullTabletReport = Sets.newConcurrentHashSet();
+
     private GaugeMetric<Long> gaugeQueueSize;
 
     public ReportHandler() {
@@ -129,6 +134,7 @@ public class ReportHandler extends Daemon {
         Map<String, TDisk> disks = null;
         Map<Long, TTablet> tablets = null;
         boolean forceRecovery = false;
+        boolean isIncremental = false;
         long reportVersion = -1;
 
         String reportType = "";
@@ -156,8 +162,20 @@ public class ReportHandler extends Daemon {
         if (request.isSetForce_recovery()) {
             forceRecovery = request.isForce_recovery();
         }
+
+        if (tablets != null && request.isSetIs_incremental() && request.isIs_incremental()) {
+            isIncremental = true;
+            reportType += "(incremental)";
+        } else if (tablets != null) {
+            // a full report covers all the reports dropped or failed before it
+            backendsNeedFullTabletReport.remove(beId);
+        }
+        // backend only sends incremental reports after it is told that master supports them.
+        // it's told not to, until a full report is applied, once a tablet report is dropped or failed.
+        result.setSupport_incremental_tablet_report(!backendsNeedFullTabletReport.contains(beId));
         
-        ReportTask reportTask = new ReportTask(beId, tasks, disks, tablets, reportVersion, forceRecovery);
+        ReportTask reportTask = new ReportTask(beId, tasks, disks, tablets, reportVersion, forceRecovery,
+                isIncremental);
         try {
             putToQueue(reportTask);
         } catch (Exception e) {
@@ -204,17 +222,20 @@ public class ReportHandler extends Daemon {
         private Map<Long, TTablet> tablets;
         private long reportVersion;
         private boolean forceRecovery = false;
+        // tablets only contain the changed tablets of backend if true
+        private boolean isIncremental = false;
 
         public ReportTask(long beId, Map<TTaskType, Set<Long>> tasks,
                 Map<String, TDisk> disks,
                 Map<Long, TTablet> tablets, long reportVersion, 
-                boolean forceRecovery) {
+                boolean forceRecovery, boolean isIncremental) {
             this.beId = beId;
             this.tasks = tasks;
             this.disks = disks;
             this.tablets = tablets;
             this.reportVersion = reportVersion;
             this.forceRecovery = forceRecovery;
+            this.isIncremental = isIncremental;
         }
 
         @Override
@@ -230,18 +251,25 @@ public class ReportHandler extends Daemon {
                 if (reportVersion < backendReportVersion) {
                     LOG.warn("out of date report version {} from backend[{}]. current report version[{}]",
                              reportVersion, beId, backendReportVersion);
+                    // backend has forgotten the changes in this report after it was received
+                    backendsNeedFullTabletReport.add(beId);
                 } else {
-                    ReportHandler.tabletReport(beId, tablets, reportVersion, forceRecovery);
+                    try {
+                        ReportHandler.tabletReport(beId, tablets, reportVersion, forceRecovery, isIncremental);
+                    } catch (RuntimeException e) {
+                        backendsNeedFullTabletReport.add(beId);
+                        throw e;
+                    }
                 }
             }
         }
     }
 
     private static void tabletReport(long backendId, Map<Long, TTablet> backendTablets, long backendReportVersion, 
-            boolean forceRecovery) {
+            boolean forceRecovery, boolean isIncremental) {
         long start = System.currentTimeMillis();
-        LOG.info("backend[{}] reports {} tablet(s). report version: {}",
-                 backendId, backendTablets.size(), backendReportVersion);
+        LOG.info("backend[{}] reports {} tablet(s). report version: {}, incremental: {}",
+                 backendId, backendTablets.size(), backendReportVersion, isIncremental);
 
         // storage medium map
         HashMap<Long, TStorageMedium> storageMediumMap = Catalog.getInstance().getPartitionIdToStorageMediumMap();
@@ -267,7 +295,8 @@ public class ReportHandler extends Daemon {
         SetMultimap<Long, Integer> tabletWithoutPartitionId = HashMultimap.create();
 
         // 1. do the diff. find out (intersection) / (be - meta) / (meta - be)
-        Catalog.getCurrentInvertedIndex().tabletReport(backendId, backendTablets, storageMediumMap,
+        Catalog.getCurrentInvertedIndex().tabletReport(backendId, backendTablets, isIncremental,
+                                                       storageMediumMap,
                                                        tabletSyncMap,
                                                        tabletDeleteFromMeta,
                                                        foundTabletsWithValidSchema,
@@ -283,7 +312,8 @@ public class ReportHandler extends Daemon {
         sync(backendTablets, tabletSyncMap, backendId, backendReportVersion);
 
         // 3. delete (meta - be)
-        // BE will automatically drop defective tablets. these tablets should also be dropped in catalog
+        // BE will automatically drop defective tablets. these tablets should also be dropped in catalog.
+        // tablets not in an incremental report are unchanged, so nothing is found here for it.
         deleteFromMeta(tabletDeleteFromMeta, backendId, backendReportVersion, forceRecovery);
         
         // 4. handle (be - meta)
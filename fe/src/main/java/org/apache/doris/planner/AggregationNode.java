@@ -74,6 +74,7 @@ public class AggregationNode extends PlanNode {
         super(id, src, "AGGREGATE");
         aggInfo = src.aggInfo;
         needsFinalize = src.needsFinalize;
+        useStreamingPreagg = src.useStreamingPreagg;
     }
 
     public AggregateInfo getAggInfo() {
@@ -89,15 +90,21 @@ public class AggregationNode extends PlanNode {
     }
 
     /**
-     * Sets this node as a preaggregation. Only valid to call this if it is not marked
-     * as a preaggregation
+     * Sets this node as a preaggregation, the first phase of a distributed aggregation
+     * whose result is merged by the parent fragment. A grouping preaggregation streams
+     * rows which are not reduced enough to its parent, unless
+     * disable_stream_preaggregations is set.
      */
     public void setIsPreagg(PlannerContext ctx_) {
-        useStreamingPreagg =  ctx_.getQueryOptions().isSetDisable_stream_preaggregations() 
-                && !ctx_.getQueryOptions().disable_stream_preaggregations
+        useStreamingPreagg = !ctx_.getQueryOptions().disable_stream_preaggregations
+                && !aggInfo.isMerge()
                 && aggInfo.getGroupingExprs().size() > 0;
     }
 
+    public boolean useStreamingPreagg() {
+        return useStreamingPreagg;
+    }
+
     @Override
     public void setCompactData(boolean on) {
         this.compactData = on;
@@ -616,11 +616,15 @@ public class BrokerScanNode extends ScanNode {
     private TFileFormatType formatType(String fileFormat, String path) {
         if (fileFormat != null && fileFormat.toLowerCase().equals("parquet")) {
             return TFileFormatType.FORMAT_PARQUET;
+        } else if (fileFormat != null && fileFormat.toLowerCase().equals("orc")) {
+            return TFileFormatType.FORMAT_ORC;
         }
 
         String lowerCasePath = path.toLowerCase();
         if (lowerCasePath.endsWith(".parquet") || lowerCasePath.endsWith(".parq")) {
             return TFileFormatType.FORMAT_PARQUET;
+        } else if (lowerCasePath.endsWith(".orc")) {
+            return TFileFormatType.FORMAT_ORC;
         } else if (lowerCasePath.endsWith(".gz")) {
             return TFileFormatType.FORMAT_CSV_GZ;
         } else if (lowerCasePath.endsWith(".bz2")) {
@@ -23,6 +23,7 @@ import org.apache.doris.analysis.InsertStmt;
 import org.apache.doris.analysis.JoinOperator;
 import org.apache.doris.analysis.QueryStmt;
 import org.apache.doris.analysis.SlotDescriptor;
+import org.apache.doris.analysis.SlotRef;
 import org.apache.doris.catalog.Catalog;
 import org.apache.doris.catalog.ColocateTableIndex;
 import org.apache.doris.catalog.ColocateTableIndex.GroupId;
@@ -348,7 +349,9 @@ public class DistributedPlanner {
             //node.setDistributionMode(HashJoinNode.DistributionMode.PARTITIONED);
             node.setChild(0, leftChildFragment.getPlanRoot());
             node.setChild(1, rightChildFragment.getPlanRoot());
-            leftChildFragment.setPlanRoot(node);
+            PlanNode joinNode = createColocateMergeJoinNode(
+                    node, leftChildFragment.getPlanRoot(), rightChildFragment.getPlanRoot());
+            leftChildFragment.setPlanRoot(joinNode != null ? joinNode : node);
             fragments.remove(rightChildFragment);
             return leftChildFragment;
         } else {
@@ -507,6 +510,65 @@ public class DistributedPlanner {
         return false;
     }
 
+    /**
+     * Returns a merge join to replace the colocate join 'node' of two scans if its
+     * equi-join conjuncts pair up the leading key columns of both selected indexes. The
+     * scans then return rows in order of the join keys and no hash table is built.
+     * Returns null if the join can't be done that way.
+     */
+    private MergeJoinNode createColocateMergeJoinNode(HashJoinNode node, PlanNode leftRoot,
+            PlanNode rightRoot) {
+        if (ConnectContext.get() == null
+                || !ConnectContext.get().getSessionVariable().isEnableColocateMergeJoin()
+                || node.getJoinOp() != JoinOperator.INNER_JOIN
+                || !(leftRoot instanceof OlapScanNode) || !(rightRoot instanceof OlapScanNode)) {
+            return null;
+        }
+        OlapScanNode leftScan = (OlapScanNode) leftRoot;
+        OlapScanNode rightScan = (OlapScanNode) rightRoot;
+        List<Column> leftKeys = leftScan.getSelectedKeyColumns();
+        List<Column> rightKeys = rightScan.getSelectedKeyColumns();
+
+        // the equi-join conjuncts in order of the keys they compare
+        List<Pair<Expr, Expr>> cmpConjuncts = Lists.newArrayList();
+        for (int i = 0; i < leftKeys.size() && i < rightKeys.size(); ++i) {
+            Pair<Expr, Expr> keyConjunct = null;
+            for (Pair<Expr, Expr> eqJoinPredicate : node.getEqJoinConjuncts()) {
+                if (!(eqJoinPredicate.first instanceof SlotRef)
+                        || !(eqJoinPredicate.second instanceof SlotRef)) {
+                    continue;
+                }
+                SlotDescriptor leftSlot = ((SlotRef) eqJoinPredicate.first).getDesc();
+                SlotDescriptor rightSlot = ((SlotRef) eqJoinPredicate.second).getDesc();
+                if (leftSlot.getColumn() != null && rightSlot.getColumn() != null
+                        && leftSlot.getColumn().getName().equalsIgnoreCase(leftKeys.get(i).getName())
+                        && rightSlot.getColumn().getName().equalsIgnoreCase(rightKeys.get(i).getName())
+                        && leftSlot.getType().equals(rightSlot.getType())) {
+                    keyConjunct = eqJoinPredicate;
+                    break;
+                }
+            }
+            if (keyConjunct == null) {
+                break;
+            }
+            cmpConjuncts.add(keyConjunct);
+        }
+        if (cmpConjuncts.isEmpty() || cmpConjuncts.size() != node.getEqJoinConjuncts().size()) {
+            return null;
+        }
+
+        MergeJoinNode mergeJoinNode = new MergeJoinNode(node.getId(), leftRoot, rightRoot,
+                cmpConjuncts, node.getOtherJoinConjuncts());
+        mergeJoinNode.addConjuncts(node.getConjuncts());
+        mergeJoinNode.setLimit(node.getLimit());
+        mergeJoinNode.cardinality = node.getCardinality();
+        mergeJoinNode.avgRowSize = node.getAvgRowSize();
+        mergeJoinNode.numNodes = node.getNumNodes();
+        leftScan.setOrderedByKeys(true);
+        rightScan.setOrderedByKeys(true);
+        return mergeJoinNode;
+    }
+
     /**
      * Modifies the leftChildFragment to execute a cross join. The right child input is provided by an ExchangeNode,
      * which is the destination of the rightChildFragment's output.
@@ -98,6 +98,10 @@ public class HashJoinNode extends PlanNode {
         return eqJoinConjuncts;
     }
 
+    public List<Expr> getOtherJoinConjuncts() {
+        return otherJoinConjuncts;
+    }
+
     public JoinOperator getJoinOp() {
         return joinOp;
     }
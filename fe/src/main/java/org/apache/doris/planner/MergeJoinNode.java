@@ -34,9 +34,8 @@ import org.apache.logging.log4j.LogManager;
 import java.util.List;
 
 /**
- * Merge join between left child and right child.
- * The right child must be a leaf node, ie, can only materialize
- * a single input tuple.
+ * Inner merge join between left child and right child, both of which return rows
+ * in order of the exprs of cmpConjuncts.
  */
 public class MergeJoinNode extends PlanNode {
     private final static Logger LOG = LogManager.getLogger(MergeJoinNode.class);
@@ -60,11 +59,8 @@ public class MergeJoinNode extends PlanNode {
         children.add(inner);
 
         // Inherits all the nullable tuple from the children
-        // Mark tuples that form the "nullable" side of the outer join as nullable.
         nullableTupleIds.addAll(inner.getNullableTupleIds());
         nullableTupleIds.addAll(outer.getNullableTupleIds());
-        nullableTupleIds.addAll(outer.getTupleIds());
-        nullableTupleIds.addAll(inner.getTupleIds());
     }
 
     public List<Pair<Expr, Expr>> getCmpConjuncts() {
@@ -118,7 +114,7 @@ public class MergeJoinNode extends PlanNode {
             msg.merge_join_node.addToCmp_conjuncts(eqJoinCondition);
         }
         for (Expr e : otherJoinConjuncts) {
-            msg.hash_join_node.addToOther_join_conjuncts(e.treeToThrift());
+            msg.merge_join_node.addToOther_join_conjuncts(e.treeToThrift());
         }
     }
 
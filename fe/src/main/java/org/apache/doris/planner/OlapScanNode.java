@@ -47,6 +47,7 @@ import org.apache.doris.thrift.TPaloScanRange;
 import org.apache.doris.thrift.TPlanNode;
 import org.apache.doris.thrift.TPlanNodeType;
 import org.apache.doris.thrift.TPrimitiveType;
+import org.apache.doris.thrift.TPushAggOp;
 import org.apache.doris.thrift.TScanRange;
 import org.apache.doris.thrift.TScanRangeLocation;
 import org.apache.doris.thrift.TScanRangeLocations;
@@ -88,6 +89,15 @@ public class OlapScanNode extends ScanNode {
     private long selectedIndexId = -1;
     private int selectedPartitionNum = 0;
     private long totalBytes = 0;
+    // aggregation over this node which can be answered by meta of rowsets
+    private TPushAggOp pushDownAggType = TPushAggOp.NONE;
+    // top n above this node which is pushed down if its ordering columns are prefix of keys
+    // of the selected index
+    private List<String> topNColumnNames = null;
+    private long topNLimit = -1;
+    private long pushDownTopNLimit = -1;
+    // rows are returned in order of the keys of the selected index, e.g. for a merge join
+    private boolean orderedByKeys = false;
 
     boolean isFinalized = false;
 
@@ -126,6 +136,43 @@ public class OlapScanNode extends ScanNode {
         return olapTable;
     }
 
+    public void setPushDownAggType(TPushAggOp pushDownAggType) {
+        this.pushDownAggType = pushDownAggType;
+    }
+
+    public void setOrderedByKeys(boolean orderedByKeys) {
+        this.orderedByKeys = orderedByKeys;
+    }
+
+    // key columns of the selected index, in order
+    public List<Column> getSelectedKeyColumns() {
+        if (selectedIndexId == -1) {
+            return Lists.newArrayList();
+        }
+        return olapTable.getKeyColumnsByIndexId(selectedIndexId);
+    }
+
+    public void setTopNCandidate(List<String> columnNames, long limit) {
+        this.topNColumnNames = columnNames;
+        this.topNLimit = limit;
+    }
+
+    private void computePushDownTopN() {
+        if (topNColumnNames == null || selectedIndexId == -1) {
+            return;
+        }
+        List<Column> keyColumns = olapTable.getKeyColumnsByIndexId(selectedIndexId);
+        if (topNColumnNames.size() > keyColumns.size()) {
+            return;
+        }
+        for (int i = 0; i < topNColumnNames.size(); ++i) {
+            if (!topNColumnNames.get(i).equalsIgnoreCase(keyColumns.get(i).getName())) {
+                return;
+            }
+        }
+        pushDownTopNLimit = topNLimit;
+    }
+
     @Override
     protected String debugString() {
         ToStringHelper helper = Objects.toStringHelper(this);
@@ -146,6 +193,7 @@ public class OlapScanNode extends ScanNode {
         } catch (AnalysisException e) {
             throw new UserException(e.getMessage());
         }
+        computePushDownTopN();
 
         computeStats(analyzer);
         isFinalized = true;
@@ -395,6 +443,12 @@ public class OlapScanNode extends ScanNode {
         } else {
             output.append(prefix).append("PREAGGREGATION: OFF. Reason: ").append(reasonOfPreAggregation).append("\n");
         }
+        if (pushDownAggType != TPushAggOp.NONE) {
+            output.append(prefix).append("PUSHDOWN AGGREGATION: ").append(pushDownAggType).append("\n");
+        }
+        if (pushDownTopNLimit != -1) {
+            output.append(prefix).append("PUSHDOWN TOPN: ").append(pushDownTopNLimit).append("\n");
+        }
         if (!conjuncts.isEmpty()) {
             output.append(prefix).append("PREDICATES: ").append(
                     getExplainString(conjuncts)).append("\n");
@@ -454,6 +508,15 @@ public class OlapScanNode extends ScanNode {
         if (null != sortColumn) {
             msg.olap_scan_node.setSort_column(sortColumn);
         }
+        if (pushDownAggType != TPushAggOp.NONE) {
+            msg.olap_scan_node.setPush_down_agg_type(pushDownAggType);
+        }
+        if (pushDownTopNLimit != -1) {
+            msg.olap_scan_node.setPush_down_topn_limit(pushDownTopNLimit);
+        }
+        if (orderedByKeys) {
+            msg.olap_scan_node.setOrdered_by_keys(true);
+        }
     }
 
     // export some tablets
@@ -25,6 +25,7 @@ import org.apache.doris.catalog.DistributionInfo;
 import org.apache.doris.catalog.HashDistributionInfo;
 import org.apache.doris.catalog.MaterializedIndex;
 import org.apache.doris.catalog.OlapTable;
+import org.apache.doris.catalog.OlapTable.OlapTableState;
 import org.apache.doris.catalog.Partition;
 import org.apache.doris.catalog.PartitionKey;
 import org.apache.doris.catalog.PartitionType;
@@ -36,6 +37,7 @@ import org.apache.doris.common.ErrorReport;
 import org.apache.doris.common.UserException;
 import org.apache.doris.system.Backend;
 import org.apache.doris.system.SystemInfoService;
+import org.apache.doris.thrift.TAggregationType;
 import org.apache.doris.thrift.TDataSink;
 import org.apache.doris.thrift.TDataSinkType;
 import org.apache.doris.thrift.TExplainLevel;
@@ -176,11 +178,24 @@ public class OlapTableSink extends DataSink {
             schemaParam.addToSlot_descs(slotDesc.toThrift());
         }
 
+        // rows of a table under schema change are converted to the new schema by the
+        // receivers too, so they are only pre-aggregated by keys of a stable table
+        boolean withAggregationTypes = table.getState() == OlapTableState.NORMAL;
+        if (withAggregationTypes) {
+            schemaParam.setKeys_type(table.getKeysType().toThrift());
+        }
         for (Map.Entry<Long, List<Column>> pair : table.getIndexIdToSchema().entrySet()) {
             List<String> columns = Lists.newArrayList();
             columns.addAll(pair.getValue().stream().map(Column::getName).collect(Collectors.toList()));
-            schemaParam.addToIndexes(new TOlapTableIndexSchema(pair.getKey(), columns,
-                    table.getSchemaHashByIndexId(pair.getKey())));
+            TOlapTableIndexSchema indexSchema = new TOlapTableIndexSchema(pair.getKey(), columns,
+                    table.getSchemaHashByIndexId(pair.getKey()));
+            if (withAggregationTypes) {
+                for (Column column : pair.getValue()) {
+                    indexSchema.addToAggregation_types(column.isKey() || column.getAggregationType() == null
+                            ? TAggregationType.NONE : column.getAggregationType().toThrift());
+                }
+            }
+            schemaParam.addToIndexes(indexSchema);
         }
         return schemaParam;
     }
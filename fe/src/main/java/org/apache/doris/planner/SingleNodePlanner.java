@@ -39,6 +39,7 @@ import org.apache.doris.analysis.SelectStmt;
 import org.apache.doris.analysis.SlotDescriptor;
 import org.apache.doris.analysis.SlotId;
 import org.apache.doris.analysis.SlotRef;
+import org.apache.doris.analysis.SortInfo;
 import org.apache.doris.analysis.TableRef;
 import org.apache.doris.analysis.TupleDescriptor;
 import org.apache.doris.analysis.TupleId;
@@ -46,12 +47,14 @@ import org.apache.doris.analysis.TupleIsNullPredicate;
 import org.apache.doris.analysis.UnionStmt;
 import org.apache.doris.catalog.AggregateType;
 import org.apache.doris.catalog.Column;
+import org.apache.doris.catalog.KeysType;
 import org.apache.doris.catalog.MysqlTable;
 import org.apache.doris.catalog.Table;
 import org.apache.doris.common.AnalysisException;
 import org.apache.doris.common.Pair;
 import org.apache.doris.common.Reference;
 import org.apache.doris.common.UserException;
+import org.apache.doris.thrift.TPushAggOp;
 
 import com.google.common.base.Preconditions;
 import com.google.common.base.Predicate;
@@ -249,6 +252,9 @@ public class SingleNodePlanner {
             if (limit == -1 && analyzer.getContext().getSessionVariable().enableSpilling) {
                 useTopN = false;
             }
+            if (useTopN && limit != -1 && root instanceof OlapScanNode) {
+                pushDownTopN(stmt.getSortInfo(), (OlapScanNode) root, limit + stmt.getOffset());
+            }
             root = new SortNode(ctx_.getNextNodeId(), root, stmt.getSortInfo(),
                     useTopN, limit == -1, stmt.getOffset());
             if (useTopN) {
@@ -701,6 +707,9 @@ public class SingleNodePlanner {
         Preconditions.checkState(selectStmt.getAggInfo() != null);
         // add aggregation, if required
         AggregateInfo aggInfo = selectStmt.getAggInfo();
+        if (root instanceof OlapScanNode) {
+            ((OlapScanNode) root).setPushDownAggType(getPushDownAggType(selectStmt, aggInfo, (OlapScanNode) root));
+        }
         PlanNode newRoot = new AggregationNode(ctx_.getNextNodeId(), root, aggInfo);
         newRoot.init(analyzer);
         Preconditions.checkState(newRoot.hasValidStats());
@@ -720,6 +729,80 @@ public class SingleNodePlanner {
         return newRoot;
     }
 
+    /**
+     * Tells scan node that only first 'limit' rows of each tablet are needed when rows are
+     * sorted in ascending order of columns of scan tuple with nulls first, which is the order
+     * of rows in storage if the columns are prefix of keys of the selected index.
+     */
+    private void pushDownTopN(SortInfo sortInfo, OlapScanNode scanNode, long limit) {
+        // rows of other keys types are aggregated after being read, conjuncts are fine since
+        // they are evaluated by scanners before rows are counted
+        if (scanNode.getOlapTable().getKeysType() != KeysType.DUP_KEYS) {
+            return;
+        }
+        List<String> columnNames = Lists.newArrayList();
+        List<Boolean> nullsFirst = sortInfo.getNullsFirst();
+        for (int i = 0; i < sortInfo.getOrderingExprs().size(); ++i) {
+            if (!sortInfo.getIsAscOrder().get(i) || !nullsFirst.get(i)) {
+                return;
+            }
+            Expr expr = sortInfo.getOrderingExprs().get(i);
+            // ordering exprs may be substituted by slots of sort tuple
+            if (expr instanceof SlotRef && ((SlotRef) expr).getDesc().getSourceExprs().size() == 1) {
+                expr = ((SlotRef) expr).getDesc().getSourceExprs().get(0);
+            }
+            if (!(expr instanceof SlotRef)) {
+                return;
+            }
+            SlotDescriptor slotDesc = ((SlotRef) expr).getDesc();
+            if (!slotDesc.getParent().getId().equals(scanNode.getTupleIds().get(0))
+                    || slotDesc.getColumn() == null) {
+                return;
+            }
+            columnNames.add(slotDesc.getColumn().getName());
+        }
+        scanNode.setTopNCandidate(columnNames, limit);
+    }
+
+    /**
+     * Returns the aggregation which can be answered by number of rows and zone maps in meta of
+     * rowsets when scan node reads a duplicate keys table without any predicate, so that BE need
+     * not read rows. Aggregations must be count(*), count of not nullable columns, or min/max of
+     * not nullable numeric or date columns.
+     */
+    private TPushAggOp getPushDownAggType(SelectStmt selectStmt, AggregateInfo aggInfo, OlapScanNode scanNode) {
+        if (selectStmt.getTableRefs().size() != 1 || aggInfo.isDistinctAgg()
+                || !aggInfo.getGroupingExprs().isEmpty() || !scanNode.getConjuncts().isEmpty()
+                || scanNode.getOlapTable().getKeysType() != KeysType.DUP_KEYS) {
+            return TPushAggOp.NONE;
+        }
+        TPushAggOp aggType = TPushAggOp.COUNT;
+        for (FunctionCallExpr aggExpr : aggInfo.getAggregateExprs()) {
+            String fnName = aggExpr.getFnName().getFunction();
+            if (fnName.equalsIgnoreCase("count") && aggExpr.getParams().isStar()) {
+                continue;
+            }
+            if (aggExpr.getChildren().size() != 1 || !(aggExpr.getChild(0) instanceof SlotRef)) {
+                return TPushAggOp.NONE;
+            }
+            SlotRef slotRef = (SlotRef) aggExpr.getChild(0);
+            if (slotRef.getDesc() == null || slotRef.getDesc().getIsNullable()) {
+                return TPushAggOp.NONE;
+            }
+            if (fnName.equalsIgnoreCase("count")) {
+                continue;
+            }
+            if (!fnName.equalsIgnoreCase("min") && !fnName.equalsIgnoreCase("max")) {
+                return TPushAggOp.NONE;
+            }
+            if (!slotRef.getType().isNumericType() && !slotRef.getType().isDateType()) {
+                return TPushAggOp.NONE;
+            }
+            aggType = TPushAggOp.MINMAX;
+        }
+        return aggType;
+    }
+
     /**
      * Returns a MergeNode that materializes the exprs of the constant selectStmt. Replaces the resultExprs of the
      * selectStmt with SlotRefs into the materialized tuple.
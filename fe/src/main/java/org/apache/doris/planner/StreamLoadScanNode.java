@@ -43,6 +43,7 @@ import org.apache.doris.thrift.TBrokerScanNode;
 import org.apache.doris.thrift.TBrokerScanRange;
 import org.apache.doris.thrift.TBrokerScanRangeParams;
 import org.apache.doris.thrift.TExplainLevel;
+import org.apache.doris.thrift.TFileFormatType;
 import org.apache.doris.thrift.TPlanNode;
 import org.apache.doris.thrift.TPlanNodeType;
 import org.apache.doris.thrift.TScanRange;
@@ -51,6 +52,9 @@ import org.apache.doris.thrift.TUniqueId;
 
 import com.google.common.collect.Lists;
 import com.google.common.collect.Maps;
+import com.google.gson.Gson;
+import com.google.gson.JsonSyntaxException;
+import com.google.gson.reflect.TypeToken;
 
 import org.apache.logging.log4j.LogManager;
 import org.apache.logging.log4j.Logger;
@@ -118,6 +122,8 @@ public class StreamLoadScanNode extends ScanNode {
         srcTupleDesc = analyzer.getDescTbl().createTupleDescriptor("StreamLoadScanNode");
 
         TBrokerScanRangeParams params = new TBrokerScanRangeParams();
+        // names of source columns, in the order of src slots
+        List<String> srcColumnNames = Lists.newArrayList();
 
         // parse columns header. this contain map from input column to column of destination table
         // columns: k1, k2, v1, v2=k1 + k2
@@ -142,6 +148,7 @@ public class StreamLoadScanNode extends ScanNode {
                     slotDesc.setIsNullable(true);
                     params.addToSrc_slot_ids(slotDesc.getId().asInt());
                     slotDescByName.put(realColName, slotDesc);
+                    srcColumnNames.add(columnName);
                 }
             }
 
@@ -183,6 +190,7 @@ public class StreamLoadScanNode extends ScanNode {
                 params.addToSrc_slot_ids(slotDesc.getId().asInt());
 
                 slotDescByName.put(column.getName(), slotDesc);
+                srcColumnNames.add(column.getName());
             }
         }
 
@@ -229,6 +237,9 @@ public class StreamLoadScanNode extends ScanNode {
             params.setColumn_separator((byte) '\t');
         }
         params.setLine_delimiter((byte) '\n');
+        if (streamLoadTask.getFormatType() == TFileFormatType.FORMAT_JSON) {
+            params.setJson_paths(getJsonPaths(srcColumnNames));
+        }
         params.setSrc_tuple_id(srcTupleDesc.getId().asInt());
         params.setDest_tuple_id(desc.getId().asInt());
         brokerScanRange.setParams(params);
@@ -236,6 +247,29 @@ public class StreamLoadScanNode extends ScanNode {
         brokerScanRange.setBroker_addresses(Lists.newArrayList());
     }
 
+    // json paths of source columns, which are "$.<column name>" if they are not given
+    private List<String> getJsonPaths(List<String> srcColumnNames) throws UserException {
+        if (streamLoadTask.getJsonPaths() == null) {
+            List<String> jsonPaths = Lists.newArrayList();
+            for (String columnName : srcColumnNames) {
+                jsonPaths.add("$." + columnName);
+            }
+            return jsonPaths;
+        }
+        List<String> jsonPaths;
+        try {
+            jsonPaths = new Gson().fromJson(streamLoadTask.getJsonPaths(),
+                    new TypeToken<List<String>>() {}.getType());
+        } catch (JsonSyntaxException e) {
+            throw new UserException("invalid json paths, jsonpaths=" + streamLoadTask.getJsonPaths());
+        }
+        if (jsonPaths == null || jsonPaths.size() != srcColumnNames.size()) {
+            throw new UserException("number of json paths is not the number of source columns, jsonpaths="
+                    + streamLoadTask.getJsonPaths() + ", columns=" + srcColumnNames);
+        }
+        return jsonPaths;
+    }
+
     @Override
     public void finalize(Analyzer analyzer) throws UserException, UserException {
         finalizeParams();
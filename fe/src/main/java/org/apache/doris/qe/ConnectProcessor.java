@@ -104,6 +104,10 @@ public class ConnectProcessor {
         Preconditions.checkNotNull(statistics); 
         ctx.getAuditBuilder().put("ScanBytes", statistics.scan_bytes);
         ctx.getAuditBuilder().put("ScanRows", statistics.scan_rows);
+        ctx.getAuditBuilder().put("ScanBytesFromPageCache", statistics.scan_bytes_from_page_cache);
+        ctx.getAuditBuilder().put("CpuTimeMS", statistics.cpu_ms);
+        ctx.getAuditBuilder().put("SpillBytes", statistics.spill_bytes);
+        ctx.getAuditBuilder().put("PeakMemoryBytes", statistics.max_peak_memory_bytes);
         ctx.getAuditBuilder().put("ReturnRows", ctx.getReturnRows());
         ctx.getAuditBuilder().put("StmtId", ctx.getStmtId());
         ctx.getAuditBuilder().put("QueryId", ctx.queryId() == null ? "NaN" : DebugUtil.printId(ctx.queryId()));
@@ -36,6 +36,7 @@ import org.apache.doris.planner.DataSink;
 import org.apache.doris.planner.DataStreamSink;
 import org.apache.doris.planner.ExchangeNode;
 import org.apache.doris.planner.HashJoinNode;
+import org.apache.doris.planner.MergeJoinNode;
 import org.apache.doris.planner.OlapScanNode;
 import org.apache.doris.planner.PlanFragment;
 import org.apache.doris.planner.PlanFragmentId;
@@ -55,6 +56,7 @@ import org.apache.doris.task.LoadEtlTask;
 import org.apache.doris.thrift.PaloInternalServiceVersion;
 import org.apache.doris.thrift.TDescriptorTable;
 import org.apache.doris.thrift.TEsScanRange;
+import org.apache.doris.thrift.TExecPlanFragmentBatchParams;
 import org.apache.doris.thrift.TExecPlanFragmentParams;
 import org.apache.doris.thrift.TLoadErrorHubInfo;
 import org.apache.doris.thrift.TNetworkAddress;
@@ -434,6 +436,8 @@ public class Coordinator {
                 }
 
                 int instanceId = 0;
+                // instances by backend, in the order they are sent
+                Map<TNetworkAddress, List<BackendExecState>> hostToExecStates = Maps.newLinkedHashMap();
                 for (TExecPlanFragmentParams tParam : tParams) {
                     // TODO: pool of pre-formatted BackendExecStates?
                     BackendExecState execState =
@@ -442,10 +446,30 @@ public class Coordinator {
                     backendExecStates.add(execState);
                     backendExecStateMap.put(tParam.params.getFragment_instance_id(), execState);
 
-                    futures.add(Pair.create(execState, execState.execRemoteFragmentAsync()));
+                    if (Config.enable_batch_exec_plan_fragment) {
+                        List<BackendExecState> states = hostToExecStates.get(execState.address);
+                        if (states == null) {
+                            states = Lists.newArrayList();
+                            hostToExecStates.put(execState.address, states);
+                        }
+                        states.add(execState);
+                    } else {
+                        futures.add(Pair.create(execState, execState.execRemoteFragmentAsync()));
+                    }
 
                     backendId++;
                 }
+                for (List<BackendExecState> states : hostToExecStates.values()) {
+                    if (states.size() == 1) {
+                        futures.add(Pair.create(states.get(0), states.get(0).execRemoteFragmentAsync()));
+                        continue;
+                    }
+                    // the instances share the result of the rpc starting them
+                    Future<PExecPlanFragmentResult> future = execRemoteFragmentsAsync(states);
+                    for (BackendExecState state : states) {
+                        futures.add(Pair.create(state, future));
+                    }
+                }
 
                 for (Pair<BackendExecState, Future<PExecPlanFragmentResult>> pair : futures) {
                     TStatusCode code = TStatusCode.INTERNAL_ERROR;
@@ -946,6 +970,12 @@ public class Coordinator {
             }
         }
 
+        // merge joins are only planned for colocate joins
+        if (node instanceof MergeJoinNode) {
+            colocateFragmentIds.add(node.getFragmentId().asInt());
+            return true;
+        }
+
         for (PlanNode childNode : node.getChildren()) {
             return isColocateJoin(childNode);
         }
@@ -1284,6 +1314,55 @@ public class Coordinator {
         }
     }
 
+    // Starts the instances of one fragment on the same backend with one rpc. The
+    // params they have in common are taken from the first one.
+    private Future<PExecPlanFragmentResult> execRemoteFragmentsAsync(List<BackendExecState> states)
+            throws TException, RpcException {
+        BackendExecState first = states.get(0);
+        TExecPlanFragmentParams firstParams = first.rpcParams;
+        TExecPlanFragmentParams common = new TExecPlanFragmentParams();
+        common.setProtocol_version(firstParams.getProtocol_version());
+        common.setFragment(firstParams.getFragment());
+        common.setDesc_tbl(firstParams.getDesc_tbl());
+        common.setCoord(firstParams.getCoord());
+        common.setQuery_globals(firstParams.getQuery_globals());
+        common.setQuery_options(firstParams.getQuery_options());
+        if (firstParams.isSetIs_report_success()) {
+            common.setIs_report_success(firstParams.isIs_report_success());
+        }
+        common.setResource_info(firstParams.getResource_info());
+        common.setImport_label(firstParams.getImport_label());
+        common.setDb_name(firstParams.getDb_name());
+        if (firstParams.isSetLoad_job_id()) {
+            common.setLoad_job_id(firstParams.getLoad_job_id());
+        }
+        common.setLoad_error_hub_info(firstParams.getLoad_error_hub_info());
+
+        TExecPlanFragmentBatchParams batchParams = new TExecPlanFragmentBatchParams();
+        batchParams.setProtocol_version(PaloInternalServiceVersion.V1);
+        batchParams.setCommon(common);
+        for (BackendExecState state : states) {
+            batchParams.addToInstance_params(state.rpcParams.getParams());
+            batchParams.addToBackend_nums(state.rpcParams.getBackend_num());
+        }
+
+        TNetworkAddress brpcAddress = null;
+        try {
+            brpcAddress = toBrpcHost(first.address);
+        } catch (Exception e) {
+            throw new TException(e.getMessage());
+        }
+        for (BackendExecState state : states) {
+            state.initiated = true;
+        }
+        try {
+            return BackendServiceProxy.getInstance().execPlanFragmentBatchAsync(brpcAddress, batchParams);
+        } catch (RpcException e) {
+            SimpleScheduler.updateBlacklistBackends(first.backendId);
+            throw e;
+        }
+    }
+
     // execution parameters for a single fragment,
     // per-fragment can have multiple FInstanceExecParam,
     // used to assemble TPlanFragmentExecParas  
@@ -73,6 +73,13 @@ public class SessionVariable implements Serializable, Writable {
     public static final int MAX_EXEC_INSTANCE_NUM = 32;
     // if set to true, some of stmt will be forwarded to master FE to get result
     public static final String FORWARD_TO_MASTER = "forward_to_master";
+    // if set to true, hardware counters of every exec node are added into the profile
+    public static final String ENABLE_PERF_COUNTERS = "enable_perf_counters";
+    public static final String ENABLE_QUERY_TRACE = "enable_query_trace";
+    public static final String ENABLE_FRAGMENT_RESULT_CACHE = "enable_fragment_result_cache";
+    // if set to true, colocate inner joins of two tables on leading keys are planned as
+    // merge joins over the scans read in order of keys, without building hash tables
+    public static final String ENABLE_COLOCATE_MERGE_JOIN = "enable_colocate_merge_join";
 
     // max memory used on every backend.
     @VariableMgr.VarAttr(name = EXEC_MEM_LIMIT)
@@ -192,6 +199,18 @@ public class SessionVariable implements Serializable, Writable {
     @VariableMgr.VarAttr(name = FORWARD_TO_MASTER)
     private boolean forwardToMaster = false;
 
+    @VariableMgr.VarAttr(name = ENABLE_PERF_COUNTERS)
+    private boolean enablePerfCounters = false;
+
+    @VariableMgr.VarAttr(name = ENABLE_QUERY_TRACE)
+    private boolean enableQueryTrace = false;
+
+    @VariableMgr.VarAttr(name = ENABLE_FRAGMENT_RESULT_CACHE)
+    private boolean enableFragmentResultCache = false;
+
+    @VariableMgr.VarAttr(name = ENABLE_COLOCATE_MERGE_JOIN)
+    private boolean enableColocateMergeJoin = false;
+
     public long getMaxExecMemByte() {
         return maxExecMemByte;
     }
@@ -451,6 +470,38 @@ public class SessionVariable implements Serializable, Writable {
         this.forwardToMaster = forwardToMaster;
     }
 
+    public boolean isEnablePerfCounters() {
+        return enablePerfCounters;
+    }
+
+    public void setEnablePerfCounters(boolean enablePerfCounters) {
+        this.enablePerfCounters = enablePerfCounters;
+    }
+
+    public boolean isEnableQueryTrace() {
+        return enableQueryTrace;
+    }
+
+    public void setEnableQueryTrace(boolean enableQueryTrace) {
+        this.enableQueryTrace = enableQueryTrace;
+    }
+
+    public boolean isEnableFragmentResultCache() {
+        return enableFragmentResultCache;
+    }
+
+    public void setEnableFragmentResultCache(boolean enableFragmentResultCache) {
+        this.enableFragmentResultCache = enableFragmentResultCache;
+    }
+
+    public boolean isEnableColocateMergeJoin() {
+        return enableColocateMergeJoin;
+    }
+
+    public void setEnableColocateMergeJoin(boolean enableColocateMergeJoin) {
+        this.enableColocateMergeJoin = enableColocateMergeJoin;
+    }
+
     // Serialize to thrift object
     // used for rest api
     public TQueryOptions toThrift() {
@@ -469,6 +520,9 @@ public class SessionVariable implements Serializable, Writable {
 
         tResult.setBatch_size(batchSize);
         tResult.setDisable_stream_preaggregations(disableStreamPreaggregations);
+        tResult.setEnable_perf_counters(enablePerfCounters);
+        tResult.setEnable_query_trace(enableQueryTrace);
+        tResult.setEnable_fragment_result_cache(enableFragmentResultCache);
         return tResult;
     }
 
@@ -855,6 +855,18 @@ public class StmtExecutor {
         if (statisticsForAuditLog.scan_rows == null) {
             statisticsForAuditLog.scan_rows = 0L;
         }
+        if (statisticsForAuditLog.scan_bytes_from_page_cache == null) {
+            statisticsForAuditLog.scan_bytes_from_page_cache = 0L;
+        }
+        if (statisticsForAuditLog.cpu_ms == null) {
+            statisticsForAuditLog.cpu_ms = 0L;
+        }
+        if (statisticsForAuditLog.spill_bytes == null) {
+            statisticsForAuditLog.spill_bytes = 0L;
+        }
+        if (statisticsForAuditLog.max_peak_memory_bytes == null) {
+            statisticsForAuditLog.max_peak_memory_bytes = 0L;
+        }
         return statisticsForAuditLog;
     }
 }
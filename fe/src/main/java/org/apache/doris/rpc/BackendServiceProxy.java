@@ -27,6 +27,7 @@ import org.apache.doris.proto.PProxyRequest;
 import org.apache.doris.proto.PProxyResult;
 import org.apache.doris.proto.PTriggerProfileReportResult;
 import org.apache.doris.proto.PUniqueId;
+import org.apache.doris.thrift.TExecPlanFragmentBatchParams;
 import org.apache.doris.thrift.TExecPlanFragmentParams;
 import org.apache.doris.thrift.TNetworkAddress;
 import org.apache.doris.thrift.TUniqueId;
@@ -111,6 +112,37 @@ public class BackendServiceProxy {
         }
     }
 
+    // start the instances of one fragment on one backend in one rpc
+    public Future<PExecPlanFragmentResult> execPlanFragmentBatchAsync(
+            TNetworkAddress address, TExecPlanFragmentBatchParams tRequest)
+            throws TException, RpcException {
+        final PExecPlanFragmentRequest pRequest = new PExecPlanFragmentRequest();
+        pRequest.setRequest(tRequest);
+        try {
+            final PBackendService service = getProxy(address);
+            return service.execPlanFragmentBatchAsync(pRequest);
+        } catch (NoSuchElementException e) {
+            try {
+                // retry
+                try {
+                    Thread.sleep(10);
+                } catch (InterruptedException interruptedException) {
+                    // do nothing
+                }
+                final PBackendService service = getProxy(address);
+                return service.execPlanFragmentBatchAsync(pRequest);
+            } catch (NoSuchElementException noSuchElementException) {
+                LOG.warn("Execute plan fragment batch retry failed, address={}:{}",
+                        address.getHostname(), address.getPort(), noSuchElementException);
+                throw new RpcException(e.getMessage());
+            }
+        } catch (Throwable e) {
+            LOG.warn("Execute plan fragment batch catch a exception, address={}:{}",
+                    address.getHostname(), address.getPort(), e);
+            throw new RpcException(e.getMessage());
+        }
+    }
+
     public Future<PCancelPlanFragmentResult> cancelPlanFragmentAsync(
             TNetworkAddress address, TUniqueId finstId, PPlanFragmentCancelReason cancelReason) throws RpcException {
         final PCancelPlanFragmentRequest pRequest = new PCancelPlanFragmentRequest();
@@ -57,6 +57,8 @@ public class StreamLoadTask {
     private String partitions;
     private String path;
     private boolean negative;
+    // json array of json paths of source columns, only for json format
+    private String jsonPaths;
     private int timeout = Config.stream_load_default_timeout_second;
 
     public StreamLoadTask(TUniqueId id, long txnId, TFileType fileType, TFileFormatType formatType) {
@@ -106,6 +108,10 @@ public class StreamLoadTask {
         return negative;
     }
 
+    public String getJsonPaths() {
+        return jsonPaths;
+    }
+
     public int getTimeout() {
         return timeout;
     }
@@ -143,12 +149,15 @@ public class StreamLoadTask {
         if (request.isSetTimeout()) {
             timeout = request.getTimeout();
         }
+        if (request.isSetJsonpaths()) {
+            jsonPaths = request.getJsonpaths();
+        }
     }
 
     public static StreamLoadTask fromRoutineLoadJob(RoutineLoadJob routineLoadJob) {
         TUniqueId dummyId = new TUniqueId();
         StreamLoadTask streamLoadTask = new StreamLoadTask(dummyId, -1L /* dummy txn id*/,
-                TFileType.FILE_STREAM, TFileFormatType.FORMAT_CSV_PLAIN);
+                TFileType.FILE_STREAM, routineLoadJob.getFormatType());
         streamLoadTask.setOptionalFromRoutineLoadJob(routineLoadJob);
         return streamLoadTask;
     }
@@ -158,6 +167,7 @@ public class StreamLoadTask {
         whereExpr = routineLoadJob.getWhereExpr();
         columnSeparator = routineLoadJob.getColumnSeparator();
         partitions = routineLoadJob.getPartitions() == null ? null : Joiner.on(",").join(routineLoadJob.getPartitions());
+        jsonPaths = routineLoadJob.getJsonPaths();
     }
 
     private void setColumnToColumnExpr(String columns) throws UserException {
@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+package org.apache.doris.planner;
+
+import org.apache.doris.analysis.AggregateInfo;
+import org.apache.doris.analysis.Expr;
+import org.apache.doris.analysis.FunctionCallExpr;
+import org.apache.doris.analysis.IntLiteral;
+import org.apache.doris.analysis.TupleId;
+import org.apache.doris.thrift.TPlanNode;
+import org.apache.doris.thrift.TQueryOptions;
+
+import com.google.common.collect.Lists;
+
+import org.junit.Assert;
+import org.junit.Test;
+
+import java.util.ArrayList;
+
+import mockit.Injectable;
+import mockit.NonStrictExpectations;
+
+public class AggregationNodeTest {
+    @Injectable
+    AggregateInfo aggInfo;
+
+    @Injectable
+    PlanNode input;
+
+    private AggregationNode createNode(boolean isMerge, int numGroupingExprs) {
+        ArrayList<Expr> groupingExprs = Lists.newArrayList();
+        for (int i = 0; i < numGroupingExprs; i++) {
+            groupingExprs.add(new IntLiteral(i));
+        }
+        new NonStrictExpectations() {
+            {
+                aggInfo.getOutputTupleId();
+                result = new TupleId(1);
+                aggInfo.getIntermediateTupleId();
+                result = new TupleId(0);
+                aggInfo.getGroupingExprs();
+                result = groupingExprs;
+                aggInfo.getMaterializedAggregateExprs();
+                result = Lists.<FunctionCallExpr>newArrayList();
+                aggInfo.isMerge();
+                result = isMerge;
+            }
+        };
+        AggregationNode node = new AggregationNode(new PlanNodeId(1), input, aggInfo);
+        node.unsetNeedsFinalize();
+        return node;
+    }
+
+    private static PlannerContext createContext(boolean disableStreamPreaggregations) {
+        TQueryOptions queryOptions = new TQueryOptions();
+        queryOptions.setDisable_stream_preaggregations(disableStreamPreaggregations);
+        return new PlannerContext(null, null, queryOptions, null);
+    }
+
+    private static TPlanNode toThrift(AggregationNode node) {
+        TPlanNode msg = new TPlanNode();
+        node.toThrift(msg);
+        return msg;
+    }
+
+    @Test
+    public void testGroupingPreagg() {
+        AggregationNode node = createNode(false, 2);
+        node.setIsPreagg(createContext(false));
+        Assert.assertTrue(node.useStreamingPreagg());
+        TPlanNode msg = toThrift(node);
+        Assert.assertTrue(msg.agg_node.isSetUse_streaming_preaggregation());
+        Assert.assertTrue(msg.agg_node.use_streaming_preaggregation);
+        Assert.assertFalse(msg.agg_node.need_finalize);
+    }
+
+    @Test
+    public void testQueryOptionNotSet() {
+        AggregationNode node = createNode(false, 1);
+        node.setIsPreagg(new PlannerContext(null, null, new TQueryOptions(), null));
+        Assert.assertTrue(node.useStreamingPreagg());
+    }
+
+    @Test
+    public void testDisabledByQueryOption() {
+        AggregationNode node = createNode(false, 2);
+        node.setIsPreagg(createContext(true));
+        Assert.assertFalse(node.useStreamingPreagg());
+        Assert.assertFalse(toThrift(node).agg_node.use_streaming_preaggregation);
+    }
+
+    @Test
+    public void testNoGrouping() {
+        // a preaggregation without grouping returns a single row, nothing to stream
+        AggregationNode node = createNode(false, 0);
+        node.setIsPreagg(createContext(false));
+        Assert.assertFalse(node.useStreamingPreagg());
+    }
+
+    @Test
+    public void testMergeAgg() {
+        AggregationNode node = createNode(true, 2);
+        node.setIsPreagg(createContext(false));
+        Assert.assertFalse(node.useStreamingPreagg());
+    }
+
+    @Test
+    public void testNotPreagg() {
+        // aggregation nodes which are not preaggregations never stream
+        AggregationNode node = createNode(false, 2);
+        Assert.assertFalse(node.useStreamingPreagg());
+        Assert.assertFalse(toThrift(node).agg_node.use_streaming_preaggregation);
+    }
+}
@@ -0,0 +1,172 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+package org.apache.doris.planner;
+
+import org.apache.doris.analysis.DescriptorTable;
+import org.apache.doris.analysis.Expr;
+import org.apache.doris.analysis.JoinOperator;
+import org.apache.doris.analysis.SlotDescriptor;
+import org.apache.doris.analysis.SlotRef;
+import org.apache.doris.analysis.TableRef;
+import org.apache.doris.analysis.TupleDescriptor;
+import org.apache.doris.catalog.Column;
+import org.apache.doris.catalog.OlapTable;
+import org.apache.doris.catalog.PrimitiveType;
+import org.apache.doris.common.Pair;
+import org.apache.doris.qe.ConnectContext;
+
+import com.google.common.collect.Lists;
+
+import org.junit.After;
+import org.junit.Assert;
+import org.junit.Before;
+import org.junit.Test;
+
+import java.util.List;
+
+import mockit.Deencapsulation;
+import mockit.Injectable;
+import mockit.NonStrictExpectations;
+
+public class DistributedPlannerTest {
+    @Injectable
+    OlapTable leftTable;
+
+    @Injectable
+    OlapTable rightTable;
+
+    private ConnectContext context;
+    private DescriptorTable descTable;
+    private OlapScanNode leftScan;
+    private OlapScanNode rightScan;
+
+    @Before
+    public void setUp() {
+        context = new ConnectContext(null);
+        context.getSessionVariable().setEnableColocateMergeJoin(true);
+        context.setThreadLocalInfo();
+        descTable = new DescriptorTable();
+        // both tables are keyed by (k1 INT, k2 INT)
+        leftScan = createScan(0, leftTable, PrimitiveType.INT);
+        rightScan = createScan(1, rightTable, PrimitiveType.INT);
+    }
+
+    @After
+    public void tearDown() {
+        ConnectContext.remove();
+    }
+
+    private List<Column> keyColumns(PrimitiveType k1Type) {
+        return Lists.newArrayList(new Column("k1", k1Type), new Column("k2", PrimitiveType.INT));
+    }
+
+    private OlapScanNode createScan(int id, OlapTable table, PrimitiveType k1Type) {
+        List<Column> keys = keyColumns(k1Type);
+        new NonStrictExpectations() {
+            {
+                table.getKeyColumnsByIndexId(anyLong);
+                result = keys;
+            }
+        };
+        TupleDescriptor tuple = descTable.createTupleDescriptor();
+        tuple.setTable(table);
+        for (Column key : keys) {
+            SlotDescriptor slot = descTable.addSlotDescriptor(tuple);
+            slot.setColumn(key);
+            slot.setIsMaterialized(true);
+        }
+        OlapScanNode scan = new OlapScanNode(new PlanNodeId(id), tuple, "OlapScanNode");
+        Deencapsulation.setField(scan, "selectedIndexId", 10000L);
+        return scan;
+    }
+
+    private static Expr slotRef(OlapScanNode scan, int slotIdx) {
+        return new SlotRef(scan.getTupleDesc().getSlots().get(slotIdx));
+    }
+
+    // colocate join of the two scans on pairs of (left slot, right slot)
+    private HashJoinNode createJoin(JoinOperator op, int[][] slotPairs) {
+        List<Pair<Expr, Expr>> eqJoinConjuncts = Lists.newArrayList();
+        for (int[] pair : slotPairs) {
+            eqJoinConjuncts.add(new Pair<>(slotRef(leftScan, pair[0]), slotRef(rightScan, pair[1])));
+        }
+        TableRef innerRef = new TableRef();
+        innerRef.setJoinOp(op);
+        return new HashJoinNode(new PlanNodeId(2), leftScan, rightScan, innerRef,
+                eqJoinConjuncts, Lists.<Expr>newArrayList());
+    }
+
+    private PlanNode createMergeJoin(HashJoinNode join) {
+        DistributedPlanner planner = new DistributedPlanner(null);
+        return Deencapsulation.invoke(planner, "createColocateMergeJoinNode", join, leftScan, rightScan);
+    }
+
+    private boolean isOrderedByKeys(OlapScanNode scan) {
+        return Deencapsulation.getField(scan, "orderedByKeys");
+    }
+
+    @Test
+    public void testJoinOnLeadingKeys() {
+        PlanNode node = createMergeJoin(createJoin(JoinOperator.INNER_JOIN, new int[][] {{0, 0}, {1, 1}}));
+        Assert.assertTrue(node instanceof MergeJoinNode);
+        Assert.assertEquals(leftScan, node.getChild(0));
+        Assert.assertEquals(rightScan, node.getChild(1));
+        Assert.assertTrue(isOrderedByKeys(leftScan));
+        Assert.assertTrue(isOrderedByKeys(rightScan));
+
+        // conjuncts in any order pair up the keys
+        leftScan.setOrderedByKeys(false);
+        rightScan.setOrderedByKeys(false);
+        node = createMergeJoin(createJoin(JoinOperator.INNER_JOIN, new int[][] {{1, 1}, {0, 0}}));
+        Assert.assertTrue(node instanceof MergeJoinNode);
+    }
+
+    @Test
+    public void testJoinOnKeyPrefix() {
+        PlanNode node = createMergeJoin(createJoin(JoinOperator.INNER_JOIN, new int[][] {{0, 0}}));
+        Assert.assertTrue(node instanceof MergeJoinNode);
+    }
+
+    @Test
+    public void testJoinNotOnLeadingKeys() {
+        // rows are not ordered by k2 alone
+        Assert.assertNull(createMergeJoin(createJoin(JoinOperator.INNER_JOIN, new int[][] {{1, 1}})));
+        // k1 of one side with k2 of the other
+        Assert.assertNull(createMergeJoin(createJoin(JoinOperator.INNER_JOIN, new int[][] {{0, 1}})));
+        Assert.assertFalse(isOrderedByKeys(leftScan));
+        Assert.assertFalse(isOrderedByKeys(rightScan));
+    }
+
+    @Test
+    public void testOuterJoin() {
+        Assert.assertNull(createMergeJoin(createJoin(JoinOperator.LEFT_OUTER_JOIN, new int[][] {{0, 0}})));
+        Assert.assertNull(createMergeJoin(createJoin(JoinOperator.FULL_OUTER_JOIN, new int[][] {{0, 0}})));
+    }
+
+    @Test
+    public void testKeysOfDifferentTypes() {
+        rightScan = createScan(1, rightTable, PrimitiveType.BIGINT);
+        Assert.assertNull(createMergeJoin(createJoin(JoinOperator.INNER_JOIN, new int[][] {{0, 0}})));
+    }
+
+    @Test
+    public void testSessionVariableOff() {
+        context.getSessionVariable().setEnableColocateMergeJoin(false);
+        Assert.assertNull(createMergeJoin(createJoin(JoinOperator.INNER_JOIN, new int[][] {{0, 0}})));
+    }
+}
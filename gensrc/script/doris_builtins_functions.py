@@ -100,18 +100,30 @@ visible_functions = [
     [['unix_timestamp'], 'INT', [],
         '_ZN5doris18TimestampFunctions7to_unixEPN9doris_udf15FunctionContextE'],
     [['unix_timestamp'], 'INT', ['DATETIME'],
-        '_ZN5doris18TimestampFunctions7to_unixEPN9doris_udf15FunctionContextERKNS1_11DateTimeValE'],
+        '_ZN5doris18TimestampFunctions7to_unixEPN9doris_udf15FunctionContextERKNS1_11DateTimeValE',
+        '_ZN5doris18TimestampFunctions16timezone_prepareEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
+        '_ZN5doris18TimestampFunctions14timezone_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE'],
     [['unix_timestamp'], 'INT', ['VARCHAR', 'VARCHAR'],
-        '_ZN5doris18TimestampFunctions7to_unixEPN9doris_udf15FunctionContextERKNS1_9StringValES6_'],
+        '_ZN5doris18TimestampFunctions7to_unixEPN9doris_udf15FunctionContextERKNS1_9StringValES6_',
+        '_ZN5doris18TimestampFunctions16timezone_prepareEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
+        '_ZN5doris18TimestampFunctions14timezone_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE'],
     [['from_unixtime'], 'VARCHAR', ['INT'],
-        '_ZN5doris18TimestampFunctions9from_unixEPN9doris_udf15FunctionContextERKNS1_6IntValE'],
+        '_ZN5doris18TimestampFunctions9from_unixEPN9doris_udf15FunctionContextERKNS1_6IntValE',
+        '_ZN5doris18TimestampFunctions16timezone_prepareEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
+        '_ZN5doris18TimestampFunctions14timezone_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE'],
     [['from_unixtime'], 'VARCHAR', ['INT', 'VARCHAR'],
         '_ZN5doris18TimestampFunctions9from_unixEPN9doris_udf'
-        '15FunctionContextERKNS1_6IntValERKNS1_9StringValE'],
+        '15FunctionContextERKNS1_6IntValERKNS1_9StringValE',
+        '_ZN5doris18TimestampFunctions16timezone_prepareEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
+        '_ZN5doris18TimestampFunctions14timezone_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE'],
     [['now', 'current_timestamp', 'localtime', 'localtimestamp'], 'DATETIME', [],
-        '_ZN5doris18TimestampFunctions3nowEPN9doris_udf15FunctionContextE'],
+        '_ZN5doris18TimestampFunctions3nowEPN9doris_udf15FunctionContextE',
+        '_ZN5doris18TimestampFunctions16timezone_prepareEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
+        '_ZN5doris18TimestampFunctions14timezone_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE'],
     [['curtime', 'current_time'], 'TIME', [],
-        '_ZN5doris18TimestampFunctions7curtimeEPN9doris_udf15FunctionContextE'],
+        '_ZN5doris18TimestampFunctions7curtimeEPN9doris_udf15FunctionContextE',
+        '_ZN5doris18TimestampFunctions16timezone_prepareEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
+        '_ZN5doris18TimestampFunctions14timezone_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE'],
     [['utc_timestamp'], 'DATETIME', [],
         '_ZN5doris18TimestampFunctions13utc_timestampEPN9doris_udf15FunctionContextE'],
     [['timestamp'], 'DATETIME', ['DATETIME'],
@@ -219,7 +231,9 @@ visible_functions = [
         '15FunctionContextERKNS1_11DateTimeValE'],
 
     [['convert_tz'], 'DATETIME', ['DATETIME', 'VARCHAR', 'VARCHAR'],
-            '_ZN5doris18TimestampFunctions10convert_tzEPN9doris_udf15FunctionContextERKNS1_11DateTimeValERKNS1_9StringValES9_'],
+            '_ZN5doris18TimestampFunctions10convert_tzEPN9doris_udf15FunctionContextERKNS1_11DateTimeValERKNS1_9StringValES9_',
+            '_ZN5doris18TimestampFunctions18convert_tz_prepareEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
+            '_ZN5doris18TimestampFunctions14timezone_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE'],
 
     # Math builtin functions
     [['pi'], 'DOUBLE', [],
@@ -492,6 +506,8 @@ visible_functions = [
             '15FunctionContextERKNS1_9StringValERKNS1_6IntValES6_'],
     [['length'], 'INT', ['VARCHAR'],
             '_ZN5doris15StringFunctions6lengthEPN9doris_udf15FunctionContextERKNS1_9StringValE'],
+    [['char_length', 'character_length'], 'INT', ['VARCHAR'],
+            '_ZN5doris15StringFunctions16char_utf8_lengthEPN9doris_udf15FunctionContextERKNS1_9StringValE'],
     [['lower', 'lcase'], 'VARCHAR', ['VARCHAR'],
             '_ZN5doris15StringFunctions5lowerEPN9doris_udf15FunctionContextERKNS1_9StringValE'],
     [['upper', 'ucase'], 'VARCHAR', ['VARCHAR'],
@@ -588,6 +604,13 @@ visible_functions = [
     [['hll_hash'], 'VARCHAR', ['VARCHAR'],
         '_ZN5doris16HllHashFunctions8hll_hashEPN9doris_udf15FunctionContextERKNS1_9StringValE'],
 
+    #bitmap function
+    [['to_bitmap'], 'VARCHAR', ['VARCHAR'],
+        '_ZN5doris15BitmapFunctions9to_bitmapEPN9doris_udf15FunctionContextERKNS1_9StringValE'],
+    [['bitmap_and'], 'VARCHAR', ['VARCHAR', 'VARCHAR'],
+        '_ZN5doris15BitmapFunctions10bitmap_andEPN9doris_udf'
+        '15FunctionContextERKNS1_9StringValES6_'],
+
     # aes and base64 function
     [['aes_encrypt'], 'VARCHAR', ['VARCHAR', 'VARCHAR'],
         '_ZN5doris19EncryptionFunctions11aes_encryptEPN9doris_udf'
@@ -153,6 +153,9 @@ struct TOlapTableIndexSchema {
     1: required i64 id
     2: required list<string> columns
     3: required i32 schema_hash
+    // aggregation type of each of columns, NONE for keys. Only set for tables not
+    // under schema change, whose rows may be pre-aggregated by the sender.
+    4: optional list<Types.TAggregationType> aggregation_types
 }
 
 struct TOlapTableSchemaParam {
@@ -164,6 +167,7 @@ struct TOlapTableSchemaParam {
     4: required list<TSlotDescriptor> slot_descs
     5: required TTupleDescriptor tuple_desc
     6: required list<TOlapTableIndexSchema> indexes
+    7: optional Types.TKeysType keys_type
 }
 
 struct TTabletLocation {
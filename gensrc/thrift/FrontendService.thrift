@@ -523,6 +523,8 @@ struct TStreamLoadPutRequest {
     16: optional i64 auth_code
     17: optional bool negative
     18: optional i32 timeout
+    // json array of json paths of the source columns, only valid when format is json
+    19: optional string jsonpaths
 }
 
 struct TStreamLoadPutResult {
@@ -80,11 +80,15 @@ struct TReportRequest {
     5: optional map<string, TDisk> disks // string root_path
     6: optional bool force_recovery
     7: optional list<TTablet> tablet_list
+    // tablets only contain tablets changed since last report if true
+    8: optional bool is_incremental
 }
 
 struct TMasterResult {
     // required in V1
     1: required Status.TStatus status
+    // set by report of tablets, means FE can handle incremental tablet report
+    2: optional bool support_incremental_tablet_report
 }
 
 // Now we only support CPU share.
@@ -126,6 +126,16 @@ struct TQueryOptions {
 
   // multithreaded degree of intra-node parallelism
   27: optional i32 mt_dop = 0;
+
+  // whether to add hardware counters of get_next() into profiles of exec nodes
+  28: optional bool enable_perf_counters = false;
+
+  // whether to record timestamped spans of fragments, served by /api/query_trace of BE
+  29: optional bool enable_query_trace = false;
+
+  // whether BE may serve the outputs of aggregation fragments over olap tablets
+  // from its cache, keyed by plan digest and versions of the tablets
+  30: optional bool enable_fragment_result_cache = false;
 }
 
 // A scan range plus the parameters needed to execute that scan.
@@ -246,6 +256,19 @@ struct TExecPlanFragmentParams {
   14: optional TLoadErrorHubInfo load_error_hub_info
 }
 
+// Instances of one fragment on one backend, started by one rpc. 'common' holds
+// everything the instances share, i.e. all of TExecPlanFragmentParams but params
+// and backend_num, which are given per instance.
+struct TExecPlanFragmentBatchParams {
+  1: required PaloInternalServiceVersion protocol_version
+
+  2: optional TExecPlanFragmentParams common
+
+  3: optional list<TPlanFragmentExecParams> instance_params
+
+  4: optional list<i32> backend_nums
+}
+
 struct TExecPlanFragmentResult {
   // required in V1
   1: optional Status.TStatus status
@@ -33,7 +33,12 @@ enum TPartitionType {
 
   // ordered partition on a list of exprs
   // (partition bounds don't overlap)
-  RANGE_PARTITIONED
+  RANGE_PARTITIONED,
+
+  // partition on the distribution columns of an olap table, a row is sent to the
+  // destination which scans its bucket. The destinations are ordered by bucket
+  // sequence, one for each bucket of the table.
+  BUCKET_SHUFFLE_HASH_PARTITIONED
 }
 
 enum TDistributionType {
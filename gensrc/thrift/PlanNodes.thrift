@@ -96,7 +96,10 @@ enum TFileFormatType {
     FORMAT_CSV_BZ2,
     FORMAT_CSV_LZ4FRAME,
     FORMAT_CSV_LZOP,
-    FORMAT_PARQUET
+    FORMAT_PARQUET,
+    FORMAT_ORC,
+    // one json object per line
+    FORMAT_JSON
 }
 
 // One broker range information.
@@ -146,6 +149,9 @@ struct TBrokerScanRangeParams {
     // strictMode is a boolean
     // if strict mode is true, the incorrect data (the result of cast is null) will not be loaded
     10: optional bool strict_mode
+    // json paths of src slots, in the order of src_slot_ids. Only valid for json format,
+    // names of src slots are used as keys if not set
+    11: optional list<string> json_paths
 }
 
 // Broker scan range
@@ -244,12 +250,27 @@ struct TMetaScanNode {
   5: optional string user
 }
 
+// aggregation over olap scan node which can be answered by meta of rowsets
+enum TPushAggOp {
+  NONE,
+  // all aggregations only count rows
+  COUNT,
+  // all aggregations count rows or are min/max of columns
+  MINMAX
+}
+
 struct TOlapScanNode {
   1: required Types.TTupleId tuple_id
   2: required list<string> key_column_name
   3: required list<Types.TPrimitiveType> key_column_type
   4: required bool is_preaggregation
   5: optional string sort_column
+  6: optional TPushAggOp push_down_agg_type
+  // only first rows by keys of each tablet are needed by top n node above
+  7: optional i64 push_down_topn_limit
+  // rows are returned in order of the key columns of the tuple, e.g. for a merge
+  // join above, rows of all tablets of the node are merged into one ordered stream
+  8: optional bool ordered_by_keys
 }
 struct TEqJoinCondition {
   // left-hand side of "<a> = <b>"
@@ -292,6 +313,10 @@ struct THashJoinNode {
   // If true, this join node can (but may choose not to) generate slot filters
   // after constructing the build side that can be applied to the probe side.
   5: optional bool add_probe_filters
+
+  // If true, every instance of this fragment receives the whole build side, so the
+  // instances on one backend can share a single hash table.
+  6: optional bool is_broadcast_join
 }
 
 struct TMergeJoinNode {
@@ -129,7 +129,9 @@ enum TAggregationType {
     MIN,
     REPLACE,
     HLL_UNION,
-    NONE
+    NONE,
+    BITMAP_UNION,
+    REPLACE_IF_NOT_NULL
 }
 
 enum TPushType {
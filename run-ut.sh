@@ -188,6 +188,9 @@ ${DORIS_TEST_BINARY_DIR}/exec/es_scan_reader_test
 ${DORIS_TEST_BINARY_DIR}/exec/es_query_builder_test
 ${DORIS_TEST_BINARY_DIR}/exec/tablet_info_test
 ${DORIS_TEST_BINARY_DIR}/exec/tablet_sink_test
+${DORIS_TEST_BINARY_DIR}/exec/hash_table_test
+${DORIS_TEST_BINARY_DIR}/exec/partitioned_hash_join_node_test
+${DORIS_TEST_BINARY_DIR}/exec/merge_join_node_test
 
 # Running runtime Unittest
 ${DORIS_TEST_BINARY_DIR}/runtime/external_scan_context_mgr_test
@@ -212,6 +215,7 @@ ${DORIS_TEST_BINARY_DIR}/http/metrics_action_test
 ${DORIS_TEST_BINARY_DIR}/http/http_utils_test
 ${DORIS_TEST_BINARY_DIR}/http/stream_load_test
 ${DORIS_TEST_BINARY_DIR}/http/http_client_test
+${DORIS_TEST_BINARY_DIR}/http/ev_http_server_test
 
 # Running StorageEngine Unittest
 ${DORIS_TEST_BINARY_DIR}/olap/bit_field_test
@@ -239,6 +243,7 @@ ${DORIS_TEST_BINARY_DIR}/olap/tablet_meta_manager_test
 ${DORIS_TEST_BINARY_DIR}/olap/tablet_mgr_test
 ${DORIS_TEST_BINARY_DIR}/olap/olap_meta_test
 ${DORIS_TEST_BINARY_DIR}/olap/delta_writer_test
+${DORIS_TEST_BINARY_DIR}/olap/primary_key_index_test
 ${DORIS_TEST_BINARY_DIR}/olap/decimal12_test
 ${DORIS_TEST_BINARY_DIR}/olap/olap_snapshot_converter_test
 ${DORIS_TEST_BINARY_DIR}/olap/rowset/rowset_meta_manager_test
@@ -260,6 +265,8 @@ ${DORIS_TEST_BINARY_DIR}/olap/aggregate_func_test
 ${DORIS_TEST_BINARY_DIR}/olap/short_key_index_test
 ${DORIS_TEST_BINARY_DIR}/olap/key_coder_test
 ${DORIS_TEST_BINARY_DIR}/olap/page_cache_test
+${DORIS_TEST_BINARY_DIR}/olap/segment_cache_test
+${DORIS_TEST_BINARY_DIR}/olap/rowset_graph_test
 
 # Running routine load test
 ${DORIS_TEST_BINARY_DIR}/runtime/kafka_consumer_pipe_test
@@ -534,13 +534,14 @@ build_arrow() {
     export ARROW_URIPARSER_URL=${TP_SOURCE_DIR}/${URIPARSER_NAME}
     export ARROW_ZSTD_URL=${TP_SOURCE_DIR}/${ZSTD_NAME}
 
-    cmake -DARROW_PARQUET=ON -DARROW_IPC=OFF -DARROW_BUILD_SHARED=OFF \
+    cmake -DARROW_PARQUET=ON -DARROW_ORC=ON -DARROW_IPC=OFF -DARROW_BUILD_SHARED=OFF \
     -DCMAKE_INSTALL_PREFIX=$TP_INSTALL_DIR \
     -DARROW_BOOST_USE_SHARED=OFF -DBoost_NO_BOOST_CMAKE=ON -DBOOST_ROOT=$TP_INSTALL_DIR \
     -Dgflags_ROOT=$TP_INSTALL_DIR/ \
     -DSnappy_ROOT=$TP_INSTALL_DIR/ \
     -DGLOG_ROOT=$TP_INSTALL_DIR/ \
     -DLZ4_ROOT=$TP_INSTALL_DIR/ \
+    -DProtobuf_ROOT=$TP_INSTALL_DIR/ \
     -DThrift_ROOT=$TP_INSTALL_DIR/ ..
 
     make -j$PARALLEL && make install
@@ -554,8 +555,11 @@ build_arrow() {
     else
         cp -rf ./zstd_ep-install/lib/libzstd.a $TP_INSTALL_DIR/lib64/libzstd.a
     fi
+    # zstd is also used by block compression of segment v2
+    cp -rf ./zstd_ep-install/include/zstd.h $TP_INSTALL_DIR/include/zstd.h
     cp -rf ./double-conversion_ep/src/double-conversion_ep/lib/libdouble-conversion.a $TP_INSTALL_DIR/lib64/libdouble-conversion.a
     cp -rf ./uriparser_ep-install/lib/liburiparser.a $TP_INSTALL_DIR/lib64/liburiparser.a
+    cp -rf ./orc_ep-install/lib/liborc.a $TP_INSTALL_DIR/lib64/liborc.a
 }
 
 # s2
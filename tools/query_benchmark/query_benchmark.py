@@ -0,0 +1,681 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""
+Driver of SSB and TPC-H benchmarks on a Doris cluster.
+
+  load: create the tables and load the data generated by dbgen through stream load
+  run:  run the queries at some concurrency levels, and collect latency percentiles
+        and the runtime profile of every query
+  diff: compare the results of two runs, by query and by operator
+
+See README.md for the usage.
+"""
+
+from __future__ import print_function
+
+import argparse
+import base64
+import glob
+import json
+import os
+import random
+import re
+import subprocess
+import sys
+import threading
+import time
+import uuid
+
+try:
+    import ConfigParser as configparser
+except ImportError:
+    import configparser
+
+try:
+    import httplib
+    from urlparse import urlparse
+    from HTMLParser import HTMLParser
+    html_unescape = HTMLParser().unescape
+except ImportError:
+    import http.client as httplib
+    from urllib.parse import urlparse
+    from html import unescape as html_unescape
+
+try:
+    import MySQLdb
+except ImportError:
+    import pymysql as MySQLdb
+
+BASE_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# table name -> file name prefix of dbgen
+BENCHMARK_TABLES = {
+    'ssb': [('lineorder', 'lineorder'), ('customer', 'customer'), ('dates', 'date'),
+            ('supplier', 'supplier'), ('part', 'part')],
+    'tpch': [('lineitem', 'lineitem'), ('orders', 'orders'), ('partsupp', 'partsupp'),
+             ('part', 'part'), ('customer', 'customer'), ('supplier', 'supplier'),
+             ('nation', 'nation'), ('region', 'region')],
+}
+
+# arguments of dbgen to generate all tables into the working directory
+DBGEN_ARGS = {
+    'ssb': ['-T', 'a', '-f'],
+    'tpch': ['-f'],
+}
+
+
+class Cluster(object):
+    """
+    MySQL and HTTP connections to the FE
+    """
+    def __init__(self, args):
+        self.host = args.fe_host
+        self.port = args.port
+        self.http_port = args.http_port
+        self.user = args.user
+        self.password = args.password
+        self.database = args.database
+        auth = '%s:%s' % (self.user, self.password)
+        self.auth_header = 'Basic ' + base64.b64encode(auth.encode('utf-8')).decode('ascii')
+
+    def connect(self, database=None):
+        return MySQLdb.connect(host=self.host, port=self.port, user=self.user,
+                               passwd=self.password, db=database or '')
+
+    def http_get(self, path):
+        conn = httplib.HTTPConnection(self.host, self.http_port, timeout=60)
+        try:
+            conn.request('GET', path, headers={'Authorization': self.auth_header})
+            response = conn.getresponse()
+            body = response.read().decode('utf-8', 'replace')
+            if response.status != 200:
+                raise Exception('GET %s returns %d: %s' % (path, response.status, body))
+            return body
+        finally:
+            conn.close()
+
+    def stream_load(self, table, label, data):
+        """
+        Stream load 'data' into 'table'. The FE redirects the request to a BE before the
+        body is sent, so that it's sent only once.
+        """
+        path = '/api/%s/%s/_stream_load' % (self.database, table)
+        headers = {
+            'Authorization': self.auth_header,
+            'label': label,
+            'column_separator': '|',
+            'Content-Length': str(len(data)),
+        }
+
+        conn = httplib.HTTPConnection(self.host, self.http_port, timeout=60)
+        try:
+            conn.putrequest('PUT', path)
+            for key, value in headers.items():
+                conn.putheader(key, value)
+            conn.putheader('Expect', '100-continue')
+            conn.endheaders()
+            response = conn.getresponse()
+            location = response.getheader('Location')
+            response.read()
+        finally:
+            conn.close()
+        if response.status != 307 or not location:
+            raise Exception('FE does not redirect stream load of %s, status: %d'
+                            % (table, response.status))
+
+        url = urlparse(location)
+        conn = httplib.HTTPConnection(url.hostname, url.port, timeout=3600)
+        try:
+            conn.request('PUT', url.path + ('?' + url.query if url.query else ''),
+                         body=data, headers=headers)
+            response = conn.getresponse()
+            body = response.read().decode('utf-8', 'replace')
+        finally:
+            conn.close()
+        result = json.loads(body)
+        if result.get('Status') not in ('Success', 'Publish Timeout'):
+            raise Exception('failed to stream load %s: %s' % (table, body))
+        return result
+
+
+def read_sql_file(path):
+    with open(path) as f:
+        lines = [line for line in f if not line.startswith('--')]
+    return [stmt.strip() for stmt in ''.join(lines).split(';') if stmt.strip()]
+
+
+def load_queries(benchmark, names):
+    query_dir = os.path.join(BASE_DIR, benchmark, 'queries')
+    queries = {}
+    for path in glob.glob(os.path.join(query_dir, '*.sql')):
+        name = os.path.basename(path)[:-len('.sql')]
+        queries[name] = read_sql_file(path)[0]
+
+    def order(name):
+        return [int(x) for x in re.findall(r'\d+', name)]
+    selected = sorted(queries.keys(), key=order)
+    if names:
+        for name in names:
+            if name not in queries:
+                raise Exception('unknown query %s of %s' % (name, benchmark))
+        selected = names
+    return [(name, queries[name]) for name in selected]
+
+
+def split_list(value):
+    return [x.strip() for x in value.split(',') if x.strip()] if value else []
+
+
+# ---------------------------------------------------------------------------
+# load
+# ---------------------------------------------------------------------------
+
+def generate_data(args):
+    if not os.path.isdir(args.data_dir):
+        os.makedirs(args.data_dir)
+    cmd = [os.path.abspath(args.dbgen), '-s', str(args.scale_factor)] + DBGEN_ARGS[args.benchmark]
+    print('generating data: %s' % ' '.join(cmd))
+    # dbgen reads dists.dss from its own directory
+    env = dict(os.environ, DSS_CONFIG=os.path.dirname(os.path.abspath(args.dbgen)))
+    subprocess.check_call(cmd, cwd=args.data_dir, env=env)
+
+
+def read_batches(path, batch_bytes):
+    """
+    Rows of a dbgen file in batches of about batch_bytes, without the separator at
+    the end of every row
+    """
+    rows = []
+    size = 0
+    with open(path, 'rb') as f:
+        for line in f:
+            line = line.rstrip(b'\r\n')
+            if line.endswith(b'|'):
+                line = line[:-1]
+            rows.append(line)
+            size += len(line) + 1
+            if size >= batch_bytes:
+                yield b'\n'.join(rows) + b'\n'
+                rows = []
+                size = 0
+    if rows:
+        yield b'\n'.join(rows) + b'\n'
+
+
+def cmd_load(args):
+    cluster = Cluster(args)
+    if args.dbgen:
+        generate_data(args)
+
+    conn = cluster.connect()
+    cursor = conn.cursor()
+    cursor.execute('CREATE DATABASE IF NOT EXISTS `%s`' % args.database)
+    cursor.execute('USE `%s`' % args.database)
+    tables = BENCHMARK_TABLES[args.benchmark]
+    for table, _ in tables:
+        cursor.execute('DROP TABLE IF EXISTS `%s`' % table)
+    ddl_path = os.path.join(BASE_DIR, args.benchmark, 'create_tables.sql')
+    for stmt in read_sql_file(ddl_path):
+        cursor.execute(stmt.replace('${buckets}', str(args.buckets)))
+
+    batch_bytes = args.batch_mb * 1024 * 1024
+    for table, prefix in tables:
+        files = sorted(glob.glob(os.path.join(args.data_dir, prefix + '.tbl*')))
+        if not files:
+            raise Exception('no data file of %s in %s' % (table, args.data_dir))
+        start = time.time()
+        rows = 0
+        for path in files:
+            for data in read_batches(path, batch_bytes):
+                label = 'query_benchmark_%s_%s' % (table, uuid.uuid4().hex)
+                result = cluster.stream_load(table, label, data)
+                rows += int(result.get('NumberLoadedRows', 0))
+        elapsed = time.time() - start
+        print('loaded %-10s %12d rows in %8.1fs, %10.0f rows/s'
+              % (table, rows, elapsed, rows / elapsed if elapsed > 0 else 0))
+
+    # all loads are visible after published
+    for table, _ in tables:
+        cursor.execute('SELECT COUNT(*) FROM `%s`' % table)
+        print('%-10s %12d rows' % (table, cursor.fetchone()[0]))
+    cursor.close()
+    conn.close()
+
+
+# ---------------------------------------------------------------------------
+# run
+# ---------------------------------------------------------------------------
+
+def percentile(values, p):
+    if not values:
+        return 0
+    values = sorted(values)
+    index = int(round(p / 100.0 * (len(values) - 1)))
+    return values[index]
+
+
+def latency_summary(latencies):
+    return {
+        'count': len(latencies),
+        'mean': sum(latencies) / len(latencies) if latencies else 0,
+        'p50': percentile(latencies, 50),
+        'p90': percentile(latencies, 90),
+        'p95': percentile(latencies, 95),
+        'p99': percentile(latencies, 99),
+        'max': max(latencies) if latencies else 0,
+    }
+
+
+def execute(cursor, sql):
+    start = time.time()
+    cursor.execute(sql)
+    cursor.fetchall()
+    return (time.time() - start) * 1000
+
+
+def run_concurrently(cluster, queries, concurrency, rounds, seed):
+    """
+    Every thread runs all queries 'rounds' times in its own random order. Returns
+    latencies in ms by query, the numbers of errors by query and the elapsed time.
+    """
+    latencies = dict((name, []) for name, _ in queries)
+    errors = dict((name, 0) for name, _ in queries)
+    lock = threading.Lock()
+
+    def worker(thread_id):
+        rng = random.Random(seed + thread_id)
+        conn = cluster.connect(cluster.database)
+        cursor = conn.cursor()
+        try:
+            for _ in range(rounds):
+                order = list(queries)
+                rng.shuffle(order)
+                for name, sql in order:
+                    try:
+                        latency = execute(cursor, sql)
+                    except MySQLdb.Error as e:
+                        print('query %s failed: %s' % (name, e), file=sys.stderr)
+                        with lock:
+                            errors[name] += 1
+                        continue
+                    with lock:
+                        latencies[name].append(latency)
+        finally:
+            cursor.close()
+            conn.close()
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(concurrency)]
+    start = time.time()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return latencies, errors, time.time() - start
+
+
+# a node of the runtime profile, like 'HASH_JOIN_NODE (id=3):(Active: 1.234ms, ...)'
+PROFILE_NODE_RE = re.compile(r'^(\s*)(\S[^:]*?) \(id=(\d+)\):(?:\(Active: ([^,]+),.*\))?\s*$')
+PROFILE_FRAGMENT_RE = re.compile(r'^(\s*)Fragment (\d+):')
+PROFILE_HEADER_RE = re.compile(r'^(\s*)(\S[^:]*):(?:\(Active: ([^,]+),.*\))?\s*$')
+PROFILE_COUNTER_RE = re.compile(r'^\s*- ([^:]+): (.*)$')
+
+TIME_UNITS_NS = {'h': 3600 * 10 ** 9, 'm': 60 * 10 ** 9, 's': 10 ** 9,
+                 'ms': 10 ** 6, 'us': 10 ** 3, 'ns': 1}
+BYTE_UNITS = {'B': 1, 'KB': 1024, 'MB': 1024 ** 2, 'GB': 1024 ** 3, 'TB': 1024 ** 4}
+
+
+def parse_profile_value(value):
+    """
+    A counter printed by RuntimeProfile of the FE as a number, times in ns. Returns
+    None for rates.
+    """
+    value = value.strip()
+    if value.endswith('/sec'):
+        return None
+    # units, like '1.23M (1234567)'
+    match = re.match(r'^[\d.]+[KMB] \((\d+)\)$', value)
+    if match:
+        return float(match.group(1))
+    match = re.match(r'^([\d.]+) (B|KB|MB|GB|TB)$', value)
+    if match:
+        return float(match.group(1)) * BYTE_UNITS[match.group(2)]
+    # times, like '1s234ms', '12.345ms' and '100ns'
+    parts = re.findall(r'([\d.]+)(h|ms|us|ns|m|s)', value)
+    if parts and ''.join(n + u for n, u in parts) == value:
+        return float(sum(float(n) * TIME_UNITS_NS[u] for n, u in parts))
+    try:
+        return float(value)
+    except ValueError:
+        return None
+
+
+def parse_profile(text):
+    """
+    Operators of a query profile, merged over fragment instances. Returns a dict from
+    'Fragment N/NODE (id=X)' to the max active time of instances in ns, the number of
+    instances and the sums of counters of instances. Counters of the children of an
+    operator, like the scanners of OLAP_SCAN_NODE, are prefixed with their names.
+    """
+    operators = {}
+    fragment = None
+    # [(indent, operator key or None, prefix of counters)]
+    stack = []
+    current = None
+    for line in text.splitlines():
+        if not line.strip():
+            continue
+        counter = PROFILE_COUNTER_RE.match(line)
+        if counter:
+            if current is not None:
+                key, prefix = current
+                value = parse_profile_value(counter.group(2))
+                if value is not None:
+                    name = prefix + counter.group(1).strip()
+                    counters = operators[key]['counters']
+                    counters[name] = counters.get(name, 0) + value
+            continue
+
+        match = PROFILE_FRAGMENT_RE.match(line)
+        if match:
+            fragment = int(match.group(2))
+            stack = []
+            current = None
+            continue
+        indent_match = re.match(r'^(\s*)', line)
+        indent = len(indent_match.group(1))
+        while stack and stack[-1][0] >= indent:
+            stack.pop()
+
+        match = PROFILE_NODE_RE.match(line)
+        if match and fragment is not None:
+            key = 'Fragment %d/%s (id=%s)' % (fragment, match.group(2).strip(), match.group(3))
+            op = operators.setdefault(key, {'active_ns': 0, 'instances': 0, 'counters': {}})
+            active = parse_profile_value(match.group(4)) if match.group(4) else 0
+            op['active_ns'] = max(op['active_ns'], active or 0)
+            op['instances'] += 1
+            current = (key, '')
+            stack.append((indent, current))
+            continue
+
+        match = PROFILE_HEADER_RE.match(line)
+        if match and stack:
+            # a child of an operator
+            parent_key, parent_prefix = stack[-1][1]
+            current = (parent_key, parent_prefix + match.group(2).strip() + '/')
+            stack.append((indent, current))
+        else:
+            current = None
+    return operators
+
+
+def fetch_profile(cluster, tag):
+    """
+    Find the query with 'tag' in the queries listed by the FE, and return its profile
+    """
+    for _ in range(10):
+        page = cluster.http_get('/query')
+        for row in page.split('<tr>'):
+            if tag not in row:
+                continue
+            match = re.search(r'query_profile\?query_id=([0-9a-fA-F-]+)', row)
+            if match:
+                page = cluster.http_get('/query_profile?query_id=' + match.group(1))
+                pre = re.search(r'<pre>(.*)</pre>', page, re.S)
+                return html_unescape(pre.group(1)) if pre else None
+        # profiles are reported asynchronously after a query finishes
+        time.sleep(0.5)
+    return None
+
+
+def median(values):
+    return percentile(values, 50)
+
+
+def collect_profiles(cluster, queries, rounds):
+    """
+    Run every query 'rounds' times serially with the profile reported, and return the
+    medians of operators over rounds
+    """
+    conn = cluster.connect(cluster.database)
+    cursor = conn.cursor()
+    cursor.execute('SET is_report_success = true')
+    profiles = {}
+    for name, sql in queries:
+        samples = []
+        for _ in range(rounds):
+            tag = 'query_benchmark_%s' % uuid.uuid4().hex
+            try:
+                execute(cursor, '/* %s */ %s' % (tag, sql))
+            except MySQLdb.Error as e:
+                print('query %s failed: %s' % (name, e), file=sys.stderr)
+                continue
+            text = fetch_profile(cluster, tag)
+            if text is None:
+                print('profile of query %s is not found' % name, file=sys.stderr)
+                continue
+            samples.append(parse_profile(text))
+        operators = {}
+        for key in set(k for sample in samples for k in sample):
+            ops = [sample[key] for sample in samples if key in sample]
+            counter_names = set(c for op in ops for c in op['counters'])
+            operators[key] = {
+                'active_ns': median([op['active_ns'] for op in ops]),
+                'instances': ops[0]['instances'],
+                'counters': dict((c, median([op['counters'].get(c, 0) for op in ops]))
+                                 for c in counter_names),
+            }
+        profiles[name] = operators
+    cursor.close()
+    conn.close()
+    return profiles
+
+
+def cmd_run(args):
+    cluster = Cluster(args)
+    queries = load_queries(args.benchmark, split_list(args.queries))
+    concurrencies = [int(x) for x in split_list(args.concurrency)]
+
+    if args.warmup > 0:
+        print('warming up for %d rounds' % args.warmup)
+        run_concurrently(cluster, queries, 1, args.warmup, args.seed)
+
+    result = {
+        'context': {
+            'benchmark': args.benchmark,
+            'database': args.database,
+            'fe_host': args.fe_host,
+            'rounds': args.rounds,
+            'warmup': args.warmup,
+            'start_time': time.strftime('%Y-%m-%d %H:%M:%S'),
+        },
+        'runs': [],
+    }
+    print('%-12s %-8s %8s %10s %10s %10s %10s %10s %7s'
+          % ('Concurrency', 'Query', 'Count', 'Mean ms', 'P50 ms', 'P90 ms', 'P99 ms',
+             'Max ms', 'Errors'))
+    for concurrency in concurrencies:
+        latencies, errors, elapsed = run_concurrently(cluster, queries, concurrency,
+                                                      args.rounds, args.seed)
+        run = {'concurrency': concurrency, 'queries': {}}
+        all_latencies = []
+        for name, _ in queries:
+            summary = latency_summary(latencies[name])
+            summary['errors'] = errors[name]
+            run['queries'][name] = summary
+            all_latencies.extend(latencies[name])
+            print('%-12d %-8s %8d %10.1f %10.1f %10.1f %10.1f %10.1f %7d'
+                  % (concurrency, name, summary['count'], summary['mean'], summary['p50'],
+                     summary['p90'], summary['p99'], summary['max'], errors[name]))
+        run['total'] = latency_summary(all_latencies)
+        run['elapsed_s'] = elapsed
+        run['qps'] = len(all_latencies) / elapsed if elapsed > 0 else 0
+        total = run['total']
+        print('%-12d %-8s %8d %10.1f %10.1f %10.1f %10.1f %10.1f %7d  QPS: %.2f'
+              % (concurrency, 'all', total['count'], total['mean'], total['p50'],
+                 total['p90'], total['p99'], total['max'], sum(errors.values()), run['qps']))
+        result['runs'].append(run)
+
+    if args.profile_rounds > 0:
+        print('collecting profiles for %d rounds' % args.profile_rounds)
+        result['profiles'] = collect_profiles(cluster, queries, args.profile_rounds)
+
+    with open(args.output, 'w') as f:
+        json.dump(result, f, indent=2, sort_keys=True)
+    print('results are written into %s' % args.output)
+
+
+# ---------------------------------------------------------------------------
+# diff
+# ---------------------------------------------------------------------------
+
+def change_percent(base, new):
+    if base == 0:
+        return 0 if new == 0 else float('inf')
+    return (new - base) * 100.0 / base
+
+
+def cmd_diff(args):
+    with open(args.base) as f:
+        base = json.load(f)
+    with open(args.new) as f:
+        new = json.load(f)
+
+    print('Latency of queries, %s -> %s' % (args.base, args.new))
+    print('%-12s %-8s %12s %12s %9s %12s %12s %9s'
+          % ('Concurrency', 'Query', 'Base P50', 'New P50', 'Change', 'Base P99',
+             'New P99', 'Change'))
+    new_runs = dict((run['concurrency'], run) for run in new['runs'])
+    for base_run in base['runs']:
+        new_run = new_runs.get(base_run['concurrency'])
+        if new_run is None:
+            continue
+        names = sorted(set(base_run['queries']) & set(new_run['queries']),
+                       key=lambda n: [int(x) for x in re.findall(r'\d+', n)])
+        rows = [(name, base_run['queries'][name], new_run['queries'][name]) for name in names]
+        rows.append(('all', base_run['total'], new_run['total']))
+        for name, b, n in rows:
+            print('%-12d %-8s %12.1f %12.1f %8.1f%% %12.1f %12.1f %8.1f%%'
+                  % (base_run['concurrency'], name, b['p50'], n['p50'],
+                     change_percent(b['p50'], n['p50']), b['p99'], n['p99'],
+                     change_percent(b['p99'], n['p99'])))
+        print('%-12d %-8s %12.2f %12.2f %8.1f%%  (QPS)'
+              % (base_run['concurrency'], 'all', base_run['qps'], new_run['qps'],
+                 change_percent(base_run['qps'], new_run['qps'])))
+
+    base_profiles = base.get('profiles', {})
+    new_profiles = new.get('profiles', {})
+    if not base_profiles or not new_profiles:
+        return
+    min_ns = args.min_ms * 10 ** 6
+    print('')
+    print('Operators changed by at least %.0f%% and taking at least %.1fms' %
+          (args.threshold, args.min_ms))
+    print('%-8s %-48s %12s %12s %9s' % ('Query', 'Operator', 'Base ms', 'New ms', 'Change'))
+    for name in sorted(set(base_profiles) & set(new_profiles),
+                       key=lambda n: [int(x) for x in re.findall(r'\d+', n)]):
+        b_ops = base_profiles[name]
+        n_ops = new_profiles[name]
+        for key in sorted(set(b_ops) | set(n_ops)):
+            b_ns = b_ops[key]['active_ns'] if key in b_ops else 0
+            n_ns = n_ops[key]['active_ns'] if key in n_ops else 0
+            change = change_percent(b_ns, n_ns)
+            if max(b_ns, n_ns) < min_ns or abs(change) < args.threshold:
+                continue
+            print('%-8s %-48s %12.1f %12.1f %8.1f%%'
+                  % (name, key, b_ns / 1e6, n_ns / 1e6, change))
+            if not args.counters or key not in b_ops or key not in n_ops:
+                continue
+            b_counters = b_ops[key]['counters']
+            n_counters = n_ops[key]['counters']
+            for counter in sorted(set(b_counters) & set(n_counters)):
+                c_change = change_percent(b_counters[counter], n_counters[counter])
+                if abs(c_change) >= args.threshold:
+                    print('%-8s   %-46s %12.0f %12.0f %8.1f%%'
+                          % ('', counter, b_counters[counter], n_counters[counter], c_change))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='SSB and TPC-H benchmark driver of Doris')
+    parser.add_argument('--conf', default=os.path.join(BASE_DIR, 'conf'),
+                        help='config file of the cluster')
+    subparsers = parser.add_subparsers(dest='command')
+
+    load = subparsers.add_parser('load', help='create tables and load data')
+    load.add_argument('--benchmark', choices=sorted(BENCHMARK_TABLES), required=True)
+    load.add_argument('--data_dir', required=True,
+                      help='directory of the files generated by dbgen')
+    load.add_argument('--dbgen', help='path of dbgen, to generate data into data_dir first')
+    load.add_argument('--scale_factor', type=float, default=1, help='scale factor of dbgen')
+    load.add_argument('--buckets', type=int, default=16,
+                      help='buckets of the tables, except for the small dimension tables')
+    load.add_argument('--batch_mb', type=int, default=256, help='size of a stream load')
+
+    run = subparsers.add_parser('run', help='run queries')
+    run.add_argument('--benchmark', choices=sorted(BENCHMARK_TABLES), required=True)
+    run.add_argument('--queries', help='queries to run, like q1.1,q2.1, all by default')
+    run.add_argument('--concurrency', default='1', help='concurrency levels, like 1,4,16')
+    run.add_argument('--rounds', type=int, default=3,
+                     help='times every thread runs every query at each concurrency level')
+    run.add_argument('--warmup', type=int, default=1,
+                     help='times every query is run serially before measured')
+    run.add_argument('--profile_rounds', type=int, default=1,
+                     help='times every query is run serially with its profile collected, '
+                          'after measured; 0 to not collect profiles')
+    run.add_argument('--seed', type=int, default=0, help='seed of the orders of queries')
+    run.add_argument('--output', required=True, help='file to write results into')
+
+    diff = subparsers.add_parser('diff', help='compare the results of two runs')
+    diff.add_argument('base', help='results of the base run')
+    diff.add_argument('new', help='results of the new run')
+    diff.add_argument('--threshold', type=float, default=10,
+                      help='percent of change to report an operator')
+    diff.add_argument('--min_ms', type=float, default=1,
+                      help='active time to report an operator')
+    diff.add_argument('--counters', action='store_true',
+                      help='report the changed counters of the reported operators')
+
+    args = parser.parse_args()
+    if args.command == 'diff':
+        cmd_diff(args)
+        return
+
+    cf = configparser.ConfigParser()
+    if not cf.read(args.conf):
+        raise Exception('failed to read config file %s' % args.conf)
+    args.fe_host = cf.get('cluster', 'fe_host')
+    args.port = int(cf.get('cluster', 'port'))
+    args.http_port = int(cf.get('cluster', 'http_port'))
+    args.user = cf.get('cluster', 'username')
+    args.password = cf.get('cluster', 'password')
+    if cf.has_option('cluster', 'database') and cf.get('cluster', 'database'):
+        args.database = cf.get('cluster', 'database')
+    else:
+        args.database = args.benchmark
+
+    if args.command == 'load':
+        cmd_load(args)
+    elif args.command == 'run':
+        cmd_run(args)
+    else:
+        parser.print_help()
+
+
+if __name__ == '__main__':
+    main()